@@ -6,7 +6,8 @@ CREATE TABLE device_%deviceid_directories (
 CREATE TABLE device_%deviceid_subdirectories (
   directory_id INTEGER NOT NULL,
   path TEXT NOT NULL,
-  mtime INTEGER NOT NULL
+  mtime INTEGER NOT NULL,
+  art_automatic TEXT
 );
 
 CREATE TABLE device_%deviceid_songs (
@@ -96,7 +97,9 @@ CREATE TABLE device_%deviceid_songs (
 
   bpm REAL,
   mood TEXT,
-  initial_key TEXT
+  initial_key TEXT,
+
+  metadata_digest INTEGER NOT NULL DEFAULT 0
 
 );
 
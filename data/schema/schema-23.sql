@@ -0,0 +1,37 @@
+CREATE VIRTUAL TABLE IF NOT EXISTS songs_fts USING fts5(
+  title,
+  titlesort,
+  album,
+  albumsort,
+  artist,
+  artistsort,
+  albumartist,
+  albumartistsort,
+  composer,
+  composersort,
+  performer,
+  performersort,
+  grouping,
+  genre,
+  comment,
+  content = 'songs',
+  content_rowid = 'ROWID',
+  tokenize = 'trigram'
+);
+
+CREATE TRIGGER IF NOT EXISTS songs_fts_insert AFTER INSERT ON songs BEGIN
+  INSERT INTO songs_fts (ROWID, title, titlesort, album, albumsort, artist, artistsort, albumartist, albumartistsort, composer, composersort, performer, performersort, grouping, genre, comment) VALUES (new.ROWID, new.title, new.titlesort, new.album, new.albumsort, new.artist, new.artistsort, new.albumartist, new.albumartistsort, new.composer, new.composersort, new.performer, new.performersort, new.grouping, new.genre, new.comment);
+END;
+
+CREATE TRIGGER IF NOT EXISTS songs_fts_delete AFTER DELETE ON songs BEGIN
+  INSERT INTO songs_fts (songs_fts, ROWID, title, titlesort, album, albumsort, artist, artistsort, albumartist, albumartistsort, composer, composersort, performer, performersort, grouping, genre, comment) VALUES ('delete', old.ROWID, old.title, old.titlesort, old.album, old.albumsort, old.artist, old.artistsort, old.albumartist, old.albumartistsort, old.composer, old.composersort, old.performer, old.performersort, old.grouping, old.genre, old.comment);
+END;
+
+CREATE TRIGGER IF NOT EXISTS songs_fts_update AFTER UPDATE OF title, titlesort, album, albumsort, artist, artistsort, albumartist, albumartistsort, composer, composersort, performer, performersort, grouping, genre, comment ON songs BEGIN
+  INSERT INTO songs_fts (songs_fts, ROWID, title, titlesort, album, albumsort, artist, artistsort, albumartist, albumartistsort, composer, composersort, performer, performersort, grouping, genre, comment) VALUES ('delete', old.ROWID, old.title, old.titlesort, old.album, old.albumsort, old.artist, old.artistsort, old.albumartist, old.albumartistsort, old.composer, old.composersort, old.performer, old.performersort, old.grouping, old.genre, old.comment);
+  INSERT INTO songs_fts (ROWID, title, titlesort, album, albumsort, artist, artistsort, albumartist, albumartistsort, composer, composersort, performer, performersort, grouping, genre, comment) VALUES (new.ROWID, new.title, new.titlesort, new.album, new.albumsort, new.artist, new.artistsort, new.albumartist, new.albumartistsort, new.composer, new.composersort, new.performer, new.performersort, new.grouping, new.genre, new.comment);
+END;
+
+INSERT INTO songs_fts (songs_fts) VALUES ('rebuild');
+
+UPDATE schema_version SET version=23;
@@ -0,0 +1,8 @@
+CREATE TABLE IF NOT EXISTS lyrics (
+  key TEXT PRIMARY KEY NOT NULL,
+  provider TEXT,
+  lyrics TEXT NOT NULL,
+  time INTEGER NOT NULL DEFAULT 0
+);
+
+UPDATE schema_version SET version=25;
@@ -0,0 +1,20 @@
+CREATE TABLE IF NOT EXISTS changes (
+  name TEXT PRIMARY KEY NOT NULL,
+  counter INTEGER NOT NULL DEFAULT 0
+);
+
+INSERT OR IGNORE INTO changes (name, counter) VALUES ('songs', 0);
+
+CREATE TRIGGER IF NOT EXISTS songs_changes_insert AFTER INSERT ON songs BEGIN
+  UPDATE changes SET counter = counter + 1 WHERE name = 'songs';
+END;
+
+CREATE TRIGGER IF NOT EXISTS songs_changes_update AFTER UPDATE ON songs BEGIN
+  UPDATE changes SET counter = counter + 1 WHERE name = 'songs';
+END;
+
+CREATE TRIGGER IF NOT EXISTS songs_changes_delete AFTER DELETE ON songs BEGIN
+  UPDATE changes SET counter = counter + 1 WHERE name = 'songs';
+END;
+
+UPDATE schema_version SET version=26;
@@ -0,0 +1,15 @@
+DROP INDEX IF EXISTS idx_albumsort;
+
+DROP INDEX IF EXISTS idx_titlesort;
+
+DROP INDEX IF EXISTS idx_composersort;
+
+DROP INDEX IF EXISTS idx_performersort;
+
+CREATE INDEX IF NOT EXISTS idx_effective_albumartist_album ON songs (effective_albumartist, album, url) WHERE unavailable = 0;
+
+CREATE INDEX IF NOT EXISTS idx_albumartist_artist_album ON songs (albumartist, artist, album, compilation_effective, unavailable) WHERE unavailable = 0;
+
+CREATE INDEX IF NOT EXISTS idx_album_effective_albumartist ON songs (album, effective_albumartist, url, compilation_detected, unavailable) WHERE unavailable = 0;
+
+UPDATE schema_version SET version=27;
@@ -0,0 +1,18 @@
+CREATE TABLE IF NOT EXISTS compilation_dirty_albums (
+  album TEXT PRIMARY KEY NOT NULL
+);
+
+CREATE TRIGGER IF NOT EXISTS songs_compilation_insert AFTER INSERT ON songs WHEN new.album != '' BEGIN
+  INSERT OR IGNORE INTO compilation_dirty_albums (album) VALUES (new.album);
+END;
+
+CREATE TRIGGER IF NOT EXISTS songs_compilation_delete AFTER DELETE ON songs WHEN old.album != '' BEGIN
+  INSERT OR IGNORE INTO compilation_dirty_albums (album) VALUES (old.album);
+END;
+
+CREATE TRIGGER IF NOT EXISTS songs_compilation_update AFTER UPDATE OF album, effective_albumartist, url, unavailable ON songs BEGIN
+  INSERT OR IGNORE INTO compilation_dirty_albums (album) SELECT old.album WHERE old.album != '';
+  INSERT OR IGNORE INTO compilation_dirty_albums (album) SELECT new.album WHERE new.album != '';
+END;
+
+UPDATE schema_version SET version=28;
@@ -0,0 +1,3 @@
+ALTER TABLE %allsongstables ADD COLUMN metadata_digest INTEGER NOT NULL DEFAULT 0;
+
+UPDATE schema_version SET version=29;
@@ -0,0 +1,3 @@
+ALTER TABLE %allsubdirstables ADD COLUMN art_automatic TEXT;
+
+UPDATE schema_version SET version=30;
@@ -0,0 +1,23 @@
+CREATE TABLE IF NOT EXISTS fingerprint_songs (
+  song_id INTEGER PRIMARY KEY NOT NULL
+);
+
+CREATE TABLE IF NOT EXISTS fingerprint_bands (
+  band INTEGER NOT NULL,
+  song_id INTEGER NOT NULL,
+  PRIMARY KEY (band, song_id)
+) WITHOUT ROWID;
+
+CREATE INDEX IF NOT EXISTS idx_fingerprint_bands_song_id ON fingerprint_bands (song_id);
+
+CREATE TRIGGER IF NOT EXISTS songs_fingerprint_delete AFTER DELETE ON songs BEGIN
+  DELETE FROM fingerprint_bands WHERE song_id = old.ROWID;
+  DELETE FROM fingerprint_songs WHERE song_id = old.ROWID;
+END;
+
+CREATE TRIGGER IF NOT EXISTS songs_fingerprint_update AFTER UPDATE OF fingerprint ON songs BEGIN
+  DELETE FROM fingerprint_bands WHERE song_id = old.ROWID;
+  DELETE FROM fingerprint_songs WHERE song_id = old.ROWID;
+END;
+
+UPDATE schema_version SET version=31;
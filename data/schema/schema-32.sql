@@ -0,0 +1,128 @@
+CREATE TABLE IF NOT EXISTS playlist_songs (
+
+  hash BLOB,
+
+  title TEXT,
+  titlesort TEXT,
+  album TEXT,
+  albumsort TEXT,
+  artist TEXT,
+  artistsort TEXT,
+  albumartist TEXT,
+  albumartistsort TEXT,
+  track INTEGER,
+  disc INTEGER,
+  year INTEGER,
+  originalyear INTEGER,
+  genre TEXT,
+  compilation INTEGER DEFAULT 0,
+  composer TEXT,
+  composersort TEXT,
+  performer TEXT,
+  performersort TEXT,
+  grouping TEXT,
+  comment TEXT,
+  lyrics TEXT,
+
+  artist_id TEXT,
+  album_id TEXT,
+  song_id TEXT,
+
+  beginning INTEGER,
+  length INTEGER,
+
+  bitrate INTEGER,
+  samplerate INTEGER,
+  bitdepth INTEGER,
+
+  source INTEGER,
+  directory_id INTEGER,
+  url TEXT,
+  filetype INTEGER,
+  filesize INTEGER,
+  mtime INTEGER,
+  ctime INTEGER,
+  unavailable INTEGER DEFAULT 0,
+
+  fingerprint TEXT,
+
+  playcount INTEGER DEFAULT 0,
+  skipcount INTEGER DEFAULT 0,
+  lastplayed INTEGER DEFAULT -1,
+  lastseen INTEGER DEFAULT -1,
+
+  compilation_detected INTEGER DEFAULT 0,
+  compilation_on INTEGER DEFAULT 0,
+  compilation_off INTEGER DEFAULT 0,
+  compilation_effective INTEGER DEFAULT 0,
+
+  art_embedded INTEGER DEFAULT 0,
+  art_automatic TEXT,
+  art_manual TEXT,
+  art_unset INTEGER DEFAULT 0,
+
+  effective_albumartist TEXT,
+  effective_originalyear INTEGER,
+
+  cue_path TEXT,
+
+  rating INTEGER DEFAULT -1,
+
+  acoustid_id TEXT,
+  acoustid_fingerprint TEXT,
+
+  musicbrainz_album_artist_id TEXT,
+  musicbrainz_artist_id TEXT,
+  musicbrainz_original_artist_id TEXT,
+  musicbrainz_album_id TEXT,
+  musicbrainz_original_album_id TEXT,
+  musicbrainz_recording_id TEXT,
+  musicbrainz_track_id TEXT,
+  musicbrainz_disc_id TEXT,
+  musicbrainz_release_group_id TEXT,
+  musicbrainz_work_id TEXT,
+
+  ebur128_integrated_loudness_lufs REAL,
+  ebur128_loudness_range_lu REAL,
+
+  bpm REAL,
+  mood TEXT,
+  initial_key TEXT,
+
+  metadata_digest INTEGER NOT NULL DEFAULT 0
+
+);
+
+INSERT INTO playlist_songs (ROWID, title, titlesort, album, albumsort, artist, artistsort, albumartist, albumartistsort, track, disc, year, originalyear, genre, compilation, composer, composersort, performer, performersort, grouping, comment, lyrics, artist_id, album_id, song_id, beginning, length, bitrate, samplerate, bitdepth, source, directory_id, url, filetype, filesize, mtime, ctime, unavailable, fingerprint, playcount, skipcount, lastplayed, lastseen, compilation_detected, compilation_on, compilation_off, compilation_effective, art_embedded, art_automatic, art_manual, art_unset, effective_albumartist, effective_originalyear, cue_path, rating, acoustid_id, acoustid_fingerprint, musicbrainz_album_artist_id, musicbrainz_artist_id, musicbrainz_original_artist_id, musicbrainz_album_id, musicbrainz_original_album_id, musicbrainz_recording_id, musicbrainz_track_id, musicbrainz_disc_id, musicbrainz_release_group_id, musicbrainz_work_id, ebur128_integrated_loudness_lufs, ebur128_loudness_range_lu, bpm, mood, initial_key, metadata_digest)
+SELECT ROWID, title, titlesort, album, albumsort, artist, artistsort, albumartist, albumartistsort, track, disc, year, originalyear, genre, compilation, composer, composersort, performer, performersort, grouping, comment, lyrics, artist_id, album_id, song_id, beginning, length, bitrate, samplerate, bitdepth, source, directory_id, url, filetype, filesize, mtime, ctime, unavailable, fingerprint, playcount, skipcount, lastplayed, lastseen, compilation_detected, compilation_on, compilation_off, compilation_effective, art_embedded, art_automatic, art_manual, art_unset, effective_albumartist, effective_originalyear, cue_path, rating, acoustid_id, acoustid_fingerprint, musicbrainz_album_artist_id, musicbrainz_artist_id, musicbrainz_original_artist_id, musicbrainz_album_id, musicbrainz_original_album_id, musicbrainz_recording_id, musicbrainz_track_id, musicbrainz_disc_id, musicbrainz_release_group_id, musicbrainz_work_id, ebur128_integrated_loudness_lufs, ebur128_loudness_range_lu, bpm, mood, initial_key, metadata_digest
+FROM playlist_items WHERE url IS NOT NULL AND url != '';
+
+DROP INDEX IF EXISTS idx_playlist_items_position;
+
+ALTER TABLE playlist_items RENAME TO playlist_items_old;
+
+CREATE TABLE playlist_items (
+
+  playlist INTEGER NOT NULL,
+  type INTEGER NOT NULL DEFAULT 0,
+  uuid TEXT,
+  collection_id INTEGER,
+  playlist_url TEXT,
+  position INTEGER,
+  playlist_song_id INTEGER
+
+);
+
+INSERT INTO playlist_items (ROWID, playlist, type, uuid, collection_id, playlist_url, position, playlist_song_id)
+SELECT ROWID, playlist, type, uuid, collection_id, playlist_url, position, CASE WHEN url IS NOT NULL AND url != '' THEN ROWID ELSE NULL END
+FROM playlist_items_old;
+
+DROP TABLE playlist_items_old;
+
+CREATE INDEX IF NOT EXISTS idx_playlist_items_position ON playlist_items (playlist, position);
+
+CREATE INDEX IF NOT EXISTS idx_playlist_items_playlist_song_id ON playlist_items (playlist_song_id);
+
+CREATE INDEX IF NOT EXISTS idx_playlist_songs_url_hash ON playlist_songs (url, hash);
+
+UPDATE schema_version SET version=32;
@@ -0,0 +1,10 @@
+CREATE TABLE IF NOT EXISTS songs_text (
+  song_id INTEGER PRIMARY KEY NOT NULL,
+  lyrics BLOB
+);
+
+CREATE TRIGGER IF NOT EXISTS songs_text_delete AFTER DELETE ON songs BEGIN
+  DELETE FROM songs_text WHERE song_id = old.ROWID;
+END;
+
+UPDATE schema_version SET version=33;
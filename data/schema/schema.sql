@@ -4,7 +4,7 @@ CREATE TABLE IF NOT EXISTS schema_version (
 
 DELETE FROM schema_version;
 
-INSERT INTO schema_version (version) VALUES (22);
+INSERT INTO schema_version (version) VALUES (33);
 
 CREATE TABLE IF NOT EXISTS directories (
   path TEXT NOT NULL,
@@ -14,7 +14,8 @@ CREATE TABLE IF NOT EXISTS directories (
 CREATE TABLE IF NOT EXISTS subdirectories (
   directory_id INTEGER NOT NULL,
   path TEXT NOT NULL,
-  mtime INTEGER NOT NULL
+  mtime INTEGER NOT NULL,
+  art_automatic TEXT
 );
 
 CREATE TABLE IF NOT EXISTS songs (
@@ -104,7 +105,9 @@ CREATE TABLE IF NOT EXISTS songs (
 
   bpm REAL,
   mood TEXT,
-  initial_key TEXT
+  initial_key TEXT,
+
+  metadata_digest INTEGER NOT NULL DEFAULT 0
 
 );
 
@@ -195,7 +198,9 @@ CREATE TABLE IF NOT EXISTS subsonic_songs (
 
   bpm REAL,
   mood TEXT,
-  initial_key TEXT
+  initial_key TEXT,
+
+  metadata_digest INTEGER NOT NULL DEFAULT 0
 
 );
 
@@ -286,7 +291,9 @@ CREATE TABLE IF NOT EXISTS tidal_artists_songs (
 
   bpm REAL,
   mood TEXT,
-  initial_key TEXT
+  initial_key TEXT,
+
+  metadata_digest INTEGER NOT NULL DEFAULT 0
 
 );
 
@@ -377,7 +384,9 @@ CREATE TABLE IF NOT EXISTS tidal_albums_songs (
 
   bpm REAL,
   mood TEXT,
-  initial_key TEXT
+  initial_key TEXT,
+
+  metadata_digest INTEGER NOT NULL DEFAULT 0
 
 );
 
@@ -468,7 +477,9 @@ CREATE TABLE IF NOT EXISTS tidal_songs (
 
   bpm REAL,
   mood TEXT,
-  initial_key TEXT
+  initial_key TEXT,
+
+  metadata_digest INTEGER NOT NULL DEFAULT 0
 
 );
 
@@ -559,7 +570,9 @@ CREATE TABLE IF NOT EXISTS spotify_artists_songs (
 
   bpm REAL,
   mood TEXT,
-  initial_key TEXT
+  initial_key TEXT,
+
+  metadata_digest INTEGER NOT NULL DEFAULT 0
 
 );
 
@@ -650,7 +663,9 @@ CREATE TABLE IF NOT EXISTS spotify_albums_songs (
 
   bpm REAL,
   mood TEXT,
-  initial_key TEXT
+  initial_key TEXT,
+
+  metadata_digest INTEGER NOT NULL DEFAULT 0
 
 );
 
@@ -741,7 +756,9 @@ CREATE TABLE IF NOT EXISTS spotify_songs (
 
   bpm REAL,
   mood TEXT,
-  initial_key TEXT
+  initial_key TEXT,
+
+  metadata_digest INTEGER NOT NULL DEFAULT 0
 
 );
 
@@ -832,7 +849,9 @@ CREATE TABLE IF NOT EXISTS qobuz_artists_songs (
 
   bpm REAL,
   mood TEXT,
-  initial_key TEXT
+  initial_key TEXT,
+
+  metadata_digest INTEGER NOT NULL DEFAULT 0
 
 );
 
@@ -923,7 +942,9 @@ CREATE TABLE IF NOT EXISTS qobuz_albums_songs (
 
   bpm REAL,
   mood TEXT,
-  initial_key TEXT
+  initial_key TEXT,
+
+  metadata_digest INTEGER NOT NULL DEFAULT 0
 
 );
 
@@ -1014,7 +1035,9 @@ CREATE TABLE IF NOT EXISTS qobuz_songs (
 
   bpm REAL,
   mood TEXT,
-  initial_key TEXT
+  initial_key TEXT,
+
+  metadata_digest INTEGER NOT NULL DEFAULT 0
 
 );
 
@@ -1040,6 +1063,14 @@ CREATE TABLE IF NOT EXISTS playlist_items (
   uuid TEXT,
   collection_id INTEGER,
   playlist_url TEXT,
+  position INTEGER,
+  playlist_song_id INTEGER
+
+);
+
+CREATE TABLE IF NOT EXISTS playlist_songs (
+
+  hash BLOB,
 
   title TEXT,
   titlesort TEXT,
@@ -1126,7 +1157,9 @@ CREATE TABLE IF NOT EXISTS playlist_items (
 
   bpm REAL,
   mood TEXT,
-  initial_key TEXT
+  initial_key TEXT,
+
+  metadata_digest INTEGER NOT NULL DEFAULT 0
 
 );
 
@@ -1147,6 +1180,13 @@ CREATE TABLE IF NOT EXISTS radio_channels (
   thumbnail_url TEXT
 );
 
+CREATE TABLE IF NOT EXISTS lyrics (
+  key TEXT PRIMARY KEY NOT NULL,
+  provider TEXT,
+  lyrics TEXT NOT NULL,
+  time INTEGER NOT NULL DEFAULT 0
+);
+
 CREATE INDEX IF NOT EXISTS idx_url ON songs (url);
 
 CREATE INDEX IF NOT EXISTS idx_comp_artist ON songs (compilation_effective, artist);
@@ -1161,14 +1201,122 @@ CREATE INDEX IF NOT EXISTS idx_artistsort ON songs (artistsort);
 
 CREATE INDEX IF NOT EXISTS idx_album ON songs (album);
 
-CREATE INDEX IF NOT EXISTS idx_albumsort ON songs (album);
-
 CREATE INDEX IF NOT EXISTS idx_title ON songs (title);
 
-CREATE INDEX IF NOT EXISTS idx_titlesort ON songs (title);
+CREATE INDEX IF NOT EXISTS idx_effective_albumartist_album ON songs (effective_albumartist, album, url) WHERE unavailable = 0;
+
+CREATE INDEX IF NOT EXISTS idx_albumartist_artist_album ON songs (albumartist, artist, album, compilation_effective, unavailable) WHERE unavailable = 0;
+
+CREATE INDEX IF NOT EXISTS idx_album_effective_albumartist ON songs (album, effective_albumartist, url, compilation_detected, unavailable) WHERE unavailable = 0;
+
+CREATE INDEX IF NOT EXISTS idx_playlist_items_position ON playlist_items (playlist, position);
+
+CREATE INDEX IF NOT EXISTS idx_playlist_items_playlist_song_id ON playlist_items (playlist_song_id);
+
+CREATE INDEX IF NOT EXISTS idx_playlist_songs_url_hash ON playlist_songs (url, hash);
+
+CREATE VIRTUAL TABLE IF NOT EXISTS songs_fts USING fts5(
+  title,
+  titlesort,
+  album,
+  albumsort,
+  artist,
+  artistsort,
+  albumartist,
+  albumartistsort,
+  composer,
+  composersort,
+  performer,
+  performersort,
+  grouping,
+  genre,
+  comment,
+  content = 'songs',
+  content_rowid = 'ROWID',
+  tokenize = 'trigram'
+);
 
-CREATE INDEX IF NOT EXISTS idx_composersort ON songs (title);
+CREATE TRIGGER IF NOT EXISTS songs_fts_insert AFTER INSERT ON songs BEGIN
+  INSERT INTO songs_fts (ROWID, title, titlesort, album, albumsort, artist, artistsort, albumartist, albumartistsort, composer, composersort, performer, performersort, grouping, genre, comment) VALUES (new.ROWID, new.title, new.titlesort, new.album, new.albumsort, new.artist, new.artistsort, new.albumartist, new.albumartistsort, new.composer, new.composersort, new.performer, new.performersort, new.grouping, new.genre, new.comment);
+END;
 
-CREATE INDEX IF NOT EXISTS idx_performersort ON songs (title);
+CREATE TRIGGER IF NOT EXISTS songs_fts_delete AFTER DELETE ON songs BEGIN
+  INSERT INTO songs_fts (songs_fts, ROWID, title, titlesort, album, albumsort, artist, artistsort, albumartist, albumartistsort, composer, composersort, performer, performersort, grouping, genre, comment) VALUES ('delete', old.ROWID, old.title, old.titlesort, old.album, old.albumsort, old.artist, old.artistsort, old.albumartist, old.albumartistsort, old.composer, old.composersort, old.performer, old.performersort, old.grouping, old.genre, old.comment);
+END;
+
+CREATE TRIGGER IF NOT EXISTS songs_fts_update AFTER UPDATE OF title, titlesort, album, albumsort, artist, artistsort, albumartist, albumartistsort, composer, composersort, performer, performersort, grouping, genre, comment ON songs BEGIN
+  INSERT INTO songs_fts (songs_fts, ROWID, title, titlesort, album, albumsort, artist, artistsort, albumartist, albumartistsort, composer, composersort, performer, performersort, grouping, genre, comment) VALUES ('delete', old.ROWID, old.title, old.titlesort, old.album, old.albumsort, old.artist, old.artistsort, old.albumartist, old.albumartistsort, old.composer, old.composersort, old.performer, old.performersort, old.grouping, old.genre, old.comment);
+  INSERT INTO songs_fts (ROWID, title, titlesort, album, albumsort, artist, artistsort, albumartist, albumartistsort, composer, composersort, performer, performersort, grouping, genre, comment) VALUES (new.ROWID, new.title, new.titlesort, new.album, new.albumsort, new.artist, new.artistsort, new.albumartist, new.albumartistsort, new.composer, new.composersort, new.performer, new.performersort, new.grouping, new.genre, new.comment);
+END;
 
 CREATE VIEW IF NOT EXISTS duplicated_songs as select artist dup_artist, album dup_album, title dup_title from songs as inner_songs where artist != '' and album != '' and title != '' and unavailable = 0 group by artist, album , title having count(*) > 1;
+
+CREATE TABLE IF NOT EXISTS changes (
+  name TEXT PRIMARY KEY NOT NULL,
+  counter INTEGER NOT NULL DEFAULT 0
+);
+
+INSERT OR IGNORE INTO changes (name, counter) VALUES ('songs', 0);
+
+CREATE TRIGGER IF NOT EXISTS songs_changes_insert AFTER INSERT ON songs BEGIN
+  UPDATE changes SET counter = counter + 1 WHERE name = 'songs';
+END;
+
+CREATE TRIGGER IF NOT EXISTS songs_changes_update AFTER UPDATE ON songs BEGIN
+  UPDATE changes SET counter = counter + 1 WHERE name = 'songs';
+END;
+
+CREATE TRIGGER IF NOT EXISTS songs_changes_delete AFTER DELETE ON songs BEGIN
+  UPDATE changes SET counter = counter + 1 WHERE name = 'songs';
+END;
+
+
+CREATE TABLE IF NOT EXISTS compilation_dirty_albums (
+  album TEXT PRIMARY KEY NOT NULL
+);
+
+CREATE TRIGGER IF NOT EXISTS songs_compilation_insert AFTER INSERT ON songs WHEN new.album != '' BEGIN
+  INSERT OR IGNORE INTO compilation_dirty_albums (album) VALUES (new.album);
+END;
+
+CREATE TRIGGER IF NOT EXISTS songs_compilation_delete AFTER DELETE ON songs WHEN old.album != '' BEGIN
+  INSERT OR IGNORE INTO compilation_dirty_albums (album) VALUES (old.album);
+END;
+
+CREATE TRIGGER IF NOT EXISTS songs_compilation_update AFTER UPDATE OF album, effective_albumartist, url, unavailable ON songs BEGIN
+  INSERT OR IGNORE INTO compilation_dirty_albums (album) SELECT old.album WHERE old.album != '';
+  INSERT OR IGNORE INTO compilation_dirty_albums (album) SELECT new.album WHERE new.album != '';
+END;
+
+CREATE TABLE IF NOT EXISTS fingerprint_songs (
+  song_id INTEGER PRIMARY KEY NOT NULL
+);
+
+CREATE TABLE IF NOT EXISTS fingerprint_bands (
+  band INTEGER NOT NULL,
+  song_id INTEGER NOT NULL,
+  PRIMARY KEY (band, song_id)
+) WITHOUT ROWID;
+
+CREATE INDEX IF NOT EXISTS idx_fingerprint_bands_song_id ON fingerprint_bands (song_id);
+
+CREATE TRIGGER IF NOT EXISTS songs_fingerprint_delete AFTER DELETE ON songs BEGIN
+  DELETE FROM fingerprint_bands WHERE song_id = old.ROWID;
+  DELETE FROM fingerprint_songs WHERE song_id = old.ROWID;
+END;
+
+CREATE TRIGGER IF NOT EXISTS songs_fingerprint_update AFTER UPDATE OF fingerprint ON songs BEGIN
+  DELETE FROM fingerprint_bands WHERE song_id = old.ROWID;
+  DELETE FROM fingerprint_songs WHERE song_id = old.ROWID;
+END;
+
+CREATE TABLE IF NOT EXISTS songs_text (
+  song_id INTEGER PRIMARY KEY NOT NULL,
+  lyrics BLOB
+);
+
+CREATE TRIGGER IF NOT EXISTS songs_text_delete AFTER DELETE ON songs BEGIN
+  DELETE FROM songs_text WHERE song_id = old.ROWID;
+END;
+
+UPDATE schema_version SET version=28;
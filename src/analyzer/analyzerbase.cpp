@@ -29,7 +29,6 @@
 #include <algorithm>
 
 #include <QWidget>
-#include <QList>
 #include <QPainter>
 #include <QPalette>
 #include <QBasicTimer>
@@ -37,6 +36,7 @@
 #include <QHideEvent>
 #include <QTimerEvent>
 
+#include "core/wakeupstatistics.h"
 #include "engine/enginebase.h"
 
 // INSTRUCTIONS Base2D
@@ -89,15 +89,10 @@ void AnalyzerBase::ChangeTimeout(const int timeout) {
 
 void AnalyzerBase::transform(Scope &scope) {
 
-  QList<float> aux(fht_->size());
-  if (static_cast<quint64>(aux.size()) >= scope.size()) {
-    std::copy(scope.begin(), scope.end(), aux.begin());
-  }
-  else {
-    std::copy(scope.begin(), scope.begin() + aux.size(), aux.begin());
-  }
+  transform_buffer_.assign(static_cast<size_t>(fht_->size()), 0.0F);
+  std::copy_n(scope.begin(), std::min(scope.size(), transform_buffer_.size()), transform_buffer_.begin());
 
-  fht_->logSpectrum(scope.data(), aux.data());
+  fht_->logSpectrum(scope.data(), transform_buffer_.data());
   fht_->scale(scope.data(), 1.0F / 20);
 
   scope.resize(static_cast<size_t>(fht_->size() / 2));  // second half of values are rubbish
@@ -111,6 +106,14 @@ void AnalyzerBase::paintEvent(QPaintEvent *e) {
 
   switch (engine_->state()) {
     case EngineBase::State::Playing:{
+      is_playing_ = true;
+
+      // Repaints between timer frames (resizes, exposes) just redraw, only a new frame takes the next scope chunk and transforms it
+      if (!new_frame_) {
+        analyze(p, lastscope_, new_frame_);
+        break;
+      }
+
       const EngineBase::Scope &thescope = engine_->scope(timeout_);
       size_t i = 0;
 
@@ -120,7 +123,6 @@ void AnalyzerBase::paintEvent(QPaintEvent *e) {
         i += 2;
       }
 
-      is_playing_ = true;
       transform(lastscope_);
       analyze(p, lastscope_, new_frame_);
 
@@ -256,6 +258,8 @@ void AnalyzerBase::timerEvent(QTimerEvent *e) {
     return;
   }
 
+  WakeupStatistics::Add();
+
   new_frame_ = true;
   update();
 
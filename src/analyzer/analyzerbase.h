@@ -83,6 +83,7 @@ class AnalyzerBase : public QWidget {
   FHT *fht_;
   SharedPtr<EngineBase> engine_;
   Scope lastscope_;
+  Scope transform_buffer_;
 
   bool new_frame_;
   bool is_playing_;
@@ -21,6 +21,10 @@
    along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <QImage>
+#include <QPoint>
+#include <QRect>
+#include <QColor>
 #include <QPainter>
 #include <QResizeEvent>
 
@@ -31,53 +35,69 @@
 const char *SonogramAnalyzer::kName = QT_TRANSLATE_NOOP("AnalyzerContainer", "Sonogram");
 
 SonogramAnalyzer::SonogramAnalyzer(QWidget *parent)
-    : AnalyzerBase(parent, 9) {}
+    : AnalyzerBase(parent, 9),
+      canvas_column_(0) {}
 
 void SonogramAnalyzer::resizeEvent(QResizeEvent *e) {
 
   Q_UNUSED(e)
 
-  canvas_ = QPixmap(size());
+  canvas_ = QImage(size(), QImage::Format_RGB32);
   canvas_.fill(palette().color(QPalette::Window));
+  canvas_column_ = 0;
 
 }
 
 void SonogramAnalyzer::analyze(QPainter &p, const Scope &s, const bool new_frame) {
 
-  if (!new_frame || engine_->state() == EngineBase::State::Paused) {
-    p.drawPixmap(0, 0, canvas_);
+  if (!new_frame || engine_->state() == EngineBase::State::Paused || canvas_.isNull()) {
+    DrawCanvas(p);
     return;
   }
 
-  QPainter canvas_painter(&canvas_);
-  canvas_painter.drawPixmap(0, 0, canvas_, 1, 0, width() - 1, -1);
+  const int x = canvas_column_;
 
+  const QRgb background = palette().color(QPalette::Window).rgb();
   Scope::const_iterator it = s.begin(), end = s.end();
 
-  for (int y = height() - 1; y;) {
-    QColor c;
+  for (int y = canvas_.height() - 1; y; --y) {
+    QRgb c = 0;
     if (it >= end || *it < .005) {
-      c = palette().color(QPalette::Window);
+      c = background;
     }
     else if (*it < .05) {
-      c.setHsv(95, 255, 255 - static_cast<int>(*it * 4000.0));
+      c = QColor::fromHsv(95, 255, 255 - static_cast<int>(*it * 4000.0)).rgb();
     }
     else if (*it < 1.0) {
-      c.setHsv(95 - static_cast<int>(*it * 90.0), 255, 255);
+      c = QColor::fromHsv(95 - static_cast<int>(*it * 90.0), 255, 255).rgb();
     }
     else {
-      c = Qt::red;
+      c = qRgb(255, 0, 0);
     }
 
-    canvas_painter.setPen(c);
-    canvas_painter.drawPoint(width() - 1, y--);
+    reinterpret_cast<QRgb*>(canvas_.scanLine(y))[x] = c;
 
     if (it < end) ++it;
   }
 
-  canvas_painter.end();
+  canvas_column_ = (canvas_column_ + 1) % canvas_.width();
 
-  p.drawPixmap(0, 0, canvas_);
+  DrawCanvas(p);
+
+}
+
+void SonogramAnalyzer::DrawCanvas(QPainter &p) const {
+
+  if (canvas_.isNull()) return;
+
+  const int w = canvas_.width();
+  const int h = canvas_.height();
+
+  // The columns from the oldest to the end of the image, then the ones wrapped around to the start.
+  p.drawImage(QPoint(0, 0), canvas_, QRect(canvas_column_, 0, w - canvas_column_, h));
+  if (canvas_column_ > 0) {
+    p.drawImage(QPoint(w - canvas_column_, 0), canvas_, QRect(0, 0, canvas_column_, h));
+  }
 
 }
 
@@ -24,7 +24,7 @@
 #ifndef SONOGRAMANALYZER_H
 #define SONOGRAMANALYZER_H
 
-#include <QPixmap>
+#include <QImage>
 #include <QPainter>
 
 #include "analyzerbase.h"
@@ -44,7 +44,15 @@ class SonogramAnalyzer : public AnalyzerBase {
   void demo(QPainter &p) override;
 
  private:
-  QPixmap canvas_;
+  // Draws the canvas with the oldest column on the left.
+  void DrawCanvas(QPainter &p) const;
+
+ private:
+  // Ring buffer of columns written directly in memory, rather than painted point by point.
+  // Each frame overwrites the oldest column instead of scrolling the whole image.
+  QImage canvas_;
+  // Column the next frame is written to, the oldest column on screen.
+  int canvas_column_;
 };
 
 #endif  // SONOGRAMANALYZER_H
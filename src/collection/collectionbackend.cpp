@@ -23,15 +23,19 @@
 
 #include <optional>
 #include <utility>
+#include <algorithm>
 
 #include <QtGlobal>
 #include <QObject>
 #include <QApplication>
 #include <QThread>
 #include <QMutex>
+#include <QMutexLocker>
 #include <QSet>
 #include <QMap>
+#include <QHash>
 #include <QList>
+#include <QPair>
 #include <QVariant>
 #include <QByteArray>
 #include <QString>
@@ -41,6 +45,7 @@
 #include <QFileInfo>
 #include <QDateTime>
 #include <QRegularExpression>
+#include <QTimer>
 #include <QSqlDatabase>
 #include <QSqlQuery>
 #include <QSqlError>
@@ -52,22 +57,81 @@
 #include "core/song.h"
 
 #include "collectiondirectory.h"
+#include "collectionplaystatistics.h"
 #include "collectionbackend.h"
+#include "collectionlibrary.h"
 #include "collectionfilteroptions.h"
 #include "collectionquery.h"
 #include "collectiontask.h"
+#include "fingerprintindex.h"
 
 using namespace Qt::Literals::StringLiterals;
 
+namespace {
+constexpr int kBulkSongsThreshold = 500;
+constexpr int kMaxBoundVariables = 999;
+constexpr int kFlushStatisticsDelayMsec = 3000;
+constexpr int kFingerprintIndexBatchSize = 1000;
+constexpr int kFingerprintBandMaxSongs = 50;
+
+// Temporary tables with the keys for multi-row statements, see Database::LoadTemporaryKeys().
+constexpr char kKeysTable[] = "collection_keys";
+constexpr char kAlbumKeysTable[] = "collection_album_keys";
+
+QString AlbumKey(const QString &effective_albumartist, const QString &album) {
+  return effective_albumartist + QLatin1Char('\n') + album;
+}
+
+QVariantList SongIds(const SongList &songs) {
+
+  QVariantList ids;
+  ids.reserve(songs.count());
+  for (const Song &song : songs) {
+    ids << song.id();
+  }
+  return ids;
+
+}
+
+// Each URL is matched in 4 encodings, like GetSongsByUrl().
+QVariantList UrlKeys(const QList<QUrl> &urls) {
+
+  QVariantList keys;
+  keys.reserve(urls.count() * 4);
+  for (const QUrl &url : urls) {
+    keys << url.toString() << url.toString(QUrl::FullyEncoded) << url.toEncoded(QUrl::FullyDecoded) << url.toEncoded(QUrl::FullyEncoded);
+  }
+  return keys;
+
+}
+
+}  // namespace
+
 CollectionBackend::CollectionBackend(QObject *parent)
     : CollectionBackendInterface(parent),
       db_(nullptr),
       task_manager_(nullptr),
       source_(Song::Source::Unknown),
-      original_thread_(nullptr) {
+      long_text_(false),
+      original_thread_(nullptr),
+      timer_flush_statistics_(new QTimer(this)),
+      cache_generation_(0) {
 
   original_thread_ = thread();
 
+  timer_flush_statistics_->setSingleShot(true);
+  timer_flush_statistics_->setInterval(kFlushStatisticsDelayMsec);
+  QObject::connect(timer_flush_statistics_, &QTimer::timeout, this, &CollectionBackend::FlushStatistics);
+
+  // Keep the song index up to date right away, the changes can be emitted from other threads.
+  QObject::connect(this, &CollectionBackend::SongsAdded, this, [this]() { song_index_.SongsAdded(); }, Qt::DirectConnection);
+  QObject::connect(this, &CollectionBackend::SongsChanged, this, [this](const SongList &songs) { song_index_.RemoveSongs(songs); }, Qt::DirectConnection);
+  QObject::connect(this, &CollectionBackend::SongsDeleted, this, [this](const SongList &songs) { song_index_.RemoveSongs(songs); }, Qt::DirectConnection);
+  QObject::connect(this, &CollectionBackend::AlbumArtChanged, this, [this](const SongList &songs) { song_index_.RemoveSongs(songs); }, Qt::DirectConnection);
+  QObject::connect(this, &CollectionBackend::SongsStatisticsChanged, this, [this](const SongList &songs) { song_index_.RemoveSongs(songs); }, Qt::DirectConnection);
+  QObject::connect(this, &CollectionBackend::SongsRatingChanged, this, [this](const SongList &songs) { song_index_.RemoveSongs(songs); }, Qt::DirectConnection);
+  QObject::connect(this, &CollectionBackend::DatabaseReset, this, [this]() { song_index_.Clear(); }, Qt::DirectConnection);
+
 }
 
 CollectionBackend::~CollectionBackend() {
@@ -86,6 +150,8 @@ void CollectionBackend::Init(SharedPtr<Database> db, SharedPtr<TaskManager> task
   songs_table_ = songs_table;
   dirs_table_ = dirs_table;
   subdirs_table_ = subdirs_table;
+  long_text_ = songs_table_ == QLatin1String(CollectionLibrary::kSongsTable);
+  column_spec_ = long_text_ ? Song::LongTextJoinSpec(songs_table_) : Song::kRowIdColumnSpec;
 
 }
 
@@ -106,6 +172,8 @@ void CollectionBackend::Exit() {
 
   Q_ASSERT(QThread::currentThread() == thread());
 
+  FlushStatistics();
+
   moveToThread(original_thread_);
   Q_EMIT ExitFinished();
 
@@ -135,7 +203,7 @@ void CollectionBackend::GetAllSongs(const int id) {
 
   SqlQuery q(db);
   q.setForwardOnly(true);
-  q.prepare(QStringLiteral("SELECT %1 FROM %2").arg(Song::kRowIdColumnSpec, songs_table_));
+  q.prepare(QStringLiteral("SELECT %1 FROM %2").arg(column_spec_, songs_table_));
   if (!q.exec()) {
     db_->ReportErrors(q);
     Q_EMIT GotSongs(SongList(), id);
@@ -247,6 +315,10 @@ void CollectionBackend::ChangeDirPath(const int id, const QString &old_path, con
 
   t.Commit();
 
+  song_index_.Clear();
+
+  UpdateCache(SongList(), false);
+
 }
 
 CollectionDirectoryList CollectionBackend::GetAllDirectories() {
@@ -285,7 +357,7 @@ CollectionSubdirectoryList CollectionBackend::SubdirsInDirectory(const int id) {
 CollectionSubdirectoryList CollectionBackend::SubdirsInDirectory(const int id, QSqlDatabase &db) {
 
   SqlQuery q(db);
-  q.prepare(QStringLiteral("SELECT path, mtime FROM %1 WHERE directory_id = :dir").arg(subdirs_table_));
+  q.prepare(QStringLiteral("SELECT path, mtime, art_automatic FROM %1 WHERE directory_id = :dir").arg(subdirs_table_));
   q.BindValue(u":dir"_s, id);
   if (!q.Exec()) {
     db_->ReportErrors(q);
@@ -298,6 +370,7 @@ CollectionSubdirectoryList CollectionBackend::SubdirsInDirectory(const int id, Q
     subdir.directory_id = id;
     subdir.path = q.value(0).toString();
     subdir.mtime = q.value(1).toLongLong();
+    subdir.art_automatic = q.value(2).toString();
     subdirs << subdir;
   }
 
@@ -307,6 +380,16 @@ CollectionSubdirectoryList CollectionBackend::SubdirsInDirectory(const int id, Q
 
 void CollectionBackend::UpdateTotalSongCount() {
 
+  quint64 generation = 0;
+  {
+    QMutexLocker l(&mutex_cache_);
+    if (cached_song_count_) {
+      Q_EMIT TotalSongCountUpdated(cached_song_count_.value());
+      return;
+    }
+    generation = cache_generation_;
+  }
+
   QMutexLocker l(db_->Mutex());
   QSqlDatabase db(db_->Connect());
 
@@ -321,47 +404,119 @@ void CollectionBackend::UpdateTotalSongCount() {
     return;
   }
 
-  Q_EMIT TotalSongCountUpdated(q.value(0).toInt());
+  const int count = q.value(0).toInt();
+  {
+    QMutexLocker l_cache(&mutex_cache_);
+    if (cache_generation_ == generation) cached_song_count_ = count;
+  }
+
+  Q_EMIT TotalSongCountUpdated(count);
 
 }
 
 void CollectionBackend::UpdateTotalArtistCount() {
 
+  quint64 generation = 0;
+  {
+    QMutexLocker l(&mutex_cache_);
+    if (cached_artist_songs_) {
+      Q_EMIT TotalArtistCountUpdated(static_cast<int>(cached_artist_songs_->count()));
+      return;
+    }
+    generation = cache_generation_;
+  }
+
   QMutexLocker l(db_->Mutex());
   QSqlDatabase db(db_->Connect());
 
+  // Count the songs of each artist, so the total can be updated when songs are added.
   SqlQuery q(db);
-  q.prepare(QStringLiteral("SELECT COUNT(DISTINCT artist) FROM %1 WHERE unavailable = 0").arg(songs_table_));
+  q.prepare(QStringLiteral("SELECT artist, COUNT(*) FROM %1 WHERE unavailable = 0 AND artist IS NOT NULL GROUP BY artist").arg(songs_table_));
   if (!q.Exec()) {
     db_->ReportErrors(q);
     return;
   }
-  if (!q.next()) {
-    db_->ReportErrors(q);
-    return;
+
+  QHash<QString, int> artist_songs;
+  while (q.next()) {
+    artist_songs.insert(q.value(0).toString(), q.value(1).toInt());
   }
 
-  Q_EMIT TotalArtistCountUpdated(q.value(0).toInt());
+  {
+    QMutexLocker l_cache(&mutex_cache_);
+    if (cache_generation_ == generation) cached_artist_songs_ = artist_songs;
+  }
+
+  Q_EMIT TotalArtistCountUpdated(static_cast<int>(artist_songs.count()));
 
 }
 
 void CollectionBackend::UpdateTotalAlbumCount() {
 
+  quint64 generation = 0;
+  {
+    QMutexLocker l(&mutex_cache_);
+    if (cached_album_songs_) {
+      Q_EMIT TotalAlbumCountUpdated(static_cast<int>(cached_album_songs_->count()));
+      return;
+    }
+    generation = cache_generation_;
+  }
+
   QMutexLocker l(db_->Mutex());
   QSqlDatabase db(db_->Connect());
 
   SqlQuery q(db);
-  q.prepare(QStringLiteral("SELECT COUNT(*) FROM (SELECT DISTINCT effective_albumartist, album FROM %1 WHERE unavailable = 0)").arg(songs_table_));
+  q.prepare(QStringLiteral("SELECT effective_albumartist, album, COUNT(*) FROM %1 WHERE unavailable = 0 GROUP BY effective_albumartist, album").arg(songs_table_));
   if (!q.Exec()) {
     db_->ReportErrors(q);
     return;
   }
-  if (!q.next()) {
-    db_->ReportErrors(q);
+
+  QHash<QString, int> album_songs;
+  while (q.next()) {
+    album_songs.insert(AlbumKey(q.value(0).toString(), q.value(1).toString()), q.value(2).toInt());
+  }
+
+  {
+    QMutexLocker l_cache(&mutex_cache_);
+    if (cache_generation_ == generation) cached_album_songs_ = album_songs;
+  }
+
+  Q_EMIT TotalAlbumCountUpdated(static_cast<int>(album_songs.count()));
+
+}
+
+QString CollectionBackend::CacheKey(const QString &query, const QString &argument, const CollectionFilterOptions &filter_options) {
+
+  // The result of a maximum age filter changes with the time.
+  if (filter_options.max_age() != -1) return QString();
+
+  return QStringList({ query, argument, QString::number(static_cast<int>(filter_options.filter_mode())), QString::number(filter_options.min_rating()), filter_options.filter_text() }).join(QLatin1Char('\n'));
+
+}
+
+void CollectionBackend::UpdateCache(const SongList &added_songs, const bool recount) {
+
+  QMutexLocker l(&mutex_cache_);
+
+  ++cache_generation_;
+  cached_string_lists_.clear();
+  cached_album_lists_.clear();
+
+  if (recount) {
+    cached_song_count_.reset();
+    cached_artist_songs_.reset();
+    cached_album_songs_.reset();
     return;
   }
 
-  Q_EMIT TotalAlbumCountUpdated(q.value(0).toInt());
+  for (const Song &song : added_songs) {
+    if (song.unavailable()) continue;
+    if (cached_song_count_) ++*cached_song_count_;
+    if (cached_artist_songs_) ++(*cached_artist_songs_)[song.artist()];
+    if (cached_album_songs_) ++(*cached_album_songs_)[AlbumKey(song.effective_albumartist(), song.album())];
+  }
 
 }
 
@@ -451,7 +606,7 @@ SongList CollectionBackend::FindSongsInDirectory(const int id) {
   QSqlDatabase db(db_->Connect());
 
   SqlQuery q(db);
-  q.prepare(QStringLiteral("SELECT %1 FROM %2 WHERE directory_id = :directory_id").arg(Song::kRowIdColumnSpec, songs_table_));
+  q.prepare(QStringLiteral("SELECT %1 FROM %2 WHERE directory_id = :directory_id").arg(column_spec_, songs_table_));
   q.BindValue(u":directory_id"_s, id);
   if (!q.Exec()) {
     db_->ReportErrors(q);
@@ -474,7 +629,7 @@ SongList CollectionBackend::SongsWithMissingFingerprint(const int id) {
   QSqlDatabase db(db_->Connect());
 
   SqlQuery q(db);
-  q.prepare(QStringLiteral("SELECT %1 FROM %2 WHERE directory_id = :directory_id AND unavailable = 0 AND (fingerprint IS NULL OR fingerprint = '')").arg(Song::kRowIdColumnSpec, songs_table_));
+  q.prepare(QStringLiteral("SELECT %1 FROM %2 WHERE directory_id = :directory_id AND unavailable = 0 AND (fingerprint IS NULL OR fingerprint = '')").arg(column_spec_, songs_table_));
   q.BindValue(u":directory_id"_s, id);
   if (!q.Exec()) {
     db_->ReportErrors(q);
@@ -497,7 +652,7 @@ SongList CollectionBackend::SongsWithMissingLoudnessCharacteristics(const int id
   QSqlDatabase db(db_->Connect());
 
   SqlQuery q(db);
-  q.prepare(QStringLiteral("SELECT %1 FROM %2 WHERE directory_id = :directory_id AND unavailable = 0 AND (ebur128_integrated_loudness_lufs IS NULL OR ebur128_loudness_range_lu IS NULL)").arg(Song::kRowIdColumnSpec, songs_table_));
+  q.prepare(QStringLiteral("SELECT %1 FROM %2 WHERE directory_id = :directory_id AND unavailable = 0 AND (ebur128_integrated_loudness_lufs IS NULL OR ebur128_loudness_range_lu IS NULL)").arg(column_spec_, songs_table_));
   q.BindValue(u":directory_id"_s, id);
   if (!q.Exec()) {
     db_->ReportErrors(q);
@@ -516,17 +671,29 @@ SongList CollectionBackend::SongsWithMissingLoudnessCharacteristics(const int id
 
 void CollectionBackend::SongPathChanged(const Song &song, const QFileInfo &new_file, const std::optional<int> new_collection_directory_id) {
 
-  // Take a song and update its path
-  Song updated_song = song;
-  updated_song.set_source(source_);
-  updated_song.set_url(QUrl::fromLocalFile(QDir::cleanPath(new_file.filePath())));
-  updated_song.set_basefilename(new_file.fileName());
-  updated_song.InitArtManual();
-  if (updated_song.is_linked_collection_song() && new_collection_directory_id) {
-    updated_song.set_directory_id(new_collection_directory_id.value());
+  SongsPathChanged(SongList() << song, QList<QFileInfo>() << new_file, new_collection_directory_id);
+
+}
+
+void CollectionBackend::SongsPathChanged(const SongList &songs, const QList<QFileInfo> &new_files, const std::optional<int> new_collection_directory_id) {
+
+  // Take the songs and update their paths, all in one transaction.
+  SongList updated_songs;
+  updated_songs.reserve(songs.count());
+  for (qsizetype i = 0; i < songs.count() && i < new_files.count(); ++i) {
+    const QFileInfo &new_file = new_files[i];
+    Song updated_song = songs[i];
+    updated_song.set_source(source_);
+    updated_song.set_url(QUrl::fromLocalFile(QDir::cleanPath(new_file.filePath())));
+    updated_song.set_basefilename(new_file.fileName());
+    updated_song.InitArtManual();
+    if (updated_song.is_linked_collection_song() && new_collection_directory_id) {
+      updated_song.set_directory_id(new_collection_directory_id.value());
+    }
+    updated_songs << updated_song;
   }
 
-  AddOrUpdateSongs(SongList() << updated_song);
+  AddOrUpdateSongs(updated_songs);
 
 }
 
@@ -553,8 +720,9 @@ void CollectionBackend::AddOrUpdateSubdirs(const CollectionSubdirectoryList &sub
 
     if (exists) {
       SqlQuery q(db);
-      q.prepare(QStringLiteral("UPDATE %1 SET mtime = :mtime WHERE directory_id = :id AND path = :path").arg(subdirs_table_));
+      q.prepare(QStringLiteral("UPDATE %1 SET mtime = :mtime, art_automatic = :art_automatic WHERE directory_id = :id AND path = :path").arg(subdirs_table_));
       q.BindValue(u":mtime"_s, subdir.mtime);
+      q.BindValue(u":art_automatic"_s, subdir.art_automatic);
       q.BindValue(u":id"_s, subdir.directory_id);
       q.BindValue(u":path"_s, subdir.path);
       if (!q.Exec()) {
@@ -564,10 +732,11 @@ void CollectionBackend::AddOrUpdateSubdirs(const CollectionSubdirectoryList &sub
     }
     else {
       SqlQuery q(db);
-      q.prepare(QStringLiteral("INSERT INTO %1 (directory_id, path, mtime) VALUES (:id, :path, :mtime)").arg(subdirs_table_));
+      q.prepare(QStringLiteral("INSERT INTO %1 (directory_id, path, mtime, art_automatic) VALUES (:id, :path, :mtime, :art_automatic)").arg(subdirs_table_));
       q.BindValue(u":id"_s, subdir.directory_id);
       q.BindValue(u":path"_s, subdir.path);
       q.BindValue(u":mtime"_s, subdir.mtime);
+      q.BindValue(u":art_automatic"_s, subdir.art_automatic);
       if (!q.Exec()) {
         db_->ReportErrors(q);
         return;
@@ -606,7 +775,7 @@ SongList CollectionBackend::GetAllSongs() {
   QSqlDatabase db(db_->Connect());
 
   SqlQuery q(db);
-  q.prepare(QStringLiteral("SELECT %1 FROM %2").arg(Song::kRowIdColumnSpec, songs_table_));
+  q.prepare(QStringLiteral("SELECT %1 FROM %2").arg(column_spec_, songs_table_));
   if (!q.Exec()) {
     db_->ReportErrors(q);
     return SongList();
@@ -632,110 +801,235 @@ void CollectionBackend::AddOrUpdateSongs(const SongList &songs) {
   QSqlDatabase db(db_->Connect());
 
   CollectionTask task(task_manager_, tr("Updating %1 database.").arg(Song::TextForSource(source_)));
-  ScopedTransaction transaction(&db);
+
+  // For large batches, such as the first scan of a collection, don't wait for the data to reach the disk after every statement.
+  // The transaction is still atomic, and the previous setting is restored after the commit.
+  const bool bulk = songs.count() >= kBulkSongsThreshold;
+  QVariant synchronous;
+  if (bulk) {
+    SqlQuery q(db);
+    q.prepare(u"PRAGMA synchronous"_s);
+    if (q.Exec() && q.next()) {
+      synchronous = q.value(0);
+      SqlQuery q_set(db);
+      q_set.prepare(u"PRAGMA synchronous = OFF"_s);
+      if (!q_set.Exec()) {
+        db_->ReportErrors(q_set);
+        synchronous.clear();
+      }
+    }
+  }
+
+  const auto restore_synchronous = [this, &db, &synchronous]() {
+    if (!synchronous.isValid()) return;
+    SqlQuery q(db);
+    q.prepare(u"PRAGMA synchronous = %1"_s.arg(synchronous.toInt()));
+    if (!q.Exec()) {
+      db_->ReportErrors(q);
+    }
+  };
 
   SongList added_songs;
   SongList changed_songs;
 
-  for (const Song &song : songs) {
+  {
+    ScopedTransaction transaction(&db);
 
     // Do a sanity check first - make sure the song's directory still exists
     // This is to fix a possible race condition when a directory is removed while CollectionWatcher is scanning it.
+    QSet<int> directory_ids;
     if (!dirs_table_.isEmpty()) {
-      SqlQuery check_dir(db);
-      check_dir.prepare(QStringLiteral("SELECT ROWID FROM %1 WHERE ROWID = :id").arg(dirs_table_));
-      check_dir.BindValue(u":id"_s, song.directory_id());
-      if (!check_dir.Exec()) {
-        db_->ReportErrors(check_dir);
+      SqlQuery q(db);
+      q.prepare(QStringLiteral("SELECT ROWID FROM %1").arg(dirs_table_));
+      if (!q.Exec()) {
+        db_->ReportErrors(q);
+        restore_synchronous();
         return;
       }
+      while (q.next()) {
+        directory_ids.insert(q.value(0).toInt());
+      }
+    }
 
-      if (!check_dir.next()) continue;
+    SqlQuery q_update(db);
+    q_update.prepare(QStringLiteral("UPDATE %1 SET %2 WHERE ROWID = :id").arg(songs_table_, Song::kUpdateSpec));
 
-    }
+    // New songs are inserted in batches, pending_song_ids makes sure a song id occurring twice still updates the first instance.
+    SongList new_songs;
+    QSet<QString> pending_song_ids;
 
-    if (song.id() != -1) {  // This song exists in the DB.
+    for (const Song &song : songs) {
 
-      // Get the previous song data first
-      Song old_song(GetSongById(song.id()));
-      if (!old_song.is_valid()) continue;
+      if (!dirs_table_.isEmpty() && !directory_ids.contains(song.directory_id())) continue;
 
-      // Update
-      {
-        SqlQuery q(db);
-        q.prepare(QStringLiteral("UPDATE %1 SET %2 WHERE ROWID = :id").arg(songs_table_, Song::kUpdateSpec));
-        song.BindToQuery(&q);
-        q.BindValue(u":id"_s, song.id());
-        if (!q.Exec()) {
-          db_->ReportErrors(q);
+      Song update_song = song;
+      bool update = false;
+      if (song.id() != -1) {  // This song exists in the DB.
+        // Get the previous song data first
+        const Song old_song = GetSongById(song.id(), db);
+        if (!old_song.is_valid()) continue;
+        update = true;
+      }
+      else if (!song.song_id().isEmpty()) {  // Song has a unique id, check if the song exists.
+        if (pending_song_ids.contains(song.song_id())) {
+          if (!InsertSongs(db, new_songs, added_songs)) {
+            restore_synchronous();
+            return;
+          }
+          new_songs.clear();
+          pending_song_ids.clear();
+        }
+        // Get the previous song data first
+        const Song old_song = GetSongBySongId(song.song_id(), db);
+        if (old_song.is_valid() && old_song.id() != -1) {
+          update_song.set_id(old_song.id());
+          update = true;
+        }
+      }
+
+      if (update) {
+        BindSongToQuery(update_song, &q_update);
+        q_update.BindValue(u":id"_s, update_song.id());
+        if (!q_update.Exec()) {
+          db_->ReportErrors(q_update);
+          restore_synchronous();
+          return;
+        }
+        if (!SaveLongText(db, update_song)) {
+          restore_synchronous();
           return;
         }
+        changed_songs << update_song;
+        continue;
       }
 
-      changed_songs << song;
+      // Create new song
+      new_songs << song;
+      if (!song.song_id().isEmpty()) {
+        pending_song_ids.insert(song.song_id());
+      }
 
-      continue;
+    }
 
+    if (!InsertSongs(db, new_songs, added_songs)) {
+      restore_synchronous();
+      return;
     }
-    else if (!song.song_id().isEmpty()) {  // Song has a unique id, check if the song exists.
 
-      // Get the previous song data first
-      Song old_song(GetSongBySongId(song.song_id()));
+    transaction.Commit();
+  }
 
-      if (old_song.is_valid() && old_song.id() != -1) {
+  restore_synchronous();
 
-        Song new_song = song;
-        new_song.set_id(old_song.id());
+  UpdateCache(added_songs, !changed_songs.isEmpty());
 
-        // Update
-        {
-          SqlQuery q(db);
-          q.prepare(QStringLiteral("UPDATE %1 SET %2 WHERE ROWID = :id").arg(songs_table_, Song::kUpdateSpec));
-          new_song.BindToQuery(&q);
-          q.BindValue(u":id"_s, new_song.id());
-          if (!q.Exec()) {
-            db_->ReportErrors(q);
-            return;
-          }
-        }
+  if (!added_songs.isEmpty()) Q_EMIT SongsAdded(std::move(added_songs));
+  if (!changed_songs.isEmpty()) Q_EMIT SongsChanged(std::move(changed_songs));
 
-        changed_songs << new_song;
+  UpdateTotalSongCountAsync();
+  UpdateTotalArtistCountAsync();
+  UpdateTotalAlbumCountAsync();
 
-        continue;
+}
+
+bool CollectionBackend::InsertSongs(QSqlDatabase &db, const SongList &songs, SongList &added_songs) {
+
+  if (songs.isEmpty()) return true;
+
+  // Insert several rows per statement, staying below SQLite's historic limit of 999 bound variables.
+  const qint64 rows_per_statement = std::max(static_cast<qint64>(1), static_cast<qint64>(kMaxBoundVariables / Song::kColumns.count()));
+
+  // The statement for full batches is prepared once and reused, only the last batch may need a shorter one.
+  std::optional<SqlQuery> q_full;
+
+  for (qint64 offset = 0; offset < songs.count(); offset += rows_per_statement) {
+    const qint64 rows = std::min(rows_per_statement, songs.count() - offset);
+
+    QStringList values;
+    values.reserve(rows);
+    for (qint64 row = 0; row < rows; ++row) {
+      const QString suffix = u"_%1_"_s.arg(row);
+      QStringList binds;
+      binds.reserve(Song::kColumns.count());
+      for (const QString &column : Song::kColumns) {
+        binds << u":"_s + column + suffix;
       }
+      values << u"("_s + binds.join(", "_L1) + u")"_s;
+    }
+
+    std::optional<SqlQuery> q_partial;
+    SqlQuery *q = nullptr;
+    if (rows == rows_per_statement && q_full) {
+      q = &*q_full;
+    }
+    else {
+      std::optional<SqlQuery> &q_new = rows == rows_per_statement ? q_full : q_partial;
+      q_new.emplace(db);
+      q_new->prepare(QStringLiteral("INSERT INTO %1 (%2) VALUES %3").arg(songs_table_, Song::kColumnSpec, values.join(", "_L1)));
+      q = &*q_new;
     }
 
-    // Create new song
+    for (qint64 row = 0; row < rows; ++row) {
+      q->SetPlaceholderSuffix(u"_%1_"_s.arg(row));
+      BindSongToQuery(songs[offset + row], q);
+    }
+    q->SetPlaceholderSuffix(QString());
 
-    int id = -1;
-    {  // Insert the row and create a new ID
-      SqlQuery q(db);
-      q.prepare(QStringLiteral("INSERT INTO %1 (%2) VALUES (%3)").arg(songs_table_, Song::kColumnSpec, Song::kBindSpec));
-      song.BindToQuery(&q);
-      if (!q.Exec()) {
-        db_->ReportErrors(q);
-        return;
-      }
-      // Get the new ID
-      id = q.lastInsertId().toInt();
+    if (!q->Exec()) {
+      db_->ReportErrors(*q);
+      return false;
+    }
+
+    // SQLite assigns consecutive row ids to the rows of a single INSERT statement.
+    const int last_id = q->lastInsertId().toInt();
+    if (last_id <= 0) return false;
+
+    for (qint64 row = 0; row < rows; ++row) {
+      Song song_copy(songs[offset + row]);
+      song_copy.set_id(last_id - static_cast<int>(rows - 1 - row));
+      if (song_copy.lyrics().size() >= Song::kLongTextMinSize && !SaveLongText(db, song_copy)) return false;
+      added_songs << song_copy;
     }
+  }
+
+  return true;
 
-    if (id == -1) return;
+}
 
-    Song song_copy(song);
-    song_copy.set_id(id);
-    added_songs << song_copy;
+void CollectionBackend::BindSongToQuery(const Song &song, SqlQuery *q) const {
 
+  song.BindToQuery(q);
+  if (long_text_ && song.lyrics().size() >= Song::kLongTextMinSize) {
+    q->BindValue(u":lyrics"_s, QVariant());
   }
 
-  transaction.Commit();
+}
 
-  if (!added_songs.isEmpty()) Q_EMIT SongsAdded(added_songs);
-  if (!changed_songs.isEmpty()) Q_EMIT SongsChanged(changed_songs);
+bool CollectionBackend::SaveLongText(QSqlDatabase &db, const Song &song) {
 
-  UpdateTotalSongCountAsync();
-  UpdateTotalArtistCountAsync();
-  UpdateTotalAlbumCountAsync();
+  if (!long_text_) return true;
+
+  if (song.lyrics().size() >= Song::kLongTextMinSize) {
+    SqlQuery q = db_->PreparedQuery(db, QStringLiteral("INSERT OR REPLACE INTO %1 (song_id, lyrics) VALUES (:song_id, :lyrics)").arg(QLatin1String(Song::kLongTextTable)));
+    q.BindValue(u":song_id"_s, song.id());
+    q.BindValue(u":lyrics"_s, Song::CompressLongText(song.lyrics()));
+    if (!q.Exec()) {
+      db_->ReportErrors(q);
+      return false;
+    }
+    q.finish();
+  }
+  else {
+    SqlQuery q = db_->PreparedQuery(db, QStringLiteral("DELETE FROM %1 WHERE song_id = :song_id").arg(QLatin1String(Song::kLongTextTable)));
+    q.BindValue(u":song_id"_s, song.id());
+    if (!q.Exec()) {
+      db_->ReportErrors(q);
+      return false;
+    }
+    q.finish();
+  }
+
+  return true;
 
 }
 
@@ -832,9 +1126,11 @@ void CollectionBackend::UpdateSongsBySongID(const SongMap &new_songs) {
 
   transaction.Commit();
 
-  if (!deleted_songs.isEmpty()) Q_EMIT SongsDeleted(deleted_songs);
-  if (!added_songs.isEmpty()) Q_EMIT SongsAdded(added_songs);
-  if (!changed_songs.isEmpty()) Q_EMIT SongsChanged(changed_songs);
+  UpdateCache(added_songs, !deleted_songs.isEmpty() || !changed_songs.isEmpty());
+
+  if (!deleted_songs.isEmpty()) Q_EMIT SongsDeleted(std::move(deleted_songs));
+  if (!added_songs.isEmpty()) Q_EMIT SongsAdded(std::move(added_songs));
+  if (!changed_songs.isEmpty()) Q_EMIT SongsChanged(std::move(changed_songs));
 
   UpdateTotalSongCountAsync();
   UpdateTotalArtistCountAsync();
@@ -842,6 +1138,10 @@ void CollectionBackend::UpdateSongsBySongID(const SongMap &new_songs) {
 
 }
 
+void CollectionBackend::UpdateMTimesOnlyAsync(const SongList &songs) {
+  QMetaObject::invokeMethod(this, "UpdateMTimesOnly", Qt::QueuedConnection, Q_ARG(SongList, songs));
+}
+
 void CollectionBackend::UpdateMTimesOnly(const SongList &songs) {
 
   QMutexLocker l(db_->Mutex());
@@ -850,7 +1150,8 @@ void CollectionBackend::UpdateMTimesOnly(const SongList &songs) {
   ScopedTransaction transaction(&db);
   for (const Song &song : songs) {
     SqlQuery q(db);
-    q.prepare(QStringLiteral("UPDATE %1 SET mtime = :mtime WHERE ROWID = :id").arg(songs_table_));
+    q.prepare(QStringLiteral("UPDATE %1 SET filesize = :filesize, mtime = :mtime WHERE ROWID = :id").arg(songs_table_));
+    q.BindValue(u":filesize"_s, song.filesize());
     q.BindValue(u":mtime"_s, song.mtime());
     q.BindValue(u":id"_s, song.id());
     if (!q.Exec()) {
@@ -860,6 +1161,8 @@ void CollectionBackend::UpdateMTimesOnly(const SongList &songs) {
   }
   transaction.Commit();
 
+  song_index_.RemoveSongs(songs);
+
 }
 
 void CollectionBackend::DeleteSongsAsync(const SongList &songs) {
@@ -872,18 +1175,20 @@ void CollectionBackend::DeleteSongs(const SongList &songs) {
   QSqlDatabase db(db_->Connect());
 
   ScopedTransaction transaction(&db);
-  for (const Song &song : songs) {
-    SqlQuery q(db);
-    q.prepare(QStringLiteral("DELETE FROM %1 WHERE ROWID = :id").arg(songs_table_));
-    q.BindValue(u":id"_s, song.id());
-    if (!q.Exec()) {
-      db_->ReportErrors(q);
-      return;
-    }
+
+  if (!db_->LoadTemporaryKeys(db, QLatin1String(kKeysTable), SongIds(songs))) return;
+
+  SqlQuery q(db);
+  q.prepare(QStringLiteral("DELETE FROM %1 WHERE ROWID IN (SELECT key FROM temp.%2)").arg(songs_table_, QLatin1String(kKeysTable)));
+  if (!q.Exec()) {
+    db_->ReportErrors(q);
+    return;
   }
 
   transaction.Commit();
 
+  UpdateCache(SongList(), true);
+
   Q_EMIT SongsDeleted(songs);
 
   UpdateTotalSongCountAsync();
@@ -915,19 +1220,21 @@ void CollectionBackend::MarkSongsUnavailable(const SongList &songs, const bool u
   QMutexLocker l(db_->Mutex());
   QSqlDatabase db(db_->Connect());
 
-  SqlQuery query(db);
-  query.prepare(QStringLiteral("UPDATE %1 SET unavailable = %2 WHERE ROWID = :id").arg(songs_table_).arg(static_cast<int>(unavailable)));
-
   ScopedTransaction transaction(&db);
-  for (const Song &song : songs) {
-    query.BindValue(u":id"_s, song.id());
-    if (!query.Exec()) {
-      db_->ReportErrors(query);
-      return;
-    }
+
+  if (!db_->LoadTemporaryKeys(db, QLatin1String(kKeysTable), SongIds(songs))) return;
+
+  SqlQuery query(db);
+  query.prepare(QStringLiteral("UPDATE %1 SET unavailable = %2 WHERE ROWID IN (SELECT key FROM temp.%3)").arg(songs_table_).arg(static_cast<int>(unavailable)).arg(QLatin1String(kKeysTable)));
+  if (!query.Exec()) {
+    db_->ReportErrors(query);
+    return;
   }
+
   transaction.Commit();
 
+  UpdateCache(SongList(), true);
+
   if (unavailable) {
     Q_EMIT SongsDeleted(songs);
   }
@@ -943,6 +1250,14 @@ void CollectionBackend::MarkSongsUnavailable(const SongList &songs, const bool u
 
 QStringList CollectionBackend::GetAll(const QString &column, const CollectionFilterOptions &filter_options) {
 
+  const QString cache_key = CacheKey(u"all"_s, column, filter_options);
+  quint64 generation = 0;
+  if (!cache_key.isEmpty()) {
+    QMutexLocker l(&mutex_cache_);
+    if (cached_string_lists_.contains(cache_key)) return cached_string_lists_.value(cache_key);
+    generation = cache_generation_;
+  }
+
   QMutexLocker l(db_->Mutex());
   QSqlDatabase db(db_->Connect());
 
@@ -959,6 +1274,12 @@ QStringList CollectionBackend::GetAll(const QString &column, const CollectionFil
   while (query.Next()) {
     ret << query.Value(0).toString();
   }
+
+  if (!cache_key.isEmpty()) {
+    QMutexLocker l_cache(&mutex_cache_);
+    if (cache_generation_ == generation) cached_string_lists_.insert(cache_key, ret);
+  }
+
   return ret;
 
 }
@@ -971,6 +1292,14 @@ QStringList CollectionBackend::GetAllArtists(const CollectionFilterOptions &opt)
 
 QStringList CollectionBackend::GetAllArtistsWithAlbums(const CollectionFilterOptions &opt) {
 
+  const QString cache_key = CacheKey(u"artists_with_albums"_s, QString(), opt);
+  quint64 generation = 0;
+  if (!cache_key.isEmpty()) {
+    QMutexLocker l(&mutex_cache_);
+    if (cached_string_lists_.contains(cache_key)) return cached_string_lists_.value(cache_key);
+    generation = cache_generation_;
+  }
+
   QMutexLocker l(db_->Mutex());
   QSqlDatabase db(db_->Connect());
 
@@ -1005,7 +1334,14 @@ QStringList CollectionBackend::GetAllArtistsWithAlbums(const CollectionFilterOpt
     artists << query2.Value(0).toString();
   }
 
-  return QStringList(artists.values());
+  const QStringList ret = artists.values();
+
+  if (!cache_key.isEmpty()) {
+    QMutexLocker l_cache(&mutex_cache_);
+    if (cache_generation_ == generation) cached_string_lists_.insert(cache_key, ret);
+  }
+
+  return ret;
 
 }
 
@@ -1104,9 +1440,18 @@ bool CollectionBackend::ExecCollectionQuery(CollectionQuery *query, SongMap &son
 
 Song CollectionBackend::GetSongById(const int id) {
 
-  QMutexLocker l(db_->Mutex());
-  QSqlDatabase db(db_->Connect());
-  return GetSongById(id, db);
+  if (const std::optional<Song> song = song_index_.SongById(id)) return *song;
+
+  const quint64 generation = song_index_.generation();
+  Song song;
+  {
+    QMutexLocker l(db_->Mutex());
+    QSqlDatabase db(db_->Connect());
+    song = GetSongById(id, db);
+  }
+  song_index_.InsertSong(generation, song);
+
+  return song;
 
 }
 
@@ -1134,15 +1479,52 @@ SongList CollectionBackend::GetSongsById(const QStringList &ids) {
 
 }
 
+SongList CollectionBackend::GetCompleteSongs(const SongList &songs) {
+
+  QStringList ids;
+  for (const Song &song : songs) {
+    if (song.is_incomplete() && song.id() != -1) ids << QString::number(song.id());
+  }
+  if (ids.isEmpty()) return songs;
+
+  QHash<int, Song> complete_songs;
+  {
+    QMutexLocker l(db_->Mutex());
+    QSqlDatabase db(db_->Connect());
+    const SongList loaded_songs = GetSongsById(ids, db);
+    complete_songs.reserve(loaded_songs.count());
+    for (const Song &song : loaded_songs) {
+      complete_songs.insert(song.id(), song);
+    }
+  }
+
+  SongList ret;
+  ret.reserve(songs.count());
+  for (const Song &song : songs) {
+    ret << (song.is_incomplete() ? complete_songs.value(song.id(), song) : song);
+  }
+
+  return ret;
+
+}
+
 SongList CollectionBackend::GetSongsByForeignId(const QStringList &ids, const QString &table, const QString &column) {
 
   QMutexLocker l(db_->Mutex());
   QSqlDatabase db(db_->Connect());
 
-  QString in = ids.join(u',');
+  QVariantList keys;
+  keys.reserve(ids.count());
+  QHash<QString, qint64> indexes;
+  indexes.reserve(ids.count());
+  for (qint64 i = 0; i < ids.count(); ++i) {
+    keys << ids[i];
+    if (!indexes.contains(ids[i])) indexes.insert(ids[i], i);
+  }
+  if (!db_->LoadTemporaryKeys(db, QLatin1String(kKeysTable), keys)) return SongList();
 
   SqlQuery q(db);
-  q.prepare(QStringLiteral("SELECT %3.ROWID, %2, %3.%4 FROM %3, %1 WHERE %3.%4 IN (in) AND %1.ROWID = %3.ROWID AND unavailable = 0").arg(songs_table_, Song::kColumnSpec, table, column, in));
+  q.prepare(QStringLiteral("SELECT %3.ROWID, %2, %3.%4 FROM %3, %1 WHERE %3.%4 IN (SELECT key FROM temp.%5) AND %1.ROWID = %3.ROWID AND unavailable = 0").arg(songs_table_, Song::kColumnSpec, table, column, QLatin1String(kKeysTable)));
   if (!q.Exec()) {
     db_->ReportErrors(q);
     return SongList();
@@ -1151,7 +1533,7 @@ SongList CollectionBackend::GetSongsByForeignId(const QStringList &ids, const QS
   QList<Song> ret(ids.count());
   while (q.next()) {
     const QString foreign_id = q.value(static_cast<int>(Song::kColumns.count()) + 1).toString();
-    const qint64 index = ids.indexOf(foreign_id);
+    const qint64 index = indexes.value(foreign_id, -1);
     if (index == -1) continue;
 
     ret[index].InitFromQuery(q, true);
@@ -1162,18 +1544,37 @@ SongList CollectionBackend::GetSongsByForeignId(const QStringList &ids, const QS
 
 Song CollectionBackend::GetSongById(const int id, QSqlDatabase &db) {
 
-  SongList list = GetSongsById(QStringList() << QString::number(id), db);
-  if (list.isEmpty()) return Song();
-  return list.first();
+  SqlQuery q = db_->PreparedQuery(db, QStringLiteral("SELECT %1 FROM %2 WHERE ROWID = :id").arg(column_spec_, songs_table_));
+  q.BindValue(u":id"_s, id);
+  if (!q.Exec()) {
+    db_->ReportErrors(q);
+    return Song();
+  }
+
+  if (!q.next()) {
+    q.finish();
+    return Song();
+  }
+
+  Song song(source_);
+  song.InitFromQuery(q, true);
+  q.finish();
+
+  return song;
 
 }
 
 SongList CollectionBackend::GetSongsById(const QStringList &ids, QSqlDatabase &db) {
 
-  QString in = ids.join(u',');
+  QVariantList keys;
+  keys.reserve(ids.count());
+  for (const QString &id : ids) {
+    keys << id.toInt();
+  }
+  if (!db_->LoadTemporaryKeys(db, QLatin1String(kKeysTable), keys)) return SongList();
 
   SqlQuery q(db);
-  q.prepare(QStringLiteral("SELECT %1 FROM %2 WHERE ROWID IN (%3)").arg(Song::kRowIdColumnSpec, songs_table_, in));
+  q.prepare(QStringLiteral("SELECT %1 FROM %2 WHERE ROWID IN (SELECT key FROM temp.%3)").arg(column_spec_, songs_table_, QLatin1String(kKeysTable)));
   if (!q.Exec()) {
     db_->ReportErrors(q);
     return SongList();
@@ -1189,82 +1590,89 @@ SongList CollectionBackend::GetSongsById(const QStringList &ids, QSqlDatabase &d
 
 }
 
-Song CollectionBackend::GetSongByUrl(const QUrl &url, const qint64 beginning) {
+SongList CollectionBackend::GetAllSongsByUrl(const QUrl &url) {
 
-  QMutexLocker l(db_->Mutex());
-  QSqlDatabase db(db_->Connect());
+  if (std::optional<SongList> songs = song_index_.SongsByUrl(url)) return *songs;
 
-  SqlQuery q(db);
-  q.prepare(QStringLiteral("SELECT %1 FROM %2 WHERE (url = :url1 OR url = :url2 OR url = :url3 OR url = :url4) AND beginning = :beginning AND unavailable = 0").arg(Song::kRowIdColumnSpec, songs_table_));
-  q.BindValue(u":url1"_s, url.toString());
-  q.BindValue(u":url2"_s, url.toString(QUrl::FullyEncoded));
-  q.BindValue(u":url3"_s, url.toEncoded(QUrl::FullyDecoded));
-  q.BindValue(u":url4"_s, url.toEncoded(QUrl::FullyEncoded));
-  q.BindValue(u":beginning"_s, beginning);
+  const quint64 generation = song_index_.generation();
+  SongList songs;
+  {
+    QMutexLocker l(db_->Mutex());
+    QSqlDatabase db(db_->Connect());
 
-  if (!q.Exec()) {
-    db_->ReportErrors(q);
-    return Song();
-  }
+    SqlQuery q = db_->PreparedQuery(db, QStringLiteral("SELECT %1 FROM %2 WHERE url = :url1 OR url = :url2 OR url = :url3 OR url = :url4").arg(column_spec_, songs_table_));
+    q.BindValue(u":url1"_s, url.toString());
+    q.BindValue(u":url2"_s, url.toString(QUrl::FullyEncoded));
+    q.BindValue(u":url3"_s, url.toEncoded(QUrl::FullyDecoded));
+    q.BindValue(u":url4"_s, url.toEncoded(QUrl::FullyEncoded));
 
-  if (!q.next()) {
-    return Song();
+    if (!q.Exec()) {
+      db_->ReportErrors(q);
+      return SongList();
+    }
+    while (q.next()) {
+      Song song(source_);
+      song.InitFromQuery(q, true);
+      songs << song;
+    }
+    q.finish();
   }
 
-  Song song(source_);
-  song.InitFromQuery(q, true);
+  song_index_.InsertSongsByUrl(generation, url, songs);
 
-  return song;
+  return songs;
 
 }
 
-Song CollectionBackend::GetSongByUrlAndTrack(const QUrl &url, const int track) {
+Song CollectionBackend::GetSongByUrl(const QUrl &url, const qint64 beginning) {
 
-  QMutexLocker l(db_->Mutex());
-  QSqlDatabase db(db_->Connect());
+  const SongList songs = GetAllSongsByUrl(url);
+  for (const Song &song : songs) {
+    if (song.beginning_nanosec() == beginning && !song.unavailable()) return song;
+  }
 
-  SqlQuery q(db);
-  q.prepare(QStringLiteral("SELECT %1 FROM %2 WHERE (url = :url1 OR url = :url2 OR url = :url3 OR url = :url4) AND track = :track AND unavailable = 0").arg(Song::kRowIdColumnSpec, songs_table_));
-  q.BindValue(u":url1"_s, url.toString());
-  q.BindValue(u":url2"_s, url.toString(QUrl::FullyEncoded));
-  q.BindValue(u":url3"_s, url.toEncoded(QUrl::FullyDecoded));
-  q.BindValue(u":url4"_s, url.toEncoded(QUrl::FullyEncoded));
-  q.BindValue(u":track"_s, track);
+  return Song();
 
-  if (!q.Exec()) {
-    db_->ReportErrors(q);
-    return Song();
-  }
+}
 
-  if (!q.next()) {
-    return Song();
-  }
+Song CollectionBackend::GetSongByUrlAndTrack(const QUrl &url, const int track) {
 
-  Song song(source_);
-  song.InitFromQuery(q, true);
+  const SongList songs = GetAllSongsByUrl(url);
+  for (const Song &song : songs) {
+    if (song.track() == track && !song.unavailable()) return song;
+  }
 
-  return song;
+  return Song();
 
 }
 
 SongList CollectionBackend::GetSongsByUrl(const QUrl &url, const bool unavailable) {
 
+  SongList songs = GetAllSongsByUrl(url);
+  songs.removeIf([unavailable](const Song &song) { return song.unavailable() != unavailable; });
+
+  return songs;
+
+}
+
+SongList CollectionBackend::GetSongsByUrls(const QList<QUrl> &urls, const bool unavailable) {
+
+  if (urls.isEmpty()) return SongList();
+
   QMutexLocker l(db_->Mutex());
   QSqlDatabase db(db_->Connect());
 
+  if (!db_->LoadTemporaryKeys(db, QLatin1String(kKeysTable), UrlKeys(urls))) return SongList();
+
   SqlQuery q(db);
-  q.prepare(QStringLiteral("SELECT %1 FROM %2 WHERE (url = :url1 OR url = :url2 OR url = :url3 OR url = :url4) AND unavailable = :unavailable").arg(Song::kRowIdColumnSpec, songs_table_));
-  q.BindValue(u":url1"_s, url.toString());
-  q.BindValue(u":url2"_s, url.toString(QUrl::FullyEncoded));
-  q.BindValue(u":url3"_s, url.toEncoded(QUrl::FullyDecoded));
-  q.BindValue(u":url4"_s, url.toEncoded(QUrl::FullyEncoded));
+  q.prepare(QStringLiteral("SELECT %1 FROM %2 WHERE url IN (SELECT key FROM temp.%3) AND unavailable = :unavailable").arg(column_spec_, songs_table_, QLatin1String(kKeysTable)));
   q.BindValue(u":unavailable"_s, (unavailable ? 1 : 0));
-
-  SongList songs;
   if (!q.Exec()) {
     db_->ReportErrors(q);
     return SongList();
   }
+
+  SongList songs;
   while (q.next()) {
     Song song(source_);
     song.InitFromQuery(q, true);
@@ -1278,9 +1686,18 @@ SongList CollectionBackend::GetSongsByUrl(const QUrl &url, const bool unavailabl
 
 Song CollectionBackend::GetSongBySongId(const QString &song_id) {
 
-  QMutexLocker l(db_->Mutex());
-  QSqlDatabase db(db_->Connect());
-  return GetSongBySongId(song_id, db);
+  if (const std::optional<Song> song = song_index_.SongBySongId(song_id)) return *song;
+
+  const quint64 generation = song_index_.generation();
+  Song song;
+  {
+    QMutexLocker l(db_->Mutex());
+    QSqlDatabase db(db_->Connect());
+    song = GetSongBySongId(song_id, db);
+  }
+  song_index_.InsertSongBySongId(generation, song_id, song);
+
+  return song;
 
 }
 
@@ -1295,23 +1712,34 @@ SongList CollectionBackend::GetSongsBySongId(const QStringList &song_ids) {
 
 Song CollectionBackend::GetSongBySongId(const QString &song_id, QSqlDatabase &db) {
 
-  SongList list = GetSongsBySongId(QStringList() << song_id, db);
-  if (list.isEmpty()) return Song();
-  return list.first();
+  SqlQuery q = db_->PreparedQuery(db, QStringLiteral("SELECT %1 FROM %2 WHERE song_id = :song_id").arg(column_spec_, songs_table_));
+  q.BindValue(u":song_id"_s, song_id);
+  if (!q.Exec()) {
+    db_->ReportErrors(q);
+    return Song();
+  }
+
+  Song song(source_);
+  if (q.next()) {
+    song.InitFromQuery(q, true);
+  }
+  q.finish();
+
+  return song;
 
 }
 
 SongList CollectionBackend::GetSongsBySongId(const QStringList &song_ids, QSqlDatabase &db) {
 
-  QStringList song_ids2;
-  song_ids2.reserve(song_ids.count());
+  QVariantList keys;
+  keys.reserve(song_ids.count());
   for (const QString &song_id : song_ids) {
-    song_ids2 << QLatin1Char('\'') + song_id + QLatin1Char('\'');
+    keys << song_id;
   }
-  QString in = song_ids2.join(u',');
+  if (!db_->LoadTemporaryKeys(db, QLatin1String(kKeysTable), keys)) return SongList();
 
   SqlQuery q(db);
-  q.prepare(QStringLiteral("SELECT %1 FROM %2 WHERE SONG_ID IN (%3)").arg(Song::kRowIdColumnSpec, songs_table_, in));
+  q.prepare(QStringLiteral("SELECT %1 FROM %2 WHERE song_id IN (SELECT key FROM temp.%3)").arg(column_spec_, songs_table_, QLatin1String(kKeysTable)));
   if (!q.Exec()) {
     db_->ReportErrors(q);
     return SongList();
@@ -1334,7 +1762,7 @@ SongList CollectionBackend::GetSongsByFingerprint(const QString &fingerprint) {
   QSqlDatabase db(db_->Connect());
 
   SqlQuery q(db);
-  q.prepare(QStringLiteral("SELECT %1 FROM %2 WHERE fingerprint = :fingerprint").arg(Song::kRowIdColumnSpec, songs_table_));
+  q.prepare(QStringLiteral("SELECT %1 FROM %2 WHERE fingerprint = :fingerprint").arg(column_spec_, songs_table_));
   q.BindValue(u":fingerprint"_s, fingerprint);
   if (!q.Exec()) {
     db_->ReportErrors(q);
@@ -1352,6 +1780,160 @@ SongList CollectionBackend::GetSongsByFingerprint(const QString &fingerprint) {
 
 }
 
+bool CollectionBackend::UpdateFingerprintIndex() {
+
+  // The index and its triggers only exist for the songs table of the collection.
+  if (songs_table_ != QLatin1String(CollectionLibrary::kSongsTable)) return false;
+
+  Q_FOREVER {
+    QList<QPair<int, QString>> pending;
+    {
+      QMutexLocker l(db_->Mutex());
+      QSqlDatabase db(db_->Connect());
+      SqlQuery q(db);
+      q.prepare(u"SELECT ROWID, fingerprint FROM songs WHERE fingerprint IS NOT NULL AND fingerprint != '' AND fingerprint != 'NONE' AND ROWID NOT IN (SELECT song_id FROM fingerprint_songs) LIMIT :limit"_s);
+      q.BindValue(u":limit"_s, kFingerprintIndexBatchSize);
+      if (!q.Exec()) {
+        db_->ReportErrors(q);
+        return false;
+      }
+      while (q.next()) {
+        pending << qMakePair(q.value(0).toInt(), q.value(1).toString());
+      }
+    }
+    if (pending.isEmpty()) return true;
+
+    // Hashed without holding the database lock.
+    QList<QList<qint64>> pending_bands;
+    pending_bands.reserve(pending.count());
+    for (const QPair<int, QString> &song : std::as_const(pending)) {
+      pending_bands << FingerprintIndex::Bands(FingerprintIndex::Decode(song.second));
+    }
+
+    QMutexLocker l(db_->Mutex());
+    QSqlDatabase db(db_->Connect());
+    ScopedTransaction transaction(&db);
+    for (qsizetype i = 0; i < pending.count(); ++i) {
+      // Songs with an undecodable fingerprint are marked as indexed too, so they aren't hashed again.
+      // The fingerprint is compared, because the song could have been updated while it was hashed.
+      SqlQuery q = db_->PreparedQuery(db, u"INSERT INTO fingerprint_songs (song_id) SELECT ROWID FROM songs WHERE ROWID = :id AND fingerprint = :fingerprint"_s);
+      q.BindValue(u":id"_s, pending[i].first);
+      q.BindValue(u":fingerprint"_s, pending[i].second);
+      if (!q.Exec()) {
+        db_->ReportErrors(q);
+        return false;
+      }
+      const bool indexed = q.numRowsAffected() > 0;
+      q.finish();
+      if (!indexed) continue;
+      for (const qint64 band : std::as_const(pending_bands[i])) {
+        SqlQuery q_band = db_->PreparedQuery(db, u"INSERT OR IGNORE INTO fingerprint_bands (band, song_id) VALUES (:band, :id)"_s);
+        q_band.BindValue(u":band"_s, band);
+        q_band.BindValue(u":id"_s, pending[i].first);
+        if (!q_band.Exec()) {
+          db_->ReportErrors(q_band);
+          return false;
+        }
+        q_band.finish();
+      }
+    }
+    transaction.Commit();
+  }
+
+}
+
+QList<SongList> CollectionBackend::GetFingerprintDuplicates() {
+
+  CollectionTask task(task_manager_, tr("Finding duplicate songs"));
+
+  if (!UpdateFingerprintIndex()) return QList<SongList>();
+
+  QList<QPair<int, int>> candidates;
+  QHash<int, FingerprintIndex::RawFingerprint> fingerprints;
+  {
+    QMutexLocker l(db_->Mutex());
+    QSqlDatabase db(db_->Connect());
+
+    // Bands shared by many songs are from silence or other degenerate audio, and would make the join quadratic.
+    SqlQuery q(db);
+    q.prepare(u"SELECT DISTINCT a.song_id, b.song_id FROM fingerprint_bands a JOIN fingerprint_bands b ON b.band = a.band AND b.song_id > a.song_id WHERE a.band IN (SELECT band FROM fingerprint_bands GROUP BY band HAVING COUNT(*) BETWEEN 2 AND :max_songs)"_s);
+    q.BindValue(u":max_songs"_s, kFingerprintBandMaxSongs);
+    if (!q.Exec()) {
+      db_->ReportErrors(q);
+      return QList<SongList>();
+    }
+    QVariantList ids;
+    while (q.next()) {
+      const int id1 = q.value(0).toInt();
+      const int id2 = q.value(1).toInt();
+      candidates << qMakePair(id1, id2);
+      ids << id1 << id2;
+    }
+    if (candidates.isEmpty()) return QList<SongList>();
+
+    if (!db_->LoadTemporaryKeys(db, QLatin1String(kKeysTable), ids)) return QList<SongList>();
+    SqlQuery q_fingerprints(db);
+    q_fingerprints.prepare(QStringLiteral("SELECT ROWID, fingerprint FROM songs WHERE ROWID IN (SELECT key FROM temp.%1) AND unavailable = 0").arg(QLatin1String(kKeysTable)));
+    if (!q_fingerprints.Exec()) {
+      db_->ReportErrors(q_fingerprints);
+      return QList<SongList>();
+    }
+    while (q_fingerprints.next()) {
+      fingerprints.insert(q_fingerprints.value(0).toInt(), FingerprintIndex::Decode(q_fingerprints.value(1).toString()));
+    }
+  }
+
+  // Songs matching each other are merged into one group, the roots of the groups have no parent.
+  QHash<int, int> parents;
+  QSet<int> matched_ids;
+  const auto find_root = [&parents](int id) {
+    while (parents.contains(id)) {
+      id = parents.value(id);
+    }
+    return id;
+  };
+  for (const QPair<int, int> &candidate : std::as_const(candidates)) {
+    if (!fingerprints.contains(candidate.first) || !fingerprints.contains(candidate.second)) continue;
+    const int root1 = find_root(candidate.first);
+    const int root2 = find_root(candidate.second);
+    if (root1 == root2) continue;
+    if (FingerprintIndex::Similarity(fingerprints.value(candidate.first), fingerprints.value(candidate.second)) < FingerprintIndex::kDuplicateSimilarity) continue;
+    parents.insert(std::max(root1, root2), std::min(root1, root2));
+    matched_ids << candidate.first << candidate.second;
+  }
+  if (matched_ids.isEmpty()) return QList<SongList>();
+
+  QStringList ids;
+  ids.reserve(matched_ids.count());
+  for (const int id : std::as_const(matched_ids)) {
+    ids << QString::number(id);
+  }
+
+  SongList songs = GetSongsById(ids);
+  std::sort(songs.begin(), songs.end(), [](const Song &song1, const Song &song2) { return song1.id() < song2.id(); });
+
+  QMap<int, SongList> groups;
+  for (const Song &song : std::as_const(songs)) {
+    groups[find_root(song.id())] << song;
+  }
+
+  QList<SongList> duplicates;
+  for (const SongList &group : std::as_const(groups)) {
+    if (group.count() > 1) duplicates << group;
+  }
+
+  return duplicates;
+
+}
+
+void CollectionBackend::FindFingerprintDuplicatesAsync() {
+  QMetaObject::invokeMethod(this, &CollectionBackend::FindFingerprintDuplicates, Qt::QueuedConnection);
+}
+
+void CollectionBackend::FindFingerprintDuplicates() {
+  Q_EMIT FingerprintDuplicatesFound(GetFingerprintDuplicates());
+}
+
 
 CollectionBackend::AlbumList CollectionBackend::GetCompilationAlbums(const CollectionFilterOptions &opt) {
   return GetAlbums(QString(), true, opt);
@@ -1389,33 +1971,46 @@ void CollectionBackend::CompilationsNeedUpdating() {
 
   // Look for albums that have songs by more than one 'effective album artist' in the same directory
 
-  SqlQuery q(db);
-  q.prepare(QStringLiteral("SELECT effective_albumartist, album, url, compilation_detected FROM %1 WHERE unavailable = 0 ORDER BY album").arg(songs_table_));
-  if (!q.Exec()) {
-    db_->ReportErrors(q);
-    return;
-  }
-
   QMap<QString, CompilationInfo> compilation_info;
-  while (q.next()) {
-    QString artist = q.value(0).toString();
-    QString album = q.value(1).toString();
-    QUrl url = QUrl::fromEncoded(q.value(2).toString().toUtf8());
-    bool compilation_detected = q.value(3).toBool();
 
-    // Ignore songs that don't have an album field set
-    if (album.isEmpty()) continue;
+  // Triggers on the collection songs table record the albums with songs added, changed or removed since the last time, only those are checked again.
+  const bool incremental = songs_table_ == QLatin1String(CollectionLibrary::kSongsTable);
+  QStringList albums;
+  if (incremental) {
+    SqlQuery q(db);
+    q.prepare(u"SELECT album FROM compilation_dirty_albums"_s);
+    if (!q.Exec()) {
+      db_->ReportErrors(q);
+      return;
+    }
+    while (q.next()) {
+      albums << q.value(0).toString();
+    }
+    if (albums.isEmpty()) return;
 
-    // Find the directory the song is in
-    QString directory = url.toString(QUrl::PreferLocalFile | QUrl::RemoveFilename);
+    QVariantList keys;
+    keys.reserve(albums.count());
+    for (const QString &album : std::as_const(albums)) {
+      keys << album;
+    }
+    if (!db_->LoadTemporaryKeys(db, QLatin1String(kAlbumKeysTable), keys)) return;
 
-    CompilationInfo &info = compilation_info[directory + album];
-    info.urls << url;
-    if (!info.artists.contains(artist)) {
-      info.artists << artist;
+    SqlQuery q_songs(db);
+    q_songs.prepare(QStringLiteral("SELECT effective_albumartist, album, url, compilation_detected FROM %1 WHERE unavailable = 0 AND album IN (SELECT key FROM temp.%2)").arg(songs_table_, QLatin1String(kAlbumKeysTable)));
+    if (!q_songs.Exec()) {
+      db_->ReportErrors(q_songs);
+      return;
     }
-    if (compilation_detected) info.has_compilation_detected++;
-    else info.has_not_compilation_detected++;
+    ReadCompilationInfo(q_songs, compilation_info);
+  }
+  else {
+    SqlQuery q(db);
+    q.prepare(QStringLiteral("SELECT effective_albumartist, album, url, compilation_detected FROM %1 WHERE unavailable = 0 ORDER BY album").arg(songs_table_));
+    if (!q.Exec()) {
+      db_->ReportErrors(q);
+      return;
+    }
+    ReadCompilationInfo(q, compilation_info);
   }
 
   // Now mark the songs that we think are in compilations
@@ -1423,43 +2018,80 @@ void CollectionBackend::CompilationsNeedUpdating() {
 
   ScopedTransaction transaction(&db);
 
+  QList<QUrl> compilation_urls;
+  QList<QUrl> not_compilation_urls;
   QMap<QString, CompilationInfo>::const_iterator it = compilation_info.constBegin();
   for (; it != compilation_info.constEnd(); ++it) {
     const CompilationInfo &info = it.value();
 
     // If there were more than one 'effective album artist' for this album directory, then it's a compilation.
 
-    for (const QUrl &url : info.urls) {
-      if (info.artists.count() > 1) {  // This directory+album is a compilation.
-        if (info.has_not_compilation_detected > 0) {  // Run updates if any of the songs is not marked as compilations.
-          UpdateCompilations(db, changed_songs, url, true);
-        }
+    if (info.artists.count() > 1) {  // This directory+album is a compilation.
+      if (info.has_not_compilation_detected > 0) {  // Run updates if any of the songs is not marked as compilations.
+        compilation_urls << info.urls;
       }
-      else {
-        if (info.has_compilation_detected > 0) {
-          UpdateCompilations(db, changed_songs, url, false);
-        }
+    }
+    else {
+      if (info.has_compilation_detected > 0) {
+        not_compilation_urls << info.urls;
       }
     }
   }
 
+  if (!compilation_urls.isEmpty() && !UpdateCompilations(db, changed_songs, compilation_urls, true)) return;
+  if (!not_compilation_urls.isEmpty() && !UpdateCompilations(db, changed_songs, not_compilation_urls, false)) return;
+
+  // The albums are checked now, forget them in the same transaction as the updates.
+  if (!albums.isEmpty()) {
+    SqlQuery q(db);
+    q.prepare(QStringLiteral("DELETE FROM compilation_dirty_albums WHERE album IN (SELECT key FROM temp.%1)").arg(QLatin1String(kAlbumKeysTable)));
+    if (!q.Exec()) {
+      db_->ReportErrors(q);
+      return;
+    }
+  }
+
   transaction.Commit();
 
   if (!changed_songs.isEmpty()) {
+    UpdateCache(SongList(), false);
     Q_EMIT SongsChanged(changed_songs);
   }
 
 }
 
-bool CollectionBackend::UpdateCompilations(const QSqlDatabase &db, SongList &changed_songs, const QUrl &url, const bool compilation_detected) {
+void CollectionBackend::ReadCompilationInfo(SqlQuery &q, QMap<QString, CompilationInfo> &compilation_info) {
+
+  while (q.next()) {
+    QString artist = q.value(0).toString();
+    QString album = q.value(1).toString();
+    QUrl url = QUrl::fromEncoded(q.value(2).toString().toUtf8());
+    bool compilation_detected = q.value(3).toBool();
+
+    // Ignore songs that don't have an album field set
+    if (album.isEmpty()) continue;
 
-  {  // Get song, so we can tell the model its updated
+    // Find the directory the song is in
+    QString directory = url.toString(QUrl::PreferLocalFile | QUrl::RemoveFilename);
+
+    CompilationInfo &info = compilation_info[directory + album];
+    info.urls << url;
+    if (!info.artists.contains(artist)) {
+      info.artists << artist;
+    }
+    if (compilation_detected) info.has_compilation_detected++;
+    else info.has_not_compilation_detected++;
+  }
+
+}
+
+bool CollectionBackend::UpdateCompilations(const QSqlDatabase &db, SongList &changed_songs, const QList<QUrl> &urls, const bool compilation_detected) {
+
+  if (!db_->LoadTemporaryKeys(db, QLatin1String(kKeysTable), UrlKeys(urls))) return false;
+
+  {  // Get the songs, so we can tell the model they're updated
     SqlQuery q(db);
-    q.prepare(QStringLiteral("SELECT %1 FROM %2 WHERE (url = :url1 OR url = :url2 OR url = :url3 OR url = :url4) AND unavailable = 0").arg(Song::kRowIdColumnSpec, songs_table_));
-    q.BindValue(u":url1"_s, url.toString());
-    q.BindValue(u":url2"_s, url.toString(QUrl::FullyEncoded));
-    q.BindValue(u":url3"_s, url.toEncoded(QUrl::FullyDecoded));
-    q.BindValue(u":url4"_s, url.toEncoded(QUrl::FullyEncoded));
+    q.prepare(QStringLiteral("SELECT %1 FROM %2 WHERE url IN (SELECT key FROM temp.%3) AND unavailable = 0").arg(column_spec_, songs_table_, QLatin1String(kKeysTable)));
     if (q.Exec()) {
       while (q.next()) {
         Song song(source_);
@@ -1474,14 +2106,10 @@ bool CollectionBackend::UpdateCompilations(const QSqlDatabase &db, SongList &cha
     }
   }
 
-  // Update the song
+  // Update the songs
   SqlQuery q(db);
-  q.prepare(QStringLiteral("UPDATE %1 SET compilation_detected = :compilation_detected, compilation_effective = ((compilation OR :compilation_detected OR compilation_on) AND NOT compilation_off) + 0 WHERE (url = :url1 OR url = :url2 OR url = :url3 OR url = :url4) AND unavailable = 0").arg(songs_table_));
+  q.prepare(QStringLiteral("UPDATE %1 SET compilation_detected = :compilation_detected, compilation_effective = ((compilation OR :compilation_detected OR compilation_on) AND NOT compilation_off) + 0 WHERE url IN (SELECT key FROM temp.%2) AND unavailable = 0").arg(songs_table_, QLatin1String(kKeysTable)));
   q.BindValue(u":compilation_detected"_s, static_cast<int>(compilation_detected));
-  q.BindValue(u":url1"_s, url.toString());
-  q.BindValue(u":url2"_s, url.toString(QUrl::FullyEncoded));
-  q.BindValue(u":url3"_s, url.toEncoded(QUrl::FullyDecoded));
-  q.BindValue(u":url4"_s, url.toEncoded(QUrl::FullyEncoded));
   if (!q.Exec()) {
     db_->ReportErrors(q);
     return false;
@@ -1493,6 +2121,14 @@ bool CollectionBackend::UpdateCompilations(const QSqlDatabase &db, SongList &cha
 
 CollectionBackend::AlbumList CollectionBackend::GetAlbums(const QString &artist, const bool compilation_required, const CollectionFilterOptions &opt) {
 
+  const QString cache_key = CacheKey(compilation_required ? u"compilation_albums"_s : u"albums"_s, artist, opt);
+  quint64 generation = 0;
+  if (!cache_key.isEmpty()) {
+    QMutexLocker l(&mutex_cache_);
+    if (cached_album_lists_.contains(cache_key)) return cached_album_lists_.value(cache_key);
+    generation = cache_generation_;
+  }
+
   QMutexLocker l(db_->Mutex());
   QSqlDatabase db(db_->Connect());
 
@@ -1575,7 +2211,14 @@ CollectionBackend::AlbumList CollectionBackend::GetAlbums(const QString &artist,
 
   }
 
-  return albums.values();
+  const AlbumList ret = albums.values();
+
+  if (!cache_key.isEmpty()) {
+    QMutexLocker l_cache(&mutex_cache_);
+    if (cache_generation_ == generation) cached_album_lists_.insert(cache_key, ret);
+  }
+
+  return ret;
 
 }
 
@@ -1638,7 +2281,7 @@ void CollectionBackend::UpdateEmbeddedAlbumArt(const QString &effective_albumart
   SongList songs;
   {
     CollectionQuery q(db, songs_table_);
-    q.SetColumnSpec(Song::kRowIdColumnSpec);
+    q.SetColumnSpec(column_spec_);
     q.AddWhere(u"effective_albumartist"_s, effective_albumartist);
     q.AddWhere(u"album"_s, album);
     if (!q.Exec()) {
@@ -1652,8 +2295,10 @@ void CollectionBackend::UpdateEmbeddedAlbumArt(const QString &effective_albumart
     }
   }
 
+  UpdateCache(SongList(), false);
+
   if (!songs.isEmpty()) {
-    Q_EMIT SongsChanged(songs);
+    Q_EMIT AlbumArtChanged(songs);
   }
 
 }
@@ -1684,7 +2329,7 @@ void CollectionBackend::UpdateManualAlbumArt(const QString &effective_albumartis
   SongList songs;
   {
     CollectionQuery q(db, songs_table_);
-    q.SetColumnSpec(Song::kRowIdColumnSpec);
+    q.SetColumnSpec(column_spec_);
     q.AddWhere(u"effective_albumartist"_s, effective_albumartist);
     q.AddWhere(u"album"_s, album);
     if (!q.Exec()) {
@@ -1698,8 +2343,10 @@ void CollectionBackend::UpdateManualAlbumArt(const QString &effective_albumartis
     }
   }
 
+  UpdateCache(SongList(), false);
+
   if (!songs.isEmpty()) {
-    Q_EMIT SongsChanged(songs);
+    Q_EMIT AlbumArtChanged(songs);
   }
 
 }
@@ -1729,7 +2376,7 @@ void CollectionBackend::UnsetAlbumArt(const QString &effective_albumartist, cons
   SongList songs;
   {
     CollectionQuery q(db, songs_table_);
-    q.SetColumnSpec(Song::kRowIdColumnSpec);
+    q.SetColumnSpec(column_spec_);
     q.AddWhere(u"effective_albumartist"_s, effective_albumartist);
     q.AddWhere(u"album"_s, album);
     if (!q.Exec()) {
@@ -1743,8 +2390,10 @@ void CollectionBackend::UnsetAlbumArt(const QString &effective_albumartist, cons
     }
   }
 
+  UpdateCache(SongList(), false);
+
   if (!songs.isEmpty()) {
-    Q_EMIT SongsChanged(songs);
+    Q_EMIT AlbumArtChanged(songs);
   }
 
 }
@@ -1775,7 +2424,7 @@ void CollectionBackend::ClearAlbumArt(const QString &effective_albumartist, cons
   SongList songs;
   {
     CollectionQuery q(db, songs_table_);
-    q.SetColumnSpec(Song::kRowIdColumnSpec);
+    q.SetColumnSpec(column_spec_);
     q.AddWhere(u"effective_albumartist"_s, effective_albumartist);
     q.AddWhere(u"album"_s, album);
     if (!q.Exec()) {
@@ -1789,8 +2438,10 @@ void CollectionBackend::ClearAlbumArt(const QString &effective_albumartist, cons
     }
   }
 
+  UpdateCache(SongList(), false);
+
   if (!songs.isEmpty()) {
-    Q_EMIT SongsChanged(songs);
+    Q_EMIT AlbumArtChanged(songs);
   }
 
 }
@@ -1822,7 +2473,7 @@ void CollectionBackend::ForceCompilation(const QString &album, const QStringList
     // Get the updated songs
 
     CollectionQuery query(db, songs_table_);
-    query.SetColumnSpec(Song::kRowIdColumnSpec);
+    query.SetColumnSpec(column_spec_);
     query.AddWhere(u"album"_s, album);
     if (!artist.isEmpty()) query.AddWhere(u"artist"_s, artist);
 
@@ -1838,6 +2489,8 @@ void CollectionBackend::ForceCompilation(const QString &album, const QStringList
     }
   }
 
+  UpdateCache(SongList(), false);
+
   if (!songs.isEmpty()) {
     Q_EMIT SongsChanged(songs);
   }
@@ -1848,20 +2501,10 @@ void CollectionBackend::IncrementPlayCount(const int id) {
 
   if (id == -1) return;
 
-  QMutexLocker l(db_->Mutex());
-  QSqlDatabase db(db_->Connect());
-
-  SqlQuery q(db);
-  q.prepare(QStringLiteral("UPDATE %1 SET playcount = playcount + 1, lastplayed = :now WHERE ROWID = :id").arg(songs_table_));
-  q.BindValue(u":now"_s, QDateTime::currentSecsSinceEpoch());
-  q.BindValue(u":id"_s, id);
-  if (!q.Exec()) {
-    db_->ReportErrors(q);
-    return;
-  }
-
-  Song new_song = GetSongById(id, db);
-  Q_EMIT SongsStatisticsChanged(SongList() << new_song);
+  PendingStatistics &pending = pending_statistics_[id];
+  ++pending.playcount;
+  pending.lastplayed = QDateTime::currentSecsSinceEpoch();
+  if (!timer_flush_statistics_->isActive()) timer_flush_statistics_->start();
 
 }
 
@@ -1871,19 +2514,8 @@ void CollectionBackend::IncrementSkipCount(const int id, const float progress) {
 
   if (id == -1) return;
 
-  QMutexLocker l(db_->Mutex());
-  QSqlDatabase db(db_->Connect());
-
-  SqlQuery q(db);
-  q.prepare(QStringLiteral("UPDATE %1 SET skipcount = skipcount + 1 WHERE ROWID = :id").arg(songs_table_));
-  q.BindValue(u":id"_s, id);
-  if (!q.Exec()) {
-    db_->ReportErrors(q);
-    return;
-  }
-
-  Song new_song = GetSongById(id, db);
-  Q_EMIT SongsStatisticsChanged(SongList() << new_song);
+  ++pending_statistics_[id].skipcount;
+  if (!timer_flush_statistics_->isActive()) timer_flush_statistics_->start();
 
 }
 
@@ -1917,17 +2549,33 @@ bool CollectionBackend::ResetPlayStatistics(const QStringList &id_str_list) {
 
   if (id_str_list.isEmpty()) return false;
 
+  // Buffered increments must not be added on top of the reset.
+  FlushStatistics();
+
   QMutexLocker l(db_->Mutex());
   QSqlDatabase db(db_->Connect());
 
+  QVariantList keys;
+  keys.reserve(id_str_list.count());
+  for (const QString &id : id_str_list) {
+    keys << id.toInt();
+  }
+  if (!db_->LoadTemporaryKeys(db, QLatin1String(kKeysTable), keys)) return false;
+
   SqlQuery q(db);
-  q.prepare(QStringLiteral("UPDATE %1 SET playcount = 0, skipcount = 0, lastplayed = -1 WHERE ROWID IN (:ids)").arg(songs_table_));
-  q.BindValue(u":ids"_s, id_str_list.join(u','));
+  q.prepare(QStringLiteral("UPDATE %1 SET playcount = 0, skipcount = 0, lastplayed = -1 WHERE ROWID IN (SELECT key FROM temp.%2)").arg(songs_table_, QLatin1String(kKeysTable)));
   if (!q.Exec()) {
     db_->ReportErrors(q);
     return false;
   }
 
+  QList<int> ids;
+  ids.reserve(keys.count());
+  for (const QVariant &key : std::as_const(keys)) {
+    ids << key.toInt();
+  }
+  song_index_.RemoveSongs(ids);
+
   return true;
 
 }
@@ -1957,8 +2605,121 @@ void CollectionBackend::DeleteAll() {
     t.Commit();
   }
 
+  UpdateCache(SongList(), true);
+
+  Q_EMIT DatabaseReset();
+
+}
+
+void CollectionBackend::ReplicaResetAsync(const SongList &songs) {
+  QMetaObject::invokeMethod(this, "ReplicaReset", Qt::QueuedConnection, Q_ARG(SongList, songs));
+}
+
+void CollectionBackend::ReplicaReset(const SongList &songs) {
+
+  {
+    QMutexLocker l(db_->Mutex());
+    QSqlDatabase db(db_->Connect());
+
+    CollectionTask task(task_manager_, tr("Updating %1 database.").arg(Song::TextForSource(source_)));
+    ScopedTransaction t(&db);
+
+    {
+      SqlQuery q(db);
+      q.prepare(u"DELETE FROM "_s + songs_table_);
+      if (!q.Exec()) {
+        db_->ReportErrors(q);
+        return;
+      }
+    }
+
+    SongList added_songs;
+    SongList changed_songs;
+    if (!ReplicaWriteSongs(db, songs, added_songs, changed_songs)) return;
+
+    t.Commit();
+  }
+
+  UpdateCache(SongList(), true);
+
   Q_EMIT DatabaseReset();
 
+  UpdateTotalSongCountAsync();
+  UpdateTotalArtistCountAsync();
+  UpdateTotalAlbumCountAsync();
+
+}
+
+void CollectionBackend::ReplicaUpdateSongsAsync(const SongList &songs) {
+  QMetaObject::invokeMethod(this, "ReplicaUpdateSongs", Qt::QueuedConnection, Q_ARG(SongList, songs));
+}
+
+void CollectionBackend::ReplicaUpdateSongs(const SongList &songs) {
+
+  SongList added_songs;
+  SongList changed_songs;
+
+  {
+    QMutexLocker l(db_->Mutex());
+    QSqlDatabase db(db_->Connect());
+
+    ScopedTransaction t(&db);
+    if (!ReplicaWriteSongs(db, songs, added_songs, changed_songs)) return;
+    t.Commit();
+  }
+
+  UpdateCache(added_songs, !changed_songs.isEmpty());
+
+  if (!added_songs.isEmpty()) Q_EMIT SongsAdded(std::move(added_songs));
+  if (!changed_songs.isEmpty()) Q_EMIT SongsChanged(std::move(changed_songs));
+
+  UpdateTotalSongCountAsync();
+  UpdateTotalArtistCountAsync();
+  UpdateTotalAlbumCountAsync();
+
+}
+
+bool CollectionBackend::ReplicaWriteSongs(QSqlDatabase &db, const SongList &songs, SongList &added_songs, SongList &changed_songs) {
+
+  SqlQuery q_exists(db);
+  q_exists.prepare(QStringLiteral("SELECT ROWID FROM %1 WHERE ROWID = :id").arg(songs_table_));
+
+  SqlQuery q_update(db);
+  q_update.prepare(QStringLiteral("UPDATE %1 SET %2 WHERE ROWID = :id").arg(songs_table_, Song::kUpdateSpec));
+
+  SqlQuery q_insert(db);
+  q_insert.prepare(QStringLiteral("INSERT INTO %1 (ROWID, %2) VALUES (:id, %3)").arg(songs_table_, Song::kColumnSpec, Song::kBindSpec));
+
+  for (const Song &song : songs) {
+    if (song.id() <= 0) continue;
+
+    q_exists.BindValue(u":id"_s, song.id());
+    if (!q_exists.Exec()) {
+      db_->ReportErrors(q_exists);
+      return false;
+    }
+    const bool exists = q_exists.next();
+    q_exists.finish();
+
+    SqlQuery &q = exists ? q_update : q_insert;
+    BindSongToQuery(song, &q);
+    q.BindValue(u":id"_s, song.id());
+    if (!q.Exec()) {
+      db_->ReportErrors(q);
+      return false;
+    }
+    if (!SaveLongText(db, song)) return false;
+
+    if (exists) {
+      changed_songs << song;
+    }
+    else {
+      added_songs << song;
+    }
+  }
+
+  return true;
+
 }
 
 SongList CollectionBackend::ExecuteQuery(const QString &sql) {
@@ -1984,6 +2745,75 @@ SongList CollectionBackend::ExecuteQuery(const QString &sql) {
 
 }
 
+QList<int> CollectionBackend::ExecuteSongIdQuery(const QString &sql) {
+
+  QMutexLocker l(db_->Mutex());
+  QSqlDatabase db(db_->Connect());
+
+  SqlQuery query(db);
+  query.prepare(sql);
+  if (!query.Exec()) {
+    db_->ReportErrors(query);
+    return QList<int>();
+  }
+
+  QList<int> ids;
+  while (query.next()) {
+    ids << query.value(0).toInt();
+  }
+
+  return ids;
+
+}
+
+int CollectionBackend::ExecuteCountQuery(const QString &sql) {
+
+  QMutexLocker l(db_->Mutex());
+  QSqlDatabase db(db_->Connect());
+
+  SqlQuery query(db);
+  query.prepare(sql);
+  if (!query.Exec()) {
+    db_->ReportErrors(query);
+    return -1;
+  }
+  if (!query.next()) return -1;
+
+  return query.value(0).toInt();
+
+}
+
+std::optional<QSet<int>> CollectionBackend::SearchSongIds(const QString &fts_query) {
+
+  QMutexLocker l(db_->Mutex());
+  QSqlDatabase db(db_->Connect());
+
+  if (!fts_available_.has_value()) {
+    SqlQuery q(db);
+    q.prepare(u"SELECT ROWID FROM sqlite_master WHERE type = 'table' AND name = :name"_s);
+    q.BindValue(u":name"_s, songs_table_ + "_fts"_L1);
+    fts_available_ = q.Exec() && q.next();
+  }
+
+  if (!*fts_available_) return std::nullopt;
+
+  SqlQuery q(db);
+  q.prepare(QStringLiteral("SELECT ROWID FROM %1_fts WHERE %1_fts MATCH :query").arg(songs_table_));
+  q.BindValue(u":query"_s, fts_query);
+  if (!q.Exec()) {
+    db_->ReportErrors(q);
+    return std::nullopt;
+  }
+
+  QSet<int> song_ids;
+  while (q.next()) {
+    song_ids.insert(q.value(0).toInt());
+  }
+
+  return song_ids;
+
+}
+
 SongList CollectionBackend::GetSongsBy(const QString &artist, const QString &album, const QString &title) {
 
   QMutexLocker l(db_->Mutex());
@@ -1992,10 +2822,10 @@ SongList CollectionBackend::GetSongsBy(const QString &artist, const QString &alb
   SongList songs;
   SqlQuery q(db);
   if (album.isEmpty()) {
-    q.prepare(QStringLiteral("SELECT %1 FROM %2 WHERE artist = :artist COLLATE NOCASE AND title = :title COLLATE NOCASE").arg(Song::kRowIdColumnSpec, songs_table_));
+    q.prepare(QStringLiteral("SELECT %1 FROM %2 WHERE artist = :artist COLLATE NOCASE AND title = :title COLLATE NOCASE").arg(column_spec_, songs_table_));
   }
   else {
-    q.prepare(QStringLiteral("SELECT %1 FROM %2 WHERE artist = :artist COLLATE NOCASE AND album = :album COLLATE NOCASE AND title = :title COLLATE NOCASE").arg(Song::kRowIdColumnSpec, songs_table_));
+    q.prepare(QStringLiteral("SELECT %1 FROM %2 WHERE artist = :artist COLLATE NOCASE AND album = :album COLLATE NOCASE AND title = :title COLLATE NOCASE").arg(column_spec_, songs_table_));
   }
   q.BindValue(u":artist"_s, artist);
   if (!album.isEmpty()) q.BindValue(u":album"_s, album);
@@ -2016,6 +2846,8 @@ SongList CollectionBackend::GetSongsBy(const QString &artist, const QString &alb
 
 void CollectionBackend::UpdateLastPlayed(const QString &artist, const QString &album, const QString &title, const qint64 lastplayed) {
 
+  FlushStatistics();
+
   const SongList songs = GetSongsBy(artist, album, title);
   if (songs.isEmpty()) {
     qLog(Debug) << "Could not find a matching song in the database for" << artist << album << title;
@@ -2045,6 +2877,8 @@ void CollectionBackend::UpdateLastPlayed(const QString &artist, const QString &a
 
 void CollectionBackend::UpdatePlayCount(const QString &artist, const QString &title, const int playcount, const bool save_tags) {
 
+  FlushStatistics();
+
   const SongList songs = GetSongsBy(artist, QString(), title);
   if (songs.isEmpty()) {
     qLog(Debug) << "Could not find a matching song in the database for" << artist << title;
@@ -2069,6 +2903,108 @@ void CollectionBackend::UpdatePlayCount(const QString &artist, const QString &ti
 
 }
 
+void CollectionBackend::UpdatePlayStatistics(const CollectionPlayStatisticsList &statistics_list) {
+
+  if (statistics_list.isEmpty()) return;
+
+  FlushStatistics();
+
+  QMutexLocker l(db_->Mutex());
+  QSqlDatabase db(db_->Connect());
+
+  ScopedTransaction transaction(&db);
+
+  const QStringList statements = QStringList() << u"CREATE TEMP TABLE IF NOT EXISTS play_statistics (artist TEXT COLLATE NOCASE, album TEXT COLLATE NOCASE, title TEXT COLLATE NOCASE, playcount INTEGER, lastplayed INTEGER)"_s
+                                               << u"CREATE INDEX IF NOT EXISTS temp.idx_play_statistics ON play_statistics (artist, title)"_s
+                                               << u"DELETE FROM temp.play_statistics"_s;
+  for (const QString &statement : statements) {
+    SqlQuery q(db);
+    q.prepare(statement);
+    if (!q.Exec()) {
+      db_->ReportErrors(q);
+      return;
+    }
+  }
+
+  {
+    SqlQuery q(db);
+    q.prepare(u"INSERT INTO temp.play_statistics (artist, album, title, playcount, lastplayed) VALUES (:artist, :album, :title, :playcount, :lastplayed)"_s);
+    for (const CollectionPlayStatistics &statistics : statistics_list) {
+      q.BindValue(u":artist"_s, statistics.artist);
+      q.BindValue(u":album"_s, statistics.album.isNull() ? u""_s : statistics.album);
+      q.BindValue(u":title"_s, statistics.title);
+      q.BindValue(u":playcount"_s, statistics.playcount);
+      q.BindValue(u":lastplayed"_s, statistics.lastplayed);
+      if (!q.Exec()) {
+        db_->ReportErrors(q);
+        return;
+      }
+    }
+  }
+
+  // The collation of the temporary table columns is used, so matching is case insensitive like in GetSongsBy().
+  SqlQuery q_match(db);
+  q_match.prepare(QStringLiteral("SELECT %1.ROWID, %1.playcount, %1.lastplayed, MAX(t.playcount), MAX(t.lastplayed) FROM %1 INNER JOIN temp.play_statistics AS t ON t.artist = %1.artist AND t.title = %1.title AND (t.album = '' OR t.album = %1.album) GROUP BY %1.ROWID").arg(songs_table_));
+  if (!q_match.Exec()) {
+    db_->ReportErrors(q_match);
+    return;
+  }
+
+  SqlQuery q_playcount(db);
+  q_playcount.prepare(QStringLiteral("UPDATE %1 SET playcount = :playcount WHERE ROWID = :id").arg(songs_table_));
+  SqlQuery q_lastplayed(db);
+  q_lastplayed.prepare(QStringLiteral("UPDATE %1 SET lastplayed = :lastplayed WHERE ROWID = :id").arg(songs_table_));
+
+  QStringList id_str_list;
+  while (q_match.next()) {
+    const int id = q_match.value(0).toInt();
+    const int song_playcount = q_match.value(1).toInt();
+    const qint64 song_lastplayed = q_match.value(2).toLongLong();
+    const int playcount = q_match.value(3).toInt();
+    const qint64 lastplayed = q_match.value(4).toLongLong();
+    bool changed = false;
+    if (playcount > 0 && playcount != song_playcount) {
+      q_playcount.BindValue(u":playcount"_s, playcount);
+      q_playcount.BindValue(u":id"_s, id);
+      if (!q_playcount.Exec()) {
+        db_->ReportErrors(q_playcount);
+        return;
+      }
+      changed = true;
+    }
+    if (lastplayed > song_lastplayed) {
+      q_lastplayed.BindValue(u":lastplayed"_s, lastplayed);
+      q_lastplayed.BindValue(u":id"_s, id);
+      if (!q_lastplayed.Exec()) {
+        db_->ReportErrors(q_lastplayed);
+        return;
+      }
+      changed = true;
+    }
+    if (changed) {
+      id_str_list << QString::number(id);
+    }
+  }
+
+  {
+    SqlQuery q(db);
+    q.prepare(u"DELETE FROM temp.play_statistics"_s);
+    if (!q.Exec()) {
+      db_->ReportErrors(q);
+      return;
+    }
+  }
+
+  transaction.Commit();
+
+  qLog(Debug) << "Updated play statistics for" << id_str_list.count() << "songs from" << statistics_list.count() << "entries";
+
+  if (!id_str_list.isEmpty()) {
+    Q_EMIT SongsStatisticsChanged(GetSongsById(id_str_list, db));
+  }
+
+}
+
 void CollectionBackend::UpdateSongRating(const int id, const float rating, const bool save_tags) {
 
   if (id == -1) return;
@@ -2081,26 +3017,82 @@ void CollectionBackend::UpdateSongsRating(const QList<int> &id_list, const float
 
   if (id_list.isEmpty()) return;
 
+  for (const int id : id_list) {
+    PendingStatistics &pending = pending_statistics_[id];
+    pending.rating = rating;
+    pending.update_rating = true;
+    pending.save_rating_tags = pending.save_rating_tags || save_tags;
+  }
+  if (!timer_flush_statistics_->isActive()) timer_flush_statistics_->start();
+
+}
+
+void CollectionBackend::FlushStatistics() {
+
+  timer_flush_statistics_->stop();
+
+  if (pending_statistics_.isEmpty()) return;
+
+  const QMap<int, PendingStatistics> pending_statistics = std::exchange(pending_statistics_, QMap<int, PendingStatistics>());
+
   QMutexLocker l(db_->Mutex());
   QSqlDatabase db(db_->Connect());
 
-  QStringList id_str_list;
-  id_str_list.reserve(id_list.count());
-  for (int i : id_list) {
-    id_str_list << QString::number(i);
-  }
-  QString ids = id_str_list.join(u',');
-  SqlQuery q(db);
-  q.prepare(QStringLiteral("UPDATE %1 SET rating = :rating WHERE ROWID IN (%2)").arg(songs_table_, ids));
-  q.BindValue(u":rating"_s, rating);
-  if (!q.Exec()) {
-    db_->ReportErrors(q);
-    return;
+  ScopedTransaction transaction(&db);
+
+  SqlQuery q_counts(db);
+  q_counts.prepare(QStringLiteral("UPDATE %1 SET playcount = playcount + :playcount, skipcount = skipcount + :skipcount, lastplayed = MAX(lastplayed, :lastplayed) WHERE ROWID = :id").arg(songs_table_));
+  SqlQuery q_rating(db);
+  q_rating.prepare(QStringLiteral("UPDATE %1 SET rating = :rating WHERE ROWID = :id").arg(songs_table_));
+
+  QStringList statistics_ids;
+  QStringList rating_ids;
+  QStringList rating_save_tags_ids;
+  for (QMap<int, PendingStatistics>::const_iterator it = pending_statistics.constBegin(); it != pending_statistics.constEnd(); ++it) {
+    const PendingStatistics &pending = it.value();
+    if (pending.playcount > 0 || pending.skipcount > 0) {
+      q_counts.BindValue(u":playcount"_s, pending.playcount);
+      q_counts.BindValue(u":skipcount"_s, pending.skipcount);
+      q_counts.BindValue(u":lastplayed"_s, pending.lastplayed);
+      q_counts.BindValue(u":id"_s, it.key());
+      if (!q_counts.Exec()) {
+        db_->ReportErrors(q_counts);
+        return;
+      }
+      statistics_ids << QString::number(it.key());
+    }
+    if (pending.update_rating) {
+      q_rating.BindValue(u":rating"_s, pending.rating);
+      q_rating.BindValue(u":id"_s, it.key());
+      if (!q_rating.Exec()) {
+        db_->ReportErrors(q_rating);
+        return;
+      }
+      if (pending.save_rating_tags) {
+        rating_save_tags_ids << QString::number(it.key());
+      }
+      else {
+        rating_ids << QString::number(it.key());
+      }
+    }
   }
 
-  SongList new_song_list = GetSongsById(id_str_list, db);
+  transaction.Commit();
 
-  Q_EMIT SongsRatingChanged(new_song_list, save_tags);
+  // The rating filters of the cached queries depend on the ratings.
+  if (!rating_ids.isEmpty() || !rating_save_tags_ids.isEmpty()) {
+    UpdateCache(SongList(), false);
+  }
+
+  if (!statistics_ids.isEmpty()) {
+    Q_EMIT SongsStatisticsChanged(GetSongsById(statistics_ids, db));
+  }
+  if (!rating_ids.isEmpty()) {
+    Q_EMIT SongsRatingChanged(GetSongsById(rating_ids, db), false);
+  }
+  if (!rating_save_tags_ids.isEmpty()) {
+    Q_EMIT SongsRatingChanged(GetSongsById(rating_save_tags_ids, db), true);
+  }
 
 }
 
@@ -2128,6 +3120,8 @@ void CollectionBackend::UpdateLastSeen(const int directory_id, const int expire_
     }
   }
 
+  song_index_.Clear();
+
   if (expire_unavailable_songs_days > 0) ExpireSongs(directory_id, expire_unavailable_songs_days);
 
 }
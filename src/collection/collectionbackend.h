@@ -29,8 +29,11 @@
 
 #include <QtGlobal>
 #include <QObject>
+#include <QMutex>
 #include <QFileInfo>
 #include <QList>
+#include <QHash>
+#include <QSet>
 #include <QString>
 #include <QStringList>
 #include <QUrl>
@@ -38,11 +41,15 @@
 
 #include "includes/shared_ptr.h"
 #include "core/song.h"
+#include "core/songbatch.h"
 #include "collectionfilteroptions.h"
 #include "collectionquery.h"
 #include "collectiondirectory.h"
+#include "collectionplaystatistics.h"
+#include "collectionsongindex.h"
 
 class QThread;
+class QTimer;
 class TaskManager;
 class Database;
 
@@ -127,6 +134,8 @@ class CollectionBackendInterface : public QObject {
 
   // Returns all sections of a song with the given filename. If there's just one section the resulting list will have it's size equal to 1.
   virtual SongList GetSongsByUrl(const QUrl &url, const bool unavailable = false) = 0;
+  // Same as GetSongsByUrl() for several URLs at once, using as few queries as possible.
+  virtual SongList GetSongsByUrls(const QList<QUrl> &urls, const bool unavailable = false) = 0;
   // Returns a section of a song with the given filename and beginning. If the section is not present in collection, returns invalid song.
   // Using default beginning value is suitable when searching for single-section songs.
   virtual Song GetSongByUrl(const QUrl &url, const qint64 beginning = 0) = 0;
@@ -201,9 +210,12 @@ class CollectionBackend : public CollectionBackendInterface {
   Song GetSongById(const int id) override;
   SongList GetSongsById(const QList<int> &ids);
   SongList GetSongsById(const QStringList &ids);
+  // Loads the detail columns of the songs loaded without them by the collection model, the other songs are returned as they are.
+  SongList GetCompleteSongs(const SongList &songs);
   SongList GetSongsByForeignId(const QStringList &ids, const QString &table, const QString &column);
 
   SongList GetSongsByUrl(const QUrl &url, const bool unavailable = false) override;
+  SongList GetSongsByUrls(const QList<QUrl> &urls, const bool unavailable = false) override;
   Song GetSongByUrl(const QUrl &url, qint64 beginning = 0) override;
   Song GetSongByUrlAndTrack(const QUrl &url, const int track) override;
 
@@ -225,7 +237,19 @@ class CollectionBackend : public CollectionBackendInterface {
 
   SongList GetSongsByFingerprint(const QString &fingerprint) override;
 
+  // Returns groups of songs with the same recording, compared by their fingerprints.
+  // The fingerprint index is updated with the songs not indexed yet first, so the first call on a large collection takes a while.
+  QList<SongList> GetFingerprintDuplicates();
+  void FindFingerprintDuplicatesAsync();
+
   SongList ExecuteQuery(const QString &sql);
+  // Runs a query selecting song ids only, and returns the ids.
+  QList<int> ExecuteSongIdQuery(const QString &sql);
+  // Runs a query selecting a single count, returns -1 if the query failed.
+  int ExecuteCountQuery(const QString &sql);
+
+  // Returns the ids of the songs matching an FTS5 query, or nothing if the songs table has no FTS index.
+  std::optional<QSet<int>> SearchSongIds(const QString &fts_query);
 
   void AddOrUpdateSongsAsync(const SongList &songs);
   void UpdateSongsBySongIDAsync(const SongMap &new_songs);
@@ -233,9 +257,14 @@ class CollectionBackend : public CollectionBackendInterface {
   void UpdateSongRatingAsync(const int id, const float rating, const bool save_tags = false);
   void UpdateSongsRatingAsync(const QList<int> &ids, const float rating, const bool save_tags = false);
 
+  void UpdateMTimesOnlyAsync(const SongList &songs);
   void DeleteSongsAsync(const SongList &songs);
   void DeleteSongsByUrlsAsync(const QList<QUrl> &url);
 
+  // Used by collection replicas, the songs keep the ids they have in the collection of the server.
+  void ReplicaResetAsync(const SongList &songs);
+  void ReplicaUpdateSongsAsync(const SongList &songs);
+
  public Q_SLOTS:
   void Exit();
   void GetAllSongs(const int id);
@@ -243,6 +272,7 @@ class CollectionBackend : public CollectionBackendInterface {
   void UpdateTotalSongCount();
   void UpdateTotalArtistCount();
   void UpdateTotalAlbumCount();
+  void FindFingerprintDuplicates();
   void AddDirectory(const QString &path);
   void RemoveDirectory(const CollectionDirectory &dir);
   void AddOrUpdateSongs(const SongList &songs);
@@ -265,15 +295,23 @@ class CollectionBackend : public CollectionBackendInterface {
   void ResetPlayStatistics(const QList<int> &id_list, const bool save_tags = false);
   bool ResetPlayStatistics(const QStringList &id_str_list);
   void DeleteAll();
+  void ReplicaReset(const SongList &songs);
+  void ReplicaUpdateSongs(const SongList &songs);
   void SongPathChanged(const Song &song, const QFileInfo &new_file, const std::optional<int> new_collection_directory_id);
+  void SongsPathChanged(const SongList &songs, const QList<QFileInfo> &new_files, const std::optional<int> new_collection_directory_id);
 
   SongList GetSongsBy(const QString &artist, const QString &album, const QString &title);
   void UpdateLastPlayed(const QString &artist, const QString &album, const QString &title, const qint64 lastplayed);
   void UpdatePlayCount(const QString &artist, const QString &title, const int playcount, const bool save_tags = false);
+  // Matches all statistics with one query and updates the songs in a single transaction.
+  void UpdatePlayStatistics(const CollectionPlayStatisticsList &statistics_list);
 
   void UpdateSongRating(const int id, const float rating, const bool save_tags = false);
   void UpdateSongsRating(const QList<int> &id_list, const float rating, const bool save_tags = false);
 
+  // Writes the buffered play counts, skip counts and ratings in one transaction.
+  void FlushStatistics();
+
   void UpdateLastSeen(const int directory_id, const int expire_unavailable_songs_days);
   void ExpireSongs(const int directory_id, const int expire_unavailable_songs_days);
 
@@ -282,9 +320,11 @@ class CollectionBackend : public CollectionBackendInterface {
   void DirectoryDeleted(const CollectionDirectory &dir);
 
   void GotSongs(const SongList &songs, const int id);
-  void SongsAdded(const SongList &songs);
-  void SongsDeleted(const SongList &songs);
-  void SongsChanged(const SongList &songs);
+  void SongsAdded(const SongBatch &songs);
+  void SongsDeleted(const SongBatch &songs);
+  void SongsChanged(const SongBatch &songs);
+  // Emitted once when the art of an album changed, with all the songs of the album.
+  void AlbumArtChanged(const SongList &songs);
   void SongsStatisticsChanged(const SongList &songs, const bool save_tags = false);
 
   void DatabaseReset();
@@ -292,6 +332,7 @@ class CollectionBackend : public CollectionBackendInterface {
   void TotalSongCountUpdated(const int count);
   void TotalArtistCountUpdated(const int count);
   void TotalAlbumCountUpdated(const int count);
+  void FingerprintDuplicatesFound(const QList<SongList> &duplicates);
   void SongsRatingChanged(const SongList &songs, const bool save_tags);
 
   void ExitFinished();
@@ -299,6 +340,17 @@ class CollectionBackend : public CollectionBackendInterface {
   void Error(const QString &error);
 
  private:
+  struct PendingStatistics {
+    PendingStatistics() : playcount(0), skipcount(0), lastplayed(-1), rating(-1.0F), update_rating(false), save_rating_tags(false) {}
+
+    int playcount;
+    int skipcount;
+    qint64 lastplayed;
+    float rating;
+    bool update_rating;
+    bool save_rating_tags;
+  };
+
   struct CompilationInfo {
     CompilationInfo() : has_compilation_detected(0), has_not_compilation_detected(0) {}
 
@@ -309,7 +361,8 @@ class CollectionBackend : public CollectionBackendInterface {
     int has_not_compilation_detected;
   };
 
-  bool UpdateCompilations(const QSqlDatabase &db, SongList &changed_songs, const QUrl &url, const bool compilation_detected);
+  static void ReadCompilationInfo(SqlQuery &q, QMap<QString, CompilationInfo> &compilation_info);
+  bool UpdateCompilations(const QSqlDatabase &db, SongList &changed_songs, const QList<QUrl> &urls, const bool compilation_detected);
   AlbumList GetAlbums(const QString &artist, const QString &album_artist, const bool compilation_required = false, const CollectionFilterOptions &opt = CollectionFilterOptions());
   AlbumList GetAlbums(const QString &artist, const bool compilation_required, const CollectionFilterOptions &opt = CollectionFilterOptions());
   CollectionSubdirectoryList SubdirsInDirectory(const int id, QSqlDatabase &db);
@@ -320,6 +373,26 @@ class CollectionBackend : public CollectionBackendInterface {
   Song GetSongBySongId(const QString &song_id, QSqlDatabase &db);
   SongList GetSongsBySongId(const QStringList &song_ids, QSqlDatabase &db);
 
+  bool InsertSongs(QSqlDatabase &db, const SongList &songs, SongList &added_songs);
+  // Binds the song, leaving out the lyrics stored by SaveLongText().
+  void BindSongToQuery(const Song &song, SqlQuery *q) const;
+  // Stores long lyrics of a collection song compressed in the long text table, and removes them when the lyrics got shorter.
+  bool SaveLongText(QSqlDatabase &db, const Song &song);
+
+  // All songs with the URL, including unavailable songs, from the song index when possible.
+  SongList GetAllSongsByUrl(const QUrl &url);
+  // Inserts or updates the songs with their own ids.
+  bool ReplicaWriteSongs(QSqlDatabase &db, const SongList &songs, SongList &added_songs, SongList &changed_songs);
+
+  // Hashes the fingerprints of the songs not in the fingerprint index yet, in batches.
+  bool UpdateFingerprintIndex();
+
+  // Key of a cached aggregate query result, empty if the result can't be cached.
+  static QString CacheKey(const QString &query, const QString &argument, const CollectionFilterOptions &filter_options);
+  // Called after the songs changed, drops the cached query results.
+  // The cached totals are updated with the added songs, or counted again on the next update when songs were also changed or deleted.
+  void UpdateCache(const SongList &added_songs, const bool recount);
+
  private:
   SharedPtr<Database> db_;
   SharedPtr<TaskManager> task_manager_;
@@ -327,7 +400,29 @@ class CollectionBackend : public CollectionBackendInterface {
   QString songs_table_;
   QString dirs_table_;
   QString subdirs_table_;
+  // Only the collection songs table keeps long lyrics in the long text table.
+  bool long_text_;
+  QString column_spec_;
   QThread *original_thread_;
+  std::optional<bool> fts_available_;
+
+  // Song ID -> statistics changes not written yet
+  QMap<int, PendingStatistics> pending_statistics_;
+  QTimer *timer_flush_statistics_;
+
+  // Results of the aggregate queries.
+  // cache_generation_ is increased on every change, a result is only stored if it didn't change while the result was queried.
+  QMutex mutex_cache_;
+  quint64 cache_generation_;
+  QHash<QString, QStringList> cached_string_lists_;
+  QHash<QString, AlbumList> cached_album_lists_;
+  std::optional<int> cached_song_count_;
+  // Number of available songs per artist and per album, so the totals don't need to be counted again when songs are added.
+  std::optional<QHash<QString, int>> cached_artist_songs_;
+  std::optional<QHash<QString, int>> cached_album_songs_;
+
+  // Songs looked up by ID, URL and song ID.
+  CollectionSongIndex song_index_;
 };
 
 #endif  // COLLECTIONBACKEND_H
@@ -0,0 +1,222 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "config.h"
+
+#include <QtGlobal>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QByteArray>
+#include <QDataStream>
+#include <QList>
+#include <QHash>
+#include <QSet>
+#include <QString>
+
+#include "core/logging.h"
+#include "core/database.h"
+#include "core/song.h"
+#include "core/standardpaths.h"
+#include "collectionfilteroptions.h"
+#include "collectionchangefeed.h"
+
+using namespace Qt::Literals::StringLiterals;
+
+namespace CollectionChangeFeed {
+
+namespace {
+
+constexpr quint32 kMagic = 0x53434346;  // SCCF
+// Increase when Song::ToDataStream() changes.
+constexpr quint32 kFormatVersion = 1;
+constexpr QDataStream::Version kDataStreamVersion = QDataStream::Qt_6_4;
+// When the feed grows beyond this without being applied, it's started over, loading the songs from the database is faster then.
+constexpr qint64 kMaxFileSize = 128LL * 1024LL * 1024LL;
+
+struct Entry {
+  qint64 change_counter_from = 0;
+  qint64 change_counter_to = 0;
+  SongList songs_updated;
+  QList<int> song_ids_deleted;
+};
+
+QString Filename(const QString &songs_table) {
+
+  return StandardPaths::WritableLocation(StandardPaths::StandardLocation::CacheLocation) + "/collection-changes-"_L1 + songs_table + ".bin"_L1;
+
+}
+
+}  // namespace
+
+void Append(const QString &songs_table, const qint64 change_counter_from, const qint64 change_counter_to, const SongList &songs_updated, const QList<int> &song_ids_deleted) {
+
+  if (change_counter_from == -1 || change_counter_to == -1 || change_counter_from == change_counter_to) return;
+
+  const QString filename = Filename(songs_table);
+  if (!QDir().mkpath(QFileInfo(filename).path())) return;
+
+  QFile file(filename);
+  if (file.exists() && file.size() > kMaxFileSize) {
+    qLog(Debug) << "Collection change feed for" << songs_table << "is too large, starting over";
+    file.remove();
+  }
+
+  const bool create = !file.exists() || file.size() == 0;
+  if (!file.open(create ? QIODevice::WriteOnly : QIODevice::Append)) {
+    qLog(Warning) << "Could not open" << filename << "for writing" << file.errorString();
+    return;
+  }
+
+  QDataStream s(&file);
+  s.setVersion(kDataStreamVersion);
+  if (create) {
+    s << kMagic << kFormatVersion << static_cast<qint32>(Database::kSchemaVersion);
+  }
+
+  s << change_counter_from << change_counter_to << static_cast<qint64>(songs_updated.count());
+  for (const Song &song : songs_updated) {
+    song.ToDataStream(&s);
+  }
+  s << static_cast<qint64>(song_ids_deleted.count());
+  for (const int song_id : song_ids_deleted) {
+    s << static_cast<qint32>(song_id);
+  }
+
+  if (s.status() != QDataStream::Ok) {
+    qLog(Warning) << "Could not write collection change feed" << filename;
+    file.close();
+    file.remove();
+    return;
+  }
+
+  qLog(Debug) << "Wrote" << songs_updated.count() << "updated and" << song_ids_deleted.count() << "deleted songs to the collection change feed";
+
+}
+
+bool Apply(const QString &songs_table, const qint64 change_counter_from, const qint64 change_counter_to, const CollectionFilterOptions &filter_options, SongList &songs) {
+
+  if (change_counter_from == -1 || change_counter_to == -1 || change_counter_to < change_counter_from) return false;
+
+  QFile file(Filename(songs_table));
+  if (!file.exists() || !file.open(QIODevice::ReadOnly)) return false;
+
+  QDataStream s(&file);
+  s.setVersion(kDataStreamVersion);
+
+  quint32 magic = 0;
+  quint32 format_version = 0;
+  qint32 schema_version = 0;
+  s >> magic >> format_version >> schema_version;
+  if (s.status() != QDataStream::Ok || magic != kMagic || format_version != kFormatVersion || schema_version != Database::kSchemaVersion) {
+    return false;
+  }
+
+  // Collect the entries following each other from the counter of the snapshot up to the current counter.
+  QList<Entry> entries;
+  qint64 change_counter = change_counter_from;
+  while (!s.atEnd() && change_counter != change_counter_to) {
+    Entry entry;
+    qint64 count_updated = 0;
+    s >> entry.change_counter_from >> entry.change_counter_to >> count_updated;
+    if (s.status() != QDataStream::Ok || count_updated < 0) break;
+    const bool needed = entry.change_counter_from == change_counter;
+    for (qint64 i = 0; i < count_updated && s.status() == QDataStream::Ok; ++i) {
+      Song song;
+      song.InitFromDataStream(&s);
+      if (needed) entry.songs_updated << song;
+    }
+    qint64 count_deleted = 0;
+    s >> count_deleted;
+    if (s.status() != QDataStream::Ok || count_deleted < 0) break;
+    for (qint64 i = 0; i < count_deleted && s.status() == QDataStream::Ok; ++i) {
+      qint32 song_id = -1;
+      s >> song_id;
+      if (needed) entry.song_ids_deleted << song_id;
+    }
+    if (s.status() != QDataStream::Ok) break;
+    if (needed) {
+      change_counter = entry.change_counter_to;
+      entries << entry;
+    }
+  }
+
+  if (change_counter != change_counter_to) {
+    qLog(Debug) << "Collection change feed for" << songs_table << "doesn't cover the changes from" << change_counter_from << "to" << change_counter_to;
+    return false;
+  }
+
+  QHash<int, qsizetype> song_indexes;
+  song_indexes.reserve(songs.count());
+  for (qsizetype i = 0; i < songs.count(); ++i) {
+    song_indexes.insert(songs[i].id(), i);
+  }
+
+  QSet<int> song_ids_removed;
+  qint64 songs_updated = 0;
+  for (const Entry &entry : std::as_const(entries)) {
+    for (const Song &song : entry.songs_updated) {
+      const bool visible = !song.unavailable() && filter_options.Matches(song);
+      const QHash<int, qsizetype>::const_iterator it = song_indexes.constFind(song.id());
+      if (it != song_indexes.constEnd()) {
+        songs[it.value()] = song;
+        if (visible) {
+          song_ids_removed.remove(song.id());
+        }
+        else {
+          song_ids_removed.insert(song.id());
+        }
+      }
+      else if (visible) {
+        song_indexes.insert(song.id(), songs.count());
+        songs << song;
+      }
+      ++songs_updated;
+    }
+    for (const int song_id : entry.song_ids_deleted) {
+      if (song_indexes.contains(song_id)) song_ids_removed.insert(song_id);
+    }
+  }
+
+  if (!song_ids_removed.isEmpty()) {
+    songs.removeIf([&song_ids_removed](const Song &song) { return song_ids_removed.contains(song.id()); });
+  }
+
+  qLog(Debug) << "Applied" << entries.count() << "collection change feed entries with" << songs_updated << "updated and" << song_ids_removed.count() << "removed songs";
+
+  return true;
+
+}
+
+bool Exists(const QString &songs_table) {
+
+  return QFile::exists(Filename(songs_table));
+
+}
+
+void Clear(const QString &songs_table) {
+
+  const QString filename = Filename(songs_table);
+  if (QFile::exists(filename)) {
+    QFile::remove(filename);
+  }
+
+}
+
+}  // namespace CollectionChangeFeed
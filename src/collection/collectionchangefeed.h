@@ -0,0 +1,49 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef COLLECTIONCHANGEFEED_H
+#define COLLECTIONCHANGEFEED_H
+
+#include "config.h"
+
+#include <QtGlobal>
+#include <QList>
+#include <QString>
+
+#include "core/song.h"
+
+class CollectionFilterOptions;
+
+// Songs changed by the headless collection scanner, appended after every scan.
+// Each entry stores the change counter of the songs table before and after the scan, so a stale collection snapshot can be brought up to date with the entries following it instead of loading all songs from the database.
+// The feed is cleared when a new snapshot is written.
+namespace CollectionChangeFeed {
+
+void Append(const QString &songs_table, const qint64 change_counter_from, const qint64 change_counter_to, const SongList &songs_updated, const QList<int> &song_ids_deleted);
+
+// Applies the entries from change_counter_from up to change_counter_to to the songs of a snapshot.
+// Returns false, leaving the songs unchanged, when the feed doesn't cover all changes in between.
+bool Apply(const QString &songs_table, const qint64 change_counter_from, const qint64 change_counter_to, const CollectionFilterOptions &filter_options, SongList &songs);
+
+bool Exists(const QString &songs_table);
+void Clear(const QString &songs_table);
+
+}  // namespace CollectionChangeFeed
+
+#endif  // COLLECTIONCHANGEFEED_H
@@ -48,6 +48,8 @@ struct CollectionSubdirectory {
   int directory_id;
   QString path;
   qint64 mtime;
+  // The album art picked for the songs in this subdirectory, valid as long as the mtime is unchanged.
+  QString art_automatic;
 };
 Q_DECLARE_METATYPE(CollectionSubdirectory)
 
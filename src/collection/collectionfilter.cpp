@@ -26,8 +26,11 @@
 #include <QList>
 #include <QString>
 #include <QUrl>
+#include <QFutureWatcher>
 
+#include "includes/shared_ptr.h"
 #include "core/song.h"
+#include "core/taskexecutor.h"
 #include "core/songmimedata.h"
 #include "filterparser/filterparser.h"
 #include "filterparser/filtertree.h"
@@ -36,7 +39,7 @@
 #include "collectionmodel.h"
 #include "collectionitem.h"
 
-CollectionFilter::CollectionFilter(QObject *parent) : QSortFilterProxyModel(parent), query_hash_(0) {
+CollectionFilter::CollectionFilter(QObject *parent) : QSortFilterProxyModel(parent), query_hash_(0), search_watcher_(nullptr) {
 
   setSortLocaleAware(true);
   setDynamicSortFilter(true);
@@ -44,6 +47,10 @@ CollectionFilter::CollectionFilter(QObject *parent) : QSortFilterProxyModel(pare
 
 }
 
+CollectionFilter::~CollectionFilter() {
+  CancelSearch();
+}
+
 bool CollectionFilter::filterAcceptsRow(const int source_row, const QModelIndex &source_parent) const {
 
   CollectionModel *model = qobject_cast<CollectionModel*>(sourceModel());
@@ -59,29 +66,190 @@ bool CollectionFilter::filterAcceptsRow(const int source_row, const QModelIndex
     return item->type == CollectionItem::Type::LoadingIndicator;
   }
 
+  if (matching_song_ids_.has_value()) {
+    return item->metadata.is_valid() && matching_song_ids_->contains(item->metadata.id());
+  }
+
   size_t hash = qHash(filter_string_);
   if (hash != query_hash_) {
     FilterParser p(filter_string_);
     filter_tree_.reset(p.parse());
     query_hash_ = hash;
+    fts_song_ids_.reset();
+    const QString fts_query = filter_tree_->FtsQuery();
+    if (!fts_query.isEmpty() && model->backend()) {
+      fts_song_ids_ = model->backend()->SearchSongIds(fts_query);
+    }
+  }
+
+  if (!item->metadata.is_valid()) return false;
+
+  // Songs without a title are matched on the filename, which is not in the FTS index.
+  if (fts_song_ids_.has_value() && !item->metadata.title().isEmpty()) {
+    return fts_song_ids_->contains(item->metadata.id());
+  }
+
+  return filter_tree_->accept(item->metadata);
+
+}
+
+void CollectionFilter::setSourceModel(QAbstractItemModel *source_model) {
+
+  QSortFilterProxyModel::setSourceModel(source_model);
+
+  // Songs matching the FTS query might have been added or changed, so run the query again for the new rows.
+  // The songs found by an async search don't cover the new rows either, so those go back to filtering each row.
+  if (source_model) {
+    QObject::connect(source_model, &QAbstractItemModel::rowsAboutToBeInserted, this, [this]() { query_hash_ = 0; matching_song_ids_.reset(); });
+    QObject::connect(source_model, &QAbstractItemModel::modelAboutToBeReset, this, [this]() { query_hash_ = 0; matching_song_ids_.reset(); });
+  }
+
+}
+
+bool CollectionFilter::lessThan(const QModelIndex &source_left, const QModelIndex &source_right) const {
+
+  CollectionModel *model = qobject_cast<CollectionModel*>(sourceModel());
+  if (!model || sortRole() != CollectionModel::Role_SortText) {
+    return QSortFilterProxyModel::lessThan(source_left, source_right);
+  }
+
+  CollectionItem *item_left = model->IndexToItem(source_left);
+  CollectionItem *item_right = model->IndexToItem(source_right);
+  if (!item_left || !item_right) {
+    return QSortFilterProxyModel::lessThan(source_left, source_right);
+  }
+
+  // Collation keys are created once per item, so sorting doesn't need a locale aware string comparison for each step.
+  return SortKey(item_left).compare(SortKey(item_right)) < 0;
+
+}
+
+const QCollatorSortKey &CollectionFilter::SortKey(CollectionItem *item) const {
+
+  if (!item->sort_key.has_value()) {
+    item->sort_key = collator_.sortKey(item->sort_text);
   }
 
-  return item->metadata.is_valid() && filter_tree_->accept(item->metadata);
+  return *item->sort_key;
 
 }
 
 void CollectionFilter::SetFilterString(const QString &filter_string) {
 
+  CancelSearch();
+
   filter_string_ = filter_string;
+  matching_song_ids_.reset();
+
+  if (CollectionModel *model = qobject_cast<CollectionModel*>(sourceModel())) {
+    model->SetLoadAllItems(!filter_string_.isEmpty());
+  }
   setFilterFixedString(filter_string);
 
 }
 
+void CollectionFilter::SetFilterStringAsync(const QString &filter_string) {
+
+  CollectionModel *model = qobject_cast<CollectionModel*>(sourceModel());
+  if (!model || filter_string.isEmpty()) {
+    SetFilterString(filter_string);
+    return;
+  }
+
+  CancelSearch();
+
+  // All songs need to be in the model for the snapshot searched on the worker thread.
+  model->SetLoadAllItems(true);
+
+  FilterParser p(filter_string);
+  SharedPtr<FilterTree> filter_tree(p.parse());
+
+  const QList<CollectionItem*> song_items = model->song_nodes();
+  SongList songs;
+  songs.reserve(song_items.count());
+  for (CollectionItem *item : song_items) {
+    songs << item->metadata;
+  }
+
+  QFutureWatcher<QSet<int>> *watcher = new QFutureWatcher<QSet<int>>(this);
+  search_watcher_ = watcher;
+  QObject::connect(watcher, &QFutureWatcher<QSet<int>>::finished, this, [this, watcher, filter_string, filter_tree]() {
+    if (watcher != search_watcher_) return;
+    search_watcher_ = nullptr;
+    const QSet<int> song_ids = watcher->result();
+    watcher->deleteLater();
+    AsyncSearchFinished(filter_string, filter_tree, song_ids);
+  });
+  watcher->setFuture(TaskExecutor::Run(TaskExecutor::Lane::Interactive, &CollectionFilter::MatchingSongIds, model->backend(), filter_tree, songs));
+
+  Q_EMIT SearchStarted();
+
+}
+
+void CollectionFilter::CancelSearch() {
+
+  if (!search_watcher_) return;
+
+  search_watcher_->cancel();
+  search_watcher_->deleteLater();
+  search_watcher_ = nullptr;
+
+  Q_EMIT SearchFinished();
+
+}
+
+QSet<int> CollectionFilter::MatchingSongIds(const SharedPtr<CollectionBackend> backend, const SharedPtr<FilterTree> filter_tree, const SongList &songs) {
+
+  std::optional<QSet<int>> fts_song_ids;
+  const QString fts_query = filter_tree->FtsQuery();
+  if (!fts_query.isEmpty() && backend) {
+    fts_song_ids = backend->SearchSongIds(fts_query);
+  }
+
+  QSet<int> song_ids;
+  for (const Song &song : songs) {
+    if (!song.is_valid()) continue;
+    // Songs without a title are matched on the filename, which is not in the FTS index.
+    const bool accept = fts_song_ids.has_value() && !song.title().isEmpty() ? fts_song_ids->contains(song.id()) : filter_tree->accept(song);
+    if (accept) {
+      song_ids.insert(song.id());
+    }
+  }
+
+  return song_ids;
+
+}
+
+void CollectionFilter::AsyncSearchFinished(const QString &filter_string, const SharedPtr<FilterTree> filter_tree, const QSet<int> &song_ids) {
+
+  filter_string_ = filter_string;
+  filter_tree_ = filter_tree;
+  query_hash_ = qHash(filter_string_);
+  fts_song_ids_.reset();
+  matching_song_ids_ = song_ids;
+
+  invalidateFilter();
+
+  Q_EMIT SearchFinished();
+
+}
+
 QMimeData *CollectionFilter::mimeData(const QModelIndexList &indexes) const {
 
   if (indexes.isEmpty()) return nullptr;
 
   CollectionModel *collection_model = qobject_cast<CollectionModel*>(sourceModel());
+
+  // Without a filter all the songs are accepted, so there is no need to load the children of containers that weren't expanded.
+  if (filter_string_.isEmpty()) {
+    QModelIndexList source_indexes;
+    source_indexes.reserve(indexes.count());
+    for (const QModelIndex &idx : indexes) {
+      source_indexes << mapToSource(idx);
+    }
+    return collection_model->mimeData(source_indexes);
+  }
+
   SongMimeData *data = new SongMimeData;
   data->backend = collection_model->backend();
 
@@ -92,6 +260,7 @@ QMimeData *CollectionFilter::mimeData(const QModelIndexList &indexes) const {
     CollectionItem *item = collection_model->IndexToItem(source_index);
     GetChildSongs(item, song_ids, urls, data->songs);
   }
+  data->songs = collection_model->backend()->GetCompleteSongs(data->songs);
 
   data->setUrls(urls);
   data->name_for_new_playlist_ = Song::GetNameForNewPlaylist(data->songs);
@@ -106,6 +275,7 @@ void CollectionFilter::GetChildSongs(CollectionItem *item, QSet<int> &song_ids,
 
   switch (item->type) {
     case CollectionItem::Type::Container:{
+      collection_model->FetchLazyItem(item);
       QList<CollectionItem*> children = item->children;
       std::sort(children.begin(), children.end(), std::bind(&CollectionModel::CompareItems, collection_model, std::placeholders::_1, std::placeholders::_2));
       for (CollectionItem *child : children) {
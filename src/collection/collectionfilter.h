@@ -22,37 +22,62 @@
 
 #include "config.h"
 
+#include <optional>
+
 #include <QSortFilterProxyModel>
-#include <QScopedPointer>
+#include <QCollator>
+#include <QCollatorSortKey>
 #include <QSet>
 #include <QList>
 #include <QUrl>
 
+#include "includes/shared_ptr.h"
 #include "core/song.h"
 #include "filterparser/filtertree.h"
 
 class CollectionItem;
+class CollectionBackend;
+template<typename T> class QFutureWatcher;
 
 class CollectionFilter : public QSortFilterProxyModel {
   Q_OBJECT
 
  public:
   explicit CollectionFilter(QObject *parent = nullptr);
+  ~CollectionFilter() override;
 
   void SetFilterString(const QString &filter_string);
+  // Finds the matching songs on a worker thread, the filter is applied in one go when the search is done.
+  void SetFilterStringAsync(const QString &filter_string);
   QString filter_string() const { return filter_string_; }
 
+  void setSourceModel(QAbstractItemModel *source_model) override;
+
+ Q_SIGNALS:
+  void SearchStarted();
+  void SearchFinished();
+
  protected:
   bool filterAcceptsRow(const int source_row, const QModelIndex &source_parent) const override;
+  bool lessThan(const QModelIndex &source_left, const QModelIndex &source_right) const override;
   QMimeData *mimeData(const QModelIndexList &indexes) const override;
 
  private:
   void GetChildSongs(CollectionItem *item, QSet<int> &song_ids, QList<QUrl> &urls, SongList &songs) const;
+  const QCollatorSortKey &SortKey(CollectionItem *item) const;
+  void CancelSearch();
+  static QSet<int> MatchingSongIds(const SharedPtr<CollectionBackend> backend, const SharedPtr<FilterTree> filter_tree, const SongList &songs);
+  void AsyncSearchFinished(const QString &filter_string, const SharedPtr<FilterTree> filter_tree, const QSet<int> &song_ids);
 
  private:
-  mutable QScopedPointer<FilterTree> filter_tree_;
+  mutable SharedPtr<FilterTree> filter_tree_;
   mutable size_t query_hash_;
+  mutable std::optional<QSet<int>> fts_song_ids_;
+  // Songs matching the filter string, when it was searched on a worker thread.
+  mutable std::optional<QSet<int>> matching_song_ids_;
+  QFutureWatcher<QSet<int>> *search_watcher_;
   QString filter_string_;
+  QCollator collator_;
 };
 
 #endif  // COLLECTIONFILTER_H
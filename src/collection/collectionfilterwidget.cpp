@@ -56,6 +56,7 @@
 #include "groupbydialog.h"
 #include "ui_collectionfilterwidget.h"
 #include "widgets/searchfield.h"
+#include "widgets/busyindicator.h"
 #include "constants/collectionsettings.h"
 #include "constants/appearancesettings.h"
 
@@ -63,6 +64,8 @@ using namespace Qt::Literals::StringLiterals;
 
 namespace {
 constexpr int kFilterDelay = 500;  // msec
+// Libraries from this size are searched on a worker thread.
+constexpr int kAsyncFilterSongCount = 20000;
 }
 
 CollectionFilterWidget::CollectionFilterWidget(QWidget *parent)
@@ -84,6 +87,7 @@ CollectionFilterWidget::CollectionFilterWidget(QWidget *parent)
   ui_->setupUi(this);
 
   ui_->search_field->setToolTip(FilterParser::ToolTip());
+  ui_->search_busy->hide();
 
   QObject::connect(ui_->search_field, &SearchField::returnPressed, this, &CollectionFilterWidget::ReturnPressed);
   QObject::connect(timer_filter_delay_, &QTimer::timeout, this, &CollectionFilterWidget::FilterDelayTimeout);
@@ -175,7 +179,7 @@ void CollectionFilterWidget::Init(CollectionModel *model, CollectionFilter *filt
   }
 
   model_ = model;
-  filter_ = filter;
+  setFilter(filter);
 
   // Connect signals
   QObject::connect(model_, &CollectionModel::GroupingChanged, group_by_dialog_, &GroupByDialog::CollectionGroupingChanged);
@@ -231,7 +235,20 @@ void CollectionFilterWidget::SetSettingsPrefix(const QString &prefix) {
 }
 
 void CollectionFilterWidget::setFilter(CollectionFilter *filter) {
+
+  if (filter_) {
+    QObject::disconnect(filter_, &CollectionFilter::SearchStarted, ui_->search_busy, &BusyIndicator::show);
+    QObject::disconnect(filter_, &CollectionFilter::SearchFinished, ui_->search_busy, &BusyIndicator::hide);
+  }
+
   filter_ = filter;
+  ui_->search_busy->hide();
+
+  if (filter_) {
+    QObject::connect(filter_, &CollectionFilter::SearchStarted, ui_->search_busy, &BusyIndicator::show);
+    QObject::connect(filter_, &CollectionFilter::SearchFinished, ui_->search_busy, &BusyIndicator::hide);
+  }
+
 }
 
 void CollectionFilterWidget::ReloadSettings() {
@@ -551,8 +568,14 @@ void CollectionFilterWidget::FilterTextChanged(const QString &text) {
 
 void CollectionFilterWidget::FilterDelayTimeout() {
 
-  if (filter_applies_to_model_) {
-    filter_->SetFilterString(ui_->search_field->text());
+  if (!filter_applies_to_model_) return;
+
+  const QString text = ui_->search_field->text();
+  if (!text.isEmpty() && model_->total_song_count() >= kAsyncFilterSongCount) {
+    filter_->SetFilterStringAsync(text);
+  }
+  else {
+    filter_->SetFilterString(text);
   }
 
 }
@@ -20,6 +20,10 @@
 #ifndef COLLECTIONITEM_H
 #define COLLECTIONITEM_H
 
+#include <optional>
+
+#include <QCollatorSortKey>
+
 #include "core/simpletreeitem.h"
 #include "core/song.h"
 
@@ -41,6 +45,9 @@ class CollectionItem : public SimpleTreeItem<CollectionItem> {
   Song metadata;
   CollectionItem *compilation_artist_node_;
 
+  // Collation key for sort_text, created the first time the item is sorted.
+  std::optional<QCollatorSortKey> sort_key;
+
  private:
   Q_DISABLE_COPY(CollectionItem)
 };
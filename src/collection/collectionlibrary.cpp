@@ -37,11 +37,15 @@
 #include "core/logging.h"
 #include "core/settings.h"
 #include "tagreader/tagreaderclient.h"
+#include "tagreader/tagreaderreply.h"
+#include "tagreader/tagreaderwritefilesreply.h"
 #include "utilities/threadutils.h"
 #include "collectionlibrary.h"
 #include "collectionwatcher.h"
 #include "collectionbackend.h"
 #include "collectionmodel.h"
+#include "collectionserver.h"
+#include "collectionreplica.h"
 #include "constants/collectionsettings.h"
 
 using std::make_shared;
@@ -62,6 +66,8 @@ CollectionLibrary::CollectionLibrary(const SharedPtr<Database> database,
       model_(nullptr),
       watcher_(nullptr),
       watcher_thread_(nullptr),
+      server_(nullptr),
+      replica_(nullptr),
       original_thread_(thread()),
       save_playcounts_to_files_(false),
       save_ratings_to_files_(false) {
@@ -75,6 +81,7 @@ CollectionLibrary::CollectionLibrary(const SharedPtr<Database> database,
   backend_->Init(database, task_manager, Song::Source::Collection, QLatin1String(kSongsTable), QLatin1String(kDirsTable), QLatin1String(kSubdirsTable));
 
   model_ = new CollectionModel(backend_, albumcover_loader, this);
+  model_->EnableAlbumIconPregeneration(task_manager);
 
   full_rescan_revisions_[21] = tr("Support for sort tags artist, album, album artist, title, composer and performer");
 
@@ -125,6 +132,29 @@ void CollectionLibrary::Init() {
   QObject::connect(watcher_, &CollectionWatcher::SubdirsDeleted, &*backend_, &CollectionBackend::DeleteSubdirs);
   QObject::connect(watcher_, &CollectionWatcher::CompilationsNeedUpdating, &*backend_, &CollectionBackend::CompilationsNeedUpdating);
   QObject::connect(watcher_, &CollectionWatcher::UpdateLastSeen, &*backend_, &CollectionBackend::UpdateLastSeen);
+  QObject::connect(watcher_, &CollectionWatcher::LrcFilesFound, this, &CollectionLibrary::LrcFilesFound);
+
+  Settings s;
+  s.beginGroup(CollectionSettings::kSettingsGroup);
+  const CollectionSettings::ServerMode server_mode = static_cast<CollectionSettings::ServerMode>(s.value(CollectionSettings::kServerMode, static_cast<int>(CollectionSettings::ServerMode::Standalone)).toInt());
+  const QString server_host = s.value(CollectionSettings::kServerHost).toString();
+  const quint16 server_port = static_cast<quint16>(s.value(CollectionSettings::kServerPort, CollectionSettings::kServerPortDefault).toUInt());
+  const QString server_password = s.value(CollectionSettings::kServerPassword).toString();
+  s.endGroup();
+
+  if (server_mode == CollectionSettings::ServerMode::Replica) {
+    // The songs come from the server, the directories are not given to the watcher so nothing is scanned locally.
+    QObject::disconnect(&*backend_, &CollectionBackend::DirectoryAdded, watcher_, &CollectionWatcher::AddDirectory);
+    replica_ = new CollectionReplica(backend_, this);
+    QObject::connect(replica_, &CollectionReplica::Error, this, &CollectionLibrary::Error);
+    replica_->Start(server_host, server_port, server_password);
+    return;
+  }
+
+  if (server_mode == CollectionSettings::ServerMode::Server) {
+    server_ = new CollectionServer(backend_, this);
+    server_->Listen(server_port, server_password);
+  }
 
   // This will start the watcher checking for updates
   backend_->LoadDirectoriesAsync();
@@ -160,6 +190,8 @@ void CollectionLibrary::IncrementalScan() { watcher_->IncrementalScanAsync(); }
 
 void CollectionLibrary::FullScan() { watcher_->FullScanAsync(); }
 
+void CollectionLibrary::MountPointsChanged() { watcher_->RefreshMountPointsAsync(); }
+
 void CollectionLibrary::StopScan() { watcher_->Stop(); }
 
 void CollectionLibrary::Rescan(const SongList &songs) {
@@ -256,7 +288,7 @@ void CollectionLibrary::SongsPlaycountChanged(const SongList &songs, const bool
       }
     }
     if (!songs_to_save_now.isEmpty()) {
-      tagreader_client_->SaveSongsPlaycountAsync(songs_to_save_now);
+      UpdateMTimesWhenWritten(tagreader_client_->SaveSongsPlaycountAsync(songs_to_save_now));
     }
   }
 
@@ -287,7 +319,7 @@ void CollectionLibrary::SongsRatingChanged(const SongList &songs, const bool sav
       }
     }
     if (!songs_to_save_now.isEmpty()) {
-      tagreader_client_->SaveSongsRatingAsync(songs_to_save_now);
+      UpdateMTimesWhenWritten(tagreader_client_->SaveSongsRatingAsync(songs_to_save_now));
     }
   }
 
@@ -295,6 +327,7 @@ void CollectionLibrary::SongsRatingChanged(const SongList &songs, const bool sav
 
 void CollectionLibrary::SavePendingPlaycountsAndRatings() {
 
+  QList<TagReaderClient::WriteFileData> files;
   for (QMap<QUrl, SharedPtr<PendingSongSave>>::iterator it = pending_song_saves_.begin(); it != pending_song_saves_.end();) {
     const QUrl url = it.key();
     SharedPtr<PendingSongSave> pending_song_save = it.value();
@@ -303,13 +336,33 @@ void CollectionLibrary::SavePendingPlaycountsAndRatings() {
       continue;
     }
     qLog(Debug) << "Saving deferred playcount/rating for" << url.toLocalFile();
+    TagReaderClient::SaveOptions save_tags_options;
     if (pending_song_save->save_playcount) {
-      tagreader_client_->SaveSongsPlaycountAsync(SongList() << pending_song_save->song);
+      save_tags_options |= TagReaderClient::SaveOption::Playcount;
     }
     if (pending_song_save->save_rating) {
-      tagreader_client_->SaveSongsRatingAsync(SongList() << pending_song_save->song);
+      save_tags_options |= TagReaderClient::SaveOption::Rating;
     }
+    files << TagReaderClient::WriteFileData(pending_song_save->song, save_tags_options);
     it = pending_song_saves_.erase(it);
   }
 
+  if (!files.isEmpty()) {
+    UpdateMTimesWhenWritten(tagreader_client_->WriteFilesAsync(files));
+  }
+
+}
+
+void CollectionLibrary::UpdateMTimesWhenWritten(TagReaderWriteFilesReplyPtr reply) {
+
+  SharedPtr<QMetaObject::Connection> connection = make_shared<QMetaObject::Connection>();
+  *connection = QObject::connect(&*reply, &TagReaderReply::Finished, this, [this, reply, connection]() {
+    // Store the new file size and modification time right away, so the watcher doesn't read the tags again.
+    const SongList songs = reply->songs().values();
+    if (!songs.isEmpty()) {
+      backend_->UpdateMTimesOnlyAsync(songs);
+    }
+    QObject::disconnect(*connection);
+  }, Qt::QueuedConnection);
+
 }
@@ -29,9 +29,11 @@
 #include <QHash>
 #include <QMap>
 #include <QString>
+#include <QStringList>
 
 #include "includes/shared_ptr.h"
 #include "core/song.h"
+#include "tagreader/tagreaderwritefilesreply.h"
 
 class QThread;
 class Thread;
@@ -41,6 +43,8 @@ class TagReaderClient;
 class CollectionBackend;
 class CollectionModel;
 class CollectionWatcher;
+class CollectionServer;
+class CollectionReplica;
 class AlbumCoverLoader;
 
 class CollectionLibrary : public QObject {
@@ -73,6 +77,7 @@ class CollectionLibrary : public QObject {
  private:
   void SyncPlaycountAndRatingToFiles();
   void SavePendingPlaycountsAndRatings();
+  void UpdateMTimesWhenWritten(TagReaderWriteFilesReplyPtr reply);
 
  public Q_SLOTS:
   void ReloadSettings();
@@ -85,6 +90,7 @@ class CollectionLibrary : public QObject {
   void Rescan(const SongList &songs);
 
   void IncrementalScan();
+  void MountPointsChanged();
 
   void CurrentSongChanged(const Song &song);
   void Stopped();
@@ -96,6 +102,7 @@ class CollectionLibrary : public QObject {
 
  Q_SIGNALS:
   void Error(const QString &error);
+  void LrcFilesFound(const SongList &songs, const QStringList &lrc_data);
   void ExitFinished();
 
  private:
@@ -114,6 +121,8 @@ class CollectionLibrary : public QObject {
 
   CollectionWatcher *watcher_;
   Thread *watcher_thread_;
+  CollectionServer *server_;
+  CollectionReplica *replica_;
   QThread *original_thread_;
 
   // DB schema versions which should trigger a full collection rescan (each of those with a short reason why).
@@ -35,7 +35,6 @@
 #include <QFutureWatcher>
 #include <QDataStream>
 #include <QMimeData>
-#include <QIODevice>
 #include <QList>
 #include <QSet>
 #include <QMap>
@@ -47,22 +46,25 @@
 #include <QImage>
 #include <QChar>
 #include <QRegularExpression>
-#include <QPixmapCache>
-#include <QNetworkDiskCache>
+#include <QDir>
 #include <QSettings>
 #include <QTimer>
 
-#include "includes/scoped_ptr.h"
 #include "includes/shared_ptr.h"
 #include "constants/collectionsettings.h"
 #include "core/logging.h"
+#include "core/tracing.h"
 #include "core/standardpaths.h"
 #include "core/database.h"
+#include "core/sqlitereader.h"
 #include "core/iconloader.h"
 #include "core/settings.h"
+#include "core/taskmanager.h"
 #include "core/songmimedata.h"
+#include "core/memorybudget.h"
 #include "collectionfilteroptions.h"
 #include "collectionquery.h"
+#include "collectionsnapshot.h"
 #include "collectionbackend.h"
 #include "collectiondirectorymodel.h"
 #include "collectionitem.h"
@@ -72,6 +74,8 @@
 #include "covermanager/albumcoverloaderoptions.h"
 #include "covermanager/albumcoverloaderresult.h"
 #include "covermanager/albumcoverloader.h"
+#include "covermanager/covercache.h"
+#include "utilities/imageutils.h"
 
 using namespace std::chrono_literals;
 using namespace Qt::Literals::StringLiterals;
@@ -79,8 +83,19 @@ using namespace Qt::Literals::StringLiterals;
 const int CollectionModel::kPrettyCoverSize = 32;
 
 namespace {
+constexpr char kCoverCacheDir[] = "covercache";
+// Directory of the disk cache used before the cover cache.
 constexpr char kPixmapDiskCacheDir[] = "pixmapcache";
 constexpr char kVariousArtists[] = QT_TR_NOOP("Various artists");
+constexpr int kPregenerateIconsDelayMsec = 10000;
+constexpr int kPregenerateIconsInFlight = 8;
+// Dragging more songs than this sorts them when they are dropped instead of when the drag starts.
+constexpr qsizetype kLazyMimeDataSongs = 1000;
+
+bool CompareLazySongs(const Song &a, const Song &b) {
+  return a.album() == b.album() ? CollectionModel::SortTextForSong(a) < CollectionModel::SortTextForSong(b) : a.album() < b.album();
+}
+
 }  // namespace
 
 CollectionModel::CollectionModel(const SharedPtr<CollectionBackend> backend, const SharedPtr<AlbumCoverLoader> albumcover_loader, QObject *parent)
@@ -96,7 +111,12 @@ CollectionModel::CollectionModel(const SharedPtr<CollectionBackend> backend, con
       total_artist_count_(0),
       total_album_count_(0),
       loading_(false),
-      icon_disk_cache_(new QNetworkDiskCache(this)) {
+      load_all_items_(false),
+      cover_cache_(new CoverCache(StandardPaths::WritableLocation(StandardPaths::StandardLocation::CacheLocation) + u'/' + QLatin1String(kCoverCacheDir) + u'-' + Song::TextForSource(backend_->source()), QSize(kPrettyCoverSize, kPrettyCoverSize), this)),
+      timer_pregenerate_icons_(new QTimer(this)),
+      pregenerate_task_id_(-1),
+      pregenerate_total_(0),
+      pregenerate_done_(0) {
 
   setObjectName(backend_->source() == Song::Source::Collection ? QLatin1String(QObject::metaObject()->className()) : QStringLiteral("%1%2").arg(Song::DescriptionForSource(backend_->source()), QLatin1String(QObject::metaObject()->className())));
 
@@ -108,16 +128,22 @@ CollectionModel::CollectionModel(const SharedPtr<CollectionBackend> backend, con
     QObject::connect(&*albumcover_loader_, &AlbumCoverLoader::AlbumCoverLoaded, this, &CollectionModel::AlbumCoverLoaded);
   }
 
+  MemoryBudget::Instance()->Register(objectName() + u" icons"_s, this, [this]() { return cover_cache_->memory_cache_size(); }, [this](const qint64 bytes) { cover_cache_->TrimMemoryCache(bytes); });
+
   QIcon nocover = IconLoader::Load(u"cdcase"_s);
   if (!nocover.isNull()) {
     QList<QSize> nocover_sizes = nocover.availableSizes();
     pixmap_no_cover_ = nocover.pixmap(nocover_sizes.last()).scaled(kPrettyCoverSize, kPrettyCoverSize, Qt::KeepAspectRatio, Qt::SmoothTransformation);
   }
 
-  icon_disk_cache_->setCacheDirectory(StandardPaths::WritableLocation(StandardPaths::StandardLocation::CacheLocation) + u'/' + QLatin1String(kPixmapDiskCacheDir) + u'-' + Song::TextForSource(backend_->source()));
+  QDir pixmap_disk_cache_dir(StandardPaths::WritableLocation(StandardPaths::StandardLocation::CacheLocation) + u'/' + QLatin1String(kPixmapDiskCacheDir) + u'-' + Song::TextForSource(backend_->source()));
+  if (pixmap_disk_cache_dir.exists()) {
+    pixmap_disk_cache_dir.removeRecursively();
+  }
 
   QObject::connect(&*backend_, &CollectionBackend::SongsAdded, this, &CollectionModel::AddReAddOrUpdate);
   QObject::connect(&*backend_, &CollectionBackend::SongsChanged, this, &CollectionModel::AddReAddOrUpdate);
+  QObject::connect(&*backend_, &CollectionBackend::AlbumArtChanged, this, &CollectionModel::AlbumArtChanged);
   QObject::connect(&*backend_, &CollectionBackend::SongsDeleted, this, &CollectionModel::RemoveSongs);
   QObject::connect(&*backend_, &CollectionBackend::DatabaseReset, this, &CollectionModel::ScheduleReset);
   QObject::connect(&*backend_, &CollectionBackend::TotalSongCountUpdated, this, &CollectionModel::TotalSongCountUpdatedSlot);
@@ -134,6 +160,10 @@ CollectionModel::CollectionModel(const SharedPtr<CollectionBackend> backend, con
   timer_update_->setInterval(20ms);
   QObject::connect(timer_update_, &QTimer::timeout, this, &CollectionModel::ProcessUpdate);
 
+  timer_pregenerate_icons_->setSingleShot(true);
+  timer_pregenerate_icons_->setInterval(kPregenerateIconsDelayMsec);
+  QObject::connect(timer_pregenerate_icons_, &QTimer::timeout, this, &CollectionModel::StartAlbumIconPregeneration);
+
   ReloadSettings();
 
 }
@@ -163,12 +193,16 @@ void CollectionModel::Clear() {
     root_ = nullptr;
   }
   song_nodes_.clear();
+  lazy_songs_.clear();
+  lazy_song_containers_.clear();
   container_nodes_[0].clear();
   container_nodes_[1].clear();
   container_nodes_[2].clear();
   divider_nodes_.clear();
   pending_art_.clear();
   pending_cache_keys_.clear();
+  prefetch_ids_.clear();
+  StopAlbumIconPregeneration();
 
 }
 
@@ -189,6 +223,8 @@ void CollectionModel::EndReset() {
 
 void CollectionModel::ResetInternal() {
 
+  qTraceScope("CollectionModel::ResetInternal");
+
   loading_ = true;
 
   options_active_ = options_current_;
@@ -203,6 +239,51 @@ void CollectionModel::ResetInternal() {
 
 }
 
+void CollectionModel::RegroupInternal() {
+
+  if (!root_ || !LoadedSongsCoverFilterOptions(options_current_.filter_options)) {
+    ResetInternal();
+    return;
+  }
+
+  // Only the container hierarchy depends on the grouping, so rebuild the tree from the songs already in the model instead of reloading them from the database.
+  SongList songs;
+  songs.reserve(song_nodes_.count());
+  for (CollectionItem *item : std::as_const(song_nodes_)) {
+    songs << item->metadata;
+  }
+  for (const QMap<int, Song> &lazy_songs : std::as_const(lazy_songs_)) {
+    songs << lazy_songs.values();
+  }
+
+  options_active_ = options_current_;
+
+  BeginReset();
+  ScheduleAddSongs(songs);
+  EndReset();
+
+}
+
+bool CollectionModel::LoadedSongsCoverFilterOptions(const CollectionFilterOptions &filter_options) const {
+
+  const CollectionFilterOptions &active_filter_options = options_active_.filter_options;
+
+  if (filter_options.filter_mode() != active_filter_options.filter_mode() || filter_options.filter_text() != active_filter_options.filter_text()) {
+    return false;
+  }
+
+  // The loaded songs can be filtered further in memory, but songs excluded by the active filter are not loaded.
+  if (active_filter_options.max_age() != -1 && (filter_options.max_age() == -1 || filter_options.max_age() > active_filter_options.max_age())) {
+    return false;
+  }
+  if (active_filter_options.min_rating() >= 0.0F && filter_options.min_rating() < active_filter_options.min_rating()) {
+    return false;
+  }
+
+  return true;
+
+}
+
 void CollectionModel::ReloadSettings() {
 
   Settings settings;
@@ -213,12 +294,13 @@ void CollectionModel::ReloadSettings() {
   const bool sort_skip_articles_for_artists = settings.value(CollectionSettings::kSkipArticlesForArtists, true).toBool();
   const bool sort_skip_articles_for_albums = settings.value(CollectionSettings::kSkipArticlesForAlbums, false).toBool();
   const bool use_sort_tags = settings.value(CollectionSettings::kUseSortTags, true).toBool();
+  const bool lazy_loading = settings.value(CollectionSettings::kLazyLoading, false).toBool();
 
   use_disk_cache_ = settings.value(CollectionSettings::kSettingsDiskCacheEnable, false).toBool();
-  QPixmapCache::setCacheLimit(static_cast<int>(MaximumCacheSize(&settings, CollectionSettings::kSettingsCacheSize, CollectionSettings::kSettingsCacheSizeUnit, CollectionSettings::kSettingsCacheSizeDefault) / 1024));
-  if (icon_disk_cache_) {
-    icon_disk_cache_->setMaximumCacheSize(MaximumCacheSize(&settings, CollectionSettings::kSettingsDiskCacheSize, CollectionSettings::kSettingsDiskCacheSizeUnit, CollectionSettings::kSettingsDiskCacheSizeDefault));
-  }
+  cover_cache_->SetMemoryCacheSize(MaximumCacheSize(&settings, CollectionSettings::kSettingsCacheSize, CollectionSettings::kSettingsCacheSizeUnit, CollectionSettings::kSettingsCacheSizeDefault));
+  cover_cache_->SetDiskCacheFormat(static_cast<ImageUtils::ThumbnailFormat>(settings.value(CollectionSettings::kSettingsDiskCacheFormat, static_cast<int>(ImageUtils::ThumbnailFormat::Raw)).toInt()), settings.value(CollectionSettings::kSettingsDiskCacheQuality, CollectionSettings::kSettingsDiskCacheQualityDefault).toInt());
+  cover_cache_->SetDiskCacheSize(MaximumCacheSize(&settings, CollectionSettings::kSettingsDiskCacheSize, CollectionSettings::kSettingsDiskCacheSizeUnit, CollectionSettings::kSettingsDiskCacheSizeDefault));
+  cover_cache_->SetDiskCacheEnabled(use_disk_cache_);
 
   settings.endGroup();
 
@@ -229,20 +311,26 @@ void CollectionModel::ReloadSettings() {
       show_various_artists != options_current_.show_various_artists ||
       sort_skip_articles_for_artists != options_current_.sort_skip_articles_for_artists ||
       sort_skip_articles_for_albums != options_current_.sort_skip_articles_for_albums ||
-      use_sort_tags != options_current_.use_sort_tags) {
+      use_sort_tags != options_current_.use_sort_tags ||
+      lazy_loading != options_current_.lazy_loading) {
     options_current_.show_pretty_covers = show_pretty_covers;
     options_current_.show_dividers = show_dividers;
     options_current_.show_various_artists = show_various_artists;
     options_current_.sort_skip_articles_for_artists = sort_skip_articles_for_artists;
     options_current_.sort_skip_articles_for_albums = sort_skip_articles_for_albums;
     options_current_.use_sort_tags = use_sort_tags;
-    ScheduleReset();
+    options_current_.lazy_loading = lazy_loading;
+    ScheduleRegroup();
   }
 
   if (!use_disk_cache_) {
     ClearIconDiskCache();
   }
 
+  if (!use_disk_cache_ || !options_current_.show_pretty_covers) {
+    StopAlbumIconPregeneration();
+  }
+
 }
 
 void CollectionModel::SetGroupBy(const Grouping g, const std::optional<bool> separate_albums_by_grouping) {
@@ -252,7 +340,7 @@ void CollectionModel::SetGroupBy(const Grouping g, const std::optional<bool> sep
     options_current_.separate_albums_by_grouping = separate_albums_by_grouping.value();
   }
 
-  ScheduleReset();
+  ScheduleRegroup();
 
   Q_EMIT GroupingChanged(g, options_current_.separate_albums_by_grouping);
 
@@ -271,7 +359,7 @@ void CollectionModel::SetFilterMaxAge(const int filter_max_age) {
 
   if (options_current_.filter_options.max_age() != filter_max_age) {
     options_current_.filter_options.set_max_age(filter_max_age);
-    ScheduleReset();
+    ScheduleRegroup();
   }
 
 }
@@ -280,7 +368,7 @@ void CollectionModel::SetFilterMinRating(const float filter_min_rating) {
 
   if (options_current_.filter_options.min_rating() != filter_min_rating) {
     options_current_.filter_options.set_min_rating(filter_min_rating);
-    ScheduleReset();
+    ScheduleRegroup();
   }
 
 }
@@ -381,6 +469,49 @@ Qt::ItemFlags CollectionModel::flags(const QModelIndex &idx) const {
 
 }
 
+bool CollectionModel::hasChildren(const QModelIndex &parent) const {
+
+  return lazy_songs_.contains(IndexToItem(parent)) || SimpleTreeModel<CollectionItem>::hasChildren(parent);
+
+}
+
+bool CollectionModel::canFetchMore(const QModelIndex &parent) const {
+
+  return lazy_songs_.contains(IndexToItem(parent));
+
+}
+
+void CollectionModel::fetchMore(const QModelIndex &parent) {
+
+  FetchLazyItem(IndexToItem(parent));
+
+}
+
+void CollectionModel::FetchLazyItem(CollectionItem *item) {
+
+  if (!item || !lazy_songs_.contains(item)) return;
+
+  const QMap<int, Song> songs = lazy_songs_.take(item);
+  for (const Song &song : songs) {
+    lazy_song_containers_.remove(song.id());
+    AddSongInternal(song);
+  }
+
+}
+
+void CollectionModel::SetLoadAllItems(const bool load_all_items) {
+
+  load_all_items_ = load_all_items;
+
+  if (load_all_items_) {
+    const QList<CollectionItem*> items = lazy_songs_.keys();
+    for (CollectionItem *item : items) {
+      FetchLazyItem(item);
+    }
+  }
+
+}
+
 QStringList CollectionModel::mimeTypes() const {
   return QStringList() << u"text/uri-list"_s;
 }
@@ -389,19 +520,33 @@ QMimeData *CollectionModel::mimeData(const QModelIndexList &indexes) const {
 
   if (indexes.isEmpty()) return nullptr;
 
-  SongList songs;
-  QSet<int> song_ids;
-  QList<QUrl> urls;
+  QList<ChildSongs> child_songs;
   for (const QModelIndex &idx : indexes) {
-    GetChildSongs(IndexToItem(idx), songs, song_ids, urls);
+    GetChildSongs(IndexToItem(idx), child_songs);
+  }
+
+  SongList songs;
+  for (const ChildSongs &child : std::as_const(child_songs)) {
+    songs << child.songs;
   }
 
   SongMimeData *song_mime_data = new SongMimeData;
-  song_mime_data->setUrls(urls);
   song_mime_data->backend = backend_;
-  song_mime_data->songs = songs;
   song_mime_data->name_for_new_playlist_ = Song::GetNameForNewPlaylist(songs);
 
+  if (songs.count() > kLazyMimeDataSongs) {
+    song_mime_data->resolver = [child_songs, backend = backend_]() { return ResolveChildSongs(child_songs, backend); };
+  }
+  else {
+    song_mime_data->songs = ResolveChildSongs(child_songs, backend_);
+    QList<QUrl> urls;
+    urls.reserve(song_mime_data->songs.count());
+    for (const Song &song : std::as_const(song_mime_data->songs)) {
+      urls << song.url();
+    }
+    song_mime_data->setUrls(urls);
+  }
+
   return song_mime_data;
 
 }
@@ -412,6 +557,12 @@ void CollectionModel::AddReAddOrUpdate(const SongList &songs) {
 
 }
 
+void CollectionModel::AlbumArtChanged(const SongList &songs) {
+
+  ScheduleUpdate(CollectionModelUpdate::Type::UpdateArt, songs);
+
+}
+
 void CollectionModel::RemoveSongs(const SongList &songs) {
 
   ScheduleRemoveSongs(songs);
@@ -420,7 +571,7 @@ void CollectionModel::RemoveSongs(const SongList &songs) {
 
 void CollectionModel::ScheduleUpdate(const CollectionModelUpdate::Type type, const SongList &songs) {
 
-  if (type == CollectionModelUpdate::Type::Reset) {
+  if (type == CollectionModelUpdate::Type::Reset || type == CollectionModelUpdate::Type::Regroup) {
     updates_.enqueue(CollectionModelUpdate(type));
   }
   else {
@@ -445,6 +596,14 @@ void CollectionModel::ScheduleReset() {
 
 }
 
+void CollectionModel::ScheduleRegroup() {
+
+  if (!updates_.isEmpty() && (updates_.constFirst().type == CollectionModelUpdate::Type::Reset || updates_.constFirst().type == CollectionModelUpdate::Type::Regroup)) return;
+
+  ScheduleUpdate(CollectionModelUpdate::Type::Regroup);
+
+}
+
 void CollectionModel::ScheduleAddSongs(const SongList &songs) {
 
   ScheduleUpdate(CollectionModelUpdate::Type::Add, songs);
@@ -465,6 +624,8 @@ void CollectionModel::ScheduleRemoveSongs(const SongList &songs) {
 
 void CollectionModel::ProcessUpdate() {
 
+  qTraceScope("CollectionModel::ProcessUpdate");
+
   if (loading_ || updates_.isEmpty()) {
     timer_update_->stop();
     return;
@@ -474,12 +635,16 @@ void CollectionModel::ProcessUpdate() {
 
   if (updates_.isEmpty()) {
     timer_update_->stop();
+    ScheduleAlbumIconPregeneration();
   }
 
   switch (update.type) {
     case CollectionModelUpdate::Type::Reset:
       ResetInternal();
       break;
+    case CollectionModelUpdate::Type::Regroup:
+      RegroupInternal();
+      break;
     case CollectionModelUpdate::Type::AddReAddOrUpdate:
       AddReAddOrUpdateSongsInternal(update.songs);
       break;
@@ -489,6 +654,9 @@ void CollectionModel::ProcessUpdate() {
     case CollectionModelUpdate::Type::Update:
       UpdateSongsInternal(update.songs);
       break;
+    case CollectionModelUpdate::Type::UpdateArt:
+      UpdateSongsArtInternal(update.songs);
+      break;
     case CollectionModelUpdate::Type::Remove:
       RemoveSongsInternal(update.songs);
       break;
@@ -505,11 +673,17 @@ void CollectionModel::AddReAddOrUpdateSongsInternal(const SongList &songs) {
   SongList songs_updated;
 
   for (const Song &new_song : songs) {
-    if (!song_nodes_.contains(new_song.id())) {
+    Song old_song;
+    if (song_nodes_.contains(new_song.id())) {
+      old_song = song_nodes_.value(new_song.id())->metadata;
+    }
+    else if (lazy_song_containers_.contains(new_song.id())) {
+      old_song = lazy_songs_.value(lazy_song_containers_.value(new_song.id())).value(new_song.id());
+    }
+    else {
       songs_added << new_song;
       continue;
     }
-    const Song old_song = song_nodes_.value(new_song.id())->metadata;
     bool container_key_changed = false;
     bool has_unique_album_identifier_1 = false;
     bool has_unique_album_identifier_2 = false;
@@ -554,43 +728,66 @@ void CollectionModel::AddSongsInternal(const SongList &songs) {
     // Sanity check to make sure we don't add songs that are outside the user's filter
     if (!options_active_.filter_options.Matches(song)) continue;
 
-    if (song_nodes_.contains(song.id())) {
+    if (song_nodes_.contains(song.id()) || lazy_song_containers_.contains(song.id())) {
       qLog(Debug) << song.id() << song.title() << "already exists, skipping";
       continue;
     }
 
-    // Before we can add each song we need to make sure the required container items already exist in the tree.
-    // These depend on which "group by" settings the user has on the collection.
-    // Eg. if the user grouped by artist and album, we would need to make sure nodes for the song's artist and album were already in the tree.
+    AddSongInternal(song);
 
-    CollectionItem *container = root_;
-    QString container_key;
-    bool has_unique_album_identifier = false;
-    for (int i = 0; i < 3; ++i) {
-      const GroupBy group_by = options_active_.group_by[i];
-      if (group_by == GroupBy::None) break;
-      if (options_active_.show_various_artists && IsArtistGroupBy(group_by) && song.is_compilation()) {
-        has_unique_album_identifier = true;
-        if (container->compilation_artist_node_ == nullptr) {
-          CreateCompilationArtistNode(container);
-        }
-        container = container->compilation_artist_node_;
-        container_key = container->container_key;
+  }
+
+}
+
+void CollectionModel::AddSongInternal(const Song &song) {
+
+  // Before we can add each song we need to make sure the required container items already exist in the tree.
+  // These depend on which "group by" settings the user has on the collection.
+  // Eg. if the user grouped by artist and album, we would need to make sure nodes for the song's artist and album were already in the tree.
+
+  CollectionItem *container = root_;
+  QString container_key;
+  bool has_unique_album_identifier = false;
+  for (int i = 0; i < 3; ++i) {
+    const GroupBy group_by = options_active_.group_by[i];
+    if (group_by == GroupBy::None) break;
+    bool container_created = false;
+    if (options_active_.show_various_artists && IsArtistGroupBy(group_by) && song.is_compilation()) {
+      has_unique_album_identifier = true;
+      if (container->compilation_artist_node_ == nullptr) {
+        CreateCompilationArtistNode(container);
+        container_created = true;
+      }
+      container = container->compilation_artist_node_;
+      container_key = container->container_key;
+    }
+    else {
+      if (!container_key.isEmpty()) container_key.append(u'-');
+      container_key.append(ContainerKey(group_by, song, has_unique_album_identifier));
+      if (container_nodes_[i].contains(container_key)) {
+        container = container_nodes_[i][container_key];
       }
       else {
-        if (!container_key.isEmpty()) container_key.append(u'-');
-        container_key.append(ContainerKey(group_by, song, has_unique_album_identifier));
-        if (container_nodes_[i].contains(container_key)) {
-          container = container_nodes_[i][container_key];
-        }
-        else {
-          container = CreateContainerItem(group_by, i, container_key, song, container);
-        }
+        container = CreateContainerItem(group_by, i, container_key, song, container);
+        container_created = true;
+      }
+    }
+    if (i == 0) {
+      if (container_created && options_active_.lazy_loading && !load_all_items_) {
+        lazy_songs_.insert(container, QMap<int, Song>());
+      }
+      // Keep the song until the top level container is fetched.
+      const QHash<CollectionItem*, QMap<int, Song>>::iterator it = lazy_songs_.find(container);
+      if (it != lazy_songs_.end()) {
+        it.value().insert(song.id(), song);
+        lazy_song_containers_.insert(song.id(), container);
+        return;
       }
     }
-    CreateSongItem(song, container);
   }
 
+  CreateSongItem(song, container);
+
 }
 
 void CollectionModel::UpdateSongsInternal(const SongList &songs) {
@@ -600,6 +797,10 @@ void CollectionModel::UpdateSongsInternal(const SongList &songs) {
   QList<CollectionItem*> album_parents;
 
   for (const Song &new_song : songs) {
+    if (lazy_song_containers_.contains(new_song.id())) {
+      lazy_songs_[lazy_song_containers_.value(new_song.id())].insert(new_song.id(), new_song);
+      continue;
+    }
     if (!song_nodes_.contains(new_song.id())) {
       qLog(Error) << "Song does not exist in model" << new_song.id() << new_song.PrettyTitleWithArtist();
       continue;
@@ -637,6 +838,44 @@ void CollectionModel::UpdateSongsInternal(const SongList &songs) {
 
 }
 
+void CollectionModel::UpdateSongsArtInternal(const SongList &songs) {
+
+  if (loading_) return;
+
+  // Only the art changed, so the songs stay where they are and only the album icons need to be reloaded.
+  QSet<CollectionItem*> album_parents;
+  for (const Song &new_song : songs) {
+    CollectionItem *item = nullptr;
+    if (lazy_song_containers_.contains(new_song.id())) {
+      item = lazy_song_containers_.value(new_song.id());
+      QMap<int, Song> &container_songs = lazy_songs_[item];
+      if (container_songs.contains(new_song.id())) {
+        container_songs[new_song.id()].MergeArt(new_song);
+      }
+    }
+    else if (song_nodes_.contains(new_song.id())) {
+      CollectionItem *song_item = song_nodes_.value(new_song.id());
+      if (song_item->metadata.IsArtEqual(new_song)) continue;
+      song_item->metadata.MergeArt(new_song);
+      item = song_item->parent;
+    }
+    for (; item && item != root_; item = item->parent) {
+      if (IsAlbumGroupBy(options_active_.group_by[item->container_level])) {
+        album_parents << item;
+      }
+    }
+  }
+
+  for (CollectionItem *item : std::as_const(album_parents)) {
+    ClearItemPixmapCache(item);
+    const QModelIndex idx = ItemToIndex(item);
+    if (idx.isValid()) {
+      Q_EMIT dataChanged(idx, idx);
+    }
+  }
+
+}
+
 void CollectionModel::RemoveSongsInternal(const SongList &songs) {
 
   if (loading_) return;
@@ -645,6 +884,13 @@ void CollectionModel::RemoveSongsInternal(const SongList &songs) {
   QSet<CollectionItem*> parents;
   for (const Song &song : songs) {
 
+    if (lazy_song_containers_.contains(song.id())) {
+      CollectionItem *container = lazy_song_containers_.take(song.id());
+      lazy_songs_[container].remove(song.id());
+      parents << container;
+      continue;
+    }
+
     if (song_nodes_.contains(song.id())) {
       CollectionItem *node = song_nodes_.value(song.id());
 
@@ -666,7 +912,8 @@ void CollectionModel::RemoveSongsInternal(const SongList &songs) {
     QSet<CollectionItem*> parents_copy = parents;
     for (CollectionItem *node : parents_copy) {
       parents.remove(node);
-      if (node->children.count() != 0) continue;
+      if (node->children.count() != 0 || !lazy_songs_.value(node).isEmpty()) continue;
+      lazy_songs_.remove(node);
 
       // Consider its parent for the next round
       if (node->parent != root_) parents << node->parent;
@@ -774,6 +1021,7 @@ void CollectionModel::SetSongItemData(CollectionItem *item, const Song &song) co
 
   item->display_text = song.TitleWithCompilationArtist();
   item->sort_text = HasParentAlbumGroupBy(item->parent) ? SortTextForSong(song) : SortText(song.title());
+  item->sort_key.reset();
   item->metadata = song;
 
 }
@@ -809,25 +1057,70 @@ void CollectionModel::LoadSongsFromSqlAsync() {
 
 SongList CollectionModel::LoadSongsFromSql(const CollectionFilterOptions &filter_options) {
 
+  qTraceScope("CollectionModel::LoadSongsFromSql");
+
   SongList songs;
+  const bool use_snapshot = CollectionSnapshot::CanUse(backend_->songs_table(), filter_options);
+  qint64 change_counter = -1;
+  bool from_snapshot = false;
 
   {
+    QMutexLocker l(backend_->db()->Mutex());
+    QSqlDatabase db(backend_->db()->Connect());
+    if (use_snapshot) {
+      change_counter = CollectionSnapshot::ChangeCounter(db, backend_->songs_table());
+      std::optional<SongList> snapshot_songs = CollectionSnapshot::Read(backend_->songs_table(), filter_options, change_counter);
+      if (snapshot_songs) {
+        songs = *snapshot_songs;
+        from_snapshot = true;
+      }
+    }
+  }
+
+  if (!from_snapshot) {
     QMutexLocker l(backend_->db()->Mutex());
     QSqlDatabase db(backend_->db()->Connect());
     CollectionQuery q(db, backend_->songs_table(), filter_options);
-    q.SetColumnSpec(u"%songs_table.ROWID, "_s + Song::kColumnSpec);
-    if (q.Exec()) {
-      while (q.Next()) {
+    // The detail columns aren't needed to build the tree, they are loaded with CollectionBackend::GetCompleteSongs() when the songs are used.
+    q.SetSongColumns(Song::kDetailColumns);
+    // Read the rows directly from the database file when possible, the reader shares the repeated strings.
+    SqliteReader reader(db.databaseName());
+    bool loaded = false;
+    if (reader.Prepare(q.GetQuery(), q.bound_values())) {
+      while (reader.Next()) {
         Song song;
-        song.InitFromQuery(q, true);
+        song.InitFromSqliteReader(&reader, true);
+        song.set_incomplete(true);
         songs << song;
       }
+      loaded = reader.error().isEmpty();
+      if (!loaded) songs.clear();
     }
-    else {
-      backend_->ReportErrors(q);
+    if (!loaded) {
+      if (q.Exec()) {
+        // Songs on the same album share most of their strings, keep only one copy of each while the model holds the songs.
+        QSet<QString> strings;
+        QSet<QUrl> urls;
+        while (q.Next()) {
+          Song song;
+          song.InitFromQuery(q, true);
+          song.set_incomplete(true);
+          song.ShareStrings(strings, urls);
+          songs << song;
+        }
+      }
+      else {
+        backend_->ReportErrors(q);
+        // Don't write a snapshot of a failed load.
+        change_counter = -1;
+      }
     }
   }
 
+  if (use_snapshot && !from_snapshot) {
+    CollectionSnapshot::Write(backend_->songs_table(), filter_options, change_counter, songs);
+  }
+
   if (QThread::currentThread() != thread() && QThread::currentThread() != backend_->thread()) {
     backend_->db()->Close();
   }
@@ -838,6 +1131,8 @@ SongList CollectionModel::LoadSongsFromSql(const CollectionFilterOptions &filter
 
 void CollectionModel::LoadSongsFromSqlAsyncFinished() {
 
+  qTraceScope("CollectionModel::LoadSongsFromSqlAsyncFinished");
+
   QFutureWatcher<SongList> *watcher = static_cast<QFutureWatcher<SongList>*>(sender());
   const SongList songs = watcher->result();
   watcher->deleteLater();
@@ -852,6 +1147,8 @@ void CollectionModel::LoadSongsFromSqlAsyncFinished() {
     timer_update_->start();
   }
 
+  ScheduleAlbumIconPregeneration();
+
 }
 
 QString CollectionModel::AlbumIconPixmapCacheKey(const CollectionItem *item) const {
@@ -860,18 +1157,11 @@ QString CollectionModel::AlbumIconPixmapCacheKey(const CollectionItem *item) con
 
 }
 
-QUrl CollectionModel::AlbumIconPixmapDiskCacheKey(const QString &cache_key) {
-
-  return QUrl(QString::fromLatin1(QUrl::toPercentEncoding(cache_key)));
-
-}
-
 void CollectionModel::ClearItemPixmapCache(CollectionItem *item) {
 
   // Remove from pixmap cache
   const QString cache_key = AlbumIconPixmapCacheKey(item);
-  QPixmapCache::remove(cache_key);
-  if (use_disk_cache_ && icon_disk_cache_) icon_disk_cache_->remove(AlbumIconPixmapDiskCacheKey(cache_key));
+  cover_cache_->Remove(cache_key);
   if (pending_cache_keys_.contains(cache_key)) {
     pending_cache_keys_.remove(cache_key);
   }
@@ -896,44 +1186,185 @@ QVariant CollectionModel::AlbumIcon(CollectionItem *item) {
   const QString cache_key = AlbumIconPixmapCacheKey(item);
 
   QPixmap cached_pixmap;
-  if (QPixmapCache::find(cache_key, &cached_pixmap)) {
+  if (cover_cache_->Find(cache_key, QSize(kPrettyCoverSize, kPrettyCoverSize), &cached_pixmap)) {
     return cached_pixmap;
   }
 
-  // Try to load it from the disk cache
-  if (use_disk_cache_ && icon_disk_cache_) {
-    ScopedPtr<QIODevice> disk_cache_img(icon_disk_cache_->data(AlbumIconPixmapDiskCacheKey(cache_key)));
-    if (disk_cache_img) {
-      QImage cached_image;
-      if (cached_image.load(&*disk_cache_img, "XPM")) {
-        QPixmapCache::insert(cache_key, QPixmap::fromImage(cached_image));
-        return QPixmap::fromImage(cached_image);
-      }
-    }
-  }
-
   // Maybe we're loading a pixmap already?
-  if (pending_cache_keys_.contains(cache_key)) {
+  // If it's only loaded in the background or prefetched, request it again so the album cover loader moves it up.
+  if (pending_cache_keys_.contains(cache_key) && !pregenerate_cache_keys_.remove(cache_key) && prefetch_ids_.remove(cache_key) == 0) {
     return pixmap_no_cover_;
   }
 
   // No art is cached and we're not loading it already.  Load art for the first song in the album.
+  LoadAlbumIconAsync(item, cache_key, AlbumCoverLoaderOptions::Priority::Collection);
+
+  return pixmap_no_cover_;
+
+}
+
+quint64 CollectionModel::LoadAlbumIconAsync(CollectionItem *item, const QString &cache_key, const AlbumCoverLoaderOptions::Priority priority) {
+
   const SongList songs = GetChildSongs(item);
-  if (!songs.isEmpty()) {
-    AlbumCoverLoaderOptions cover_loader_options(AlbumCoverLoaderOptions::Option::ScaledImage | AlbumCoverLoaderOptions::Option::PadScaledImage);
-    cover_loader_options.desired_scaled_size = QSize(kPrettyCoverSize, kPrettyCoverSize);
-    cover_loader_options.types = cover_types_;
-    const quint64 id = albumcover_loader_->LoadImageAsync(cover_loader_options, songs.first());
-    pending_art_[id] = ItemAndCacheKey(item, cache_key);
-    pending_cache_keys_.insert(cache_key);
+  if (songs.isEmpty()) return 0;
+
+  AlbumCoverLoaderOptions cover_loader_options(AlbumCoverLoaderOptions::Option::ScaledImage | AlbumCoverLoaderOptions::Option::PadScaledImage);
+  cover_loader_options.desired_scaled_size = QSize(kPrettyCoverSize, kPrettyCoverSize);
+  cover_loader_options.types = cover_types_;
+  cover_loader_options.priority = priority;
+  const quint64 id = albumcover_loader_->LoadImageAsync(cover_loader_options, songs.first());
+  pending_art_[id] = ItemAndCacheKey(item, cache_key);
+  pending_cache_keys_.insert(cache_key);
+
+  return id;
+
+}
+
+void CollectionModel::EnableAlbumIconPregeneration(const SharedPtr<TaskManager> task_manager) {
+
+  task_manager_ = task_manager;
+  ScheduleAlbumIconPregeneration();
+
+}
+
+void CollectionModel::PrefetchAlbumIcons(const QModelIndexList &indexes) {
+
+  if (!albumcover_loader_ || !options_active_.show_pretty_covers) return;
+
+  QMap<QString, quint64> prefetch_ids;
+  for (const QModelIndex &idx : indexes) {
+    CollectionItem *item = IndexToItem(idx);
+    if (!item || item->type != CollectionItem::Type::Container || item->container_level < 0 || item->container_level > 2 || !IsAlbumGroupBy(options_active_.group_by[item->container_level])) continue;
+    const QString cache_key = AlbumIconPixmapCacheKey(item);
+    if (prefetch_ids_.contains(cache_key)) {
+      prefetch_ids.insert(cache_key, prefetch_ids_.take(cache_key));
+      continue;
+    }
+    if (pending_cache_keys_.contains(cache_key) || cover_cache_->Contains(cache_key, QSize(kPrettyCoverSize, kPrettyCoverSize))) continue;
+    const quint64 id = LoadAlbumIconAsync(item, cache_key, AlbumCoverLoaderOptions::Priority::Viewport);
+    if (id != 0) prefetch_ids.insert(cache_key, id);
   }
 
-  return pixmap_no_cover_;
+  // What is left are albums that scrolled away before their icon was loaded.
+  if (!prefetch_ids_.isEmpty()) {
+    QSet<quint64> cancel_ids;
+    for (QMap<QString, quint64>::const_iterator it = prefetch_ids_.constBegin(); it != prefetch_ids_.constEnd(); ++it) {
+      cancel_ids.insert(it.value());
+      pending_art_.remove(it.value());
+      if (!pregenerate_cache_keys_.contains(it.key())) {
+        pending_cache_keys_.remove(it.key());
+      }
+    }
+    albumcover_loader_->CancelTasks(cancel_ids);
+  }
+
+  prefetch_ids_ = prefetch_ids;
+
+}
+
+void CollectionModel::ScheduleAlbumIconPregeneration() {
+
+  if (task_manager_ && albumcover_loader_ && use_disk_cache_ && options_active_.show_pretty_covers) {
+    timer_pregenerate_icons_->start();
+  }
+
+}
+
+void CollectionModel::StartAlbumIconPregeneration() {
+
+  if (!task_manager_ || !albumcover_loader_ || loading_ || !use_disk_cache_ || !options_active_.show_pretty_covers) return;
+
+  // Only albums that are not cached, so after the first time only albums with changed art are loaded again.
+  for (int level = 0; level < 3; ++level) {
+    if (!IsAlbumGroupBy(options_active_.group_by[level])) continue;
+    for (CollectionItem *item : std::as_const(container_nodes_[level])) {
+      const QString cache_key = AlbumIconPixmapCacheKey(item);
+      if (pending_cache_keys_.contains(cache_key) || pregenerate_cache_keys_.contains(cache_key) || cover_cache_->Contains(cache_key, QSize(kPrettyCoverSize, kPrettyCoverSize))) {
+        continue;
+      }
+      pregenerate_queue_.enqueue(qMakePair(level, item->container_key));
+      pregenerate_cache_keys_.insert(cache_key);
+      ++pregenerate_total_;
+    }
+  }
+
+  if (pregenerate_queue_.isEmpty()) return;
+
+  qLog(Debug) << "Generating" << pregenerate_queue_.count() << "album icons";
+
+  if (pregenerate_task_id_ == -1) {
+    pregenerate_task_id_ = task_manager_->StartTask(tr("Generating album covers"));
+  }
+
+  PregenerateNextAlbumIcons();
+
+}
+
+void CollectionModel::PregenerateNextAlbumIcons() {
+
+  if (pregenerate_task_id_ == -1) return;
+
+  while (pregenerate_ids_.count() < kPregenerateIconsInFlight && !pregenerate_queue_.isEmpty()) {
+    const QPair<int, QString> level_and_key = pregenerate_queue_.dequeue();
+    CollectionItem *item = container_nodes_[level_and_key.first].value(level_and_key.second);
+    const QString cache_key = item ? AlbumIconPixmapCacheKey(item) : QString();
+    // Skip albums that were removed or have been requested for display in the meantime.
+    if (!item || !pregenerate_cache_keys_.contains(cache_key) || pending_cache_keys_.contains(cache_key)) {
+      pregenerate_cache_keys_.remove(cache_key);
+      ++pregenerate_done_;
+      continue;
+    }
+    const quint64 id = LoadAlbumIconAsync(item, cache_key, AlbumCoverLoaderOptions::Priority::Prefetch);
+    if (id == 0) {
+      pregenerate_cache_keys_.remove(cache_key);
+      ++pregenerate_done_;
+      continue;
+    }
+    pregenerate_ids_.insert(id);
+  }
+
+  if (pregenerate_queue_.isEmpty() && pregenerate_ids_.isEmpty()) {
+    StopAlbumIconPregeneration();
+    return;
+  }
+
+  task_manager_->SetTaskProgress(pregenerate_task_id_, static_cast<quint64>(pregenerate_done_), static_cast<quint64>(pregenerate_total_));
+
+}
+
+void CollectionModel::StopAlbumIconPregeneration() {
+
+  timer_pregenerate_icons_->stop();
+
+  if (!pregenerate_ids_.isEmpty() && albumcover_loader_) {
+    albumcover_loader_->CancelTasks(pregenerate_ids_);
+    for (const quint64 id : std::as_const(pregenerate_ids_)) {
+      if (pending_art_.contains(id)) {
+        pending_cache_keys_.remove(pending_art_.take(id).second);
+      }
+    }
+  }
+
+  pregenerate_queue_.clear();
+  pregenerate_ids_.clear();
+  pregenerate_cache_keys_.clear();
+  pregenerate_total_ = 0;
+  pregenerate_done_ = 0;
+
+  if (pregenerate_task_id_ != -1) {
+    task_manager_->SetTaskFinished(pregenerate_task_id_);
+    pregenerate_task_id_ = -1;
+  }
 
 }
 
 void CollectionModel::AlbumCoverLoaded(const quint64 id, const AlbumCoverLoaderResult &result) {
 
+  if (pregenerate_ids_.remove(id)) {
+    ++pregenerate_done_;
+    QMetaObject::invokeMethod(this, &CollectionModel::PregenerateNextAlbumIcons, Qt::QueuedConnection);
+  }
+
   if (!pending_art_.contains(id)) return;
 
   ItemAndCacheKey item_and_cache_key = pending_art_.take(id);
@@ -943,34 +1374,17 @@ void CollectionModel::AlbumCoverLoaded(const quint64 id, const AlbumCoverLoaderR
   const QString &cache_key = item_and_cache_key.second;
 
   pending_cache_keys_.remove(cache_key);
+  pregenerate_cache_keys_.remove(cache_key);
+  if (prefetch_ids_.value(cache_key) == id) prefetch_ids_.remove(cache_key);
 
   // Insert this image in the cache.
   if (!result.success || result.image_scaled.isNull() || result.type == AlbumCoverLoaderResult::Type::Unset) {
     // Set the no_cover image so we don't continually try to load art.
-    QPixmapCache::insert(cache_key, pixmap_no_cover_);
+    cover_cache_->Insert(cache_key, QSize(kPrettyCoverSize, kPrettyCoverSize), pixmap_no_cover_);
   }
   else {
-    QPixmap image_pixmap;
-    image_pixmap = QPixmap::fromImage(result.image_scaled);
-    QPixmapCache::insert(cache_key, image_pixmap);
-  }
-
-  // If we have a valid cover not already in the disk cache
-  if (use_disk_cache_ && icon_disk_cache_ && result.success && !result.image_scaled.isNull()) {
-    const QUrl disk_cache_key = AlbumIconPixmapDiskCacheKey(cache_key);
-    ScopedPtr<QIODevice> disk_cache_img(icon_disk_cache_->data(disk_cache_key));
-    if (!disk_cache_img) {
-      QNetworkCacheMetaData disk_cache_metadata;
-      disk_cache_metadata.setSaveToDisk(true);
-      disk_cache_metadata.setUrl(disk_cache_key);
-      // Qt 6 now ignores any entry without headers, so add a fake header.
-      disk_cache_metadata.setRawHeaders(QNetworkCacheMetaData::RawHeaderList() << qMakePair(QByteArray("collection-thumbnail"), cache_key.toUtf8()));
-      QIODevice *device_iconcache = icon_disk_cache_->prepare(disk_cache_metadata);
-      if (device_iconcache) {
-        result.image_scaled.save(device_iconcache, "XPM");
-        icon_disk_cache_->insert(device_iconcache);
-      }
-    }
+    // Also stored in the disk cache if enabled.
+    cover_cache_->Store(cache_key, QSize(kPrettyCoverSize, kPrettyCoverSize), result.image_scaled);
   }
 
   const QModelIndex idx = ItemToIndex(item);
@@ -1418,15 +1832,7 @@ QString CollectionModel::DividerDisplayText(const GroupBy group_by, const QStrin
 
 bool CollectionModel::CompareItems(CollectionItem *a, CollectionItem *b) const {
 
-  QVariant left = data(a, CollectionModel::Role_SortText);
-  QVariant right = data(b, CollectionModel::Role_SortText);
-
-  if (left.metaType().id() == QMetaType::Int) {
-    return left.toInt() < right.toInt();
-  }
-  else {
-    return left.toString() < right.toString();
-  }
+  return a->sort_text < b->sort_text;
 
 }
 
@@ -1466,6 +1872,17 @@ void CollectionModel::GetChildSongs(CollectionItem *item, SongList &songs, QSet<
       for (CollectionItem *child : children) {
         GetChildSongs(child, songs, song_ids, urls);
       }
+      if (lazy_songs_.contains(item)) {
+        SongList lazy_songs = lazy_songs_.value(item).values();
+        std::sort(lazy_songs.begin(), lazy_songs.end(), CompareLazySongs);
+        for (const Song &song : std::as_const(lazy_songs)) {
+          urls << song.url();
+          if (!song_ids.contains(song.id())) {
+            songs << song;
+            song_ids << song.id();
+          }
+        }
+      }
       break;
     }
 
@@ -1483,6 +1900,61 @@ void CollectionModel::GetChildSongs(CollectionItem *item, SongList &songs, QSet<
 
 }
 
+void CollectionModel::GetChildSongs(CollectionItem *item, QList<ChildSongs> &child_songs) const {
+
+  switch (item->type) {
+    case CollectionItem::Type::Container: {
+      QList<CollectionItem*> children = item->children;
+      std::sort(children.begin(), children.end(), std::bind(&CollectionModel::CompareItems, this, std::placeholders::_1, std::placeholders::_2));
+      for (CollectionItem *child : std::as_const(children)) {
+        GetChildSongs(child, child_songs);
+      }
+      if (lazy_songs_.contains(item)) {
+        child_songs << ChildSongs { lazy_songs_.value(item).values(), true };
+      }
+      break;
+    }
+
+    case CollectionItem::Type::Song:
+      if (child_songs.isEmpty() || child_songs.last().sort) {
+        child_songs << ChildSongs { SongList(), false };
+      }
+      child_songs.last().songs << item->metadata;
+      break;
+
+    default:
+      break;
+  }
+
+}
+
+SongList CollectionModel::ResolveChildSongs(QList<ChildSongs> child_songs, SharedPtr<CollectionBackend> backend) {
+
+  qsizetype count = 0;
+  for (const ChildSongs &child : std::as_const(child_songs)) {
+    count += child.songs.count();
+  }
+
+  SongList songs;
+  songs.reserve(count);
+  QSet<int> song_ids;
+  song_ids.reserve(count);
+  for (ChildSongs &child : child_songs) {
+    if (child.sort) {
+      std::sort(child.songs.begin(), child.songs.end(), CompareLazySongs);
+    }
+    for (const Song &song : std::as_const(child.songs)) {
+      if (!song_ids.contains(song.id())) {
+        songs << song;
+        song_ids << song.id();
+      }
+    }
+  }
+
+  return backend->GetCompleteSongs(songs);
+
+}
+
 SongList CollectionModel::GetChildSongs(const QList<CollectionItem*> items) const {
 
   SongList songs;
@@ -1565,10 +2037,15 @@ void CollectionModel::TotalAlbumCountUpdatedSlot(const int count) {
 
 }
 
+quint64 CollectionModel::icon_disk_cache_size() const {
+
+  return static_cast<quint64>(cover_cache_->disk_cache_size());
+
+}
+
 void CollectionModel::ClearIconDiskCache() {
 
-  if (icon_disk_cache_) icon_disk_cache_->clear();
-  QPixmapCache::clear();
+  cover_cache_->Clear();
 
 }
 
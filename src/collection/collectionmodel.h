@@ -34,6 +34,7 @@
 #include <QSet>
 #include <QList>
 #include <QMap>
+#include <QHash>
 #include <QVariant>
 #include <QString>
 #include <QStringList>
@@ -41,7 +42,6 @@
 #include <QImage>
 #include <QIcon>
 #include <QPixmap>
-#include <QNetworkDiskCache>
 #include <QQueue>
 
 #include "includes/shared_ptr.h"
@@ -56,7 +56,9 @@
 class QTimer;
 class Settings;
 
+class TaskManager;
 class CollectionBackend;
+class CoverCache;
 class CollectionDirectoryModel;
 class CollectionFilter;
 class AlbumCoverLoader;
@@ -132,7 +134,8 @@ class CollectionModel : public SimpleTreeModel<CollectionItem> {
                 sort_skip_articles_for_artists(false),
                 sort_skip_articles_for_albums(false),
                 use_sort_tags(true),
-                separate_albums_by_grouping(false) {}
+                separate_albums_by_grouping(false),
+                lazy_loading(false) {}
 
     Grouping group_by;
     bool show_dividers;
@@ -142,6 +145,7 @@ class CollectionModel : public SimpleTreeModel<CollectionItem> {
     bool sort_skip_articles_for_albums;
     bool use_sort_tags;
     bool separate_albums_by_grouping;
+    bool lazy_loading;
     CollectionFilterOptions filter_options;
   };
 
@@ -153,13 +157,21 @@ class CollectionModel : public SimpleTreeModel<CollectionItem> {
 
   void ReloadSettings();
 
+  // Load the icons of all albums in the background after the model is loaded or updated, so they are in the disk cache before they are shown.
+  void EnableAlbumIconPregeneration(const SharedPtr<TaskManager> task_manager);
+
+  // Load the icons of albums that are about to be scrolled into view, requests from the previous call for albums not in the list are cancelled.
+  void PrefetchAlbumIcons(const QModelIndexList &indexes);
+
   CollectionDirectoryModel *directory_model() const { return dir_model_; }
 
   int total_song_count() const { return total_song_count_; }
   int total_artist_count() const { return total_artist_count_; }
   int total_album_count() const { return total_album_count_; }
 
-  quint64 icon_disk_cache_size() { return static_cast<quint64>(icon_disk_cache_->cacheSize()); }
+  quint64 icon_disk_cache_size() const;
+  CoverCache *icon_cache() const { return cover_cache_; }
+  qsizetype loaded_song_count() const { return song_nodes_.count(); }
 
   const CollectionModel::Grouping GetGroupBy() const { return options_current_.group_by; }
   void SetGroupBy(const CollectionModel::Grouping g, const std::optional<bool> separate_albums_by_grouping = std::optional<bool>());
@@ -171,11 +183,19 @@ class CollectionModel : public SimpleTreeModel<CollectionItem> {
 
   QMap<QString, CollectionItem*> container_nodes(const int i) { return container_nodes_[i]; }
   QList<CollectionItem*> song_nodes() const { return song_nodes_.values(); }
+
+  // In lazy loading mode, the children of top level containers are only created when they are fetched.
+  // Searching needs all the song nodes, so the filter makes the model load everything while a filter is set.
+  void SetLoadAllItems(const bool load_all_items);
+  void FetchLazyItem(CollectionItem *item);
   int divider_nodes_count() const { return divider_nodes_.count(); }
 
   // QAbstractItemModel
   QVariant data(const QModelIndex &idx, const int role = Qt::DisplayRole) const override;
   Qt::ItemFlags flags(const QModelIndex &idx) const override;
+  bool hasChildren(const QModelIndex &parent) const override;
+  bool canFetchMore(const QModelIndex &parent) const override;
+  void fetchMore(const QModelIndex &parent) override;
   QStringList mimeTypes() const override;
   QMimeData *mimeData(const QModelIndexList &indexes) const override;
 
@@ -200,6 +220,14 @@ class CollectionModel : public SimpleTreeModel<CollectionItem> {
 
   // Get information about the collection
   void GetChildSongs(CollectionItem *item, SongList &songs, QSet<int> &song_ids, QList<QUrl> &urls) const;
+  // The songs of an item, in the order they are listed.
+  // Leaves sorting the songs of containers that aren't loaded yet, removing the duplicates and loading the detail columns to ResolveChildSongs(), which can run on a worker thread.
+  struct ChildSongs {
+    SongList songs;
+    bool sort;
+  };
+  void GetChildSongs(CollectionItem *item, QList<ChildSongs> &child_songs) const;
+  static SongList ResolveChildSongs(QList<ChildSongs> child_songs, SharedPtr<CollectionBackend> backend);
   SongList GetChildSongs(const QList<CollectionItem*> items) const;
   SongList GetChildSongs(CollectionItem *item) const;
   SongList GetChildSongs(const QModelIndex &idx) const;
@@ -223,6 +251,7 @@ class CollectionModel : public SimpleTreeModel<CollectionItem> {
   void SetFilterMinRating(const float filter_min_rating);
 
   void AddReAddOrUpdate(const SongList &songs);
+  void AlbumArtChanged(const SongList &songs);
   void RemoveSongs(const SongList &songs);
 
   void ClearIconDiskCache();
@@ -241,7 +270,9 @@ class CollectionModel : public SimpleTreeModel<CollectionItem> {
 
   void AddReAddOrUpdateSongsInternal(const SongList &songs);
   void AddSongsInternal(const SongList &songs);
+  void AddSongInternal(const Song &song);
   void UpdateSongsInternal(const SongList &songs);
+  void UpdateSongsArtInternal(const SongList &songs);
   void RemoveSongsInternal(const SongList &songs);
 
   void CreateDividerItem(const QString &divider_key, const QString &display_text, CollectionItem *parent);
@@ -259,17 +290,24 @@ class CollectionModel : public SimpleTreeModel<CollectionItem> {
   // Helpers
   static bool IsCompilationArtistNode(const CollectionItem *node) { return node == node->parent->compilation_artist_node_; }
   QString AlbumIconPixmapCacheKey(const CollectionItem *item) const;
-  static QUrl AlbumIconPixmapDiskCacheKey(const QString &cache_key);
   QVariant AlbumIcon(CollectionItem *item);
+  quint64 LoadAlbumIconAsync(CollectionItem *item, const QString &cache_key, const AlbumCoverLoaderOptions::Priority priority);
   void ClearItemPixmapCache(CollectionItem *item);
+  void ScheduleAlbumIconPregeneration();
+  void StopAlbumIconPregeneration();
   static qint64 MaximumCacheSize(Settings *s, const char *size_id, const char *size_unit_id, const qint64 cache_size_default);
+  bool LoadedSongsCoverFilterOptions(const CollectionFilterOptions &filter_options) const;
 
  private Q_SLOTS:
   void ResetInternal();
+  void RegroupInternal();
   void ScheduleReset();
+  void ScheduleRegroup();
   void ProcessUpdate();
   void LoadSongsFromSqlAsyncFinished();
   void AlbumCoverLoaded(const quint64 id, const AlbumCoverLoaderResult &result);
+  void StartAlbumIconPregeneration();
+  void PregenerateNextAlbumIcons();
 
   // From CollectionBackend
   void TotalSongCountUpdatedSlot(const int count);
@@ -306,6 +344,11 @@ class CollectionModel : public SimpleTreeModel<CollectionItem> {
   // Keyed on database ID
   QMap<int, CollectionItem*> song_nodes_;
 
+  // Songs of top level containers whose children haven't been created yet, with the container for each song ID.
+  QHash<CollectionItem*, QMap<int, Song>> lazy_songs_;
+  QMap<int, CollectionItem*> lazy_song_containers_;
+  bool load_all_items_;
+
   // Keyed on whatever the key is for that level - artist, album, year, etc.
   QMap<QString, CollectionItem*> container_nodes_[3];
 
@@ -316,7 +359,19 @@ class CollectionModel : public SimpleTreeModel<CollectionItem> {
   QMap<quint64, ItemAndCacheKey> pending_art_;
   QSet<QString> pending_cache_keys_;
 
-  QNetworkDiskCache *icon_disk_cache_;
+  CoverCache *cover_cache_;
+
+  SharedPtr<TaskManager> task_manager_;
+  QTimer *timer_pregenerate_icons_;
+  // Level and container key of the albums still to load.
+  QQueue<QPair<int, QString>> pregenerate_queue_;
+  QSet<quint64> pregenerate_ids_;
+  QSet<QString> pregenerate_cache_keys_;
+  // Cache key and loader ID of the icons requested for albums about to be shown.
+  QMap<QString, quint64> prefetch_ids_;
+  int pregenerate_task_id_;
+  int pregenerate_total_;
+  int pregenerate_done_;
 };
 
 Q_DECLARE_METATYPE(CollectionModel::Grouping)
@@ -26,9 +26,11 @@ class CollectionModelUpdate {
  public:
   enum class Type {
     Reset,
+    Regroup,
     AddReAddOrUpdate,
     Add,
     Update,
+    UpdateArt,
     Remove,
   };
   explicit CollectionModelUpdate(const Type _type, const SongList &_songs = SongList());
@@ -38,6 +38,7 @@ class CollectionPlaylistItem : public PlaylistItem {
 
   Song OriginalMetadata() const override { return song_; }
   void SetOriginalMetadata(const Song &song) override { song_ = song; }
+  void ShareStrings(QSet<QString> &strings, QSet<QUrl> &urls) override { song_.ShareStrings(strings, urls); }
 
   QUrl OriginalUrl() const override { return song_.url(); }
   bool IsLocalCollectionItem() const override { return song_.source() == Song::Source::Collection; }
@@ -0,0 +1,46 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef COLLECTIONPLAYSTATISTICS_H
+#define COLLECTIONPLAYSTATISTICS_H
+
+#include "config.h"
+
+#include <QtGlobal>
+#include <QMetaType>
+#include <QList>
+#include <QString>
+
+// Play statistics received from outside the collection, matched to collection songs by artist, album and title.
+// An empty album matches any album, playcount and lastplayed are -1 when not set.
+struct CollectionPlayStatistics {
+  CollectionPlayStatistics() : playcount(-1), lastplayed(-1) {}
+
+  QString artist;
+  QString album;
+  QString title;
+  int playcount;
+  qint64 lastplayed;
+};
+Q_DECLARE_METATYPE(CollectionPlayStatistics)
+
+using CollectionPlayStatisticsList = QList<CollectionPlayStatistics>;
+Q_DECLARE_METATYPE(CollectionPlayStatisticsList)
+
+#endif  // COLLECTIONPLAYSTATISTICS_H
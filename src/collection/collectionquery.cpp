@@ -92,6 +92,12 @@ void CollectionQuery::AddWhere(const QString &column, const QVariant &value, con
 
 }
 
+void CollectionQuery::SetSongColumns(const QStringList &excluded_columns) {
+
+  column_spec_ = Song::ProjectionSpec(excluded_columns, u"%songs_table"_s);
+
+}
+
 void CollectionQuery::AddCompilationRequirement(const bool compilation) {
   // The unary + is added to prevent sqlite from using the index idx_comp_artist.
   where_clauses_ << QStringLiteral("+compilation_effective = %1").arg(compilation ? 1 : 0);
@@ -107,7 +113,7 @@ QString CollectionQuery::GetInnerQuery() const {
              : QString();
 }
 
-bool CollectionQuery::Exec() {
+QString CollectionQuery::GetQuery() const {
 
   QString sql = QStringLiteral("SELECT %1 FROM %2 %3").arg(column_spec_, songs_table_, GetInnerQuery());
 
@@ -124,7 +130,13 @@ bool CollectionQuery::Exec() {
 
   sql.replace("%songs_table"_L1, songs_table_);
 
-  if (!QSqlQuery::prepare(sql)) return false;
+  return sql;
+
+}
+
+bool CollectionQuery::Exec() {
+
+  if (!QSqlQuery::prepare(GetQuery())) return false;
 
   // Bind values
   for (const QVariant &value : std::as_const(bound_values_)) {
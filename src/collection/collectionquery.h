@@ -40,6 +40,9 @@ class CollectionQuery : public SqlQuery {
   QVariant Value(const int column) const;
   QVariant value(const int column) const { return Value(column); }
 
+  // Returns the SQL statement executed by Exec(), with placeholders for bound_values().
+  QString GetQuery() const;
+
   bool Exec();
   bool exec() { return SqlQuery::exec(); }
 
@@ -55,6 +58,8 @@ class CollectionQuery : public SqlQuery {
 
   // Sets contents of SELECT clause on the query (list of columns to get).
   void SetColumnSpec(const QString &column_spec) { column_spec_ = column_spec; }
+  // Selects the columns read by Song::InitFromQuery(), the excluded columns are selected as NULL.
+  void SetSongColumns(const QStringList &excluded_columns = QStringList());
 
   // Sets an ORDER BY clause on the query.
   void SetOrderBy(const QString &order_by) { order_by_ = order_by; }
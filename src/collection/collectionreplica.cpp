@@ -0,0 +1,180 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "config.h"
+
+#include <chrono>
+
+#include <QtGlobal>
+#include <QObject>
+#include <QByteArray>
+#include <QString>
+#include <QTimer>
+#include <QTcpSocket>
+#include <QAbstractSocket>
+
+#include "core/logging.h"
+#include "core/song.h"
+#include "collectionbackend.h"
+#include "collectionreplica.h"
+#include "collectionserverprotocol.h"
+
+using namespace std::chrono_literals;
+using namespace CollectionServerProtocol;
+
+namespace {
+constexpr auto kReconnectInterval = 10s;
+}
+
+CollectionReplica::CollectionReplica(const SharedPtr<CollectionBackend> backend, QObject *parent)
+    : QObject(parent),
+      backend_(backend),
+      socket_(new QTcpSocket(this)),
+      timer_reconnect_(new QTimer(this)),
+      port_(0),
+      error_reported_(false) {
+
+  setObjectName(QLatin1String(QObject::metaObject()->className()));
+
+  timer_reconnect_->setSingleShot(true);
+  timer_reconnect_->setInterval(kReconnectInterval);
+  QObject::connect(timer_reconnect_, &QTimer::timeout, this, &CollectionReplica::Connect);
+
+  QObject::connect(socket_, &QTcpSocket::connected, this, &CollectionReplica::Connected);
+  QObject::connect(socket_, &QTcpSocket::disconnected, this, &CollectionReplica::Disconnected);
+  QObject::connect(socket_, &QTcpSocket::errorOccurred, this, &CollectionReplica::SocketError);
+  QObject::connect(socket_, &QTcpSocket::readyRead, this, &CollectionReplica::ReadyRead);
+
+}
+
+CollectionReplica::~CollectionReplica() {
+
+  QObject::disconnect(socket_, nullptr, this, nullptr);
+  socket_->abort();
+
+}
+
+void CollectionReplica::Start(const QString &host, const quint16 port, const QString &password) {
+
+  host_ = host;
+  port_ = port;
+  password_ = password;
+
+  Connect();
+
+}
+
+void CollectionReplica::Connect() {
+
+  if (host_.isEmpty() || socket_->state() != QAbstractSocket::UnconnectedState) return;
+
+  qLog(Debug) << "Connecting to collection server" << host_ << port_;
+
+  buffer_.clear();
+  socket_->connectToHost(host_, port_);
+
+}
+
+void CollectionReplica::Connected() {
+
+  qLog(Info) << "Connected to collection server" << host_ << port_;
+
+  error_reported_ = false;
+  socket_->write(Message(MessageType::Hello, HelloPayload(password_)));
+
+}
+
+void CollectionReplica::Disconnected() {
+
+  qLog(Info) << "Disconnected from collection server" << host_ << port_;
+
+  // The local copy of the collection stays usable until the server is back.
+  timer_reconnect_->start();
+
+}
+
+void CollectionReplica::SocketError(const QAbstractSocket::SocketError error) {
+
+  Q_UNUSED(error)
+
+  qLog(Warning) << "Collection server" << host_ << port_ << socket_->errorString();
+
+  if (socket_->state() == QAbstractSocket::UnconnectedState) {
+    timer_reconnect_->start();
+  }
+
+}
+
+void CollectionReplica::ReadyRead() {
+
+  buffer_.append(socket_->readAll());
+
+  MessageType type = MessageType::Error;
+  QByteArray payload;
+  bool error = false;
+  while (TakeMessage(buffer_, type, payload, error)) {
+    HandleMessage(type, payload);
+  }
+
+  if (error) {
+    qLog(Error) << "Invalid message from collection server" << host_ << port_;
+    buffer_.clear();
+    socket_->abort();
+    timer_reconnect_->start();
+  }
+
+}
+
+void CollectionReplica::HandleMessage(const MessageType type, const QByteArray &payload) {
+
+  switch (type) {
+    case MessageType::Snapshot:
+    case MessageType::SongsUpdated:
+    case MessageType::SongsDeleted:{
+      SongList songs;
+      if (!ParseSongsPayload(payload, songs)) {
+        qLog(Error) << "Invalid songs from collection server" << host_ << port_;
+        return;
+      }
+      if (type == MessageType::Snapshot) {
+        qLog(Debug) << "Received" << songs.count() << "songs from collection server" << host_ << port_;
+        backend_->ReplicaResetAsync(songs);
+      }
+      else if (type == MessageType::SongsUpdated) {
+        backend_->ReplicaUpdateSongsAsync(songs);
+      }
+      else {
+        backend_->DeleteSongsAsync(songs);
+      }
+      break;
+    }
+    case MessageType::Error:{
+      const QString error = ParseErrorPayload(payload);
+      qLog(Error) << "Collection server" << host_ << port_ << error;
+      if (!error_reported_) {
+        error_reported_ = true;
+        Q_EMIT Error(tr("Collection server %1: %2").arg(host_, error));
+      }
+      break;
+    }
+    case MessageType::Hello:
+      break;
+  }
+
+}
@@ -0,0 +1,74 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef COLLECTIONREPLICA_H
+#define COLLECTIONREPLICA_H
+
+#include "config.h"
+
+#include <QtGlobal>
+#include <QObject>
+#include <QByteArray>
+#include <QString>
+#include <QAbstractSocket>
+
+#include "includes/shared_ptr.h"
+#include "collectionserverprotocol.h"
+
+class QTcpSocket;
+class QTimer;
+class CollectionBackend;
+
+// Keeps the local collection a copy of the collection of a collection server.
+// The songs are written to the local database with the ids they have on the server, and the collection isn't scanned locally.
+class CollectionReplica : public QObject {
+  Q_OBJECT
+
+ public:
+  explicit CollectionReplica(const SharedPtr<CollectionBackend> backend, QObject *parent = nullptr);
+  ~CollectionReplica() override;
+
+  void Start(const QString &host, const quint16 port, const QString &password);
+
+ private Q_SLOTS:
+  void Connect();
+  void Connected();
+  void Disconnected();
+  void SocketError(const QAbstractSocket::SocketError error);
+  void ReadyRead();
+
+ Q_SIGNALS:
+  void Error(const QString &error);
+
+ private:
+  void HandleMessage(const CollectionServerProtocol::MessageType type, const QByteArray &payload);
+
+  const SharedPtr<CollectionBackend> backend_;
+  QTcpSocket *socket_;
+  QTimer *timer_reconnect_;
+  QString host_;
+  quint16 port_;
+  QString password_;
+  QByteArray buffer_;
+  bool error_reported_;
+
+  Q_DISABLE_COPY(CollectionReplica)
+};
+
+#endif  // COLLECTIONREPLICA_H
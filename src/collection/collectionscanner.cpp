@@ -0,0 +1,131 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "config.h"
+
+#include <memory>
+
+#include <QtGlobal>
+#include <QObject>
+#include <QCoreApplication>
+#include <QList>
+#include <QMap>
+#include <QSet>
+#include <QString>
+#include <QSqlDatabase>
+#include <QMutexLocker>
+#include <QElapsedTimer>
+
+#include "includes/shared_ptr.h"
+#include "core/logging.h"
+#include "core/database.h"
+#include "core/taskmanager.h"
+#include "core/song.h"
+#include "engine/gststartup.h"
+#include "tagreader/tagreaderclient.h"
+#include "collectionlibrary.h"
+#include "collectionbackend.h"
+#include "collectionwatcher.h"
+#include "collectionsnapshot.h"
+#include "collectionchangefeed.h"
+#include "collectionscanner.h"
+
+using std::make_shared;
+
+namespace {
+
+qint64 ChangeCounter(const SharedPtr<Database> database, const QString &songs_table) {
+
+  QMutexLocker l(database->Mutex());
+  QSqlDatabase db(database->Connect());
+  return CollectionSnapshot::ChangeCounter(db, songs_table);
+
+}
+
+}  // namespace
+
+int CollectionScanner::Run(const bool full_scan) {
+
+  QElapsedTimer timer;
+  timer.start();
+
+  // The fingerprinting and loudness analysis decode the files with GStreamer.
+  GstStartup::Initialize();
+
+  SharedPtr<TaskManager> task_manager = make_shared<TaskManager>();
+  SharedPtr<Database> database = make_shared<Database>(task_manager);
+  SharedPtr<TagReaderClient> tagreader_client = make_shared<TagReaderClient>();
+
+  SharedPtr<CollectionBackend> backend = make_shared<CollectionBackend>();
+  const QString songs_table = QLatin1String(CollectionLibrary::kSongsTable);
+  backend->Init(database, task_manager, Song::Source::Collection, songs_table, QLatin1String(CollectionLibrary::kDirsTable), QLatin1String(CollectionLibrary::kSubdirsTable));
+
+  // Everything runs in this thread, so the watcher writes its results to the database before the scan returns.
+  CollectionWatcher watcher(Song::Source::Collection, task_manager, tagreader_client, backend);
+  watcher.SetHeadless();
+
+  QObject::connect(&*backend, &CollectionBackend::DirectoryAdded, &watcher, &CollectionWatcher::AddDirectory);
+  QObject::connect(&watcher, &CollectionWatcher::NewOrUpdatedSongs, &*backend, &CollectionBackend::AddOrUpdateSongs);
+  QObject::connect(&watcher, &CollectionWatcher::SongsMTimeUpdated, &*backend, &CollectionBackend::UpdateMTimesOnly);
+  QObject::connect(&watcher, &CollectionWatcher::SongsDeleted, &*backend, &CollectionBackend::DeleteSongs);
+  QObject::connect(&watcher, &CollectionWatcher::SongsUnavailable, &*backend, &CollectionBackend::MarkSongsUnavailable);
+  QObject::connect(&watcher, &CollectionWatcher::SongsReadded, &*backend, &CollectionBackend::MarkSongsUnavailable);
+  QObject::connect(&watcher, &CollectionWatcher::SubdirsDiscovered, &*backend, &CollectionBackend::AddOrUpdateSubdirs);
+  QObject::connect(&watcher, &CollectionWatcher::SubdirsMTimeUpdated, &*backend, &CollectionBackend::AddOrUpdateSubdirs);
+  QObject::connect(&watcher, &CollectionWatcher::SubdirsDeleted, &*backend, &CollectionBackend::DeleteSubdirs);
+  QObject::connect(&watcher, &CollectionWatcher::CompilationsNeedUpdating, &*backend, &CollectionBackend::CompilationsNeedUpdating);
+  QObject::connect(&watcher, &CollectionWatcher::UpdateLastSeen, &*backend, &CollectionBackend::UpdateLastSeen);
+
+  // Song ID -> the last version of each song changed by the scan.
+  QMap<int, Song> songs_updated;
+  QSet<int> song_ids_deleted;
+  const auto songs_changed = [&songs_updated, &song_ids_deleted](const SongList &songs) {
+    for (const Song &song : songs) {
+      songs_updated.insert(song.id(), song);
+      song_ids_deleted.remove(song.id());
+    }
+  };
+  QObject::connect(&*backend, &CollectionBackend::SongsAdded, &watcher, songs_changed);
+  QObject::connect(&*backend, &CollectionBackend::SongsChanged, &watcher, songs_changed);
+  QObject::connect(&*backend, &CollectionBackend::SongsDeleted, &watcher, [&songs_updated, &song_ids_deleted](const SongList &songs) {
+    for (const Song &song : songs) {
+      songs_updated.remove(song.id());
+      song_ids_deleted.insert(song.id());
+    }
+  });
+
+  const qint64 change_counter_from = ChangeCounter(database, songs_table);
+
+  backend->LoadDirectories();
+  watcher.ScanNow(full_scan);
+
+  // The totals are updated with queued calls.
+  QCoreApplication::processEvents();
+
+  const qint64 change_counter_to = ChangeCounter(database, songs_table);
+
+  qLog(Info) << "Collection scan finished in" << timer.elapsed() << "ms," << songs_updated.count() << "songs updated," << song_ids_deleted.count() << "songs deleted";
+
+  CollectionChangeFeed::Append(songs_table, change_counter_from, change_counter_to, songs_updated.values(), song_ids_deleted.values());
+
+  database->Close();
+
+  return 0;
+
+}
@@ -0,0 +1,37 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef COLLECTIONSCANNER_H
+#define COLLECTIONSCANNER_H
+
+#include "config.h"
+
+// Scans the collection without a GUI, started by running Strawberry with kCommandLineOption, optionally followed by kFullScanArgument.
+// The scan runs with the collection settings of the user, including the fingerprinting and loudness analysis, and writes to the same database as the GUI.
+// The changed songs are appended to the collection change feed, so the GUI brings its collection snapshot up to date on the next startup instead of loading all songs again.
+class CollectionScanner {
+ public:
+  static constexpr char kCommandLineOption[] = "--scan-collection";
+  static constexpr char kFullScanArgument[] = "full";
+
+  // Returns the exit code of the process.
+  static int Run(const bool full_scan);
+};
+
+#endif  // COLLECTIONSCANNER_H
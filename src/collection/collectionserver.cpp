@@ -0,0 +1,228 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "config.h"
+
+#include <QtGlobal>
+#include <QObject>
+#include <QPointer>
+#include <QFuture>
+#include <QFutureWatcher>
+#include <QByteArray>
+#include <QString>
+#include <QHostAddress>
+#include <QTcpServer>
+#include <QTcpSocket>
+
+#include "core/logging.h"
+#include "core/taskexecutor.h"
+#include "collectionbackend.h"
+#include "collectionserver.h"
+#include "collectionserverprotocol.h"
+
+using namespace CollectionServerProtocol;
+
+CollectionServer::CollectionServer(const SharedPtr<CollectionBackend> backend, QObject *parent)
+    : QObject(parent),
+      backend_(backend),
+      server_(new QTcpServer(this)) {
+
+  setObjectName(QLatin1String(QObject::metaObject()->className()));
+
+  QObject::connect(server_, &QTcpServer::newConnection, this, &CollectionServer::NewConnection);
+
+  QObject::connect(&*backend_, &CollectionBackend::SongsAdded, this, &CollectionServer::SongsUpdated);
+  QObject::connect(&*backend_, &CollectionBackend::SongsChanged, this, &CollectionServer::SongsUpdated);
+  QObject::connect(&*backend_, &CollectionBackend::SongsStatisticsChanged, this, &CollectionServer::SongsUpdated);
+  QObject::connect(&*backend_, &CollectionBackend::SongsRatingChanged, this, &CollectionServer::SongsUpdated);
+  QObject::connect(&*backend_, &CollectionBackend::SongsDeleted, this, &CollectionServer::SongsDeleted);
+  QObject::connect(&*backend_, &CollectionBackend::DatabaseReset, this, &CollectionServer::DatabaseReset);
+
+}
+
+CollectionServer::~CollectionServer() {
+
+  server_->close();
+
+}
+
+bool CollectionServer::Listen(const quint16 port, const QString &password) {
+
+  password_ = password;
+
+  if (!server_->listen(QHostAddress::Any, port)) {
+    qLog(Error) << "Could not start collection server on port" << port << server_->errorString();
+    return false;
+  }
+
+  qLog(Info) << "Collection server listening on port" << server_->serverPort();
+
+  return true;
+
+}
+
+void CollectionServer::NewConnection() {
+
+  while (server_->hasPendingConnections()) {
+    QTcpSocket *socket = server_->nextPendingConnection();
+    qLog(Info) << "Collection replica connected from" << socket->peerAddress().toString();
+    clients_.insert(socket, Client());
+    QObject::connect(socket, &QTcpSocket::readyRead, this, &CollectionServer::ClientReadyRead);
+    QObject::connect(socket, &QTcpSocket::disconnected, this, &CollectionServer::ClientDisconnected);
+  }
+
+}
+
+void CollectionServer::ClientDisconnected() {
+
+  QTcpSocket *socket = qobject_cast<QTcpSocket*>(sender());
+  if (!socket) return;
+
+  qLog(Info) << "Collection replica" << socket->peerAddress().toString() << "disconnected";
+
+  clients_.remove(socket);
+  socket->deleteLater();
+
+}
+
+void CollectionServer::ClientReadyRead() {
+
+  QTcpSocket *socket = qobject_cast<QTcpSocket*>(sender());
+  if (!socket || !clients_.contains(socket)) return;
+
+  Client &client = clients_[socket];
+  client.buffer.append(socket->readAll());
+
+  // Replicas only send a hello, anything else is ignored.
+  if (client.accepted) {
+    client.buffer.clear();
+    return;
+  }
+
+  MessageType type = MessageType::Hello;
+  QByteArray payload;
+  bool error = false;
+  if (!TakeMessage(client.buffer, type, payload, error)) {
+    if (error) SendError(socket, tr("Invalid message."));
+    return;
+  }
+
+  QString password;
+  QString hello_error;
+  if (type != MessageType::Hello || !ParseHelloPayload(payload, password, hello_error)) {
+    SendError(socket, hello_error.isEmpty() ? tr("Invalid message.") : hello_error);
+    return;
+  }
+
+  if (password != password_) {
+    qLog(Warning) << "Collection replica" << socket->peerAddress().toString() << "sent the wrong password";
+    SendError(socket, tr("Wrong password."));
+    return;
+  }
+
+  client.accepted = true;
+  client.buffer.clear();
+
+  SendSnapshot(socket);
+
+}
+
+void CollectionServer::SendSnapshot(QTcpSocket *socket) {
+
+  Client &client = clients_[socket];
+  client.snapshot_pending = true;
+  client.pending_messages.clear();
+
+  // Reading and serializing all songs takes a while on large collections.
+  QFuture<QByteArray> future = TaskExecutor::Run(TaskExecutor::Lane::BackgroundIO, [backend = backend_]() { return SongsPayload(backend->GetAllSongs()); });
+  QFutureWatcher<QByteArray> *watcher = new QFutureWatcher<QByteArray>();
+  QObject::connect(watcher, &QFutureWatcher<QByteArray>::finished, this, [this, watcher, socket = QPointer<QTcpSocket>(socket)]() {
+    if (socket) {
+      SnapshotFinished(socket, watcher->result());
+    }
+    watcher->deleteLater();
+  });
+  watcher->setFuture(future);
+
+}
+
+void CollectionServer::SnapshotFinished(QTcpSocket *socket, const QByteArray &payload) {
+
+  if (!clients_.contains(socket)) return;
+
+  Client &client = clients_[socket];
+  client.snapshot_pending = false;
+
+  socket->write(Message(MessageType::Snapshot, payload));
+
+  // The changes are applied by song id, so sending a change that is already part of the snapshot again is harmless.
+  for (const QByteArray &message : std::as_const(client.pending_messages)) {
+    socket->write(message);
+  }
+  client.pending_messages.clear();
+
+}
+
+void CollectionServer::SendError(QTcpSocket *socket, const QString &error) {
+
+  socket->write(Message(MessageType::Error, ErrorPayload(error)));
+  socket->disconnectFromHost();
+
+}
+
+void CollectionServer::Send(const QByteArray &message) {
+
+  for (QHash<QTcpSocket*, Client>::iterator it = clients_.begin(); it != clients_.end(); ++it) {
+    if (!it->accepted) continue;
+    if (it->snapshot_pending) {
+      it->pending_messages << message;
+    }
+    else {
+      it.key()->write(message);
+    }
+  }
+
+}
+
+void CollectionServer::SongsUpdated(const SongList &songs) {
+
+  if (clients_.isEmpty() || songs.isEmpty()) return;
+
+  Send(Message(MessageType::SongsUpdated, SongsPayload(songs)));
+
+}
+
+void CollectionServer::SongsDeleted(const SongList &songs) {
+
+  if (clients_.isEmpty() || songs.isEmpty()) return;
+
+  Send(Message(MessageType::SongsDeleted, SongsPayload(songs)));
+
+}
+
+void CollectionServer::DatabaseReset() {
+
+  const QList<QTcpSocket*> sockets = clients_.keys();
+  for (QTcpSocket *socket : sockets) {
+    if (clients_.value(socket).accepted) {
+      SendSnapshot(socket);
+    }
+  }
+
+}
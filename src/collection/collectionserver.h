@@ -0,0 +1,81 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef COLLECTIONSERVER_H
+#define COLLECTIONSERVER_H
+
+#include "config.h"
+
+#include <QtGlobal>
+#include <QObject>
+#include <QList>
+#include <QHash>
+#include <QByteArray>
+#include <QString>
+
+#include "includes/shared_ptr.h"
+#include "core/song.h"
+
+class QTcpServer;
+class QTcpSocket;
+class CollectionBackend;
+
+// Shares the collection with the replicas connecting to it.
+// A replica gets a snapshot of all songs after it connected, and is then sent the changes of the collection as they happen, so the scanning is only done once.
+class CollectionServer : public QObject {
+  Q_OBJECT
+
+ public:
+  explicit CollectionServer(const SharedPtr<CollectionBackend> backend, QObject *parent = nullptr);
+  ~CollectionServer() override;
+
+  bool Listen(const quint16 port, const QString &password);
+
+ private Q_SLOTS:
+  void NewConnection();
+  void ClientReadyRead();
+  void ClientDisconnected();
+  void SongsUpdated(const SongList &songs);
+  void SongsDeleted(const SongList &songs);
+  void DatabaseReset();
+
+ private:
+  struct Client {
+    Client() : accepted(false), snapshot_pending(false) {}
+    QByteArray buffer;
+    bool accepted;
+    bool snapshot_pending;
+    // Changes that happened while the snapshot was read, sent after it.
+    QList<QByteArray> pending_messages;
+  };
+
+  void SendSnapshot(QTcpSocket *socket);
+  void SnapshotFinished(QTcpSocket *socket, const QByteArray &payload);
+  void SendError(QTcpSocket *socket, const QString &error);
+  void Send(const QByteArray &message);
+
+  const SharedPtr<CollectionBackend> backend_;
+  QTcpServer *server_;
+  QString password_;
+  QHash<QTcpSocket*, Client> clients_;
+
+  Q_DISABLE_COPY(CollectionServer)
+};
+
+#endif  // COLLECTIONSERVER_H
@@ -0,0 +1,168 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "config.h"
+
+#include <QtGlobal>
+#include <QObject>
+#include <QIODevice>
+#include <QByteArray>
+#include <QDataStream>
+#include <QtEndian>
+#include <QSet>
+#include <QString>
+#include <QUrl>
+
+#include "core/song.h"
+#include "core/database.h"
+#include "collectionserverprotocol.h"
+
+namespace CollectionServerProtocol {
+
+QByteArray Message(const MessageType type, const QByteArray &payload) {
+
+  QByteArray message;
+  message.reserve(static_cast<qsizetype>(sizeof(quint32)) + 1 + payload.size());
+
+  QDataStream s(&message, QIODevice::WriteOnly);
+  s.setVersion(kDataStreamVersion);
+  s << static_cast<quint32>(payload.size() + 1) << static_cast<quint8>(type);
+  s.writeRawData(payload.constData(), static_cast<int>(payload.size()));
+
+  return message;
+
+}
+
+bool TakeMessage(QByteArray &buffer, MessageType &type, QByteArray &payload, bool &error) {
+
+  error = false;
+
+  if (buffer.size() < static_cast<qsizetype>(sizeof(quint32))) return false;
+
+  const quint32 size = qFromBigEndian<quint32>(buffer.constData());
+  if (size == 0 || size > kMaxMessageSize) {
+    error = true;
+    return false;
+  }
+
+  if (buffer.size() < static_cast<qsizetype>(sizeof(quint32) + size)) return false;
+
+  type = static_cast<MessageType>(static_cast<quint8>(buffer.at(sizeof(quint32))));
+  payload = buffer.mid(static_cast<qsizetype>(sizeof(quint32)) + 1, static_cast<qsizetype>(size) - 1);
+  buffer.remove(0, static_cast<qsizetype>(sizeof(quint32) + size));
+
+  return true;
+
+}
+
+QByteArray HelloPayload(const QString &password) {
+
+  QByteArray payload;
+  QDataStream s(&payload, QIODevice::WriteOnly);
+  s.setVersion(kDataStreamVersion);
+  s << kMagic << kVersion << static_cast<qint32>(Database::kSchemaVersion) << password;
+
+  return payload;
+
+}
+
+bool ParseHelloPayload(const QByteArray &payload, QString &password, QString &error) {
+
+  QDataStream s(payload);
+  s.setVersion(kDataStreamVersion);
+
+  quint32 magic = 0;
+  quint32 version = 0;
+  qint32 schema_version = 0;
+  s >> magic >> version >> schema_version >> password;
+
+  if (s.status() != QDataStream::Ok || magic != kMagic) {
+    error = QObject::tr("Not a Strawberry collection replica.");
+    return false;
+  }
+  if (version != kVersion || schema_version != Database::kSchemaVersion) {
+    error = QObject::tr("The collection replica runs another version of Strawberry.");
+    return false;
+  }
+
+  return true;
+
+}
+
+QByteArray SongsPayload(const SongList &songs) {
+
+  QByteArray payload;
+  QDataStream s(&payload, QIODevice::WriteOnly);
+  s.setVersion(kDataStreamVersion);
+  s << static_cast<qint64>(songs.count());
+  for (const Song &song : songs) {
+    song.ToDataStream(&s);
+  }
+
+  return payload;
+
+}
+
+bool ParseSongsPayload(const QByteArray &payload, SongList &songs) {
+
+  QDataStream s(payload);
+  s.setVersion(kDataStreamVersion);
+
+  qint64 count = 0;
+  s >> count;
+  if (s.status() != QDataStream::Ok || count < 0) return false;
+
+  songs.reserve(static_cast<qsizetype>(count));
+  QSet<QString> strings;
+  QSet<QUrl> urls;
+  for (qint64 i = 0; i < count && s.status() == QDataStream::Ok; ++i) {
+    Song song;
+    song.InitFromDataStream(&s);
+    song.ShareStrings(strings, urls);
+    songs << song;
+  }
+
+  return s.status() == QDataStream::Ok;
+
+}
+
+QByteArray ErrorPayload(const QString &error) {
+
+  QByteArray payload;
+  QDataStream s(&payload, QIODevice::WriteOnly);
+  s.setVersion(kDataStreamVersion);
+  s << error;
+
+  return payload;
+
+}
+
+QString ParseErrorPayload(const QByteArray &payload) {
+
+  QDataStream s(payload);
+  s.setVersion(kDataStreamVersion);
+
+  QString error;
+  s >> error;
+
+  return error;
+
+}
+
+}  // namespace CollectionServerProtocol
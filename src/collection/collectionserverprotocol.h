@@ -0,0 +1,69 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef COLLECTIONSERVERPROTOCOL_H
+#define COLLECTIONSERVERPROTOCOL_H
+
+#include "config.h"
+
+#include <QtGlobal>
+#include <QByteArray>
+#include <QDataStream>
+#include <QString>
+
+#include "core/song.h"
+
+// Messages between a collection server and its replicas.
+// Each message is sent as its size followed by the message type and the payload, the songs are sent the way the collection snapshot stores them.
+// The replica starts with a hello, the server answers with a snapshot of all songs and then sends the changes as they happen.
+namespace CollectionServerProtocol {
+
+constexpr quint32 kMagic = 0x53434F4C;  // SCOL
+// Increase when the messages change.
+constexpr quint32 kVersion = 1;
+constexpr QDataStream::Version kDataStreamVersion = QDataStream::Qt_6_4;
+// Messages larger than this are treated as a protocol error.
+constexpr quint32 kMaxMessageSize = 512U * 1024U * 1024U;
+
+enum class MessageType : quint8 {
+  Hello = 1,         // Replica: magic, protocol version, schema version and password
+  Snapshot = 2,      // Server: all songs
+  SongsUpdated = 3,  // Server: songs added or changed
+  SongsDeleted = 4,  // Server: songs deleted
+  Error = 5          // Server: error message, the connection is closed after it
+};
+
+QByteArray Message(const MessageType type, const QByteArray &payload);
+
+// Takes the first complete message from the buffer, returns false when there is none yet.
+// Sets error when the buffer doesn't start with a valid message.
+bool TakeMessage(QByteArray &buffer, MessageType &type, QByteArray &payload, bool &error);
+
+QByteArray HelloPayload(const QString &password);
+bool ParseHelloPayload(const QByteArray &payload, QString &password, QString &error);
+
+QByteArray SongsPayload(const SongList &songs);
+bool ParseSongsPayload(const QByteArray &payload, SongList &songs);
+
+QByteArray ErrorPayload(const QString &error);
+QString ParseErrorPayload(const QByteArray &payload);
+
+}  // namespace CollectionServerProtocol
+
+#endif  // COLLECTIONSERVERPROTOCOL_H
@@ -0,0 +1,190 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "config.h"
+
+#include <optional>
+
+#include <QtGlobal>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QByteArray>
+#include <QDataStream>
+#include <QSet>
+#include <QString>
+#include <QUrl>
+#include <QSqlDatabase>
+#include <QElapsedTimer>
+
+#include "core/logging.h"
+#include "core/database.h"
+#include "core/sqlquery.h"
+#include "core/song.h"
+#include "core/standardpaths.h"
+#include "collectionlibrary.h"
+#include "collectionfilteroptions.h"
+#include "collectionchangefeed.h"
+#include "collectionsnapshot.h"
+
+using namespace Qt::Literals::StringLiterals;
+
+namespace CollectionSnapshot {
+
+namespace {
+
+constexpr quint32 kMagic = 0x53435348;  // SCSH
+// Increase when Song::ToDataStream() changes.
+constexpr quint32 kFormatVersion = 3;
+constexpr QDataStream::Version kDataStreamVersion = QDataStream::Qt_6_4;
+
+QString Filename(const QString &songs_table) {
+
+  return StandardPaths::WritableLocation(StandardPaths::StandardLocation::CacheLocation) + "/collection-snapshot-"_L1 + songs_table + ".bin"_L1;
+
+}
+
+}  // namespace
+
+bool CanUse(const QString &songs_table, const CollectionFilterOptions &filter_options) {
+
+  return songs_table == QLatin1String(CollectionLibrary::kSongsTable) && filter_options.filter_mode() == CollectionFilterOptions::FilterMode::All && filter_options.max_age() == -1 && filter_options.filter_text().isEmpty();
+
+}
+
+qint64 ChangeCounter(QSqlDatabase &db, const QString &songs_table) {
+
+  SqlQuery q(db);
+  q.prepare(u"SELECT counter FROM changes WHERE name = :name"_s);
+  q.BindValue(u":name"_s, songs_table);
+  if (!q.Exec() || !q.next()) return -1;
+
+  return q.value(0).toLongLong();
+
+}
+
+std::optional<SongList> Read(const QString &songs_table, const CollectionFilterOptions &filter_options, const qint64 change_counter) {
+
+  if (change_counter == -1) return std::nullopt;
+
+  QFile file(Filename(songs_table));
+  if (!file.exists() || !file.open(QIODevice::ReadOnly)) return std::nullopt;
+
+  QElapsedTimer timer;
+  timer.start();
+
+  // Map the file instead of reading it, the songs are decoded straight from the page cache.
+  uchar *data = file.map(0, file.size());
+  if (!data) return std::nullopt;
+
+  const QByteArray buffer = QByteArray::fromRawData(reinterpret_cast<const char*>(data), static_cast<qsizetype>(file.size()));
+  QDataStream s(buffer);
+  s.setVersion(kDataStreamVersion);
+
+  quint32 magic = 0;
+  quint32 format_version = 0;
+  qint32 schema_version = 0;
+  qint64 snapshot_change_counter = 0;
+  float min_rating = 0.0F;
+  qint64 count = 0;
+  s >> magic >> format_version >> schema_version >> snapshot_change_counter >> min_rating >> count;
+
+  if (s.status() != QDataStream::Ok || magic != kMagic || format_version != kFormatVersion || schema_version != Database::kSchemaVersion || count < 0) {
+    file.unmap(data);
+    return std::nullopt;
+  }
+
+  if (!qFuzzyCompare(min_rating + 2.0F, filter_options.min_rating() + 2.0F)) {
+    qLog(Debug) << "Collection snapshot for" << songs_table << "is for another rating filter";
+    file.unmap(data);
+    return std::nullopt;
+  }
+
+  // A snapshot older than the database can still be used when the headless scanner recorded the changes since.
+  if (snapshot_change_counter != change_counter && (snapshot_change_counter > change_counter || !CollectionChangeFeed::Exists(songs_table))) {
+    qLog(Debug) << "Collection snapshot for" << songs_table << "is stale";
+    file.unmap(data);
+    return std::nullopt;
+  }
+
+  SongList songs;
+  songs.reserve(static_cast<qsizetype>(count));
+  QSet<QString> strings;
+  QSet<QUrl> urls;
+  for (qint64 i = 0; i < count && s.status() == QDataStream::Ok; ++i) {
+    Song song;
+    song.InitFromDataStream(&s);
+    song.ShareStrings(strings, urls);
+    songs << song;
+  }
+
+  const bool ok = s.status() == QDataStream::Ok;
+  file.unmap(data);
+
+  if (!ok) {
+    qLog(Warning) << "Collection snapshot for" << songs_table << "is corrupt";
+    return std::nullopt;
+  }
+
+  if (snapshot_change_counter != change_counter) {
+    if (!CollectionChangeFeed::Apply(songs_table, snapshot_change_counter, change_counter, filter_options, songs)) {
+      qLog(Debug) << "Collection snapshot for" << songs_table << "is stale";
+      return std::nullopt;
+    }
+    Write(songs_table, filter_options, change_counter, songs);
+  }
+
+  qLog(Debug) << "Loaded" << songs.count() << "songs from the collection snapshot in" << timer.elapsed() << "ms";
+
+  return songs;
+
+}
+
+void Write(const QString &songs_table, const CollectionFilterOptions &filter_options, const qint64 change_counter, const SongList &songs) {
+
+  if (change_counter == -1) return;
+
+  const QString filename = Filename(songs_table);
+  if (!QDir().mkpath(QFileInfo(filename).path())) return;
+
+  QSaveFile file(filename);
+  if (!file.open(QIODevice::WriteOnly)) {
+    qLog(Warning) << "Could not open" << filename << "for writing" << file.errorString();
+    return;
+  }
+
+  QDataStream s(&file);
+  s.setVersion(kDataStreamVersion);
+  s << kMagic << kFormatVersion << static_cast<qint32>(Database::kSchemaVersion) << change_counter << filter_options.min_rating() << static_cast<qint64>(songs.count());
+  for (const Song &song : songs) {
+    song.ToDataStream(&s);
+  }
+
+  if (s.status() != QDataStream::Ok || !file.commit()) {
+    qLog(Warning) << "Could not write collection snapshot" << filename << file.errorString();
+    return;
+  }
+
+  // The snapshot includes all changes now.
+  CollectionChangeFeed::Clear(songs_table);
+
+}
+
+}  // namespace CollectionSnapshot
@@ -0,0 +1,51 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef COLLECTIONSNAPSHOT_H
+#define COLLECTIONSNAPSHOT_H
+
+#include "config.h"
+
+#include <optional>
+
+#include <QtGlobal>
+#include <QString>
+
+#include "core/song.h"
+
+class QSqlDatabase;
+class CollectionFilterOptions;
+
+// Binary copy of the songs loaded by the collection model, used on startup instead of querying the database.
+// The snapshot stores the change counter of the songs table, which is increased by triggers on every insert, update and delete.
+// A snapshot is only used when the counter still matches, otherwise the songs are loaded from the database and the snapshot is written again.
+namespace CollectionSnapshot {
+
+// Only unfiltered songs, or songs with a rating filter, are stored, the other filters depend on the time or the text.
+bool CanUse(const QString &songs_table, const CollectionFilterOptions &filter_options);
+
+// Returns -1 if the table has no change counter.
+qint64 ChangeCounter(QSqlDatabase &db, const QString &songs_table);
+
+std::optional<SongList> Read(const QString &songs_table, const CollectionFilterOptions &filter_options, const qint64 change_counter);
+void Write(const QString &songs_table, const CollectionFilterOptions &filter_options, const qint64 change_counter, const SongList &songs);
+
+}  // namespace CollectionSnapshot
+
+#endif  // COLLECTIONSNAPSHOT_H
@@ -0,0 +1,183 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "config.h"
+
+#include <optional>
+
+#include <QtGlobal>
+#include <QList>
+#include <QHash>
+#include <QString>
+#include <QUrl>
+#include <QReadLocker>
+#include <QWriteLocker>
+
+#include "core/song.h"
+#include "collectionsongindex.h"
+
+namespace {
+// The index is started over when it holds more songs, the songs looked up repeatedly are back in it soon.
+constexpr qsizetype kMaxSongs = 20000;
+}  // namespace
+
+CollectionSongIndex::CollectionSongIndex() : generation_(0) {}
+
+quint64 CollectionSongIndex::generation() const {
+
+  QReadLocker l(&lock_);
+  return generation_;
+
+}
+
+std::optional<Song> CollectionSongIndex::SongById(const int id) const {
+
+  QReadLocker l(&lock_);
+
+  const QHash<int, Song>::const_iterator it = songs_.constFind(id);
+  if (it == songs_.constEnd()) return std::nullopt;
+
+  return it.value();
+
+}
+
+std::optional<SongList> CollectionSongIndex::SongsByUrl(const QUrl &url) const {
+
+  QReadLocker l(&lock_);
+
+  const QHash<QUrl, QList<int>>::const_iterator it = song_ids_by_url_.constFind(url);
+  if (it == song_ids_by_url_.constEnd()) return std::nullopt;
+
+  SongList songs;
+  songs.reserve(it->count());
+  for (const int id : it.value()) {
+    const QHash<int, Song>::const_iterator song = songs_.constFind(id);
+    if (song == songs_.constEnd()) return std::nullopt;
+    songs << song.value();
+  }
+
+  return songs;
+
+}
+
+std::optional<Song> CollectionSongIndex::SongBySongId(const QString &song_id) const {
+
+  QReadLocker l(&lock_);
+
+  const QHash<QString, int>::const_iterator it = song_ids_by_song_id_.constFind(song_id);
+  if (it == song_ids_by_song_id_.constEnd()) return std::nullopt;
+
+  const QHash<int, Song>::const_iterator song = songs_.constFind(it.value());
+  if (song == songs_.constEnd()) return std::nullopt;
+
+  return song.value();
+
+}
+
+void CollectionSongIndex::InsertSongLocked(const Song &song) {
+
+  if (songs_.count() >= kMaxSongs) {
+    songs_.clear();
+    song_ids_by_url_.clear();
+    song_ids_by_song_id_.clear();
+  }
+
+  songs_.insert(song.id(), song);
+
+}
+
+void CollectionSongIndex::InsertSong(const quint64 generation, const Song &song) {
+
+  if (!song.is_valid() || song.id() == -1) return;
+
+  QWriteLocker l(&lock_);
+  if (generation != generation_) return;
+
+  InsertSongLocked(song);
+
+}
+
+void CollectionSongIndex::InsertSongsByUrl(const quint64 generation, const QUrl &url, const SongList &songs) {
+
+  // Not finding a song isn't remembered, the song could be added with another encoding of the URL.
+  if (songs.isEmpty()) return;
+
+  QWriteLocker l(&lock_);
+  if (generation != generation_) return;
+
+  QList<int> ids;
+  ids.reserve(songs.count());
+  for (const Song &song : songs) {
+    InsertSongLocked(song);
+    ids << song.id();
+  }
+  song_ids_by_url_.insert(url, ids);
+
+}
+
+void CollectionSongIndex::InsertSongBySongId(const quint64 generation, const QString &song_id, const Song &song) {
+
+  if (song_id.isEmpty() || !song.is_valid() || song.id() == -1) return;
+
+  QWriteLocker l(&lock_);
+  if (generation != generation_) return;
+
+  InsertSongLocked(song);
+  song_ids_by_song_id_.insert(song_id, song.id());
+
+}
+
+void CollectionSongIndex::SongsAdded() {
+
+  QWriteLocker l(&lock_);
+  ++generation_;
+  song_ids_by_url_.clear();
+  song_ids_by_song_id_.clear();
+
+}
+
+void CollectionSongIndex::RemoveSongs(const SongList &songs) {
+
+  QWriteLocker l(&lock_);
+  ++generation_;
+  for (const Song &song : songs) {
+    songs_.remove(song.id());
+  }
+
+}
+
+void CollectionSongIndex::RemoveSongs(const QList<int> &ids) {
+
+  QWriteLocker l(&lock_);
+  ++generation_;
+  for (const int id : ids) {
+    songs_.remove(id);
+  }
+
+}
+
+void CollectionSongIndex::Clear() {
+
+  QWriteLocker l(&lock_);
+  ++generation_;
+  songs_.clear();
+  song_ids_by_url_.clear();
+  song_ids_by_song_id_.clear();
+
+}
@@ -0,0 +1,74 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef COLLECTIONSONGINDEX_H
+#define COLLECTIONSONGINDEX_H
+
+#include "config.h"
+
+#include <optional>
+
+#include <QtGlobal>
+#include <QList>
+#include <QHash>
+#include <QString>
+#include <QUrl>
+#include <QReadWriteLock>
+
+#include "core/song.h"
+
+// Songs looked up by CollectionBackend by ID, URL and song ID, so repeated lookups don't need a query.
+// The songs are added when they are first looked up, and removed again when they change, the next lookup gets them from the database again.
+// Every change increases the generation, songs queried before a change are not added, so a lookup racing with a change can't add an outdated song.
+// Safe to use from any thread, lookups only take a shared lock.
+class CollectionSongIndex {
+ public:
+  CollectionSongIndex();
+
+  quint64 generation() const;
+
+  std::optional<Song> SongById(const int id) const;
+  // All songs with the URL, including unavailable songs.
+  std::optional<SongList> SongsByUrl(const QUrl &url) const;
+  std::optional<Song> SongBySongId(const QString &song_id) const;
+
+  void InsertSong(const quint64 generation, const Song &song);
+  void InsertSongsByUrl(const quint64 generation, const QUrl &url, const SongList &songs);
+  void InsertSongBySongId(const quint64 generation, const QString &song_id, const Song &song);
+
+  // New songs can have the URL or song ID of songs already looked up.
+  void SongsAdded();
+  void RemoveSongs(const SongList &songs);
+  void RemoveSongs(const QList<int> &ids);
+  void Clear();
+
+ private:
+  void InsertSongLocked(const Song &song);
+
+  mutable QReadWriteLock lock_;
+  quint64 generation_;
+  QHash<int, Song> songs_;
+  // URL or song ID -> IDs of the songs, the lookup misses when one of the songs was removed.
+  QHash<QUrl, QList<int>> song_ids_by_url_;
+  QHash<QString, int> song_ids_by_song_id_;
+
+  Q_DISABLE_COPY(CollectionSongIndex)
+};
+
+#endif  // COLLECTIONSONGINDEX_H
@@ -23,6 +23,8 @@
 
 #include <utility>
 #include <memory>
+#include <algorithm>
+#include <cmath>
 
 #include <QtGlobal>
 #include <QAbstractItemView>
@@ -39,12 +41,15 @@
 #include <QPixmap>
 #include <QPainter>
 #include <QRect>
+#include <QPoint>
 #include <QFont>
 #include <QFontMetrics>
 #include <QMenu>
 #include <QAction>
 #include <QMessageBox>
 #include <QSettings>
+#include <QTimer>
+#include <QScrollBar>
 #include <QPaintEvent>
 #include <QMouseEvent>
 #include <QKeyEvent>
@@ -76,6 +81,15 @@
 using std::make_unique;
 using namespace Qt::Literals::StringLiterals;
 
+namespace {
+constexpr int kPrefetchDelayMsec = 50;
+// How far ahead to prefetch, in time at the current scroll speed, and at most in pages.
+constexpr int kPrefetchLookaheadMsec = 500;
+constexpr int kPrefetchMaxPages = 4;
+// Scroll steps further apart than this are treated as a new scroll.
+constexpr int kScrollIdleMsec = 250;
+}  // namespace
+
 CollectionView::CollectionView(QWidget *parent)
     : AutoExpandingTreeView(parent),
       model_(nullptr),
@@ -102,7 +116,11 @@ CollectionView::CollectionView(QWidget *parent)
       action_no_show_in_various_(nullptr),
       action_delete_files_(nullptr),
       is_in_keyboard_search_(false),
-      delete_files_(false) {
+      delete_files_(false),
+      timer_prefetch_(new QTimer(this)),
+      scroll_value_(0),
+      scroll_direction_(1),
+      scroll_velocity_(0.0) {
 
   setObjectName(QLatin1String(QObject::metaObject()->className()));
 
@@ -116,6 +134,11 @@ CollectionView::CollectionView(QWidget *parent)
 
   setStyleSheet(u"QTreeView::item{padding-top:1px;}"_s);
 
+  timer_prefetch_->setSingleShot(true);
+  timer_prefetch_->setInterval(kPrefetchDelayMsec);
+  QObject::connect(timer_prefetch_, &QTimer::timeout, this, &CollectionView::PrefetchViewport);
+  QObject::connect(verticalScrollBar(), &QScrollBar::valueChanged, this, &CollectionView::ScrollValueChanged);
+
 }
 
 CollectionView::~CollectionView() = default;
@@ -431,6 +454,11 @@ void CollectionView::contextMenuEvent(QContextMenuEvent *e) {
 
     context_menu_->addSeparator();
 
+    context_menu_->addAction(tr("Expand all"), this, &CollectionView::ExpandAll);
+    context_menu_->addAction(tr("Collapse all"), this, &CollectionView::CollapseAll);
+
+    context_menu_->addSeparator();
+
     context_menu_->addMenu(filter_widget_->menu());
 
     action_copy_to_device_->setDisabled(device_manager_->connected_devices_model()->rowCount() == 0);
@@ -701,7 +729,7 @@ void CollectionView::scrollTo(const QModelIndex &idx, ScrollHint hint) {
 SongList CollectionView::GetSelectedSongs() const {
 
   QModelIndexList selected_indexes = filter_->mapSelectionToSource(selectionModel()->selection()).indexes();
-  return model_->GetChildSongs(selected_indexes);
+  return backend_->GetCompleteSongs(model_->GetChildSongs(selected_indexes));
 
 }
 
@@ -839,3 +867,58 @@ void CollectionView::DeleteFilesFinished(const SongList &songs_with_errors) {
   // It deletes itself when the user closes it
 
 }
+
+void CollectionView::ScrollValueChanged(const int value) {
+
+  const qint64 elapsed = scroll_elapsed_.isValid() ? scroll_elapsed_.restart() : -1;
+  if (elapsed == -1) scroll_elapsed_.start();
+
+  const int delta = value - scroll_value_;
+  scroll_value_ = value;
+  if (delta == 0) return;
+
+  const int direction = delta > 0 ? 1 : -1;
+  if (direction != scroll_direction_ || elapsed <= 0 || elapsed > kScrollIdleMsec) {
+    scroll_velocity_ = 0.0;
+  }
+  else {
+    // Scroll bar units per millisecond, smoothed so a single large step doesn't decide the lookahead.
+    scroll_velocity_ = (scroll_velocity_ + static_cast<double>(std::abs(delta)) / static_cast<double>(elapsed)) / 2.0;
+  }
+  scroll_direction_ = direction;
+
+  if (!timer_prefetch_->isActive()) timer_prefetch_->start();
+
+}
+
+void CollectionView::PrefetchViewport() {
+
+  if (!model_ || !filter_ || model() != filter_) return;
+
+  const QRect viewport_rect = viewport()->rect();
+  const QModelIndex first = indexAt(viewport_rect.topLeft());
+  if (!first.isValid()) return;
+  QModelIndex last = indexAt(QPoint(viewport_rect.left(), viewport_rect.bottom()));
+  if (!last.isValid()) last = first;
+
+  const int row_height = std::max(1, visualRect(first).height());
+  const int visible_rows = std::max(1, viewport_rect.height() / row_height);
+  const double lookahead = scroll_velocity_ * kPrefetchLookaheadMsec;
+  const int lookahead_rows = std::clamp(static_cast<int>(verticalScrollMode() == QAbstractItemView::ScrollPerPixel ? lookahead / row_height : lookahead), visible_rows, visible_rows * kPrefetchMaxPages);
+
+  // The visible rows are requested when they are painted, prefetch the rows after them in the scroll direction.
+  QModelIndexList indexes;
+  indexes.reserve(lookahead_rows);
+  QModelIndex idx = scroll_direction_ > 0 ? last : first;
+  for (int i = 0; i < lookahead_rows; ++i) {
+    idx = scroll_direction_ > 0 ? indexBelow(idx) : indexAbove(idx);
+    if (!idx.isValid()) break;
+    if (isExpanded(idx) && filter_->canFetchMore(idx)) {
+      filter_->fetchMore(idx);
+    }
+    indexes << filter_->mapToSource(idx);
+  }
+
+  model_->PrefetchAlbumIcons(indexes);
+
+}
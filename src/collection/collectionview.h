@@ -29,6 +29,7 @@
 #include <QString>
 #include <QPixmap>
 #include <QSet>
+#include <QElapsedTimer>
 
 #include "includes/scoped_ptr.h"
 #include "includes/shared_ptr.h"
@@ -36,6 +37,7 @@
 #include "widgets/autoexpandingtreeview.h"
 
 class QSortFilterProxyModel;
+class QTimer;
 class QMenu;
 class QAction;
 class QContextMenuEvent;
@@ -136,6 +138,8 @@ class CollectionView : public AutoExpandingTreeView {
   void NoShowInVarious();
   void Delete();
   void DeleteFilesFinished(const SongList &songs_with_errors);
+  void ScrollValueChanged(const int value);
+  void PrefetchViewport();
 
  private:
   void SetShowInVarious(const bool on);
@@ -190,6 +194,13 @@ class CollectionView : public AutoExpandingTreeView {
   bool is_in_keyboard_search_;
   bool delete_files_;
 
+  // Scroll direction and speed, used to prefetch the album icons of the rows about to be scrolled into view.
+  QTimer *timer_prefetch_;
+  QElapsedTimer scroll_elapsed_;
+  int scroll_value_;
+  int scroll_direction_;
+  double scroll_velocity_;
+
   // Save focus
   Song last_selected_song_;
   QString last_selected_container_;
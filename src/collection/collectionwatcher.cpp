@@ -22,10 +22,15 @@
 #include "config.h"
 
 #include <utility>
+#include <algorithm>
 #include <chrono>
+#include <atomic>
 
 #include <QObject>
 #include <QThread>
+#include <QThreadPool>
+#include <QtConcurrentMap>
+#include <QFuture>
 #include <QIODevice>
 #include <QStorageInfo>
 #include <QDir>
@@ -49,7 +54,9 @@
 #include "core/filesystemwatcherinterface.h"
 #include "core/logging.h"
 #include "core/taskmanager.h"
+#include "core/taskexecutor.h"
 #include "core/settings.h"
+#include "core/backgroundiothrottle.h"
 #include "utilities/imageutils.h"
 #include "constants/timeconstants.h"
 #include "constants/filesystemconstants.h"
@@ -75,6 +82,13 @@
 using namespace std::chrono_literals;
 using namespace Qt::Literals::StringLiterals;
 
+namespace {
+constexpr qint64 kScanCommitBatchSize = 1000;
+constexpr qint64 kMaxLrcFileSize = 262144;
+// Roughly how much of a file is read for its tags, for the background I/O bandwidth limit.
+constexpr qint64 kTagReadBytes = 131072;
+}
+
 QStringList CollectionWatcher::sValidImages = QStringList() << u"jpg"_s << u"jpeg"_s << u"jp2"_s << u"png"_s << u"gif"_s << u"tiff"_s << u"tif"_s << u"webp"_s;
 
 CollectionWatcher::CollectionWatcher(const Song::Source source,
@@ -97,6 +111,9 @@ CollectionWatcher::CollectionWatcher(const Song::Source source,
       expire_unavailable_songs_days_(60),
       overwrite_playcount_(false),
       overwrite_rating_(false),
+      scan_threads_(CollectionSettings::kScanThreadsDefault),
+      scan_threads_network_(CollectionSettings::kScanThreadsNetworkDefault),
+      scan_thread_pool_(new QThreadPool(this)),
       stop_requested_(false),
       abort_requested_(false),
       rescan_timer_(new QTimer(this)),
@@ -104,7 +121,9 @@ CollectionWatcher::CollectionWatcher(const Song::Source source,
       rescan_paused_(false),
       total_watches_(0),
       cue_parser_(new CueParser(tagreader_client, backend, this)),
-      last_scan_time_(0) {
+      mount_points_dirty_(true),
+      last_scan_time_(0),
+      headless_(false) {
 
   setObjectName(source_ == Song::Source::Collection ? QLatin1String(QObject::metaObject()->className()) : QStringLiteral("%1%2").arg(Song::DescriptionForSource(source_), QLatin1String(QObject::metaObject()->className())));
 
@@ -226,8 +245,20 @@ void CollectionWatcher::ReloadSettings() {
   expire_unavailable_songs_days_ = s.value(CollectionSettings::kExpireUnavailableSongs, 60).toInt();
   overwrite_playcount_ = s.value(CollectionSettings::kOverwritePlaycount, false).toBool();
   overwrite_rating_ = s.value(CollectionSettings::kOverwriteRating, false).toBool();
+  scan_threads_ = s.value(CollectionSettings::kScanThreads, CollectionSettings::kScanThreadsDefault).toInt();
+  scan_threads_network_ = s.value(CollectionSettings::kScanThreadsNetwork, CollectionSettings::kScanThreadsNetworkDefault).toInt();
+  if (source_ == Song::Source::Collection) {
+    BackgroundIOThrottle::Instance()->SetBandwidthLimit(s.value(CollectionSettings::kBackgroundReadLimit, 0).toLongLong() * 1024LL * 1024LL);
+  }
   s.endGroup();
 
+  if (headless_) {
+    scan_on_startup_ = false;
+    monitor_ = false;
+  }
+
+  scan_thread_pool_->setMaxThreadCount(qMax(ScanThreadsForFileSystem(QByteArray()), scan_threads_network_));
+
   best_art_filters_.clear();
   for (const QString &filter : filters) {
     QString str = filter.trimmed();
@@ -311,6 +342,15 @@ void CollectionWatcher::ScanTransaction::AddToProgressMax(const quint64 n) {
 
 }
 
+void CollectionWatcher::ScanTransaction::CorrectProgressMax(const quint64 files_count_estimate, const quint64 files_count) {
+
+  if (files_count == files_count_estimate) return;
+
+  progress_max_ = std::max(progress_, progress_max_ - std::min(progress_max_, files_count_estimate) + files_count);
+  watcher_->task_manager_->SetTaskProgress(task_id_, progress_, progress_max_);
+
+}
+
 void CollectionWatcher::ScanTransaction::CommitNewOrUpdatedSongs() {
 
   if (!deleted_subdirs.isEmpty()) {
@@ -331,18 +371,19 @@ void CollectionWatcher::ScanTransaction::CommitNewOrUpdatedSongs() {
       Q_EMIT watcher_->SongsUnavailable(deleted_songs);
     }
     else {
-      Q_EMIT watcher_->SongsDeleted(deleted_songs);
+      Q_EMIT watcher_->SongsDeleted(SongBatch(std::move(deleted_songs)));
     }
     deleted_songs.clear();
   }
 
   if (!new_songs.isEmpty()) {
-    Q_EMIT watcher_->NewOrUpdatedSongs(new_songs);
+    watcher_->PerformEBUR128Analysis(new_songs);
+    Q_EMIT watcher_->NewOrUpdatedSongs(SongBatch(std::move(new_songs)));
     new_songs.clear();
   }
 
   if (!touched_songs.isEmpty()) {
-    Q_EMIT watcher_->SongsMTimeUpdated(touched_songs);
+    Q_EMIT watcher_->SongsMTimeUpdated(SongBatch(std::move(touched_songs)));
     touched_songs.clear();
   }
 
@@ -374,6 +415,23 @@ void CollectionWatcher::ScanTransaction::CommitNewOrUpdatedSongs() {
 }
 
 
+void CollectionWatcher::ScanTransaction::CommitNewOrUpdatedSongsBatch() {
+
+  if (new_songs.count() + touched_songs.count() < kScanCommitBatchSize) return;
+
+  if (!new_songs.isEmpty()) {
+    watcher_->PerformEBUR128Analysis(new_songs);
+    Q_EMIT watcher_->NewOrUpdatedSongs(SongBatch(std::move(new_songs)));
+    new_songs.clear();
+  }
+
+  if (!touched_songs.isEmpty()) {
+    Q_EMIT watcher_->SongsMTimeUpdated(SongBatch(std::move(touched_songs)));
+    touched_songs.clear();
+  }
+
+}
+
 SongList CollectionWatcher::ScanTransaction::FindSongsInSubdirectory(const QString &path) {
 
   if (cached_songs_dirty_) {
@@ -472,16 +530,16 @@ void CollectionWatcher::AddDirectory(const CollectionDirectory &dir, const Colle
   {
     const QFileInfo path_info(dir.path);
     if (path_info.isSymbolicLink()) {
-      const QStorageInfo storage_info(path_info.symLinkTarget());
-      if (kRejectedFileSystems.contains(storage_info.fileSystemType())) {
-        qLog(Warning) << "Ignoring collection directory path" << dir.path << "which is a symbolic link to path" << path_info.symLinkTarget() << "with rejected filesystem type" << storage_info.fileSystemType();
+      const QByteArray filesystem_type = FileSystemType(path_info.symLinkTarget());
+      if (kRejectedFileSystems.contains(filesystem_type)) {
+        qLog(Warning) << "Ignoring collection directory path" << dir.path << "which is a symbolic link to path" << path_info.symLinkTarget() << "with rejected filesystem type" << filesystem_type;
         return;
       }
     }
     else {
-      const QStorageInfo storage_info(dir.path);
-      if (kRejectedFileSystems.contains(storage_info.fileSystemType())) {
-        qLog(Warning) << "Ignoring collection directory path" << dir.path << "with rejected filesystem type" << storage_info.fileSystemType();
+      const QByteArray filesystem_type = FileSystemType(dir.path);
+      if (kRejectedFileSystems.contains(filesystem_type)) {
+        qLog(Warning) << "Ignoring collection directory path" << dir.path << "with rejected filesystem type" << filesystem_type;
         return;
       }
     }
@@ -494,7 +552,7 @@ void CollectionWatcher::AddDirectory(const CollectionDirectory &dir, const Colle
   if (subdirs.isEmpty()) {
     // This is a new directory that we've never seen before. Scan it fully.
     ScanTransaction transaction(this, dir.id, false, false, mark_songs_unavailable_);
-    const quint64 files_count = FilesCountForPath(&transaction, dir.path);
+    const quint64 files_count = FilesCountEstimateForPath(&transaction, dir.path);
     transaction.SetKnownSubdirs(subdirs);
     transaction.AddToProgressMax(files_count);
     ScanSubdirectory(dir, dir.path, CollectionSubdirectory(), files_count, &transaction);
@@ -510,7 +568,7 @@ void CollectionWatcher::AddDirectory(const CollectionDirectory &dir, const Colle
       // We can do an incremental scan - looking at the mtimes of each subdirectory and only rescan if the directory has changed.
       ScanTransaction transaction(this, dir.id, true, false, mark_songs_unavailable_);
       QMap<QString, quint64> subdir_files_count;
-      const quint64 files_count = FilesCountForSubdirs(&transaction, subdirs, subdir_files_count);
+      const quint64 files_count = FilesCountEstimateForSubdirs(&transaction, subdirs, subdir_files_count);
       transaction.SetKnownSubdirs(subdirs);
       transaction.AddToProgressMax(files_count);
       for (const CollectionSubdirectory &subdir : subdirs) {
@@ -527,16 +585,17 @@ void CollectionWatcher::AddDirectory(const CollectionDirectory &dir, const Colle
 
 }
 
-void CollectionWatcher::ScanSubdirectory(const CollectionDirectory &dir, const QString &path, const CollectionSubdirectory &subdir, const quint64 files_count, ScanTransaction *t, const bool force_noincremental) {
+void CollectionWatcher::ScanSubdirectory(const CollectionDirectory &dir, const QString &path, const CollectionSubdirectory &subdir, const quint64 files_count_estimate, ScanTransaction *t, const bool force_noincremental) {
 
   const QFileInfo path_info(path);
   const qint64 path_mtime = path_info.exists() && path_info.lastModified().isValid() ? path_info.lastModified().toSecsSinceEpoch() : 0;
 
+  QByteArray filesystem_type;
   if (path_info.isSymLink()) {
     const QString real_path = path_info.symLinkTarget();
-    const QStorageInfo storage_info(real_path);
-    if (kRejectedFileSystems.contains(storage_info.fileSystemType())) {
-      qLog(Warning) << "Ignoring symbolic link" << path << "which links to" << real_path << "with rejected filesystem type" << storage_info.fileSystemType();
+    filesystem_type = FileSystemType(real_path);
+    if (kRejectedFileSystems.contains(filesystem_type)) {
+      qLog(Warning) << "Ignoring symbolic link" << path << "which links to" << real_path << "with rejected filesystem type" << filesystem_type;
       return;
     }
     // Do not scan symlinked dirs that are already in collection
@@ -547,9 +606,9 @@ void CollectionWatcher::ScanSubdirectory(const CollectionDirectory &dir, const Q
     }
   }
   else {
-    const QStorageInfo storage_info(path);
-    if (kRejectedFileSystems.contains(storage_info.fileSystemType())) {
-      qLog(Warning) << "Ignoring path" << path << "with rejected filesystem type" << storage_info.fileSystemType();
+    filesystem_type = FileSystemType(path);
+    if (kRejectedFileSystems.contains(filesystem_type)) {
+      qLog(Warning) << "Ignoring path" << path << "with rejected filesystem type" << filesystem_type;
       return;
     }
   }
@@ -569,12 +628,14 @@ void CollectionWatcher::ScanSubdirectory(const CollectionDirectory &dir, const Q
 
   if (!t->ignores_mtime() && !force_noincremental && t->is_incremental() && path_mtime != 0 && subdir.mtime == path_mtime && !songs_missing_fingerprint && !songs_missing_loudness_characteristics) {
     // The directory hasn't changed since last time
-    t->AddToProgress(files_count);
+    t->AddToProgress(files_count_estimate);
     return;
   }
 
   QMap<QString, QStringList> album_art;
+  QStringList lrc_files;
   QStringList files_on_disk;
+  ScanFileInfos file_infos;
   CollectionSubdirectoryList my_new_subdirs;
 
   // If a directory is moved then only its parent gets a changed notification, so we need to look and see if any of our children don't exist anymore.
@@ -587,23 +648,28 @@ void CollectionWatcher::ScanSubdirectory(const CollectionDirectory &dir, const Q
   }
 
   // First we "quickly" get a list of the files in the directory that we think might be music.  While we're here, we also look for new subdirectories and possible album artwork.
+  // This is the only walk of the directory, the progress maximum is corrected from the estimate once the number of files is known.
+  quint64 files_count = 0;
   if (path_info.exists()) {
     QDirIterator it(path, QDir::Dirs | QDir::Files | QDir::NoDotAndDotDot);
     while (it.hasNext()) {
 
       if (stop_or_abort_requested()) return;
 
-      const QString child_filepath = it.next();
-      const QFileInfo child_fileinfo(child_filepath);
+      // Use the file information from the directory iterator, so each child is only stat'ed once.
+      const QFileInfo child_fileinfo = it.nextFileInfo();
+      const QString child_filepath = child_fileinfo.filePath();
 
       if (child_fileinfo.isSymLink()) {
-        const QStorageInfo storage_info(child_fileinfo.symLinkTarget());
-        if (kRejectedFileSystems.contains(storage_info.fileSystemType())) {
-          qLog(Warning) << "Ignoring symbolic link" << child_filepath << "which links to" << child_fileinfo.symLinkTarget() << "with rejected filesystem type" << storage_info.fileSystemType();
+        const QByteArray filesystem_type_target = FileSystemType(child_fileinfo.symLinkTarget());
+        if (kRejectedFileSystems.contains(filesystem_type_target)) {
+          qLog(Warning) << "Ignoring symbolic link" << child_filepath << "which links to" << child_fileinfo.symLinkTarget() << "with rejected filesystem type" << filesystem_type_target;
           continue;
         }
       }
 
+      ++files_count;
+
       if (child_fileinfo.isDir()) {
         if (!t->HasSeenSubdir(child_filepath)) {
           // We haven't seen this subdirectory before - add it to a list, and later we'll tell the backend about it and scan it.
@@ -616,6 +682,9 @@ void CollectionWatcher::ScanSubdirectory(const CollectionDirectory &dir, const Q
         t->AddToProgress(1);
       }
       else {
+        ScanFileInfo &file_info = file_infos[child_filepath];
+        file_info.size = child_fileinfo.size();
+        file_info.mtime = child_fileinfo.lastModified().isValid() ? child_fileinfo.lastModified().toSecsSinceEpoch() : 0;
         const QString ext_part = ExtensionPart(child_filepath);
         const QString dir_part = DirectoryPart(child_filepath);
         if (Song::kRejectedExtensions.contains(child_fileinfo.suffix(), Qt::CaseInsensitive) || child_fileinfo.baseName() == "qt_temp"_L1) {
@@ -625,6 +694,10 @@ void CollectionWatcher::ScanSubdirectory(const CollectionDirectory &dir, const Q
           album_art[dir_part] << child_filepath;
           t->AddToProgress(1);
         }
+        else if (ext_part == "lrc"_L1) {
+          lrc_files << child_filepath;
+          t->AddToProgress(1);
+        }
         else {
           files_on_disk << child_filepath;
         }
@@ -634,9 +707,42 @@ void CollectionWatcher::ScanSubdirectory(const CollectionDirectory &dir, const Q
 
   if (stop_or_abort_requested()) return;
 
+  // Reuse the album art picked in an earlier scan while the directory is unchanged, instead of loading all the images again.
+  if (path_mtime != 0 && subdir.mtime == path_mtime && !subdir.art_automatic.isEmpty()) {
+    QMap<QString, QStringList>::iterator it = album_art.find(path);
+    if (it != album_art.end() && it->count() > 1 && it->contains(subdir.art_automatic)) {
+      *it = QStringList() << subdir.art_automatic;
+    }
+  }
+
+  t->CorrectProgressMax(files_count_estimate, files_count);
+  if (path_info.exists()) {
+    subdir_files_count_[path] = files_count;
+  }
+  else {
+    subdir_files_count_.remove(path);
+  }
+
   // Ask the database for a list of files in this directory
   const SongList songs_in_db = t->FindSongsInSubdirectory(path);
 
+  // Read the files that need their tags read ahead on the scan thread pool, the results are picked up by the comparison below.
+  ScanFileResults scan_file_results;
+  const int scan_threads = ScanThreadsForFileSystem(filesystem_type);
+  if (scan_threads > 1) {
+    QStringList files_to_read;
+    for (const QString &file : std::as_const(files_on_disk)) {
+      if (FileNeedsTagRead(file, file_infos, songs_in_db, t)) {
+        files_to_read << file;
+      }
+    }
+    if (files_to_read.count() > 1) {
+      scan_file_results = ReadFilesParallel(files_to_read, songs_in_db, scan_threads);
+    }
+  }
+
+  if (stop_or_abort_requested()) return;
+
   QSet<QString> cues_processed;
 
   // Now compare the list from the database with the list of files on disk
@@ -646,7 +752,7 @@ void CollectionWatcher::ScanSubdirectory(const CollectionDirectory &dir, const Q
     if (stop_or_abort_requested()) return;
 
     // Associated CUE
-    const QString new_cue = CueParser::FindCueFilename(file);
+    const QString new_cue = FindCueFilename(file, file_infos);
 
     SongList matching_songs;
     if (FindSongsByPath(songs_in_db, file, &matching_songs)) {  // Found matching song in DB by path.
@@ -654,23 +760,16 @@ void CollectionWatcher::ScanSubdirectory(const CollectionDirectory &dir, const Q
       const Song matching_song = matching_songs.first();
 
       // The song is in the database and still on disk.
-      // Check the mtime to see if it's been changed since it was added.
-      const QFileInfo fileinfo(file);
-
-      if (!fileinfo.exists()) {
-        // Partially fixes race condition - if file was removed between being added to the list and now.
-        files_on_disk.removeAll(file);
-        t->AddToProgress(1);
-        continue;
-      }
+      // Check the mtime and size from the directory listing to see if it's been changed since it was added.
+      const ScanFileInfo file_info = file_infos.value(file);
 
       // CUE sheet's path from collection (if any).
-      qint64 matching_song_cue_mtime = static_cast<qint64>(GetMtimeForCue(matching_song.cue_path()));
+      qint64 matching_song_cue_mtime = static_cast<qint64>(GetMtimeForCue(matching_song.cue_path(), file_infos));
 
       // CUE sheet's path from this file (if any).
       qint64 new_cue_mtime = 0;
       if (!new_cue.isEmpty()) {
-        new_cue_mtime = static_cast<qint64>(GetMtimeForCue(new_cue));
+        new_cue_mtime = static_cast<qint64>(GetMtimeForCue(new_cue, file_infos));
       }
 
       const bool cue_added = new_cue_mtime != 0 && !matching_song.has_cue();
@@ -678,7 +777,10 @@ void CollectionWatcher::ScanSubdirectory(const CollectionDirectory &dir, const Q
       const bool cue_deleted = matching_song.has_cue() && new_cue_mtime == 0;
 
       // Watch out for CUE songs which have their mtime equal to qMax(media_file_mtime, cue_sheet_mtime)
-      bool changed = (matching_song.mtime() != qMax(fileinfo.lastModified().toSecsSinceEpoch(), matching_song_cue_mtime)) || cue_deleted || cue_added || cue_changed;
+      bool changed = (matching_song.mtime() != qMax(file_info.mtime, matching_song_cue_mtime)) || cue_deleted || cue_added || cue_changed;
+      if (!matching_song.has_cue() && matching_song.filesize() > 0 && matching_song.filesize() != file_info.size) {
+        changed = true;
+      }
 
       // Also want to look to see whether the album art has changed
       const QUrl art_automatic = ArtForSong(file, album_art);
@@ -718,19 +820,11 @@ void CollectionWatcher::ScanSubdirectory(const CollectionDirectory &dir, const Q
       // The song's changed or missing fingerprint - create fingerprint and reread the metadata from file.
       else if (t->ignores_mtime() || changed || missing_fingerprint || missing_loudness_characteristics) {
 
-        QString fingerprint;
-#ifdef HAVE_SONGFINGERPRINTING
-        if (song_tracking_) {
-          Chromaprinter chromaprinter(file);
-          fingerprint = chromaprinter.CreateFingerprint();
-          if (fingerprint.isEmpty()) {
-            fingerprint = "NONE"_L1;
-          }
-        }
-#endif
+        const ScanFileResults::const_iterator scan_file_result = scan_file_results.constFind(file);
+        const QString fingerprint = scan_file_result == scan_file_results.constEnd() ? CreateFingerprint(file) : scan_file_result->fingerprint;
 
         if (new_cue.isEmpty() || new_cue_mtime == 0) {  // If no CUE or it's about to lose it.
-          if (!UpdateNonCueAssociatedSong(file, fingerprint, matching_songs, art_automatic, cue_deleted, t)) {
+          if (!UpdateNonCueAssociatedSong(file, fingerprint, matching_songs, art_automatic, cue_deleted, scan_file_results, t)) {
             files_on_disk.removeAll(file);
           }
         }
@@ -741,28 +835,11 @@ void CollectionWatcher::ScanSubdirectory(const CollectionDirectory &dir, const Q
 
     }
     else {  // Search the DB by fingerprint.
-      QString fingerprint;
-#ifdef HAVE_SONGFINGERPRINTING
-      if (song_tracking_) {
-        Chromaprinter chromaprinter(file);
-        fingerprint = chromaprinter.CreateFingerprint();
-        if (fingerprint.isEmpty()) {
-          fingerprint = "NONE"_L1;
-        }
-      }
-#endif
+      const ScanFileResults::const_iterator scan_file_result = scan_file_results.constFind(file);
+      const QString fingerprint = scan_file_result == scan_file_results.constEnd() ? CreateFingerprint(file) : scan_file_result->fingerprint;
       if (song_tracking_ && !fingerprint.isEmpty() && fingerprint != "NONE"_L1 && FindSongsByFingerprint(file, fingerprint, &matching_songs)) {
 
         // The song is in the database and still on disk.
-        // Check the mtime to see if it's been changed since it was added.
-        const QFileInfo fileinfo(file);
-        if (!fileinfo.exists()) {
-          // Partially fixes race condition - if file was removed between being added to the list and now.
-          files_on_disk.removeAll(file);
-          t->AddToProgress(1);
-          continue;
-        }
-
         // Make sure the songs aren't deleted, as they still exist elsewhere with a different file path.
         bool matching_songs_has_cue = false;
         for (const Song &matching_song : std::as_const(matching_songs)) {
@@ -782,14 +859,14 @@ void CollectionWatcher::ScanSubdirectory(const CollectionDirectory &dir, const Q
         // CUE sheet's path from this file (if any).
         qint64 new_cue_mtime = 0;
         if (!new_cue.isEmpty()) {
-          new_cue_mtime = static_cast<qint64>(GetMtimeForCue(new_cue));
+          new_cue_mtime = static_cast<qint64>(GetMtimeForCue(new_cue, file_infos));
         }
 
         // Get new album art
         const QUrl art_automatic = ArtForSong(file, album_art);
 
         if (new_cue.isEmpty() || new_cue_mtime == 0) {  // If no CUE or it's about to lose it.
-          if (!UpdateNonCueAssociatedSong(file, fingerprint, matching_songs, art_automatic, matching_songs_has_cue && new_cue_mtime == 0, t)) {
+          if (!UpdateNonCueAssociatedSong(file, fingerprint, matching_songs, art_automatic, matching_songs_has_cue && new_cue_mtime == 0, scan_file_results, t)) {
             files_on_disk.removeAll(file);
           }
         }
@@ -800,7 +877,7 @@ void CollectionWatcher::ScanSubdirectory(const CollectionDirectory &dir, const Q
       }
       else {  // The song is on disk but not in the DB
 
-        const SongList songs = ScanNewFile(file, path, fingerprint, new_cue, &cues_processed);
+        const SongList songs = ScanNewFile(file, path, fingerprint, new_cue, scan_file_results, &cues_processed);
         if (songs.isEmpty()) {
           files_on_disk.removeAll(file);
           t->AddToProgress(1);
@@ -822,6 +899,8 @@ void CollectionWatcher::ScanSubdirectory(const CollectionDirectory &dir, const Q
     t->AddToProgress(1);
   }
 
+  ReadLrcFiles(lrc_files, songs_in_db, t->new_songs);
+
   // Look for deleted songs
   for (const Song &song : std::as_const(songs_in_db)) {
     QString file = song.url().toLocalFile();
@@ -836,6 +915,11 @@ void CollectionWatcher::ScanSubdirectory(const CollectionDirectory &dir, const Q
   updated_subdir.directory_id = t->dir_id();
   updated_subdir.mtime = path_mtime;
   updated_subdir.path = path;
+  // ArtForSong() leaves the picked album art as the only entry.
+  const QStringList subdir_album_art = album_art.value(path);
+  if (subdir_album_art.count() == 1) {
+    updated_subdir.art_automatic = subdir_album_art.first();
+  }
 
   if (!path_info.exists() && updated_subdir.path != dir.path) {
     t->deleted_subdirs << updated_subdir;
@@ -843,10 +927,12 @@ void CollectionWatcher::ScanSubdirectory(const CollectionDirectory &dir, const Q
   else if (subdir.directory_id == -1) {
     t->new_subdirs << updated_subdir;
   }
-  else if (subdir.mtime != updated_subdir.mtime) {
+  else if (subdir.mtime != updated_subdir.mtime || subdir.art_automatic != updated_subdir.art_automatic) {
     t->touched_subdirs << updated_subdir;
   }
 
+  t->CommitNewOrUpdatedSongsBatch();
+
   // Recurse into the new subdirs that we found
   for (const CollectionSubdirectory &my_new_subdir : std::as_const(my_new_subdirs)) {
     if (stop_or_abort_requested()) return;
@@ -883,7 +969,6 @@ void CollectionWatcher::UpdateCueAssociatedSongs(const QString &file,
   for (Song new_cue_song : songs) {
     new_cue_song.set_source(source_);
     new_cue_song.set_directory_id(t->dir_id());
-    PerformEBUR128Analysis(new_cue_song);
     new_cue_song.set_fingerprint(fingerprint);
 
     if (sections_map.contains(static_cast<quint64>(new_cue_song.beginning_nanosec()))) {  // Changed section
@@ -913,6 +998,7 @@ bool CollectionWatcher::UpdateNonCueAssociatedSong(const QString &file,
                                                    const SongList &matching_songs,
                                                    const QUrl &art_automatic,
                                                    const bool cue_deleted,
+                                                   const ScanFileResults &scan_file_results,
                                                    ScanTransaction *t) {
 
   // If a CUE got deleted, we turn it's first section into the new 'raw' (cueless) song, and we just remove the rest of the sections from the collection
@@ -926,12 +1012,12 @@ bool CollectionWatcher::UpdateNonCueAssociatedSong(const QString &file,
   }
 
   Song song_on_disk(source_);
-  const TagReaderResult result = tagreader_client_->ReadFileBlocking(file, &song_on_disk);
+  SetAudioPropertiesForScan(matching_song, &song_on_disk);
+  const TagReaderResult result = ReadFileForScan(file, scan_file_results, &song_on_disk);
   if (result.success() && song_on_disk.is_valid()) {
     song_on_disk.set_source(source_);
     song_on_disk.set_directory_id(t->dir_id());
     song_on_disk.set_id(matching_song.id());
-    PerformEBUR128Analysis(song_on_disk);
     song_on_disk.set_fingerprint(fingerprint);
     song_on_disk.set_art_automatic(art_automatic);
     song_on_disk.MergeUserSetData(matching_song, !overwrite_playcount_, !overwrite_rating_);
@@ -942,7 +1028,7 @@ bool CollectionWatcher::UpdateNonCueAssociatedSong(const QString &file,
 
 }
 
-SongList CollectionWatcher::ScanNewFile(const QString &file, const QString &path, const QString &fingerprint, const QString &matching_cue, QSet<QString> *cues_processed) const {
+SongList CollectionWatcher::ScanNewFile(const QString &file, const QString &path, const QString &fingerprint, const QString &matching_cue, const ScanFileResults &scan_file_results, QSet<QString> *cues_processed) const {
 
   SongList songs;
 
@@ -969,7 +1055,6 @@ SongList CollectionWatcher::ScanNewFile(const QString &file, const QString &path
     songs.reserve(cue_songs.count());
     for (Song &cue_song : cue_songs) {
       cue_song.set_source(source_);
-      PerformEBUR128Analysis(cue_song);
       cue_song.set_fingerprint(fingerprint);
       if (cue_song.url().toLocalFile().normalized(QString::NormalizationForm_D) == file_nfd) {
         songs << cue_song;
@@ -981,10 +1066,9 @@ SongList CollectionWatcher::ScanNewFile(const QString &file, const QString &path
   }
   else {  // It's a normal media file
     Song song(source_);
-    const TagReaderResult result = tagreader_client_->ReadFileBlocking(file, &song);
+    const TagReaderResult result = ReadFileForScan(file, scan_file_results, &song);
     if (result.success() && song.is_valid()) {
       song.set_source(source_);
-      PerformEBUR128Analysis(song);
       song.set_fingerprint(fingerprint);
       songs << song;
     }
@@ -994,6 +1078,135 @@ SongList CollectionWatcher::ScanNewFile(const QString &file, const QString &path
 
 }
 
+bool CollectionWatcher::FileNeedsTagRead(const QString &file, const ScanFileInfos &file_infos, const SongList &songs_in_db, ScanTransaction *t) const {
+
+  // CUE sheets are parsed on the scan thread.
+  const QString cue = FindCueFilename(file, file_infos);
+  if (!cue.isEmpty() && GetMtimeForCue(cue, file_infos) != 0) return false;
+
+  SongList matching_songs;
+  if (!FindSongsByPath(songs_in_db, file, &matching_songs)) return true;
+
+  const Song &matching_song = matching_songs.first();
+  if (t->ignores_mtime() || matching_song.has_cue()) return true;
+
+  const ScanFileInfo file_info = file_infos.value(file);
+  if (matching_song.mtime() != file_info.mtime || (matching_song.filesize() > 0 && matching_song.filesize() != file_info.size)) return true;
+
+#ifdef HAVE_SONGFINGERPRINTING
+  if (song_tracking_ && matching_song.fingerprint().isEmpty()) return true;
+#endif
+
+#ifdef HAVE_EBUR128
+  if (song_ebur128_loudness_analysis_ && (!matching_song.ebur128_integrated_loudness_lufs() || !matching_song.ebur128_loudness_range_lu())) return true;
+#endif
+
+  return false;
+
+}
+
+CollectionWatcher::ScanFileResults CollectionWatcher::ReadFilesParallel(const QStringList &files, const SongList &songs_in_db, const int threads) {
+
+  if (scan_thread_pool_->maxThreadCount() < threads) {
+    scan_thread_pool_->setMaxThreadCount(threads);
+  }
+
+  // Split the files into as many chunks as there are threads, so no more than the given number of threads are busy for this filesystem.
+  const qint64 chunk_size = (files.count() + threads - 1) / threads;
+  QList<QStringList> chunks;
+  for (qint64 i = 0; i < files.count(); i += chunk_size) {
+    chunks << files.mid(i, chunk_size);
+  }
+
+  QFuture<ScanFileResults> future = QtConcurrent::mapped(scan_thread_pool_, chunks, [this, &songs_in_db](const QStringList &chunk) {
+    BackgroundIOThrottle::SetCurrentThreadIdle();
+    ScanFileResults results;
+    for (const QString &file : chunk) {
+      if (stop_or_abort_requested()) break;
+      BackgroundIOThrottle::Instance()->Acquire(kTagReadBytes);
+      ScanFileResult &scan_file_result = results[file];
+      scan_file_result.song = Song(source_);
+      SongList matching_songs;
+      if (FindSongsByPath(songs_in_db, file, &matching_songs)) {
+        SetAudioPropertiesForScan(matching_songs.first(), &scan_file_result.song);
+      }
+      scan_file_result.result = tagreader_client_->ReadFileBlocking(file, &scan_file_result.song, TagReaderReadProfile::Scan);
+      if (scan_file_result.result.success() && scan_file_result.song.is_valid()) {
+        scan_file_result.song.set_source(source_);
+      }
+      scan_file_result.fingerprint = CreateFingerprint(file);
+    }
+    return results;
+  });
+  future.waitForFinished();
+
+  ScanFileResults scan_file_results;
+  scan_file_results.reserve(files.count());
+  const QList<ScanFileResults> chunk_results = future.results();
+  for (const ScanFileResults &chunk_result : chunk_results) {
+    scan_file_results.insert(chunk_result);
+  }
+
+  return scan_file_results;
+
+}
+
+TagReaderResult CollectionWatcher::ReadFileForScan(const QString &file, const ScanFileResults &scan_file_results, Song *song) const {
+
+  const ScanFileResults::const_iterator it = scan_file_results.constFind(file);
+  if (it != scan_file_results.constEnd()) {
+    *song = it->song;
+    return it->result;
+  }
+
+  BackgroundIOThrottle::Instance()->Acquire(kTagReadBytes);
+
+  return tagreader_client_->ReadFileBlocking(file, song, TagReaderReadProfile::Scan);
+
+}
+
+void CollectionWatcher::SetAudioPropertiesForScan(const Song &matching_song, Song *song) {
+
+  // The length of a CUE section is not the length of the file.
+  if (matching_song.has_cue()) return;
+
+  song->set_filesize(matching_song.filesize());
+  song->set_mtime(matching_song.mtime());
+  song->set_length_nanosec(matching_song.length_nanosec());
+  song->set_bitrate(matching_song.bitrate());
+  song->set_samplerate(matching_song.samplerate());
+  song->set_bitdepth(matching_song.bitdepth());
+
+}
+
+int CollectionWatcher::ScanThreadsForFileSystem(const QByteArray &filesystem_type) const {
+
+  const int threads = kNetworkFileSystems.contains(filesystem_type) ? scan_threads_network_ : scan_threads_;
+
+  return threads > 0 ? threads : QThread::idealThreadCount();
+
+}
+
+QString CollectionWatcher::CreateFingerprint(const QString &file) const {
+
+  QString fingerprint;
+#ifdef HAVE_SONGFINGERPRINTING
+  if (song_tracking_) {
+    BackgroundIOThrottle::Instance()->Acquire(QFileInfo(file).size());
+    Chromaprinter chromaprinter(file);
+    fingerprint = chromaprinter.CreateFingerprint();
+    if (fingerprint.isEmpty()) {
+      fingerprint = "NONE"_L1;
+    }
+  }
+#else
+  Q_UNUSED(file)
+#endif
+
+  return fingerprint;
+
+}
+
 void CollectionWatcher::AddChangedSong(const QString &file, const Song &matching_song, const Song &new_song, ScanTransaction *t) {
 
   bool notify_new = false;
@@ -1077,18 +1290,39 @@ void CollectionWatcher::AddChangedSong(const QString &file, const Song &matching
 
 }
 
-void CollectionWatcher::PerformEBUR128Analysis(Song &song) const {
+void CollectionWatcher::PerformEBUR128Analysis(SongList &songs) const {
 
   if (!song_ebur128_loudness_analysis_) return;
 
 #ifdef HAVE_EBUR128
-  std::optional<EBUR128Measures> loudness_characteristics = EBUR128Analysis::Compute(song);
-  if (loudness_characteristics) {
-    song.set_ebur128_integrated_loudness_lufs(loudness_characteristics->loudness_lufs);
-    song.set_ebur128_loudness_range_lu(loudness_characteristics->range_lu);
+  QList<Song*> pending_songs;
+  for (Song &song : songs) {
+    if (!song.ebur128_integrated_loudness_lufs() || !song.ebur128_loudness_range_lu()) {
+      pending_songs << &song;
+    }
   }
+  if (pending_songs.isEmpty()) return;
+
+  const int task_id = task_manager_->StartTask(tr("Analyzing EBU R 128 loudness"));
+  const quint64 progress_max = static_cast<quint64>(pending_songs.count());
+  std::atomic<quint64> progress(0);
+
+  // Decoding for loudness analysis is CPU bound, so it runs in the shared analysis lane instead of the per-filesystem scan threads.
+  QtConcurrent::blockingMap(TaskExecutor::Pool(TaskExecutor::Lane::CPUAnalysis), pending_songs, [this, task_id, progress_max, &progress](Song *song) {
+    if (stop_or_abort_requested()) return;
+    BackgroundIOThrottle::SetCurrentThreadIdle();
+    BackgroundIOThrottle::Instance()->Acquire(song->filesize());
+    const std::optional<EBUR128Measures> loudness_characteristics = EBUR128Analysis::Compute(*song);
+    if (loudness_characteristics) {
+      song->set_ebur128_integrated_loudness_lufs(loudness_characteristics->loudness_lufs);
+      song->set_ebur128_loudness_range_lu(loudness_characteristics->range_lu);
+    }
+    task_manager_->SetTaskProgress(task_id, ++progress, progress_max);
+  });
+
+  task_manager_->SetTaskFinished(task_id);
 #else
-  Q_UNUSED(song)
+  Q_UNUSED(songs)
 #endif
 
 }
@@ -1110,6 +1344,31 @@ quint64 CollectionWatcher::GetMtimeForCue(const QString &cue_path) {
 
 }
 
+quint64 CollectionWatcher::GetMtimeForCue(const QString &cue_path, const ScanFileInfos &file_infos) {
+
+  const ScanFileInfos::const_iterator it = file_infos.constFind(cue_path);
+  if (it != file_infos.constEnd()) {
+    return static_cast<quint64>(it->mtime);
+  }
+
+  return GetMtimeForCue(cue_path);
+
+}
+
+QString CollectionWatcher::FindCueFilename(const QString &filename, const ScanFileInfos &file_infos) {
+
+  // Same candidates as CueParser::FindCueFilename, but looked up in the directory listing instead of on disk.
+  const QStringList cue_files = QStringList() << filename + u".cue"_s
+                                              << filename.section(u'.', 0, -2) + u".cue"_s;
+
+  for (const QString &cue_file : cue_files) {
+    if (file_infos.contains(cue_file)) return cue_file;
+  }
+
+  return QString();
+
+}
+
 void CollectionWatcher::AddWatch(const CollectionDirectory &dir, const QString &path) {
 
   if (!QFile::exists(path)) return;
@@ -1143,6 +1402,58 @@ void CollectionWatcher::RemoveDirectory(const CollectionDirectory &dir) {
     subdir_mapping_.remove(subdir_path);
   }
 
+  for (QHash<QString, quint64>::iterator it = subdir_files_count_.begin(); it != subdir_files_count_.end();) {
+    if (it.key() == dir.path || it.key().startsWith(dir.path + u'/')) {
+      it = subdir_files_count_.erase(it);
+    }
+    else {
+      ++it;
+    }
+  }
+
+}
+
+void CollectionWatcher::ReadLrcFiles(const QStringList &lrc_files, const SongList &songs_in_db, const SongList &new_songs) {
+
+  if (lrc_files.isEmpty()) return;
+
+  SongList songs;
+  QStringList lrc_data;
+  for (const QString &lrc_file : lrc_files) {
+
+    // The LRC file belongs to the song with the same filename, prefer the tags that were just read.
+    const QString filename = NoExtensionPart(lrc_file);
+    SongList matching_songs;
+    for (const SongList &song_list : {new_songs, songs_in_db}) {
+      for (const Song &song : song_list) {
+        if (!song.has_cue() && NoExtensionPart(song.url().toLocalFile()) == filename) {
+          matching_songs << song;
+        }
+      }
+      if (!matching_songs.isEmpty()) break;
+    }
+    if (matching_songs.isEmpty()) continue;
+
+    QFile file(lrc_file);
+    if (file.size() > kMaxLrcFileSize) continue;
+    if (!file.open(QIODevice::ReadOnly)) {
+      qLog(Error) << "Could not open LRC file" << lrc_file << file.errorString();
+      continue;
+    }
+    const QString data = QString::fromUtf8(file.readAll());
+    file.close();
+
+    for (const Song &song : std::as_const(matching_songs)) {
+      songs << song;
+      lrc_data << data;
+    }
+
+  }
+
+  if (!songs.isEmpty()) {
+    Q_EMIT LrcFilesFound(songs, lrc_data);
+  }
+
 }
 
 bool CollectionWatcher::FindSongsByPath(const SongList &songs, const QString &path, SongList *out) {
@@ -1218,7 +1529,7 @@ void CollectionWatcher::RescanPathsNow() {
 
     QMap<QString, quint64> subdir_files_count;
     for (const QString &path : paths) {
-      const quint64 files_count = FilesCountForPath(&transaction, path);
+      const quint64 files_count = FilesCountEstimateForPath(&transaction, path);
       subdir_files_count[path] = files_count;
       transaction.AddToProgressMax(files_count);
     }
@@ -1342,6 +1653,24 @@ void CollectionWatcher::IncrementalScanCheck() {
 
 }
 
+void CollectionWatcher::SetHeadless() {
+
+  headless_ = true;
+  ReloadSettings();
+
+}
+
+void CollectionWatcher::ScanNow(const bool full_scan) {
+
+  if (full_scan) {
+    FullScanNow();
+  }
+  else {
+    IncrementalScanNow();
+  }
+
+}
+
 void CollectionWatcher::IncrementalScanNow() { PerformScan(true, false); }
 
 void CollectionWatcher::FullScanNow() { PerformScan(false, true); }
@@ -1350,6 +1679,9 @@ void CollectionWatcher::PerformScan(const bool incremental, const bool ignore_mt
 
   CancelStop();
 
+  // Network and automounted filesystems can come and go without the device listers noticing.
+  mount_points_dirty_ = true;
+
   for (const CollectionDirectory &dir : std::as_const(watched_dirs_)) {
 
     if (stop_or_abort_requested()) break;
@@ -1368,7 +1700,7 @@ void CollectionWatcher::PerformScan(const bool incremental, const bool ignore_mt
     }
 
     QMap<QString, quint64> subdir_files_count;
-    quint64 files_count = FilesCountForSubdirs(&transaction, subdirs, subdir_files_count);
+    const quint64 files_count = FilesCountEstimateForSubdirs(&transaction, subdirs, subdir_files_count);
     transaction.AddToProgressMax(files_count);
 
     for (const CollectionSubdirectory &subdir : std::as_const(subdirs)) {
@@ -1384,80 +1716,74 @@ void CollectionWatcher::PerformScan(const bool incremental, const bool ignore_mt
 
 }
 
-quint64 CollectionWatcher::FilesCountForPath(ScanTransaction *t, const QString &path) {
+quint64 CollectionWatcher::FilesCountEstimateForPath(ScanTransaction *t, const QString &path) {
 
-  const QFileInfo path_info(path);
-  if (path_info.isSymLink()) {
-    const QString real_path = path_info.symLinkTarget();
-    const QStorageInfo storage_info(real_path);
-    if (kRejectedFileSystems.contains(storage_info.fileSystemType())) {
-      return 0;
-    }
-    for (const CollectionDirectory &dir : std::as_const(watched_dirs_)) {
-      if (real_path.startsWith(dir.path)) {
-        return 0;
-      }
-    }
-  }
-  else {
-    const QStorageInfo storage_info(path);
-    if (kRejectedFileSystems.contains(storage_info.fileSystemType())) {
-      return 0;
-    }
+  const QHash<QString, quint64>::const_iterator it = subdir_files_count_.constFind(path);
+  if (it != subdir_files_count_.constEnd()) {
+    return *it;
   }
 
-  quint64 i = 0;
-  QDirIterator it(path, QDir::Dirs | QDir::Files | QDir::NoDotAndDotDot);
-  while (it.hasNext()) {
+  return static_cast<quint64>(t->FindSongsInSubdirectory(path).count());
 
-    if (stop_or_abort_requested()) break;
+}
 
-    const QString child_filepath = it.next();
-    const QFileInfo child_fileinfo(child_filepath);
+quint64 CollectionWatcher::FilesCountEstimateForSubdirs(ScanTransaction *t, const CollectionSubdirectoryList &subdirs, QMap<QString, quint64> &subdir_files_count) {
 
-    if (child_fileinfo.isDir()) {
-      if (child_fileinfo.isSymLink()) {
+  quint64 i = 0;
+  for (const CollectionSubdirectory &subdir : subdirs) {
+    const quint64 files_count = FilesCountEstimateForPath(t, subdir.path);
+    subdir_files_count[subdir.path] = files_count;
+    i += files_count;
+  }
 
-        const QString real_path = child_fileinfo.symLinkTarget();
+  return i;
 
-        QStorageInfo storage_info(real_path);
-        if (kRejectedFileSystems.contains(storage_info.fileSystemType())) {
-          continue;
-        }
+}
 
-        for (const CollectionDirectory &dir : std::as_const(watched_dirs_)) {
-          if (real_path.startsWith(dir.path)) {
-            continue;
-          }
-        }
-      }
+void CollectionWatcher::RefreshMountPointsAsync() {
 
-      if (!t->HasSeenSubdir(child_filepath) && !child_fileinfo.isHidden()) {
-        // We haven't seen this subdirectory before, so we need to include the file count for this directory too.
-        i += FilesCountForPath(t, child_filepath);
-      }
+  QMetaObject::invokeMethod(this, &CollectionWatcher::RefreshMountPoints, Qt::QueuedConnection);
 
-    }
+}
 
-    ++i;
+void CollectionWatcher::RefreshMountPoints() {
 
+  mount_points_.clear();
+
+  const QList<QStorageInfo> volumes = QStorageInfo::mountedVolumes();
+  for (const QStorageInfo &volume : volumes) {
+    MountPoint mount_point;
+    mount_point.path = volume.rootPath();
+    if (!mount_point.path.endsWith(u'/')) mount_point.path.append(u'/');
+    mount_point.filesystem_type = volume.fileSystemType();
+    mount_points_ << mount_point;
   }
 
-  return i;
+  // Longest path first, so the first prefix match is the innermost mount point.
+  std::stable_sort(mount_points_.begin(), mount_points_.end(), [](const MountPoint &a, const MountPoint &b) { return a.path.length() > b.path.length(); });
+
+  mount_points_dirty_ = false;
 
 }
 
-quint64 CollectionWatcher::FilesCountForSubdirs(ScanTransaction *t, const CollectionSubdirectoryList &subdirs, QMap<QString, quint64> &subdir_files_count) {
+QByteArray CollectionWatcher::FileSystemType(const QString &path) {
 
-  quint64 i = 0;
-  for (const CollectionSubdirectory &subdir : subdirs) {
-    if (stop_or_abort_requested()) break;
-    const quint64 files_count = FilesCountForPath(t, subdir.path);
-    subdir_files_count[subdir.path] = files_count;
-    i += files_count;
+  if (mount_points_dirty_) {
+    RefreshMountPoints();
   }
 
-  return i;
+  // Resolve symbolic links in the parent directories, they can point to a different filesystem.
+  QString canonical_path = QFileInfo(path).canonicalFilePath();
+  if (canonical_path.isEmpty()) canonical_path = path;
+  if (!canonical_path.endsWith(u'/')) canonical_path.append(u'/');
+
+  for (const MountPoint &mount_point : std::as_const(mount_points_)) {
+    if (canonical_path.startsWith(mount_point.path)) {
+      return mount_point.filesystem_type;
+    }
+  }
+
+  return QStorageInfo(path).fileSystemType();
 
 }
 
@@ -1484,7 +1810,8 @@ void CollectionWatcher::RescanSongs(const SongList &songs) {
       if (stop_or_abort_requested()) break;
       if (subdir.path != song_path) continue;
       qLog(Debug) << "Rescan for directory ID" << song.directory_id() << "directory" << subdir.path;
-      const quint64 files_count = FilesCountForPath(&transaction, subdir.path);
+      const quint64 files_count = FilesCountEstimateForPath(&transaction, subdir.path);
+      transaction.AddToProgressMax(files_count);
       ScanSubdirectory(dir, song_path, subdir, files_count, &transaction);
       scanned_paths << subdir.path;
     }
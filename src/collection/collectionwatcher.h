@@ -27,6 +27,7 @@
 #include <QtGlobal>
 #include <QObject>
 #include <QHash>
+#include <QList>
 #include <QMap>
 #include <QMultiMap>
 #include <QSet>
@@ -34,12 +35,16 @@
 #include <QStringList>
 #include <QUrl>
 #include <QMutex>
+#include <QByteArray>
 
 #include "collectiondirectory.h"
 #include "includes/shared_ptr.h"
 #include "core/song.h"
+#include "core/songbatch.h"
+#include "tagreader/tagreaderresult.h"
 
 class QThread;
+class QThreadPool;
 class QTimer;
 
 class TaskManager;
@@ -77,10 +82,17 @@ class CollectionWatcher : public QObject {
 
   void RescanSongsAsync(const SongList &songs);
 
+  // Reloads the cached mount table used for the filesystem type checks, call this when a device has been mounted or unmounted.
+  void RefreshMountPointsAsync();
+
+  // Used by the headless collection scanner, the directories are neither scanned on startup nor monitored, only scanned with ScanNow() in the calling thread.
+  void SetHeadless();
+  void ScanNow(const bool full_scan);
+
  Q_SIGNALS:
-  void NewOrUpdatedSongs(const SongList &songs);
-  void SongsMTimeUpdated(const SongList &songs);
-  void SongsDeleted(const SongList &songs);
+  void NewOrUpdatedSongs(const SongBatch &songs);
+  void SongsMTimeUpdated(const SongBatch &songs);
+  void SongsDeleted(const SongBatch &songs);
   void SongsUnavailable(const SongList &songs, const bool unavailable = true);
   void SongsReadded(const SongList &songs, const bool unavailable = false);
   void SubdirsDiscovered(const CollectionSubdirectoryList &subdirs);
@@ -88,6 +100,8 @@ class CollectionWatcher : public QObject {
   void SubdirsDeleted(const CollectionSubdirectoryList &subdirs);
   void CompilationsNeedUpdating();
   void UpdateLastSeen(const int directory_id, const int expire_unavailable_songs_days);
+  // Sidecar LRC files found next to songs, lrc_data[i] belongs to songs[i].
+  void LrcFilesFound(const SongList &songs, const QStringList &lrc_data);
   void ExitFinished();
 
   void ScanStarted(const int task_id);
@@ -119,10 +133,15 @@ class CollectionWatcher : public QObject {
 
     void AddToProgress(const quint64 n = 1);
     void AddToProgressMax(const quint64 n);
+    // Replaces the estimated number of files for a subdirectory in the progress maximum with the number found on disk.
+    void CorrectProgressMax(const quint64 files_count_estimate, const quint64 files_count);
 
     // Emits the signals for new & deleted songs etc and clears the lists. This causes the new stuff to be updated on UI.
     void CommitNewOrUpdatedSongs();
 
+    // Emits the new and touched songs early once enough of them have built up, so large scans don't hold every song until the transaction ends.
+    void CommitNewOrUpdatedSongsBatch();
+
     int dir_id() const { return dir_id_; }
     bool is_incremental() const { return incremental_; }
     bool ignores_mtime() const { return ignores_mtime_; }
@@ -172,6 +191,22 @@ class CollectionWatcher : public QObject {
     bool known_subdirs_dirty_;
   };
 
+  // Song, fingerprint and loudness characteristics read by one of the scan worker threads.
+  struct ScanFileResult {
+    TagReaderResult result;
+    Song song;
+    QString fingerprint;
+  };
+  using ScanFileResults = QHash<QString, ScanFileResult>;
+
+  // Size and modification time of the files in a subdirectory from the directory listing, so each file is only stat'ed once per scan.
+  struct ScanFileInfo {
+    ScanFileInfo() : size(-1), mtime(0) {}
+    qint64 size;
+    qint64 mtime;
+  };
+  using ScanFileInfos = QHash<QString, ScanFileInfo>;
+
  private Q_SLOTS:
   void ReloadSettings();
   void Exit();
@@ -182,6 +217,7 @@ class CollectionWatcher : public QObject {
   void RescanPathsNow();
   void ScanSubdirectory(const CollectionDirectory &dir, const QString &path, const CollectionSubdirectory &subdir, const quint64 files_count, CollectionWatcher::ScanTransaction *t, const bool force_noincremental = false);
   void RescanSongs(const SongList &songs);
+  void RefreshMountPoints();
 
  private:
   bool stop_requested() const;
@@ -195,27 +231,47 @@ class CollectionWatcher : public QObject {
   inline static QString DirectoryPart(const QString &fileName);
   QString PickBestArt(const QStringList &art_automatic_list);
   QUrl ArtForSong(const QString &path, QMap<QString, QStringList> &art_automatic_list);
+  void ReadLrcFiles(const QStringList &lrc_files, const SongList &songs_in_db, const SongList &new_songs);
   void AddWatch(const CollectionDirectory &dir, const QString &path);
   void RemoveWatch(const CollectionDirectory &dir, const CollectionSubdirectory &subdir);
   static quint64 GetMtimeForCue(const QString &cue_path);
+  static quint64 GetMtimeForCue(const QString &cue_path, const ScanFileInfos &file_infos);
   void PerformScan(const bool incremental, const bool ignore_mtimes);
 
   // Updates the sections of a cue associated and altered (according to mtime) media file during a scan.
   void UpdateCueAssociatedSongs(const QString &file, const QString &path, const QString &fingerprint, const QString &matching_cue, const QUrl &art_automatic, const SongList &old_cue_songs, ScanTransaction *t) const;
   // Updates a single non-cue associated and altered (according to mtime) song during a scan.
-  bool UpdateNonCueAssociatedSong(const QString &file, const QString &fingerprint, const SongList &matching_songs, const QUrl &art_automatic, const bool cue_deleted, ScanTransaction *t);
+  bool UpdateNonCueAssociatedSong(const QString &file, const QString &fingerprint, const SongList &matching_songs, const QUrl &art_automatic, const bool cue_deleted, const ScanFileResults &scan_file_results, ScanTransaction *t);
   // Scans a single media file that's present on the disk but not yet in the collection.
   // It may result in a multiple files added to the collection when the media file has many sections (like a CUE related media file).
-  SongList ScanNewFile(const QString &file, const QString &path, const QString &fingerprint, const QString &matching_cue, QSet<QString> *cues_processed) const;
+  SongList ScanNewFile(const QString &file, const QString &path, const QString &fingerprint, const QString &matching_cue, const ScanFileResults &scan_file_results, QSet<QString> *cues_processed) const;
+
+  // Returns true if the file will have its tags read during the scan, so it can be read ahead on the scan thread pool.
+  bool FileNeedsTagRead(const QString &file, const ScanFileInfos &file_infos, const SongList &songs_in_db, ScanTransaction *t) const;
+  // Reads tags and fingerprint for the files in parallel using the given number of threads.
+  ScanFileResults ReadFilesParallel(const QStringList &files, const SongList &songs_in_db, const int threads);
+  // Reads a single song, using the result from the scan worker threads if the file was read ahead.
+  TagReaderResult ReadFileForScan(const QString &file, const ScanFileResults &scan_file_results, Song *song) const;
+  // Copies the audio properties from the database, so the tag reader does not calculate them again if the file is unchanged.
+  static void SetAudioPropertiesForScan(const Song &matching_song, Song *song);
+  int ScanThreadsForFileSystem(const QByteArray &filesystem_type) const;
+
+  QString CreateFingerprint(const QString &file) const;
+
+  // Looks up the filesystem type in the cached mount table instead of parsing the mount table for each path.
+  QByteArray FileSystemType(const QString &path);
 
   static void AddChangedSong(const QString &file, const Song &matching_song, const Song &new_song, ScanTransaction *t);
 
-  void PerformEBUR128Analysis(Song &song) const;
+  // Analyses the songs missing EBU R 128 loudness characteristics in parallel on the loudness thread pool, before they're sent to the backend.
+  void PerformEBUR128Analysis(SongList &songs) const;
 
-  quint64 FilesCountForPath(ScanTransaction *t, const QString &path);
-  quint64 FilesCountForSubdirs(ScanTransaction *t, const CollectionSubdirectoryList &subdirs, QMap<QString, quint64> &subdir_files_count);
+  // Estimates the number of files in a subdirectory for the scan progress without walking it,
+  // from the count of the previous scan, or the number of songs in the collection before the first scan.
+  quint64 FilesCountEstimateForPath(ScanTransaction *t, const QString &path);
+  quint64 FilesCountEstimateForSubdirs(ScanTransaction *t, const CollectionSubdirectoryList &subdirs, QMap<QString, quint64> &subdir_files_count);
 
-  QString FindCueFilename(const QString &filename);
+  static QString FindCueFilename(const QString &filename, const ScanFileInfos &file_infos);
 
  private:
   const Song::Source source_;
@@ -242,6 +298,10 @@ class CollectionWatcher : public QObject {
   int expire_unavailable_songs_days_;
   bool overwrite_playcount_;
   bool overwrite_rating_;
+  int scan_threads_;
+  int scan_threads_network_;
+
+  QThreadPool *scan_thread_pool_;
 
   mutable QMutex mutex_stop_;
   bool stop_requested_;
@@ -259,9 +319,20 @@ class CollectionWatcher : public QObject {
 
   CueParser *cue_parser_;
 
+  struct MountPoint {
+    QString path;
+    QByteArray filesystem_type;
+  };
+  QList<MountPoint> mount_points_;
+  bool mount_points_dirty_;
+
+  // Number of files and directories found directly in each subdirectory during the last scan.
+  QHash<QString, quint64> subdir_files_count_;
+
   static QStringList sValidImages;
 
   qint64 last_scan_time_;
+  bool headless_;
 };
 
 inline QString CollectionWatcher::NoExtensionPart(const QString &fileName) {
@@ -0,0 +1,149 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "config.h"
+
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <utility>
+
+#include <QtGlobal>
+#include <QtAlgorithms>
+#include <QList>
+#include <QSet>
+#include <QString>
+#include <QByteArray>
+
+#ifdef HAVE_CHROMAPRINT
+#  include <chromaprint.h>
+#endif
+
+#include "fingerprintindex.h"
+
+namespace {
+
+constexpr int kBands = 12;
+constexpr int kRowsPerBand = 3;
+// Only the most significant bits of a sub-fingerprint are hashed, the lower bits differ more between encodings of the same recording.
+constexpr int kTermShift = 12;
+constexpr qsizetype kMinimumTerms = 16;
+// Fingerprints are compared shifted by up to about 2 seconds, to cover differences in encoder delay and leading silence.
+constexpr qsizetype kMaximumOffset = 16;
+// The aligned part must cover most of the longer fingerprint, so a song doesn't match a longer version of itself.
+constexpr double kMinimumOverlap = 0.8;
+
+quint64 Mix(quint64 value) {
+
+  // SplitMix64 finalizer.
+  value ^= value >> 30;
+  value *= 0xBF58476D1CE4E5B9ULL;
+  value ^= value >> 27;
+  value *= 0x94D049BB133111EBULL;
+  value ^= value >> 31;
+  return value;
+
+}
+
+}  // namespace
+
+namespace FingerprintIndex {
+
+RawFingerprint Decode(const QString &fingerprint) {
+
+#ifdef HAVE_CHROMAPRINT
+
+  if (fingerprint.isEmpty()) return RawFingerprint();
+
+  const QByteArray encoded = fingerprint.toLatin1();
+  quint32 *raw = nullptr;
+  int size = 0;
+  int algorithm = 0;
+  if (chromaprint_decode_fingerprint(encoded.constData(), static_cast<int>(encoded.size()), &raw, &size, &algorithm, 1) != 1) {
+    return RawFingerprint();
+  }
+
+  RawFingerprint ret(raw, raw + size);
+  chromaprint_dealloc(raw);
+
+  return ret;
+
+#else
+
+  Q_UNUSED(fingerprint)
+  return RawFingerprint();
+
+#endif
+
+}
+
+QList<qint64> Bands(const RawFingerprint &fingerprint) {
+
+  QSet<quint32> terms;
+  terms.reserve(fingerprint.count());
+  for (const quint32 value : fingerprint) {
+    terms.insert(value >> kTermShift);
+  }
+  if (terms.count() < kMinimumTerms) return QList<qint64>();
+
+  std::array<quint64, kBands * kRowsPerBand> minimums;
+  minimums.fill(std::numeric_limits<quint64>::max());
+  for (const quint32 term : std::as_const(terms)) {
+    for (int i = 0; i < static_cast<int>(minimums.size()); ++i) {
+      minimums[i] = std::min(minimums[i], Mix(term ^ (static_cast<quint64>(i + 1) * 0x9E3779B97F4A7C15ULL)));
+    }
+  }
+
+  QList<qint64> bands;
+  bands.reserve(kBands);
+  for (int band = 0; band < kBands; ++band) {
+    quint64 hash = static_cast<quint64>(band);
+    for (int row = 0; row < kRowsPerBand; ++row) {
+      hash = Mix(hash ^ minimums[band * kRowsPerBand + row]);
+    }
+    bands << static_cast<qint64>(hash);
+  }
+
+  return bands;
+
+}
+
+double Similarity(const RawFingerprint &fingerprint1, const RawFingerprint &fingerprint2) {
+
+  const qsizetype longest = std::max(fingerprint1.count(), fingerprint2.count());
+  if (fingerprint1.isEmpty() || fingerprint2.isEmpty()) return 0.0;
+
+  double best = 0.0;
+  for (qsizetype offset = -kMaximumOffset; offset <= kMaximumOffset; ++offset) {
+    const qsizetype begin1 = std::max(static_cast<qsizetype>(0), offset);
+    const qsizetype begin2 = std::max(static_cast<qsizetype>(0), -offset);
+    const qsizetype overlap = std::min(fingerprint1.count() - begin1, fingerprint2.count() - begin2);
+    if (overlap <= 0 || static_cast<double>(overlap) < static_cast<double>(longest) * kMinimumOverlap) continue;
+    qint64 errors = 0;
+    for (qsizetype i = 0; i < overlap; ++i) {
+      errors += qPopulationCount(fingerprint1[begin1 + i] ^ fingerprint2[begin2 + i]);
+    }
+    best = std::max(best, 1.0 - (static_cast<double>(errors) / static_cast<double>(overlap * 32)));
+  }
+
+  return best;
+
+}
+
+}  // namespace FingerprintIndex
@@ -0,0 +1,50 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef FINGERPRINTINDEX_H
+#define FINGERPRINTINDEX_H
+
+#include "config.h"
+
+#include <QtGlobal>
+#include <QList>
+#include <QString>
+
+// Near duplicate lookup for the Chromaprint fingerprints of the songs.
+// A fingerprint is hashed into a few bands using MinHash over its sub-fingerprints, two fingerprints of the same recording share at least one band with a high probability.
+// The bands are stored in the database, so candidates are found with an indexed join instead of comparing every pair of songs, and only the candidates are compared bit by bit.
+namespace FingerprintIndex {
+
+using RawFingerprint = QList<quint32>;
+
+// Fraction of equal bits from which two fingerprints are considered the same recording.
+constexpr double kDuplicateSimilarity = 0.85;
+
+// Decodes a fingerprint created by Chromaprinter, empty if it can't be decoded.
+RawFingerprint Decode(const QString &fingerprint);
+
+// Returns the band hashes of the fingerprint, empty if it is too short to be compared.
+QList<qint64> Bands(const RawFingerprint &fingerprint);
+
+// Returns the fraction of equal bits at the best alignment of the fingerprints, 0.5 is unrelated audio.
+double Similarity(const RawFingerprint &fingerprint1, const RawFingerprint &fingerprint2);
+
+}  // namespace FingerprintIndex
+
+#endif  // FINGERPRINTINDEX_H
@@ -35,6 +35,8 @@ constexpr char kDeviceU[] = "Device";
 constexpr char kALSAPlugin[] = "alsaplugin";
 constexpr char kPlaybin3[] = "playbin3";
 constexpr char kExclusiveMode[] = "exclusive_mode";
+constexpr char kLowLatency[] = "low_latency";
+constexpr char kLowPowerMode[] = "low_power_mode";
 constexpr char kVolumeControl[] = "volume_control";
 constexpr char kChannelsEnabled[] = "channels_enabled";
 constexpr char kChannels[] = "channels";
@@ -44,11 +46,14 @@ constexpr char kStrictSSL[] = "strict_ssl";
 constexpr char kBufferDuration[] = "bufferduration";
 constexpr char kBufferLowWatermark[] = "bufferlowwatermark";
 constexpr char kBufferHighWatermark[] = "bufferhighwatermark";
+constexpr char kStreamCache[] = "streamcache";
+constexpr char kStreamCacheSize[] = "streamcachesize";
 constexpr char kRgEnabled[] = "rgenabled";
 constexpr char kRgMode[] = "rgmode";
 constexpr char kRgPreamp[] = "rgpreamp";
 constexpr char kRgFallbackGain[] = "rgfallbackgain";
 constexpr char kRgCompression[] = "rgcompression";
+constexpr char kRgFromLoudness[] = "rgfromloudness";
 constexpr char kEBUR128LoudnessNormalization[] = "ebur128_loudness_normalization";
 constexpr char kEBUR128TargetLevelLUFS[] = "ebur128_target_level_lufs";
 constexpr char kFadeoutEnabled[] = "FadeoutEnabled";
@@ -62,6 +67,7 @@ constexpr char kFadeoutPauseDuration[] = "FadeoutPauseDuration";
 constexpr qint64 kDefaultBufferDuration = 4000;
 constexpr double kDefaultBufferLowWatermark = 0.33;
 constexpr double kDefaultBufferHighWatermark = 0.99;
+constexpr qint64 kDefaultStreamCacheSize = 2048;
 
 }  // namespace BackendSettings
 
@@ -31,6 +31,13 @@ constexpr char kMarkSongsUnavailable[] = "mark_songs_unavailable";
 constexpr char kSongENUR128LoudnessAnalysis[] = "song_ebur128_loudness_analysis";
 constexpr char kExpireUnavailableSongs[] = "expire_unavailable_songs";
 constexpr char kCoverArtPatterns[] = "cover_art_patterns";
+constexpr char kScanThreads[] = "scan_threads";
+constexpr char kScanThreadsNetwork[] = "scan_threads_network";
+constexpr int kScanThreadsDefault = 0;
+constexpr int kScanThreadsNetworkDefault = 2;
+constexpr char kBackgroundReadLimit[] = "background_read_limit";
+constexpr char kTagReaderWorkers[] = "tagreader_workers";
+constexpr int kTagReaderWorkersDefault = 0;
 constexpr char kAutoOpen[] = "auto_open";
 constexpr char kShowDividers[] = "show_dividers";
 constexpr char kPrettyCovers[] = "pretty_covers";
@@ -38,19 +45,28 @@ constexpr char kVariousArtists[] = "various_artists";
 constexpr char kSkipArticlesForArtists[] = "skip_articles_for_artists";
 constexpr char kSkipArticlesForAlbums[] = "skip_articles_for_albums";
 constexpr char kUseSortTags[] = "use_short_tags";
+constexpr char kLazyLoading[] = "lazy_loading";
 constexpr char kSettingsCacheSize[] = "cache_size";
 constexpr char kSettingsCacheSizeUnit[] = "cache_size_unit";
 constexpr char kSettingsDiskCacheEnable[] = "disk_cache_enable";
 constexpr char kSettingsDiskCacheSize[] = "disk_cache_size";
 constexpr char kSettingsDiskCacheSizeUnit[] = "disk_cache_size_unit";
+constexpr char kSettingsDiskCacheFormat[] = "disk_cache_format";
+constexpr char kSettingsDiskCacheQuality[] = "disk_cache_quality";
 constexpr int kSettingsCacheSizeDefault = 160;
 constexpr int kSettingsDiskCacheSizeDefault = 360;
+constexpr int kSettingsDiskCacheQualityDefault = 80;
 constexpr char kSavePlayCounts[] = "save_playcounts";
 constexpr char kSaveRatings[] = "save_ratings";
 constexpr char kOverwritePlaycount[] = "overwrite_playcount";
 constexpr char kOverwriteRating[] = "overwrite_rating";
 constexpr char kDeleteFiles[] = "delete_files";
 constexpr char kLastPath[] = "last_path";
+constexpr char kServerMode[] = "server_mode";
+constexpr char kServerHost[] = "server_host";
+constexpr char kServerPort[] = "server_port";
+constexpr char kServerPassword[] = "server_password";
+constexpr int kServerPortDefault = 5590;
 
 enum class CacheSizeUnit {
   KB,
@@ -59,6 +75,13 @@ enum class CacheSizeUnit {
   TB
 };
 
+// Sharing the collection with other instances, see CollectionServer and CollectionReplica.
+enum class ServerMode {
+  Standalone,
+  Server,
+  Replica
+};
+
 }  // namespace CollectionSettings
 
 #endif  // COLLECTIONSETTINGS_H
@@ -27,5 +27,18 @@ const QByteArrayList kRejectedFileSystems = QByteArrayList() << "proc"
                                                              << "tmpfs"
                                                              << "devtmpfs";
 
+const QByteArrayList kNetworkFileSystems = QByteArrayList() << "nfs"
+                                                            << "nfs4"
+                                                            << "cifs"
+                                                            << "smb3"
+                                                            << "smbfs"
+                                                            << "afpfs"
+                                                            << "9p"
+                                                            << "davfs"
+                                                            << "fuse.sshfs"
+                                                            << "fuse.rclone"
+                                                            << "fuse.glusterfs"
+                                                            << "ceph";
+
 
 #endif  // FILESYSTEMCONSTANTS_H
@@ -37,6 +37,7 @@ constexpr char kEnabled[] = "enabled";
 constexpr char kShow[] = "show";
 constexpr char kStyle[] = "style";
 constexpr char kSave[] = "save";
+constexpr char kGenerateCollection[] = "generate_collection";
 
 }  // namespace MoodbarSettings
 
@@ -44,6 +44,8 @@ constexpr char kSelectTrack[] = "select_track";
 constexpr char kShowToolbar[] = "show_toolbar";
 constexpr char kPlaylistClear[] = "playlist_clear";
 constexpr char kAutoSort[] = "auto_sort";
+constexpr char kCurrentPlaylist[] = "current_playlist";
+constexpr char kUndoItemBudget[] = "undo_item_budget";
 
 constexpr char kPathType[] = "path_type";
 
@@ -28,6 +28,7 @@
 #include <QByteArray>
 #include <QImage>
 #include <QPixmap>
+#include <QSize>
 #include <QPalette>
 #include <QBrush>
 #include <QMovie>
@@ -64,6 +65,7 @@ ContextAlbum::ContextAlbum(QWidget *parent)
       image_strawberry_(u":/pictures/strawberry.png"_s),
       image_original_(image_strawberry_),
       pixmap_current_opacity_(1.0),
+      pixmap_transition_dirty_(true),
       desired_height_(width()) {
 
   setObjectName(u"context-widget-album"_s);
@@ -108,8 +110,13 @@ void ContextAlbum::paintEvent(QPaintEvent *paint_event) {
 
   QPainter p(this);
   p.setRenderHint(QPainter::SmoothPixmapTransform);
-  DrawPreviousCovers(&p);
-  DrawImage(&p, pixmap_current_, pixmap_current_opacity_);
+  if (previous_covers_.isEmpty() && pixmap_current_opacity_ >= 1.0) {
+    DrawImage(&p, pixmap_current_, pixmap_current_opacity_);
+  }
+  else {
+    if (pixmap_transition_dirty_) DrawTransition();
+    p.drawPixmap(0, 0, pixmap_transition_);
+  }
   DrawSpinner(&p);
   p.end();
 
@@ -205,6 +212,26 @@ void ContextAlbum::DrawSpinner(QPainter *p) {
 
 }
 
+void ContextAlbum::DrawTransition() {
+
+  const qreal device_pixel_ratio = devicePixelRatioF();
+  const QSize pixmap_size = size() * device_pixel_ratio;
+  if (pixmap_transition_.size() != pixmap_size || pixmap_transition_.devicePixelRatio() != device_pixel_ratio) {
+    pixmap_transition_ = QPixmap(pixmap_size);
+    pixmap_transition_.setDevicePixelRatio(device_pixel_ratio);
+  }
+  pixmap_transition_.fill(Qt::transparent);
+
+  QPainter p(&pixmap_transition_);
+  p.setRenderHint(QPainter::SmoothPixmapTransform);
+  DrawPreviousCovers(&p);
+  DrawImage(&p, pixmap_current_, pixmap_current_opacity_);
+  p.end();
+
+  pixmap_transition_dirty_ = false;
+
+}
+
 void ContextAlbum::DrawPreviousCovers(QPainter *p) {
 
   for (int i = 0; i < previous_covers_.count(); i++) {
@@ -219,6 +246,7 @@ void ContextAlbum::FadeCurrentCover(const qreal value) {
   if (value <= pixmap_current_opacity_) return;
 
   pixmap_current_opacity_ = value;
+  pixmap_transition_dirty_ = true;
   update();
 
 }
@@ -236,6 +264,7 @@ void ContextAlbum::FadePreviousCover(SharedPtr<PreviousCover> previous_cover) {
   if (previous_cover->timeline->currentValue() >= previous_cover->opacity) return;
 
   previous_cover->opacity = previous_cover->timeline->currentValue();
+  pixmap_transition_dirty_ = true;
 
 }
 
@@ -243,6 +272,7 @@ void ContextAlbum::FadePreviousCoverFinished(SharedPtr<PreviousCover> previous_c
 
   previous_cover->timeline.reset();
   previous_covers_.removeAll(previous_cover);
+  pixmap_transition_dirty_ = true;
 
 }
 
@@ -255,6 +285,7 @@ void ContextAlbum::ScaleCover() {
   else {
     pixmap_current_ = QPixmap::fromImage(image);
   }
+  pixmap_transition_dirty_ = true;
 
 }
 
@@ -270,6 +301,7 @@ void ContextAlbum::ScalePreviousCovers() {
       previous_cover->pixmap = QPixmap::fromImage(image);
     }
   }
+  pixmap_transition_dirty_ = true;
 
 }
 
@@ -74,6 +74,7 @@ class ContextAlbum : public QWidget {
   void DrawImage(QPainter *p, const QPixmap &pixmap, const qreal opacity);
   void DrawSpinner(QPainter *p);
   void DrawPreviousCovers(QPainter *p);
+  void DrawTransition();
   void ScaleCover();
   void ScalePreviousCovers();
 
@@ -101,6 +102,9 @@ class ContextAlbum : public QWidget {
   QImage image_original_;
   QPixmap pixmap_current_;
   qreal pixmap_current_opacity_;
+  // The covers fading in and out are composed here once per step and reused for every repaint until the next step.
+  QPixmap pixmap_transition_;
+  bool pixmap_transition_dirty_;
   ScopedPtr<QMovie> spinner_animation_;
   int desired_height_;
 };
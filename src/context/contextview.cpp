@@ -58,6 +58,7 @@
 #include "collection/collectionview.h"
 #include "covermanager/albumcoverchoicecontroller.h"
 #include "lyrics/lyricsfetcher.h"
+#include "lyrics/lyricsstore.h"
 #include "constants/contextsettings.h"
 #include "constants/timeconstants.h"
 
@@ -107,7 +108,9 @@ ContextView::ContextView(QWidget *parent)
       label_bitdepth_(new QLabel(this)),
       label_bitrate_(new QLabel(this)),
       lyrics_tried_(false),
-      lyrics_id_(-1) {
+      lyrics_id_(-1),
+      lyrics_store_tried_(false),
+      lyrics_store_id_(0) {
 
   setLayout(layout_container_);
 
@@ -220,10 +223,11 @@ ContextView::ContextView(QWidget *parent)
 
 }
 
-void ContextView::Init(CollectionView *collectionview, AlbumCoverChoiceController *album_cover_choice_controller, SharedPtr<LyricsProviders> lyrics_providers) {
+void ContextView::Init(CollectionView *collectionview, AlbumCoverChoiceController *album_cover_choice_controller, SharedPtr<LyricsProviders> lyrics_providers, SharedPtr<LyricsStore> lyrics_store) {
 
   collectionview_ = collectionview;
   album_cover_choice_controller_ = album_cover_choice_controller;
+  lyrics_store_ = lyrics_store;
 
   widget_album_->Init(this, album_cover_choice_controller_);
   lyrics_fetcher_ = new LyricsFetcher(lyrics_providers, this);
@@ -232,6 +236,7 @@ void ContextView::Init(CollectionView *collectionview, AlbumCoverChoiceControlle
   QObject::connect(collectionview_, &CollectionView::TotalArtistCountUpdated_, this, &ContextView::UpdateNoSong);
   QObject::connect(collectionview_, &CollectionView::TotalAlbumCountUpdated_, this, &ContextView::UpdateNoSong);
   QObject::connect(lyrics_fetcher_, &LyricsFetcher::LyricsFetched, this, &ContextView::UpdateLyrics);
+  QObject::connect(&*lyrics_store_, &LyricsStore::LyricsLoaded, this, &ContextView::StoredLyricsLoaded);
 
   AddActions();
 
@@ -333,8 +338,20 @@ void ContextView::Error() {}
 
 void ContextView::SongChanged(const Song &song) {
 
-  if (widget_stacked_->currentWidget() == widget_play_ && song_playing_.is_valid() && song == song_playing_ && song.title() == song_playing_.title() && song.album() == song_playing_.album() && song.artist() == song_playing_.artist()) {
-    UpdateSong(song);
+  if (widget_stacked_->currentWidget() == widget_play_ && song_playing_.is_valid() && song == song_playing_) {
+    // Same song or stream with new metadata, such as a radio title change, only update the widgets for the changed fields.
+    if (song.title() != song_playing_.title() || song.album() != song_playing_.album() || song.artist() != song_playing_.artist()) {
+      lyrics_ = song.lyrics();
+      lyrics_id_ = -1;
+      lyrics_tried_ = false;
+      lyrics_store_tried_ = false;
+      lyrics_store_id_ = 0;
+      UpdateSong(song);
+      if (ShowLyrics()) widget_stacked_->updateGeometry();
+    }
+    else {
+      UpdateSong(song);
+    }
   }
   else {
     song_prev_ = song_playing_;
@@ -342,6 +359,8 @@ void ContextView::SongChanged(const Song &song) {
     lyrics_ = song.lyrics();
     lyrics_id_ = -1;
     lyrics_tried_ = false;
+    lyrics_store_tried_ = false;
+    lyrics_store_id_ = 0;
     SetSong();
   }
 
@@ -351,6 +370,17 @@ void ContextView::SongChanged(const Song &song) {
 
 void ContextView::SearchLyrics() {
 
+  // Look in the lyrics store first, the providers are only searched if the lyrics weren't stored before.
+  if (lyrics_.isEmpty() && action_show_lyrics_->isChecked() && !song_playing_.artist().isEmpty() && !song_playing_.title().isEmpty() && !lyrics_store_tried_) {
+    lyrics_store_tried_ = true;
+    static quint64 next_lyrics_store_id = 0;
+    lyrics_store_id_ = ++next_lyrics_store_id;
+    lyrics_store_->LoadLyricsAsync(lyrics_store_id_, song_playing_);
+    return;
+  }
+
+  if (lyrics_store_id_ != 0) return;
+
   if (lyrics_.isEmpty() && action_show_lyrics_->isChecked() && action_search_lyrics_->isChecked() && !song_playing_.artist().isEmpty() && !song_playing_.title().isEmpty() && !lyrics_tried_ && lyrics_id_ == -1) {
     lyrics_fetcher_->Clear();
     lyrics_tried_ = true;
@@ -368,8 +398,8 @@ void ContextView::FadeStopFinished() {
 
 }
 
-void ContextView::SetLabelText(QLabel *label, int value, const QString &suffix, const QString &def) {
-  label->setText(value <= 0 ? def : (QString::number(value) + QLatin1Char(' ') + suffix));
+QString ContextView::LabelText(const int value, const QString &suffix) {
+  return value <= 0 ? QString() : (QString::number(value) + QLatin1Char(' ') + suffix);
 }
 
 void ContextView::UpdateNoSong() {
@@ -417,7 +447,7 @@ void ContextView::UpdateFonts() {
 void ContextView::SetSong() {
 
   textedit_top_->setFont(font_headline_);
-  textedit_top_->SetText(QStringLiteral("<b>%1</b><br />%2").arg(Utilities::ReplaceMessage(title_fmt_, song_playing_, u"<br />"_s, true), Utilities::ReplaceMessage(summary_fmt_, song_playing_, u"<br />"_s, true)));
+  bool changed = SetTopText(song_playing_);
 
   label_stop_summary_->clear();
 
@@ -433,51 +463,14 @@ void ContextView::SetSong() {
   if (widget_album_changed) Q_EMIT AlbumEnabledChanged();
 
   if (action_show_data_->isChecked()) {
-    widget_play_data_->show();
-    label_filetype_->setText(song_playing_.TextForFiletype());
-    if (song_playing_.length_nanosec() <= 0) {
-      label_length_title_->hide();
-      label_length_->hide();
-      label_length_->clear();
-    }
-    else {
-      label_length_title_->show();
-      label_length_->show();
-      label_length_->setText(Utilities::PrettyTimeNanosec(song_playing_.length_nanosec()));
-    }
-    if (song_playing_.samplerate() <= 0) {
-      label_samplerate_title_->hide();
-      label_samplerate_->hide();
-      label_samplerate_->clear();
-    }
-    else {
-      label_samplerate_title_->show();
-      label_samplerate_->show();
-      SetLabelText(label_samplerate_, song_playing_.samplerate(), u"Hz"_s);
-    }
-    if (song_playing_.bitdepth() <= 0) {
-      label_bitdepth_title_->hide();
-      label_bitdepth_->hide();
-      label_bitdepth_->clear();
-    }
-    else {
-      label_bitdepth_title_->show();
-      label_bitdepth_->show();
-      SetLabelText(label_bitdepth_, song_playing_.bitdepth(), u"Bit"_s);
-    }
-    if (song_playing_.bitrate() <= 0) {
-      label_bitrate_title_->hide();
-      label_bitrate_->hide();
-      label_bitrate_->clear();
-    }
-    else {
-      label_bitrate_title_->show();
-      label_bitrate_->show();
-      SetLabelText(label_bitrate_, song_playing_.bitrate(), tr("kbps"));
+    if (widget_play_data_->isHidden()) {
+      widget_play_data_->show();
+      spacer_play_data_->changeSize(20, 20, QSizePolicy::Fixed);
+      changed = true;
     }
-    spacer_play_data_->changeSize(20, 20, QSizePolicy::Fixed);
+    if (SetDataLabels(song_playing_)) changed = true;
   }
-  else {
+  else if (!widget_play_data_->isHidden() || !label_filetype_->text().isEmpty()) {
     widget_play_data_->hide();
     label_filetype_->clear();
     label_length_->clear();
@@ -485,84 +478,66 @@ void ContextView::SetSong() {
     label_bitdepth_->clear();
     label_bitrate_->clear();
     spacer_play_data_->changeSize(0, 0, QSizePolicy::Fixed);
+    changed = true;
   }
 
-  if (action_show_lyrics_->isChecked() && !lyrics_.isEmpty()) {
-    textedit_play_lyrics_->SetText(lyrics_);
-    textedit_play_lyrics_->show();
-  }
-  else {
-    textedit_play_lyrics_->clear();
-    textedit_play_lyrics_->hide();
+  if (ShowLyrics()) changed = true;
+
+  if (widget_stacked_->currentWidget() != widget_play_) {
+    widget_stacked_->setCurrentWidget(widget_play_);
+    changed = true;
   }
 
-  widget_stacked_->setCurrentWidget(widget_play_);
-  widget_stacked_->updateGeometry();
+  if (changed || widget_album_changed) widget_stacked_->updateGeometry();
 
 }
 
 void ContextView::UpdateSong(const Song &song) {
 
-  const QString top_text = QStringLiteral("<b>%1</b><br />%2").arg(Utilities::ReplaceMessage(title_fmt_, song, u"<br />"_s, true), Utilities::ReplaceMessage(summary_fmt_, song, u"<br />"_s, true));
-  if (top_text != textedit_top_->Text()) {
-    textedit_top_->SetText(top_text);
-  }
+  bool changed = SetTopText(song);
 
-  if (action_show_data_->isChecked()) {
-    if (song.filetype() != song_playing_.filetype()) label_filetype_->setText(song.TextForFiletype());
-    if (song.length_nanosec() != song_playing_.length_nanosec()) {
-      if (song.length_nanosec() <= 0) {
-        label_length_title_->hide();
-        label_length_->hide();
-        label_length_->clear();
-      }
-      else {
-        label_length_title_->show();
-        label_length_->show();
-        label_length_->setText(Utilities::PrettyTimeNanosec(song.length_nanosec()));
-      }
-    }
-    if (song.samplerate() != song_playing_.samplerate()) {
-      if (song.samplerate() <= 0) {
-        label_samplerate_title_->hide();
-        label_samplerate_->hide();
-        label_samplerate_->clear();
-      }
-      else {
-        label_samplerate_title_->show();
-        label_samplerate_->show();
-        SetLabelText(label_samplerate_, song.samplerate(), u"Hz"_s);
-      }
-    }
-    if (song.bitdepth() != song_playing_.bitdepth()) {
-      if (song.bitdepth() <= 0) {
-        label_bitdepth_title_->hide();
-        label_bitdepth_->hide();
-        label_bitdepth_->clear();
-      }
-      else {
-        label_bitdepth_title_->show();
-        label_bitdepth_->show();
-        SetLabelText(label_bitdepth_, song.bitdepth(), u"Bit"_s);
-      }
-    }
-    if (song.bitrate() != song_playing_.bitrate()) {
-      if (song.bitrate() <= 0) {
-        label_bitrate_title_->hide();
-        label_bitrate_->hide();
-        label_bitrate_->clear();
-      }
-      else {
-        label_bitrate_title_->show();
-        label_bitrate_->show();
-        SetLabelText(label_bitrate_, song.bitrate(), tr("kbps"));
-      }
-    }
-  }
+  if (action_show_data_->isChecked() && SetDataLabels(song)) changed = true;
 
   song_playing_ = song;
 
-  widget_stacked_->updateGeometry();
+  if (changed) widget_stacked_->updateGeometry();
+
+}
+
+bool ContextView::SetTopText(const Song &song) {
+
+  const QString top_text = QStringLiteral("<b>%1</b><br />%2").arg(Utilities::ReplaceMessage(title_fmt_, song, u"<br />"_s, true), Utilities::ReplaceMessage(summary_fmt_, song, u"<br />"_s, true));
+  if (top_text == textedit_top_->Text()) return false;
+
+  textedit_top_->SetText(top_text);
+
+  return true;
+
+}
+
+bool ContextView::SetDataLabels(const Song &song) {
+
+  bool changed = SetDataLabel(label_filetype_title_, label_filetype_, song.TextForFiletype());
+  if (SetDataLabel(label_length_title_, label_length_, song.length_nanosec() <= 0 ? QString() : Utilities::PrettyTimeNanosec(song.length_nanosec()))) changed = true;
+  if (SetDataLabel(label_samplerate_title_, label_samplerate_, LabelText(song.samplerate(), u"Hz"_s))) changed = true;
+  if (SetDataLabel(label_bitdepth_title_, label_bitdepth_, LabelText(song.bitdepth(), u"Bit"_s))) changed = true;
+  if (SetDataLabel(label_bitrate_title_, label_bitrate_, LabelText(song.bitrate(), tr("kbps")))) changed = true;
+
+  return changed;
+
+}
+
+bool ContextView::SetDataLabel(QLabel *label_title, QLabel *label, const QString &text) {
+
+  // The file type is always shown, the other rows are hidden when there is no value.
+  const bool visible = label == label_filetype_ || !text.isEmpty();
+  if (label->text() == text && label->isHidden() != visible) return false;
+
+  label->setText(text);
+  label_title->setVisible(visible);
+  label->setVisible(visible);
+
+  return true;
 
 }
 
@@ -590,18 +565,46 @@ void ContextView::UpdateLyrics(const quint64 id, const QString &provider, const
   }
   else {
     lyrics_ = lyrics + "\n\n(Lyrics from "_L1 + provider + ")\n"_L1;
+    lyrics_store_->SaveLyricsAsync(song_playing_, provider, lyrics);
   }
   lyrics_id_ = -1;
 
+  ShowLyrics();
+
+}
+
+void ContextView::StoredLyricsLoaded(const quint64 id, const QString &provider, const QString &lyrics) {
+
+  if (id != lyrics_store_id_) return;
+  lyrics_store_id_ = 0;
+
+  if (lyrics.isEmpty()) {
+    SearchLyrics();
+    return;
+  }
+
+  lyrics_tried_ = true;
+  lyrics_ = lyrics + "\n\n(Lyrics from "_L1 + provider + ")\n"_L1;
+
+  ShowLyrics();
+
+}
+
+bool ContextView::ShowLyrics() {
+
   if (action_show_lyrics_->isChecked() && !lyrics_.isEmpty()) {
+    if (lyrics_ == textedit_play_lyrics_->Text() && !textedit_play_lyrics_->isHidden()) return false;
     textedit_play_lyrics_->SetText(lyrics_);
     textedit_play_lyrics_->show();
   }
   else {
-    textedit_play_lyrics_->clear();
+    if (textedit_play_lyrics_->Text().isEmpty() && textedit_play_lyrics_->isHidden()) return false;
+    textedit_play_lyrics_->SetText(QString());
     textedit_play_lyrics_->hide();
   }
 
+  return true;
+
 }
 
 void ContextView::contextMenuEvent(QContextMenuEvent *e) {
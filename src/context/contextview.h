@@ -30,6 +30,7 @@
 #include <QImage>
 #include <QAction>
 
+#include "includes/shared_ptr.h"
 #include "core/song.h"
 #include "contextalbum.h"
 
@@ -50,6 +51,7 @@ class CollectionView;
 class AlbumCoverChoiceController;
 class LyricsProviders;
 class LyricsFetcher;
+class LyricsStore;
 
 class ContextView : public QWidget {
   Q_OBJECT
@@ -57,7 +59,7 @@ class ContextView : public QWidget {
  public:
   explicit ContextView(QWidget *parent = nullptr);
 
-  void Init(CollectionView *collectionview, AlbumCoverChoiceController *album_cover_choice_controller, SharedPtr<LyricsProviders> lyrics_providers);
+  void Init(CollectionView *collectionview, AlbumCoverChoiceController *album_cover_choice_controller, SharedPtr<LyricsProviders> lyrics_providers, SharedPtr<LyricsStore> lyrics_store);
 
   ContextAlbum *album_widget() const { return widget_album_; }
   bool album_enabled() const { return action_show_album_->isChecked(); }
@@ -71,13 +73,18 @@ class ContextView : public QWidget {
 
  private:
   void AddActions();
-  static void SetLabelText(QLabel *label, int value, const QString &suffix, const QString &def = QString());
+  static QString LabelText(const int value, const QString &suffix);
   void NoSong();
   void SetSong();
   void UpdateSong(const Song &song);
+  // These only touch the widgets when the text or visibility changes, and return true if they did.
+  bool SetTopText(const Song &song);
+  bool SetDataLabels(const Song &song);
+  bool SetDataLabel(QLabel *label_title, QLabel *label, const QString &text);
   void ResetSong();
   void GetCoverAutomatically();
   void SearchLyrics();
+  bool ShowLyrics();
   void UpdateFonts();
 
  Q_SIGNALS:
@@ -91,6 +98,7 @@ class ContextView : public QWidget {
   void UpdateNoSong();
   void FadeStopFinished();
   void UpdateLyrics(const quint64 id, const QString &provider, const QString &lyrics);
+  void StoredLyricsLoaded(const quint64 id, const QString &provider, const QString &lyrics);
 
  public Q_SLOTS:
   void ReloadSettings();
@@ -104,6 +112,7 @@ class ContextView : public QWidget {
   CollectionView *collectionview_;
   AlbumCoverChoiceController *album_cover_choice_controller_;
   LyricsFetcher *lyrics_fetcher_;
+  SharedPtr<LyricsStore> lyrics_store_;
 
   QMenu *menu_options_;
   QAction *action_show_album_;
@@ -146,6 +155,8 @@ class ContextView : public QWidget {
   QImage image_original_;
   bool lyrics_tried_;
   qint64 lyrics_id_;
+  bool lyrics_store_tried_;
+  quint64 lyrics_store_id_;
   QString lyrics_;
   QString title_fmt_;
   QString summary_fmt_;
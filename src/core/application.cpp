@@ -32,13 +32,20 @@
 
 #include <QObject>
 #include <QThread>
+#include <QList>
+#include <QMap>
 #include <QString>
 #include <QMetaObject>
 #include <QCoreApplication>
 #include <QAbstractEventDispatcher>
 #include <QTimer>
+#include <QPointer>
+#include <QFuture>
+#include <QFutureWatcher>
 
 #include "core/logging.h"
+#include "core/startuptracer.h"
+#include "core/taskexecutor.h"
 
 #include "includes/shared_ptr.h"
 #include "includes/lazy.h"
@@ -46,8 +53,11 @@
 #include "core/taskmanager.h"
 #include "core/networkaccessmanager.h"
 #include "core/player.h"
+#include "core/transportcontrol.h"
+#include "core/mainthreadwatchdog.h"
 #include "tagreader/tagreaderclient.h"
 #include "engine/devicefinders.h"
+#include "engine/gststartup.h"
 #include "core/urlhandlers.h"
 #include "device/devicemanager.h"
 #include "collection/collectionlibrary.h"
@@ -75,6 +85,7 @@
 #include "lyrics/letraslyricsprovider.h"
 #include "lyrics/lyricfindlyricsprovider.h"
 #include "lyrics/lrcliblyricsprovider.h"
+#include "lyrics/lyricsstore.h"
 
 #include "scrobbler/audioscrobbler.h"
 #include "scrobbler/lastfmscrobbler.h"
@@ -115,6 +126,7 @@
 
 using std::make_shared;
 using namespace std::chrono_literals;
+using namespace Qt::Literals::StringLiterals;
 
 class ApplicationImpl {
  public:
@@ -128,15 +140,37 @@ class ApplicationImpl {
           Database *database = new Database(app->task_manager());
           app->MoveToNewThread(database);
           QTimer::singleShot(30s, database, &Database::DoBackup);
+          QTimer::singleShot(30s, database, &Database::StartMaintenance);
           return database;
         }),
         task_manager_([]() { return new TaskManager(); }),
         player_([app]() { return new Player(app->task_manager(), app->url_handlers(), app->playlist_manager()); }),
+        main_thread_watchdog_([app]() {
+          MainThreadWatchdog *main_thread_watchdog = new MainThreadWatchdog();
+          app->MoveToNewThread(main_thread_watchdog);
+          QMetaObject::invokeMethod(main_thread_watchdog, &MainThreadWatchdog::Start, Qt::QueuedConnection);
+          return main_thread_watchdog;
+        }),
+        transport_control_([app]() {
+          TransportControl *transport_control = new TransportControl(app->player()->engine());
+          app->MoveToNewThread(transport_control);
+          return transport_control;
+        }),
         network_([]() { return new NetworkAccessManager(); }),
         device_finders_([]() { return new DeviceFinders(); }),
         url_handlers_([]() { return new UrlHandlers(); }),
-        device_manager_([app]() { return new DeviceManager(app->task_manager(), app->database(), app->tagreader_client(), app->albumcover_loader()); }),
-        collection_([app]() { return new CollectionLibrary(app->database(), app->task_manager(), app->tagreader_client(), app->albumcover_loader()); }),
+        device_manager_([app]() {
+          DeviceManager *device_manager = new DeviceManager(app->task_manager(), app->database(), app->tagreader_client(), app->albumcover_loader());
+          app->DeferUntilShown(u"DeviceListers"_s, [device_manager = QPointer<DeviceManager>(device_manager)]() {
+            if (device_manager) device_manager->StartListers();
+          });
+          return device_manager;
+        }),
+        collection_([app]() {
+          CollectionLibrary *collection = new CollectionLibrary(app->database(), app->task_manager(), app->tagreader_client(), app->albumcover_loader());
+          QObject::connect(collection, &CollectionLibrary::LrcFilesFound, &*app->lyrics_store(), &LyricsStore::SaveLrcFilesAsync);
+          return collection;
+        }),
         playlist_backend_([this, app]() {
           PlaylistBackend *playlist_backend = new PlaylistBackend(app->database(), app->tagreader_client(), app->collection_backend());
           app->MoveToThread(playlist_backend, database_->thread());
@@ -145,23 +179,10 @@ class ApplicationImpl {
         playlist_manager_([app]() { return new PlaylistManager(app->task_manager(), app->tagreader_client(), app->url_handlers(), app->playlist_backend(), app->collection_backend(), app->current_albumcover_loader()); }),
         cover_providers_([app]() {
           CoverProviders *cover_providers = new CoverProviders();
-          // Initialize the repository of cover providers.
-          cover_providers->AddProvider(new LastFmCoverProvider(app->network()));
-          cover_providers->AddProvider(new MusicbrainzCoverProvider(app->network()));
-          cover_providers->AddProvider(new DiscogsCoverProvider(app->network()));
-          cover_providers->AddProvider(new DeezerCoverProvider(app->network()));
-          cover_providers->AddProvider(new MusixmatchCoverProvider(app->network()));
-          cover_providers->AddProvider(new OpenTidalCoverProvider(app->network()));
-#ifdef HAVE_TIDAL
-          cover_providers->AddProvider(new TidalCoverProvider(app->streaming_services()->Service<TidalService>(), app->network()));
-#endif
-#ifdef HAVE_SPOTIFY
-          cover_providers->AddProvider(new SpotifyCoverProvider(app->streaming_services()->Service<SpotifyService>(), app->network()));
-#endif
-#ifdef HAVE_QOBUZ
-          cover_providers->AddProvider(new QobuzCoverProvider(app->streaming_services()->Service<QobuzService>(), app->network()));
-#endif
-          cover_providers->ReloadSettings();
+          // Initialize the repository of cover providers once the main window is shown, nothing searches for covers before that.
+          app->DeferUntilShown(u"CoverProviders"_s, [app, cover_providers = QPointer<CoverProviders>(cover_providers)]() {
+            if (cover_providers) ApplicationImpl::AddCoverProviders(app, cover_providers);
+          });
           return cover_providers;
         }),
         albumcover_loader_([app]() {
@@ -172,38 +193,34 @@ class ApplicationImpl {
         current_albumcover_loader_([app]() { return new CurrentAlbumCoverLoader(app->albumcover_loader()); }),
         lyrics_providers_([app]() {
           LyricsProviders *lyrics_providers = new LyricsProviders(app);
-          // Initialize the repository of lyrics providers.
-          lyrics_providers->AddProvider(new GeniusLyricsProvider(lyrics_providers->network()));
-          lyrics_providers->AddProvider(new OVHLyricsProvider(lyrics_providers->network()));
-          lyrics_providers->AddProvider(new LoloLyricsProvider(lyrics_providers->network()));
-          lyrics_providers->AddProvider(new MusixmatchLyricsProvider(lyrics_providers->network()));
-          lyrics_providers->AddProvider(new ChartLyricsProvider(lyrics_providers->network()));
-          lyrics_providers->AddProvider(new SongLyricsComLyricsProvider(lyrics_providers->network()));
-          lyrics_providers->AddProvider(new AzLyricsComLyricsProvider(lyrics_providers->network()));
-          lyrics_providers->AddProvider(new ElyricsNetLyricsProvider(lyrics_providers->network()));
-          lyrics_providers->AddProvider(new LetrasLyricsProvider(lyrics_providers->network()));
-          lyrics_providers->AddProvider(new LyricFindLyricsProvider(lyrics_providers->network()));
-          lyrics_providers->AddProvider(new LrcLibLyricsProvider(lyrics_providers->network()));
-          lyrics_providers->ReloadSettings();
+          // Initialize the repository of lyrics providers once the main window is shown.
+          app->DeferUntilShown(u"LyricsProviders"_s, [lyrics_providers = QPointer<LyricsProviders>(lyrics_providers)]() {
+            if (lyrics_providers) ApplicationImpl::AddLyricsProviders(lyrics_providers);
+          });
           return lyrics_providers;
         }),
+        lyrics_store_([this, app]() {
+          LyricsStore *lyrics_store = new LyricsStore(app->database());
+          app->MoveToThread(lyrics_store, database_->thread());
+          return lyrics_store;
+        }),
         streaming_services_([app]() {
           StreamingServices *streaming_services = new StreamingServices();
 #ifdef HAVE_SUBSONIC
-          streaming_services->AddService(make_shared<SubsonicService>(app->task_manager(), app->database(), app->url_handlers(), app->albumcover_loader()));
+          streaming_services->AddService(make_shared<SubsonicService>(app->task_manager(), app->source_database(u"subsonic"_s), app->url_handlers(), app->albumcover_loader()));
 #endif
 #ifdef HAVE_TIDAL
-          streaming_services->AddService(make_shared<TidalService>(app->task_manager(), app->database(), app->network(), app->url_handlers(), app->albumcover_loader()));
+          streaming_services->AddService(make_shared<TidalService>(app->task_manager(), app->source_database(u"tidal"_s), app->network(), app->url_handlers(), app->albumcover_loader()));
 #endif
 #ifdef HAVE_SPOTIFY
-          streaming_services->AddService(make_shared<SpotifyService>(app->task_manager(), app->database(), app->network(), app->albumcover_loader()));
+          streaming_services->AddService(make_shared<SpotifyService>(app->task_manager(), app->source_database(u"spotify"_s), app->network(), app->albumcover_loader()));
 #endif
 #ifdef HAVE_QOBUZ
-          streaming_services->AddService(make_shared<QobuzService>(app->task_manager(), app->database(), app->network(), app->url_handlers(), app->albumcover_loader()));
+          streaming_services->AddService(make_shared<QobuzService>(app->task_manager(), app->source_database(u"qobuz"_s), app->network(), app->url_handlers(), app->albumcover_loader()));
 #endif
           return streaming_services;
         }),
-        radio_services_([app]() { return new RadioServices(app->task_manager(), app->network(), app->database(), app->albumcover_loader()); }),
+        radio_services_([app]() { return new RadioServices(app->task_manager(), app->network(), app->url_handlers(), app->database(), app->albumcover_loader()); }),
         scrobbler_([app]() {
           AudioScrobbler *scrobbler = new AudioScrobbler(app);
           scrobbler->AddService(make_shared<LastFMScrobbler>(scrobbler->settings(), app->network()));
@@ -214,16 +231,58 @@ class ApplicationImpl {
           return scrobbler;
         }),
 #ifdef HAVE_MOODBAR
-        moodbar_loader_([app]() { return new MoodbarLoader(app); }),
+        moodbar_loader_([app]() { return new MoodbarLoader(app->collection_backend(), app); }),
         moodbar_controller_([app]() { return new MoodbarController(app->player(), app->moodbar_loader()); }),
 #endif
         lastfm_import_([app]() { return new LastFMImport(app->network()); })
   {}
 
+  static void AddCoverProviders(Application *app, CoverProviders *cover_providers) {
+
+    cover_providers->AddProvider(new LastFmCoverProvider(app->network()));
+    cover_providers->AddProvider(new MusicbrainzCoverProvider(app->network()));
+    cover_providers->AddProvider(new DiscogsCoverProvider(app->network()));
+    cover_providers->AddProvider(new DeezerCoverProvider(app->network()));
+    cover_providers->AddProvider(new MusixmatchCoverProvider(app->network()));
+    cover_providers->AddProvider(new OpenTidalCoverProvider(app->network()));
+#ifdef HAVE_TIDAL
+    cover_providers->AddProvider(new TidalCoverProvider(app->streaming_services()->Service<TidalService>(), app->network()));
+#endif
+#ifdef HAVE_SPOTIFY
+    cover_providers->AddProvider(new SpotifyCoverProvider(app->streaming_services()->Service<SpotifyService>(), app->network()));
+#endif
+#ifdef HAVE_QOBUZ
+    cover_providers->AddProvider(new QobuzCoverProvider(app->streaming_services()->Service<QobuzService>(), app->network()));
+#endif
+    cover_providers->ReloadSettings();
+
+  }
+
+  static void AddLyricsProviders(LyricsProviders *lyrics_providers) {
+
+    lyrics_providers->AddProvider(new GeniusLyricsProvider(lyrics_providers->network()));
+    lyrics_providers->AddProvider(new OVHLyricsProvider(lyrics_providers->network()));
+    lyrics_providers->AddProvider(new LoloLyricsProvider(lyrics_providers->network()));
+    lyrics_providers->AddProvider(new MusixmatchLyricsProvider(lyrics_providers->network()));
+    lyrics_providers->AddProvider(new ChartLyricsProvider(lyrics_providers->network()));
+    lyrics_providers->AddProvider(new SongLyricsComLyricsProvider(lyrics_providers->network()));
+    lyrics_providers->AddProvider(new AzLyricsComLyricsProvider(lyrics_providers->network()));
+    lyrics_providers->AddProvider(new ElyricsNetLyricsProvider(lyrics_providers->network()));
+    lyrics_providers->AddProvider(new LetrasLyricsProvider(lyrics_providers->network()));
+    lyrics_providers->AddProvider(new LyricFindLyricsProvider(lyrics_providers->network()));
+    lyrics_providers->AddProvider(new LrcLibLyricsProvider(lyrics_providers->network()));
+    lyrics_providers->ReloadSettings();
+
+  }
+
   Lazy<TagReaderClient> tagreader_client_;
   Lazy<Database> database_;
+  // Source name -> database, every streaming service has its own database file and thread, so syncing one source doesn't hold up the queries of the others.
+  QMap<QString, SharedPtr<Database>> source_databases_;
   Lazy<TaskManager> task_manager_;
   Lazy<Player> player_;
+  Lazy<MainThreadWatchdog> main_thread_watchdog_;
+  Lazy<TransportControl> transport_control_;
   Lazy<NetworkAccessManager> network_;
   Lazy<DeviceFinders> device_finders_;
   Lazy<UrlHandlers> url_handlers_;
@@ -235,6 +294,7 @@ class ApplicationImpl {
   Lazy<AlbumCoverLoader> albumcover_loader_;
   Lazy<CurrentAlbumCoverLoader> current_albumcover_loader_;
   Lazy<LyricsProviders> lyrics_providers_;
+  Lazy<LyricsStore> lyrics_store_;
   Lazy<StreamingServices> streaming_services_;
   Lazy<RadioServices> radio_services_;
   Lazy<AudioScrobbler> scrobbler_;
@@ -249,7 +309,9 @@ class ApplicationImpl {
 Application::Application(QObject *parent)
     : QObject(parent),
       p_(new ApplicationImpl(this)),
-      g_thread_(nullptr) {
+      g_thread_(nullptr),
+      deferred_started_(false),
+      deferred_running_(false) {
 
   setObjectName(QLatin1String(QObject::metaObject()->className()));
 
@@ -258,6 +320,20 @@ Application::Application(QObject *parent)
     g_thread_ = g_thread_new(nullptr, Application::GLibMainLoopThreadFunc, nullptr);
   }
 
+  main_thread_watchdog();
+
+  // Rebuilding the GStreamer plugin registry after an update can take a while, show it as a task instead of looking stuck.
+  const QFuture<void> gst_initialized = GstStartup::Initialized();
+  if (!gst_initialized.isFinished()) {
+    const int task_id = task_manager()->StartTask(tr("Loading GStreamer plugins"));
+    QFutureWatcher<void> *watcher = new QFutureWatcher<void>(this);
+    QObject::connect(watcher, &QFutureWatcher<void>::finished, this, [this, watcher, task_id]() {
+      task_manager()->SetTaskFinished(task_id);
+      watcher->deleteLater();
+    });
+    watcher->setFuture(gst_initialized);
+  }
+
   device_finders()->Init();
   collection()->Init();
   tagreader_client();
@@ -268,6 +344,9 @@ Application::~Application() {
 
   qLog(Debug) << "Terminating application";
 
+  // Tasks in the shared pools may still use the objects living in the threads below.
+  TaskExecutor::WaitForDone();
+
   for (QThread *thread : std::as_const(threads_)) {
     thread->quit();
   }
@@ -297,6 +376,8 @@ gpointer Application::GLibMainLoopThreadFunc(gpointer data) {
 
 QThread *Application::MoveToNewThread(QObject *object) {
 
+  const qint64 start_msec = StartupTracer::ElapsedMsec();
+
   QThread *thread = new QThread(this);
 
   thread->setObjectName(object->objectName());
@@ -306,6 +387,8 @@ QThread *Application::MoveToNewThread(QObject *object) {
   thread->start();
   threads_ << thread;
 
+  StartupTracer::AddEvent(u"Thread "_s + thread->objectName(), start_msec, StartupTracer::ElapsedMsec() - start_msec);
+
   return thread;
 
 }
@@ -316,11 +399,53 @@ void Application::MoveToThread(QObject *object, QThread *thread) {
   qLog(Debug) << object << "moved to thread" << thread;
 }
 
+void Application::DeferUntilShown(const QString &name, std::function<void()> function) {
+
+  deferred_functions_ << DeferredFunction { name, function };
+
+  if (deferred_started_ && !deferred_running_) {
+    deferred_running_ = true;
+    QTimer::singleShot(0, this, &Application::RunNextDeferred);
+  }
+
+}
+
+void Application::RunDeferred() {
+
+  if (deferred_started_) return;
+  deferred_started_ = true;
+
+  qLog(Debug) << "Main window shown after" << StartupTracer::ElapsedMsec() << "ms, running" << deferred_functions_.count() << "deferred initializations";
+
+  deferred_running_ = true;
+  RunNextDeferred();
+
+}
+
+void Application::RunNextDeferred() {
+
+  if (deferred_functions_.isEmpty()) {
+    deferred_running_ = false;
+    StartupTracer::Finish();
+    return;
+  }
+
+  const DeferredFunction deferred_function = deferred_functions_.takeFirst();
+  const qint64 start_msec = StartupTracer::ElapsedMsec();
+  deferred_function.function();
+  StartupTracer::AddEvent(u"Deferred "_s + deferred_function.name, start_msec, StartupTracer::ElapsedMsec() - start_msec);
+
+  // Let the event loop process input and paint between each deferred initialization.
+  QTimer::singleShot(0, this, &Application::RunNextDeferred);
+
+}
+
 void Application::Exit() {
 
   wait_for_exit_ << &*tagreader_client()
                  << &*collection()
                  << &*playlist_backend()
+                 << &*lyrics_store()
                  << &*albumcover_loader()
                  << &*device_manager()
                  << &*streaming_services()
@@ -335,6 +460,9 @@ void Application::Exit() {
   QObject::connect(&*playlist_backend(), &PlaylistBackend::ExitFinished, this, &Application::ExitReceived);
   playlist_backend()->ExitAsync();
 
+  QObject::connect(&*lyrics_store(), &LyricsStore::ExitFinished, this, &Application::ExitReceived);
+  lyrics_store()->ExitAsync();
+
   QObject::connect(&*albumcover_loader(), &AlbumCoverLoader::ExitFinished, this, &Application::ExitReceived);
   albumcover_loader()->ExitAsync();
 
@@ -358,17 +486,53 @@ void Application::ExitReceived() {
 
   wait_for_exit_.removeAll(obj);
   if (wait_for_exit_.isEmpty()) {
-    database()->Close();
-    QObject::connect(&*database(), &Database::ExitFinished, this, &Application::ExitFinished);
-    database()->ExitAsync();
+    const QList<SharedPtr<Database>> databases = QList<SharedPtr<Database>>() << database() << p_->source_databases_.values();
+    for (const SharedPtr<Database> &db : databases) {
+      wait_for_exit_ << &*db;
+      db->Close();
+      QObject::connect(&*db, &Database::ExitFinished, this, &Application::DatabaseExitReceived);
+      db->ExitAsync();
+    }
   }
 
 }
 
+void Application::DatabaseExitReceived() {
+
+  QObject *obj = sender();
+  QObject::disconnect(obj, nullptr, this, nullptr);
+
+  wait_for_exit_.removeAll(obj);
+  if (wait_for_exit_.isEmpty()) Q_EMIT ExitFinished();
+
+}
+
 SharedPtr<TagReaderClient> Application::tagreader_client() const { return p_->tagreader_client_.ptr(); }
 SharedPtr<Database> Application::database() const { return p_->database_.ptr(); }
+
+SharedPtr<Database> Application::source_database(const QString &name) {
+
+  SharedPtr<Database> database = p_->source_databases_.value(name);
+  if (database) return database;
+
+  Database *source_database = new Database(task_manager(), nullptr, QString(), QStringLiteral("strawberry-%1.db").arg(name));
+  source_database->setObjectName(QStringLiteral("Database %1").arg(name));
+  MoveToNewThread(source_database);
+  QTimer::singleShot(30s, source_database, &Database::StartMaintenance);
+
+  database = SharedPtr<Database>(source_database, [](Database *obj) { qLog(Debug) << obj << "deleted"; delete obj; });
+  p_->source_databases_.insert(name, database);
+
+  // Queries across the sources attach the source databases to a connection of the main database.
+  this->database()->AddSourceDatabase(name, source_database->filename());
+
+  return database;
+
+}
 SharedPtr<TaskManager> Application::task_manager() const { return p_->task_manager_.ptr(); }
 SharedPtr<Player> Application::player() const { return p_->player_.ptr(); }
+SharedPtr<TransportControl> Application::transport_control() const { return p_->transport_control_.ptr(); }
+SharedPtr<MainThreadWatchdog> Application::main_thread_watchdog() const { return p_->main_thread_watchdog_.ptr(); }
 SharedPtr<NetworkAccessManager> Application::network() const { return p_->network_.ptr(); }
 SharedPtr<DeviceFinders> Application::device_finders() const { return p_->device_finders_.ptr(); }
 SharedPtr<UrlHandlers> Application::url_handlers() const { return p_->url_handlers_.ptr(); }
@@ -380,6 +544,7 @@ SharedPtr<AlbumCoverLoader> Application::albumcover_loader() const { return p_->
 SharedPtr<CoverProviders> Application::cover_providers() const { return p_->cover_providers_.ptr(); }
 SharedPtr<CurrentAlbumCoverLoader> Application::current_albumcover_loader() const { return p_->current_albumcover_loader_.ptr(); }
 SharedPtr<LyricsProviders> Application::lyrics_providers() const { return p_->lyrics_providers_.ptr(); }
+SharedPtr<LyricsStore> Application::lyrics_store() const { return p_->lyrics_store_.ptr(); }
 SharedPtr<PlaylistBackend> Application::playlist_backend() const { return p_->playlist_backend_.ptr(); }
 SharedPtr<PlaylistManager> Application::playlist_manager() const { return p_->playlist_manager_.ptr(); }
 SharedPtr<StreamingServices> Application::streaming_services() const { return p_->streaming_services_.ptr(); }
@@ -27,6 +27,8 @@
 
 #include <glib.h>
 
+#include <functional>
+
 #include <QObject>
 #include <QList>
 #include <QString>
@@ -43,6 +45,8 @@ class Database;
 class DeviceFinders;
 class UrlHandlers;
 class Player;
+class TransportControl;
+class MainThreadWatchdog;
 class NetworkAccessManager;
 class CollectionLibrary;
 class CollectionBackend;
@@ -55,6 +59,7 @@ class AlbumCoverLoader;
 class CurrentAlbumCoverLoader;
 class CoverProviders;
 class LyricsProviders;
+class LyricsStore;
 class AudioScrobbler;
 class LastFMImport;
 class StreamingServices;
@@ -73,8 +78,12 @@ class Application : public QObject {
 
   SharedPtr<TagReaderClient> tagreader_client() const;
   SharedPtr<Database> database() const;
+  // The database of a single music source, created with its own file and thread the first time it is requested.
+  SharedPtr<Database> source_database(const QString &name);
   SharedPtr<TaskManager> task_manager() const;
   SharedPtr<Player> player() const;
+  SharedPtr<TransportControl> transport_control() const;
+  SharedPtr<MainThreadWatchdog> main_thread_watchdog() const;
   SharedPtr<NetworkAccessManager> network() const;
   SharedPtr<DeviceFinders> device_finders() const;
   SharedPtr<UrlHandlers> url_handlers() const;
@@ -92,6 +101,7 @@ class Application : public QObject {
   SharedPtr<CurrentAlbumCoverLoader> current_albumcover_loader() const;
 
   SharedPtr<LyricsProviders> lyrics_providers() const;
+  SharedPtr<LyricsStore> lyrics_store() const;
 
   SharedPtr<AudioScrobbler> scrobbler() const;
 
@@ -110,8 +120,17 @@ class Application : public QObject {
   QThread *MoveToNewThread(QObject *object);
   static void MoveToThread(QObject *object, QThread *thread);
 
+  // Runs function once the main window has shown its first frame, or soon if that already happened.
+  // Deferred functions are run one per event loop iteration, in the order they were added.
+  void DeferUntilShown(const QString &name, std::function<void()> function);
+
+ public Q_SLOTS:
+  void RunDeferred();
+
  private Q_SLOTS:
   void ExitReceived();
+  void DatabaseExitReceived();
+  void RunNextDeferred();
 
  Q_SIGNALS:
   void ExitFinished();
@@ -124,6 +143,14 @@ class Application : public QObject {
   GThread *g_thread_;
   QList<QThread*> threads_;
   QList<QObject*> wait_for_exit_;
+
+  struct DeferredFunction {
+    QString name;
+    std::function<void()> function;
+  };
+  QList<DeferredFunction> deferred_functions_;
+  bool deferred_started_;
+  bool deferred_running_;
 };
 
 #endif  // APPLICATION_H
@@ -0,0 +1,106 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "config.h"
+
+#include <algorithm>
+
+#include <QtGlobal>
+#include <QThread>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QWaitCondition>
+#include <QDeadlineTimer>
+#include <QElapsedTimer>
+
+#include "utilities/threadutils.h"
+#include "backgroundiothrottle.h"
+
+namespace {
+// Buffering of a stream can last long, so the background reads resume after a while anyway.
+constexpr qint64 kMaxBufferingPauseMsec = 30000;
+// A single large read is paid back in several sleeps, so a job stopping isn't held up for long.
+constexpr qint64 kMaxSleepMsec = 1000;
+}  // namespace
+
+BackgroundIOThrottle::BackgroundIOThrottle()
+    : playback_buffering_(false),
+      bandwidth_limit_(0),
+      available_bytes_(0) {
+
+  timer_refill_.start();
+
+}
+
+BackgroundIOThrottle *BackgroundIOThrottle::Instance() {
+
+  static BackgroundIOThrottle instance;
+  return &instance;
+
+}
+
+void BackgroundIOThrottle::SetPlaybackBuffering(const bool buffering) {
+
+  QMutexLocker l(&mutex_);
+  playback_buffering_ = buffering;
+  if (!buffering) wait_condition_buffering_.wakeAll();
+
+}
+
+void BackgroundIOThrottle::SetBandwidthLimit(const qint64 bytes_per_second) {
+
+  QMutexLocker l(&mutex_);
+  bandwidth_limit_ = std::max(0LL, bytes_per_second);
+  available_bytes_ = bandwidth_limit_;
+  timer_refill_.restart();
+
+}
+
+void BackgroundIOThrottle::Acquire(const qint64 bytes) {
+
+  QMutexLocker l(&mutex_);
+
+  if (playback_buffering_) {
+    const QDeadlineTimer deadline(kMaxBufferingPauseMsec);
+    while (playback_buffering_ && !deadline.hasExpired()) {
+      wait_condition_buffering_.wait(&mutex_, deadline);
+    }
+  }
+
+  if (bandwidth_limit_ <= 0) return;
+
+  // Refill for the time passed, holding at most one second of reads.
+  available_bytes_ = std::min(bandwidth_limit_, available_bytes_ + (timer_refill_.restart() * bandwidth_limit_ / 1000));
+  available_bytes_ -= bytes;
+  if (available_bytes_ >= 0) return;
+
+  const qint64 sleep_msec = std::min(kMaxSleepMsec, -available_bytes_ * 1000 / bandwidth_limit_);
+  l.unlock();
+
+  QThread::msleep(static_cast<unsigned long>(sleep_msec));
+
+}
+
+void BackgroundIOThrottle::SetCurrentThreadIdle() {
+
+#ifndef Q_OS_WIN32
+  Utilities::SetThreadIOPriority(Utilities::IoPriority::IOPRIO_CLASS_IDLE);
+#endif
+
+}
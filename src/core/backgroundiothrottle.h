@@ -0,0 +1,63 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef BACKGROUNDIOTHROTTLE_H
+#define BACKGROUNDIOTHROTTLE_H
+
+#include "config.h"
+
+#include <QtGlobal>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QElapsedTimer>
+
+// Keeps the background jobs reading files, like collection scans and analysis, from starving playback of disk I/O.
+// The jobs call Acquire() before reading, which blocks while playback is buffering and paces the reads to the bandwidth limit.
+// Thread safe, shared by all the jobs.
+class BackgroundIOThrottle {
+ public:
+  static BackgroundIOThrottle *Instance();
+
+  // Pauses the background reads while the engine is buffering.
+  void SetPlaybackBuffering(const bool buffering);
+
+  // Limits the background reads to the number of bytes per second, 0 for no limit.
+  void SetBandwidthLimit(const qint64 bytes_per_second);
+
+  // Called before reading about the number of bytes.
+  void Acquire(const qint64 bytes);
+
+  // Lowers the I/O priority of the calling thread to the idle class, so the disk serves it only when nothing else is reading.
+  static void SetCurrentThreadIdle();
+
+ private:
+  BackgroundIOThrottle();
+
+  QMutex mutex_;
+  QWaitCondition wait_condition_buffering_;
+  bool playback_buffering_;
+  qint64 bandwidth_limit_;
+  // Token bucket for the bandwidth limit, negative when reads are ahead of the limit.
+  qint64 available_bytes_;
+  QElapsedTimer timer_refill_;
+
+  Q_DISABLE_COPY(BackgroundIOThrottle)
+};
+
+#endif  // BACKGROUNDIOTHROTTLE_H
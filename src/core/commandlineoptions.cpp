@@ -92,7 +92,9 @@ constexpr char kHelpText[] =
     "      --verbose              %32\n"
     "      --log-levels <levels>  %33\n"
     "      --version              %34\n"
-    "      --create-fingerprint <filename>  %35\n";
+    "      --create-fingerprint <filename>  %35\n"
+    "      --trace-file <filename>          %36\n"
+    "      --scan-collection [full]         %37\n";
 
 constexpr char kVersionText[] = "Strawberry %1";
 
@@ -179,6 +181,7 @@ bool CommandlineOptions::Parse() {
       {L"log-levels", required_argument, nullptr, LongOptions::LogLevels},
       {L"version", no_argument, nullptr, LongOptions::Version},
       {L"create-fingerprint", required_argument, nullptr, LongOptions::CreateFingerPrint},
+      {L"trace-file", required_argument, nullptr, LongOptions::TraceFile},
       {nullptr, 0, nullptr, 0}
 #else
     { "help", no_argument, nullptr, 'h' },
@@ -211,6 +214,7 @@ bool CommandlineOptions::Parse() {
     { "log-levels", required_argument, nullptr, LongOptions::LogLevels },
     { "version", no_argument, nullptr, LongOptions::Version },
     { "create-fingerprint", required_argument, nullptr, LongOptions::CreateFingerPrint },
+    { "trace-file", required_argument, nullptr, LongOptions::TraceFile },
     { nullptr, 0, nullptr, 0 }
 #endif
   };
@@ -264,7 +268,9 @@ bool CommandlineOptions::Parse() {
                      QObject::tr("Equivalent to --log-levels *:3"),
                      QObject::tr("Comma separated list of class:level, level is 0-3"),
                      QObject::tr("Print out version information"),
-                     QObject::tr("Create fingerprint")
+                     QObject::tr("Create fingerprint"),
+                     QObject::tr("Record a profiling trace and write it to <filename> on exit"),
+                     QObject::tr("Scan the collection without starting the GUI, then exit")
                      );
 
         std::cout << translated_help_text.toLocal8Bit().constData();
@@ -386,6 +392,10 @@ bool CommandlineOptions::Parse() {
         exit(0);
       }
 
+      case LongOptions::TraceFile:
+        trace_file_ = OptArgToString(optarg);
+        break;
+
       case '?':
       default:
         return false;
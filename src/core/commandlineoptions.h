@@ -82,6 +82,7 @@ class CommandlineOptions {
   QString log_levels() const { return log_levels_; }
   QString playlist_name() const { return playlist_name_; }
   QString window_size() const { return window_size_; }
+  QString trace_file() const { return trace_file_; }
 
   QByteArray Serialize() const;
   void Load(const QByteArray &serialized);
@@ -101,6 +102,7 @@ class CommandlineOptions {
     VolumeDecreaseBy,
     RestartOrPrevious,
     CreateFingerPrint,
+    TraceFile,
   };
 
   void RemoveArg(const QString &starts_with, int count);
@@ -136,6 +138,7 @@ class CommandlineOptions {
   QString log_levels_;
   QString playlist_name_;
   QString window_size_;
+  QString trace_file_;
 
   QList<QUrl> urls_;
 };
@@ -40,34 +40,58 @@
 #include <QSqlDatabase>
 #include <QSqlError>
 #include <QScopeGuard>
+#include <QTimer>
 
 #include "logging.h"
+#include "tracing.h"
+#include "settings.h"
 #include "standardpaths.h"
 #include "taskmanager.h"
 #include "database.h"
 #include "sqlquery.h"
 #include "scopedtransaction.h"
+#include "song.h"
+#include "constants/databasesettings.h"
 
 using namespace Qt::Literals::StringLiterals;
 
-const int Database::kSchemaVersion = 22;
+const int Database::kSchemaVersion = 33;
 
 namespace {
 constexpr char kDatabaseFilename[] = "strawberry.db";
 constexpr int kMinSupportedSchemaVersion = 10;
 constexpr char kMagicAllSongsTables[] = "%allsongstables";
+constexpr char kMagicAllSubdirsTables[] = "%allsubdirstables";
+constexpr int kMaintenanceIntervalMsec = 600000;
+// Run ANALYZE again when this many rows in the songs table changed since the last time.
+constexpr qint64 kAnalyzeMinChanges = 1000;
+constexpr int kAnalysisLimit = 1000;
+constexpr int kIncrementalVacuumPages = 256;
+constexpr int kIncrementalVacuumDelayMsec = 100;
+constexpr int kBackupPagesPerStep = 64;
+constexpr int kBackupRetryMsec = 250;
 }  // namespace
 
 int Database::sNextConnectionId = 1;
 QMutex Database::sNextConnectionIdMutex;
 
-Database::Database(SharedPtr<TaskManager> task_manager, QObject *parent, const QString &database_name)
+Database::Database(SharedPtr<TaskManager> task_manager, QObject *parent, const QString &database_name, const QString &filename)
     : QObject(parent),
       task_manager_(task_manager),
+      created_(false),
+      prepared_query_hits_(0),
+      prepared_query_misses_(0),
+      write_ahead_log_(false),
       injected_database_name_(database_name),
       query_hash_(0),
       startup_schema_version_(-1),
-      original_thread_(nullptr) {
+      original_thread_(nullptr),
+      timer_maintenance_(new QTimer(this)),
+      analyze_change_counter_(-1),
+      backup_source_connection_(nullptr),
+      backup_dest_connection_(nullptr),
+      backup_(nullptr),
+      backup_task_id_(-1) {
 
   setObjectName(QLatin1String(QObject::metaObject()->className()));
 
@@ -78,8 +102,28 @@ Database::Database(SharedPtr<TaskManager> task_manager, QObject *parent, const Q
     connection_id_ = sNextConnectionId++;
   }
 
+  timer_maintenance_->setInterval(kMaintenanceIntervalMsec);
+  QObject::connect(timer_maintenance_, &QTimer::timeout, this, &Database::Maintenance);
+
   directory_ = QDir::toNativeSeparators(StandardPaths::WritableLocation(StandardPaths::StandardLocation::AppLocalDataLocation)).replace(u"Strawberry"_s, u"strawberry"_s);
 
+  if (!injected_database_name_.isNull()) {
+    filename_ = injected_database_name_;
+  }
+  else if (!filename.isEmpty()) {
+    filename_ = directory_ + u'/' + filename;
+  }
+  else {
+    filename_ = directory_ + u'/' + QLatin1String(kDatabaseFilename);
+  }
+
+  if (injected_database_name_.isNull()) {
+    Settings s;
+    s.beginGroup(DatabaseSettings::kSettingsGroup);
+    write_ahead_log_ = s.value(DatabaseSettings::kWriteAheadLog, false).toBool();
+    s.endGroup();
+  }
+
   QMutexLocker l(&mutex_);
   Connect();
 
@@ -103,6 +147,8 @@ void Database::ExitAsync() {
 void Database::Exit() {
 
   Q_ASSERT(QThread::currentThread() == thread());
+  timer_maintenance_->stop();
+  FinishBackup();
   Close();
   moveToThread(original_thread_);
   Q_EMIT ExitFinished();
@@ -111,6 +157,18 @@ void Database::Exit() {
 
 QSqlDatabase Database::Connect() {
 
+  qTraceScope("Database::Connect");
+
+  const QString connection_id = QStringLiteral("%1_thread_%2").arg(connection_id_).arg(reinterpret_cast<quint64>(QThread::currentThread()));
+
+  // Each thread has its own connection, so an already open connection can be returned without serializing the threads.
+  if (QSqlDatabase::contains(connection_id)) {
+    QSqlDatabase db = QSqlDatabase::database(connection_id, false);
+    if (db.isOpen()) {
+      return db;
+    }
+  }
+
   QMutexLocker l(&connect_mutex_);
 
   // Create the directory if it doesn't exist
@@ -120,11 +178,9 @@ QSqlDatabase Database::Connect() {
     }
   }
 
-  const QString connection_id = QStringLiteral("%1_thread_%2").arg(connection_id_).arg(reinterpret_cast<quint64>(QThread::currentThread()));
-
   // Try to find an existing connection for this thread
   QSqlDatabase db;
-  if (QSqlDatabase::connectionNames().contains(connection_id)) {
+  if (QSqlDatabase::contains(connection_id)) {
     db = QSqlDatabase::database(connection_id);
   }
   else {
@@ -136,19 +192,40 @@ QSqlDatabase Database::Connect() {
   db.setConnectOptions(u"QSQLITE_BUSY_TIMEOUT=30000"_s);
   // qLog(Debug) << "Opened database with connection id" << connection_id;
 
-  if (injected_database_name_.isNull()) {
-    db.setDatabaseName(directory_ + u'/' + QLatin1String(kDatabaseFilename));
-  }
-  else {
-    db.setDatabaseName(injected_database_name_);
-  }
+  db.setDatabaseName(filename_);
 
   if (!db.open()) {
     Q_EMIT Error(u"Database: "_s + db.lastError().text());
     return db;
   }
 
-  if (db.tables().count() == 0) {
+  const bool new_database = db.tables().count() == 0;
+
+  if (new_database) {
+    // Must be set before the first table is created, it lets maintenance give free pages back in small steps.
+    SqlQuery q(db);
+    q.prepare(u"PRAGMA auto_vacuum = INCREMENTAL"_s);
+    if (!q.Exec()) {
+      ReportErrors(q);
+    }
+  }
+
+  if (write_ahead_log_) {
+    // With a write-ahead log, readers such as the UI thread's connection are not blocked by a writing connection.
+    SqlQuery q(db);
+    q.prepare(u"PRAGMA journal_mode = WAL"_s);
+    if (q.Exec()) {
+      q.finish();
+      q.prepare(u"PRAGMA synchronous = NORMAL"_s);
+      q.Exec();
+    }
+    else {
+      ReportErrors(q);
+    }
+  }
+
+  if (new_database) {
+    created_ = true;
     // Set up initial schema
     qLog(Info) << "Creating initial database schema";
     UpdateDatabaseSchema(0, db);
@@ -198,14 +275,117 @@ QSqlDatabase Database::Connect() {
 
 }
 
+void Database::ImportSongsTables(const QStringList &songs_tables) {
+
+  const QString main_filename = directory_ + u'/' + QLatin1String(kDatabaseFilename);
+  if (!created_ || !injected_database_name_.isNull() || filename_ == main_filename || !QFile::exists(main_filename)) return;
+
+  QMutexLocker l(&mutex_);
+  QSqlDatabase db(Connect());
+
+  {
+    SqlQuery q(db);
+    q.prepare(u"ATTACH DATABASE :filename AS main_database"_s);
+    q.BindValue(u":filename"_s, main_filename);
+    if (!q.Exec()) {
+      ReportErrors(q);
+      return;
+    }
+  }
+
+  bool success = true;
+  {
+    // Moved in one transaction, the songs are either in the new file or still in the main database.
+    ScopedTransaction transaction(&db);
+    for (const QString &songs_table : songs_tables) {
+      // The columns are listed, the column order of a table altered by the schema updates can differ from a new table.
+      SqlQuery q_insert(db);
+      q_insert.prepare(QStringLiteral("INSERT INTO %1 (ROWID, %2) SELECT ROWID, %2 FROM main_database.%1").arg(songs_table, Song::kColumnSpec));
+      SqlQuery q_delete(db);
+      q_delete.prepare(QStringLiteral("DELETE FROM main_database.%1").arg(songs_table));
+      if (!q_insert.Exec()) {
+        ReportErrors(q_insert);
+        success = false;
+        break;
+      }
+      if (!q_delete.Exec()) {
+        ReportErrors(q_delete);
+        success = false;
+        break;
+      }
+    }
+    if (success) {
+      transaction.Commit();
+    }
+  }
+
+  SqlQuery q(db);
+  q.prepare(u"DETACH DATABASE main_database"_s);
+  if (!q.Exec()) {
+    ReportErrors(q);
+  }
+
+  created_ = false;
+
+  if (success) {
+    qLog(Info) << "Moved" << songs_tables << "to" << filename_;
+  }
+
+}
+
+void Database::AddSourceDatabase(const QString &name, const QString &filename) {
+
+  QMutexLocker l(&source_databases_mutex_);
+  source_databases_.insert(name, filename);
+
+}
+
+bool Database::AttachSourceDatabases(QSqlDatabase &db) {
+
+  QMutexLocker l(&source_databases_mutex_);
+  for (QMap<QString, QString>::const_iterator it = source_databases_.constBegin(); it != source_databases_.constEnd(); ++it) {
+    SqlQuery q(db);
+    q.prepare(u"ATTACH DATABASE :filename AS :alias"_s);
+    q.BindValue(u":filename"_s, it.value());
+    q.BindValue(u":alias"_s, it.key());
+    if (!q.Exec()) {
+      ReportErrors(q);
+      return false;
+    }
+  }
+
+  return true;
+
+}
+
+void Database::DetachSourceDatabases(QSqlDatabase &db) {
+
+  QMutexLocker l(&source_databases_mutex_);
+  const QStringList names = source_databases_.keys();
+  for (const QString &name : names) {
+    SqlQuery q(db);
+    q.prepare(u"DETACH DATABASE :alias"_s);
+    q.BindValue(u":alias"_s, name);
+    if (!q.Exec()) {
+      qLog(Warning) << "Failed to detach database" << name;
+    }
+  }
+
+}
+
 void Database::Close() {
 
   QMutexLocker l(&connect_mutex_);
 
   const QString connection_id = QStringLiteral("%1_thread_%2").arg(connection_id_).arg(reinterpret_cast<quint64>(QThread::currentThread()));
 
+  {
+    QMutexLocker l_prepared_queries(&prepared_queries_mutex_);
+    prepared_queries_.remove(connection_id);
+  }
+
   // Try to find an existing connection for this thread
-  if (QSqlDatabase::connectionNames().contains(connection_id)) {
+  if (QSqlDatabase::contains(connection_id)) {
     {
       QSqlDatabase db = QSqlDatabase::database(connection_id);
       if (db.isOpen()) {
@@ -218,6 +398,70 @@ void Database::Close() {
 
 }
 
+SqlQuery Database::PreparedQuery(const QSqlDatabase &db, const QString &query) {
+
+  QMutexLocker l(&prepared_queries_mutex_);
+
+  QHash<QString, SqlQuery> &queries = prepared_queries_[db.connectionName()];
+  QHash<QString, SqlQuery>::iterator it = queries.find(query);
+  if (it == queries.end()) {
+    ++prepared_query_misses_;
+    SqlQuery q(db);
+    if (!q.prepare(query)) {
+      return q;
+    }
+    it = queries.insert(query, q);
+  }
+  else {
+    ++prepared_query_hits_;
+  }
+
+  return it.value();
+
+}
+
+bool Database::LoadTemporaryKeys(const QSqlDatabase &db, const QString &table, const QVariantList &keys) {
+
+  const QStringList statements = QStringList() << QStringLiteral("CREATE TEMP TABLE IF NOT EXISTS %1 (key PRIMARY KEY) WITHOUT ROWID").arg(table)
+                                               << QStringLiteral("DELETE FROM temp.%1").arg(table);
+  for (const QString &statement : statements) {
+    SqlQuery q = PreparedQuery(db, statement);
+    if (!q.Exec()) {
+      ReportErrors(q);
+      return false;
+    }
+    q.finish();
+  }
+
+  SqlQuery q = PreparedQuery(db, QStringLiteral("INSERT OR IGNORE INTO temp.%1 (key) VALUES (:key)").arg(table));
+  for (const QVariant &key : keys) {
+    q.BindValue(u":key"_s, key);
+    if (!q.Exec()) {
+      ReportErrors(q);
+      return false;
+    }
+  }
+  q.finish();
+
+  return true;
+
+}
+
+Database::PreparedQueryStatistics Database::prepared_query_statistics() {
+
+  QMutexLocker l(&prepared_queries_mutex_);
+
+  PreparedQueryStatistics statistics {};
+  statistics.hits = prepared_query_hits_;
+  statistics.misses = prepared_query_misses_;
+  for (const QHash<QString, SqlQuery> &queries : std::as_const(prepared_queries_)) {
+    statistics.cached += queries.count();
+  }
+
+  return statistics;
+
+}
+
 int Database::SchemaVersion(QSqlDatabase *db) {
 
   // Get the database's schema version
@@ -337,6 +581,52 @@ void Database::UpdateDatabaseSchema(int version, QSqlDatabase &db) {
 
   ExecSchemaCommandsFromFile(db, filename, version - 1);
 
+  if (version == 33) {
+    MoveLongText(db);
+  }
+
+}
+
+void Database::MoveLongText(QSqlDatabase &db) {
+
+  // The lyrics are compressed here, SQLite can't compress them in the schema update.
+  SqlQuery q_select(db);
+  q_select.prepare(u"SELECT ROWID, lyrics FROM songs WHERE length(lyrics) >= :size"_s);
+  q_select.BindValue(u":size"_s, Song::kLongTextMinSize);
+  if (!q_select.Exec()) {
+    ReportErrors(q_select);
+    return;
+  }
+
+  QMap<int, QString> lyrics;
+  while (q_select.next()) {
+    lyrics.insert(q_select.value(0).toInt(), q_select.value(1).toString());
+  }
+  q_select.finish();
+  if (lyrics.isEmpty()) return;
+
+  ScopedTransaction transaction(&db);
+  SqlQuery q_insert(db);
+  q_insert.prepare(QStringLiteral("INSERT OR REPLACE INTO %1 (song_id, lyrics) VALUES (:song_id, :lyrics)").arg(QLatin1String(Song::kLongTextTable)));
+  SqlQuery q_update(db);
+  q_update.prepare(u"UPDATE songs SET lyrics = NULL WHERE ROWID = :id"_s);
+  for (QMap<int, QString>::const_iterator it = lyrics.constBegin(); it != lyrics.constEnd(); ++it) {
+    q_insert.BindValue(u":song_id"_s, it.key());
+    q_insert.BindValue(u":lyrics"_s, Song::CompressLongText(it.value()));
+    if (!q_insert.Exec()) {
+      ReportErrors(q_insert);
+      return;
+    }
+    q_update.BindValue(u":id"_s, it.key());
+    if (!q_update.Exec()) {
+      ReportErrors(q_update);
+      return;
+    }
+  }
+  transaction.Commit();
+
+  qLog(Info) << "Moved the lyrics of" << lyrics.count() << "songs to" << Song::kLongTextTable;
+
 }
 
 void Database::UrlEncodeFilenameColumn(const QString &table, QSqlDatabase &db) {
@@ -395,28 +685,32 @@ void Database::ExecSchemaCommands(QSqlDatabase &db, const QString &schema, int s
   // If no outer transaction is provided the song tables need to be queried before beginning an inner transaction!
   // Otherwise DROP TABLE commands on song tables may fail due to database locks.
   const QStringList song_tables(SongsTables(db, schema_version));
+  const QStringList subdirs_tables(SubdirsTables(db));
 
   if (!in_transaction) {
     ScopedTransaction inner_transaction(&db);
-    ExecSongTablesCommands(db, song_tables, commands);
+    ExecSongTablesCommands(db, song_tables, subdirs_tables, commands);
     inner_transaction.Commit();
   }
   else {
-    ExecSongTablesCommands(db, song_tables, commands);
+    ExecSongTablesCommands(db, song_tables, subdirs_tables, commands);
   }
 
 }
 
-void Database::ExecSongTablesCommands(QSqlDatabase &db, const QStringList &song_tables, const QStringList &commands) {
+void Database::ExecSongTablesCommands(QSqlDatabase &db, const QStringList &song_tables, const QStringList &subdirs_tables, const QStringList &commands) {
 
   for (const QString &command : commands) {
     // There are now lots of "songs" tables that need to have the same schema: songs and device_*_songs.
-    // We allow a magic value in the schema files to update all songs tables at once.
-    if (command.contains(QLatin1String(kMagicAllSongsTables))) {
-      for (const QString &table : song_tables) {
-        qLog(Info) << "Updating" << table << "for" << kMagicAllSongsTables;
+    // We allow a magic value in the schema files to update all songs tables at once, and the same for the subdirectories tables.
+    const bool all_songs_tables = command.contains(QLatin1String(kMagicAllSongsTables));
+    if (all_songs_tables || command.contains(QLatin1String(kMagicAllSubdirsTables))) {
+      const char *magic = all_songs_tables ? kMagicAllSongsTables : kMagicAllSubdirsTables;
+      const QStringList &tables = all_songs_tables ? song_tables : subdirs_tables;
+      for (const QString &table : tables) {
+        qLog(Info) << "Updating" << table << "for" << magic;
         QString new_command(command);
-        new_command.replace(QLatin1String(kMagicAllSongsTables), table);
+        new_command.replace(QLatin1String(magic), table);
         SqlQuery query(db);
         query.prepare(new_command);
         if (!query.Exec()) {
@@ -465,7 +759,23 @@ QStringList Database::SongsTables(QSqlDatabase &db, const int schema_version) {
     }
   }
 
-  ret << u"playlist_items"_s;
+  // The playlist items keep their metadata in playlist_songs since schema 32, which is found above.
+  if (!ret.contains("playlist_songs"_L1)) {
+    ret << u"playlist_items"_s;
+  }
+
+  return ret;
+
+}
+
+QStringList Database::SubdirsTables(QSqlDatabase &db) {
+
+  QStringList ret;
+
+  const QStringList tables = db.tables();
+  for (const QString &table : tables) {
+    if (table == "subdirectories"_L1 || table.endsWith("_subdirectories"_L1)) ret << table;
+  }
 
   return ret;
 
@@ -523,6 +833,8 @@ bool Database::IntegrityCheck(const QSqlDatabase &db) {
 
 void Database::DoBackup() {
 
+  if (backup_) return;
+
   QSqlDatabase db(Connect());
 
   if (!db.isOpen()) return;
@@ -537,6 +849,106 @@ void Database::DoBackup() {
 
 }
 
+void Database::StartMaintenance() {
+
+  timer_maintenance_->start();
+
+}
+
+void Database::Maintenance() {
+
+  qTraceScope("Database::Maintenance");
+
+  if (backup_) return;
+
+  // Skip this round if another thread is using the database, it's tried again on the next timeout.
+  if (!mutex_.tryLock()) return;
+  const QScopeGuard unlock_mutex = qScopeGuard([this]() { mutex_.unlock(); });
+
+  QSqlDatabase db(Connect());
+  if (!db.isOpen()) return;
+
+  qint64 change_counter = -1;
+  {
+    SqlQuery q(db);
+    q.prepare(u"SELECT counter FROM changes WHERE name = 'songs'"_s);
+    if (q.Exec() && q.next()) {
+      change_counter = q.value(0).toLongLong();
+    }
+  }
+
+  bool has_statistics = false;
+  {
+    SqlQuery q(db);
+    q.prepare(u"SELECT name FROM sqlite_master WHERE type = 'table' AND name = 'sqlite_stat1'"_s);
+    has_statistics = q.Exec() && q.next();
+  }
+
+  if (!has_statistics || (analyze_change_counter_ != -1 && change_counter - analyze_change_counter_ >= kAnalyzeMinChanges)) {
+    // Limit the number of rows looked at in each index, so ANALYZE stays short on big collections.
+    qLog(Debug) << "Analyzing database";
+    SqlQuery q(db);
+    q.prepare(QStringLiteral("PRAGMA analysis_limit = %1").arg(kAnalysisLimit));
+    if (q.Exec()) {
+      q.finish();
+      q.prepare(u"ANALYZE"_s);
+    }
+    if (!q.Exec()) {
+      ReportErrors(q);
+    }
+  }
+  else {
+    SqlQuery q(db);
+    q.prepare(u"PRAGMA optimize"_s);
+    if (!q.Exec()) {
+      ReportErrors(q);
+    }
+  }
+  analyze_change_counter_ = change_counter;
+
+  QMetaObject::invokeMethod(this, &Database::IncrementalVacuum, Qt::QueuedConnection);
+
+}
+
+void Database::IncrementalVacuum() {
+
+  qTraceScope("Database::IncrementalVacuum");
+
+  if (!mutex_.tryLock()) {
+    QTimer::singleShot(kIncrementalVacuumDelayMsec, this, &Database::IncrementalVacuum);
+    return;
+  }
+  const QScopeGuard unlock_mutex = qScopeGuard([this]() { mutex_.unlock(); });
+
+  QSqlDatabase db(Connect());
+  if (!db.isOpen()) return;
+
+  // Databases created before auto_vacuum was set need a full VACUUM to change it, which is not done here.
+  SqlQuery q(db);
+  q.prepare(u"PRAGMA auto_vacuum"_s);
+  if (!q.Exec() || !q.next() || q.value(0).toInt() != 2) return;
+  q.finish();
+
+  q.prepare(u"PRAGMA freelist_count"_s);
+  if (!q.Exec() || !q.next()) return;
+  const qint64 free_pages = q.value(0).toLongLong();
+  q.finish();
+  if (free_pages <= 0) return;
+
+  q.prepare(QStringLiteral("PRAGMA incremental_vacuum(%1)").arg(kIncrementalVacuumPages));
+  if (!q.Exec()) {
+    ReportErrors(q);
+    return;
+  }
+  while (q.next()) {}
+
+  // Let queued database work run before the next step.
+  if (free_pages > kIncrementalVacuumPages) {
+    QTimer::singleShot(kIncrementalVacuumDelayMsec, this, &Database::IncrementalVacuum);
+  }
+
+}
+
 bool Database::OpenDatabase(const QString &filename, sqlite3 **connection) {
 
   const QByteArray filename_data = filename.toUtf8();
@@ -559,49 +971,71 @@ void Database::BackupFile(const QString &filename) {
 
   qLog(Debug) << "Starting database backup";
   QString dest_filename = QStringLiteral("%1.bak").arg(filename);
-  const int task_id = task_manager_->StartTask(tr("Backing up database"));
-
-  sqlite3 *source_connection = nullptr;
-  sqlite3 *dest_connection = nullptr;
+  backup_task_id_ = task_manager_->StartTask(tr("Backing up database"));
 
-  const QScopeGuard db_backup_finish = qScopeGuard([this, task_id, &source_connection, &dest_connection]() {
-    if (source_connection) {
-      sqlite3_close(source_connection);
-    }
-    if (dest_connection) {
-      sqlite3_close(dest_connection);
-    }
-    task_manager_->SetTaskFinished(task_id);
-  });
-
-  bool success = OpenDatabase(filename, &source_connection);
-  if (!success) {
+  if (!OpenDatabase(filename, &backup_source_connection_) || !OpenDatabase(dest_filename, &backup_dest_connection_)) {
+    FinishBackup();
     return;
   }
 
-  success = OpenDatabase(dest_filename, &dest_connection);
-  if (!success) {
-    return;
-  }
-
-  sqlite3_backup *backup = sqlite3_backup_init(dest_connection, "main", source_connection, "main");
-  if (!backup) {
-    const char *error_message = sqlite3_errmsg(dest_connection);
+  backup_ = sqlite3_backup_init(backup_dest_connection_, "main", backup_source_connection_, "main");
+  if (!backup_) {
+    const char *error_message = sqlite3_errmsg(backup_dest_connection_);
     qLog(Error) << "Failed to start database backup:" << error_message;
+    FinishBackup();
     return;
   }
 
-  int ret = SQLITE_OK;
-  do {
-    ret = sqlite3_backup_step(backup, 16);
-    const int page_count = sqlite3_backup_pagecount(backup);
-    task_manager_->SetTaskProgress(task_id, static_cast<quint64>(page_count - sqlite3_backup_remaining(backup)), static_cast<quint64>(page_count));
-  } while (ret == SQLITE_OK);
+  // Copy a few pages at a time from the event loop, so other queued database work isn't held up by the backup.
+  QMetaObject::invokeMethod(this, &Database::BackupStep, Qt::QueuedConnection);
 
-  if (ret != SQLITE_DONE) {
-    qLog(Error) << "Database backup failed";
+}
+
+void Database::BackupStep() {
+
+  if (!backup_) return;
+
+  const int ret = sqlite3_backup_step(backup_, kBackupPagesPerStep);
+  const int page_count = sqlite3_backup_pagecount(backup_);
+  task_manager_->SetTaskProgress(backup_task_id_, static_cast<quint64>(page_count - sqlite3_backup_remaining(backup_)), static_cast<quint64>(page_count));
+
+  switch (ret) {
+    case SQLITE_OK:
+      QMetaObject::invokeMethod(this, &Database::BackupStep, Qt::QueuedConnection);
+      return;
+    case SQLITE_BUSY:
+    case SQLITE_LOCKED:
+      QTimer::singleShot(kBackupRetryMsec, this, &Database::BackupStep);
+      return;
+    case SQLITE_DONE:
+      qLog(Debug) << "Database backup finished";
+      break;
+    default:
+      qLog(Error) << "Database backup failed";
+      break;
   }
 
-  sqlite3_backup_finish(backup);
+  FinishBackup();
+
+}
+
+void Database::FinishBackup() {
+
+  if (backup_) {
+    sqlite3_backup_finish(backup_);
+    backup_ = nullptr;
+  }
+  if (backup_source_connection_) {
+    sqlite3_close(backup_source_connection_);
+    backup_source_connection_ = nullptr;
+  }
+  if (backup_dest_connection_) {
+    sqlite3_close(backup_dest_connection_);
+    backup_dest_connection_ = nullptr;
+  }
+  if (backup_task_id_ != -1) {
+    task_manager_->SetTaskFinished(backup_task_id_);
+    backup_task_id_ = -1;
+  }
 
 }
@@ -29,24 +29,28 @@
 #include <QtGlobal>
 #include <QObject>
 #include <QMutex>
+#include <QHash>
 #include <QMap>
 #include <QSqlDatabase>
 #include <QSqlQuery>
 #include <QString>
 #include <QStringList>
+#include <QVariant>
 #include <QRecursiveMutex>
 
 #include "includes/shared_ptr.h"
 #include "sqlquery.h"
 
 class QThread;
+class QTimer;
 class TaskManager;
 
 class Database : public QObject {
   Q_OBJECT
 
  public:
-  explicit Database(SharedPtr<TaskManager> task_manager, QObject *parent = nullptr, const QString &database_name = QString());
+  // The filename is used for the database of a single music source, instead of the main database file.
+  explicit Database(SharedPtr<TaskManager> task_manager, QObject *parent = nullptr, const QString &database_name = QString(), const QString &filename = QString());
   ~Database() override;
 
   static const int kSchemaVersion;
@@ -64,8 +68,35 @@ class Database : public QObject {
   void ExitAsync();
   QSqlDatabase Connect();
   void Close();
+
+  QString filename() const { return filename_; }
+
+  // Moves the rows of the songs tables from the main database file to this database when the file was just created, so a source keeps its songs after moving to its own file.
+  void ImportSongsTables(const QStringList &songs_tables);
+
+  // Databases of the music sources, attached by AttachSourceDatabases() only to the connection of a query that needs the songs of several sources.
+  // Name -> filename, the name is used as the schema name of the attached database.
+  void AddSourceDatabase(const QString &name, const QString &filename);
+  bool AttachSourceDatabases(QSqlDatabase &db);
+  void DetachSourceDatabases(QSqlDatabase &db);
+
+  // Returns a query for the connection which is prepared only the first time it is requested.
+  // The query is shared with the cache, so call finish() when done with the results.
+  SqlQuery PreparedQuery(const QSqlDatabase &db, const QString &query);
   void ReportErrors(const SqlQuery &query);
 
+  // Replaces the keys in a temporary table with a single column named key, so statements can use "IN (SELECT key FROM temp.table)" instead of listing the keys.
+  // The keys are inserted with one prepared statement, there is no limit on their number.
+  // The table belongs to the connection, Mutex() must be held until the statements using it are done.
+  bool LoadTemporaryKeys(const QSqlDatabase &db, const QString &table, const QVariantList &keys);
+
+  struct PreparedQueryStatistics {
+    quint64 hits;
+    quint64 misses;
+    qsizetype cached;
+  };
+  PreparedQueryStatistics prepared_query_statistics();
+
   QRecursiveMutex *Mutex() { return &mutex_; }
 
   void RecreateAttachedDb(const QString &database_name);
@@ -85,22 +116,30 @@ class Database : public QObject {
 
  private Q_SLOTS:
   void Exit();
+  void Maintenance();
+  void IncrementalVacuum();
+  void BackupStep();
 
  public Q_SLOTS:
   void DoBackup();
+  void StartMaintenance();
 
  private:
   static int SchemaVersion(QSqlDatabase *db);
   void UpdateMainSchema(QSqlDatabase *db);
 
   void ExecSchemaCommandsFromFile(QSqlDatabase &db, const QString &filename, int schema_version, bool in_transaction = false);
-  void ExecSongTablesCommands(QSqlDatabase &db, const QStringList &song_tables, const QStringList &commands);
+  void ExecSongTablesCommands(QSqlDatabase &db, const QStringList &song_tables, const QStringList &subdirs_tables, const QStringList &commands);
 
   void UpdateDatabaseSchema(int version, QSqlDatabase &db);
   void UrlEncodeFilenameColumn(const QString &table, QSqlDatabase &db);
+  // Moves the long lyrics of the collection songs to the long text table.
+  void MoveLongText(QSqlDatabase &db);
   QStringList SongsTables(QSqlDatabase &db, const int schema_version);
+  static QStringList SubdirsTables(QSqlDatabase &db);
   bool IntegrityCheck(const QSqlDatabase &db);
   void BackupFile(const QString &filename);
+  void FinishBackup();
   static bool OpenDatabase(const QString &filename, sqlite3 **connection);
 
   SharedPtr<TaskManager> task_manager_;
@@ -108,10 +147,24 @@ class Database : public QObject {
   // Alias -> filename
   QMap<QString, AttachedDatabase> attached_databases_;
 
+  // Name -> filename
+  QMutex source_databases_mutex_;
+  QMap<QString, QString> source_databases_;
+
   QString directory_;
+  QString filename_;
+  bool created_;
   QMutex connect_mutex_;
   QRecursiveMutex mutex_;
 
+  // Connection name -> query -> prepared query
+  QMutex prepared_queries_mutex_;
+  QHash<QString, QHash<QString, SqlQuery>> prepared_queries_;
+  quint64 prepared_query_hits_;
+  quint64 prepared_query_misses_;
+
+  bool write_ahead_log_;
+
   // This ID makes the QSqlDatabase name unique to the object as well as the thread
   int connection_id_;
 
@@ -128,6 +181,14 @@ class Database : public QObject {
   int startup_schema_version_;
 
   QThread *original_thread_;
+
+  // Maintenance runs in the database thread, one short step at a time.
+  QTimer *timer_maintenance_;
+  qint64 analyze_change_counter_;
+  sqlite3 *backup_source_connection_;
+  sqlite3 *backup_dest_connection_;
+  sqlite3_backup *backup_;
+  int backup_task_id_;
 };
 
 #endif  // DATABASE_H
@@ -23,6 +23,14 @@
 
 #include <optional>
 
+#ifdef Q_OS_LINUX
+#  include <sys/ioctl.h>
+#  include <sys/stat.h>
+#  include <fcntl.h>
+#  include <unistd.h>
+#  include <linux/fs.h>
+#endif
+
 #include <QDir>
 #include <QFile>
 #include <QFileInfo>
@@ -34,8 +42,61 @@
 
 #include "filesystemmusicstorage.h"
 
+namespace {
+constexpr int kMaxConcurrentCopies = 3;
+
+#ifdef Q_OS_LINUX
+// Copies the file within the kernel, sharing the data blocks on filesystems with reflink support such as Btrfs and XFS.
+// Returns false without leaving a destination file if it's not possible, so the caller can fall back to a normal copy.
+bool CopyFileInKernel(const QString &source, const QString &destination) {
+
+  const int source_fd = open(QFile::encodeName(source).constData(), O_RDONLY | O_CLOEXEC);
+  if (source_fd == -1) return false;
+
+  struct stat source_stat {};
+  if (fstat(source_fd, &source_stat) != 0) {
+    close(source_fd);
+    return false;
+  }
+
+  const int destination_fd = open(QFile::encodeName(destination).constData(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, source_stat.st_mode & 0777);
+  if (destination_fd == -1) {
+    close(source_fd);
+    return false;
+  }
+
+  bool success = ioctl(destination_fd, FICLONE, source_fd) == 0;
+  if (!success) {
+    off_t remaining = source_stat.st_size;
+    while (remaining > 0) {
+      const ssize_t copied = copy_file_range(source_fd, nullptr, destination_fd, nullptr, static_cast<size_t>(remaining), 0);
+      if (copied <= 0) break;
+      remaining -= copied;
+    }
+    success = remaining == 0;
+  }
+
+  close(source_fd);
+  if (close(destination_fd) != 0) success = false;
+  if (!success) {
+    unlink(QFile::encodeName(destination).constData());
+  }
+
+  return success;
+
+}
+#endif  // Q_OS_LINUX
+
+}  // namespace
+
 FilesystemMusicStorage::FilesystemMusicStorage(const Song::Source source, const QString &root, const std::optional<int> collection_directory_id) : source_(source), root_(root), collection_directory_id_(collection_directory_id) {}
 
+int FilesystemMusicStorage::MaxConcurrentCopies() const {
+
+  return kMaxConcurrentCopies;
+
+}
+
 bool FilesystemMusicStorage::CopyToStorage(const CopyJob &job, QString &error_text) {
 
   const QFileInfo src = QFileInfo(job.source_);
@@ -74,6 +135,7 @@ bool FilesystemMusicStorage::CopyToStorage(const CopyJob &job, QString &error_te
       qLog(Error) << error_text;
     }
     else {
+      // This is a rename(2) when the destination is on the same filesystem, the data is only copied between filesystems.
       result = QFile::rename(src.absoluteFilePath(), dest.absoluteFilePath());
     }
     if ((!cover_dest.exists() || job.overwrite_) && !cover_src.filePath().isEmpty() && !cover_dest.filePath().isEmpty()) {
@@ -93,7 +155,11 @@ bool FilesystemMusicStorage::CopyToStorage(const CopyJob &job, QString &error_te
       qLog(Error) << error_text;
     }
     else {
+#ifdef Q_OS_LINUX
+      result = CopyFileInKernel(src.absoluteFilePath(), dest.absoluteFilePath()) || QFile::copy(src.absoluteFilePath(), dest.absoluteFilePath());
+#else
       result = QFile::copy(src.absoluteFilePath(), dest.absoluteFilePath());
+#endif
       if (!result) {
         error_text = QObject::tr("Could not copy file %1 to %2.").arg(src.absoluteFilePath(), dest.absoluteFilePath());
         qLog(Error) << error_text;
@@ -24,12 +24,24 @@
 
 #include "filesystemwatcherinterface.h"
 #include "qtfslistener.h"
+#ifdef Q_OS_LINUX
+#  include "inotifylistener.h"
+#endif
 
 FileSystemWatcherInterface::FileSystemWatcherInterface(QObject *parent)
     : QObject(parent) {}
 
 FileSystemWatcherInterface *FileSystemWatcherInterface::Create(QObject *parent) {
 
+#ifdef Q_OS_LINUX
+  InotifyListener *inotify_listener = new InotifyListener(parent);
+  if (inotify_listener->IsValid()) {
+    inotify_listener->Init();
+    return inotify_listener;
+  }
+  delete inotify_listener;
+#endif
+
   FileSystemWatcherInterface *listener = new QtFSListener(parent);
   listener->Init();
 
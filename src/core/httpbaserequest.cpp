@@ -89,6 +89,10 @@ QNetworkReply *HttpBaseRequest::CreateGetRequest(const QUrl &url, const QUrlQuer
   if (fake_user_agent_header) {
     network_request.setHeader(QNetworkRequest::UserAgentHeader, u"Mozilla/5.0 (X11; Linux x86_64; rv:122.0) Gecko/20100101 Firefox/122.0"_s);
   }
+  network_request.setPriority(request_priority());
+  if (cache_time() > 0) {
+    network_request.setAttribute(NetworkAccessManager::kCacheTimeAttribute, cache_time());
+  }
   QNetworkReply *reply = network_->get(network_request);
   QObject::connect(reply, &QNetworkReply::sslErrors, this, &HttpBaseRequest::HandleSSLErrors);
   replies_ << reply;
@@ -104,6 +108,7 @@ QNetworkReply *HttpBaseRequest::CreatePostRequest(const QUrl &url, const QByteAr
   QNetworkRequest network_request(url);
   network_request.setAttribute(QNetworkRequest::RedirectPolicyAttribute, QNetworkRequest::NoLessSafeRedirectPolicy);
   network_request.setHeader(QNetworkRequest::ContentTypeHeader, content_type_header);
+  network_request.setPriority(request_priority());
   if (use_authorization_header() && authenticated()) {
     network_request.setRawHeader("Authorization", authorization_header());
   }
@@ -27,6 +27,7 @@
 #include <QString>
 #include <QUrl>
 #include <QUrlQuery>
+#include <QNetworkRequest>
 #include <QNetworkReply>
 #include <QSslError>
 #include <QJsonDocument>
@@ -85,6 +86,9 @@ class HttpBaseRequest : public QObject {
   virtual bool authenticated() const = 0;
   virtual bool use_authorization_header() const = 0;
   virtual QByteArray authorization_header() const = 0;
+  virtual QNetworkRequest::Priority request_priority() const { return QNetworkRequest::NormalPriority; }
+  // Number of seconds to cache replies to get requests, 0 to follow the caching headers of the server.
+  virtual qint64 cache_time() const { return 0; }
 
   virtual QNetworkReply *CreateGetRequest(const QUrl &url, const bool fake_user_agent_header);
   virtual QNetworkReply *CreateGetRequest(const QUrl &url, const ParamList &params = ParamList(), const bool fake_user_agent_header = false);
@@ -0,0 +1,339 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "config.h"
+#include "version.h"
+
+#include <cmath>
+
+#include <QtGlobal>
+#include <QCoreApplication>
+#include <QObject>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QByteArray>
+#include <QDataStream>
+#include <QString>
+#include <QSize>
+#include <QRect>
+#include <QImage>
+#include <QPixmap>
+#include <QIcon>
+#include <QPainter>
+#include <QPaintDevice>
+#include <QTimer>
+
+#include "core/logging.h"
+#include "core/standardpaths.h"
+#include "iconcache.h"
+
+using namespace std::chrono_literals;
+using namespace Qt::Literals::StringLiterals;
+
+namespace {
+
+constexpr quint32 kMagic = 0x53494343;  // SICC
+constexpr quint32 kFormatVersion = 1;
+constexpr QDataStream::Version kDataStreamVersion = QDataStream::Qt_6_4;
+// Magic, format version and the offset of the index, the pixels of the icons follow.
+constexpr qint64 kHeaderSize = 16;
+// The pixels of each icon start at this alignment, so they can be used straight from the mapped file.
+constexpr qint64 kImageAlignment = 16;
+constexpr QImage::Format kImageFormat = QImage::Format_ARGB32_Premultiplied;
+
+}  // namespace
+
+IconCache::IconCache(QObject *parent)
+    : QObject(parent),
+      timer_save_(new QTimer(this)),
+      open_(false),
+      data_(nullptr) {
+
+  setObjectName(QLatin1String(QObject::metaObject()->className()));
+
+  timer_save_->setSingleShot(true);
+  timer_save_->setInterval(10s);
+  QObject::connect(timer_save_, &QTimer::timeout, this, &IconCache::Save);
+
+}
+
+IconCache::~IconCache() {
+
+  Close();
+
+}
+
+IconCache *IconCache::Instance() {
+
+  static IconCache *instance = new IconCache;
+  return instance;
+
+}
+
+QString IconCache::Filename() {
+
+  return StandardPaths::WritableLocation(StandardPaths::StandardLocation::CacheLocation) + "/icon-cache.bin"_L1;
+
+}
+
+QString IconCache::ThemeKey() {
+
+  return QIcon::themeName() + u'|' + QLatin1String(STRAWBERRY_VERSION_PACKAGE) + u'|' + QLatin1String(qVersion());
+
+}
+
+IconCache::Key IconCache::MakeKey(const QString &name, const QSize &size, const qreal device_pixel_ratio) {
+
+  return Key { name, size, static_cast<int>(std::lround(device_pixel_ratio * 100.0)) };
+
+}
+
+void IconCache::Open() {
+
+  if (open_) return;
+  open_ = true;
+
+  if (QCoreApplication::instance()) {
+    QObject::connect(QCoreApplication::instance(), &QCoreApplication::aboutToQuit, this, &IconCache::Save);
+  }
+
+  file_.setFileName(Filename());
+  if (!file_.exists() || !file_.open(QIODevice::ReadOnly)) return;
+
+  // The icons are used straight from the mapped file, the file stays mapped until it's written again.
+  data_ = file_.map(0, file_.size());
+  if (!data_) {
+    file_.close();
+    return;
+  }
+
+  const qint64 file_size = file_.size();
+  const QByteArray buffer = QByteArray::fromRawData(reinterpret_cast<const char*>(data_), static_cast<qsizetype>(file_size));
+  QDataStream s(buffer);
+  s.setVersion(kDataStreamVersion);
+
+  quint32 magic = 0;
+  quint32 format_version = 0;
+  qint64 index_offset = 0;
+  s >> magic >> format_version >> index_offset;
+  if (s.status() != QDataStream::Ok || magic != kMagic || format_version != kFormatVersion || index_offset < kHeaderSize || index_offset >= file_size) {
+    Close();
+    return;
+  }
+
+  s.skipRawData(static_cast<int>(index_offset - kHeaderSize));
+
+  QString theme_key;
+  qint64 count = 0;
+  s >> theme_key >> count;
+  if (s.status() != QDataStream::Ok || count < 0) {
+    Close();
+    return;
+  }
+
+  if (theme_key != ThemeKey()) {
+    qLog(Debug) << "Icon cache is for another icon theme or version, rebuilding it";
+    Close();
+    return;
+  }
+
+  mapped_images_.reserve(static_cast<qsizetype>(count));
+  for (qint64 i = 0; i < count && s.status() == QDataStream::Ok; ++i) {
+    QString name;
+    qint32 width = 0;
+    qint32 height = 0;
+    qint32 device_pixel_ratio_percent = 0;
+    MappedImage mapped_image{};
+    qint32 image_width = 0;
+    qint32 image_height = 0;
+    qint32 bytes_per_line = 0;
+    s >> name >> width >> height >> device_pixel_ratio_percent >> mapped_image.offset >> image_width >> image_height >> bytes_per_line;
+    if (mapped_image.offset < kHeaderSize || image_width <= 0 || image_height <= 0 || bytes_per_line < image_width * 4 || mapped_image.offset + static_cast<qint64>(image_height) * bytes_per_line > index_offset) {
+      s.setStatus(QDataStream::ReadCorruptData);
+      break;
+    }
+    mapped_image.width = image_width;
+    mapped_image.height = image_height;
+    mapped_image.bytes_per_line = bytes_per_line;
+    mapped_images_.insert(Key { name, QSize(width, height), device_pixel_ratio_percent }, mapped_image);
+  }
+
+  if (s.status() != QDataStream::Ok) {
+    qLog(Warning) << "Icon cache is corrupt";
+    Close();
+    return;
+  }
+
+  qLog(Debug) << "Loaded" << mapped_images_.count() << "icons from the icon cache";
+
+}
+
+void IconCache::Close() {
+
+  mapped_images_.clear();
+  if (data_) {
+    file_.unmap(data_);
+    data_ = nullptr;
+  }
+  if (file_.isOpen()) file_.close();
+
+}
+
+QImage IconCache::Image(const QString &name, const QSize &size, const qreal device_pixel_ratio) const {
+
+  const Key key = MakeKey(name, size, device_pixel_ratio);
+
+  const QHash<Key, QImage>::const_iterator new_image = new_images_.constFind(key);
+  if (new_image != new_images_.constEnd()) return new_image.value();
+
+  const QHash<Key, MappedImage>::const_iterator mapped_image = mapped_images_.constFind(key);
+  if (mapped_image == mapped_images_.constEnd() || !data_) return QImage();
+
+  // Read only image using the mapped pixels.
+  return QImage(static_cast<const uchar*>(data_ + mapped_image->offset), mapped_image->width, mapped_image->height, mapped_image->bytes_per_line, kImageFormat);
+
+}
+
+void IconCache::Insert(const QString &name, const QSize &size, const qreal device_pixel_ratio, const QImage &image) {
+
+  if (!open_ || image.isNull()) return;
+
+  new_images_.insert(MakeKey(name, size, device_pixel_ratio), image.convertToFormat(kImageFormat));
+  timer_save_->start();
+
+}
+
+void IconCache::Save() {
+
+  timer_save_->stop();
+
+  if (!open_ || new_images_.isEmpty()) return;
+
+  // A mapped file can't be replaced on all platforms, so the mapped icons are copied before it's written again.
+  for (QHash<Key, MappedImage>::const_iterator it = mapped_images_.constBegin(); it != mapped_images_.constEnd(); ++it) {
+    if (new_images_.contains(it.key())) continue;
+    new_images_.insert(it.key(), QImage(static_cast<const uchar*>(data_ + it->offset), it->width, it->height, it->bytes_per_line, kImageFormat).copy());
+  }
+  Close();
+
+  const QString filename = Filename();
+  if (!QDir().mkpath(QFileInfo(filename).path())) return;
+
+  QSaveFile file(filename);
+  if (!file.open(QIODevice::WriteOnly)) {
+    qLog(Warning) << "Could not open" << filename << "for writing" << file.errorString();
+    return;
+  }
+
+  QDataStream s(&file);
+  s.setVersion(kDataStreamVersion);
+  s << kMagic << kFormatVersion << static_cast<qint64>(0);
+
+  QHash<Key, qint64> offsets;
+  offsets.reserve(new_images_.count());
+  for (QHash<Key, QImage>::const_iterator it = new_images_.constBegin(); it != new_images_.constEnd(); ++it) {
+    const qint64 padding = (kImageAlignment - (file.pos() % kImageAlignment)) % kImageAlignment;
+    if (padding > 0) s.writeRawData(QByteArray(static_cast<qsizetype>(padding), '\0').constData(), static_cast<int>(padding));
+    offsets.insert(it.key(), file.pos());
+    s.writeRawData(reinterpret_cast<const char*>(it->constBits()), static_cast<int>(it->sizeInBytes()));
+  }
+
+  const qint64 index_offset = file.pos();
+  s << ThemeKey() << static_cast<qint64>(new_images_.count());
+  for (QHash<Key, QImage>::const_iterator it = new_images_.constBegin(); it != new_images_.constEnd(); ++it) {
+    s << it.key().name << static_cast<qint32>(it.key().size.width()) << static_cast<qint32>(it.key().size.height()) << static_cast<qint32>(it.key().device_pixel_ratio_percent);
+    s << offsets.value(it.key()) << static_cast<qint32>(it->width()) << static_cast<qint32>(it->height()) << static_cast<qint32>(it->bytesPerLine());
+  }
+
+  file.seek(8);
+  s << index_offset;
+
+  if (s.status() != QDataStream::Ok || !file.commit()) {
+    qLog(Warning) << "Could not write icon cache" << filename << file.errorString();
+    return;
+  }
+
+  qLog(Debug) << "Wrote" << new_images_.count() << "icons to the icon cache";
+
+}
+
+IconCacheEngine::IconCacheEngine(const QString &name, const QIcon &theme_icon)
+    : name_(name),
+      theme_icon_(theme_icon) {}
+
+QString IconCacheEngine::key() const {
+
+  return u"IconCacheEngine"_s;
+
+}
+
+QIconEngine *IconCacheEngine::clone() const {
+
+  return new IconCacheEngine(name_, theme_icon_);
+
+}
+
+void IconCacheEngine::paint(QPainter *painter, const QRect &rect, QIcon::Mode mode, QIcon::State state) {
+
+  const qreal device_pixel_ratio = painter->device() ? painter->device()->devicePixelRatioF() : 1.0;
+  painter->drawPixmap(rect, scaledPixmap(rect.size(), mode, state, device_pixel_ratio));
+
+}
+
+QPixmap IconCacheEngine::pixmap(const QSize &size, QIcon::Mode mode, QIcon::State state) {
+
+  return scaledPixmap(size, mode, state, 1.0);
+
+}
+
+QPixmap IconCacheEngine::scaledPixmap(const QSize &size, QIcon::Mode mode, QIcon::State state, qreal scale) {
+
+  // The other modes and states are generated from the normal pixmap by the style, or come with the theme, so they are left to the theme icon.
+  if (mode != QIcon::Normal || state != QIcon::Off || size.isEmpty()) {
+    return theme_icon_.pixmap(size, scale, mode, state);
+  }
+
+  IconCache *icon_cache = IconCache::Instance();
+  const QImage image = icon_cache->Image(name_, size, scale);
+  if (!image.isNull()) {
+    QPixmap pixmap = QPixmap::fromImage(image);
+    pixmap.setDevicePixelRatio(scale);
+    return pixmap;
+  }
+
+  const QPixmap pixmap = theme_icon_.pixmap(size, scale, mode, state);
+  icon_cache->Insert(name_, size, scale, pixmap.toImage());
+
+  return pixmap;
+
+}
+
+QSize IconCacheEngine::actualSize(const QSize &size, QIcon::Mode mode, QIcon::State state) {
+
+  return theme_icon_.actualSize(size, mode, state);
+
+}
+
+QList<QSize> IconCacheEngine::availableSizes(QIcon::Mode mode, QIcon::State state) {
+
+  return theme_icon_.availableSizes(mode, state);
+
+}
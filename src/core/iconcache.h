@@ -0,0 +1,117 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef ICONCACHE_H
+#define ICONCACHE_H
+
+#include "config.h"
+
+#include <QtGlobal>
+#include <QObject>
+#include <QList>
+#include <QHash>
+#include <QHashFunctions>
+#include <QFile>
+#include <QString>
+#include <QSize>
+#include <QImage>
+#include <QPixmap>
+#include <QIcon>
+#include <QIconEngine>
+
+class QTimer;
+class QPainter;
+
+// Persistent cache of the theme icons, rasterized at the sizes they were painted at, so the SVG icons don't have to be rendered again on every startup.
+// The cache file is mapped when opened and written again after new icons were rasterized.
+// It's dropped when the icon theme or the version of Strawberry or Qt changes.
+// Only to be used from the GUI thread.
+class IconCache : public QObject {
+  Q_OBJECT
+
+ public:
+  static IconCache *Instance();
+
+  void Open();
+  bool is_open() const { return open_; }
+
+  // Returns a null image when the icon isn't cached.
+  QImage Image(const QString &name, const QSize &size, const qreal device_pixel_ratio) const;
+  void Insert(const QString &name, const QSize &size, const qreal device_pixel_ratio, const QImage &image);
+
+ private Q_SLOTS:
+  void Save();
+
+ private:
+  explicit IconCache(QObject *parent = nullptr);
+  ~IconCache() override;
+
+  static QString Filename();
+  static QString ThemeKey();
+  void Close();
+
+  struct Key {
+    QString name;
+    QSize size;
+    int device_pixel_ratio_percent;
+
+    bool operator==(const Key &other) const { return name == other.name && size == other.size && device_pixel_ratio_percent == other.device_pixel_ratio_percent; }
+    friend size_t qHash(const Key &key, const size_t seed = 0) { return qHashMulti(seed, key.name, key.size.width(), key.size.height(), key.device_pixel_ratio_percent); }
+  };
+  static Key MakeKey(const QString &name, const QSize &size, const qreal device_pixel_ratio);
+
+  // Position of the pixels of an icon in the mapped file.
+  struct MappedImage {
+    qint64 offset;
+    int width;
+    int height;
+    int bytes_per_line;
+  };
+
+  QTimer *timer_save_;
+  bool open_;
+  QFile file_;
+  uchar *data_;
+  QHash<Key, MappedImage> mapped_images_;
+  QHash<Key, QImage> new_images_;
+
+  Q_DISABLE_COPY(IconCache)
+};
+
+// Paints a theme icon from the icon cache, the theme icon is only rendered for sizes that aren't cached yet.
+class IconCacheEngine : public QIconEngine {
+ public:
+  explicit IconCacheEngine(const QString &name, const QIcon &theme_icon);
+
+  void paint(QPainter *painter, const QRect &rect, QIcon::Mode mode, QIcon::State state) override;
+  QPixmap pixmap(const QSize &size, QIcon::Mode mode, QIcon::State state) override;
+  QPixmap scaledPixmap(const QSize &size, QIcon::Mode mode, QIcon::State state, qreal scale) override;
+  QSize actualSize(const QSize &size, QIcon::Mode mode, QIcon::State state) override;
+  QList<QSize> availableSizes(QIcon::Mode mode, QIcon::State state) override;
+  QString iconName() override { return name_; }
+  bool isNull() override { return theme_icon_.isNull(); }
+  QString key() const override;
+  QIconEngine *clone() const override;
+
+ private:
+  QString name_;
+  QIcon theme_icon_;
+};
+
+#endif  // ICONCACHE_H
@@ -33,6 +33,7 @@
 #include "standardpaths.h"
 #include "settings.h"
 #include "includes/iconmapper.h"
+#include "iconcache.h"
 #include "iconloader.h"
 #include "constants/appearancesettings.h"
 
@@ -50,6 +51,11 @@ void IconLoader::Init() {
   s.endGroup();
 #endif
 
+  // Only the theme icons can be SVG icons, the icons that come with Strawberry and the custom icons are already PNG.
+  if (system_icons_) {
+    IconCache::Instance()->Open();
+  }
+
   QDir dir;
   if (dir.exists(StandardPaths::WritableLocation(StandardPaths::StandardLocation::AppLocalDataLocation) + u"/icons"_s)) {
     custom_icons_ = true;
@@ -121,7 +127,7 @@ QIcon IconLoader::Load(const QString &name, const bool system_icon, const int fi
         }
       }
     }
-    if (!ret.isNull()) return ret;
+    if (!ret.isNull()) return QIcon(new IconCacheEngine(name, ret));
   }
 
   if (custom_icons_) {
@@ -0,0 +1,178 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "config.h"
+
+#include <cstring>
+#include <cerrno>
+#include <utility>
+#include <unistd.h>
+#include <sys/inotify.h>
+
+#include <QObject>
+#include <QFile>
+#include <QSocketNotifier>
+#include <QTimer>
+#include <QString>
+
+#include "core/logging.h"
+#include "inotifylistener.h"
+
+namespace {
+constexpr uint32_t kWatchMask = IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_CLOSE_WRITE | IN_DELETE_SELF | IN_MOVE_SELF | IN_ONLYDIR;
+constexpr int kEmitChangedPathsDelay = 100;
+}  // namespace
+
+InotifyListener::InotifyListener(QObject *parent)
+    : FileSystemWatcherInterface(parent),
+      fd_(::inotify_init1(IN_NONBLOCK | IN_CLOEXEC)),
+      socket_notifier_(nullptr),
+      timer_emit_changed_paths_(new QTimer(this)),
+      watch_limit_reached_(false) {
+
+  if (fd_ == -1) {
+    qLog(Error) << "Failed to initialize inotify:" << ::strerror(errno);
+    return;
+  }
+
+  timer_emit_changed_paths_->setSingleShot(true);
+  timer_emit_changed_paths_->setInterval(kEmitChangedPathsDelay);
+  QObject::connect(timer_emit_changed_paths_, &QTimer::timeout, this, &InotifyListener::EmitChangedPaths);
+
+  socket_notifier_ = new QSocketNotifier(fd_, QSocketNotifier::Read, this);
+  QObject::connect(socket_notifier_, &QSocketNotifier::activated, this, &InotifyListener::ReadEvents);
+
+}
+
+InotifyListener::~InotifyListener() {
+
+  if (socket_notifier_) {
+    socket_notifier_->setEnabled(false);
+  }
+
+  if (fd_ != -1) {
+    ::close(fd_);
+    fd_ = -1;
+  }
+
+}
+
+void InotifyListener::AddPath(const QString &path) {
+
+  if (fd_ == -1 || path_watches_.contains(path)) return;
+
+  const int wd = ::inotify_add_watch(fd_, QFile::encodeName(path).constData(), kWatchMask);
+  if (wd == -1) {
+    if (errno == ENOSPC) {
+      if (!watch_limit_reached_) {
+        qLog(Error) << "Failed to add watch for path" << path << "the inotify watch limit is reached, increase fs.inotify.max_user_watches to monitor the whole collection.";
+        watch_limit_reached_ = true;
+      }
+    }
+    else {
+      qLog(Error) << "Failed to add watch for path" << path << ::strerror(errno);
+    }
+    return;
+  }
+
+  watch_paths_.insert(wd, path);
+  path_watches_.insert(path, wd);
+
+}
+
+void InotifyListener::RemovePath(const QString &path) {
+
+  const QHash<QString, int>::iterator it = path_watches_.find(path);
+  if (it == path_watches_.end()) {
+    qLog(Error) << "Failed to remove watch for path" << path;
+    return;
+  }
+
+  const int wd = it.value();
+  path_watches_.erase(it);
+  watch_paths_.remove(wd);
+  changed_paths_.remove(path);
+
+  ::inotify_rm_watch(fd_, wd);
+
+}
+
+void InotifyListener::Clear() {
+
+  for (QHash<int, QString>::const_iterator it = watch_paths_.constBegin(); it != watch_paths_.constEnd(); ++it) {
+    ::inotify_rm_watch(fd_, it.key());
+  }
+
+  watch_paths_.clear();
+  path_watches_.clear();
+  changed_paths_.clear();
+  timer_emit_changed_paths_->stop();
+  watch_limit_reached_ = false;
+
+}
+
+void InotifyListener::ReadEvents() {
+
+  alignas(struct inotify_event) char buffer[4096];
+
+  Q_FOREVER {
+    const ssize_t len = ::read(fd_, buffer, sizeof(buffer));
+    if (len <= 0) break;
+
+    for (char *ptr = buffer; ptr < buffer + len;) {
+      const struct inotify_event *event = reinterpret_cast<const struct inotify_event*>(ptr);
+      ptr += sizeof(struct inotify_event) + event->len;
+
+      if (event->mask & IN_Q_OVERFLOW) {
+        // Events were lost, so every directory might have changed.
+        for (const QString &path : std::as_const(watch_paths_)) {
+          changed_paths_.insert(path);
+        }
+        continue;
+      }
+
+      const QHash<int, QString>::const_iterator it = watch_paths_.constFind(event->wd);
+      if (it == watch_paths_.constEnd()) continue;
+
+      changed_paths_.insert(it.value());
+
+      if (event->mask & IN_IGNORED) {
+        // The kernel removed the watch because the directory was deleted or unmounted.
+        path_watches_.remove(it.value());
+        watch_paths_.remove(event->wd);
+      }
+    }
+  }
+
+  if (!changed_paths_.isEmpty() && !timer_emit_changed_paths_->isActive()) {
+    timer_emit_changed_paths_->start();
+  }
+
+}
+
+void InotifyListener::EmitChangedPaths() {
+
+  const QSet<QString> changed_paths = changed_paths_;
+  changed_paths_.clear();
+
+  for (const QString &path : changed_paths) {
+    Q_EMIT PathChanged(path);
+  }
+
+}
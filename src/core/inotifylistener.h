@@ -0,0 +1,64 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef INOTIFYLISTENER_H
+#define INOTIFYLISTENER_H
+
+#include "config.h"
+
+#include <QObject>
+#include <QHash>
+#include <QSet>
+#include <QString>
+
+#include "filesystemwatcherinterface.h"
+
+class QSocketNotifier;
+class QTimer;
+
+// Watches directories using a single inotify file descriptor.
+// Only directory content changes are requested from the kernel, and changes are coalesced per directory before PathChanged is emitted.
+class InotifyListener : public FileSystemWatcherInterface {
+  Q_OBJECT
+
+ public:
+  explicit InotifyListener(QObject *parent = nullptr);
+  ~InotifyListener() override;
+
+  bool IsValid() const { return fd_ != -1; }
+
+  void AddPath(const QString &path) override;
+  void RemovePath(const QString &path) override;
+  void Clear() override;
+
+ private Q_SLOTS:
+  void ReadEvents();
+  void EmitChangedPaths();
+
+ private:
+  int fd_;
+  QSocketNotifier *socket_notifier_;
+  QTimer *timer_emit_changed_paths_;
+  QHash<int, QString> watch_paths_;
+  QHash<QString, int> path_watches_;
+  QSet<QString> changed_paths_;
+  bool watch_limit_reached_;
+};
+
+#endif  // INOTIFYLISTENER_H
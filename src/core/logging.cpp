@@ -27,6 +27,11 @@
 #include <utility>
 #include <memory>
 #include <chrono>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <type_traits>
 
 #ifndef _MSC_VER
 #  include <cxxabi.h>
@@ -73,8 +78,225 @@ const char *kDefaultLogLevels = "*:3";
 
 static constexpr char kMessageHandlerMagic[] = "__logging_message__";
 static const size_t kMessageHandlerMagicLen = strlen(kMessageHandlerMagic);
+static constexpr char kTimeSeparator = '|';
 static QtMessageHandler sOriginalMessageHandler = nullptr;
 
+// Messages queued by a writer thread are dropped when this many are waiting, so a flood can't use up all memory.
+static constexpr int kMaxPendingMessages = 100000;
+
+// Writes log messages from a background thread, so logging threads don't wait for stdout or stderr.
+// Messages are pushed onto a lock-free list, the writer takes the whole list at once.
+// The time of each message is formatted by the writer, and consecutive repeats of a message are collapsed.
+class LogWriter {
+ public:
+  LogWriter() : head_(nullptr), pending_(0), dropped_(0), running_(false), last_error_(false), repeated_(0) {}
+
+  struct Message {
+    Message *next;
+    qint64 msecs;
+    bool error;
+    QByteArray text;
+  };
+
+  void Start() {
+    running_ = true;
+    thread_ = std::thread(&LogWriter::Run, this);
+  }
+
+  void Stop() {
+    if (!running_.exchange(false)) return;
+    {
+      std::lock_guard<std::mutex> l(wake_mutex_);
+    }
+    wake_.notify_one();
+    thread_.join();
+    Flush();
+  }
+
+  // Takes ownership of message, returns false if the writer isn't running.
+  bool Enqueue(Message *message) {
+
+    if (!running_.load(std::memory_order_relaxed)) return false;
+
+    if (pending_.fetch_add(1, std::memory_order_relaxed) >= kMaxPendingMessages) {
+      pending_.fetch_sub(1, std::memory_order_relaxed);
+      dropped_.fetch_add(1, std::memory_order_relaxed);
+      delete message;
+      return true;
+    }
+
+    Message *head = head_.load(std::memory_order_relaxed);
+    do {
+      message->next = head;
+    } while (!head_.compare_exchange_weak(head, message, std::memory_order_release, std::memory_order_relaxed));
+
+    // Only wake up the writer when the list was empty, it takes everything queued until then.
+    if (!head) {
+      {
+        std::lock_guard<std::mutex> l(wake_mutex_);
+      }
+      wake_.notify_one();
+    }
+
+    return true;
+
+  }
+
+  // Writes all queued messages from the calling thread.
+  void Flush() {
+
+    std::lock_guard<std::mutex> l(write_mutex_);
+    WriteQueued();
+
+  }
+
+  // Writes a message directly, after the queued messages.
+  void WriteNow(const qint64 msecs, const bool error, const QByteArray &text) {
+
+    std::lock_guard<std::mutex> l(write_mutex_);
+    WriteQueued();
+    Write(msecs, error, text);
+    WriteRepeated();
+    fflush(stdout);
+    fflush(stderr);
+
+  }
+
+ private:
+  void Run() {
+
+    while (running_) {
+      {
+        std::unique_lock<std::mutex> l(wake_mutex_);
+        wake_.wait(l, [this]() { return !running_ || head_.load(std::memory_order_acquire) != nullptr; });
+      }
+      Flush();
+    }
+
+  }
+
+  void WriteQueued() {
+
+    Message *message = head_.exchange(nullptr, std::memory_order_acquire);
+
+    // The list is newest first.
+    Message *oldest = nullptr;
+    while (message) {
+      Message *next = message->next;
+      message->next = oldest;
+      oldest = message;
+      message = next;
+    }
+
+    int count = 0;
+    while (oldest) {
+      Message *next = oldest->next;
+      Write(oldest->msecs, oldest->error, oldest->text);
+      delete oldest;
+      oldest = next;
+      ++count;
+    }
+    pending_.fetch_sub(count, std::memory_order_relaxed);
+
+    WriteRepeated();
+
+    const quint64 dropped = dropped_.exchange(0, std::memory_order_relaxed);
+    if (dropped > 0) {
+      fprintf(stderr, "%s Dropped %llu log messages\n", FormatTime(QDateTime::currentMSecsSinceEpoch()).constData(), static_cast<unsigned long long>(dropped));
+    }
+
+    if (count > 0 || dropped > 0) {
+      fflush(stdout);
+      fflush(stderr);
+    }
+
+  }
+
+  void Write(const qint64 msecs, const bool error, const QByteArray &text) {
+
+    if (msecs != -1 && error == last_error_ && text == last_text_) {
+      last_msecs_ = msecs;
+      ++repeated_;
+      return;
+    }
+
+    WriteRepeated();
+
+    FILE *file = error ? stderr : stdout;
+    if (msecs == -1) {
+      fprintf(file, "%s\n", text.constData());
+    }
+    else {
+      fprintf(file, "%s%s\n", FormatTime(msecs).constData(), text.constData());
+    }
+
+    last_msecs_ = msecs;
+    last_error_ = error;
+    last_text_ = msecs == -1 ? QByteArray() : text;
+
+  }
+
+  // Repeats are written once per batch, which limits a message logged in a loop to one line each time the writer runs.
+  void WriteRepeated() {
+
+    if (repeated_ == 0) return;
+
+    fprintf(last_error_ ? stderr : stdout, "%s Last message repeated %d times\n", FormatTime(last_msecs_).constData(), repeated_);
+    repeated_ = 0;
+    last_text_.clear();
+
+  }
+
+  static QByteArray FormatTime(const qint64 msecs) {
+    return QDateTime::fromMSecsSinceEpoch(msecs).toString(u"hh:mm:ss.zzz"_s).toLatin1();
+  }
+
+  std::atomic<Message*> head_;
+  std::atomic<int> pending_;
+  std::atomic<quint64> dropped_;
+  std::atomic<bool> running_;
+  std::thread thread_;
+  std::mutex wake_mutex_;
+  std::condition_variable wake_;
+
+  // Used by the thread that is writing.
+  std::mutex write_mutex_;
+  qint64 last_msecs_ = 0;
+  bool last_error_;
+  QByteArray last_text_;
+  int repeated_;
+};
+
+// Never deleted, messages can still be logged while static objects are destroyed.
+static LogWriter *sLogWriter = nullptr;
+
+static void StopLogWriter() {
+  if (sLogWriter) sLogWriter->Stop();
+}
+
+static void WriteMessage(const qint64 msecs, const bool error, const QByteArray &text) {
+
+  if (sLogWriter) {
+    if (!error) {
+      LogWriter::Message *message = new LogWriter::Message { nullptr, msecs, error, text };
+      if (sLogWriter->Enqueue(message)) return;
+      delete message;
+    }
+    sLogWriter->WriteNow(msecs, error, text);
+    return;
+  }
+
+  FILE *file = error ? stderr : stdout;
+  if (msecs == -1) {
+    fprintf(file, "%s\n", text.constData());
+  }
+  else {
+    fprintf(file, "%s%s\n", QDateTime::fromMSecsSinceEpoch(msecs).toString(u"hh:mm:ss.zzz"_s).toLatin1().constData(), text.constData());
+  }
+  fflush(file);
+
+}
+
 template<class T>
 static T CreateLogger(Level level, const QString &class_name, int line, const char *category);
 
@@ -145,9 +367,17 @@ static void MessageHandler(QtMsgType type, const QMessageLogContext &message_log
   Q_UNUSED(message_log_context)
 
   if (message.startsWith(QLatin1String(kMessageHandlerMagic))) {
-    QByteArray message_data = message.toUtf8();
-    fprintf(type == QtCriticalMsg || type == QtFatalMsg ? stderr : stdout, "%s\n", message_data.constData() + kMessageHandlerMagicLen);
-    fflush(type == QtCriticalMsg || type == QtFatalMsg ? stderr : stdout);
+    const QByteArray message_data = message.toUtf8();
+    // The message starts with the time in milliseconds since the epoch, which is formatted when the message is written.
+    const qsizetype separator = message_data.indexOf(kTimeSeparator, static_cast<qsizetype>(kMessageHandlerMagicLen));
+    bool ok = false;
+    const qint64 msecs = separator == -1 ? -1 : message_data.mid(static_cast<qsizetype>(kMessageHandlerMagicLen), separator - static_cast<qsizetype>(kMessageHandlerMagicLen)).toLongLong(&ok);
+    if (ok) {
+      WriteMessage(msecs, type == QtCriticalMsg || type == QtFatalMsg, message_data.mid(separator + 1));
+    }
+    else {
+      WriteMessage(-1, type == QtCriticalMsg || type == QtFatalMsg, message_data.mid(static_cast<qsizetype>(kMessageHandlerMagicLen)));
+    }
     return;
   }
 
@@ -172,8 +402,7 @@ static void MessageHandler(QtMsgType type, const QMessageLogContext &message_log
     d << line.toLocal8Bit().constData();
     if (d.buf_) {
       d.buf_->close();
-      fprintf(type == QtCriticalMsg || type == QtFatalMsg ? stderr : stdout, "%s\n", d.buf_->buffer().constData());
-      fflush(type == QtCriticalMsg || type == QtFatalMsg ? stderr : stdout);
+      WriteMessage(-1, type == QtCriticalMsg || type == QtFatalMsg, d.buf_->buffer());
     }
   }
 
@@ -197,6 +426,12 @@ void Init() {
     sOriginalMessageHandler = qInstallMessageHandler(MessageHandler);
   }
 
+  if (!sLogWriter) {
+    sLogWriter = new LogWriter;
+    sLogWriter->Start();
+    std::atexit(StopLogWriter);
+  }
+
 }
 
 void SetLevels(const QString &levels) {
@@ -295,7 +530,12 @@ static T CreateLogger(Level level, const QString &class_name, int line, const ch
   }
 
   T ret(type);
-  ret.nospace() << QDateTime::currentDateTime().toString(u"hh:mm:ss.zzz"_s).toLatin1().constData() << level_name << function_line.leftJustified(32).toLatin1().constData();
+  if constexpr (std::is_same_v<T, LoggedDebug>) {
+    ret.nospace() << QDateTime::currentMSecsSinceEpoch() << kTimeSeparator << level_name << function_line.leftJustified(32).toLatin1().constData();
+  }
+  else {
+    ret.nospace() << QDateTime::currentDateTime().toString(u"hh:mm:ss.zzz"_s).toLatin1().constData() << level_name << function_line.leftJustified(32).toLatin1().constData();
+  }
 
   return ret.space();
 
@@ -0,0 +1,111 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "config.h"
+
+#include <atomic>
+#include <chrono>
+
+#include <QObject>
+#include <QCoreApplication>
+#include <QThread>
+#include <QMetaObject>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QString>
+#include <QStringList>
+
+#include "includes/shared_ptr.h"
+#include "core/logging.h"
+#include "core/tracing.h"
+#include "mainthreadwatchdog.h"
+
+using std::make_shared;
+using namespace std::chrono_literals;
+using namespace Qt::Literals::StringLiterals;
+
+namespace {
+constexpr std::chrono::milliseconds kCheckInterval = 100ms;
+constexpr qint64 kStallThresholdMsec = 500;
+}  // namespace
+
+MainThreadWatchdog::MainThreadWatchdog(QObject *parent)
+    : QObject(parent),
+      timer_check_(new QTimer(this)),
+      main_thread_id_(QThread::currentThreadId()),
+      heartbeat_posted_msec_(0),
+      heartbeat_serial_(0),
+      heartbeat_answered_serial_(make_shared<std::atomic<quint64>>(0)),
+      stall_reported_(false) {
+
+  setObjectName(QLatin1String(QObject::metaObject()->className()));
+
+  Q_ASSERT(QThread::currentThread() == QCoreApplication::instance()->thread());
+
+  timer_check_->setInterval(kCheckInterval);
+  QObject::connect(timer_check_, &QTimer::timeout, this, &MainThreadWatchdog::Check);
+
+}
+
+MainThreadWatchdog::~MainThreadWatchdog() {
+
+  tracing::SetTrackOpenSpans(false);
+
+}
+
+void MainThreadWatchdog::Start() {
+
+  tracing::SetTrackOpenSpans(true);
+
+  elapsed_.start();
+  PostHeartbeat();
+  timer_check_->start();
+
+}
+
+void MainThreadWatchdog::PostHeartbeat() {
+
+  const quint64 serial = ++heartbeat_serial_;
+  heartbeat_posted_msec_ = elapsed_.elapsed();
+  QMetaObject::invokeMethod(QCoreApplication::instance(), [answered_serial = heartbeat_answered_serial_, serial]() { answered_serial->store(serial, std::memory_order_release); }, Qt::QueuedConnection);
+
+}
+
+void MainThreadWatchdog::Check() {
+
+  const qint64 waited_msec = elapsed_.elapsed() - heartbeat_posted_msec_;
+
+  if (heartbeat_answered_serial_->load(std::memory_order_acquire) == heartbeat_serial_) {
+    if (stall_reported_) {
+      qLog(Warning) << "Main thread was blocked for about" << waited_msec << "ms, open trace spans:" << (stall_spans_.isEmpty() ? u"none"_s : stall_spans_.join(" > "_L1));
+      stall_reported_ = false;
+      stall_spans_.clear();
+    }
+    PostHeartbeat();
+    return;
+  }
+
+  // Report once while the stall is ongoing, the spans that are open now are the ones blocking.
+  if (!stall_reported_ && waited_msec >= kStallThresholdMsec) {
+    stall_spans_ = tracing::OpenSpans(main_thread_id_);
+    qLog(Warning) << "Main thread blocked for" << waited_msec << "ms, open trace spans:" << (stall_spans_.isEmpty() ? u"none"_s : stall_spans_.join(" > "_L1));
+    stall_reported_ = true;
+  }
+
+}
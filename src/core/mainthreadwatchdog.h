@@ -0,0 +1,68 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef MAINTHREADWATCHDOG_H
+#define MAINTHREADWATCHDOG_H
+
+#include "config.h"
+
+#include <atomic>
+
+#include <QtGlobal>
+#include <QObject>
+#include <QStringList>
+#include <QElapsedTimer>
+
+#include "includes/shared_ptr.h"
+
+class QTimer;
+
+// Detects stalls of the main event loop from another thread.
+// A heartbeat is posted to the main thread, when it isn't answered in time the trace spans open in the main thread are logged, so the stall can be attributed.
+// Meant to be moved to its own thread, Start() is called from there.
+class MainThreadWatchdog : public QObject {
+  Q_OBJECT
+
+ public:
+  explicit MainThreadWatchdog(QObject *parent = nullptr);
+  ~MainThreadWatchdog() override;
+
+ public Q_SLOTS:
+  void Start();
+
+ private Q_SLOTS:
+  void Check();
+
+ private:
+  void PostHeartbeat();
+
+  QTimer *timer_check_;
+  Qt::HANDLE main_thread_id_;
+  QElapsedTimer elapsed_;
+  qint64 heartbeat_posted_msec_;
+  quint64 heartbeat_serial_;
+  // Shared with the heartbeats, which may still be queued in the main thread when this is deleted.
+  SharedPtr<std::atomic<quint64>> heartbeat_answered_serial_;
+  bool stall_reported_;
+  QStringList stall_spans_;
+
+  Q_DISABLE_COPY(MainThreadWatchdog)
+};
+
+#endif  // MAINTHREADWATCHDOG_H
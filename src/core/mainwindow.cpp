@@ -79,6 +79,7 @@
 #endif
 
 #include "core/logging.h"
+#include "core/wakeupstatistics.h"
 
 #include "mainwindow.h"
 #include "ui_mainwindow.h"
@@ -99,7 +100,9 @@
 #include "core/filesystemmusicstorage.h"
 #include "core/deletefiles.h"
 #include "core/settings.h"
+#include "core/settingsstore.h"
 #include "core/player.h"
+#include "core/transportcontrol.h"
 #include "utilities/envutils.h"
 #include "utilities/filemanagerutils.h"
 #include "utilities/screenutils.h"
@@ -299,7 +302,16 @@ MainWindow::MainWindow(Application *app,
       discord_rich_presence_(discord_rich_presence),
 #endif
       console_([app, this]() {
-        Console *console = new Console(app->database());
+        Console *console = new Console(app->database(),
+                                       app->tagreader_client(),
+                                       app->albumcover_loader(),
+                                       app->player(),
+                                       app->playlist_manager(),
+                                       app->scrobbler(),
+#ifdef HAVE_MOODBAR
+                                       app->moodbar_loader(),
+#endif
+                                       app->collection_model());
         QObject::connect(console, &Console::Error, this, &MainWindow::ShowErrorDialog);
         return console;
       }),
@@ -396,8 +408,11 @@ MainWindow::MainWindow(Application *app,
       doubleclick_playlist_addmode_(BehaviourSettings::PlaylistAddBehaviour::Play),
       menu_playmode_(BehaviourSettings::PlayBehaviour::Never),
       initialized_(false),
+      first_frame_shown_(false),
       was_maximized_(true),
       was_minimized_(false),
+      low_power_mode_enabled_(true),
+      low_power_mode_(false),
       exit_(false),
       exit_count_(0),
       playlists_loaded_(false),
@@ -419,7 +434,7 @@ MainWindow::MainWindow(Application *app,
   album_cover_choice_controller_->Init(app->network(), app->tagreader_client(), app->collection()->backend(), app->albumcover_loader(), app->current_albumcover_loader(), app->cover_providers(), app->streaming_services());
 
   ui_->multi_loading_indicator->SetTaskManager(app_->task_manager());
-  context_view_->Init(collection_view_->view(), album_cover_choice_controller_, app_->lyrics_providers());
+  context_view_->Init(collection_view_->view(), album_cover_choice_controller_, app_->lyrics_providers(), app_->lyrics_store());
   ui_->widget_playing->Init(album_cover_choice_controller_);
 
   // Initialize the search widget
@@ -850,6 +865,7 @@ MainWindow::MainWindow(Application *app,
   QObject::connect(ui_->playlist, &PlaylistContainer::UndoRedoActionsChanged, this, &MainWindow::PlaylistUndoRedoChanged);
 
   QObject::connect(&*app_->device_manager(), &DeviceManager::DeviceError, this, &MainWindow::ShowErrorDialog);
+  QObject::connect(&*app_->device_manager(), &DeviceManager::MountPointsChanged, &*app_->collection(), &CollectionLibrary::MountPointsChanged);
   QObject::connect(app_->device_manager()->connected_devices_model(), &DeviceStateFilterModel::IsEmptyChanged, playlist_copy_to_device_, &QAction::setDisabled);
   playlist_copy_to_device_->setDisabled(app_->device_manager()->connected_devices_model()->rowCount() == 0);
 
@@ -885,6 +901,12 @@ MainWindow::MainWindow(Application *app,
   QObject::connect(globalshortcuts_manager_, &GlobalShortcutsManager::Play, &*app_->player(), &Player::PlayHelper);
   QObject::connect(globalshortcuts_manager_, &GlobalShortcutsManager::Pause, &*app_->player(), &Player::Pause);
   QObject::connect(globalshortcuts_manager_, &GlobalShortcutsManager::PlayPause, ui_->action_play_pause, &QAction::trigger);
+  // Commands the engine couldn't handle by itself on the thread of the transport control.
+  QObject::connect(&*app_->transport_control(), &TransportControl::PlayRequested, &*app_->player(), &Player::PlayHelper);
+  QObject::connect(&*app_->transport_control(), &TransportControl::PauseRequested, &*app_->player(), &Player::Pause);
+  QObject::connect(&*app_->transport_control(), &TransportControl::PlayPauseRequested, ui_->action_play_pause, &QAction::trigger);
+  QObject::connect(&*app_->transport_control(), &TransportControl::Resumed, osd_, &OSDBase::Resumed);
+  globalshortcuts_manager_->SetTransportControl(app_->transport_control());
   QObject::connect(globalshortcuts_manager_, &GlobalShortcutsManager::Stop, ui_->action_stop, &QAction::trigger);
   QObject::connect(globalshortcuts_manager_, &GlobalShortcutsManager::StopAfter, ui_->action_stop_after_this_track, &QAction::trigger);
   QObject::connect(globalshortcuts_manager_, &GlobalShortcutsManager::Next, ui_->action_next_track, &QAction::trigger);
@@ -980,8 +1002,7 @@ MainWindow::MainWindow(Application *app,
   QObject::connect(&*app_->lastfm_import(), &LastFMImport::FinishedWithError, lastfm_import_dialog_, &LastFMImportDialog::FinishedWithError);
   QObject::connect(&*app_->lastfm_import(), &LastFMImport::UpdateTotal, lastfm_import_dialog_, &LastFMImportDialog::UpdateTotal);
   QObject::connect(&*app_->lastfm_import(), &LastFMImport::UpdateProgress, lastfm_import_dialog_, &LastFMImportDialog::UpdateProgress);
-  QObject::connect(&*app_->lastfm_import(), &LastFMImport::UpdateLastPlayed, &*app_->collection_backend(), &CollectionBackend::UpdateLastPlayed);
-  QObject::connect(&*app_->lastfm_import(), &LastFMImport::UpdatePlayCount, &*app_->collection_backend(), &CollectionBackend::UpdatePlayCount);
+  QObject::connect(&*app_->lastfm_import(), &LastFMImport::UpdatePlayStatistics, &*app_->collection_backend(), &CollectionBackend::UpdatePlayStatistics);
 
 #if !defined(HAVE_AUDIOCD)
   ui_->action_open_cd->setEnabled(false);
@@ -1159,6 +1180,14 @@ MainWindow::MainWindow(Application *app,
   qLog(Debug) << "Started" << QThread::currentThread();
   initialized_ = true;
 
+  UpdateLowPowerMode();
+
+  // Without a visible window there is no first frame to wait for.
+  if (!isVisible() || isMinimized()) {
+    first_frame_shown_ = true;
+    QTimer::singleShot(0, app_, &Application::RunDeferred);
+  }
+
 }
 
 MainWindow::~MainWindow() {
@@ -1220,7 +1249,9 @@ void MainWindow::ReloadSettings() {
 
   s.beginGroup(BackendSettings::kSettingsGroup);
   bool volume_control = s.value("volume_control", true).toBool();
+  low_power_mode_enabled_ = s.value(BackendSettings::kLowPowerMode, true).toBool();
   s.endGroup();
+  UpdateLowPowerMode();
   if (volume_control != ui_->volume->isEnabled()) {
     ui_->volume->SetEnabled(volume_control);
     if (volume_control) {
@@ -1297,6 +1328,8 @@ void MainWindow::ReloadSettings() {
 
 void MainWindow::ReloadAllSettings() {
 
+  SettingsStore::Instance()->Reload();
+
   ReloadSettings();
 
   // Other settings
@@ -1482,7 +1515,7 @@ void MainWindow::MediaPaused() {
   if (!track_position_timer_->isActive()) {
     track_position_timer_->start();
   }
-  if (!track_slider_timer_->isActive()) {
+  if (!low_power_mode_ && !track_slider_timer_->isActive()) {
     track_slider_timer_->start();
   }
 
@@ -1512,7 +1545,7 @@ void MainWindow::MediaPlaying() {
   if (!track_position_timer_->isActive()) {
     track_position_timer_->start();
   }
-  if (!track_slider_timer_->isActive()) {
+  if (!low_power_mode_ && !track_slider_timer_->isActive()) {
     track_slider_timer_->start();
   }
 
@@ -1715,6 +1748,24 @@ void MainWindow::StopAfterCurrent() {
   Q_EMIT StopAfterToggled(app_->playlist_manager()->active()->stop_after_current());
 }
 
+bool MainWindow::event(QEvent *e) {
+
+  // The first frame is flushed to the screen after the paint event returns, so the queued call runs once it is visible.
+  if (e->type() == QEvent::Paint && !first_frame_shown_) {
+    first_frame_shown_ = true;
+    QTimer::singleShot(0, app_, &Application::RunDeferred);
+  }
+
+  const bool result = QMainWindow::event(e);
+
+  if (e->type() == QEvent::Show || e->type() == QEvent::Hide || e->type() == QEvent::WindowStateChange) {
+    UpdateLowPowerMode();
+  }
+
+  return result;
+
+}
+
 void MainWindow::hideEvent(QHideEvent *e) {
 
   // Some window managers don't remember maximized state between
@@ -1797,6 +1848,8 @@ void MainWindow::Seeked(const qint64 microseconds) {
 
 void MainWindow::UpdateTrackPosition() {
 
+  WakeupStatistics::Add();
+
   PlaylistItemPtr item(app_->player()->GetCurrentItem());
   if (!item) return;
 
@@ -1829,6 +1882,8 @@ void MainWindow::UpdateTrackPosition() {
 
 void MainWindow::UpdateTrackSliderPosition() {
 
+  WakeupStatistics::Add();
+
   PlaylistItemPtr item(app_->player()->GetCurrentItem());
 
   const int slider_position = std::floor(static_cast<float>(app_->player()->engine()->position_nanosec()) / kNsecPerMsec);
@@ -1839,6 +1894,41 @@ void MainWindow::UpdateTrackSliderPosition() {
 
 }
 
+void MainWindow::UpdateLowPowerMode() {
+
+  if (!initialized_ || exit_) return;
+
+  const bool low_power_mode = low_power_mode_enabled_ && (!isVisible() || isMinimized());
+  if (low_power_mode == low_power_mode_) return;
+  low_power_mode_ = low_power_mode;
+
+  qLog(Debug) << (low_power_mode_ ? "Entering" : "Leaving") << "low power mode";
+
+  app_->player()->engine()->SetLowPowerMode(low_power_mode_);
+#ifdef HAVE_MOODBAR
+  app_->moodbar_loader()->SetLowPowerMode(low_power_mode_);
+#endif
+#ifdef HAVE_DISCORD_RPC
+  discord_rich_presence_->SetLowPowerMode(low_power_mode_);
+#endif
+
+  // The track position is still needed for scrobbling and the tray icon, but it's fine to be late a little.
+  track_position_timer_->setTimerType(low_power_mode_ ? Qt::VeryCoarseTimer : Qt::CoarseTimer);
+  if (track_position_timer_->isActive()) {
+    track_position_timer_->start();
+  }
+
+  // Nothing shows the track slider.
+  if (low_power_mode_) {
+    track_slider_timer_->stop();
+  }
+  else if (track_position_timer_->isActive()) {
+    track_slider_timer_->start();
+    UpdateTrackSliderPosition();
+  }
+
+}
+
 #ifdef HAVE_DBUS
 void MainWindow::UpdateTaskbarProgress(const bool visible, const double progress) {
 
@@ -119,6 +119,7 @@ class MainWindow : public QMainWindow, public PlatformInterface {
   void CommandlineOptionsReceived(const CommandlineOptions &options);
 
  protected:
+  bool event(QEvent *e) override;
   void hideEvent(QHideEvent *e) override;
   void closeEvent(QCloseEvent *e) override;
   void changeEvent(QEvent *e) override;
@@ -205,6 +206,8 @@ class MainWindow : public QMainWindow, public PlatformInterface {
   void Seeked(const qint64 microseconds);
   void UpdateTrackPosition();
   void UpdateTrackSliderPosition();
+  // Enters low power mode while the window is hidden or minimized, see BackendSettings::kLowPowerMode.
+  void UpdateLowPowerMode();
 
   void TaskCountChanged(const int count);
 
@@ -399,8 +402,11 @@ class MainWindow : public QMainWindow, public PlatformInterface {
   BehaviourSettings::PlayBehaviour menu_playmode_;
 
   bool initialized_;
+  bool first_frame_shown_;
   bool was_maximized_;
   bool was_minimized_;
+  bool low_power_mode_enabled_;
+  bool low_power_mode_;
 
   Song song_;
   Song song_playing_;
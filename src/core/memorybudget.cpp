@@ -0,0 +1,190 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "config.h"
+
+#include <algorithm>
+#include <utility>
+
+#include <QtGlobal>
+#include <QObject>
+#include <QTimer>
+#include <QList>
+#include <QString>
+#include <QPixmapCache>
+
+#ifdef Q_OS_LINUX
+#  include <QFile>
+#  include <QByteArray>
+#endif
+
+#include "core/logging.h"
+#include "memorybudget.h"
+
+#ifdef Q_OS_MACOS
+#  include "utilities/macosutils.h"
+#endif
+
+using namespace std::chrono_literals;
+
+namespace {
+constexpr qint64 kDefaultBudget = 512LL * 1024LL * 1024LL;
+#ifdef Q_OS_LINUX
+// Percentage of the last 10 seconds where some tasks were stalled on memory.
+constexpr double kPressureThreshold = 10.0;
+#endif
+}  // namespace
+
+MemoryBudget::MemoryBudget(QObject *parent)
+    : QObject(parent),
+      timer_check_(new QTimer(this)),
+      budget_(kDefaultBudget) {
+
+  setObjectName(QLatin1String(QObject::metaObject()->className()));
+
+  timer_check_->setInterval(10s);
+  QObject::connect(timer_check_, &QTimer::timeout, this, &MemoryBudget::Check);
+
+}
+
+MemoryBudget *MemoryBudget::Instance() {
+
+  static MemoryBudget *instance = new MemoryBudget;
+  return instance;
+
+}
+
+void MemoryBudget::Register(const QString &name, QObject *context, UsageFunction usage_function, TrimFunction trim_function) {
+
+  Q_ASSERT(context);
+
+  const bool connect_destroyed = std::none_of(caches_.begin(), caches_.end(), [context](const Cache &cache) { return cache.context == context; });
+
+  caches_ << Cache { name, context, std::move(usage_function), std::move(trim_function), 0, true };
+
+  if (connect_destroyed) {
+    QObject::connect(context, &QObject::destroyed, this, [this, context]() {
+      caches_.removeIf([context](const Cache &cache) { return cache.context == context; });
+      if (caches_.isEmpty()) timer_check_->stop();
+    });
+  }
+
+  if (!timer_check_->isActive()) timer_check_->start();
+
+}
+
+void MemoryBudget::SetBudget(const qint64 bytes) {
+
+  budget_ = bytes;
+  Check();
+
+}
+
+QList<MemoryBudget::CacheUsage> MemoryBudget::usage() const {
+
+  QList<CacheUsage> ret;
+  ret.reserve(caches_.count());
+  for (const Cache &cache : caches_) {
+    ret << CacheUsage { cache.name, cache.usage_function() };
+  }
+
+  return ret;
+
+}
+
+bool MemoryBudget::MemoryPressure() {
+
+#if defined(Q_OS_LINUX)
+
+  // Pressure stall information, the first line is "some avg10=0.00 avg60=0.00 avg300=0.00 total=0".
+  QFile file(QStringLiteral("/proc/pressure/memory"));
+  if (!file.open(QIODevice::ReadOnly)) return false;
+  const QByteArray line = file.readLine();
+  file.close();
+  if (!line.startsWith("some ")) return false;
+  const qsizetype start = line.indexOf("avg10=");
+  if (start == -1) return false;
+  const qsizetype end = line.indexOf(' ', start);
+  bool ok = false;
+  const double avg10 = line.mid(start + 6, end == -1 ? -1 : end - start - 6).toDouble(&ok);
+  return ok && avg10 >= kPressureThreshold;
+
+#elif defined(Q_OS_MACOS)
+
+  return Utilities::MemoryPressure();
+
+#else
+
+  return false;
+
+#endif
+
+}
+
+void MemoryBudget::Check() {
+
+  const bool memory_pressure = MemoryPressure();
+
+  qint64 total_bytes = 0;
+  for (Cache &cache : caches_) {
+    const qint64 bytes = cache.usage_function();
+    cache.warm = bytes > cache.last_usage;
+    cache.last_usage = bytes;
+    total_bytes += bytes;
+  }
+
+  if (memory_pressure) {
+    // QPixmapCache can't tell how much it uses, so it is only cleared under memory pressure.
+    QPixmapCache::clear();
+    qLog(Debug) << "Memory pressure, trimming caches using" << total_bytes << "bytes";
+    Trim(std::min(budget_, total_bytes) / 2);
+  }
+  else if (total_bytes > budget_) {
+    qLog(Debug) << "Caches use" << total_bytes << "bytes, trimming to" << budget_;
+    Trim(budget_);
+  }
+
+}
+
+void MemoryBudget::Trim(const qint64 target_bytes) {
+
+  QList<Cache*> caches;
+  caches.reserve(caches_.count());
+  qint64 total_bytes = 0;
+  for (Cache &cache : caches_) {
+    caches << &cache;
+    total_bytes += cache.last_usage;
+  }
+
+  std::stable_sort(caches.begin(), caches.end(), [](const Cache *a, const Cache *b) {
+    if (a->warm != b->warm) return !a->warm;
+    return a->last_usage > b->last_usage;
+  });
+
+  for (Cache *cache : std::as_const(caches)) {
+    if (total_bytes <= target_bytes) break;
+    if (cache->last_usage <= 0) continue;
+    const qint64 excess_bytes = total_bytes - target_bytes;
+    cache->trim_function(std::max(0LL, cache->last_usage - excess_bytes));
+    const qint64 bytes = cache->usage_function();
+    total_bytes -= cache->last_usage - bytes;
+    cache->last_usage = bytes;
+  }
+
+}
@@ -0,0 +1,87 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef MEMORYBUDGET_H
+#define MEMORYBUDGET_H
+
+#include "config.h"
+
+#include <functional>
+
+#include <QtGlobal>
+#include <QObject>
+#include <QList>
+#include <QString>
+
+class QTimer;
+
+// Shared memory budget for the in-memory caches.
+// Caches register how to measure and trim themselves, and are checked periodically.
+// When the caches together use more than the budget, or the system reports memory pressure, they are trimmed until they fit again.
+// Caches that didn't grow since the last check are trimmed first, largest first.
+// Only to be used from the GUI thread.
+class MemoryBudget : public QObject {
+  Q_OBJECT
+
+ public:
+  static MemoryBudget *Instance();
+
+  // Returns the number of bytes used by the cache.
+  using UsageFunction = std::function<qint64()>;
+  // Asks the cache to shrink to at most the given number of bytes.
+  using TrimFunction = std::function<void(const qint64 bytes)>;
+
+  // Registers a cache until context is destroyed.
+  void Register(const QString &name, QObject *context, UsageFunction usage_function, TrimFunction trim_function);
+
+  void SetBudget(const qint64 bytes);
+  qint64 budget() const { return budget_; }
+
+  struct CacheUsage {
+    QString name;
+    qint64 bytes;
+  };
+  QList<CacheUsage> usage() const;
+
+ public Q_SLOTS:
+  void Check();
+
+ private:
+  explicit MemoryBudget(QObject *parent = nullptr);
+
+  static bool MemoryPressure();
+  void Trim(const qint64 target_bytes);
+
+  struct Cache {
+    QString name;
+    QObject *context;
+    UsageFunction usage_function;
+    TrimFunction trim_function;
+    qint64 last_usage;
+    bool warm;
+  };
+
+  QTimer *timer_check_;
+  qint64 budget_;
+  QList<Cache> caches_;
+
+  Q_DISABLE_COPY(MemoryBudget)
+};
+
+#endif  // MEMORYBUDGET_H
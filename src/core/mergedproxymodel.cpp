@@ -47,7 +47,6 @@
 #include <boost/multi_index/identity.hpp>
 #include <boost/multi_index/indexed_by.hpp>
 #include <boost/multi_index/member.hpp>
-#include <boost/multi_index/ordered_index.hpp>
 #include <boost/multi_index/tag.hpp>
 #include <boost/multi_index_container.hpp>
 #include <boost/operators.hpp>
@@ -61,7 +60,6 @@ using boost::multi_index::identity;
 using boost::multi_index::indexed_by;
 using boost::multi_index::member;
 using boost::multi_index::multi_index_container;
-using boost::multi_index::ordered_unique;
 using boost::multi_index::tag;
 
 size_t hash_value(const QModelIndex &idx) { return qHash(idx); }
@@ -81,7 +79,8 @@ struct tag_by_pointer {};
 
 class MergedProxyModelPrivate {
  private:
-  using MappingContainer = multi_index_container<Mapping*, indexed_by<hashed_unique<tag<tag_by_source>, member<Mapping, QModelIndex, &Mapping::source_index>>, ordered_unique<tag<tag_by_pointer>, identity<Mapping*>>>>;
+  // Both lookups are hashed, mapToSource() checks the pointer of every proxy index it's given.
+  using MappingContainer = multi_index_container<Mapping*, indexed_by<hashed_unique<tag<tag_by_source>, member<Mapping, QModelIndex, &Mapping::source_index>>, hashed_unique<tag<tag_by_pointer>, identity<Mapping*>>>>;
 
  public:
   MappingContainer mappings_;
@@ -326,7 +325,7 @@ QModelIndex MergedProxyModel::index(const int row, const int column, const QMode
   }
   else {
     QModelIndex source_parent = mapToSource(parent);
-    const QAbstractItemModel *child_model = merge_points_.key(source_parent);
+    const QAbstractItemModel *child_model = SubModelAt(source_parent);
 
     if (child_model) {
       source_index = child_model->index(row, column, QModelIndex());
@@ -364,7 +363,7 @@ int MergedProxyModel::rowCount(const QModelIndex &parent) const {
   QModelIndex source_parent = mapToSource(parent);
   if (!IsKnownModel(source_parent.model())) return 0;
 
-  const QAbstractItemModel *child_model = merge_points_.key(source_parent);
+  const QAbstractItemModel *child_model = SubModelAt(source_parent);
   if (child_model) {
     // Query the source model but disregard what it says, so it gets a chance to lazy load
     source_parent.model()->rowCount(source_parent);
@@ -383,7 +382,7 @@ int MergedProxyModel::columnCount(const QModelIndex &parent) const {
   QModelIndex source_parent = mapToSource(parent);
   if (!IsKnownModel(source_parent.model())) return 0;
 
-  const QAbstractItemModel *child_model = merge_points_.key(source_parent);
+  const QAbstractItemModel *child_model = SubModelAt(source_parent);
   if (child_model) return child_model->columnCount(QModelIndex());
   return source_parent.model()->columnCount(source_parent);
 
@@ -396,7 +395,7 @@ bool MergedProxyModel::hasChildren(const QModelIndex &parent) const {
   QModelIndex source_parent = mapToSource(parent);
   if (!IsKnownModel(source_parent.model())) return false;
 
-  const QAbstractItemModel *child_model = merge_points_.key(source_parent);
+  const QAbstractItemModel *child_model = SubModelAt(source_parent);
 
   if (child_model) return child_model->hasChildren(QModelIndex()) || source_parent.model()->hasChildren(source_parent);
   return source_parent.model()->hasChildren(source_parent);
@@ -529,9 +528,21 @@ QAbstractItemModel *MergedProxyModel::GetModel(const QModelIndex &source_index)
   // This is essentially const_cast<QAbstractItemModel*>(source_index.model()), but without the const_cast
   const QAbstractItemModel *const_model = source_index.model();
   if (const_model == sourceModel()) return sourceModel();
-  const QList<QAbstractItemModel*> submodels = merge_points_.keys();
-  for (QAbstractItemModel *submodel : submodels) {
-    if (submodel == const_model) return submodel;
+  for (QHash<QAbstractItemModel*, QPersistentModelIndex>::const_iterator it = merge_points_.constBegin(); it != merge_points_.constEnd(); ++it) {
+    if (it.key() == const_model) return it.key();
+  }
+
+  return nullptr;
+
+}
+
+QAbstractItemModel *MergedProxyModel::SubModelAt(const QModelIndex &source_parent) const {
+
+  // Submodels are only merged into items of the source model, so items in submodels never need the search.
+  if (merge_points_.isEmpty() || source_parent.model() != sourceModel()) return nullptr;
+
+  for (QHash<QAbstractItemModel*, QPersistentModelIndex>::const_iterator it = merge_points_.constBegin(); it != merge_points_.constEnd(); ++it) {
+    if (it.value() == source_parent) return it.key();
   }
 
   return nullptr;
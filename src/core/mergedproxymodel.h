@@ -105,6 +105,8 @@ class MergedProxyModel : public QAbstractProxyModel {
  private:
   QModelIndex GetActualSourceParent(const QModelIndex &source_parent, QAbstractItemModel *model) const;
   QAbstractItemModel *GetModel(const QModelIndex &source_index) const;
+  // Returns the submodel merged into the source model item, or nullptr.
+  QAbstractItemModel *SubModelAt(const QModelIndex &source_parent) const;
   void DeleteAllMappings();
   bool IsKnownModel(const QAbstractItemModel *model) const;
 
@@ -44,10 +44,12 @@
 #endif
 
 #include "core/song.h"
+#include "core/songbatch.h"
 #include "core/enginemetadata.h"
 #include "engine/enginebase.h"
 #include "engine/gstenginepipeline.h"
 #include "collection/collectiondirectory.h"
+#include "collection/collectionplaystatistics.h"
 #include "playlist/playlistitem.h"
 #include "playlist/playlistsequence.h"
 #include "covermanager/albumcoverloaderresult.h"
@@ -91,6 +93,7 @@ void RegisterMetaTypes() {
   qRegisterMetaType<QList<int>>("QList<int>");
   qRegisterMetaType<QList<QUrl>>("QList<QUrl>");
   qRegisterMetaType<QFileInfo>("QFileInfo");
+  qRegisterMetaType<QList<QFileInfo>>("QList<QFileInfo>");
   qRegisterMetaType<QAbstractSocket::SocketState>("QAbstractSocket::SocketState");
   qRegisterMetaType<QNetworkReply*>("QNetworkReply*");
   qRegisterMetaType<QNetworkReply**>("QNetworkReply**");
@@ -99,6 +102,7 @@ void RegisterMetaTypes() {
   qRegisterMetaType<QMap<int, int>>("ColumnAlignmentIntMap");
   qRegisterMetaType<Song>("Song");
   qRegisterMetaType<SongList>("SongList");
+  qRegisterMetaType<SongBatch>("SongBatch");
   qRegisterMetaType<SongMap>("SongMap");
   qRegisterMetaType<Song::Source>("Song::Source");
   qRegisterMetaType<Song::FileType>("Song::FileType");
@@ -114,6 +118,7 @@ void RegisterMetaTypes() {
   qRegisterMetaType<CollectionDirectoryList>("CollectionDirectoryList");
   qRegisterMetaType<CollectionSubdirectory>("CollectionSubdirectory");
   qRegisterMetaType<CollectionSubdirectoryList>("CollectionSubdirectoryList");
+  qRegisterMetaType<CollectionPlayStatisticsList>("CollectionPlayStatisticsList");
   qRegisterMetaType<CollectionModel::Grouping>("CollectionModel::Grouping");
   qRegisterMetaType<PlaylistItemPtr>("PlaylistItemPtr");
   qRegisterMetaType<PlaylistItemPtrList>("PlaylistItemPtrList");
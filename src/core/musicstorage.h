@@ -89,6 +89,8 @@ class MusicStorage {
   virtual bool GetSupportedFiletypes(QList<Song::FileType> *ret) { Q_UNUSED(ret); return true; }
 
   virtual bool StartCopy(QList<Song::FileType> *supported_types) { Q_UNUSED(supported_types); return true; }
+  // Storages returning more than 1 have a thread safe CopyToStorage, and copy that many files at the same time.
+  virtual int MaxConcurrentCopies() const { return 1; }
   virtual bool CopyToStorage(const CopyJob &job, QString &error_text) = 0;
   virtual bool FinishCopy(bool success, QString &error_text) { Q_UNUSED(error_text); return success; }
 
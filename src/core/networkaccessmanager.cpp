@@ -26,16 +26,48 @@
 #include <QIODevice>
 #include <QByteArray>
 #include <QString>
+#include <QUrl>
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
 #include <QNetworkAccessManager>
 #include <QNetworkRequest>
 #include <QNetworkReply>
 #include <QNetworkInformation>
+#include <QSslConfiguration>
+#if QT_VERSION >= QT_VERSION_CHECK(6, 5, 0)
+#  include <QHttp1Configuration>
+#endif
 
 #include "networkaccessmanager.h"
 #include "threadsafenetworkdiskcache.h"
 
 using namespace Qt::Literals::StringLiterals;
 
+namespace {
+
+constexpr qsizetype kMaxSessionTickets = 100;
+#if QT_VERSION >= QT_VERSION_CHECK(6, 5, 0)
+constexpr int kMaxConnectionsPerHost = 4;
+#endif
+
+// TLS session tickets are shared by all instances, so a new connection to a host can resume the previous session instead of doing a full handshake.
+QMutex &SessionTicketsMutex() {
+  static QMutex mutex;
+  return mutex;
+}
+
+QHash<QString, QByteArray> &SessionTickets() {
+  static QHash<QString, QByteArray> session_tickets;
+  return session_tickets;
+}
+
+QString SessionTicketKey(const QUrl &url) {
+  return url.host() + u':' + QString::number(url.port(443));
+}
+
+}  // namespace
+
 NetworkAccessManager::NetworkAccessManager(QObject *parent)
     : QNetworkAccessManager(parent) {
 
@@ -83,6 +115,61 @@ QNetworkReply *NetworkAccessManager::createRequest(Operation op, const QNetworkR
     new_network_request.setAttribute(QNetworkRequest::CacheLoadControlAttribute, QNetworkRequest::PreferCache);
   }
 
-  return QNetworkAccessManager::createRequest(op, new_network_request, outgoing_data);
+  if (op == QNetworkAccessManager::GetOperation && network_request.attribute(kCacheTimeAttribute).isValid()) {
+    ThreadSafeNetworkDiskCache::SetCacheTime(new_network_request.url(), network_request.attribute(kCacheTimeAttribute).toLongLong());
+  }
+
+  // Multiplex the requests to a host over one connection when the server supports HTTP/2
+  if (!network_request.attribute(QNetworkRequest::Http2AllowedAttribute).isValid()) {
+    new_network_request.setAttribute(QNetworkRequest::Http2AllowedAttribute, true);
+  }
+
+#if QT_VERSION >= QT_VERSION_CHECK(6, 5, 0)
+  QHttp1Configuration http1_configuration = new_network_request.http1Configuration();
+  http1_configuration.setNumberOfConnectionsPerHost(kMaxConnectionsPerHost);
+  new_network_request.setHttp1Configuration(http1_configuration);
+#endif
+
+  const bool https = new_network_request.url().scheme() == "https"_L1;
+  if (https) {
+    QSslConfiguration ssl_configuration = new_network_request.sslConfiguration();
+    ssl_configuration.setSslOption(QSsl::SslOptionDisableSessionPersistence, false);
+    const QByteArray session_ticket = SessionTicket(new_network_request.url());
+    if (!session_ticket.isEmpty()) {
+      ssl_configuration.setSessionTicket(session_ticket);
+    }
+    new_network_request.setSslConfiguration(ssl_configuration);
+  }
+
+  QNetworkReply *reply = QNetworkAccessManager::createRequest(op, new_network_request, outgoing_data);
+
+  if (https) {
+    QObject::connect(reply, &QNetworkReply::finished, this, [reply]() { StoreSessionTicket(reply); });
+  }
+
+  return reply;
+
+}
+
+QByteArray NetworkAccessManager::SessionTicket(const QUrl &url) {
+
+  QMutexLocker l(&SessionTicketsMutex());
+  return SessionTickets().value(SessionTicketKey(url));
+
+}
+
+void NetworkAccessManager::StoreSessionTicket(QNetworkReply *reply) {
+
+  if (reply->error() != QNetworkReply::NoError || reply->url().scheme() != "https"_L1) return;
+
+  const QByteArray session_ticket = reply->sslConfiguration().sessionTicket();
+  if (session_ticket.isEmpty()) return;
+
+  QMutexLocker l(&SessionTicketsMutex());
+  QHash<QString, QByteArray> &session_tickets = SessionTickets();
+  if (session_tickets.count() >= kMaxSessionTickets) {
+    session_tickets.clear();
+  }
+  session_tickets.insert(SessionTicketKey(reply->url()), session_ticket);
 
 }
@@ -25,11 +25,13 @@
 #include "config.h"
 
 #include <QObject>
+#include <QByteArray>
 #include <QNetworkAccessManager>
 #include <QNetworkRequest>
 
 class QIODevice;
 class QNetworkReply;
+class QUrl;
 
 class NetworkAccessManager : public QNetworkAccessManager {
   Q_OBJECT
@@ -37,8 +39,15 @@ class NetworkAccessManager : public QNetworkAccessManager {
  public:
   explicit NetworkAccessManager(QObject *parent = nullptr);
 
+  // Number of seconds to keep the reply of a get request in the disk cache, regardless of the caching headers and status code.
+  static constexpr QNetworkRequest::Attribute kCacheTimeAttribute = static_cast<QNetworkRequest::Attribute>(QNetworkRequest::User + 1);
+
  protected:
   QNetworkReply *createRequest(Operation op, const QNetworkRequest &network_request, QIODevice *outgoing_data) override;
+
+ private:
+  static QByteArray SessionTicket(const QUrl &url);
+  static void StoreSessionTicket(QNetworkReply *reply);
 };
 
 #endif  // NETWORKACCESSMANAGER_H
@@ -45,10 +45,12 @@
 #include "includes/shared_ptr.h"
 #include "core/logging.h"
 #include "core/settings.h"
+#include "core/settingsstore.h"
 #include "core/song.h"
 #include "core/urlhandlers.h"
 #include "core/urlhandler.h"
 #include "core/enginemetadata.h"
+#include "core/streamaudiocache.h"
 
 #include "engine/enginebase.h"
 #include "engine/gstengine.h"
@@ -63,6 +65,7 @@
 #include "analyzer/analyzercontainer.h"
 
 using namespace std::chrono_literals;
+using namespace Qt::Literals::StringLiterals;
 using std::make_shared;
 
 namespace {
@@ -71,6 +74,8 @@ constexpr char kVolume[] = "volume";
 constexpr char kPlaybackState[] = "playback_state";
 constexpr char kPlaybackPlaylist[] = "playback_playlist";
 constexpr char kPlaybackPosition[] = "playback_position";
+constexpr auto kPrepareNextTrackDelay = 3s;
+constexpr qint64 kPreparedStreamUrlMaxAgeMsec = 300000;
 }  // namespace
 
 Player::Player(const SharedPtr<TaskManager> task_manager, const SharedPtr<UrlHandlers> url_handlers, const SharedPtr<PlaylistManager> playlist_manager, QObject *parent)
@@ -82,6 +87,8 @@ Player::Player(const SharedPtr<TaskManager> task_manager, const SharedPtr<UrlHan
       analyzer_(nullptr),
       equalizer_(nullptr),
       timer_save_volume_(new QTimer(this)),
+      timer_prepare_next_(new QTimer(this)),
+      stream_audio_cache_(new StreamAudioCache(this)),
       playlists_loaded_(false),
       play_requested_(false),
       pause_(false),
@@ -105,6 +112,9 @@ Player::Player(const SharedPtr<TaskManager> task_manager, const SharedPtr<UrlHan
   timer_save_volume_->setInterval(5s);
   QObject::connect(timer_save_volume_, &QTimer::timeout, this, &Player::SaveVolume);
 
+  timer_prepare_next_->setSingleShot(true);
+  QObject::connect(timer_prepare_next_, &QTimer::timeout, this, &Player::PrepareNextTrack);
+
   QObject::connect(&*url_handlers, &UrlHandlers::Registered, this, &Player::UrlHandlerRegistered);
 
 }
@@ -146,18 +156,16 @@ void Player::Init() {
 
 void Player::ReloadSettings() {
 
-  Settings s;
+  const SettingsStore *settings_store = SettingsStore::Instance();
 
-  s.beginGroup(PlaylistSettings::kSettingsGroup);
-  continue_on_error_ = s.value("continue_on_error", false).toBool();
-  greyout_ = s.value("greyout_songs_play", true).toBool();
-  s.endGroup();
+  continue_on_error_ = settings_store->Value(PlaylistSettings::kSettingsGroup, "continue_on_error", false).toBool();
+  greyout_ = settings_store->Value(PlaylistSettings::kSettingsGroup, "greyout_songs_play", true).toBool();
 
-  s.beginGroup(BehaviourSettings::kSettingsGroup);
-  menu_previousmode_ = static_cast<BehaviourSettings::PreviousBehaviour>(s.value(BehaviourSettings::kMenuPreviousMode, static_cast<int>(BehaviourSettings::PreviousBehaviour::DontRestart)).toInt());
-  seek_step_sec_ = s.value(BehaviourSettings::kSeekStepSec, 10).toInt();
-  volume_increment_ = s.value(BehaviourSettings::kVolumeIncrement, 5).toUInt();
-  s.endGroup();
+  menu_previousmode_ = static_cast<BehaviourSettings::PreviousBehaviour>(settings_store->Value(BehaviourSettings::kSettingsGroup, BehaviourSettings::kMenuPreviousMode, static_cast<int>(BehaviourSettings::PreviousBehaviour::DontRestart)).toInt());
+  seek_step_sec_ = settings_store->Value(BehaviourSettings::kSettingsGroup, BehaviourSettings::kSeekStepSec, 10).toInt();
+  volume_increment_ = settings_store->Value(BehaviourSettings::kSettingsGroup, BehaviourSettings::kVolumeIncrement, 5).toUInt();
+
+  stream_audio_cache_->ReloadSettings();
 
   engine_->ReloadSettings();
 
@@ -269,6 +277,11 @@ void Player::HandleLoadResult(const UrlHandler::LoadResult &result) {
     loading_async_.removeAll(result.media_url_);
   }
 
+  const bool was_preparing = result.media_url_ == preparing_next_url_ && result.type_ != UrlHandler::LoadResult::Type::WillLoadAsynchronously;
+  if (was_preparing) {
+    preparing_next_url_.clear();
+  }
+
   // Might've been an async load, so check we're still on the same item
   const int current_row = playlist_manager_->active()->current_row();
   if (current_row == -1) {
@@ -298,6 +311,12 @@ void Player::HandleLoadResult(const UrlHandler::LoadResult &result) {
     return;
   }
 
+  // Results for the next track requested by PrepareNextTrack() are only stored, errors are reported when the track is actually needed.
+  const bool is_prepare = was_preparing && is_next;
+  if (is_prepare && result.type_ != UrlHandler::LoadResult::Type::TrackAvailable) {
+    return;
+  }
+
   switch (result.type_) {
     case UrlHandler::LoadResult::Type::Error:
       if (is_current) {
@@ -361,6 +380,11 @@ void Player::HandleLoadResult(const UrlHandler::LoadResult &result) {
         update = true;
       }
 
+      if (is_next) {
+        prepared_next_url_ = result.media_url_;
+        prepared_next_timer_.start();
+      }
+
       if (update) {
         if (is_current) {
           playlist_manager_->active()->UpdateItemMetadata(current_row, current_item, song, true);
@@ -372,12 +396,22 @@ void Player::HandleLoadResult(const UrlHandler::LoadResult &result) {
 
       if (is_current) {
         qLog(Debug) << "Playing song" << current_item->EffectiveMetadata().title() << result.stream_url_ << "position" << play_offset_nanosec_;
+        SetStreamDiscovery(result.media_url_, song);
         engine_->Play(result.media_url_, result.stream_url_, pause_, stream_change_type_, song.has_cue(), static_cast<quint64>(song.beginning_nanosec()), song.end_nanosec(), play_offset_nanosec_, song.ebur128_integrated_loudness_lufs());
+        if (song.is_stream_service()) stream_audio_cache_->Add(result.media_url_, result.stream_url_);
         current_item_ = current_item;
+        UpdateFastTransport();
         play_offset_nanosec_ = 0;
+        SchedulePrepareNextTrack();
+      }
+      else if (is_prepare) {
+        qLog(Debug) << "Prepared next song" << next_item->EffectiveMetadata().title() << result.stream_url_;
+        // Resolve it again before it can expire
+        timer_prepare_next_->start(std::chrono::milliseconds(kPreparedStreamUrlMaxAgeMsec));
       }
       else if (is_next && !current_item->EffectiveMetadata().is_module_music()) {
         qLog(Debug) << "Preloading next song" << next_item->EffectiveMetadata().title() << result.stream_url_;
+        SetStreamDiscovery(next_item->OriginalUrl(), song);
         engine_->StartPreloading(next_item->OriginalUrl(), result.stream_url_, song.has_cue(), song.beginning_nanosec(), song.end_nanosec());
       }
 
@@ -574,6 +608,36 @@ void Player::UnPause() {
 
 }
 
+void Player::UpdateFastTransport() {
+
+  // Songs that can't be paused are stopped instead, and expiring stream URLs might need to be requested again when resuming, see PlayPause() and UnPause().
+  bool allowed = false;
+  if (current_item_ && !(current_item_->options() & PlaylistItem::Option::PauseDisabled)) {
+    const Song &song = current_item_->EffectiveMetadata();
+    allowed = !(url_handlers_->CanHandle(song.url()) && song.stream_url_can_expire());
+  }
+  engine_->set_fast_transport_allowed(allowed);
+
+}
+
+void Player::SetStreamDiscovery(const QUrl &media_url, const Song &song) {
+
+  // Songs from the collection, and most from streaming services, already have the audio properties the stream discovery would find.
+  const bool needed = song.filetype() == Song::FileType::Unknown || song.filetype() == Song::FileType::Stream || song.samplerate() <= 0 || (song.bitrate() <= 0 && song.bitdepth() <= 0);
+
+  // Radio streams can change format, and local files can be replaced, so only the results for streaming service tracks and remote files are cached.
+  QString cache_key;
+  if (song.is_stream_service() && !song.song_id().isEmpty()) {
+    cache_key = Song::TextForSource(song.source()) + u':' + song.song_id();
+  }
+  else if (!song.is_radio() && (media_url.scheme() == "http"_L1 || media_url.scheme() == "https"_L1)) {
+    cache_key = media_url.toString();
+  }
+
+  engine_->SetStreamDiscovery(media_url, needed, cache_key);
+
+}
+
 void Player::RestartOrPrevious() {
 
   pause_time_ = QDateTime();
@@ -591,9 +655,11 @@ void Player::RestartOrPrevious() {
 void Player::Stop(const bool stop_after) {
 
   engine_->Stop(stop_after);
+  timer_prepare_next_->stop();
   playlist_manager_->active()->set_current_row(-1);
   playlist_manager_->active()->reset_played_indexes();
   current_item_.reset();
+  UpdateFastTransport();
   pause_time_ = QDateTime();
   play_offset_nanosec_ = 0;
 
@@ -758,9 +824,17 @@ void Player::PlayAt(const int index, const bool pause, const quint64 offset_nano
   }
 
   current_item_ = playlist_manager_->active()->current_item();
-  const QUrl url = current_item_->EffectiveUrl();
-
-  if (url_handlers_->CanHandle(url)) {
+  UpdateFastTransport();
+  const QUrl url = PlayableUrl(current_item_);
+  const QUrl cached_url = CachedStreamUrl(current_item_);
+
+  if (cached_url.isValid()) {
+    qLog(Debug) << "Playing song" << current_item_->EffectiveMetadata().title() << "from the stream audio cache" << "position" << offset_nanosec;
+    SetStreamDiscovery(current_item_->OriginalUrl(), current_item_->EffectiveMetadata());
+    engine_->Play(current_item_->OriginalUrl(), cached_url, pause, change, current_item_->EffectiveMetadata().has_cue(), static_cast<quint64>(current_item_->effective_beginning_nanosec()), current_item_->effective_end_nanosec(), offset_nanosec, current_item_->EffectiveMetadata().ebur128_integrated_loudness_lufs());
+    SchedulePrepareNextTrack();
+  }
+  else if (url_handlers_->CanHandle(url)) {
     // It's already loading
     if (loading_async_.contains(url)) {
       return;
@@ -774,11 +848,64 @@ void Player::PlayAt(const int index, const bool pause, const quint64 offset_nano
   }
   else {
     qLog(Debug) << "Playing song" << current_item_->EffectiveMetadata().title() << url << "position" << offset_nanosec;
+    SetStreamDiscovery(current_item_->OriginalUrl(), current_item_->EffectiveMetadata());
     engine_->Play(current_item_->OriginalUrl(), url, pause, change, current_item_->EffectiveMetadata().has_cue(), static_cast<quint64>(current_item_->effective_beginning_nanosec()), current_item_->effective_end_nanosec(), offset_nanosec, current_item_->EffectiveMetadata().ebur128_integrated_loudness_lufs());
+    if (url != current_item_->OriginalUrl() && current_item_->EffectiveMetadata().is_stream_service() && url_handlers_->CanHandle(current_item_->OriginalUrl())) {
+      stream_audio_cache_->Add(current_item_->OriginalUrl(), url);
+    }
+    SchedulePrepareNextTrack();
   }
 
 }
 
+QUrl Player::CachedStreamUrl(PlaylistItemPtr item) const {
+
+  if (!url_handlers_->CanHandle(item->OriginalUrl())) return QUrl();
+
+  return stream_audio_cache_->CachedUrl(item->OriginalUrl());
+
+}
+
+void Player::SchedulePrepareNextTrack() {
+
+  // Wait a moment, so skipping through the playlist doesn't resolve every track on the way
+  timer_prepare_next_->start(kPrepareNextTrackDelay);
+
+}
+
+void Player::PrepareNextTrack() {
+
+  if (!current_item_ || (engine_->state() != EngineBase::State::Playing && engine_->state() != EngineBase::State::Paused)) return;
+
+  Playlist *playlist = playlist_manager_->active();
+  const int next_row = playlist->next_row();
+  if (next_row == -1) return;
+  PlaylistItemPtr next_item = playlist->item_at(next_row);
+  if (!next_item) return;
+
+  const QUrl url = next_item->OriginalUrl();
+  if (!url_handlers_->CanHandle(url) || loading_async_.contains(url)) return;
+  if (CachedStreamUrl(next_item).isValid()) return;
+  if (url == prepared_next_url_ && prepared_next_timer_.isValid() && prepared_next_timer_.elapsed() < kPreparedStreamUrlMaxAgeMsec) return;
+
+  qLog(Debug) << "Preparing next song" << next_item->EffectiveMetadata().title();
+
+  preparing_next_url_ = url;
+  UrlHandler *url_handler = url_handlers_->GetUrlHandler(url);
+  HandleLoadResult(url_handler->StartLoading(url));
+
+}
+
+QUrl Player::PlayableUrl(PlaylistItemPtr item) const {
+
+  if (item->OriginalUrl() == prepared_next_url_ && prepared_next_timer_.isValid() && prepared_next_timer_.elapsed() >= kPreparedStreamUrlMaxAgeMsec && url_handlers_->CanHandle(item->OriginalUrl())) {
+    return item->OriginalUrl();
+  }
+
+  return item->EffectiveUrl();
+
+}
+
 void Player::CurrentMetadataChanged(const Song &metadata) {
 
   // Those things might have changed (especially when a previously invalid song was reloaded) so we push the latest version into Engine
@@ -941,11 +1068,19 @@ void Player::TrackAboutToEnd() {
   // Crossfade is off, so start preloading the next track, so we don't get a gap between songs.
   if (!has_next_row || !next_item) return;
 
-  QUrl url = next_item->EffectiveUrl();
+  QUrl url = PlayableUrl(next_item);
+  const QUrl cached_url = CachedStreamUrl(next_item);
 
   // Get the actual track URL rather than the stream URL.
-  if (url_handlers_->CanHandle(url)) {
-    if (loading_async_.contains(url)) return;
+  if (cached_url.isValid()) {
+    url = cached_url;
+  }
+  else if (url_handlers_->CanHandle(url)) {
+    if (loading_async_.contains(url)) {
+      // Still being prepared, preload it as soon as the URL handler is done
+      if (url == preparing_next_url_) preparing_next_url_.clear();
+      return;
+    }
     autoscroll_ = Playlist::AutoScroll::Maybe;
     UrlHandler *url_handler = url_handlers_->GetUrlHandler(url);
     const UrlHandler::LoadResult result = url_handler->StartLoading(url);
@@ -964,6 +1099,9 @@ void Player::TrackAboutToEnd() {
         Song song = next_item->EffectiveMetadata();
         song.set_stream_url(url);
         next_item->SetStreamMetadata(song);
+        prepared_next_url_ = result.media_url_;
+        prepared_next_timer_.start();
+        if (song.is_stream_service()) stream_audio_cache_->Add(result.media_url_, url);
         break;
     }
   }
@@ -974,6 +1112,7 @@ void Player::TrackAboutToEnd() {
     return;
   }
 
+  SetStreamDiscovery(next_item->OriginalUrl(), next_item->EffectiveMetadata());
   engine_->StartPreloading(next_item->OriginalUrl(), url, next_item->EffectiveMetadata().has_cue(), next_item->effective_beginning_nanosec(), next_item->effective_end_nanosec());
 
 }
@@ -984,11 +1123,25 @@ void Player::FatalError() {
 }
 
 void Player::ValidSongRequested(const QUrl &url) {
+  stream_url_retried_.clear();
   Q_EMIT SongChangeRequestProcessed(url, true);
 }
 
 void Player::InvalidSongRequested(const QUrl &url) {
 
+  // The stream URL might have expired, get a new one from the URL handler once before giving up.
+  if (current_item_ && url != current_item_->OriginalUrl() && url_handlers_->CanHandle(current_item_->OriginalUrl()) && stream_url_retried_ != current_item_->OriginalUrl()) {
+    const QUrl media_url = current_item_->OriginalUrl();
+    qLog(Debug) << "Stream URL for" << media_url << "failed, requesting a new one";
+    stream_url_retried_ = media_url;
+    if (prepared_next_url_ == media_url) prepared_next_url_.clear();
+    UrlHandler *url_handler = url_handlers_->GetUrlHandler(media_url);
+    url_handler->InvalidateStreamUrl(media_url);
+    stream_audio_cache_->Remove(media_url);
+    HandleLoadResult(url_handler->StartLoading(media_url));
+    return;
+  }
+
   if (greyout_) Q_EMIT SongChangeRequestProcessed(url, false);
 
   if (!continue_on_error_) {
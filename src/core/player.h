@@ -28,6 +28,7 @@
 #include <QObject>
 #include <QMap>
 #include <QDateTime>
+#include <QElapsedTimer>
 #include <QString>
 #include <QUrl>
 
@@ -47,6 +48,7 @@ class UrlHandlers;
 class PlaylistManager;
 class AnalyzerContainer;
 class Equalizer;
+class StreamAudioCache;
 
 class Player : public PlayerInterface {
   Q_OBJECT
@@ -126,13 +128,24 @@ class Player : public PlayerInterface {
 
   void HandleLoadResult(const UrlHandler::LoadResult &result);
 
+  // Resolves the stream URL of the next item ahead of time, so the track change doesn't wait for the URL handler.
+  void PrepareNextTrack();
+
  private:
   void ResumePlayback();
 
+  void SchedulePrepareNextTrack();
+  // Returns the URL to play the item from, skipping a prepared stream URL that may have expired.
+  QUrl PlayableUrl(PlaylistItemPtr item) const;
+  QUrl CachedStreamUrl(PlaylistItemPtr item) const;
+
   // Returns true if we were supposed to stop after this track.
   bool HandleStopAfter(const Playlist::AutoScroll autoscroll);
 
   void UnPause();
+  // Lets the engine pause and resume the current song by itself when the player has nothing to add.
+  void UpdateFastTransport();
+  void SetStreamDiscovery(const QUrl &media_url, const Song &song);
 
  private:
   const SharedPtr<TaskManager> task_manager_;
@@ -142,6 +155,8 @@ class Player : public PlayerInterface {
   AnalyzerContainer *analyzer_;
   SharedPtr<Equalizer> equalizer_;
   QTimer *timer_save_volume_;
+  QTimer *timer_prepare_next_;
+  StreamAudioCache *stream_audio_cache_;
 
   bool playlists_loaded_;
   bool play_requested_;
@@ -155,6 +170,10 @@ class Player : public PlayerInterface {
   int nb_errors_received_;
 
   QList<QUrl> loading_async_;
+  QUrl preparing_next_url_;
+  QUrl prepared_next_url_;
+  QElapsedTimer prepared_next_timer_;
+  QUrl stream_url_retried_;
   uint volume_;
   uint volume_before_mute_;
   QDateTime last_pressed_previous_;
@@ -0,0 +1,115 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "config.h"
+
+#include <QObject>
+#include <QReadWriteLock>
+#include <QHash>
+#include <QVariant>
+#include <QString>
+#include <QStringList>
+#include <QAnyStringView>
+
+#include "settings.h"
+#include "settingsstore.h"
+
+SettingsStore::SettingsStore(QObject *parent) : QObject(parent), values_(ReadAll()) {
+
+  setObjectName(QLatin1String(QObject::metaObject()->className()));
+
+}
+
+SettingsStore *SettingsStore::Instance() {
+
+  static SettingsStore *instance = new SettingsStore;
+  return instance;
+
+}
+
+QString SettingsStore::StoreKey(const QAnyStringView group, const QAnyStringView key) {
+
+  return group.toString() + u'/' + key.toString();
+
+}
+
+QHash<QString, QVariant> SettingsStore::ReadAll() {
+
+  QHash<QString, QVariant> values;
+
+  Settings s;
+  const QStringList keys = s.allKeys();
+  values.reserve(keys.count());
+  for (const QString &key : keys) {
+    values.insert(key, s.value(key));
+  }
+
+  return values;
+
+}
+
+QVariant SettingsStore::Value(const QAnyStringView group, const QAnyStringView key, const QVariant &default_value) const {
+
+  const QString store_key = StoreKey(group, key);
+
+  QReadLocker l(&lock_);
+  return values_.value(store_key, default_value);
+
+}
+
+void SettingsStore::SetValue(const QAnyStringView group, const QAnyStringView key, const QVariant &value) {
+
+  const QString store_key = StoreKey(group, key);
+
+  {
+    Settings s;
+    s.setValue(store_key, value);
+  }
+
+  {
+    QWriteLocker l(&lock_);
+    if (values_.value(store_key) == value) return;
+    values_.insert(store_key, value);
+  }
+
+  Q_EMIT ValueChanged(store_key, value);
+
+}
+
+void SettingsStore::Reload() {
+
+  const QHash<QString, QVariant> values = ReadAll();
+
+  QHash<QString, QVariant> changed_values;
+  {
+    QWriteLocker l(&lock_);
+    for (QHash<QString, QVariant>::const_iterator it = values.constBegin(); it != values.constEnd(); ++it) {
+      if (values_.value(it.key()) != it.value()) changed_values.insert(it.key(), it.value());
+    }
+    for (QHash<QString, QVariant>::const_iterator it = values_.constBegin(); it != values_.constEnd(); ++it) {
+      if (!values.contains(it.key())) changed_values.insert(it.key(), QVariant());
+    }
+    values_ = values;
+  }
+
+  for (QHash<QString, QVariant>::const_iterator it = changed_values.constBegin(); it != changed_values.constEnd(); ++it) {
+    Q_EMIT ValueChanged(it.key(), it.value());
+  }
+
+}
@@ -0,0 +1,76 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef SETTINGSSTORE_H
+#define SETTINGSSTORE_H
+
+#include "config.h"
+
+#include <utility>
+
+#include <QObject>
+#include <QReadWriteLock>
+#include <QHash>
+#include <QVariant>
+#include <QString>
+#include <QAnyStringView>
+
+// In-memory copy of the settings, read from the settings file once.
+// Reading a value doesn't parse the settings file, and subsystems can watch the keys they use instead of reloading whole groups.
+// Values written with Settings directly are only seen after Reload(), which is called when the settings dialog saves.
+// Values can be read from any thread, signals are emitted in the thread calling Reload() or SetValue().
+class SettingsStore : public QObject {
+  Q_OBJECT
+
+ public:
+  static SettingsStore *Instance();
+
+  QVariant Value(const QAnyStringView group, const QAnyStringView key, const QVariant &default_value = QVariant()) const;
+
+  // Writes the value to the settings file and notifies the watchers of the key if the value changed.
+  void SetValue(const QAnyStringView group, const QAnyStringView key, const QVariant &value);
+
+  // Reads the settings file again and notifies the watchers of the changed keys.
+  void Reload();
+
+  // Calls function with the new value each time the key changes, until context is destroyed.
+  template<typename Function>
+  QMetaObject::Connection Watch(const QAnyStringView group, const QAnyStringView key, const QObject *context, Function &&function) {
+    return QObject::connect(this, &SettingsStore::ValueChanged, context, [watched_key = StoreKey(group, key), function = std::forward<Function>(function)](const QString &changed_key, const QVariant &value) {
+      if (changed_key == watched_key) function(value);
+    });
+  }
+
+ Q_SIGNALS:
+  // key is the group and key joined with a slash.
+  void ValueChanged(const QString &key, const QVariant &value);
+
+ private:
+  explicit SettingsStore(QObject *parent = nullptr);
+
+  static QString StoreKey(const QAnyStringView group, const QAnyStringView key);
+  static QHash<QString, QVariant> ReadAll();
+
+  mutable QReadWriteLock lock_;
+  QHash<QString, QVariant> values_;
+
+  Q_DISABLE_COPY(SettingsStore)
+};
+
+#endif  // SETTINGSSTORE_H
@@ -22,6 +22,8 @@
 #include "config.h"
 
 #include <algorithm>
+#include <atomic>
+#include <cstring>
 
 #ifdef HAVE_GPOD
 #  include <gdk-pixbuf/gdk-pixbuf.h>
@@ -38,7 +40,10 @@
 #include <QFileInfo>
 #include <QDir>
 #include <QSharedData>
+#include <QSet>
+#include <QHash>
 #include <QByteArray>
+#include <QVariant>
 #include <QVariantMap>
 #include <QString>
 #include <QStringList>
@@ -46,6 +51,7 @@
 #include <QUrl>
 #include <QIcon>
 #include <QSqlRecord>
+#include <QDataStream>
 
 #include <taglib/tstring.h>
 
@@ -61,6 +67,7 @@
 #include "song.h"
 #include "sqlquery.h"
 #include "sqlrow.h"
+#include "sqlitereader.h"
 #ifdef HAVE_MPRIS2
 #  include "mpris2/mpris_common.h"
 #endif
@@ -153,15 +160,35 @@ const QStringList Song::kColumns = QStringList() << u"title"_s
                                                  << u"ebur128_integrated_loudness_lufs"_s
                                                  << u"ebur128_loudness_range_lu"_s
 
+                                                 << u"metadata_digest"_s
+
                                                  ;
 
 const QStringList Song::kRowIdColumns = QStringList() << u"ROWID"_s << kColumns;
 
 const QString Song::kColumnSpec = kColumns.join(", "_L1);
 const QString Song::kRowIdColumnSpec = kRowIdColumns.join(", "_L1);
+
+const QStringList Song::kDetailColumns = QStringList() << u"lyrics"_s
+                                                       << u"fingerprint"_s
+                                                       << u"acoustid_id"_s
+                                                       << u"acoustid_fingerprint"_s
+                                                       << u"musicbrainz_album_artist_id"_s
+                                                       << u"musicbrainz_artist_id"_s
+                                                       << u"musicbrainz_original_artist_id"_s
+                                                       << u"musicbrainz_album_id"_s
+                                                       << u"musicbrainz_original_album_id"_s
+                                                       << u"musicbrainz_recording_id"_s
+                                                       << u"musicbrainz_track_id"_s
+                                                       << u"musicbrainz_disc_id"_s
+                                                       << u"musicbrainz_release_group_id"_s
+                                                       << u"musicbrainz_work_id"_s;
 const QString Song::kBindSpec = Utilities::Prepend(u":"_s, kColumns).join(", "_L1);
 const QString Song::kUpdateSpec = Utilities::Updateify(kColumns).join(", "_L1);
 
+const char *Song::kLongTextTable = "songs_text";
+const qsizetype Song::kLongTextMinSize = 512;
+
 const QStringList Song::kTextSearchColumns = QStringList()      << u"title"_s
                                                                 << u"album"_s
                                                                 << u"artist"_s
@@ -356,10 +383,30 @@ struct Song::Private : public QSharedData {
   int id3v2_version_;  // ID3v2 tag version (3 or 4), 0 if not applicable or unknown
 
   bool init_from_file_;         // Whether this song was loaded from a file using taglib.
+  bool incomplete_;             // Whether this song was loaded from the database without the detail columns.
   bool suspicious_tags_;        // Whether our encoding guesser thinks these tags might be incorrectly encoded.
 
   QUrl stream_url_;             // Temporary stream URL set by the URL handler.
 
+  // Digest of the fields compared by IsMetadataEqual(), 0 if not computed yet.
+  // Computed lazily from const accessors on data that may be shared between threads, so it is atomic.
+  class DigestCache {
+   public:
+    DigestCache() : value_(0) {}
+    DigestCache(const DigestCache &other) : value_(other.load()) {}
+    DigestCache &operator=(const DigestCache &other) {
+      store(other.load());
+      return *this;
+    }
+    quint64 load() const { return value_.load(std::memory_order_relaxed); }
+    void store(const quint64 value) const { value_.store(value, std::memory_order_relaxed); }
+    void reset() { store(0); }
+
+   private:
+    mutable std::atomic<quint64> value_;
+  };
+  DigestCache metadata_digest_;
+
 };
 
 Song::Private::Private(const Source source)
@@ -405,6 +452,7 @@ Song::Private::Private(const Source source)
       id3v2_version_(0),
 
       init_from_file_(false),
+      incomplete_(false),
       suspicious_tags_(false)
 
       {}
@@ -516,16 +564,16 @@ std::optional<double> Song::ebur128_loudness_range_lu() const { return d->ebur12
 
 int Song::id3v2_version() const { return d->id3v2_version_; }
 
-QString *Song::mutable_title() { return &d->title_; }
-QString *Song::mutable_album() { return &d->album_; }
-QString *Song::mutable_artist() { return &d->artist_; }
-QString *Song::mutable_albumartist() { return &d->albumartist_; }
-QString *Song::mutable_genre() { return &d->genre_; }
-QString *Song::mutable_composer() { return &d->composer_; }
-QString *Song::mutable_performer() { return &d->performer_; }
-QString *Song::mutable_grouping() { return &d->grouping_; }
-QString *Song::mutable_comment() { return &d->comment_; }
-QString *Song::mutable_lyrics() { return &d->lyrics_; }
+QString *Song::mutable_title() { d->metadata_digest_.reset(); return &d->title_; }
+QString *Song::mutable_album() { d->metadata_digest_.reset(); return &d->album_; }
+QString *Song::mutable_artist() { d->metadata_digest_.reset(); return &d->artist_; }
+QString *Song::mutable_albumartist() { d->metadata_digest_.reset(); return &d->albumartist_; }
+QString *Song::mutable_genre() { d->metadata_digest_.reset(); return &d->genre_; }
+QString *Song::mutable_composer() { d->metadata_digest_.reset(); return &d->composer_; }
+QString *Song::mutable_performer() { d->metadata_digest_.reset(); return &d->performer_; }
+QString *Song::mutable_grouping() { d->metadata_digest_.reset(); return &d->grouping_; }
+QString *Song::mutable_comment() { d->metadata_digest_.reset(); return &d->comment_; }
+QString *Song::mutable_lyrics() { d->metadata_digest_.reset(); return &d->lyrics_; }
 QString *Song::mutable_acoustid_id() { return &d->acoustid_id_; }
 QString *Song::mutable_acoustid_fingerprint() { return &d->acoustid_fingerprint_; }
 QString *Song::mutable_musicbrainz_album_artist_id() { return &d->musicbrainz_album_artist_id_; }
@@ -540,45 +588,46 @@ QString *Song::mutable_musicbrainz_release_group_id() { return &d->musicbrainz_r
 QString *Song::mutable_musicbrainz_work_id() { return &d->musicbrainz_work_id_; }
 
 bool Song::init_from_file() const { return d->init_from_file_; }
+bool Song::is_incomplete() const { return d->incomplete_; }
 
 const QUrl &Song::stream_url() const { return d->stream_url_; }
 
 void Song::set_id(const int id) { d->id_ = id; }
 void Song::set_valid(const bool v) { d->valid_ = v; }
 
-void Song::set_title(const QString &v) { d->title_ = v; }
-void Song::set_titlesort(const QString &v) { d->titlesort_ = v; }
-void Song::set_album(const QString &v) { d->album_ = v; }
-void Song::set_albumsort(const QString &v) { d->albumsort_ = v; }
-void Song::set_artist(const QString &v) { d->artist_ = v; }
-void Song::set_artistsort(const QString &v) { d->artistsort_ = v; }
-void Song::set_albumartist(const QString &v) { d->albumartist_ = v; }
-void Song::set_albumartistsort(const QString &v) { d->albumartistsort_ = v; }
-void Song::set_track(const int v) { d->track_ = v; }
-void Song::set_disc(const int v) { d->disc_ = v; }
-void Song::set_year(const int v) { d->year_ = v; }
-void Song::set_originalyear(const int v) { d->originalyear_ = v; }
-void Song::set_genre(const QString &v) { d->genre_ = v; }
-void Song::set_compilation(const bool v) { d->compilation_ = v; }
-void Song::set_composer(const QString &v) { d->composer_ = v; }
-void Song::set_composersort(const QString &v) { d->composersort_ = v; }
-void Song::set_performer(const QString &v) { d->performer_ = v; }
-void Song::set_performersort(const QString &v) { d->performersort_ = v; }
-void Song::set_grouping(const QString &v) { d->grouping_ = v; }
-void Song::set_comment(const QString &v) { d->comment_ = v; }
-void Song::set_lyrics(const QString &v) { d->lyrics_ = v; }
-
-void Song::set_artist_id(const QString &v) { d->artist_id_ = v; }
-void Song::set_album_id(const QString &v) { d->album_id_ = v; }
-void Song::set_song_id(const QString &v) { d->song_id_ = v; }
-
-void Song::set_beginning_nanosec(const qint64 v) { d->beginning_ = qMax(0LL, v); }
-void Song::set_end_nanosec(const qint64 v) { d->end_ = v; }
-void Song::set_length_nanosec(const qint64 v) { d->end_ = d->beginning_ + v; }
-
-void Song::set_bitrate(const int v) { d->bitrate_ = v; }
-void Song::set_samplerate(const int v) { d->samplerate_ = v; }
-void Song::set_bitdepth(const int v) { d->bitdepth_ = v; }
+void Song::set_title(const QString &v) { d->title_ = v; d->metadata_digest_.reset(); }
+void Song::set_titlesort(const QString &v) { d->titlesort_ = v; d->metadata_digest_.reset(); }
+void Song::set_album(const QString &v) { d->album_ = v; d->metadata_digest_.reset(); }
+void Song::set_albumsort(const QString &v) { d->albumsort_ = v; d->metadata_digest_.reset(); }
+void Song::set_artist(const QString &v) { d->artist_ = v; d->metadata_digest_.reset(); }
+void Song::set_artistsort(const QString &v) { d->artistsort_ = v; d->metadata_digest_.reset(); }
+void Song::set_albumartist(const QString &v) { d->albumartist_ = v; d->metadata_digest_.reset(); }
+void Song::set_albumartistsort(const QString &v) { d->albumartistsort_ = v; d->metadata_digest_.reset(); }
+void Song::set_track(const int v) { d->track_ = v; d->metadata_digest_.reset(); }
+void Song::set_disc(const int v) { d->disc_ = v; d->metadata_digest_.reset(); }
+void Song::set_year(const int v) { d->year_ = v; d->metadata_digest_.reset(); }
+void Song::set_originalyear(const int v) { d->originalyear_ = v; d->metadata_digest_.reset(); }
+void Song::set_genre(const QString &v) { d->genre_ = v; d->metadata_digest_.reset(); }
+void Song::set_compilation(const bool v) { d->compilation_ = v; d->metadata_digest_.reset(); }
+void Song::set_composer(const QString &v) { d->composer_ = v; d->metadata_digest_.reset(); }
+void Song::set_composersort(const QString &v) { d->composersort_ = v; d->metadata_digest_.reset(); }
+void Song::set_performer(const QString &v) { d->performer_ = v; d->metadata_digest_.reset(); }
+void Song::set_performersort(const QString &v) { d->performersort_ = v; d->metadata_digest_.reset(); }
+void Song::set_grouping(const QString &v) { d->grouping_ = v; d->metadata_digest_.reset(); }
+void Song::set_comment(const QString &v) { d->comment_ = v; d->metadata_digest_.reset(); }
+void Song::set_lyrics(const QString &v) { d->lyrics_ = v; d->metadata_digest_.reset(); }
+
+void Song::set_artist_id(const QString &v) { d->artist_id_ = v; d->metadata_digest_.reset(); }
+void Song::set_album_id(const QString &v) { d->album_id_ = v; d->metadata_digest_.reset(); }
+void Song::set_song_id(const QString &v) { d->song_id_ = v; d->metadata_digest_.reset(); }
+
+void Song::set_beginning_nanosec(const qint64 v) { d->beginning_ = qMax(0LL, v); d->metadata_digest_.reset(); }
+void Song::set_end_nanosec(const qint64 v) { d->end_ = v; d->metadata_digest_.reset(); }
+void Song::set_length_nanosec(const qint64 v) { d->end_ = d->beginning_ + v; d->metadata_digest_.reset(); }
+
+void Song::set_bitrate(const int v) { d->bitrate_ = v; d->metadata_digest_.reset(); }
+void Song::set_samplerate(const int v) { d->samplerate_ = v; d->metadata_digest_.reset(); }
+void Song::set_bitdepth(const int v) { d->bitdepth_ = v; d->metadata_digest_.reset(); }
 
 void Song::set_source(const Source v) { d->source_ = v; }
 void Song::set_directory_id(const int v) { d->directory_id_ = v; }
@@ -606,12 +655,12 @@ void Song::set_art_automatic(const QUrl &v) { d->art_automatic_ = v; }
 void Song::set_art_manual(const QUrl &v) { d->art_manual_ = v; }
 void Song::set_art_unset(const bool v) { d->art_unset_ = v; }
 
-void Song::set_cue_path(const QString &v) { d->cue_path_ = v; }
+void Song::set_cue_path(const QString &v) { d->cue_path_ = v; d->metadata_digest_.reset(); }
 
 void Song::set_rating(const float v) { d->rating_ = v; }
-void Song::set_bpm(const float v) { d->bpm_ = v; }
-void Song::set_mood(const QString &v) { d->mood_ = v; }
-void Song::set_initial_key(const QString &v) { d->initial_key_ = v; }
+void Song::set_bpm(const float v) { d->bpm_ = v; d->metadata_digest_.reset(); }
+void Song::set_mood(const QString &v) { d->mood_ = v; d->metadata_digest_.reset(); }
+void Song::set_initial_key(const QString &v) { d->initial_key_ = v; d->metadata_digest_.reset(); }
 
 void Song::set_acoustid_id(const QString &v) { d->acoustid_id_ = v; }
 void Song::set_acoustid_fingerprint(const QString &v) { d->acoustid_fingerprint_ = v; }
@@ -633,28 +682,29 @@ void Song::set_ebur128_loudness_range_lu(const std::optional<double> v) { d->ebu
 void Song::set_id3v2_version(const int v) { d->id3v2_version_ = v; }
 
 void Song::set_init_from_file(const bool v) { d->init_from_file_ = v; }
+void Song::set_incomplete(const bool v) { d->incomplete_ = v; }
 
 void Song::set_stream_url(const QUrl &v) { d->stream_url_ = v; }
 
-void Song::set_title(const TagLib::String &v) { d->title_ = TagLibStringToQString(v); }
-void Song::set_titlesort(const TagLib::String &v) { d->titlesort_ = TagLibStringToQString(v); }
-void Song::set_album(const TagLib::String &v) { d->album_ = TagLibStringToQString(v); }
-void Song::set_albumsort(const TagLib::String &v) { d->albumsort_ = TagLibStringToQString(v); }
-void Song::set_artist(const TagLib::String &v) { d->artist_ = TagLibStringToQString(v); }
-void Song::set_artistsort(const TagLib::String &v) { d->artistsort_ = TagLibStringToQString(v); }
-void Song::set_albumartist(const TagLib::String &v) { d->albumartist_ = TagLibStringToQString(v); }
-void Song::set_albumartistsort(const TagLib::String &v) { d->albumartistsort_ = TagLibStringToQString(v); }
-void Song::set_genre(const TagLib::String &v) { d->genre_ = TagLibStringToQString(v); }
-void Song::set_composer(const TagLib::String &v) { d->composer_ = TagLibStringToQString(v); }
-void Song::set_composersort(const TagLib::String &v) { d->composersort_ = TagLibStringToQString(v); }
-void Song::set_performer(const TagLib::String &v) { d->performer_ = TagLibStringToQString(v); }
-void Song::set_performersort(const TagLib::String &v) { d->performersort_ = TagLibStringToQString(v); }
-void Song::set_grouping(const TagLib::String &v) { d->grouping_ = TagLibStringToQString(v); }
-void Song::set_comment(const TagLib::String &v) { d->comment_ = TagLibStringToQString(v); }
-void Song::set_lyrics(const TagLib::String &v) { d->lyrics_ = TagLibStringToQString(v); }
-void Song::set_artist_id(const TagLib::String &v) { d->artist_id_ = TagLibStringToQString(v); }
-void Song::set_album_id(const TagLib::String &v) { d->album_id_ = TagLibStringToQString(v); }
-void Song::set_song_id(const TagLib::String &v) { d->song_id_ = TagLibStringToQString(v); }
+void Song::set_title(const TagLib::String &v) { d->title_ = TagLibStringToQString(v); d->metadata_digest_.reset(); }
+void Song::set_titlesort(const TagLib::String &v) { d->titlesort_ = TagLibStringToQString(v); d->metadata_digest_.reset(); }
+void Song::set_album(const TagLib::String &v) { d->album_ = TagLibStringToQString(v); d->metadata_digest_.reset(); }
+void Song::set_albumsort(const TagLib::String &v) { d->albumsort_ = TagLibStringToQString(v); d->metadata_digest_.reset(); }
+void Song::set_artist(const TagLib::String &v) { d->artist_ = TagLibStringToQString(v); d->metadata_digest_.reset(); }
+void Song::set_artistsort(const TagLib::String &v) { d->artistsort_ = TagLibStringToQString(v); d->metadata_digest_.reset(); }
+void Song::set_albumartist(const TagLib::String &v) { d->albumartist_ = TagLibStringToQString(v); d->metadata_digest_.reset(); }
+void Song::set_albumartistsort(const TagLib::String &v) { d->albumartistsort_ = TagLibStringToQString(v); d->metadata_digest_.reset(); }
+void Song::set_genre(const TagLib::String &v) { d->genre_ = TagLibStringToQString(v); d->metadata_digest_.reset(); }
+void Song::set_composer(const TagLib::String &v) { d->composer_ = TagLibStringToQString(v); d->metadata_digest_.reset(); }
+void Song::set_composersort(const TagLib::String &v) { d->composersort_ = TagLibStringToQString(v); d->metadata_digest_.reset(); }
+void Song::set_performer(const TagLib::String &v) { d->performer_ = TagLibStringToQString(v); d->metadata_digest_.reset(); }
+void Song::set_performersort(const TagLib::String &v) { d->performersort_ = TagLibStringToQString(v); d->metadata_digest_.reset(); }
+void Song::set_grouping(const TagLib::String &v) { d->grouping_ = TagLibStringToQString(v); d->metadata_digest_.reset(); }
+void Song::set_comment(const TagLib::String &v) { d->comment_ = TagLibStringToQString(v); d->metadata_digest_.reset(); }
+void Song::set_lyrics(const TagLib::String &v) { d->lyrics_ = TagLibStringToQString(v); d->metadata_digest_.reset(); }
+void Song::set_artist_id(const TagLib::String &v) { d->artist_id_ = TagLibStringToQString(v); d->metadata_digest_.reset(); }
+void Song::set_album_id(const TagLib::String &v) { d->album_id_ = TagLibStringToQString(v); d->metadata_digest_.reset(); }
+void Song::set_song_id(const TagLib::String &v) { d->song_id_ = TagLibStringToQString(v); d->metadata_digest_.reset(); }
 void Song::set_acoustid_id(const TagLib::String &v) { d->acoustid_id_ = TagLibStringToQString(v).remove(u' ').replace(u';', u'/'); }
 void Song::set_acoustid_fingerprint(const TagLib::String &v) { d->acoustid_fingerprint_ = TagLibStringToQString(v).remove(u' ').replace(u';', u'/'); }
 void Song::set_musicbrainz_album_artist_id(const TagLib::String &v) { d->musicbrainz_album_artist_id_ = TagLibStringToQString(v).remove(u' ').replace(u';', u'/'); }
@@ -667,8 +717,8 @@ void Song::set_musicbrainz_track_id(const TagLib::String &v) { d->musicbrainz_tr
 void Song::set_musicbrainz_disc_id(const TagLib::String &v) { d->musicbrainz_disc_id_ = TagLibStringToQString(v).remove(u' ').replace(u';', u'/'); }
 void Song::set_musicbrainz_release_group_id(const TagLib::String &v) { d->musicbrainz_release_group_id_ = TagLibStringToQString(v).remove(u' ').replace(u';', u'/'); }
 void Song::set_musicbrainz_work_id(const TagLib::String &v) { d->musicbrainz_work_id_ = TagLibStringToQString(v).remove(u' ').replace(u';', u'/'); }
-void Song::set_mood(const TagLib::String &v) { d->mood_ = TagLibStringToQString(v); }
-void Song::set_initial_key(const TagLib::String &v) { d->initial_key_ = TagLibStringToQString(v); }
+void Song::set_mood(const TagLib::String &v) { d->mood_ = TagLibStringToQString(v); d->metadata_digest_.reset(); }
+void Song::set_initial_key(const TagLib::String &v) { d->initial_key_ = TagLibStringToQString(v); d->metadata_digest_.reset(); }
 
 const QUrl &Song::effective_url() const { return !d->stream_url_.isEmpty() && d->stream_url_.isValid() ? d->stream_url_ : d->url_; }
 const QString &Song::effective_titlesort() const { return d->titlesort_.isEmpty() ? d->title_ : d->titlesort_; }
@@ -856,6 +906,47 @@ QString Song::JoinSpec(const QString &table) {
   return Utilities::Prepend(table + QLatin1Char('.'), kRowIdColumns).join(", "_L1);
 }
 
+QString Song::LongTextJoinSpec(const QString &table) {
+
+  QStringList columns;
+  columns.reserve(kRowIdColumns.count());
+  for (const QString &column : kRowIdColumns) {
+    if (column == "lyrics"_L1) {
+      columns << QStringLiteral("COALESCE(%1.lyrics, (SELECT %2.lyrics FROM %2 WHERE %2.song_id = %1.ROWID))").arg(table, QLatin1String(kLongTextTable));
+    }
+    else {
+      columns << table + QLatin1Char('.') + column;
+    }
+  }
+
+  return columns.join(", "_L1);
+
+}
+
+QByteArray Song::CompressLongText(const QString &text) {
+  return qCompress(text.toUtf8());
+}
+
+QString Song::ProjectionSpec(const QStringList &excluded_columns, const QString &table) {
+
+  QStringList columns;
+  columns.reserve(kRowIdColumns.count());
+  for (const QString &column : kRowIdColumns) {
+    if (excluded_columns.contains(column)) {
+      columns << u"NULL"_s;
+    }
+    else if (table.isEmpty()) {
+      columns << column;
+    }
+    else {
+      columns << table + QLatin1Char('.') + column;
+    }
+  }
+
+  return columns.join(", "_L1);
+
+}
+
 QString Song::PrettyTitle() const {
 
   QString title(d->title_);
@@ -977,6 +1068,15 @@ bool Song::IsFileInfoEqual(const Song &other) const {
 
 bool Song::IsMetadataEqual(const Song &other) const {
 
+  if (d == other.d) return true;
+
+  // Only trust the digests when both are already known, computing one costs as much as comparing the fields.
+  const quint64 digest = d->metadata_digest_.load();
+  const quint64 other_digest = other.d->metadata_digest_.load();
+  if (digest != 0 && other_digest != 0) {
+    return digest == other_digest;
+  }
+
   return d->title_ == other.d->title_ &&
          d->titlesort_ == other.d->titlesort_ &&
          d->album_ == other.d->album_ &&
@@ -1012,6 +1112,76 @@ bool Song::IsMetadataEqual(const Song &other) const {
          d->cue_path_ == other.d->cue_path_;
 }
 
+quint64 Song::metadata_digest() const {
+
+  quint64 digest = d->metadata_digest_.load();
+  if (digest != 0) return digest;
+
+  // 64-bit FNV-1a over the fields compared by IsMetadataEqual().
+  // The value is stored in the database, so it must not depend on the platform or the Qt version.
+  digest = 14695981039346656037ULL;
+  const auto add_value = [&digest](const quint64 value) {
+    for (int i = 0; i < 8; ++i) {
+      digest ^= (value >> (i * 8)) & 0xFF;
+      digest *= 1099511628211ULL;
+    }
+  };
+  const auto add_string = [&digest, &add_value](const QString &str) {
+    add_value(static_cast<quint64>(str.size()));
+    for (const QChar c : str) {
+      digest ^= c.unicode();
+      digest *= 1099511628211ULL;
+    }
+  };
+  const auto add_float = [&add_value](const float value) {
+    quint32 bits = 0;
+    std::memcpy(&bits, &value, sizeof(bits));
+    add_value(bits);
+  };
+
+  add_string(d->title_);
+  add_string(d->titlesort_);
+  add_string(d->album_);
+  add_string(d->albumsort_);
+  add_string(d->artist_);
+  add_string(d->artistsort_);
+  add_string(d->albumartist_);
+  add_string(d->albumartistsort_);
+  add_value(static_cast<quint64>(d->track_));
+  add_value(static_cast<quint64>(d->disc_));
+  add_value(static_cast<quint64>(d->year_));
+  add_value(static_cast<quint64>(d->originalyear_));
+  add_string(d->genre_);
+  add_value(d->compilation_ ? 1 : 0);
+  add_string(d->composer_);
+  add_string(d->composersort_);
+  add_string(d->performer_);
+  add_string(d->performersort_);
+  add_string(d->grouping_);
+  add_string(d->comment_);
+  add_string(d->lyrics_);
+  add_string(d->artist_id_);
+  add_string(d->album_id_);
+  add_string(d->song_id_);
+  add_value(static_cast<quint64>(d->beginning_));
+  add_value(static_cast<quint64>(length_nanosec()));
+  add_value(static_cast<quint64>(d->bitrate_));
+  add_value(static_cast<quint64>(d->samplerate_));
+  add_value(static_cast<quint64>(d->bitdepth_));
+  add_float(d->bpm_);
+  add_string(d->mood_);
+  add_string(d->initial_key_);
+  add_string(d->cue_path_);
+
+  // 0 means "not computed".
+  if (digest == 0) digest = 1;
+
+  d->metadata_digest_.store(digest);
+
+  return digest;
+
+}
+
 bool Song::IsPlayStatisticsEqual(const Song &other) const {
 
   return d->playcount_ == other.d->playcount_ &&
@@ -1098,6 +1268,10 @@ bool Song::IsAllMetadataEqual(const Song &other) const {
 
 }
 
+bool Song::IsSharedWith(const Song &other) const {
+  return d == other.d;
+}
+
 bool Song::IsEqual(const Song &other) const {
 
   return IsFileInfoEqual(other) &&
@@ -1534,6 +1708,7 @@ void Song::Init(const QString &title, const QString &artist, const QString &albu
 
   d->beginning_ = beginning;
   d->end_ = end;
+  d->metadata_digest_.reset();
 
 }
 
@@ -1563,7 +1738,9 @@ void Song::InitFromQuery(const QSqlRecord &r, const bool reliable_metadata, cons
   d->performersort_ = SqlHelper::ValueToString(r, ColumnIndex(u"performersort"_s) + col);
   d->grouping_ = SqlHelper::ValueToString(r, ColumnIndex(u"grouping"_s) + col);
   d->comment_ = SqlHelper::ValueToString(r, ColumnIndex(u"comment"_s) + col);
-  d->lyrics_ = SqlHelper::ValueToString(r, ColumnIndex(u"lyrics"_s) + col);
+  // Lyrics from the long text table are compressed, SQLite returns them as a blob.
+  const QVariant lyrics = r.value(ColumnIndex(u"lyrics"_s) + col);
+  d->lyrics_ = lyrics.typeId() == QMetaType::QByteArray ? QString::fromUtf8(qUncompress(lyrics.toByteArray())) : SqlHelper::ValueToString(r, ColumnIndex(u"lyrics"_s) + col);
   d->artist_id_ = SqlHelper::ValueToString(r, ColumnIndex(u"artist_id"_s) + col);
   d->album_id_ = SqlHelper::ValueToString(r, ColumnIndex(u"album_id"_s) + col);
   d->song_id_ = SqlHelper::ValueToString(r, ColumnIndex(u"song_id"_s) + col);
@@ -1622,6 +1799,8 @@ void Song::InitFromQuery(const QSqlRecord &r, const bool reliable_metadata, cons
   d->musicbrainz_release_group_id_ = SqlHelper::ValueToString(r, ColumnIndex(u"musicbrainz_release_group_id"_s) + col);
   d->musicbrainz_work_id_ = SqlHelper::ValueToString(r, ColumnIndex(u"musicbrainz_work_id"_s) + col);
 
+  d->metadata_digest_.store(r.value(ColumnIndex(u"metadata_digest"_s) + col).toULongLong());
+
   d->valid_ = true;
   d->init_from_file_ = reliable_metadata;
 
@@ -1641,6 +1820,170 @@ void Song::InitFromQuery(const SqlRow &row, const bool reliable_metadata, const
 
 }
 
+void Song::InitFromSqliteReader(SqliteReader *reader, const bool reliable_metadata, const int col) {
+
+  Q_ASSERT(kRowIdColumns.count() + col <= reader->columns());
+
+  static const QHash<QString, int> column_indexes = []() {
+    QHash<QString, int> indexes;
+    for (int i = 0; i < kRowIdColumns.count(); ++i) {
+      indexes.insert(kRowIdColumns[i], i);
+    }
+    return indexes;
+  }();
+
+  const auto column = [col](const QString &field) { return column_indexes.value(field) + col; };
+  const auto to_int = [reader, &column](const QString &field) { const int i = column(field); return reader->IsNull(i) ? -1 : reader->Int(i); };
+  const auto to_uint = [reader, &column](const QString &field) { const int i = column(field); return reader->IsNull(i) || reader->Int(i) < 0 ? 0U : static_cast<uint>(reader->Int(i)); };
+  const auto to_longlong = [reader, &column](const QString &field) { const int i = column(field); return reader->IsNull(i) ? -1LL : reader->LongLong(i); };
+  const auto to_float = [reader, &column](const QString &field) { const int i = column(field); return reader->IsNull(i) ? -1.0F : static_cast<float>(reader->Double(i)); };
+  const auto to_bool = [reader, &column](const QString &field) { const int i = column(field); return !reader->IsNull(i) && reader->Int(i) == 1; };
+  const auto to_string = [reader, &column](const QString &field) { return reader->String(column(field)); };
+  const auto to_shared_string = [reader, &column](const QString &field) { return reader->SharedString(column(field)); };
+
+  d->id_ = to_int(u"ROWID"_s);
+
+  d->title_ = to_string(u"title"_s);
+  d->titlesort_ = to_string(u"titlesort"_s);
+  d->album_ = to_shared_string(u"album"_s);
+  d->albumsort_ = to_shared_string(u"albumsort"_s);
+  d->artist_ = to_shared_string(u"artist"_s);
+  d->artistsort_ = to_shared_string(u"artistsort"_s);
+  d->albumartist_ = to_shared_string(u"albumartist"_s);
+  d->albumartistsort_ = to_shared_string(u"albumartistsort"_s);
+  d->track_ = to_int(u"track"_s);
+  d->disc_ = to_int(u"disc"_s);
+  d->year_ = to_int(u"year"_s);
+  d->originalyear_ = to_int(u"originalyear"_s);
+  d->genre_ = to_shared_string(u"genre"_s);
+  d->compilation_ = reader->Int(column(u"compilation"_s)) != 0;
+  d->composer_ = to_shared_string(u"composer"_s);
+  d->composersort_ = to_shared_string(u"composersort"_s);
+  d->performer_ = to_shared_string(u"performer"_s);
+  d->performersort_ = to_shared_string(u"performersort"_s);
+  d->grouping_ = to_shared_string(u"grouping"_s);
+  d->comment_ = to_shared_string(u"comment"_s);
+  d->lyrics_ = to_string(u"lyrics"_s);
+  d->artist_id_ = to_shared_string(u"artist_id"_s);
+  d->album_id_ = to_shared_string(u"album_id"_s);
+  d->song_id_ = to_string(u"song_id"_s);
+  d->beginning_ = reader->LongLong(column(u"beginning"_s));
+  set_length_nanosec(to_longlong(u"length"_s));
+  d->bitrate_ = to_int(u"bitrate"_s);
+  d->samplerate_ = to_int(u"samplerate"_s);
+  d->bitdepth_ = to_int(u"bitdepth"_s);
+  if (!reader->IsNull(column(u"ebur128_integrated_loudness_lufs"_s))) {
+    d->ebur128_integrated_loudness_lufs_ = reader->Double(column(u"ebur128_integrated_loudness_lufs"_s));
+  }
+  if (!reader->IsNull(column(u"ebur128_loudness_range_lu"_s))) {
+    d->ebur128_loudness_range_lu_ = reader->Double(column(u"ebur128_loudness_range_lu"_s));
+  }
+  d->source_ = static_cast<Source>(reader->Int(column(u"source"_s)));
+  d->directory_id_ = to_int(u"directory_id"_s);
+  d->url_ = reader->Url(column(u"url"_s));
+  d->basefilename_ = d->url_.isLocalFile() ? d->url_.fileName() : QString();
+  d->filetype_ = FileType(reader->Int(column(u"filetype"_s)));
+  d->filesize_ = to_longlong(u"filesize"_s);
+  d->mtime_ = to_longlong(u"mtime"_s);
+  d->ctime_ = to_longlong(u"ctime"_s);
+  d->unavailable_ = reader->Int(column(u"unavailable"_s)) != 0;
+  d->fingerprint_ = to_string(u"fingerprint"_s);
+  d->playcount_ = to_uint(u"playcount"_s);
+  d->skipcount_ = to_uint(u"skipcount"_s);
+  d->lastplayed_ = to_longlong(u"lastplayed"_s);
+  d->lastseen_ = to_longlong(u"lastseen"_s);
+  d->compilation_detected_ = to_bool(u"compilation_detected"_s);
+  d->compilation_on_ = to_bool(u"compilation_on"_s);
+  d->compilation_off_ = to_bool(u"compilation_off"_s);
+
+  d->art_embedded_ = to_bool(u"art_embedded"_s);
+  d->art_automatic_ = reader->SharedUrl(column(u"art_automatic"_s));
+  d->art_manual_ = reader->SharedUrl(column(u"art_manual"_s));
+  d->art_unset_ = to_bool(u"art_unset"_s);
+
+  d->cue_path_ = to_shared_string(u"cue_path"_s);
+
+  d->rating_ = to_float(u"rating"_s);
+  d->bpm_ = to_float(u"bpm"_s);
+  d->mood_ = to_shared_string(u"mood"_s);
+  d->initial_key_ = to_shared_string(u"initial_key"_s);
+
+  d->acoustid_id_ = to_string(u"acoustid_id"_s);
+  d->acoustid_fingerprint_ = to_string(u"acoustid_fingerprint"_s);
+
+  d->musicbrainz_album_artist_id_ = to_shared_string(u"musicbrainz_album_artist_id"_s);
+  d->musicbrainz_artist_id_ = to_shared_string(u"musicbrainz_artist_id"_s);
+  d->musicbrainz_original_artist_id_ = to_shared_string(u"musicbrainz_original_artist_id"_s);
+  d->musicbrainz_album_id_ = to_shared_string(u"musicbrainz_album_id"_s);
+  d->musicbrainz_original_album_id_ = to_shared_string(u"musicbrainz_original_album_id"_s);
+  d->musicbrainz_recording_id_ = to_string(u"musicbrainz_recording_id"_s);
+  d->musicbrainz_track_id_ = to_string(u"musicbrainz_track_id"_s);
+  d->musicbrainz_disc_id_ = to_string(u"musicbrainz_disc_id"_s);
+  d->musicbrainz_release_group_id_ = to_shared_string(u"musicbrainz_release_group_id"_s);
+  d->musicbrainz_work_id_ = to_string(u"musicbrainz_work_id"_s);
+
+  d->metadata_digest_.store(reader->IsNull(column(u"metadata_digest"_s)) ? 0 : static_cast<quint64>(reader->LongLong(column(u"metadata_digest"_s))));
+
+  d->valid_ = true;
+  d->init_from_file_ = reliable_metadata;
+
+  InitArtManual();
+
+}
+
+void Song::ShareStrings(QSet<QString> &strings, QSet<QUrl> &urls) {
+
+  const auto share_string = [&strings](QString &str) {
+    if (str.isEmpty()) return;
+    QSet<QString>::const_iterator it = strings.constFind(str);
+    if (it == strings.constEnd()) {
+      strings.insert(str);
+    }
+    else {
+      str = *it;
+    }
+  };
+
+  const auto share_url = [&urls](QUrl &url) {
+    if (url.isEmpty()) return;
+    QSet<QUrl>::const_iterator it = urls.constFind(url);
+    if (it == urls.constEnd()) {
+      urls.insert(url);
+    }
+    else {
+      url = *it;
+    }
+  };
+
+  share_string(d->album_);
+  share_string(d->albumsort_);
+  share_string(d->artist_);
+  share_string(d->artistsort_);
+  share_string(d->albumartist_);
+  share_string(d->albumartistsort_);
+  share_string(d->genre_);
+  share_string(d->composer_);
+  share_string(d->composersort_);
+  share_string(d->performer_);
+  share_string(d->performersort_);
+  share_string(d->grouping_);
+  share_string(d->comment_);
+  share_string(d->artist_id_);
+  share_string(d->album_id_);
+  share_string(d->cue_path_);
+  share_string(d->mood_);
+  share_string(d->initial_key_);
+  share_string(d->musicbrainz_album_artist_id_);
+  share_string(d->musicbrainz_artist_id_);
+  share_string(d->musicbrainz_original_artist_id_);
+  share_string(d->musicbrainz_album_id_);
+  share_string(d->musicbrainz_original_album_id_);
+  share_string(d->musicbrainz_release_group_id_);
+  share_url(d->art_automatic_);
+  share_url(d->art_manual_);
+
+}
+
 void Song::InitFromFilePartial(const QString &filename, const QFileInfo &fileinfo) {
 
   set_url(QUrl::fromLocalFile(filename));
@@ -1649,6 +1992,7 @@ void Song::InitFromFilePartial(const QString &filename, const QFileInfo &fileinf
   d->filetype_ = FiletypeByExtension(fileinfo.suffix());
   d->basefilename_ = fileinfo.fileName();
   d->title_ = fileinfo.fileName();
+  d->metadata_digest_.reset();
   if (d->art_manual_.isEmpty()) InitArtManual();
 
 }
@@ -1969,6 +2313,189 @@ void Song::BindToQuery(SqlQuery *query) const {
   query->BindDoubleOrNullValue(u":ebur128_integrated_loudness_lufs"_s, d->ebur128_integrated_loudness_lufs_);
   query->BindDoubleOrNullValue(u":ebur128_loudness_range_lu"_s, d->ebur128_loudness_range_lu_);
 
+  query->BindValue(u":metadata_digest"_s, static_cast<qint64>(metadata_digest()));
+
+}
+
+void Song::ToDataStream(QDataStream *s) const {
+
+  *s
+    << d->id_
+    << d->track_
+    << d->disc_
+    << d->year_
+    << d->originalyear_
+    << d->bitrate_
+    << d->samplerate_
+    << d->bitdepth_
+    << d->directory_id_
+    << d->id3v2_version_
+    << d->beginning_
+    << d->end_
+    << d->filesize_
+    << d->mtime_
+    << d->ctime_
+    << d->lastplayed_
+    << d->lastseen_
+    << d->playcount_
+    << d->skipcount_
+    << d->valid_
+    << d->compilation_
+    << d->unavailable_
+    << d->compilation_detected_
+    << d->compilation_on_
+    << d->compilation_off_
+    << d->art_embedded_
+    << d->art_unset_
+    << d->init_from_file_
+    << d->incomplete_
+    << d->suspicious_tags_
+    << d->rating_
+    << d->bpm_
+    << d->title_
+    << d->titlesort_
+    << d->album_
+    << d->albumsort_
+    << d->artist_
+    << d->artistsort_
+    << d->albumartist_
+    << d->albumartistsort_
+    << d->genre_
+    << d->composer_
+    << d->composersort_
+    << d->performer_
+    << d->performersort_
+    << d->grouping_
+    << d->comment_
+    << d->lyrics_
+    << d->artist_id_
+    << d->album_id_
+    << d->song_id_
+    << d->basefilename_
+    << d->fingerprint_
+    << d->cue_path_
+    << d->mood_
+    << d->initial_key_
+    << d->acoustid_id_
+    << d->acoustid_fingerprint_
+    << d->musicbrainz_album_artist_id_
+    << d->musicbrainz_artist_id_
+    << d->musicbrainz_original_artist_id_
+    << d->musicbrainz_album_id_
+    << d->musicbrainz_original_album_id_
+    << d->musicbrainz_recording_id_
+    << d->musicbrainz_track_id_
+    << d->musicbrainz_disc_id_
+    << d->musicbrainz_release_group_id_
+    << d->musicbrainz_work_id_
+    << d->url_
+    << d->art_automatic_
+    << d->art_manual_
+    << d->stream_url_;
+
+  *s << static_cast<qint32>(d->source_) << static_cast<qint32>(d->filetype_);
+
+  *s << d->ebur128_integrated_loudness_lufs_.has_value() << d->ebur128_integrated_loudness_lufs_.value_or(0.0);
+  *s << d->ebur128_loudness_range_lu_.has_value() << d->ebur128_loudness_range_lu_.value_or(0.0);
+
+  *s << d->metadata_digest_.load();
+
+}
+
+void Song::InitFromDataStream(QDataStream *s) {
+
+  *s
+    >> d->id_
+    >> d->track_
+    >> d->disc_
+    >> d->year_
+    >> d->originalyear_
+    >> d->bitrate_
+    >> d->samplerate_
+    >> d->bitdepth_
+    >> d->directory_id_
+    >> d->id3v2_version_
+    >> d->beginning_
+    >> d->end_
+    >> d->filesize_
+    >> d->mtime_
+    >> d->ctime_
+    >> d->lastplayed_
+    >> d->lastseen_
+    >> d->playcount_
+    >> d->skipcount_
+    >> d->valid_
+    >> d->compilation_
+    >> d->unavailable_
+    >> d->compilation_detected_
+    >> d->compilation_on_
+    >> d->compilation_off_
+    >> d->art_embedded_
+    >> d->art_unset_
+    >> d->init_from_file_
+    >> d->incomplete_
+    >> d->suspicious_tags_
+    >> d->rating_
+    >> d->bpm_
+    >> d->title_
+    >> d->titlesort_
+    >> d->album_
+    >> d->albumsort_
+    >> d->artist_
+    >> d->artistsort_
+    >> d->albumartist_
+    >> d->albumartistsort_
+    >> d->genre_
+    >> d->composer_
+    >> d->composersort_
+    >> d->performer_
+    >> d->performersort_
+    >> d->grouping_
+    >> d->comment_
+    >> d->lyrics_
+    >> d->artist_id_
+    >> d->album_id_
+    >> d->song_id_
+    >> d->basefilename_
+    >> d->fingerprint_
+    >> d->cue_path_
+    >> d->mood_
+    >> d->initial_key_
+    >> d->acoustid_id_
+    >> d->acoustid_fingerprint_
+    >> d->musicbrainz_album_artist_id_
+    >> d->musicbrainz_artist_id_
+    >> d->musicbrainz_original_artist_id_
+    >> d->musicbrainz_album_id_
+    >> d->musicbrainz_original_album_id_
+    >> d->musicbrainz_recording_id_
+    >> d->musicbrainz_track_id_
+    >> d->musicbrainz_disc_id_
+    >> d->musicbrainz_release_group_id_
+    >> d->musicbrainz_work_id_
+    >> d->url_
+    >> d->art_automatic_
+    >> d->art_manual_
+    >> d->stream_url_;
+
+  qint32 source = 0;
+  qint32 filetype = 0;
+  *s >> source >> filetype;
+  d->source_ = static_cast<Source>(source);
+  d->filetype_ = static_cast<FileType>(filetype);
+
+  bool has_ebur128_integrated_loudness_lufs = false;
+  double ebur128_integrated_loudness_lufs = 0.0;
+  bool has_ebur128_loudness_range_lu = false;
+  double ebur128_loudness_range_lu = 0.0;
+  *s >> has_ebur128_integrated_loudness_lufs >> ebur128_integrated_loudness_lufs >> has_ebur128_loudness_range_lu >> ebur128_loudness_range_lu;
+  d->ebur128_integrated_loudness_lufs_ = has_ebur128_integrated_loudness_lufs ? std::optional<double>(ebur128_integrated_loudness_lufs) : std::nullopt;
+  d->ebur128_loudness_range_lu_ = has_ebur128_loudness_range_lu ? std::optional<double>(ebur128_loudness_range_lu) : std::nullopt;
+
+  quint64 metadata_digest = 0;
+  *s >> metadata_digest;
+  d->metadata_digest_.store(metadata_digest);
+
 }
 
 #ifdef HAVE_MPRIS2
@@ -2049,6 +2576,7 @@ bool Song::MergeFromEngineMetadata(const EngineMetadata &engine_metadata) {
   if (engine_metadata.samplerate > 0) d->samplerate_ = engine_metadata.samplerate;
   if (engine_metadata.bitdepth > 0) d->bitdepth_ = engine_metadata.bitdepth;
   if (engine_metadata.bitrate > 0) d->bitrate_ = engine_metadata.bitrate;
+  d->metadata_digest_.reset();
 
   return minor;
 
@@ -2073,6 +2601,15 @@ void Song::MergeUserSetData(const Song &other, const bool merge_playcount, const
 
 }
 
+void Song::MergeArt(const Song &other) {
+
+  set_art_embedded(other.art_embedded());
+  set_art_automatic(other.art_automatic());
+  set_art_manual(other.art_manual());
+  set_art_unset(other.art_unset());
+
+}
+
 QString Song::AlbumKey() const {
   return QStringLiteral("%1|%2|%3").arg(is_compilation() ? u"_compilation"_s : effective_albumartist(), has_cue() ? cue_path() : ""_L1, effective_album());
 }
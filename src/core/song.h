@@ -47,6 +47,7 @@
 
 class SqlQuery;
 class QSqlRecord;
+class QDataStream;
 
 class EngineMetadata;
 
@@ -59,6 +60,7 @@ struct LIBMTP_track_struct;
 #endif
 
 class SqlRow;
+class SqliteReader;
 
 class Song {
 
@@ -114,9 +116,15 @@ class Song {
   static const QStringList kRowIdColumns;
   static const QString kColumnSpec;
   static const QString kRowIdColumnSpec;
+  // Columns only needed to play, edit or look up songs, not to group, sort, filter or display them in the collection.
+  static const QStringList kDetailColumns;
   static const QString kBindSpec;
   static const QString kUpdateSpec;
 
+  // Lyrics this long are kept compressed in the long text table, out of the rows of the collection songs table.
+  static const char *kLongTextTable;
+  static const qsizetype kLongTextMinSize;
+
   static const QStringList kTextSearchColumns;
   static const QStringList kIntSearchColumns;
   static const QStringList kUIntSearchColumns;
@@ -260,6 +268,8 @@ class Song {
   QString *mutable_musicbrainz_work_id();
 
   bool init_from_file() const;
+  // Whether the song was loaded without the kDetailColumns, see CollectionBackend::GetCompleteSongs().
+  bool is_incomplete() const;
 
   const QUrl &stream_url() const;
 
@@ -354,6 +364,7 @@ class Song {
   void set_id3v2_version(const int v);
 
   void set_init_from_file(const bool v);
+  void set_incomplete(const bool v);
 
   void set_stream_url(const QUrl &v);
 
@@ -448,6 +459,11 @@ class Song {
 
   static int ColumnIndex(const QString &field);
   static QString JoinSpec(const QString &table);
+  // Same as JoinSpec, with the lyrics selected from the long text table when they are not in the songs table.
+  static QString LongTextJoinSpec(const QString &table);
+  static QByteArray CompressLongText(const QString &text);
+  // Same as kRowIdColumnSpec, with the excluded columns selected as NULL so the other columns keep their position for InitFromQuery().
+  static QString ProjectionSpec(const QStringList &excluded_columns, const QString &table = QString());
 
   // Pretty accessors
   QString PrettyTitle() const;
@@ -470,6 +486,9 @@ class Song {
 
   bool IsEditable() const;
 
+  // Digest of the metadata fields, used to short-circuit IsMetadataEqual() and stored in the database.
+  quint64 metadata_digest() const;
+
   // Comparison functions
   bool IsFileInfoEqual(const Song &other) const;
   bool IsMetadataEqual(const Song &other) const;
@@ -484,6 +503,8 @@ class Song {
   bool IsSettingsEqual(const Song &other) const;
   bool IsAllMetadataEqual(const Song &other) const;
   bool IsEqual(const Song &other) const;
+  // True if both songs still share the same data, which means that neither of them has been modified since one was copied from the other.
+  bool IsSharedWith(const Song &other) const;
 
   bool IsOnSameAlbum(const Song &other) const;
   bool IsSimilar(const Song &other) const;
@@ -524,7 +545,12 @@ class Song {
   void InitFromQuery(const QSqlRecord &r, const bool reliable_metadata, const int col = 0);
   void InitFromQuery(const SqlQuery &query, const bool reliable_metadata, const int col = 0);
   void InitFromQuery(const SqlRow &row, const bool reliable_metadata, const int col = 0);
+  // Same as InitFromQuery, strings and URLs repeated across songs are shared by the reader.
+  void InitFromSqliteReader(SqliteReader *reader, const bool reliable_metadata, const int col = 0);
   void InitFromFilePartial(const QString &filename, const QFileInfo &fileinfo);
+
+  // Replace strings repeated across many songs, such as artist and album, with the copies in the tables, so the data is only stored once.
+  void ShareStrings(QSet<QString> &strings, QSet<QUrl> &urls);
   void InitArtManual();
   void InitArtAutomatic();
 
@@ -540,6 +566,9 @@ class Song {
 
   // Save
   void BindToQuery(SqlQuery *query) const;
+  // Used to pass songs between processes.
+  void ToDataStream(QDataStream *s) const;
+  void InitFromDataStream(QDataStream *s);
 #ifdef HAVE_MPRIS2
   void ToXesam(QVariantMap *map) const;
 #endif
@@ -549,6 +578,8 @@ class Song {
   // Copies important statistics from the other song to this one, overwriting any data that already exists.
   // Useful when you want updated tags from disk but you want to keep user stats.
   void MergeUserSetData(const Song &other, const bool merge_playcount, const bool merge_rating);
+  // Copies the album art fields from the other song.
+  void MergeArt(const Song &other);
 
   // Two songs that are on the same album will have the same AlbumKey.
   // It is more efficient to use IsOnSameAlbum, but this function can be used when you need to hash the key to do fast lookups.
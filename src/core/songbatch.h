@@ -0,0 +1,60 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef SONGBATCH_H
+#define SONGBATCH_H
+
+#include "config.h"
+
+#include <memory>
+#include <utility>
+
+#include <QtGlobal>
+#include <QMetaType>
+
+#include "includes/shared_ptr.h"
+#include "song.h"
+
+// An immutable list of songs for signals between threads.
+// The list and its shared state are one allocation, copying the batch into a queued signal only copies the pointer.
+// Nothing can change the songs, so a receiver never detaches the list and copies every song.
+// Converts to const SongList&, slots and functions taking a SongList can be used unchanged.
+class SongBatch {
+ public:
+  SongBatch() : songs_(std::make_shared<const SongList>()) {}
+  // Move the songs in when the list isn't used after, a copied list is detached as soon as the sender changes it.
+  SongBatch(SongList songs) : songs_(std::make_shared<const SongList>(std::move(songs))) {}  // NOLINT(google-explicit-constructor)
+
+  const SongList &songs() const { return *songs_; }
+  operator const SongList&() const { return *songs_; }  // NOLINT(google-explicit-constructor)
+
+  qsizetype count() const { return songs_->count(); }
+  bool isEmpty() const { return songs_->isEmpty(); }
+  const Song &operator[](const qsizetype i) const { return songs_->at(i); }
+
+  SongList::const_iterator begin() const { return songs_->cbegin(); }
+  SongList::const_iterator end() const { return songs_->cend(); }
+
+ private:
+  SharedPtr<const SongList> songs_;
+};
+
+Q_DECLARE_METATYPE(SongBatch)
+
+#endif  // SONGBATCH_H
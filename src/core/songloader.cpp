@@ -45,6 +45,7 @@
 #include "core/song.h"
 #include "core/database.h"
 #include "core/urlhandlers.h"
+#include "engine/gststartup.h"
 #include "songloader.h"
 #include "tagreader/tagreaderclient.h"
 #include "collection/collectionbackend.h"
@@ -101,6 +102,9 @@ SongLoader::SongLoader(const SharedPtr<UrlHandlers> url_handlers,
   QObject::connect(playlist_parser_, &PlaylistParser::Error, this, &SongLoader::ParserError);
   QObject::connect(cue_parser_, &CueParser::Error, this, &SongLoader::ParserError);
 
+  // Playlists are parsed with filenames only, the tags are read in LoadMetadataBlocking() after the songs are inserted.
+  playlist_parser_->SetReadTags(false);
+
 }
 
 SongLoader::~SongLoader() {
@@ -342,6 +346,14 @@ void SongLoader::LoadMetadataBlocking() {
 
 }
 
+void SongLoader::LoadFirstSongMetadataBlocking() {
+
+  if (!songs_.isEmpty()) {
+    EffectiveSongLoad(&songs_[0]);
+  }
+
+}
+
 void SongLoader::EffectiveSongLoad(Song *song) {
 
   if (!song || !song->url().isLocalFile()) return;
@@ -479,6 +491,8 @@ SongLoader::Result SongLoader::LoadRemote() {
 
   ScheduleTimeoutAsync();
 
+  GstStartup::WaitForInitialized();
+
   // Create the pipeline - it gets unreffed if it goes out of scope
   SharedPtr<GstElement> pipeline(gst_pipeline_new(nullptr), std::bind(&gst_object_unref, std::placeholders::_1));
 
@@ -31,7 +31,6 @@
 
 #include <QtGlobal>
 #include <QObject>
-#include <QThreadPool>
 #include <QByteArray>
 #include <QSet>
 #include <QString>
@@ -85,6 +84,8 @@ class SongLoader : public QObject {
   // Completely load songs previously loaded with LoadFilenamesBlocking().
   // When finished, the Song objects in songs() contain metadata now. This method is blocking, do not call it from the UI thread.
   void LoadMetadataBlocking();
+  // Same as LoadMetadataBlocking(), but only for the first song, so it can start playing while the rest is loading.
+  void LoadFirstSongMetadataBlocking();
   Result LoadAudioCD();
 
   QStringList errors() { return errors_; }
@@ -168,7 +169,6 @@ class SongLoader : public QObject {
   GstElement *fakesink_;
   gulong buffer_probe_cb_id_;
 
-  QThreadPool thread_pool_;
   QStringList errors_;
 
   bool success_;
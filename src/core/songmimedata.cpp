@@ -19,8 +19,57 @@
  *
  */
 
+#include "config.h"
+
+#include <QFuture>
+#include <QList>
+#include <QVariant>
+#include <QString>
+#include <QStringList>
+#include <QUrl>
+#include <QMetaType>
+
+#include "core/taskexecutor.h"
 #include "songmimedata.h"
 
+namespace {
+constexpr char kUriListMimeType[] = "text/uri-list";
+}  // namespace
+
 SongMimeData::SongMimeData(QObject *parent) : backend(nullptr) {
   Q_UNUSED(parent);
 }
+
+QFuture<SongList> SongMimeData::ResolveSongs() const {
+
+  return TaskExecutor::Run(TaskExecutor::Lane::Interactive, resolver);
+
+}
+
+QStringList SongMimeData::formats() const {
+
+  QStringList formats = MimeData::formats();
+  if (lazy() && !formats.contains(QLatin1String(kUriListMimeType))) {
+    formats << QLatin1String(kUriListMimeType);
+  }
+
+  return formats;
+
+}
+
+QVariant SongMimeData::retrieveData(const QString &mimetype, QMetaType type) const {
+
+  if (lazy() && mimetype == QLatin1String(kUriListMimeType) && !MimeData::formats().contains(mimetype)) {
+    if (resolved_urls_.isEmpty()) {
+      const SongList resolved_songs = resolver();
+      resolved_urls_.reserve(resolved_songs.count());
+      for (const Song &song : resolved_songs) {
+        resolved_urls_ << song.url();
+      }
+    }
+    return resolved_urls_;
+  }
+
+  return MimeData::retrieveData(mimetype, type);
+
+}
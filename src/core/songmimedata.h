@@ -24,6 +24,15 @@
 
 #include "config.h"
 
+#include <functional>
+
+#include <QFuture>
+#include <QList>
+#include <QString>
+#include <QStringList>
+#include <QVariant>
+#include <QMetaType>
+
 #include "includes/shared_ptr.h"
 #include "mimedata.h"
 #include "core/song.h"
@@ -36,8 +45,25 @@ class SongMimeData : public MimeData {
  public:
   explicit SongMimeData(QObject *parent = nullptr);
 
+  // Large selections set a resolver instead of the songs, which is only run when the songs are dropped.
+  // It runs on a worker thread, so it can't refer to anything that is changed elsewhere.
+  using SongsResolver = std::function<SongList()>;
+
+  bool lazy() const { return static_cast<bool>(resolver); }
+  QFuture<SongList> ResolveSongs() const;
+
+  QStringList formats() const override;
+
   SharedPtr<CollectionBackendInterface> backend;
   SongList songs;
+  SongsResolver resolver;
+
+ protected:
+  // The URLs of lazy songs are only resolved when a drop target outside the playlist asks for them.
+  QVariant retrieveData(const QString &mimetype, QMetaType type) const override;
+
+ private:
+  mutable QList<QVariant> resolved_urls_;
 };
 
 #endif  // SONGMIMEDATA_H
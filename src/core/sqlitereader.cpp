@@ -0,0 +1,232 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "config.h"
+
+#include <sqlite3.h>
+
+#include <QtGlobal>
+#include <QByteArray>
+#include <QString>
+#include <QUrl>
+#include <QVariant>
+#include <QVariantList>
+#include <QMetaType>
+
+#include "core/logging.h"
+#include "sqlitereader.h"
+
+using namespace Qt::Literals::StringLiterals;
+
+namespace {
+constexpr int kBusyTimeout = 30000;
+}
+
+SqliteReader::SqliteReader(const QString &filename)
+    : filename_(filename),
+      db_(nullptr),
+      stmt_(nullptr) {}
+
+SqliteReader::~SqliteReader() {
+
+  if (stmt_) {
+    sqlite3_finalize(stmt_);
+  }
+  if (db_) {
+    sqlite3_close(db_);
+  }
+
+}
+
+void SqliteReader::SetError(const QString &error) {
+
+  error_ = error;
+  qLog(Error) << "Failed to read" << filename_ << error_;
+
+}
+
+bool SqliteReader::Prepare(const QString &sql, const QVariantList &bound_values) {
+
+  // In memory databases can't be opened from another connection.
+  if (filename_.isEmpty() || filename_ == ":memory:"_L1 || filename_.startsWith("file::memory:"_L1)) {
+    return false;
+  }
+
+  if (!db_) {
+    const QByteArray filename_data = filename_.toUtf8();
+    if (sqlite3_open_v2(filename_data.constData(), &db_, SQLITE_OPEN_READONLY, nullptr) != SQLITE_OK) {
+      SetError(db_ ? QString::fromUtf8(sqlite3_errmsg(db_)) : QString());
+      sqlite3_close(db_);
+      db_ = nullptr;
+      return false;
+    }
+    sqlite3_busy_timeout(db_, kBusyTimeout);
+  }
+
+  if (stmt_) {
+    sqlite3_finalize(stmt_);
+    stmt_ = nullptr;
+  }
+
+  const QByteArray sql_data = sql.toUtf8();
+  if (sqlite3_prepare_v2(db_, sql_data.constData(), static_cast<int>(sql_data.size()), &stmt_, nullptr) != SQLITE_OK) {
+    SetError(QString::fromUtf8(sqlite3_errmsg(db_)));
+    return false;
+  }
+
+  for (int i = 0; i < bound_values.count(); ++i) {
+    const QVariant &value = bound_values[i];
+    int ret = SQLITE_OK;
+    if (value.isNull()) {
+      ret = sqlite3_bind_null(stmt_, i + 1);
+    }
+    else {
+      switch (value.typeId()) {
+        case QMetaType::Bool:
+        case QMetaType::Int:
+        case QMetaType::UInt:
+        case QMetaType::LongLong:
+        case QMetaType::ULongLong:
+          ret = sqlite3_bind_int64(stmt_, i + 1, value.toLongLong());
+          break;
+        case QMetaType::Float:
+        case QMetaType::Double:
+          ret = sqlite3_bind_double(stmt_, i + 1, value.toDouble());
+          break;
+        default:{
+          const QByteArray data = value.toString().toUtf8();
+          ret = sqlite3_bind_text(stmt_, i + 1, data.constData(), static_cast<int>(data.size()), SQLITE_TRANSIENT);
+          break;
+        }
+      }
+    }
+    if (ret != SQLITE_OK) {
+      SetError(QString::fromUtf8(sqlite3_errmsg(db_)));
+      return false;
+    }
+  }
+
+  error_.clear();
+
+  return true;
+
+}
+
+bool SqliteReader::Next() {
+
+  if (!stmt_) return false;
+
+  const int ret = sqlite3_step(stmt_);
+  if (ret == SQLITE_ROW) return true;
+  if (ret != SQLITE_DONE) {
+    SetError(QString::fromUtf8(sqlite3_errmsg(db_)));
+  }
+
+  return false;
+
+}
+
+int SqliteReader::columns() const {
+
+  return stmt_ ? sqlite3_column_count(stmt_) : 0;
+
+}
+
+bool SqliteReader::IsNull(const int column) const {
+
+  return sqlite3_column_type(stmt_, column) == SQLITE_NULL;
+
+}
+
+int SqliteReader::Int(const int column) const {
+
+  return sqlite3_column_int(stmt_, column);
+
+}
+
+qint64 SqliteReader::LongLong(const int column) const {
+
+  return sqlite3_column_int64(stmt_, column);
+
+}
+
+double SqliteReader::Double(const int column) const {
+
+  return sqlite3_column_double(stmt_, column);
+
+}
+
+QString SqliteReader::String(const int column) const {
+
+  const char *data = reinterpret_cast<const char*>(sqlite3_column_text(stmt_, column));
+  if (!data) return QString();
+
+  return QString::fromUtf8(data, sqlite3_column_bytes(stmt_, column));
+
+}
+
+QUrl SqliteReader::Url(const int column) const {
+
+  return QUrl::fromEncoded(RawData(column));
+
+}
+
+QByteArray SqliteReader::RawData(const int column) const {
+
+  // The data is only valid until the next row, so it can only be used for looking up values.
+  const char *data = reinterpret_cast<const char*>(sqlite3_column_text(stmt_, column));
+  if (!data) return QByteArray();
+
+  return QByteArray::fromRawData(data, sqlite3_column_bytes(stmt_, column));
+
+}
+
+QString SqliteReader::SharedString(const int column) {
+
+  const QByteArray data = RawData(column);
+  if (data.isEmpty()) return QString();
+
+  QHash<QByteArray, QString>::const_iterator it = strings_.constFind(data);
+  if (it != strings_.constEnd()) {
+    return *it;
+  }
+
+  const QString str = QString::fromUtf8(data);
+  strings_.insert(QByteArray(data.constData(), data.size()), str);
+
+  return str;
+
+}
+
+QUrl SqliteReader::SharedUrl(const int column) {
+
+  const QByteArray data = RawData(column);
+  if (data.isEmpty()) return QUrl();
+
+  QHash<QByteArray, QUrl>::const_iterator it = urls_.constFind(data);
+  if (it != urls_.constEnd()) {
+    return *it;
+  }
+
+  const QUrl url = QUrl::fromEncoded(data);
+  urls_.insert(QByteArray(data.constData(), data.size()), url);
+
+  return url;
+
+}
@@ -0,0 +1,77 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef SQLITEREADER_H
+#define SQLITEREADER_H
+
+#include "config.h"
+
+#include <sqlite3.h>
+
+#include <QtGlobal>
+#include <QByteArray>
+#include <QHash>
+#include <QString>
+#include <QUrl>
+#include <QVariant>
+#include <QVariantList>
+
+// Reads rows from a database file with the SQLite API, through a read only connection of its own.
+// Values are read from the columns directly instead of through a QVariant each, for loading many rows at once.
+class SqliteReader {
+ public:
+  explicit SqliteReader(const QString &filename);
+  ~SqliteReader();
+
+  // Returns false if the query could not be prepared, or the database is not a file that can be opened separately.
+  bool Prepare(const QString &sql, const QVariantList &bound_values = QVariantList());
+
+  // Returns true while there are rows, check error() after the last row.
+  bool Next();
+
+  QString error() const { return error_; }
+
+  int columns() const;
+  bool IsNull(const int column) const;
+  int Int(const int column) const;
+  qint64 LongLong(const int column) const;
+  double Double(const int column) const;
+  QString String(const int column) const;
+  QUrl Url(const int column) const;
+
+  // Repeated values share the same string or URL, which is only decoded the first time.
+  QString SharedString(const int column);
+  QUrl SharedUrl(const int column);
+
+ private:
+  QByteArray RawData(const int column) const;
+  void SetError(const QString &error);
+
+ private:
+  const QString filename_;
+  sqlite3 *db_;
+  sqlite3_stmt *stmt_;
+  QString error_;
+  QHash<QByteArray, QString> strings_;
+  QHash<QByteArray, QUrl> urls_;
+
+  Q_DISABLE_COPY(SqliteReader)
+};
+
+#endif  // SQLITEREADER_H
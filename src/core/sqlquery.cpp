@@ -19,20 +19,32 @@
 
 #include "config.h"
 
+#include <atomic>
+
 #include <QMap>
 #include <QVariant>
 #include <QString>
 #include <QUrl>
+#include <QElapsedTimer>
 
 #include "sqlquery.h"
+#include "tracing.h"
 
 using namespace Qt::Literals::StringLiterals;
 
+namespace {
+std::atomic<quint64> g_queries(0);
+std::atomic<qint64> g_total_nsec(0);
+std::atomic<qint64> g_max_nsec(0);
+}  // namespace
+
 void SqlQuery::BindValue(const QString &placeholder, const QVariant &value) {
 
-  bound_values_.insert(placeholder, value);
+  const QString name = placeholder + placeholder_suffix_;
+
+  bound_values_.insert(name, value);
 
-  bindValue(placeholder, value);
+  bindValue(name, value);
 
 }
 
@@ -92,7 +104,19 @@ void SqlQuery::BindNotNullIntValue(const QString &placeholder, const int value)
 
 bool SqlQuery::Exec() {
 
+  qTraceScope("SqlQuery::Exec");
+
+  QElapsedTimer timer;
+  timer.start();
+
   bool success = exec();
+
+  const qint64 elapsed_nsec = timer.nsecsElapsed();
+  g_queries.fetch_add(1, std::memory_order_relaxed);
+  g_total_nsec.fetch_add(elapsed_nsec, std::memory_order_relaxed);
+  qint64 max_nsec = g_max_nsec.load(std::memory_order_relaxed);
+  while (elapsed_nsec > max_nsec && !g_max_nsec.compare_exchange_weak(max_nsec, elapsed_nsec, std::memory_order_relaxed)) {}
+
   last_query_ = executedQuery();
 
   for (QMap<QString, QVariant>::const_iterator it = bound_values_.constBegin(); it != bound_values_.constEnd(); ++it) {
@@ -109,3 +133,9 @@ QString SqlQuery::LastQuery() const {
   return last_query_;
 
 }
+
+SqlQuery::Statistics SqlQuery::statistics() {
+
+  return Statistics { g_queries.load(std::memory_order_relaxed), g_total_nsec.load(std::memory_order_relaxed), g_max_nsec.load(std::memory_order_relaxed) };
+
+}
@@ -38,6 +38,9 @@ class SqlQuery : public QSqlQuery {
 
   int columns() const { return QSqlQuery::record().count(); }
 
+  // Appended to every placeholder name, used when binding several rows into one multi-row statement.
+  void SetPlaceholderSuffix(const QString &suffix) { placeholder_suffix_ = suffix; }
+
   void BindValue(const QString &placeholder, const QVariant &value);
   void BindStringValue(const QString &placeholder, const QString &value);
   void BindUrlValue(const QString &placeholder, const QUrl &value);
@@ -52,9 +55,18 @@ class SqlQuery : public QSqlQuery {
   bool Exec();
   QString LastQuery() const;
 
+  // Execution times of all queries run through Exec(), in every thread.
+  struct Statistics {
+    quint64 queries;
+    qint64 total_nsec;
+    qint64 max_nsec;
+  };
+  static Statistics statistics();
+
  private:
   QMap<QString, QVariant> bound_values_;
   QString last_query_;
+  QString placeholder_suffix_;
 };
 
 #endif  // SQLQUERY_H
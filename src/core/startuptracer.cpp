@@ -0,0 +1,103 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include <algorithm>
+
+#include <QList>
+#include <QString>
+#include <QThread>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QElapsedTimer>
+
+#include "core/logging.h"
+#include "startuptracer.h"
+
+using namespace Qt::Literals::StringLiterals;
+
+namespace {
+
+struct StartupEvent {
+  QString name;
+  QString thread;
+  qint64 start_msec;
+  qint64 duration_msec;
+};
+
+struct StartupTimeline {
+  StartupTimeline() : finished(false) { timer.start(); }
+  QMutex mutex;
+  QElapsedTimer timer;
+  QList<StartupEvent> events;
+  bool finished;
+};
+
+StartupTimeline &Timeline() {
+
+  static StartupTimeline timeline;
+  return timeline;
+
+}
+
+}  // namespace
+
+namespace StartupTracer {
+
+qint64 ElapsedMsec() {
+
+  return Timeline().timer.elapsed();
+
+}
+
+void AddEvent(const QString &name, const qint64 start_msec, const qint64 duration_msec) {
+
+  StartupTimeline &timeline = Timeline();
+  QMutexLocker l(&timeline.mutex);
+  if (timeline.finished) return;
+
+  const QThread *thread = QThread::currentThread();
+  timeline.events << StartupEvent { name, thread ? thread->objectName() : QString(), start_msec, duration_msec };
+
+}
+
+bool IsFinished() {
+
+  StartupTimeline &timeline = Timeline();
+  QMutexLocker l(&timeline.mutex);
+  return timeline.finished;
+
+}
+
+void Finish() {
+
+  StartupTimeline &timeline = Timeline();
+  QMutexLocker l(&timeline.mutex);
+  if (timeline.finished) return;
+  timeline.finished = true;
+
+  std::stable_sort(timeline.events.begin(), timeline.events.end(), [](const StartupEvent &a, const StartupEvent &b) { return a.start_msec < b.start_msec; });
+
+  qLog(Debug) << "Startup finished after" << timeline.timer.elapsed() << "ms";
+  for (const StartupEvent &event : std::as_const(timeline.events)) {
+    qLog(Debug) << "Startup:" << event.start_msec << "ms" << event.name << "took" << event.duration_msec << "ms" << (event.thread.isEmpty() ? QString() : u"in thread "_s + event.thread);
+  }
+  timeline.events.clear();
+
+}
+
+}  // namespace StartupTracer
@@ -0,0 +1,40 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#ifndef STARTUPTRACER_H
+#define STARTUPTRACER_H
+
+#include <QtGlobal>
+#include <QString>
+
+// Records a timeline of what happens on the way to the first frame, lazy initializations, thread starts and deferred tasks.
+// Events are kept in memory until Finish() writes the timeline to the debug log, anything recorded after that is ignored.
+// Safe to use from any thread.
+namespace StartupTracer {
+
+// Milliseconds since the tracer was first used, which is early in main().
+qint64 ElapsedMsec();
+
+void AddEvent(const QString &name, const qint64 start_msec, const qint64 duration_msec);
+
+bool IsFinished();
+void Finish();
+
+}  // namespace StartupTracer
+
+#endif  // STARTUPTRACER_H
@@ -0,0 +1,238 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "config.h"
+
+#include <algorithm>
+#include <utility>
+
+#include <QtGlobal>
+#include <QObject>
+#include <QByteArray>
+#include <QString>
+#include <QUrl>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QFileInfoList>
+#include <QDateTime>
+#include <QCryptographicHash>
+#include <QNetworkRequest>
+#include <QNetworkReply>
+
+#include "core/logging.h"
+#include "core/settings.h"
+#include "core/standardpaths.h"
+#include "core/networkaccessmanager.h"
+#include "constants/backendsettings.h"
+#include "streamaudiocache.h"
+
+using namespace Qt::Literals::StringLiterals;
+
+namespace {
+constexpr char kCacheDirectory[] = "streamaudio";
+constexpr char kPartialSuffix[] = ".part";
+constexpr qint64 kBytesPerMegabyte = 1024LL * 1024LL;
+}  // namespace
+
+StreamAudioCache::StreamAudioCache(QObject *parent)
+    : QObject(parent),
+      cache_directory_(StandardPaths::WritableLocation(StandardPaths::StandardLocation::CacheLocation) + u'/' + QLatin1String(kCacheDirectory)),
+      network_(new NetworkAccessManager(this)),
+      enabled_(false),
+      max_size_(BackendSettings::kDefaultStreamCacheSize * kBytesPerMegabyte),
+      download_reply_(nullptr),
+      download_file_(nullptr) {}
+
+StreamAudioCache::~StreamAudioCache() {
+
+  AbortDownload();
+
+}
+
+void StreamAudioCache::ReloadSettings() {
+
+  Settings s;
+  s.beginGroup(BackendSettings::kSettingsGroup);
+  enabled_ = s.value(BackendSettings::kStreamCache, false).toBool();
+  max_size_ = s.value(BackendSettings::kStreamCacheSize, BackendSettings::kDefaultStreamCacheSize).toLongLong() * kBytesPerMegabyte;
+  s.endGroup();
+
+  if (enabled_) {
+    Evict();
+  }
+  else {
+    AbortDownload();
+  }
+
+}
+
+QString StreamAudioCache::Filename(const QUrl &media_url) const {
+
+  return cache_directory_ + u'/' + QString::fromLatin1(QCryptographicHash::hash(media_url.toEncoded(), QCryptographicHash::Sha1).toHex());
+
+}
+
+QUrl StreamAudioCache::CachedUrl(const QUrl &media_url) {
+
+  if (!enabled_ || !media_url.isValid()) return QUrl();
+
+  const QString filename = Filename(media_url);
+  QFile file(filename);
+  if (!file.exists()) return QUrl();
+
+  // The modification time is used as the last played time when evicting.
+  if (file.open(QIODevice::ReadWrite)) {
+    file.setFileTime(QDateTime::currentDateTime(), QFileDevice::FileModificationTime);
+    file.close();
+  }
+
+  return QUrl::fromLocalFile(filename);
+
+}
+
+void StreamAudioCache::Add(const QUrl &media_url, const QUrl &stream_url) {
+
+  if (!enabled_ || max_size_ <= 0 || !media_url.isValid()) return;
+  if (stream_url.scheme() != "http"_L1 && stream_url.scheme() != "https"_L1) return;
+  if (download_reply_ && download_media_url_ == media_url) return;
+  if (QFile::exists(Filename(media_url))) return;
+
+  AbortDownload();
+
+  if (!QDir().mkpath(cache_directory_)) {
+    qLog(Error) << "Could not create stream audio cache directory" << cache_directory_;
+    return;
+  }
+
+  download_file_ = new QFile(Filename(media_url) + QLatin1String(kPartialSuffix));
+  if (!download_file_->open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+    qLog(Error) << "Could not open" << download_file_->fileName() << "for writing:" << download_file_->errorString();
+    delete download_file_;
+    download_file_ = nullptr;
+    return;
+  }
+
+  QNetworkRequest network_request(stream_url);
+  network_request.setAttribute(QNetworkRequest::CacheLoadControlAttribute, QNetworkRequest::AlwaysNetwork);
+  network_request.setAttribute(QNetworkRequest::CacheSaveControlAttribute, false);
+  network_request.setPriority(QNetworkRequest::LowPriority);
+
+  download_media_url_ = media_url;
+  download_reply_ = network_->get(network_request);
+  QObject::connect(download_reply_, &QNetworkReply::readyRead, this, &StreamAudioCache::DownloadReadyRead);
+  QObject::connect(download_reply_, &QNetworkReply::finished, this, &StreamAudioCache::DownloadFinished);
+
+  qLog(Debug) << "Caching audio for" << media_url;
+
+}
+
+void StreamAudioCache::Remove(const QUrl &media_url) {
+
+  if (download_reply_ && download_media_url_ == media_url) {
+    AbortDownload();
+  }
+
+  QFile::remove(Filename(media_url));
+
+}
+
+void StreamAudioCache::DownloadReadyRead() {
+
+  if (!download_reply_ || !download_file_) return;
+
+  if (download_file_->write(download_reply_->readAll()) == -1 || download_file_->size() > max_size_) {
+    qLog(Error) << "Could not cache audio for" << download_media_url_;
+    AbortDownload();
+  }
+
+}
+
+void StreamAudioCache::DownloadFinished() {
+
+  if (!download_reply_ || !download_file_) return;
+
+  QNetworkReply *reply = download_reply_;
+  download_reply_ = nullptr;
+  QObject::disconnect(reply, nullptr, this, nullptr);
+  reply->deleteLater();
+
+  const int http_status_code = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+  const bool success = reply->error() == QNetworkReply::NoError && http_status_code == 200 && download_file_->write(reply->readAll()) != -1 && download_file_->size() > 0;
+
+  download_file_->close();
+  if (success && download_file_->rename(Filename(download_media_url_))) {
+    qLog(Debug) << "Cached audio for" << download_media_url_;
+  }
+  else {
+    qLog(Debug) << "Could not cache audio for" << download_media_url_ << reply->errorString();
+    download_file_->remove();
+  }
+  delete download_file_;
+  download_file_ = nullptr;
+  download_media_url_.clear();
+
+  Evict();
+
+}
+
+void StreamAudioCache::AbortDownload() {
+
+  if (download_reply_) {
+    QNetworkReply *reply = download_reply_;
+    download_reply_ = nullptr;
+    QObject::disconnect(reply, nullptr, this, nullptr);
+    reply->abort();
+    reply->deleteLater();
+  }
+
+  if (download_file_) {
+    download_file_->close();
+    download_file_->remove();
+    delete download_file_;
+    download_file_ = nullptr;
+  }
+
+  download_media_url_.clear();
+
+}
+
+void StreamAudioCache::Evict() {
+
+  QDir dir(cache_directory_);
+  if (!dir.exists()) return;
+
+  QFileInfoList fileinfos = dir.entryInfoList(QDir::Files | QDir::NoDotAndDotDot);
+  qint64 total_size = 0;
+  for (const QFileInfo &fileinfo : std::as_const(fileinfos)) {
+    total_size += fileinfo.size();
+  }
+  if (total_size <= max_size_) return;
+
+  std::sort(fileinfos.begin(), fileinfos.end(), [](const QFileInfo &a, const QFileInfo &b) { return a.lastModified() < b.lastModified(); });
+
+  for (const QFileInfo &fileinfo : std::as_const(fileinfos)) {
+    if (total_size <= max_size_) break;
+    if (download_file_ && fileinfo.absoluteFilePath() == QFileInfo(*download_file_).absoluteFilePath()) continue;
+    if (QFile::remove(fileinfo.absoluteFilePath())) {
+      total_size -= fileinfo.size();
+    }
+  }
+
+}
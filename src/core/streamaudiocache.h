@@ -0,0 +1,72 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef STREAMAUDIOCACHE_H
+#define STREAMAUDIOCACHE_H
+
+#include "config.h"
+
+#include <QtGlobal>
+#include <QObject>
+#include <QString>
+#include <QUrl>
+
+class QFile;
+class QNetworkReply;
+class NetworkAccessManager;
+
+// Keeps the audio of played streaming songs on disk, so playing or seeking in them again does not download them again.
+// A song is downloaded in the background the first time it is played, and the least recently played songs are removed when the cache is full.
+class StreamAudioCache : public QObject {
+  Q_OBJECT
+
+ public:
+  explicit StreamAudioCache(QObject *parent = nullptr);
+  ~StreamAudioCache() override;
+
+  void ReloadSettings();
+
+  // Returns the URL of the cached file for the media URL, or an empty URL if it is not cached.
+  QUrl CachedUrl(const QUrl &media_url);
+
+  // Starts downloading the stream URL for the media URL, if the cache is enabled and it is not already cached.
+  void Add(const QUrl &media_url, const QUrl &stream_url);
+
+  void Remove(const QUrl &media_url);
+
+ private:
+  QString Filename(const QUrl &media_url) const;
+  void AbortDownload();
+  void Evict();
+
+ private Q_SLOTS:
+  void DownloadReadyRead();
+  void DownloadFinished();
+
+ private:
+  const QString cache_directory_;
+  NetworkAccessManager *network_;
+  bool enabled_;
+  qint64 max_size_;
+  QUrl download_media_url_;
+  QNetworkReply *download_reply_;
+  QFile *download_file_;
+};
+
+#endif  // STREAMAUDIOCACHE_H
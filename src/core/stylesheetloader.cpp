@@ -22,9 +22,12 @@
 #include "config.h"
 
 #include <memory>
+#include <utility>
 
 #include <QtGlobal>
 #include <QObject>
+#include <QPair>
+#include <QSet>
 #include <QWidget>
 #include <QTimer>
 #include <QIODevice>
@@ -43,18 +46,60 @@ using namespace Qt::Literals::StringLiterals;
 
 using std::make_shared;
 
-StyleSheetLoader::StyleSheetLoader(QObject *parent) : QObject(parent) {}
+namespace {
+// The stylesheets of the palettes no longer used are dropped when there are more than this.
+constexpr qsizetype kMaxCachedStyleSheets = 64;
+}  // namespace
+
+StyleSheetLoader::StyleSheetLoader(QObject *parent)
+    : QObject(parent),
+      timer_update_pending_(new QTimer(this)) {
+
+  timer_update_pending_->setSingleShot(true);
+  timer_update_pending_->setInterval(0);
+  QObject::connect(timer_update_pending_, &QTimer::timeout, this, &StyleSheetLoader::UpdatePendingStyleSheets);
+
+}
 
 void StyleSheetLoader::SetStyleSheet(QWidget *widget, const QString &filename) {
 
+  const QString stylesheet_template = StyleSheetTemplate(filename);
+  if (stylesheet_template.isNull()) return;
+
+  const bool connect_destroyed = !styledata_.contains(widget);
+
+  SharedPtr<StyleSheetData> styledata = make_shared<StyleSheetData>();
+  styledata->filename_ = filename;
+  styledata->stylesheet_template_ = stylesheet_template;
+  styledata->stylesheet_current_ = widget->styleSheet();
+  styledata_.insert(widget, styledata);
+
+  if (connect_destroyed) {
+    QObject::connect(widget, &QObject::destroyed, this, [this, widget]() {
+      styledata_.remove(widget);
+      pending_widgets_.remove(widget);
+    });
+  }
+
+  widget->installEventFilter(this);
+  UpdateStyleSheet(widget, styledata);
+
+}
+
+QString StyleSheetLoader::StyleSheetTemplate(const QString &filename) {
+
+  if (stylesheet_templates_.contains(filename)) {
+    return stylesheet_templates_.value(filename);
+  }
+
   // Load the file
   QFile file(filename);
   if (!file.open(QIODevice::ReadOnly)) {
     qLog(Error) << "Could not open stylesheet file" << filename << "for reading:" << file.errorString();
-    return;
+    return QString();
   }
   QTextStream stream(&file);
-  QString stylesheet;
+  QString stylesheet = u""_s;
   Q_FOREVER {
     QString line = stream.readLine();
     stylesheet.append(line);
@@ -62,23 +107,73 @@ void StyleSheetLoader::SetStyleSheet(QWidget *widget, const QString &filename) {
   }
   file.close();
 
-  SharedPtr<StyleSheetData> styledata = make_shared<StyleSheetData>();
-  styledata->filename_ = filename;
-  styledata->stylesheet_template_ = stylesheet;
-  styledata->stylesheet_current_ = widget->styleSheet();
-  styledata_.insert(widget, styledata);
+  stylesheet_templates_.insert(filename, stylesheet);
 
-  widget->installEventFilter(this);
-  UpdateStyleSheet(widget, styledata);
+  return stylesheet;
+
+}
+
+QString StyleSheetLoader::PaletteKey(const QPalette &palette) {
+
+  QString key;
+  for (int role = 0; role < QPalette::NColorRoles; ++role) {
+    key.append(QString::number(palette.color(static_cast<QPalette::ColorRole>(role)).rgba(), 16));
+    key.append(u',');
+  }
+
+  return key;
+
+}
+
+void StyleSheetLoader::UpdatePendingStyleSheets() {
+
+  if (pending_widgets_.isEmpty()) return;
+
+  // Don't repaint the windows for every widget that gets a new stylesheet.
+  QSet<QWidget*> windows;
+  for (QWidget *widget : std::as_const(pending_widgets_)) {
+    QWidget *window = widget->window();
+    if (window && window->updatesEnabled() && !windows.contains(window)) {
+      window->setUpdatesEnabled(false);
+      windows << window;
+    }
+  }
+
+  const QSet<QWidget*> widgets = std::exchange(pending_widgets_, QSet<QWidget*>());
+  for (QWidget *widget : widgets) {
+    if (styledata_.contains(widget)) {
+      UpdateStyleSheet(widget, styledata_.value(widget));
+    }
+  }
+
+  for (QWidget *window : std::as_const(windows)) {
+    window->setUpdatesEnabled(true);
+  }
 
 }
 
 void StyleSheetLoader::UpdateStyleSheet(QWidget *widget, SharedPtr<StyleSheetData> styledata) {
 
-  QString stylesheet = styledata->stylesheet_template_;
+  const QString stylesheet = StyleSheet(styledata->filename_, styledata->stylesheet_template_, widget->palette());
+
+  // Setting the same stylesheet again still polishes the widget and all its children.
+  if (stylesheet != styledata->stylesheet_current_) {
+    styledata->stylesheet_current_ = stylesheet;
+    widget->setStyleSheet(stylesheet);
+  }
+
+}
+
+QString StyleSheetLoader::StyleSheet(const QString &filename, const QString &stylesheet_template, const QPalette &p) {
+
+  const QPair<QString, QString> key(filename, PaletteKey(p));
+  if (stylesheets_.contains(key)) {
+    return stylesheets_.value(key);
+  }
+
+  QString stylesheet = stylesheet_template;
 
   // Replace %palette-role with actual colours
-  QPalette p(widget->palette());
 
   QColor color_altbase = p.color(QPalette::AlternateBase);
 #ifdef Q_OS_MACOS
@@ -113,10 +208,12 @@ void StyleSheetLoader::UpdateStyleSheet(QWidget *widget, SharedPtr<StyleSheetDat
   stylesheet.replace(QLatin1String("macos"), QLatin1String("*"));
 #endif
 
-  if (stylesheet != styledata->stylesheet_current_) {
-    styledata->stylesheet_current_ = stylesheet;
-    widget->setStyleSheet(stylesheet);
+  if (stylesheets_.count() >= kMaxCachedStyleSheets) {
+    stylesheets_.clear();
   }
+  stylesheets_.insert(key, stylesheet);
+
+  return stylesheet;
 
 }
 
@@ -133,7 +230,8 @@ bool StyleSheetLoader::eventFilter(QObject *obj, QEvent *event) {
   if (event->type() == QEvent::PaletteChange) {
     QWidget *widget = qobject_cast<QWidget*>(obj);
     if (widget && styledata_.contains(widget)) {
-      UpdateStyleSheet(widget, styledata_[widget]);
+      pending_widgets_ << widget;
+      timer_update_pending_->start();
     }
   }
 
@@ -27,6 +27,7 @@
 #include <QObject>
 #include <QPair>
 #include <QHash>
+#include <QSet>
 #include <QPalette>
 #include <QString>
 
@@ -34,6 +35,7 @@
 
 class QWidget;
 class QEvent;
+class QTimer;
 
 class StyleSheetLoader : public QObject {
   Q_OBJECT
@@ -46,6 +48,9 @@ class StyleSheetLoader : public QObject {
   // The stylesheet is reloaded when the widget's palette changes.
   void SetStyleSheet(QWidget *widget, const QString &filename);
 
+ private Q_SLOTS:
+  void UpdatePendingStyleSheets();
+
  protected:
   bool eventFilter(QObject *obj, QEvent *event) override;
 
@@ -58,11 +63,20 @@ class StyleSheetLoader : public QObject {
   };
 
  private:
+  QString StyleSheetTemplate(const QString &filename);
+  QString StyleSheet(const QString &filename, const QString &stylesheet_template, const QPalette &p);
   void UpdateStyleSheet(QWidget *widget, SharedPtr<StyleSheetData> styledata);
+  static QString PaletteKey(const QPalette &palette);
   static void ReplaceColor(QString *css, const QString &name, const QPalette &palette, const QPalette::ColorRole role);
 
  private:
   QHash<QWidget*, SharedPtr<StyleSheetData>> styledata_;
+  // The stylesheet files, and the stylesheets with the colours of each palette substituted, so widgets sharing a file and a palette only compute it once.
+  QHash<QString, QString> stylesheet_templates_;
+  QHash<QPair<QString, QString>, QString> stylesheets_;
+  // A palette change reaches each widget separately, the widgets are updated together once the changes are delivered.
+  QSet<QWidget*> pending_widgets_;
+  QTimer *timer_update_pending_;
 };
 
 #endif  // STYLESHEETLOADER_H
@@ -0,0 +1,93 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "config.h"
+
+#include <QtGlobal>
+#include <QThread>
+#include <QThreadPool>
+#include <QString>
+
+#include "taskexecutor.h"
+
+using namespace Qt::Literals::StringLiterals;
+
+namespace TaskExecutor {
+
+namespace {
+
+QThreadPool *BackgroundIOPool() {
+
+  static QThreadPool pool;
+  static const auto init = []() {
+    // These threads are mostly waiting, so they get a share of the cores on top of the other lanes.
+    pool.setMaxThreadCount(qMax(2, QThread::idealThreadCount() / 2));
+    pool.setObjectName(u"TaskExecutorBackgroundIO"_s);
+    return true;
+  }();
+
+  Q_UNUSED(init);
+
+  return &pool;
+
+}
+
+QThreadPool *CPUAnalysisPool() {
+
+  static QThreadPool pool;
+  static const auto init = []() {
+    // Leave a core for the GUI and playback.
+    pool.setMaxThreadCount(qMax(1, QThread::idealThreadCount() - 1));
+    pool.setThreadPriority(QThread::LowPriority);
+    pool.setObjectName(u"TaskExecutorCPUAnalysis"_s);
+    return true;
+  }();
+
+  Q_UNUSED(init);
+
+  return &pool;
+
+}
+
+}  // namespace
+
+QThreadPool *Pool(const Lane lane) {
+
+  switch (lane) {
+    case Lane::Interactive:
+      // The global pool is already used by QtConcurrent::run() without a pool, and is limited to the number of cores.
+      return QThreadPool::globalInstance();
+    case Lane::BackgroundIO:
+      return BackgroundIOPool();
+    case Lane::CPUAnalysis:
+      return CPUAnalysisPool();
+  }
+
+  return QThreadPool::globalInstance();
+
+}
+
+void WaitForDone() {
+
+  BackgroundIOPool()->waitForDone();
+  CPUAnalysisPool()->waitForDone();
+
+}
+
+}  // namespace TaskExecutor
@@ -0,0 +1,52 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef TASKEXECUTOR_H
+#define TASKEXECUTOR_H
+
+#include "config.h"
+
+#include <utility>
+
+#include <QThreadPool>
+#include <QtConcurrentRun>
+
+// Shared thread pools for work that doesn't need a thread of its own.
+// Tasks are submitted to a lane, each lane is bounded by the number of cores, and idle threads in a lane take the next queued task.
+namespace TaskExecutor {
+
+enum class Lane {
+  Interactive,   // Short tasks the user is waiting for.
+  BackgroundIO,  // Reading and writing files, mostly waiting on the disk or network.
+  CPUAnalysis    // Long running analysis, runs with a low thread priority.
+};
+
+QThreadPool *Pool(const Lane lane);
+
+template<typename Function, typename... Args>
+auto Run(const Lane lane, Function &&function, Args&&... args) {
+  return QtConcurrent::run(Pool(lane), std::forward<Function>(function), std::forward<Args>(args)...);
+}
+
+// Waits for the tasks in the background lanes on shutdown, the interactive lane is the global pool which Qt waits for.
+void WaitForDone();
+
+}  // namespace TaskExecutor
+
+#endif  // TASKEXECUTOR_H
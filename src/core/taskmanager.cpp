@@ -27,15 +27,28 @@
 #include <QMutex>
 #include <QList>
 #include <QString>
+#include <QTimer>
 
 #include "taskmanager.h"
 
 using namespace Qt::Literals::StringLiterals;
 
-TaskManager::TaskManager(QObject *parent) : QObject(parent), next_task_id_(1) {
+namespace {
+constexpr int kMaxProgressUpdatesPerSecond = 10;
+}
+
+TaskManager::TaskManager(QObject *parent)
+    : QObject(parent),
+      next_task_id_(1),
+      timer_progress_update_(new QTimer(this)),
+      progress_update_pending_(false) {
 
   setObjectName(QLatin1String(QObject::metaObject()->className()));
 
+  timer_progress_update_->setSingleShot(true);
+  timer_progress_update_->setInterval(1000 / kMaxProgressUpdatesPerSecond);
+  QObject::connect(timer_progress_update_, &QTimer::timeout, this, &TaskManager::ProgressUpdateTimeout);
+
 }
 
 int TaskManager::StartTask(const QString &name) {
@@ -96,7 +109,8 @@ void TaskManager::SetTaskProgress(const int id, const quint64 progress, const qu
     tasks_[id] = t;
   }
 
-  Q_EMIT TasksChanged();
+  ProgressChanged();
+
 }
 
 void TaskManager::IncreaseTaskProgress(const int id, const quint64 progress, const quint64 max) {
@@ -111,7 +125,7 @@ void TaskManager::IncreaseTaskProgress(const int id, const quint64 progress, con
     tasks_[id] = t;
   }
 
-  Q_EMIT TasksChanged();
+  ProgressChanged();
 
 }
 
@@ -141,6 +155,22 @@ void TaskManager::SetTaskFinished(const int id) {
 
 }
 
+void TaskManager::ProgressChanged() {
+
+  // Only the first update since the last TasksChanged starts the timer, the rest just change the task.
+  if (progress_update_pending_.exchange(true)) return;
+
+  QMetaObject::invokeMethod(timer_progress_update_, qOverload<>(&QTimer::start), Qt::QueuedConnection);
+
+}
+
+void TaskManager::ProgressUpdateTimeout() {
+
+  progress_update_pending_ = false;
+  Q_EMIT TasksChanged();
+
+}
+
 quint64 TaskManager::GetTaskProgress(int id) {
 
   {
@@ -24,6 +24,8 @@
 
 #include "config.h"
 
+#include <atomic>
+
 #include <QtGlobal>
 #include <QObject>
 #include <QMutex>
@@ -31,6 +33,8 @@
 #include <QMap>
 #include <QString>
 
+class QTimer;
+
 class TaskManager : public QObject {
   Q_OBJECT
 
@@ -75,10 +79,19 @@ class TaskManager : public QObject {
   void PauseCollectionWatchers();
   void ResumeCollectionWatchers();
 
+ private:
+  void ProgressChanged();
+
+ private Q_SLOTS:
+  void ProgressUpdateTimeout();
+
  private:
   QMutex mutex_;
   QMap<int, Task> tasks_;
   int next_task_id_;
+  // Progress updates are collected and TasksChanged is emitted at most every timer interval.
+  QTimer *timer_progress_update_;
+  std::atomic<bool> progress_update_pending_;
 
   Q_DISABLE_COPY(TaskManager)
 };
@@ -26,6 +26,9 @@
 #include <QCoreApplication>
 #include <QIODevice>
 #include <QMutex>
+#include <QHash>
+#include <QByteArray>
+#include <QDateTime>
 #include <QNetworkDiskCache>
 #include <QNetworkCacheMetaData>
 #include <QAbstractNetworkCache>
@@ -36,9 +39,15 @@
 
 using namespace Qt::Literals::StringLiterals;
 
+namespace {
+constexpr qint64 kMaxCacheSize = 100LL * 1024LL * 1024LL;
+constexpr qsizetype kMaxCacheTimes = 1000;
+}  // namespace
+
 QMutex ThreadSafeNetworkDiskCache::sMutex;
 int ThreadSafeNetworkDiskCache::sInstances = 0;
 QNetworkDiskCache *ThreadSafeNetworkDiskCache::sCache = nullptr;
+QHash<QUrl, qint64> ThreadSafeNetworkDiskCache::sCacheTimes;
 
 ThreadSafeNetworkDiskCache::ThreadSafeNetworkDiskCache(QObject *parent) : QAbstractNetworkCache(parent) {
 
@@ -52,6 +61,7 @@ ThreadSafeNetworkDiskCache::ThreadSafeNetworkDiskCache(QObject *parent) : QAbstr
 #else
     sCache->setCacheDirectory(StandardPaths::WritableLocation(StandardPaths::StandardLocation::CacheLocation) + u"/networkcache"_s);
 #endif
+    sCache->setMaximumCacheSize(kMaxCacheSize);
   }
 
 }
@@ -89,8 +99,30 @@ QNetworkCacheMetaData ThreadSafeNetworkDiskCache::metaData(const QUrl &url) {
 }
 
 QIODevice *ThreadSafeNetworkDiskCache::prepare(const QNetworkCacheMetaData &metaData) {
+
   QMutexLocker l(&sMutex);
-  return sCache->prepare(metaData);
+
+  if (!sCacheTimes.contains(metaData.url())) {
+    return sCache->prepare(metaData);
+  }
+
+  // Replace the caching headers from the server with the cache time of the request.
+  const qint64 seconds = sCacheTimes.take(metaData.url());
+  QNetworkCacheMetaData new_metadata(metaData);
+  QNetworkCacheMetaData::RawHeaderList raw_headers;
+  const QNetworkCacheMetaData::RawHeaderList old_raw_headers = metaData.rawHeaders();
+  for (const QNetworkCacheMetaData::RawHeader &raw_header : old_raw_headers) {
+    const QByteArray name = raw_header.first.toLower();
+    if (name != "cache-control" && name != "pragma" && name != "expires" && name != "vary") {
+      raw_headers << raw_header;
+    }
+  }
+  new_metadata.setRawHeaders(raw_headers);
+  new_metadata.setExpirationDate(QDateTime::currentDateTimeUtc().addSecs(seconds));
+  new_metadata.setSaveToDisk(true);
+
+  return sCache->prepare(new_metadata);
+
 }
 
 bool ThreadSafeNetworkDiskCache::remove(const QUrl &url) {
@@ -103,6 +135,17 @@ void ThreadSafeNetworkDiskCache::updateMetaData(const QNetworkCacheMetaData &met
   sCache->updateMetaData(metaData);
 }
 
+void ThreadSafeNetworkDiskCache::SetCacheTime(const QUrl &url, const qint64 seconds) {
+
+  QMutexLocker l(&sMutex);
+
+  if (sCacheTimes.count() >= kMaxCacheTimes) {
+    sCacheTimes.clear();
+  }
+  sCacheTimes.insert(url, seconds);
+
+}
+
 void ThreadSafeNetworkDiskCache::clear() {
   QMutexLocker l(&sMutex);
   sCache->clear();
@@ -28,6 +28,7 @@
 #include <QObject>
 #include <QAbstractNetworkCache>
 #include <QMutex>
+#include <QHash>
 #include <QUrl>
 #include <QNetworkCacheMetaData>
 
@@ -41,6 +42,9 @@ class ThreadSafeNetworkDiskCache : public QAbstractNetworkCache {
   explicit ThreadSafeNetworkDiskCache(QObject *parent);
   ~ThreadSafeNetworkDiskCache() override;
 
+  // Stores the next reply for the URL for the given number of seconds, also when the server does not allow caching or the request failed.
+  static void SetCacheTime(const QUrl &url, const qint64 seconds);
+
   qint64 cacheSize() const override;
   QIODevice *data(const QUrl &url) override;
   void insert(QIODevice *device) override;
@@ -56,6 +60,7 @@ class ThreadSafeNetworkDiskCache : public QAbstractNetworkCache {
   static QMutex sMutex;
   static int sInstances;
   static QNetworkDiskCache *sCache;
+  static QHash<QUrl, qint64> sCacheTimes;
 };
 
 #endif  // THREADSAFENETWORKDISKCACHE_H
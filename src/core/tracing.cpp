@@ -0,0 +1,250 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <vector>
+
+#include <QCoreApplication>
+#include <QThread>
+#include <QStringList>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QString>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+
+#include "core/logging.h"
+#include "tracing.h"
+
+using namespace Qt::Literals::StringLiterals;
+
+namespace {
+
+constexpr quint64 kSpansPerThread = 16384;
+
+struct Span {
+  const char *name;
+  qint64 start_nsec;
+  qint64 end_nsec;
+};
+
+// Only written by the thread that owns it, read while recording is paused.
+struct ThreadBuffer {
+  explicit ThreadBuffer(const int _tid, const QString &_thread_name) : tid(_tid), thread_name(_thread_name), count(0) {}
+  const int tid;
+  const QString thread_name;
+  std::array<Span, kSpansPerThread> spans;
+  std::atomic<quint64> count;
+};
+
+QMutex g_buffers_mutex;
+std::vector<std::unique_ptr<ThreadBuffer>> g_buffers;
+
+constexpr int kMaxOpenSpans = 32;
+
+// Only written by the thread that owns it, read by other threads at any time.
+struct OpenSpanStack {
+  explicit OpenSpanStack(const Qt::HANDLE _thread_id) : thread_id(_thread_id), names{}, start_nsecs{}, depth(0) {}
+  const Qt::HANDLE thread_id;
+  std::array<std::atomic<const char*>, kMaxOpenSpans> names;
+  std::array<std::atomic<qint64>, kMaxOpenSpans> start_nsecs;
+  std::atomic<int> depth;
+};
+
+std::vector<std::unique_ptr<OpenSpanStack>> g_open_span_stacks;
+
+const std::chrono::steady_clock::time_point g_start_time = std::chrono::steady_clock::now();
+
+ThreadBuffer *RegisterThread() {
+
+  QMutexLocker l(&g_buffers_mutex);
+  const int tid = static_cast<int>(g_buffers.size()) + 1;
+  QString thread_name = QThread::currentThread()->objectName();
+  if (thread_name.isEmpty()) thread_name = u"Thread %1"_s.arg(tid);
+  g_buffers.push_back(std::make_unique<ThreadBuffer>(tid, thread_name));
+  return g_buffers.back().get();
+
+}
+
+OpenSpanStack *RegisterOpenSpanStack() {
+
+  QMutexLocker l(&g_buffers_mutex);
+  g_open_span_stacks.push_back(std::make_unique<OpenSpanStack>(QThread::currentThreadId()));
+  return g_open_span_stacks.back().get();
+
+}
+
+OpenSpanStack *CurrentOpenSpanStack() {
+
+  thread_local OpenSpanStack *stack = RegisterOpenSpanStack();
+  return stack;
+
+}
+
+}  // namespace
+
+namespace tracing {
+
+std::atomic<int> g_flags(0);
+
+void SetEnabled(const bool enabled) {
+
+  if (enabled) {
+    g_flags.fetch_or(Flag_Record, std::memory_order_relaxed);
+  }
+  else {
+    g_flags.fetch_and(~Flag_Record, std::memory_order_relaxed);
+  }
+
+}
+
+void SetTrackOpenSpans(const bool enabled) {
+
+  if (enabled) {
+    g_flags.fetch_or(Flag_TrackOpen, std::memory_order_relaxed);
+  }
+  else {
+    g_flags.fetch_and(~Flag_TrackOpen, std::memory_order_relaxed);
+  }
+
+}
+
+qint64 NowNsec() {
+
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - g_start_time).count();
+
+}
+
+void AddSpan(const char *name, const qint64 start_nsec, const qint64 end_nsec) {
+
+  thread_local ThreadBuffer *buffer = RegisterThread();
+
+  const quint64 index = buffer->count.load(std::memory_order_relaxed);
+  buffer->spans[index % kSpansPerThread] = Span { name, start_nsec, end_nsec };
+  buffer->count.store(index + 1, std::memory_order_release);
+
+}
+
+void PushOpenSpan(const char *name, const qint64 start_nsec) {
+
+  OpenSpanStack *stack = CurrentOpenSpanStack();
+  const int depth = stack->depth.load(std::memory_order_relaxed);
+  // Spans nested deeper than the stack are counted, but not named.
+  if (depth < kMaxOpenSpans) {
+    stack->names[depth].store(name, std::memory_order_relaxed);
+    stack->start_nsecs[depth].store(start_nsec, std::memory_order_relaxed);
+  }
+  stack->depth.store(depth + 1, std::memory_order_release);
+
+}
+
+void PopOpenSpan() {
+
+  OpenSpanStack *stack = CurrentOpenSpanStack();
+  stack->depth.store(std::max(0, stack->depth.load(std::memory_order_relaxed) - 1), std::memory_order_release);
+
+}
+
+QStringList OpenSpans(const Qt::HANDLE thread_id) {
+
+  const qint64 now_nsec = NowNsec();
+
+  QStringList spans;
+  QMutexLocker l(&g_buffers_mutex);
+  for (const std::unique_ptr<OpenSpanStack> &stack : g_open_span_stacks) {
+    if (stack->thread_id != thread_id) continue;
+    const int depth = stack->depth.load(std::memory_order_acquire);
+    for (int i = 0; i < std::min(depth, kMaxOpenSpans); ++i) {
+      const char *name = stack->names[i].load(std::memory_order_relaxed);
+      const qint64 start_nsec = stack->start_nsecs[i].load(std::memory_order_relaxed);
+      if (!name) continue;
+      spans << u"%1 (%2 ms)"_s.arg(QString::fromLatin1(name)).arg((now_nsec - start_nsec) / 1000000);
+    }
+    if (depth > kMaxOpenSpans) spans << u"... %1 more"_s.arg(depth - kMaxOpenSpans);
+    break;
+  }
+
+  return spans;
+
+}
+
+bool WriteChromeTrace(const QString &filename) {
+
+  const bool was_enabled = (g_flags.fetch_and(~Flag_Record) & Flag_Record) != 0;
+
+  const qint64 pid = QCoreApplication::applicationPid();
+  QJsonArray events;
+  {
+    QMutexLocker l(&g_buffers_mutex);
+    for (const std::unique_ptr<ThreadBuffer> &buffer : g_buffers) {
+      QJsonObject thread_name_args;
+      thread_name_args.insert(u"name"_s, buffer->thread_name);
+      QJsonObject thread_name_event;
+      thread_name_event.insert(u"name"_s, u"thread_name"_s);
+      thread_name_event.insert(u"ph"_s, u"M"_s);
+      thread_name_event.insert(u"pid"_s, pid);
+      thread_name_event.insert(u"tid"_s, buffer->tid);
+      thread_name_event.insert(u"args"_s, thread_name_args);
+      events.append(thread_name_event);
+
+      const quint64 count = buffer->count.load(std::memory_order_acquire);
+      const quint64 first = count > kSpansPerThread ? count - kSpansPerThread : 0;
+      for (quint64 i = first; i < count; ++i) {
+        const Span &span = buffer->spans[i % kSpansPerThread];
+        QJsonObject event;
+        event.insert(u"name"_s, QString::fromLatin1(span.name));
+        event.insert(u"ph"_s, u"X"_s);
+        event.insert(u"pid"_s, pid);
+        event.insert(u"tid"_s, buffer->tid);
+        event.insert(u"ts"_s, static_cast<double>(span.start_nsec) / 1000.0);
+        event.insert(u"dur"_s, static_cast<double>(span.end_nsec - span.start_nsec) / 1000.0);
+        events.append(event);
+      }
+    }
+  }
+
+  if (was_enabled) g_flags.fetch_or(Flag_Record);
+
+  QJsonObject root;
+  root.insert(u"traceEvents"_s, events);
+  root.insert(u"displayTimeUnit"_s, u"ms"_s);
+
+  QFile file(filename);
+  if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+    qLog(Error) << "Could not open trace file" << filename << "for writing:" << file.errorString();
+    return false;
+  }
+  if (file.write(QJsonDocument(root).toJson(QJsonDocument::Compact)) == -1) {
+    qLog(Error) << "Could not write trace file" << filename << ":" << file.errorString();
+    return false;
+  }
+  file.close();
+
+  qLog(Info) << "Wrote" << events.count() << "trace events to" << filename;
+
+  return true;
+
+}
+
+}  // namespace tracing
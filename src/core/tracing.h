@@ -0,0 +1,84 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#ifndef TRACING_H
+#define TRACING_H
+
+#include <atomic>
+
+#include <QtGlobal>
+#include <QString>
+#include <QStringList>
+
+// Scoped timers for profiling, written out in the Chrome trace event format which can be opened in chrome://tracing or Perfetto.
+// Usage:
+//    qTraceScope("Database::Connect");
+// The name must be a string literal, it is stored as a pointer.
+// Each thread records spans into its own ring buffer, when tracing is disabled a span costs a relaxed atomic load.
+// Independent of recording, the spans that are still open can be tracked, so a stall of a thread can be attributed to them.
+
+#define TRACING_CONCAT_INTERNAL(a, b) a##b
+#define TRACING_CONCAT(a, b) TRACING_CONCAT_INTERNAL(a, b)
+#define qTraceScope(name) tracing::ScopedSpan TRACING_CONCAT(trace_scope_, __LINE__)(name)
+
+namespace tracing {
+
+enum Flag {
+  Flag_Record = 1,
+  Flag_TrackOpen = 2
+};
+
+extern std::atomic<int> g_flags;
+
+inline bool IsEnabled() { return g_flags.load(std::memory_order_relaxed) & Flag_Record; }
+void SetEnabled(const bool enabled);
+void SetTrackOpenSpans(const bool enabled);
+
+qint64 NowNsec();
+void AddSpan(const char *name, const qint64 start_nsec, const qint64 end_nsec);
+void PushOpenSpan(const char *name, const qint64 start_nsec);
+void PopOpenSpan();
+
+// Returns the spans currently open in the given thread with how long they have been open, outermost first.
+// The other thread keeps running while this is read, so it is a sample.
+QStringList OpenSpans(Qt::HANDLE thread_id);
+
+// Writes the recorded spans of all threads, recording is paused while writing.
+bool WriteChromeTrace(const QString &filename);
+
+class ScopedSpan {
+ public:
+  explicit ScopedSpan(const char *name) : flags_(g_flags.load(std::memory_order_relaxed)), name_(name), start_nsec_(flags_ ? NowNsec() : 0) {
+    if (flags_ & Flag_TrackOpen) PushOpenSpan(name_, start_nsec_);
+  }
+  ~ScopedSpan() {
+    if (flags_ & Flag_TrackOpen) PopOpenSpan();
+    if (flags_ & Flag_Record) AddSpan(name_, start_nsec_, NowNsec());
+  }
+
+ private:
+  Q_DISABLE_COPY_MOVE(ScopedSpan)
+
+  const int flags_;
+  const char *name_;
+  const qint64 start_nsec_;
+};
+
+}  // namespace tracing
+
+#endif  // TRACING_H
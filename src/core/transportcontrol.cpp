@@ -0,0 +1,143 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "config.h"
+
+#include <utility>
+#include <optional>
+
+#include <QObject>
+#include <QCoreApplication>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QString>
+
+#ifdef HAVE_KGLOBALACCEL_GLOBALSHORTCUTS
+#  include <QDBusConnection>
+#endif
+
+#include "core/logging.h"
+#include "engine/enginebase.h"
+#include "transportcontrol.h"
+
+using namespace Qt::Literals::StringLiterals;
+
+namespace {
+#ifdef HAVE_KGLOBALACCEL_GLOBALSHORTCUTS
+constexpr char kKGlobalAccelComponentInterface[] = "org.kde.kglobalaccel.Component";
+#endif
+}  // namespace
+
+TransportControl::TransportControl(SharedPtr<EngineBase> engine, QObject *parent)
+    : QObject(parent),
+      engine_(std::move(engine)) {
+
+  setObjectName(QLatin1String(QObject::metaObject()->className()));
+
+}
+
+bool TransportControl::IsTransportShortcut(const QString &id) {
+
+  return id == "play"_L1 || id == "pause"_L1 || id == "play_pause"_L1;
+
+}
+
+bool TransportControl::Command(const EngineBase::TransportCommand command) {
+
+  const std::optional<EngineBase::State> state = engine_->TransportFast(command);
+  if (!state) return false;
+
+  if (state.value() == EngineBase::State::Playing) Q_EMIT Resumed();
+
+  return true;
+
+}
+
+void TransportControl::Play() {
+
+  if (!Command(EngineBase::TransportCommand::Play)) Q_EMIT PlayRequested();
+
+}
+
+void TransportControl::Pause() {
+
+  if (!Command(EngineBase::TransportCommand::Pause)) Q_EMIT PauseRequested();
+
+}
+
+void TransportControl::PlayPause() {
+
+  if (!Command(EngineBase::TransportCommand::PlayPause)) Q_EMIT PlayPauseRequested();
+
+}
+
+#ifdef HAVE_KGLOBALACCEL_GLOBALSHORTCUTS
+
+bool TransportControl::ConnectKGlobalAccelComponent(const QString &service, const QString &path) {
+
+  DisconnectKGlobalAccelComponent();
+
+  // QtDBus delivers the signal in the thread of the receiver, not the main thread.
+  if (!QDBusConnection::sessionBus().connect(service, path, QLatin1String(kKGlobalAccelComponentInterface), u"globalShortcutPressed"_s, this, SLOT(KGlobalAccelShortcutPressed(QString, QString, qlonglong)))) {
+    qLog(Error) << "Failed to connect to the KGlobalAccel component" << path;
+    return false;
+  }
+
+  QMutexLocker l(&mutex_kglobalaccel_);
+  kglobalaccel_service_ = service;
+  kglobalaccel_path_ = path;
+
+  return true;
+
+}
+
+void TransportControl::DisconnectKGlobalAccelComponent() {
+
+  QString service;
+  QString path;
+  {
+    QMutexLocker l(&mutex_kglobalaccel_);
+    service = std::exchange(kglobalaccel_service_, QString());
+    path = std::exchange(kglobalaccel_path_, QString());
+  }
+  if (path.isEmpty()) return;
+
+  QDBusConnection::sessionBus().disconnect(service, path, QLatin1String(kKGlobalAccelComponentInterface), u"globalShortcutPressed"_s, this, SLOT(KGlobalAccelShortcutPressed(QString, QString, qlonglong)));
+
+}
+
+void TransportControl::KGlobalAccelShortcutPressed(const QString &component_unique, const QString &shortcut_unique, const qlonglong timestamp) {
+
+  Q_UNUSED(timestamp)
+
+  if (component_unique != QCoreApplication::applicationName()) return;
+
+  if (shortcut_unique == "play"_L1) {
+    Play();
+  }
+  else if (shortcut_unique == "pause"_L1) {
+    Pause();
+  }
+  else if (shortcut_unique == "play_pause"_L1) {
+    PlayPause();
+  }
+
+}
+
+#endif  // HAVE_KGLOBALACCEL_GLOBALSHORTCUTS
@@ -0,0 +1,77 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef TRANSPORTCONTROL_H
+#define TRANSPORTCONTROL_H
+
+#include "config.h"
+
+#include <QObject>
+#include <QMutex>
+#include <QString>
+
+#include "includes/shared_ptr.h"
+#include "engine/enginebase.h"
+
+// Receives play and pause commands on its own thread, so they don't wait for the main event loop when it is busy.
+// The engine pauses or resumes the current stream directly when it can, everything else is forwarded to the player in the main thread.
+class TransportControl : public QObject {
+  Q_OBJECT
+
+ public:
+  explicit TransportControl(SharedPtr<EngineBase> engine, QObject *parent = nullptr);
+
+  // The global shortcuts handled here instead of by the shortcut backends.
+  static bool IsTransportShortcut(const QString &id);
+
+#ifdef HAVE_KGLOBALACCEL_GLOBALSHORTCUTS
+  // Thread safe, receives the shortcuts of the KGlobalAccel component on the thread of this object.
+  bool ConnectKGlobalAccelComponent(const QString &service, const QString &path);
+  void DisconnectKGlobalAccelComponent();
+#endif
+
+ public Q_SLOTS:
+  void Play();
+  void Pause();
+  void PlayPause();
+
+ Q_SIGNALS:
+  void PlayRequested();
+  void PauseRequested();
+  void PlayPauseRequested();
+  void Resumed();
+
+#ifdef HAVE_KGLOBALACCEL_GLOBALSHORTCUTS
+ private Q_SLOTS:
+  void KGlobalAccelShortcutPressed(const QString &component_unique, const QString &shortcut_unique, const qlonglong timestamp);
+#endif
+
+ private:
+  bool Command(const EngineBase::TransportCommand command);
+
+  SharedPtr<EngineBase> engine_;
+
+#ifdef HAVE_KGLOBALACCEL_GLOBALSHORTCUTS
+  QMutex mutex_kglobalaccel_;
+  QString kglobalaccel_service_;
+  QString kglobalaccel_path_;
+#endif
+};
+
+#endif  // TRANSPORTCONTROL_H
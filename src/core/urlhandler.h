@@ -87,6 +87,9 @@ class UrlHandler : public QObject {
   // Called by the Player when a song starts loading - gives the handler a chance to do something clever to get a playable track.
   virtual LoadResult StartLoading(const QUrl &url) { return LoadResult(url); }
 
+  // Called by the Player when the stream URL returned for the url could not be played, handlers that cache stream URLs should forget it.
+  virtual void InvalidateStreamUrl(const QUrl &url) { Q_UNUSED(url); }
+
  Q_SIGNALS:
   void AsyncLoadComplete(const UrlHandler::LoadResult &result);
 };
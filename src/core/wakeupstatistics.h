@@ -0,0 +1,42 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef WAKEUPSTATISTICS_H
+#define WAKEUPSTATISTICS_H
+
+#include "config.h"
+
+#include <atomic>
+
+#include <QtGlobal>
+
+// Counts the timer wake-ups during playback, ie: the engine and analyzer timers, the console shows them per second.
+class WakeupStatistics {
+ public:
+  static void Add() { counter().fetch_add(1, std::memory_order_relaxed); }
+  static quint64 Count() { return counter().load(std::memory_order_relaxed); }
+
+ private:
+  static std::atomic<quint64> &counter() {
+    static std::atomic<quint64> wakeups(0);
+    return wakeups;
+  }
+};
+
+#endif  // WAKEUPSTATISTICS_H
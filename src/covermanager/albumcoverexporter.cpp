@@ -20,28 +20,33 @@
 
 #include "config.h"
 
+#include <QtGlobal>
 #include <QObject>
-#include <QThreadPool>
+#include <QThread>
+#include <QSemaphore>
 
 #include "core/song.h"
+#include "core/taskexecutor.h"
 #include "albumcoverloaderoptions.h"
 #include "albumcoverexport.h"
 #include "albumcoverexporter.h"
 #include "coverexportrunnable.h"
 
 namespace {
-constexpr int kMaxConcurrentRequests = 3;
+constexpr int kMaxConcurrentRequests = 8;
+constexpr int kMaxConcurrentWrites = 2;
 }
 
 AlbumCoverExporter::AlbumCoverExporter(const SharedPtr<TagReaderClient> tagreader_client, QObject *parent)
     : QObject(parent),
       tagreader_client_(tagreader_client),
-      thread_pool_(new QThreadPool(this)),
+      // Decoding and scaling is CPU bound, so use the available cores, disk writes are limited separately by io_semaphore_.
+      max_active_(qBound(1, QThread::idealThreadCount(), kMaxConcurrentRequests)),
+      io_semaphore_(kMaxConcurrentWrites),
+      active_(0),
       exported_(0),
       skipped_(0),
-      all_(0) {
-  thread_pool_->setMaxThreadCount(kMaxConcurrentRequests);
-}
+      all_(0) {}
 
 void AlbumCoverExporter::SetDialogResult(const AlbumCoverExport::DialogResult &dialog_result) {
   dialog_result_ = dialog_result;
@@ -53,7 +58,7 @@ void AlbumCoverExporter::SetCoverTypes(const AlbumCoverLoaderOptions::Types &cov
 
 void AlbumCoverExporter::AddExportRequest(const Song &song) {
 
-  requests_.append(new CoverExportRunnable(tagreader_client_, dialog_result_, cover_types_, song));
+  requests_.append(new CoverExportRunnable(tagreader_client_, dialog_result_, cover_types_, song, &io_semaphore_));
   all_ = static_cast<int>(requests_.count());
 
 }
@@ -62,6 +67,7 @@ void AlbumCoverExporter::Cancel() { requests_.clear(); }
 
 void AlbumCoverExporter::StartExporting() {
 
+  active_ = 0;
   exported_ = 0;
   skipped_ = 0;
   AddJobsToPool();
@@ -70,19 +76,21 @@ void AlbumCoverExporter::StartExporting() {
 
 void AlbumCoverExporter::AddJobsToPool() {
 
-  while (!requests_.isEmpty() && thread_pool_->activeThreadCount() < thread_pool_->maxThreadCount()) {
+  while (!requests_.isEmpty() && active_ < max_active_) {
     CoverExportRunnable *runnable = requests_.dequeue();
 
     QObject::connect(runnable, &CoverExportRunnable::CoverExported, this, &AlbumCoverExporter::CoverExported);
     QObject::connect(runnable, &CoverExportRunnable::CoverSkipped, this, &AlbumCoverExporter::CoverSkipped);
 
-    thread_pool_->start(runnable);
+    ++active_;
+    TaskExecutor::Pool(TaskExecutor::Lane::BackgroundIO)->start(runnable);
   }
 
 }
 
 void AlbumCoverExporter::CoverExported() {
 
+  --active_;
   ++exported_;
   Q_EMIT AlbumCoversExportUpdate(exported_, skipped_, all_);
   AddJobsToPool();
@@ -91,6 +99,7 @@ void AlbumCoverExporter::CoverExported() {
 
 void AlbumCoverExporter::CoverSkipped() {
 
+  --active_;
   ++skipped_;
   Q_EMIT AlbumCoversExportUpdate(exported_, skipped_, all_);
   AddJobsToPool();
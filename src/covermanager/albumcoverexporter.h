@@ -26,13 +26,13 @@
 #include <QObject>
 #include <QQueue>
 #include <QString>
+#include <QSemaphore>
 
 #include "includes/shared_ptr.h"
 
 #include "albumcoverloaderoptions.h"
 #include "albumcoverexport.h"
 
-class QThreadPool;
 class Song;
 class CoverExportRunnable;
 class TagReaderClient;
@@ -67,8 +67,10 @@ class AlbumCoverExporter : public QObject {
   AlbumCoverExport::DialogResult dialog_result_;
 
   QQueue<CoverExportRunnable*> requests_;
-  QThreadPool *thread_pool_;
+  const int max_active_;
+  QSemaphore io_semaphore_;
 
+  int active_;
   int exported_;
   int skipped_;
   int all_;
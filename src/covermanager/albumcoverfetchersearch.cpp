@@ -33,6 +33,7 @@
 #include <QUrl>
 #include <QImage>
 #include <QImageReader>
+#include <QBuffer>
 #include <QNetworkRequest>
 #include <QNetworkReply>
 
@@ -55,18 +56,27 @@ constexpr int kSearchTimeoutMs = 20000;
 constexpr int kImageLoadTimeoutMs = 6000;
 constexpr int kTargetSize = 500;
 constexpr float kGoodScore = 4.0;
+// When fetching a cover, wait this long for the remaining providers after the first one answered with results.
+constexpr int kProviderDeadlineMs = 4000;
+constexpr int kImageProbeBytes = 65536;
 }  // namespace
 
 AlbumCoverFetcherSearch::AlbumCoverFetcherSearch(const CoverSearchRequest &request, SharedPtr<NetworkAccessManager> network, QObject *parent)
     : QObject(parent),
       request_(request),
+      timer_provider_deadline_(new QTimer(this)),
       image_load_timeout_(new NetworkTimeouts(kImageLoadTimeoutMs, this)),
       network_(network),
-      cancel_requested_(false) {
+      cancel_requested_(false),
+      providers_finished_(false) {
 
   // We will terminate the search after kSearchTimeoutMs milliseconds if we are not able to find all of the results before that point in time
   QTimer::singleShot(kSearchTimeoutMs, this, &AlbumCoverFetcherSearch::TerminateSearch);
 
+  timer_provider_deadline_->setSingleShot(true);
+  timer_provider_deadline_->setInterval(kProviderDeadlineMs);
+  QObject::connect(timer_provider_deadline_, &QTimer::timeout, this, &AlbumCoverFetcherSearch::TerminateSearch);
+
 }
 
 AlbumCoverFetcherSearch::~AlbumCoverFetcherSearch() {
@@ -76,6 +86,8 @@ AlbumCoverFetcherSearch::~AlbumCoverFetcherSearch() {
 
 void AlbumCoverFetcherSearch::TerminateSearch() {
 
+  timer_provider_deadline_->stop();
+
   const QList<int> ids = pending_requests_.keys();
   for (const int id : ids) {
     pending_requests_.take(id)->CancelSearch(id);
@@ -240,15 +252,38 @@ void AlbumCoverFetcherSearch::ProviderSearchFinished(const int id, const CoverPr
 
   // Do we have more providers left?
   if (!pending_requests_.isEmpty()) {
+    if (!request_.search && !results_.isEmpty()) {
+      // Don't let slow providers hold up fetching the cover.
+      if (HasGoodResult()) {
+        qLog(Debug) << "Got a good result from" << provider->name() << "not waiting for" << pending_requests_.count() << "more providers";
+        TerminateSearch();
+      }
+      else if (!timer_provider_deadline_->isActive()) {
+        timer_provider_deadline_->start();
+      }
+    }
     return;
   }
 
+  timer_provider_deadline_->stop();
+
   AllProvidersFinished();
 
 }
 
+bool AlbumCoverFetcherSearch::HasGoodResult() const {
+
+  // A result matching both artist and album from the request, where the size given by the API already scores high enough.
+  return std::any_of(results_.begin(), results_.end(), [](const CoverProviderSearchResult &result) { return result.score_match >= 1.0F && result.score() >= kGoodScore; });
+
+}
+
 void AlbumCoverFetcherSearch::AllProvidersFinished() {
 
+  // The search timeout can still fire after the search was ended early.
+  if (providers_finished_) return;
+  providers_finished_ = true;
+
   qLog(Debug) << "Search finished, got" << results_.count() << "results";
 
   if (cancel_requested_) {
@@ -274,25 +309,27 @@ void AlbumCoverFetcherSearch::AllProvidersFinished() {
 
   std::stable_sort(results_.begin(), results_.end(), CoverProviderSearchResultCompareScore);
 
-  FetchMoreImages();
+  ProbeMoreImages();
 
 }
 
-void AlbumCoverFetcherSearch::FetchMoreImages() {
+void AlbumCoverFetcherSearch::ProbeMoreImages() {
 
   int i = 0;
   while (!results_.isEmpty()) {
     ++i;
     CoverProviderSearchResult result = results_.takeFirst();
 
-    qLog(Debug) << "Loading" << result.artist << result.album << result.image_url << "from" << result.provider << "with current score" << result.score();
+    qLog(Debug) << "Probing" << result.artist << result.album << result.image_url << "from" << result.provider << "with current score" << result.score();
 
+    // Only request the start of the image, enough for the image reader to read the size from the header.
     QNetworkRequest network_request(result.image_url);
     network_request.setAttribute(QNetworkRequest::RedirectPolicyAttribute, QNetworkRequest::NoLessSafeRedirectPolicy);
-    QNetworkReply *image_reply = network_->get(network_request);
-    QObject::connect(image_reply, &QNetworkReply::finished, this, [this, image_reply]() { ProviderCoverFetchFinished(image_reply); });
-    pending_image_loads_[image_reply] = result;
-    image_load_timeout_->AddReply(image_reply);
+    network_request.setRawHeader("Range", QByteArray("bytes=0-") + QByteArray::number(kImageProbeBytes - 1));
+    QNetworkReply *probe_reply = network_->get(network_request);
+    QObject::connect(probe_reply, &QNetworkReply::finished, this, [this, probe_reply]() { ProviderCoverProbeFinished(probe_reply); });
+    pending_image_probes_[probe_reply] = result;
+    image_load_timeout_->AddReply(probe_reply);
 
     ++statistics_.network_requests_made_;
 
@@ -300,13 +337,102 @@ void AlbumCoverFetcherSearch::FetchMoreImages() {
 
   }
 
-  if (pending_image_loads_.isEmpty()) {
-    // There were no more results?  Time to give up.
-    SendBestImage();
+  if (pending_image_probes_.isEmpty()) {
+    FetchBestProbedImage();
+  }
+
+}
+
+void AlbumCoverFetcherSearch::ProviderCoverProbeFinished(QNetworkReply *reply) {
+
+  QObject::disconnect(reply, nullptr, this, nullptr);
+  reply->deleteLater();
+
+  if (!pending_image_probes_.contains(reply)) return;
+  CoverProviderSearchResult result = pending_image_probes_.take(reply);
+
+  if (cancel_requested_) return;
+
+  const int http_code = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+  if (reply->error() == QNetworkReply::NoError && (http_code == 200 || http_code == 206)) {
+    QByteArray image_data = reply->readAll();
+    statistics_.bytes_transferred_ += image_data.size();
+    QBuffer buffer(&image_data);
+    if (buffer.open(QIODevice::ReadOnly)) {
+      QImageReader image_reader(&buffer);
+      const QSize image_size = image_reader.size();
+      if (image_size.isValid()) {
+        if (result.image_size != QSize(0, 0) && result.image_size != image_size) {
+          qLog(Debug) << "API size for image" << result.image_size << "for" << reply->url() << "from" << result.provider << "did not match probed size" << image_size;
+        }
+        result.image_size = image_size;
+        result.score_quality = ScoreImage(image_size);
+      }
+      buffer.close();
+    }
+    // The server ignored the range, so this is the complete image.
+    if (http_code == 200) {
+      probed_image_data_.insert(result.image_url, image_data);
+    }
+  }
+  else {
+    // Keep the result with the score from the API, the image might still be downloadable.
+    qLog(Debug) << "Could not probe" << reply->url() << reply->errorString() << http_code;
+  }
+
+  probed_results_ << result;
+
+  if (pending_image_probes_.isEmpty()) {
+    std::stable_sort(probed_results_.begin(), probed_results_.end(), CoverProviderSearchResultCompareScore);
+    FetchBestProbedImage();
   }
 
 }
 
+void AlbumCoverFetcherSearch::FetchBestProbedImage() {
+
+  // Check if the image we have is good enough, or if the rest of the probed images can't score better.
+  if (!candidate_images_.isEmpty()) {
+    const float best_score = candidate_images_.lastKey();
+    qLog(Debug) << "Best image so far has a score of" << best_score;
+    if (best_score >= kGoodScore || (probed_results_.isEmpty() && results_.isEmpty())) {
+      SendBestImage();
+      return;
+    }
+  }
+
+  if (probed_results_.isEmpty()) {
+    if (results_.isEmpty()) {
+      // There were no more results?  Time to give up.
+      SendBestImage();
+    }
+    else {
+      ProbeMoreImages();
+    }
+    return;
+  }
+
+  const CoverProviderSearchResult result = probed_results_.takeFirst();
+
+  if (probed_image_data_.contains(result.image_url)) {
+    AddCandidateImage(result, probed_image_data_.take(result.image_url));
+    FetchBestProbedImage();
+    return;
+  }
+
+  qLog(Debug) << "Loading" << result.artist << result.album << result.image_url << "from" << result.provider << "with current score" << result.score();
+
+  QNetworkRequest network_request(result.image_url);
+  network_request.setAttribute(QNetworkRequest::RedirectPolicyAttribute, QNetworkRequest::NoLessSafeRedirectPolicy);
+  QNetworkReply *image_reply = network_->get(network_request);
+  QObject::connect(image_reply, &QNetworkReply::finished, this, [this, image_reply]() { ProviderCoverFetchFinished(image_reply); });
+  pending_image_loads_[image_reply] = result;
+  image_load_timeout_->AddReply(image_reply);
+
+  ++statistics_.network_requests_made_;
+
+}
+
 void AlbumCoverFetcherSearch::ProviderCoverFetchFinished(QNetworkReply *reply) {
 
   QObject::disconnect(reply, nullptr, this, nullptr);
@@ -331,44 +457,33 @@ void AlbumCoverFetcherSearch::ProviderCoverFetchFinished(QNetworkReply *reply) {
       mimetype = mimetype.left(mimetype.indexOf(u';'));
     }
     if (ImageUtils::SupportedImageMimeTypes().contains(mimetype, Qt::CaseInsensitive) || ImageUtils::SupportedImageFormats().contains(mimetype, Qt::CaseInsensitive)) {
-      QByteArray image_data = reply->readAll();
-      QString mime_type = Utilities::MimeTypeFromData(image_data);
-      QImage image;
-      if (image.loadFromData(image_data)) {
-        if (result.image_size != QSize(0, 0) && result.image_size != image.size()) {
-          qLog(Debug) << "API size for image" << result.image_size << "for" << reply->url() << "from" << result.provider << "did not match retrieved size" << image.size();
-        }
-        result.image_size = image.size();
-        result.score_quality = ScoreImage(image.size());
-        candidate_images_.insert(result.score(), CandidateImage(result, AlbumCoverImageResult(result.image_url, mime_type, image_data, image)));
-        qLog(Debug) << reply->url() << "from" << result.provider << "scored" << result.score();
-      }
-      else {
-        qLog(Error) << "Error decoding image data from" << reply->url();
-      }
+      AddCandidateImage(result, reply->readAll());
     }
     else {
       qLog(Error) << "Unsupported mimetype for image reader:" << mimetype << "from" << reply->url();
     }
   }
 
-  if (pending_image_loads_.isEmpty()) {
-    // We've fetched everything we wanted to fetch for now, check if we have an image that's good enough.
-    float best_score = 0.0;
+  FetchBestProbedImage();
 
-    if (!candidate_images_.isEmpty()) {
-      QList<float> scores = candidate_images_.keys();
-      best_score = scores.last();
-      qLog(Debug) << "Best image so far has a score of" << best_score;
-    }
+}
 
-    if (best_score >= kGoodScore) {
-      SendBestImage();
-    }
-    else {
-      FetchMoreImages();
-    }
+void AlbumCoverFetcherSearch::AddCandidateImage(CoverProviderSearchResult result, const QByteArray &image_data) {
+
+  const QString mime_type = Utilities::MimeTypeFromData(image_data);
+  QImage image;
+  if (!image.loadFromData(image_data)) {
+    qLog(Error) << "Error decoding image data from" << result.image_url;
+    return;
+  }
+
+  if (result.image_size != QSize(0, 0) && result.image_size != image.size()) {
+    qLog(Debug) << "Size for image" << result.image_size << "for" << result.image_url << "from" << result.provider << "did not match retrieved size" << image.size();
   }
+  result.image_size = image.size();
+  result.score_quality = ScoreImage(image.size());
+  candidate_images_.insert(result.score(), CandidateImage(result, AlbumCoverImageResult(result.image_url, mime_type, image_data, image)));
+  qLog(Debug) << result.image_url << "from" << result.provider << "scored" << result.score();
 
 }
 
@@ -417,13 +532,15 @@ void AlbumCoverFetcherSearch::Cancel() {
   if (!pending_requests_.isEmpty()) {
     TerminateSearch();
   }
-  else if (!pending_image_loads_.isEmpty()) {
-    const QList<QNetworkReply*> replies = pending_image_loads_.keys();
-    for (QNetworkReply *reply : replies) {
+  else {
+    QList<QNetworkReply*> replies = pending_image_probes_.keys();
+    replies << pending_image_loads_.keys();
+    for (QNetworkReply *reply : std::as_const(replies)) {
       QObject::disconnect(reply, &QNetworkReply::finished, this, nullptr);
       reply->abort();
       reply->deleteLater();
     }
+    pending_image_probes_.clear();
     pending_image_loads_.clear();
   }
 
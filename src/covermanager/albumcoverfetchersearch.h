@@ -40,6 +40,7 @@
 #include "coversearchstatistics.h"
 #include "albumcoverimageresult.h"
 
+class QTimer;
 class QNetworkReply;
 class CoverProvider;
 class CoverProviders;
@@ -49,6 +50,7 @@ class NetworkTimeouts;
 // This class encapsulates a single search for covers initiated by an AlbumCoverFetcher.
 // The search engages all of the known cover providers.
 // AlbumCoverFetcherSearch signals search results to an interested AlbumCoverFetcher when all of the providers have done their part.
+// When fetching a cover, the search doesn't wait for slow providers once one has answered with a good enough result or the provider deadline is reached.
 class AlbumCoverFetcherSearch : public QObject {
   Q_OBJECT
 
@@ -75,6 +77,7 @@ class AlbumCoverFetcherSearch : public QObject {
  private Q_SLOTS:
   void ProviderSearchResults(const int id, const CoverProviderSearchResults &results);
   void ProviderSearchFinished(const int id, const CoverProviderSearchResults &results);
+  void ProviderCoverProbeFinished(QNetworkReply *reply);
   void ProviderCoverFetchFinished(QNetworkReply *reply);
   void TerminateSearch();
 
@@ -82,7 +85,10 @@ class AlbumCoverFetcherSearch : public QObject {
   void ProviderSearchResults(CoverProvider *provider, const CoverProviderSearchResults &results);
   void AllProvidersFinished();
 
-  void FetchMoreImages();
+  bool HasGoodResult() const;
+  void ProbeMoreImages();
+  void FetchBestProbedImage();
+  void AddCandidateImage(CoverProviderSearchResult result, const QByteArray &image_data);
   static float ScoreImage(const QSize size);
   void SendBestImage();
 
@@ -99,6 +105,14 @@ class AlbumCoverFetcherSearch : public QObject {
   CoverProviderSearchResults results_;
 
   QMap<int, CoverProvider*> pending_requests_;
+  QTimer *timer_provider_deadline_;
+
+  // Images are first probed with a range request for the header to get the real image size, then only the best one is downloaded.
+  QHash<QNetworkReply*, CoverProviderSearchResult> pending_image_probes_;
+  CoverProviderSearchResults probed_results_;
+  // Complete image data received from probes where the server ignored the range.
+  QHash<QUrl, QByteArray> probed_image_data_;
+
   QHash<QNetworkReply*, CoverProviderSearchResult> pending_image_loads_;
   NetworkTimeouts *image_load_timeout_;
 
@@ -113,6 +127,7 @@ class AlbumCoverFetcherSearch : public QObject {
   SharedPtr<NetworkAccessManager> network_;
 
   bool cancel_requested_;
+  bool providers_finished_;
 };
 
 #endif  // ALBUMCOVERFETCHERSEARCH_H
@@ -18,26 +18,32 @@
  */
 
 #include <memory>
-#include <chrono>
 
 #include <QtGlobal>
 #include <QObject>
 #include <QThread>
+#include <QThreadPool>
 #include <QMutex>
+#include <QList>
 #include <QSet>
+#include <QMap>
+#include <QHash>
 #include <QQueue>
 #include <QVariant>
 #include <QByteArray>
 #include <QString>
+#include <QStringList>
 #include <QUrl>
 #include <QFile>
+#include <QBuffer>
 #include <QImage>
-#include <QTimer>
+#include <QImageReader>
 #include <QNetworkReply>
 #include <QNetworkRequest>
 
 #include "includes/shared_ptr.h"
 #include "core/logging.h"
+#include "core/tracing.h"
 #include "core/networkaccessmanager.h"
 #include "core/song.h"
 #include "utilities/mimeutils.h"
@@ -48,19 +54,23 @@
 #include "albumcoverloaderresult.h"
 #include "albumcoverimageresult.h"
 
-using namespace std::literals::chrono_literals;
 using std::make_shared;
+using namespace Qt::Literals::StringLiterals;
 
 namespace {
 constexpr int kMaxRedirects = 3;
+// Workers for everything except the current song, the thread pool has one more thread reserved for the current song so it's never queued behind the collection or cover manager.
+constexpr int kMaxWorkers = 4;
 }
 
 AlbumCoverLoader::AlbumCoverLoader(const SharedPtr<TagReaderClient> tagreader_client, QObject *parent)
     : QObject(parent),
       tagreader_client_(tagreader_client),
       network_(new NetworkAccessManager(this)),
-      timer_process_tasks_(new QTimer(this)),
+      network_schemes_(network_->supportedSchemes()),
+      thread_pool_(new QThreadPool(this)),
       stop_requested_(false),
+      workers_(0),
       load_image_async_id_(1),
       original_thread_(nullptr) {
 
@@ -68,9 +78,7 @@ AlbumCoverLoader::AlbumCoverLoader(const SharedPtr<TagReaderClient> tagreader_cl
 
   original_thread_ = thread();
 
-  timer_process_tasks_->setSingleShot(false);
-  timer_process_tasks_->setInterval(10ms);
-  QObject::connect(timer_process_tasks_, &QTimer::timeout, this, &AlbumCoverLoader::ProcessTasks);
+  thread_pool_->setMaxThreadCount(qBound(1, QThread::idealThreadCount(), kMaxWorkers) + 1);
 
 }
 
@@ -84,6 +92,14 @@ void AlbumCoverLoader::ExitAsync() {
 void AlbumCoverLoader::Exit() {
 
   Q_ASSERT(QThread::currentThread() == thread());
+
+  {
+    QMutexLocker l(&mutex_load_image_async_);
+    tasks_.clear();
+    tasks_by_key_.clear();
+  }
+  thread_pool_->waitForDone();
+
   moveToThread(original_thread_);
   Q_EMIT ExitFinished();
 
@@ -91,30 +107,40 @@ void AlbumCoverLoader::Exit() {
 
 void AlbumCoverLoader::CancelTask(const quint64 id) {
 
-  QMutexLocker l(&mutex_load_image_async_);
-  for (QQueue<TaskPtr>::iterator it = tasks_.begin(); it != tasks_.end(); ++it) {
-    TaskPtr task = *it;
-    if (task->id == id) {
-      tasks_.erase(it);
-      break;
-    }
-  }
+  CancelTasks(QSet<quint64>() << id);
 
 }
 
 void AlbumCoverLoader::CancelTasks(const QSet<quint64> &ids) {
 
   QMutexLocker l(&mutex_load_image_async_);
-  for (QQueue<TaskPtr>::iterator it = tasks_.begin(); it != tasks_.end();) {
-    TaskPtr task = *it;
-    if (ids.contains(task->id)) {
-      it = tasks_.erase(it);
-    }
-    else {
+
+  const auto remove_coalesced_ids = [&ids](TaskPtr task) {
+    task->coalesced_ids.removeIf([&ids](const quint64 id) { return ids.contains(id); });
+  };
+
+  for (QQueue<TaskPtr> &tasks : tasks_) {
+    for (QQueue<TaskPtr>::iterator it = tasks.begin(); it != tasks.end();) {
+      TaskPtr task = *it;
+      remove_coalesced_ids(task);
+      if (ids.contains(task->id)) {
+        if (task->coalesced_ids.isEmpty()) {
+          if (!task->key.isEmpty()) tasks_by_key_.remove(task->key);
+          it = tasks.erase(it);
+          continue;
+        }
+        // Another request is still waiting for this cover.
+        task->id = task->coalesced_ids.takeFirst();
+      }
       ++it;
     }
   }
 
+  // Tasks already being processed are not stopped, but the result is not sent for the coalesced requests that were cancelled.
+  for (TaskPtr task : std::as_const(tasks_by_key_)) {
+    remove_coalesced_ids(task);
+  }
+
 }
 
 quint64 AlbumCoverLoader::LoadImageAsync(const AlbumCoverLoaderOptions &options, const Song &song) {
@@ -168,48 +194,127 @@ quint64 AlbumCoverLoader::LoadImageAsync(const AlbumCoverLoaderOptions &options,
 
 }
 
+QString AlbumCoverLoader::TaskKey(const Task &task) {
+
+  // Tasks for an image that is already loaded only scale the image, there is nothing to share.
+  if (task.album_cover.is_valid() || !task.album_cover.image.isNull()) return QString();
+
+  QStringList key;
+  key << QString::number(task.options.options.toInt())
+      << QString::number(task.options.desired_scaled_size.width())
+      << QString::number(task.options.desired_scaled_size.height())
+      << QString::number(task.options.device_pixel_ratio)
+      << task.options.default_cover;
+  for (const AlbumCoverLoaderOptions::Type type : task.options.types) {
+    key << QString::number(static_cast<int>(type));
+  }
+  key << QString::number(task.art_embedded)
+      << task.art_automatic.toString()
+      << task.art_manual.toString()
+      << QString::number(task.art_unset)
+      << QString::number(static_cast<int>(task.song_source));
+
+  // Embedded covers are read from the song, and songs without a cover set might get a different one from their directory.
+  if (task.art_embedded || (!task.art_automatic.isValid() && !task.art_manual.isValid())) {
+    key << task.song_url.toString();
+  }
+
+  return key.join(u'\n');
+
+}
+
 quint64 AlbumCoverLoader::EnqueueTask(TaskPtr task) {
 
-  {
-    QMutexLocker l(&mutex_load_image_async_);
-    task->id = load_image_async_id_++;
-    tasks_.enqueue(task);
+  task->key = TaskKey(*task);
+  const AlbumCoverLoaderOptions::Priority priority = task->options.priority;
+
+  QMutexLocker l(&mutex_load_image_async_);
+
+  const quint64 id = load_image_async_id_++;
+
+  if (!task->key.isEmpty() && tasks_by_key_.contains(task->key)) {
+    TaskPtr existing_task = tasks_by_key_.value(task->key);
+    existing_task->coalesced_ids << id;
+    if (priority > existing_task->options.priority) {
+      // Move the queued task up, if it's already being processed there is nothing to do.
+      const qsizetype removed = tasks_[existing_task->options.priority].removeAll(existing_task);
+      existing_task->options.priority = priority;
+      if (removed > 0) {
+        tasks_[priority].enqueue(existing_task);
+      }
+    }
+    return id;
+  }
+
+  task->id = id;
+  tasks_[priority].enqueue(task);
+  if (!task->key.isEmpty()) {
+    tasks_by_key_.insert(task->key, task);
   }
 
-  QMetaObject::invokeMethod(this, &AlbumCoverLoader::StartProcessTasks, Qt::QueuedConnection);
+  const int max_workers = priority == AlbumCoverLoaderOptions::Priority::CurrentSong ? thread_pool_->maxThreadCount() : thread_pool_->maxThreadCount() - 1;
+  if (workers_ >= max_workers) return id;
+  ++workers_;
 
-  return task->id;
+  thread_pool_->start([this]() { ProcessTasks(); });
+
+  return id;
 
 }
 
-void AlbumCoverLoader::StartProcessTasks() {
+qsizetype AlbumCoverLoader::QueuedTasks() const {
+
+  QMutexLocker l(&mutex_load_image_async_);
 
-  if (!timer_process_tasks_->isActive()) {
-    timer_process_tasks_->start();
+  qsizetype count = 0;
+  for (const QQueue<TaskPtr> &tasks : tasks_) {
+    count += tasks.count();
   }
 
+  return count;
+
 }
 
-void AlbumCoverLoader::ProcessTasks() {
+AlbumCoverLoader::TaskPtr AlbumCoverLoader::DequeueTask() {
 
-  TaskPtr task;
-  {
-    QMutexLocker l(&mutex_load_image_async_);
-    if (tasks_.isEmpty()) {
-      if (timer_process_tasks_->isActive()) {
-        timer_process_tasks_->stop();
-      }
-      return;
+  QMutexLocker l(&mutex_load_image_async_);
+
+  // Highest priority first, the thread reserved for the current song doesn't take anything else.
+  for (QMap<AlbumCoverLoaderOptions::Priority, QQueue<TaskPtr>>::iterator it = tasks_.end(); it != tasks_.begin();) {
+    --it;
+    if (it.key() != AlbumCoverLoaderOptions::Priority::CurrentSong && workers_ >= thread_pool_->maxThreadCount()) break;
+    if (!it.value().isEmpty()) {
+      return it.value().dequeue();
     }
-    task = tasks_.dequeue();
   }
 
-  ProcessTask(task);
+  --workers_;
+
+  return TaskPtr();
+
+}
+
+void AlbumCoverLoader::ProcessTasks() {
+
+  while (TaskPtr task = DequeueTask()) {
+    if (stop_requested_.value()) continue;
+    ProcessTask(task);
+  }
+
+}
+
+void AlbumCoverLoader::ProcessTaskAsync(TaskPtr task) {
+
+  if (stop_requested_.value()) return;
+
+  thread_pool_->start([this, task]() { ProcessTask(task); });
 
 }
 
 void AlbumCoverLoader::ProcessTask(TaskPtr task) {
 
+  qTraceScope("AlbumCoverLoader::ProcessTask");
+
   // If we have album cover already, only do scale and pad.
   if (task->album_cover.is_valid()) {
     task->success = true;
@@ -242,6 +347,15 @@ void AlbumCoverLoader::ProcessTask(TaskPtr task) {
 
 void AlbumCoverLoader::FinishTask(TaskPtr task, const AlbumCoverLoaderResult::Type result_type) {
 
+  QList<quint64> ids;
+  {
+    QMutexLocker l(&mutex_load_image_async_);
+    if (!task->key.isEmpty() && tasks_by_key_.value(task->key) == task) {
+      tasks_by_key_.remove(task->key);
+    }
+    ids << task->id << task->coalesced_ids;
+  }
+
   QImage image_scaled;
   if (!task->album_cover.image_data.isEmpty() && !task->album_cover.image.isNull()) {
     task->result_type = result_type;
@@ -257,7 +371,32 @@ void AlbumCoverLoader::FinishTask(TaskPtr task, const AlbumCoverLoaderResult::Ty
     }
   }
 
-  Q_EMIT AlbumCoverLoaded(task->id, AlbumCoverLoaderResult(task->success, task->result_type, task->album_cover, image_scaled, task->art_manual_updated, task->art_automatic_updated));
+  const AlbumCoverLoaderResult result(task->success, task->result_type, task->album_cover, image_scaled, task->art_manual_updated, task->art_automatic_updated);
+  for (const quint64 id : std::as_const(ids)) {
+    Q_EMIT AlbumCoverLoaded(id, result);
+  }
+
+}
+
+bool AlbumCoverLoader::DecodeImageData(TaskPtr task) {
+
+  QBuffer buffer(&task->album_cover.image_data);
+  if (!buffer.open(QIODevice::ReadOnly)) return false;
+
+  QImageReader reader(&buffer);
+
+  // When only the scaled image is needed, let the image reader decode directly to the size we scale to, JPEG images are then decoded at a reduced size.
+  if (task->scaled_image() && !task->original_image()) {
+    const QSize image_size = reader.size();
+    const QSize scale_size(static_cast<int>(task->options.desired_scaled_size.width() * task->options.device_pixel_ratio), static_cast<int>(task->options.desired_scaled_size.height() * task->options.device_pixel_ratio));
+    if (image_size.isValid() && !scale_size.isEmpty() && (image_size.width() > scale_size.width() || image_size.height() > scale_size.height())) {
+      reader.setScaledSize(image_size.scaled(scale_size, Qt::KeepAspectRatio));
+    }
+  }
+
+  task->album_cover.image = reader.read();
+
+  return !task->album_cover.image.isNull();
 
 }
 
@@ -321,7 +460,7 @@ AlbumCoverLoader::LoadImageResult AlbumCoverLoader::LoadEmbeddedImage(TaskPtr ta
 
   if (task->art_embedded && task->song_url.isValid() && task->song_url.isLocalFile()) {
     const TagReaderResult result = tagreader_client_->LoadCoverDataBlocking(task->song_url.toLocalFile(), task->album_cover.image_data);
-    if (result.success() && !task->album_cover.image_data.isEmpty() && task->album_cover.image.loadFromData(task->album_cover.image_data)) {
+    if (result.success() && !task->album_cover.image_data.isEmpty() && DecodeImageData(task)) {
       return LoadImageResult(AlbumCoverLoaderResult::Type::Embedded, LoadImageResult::Status::Success);
     }
   }
@@ -336,7 +475,7 @@ AlbumCoverLoader::LoadImageResult AlbumCoverLoader::LoadUrlImage(TaskPtr task, c
     if (cover_url.isLocalFile()) {
       return LoadLocalUrlImage(task, result_type, cover_url);
     }
-    if (network_->supportedSchemes().contains(cover_url.scheme())) {
+    if (network_schemes_.contains(cover_url.scheme())) {
       return LoadRemoteUrlImage(task, result_type, cover_url);
     }
   }
@@ -384,7 +523,7 @@ AlbumCoverLoader::LoadImageResult AlbumCoverLoader::LoadLocalFileImage(TaskPtr t
     return LoadImageResult(result_type, LoadImageResult::Status::Failure);
   }
 
-  if (!task->album_cover.image.loadFromData(task->album_cover.image_data)) {
+  if (!DecodeImageData(task)) {
     qLog(Error) << "Failed to load image from cover file" << cover_file << ":" << file.errorString();
     return LoadImageResult(result_type, LoadImageResult::Status::Failure);
   }
@@ -395,6 +534,15 @@ AlbumCoverLoader::LoadImageResult AlbumCoverLoader::LoadLocalFileImage(TaskPtr t
 
 AlbumCoverLoader::LoadImageResult AlbumCoverLoader::LoadRemoteUrlImage(TaskPtr task, const AlbumCoverLoaderResult::Type result_type, const QUrl &cover_url) {
 
+  // The network access manager lives in the loader thread, the task is continued in the thread pool when the reply is finished.
+  QMetaObject::invokeMethod(this, [this, task, result_type, cover_url]() { GetRemoteImage(task, result_type, cover_url); }, Qt::QueuedConnection);
+
+  return LoadImageResult(result_type, LoadImageResult::Status::Async);
+
+}
+
+void AlbumCoverLoader::GetRemoteImage(TaskPtr task, const AlbumCoverLoaderResult::Type result_type, const QUrl &cover_url) {
+
   qLog(Debug) << "Loading remote cover from URL" << cover_url;
 
   QNetworkRequest network_request(cover_url);
@@ -402,8 +550,6 @@ AlbumCoverLoader::LoadImageResult AlbumCoverLoader::LoadRemoteUrlImage(TaskPtr t
   QNetworkReply *reply = network_->get(network_request);
   QObject::connect(reply, &QNetworkReply::finished, this, [this, reply, task, result_type, cover_url]() { LoadRemoteImageFinished(reply, task, result_type, cover_url); });
 
-  return LoadImageResult(result_type, LoadImageResult::Status::Async);
-
 }
 
 void AlbumCoverLoader::LoadRemoteImageFinished(QNetworkReply *reply, TaskPtr task, const AlbumCoverLoaderResult::Type result_type, const QUrl &cover_url) {
@@ -413,7 +559,7 @@ void AlbumCoverLoader::LoadRemoteImageFinished(QNetworkReply *reply, TaskPtr tas
   QVariant redirect = reply->attribute(QNetworkRequest::RedirectionTargetAttribute);
   if (redirect.isValid() && redirect.metaType().id() == QMetaType::QUrl) {
     if (task->redirects++ >= kMaxRedirects) {
-      ProcessTask(task);
+      ProcessTaskAsync(task);
       return;
     }
     const QUrl redirect_url = redirect.toUrl();
@@ -422,25 +568,29 @@ void AlbumCoverLoader::LoadRemoteImageFinished(QNetworkReply *reply, TaskPtr tas
     network_request.setAttribute(QNetworkRequest::RedirectPolicyAttribute, QNetworkRequest::NoLessSafeRedirectPolicy);
     network_request.setUrl(redirect_url);
     QNetworkReply *redirected_reply = network_->get(network_request);
-    QObject::connect(redirected_reply, &QNetworkReply::finished, this, [this, reply, task, result_type, redirect_url]() { LoadRemoteImageFinished(reply, task, result_type, redirect_url); });
+    QObject::connect(redirected_reply, &QNetworkReply::finished, this, [this, redirected_reply, task, result_type, redirect_url]() { LoadRemoteImageFinished(redirected_reply, task, result_type, redirect_url); });
     return;
   }
 
-  if (reply->error() == QNetworkReply::NoError) {
-    task->album_cover.image_data = reply->readAll();
-    if (!task->album_cover.image_data.isEmpty() && task->album_cover.image.loadFromData(task->album_cover.image_data)) {
+  if (reply->error() != QNetworkReply::NoError) {
+    qLog(Error) << "Unable to get album cover from URL" << cover_url << reply->error() << reply->errorString();
+    ProcessTaskAsync(task);
+    return;
+  }
+
+  if (stop_requested_.value()) return;
+
+  // Decode the image in the thread pool.
+  const QByteArray image_data = reply->readAll();
+  thread_pool_->start([this, task, result_type, cover_url, image_data]() {
+    task->album_cover.image_data = image_data;
+    if (!task->album_cover.image_data.isEmpty() && DecodeImageData(task)) {
       task->success = true;
       FinishTask(task, result_type);
       return;
     }
-    else {
-      qLog(Error) << "Unable to load album cover image from URL" << cover_url;
-    }
-  }
-  else {
-    qLog(Error) << "Unable to get album cover from URL" << cover_url << reply->error() << reply->errorString();
-  }
-
-  ProcessTask(task);
+    qLog(Error) << "Unable to load album cover image from URL" << cover_url;
+    ProcessTask(task);
+  });
 
 }
@@ -25,21 +25,25 @@
 #include <QtGlobal>
 #include <QObject>
 #include <QMutex>
+#include <QList>
 #include <QSet>
+#include <QMap>
 #include <QHash>
 #include <QQueue>
 #include <QByteArray>
 #include <QString>
+#include <QStringList>
 #include <QImage>
 
 #include "includes/shared_ptr.h"
+#include "includes/mutex_protected.h"
 #include "core/song.h"
 #include "albumcoverloaderoptions.h"
 #include "albumcoverloaderresult.h"
 #include "albumcoverimageresult.h"
 
 class QThread;
-class QTimer;
+class QThreadPool;
 class QNetworkReply;
 class NetworkAccessManager;
 class TagReaderClient;
@@ -61,6 +65,8 @@ class AlbumCoverLoader : public QObject {
   void CancelTask(const quint64 id);
   void CancelTasks(const QSet<quint64> &ids);
 
+  qsizetype QueuedTasks() const;
+
  Q_SIGNALS:
   void ExitFinished();
   void AlbumCoverLoaded(const quint64 id, const AlbumCoverLoaderResult &result);
@@ -71,6 +77,9 @@ class AlbumCoverLoader : public QObject {
     explicit Task() : id(0), success(false), art_embedded(false), art_unset(false), song_source(Song::Source::Unknown), result_type(AlbumCoverLoaderResult::Type::None), redirects(0) {}
 
     quint64 id;
+    // Requests for the same cover made while this task is queued or running, they receive the same result.
+    QList<quint64> coalesced_ids;
+    QString key;
     bool success;
 
     AlbumCoverLoaderOptions options;
@@ -108,8 +117,13 @@ class AlbumCoverLoader : public QObject {
   };
 
  private:
+  static QString TaskKey(const Task &task);
   quint64 EnqueueTask(TaskPtr task);
+  TaskPtr DequeueTask();
+  void ProcessTasks();
   void ProcessTask(TaskPtr task);
+  void ProcessTaskAsync(TaskPtr task);
+  bool DecodeImageData(TaskPtr task);
   void InitArt(TaskPtr task);
   LoadImageResult LoadImage(TaskPtr task, const AlbumCoverLoaderOptions::Type type);
   LoadImageResult LoadEmbeddedImage(TaskPtr task);
@@ -121,17 +135,19 @@ class AlbumCoverLoader : public QObject {
 
  private Q_SLOTS:
   void Exit();
-  void StartProcessTasks();
-  void ProcessTasks();
+  void GetRemoteImage(AlbumCoverLoader::TaskPtr task, const AlbumCoverLoaderResult::Type result_type, const QUrl &cover_url);
   void LoadRemoteImageFinished(QNetworkReply *reply, AlbumCoverLoader::TaskPtr task, const AlbumCoverLoaderResult::Type result_type, const QUrl &cover_url);
 
  private:
   const SharedPtr<TagReaderClient> tagreader_client_;
   const SharedPtr<NetworkAccessManager> network_;
-  QTimer *timer_process_tasks_;
-  bool stop_requested_;
-  QMutex mutex_load_image_async_;
-  QQueue<TaskPtr> tasks_;
+  const QStringList network_schemes_;
+  QThreadPool *thread_pool_;
+  mutex_protected<bool> stop_requested_;
+  mutable QMutex mutex_load_image_async_;
+  QMap<AlbumCoverLoaderOptions::Priority, QQueue<TaskPtr>> tasks_;
+  QHash<QString, TaskPtr> tasks_by_key_;
+  int workers_;
   quint64 load_image_async_id_;
   QThread *original_thread_;
 };
@@ -30,7 +30,8 @@ AlbumCoverLoaderOptions::AlbumCoverLoaderOptions(const Options _options, const Q
     : options(_options),
       desired_scaled_size(_desired_scaled_size),
       device_pixel_ratio(_device_pixel_ratio),
-      types(_types) {}
+      types(_types),
+      priority(Priority::Collection) {}
 
 AlbumCoverLoaderOptions::Types AlbumCoverLoaderOptions::LoadTypes() {
 
@@ -43,6 +43,15 @@ class AlbumCoverLoaderOptions {
   };
   using Types = QList<Type>;
 
+  // Order in which queued tasks are processed, highest first.
+  enum class Priority {
+    Prefetch,
+    Viewport,
+    CoverManager,
+    Collection,
+    CurrentSong
+  };
+
   explicit AlbumCoverLoaderOptions(const Options _options = AlbumCoverLoaderOptions::Option::ScaledImage, const QSize _desired_scaled_size = QSize(32, 32), const qreal device_pixel_ratio = 1.0F, const Types &_types = QList<AlbumCoverLoaderOptions::Type>() << AlbumCoverLoaderOptions::Type::Embedded << AlbumCoverLoaderOptions::Type::Automatic << AlbumCoverLoaderOptions::Type::Manual);
 
   Options options;
@@ -50,6 +59,7 @@ class AlbumCoverLoaderOptions {
   qreal device_pixel_ratio;
   Types types;
   QString default_cover;
+  Priority priority;
 
   static Types LoadTypes();
 };
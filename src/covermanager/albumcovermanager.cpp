@@ -60,6 +60,7 @@
 #include <QSettings>
 #include <QFlags>
 #include <QSize>
+#include <QRect>
 #include <QtEvents>
 
 #include "includes/scoped_ptr.h"
@@ -102,6 +103,10 @@ using std::make_shared;
 namespace {
 constexpr char kSettingsGroup[] = "CoverManager";
 constexpr int kThumbnailSize = 120;
+// Covers are loaded for the visible items and one page above and below.
+constexpr int kCoverLoadPages = 1;
+// Loaded covers further away than this many pages are released.
+constexpr int kCoverKeepPages = 3;
 }  // namespace
 
 AlbumCoverManager::AlbumCoverManager(const SharedPtr<NetworkAccessManager> network,
@@ -142,9 +147,10 @@ AlbumCoverManager::AlbumCoverManager(const SharedPtr<NetworkAccessManager> netwo
   ui_->setupUi(this);
   ui_->albums->set_cover_manager(this);
 
-  timer_album_cover_load_->setSingleShot(false);
-  timer_album_cover_load_->setInterval(10ms);
+  timer_album_cover_load_->setSingleShot(true);
+  timer_album_cover_load_->setInterval(50ms);
   QObject::connect(timer_album_cover_load_, &QTimer::timeout, this, &AlbumCoverManager::LoadAlbumCovers);
+  QObject::connect(ui_->albums, &AlbumCoverManagerList::ViewportChanged, this, &AlbumCoverManager::QueueLoadAlbumCovers);
 
   // Icons
   ui_->action_fetch->setIcon(IconLoader::Load(u"download"_s));
@@ -333,7 +339,9 @@ void AlbumCoverManager::SaveSettings() {
 void AlbumCoverManager::CancelRequests() {
 
   albumcover_loader_->CancelTasks(QSet<quint64>(cover_loading_tasks_.keyBegin(), cover_loading_tasks_.keyEnd()));
-  cover_loading_pending_.clear();
+  for (AlbumItem *album_item : std::as_const(cover_loading_tasks_)) {
+    album_item->cover_load_id = 0;
+  }
   cover_loading_tasks_.clear();
   cover_save_tasks_.clear();
 
@@ -388,9 +396,9 @@ void AlbumCoverManager::ArtistChanged(QListWidgetItem *current) {
 
   if (!current) return;
 
+  CancelRequests();
   ui_->albums->clear();
   context_menu_items_.clear();
-  CancelRequests();
 
   // Get the list of albums.  How we do it depends on what thing we have selected in the artist list.
   CollectionBackend::AlbumList albums;
@@ -439,19 +447,15 @@ void AlbumCoverManager::ArtistChanged(QListWidgetItem *current) {
     album_item->setData(Role_ArtManual, album_info.art_manual);
     album_item->setData(Role_ArtUnset, album_info.art_unset);
 
-    if (album_info.art_embedded || !album_info.art_automatic.isEmpty() || !album_info.art_manual.isEmpty()) {
-      QueueAlbumCoverLoad(album_item);
-    }
-
   }
 
+  // Covers are only loaded for the items in view, see LoadAlbumCovers().
   UpdateFilter();
+  QueueLoadAlbumCovers();
 
 }
 
-void AlbumCoverManager::QueueAlbumCoverLoad(AlbumItem *album_item) {
-
-  cover_loading_pending_.enqueue(album_item);
+void AlbumCoverManager::QueueLoadAlbumCovers() {
 
   if (!timer_album_cover_load_->isActive()) {
     timer_album_cover_load_->start();
@@ -461,25 +465,82 @@ void AlbumCoverManager::QueueAlbumCoverLoad(AlbumItem *album_item) {
 
 void AlbumCoverManager::LoadAlbumCovers() {
 
-  if (cover_loading_pending_.isEmpty()) {
-    if (timer_album_cover_load_->isActive()) {
-      timer_album_cover_load_->stop();
+  const QRect viewport_rect = ui_->albums->viewport()->rect();
+  if (!ui_->albums->isVisible() || viewport_rect.isEmpty()) return;
+
+  const int page_height = viewport_rect.height();
+  const QRect load_rect = viewport_rect.adjusted(0, -page_height * kCoverLoadPages, 0, page_height * kCoverLoadPages);
+  const QRect keep_rect = viewport_rect.adjusted(0, -page_height * kCoverKeepPages, 0, page_height * kCoverKeepPages);
+
+  QList<AlbumItem*> load_visible;
+  QList<AlbumItem*> load_nearby;
+  QSet<quint64> cancel_ids;
+
+  for (int i = 0; i < ui_->albums->count(); ++i) {
+    AlbumItem *album_item = static_cast<AlbumItem*>(ui_->albums->item(i));
+    const QRect item_rect = album_item->isHidden() ? QRect() : ui_->albums->visualItemRect(album_item);
+
+    if (item_rect.isValid() && item_rect.intersects(load_rect)) {
+      if (!album_item->cover_loaded && album_item->cover_load_id == 0 && ItemHasArt(*album_item)) {
+        if (item_rect.intersects(viewport_rect)) {
+          load_visible << album_item;
+        }
+        else {
+          load_nearby << album_item;
+        }
+      }
+      continue;
+    }
+
+    // Scrolled out of view, cancel the request.
+    if (album_item->cover_load_id != 0) {
+      cancel_ids << album_item->cover_load_id;
+      cover_loading_tasks_.remove(album_item->cover_load_id);
+      album_item->cover_load_id = 0;
     }
-    return;
+
+    // Release covers far out of view, the placeholder of albums without a cover is kept.
+    if (album_item->cover_loaded && ItemHasCover(*album_item) && !item_rect.intersects(keep_rect)) {
+      album_item->setIcon(icon_nocover_item_);
+      album_item->cover_loaded = false;
+    }
+  }
+
+  if (!cancel_ids.isEmpty()) {
+    albumcover_loader_->CancelTasks(cancel_ids);
+  }
+
+  for (AlbumItem *album_item : std::as_const(load_visible)) {
+    LoadAlbumCoverAsync(album_item);
   }
+  for (AlbumItem *album_item : std::as_const(load_nearby)) {
+    LoadAlbumCoverAsync(album_item);
+  }
+
+}
+
+void AlbumCoverManager::CancelAlbumCoverLoad(AlbumItem *album_item) {
+
+  if (album_item->cover_load_id == 0) return;
 
-  LoadAlbumCoverAsync(cover_loading_pending_.dequeue());
+  albumcover_loader_->CancelTask(album_item->cover_load_id);
+  cover_loading_tasks_.remove(album_item->cover_load_id);
+  album_item->cover_load_id = 0;
 
 }
 
 void AlbumCoverManager::LoadAlbumCoverAsync(AlbumItem *album_item) {
 
+  CancelAlbumCoverLoad(album_item);
+
   AlbumCoverLoaderOptions cover_options(AlbumCoverLoaderOptions::Option::ScaledImage | AlbumCoverLoaderOptions::Option::PadScaledImage);
   cover_options.types = cover_types_;
   cover_options.desired_scaled_size = QSize(kThumbnailSize, kThumbnailSize);
   cover_options.device_pixel_ratio = devicePixelRatioF();
+  cover_options.priority = AlbumCoverLoaderOptions::Priority::CoverManager;
   quint64 cover_load_id = albumcover_loader_->LoadImageAsync(cover_options, album_item->data(Role_ArtEmbedded).toBool(), album_item->data(Role_ArtAutomatic).toUrl(), album_item->data(Role_ArtManual).toUrl(), album_item->data(Role_ArtUnset).toBool(), album_item->urls.constFirst());
   cover_loading_tasks_.insert(cover_load_id, album_item);
+  album_item->cover_load_id = cover_load_id;
 
 }
 
@@ -488,16 +549,20 @@ void AlbumCoverManager::AlbumCoverLoaded(const quint64 id, const AlbumCoverLoade
   if (!cover_loading_tasks_.contains(id)) return;
 
   AlbumItem *album_item = cover_loading_tasks_.take(id);
+  album_item->cover_load_id = 0;
+  album_item->cover_loaded = true;
 
   if (!result.success || result.image_scaled.isNull() || result.type == AlbumCoverLoaderResult::Type::Unset) {
     album_item->setIcon(icon_nocover_item_);
+    // The album was counted as having a cover until now.
+    if (ItemHasArt(*album_item)) {
+      UpdateFilter();
+    }
   }
   else {
     album_item->setIcon(QPixmap::fromImage(result.image_scaled));
   }
 
-  UpdateFilter();
-
 }
 
 void AlbumCoverManager::UpdateFilter() {
@@ -880,7 +945,9 @@ void AlbumCoverManager::UnsetCover() {
   // Force the 'none' cover on all of the selected items
   for (QListWidgetItem *list_widget_item : std::as_const(context_menu_items_)) {
     AlbumItem *album_item = static_cast<AlbumItem*>(list_widget_item);
+    CancelAlbumCoverLoad(album_item);
     album_item->setIcon(icon_nocover_item_);
+    album_item->cover_loaded = true;
     album_item->setData(Role_ArtEmbedded, false);
     album_item->setData(Role_ArtManual, QUrl());
     album_item->setData(Role_ArtAutomatic, QUrl());
@@ -899,7 +966,9 @@ void AlbumCoverManager::ClearCover() {
   // Force the 'none' cover on all of the selected items
   for (QListWidgetItem *list_widget_item : std::as_const(context_menu_items_)) {
     AlbumItem *album_item = static_cast<AlbumItem*>(list_widget_item);
+    CancelAlbumCoverLoad(album_item);
     album_item->setIcon(icon_nocover_item_);
+    album_item->cover_loaded = true;
     album_item->setData(Role_ArtEmbedded, false);
     album_item->setData(Role_ArtAutomatic, QUrl());
     album_item->setData(Role_ArtManual, QUrl());
@@ -917,7 +986,9 @@ void AlbumCoverManager::DeleteCover() {
     AlbumItem *album_item = static_cast<AlbumItem*>(list_widget_item);
     Song song = AlbumItemAsSong(album_item);
     album_cover_choice_controller_->DeleteCover(&song);
+    CancelAlbumCoverLoad(album_item);
     album_item->setIcon(icon_nocover_item_);
+    album_item->cover_loaded = true;
     album_item->setData(Role_ArtEmbedded, false);
     album_item->setData(Role_ArtManual, QUrl());
     album_item->setData(Role_ArtAutomatic, QUrl());
@@ -1102,8 +1173,17 @@ void AlbumCoverManager::UpdateExportStatus(const int exported, const int skipped
 
 }
 
+bool AlbumCoverManager::ItemHasArt(const AlbumItem &album_item) {
+  return !album_item.data(Role_ArtUnset).toBool() && (album_item.data(Role_ArtEmbedded).toBool() || !album_item.data(Role_ArtAutomatic).toUrl().isEmpty() || !album_item.data(Role_ArtManual).toUrl().isEmpty());
+}
+
 bool AlbumCoverManager::ItemHasCover(const AlbumItem &album_item) const {
+
+  // Covers not loaded yet are assumed to be valid.
+  if (!album_item.cover_loaded) return ItemHasArt(album_item);
+
   return album_item.icon().cacheKey() != icon_nocover_item_.cacheKey();
+
 }
 
 void AlbumCoverManager::SaveEmbeddedCoverFinished(TagReaderReplyPtr reply, AlbumItem *album_item, const QUrl &url, const bool art_embedded) {
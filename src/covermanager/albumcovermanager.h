@@ -32,7 +32,6 @@
 #include <QListWidgetItem>
 #include <QMap>
 #include <QMultiMap>
-#include <QQueue>
 #include <QString>
 #include <QImage>
 #include <QIcon>
@@ -70,8 +69,12 @@ class Ui_CoverManager;
 
 class AlbumItem : public QListWidgetItem {
  public:
-  AlbumItem(const QIcon &icon, const QString &text, QListWidget *parent = nullptr, int type = Type) : QListWidgetItem(icon, text, parent, type) {};
+  AlbumItem(const QIcon &icon, const QString &text, QListWidget *parent = nullptr, int type = Type) : QListWidgetItem(icon, text, parent, type), cover_load_id(0), cover_loaded(false) {};
   QList<QUrl> urls;
+  // Id of the pending cover loader request, 0 if none.
+  quint64 cover_load_id;
+  // True when the icon is the result of a cover load, false if it is the placeholder because the cover was not loaded yet or was released.
+  bool cover_loaded;
 
  private:
   Q_DISABLE_COPY(AlbumItem)
@@ -148,8 +151,9 @@ class AlbumCoverManager : public QMainWindow {
   Song AlbumItemAsSong(QListWidgetItem *list_widget_item) { return AlbumItemAsSong(static_cast<AlbumItem*>(list_widget_item)); }
   static Song AlbumItemAsSong(AlbumItem *album_item);
 
-  void QueueAlbumCoverLoad(AlbumItem *album_item);
   void LoadAlbumCoverAsync(AlbumItem *album_item);
+  void CancelAlbumCoverLoad(AlbumItem *album_item);
+  void QueueLoadAlbumCovers();
 
   void UpdateStatusText();
   bool ShouldHide(const AlbumItem &album_item, const QString &filter, const HideCovers hide_covers) const;
@@ -160,6 +164,7 @@ class AlbumCoverManager : public QMainWindow {
   SongList GetSongsInAlbums(const QModelIndexList &indexes) const;
   SongMimeData *GetMimeDataForAlbums(const QModelIndexList &indexes) const;
 
+  static bool ItemHasArt(const AlbumItem &album_item);
   bool ItemHasCover(const AlbumItem &album_item) const;
 
  Q_SIGNALS:
@@ -215,7 +220,6 @@ class AlbumCoverManager : public QMainWindow {
   QAction *filter_with_covers_;
   QAction *filter_without_covers_;
 
-  QQueue<AlbumItem*> cover_loading_pending_;
   QMap<quint64, AlbumItem*> cover_loading_tasks_;
 
   AlbumCoverFetcher *cover_fetcher_;
@@ -71,3 +71,18 @@ QMimeData *AlbumCoverManagerList::mimeData(const QList<QListWidgetItem*> &items)
   return mime_data;
 
 }
+
+void AlbumCoverManagerList::scrollContentsBy(const int dx, const int dy) {
+
+  QListWidget::scrollContentsBy(dx, dy);
+  Q_EMIT ViewportChanged();
+
+}
+
+void AlbumCoverManagerList::updateGeometries() {
+
+  // Called after the items are laid out, on resize and when items are added, removed or hidden.
+  QListWidget::updateGeometries();
+  Q_EMIT ViewportChanged();
+
+}
@@ -43,10 +43,16 @@ class AlbumCoverManagerList : public QListWidget {
 
   void set_cover_manager(AlbumCoverManager *manager) { manager_ = manager; }
 
+ Q_SIGNALS:
+  // Emitted when the items shown in the viewport may have changed.
+  void ViewportChanged();
+
  protected:
   QMimeData *mimeData(const QList<QListWidgetItem*> &items) const override;
 
   void dropEvent(QDropEvent*) override {}
+  void scrollContentsBy(const int dx, const int dy) override;
+  void updateGeometries() override;
 
  private:
   AlbumCoverManager *manager_;
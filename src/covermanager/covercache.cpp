@@ -0,0 +1,510 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "config.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+#include <QtGlobal>
+#include <QObject>
+#include <QCache>
+#include <QHash>
+#include <QList>
+#include <QString>
+#include <QSize>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QDataStream>
+#include <QImage>
+#include <QPixmap>
+#include <QTimer>
+
+#include "core/logging.h"
+#include "covercache.h"
+
+using namespace std::literals::chrono_literals;
+using namespace Qt::Literals::StringLiterals;
+
+namespace {
+constexpr char kAtlasFilename[] = "atlas";
+constexpr char kIndexFilename[] = "index";
+constexpr quint32 kIndexMagic = 0x53424354;
+constexpr quint32 kIndexVersion = 2;
+constexpr qsizetype kAtlasGrowSlots = 256;
+// Every slot starts with the hash of the key, so a slot that was overwritten after the index was last saved is not mistaken for another cover.
+constexpr qint64 kSlotHeaderBytes = sizeof(quint64);
+// Compressed slots store the length of the data after the key hash.
+constexpr qint64 kSlotLengthBytes = sizeof(quint32);
+// Compressed slots are this many times smaller than raw slots.
+constexpr qint64 kLosslessSlotRatio = 2;
+constexpr qint64 kLossySlotRatio = 4;
+}  // namespace
+
+CoverCache::CoverCache(const QString &cache_directory, const QSize &thumbnail_size, QObject *parent)
+    : QObject(parent),
+      cache_directory_(cache_directory),
+      thumbnail_size_(thumbnail_size),
+      timer_save_index_(new QTimer(this)),
+      disk_cache_enabled_(false),
+      disk_cache_format_(ImageUtils::ThumbnailFormat::Raw),
+      disk_cache_quality_(-1),
+      atlas_max_slots_(1),
+      atlas_data_(nullptr),
+      atlas_capacity_(0),
+      atlas_next_slot_(0),
+      index_dirty_(false),
+      memory_hits_(0),
+      disk_hits_(0),
+      misses_(0) {
+
+  atlas_file_.setFileName(cache_directory_ + u'/' + QLatin1String(kAtlasFilename));
+
+  timer_save_index_->setSingleShot(true);
+  timer_save_index_->setInterval(10s);
+  QObject::connect(timer_save_index_, &QTimer::timeout, this, &CoverCache::SaveIndex);
+
+}
+
+CoverCache::~CoverCache() {
+
+  CloseAtlas();
+
+}
+
+QString CoverCache::MemoryKey(const QString &key, const QSize &size) {
+
+  return key + u'\n' + QString::number(size.width()) + u'x' + QString::number(size.height());
+
+}
+
+qint64 CoverCache::SlotBytes() const {
+
+  if (disk_cache_format_ == ImageUtils::ThumbnailFormat::Raw) {
+    return kSlotHeaderBytes + SlotDataBytes();
+  }
+
+  return kSlotHeaderBytes + kSlotLengthBytes + SlotDataBytes();
+
+}
+
+qint64 CoverCache::SlotDataBytes() const {
+
+  const qint64 raw_bytes = static_cast<qint64>(thumbnail_size_.width()) * thumbnail_size_.height() * 4;
+
+  switch (disk_cache_format_) {
+    case ImageUtils::ThumbnailFormat::Raw:
+      return raw_bytes;
+    case ImageUtils::ThumbnailFormat::PNG:
+      return raw_bytes / kLosslessSlotRatio;
+    default:
+      return raw_bytes / kLossySlotRatio;
+  }
+
+}
+
+void CoverCache::SetMemoryCacheSize(const qint64 bytes) {
+
+  memory_cache_.setMaxCost(static_cast<qsizetype>(bytes));
+
+}
+
+void CoverCache::TrimMemoryCache(const qint64 bytes) {
+
+  const qsizetype max_cost = memory_cache_.maxCost();
+  if (bytes >= memory_cache_.totalCost()) return;
+
+  memory_cache_.setMaxCost(static_cast<qsizetype>(bytes));
+  memory_cache_.setMaxCost(max_cost);
+
+}
+
+void CoverCache::SetDiskCacheEnabled(const bool enabled) {
+
+  disk_cache_enabled_ = enabled;
+
+  if (!disk_cache_enabled_) {
+    CloseAtlas();
+  }
+
+}
+
+void CoverCache::SetDiskCacheSize(const qint64 bytes) {
+
+  atlas_max_slots_ = std::max<qsizetype>(1, static_cast<qsizetype>(bytes / SlotBytes()));
+
+  if (atlas_slot_keys_.size() > atlas_max_slots_) {
+    for (qsizetype slot = atlas_max_slots_; slot < atlas_slot_keys_.size(); ++slot) {
+      atlas_index_.remove(atlas_slot_keys_[slot]);
+    }
+    atlas_slot_keys_.resize(atlas_max_slots_);
+    index_dirty_ = true;
+    if (atlas_data_ && !ResizeAtlas(atlas_max_slots_)) {
+      CloseAtlas();
+      disk_cache_enabled_ = false;
+    }
+  }
+  atlas_next_slot_ %= atlas_max_slots_;
+
+}
+
+void CoverCache::SetDiskCacheFormat(const ImageUtils::ThumbnailFormat format, const int quality) {
+
+  disk_cache_quality_ = quality;
+
+  const ImageUtils::ThumbnailFormat new_format = ImageUtils::ThumbnailFormatIsSupported(format) ? format : ImageUtils::ThumbnailFormat::Raw;
+  if (new_format == disk_cache_format_) return;
+
+  // The index saved for the old format is discarded when the atlas is opened again.
+  const qint64 disk_cache_bytes = atlas_max_slots_ * SlotBytes();
+  CloseAtlas();
+  disk_cache_format_ = new_format;
+  SetDiskCacheSize(disk_cache_bytes);
+
+}
+
+qint64 CoverCache::disk_cache_size() const {
+
+  if (atlas_file_.isOpen()) return atlas_file_.size();
+
+  return QFileInfo(atlas_file_.fileName()).size();
+
+}
+
+bool CoverCache::Contains(const QString &key, const QSize &size) {
+
+  if (memory_cache_.contains(MemoryKey(key, size))) return true;
+
+  return disk_cache_enabled_ && size == thumbnail_size_ && OpenAtlas() && atlas_index_.contains(key);
+
+}
+
+bool CoverCache::Find(const QString &key, const QSize &size, QPixmap *pixmap) {
+
+  if (QPixmap *cached_pixmap = memory_cache_.object(MemoryKey(key, size))) {
+    *pixmap = *cached_pixmap;
+    ++memory_hits_;
+    return true;
+  }
+
+  if (FindInAtlas(key, size, pixmap)) {
+    ++disk_hits_;
+    return true;
+  }
+
+  ++misses_;
+
+  return false;
+
+}
+
+CoverCache::Statistics CoverCache::statistics() const {
+
+  Statistics statistics {};
+  statistics.memory_bytes = memory_cache_.totalCost();
+  statistics.memory_limit = memory_cache_.maxCost();
+  statistics.disk_bytes = disk_cache_enabled_ ? disk_cache_size() : 0;
+  statistics.memory_hits = memory_hits_;
+  statistics.disk_hits = disk_hits_;
+  statistics.misses = misses_;
+
+  return statistics;
+
+}
+
+bool CoverCache::FindInAtlas(const QString &key, const QSize &size, QPixmap *pixmap) {
+
+  if (!disk_cache_enabled_ || size != thumbnail_size_ || !OpenAtlas()) return false;
+
+  const qsizetype slot = atlas_index_.value(key, -1);
+  if (slot < 0) return false;
+
+  quint64 key_hash = 0;
+  memcpy(&key_hash, atlas_data_ + (slot * SlotBytes()), sizeof(key_hash));
+  if (key_hash != qHash(key)) {
+    atlas_index_.remove(key);
+    atlas_slot_keys_[slot].clear();
+    ScheduleSaveIndex();
+    return false;
+  }
+
+  const QImage image = AtlasImage(slot);
+  if (image.isNull()) {
+    atlas_index_.remove(key);
+    atlas_slot_keys_[slot].clear();
+    ScheduleSaveIndex();
+    return false;
+  }
+
+  *pixmap = QPixmap::fromImage(image);
+  Insert(key, size, *pixmap);
+
+  return true;
+
+}
+
+void CoverCache::Insert(const QString &key, const QSize &size, const QPixmap &pixmap) {
+
+  memory_cache_.insert(MemoryKey(key, size), new QPixmap(pixmap), static_cast<qsizetype>(pixmap.width()) * pixmap.height() * pixmap.depth() / 8);
+
+}
+
+void CoverCache::Store(const QString &key, const QSize &size, const QImage &image) {
+
+  Insert(key, size, QPixmap::fromImage(image));
+
+  if (!disk_cache_enabled_ || size != thumbnail_size_ || image.size() != thumbnail_size_ || !OpenAtlas()) return;
+
+  QByteArray data;
+  if (disk_cache_format_ != ImageUtils::ThumbnailFormat::Raw) {
+    data = ImageUtils::EncodeThumbnail(image, disk_cache_format_, disk_cache_quality_);
+    // Covers that don't compress well enough for a slot are only kept in memory.
+    if (data.isEmpty() || data.size() > SlotDataBytes()) return;
+  }
+
+  qsizetype slot = atlas_index_.value(key, -1);
+  if (slot < 0) {
+    slot = atlas_next_slot_;
+    if (slot >= atlas_capacity_ && !ResizeAtlas(std::min(std::max(atlas_capacity_ * 2, kAtlasGrowSlots), atlas_max_slots_))) {
+      CloseAtlas();
+      disk_cache_enabled_ = false;
+      return;
+    }
+    if (slot < atlas_slot_keys_.size()) {
+      atlas_index_.remove(atlas_slot_keys_[slot]);
+      atlas_slot_keys_[slot] = key;
+    }
+    else {
+      atlas_slot_keys_ << key;
+    }
+    atlas_index_.insert(key, slot);
+    atlas_next_slot_ = (slot + 1) % atlas_max_slots_;
+    ScheduleSaveIndex();
+  }
+
+  uchar *slot_data = atlas_data_ + (slot * SlotBytes());
+  const quint64 key_hash = qHash(key);
+
+  if (disk_cache_format_ == ImageUtils::ThumbnailFormat::Raw) {
+    const QImage pixels = image.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+    memcpy(slot_data, &key_hash, sizeof(key_hash));
+    memcpy(slot_data + kSlotHeaderBytes, pixels.constBits(), static_cast<size_t>(SlotDataBytes()));
+    return;
+  }
+
+  const quint32 length = static_cast<quint32>(data.size());
+  memcpy(slot_data, &key_hash, sizeof(key_hash));
+  memcpy(slot_data + kSlotHeaderBytes, &length, sizeof(length));
+  memcpy(slot_data + kSlotHeaderBytes + kSlotLengthBytes, data.constData(), static_cast<size_t>(data.size()));
+
+}
+
+void CoverCache::Remove(const QString &key) {
+
+  const QString prefix = key + u'\n';
+  const QList<QString> memory_keys = memory_cache_.keys();
+  for (const QString &memory_key : memory_keys) {
+    if (memory_key.startsWith(prefix)) {
+      memory_cache_.remove(memory_key);
+    }
+  }
+
+  if (atlas_index_.contains(key)) {
+    atlas_slot_keys_[atlas_index_.take(key)].clear();
+    ScheduleSaveIndex();
+  }
+
+}
+
+void CoverCache::Clear() {
+
+  memory_cache_.clear();
+
+  atlas_index_.clear();
+  atlas_slot_keys_.clear();
+  atlas_next_slot_ = 0;
+
+  if (atlas_file_.isOpen()) {
+    ResizeAtlas(0);
+    index_dirty_ = true;
+    SaveIndex();
+  }
+  else {
+    QFile::remove(atlas_file_.fileName());
+    QFile::remove(cache_directory_ + u'/' + QLatin1String(kIndexFilename));
+  }
+
+}
+
+bool CoverCache::OpenAtlas() {
+
+  if (atlas_file_.isOpen()) return atlas_data_ || atlas_capacity_ == 0;
+
+  if (!QDir().mkpath(cache_directory_)) {
+    qLog(Error) << "Failed to create cover cache directory" << cache_directory_;
+    disk_cache_enabled_ = false;
+    return false;
+  }
+
+  if (!atlas_file_.open(QIODevice::ReadWrite)) {
+    qLog(Error) << "Failed to open cover cache" << atlas_file_.fileName() << atlas_file_.errorString();
+    disk_cache_enabled_ = false;
+    return false;
+  }
+
+  LoadIndex();
+
+  // Apply the current size limit to the loaded index.
+  SetDiskCacheSize(atlas_max_slots_ * SlotBytes());
+
+  if (!ResizeAtlas(atlas_slot_keys_.size())) {
+    CloseAtlas();
+    disk_cache_enabled_ = false;
+    return false;
+  }
+
+  return true;
+
+}
+
+void CoverCache::CloseAtlas() {
+
+  if (!atlas_file_.isOpen()) return;
+
+  timer_save_index_->stop();
+  SaveIndex();
+
+  if (atlas_data_) {
+    atlas_file_.unmap(atlas_data_);
+    atlas_data_ = nullptr;
+  }
+  atlas_capacity_ = 0;
+  atlas_file_.close();
+
+}
+
+bool CoverCache::ResizeAtlas(const qsizetype slots) {
+
+  if (atlas_data_) {
+    atlas_file_.unmap(atlas_data_);
+    atlas_data_ = nullptr;
+  }
+  atlas_capacity_ = 0;
+
+  if (!atlas_file_.resize(slots * SlotBytes())) {
+    qLog(Error) << "Failed to resize cover cache" << atlas_file_.fileName() << atlas_file_.errorString();
+    return false;
+  }
+
+  if (slots == 0) return true;
+
+  atlas_data_ = atlas_file_.map(0, slots * SlotBytes());
+  if (!atlas_data_) {
+    qLog(Error) << "Failed to map cover cache" << atlas_file_.fileName() << atlas_file_.errorString();
+    return false;
+  }
+  atlas_capacity_ = slots;
+
+  return true;
+
+}
+
+void CoverCache::LoadIndex() {
+
+  atlas_index_.clear();
+  atlas_slot_keys_.clear();
+  atlas_next_slot_ = 0;
+
+  QFile file(cache_directory_ + u'/' + QLatin1String(kIndexFilename));
+  if (!file.open(QIODevice::ReadOnly)) return;
+
+  QDataStream s(&file);
+  quint32 magic = 0;
+  quint32 version = 0;
+  s >> magic >> version;
+  if (magic != kIndexMagic || version != kIndexVersion) return;
+
+  QSize size;
+  qint32 format = 0;
+  qint64 next_slot = 0;
+  QList<QString> slot_keys;
+  s >> size >> format >> next_slot >> slot_keys;
+  if (s.status() != QDataStream::Ok || size != thumbnail_size_ || format != static_cast<qint32>(disk_cache_format_) || atlas_file_.size() < slot_keys.size() * SlotBytes()) {
+    return;
+  }
+
+  atlas_slot_keys_ = slot_keys;
+  for (qsizetype slot = 0; slot < atlas_slot_keys_.size(); ++slot) {
+    if (!atlas_slot_keys_[slot].isEmpty()) {
+      atlas_index_.insert(atlas_slot_keys_[slot], slot);
+    }
+  }
+  atlas_next_slot_ = std::clamp<qsizetype>(static_cast<qsizetype>(next_slot), 0, atlas_slot_keys_.size());
+
+}
+
+void CoverCache::SaveIndex() {
+
+  if (!index_dirty_) return;
+
+  QSaveFile file(cache_directory_ + u'/' + QLatin1String(kIndexFilename));
+  if (!file.open(QIODevice::WriteOnly)) {
+    qLog(Error) << "Failed to save cover cache index" << file.fileName() << file.errorString();
+    return;
+  }
+
+  QDataStream s(&file);
+  s << kIndexMagic << kIndexVersion << thumbnail_size_ << static_cast<qint32>(disk_cache_format_) << static_cast<qint64>(atlas_next_slot_) << atlas_slot_keys_;
+  if (file.commit()) {
+    index_dirty_ = false;
+  }
+
+}
+
+void CoverCache::ScheduleSaveIndex() {
+
+  index_dirty_ = true;
+  if (!timer_save_index_->isActive()) {
+    timer_save_index_->start();
+  }
+
+}
+
+QImage CoverCache::AtlasImage(const qsizetype slot) const {
+
+  const uchar *slot_data = atlas_data_ + (slot * SlotBytes()) + kSlotHeaderBytes;
+
+  if (disk_cache_format_ == ImageUtils::ThumbnailFormat::Raw) {
+    // Copy the pixels, the mapping can change when the atlas is resized.
+    return QImage(slot_data, thumbnail_size_.width(), thumbnail_size_.height(), thumbnail_size_.width() * 4, QImage::Format_ARGB32_Premultiplied).copy();
+  }
+
+  quint32 length = 0;
+  memcpy(&length, slot_data, sizeof(length));
+  if (length == 0 || length > SlotDataBytes()) return QImage();
+
+  const QImage image = ImageUtils::DecodeThumbnail(QByteArray::fromRawData(reinterpret_cast<const char*>(slot_data + kSlotLengthBytes), static_cast<qsizetype>(length)), disk_cache_format_);
+  if (image.size() != thumbnail_size_) return QImage();
+
+  return image;
+
+}
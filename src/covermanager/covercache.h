@@ -0,0 +1,120 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef COVERCACHE_H
+#define COVERCACHE_H
+
+#include "config.h"
+
+#include <QtGlobal>
+#include <QObject>
+#include <QCache>
+#include <QHash>
+#include <QList>
+#include <QString>
+#include <QSize>
+#include <QFile>
+#include <QImage>
+#include <QPixmap>
+
+#include "utilities/imageutils.h"
+
+class QTimer;
+
+// Cache for scaled album covers.
+// Decoded pixmaps are kept in memory, keyed by album and size, and evicted least recently used first within a byte budget.
+// Images of the thumbnail size are also stored in fixed size slots of a memory mapped atlas file, as raw pixels that can be loaded again without decoding, or compressed to make the slots smaller.
+// Only to be used from the GUI thread.
+class CoverCache : public QObject {
+  Q_OBJECT
+
+ public:
+  explicit CoverCache(const QString &cache_directory, const QSize &thumbnail_size, QObject *parent = nullptr);
+  ~CoverCache() override;
+
+  void SetMemoryCacheSize(const qint64 bytes);
+  void SetDiskCacheEnabled(const bool enabled);
+  void SetDiskCacheSize(const qint64 bytes);
+  // Changing the format discards the covers stored on disk.
+  void SetDiskCacheFormat(const ImageUtils::ThumbnailFormat format, const int quality);
+
+  qint64 disk_cache_size() const;
+  qint64 memory_cache_size() const { return memory_cache_.totalCost(); }
+
+  // Evicts the least recently used pixmaps from memory until at most bytes are used, the limit stays the same.
+  void TrimMemoryCache(const qint64 bytes);
+
+  bool Contains(const QString &key, const QSize &size);
+  bool Find(const QString &key, const QSize &size, QPixmap *pixmap);
+
+  // Only keeps the pixmap in memory, used for placeholders.
+  void Insert(const QString &key, const QSize &size, const QPixmap &pixmap);
+
+  // Keeps the image in memory and stores it in the atlas if the disk cache is enabled.
+  void Store(const QString &key, const QSize &size, const QImage &image);
+
+  void Remove(const QString &key);
+  void Clear();
+
+  struct Statistics {
+    qint64 memory_bytes;
+    qint64 memory_limit;
+    qint64 disk_bytes;
+    quint64 memory_hits;
+    quint64 disk_hits;
+    quint64 misses;
+  };
+  Statistics statistics() const;
+
+ private:
+  static QString MemoryKey(const QString &key, const QSize &size);
+  bool FindInAtlas(const QString &key, const QSize &size, QPixmap *pixmap);
+  qint64 SlotBytes() const;
+  qint64 SlotDataBytes() const;
+  bool OpenAtlas();
+  void CloseAtlas();
+  bool ResizeAtlas(const qsizetype slots);
+  void LoadIndex();
+  void SaveIndex();
+  void ScheduleSaveIndex();
+  QImage AtlasImage(const qsizetype slot) const;
+
+ private:
+  const QString cache_directory_;
+  const QSize thumbnail_size_;
+  QTimer *timer_save_index_;
+  QCache<QString, QPixmap> memory_cache_;
+  bool disk_cache_enabled_;
+  ImageUtils::ThumbnailFormat disk_cache_format_;
+  int disk_cache_quality_;
+  qsizetype atlas_max_slots_;
+  QFile atlas_file_;
+  uchar *atlas_data_;
+  qsizetype atlas_capacity_;
+  // Key of the cover in each slot, slots are reused in order when the atlas is full.
+  QList<QString> atlas_slot_keys_;
+  QHash<QString, qsizetype> atlas_index_;
+  qsizetype atlas_next_slot_;
+  bool index_dirty_;
+  quint64 memory_hits_;
+  quint64 disk_hits_;
+  quint64 misses_;
+};
+
+#endif  // COVERCACHE_H
@@ -26,9 +26,14 @@
 #include <QFile>
 #include <QSize>
 #include <QString>
+#include <QByteArray>
 #include <QImage>
+#include <QImageReader>
+#include <QBuffer>
+#include <QSemaphore>
 
 #include "core/song.h"
+#include "utilities/mimeutils.h"
 #include "tagreader/tagreaderclient.h"
 #include "albumcoverloaderoptions.h"
 #include "albumcoverexport.h"
@@ -36,12 +41,13 @@
 
 using namespace Qt::Literals::StringLiterals;
 
-CoverExportRunnable::CoverExportRunnable(const SharedPtr<TagReaderClient> tagreader_client, const AlbumCoverExport::DialogResult &dialog_result, const AlbumCoverLoaderOptions::Types &cover_types, const Song &song, QObject *parent)
+CoverExportRunnable::CoverExportRunnable(const SharedPtr<TagReaderClient> tagreader_client, const AlbumCoverExport::DialogResult &dialog_result, const AlbumCoverLoaderOptions::Types &cover_types, const Song &song, QSemaphore *io_semaphore, QObject *parent)
     : QObject(parent),
       tagreader_client_(tagreader_client),
       dialog_result_(dialog_result),
       cover_types_(cover_types),
-      song_(song) {}
+      song_(song),
+      io_semaphore_(io_semaphore) {}
 
 void CoverExportRunnable::run() {
 
@@ -129,10 +135,10 @@ void CoverExportRunnable::ProcessAndExportCover() {
 
     // if the mode is "overwrite smaller" then skip the cover if a bigger one is already available in the folder
     if (dialog_result_.overwrite_ == AlbumCoverExport::OverwriteMode::Smaller) {
-      QImage image_existing;
-      image_existing.load(new_file);
+      // Only the size is needed, so don't decode the existing image.
+      const QSize size_existing = QImageReader(new_file).size();
 
-      if (image_existing.isNull() || image_existing.size().height() >= image.size().height() || image_existing.size().width() >= image.size().width()) {
+      if (!size_existing.isValid() || size_existing.height() >= image.size().height() || size_existing.width() >= image.size().width()) {
         EmitCoverSkipped();
         return;
       }
@@ -144,7 +150,14 @@ void CoverExportRunnable::ProcessAndExportCover() {
     }
   }
 
-  if (image.save(new_file)) {
+  // Encode before taking the I/O semaphore, so the disk is not kept waiting for the CPU.
+  QByteArray image_data;
+  if (!EncodeImage(image, new_file.section(u'.', -1), image_data)) {
+    EmitCoverSkipped();
+    return;
+  }
+
+  if (WriteFile(new_file, image_data)) {
     EmitCoverExported();
   }
   else {
@@ -156,10 +169,9 @@ void CoverExportRunnable::ProcessAndExportCover() {
 // Exports a single album cover using a "copy file" approach.
 void CoverExportRunnable::ExportCover() {
 
-  QImage image;
+  QByteArray embedded_data;
   QString extension;
   QString cover_path;
-  bool embedded_cover = false;
 
   for (const AlbumCoverLoaderOptions::Type cover_type : std::as_const(cover_types_)) {
     switch (cover_type) {
@@ -171,9 +183,8 @@ void CoverExportRunnable::ExportCover() {
         break;
       case AlbumCoverLoaderOptions::Type::Embedded:
         if (song_.art_embedded() && dialog_result_.export_embedded_) {
-          const TagReaderResult result = tagreader_client_->LoadCoverImageBlocking(song_.url().toLocalFile(), image);
-          if (result.success() && !image.isNull()) {
-            embedded_cover = true;
+          const TagReaderResult result = tagreader_client_->LoadCoverDataBlocking(song_.url().toLocalFile(), embedded_data);
+          if (result.success() && !embedded_data.isEmpty()) {
             extension = "jpg"_L1;
           }
         }
@@ -181,28 +192,45 @@ void CoverExportRunnable::ExportCover() {
       case AlbumCoverLoaderOptions::Type::Manual:
         if (dialog_result_.export_downloaded_ && song_.art_manual_is_valid()) {
           cover_path = song_.art_manual().toLocalFile();
-          if (image.load(cover_path)) {
+          // Only check that the file is a readable image, it is copied as is.
+          if (QImageReader(cover_path).canRead()) {
             extension = cover_path.section(u'.', -1);
           }
+          else {
+            cover_path.clear();
+          }
         }
         break;
       case AlbumCoverLoaderOptions::Type::Automatic:
         if (dialog_result_.export_downloaded_ && song_.art_automatic_is_valid()) {
           cover_path = song_.art_automatic().toLocalFile();
-          if (image.load(cover_path)) {
+          if (QImageReader(cover_path).canRead()) {
             extension = cover_path.section(u'.', -1);
           }
+          else {
+            cover_path.clear();
+          }
         }
         break;
     }
-    if (!image.isNull() && !extension.isEmpty() && (embedded_cover || !cover_path.isEmpty())) break;
+    if (!extension.isEmpty() && (!embedded_data.isEmpty() || !cover_path.isEmpty())) break;
   }
 
-  if (image.isNull() || extension.isEmpty()) {
+  if (extension.isEmpty() || (embedded_data.isEmpty() && cover_path.isEmpty())) {
     EmitCoverSkipped();
     return;
   }
 
+  // Embedded covers are written as JPEG, JPEG data is written as is, anything else is re-encoded.
+  const bool embedded_cover = !embedded_data.isEmpty();
+  if (embedded_cover && Utilities::MimeTypeFromData(embedded_data) != "image/jpeg"_L1) {
+    QImage image;
+    if (!image.loadFromData(embedded_data) || !EncodeImage(image, extension, embedded_data)) {
+      EmitCoverSkipped();
+      return;
+    }
+  }
+
   QString cover_dir = song_.url().toLocalFile().section(u'/', 0, -2);
   QString new_file = cover_dir + QLatin1Char('/') + dialog_result_.filename_ + QLatin1Char('.') + extension;
 
@@ -221,14 +249,14 @@ void CoverExportRunnable::ExportCover() {
   }
 
   if (embedded_cover) {
-    if (!image.save(new_file)) {
+    if (!WriteFile(new_file, embedded_data)) {
       EmitCoverSkipped();
       return;
     }
   }
   else {
     // Automatic or manual cover, available in an image file
-    if (!QFile::copy(cover_path, new_file)) {
+    if (!CopyFile(cover_path, new_file)) {
       EmitCoverSkipped();
       return;
     }
@@ -238,6 +266,40 @@ void CoverExportRunnable::ExportCover() {
 
 }
 
+bool CoverExportRunnable::EncodeImage(const QImage &image, const QString &extension, QByteArray &data) {
+
+  data.clear();
+  QBuffer buffer(&data);
+  if (!buffer.open(QIODevice::WriteOnly)) return false;
+
+  return image.save(&buffer, extension.toLower().toLatin1().constData());
+
+}
+
+bool CoverExportRunnable::WriteFile(const QString &filename, const QByteArray &data) {
+
+  if (io_semaphore_) io_semaphore_->acquire();
+
+  QFile file(filename);
+  const bool success = file.open(QIODevice::WriteOnly) && file.write(data) == data.size();
+  file.close();
+
+  if (io_semaphore_) io_semaphore_->release();
+
+  return success;
+
+}
+
+bool CoverExportRunnable::CopyFile(const QString &source_filename, const QString &destination_filename) {
+
+  if (io_semaphore_) io_semaphore_->acquire();
+  const bool success = QFile::copy(source_filename, destination_filename);
+  if (io_semaphore_) io_semaphore_->release();
+
+  return success;
+
+}
+
 void CoverExportRunnable::EmitCoverExported() { Q_EMIT CoverExported(); }
 
 void CoverExportRunnable::EmitCoverSkipped() { Q_EMIT CoverSkipped(); }
@@ -27,12 +27,15 @@
 #include <QObject>
 #include <QRunnable>
 #include <QString>
+#include <QByteArray>
+#include <QImage>
 
 #include "includes/shared_ptr.h"
 #include "core/song.h"
 #include "albumcoverloaderoptions.h"
 #include "albumcoverexport.h"
 
+class QSemaphore;
 class TagReaderClient;
 
 class CoverExportRunnable : public QObject, public QRunnable {
@@ -43,6 +46,7 @@ class CoverExportRunnable : public QObject, public QRunnable {
                                const AlbumCoverExport::DialogResult &dialog_result,
                                const AlbumCoverLoaderOptions::Types &cover_types,
                                const Song &song,
+                               QSemaphore *io_semaphore = nullptr,
                                QObject *parent = nullptr);
 
   void run() override;
@@ -57,11 +61,16 @@ class CoverExportRunnable : public QObject, public QRunnable {
 
   void ProcessAndExportCover();
   void ExportCover();
+  static bool EncodeImage(const QImage &image, const QString &extension, QByteArray &data);
+  bool WriteFile(const QString &filename, const QByteArray &data);
+  bool CopyFile(const QString &source_filename, const QString &destination_filename);
 
   SharedPtr<TagReaderClient> tagreader_client_;
   AlbumCoverExport::DialogResult dialog_result_;
   AlbumCoverLoaderOptions::Types cover_types_;
   Song song_;
+  // Limits the number of runnables writing to disk at the same time.
+  QSemaphore *io_semaphore_;
 };
 
 #endif  // COVEREXPORTRUNNABLE_H
@@ -29,6 +29,7 @@
 #include <QStringList>
 
 #include "includes/shared_ptr.h"
+#include "constants/timeconstants.h"
 #include "core/jsonbaserequest.h"
 #include "albumcoverfetcher.h"
 
@@ -55,6 +56,9 @@ class CoverProvider : public JsonBaseRequest {
   virtual bool authenticated() const override { return true; }
   virtual bool use_authorization_header() const override { return false; }
   virtual QByteArray authorization_header() const override { return QByteArray(); }
+  // Cover searches fan out to many providers, so they should not hold up other requests.
+  virtual QNetworkRequest::Priority request_priority() const override { return QNetworkRequest::LowPriority; }
+  virtual qint64 cache_time() const override { return 7 * kSecsPerDay; }
 
   virtual void Authenticate() {}
   virtual void ClearSession() {}
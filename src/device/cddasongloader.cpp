@@ -45,6 +45,7 @@
 #include "core/logging.h"
 #include "core/networkaccessmanager.h"
 #include "constants/timeconstants.h"
+#include "engine/gststartup.h"
 
 using std::make_shared;
 
@@ -94,6 +95,8 @@ void CDDASongLoader::LoadSongsFromCDDA() {
 
   QMutexLocker l(&mutex_load_);
 
+  GstStartup::WaitForInitialized();
+
   GError *error = nullptr;
   GstElement *cdda = gst_element_factory_make("cdiocddasrc", nullptr);
   if (error) {
@@ -65,6 +65,7 @@ class DeviceInfo : public SimpleTreeItem<DeviceInfo> {
         type_(Type::Root),
         database_id_(-1),
         size_(0),
+        free_space_(0),
         transcode_mode_(MusicStorage::TranscodeMode::Transcode_Unsupported),
         transcode_format_(Song::FileType::Unknown),
         task_percentage_(-1),
@@ -76,6 +77,7 @@ class DeviceInfo : public SimpleTreeItem<DeviceInfo> {
         type_(_type),
         database_id_(-1),
         size_(0),
+        free_space_(0),
         transcode_mode_(MusicStorage::TranscodeMode::Transcode_Unsupported),
         transcode_format_(Song::FileType::Unknown),
         task_percentage_(-1),
@@ -111,6 +113,8 @@ class DeviceInfo : public SimpleTreeItem<DeviceInfo> {
 
   QString friendly_name_;
   quint64 size_;
+  // Last free space read from the lister.
+  quint64 free_space_;
 
   QString icon_name_;
   QIcon icon_;
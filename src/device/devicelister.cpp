@@ -36,6 +36,7 @@
 #include "devicelister.h"
 
 #include "core/logging.h"
+#include "core/startuptracer.h"
 
 using namespace Qt::Literals::StringLiterals;
 
@@ -63,6 +64,8 @@ DeviceLister::~DeviceLister() {
 
 void DeviceLister::Start() {
 
+  const qint64 start_msec = StartupTracer::ElapsedMsec();
+
   thread_ = new QThread;
   thread_->setObjectName(objectName());
   QObject::connect(thread_, &QThread::started, this, &DeviceLister::ThreadStarted);
@@ -71,6 +74,8 @@ void DeviceLister::Start() {
   thread_->start();
   qLog(Debug) << this << "moved to thread" << thread_;
 
+  StartupTracer::AddEvent(u"Thread "_s + thread_->objectName(), start_msec, StartupTracer::ElapsedMsec() - start_msec);
+
 }
 
 void DeviceLister::ThreadStarted() { Init(); }
@@ -31,6 +31,8 @@
 #include <QMetaObject>
 #include <QThread>
 #include <QtConcurrentRun>
+#include <QFuture>
+#include <QFutureWatcher>
 #include <QAbstractItemModel>
 #include <QDir>
 #include <QList>
@@ -97,7 +99,8 @@ DeviceManager::DeviceManager(const SharedPtr<TaskManager> task_manager,
       database_(database),
       tagreader_client_(tagreader_client),
       albumcover_loader_(albumcover_loader),
-      not_connected_overlay_(IconLoader::Load(u"edit-delete"_s)) {
+      not_connected_overlay_(IconLoader::Load(u"edit-delete"_s)),
+      listers_started_(false) {
 
   setObjectName(QLatin1String(QObject::metaObject()->className()));
 
@@ -151,7 +154,7 @@ DeviceManager::DeviceManager(const SharedPtr<TaskManager> task_manager,
 DeviceManager::~DeviceManager() {
 
   for (DeviceLister *lister : std::as_const(listers_)) {
-    lister->ShutDown();
+    if (listers_started_) lister->ShutDown();
     delete lister;
   }
   listers_.clear();
@@ -181,6 +184,11 @@ void DeviceManager::CloseDevices() {
 
 void DeviceManager::CloseListers() {
 
+  if (!listers_started_) {
+    CloseBackend();
+    return;
+  }
+
   for (DeviceLister *lister : std::as_const(listers_)) {
     if (wait_for_exit_.contains(lister)) continue;
     wait_for_exit_ << lister;
@@ -323,7 +331,7 @@ QVariant DeviceManager::data(const QModelIndex &idx, int role) const {
 
     case Role_FreeSpace:
     case MusicStorage::Role_FreeSpace:
-      return ((device_info->BestBackend() && device_info->BestBackend()->lister_) ? device_info->BestBackend()->lister_->DeviceFreeSpace(device_info->BestBackend()->unique_id_) : QVariant());
+      return ((device_info->BestBackend() && device_info->BestBackend()->lister_) ? QVariant(device_info->free_space_) : QVariant());
 
     case Role_State:
       if (device_info->device_) return QVariant::fromValue(State::Connected);
@@ -397,7 +405,18 @@ void DeviceManager::AddLister(DeviceLister *lister) {
   QObject::connect(lister, &DeviceLister::DeviceRemoved, this, &DeviceManager::PhysicalDeviceRemoved);
   QObject::connect(lister, &DeviceLister::DeviceChanged, this, &DeviceManager::PhysicalDeviceChanged);
 
-  lister->Start();
+  if (listers_started_) lister->Start();
+
+}
+
+void DeviceManager::StartListers() {
+
+  if (listers_started_) return;
+  listers_started_ = true;
+
+  for (DeviceLister *lister : std::as_const(listers_)) {
+    lister->Start();
+  }
 
 }
 
@@ -453,7 +472,53 @@ void DeviceManager::PhysicalDeviceAdded(const QString &id) {
   DeviceLister *lister = qobject_cast<DeviceLister*>(sender());
   if (!lister) return;
 
-  qLog(Info) << "Device added:" << id << lister->DeviceUniqueIDs();
+  qLog(Info) << "Device added:" << id;
+
+  Q_EMIT MountPointsChanged();
+
+  probing_devices_.insert(id);
+  ProbeDeviceAsync(lister, id, true);
+
+}
+
+DeviceManager::DeviceProbe DeviceManager::ProbeDevice(DeviceLister *lister, const QString &id) {
+
+  DeviceProbe probe;
+  probe.id = id;
+  probe.friendly_name = lister->MakeFriendlyName(id);
+  probe.urls = lister->MakeDeviceUrls(id);
+  probe.icons = lister->DeviceIcons(id);
+  probe.capacity = lister->DeviceCapacity(id);
+  probe.free_space = lister->DeviceFreeSpace(id);
+
+  return probe;
+
+}
+
+void DeviceManager::ProbeDeviceAsync(DeviceLister *lister, const QString &id, const bool added) {
+
+  QFuture<DeviceProbe> future = QtConcurrent::run(&thread_pool_, &DeviceManager::ProbeDevice, lister, id);
+  QFutureWatcher<DeviceProbe> *watcher = new QFutureWatcher<DeviceProbe>(this);
+  QObject::connect(watcher, &QFutureWatcher<DeviceProbe>::finished, this, [this, watcher, lister, added]() {
+    const DeviceProbe probe = watcher->result();
+    watcher->deleteLater();
+    if (added) {
+      PhysicalDeviceProbed(lister, probe);
+    }
+    else {
+      PhysicalDeviceChangeProbed(probe);
+    }
+  });
+  watcher->setFuture(future);
+
+}
+
+void DeviceManager::PhysicalDeviceProbed(DeviceLister *lister, const DeviceProbe &probe) {
+
+  // The device might have been removed again while it was probed.
+  if (!probing_devices_.remove(probe.id)) return;
+
+  const QString &id = probe.id;
 
   // Do we have this device already?
   DeviceInfo *device_info = FindDeviceById(id);
@@ -464,21 +529,23 @@ void DeviceManager::PhysicalDeviceAdded(const QString &id) {
         break;
       }
     }
+    device_info->free_space_ = probe.free_space;
     QModelIndex idx = ItemToIndex(device_info);
     if (idx.isValid()) Q_EMIT dataChanged(idx, idx);
   }
   else {
     // Check if we have another device with the same URL
-    device_info = FindDeviceByUrl(lister->MakeDeviceUrls(id));
+    device_info = FindDeviceByUrl(probe.urls);
     if (device_info) {
       // Add this device's lister to the existing device
       device_info->backends_ << DeviceInfo::Backend(lister, id);
 
       // If the user hasn't saved the device in the DB yet then overwrite the device's name and icon etc.
       if (device_info->database_id_ == -1 && device_info->BestBackend() && device_info->BestBackend()->lister_ == lister) {
-        device_info->friendly_name_ = lister->MakeFriendlyName(id);
-        device_info->size_ = lister->DeviceCapacity(id);
-        device_info->LoadIcon(lister->DeviceIcons(id), device_info->friendly_name_);
+        device_info->friendly_name_ = probe.friendly_name;
+        device_info->size_ = probe.capacity;
+        device_info->free_space_ = probe.free_space;
+        device_info->LoadIcon(probe.icons, device_info->friendly_name_);
       }
       QModelIndex idx = ItemToIndex(device_info);
       if (idx.isValid()) Q_EMIT dataChanged(idx, idx);
@@ -488,21 +555,41 @@ void DeviceManager::PhysicalDeviceAdded(const QString &id) {
       beginInsertRows(ItemToIndex(root_), static_cast<int>(root_->children.count()), static_cast<int>(root_->children.count()));
       device_info = new DeviceInfo(DeviceInfo::Type::Device, root_);
       device_info->backends_ << DeviceInfo::Backend(lister, id);
-      device_info->friendly_name_ = lister->MakeFriendlyName(id);
-      device_info->size_ = lister->DeviceCapacity(id);
-      device_info->LoadIcon(lister->DeviceIcons(id), device_info->friendly_name_);
+      device_info->friendly_name_ = probe.friendly_name;
+      device_info->size_ = probe.capacity;
+      device_info->free_space_ = probe.free_space;
+      device_info->LoadIcon(probe.icons, device_info->friendly_name_);
       endInsertRows();
     }
   }
 
 }
 
+void DeviceManager::PhysicalDeviceChangeProbed(const DeviceProbe &probe) {
+
+  DeviceInfo *device_info = FindDeviceById(probe.id);
+  if (!device_info) return;
+
+  device_info->free_space_ = probe.free_space;
+  if (device_info->database_id_ == -1) {
+    device_info->size_ = probe.capacity;
+  }
+
+  const QModelIndex idx = ItemToIndex(device_info);
+  if (idx.isValid()) Q_EMIT dataChanged(idx, idx);
+
+}
+
 void DeviceManager::PhysicalDeviceRemoved(const QString &id) {
 
   DeviceLister *lister = qobject_cast<DeviceLister*>(sender());
 
   qLog(Info) << "Device removed:" << id;
 
+  Q_EMIT MountPointsChanged();
+
+  probing_devices_.remove(id);
+
   DeviceInfo *device_info = FindDeviceById(id);
   if (!device_info) return;
 
@@ -547,12 +634,15 @@ void DeviceManager::PhysicalDeviceRemoved(const QString &id) {
 void DeviceManager::PhysicalDeviceChanged(const QString &id) {
 
   DeviceLister *lister = qobject_cast<DeviceLister*>(sender());
-  Q_UNUSED(lister);
+  if (!lister) return;
+
+  // Devices report a change when they are mounted or unmounted, or when the free space was updated.
+  Q_EMIT MountPointsChanged();
 
   DeviceInfo *device_info = FindDeviceById(id);
   if (!device_info) return;
 
-  // TODO
+  ProbeDeviceAsync(lister, id, false);
 
 }
 
@@ -31,6 +31,7 @@
 #include <QList>
 #include <QMap>
 #include <QMultiMap>
+#include <QSet>
 #include <QVariant>
 #include <QString>
 #include <QStringList>
@@ -97,6 +98,9 @@ class DeviceManager : public SimpleTreeModel<DeviceInfo> {
 
   void Exit();
 
+  // Starts the device listers, this is deferred until after startup.
+  void StartListers();
+
   DeviceStateFilterModel *connected_devices_model() const { return connected_devices_model_; }
 
   // Get info about devices
@@ -133,6 +137,7 @@ class DeviceManager : public SimpleTreeModel<DeviceInfo> {
   void DeviceDisconnected(const QModelIndex idx);
   void DeviceCreatedFromDB(DeviceInfo *device_info);
   void DeviceError(const QString &error);
+  void MountPointsChanged();
 
  private Q_SLOTS:
   void PhysicalDeviceAdded(const QString &id);
@@ -150,9 +155,24 @@ class DeviceManager : public SimpleTreeModel<DeviceInfo> {
   void DeviceDestroyed();
 
  private:
+  // Information read from a lister on the thread pool, so slow devices don't block the GUI thread.
+  struct DeviceProbe {
+    QString id;
+    QString friendly_name;
+    QList<QUrl> urls;
+    QVariantList icons;
+    quint64 capacity = 0;
+    quint64 free_space = 0;
+  };
+
   void AddLister(DeviceLister *lister);
   template<typename T> void AddDeviceClass();
 
+  static DeviceProbe ProbeDevice(DeviceLister *lister, const QString &id);
+  void ProbeDeviceAsync(DeviceLister *lister, const QString &id, const bool added);
+  void PhysicalDeviceProbed(DeviceLister *lister, const DeviceProbe &probe);
+  void PhysicalDeviceChangeProbed(const DeviceProbe &probe);
+
   DeviceDatabaseBackend::Device InfoToDatabaseDevice(const DeviceInfo &info) const;
 
   void RemoveFromDB(DeviceInfo *device_info, const QModelIndex &idx);
@@ -174,12 +194,16 @@ class DeviceManager : public SimpleTreeModel<DeviceInfo> {
   QIcon not_connected_overlay_;
 
   QList<DeviceLister*> listers_;
+  bool listers_started_;
 
   QMultiMap<QString, QMetaObject> device_classes_;
 
   // Map of task ID to device index
   QMap<int, QPersistentModelIndex> active_tasks_;
 
+  // Devices that were added, but not probed yet.
+  QSet<QString> probing_devices_;
+
   QThreadPool thread_pool_;
 
   QList<QObject*> wait_for_exit_;
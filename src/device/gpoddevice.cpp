@@ -314,6 +314,8 @@ void GPodDevice::Finish(const bool success) {
   if (success) {
     if (!songs_to_add_.isEmpty()) collection_backend_->AddOrUpdateSongs(songs_to_add_);
     if (!songs_to_remove_.isEmpty()) collection_backend_->DeleteSongs(songs_to_remove_);
+    // The collection matches the database we just wrote, so it doesn't need to be loaded again on the next mount.
+    GPodLoader::SaveDatabaseSnapshot(unique_id_, url_.path(), db_);
   }
 
   // This is done in the organize thread so close the unique DB connection.
@@ -26,6 +26,8 @@
 
 #include <QObject>
 #include <QDir>
+#include <QFileInfo>
+#include <QDateTime>
 #include <QByteArray>
 #include <QString>
 
@@ -33,9 +35,17 @@
 #include "core/logging.h"
 #include "core/song.h"
 #include "core/taskmanager.h"
+#include "core/settings.h"
 #include "collection/collectionbackend.h"
+#include "connecteddevice.h"
 #include "gpodloader.h"
 
+using namespace Qt::Literals::StringLiterals;
+
+namespace {
+constexpr char kSettingsGroup[] = "GPodDatabaseSnapshots";
+}
+
 GPodLoader::GPodLoader(const QString &mount_point,
                        const SharedPtr<TaskManager> task_manager,
                        const SharedPtr<CollectionBackend> backend,
@@ -88,6 +98,20 @@ Itdb_iTunesDB *GPodLoader::TryLoad() {
     return db;
   }
 
+  // The songs in the collection are still up to date if the database wasn't changed since it was last loaded or written.
+  const QString snapshot = DatabaseSnapshot(mount_point_, db);
+  if (!snapshot.isEmpty()) {
+    Settings s;
+    s.beginGroup(kSettingsGroup);
+    const bool unchanged = s.value(device_->unique_id()).toString() == snapshot;
+    s.endGroup();
+    if (unchanged) {
+      qLog(Debug) << "iTunes database is unchanged, using songs from the last time it was loaded";
+      backend_->Close();
+      return db;
+    }
+  }
+
   // Convert all the tracks from libgpod structs into Song classes
   const QString prefix = path_prefix_.isEmpty() ? QDir::fromNativeSeparators(mount_point_) : path_prefix_;
 
@@ -112,6 +136,7 @@ Itdb_iTunesDB *GPodLoader::TryLoad() {
   if (!abort_) {
     // Add the songs we've just loaded
     backend_->AddOrUpdateSongs(songs);
+    SaveDatabaseSnapshot(device_->unique_id(), mount_point_, db);
   }
 
   // This is done in the loader thread so close the unique DB connection.
@@ -120,3 +145,32 @@ Itdb_iTunesDB *GPodLoader::TryLoad() {
   return db;
 
 }
+
+QString GPodLoader::DatabaseSnapshot(const QString &mount_point, Itdb_iTunesDB *db) {
+
+  gchar *itunesdb_path = itdb_get_itunesdb_path(QDir::toNativeSeparators(mount_point).toLocal8Bit().constData());
+  if (!itunesdb_path) return QString();
+
+  const QFileInfo fileinfo(QString::fromLocal8Bit(itunesdb_path));
+  g_free(itunesdb_path);
+  if (!fileinfo.exists()) return QString();
+
+  return QStringLiteral("%1:%2:%3").arg(fileinfo.lastModified().toMSecsSinceEpoch()).arg(fileinfo.size()).arg(g_list_length(db->tracks));
+
+}
+
+void GPodLoader::SaveDatabaseSnapshot(const QString &unique_id, const QString &mount_point, Itdb_iTunesDB *db) {
+
+  const QString snapshot = DatabaseSnapshot(mount_point, db);
+
+  Settings s;
+  s.beginGroup(kSettingsGroup);
+  if (snapshot.isEmpty()) {
+    s.remove(unique_id);
+  }
+  else {
+    s.setValue(unique_id, snapshot);
+  }
+  s.endGroup();
+
+}
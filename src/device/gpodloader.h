@@ -54,6 +54,9 @@ class GPodLoader : public QObject {
 
   void Abort() { abort_ = true; }
 
+  // Remembers the iTunesDB modification time, so the songs don't need to be loaded into the collection again if the database wasn't changed.
+  static void SaveDatabaseSnapshot(const QString &unique_id, const QString &mount_point, Itdb_iTunesDB *db);
+
  public Q_SLOTS:
   void LoadDatabase();
 
@@ -64,6 +67,7 @@ class GPodLoader : public QObject {
 
  private:
   Itdb_iTunesDB *TryLoad();
+  static QString DatabaseSnapshot(const QString &mount_point, Itdb_iTunesDB *db);
 
  private:
   SharedPtr<ConnectedDevice> device_;
@@ -26,9 +26,12 @@
 #include <memory>
 
 #include <QObject>
+#include <QMap>
+#include <QSet>
 #include <QUrl>
 
 #include "includes/shared_ptr.h"
+#include "core/logging.h"
 #include "core/taskmanager.h"
 #include "core/song.h"
 #include "collection/collectionbackend.h"
@@ -78,31 +81,55 @@ bool MtpLoader::TryLoad() {
     return false;
   }
 
-  // Load the list of songs on the device
-  SongList songs;
-  LIBMTP_track_t *tracks = LIBMTP_Get_Tracklisting_With_Callback(connection_->device(), nullptr, nullptr);
-  while (tracks) {
-
-    if (abort_) break;
-
-    LIBMTP_track_t *track = tracks;
+  // The songs from the last connection are kept in the database, indexed by object ID.
+  QMap<uint32_t, Song> songs_existing;
+  const SongList songs_in_db = backend_->FindSongsInDirectory(1);
+  for (const Song &song : songs_in_db) {
+    songs_existing.insert(song.basefilename().toUInt(), song);
+  }
 
-    Song song(Song::Source::Device);
-    song.InitFromMTP(track, url_.host());
-    if (song.is_valid() && !song.title().isEmpty()) {
-      song.set_directory_id(1);
-      songs << song;
+  // Listing the files is fast, only get the track metadata for new or modified files.
+  SongList songs_changed;
+  QSet<uint32_t> item_ids;
+  LIBMTP_file_t *files = LIBMTP_Get_Filelisting_With_Callback(connection_->device(), nullptr, nullptr);
+  while (files) {
+
+    LIBMTP_file_t *file = files;
+    files = files->next;
+
+    if (!abort_ && LIBMTP_FILETYPE_IS_TRACK(file->filetype)) {
+      item_ids.insert(file->item_id);
+      const Song song_existing = songs_existing.value(file->item_id);
+      if (!song_existing.is_valid() || song_existing.mtime() != file->modificationdate || song_existing.filesize() != static_cast<qint64>(file->filesize)) {
+        LIBMTP_track_t *track = LIBMTP_Get_Trackmetadata(connection_->device(), file->item_id);
+        if (track) {
+          Song song(Song::Source::Device);
+          song.InitFromMTP(track, url_.host());
+          if (song.is_valid() && !song.title().isEmpty()) {
+            song.set_directory_id(1);
+            if (song_existing.is_valid()) song.set_id(song_existing.id());
+            songs_changed << song;
+          }
+          LIBMTP_destroy_track_t(track);
+        }
+      }
     }
-    tracks = tracks->next;
-    LIBMTP_destroy_track_t(track);
+
+    LIBMTP_destroy_file_t(file);
   }
 
   if (!abort_) {
-    // Need to remove all the existing songs in the database first
-    backend_->DeleteSongs(backend_->FindSongsInDirectory(1));
+    SongList songs_deleted;
+    for (QMap<uint32_t, Song>::const_iterator it = songs_existing.constBegin(); it != songs_existing.constEnd(); ++it) {
+      if (!item_ids.contains(it.key())) {
+        songs_deleted << it.value();
+      }
+    }
+
+    qLog(Debug) << "MTP device has" << item_ids.count() << "tracks," << songs_changed.count() << "new or changed and" << songs_deleted.count() << "deleted";
 
-    // Add the songs we've just loaded
-    backend_->AddOrUpdateSongs(songs);
+    if (!songs_deleted.isEmpty()) backend_->DeleteSongs(songs_deleted);
+    if (!songs_changed.isEmpty()) backend_->AddOrUpdateSongs(songs_changed);
   }
 
   // This is done in the loader thread so close the unique DB connection.
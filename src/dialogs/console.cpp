@@ -21,6 +21,8 @@
 
 #include "config.h"
 
+#include <optional>
+
 #include <QWidget>
 #include <QDialog>
 #include <QString>
@@ -34,22 +36,109 @@
 #include <QPushButton>
 #include <QScrollBar>
 #include <QTextBrowser>
+#include <QTabWidget>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QPixmapCache>
+#include <QScopeGuard>
+#include <QShowEvent>
+#include <QHideEvent>
 
 #include "console.h"
 
 #include "includes/shared_ptr.h"
 #include "core/logging.h"
 #include "core/database.h"
+#include "core/sqlquery.h"
+#include "core/player.h"
+#include "core/memorybudget.h"
+#include "core/wakeupstatistics.h"
+#include "engine/enginebase.h"
+#include "tagreader/tagreaderclient.h"
+#include "covermanager/albumcoverloader.h"
+#include "covermanager/covercache.h"
+#include "collection/collectionmodel.h"
+#include "playlist/playlist.h"
+#include "playlist/playlistmanager.h"
+#include "scrobbler/audioscrobbler.h"
+#include "scrobbler/scrobblerservice.h"
+#include "utilities/strutils.h"
+#ifdef HAVE_MOODBAR
+#  include "moodbar/moodbarloader.h"
+#endif
 
 using namespace Qt::Literals::StringLiterals;
 
-Console::Console(const SharedPtr<Database> database, QWidget *parent) : QDialog(parent), ui_{}, database_(database) {
+namespace {
+
+constexpr int kUpdateMetricsIntervalMsec = 1000;
+constexpr qint64 kNsecPerMsec = 1000000;
+
+QString MetricsRow(const QString &name, const QString &value) {
+
+  return u"<tr><td>%1</td><td>%2</td></tr>"_s.arg(name.toHtmlEscaped(), value.toHtmlEscaped());
+
+}
+
+QString MetricsSection(const QString &title, const QString &rows) {
+
+  return u"<h3>%1</h3><table cellspacing=\"0\" cellpadding=\"2\">%2</table>"_s.arg(title.toHtmlEscaped(), rows);
+
+}
+
+QString HitRate(const quint64 hits, const quint64 requests) {
+
+  if (requests == 0) return u"-"_s;
+
+  return QString::number(static_cast<double>(hits) * 100.0 / static_cast<double>(requests), 'f', 1) + u'%';
+
+}
+
+QString Milliseconds(const qint64 nanoseconds) {
+
+  if (nanoseconds < 0) return QObject::tr("Unknown");
+
+  return QString::number(static_cast<double>(nanoseconds) / static_cast<double>(kNsecPerMsec), 'f', 1) + u" ms"_s;
+
+}
+
+}  // namespace
+
+Console::Console(const SharedPtr<Database> database,
+                 const SharedPtr<TagReaderClient> tagreader_client,
+                 const SharedPtr<AlbumCoverLoader> albumcover_loader,
+                 const SharedPtr<Player> player,
+                 const SharedPtr<PlaylistManager> playlist_manager,
+                 const SharedPtr<AudioScrobbler> scrobbler,
+#ifdef HAVE_MOODBAR
+                 const SharedPtr<MoodbarLoader> moodbar_loader,
+#endif
+                 CollectionModel *collection_model,
+                 QWidget *parent)
+    : QDialog(parent),
+      ui_{},
+      database_(database),
+      tagreader_client_(tagreader_client),
+      albumcover_loader_(albumcover_loader),
+      player_(player),
+      playlist_manager_(playlist_manager),
+      scrobbler_(scrobbler),
+#ifdef HAVE_MOODBAR
+      moodbar_loader_(moodbar_loader),
+#endif
+      collection_model_(collection_model),
+      timer_update_metrics_(new QTimer(this)),
+      wakeups_(0) {
 
   ui_.setupUi(this);
 
   setWindowFlags(windowFlags() | Qt::WindowMaximizeButtonHint);
 
   QObject::connect(ui_.run, &QPushButton::clicked, this, &Console::RunQuery);
+  QObject::connect(ui_.tabs, &QTabWidget::currentChanged, this, &Console::CurrentTabChanged);
+
+  timer_update_metrics_->setInterval(kUpdateMetricsIntervalMsec);
+  QObject::connect(timer_update_metrics_, &QTimer::timeout, this, &Console::UpdateMetrics);
 
   QFont font(u"Monospace"_s);
   font.setStyleHint(QFont::TypeWriter);
@@ -59,9 +148,112 @@ Console::Console(const SharedPtr<Database> database, QWidget *parent) : QDialog(
 
 }
 
+void Console::showEvent(QShowEvent *e) {
+
+  CurrentTabChanged();
+
+  QDialog::showEvent(e);
+
+}
+
+void Console::hideEvent(QHideEvent *e) {
+
+  timer_update_metrics_->stop();
+
+  QDialog::hideEvent(e);
+
+}
+
+void Console::CurrentTabChanged() {
+
+  // Only collect the metrics while they are shown.
+  if (ui_.tabs->currentWidget() == ui_.tab_metrics) {
+    wakeups_elapsed_.invalidate();
+    UpdateMetrics();
+    timer_update_metrics_->start();
+  }
+  else {
+    timer_update_metrics_->stop();
+  }
+
+}
+
+void Console::UpdateMetrics() {
+
+  QString queues;
+  queues += MetricsRow(tr("Tag reader requests"), QString::number(tagreader_client_->QueuedRequests()));
+  queues += MetricsRow(tr("Album cover loader tasks"), QString::number(albumcover_loader_->QueuedTasks()));
+#ifdef HAVE_MOODBAR
+  queues += MetricsRow(tr("Moodbar requests"), tr("%1 queued, %2 active, %3 in the background").arg(moodbar_loader_->queued_requests()).arg(moodbar_loader_->active_requests()).arg(moodbar_loader_->background_requests()));
+#endif
+  const QList<ScrobblerServicePtr> scrobbler_services = scrobbler_->List();
+  for (const ScrobblerServicePtr &service : scrobbler_services) {
+    queues += MetricsRow(tr("%1 scrobbler cache").arg(service->name()), QString::number(service->cached_scrobbles()));
+  }
+
+  const SqlQuery::Statistics query_statistics = SqlQuery::statistics();
+  const Database::PreparedQueryStatistics prepared_query_statistics = database_->prepared_query_statistics();
+  QString sql;
+  sql += MetricsRow(tr("Queries"), QString::number(query_statistics.queries));
+  sql += MetricsRow(tr("Average query time"), query_statistics.queries == 0 ? u"-"_s : Milliseconds(query_statistics.total_nsec / static_cast<qint64>(query_statistics.queries)));
+  sql += MetricsRow(tr("Slowest query time"), Milliseconds(query_statistics.max_nsec));
+  sql += MetricsRow(tr("Total query time"), Milliseconds(query_statistics.total_nsec));
+  sql += MetricsRow(tr("Prepared query cache hit rate"), HitRate(prepared_query_statistics.hits, prepared_query_statistics.hits + prepared_query_statistics.misses));
+  sql += MetricsRow(tr("Prepared queries cached"), QString::number(prepared_query_statistics.cached));
+
+  const SharedPtr<EngineBase> engine = player_->engine();
+  const int buffering_percent = engine->buffering_percent();
+  QString playback;
+  playback += MetricsRow(tr("Output latency"), Milliseconds(engine->output_latency_nanosec()));
+  playback += MetricsRow(tr("Buffered audio"), Milliseconds(engine->buffered_nanosec()));
+  playback += MetricsRow(tr("Buffering"), buffering_percent < 0 ? tr("No") : QString::number(buffering_percent) + u'%');
+  if (const std::optional<EngineBase::NetworkBufferStatistics> network_statistics = engine->network_buffer_statistics()) {
+    const double throughput_ratio = network_statistics->throughput_ratio();
+    playback += MetricsRow(tr("Network throughput"), throughput_ratio <= 0.0 ? tr("Unknown") : tr("%1 times the playback rate").arg(throughput_ratio, 0, 'f', 1));
+    playback += MetricsRow(tr("Network jitter"), network_statistics->input_rate < 0 ? tr("Unknown") : QString::number(network_statistics->jitter * 100.0, 'f', 1) + u'%');
+    playback += MetricsRow(tr("Network buffer"), Milliseconds(static_cast<qint64>(network_statistics->buffer_duration_nanosec)));
+    playback += MetricsRow(tr("Network buffer underruns"), QString::number(network_statistics->underruns));
+  }
+  const quint64 wakeups = WakeupStatistics::Count();
+  const qint64 wakeups_elapsed_msec = wakeups_elapsed_.isValid() ? wakeups_elapsed_.restart() : 0;
+  if (!wakeups_elapsed_.isValid()) wakeups_elapsed_.start();
+  playback += MetricsRow(tr("Timer wake-ups"), wakeups_elapsed_msec <= 0 ? u"-"_s : tr("%1 per second").arg(static_cast<double>(wakeups - wakeups_) * 1000.0 / static_cast<double>(wakeups_elapsed_msec), 0, 'f', 1));
+  wakeups_ = wakeups;
+
+  const CoverCache::Statistics icon_cache_statistics = collection_model_->icon_cache()->statistics();
+  const QList<Playlist*> playlists = playlist_manager_->GetAllPlaylists();
+  int playlist_items = 0;
+  for (Playlist *playlist : playlists) {
+    playlist_items += playlist->rowCount();
+  }
+  QString memory;
+  memory += MetricsRow(tr("Collection songs loaded"), QString::number(collection_model_->loaded_song_count()));
+  memory += MetricsRow(tr("Collection icons in memory"), tr("%1 of %2").arg(Utilities::PrettySize(static_cast<quint64>(icon_cache_statistics.memory_bytes)), Utilities::PrettySize(static_cast<quint64>(icon_cache_statistics.memory_limit))));
+  memory += MetricsRow(tr("Collection icons on disk"), Utilities::PrettySize(static_cast<quint64>(icon_cache_statistics.disk_bytes)));
+  memory += MetricsRow(tr("Collection icon cache hit rate"), HitRate(icon_cache_statistics.memory_hits + icon_cache_statistics.disk_hits, icon_cache_statistics.memory_hits + icon_cache_statistics.disk_hits + icon_cache_statistics.misses));
+  memory += MetricsRow(tr("Pixmap cache limit"), Utilities::PrettySize(static_cast<quint64>(QPixmapCache::cacheLimit()) * 1024ULL));
+  memory += MetricsRow(tr("Playlists"), tr("%1 playlists with %2 items").arg(playlists.count()).arg(playlist_items));
+  const QList<MemoryBudget::CacheUsage> cache_usage = MemoryBudget::Instance()->usage();
+  qint64 cache_bytes = 0;
+  for (const MemoryBudget::CacheUsage &usage : cache_usage) {
+    cache_bytes += usage.bytes;
+  }
+  memory += MetricsRow(tr("Cache memory budget"), tr("%1 of %2").arg(Utilities::PrettySize(static_cast<quint64>(cache_bytes)), Utilities::PrettySize(static_cast<quint64>(MemoryBudget::Instance()->budget()))));
+
+  const int scroll_position = ui_.metrics->verticalScrollBar()->value();
+  ui_.metrics->setHtml(MetricsSection(tr("Queues"), queues) + MetricsSection(tr("Database"), sql) + MetricsSection(tr("Playback"), playback) + MetricsSection(tr("Memory"), memory));
+  ui_.metrics->verticalScrollBar()->setValue(scroll_position);
+
+}
+
 void Console::RunQuery() {
 
   QSqlDatabase db = database_->Connect();
+
+  // The songs of the streaming services are in their own database files, queried as <source>.<table>.
+  if (!database_->AttachSourceDatabases(db)) return;
+  const QScopeGuard detach_source_databases = qScopeGuard([this, &db]() { database_->DetachSourceDatabases(db); });
+
   QSqlQuery query(db);
   if (!query.prepare(ui_.query->text())) {
     qLog(Error) << query.lastError();
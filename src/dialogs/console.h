@@ -28,21 +28,51 @@
 #include <QWidget>
 #include <QDialog>
 #include <QString>
+#include <QElapsedTimer>
 
 #include "ui_console.h"
 
 #include "includes/shared_ptr.h"
 
+class QTimer;
+class QShowEvent;
+class QHideEvent;
+
 class Database;
+class TagReaderClient;
+class AlbumCoverLoader;
+class Player;
+class PlaylistManager;
+class AudioScrobbler;
+class CollectionModel;
+#ifdef HAVE_MOODBAR
+class MoodbarLoader;
+#endif
 
 class Console : public QDialog {
   Q_OBJECT
 
  public:
-  explicit Console(const SharedPtr<Database> database, QWidget *parent = nullptr);
+  explicit Console(const SharedPtr<Database> database,
+                   const SharedPtr<TagReaderClient> tagreader_client,
+                   const SharedPtr<AlbumCoverLoader> albumcover_loader,
+                   const SharedPtr<Player> player,
+                   const SharedPtr<PlaylistManager> playlist_manager,
+                   const SharedPtr<AudioScrobbler> scrobbler,
+#ifdef HAVE_MOODBAR
+                   const SharedPtr<MoodbarLoader> moodbar_loader,
+#endif
+                   CollectionModel *collection_model,
+                   QWidget *parent = nullptr);
+
+ protected:
+  void showEvent(QShowEvent *e) override;
+  void hideEvent(QHideEvent *e) override;
 
  private Q_SLOTS:
   void RunQuery();
+  void CurrentTabChanged();
+  void UpdateMetrics();
 
  Q_SIGNALS:
   void Error(const QString &error);
@@ -50,6 +80,19 @@ class Console : public QDialog {
  private:
   Ui::Console ui_;
   const SharedPtr<Database> database_;
+  const SharedPtr<TagReaderClient> tagreader_client_;
+  const SharedPtr<AlbumCoverLoader> albumcover_loader_;
+  const SharedPtr<Player> player_;
+  const SharedPtr<PlaylistManager> playlist_manager_;
+  const SharedPtr<AudioScrobbler> scrobbler_;
+#ifdef HAVE_MOODBAR
+  const SharedPtr<MoodbarLoader> moodbar_loader_;
+#endif
+  CollectionModel *collection_model_;
+  QTimer *timer_update_metrics_;
+  // Wake-ups counted when the metrics were last updated.
+  quint64 wakeups_;
+  QElapsedTimer wakeups_elapsed_;
 };
 
 #endif  // CONSOLE_H
@@ -29,9 +29,8 @@
 #include <memory>
 
 #include <QtGlobal>
-#include <QtConcurrentRun>
-#include <QFuture>
 #include <QFutureWatcher>
+#include <QPromise>
 #include <QObject>
 #include <QWidget>
 #include <QDialog>
@@ -44,6 +43,7 @@
 #include <QMap>
 #include <QVariant>
 #include <QString>
+#include <QStringList>
 #include <QUrl>
 #include <QPixmap>
 #include <QPalette>
@@ -74,6 +74,8 @@
 #include "constants/timeconstants.h"
 #include "core/iconloader.h"
 #include "core/logging.h"
+#include "core/tracing.h"
+#include "core/taskexecutor.h"
 #include "core/settings.h"
 #include "utilities/strutils.h"
 #include "utilities/timeutils.h"
@@ -113,6 +115,7 @@ using namespace Qt::Literals::StringLiterals;
 namespace {
 constexpr char kSettingsGroup[] = "EditTagDialog";
 constexpr int kSmallImageSize = 128;
+constexpr int kLoadChunkSize = 100;
 
 // ID3v2 version constants
 constexpr int kID3v2_Version_3 = 3;
@@ -153,10 +156,13 @@ EditTagDialog::EditTagDialog(const SharedPtr<NetworkAccessManager> network,
       cover_menu_(new QMenu(this)),
       image_no_cover_thumbnail_(ImageUtils::GenerateNoCoverImage(QSize(128, 128), devicePixelRatioF())),
       loading_(false),
+      load_watcher_(nullptr),
       ignore_edits_(false),
       summary_cover_art_id_(0),
       tags_cover_art_id_(0),
       cover_art_is_set_(false),
+      tags_cover_pending_(false),
+      summary_cover_pending_(false),
       save_tag_pending_(0),
       lyrics_id_(-1) {
 
@@ -235,6 +241,7 @@ EditTagDialog::EditTagDialog(const SharedPtr<NetworkAccessManager> network,
   }
 
   QObject::connect(ui_->song_list->selectionModel(), &QItemSelectionModel::selectionChanged, this, &EditTagDialog::SelectionChanged);
+  QObject::connect(ui_->tab_widget, &QTabWidget::currentChanged, this, &EditTagDialog::CurrentTabChanged);
   QObject::connect(ui_->button_box, &QDialogButtonBox::clicked, this, &EditTagDialog::ButtonClicked);
   QObject::connect(ui_->playcount_reset, &QPushButton::clicked, this, &EditTagDialog::ResetPlayStatistics);
   QObject::connect(ui_->rating, &RatingWidget::RatingChanged, this, &EditTagDialog::SongRated);
@@ -307,7 +314,13 @@ EditTagDialog::EditTagDialog(const SharedPtr<NetworkAccessManager> network,
 }
 
 EditTagDialog::~EditTagDialog() {
+
+  if (load_watcher_) {
+    load_watcher_->cancel();
+  }
+
   delete ui_;
+
 }
 
 void EditTagDialog::showEvent(QShowEvent *e) {
@@ -441,23 +454,35 @@ bool EditTagDialog::SetLoading(const QString &message) {
 
 }
 
-QList<EditTagDialog::Data> EditTagDialog::LoadData(const SongList &songs) const {
+void EditTagDialog::LoadData(QPromise<QList<Data>> &promise, const SharedPtr<TagReaderClient> tagreader_client, const SongList &songs) {
 
-  QList<Data> ret;
+  promise.setProgressRange(0, static_cast<int>(songs.count()));
 
+  QList<Data> chunk;
+  chunk.reserve(kLoadChunkSize);
+  int progress = 0;
   for (const Song &song : songs) {
+    if (promise.isCanceled()) return;
+    promise.setProgressValue(++progress);
     if (song.IsEditable()) {
       // Try reloading the tags from file
       Song copy(song);
-      const TagReaderResult result = tagreader_client_->ReadFileBlocking(copy.url().toLocalFile(), &copy);
+      const TagReaderResult result = tagreader_client->ReadFileBlocking(copy.url().toLocalFile(), &copy);
       if (result.success() && copy.is_valid()) {
         copy.MergeUserSetData(song, false, false);
-        ret << Data(copy);
+        chunk << Data(copy);
+        if (chunk.count() >= kLoadChunkSize) {
+          promise.addResult(chunk);
+          chunk.clear();
+          chunk.reserve(kLoadChunkSize);
+        }
       }
     }
   }
 
-  return ret;
+  if (!chunk.isEmpty()) {
+    promise.addResult(chunk);
+  }
 
 }
 
@@ -472,22 +497,51 @@ void EditTagDialog::SetSongs(const SongList &s, const PlaylistItemPtrList &items
   collection_songs_.clear();
 
   // Reload tags in the background
-  QFuture<QList<Data>> future = QtConcurrent::run(&EditTagDialog::LoadData, this, s);
-  QFutureWatcher<QList<Data>> *watcher = new QFutureWatcher<QList<Data>>();
-  QObject::connect(watcher, &QFutureWatcher<QList<Data>>::finished, this, &EditTagDialog::SetSongsFinished);
-  watcher->setFuture(future);
+  load_watcher_ = new LoadWatcher(this);
+  QObject::connect(load_watcher_, &LoadWatcher::resultsReadyAt, this, &EditTagDialog::LoadDataReady);
+  QObject::connect(load_watcher_, &LoadWatcher::progressValueChanged, this, &EditTagDialog::LoadDataProgress);
+  QObject::connect(load_watcher_, &LoadWatcher::finished, this, &EditTagDialog::SetSongsFinished);
+  load_watcher_->setFuture(TaskExecutor::Run(TaskExecutor::Lane::BackgroundIO, &EditTagDialog::LoadData, tagreader_client_, s));
+
+}
+
+void EditTagDialog::LoadDataReady(const int begin, const int end) {
+
+  qTraceScope("EditTagDialog::LoadDataReady");
+
+  if (!load_watcher_) return;
+
+  for (int i = begin; i < end; ++i) {
+    const QList<Data> chunk = load_watcher_->resultAt(i);
+    QStringList filenames;
+    filenames.reserve(chunk.count());
+    for (const Data &tag_data : chunk) {
+      filenames << tag_data.current_.basefilename();
+    }
+    data_ << chunk;
+    ui_->song_list->addItems(filenames);
+  }
+
+}
+
+void EditTagDialog::LoadDataProgress(const int value) {
+
+  if (!load_watcher_ || load_watcher_->progressMaximum() <= 1) return;
+
+  ui_->loading_label->set_text(tr("Loading tracks (%1 of %2)").arg(value).arg(load_watcher_->progressMaximum()) + u"..."_s);
 
 }
 
 void EditTagDialog::SetSongsFinished() {
 
-  QFutureWatcher<QList<Data>> *watcher = static_cast<QFutureWatcher<QList<Data>>*>(sender());
-  QList<Data> result_data = watcher->result();
-  watcher->deleteLater();
+  qTraceScope("EditTagDialog::SetSongsFinished");
 
-  if (!SetLoading(QString())) return;
+  if (load_watcher_) {
+    load_watcher_->deleteLater();
+    load_watcher_ = nullptr;
+  }
 
-  data_ = result_data;
+  if (!SetLoading(QString())) return;
 
   if (data_.count() == 0) {
     // If there were no valid songs, disable everything
@@ -502,11 +556,6 @@ void EditTagDialog::SetSongsFinished() {
     return;
   }
 
-  // Add the filenames to the list
-  for (const Data &tag_data : std::as_const(data_)) {
-    ui_->song_list->addItem(tag_data.current_.basefilename());
-  }
-
   // Select all
   ui_->song_list->setCurrentRow(0);
   ui_->song_list->selectAll();
@@ -579,56 +628,88 @@ void EditTagDialog::Data::set_value(const QString &id, const QVariant &value) {
 
 }
 
-bool EditTagDialog::DoesValueVary(const QModelIndexList &sel, const QString &id) const {
+bool EditTagDialog::IsValueModified(const QString &id, const QVariant &original, const QVariant &current) {
 
-  QVariant value = data_[sel.first().row()].current_value(id);
-  for (int i = 1; i < sel.count(); ++i) {
-    if (value != data_[sel[i].row()].current_value(id)) return true;
+  if (id == "track"_L1 || id == "disc"_L1 || id == "year"_L1) {
+    const int original_value = original.toInt();
+    const int current_value = current.toInt();
+    return original_value != current_value && (original_value != -1 || current_value != 0);
+  }
+  if (id == "rating"_L1) {
+    const float original_value = original.toFloat();
+    const float current_value = current.toFloat();
+    return original_value != current_value && (original_value != -1 || current_value != 0);
   }
-  return false;
+
+  return original != current;
 
 }
 
 bool EditTagDialog::IsValueModified(const QModelIndexList &sel, const QString &id) const {
 
-  if (id == u"track"_s || id == u"disc"_s || id == u"year"_s) {
-    return std::any_of(sel.begin(), sel.end(), [this, id](const QModelIndex &i) {
-      const int original = data_[i.row()].original_value(id).toInt();
-      const int current = data_[i.row()].current_value(id).toInt();
-      return original != current && (original != -1 || current != 0);
-    });
+  return std::any_of(sel.begin(), sel.end(), [this, &id](const QModelIndex &i) {
+    const Data &tag_data = data_[i.row()];
+    return IsValueModified(id, tag_data.original_value(id), tag_data.current_value(id));
+  });
+
+}
+
+QList<EditTagDialog::FieldSummary> EditTagDialog::SummarizeFields(const QList<FieldData> &fields, const QModelIndexList &sel) const {
+
+  QList<FieldSummary> summaries(fields.count());
+  if (sel.isEmpty()) return summaries;
+
+  // The values of the first song are what the other songs are compared against.
+  const Data &first_data = data_[sel.first().row()];
+  QVariantList first_values;
+  first_values.reserve(fields.count());
+  QList<qsizetype> pending;
+  pending.reserve(fields.count());
+  for (qsizetype i = 0; i < fields.count(); ++i) {
+    first_values << first_data.current_value(fields[i].id_);
+    pending << i;
   }
-  else if (id == u"rating"_s) {
-    return std::any_of(sel.begin(), sel.end(), [this, id](const QModelIndex &i) {
-      const float original = data_[i.row()].original_value(id).toFloat();
-      const float current = data_[i.row()].current_value(id).toFloat();
-      return original != current && (original != -1 || current != 0);
+
+  // Reduce all fields in a single pass over the selection, a field is settled once it's known to both vary and be modified.
+  for (const QModelIndex &idx : sel) {
+    const Data &tag_data = data_[idx.row()];
+    pending.removeIf([&fields, &first_values, &summaries, &tag_data](const qsizetype i) {
+      const QString &id = fields[i].id_;
+      FieldSummary &summary = summaries[i];
+      const QVariant current = tag_data.current_value(id);
+      if (!summary.varies_ && current != first_values[i]) {
+        summary.varies_ = true;
+      }
+      if (!summary.modified_ && IsValueModified(id, tag_data.original_value(id), current)) {
+        summary.modified_ = true;
+      }
+      return summary.varies_ && summary.modified_;
     });
+    if (pending.isEmpty()) break;
   }
-  return std::any_of(sel.begin(), sel.end(), [this, id](const QModelIndex &i) { return data_[i.row()].original_value(id) != data_[i.row()].current_value(id); });
 
-}
+  return summaries;
 
-void EditTagDialog::InitFieldValue(const FieldData &field, const QModelIndexList &sel) {
+}
 
-  const bool varies = DoesValueVary(sel, field.id_);
+void EditTagDialog::InitFieldValue(const FieldData &field, const QModelIndexList &sel, const FieldSummary &summary) {
 
   if (ExtendedEditor *editor = dynamic_cast<ExtendedEditor*>(field.editor_)) {
     editor->clear();
     editor->clear_hint();
-    if (varies) {
+    if (summary.varies_) {
       editor->set_hint(tr(kTagsDifferentHintText));
       editor->set_partially();
     }
     else {
-      editor->set_value(data_.value(sel.value(0).row()).current_value(field.id_));
+      editor->set_value(data_.at(sel.first().row()).current_value(field.id_));
     }
   }
   else if (field.editor_) {
     qLog(Error) << "Missing editor for" << field.editor_->objectName();
   }
 
-  UpdateModifiedField(field, sel);
+  UpdateModifiedField(field, summary.modified_);
 
 }
 
@@ -654,13 +735,11 @@ void EditTagDialog::UpdateFieldValue(const FieldData &field, const QModelIndexLi
     data_[i.row()].set_value(field.id_, value);
   }
 
-  UpdateModifiedField(field, sel);
+  UpdateModifiedField(field, IsValueModified(sel, field.id_));
 
 }
 
-void EditTagDialog::UpdateModifiedField(const FieldData &field, const QModelIndexList &sel) {
-
-  const bool modified = IsValueModified(sel, field.id_);
+void EditTagDialog::UpdateModifiedField(const FieldData &field, const bool modified) {
 
   // Update the boldness
   QFont new_font(font());
@@ -682,13 +761,12 @@ void EditTagDialog::ResetFieldValue(const FieldData &field, const QModelIndexLis
 
   // Reset each selected song
   for (const QModelIndex &i : sel) {
-    Data tag_data = data_.value(i.row());
+    Data &tag_data = data_[i.row()];
     tag_data.set_value(field.id_, tag_data.original_value(field.id_));
-    data_[i.row()] = tag_data;
   }
 
   // Reset the field
-  InitFieldValue(field, sel);
+  InitFieldValue(field, sel, SummarizeFields(QList<FieldData>() << field, sel).first());
 
 }
 
@@ -716,8 +794,9 @@ void EditTagDialog::SelectionChanged() {
     UpdateStatisticsTab(data_[indexes.first().row()].original_);
   }
 
-  const Song first_song = data_.value(indexes.first().row()).original_;
-  const UpdateCoverAction first_cover_action = data_.value(indexes.first().row()).cover_action_;
+  const Data &first_data = data_[indexes.first().row()];
+  const Song &first_song = first_data.original_;
+  const UpdateCoverAction first_cover_action = first_data.cover_action_;
   bool art_different = false;
   bool action_different = false;
   bool albumartist_enabled = false;
@@ -739,14 +818,15 @@ void EditTagDialog::SelectionChanged() {
   int id3v2_version = 0;
   bool id3v2_version_different = false;
   for (const QModelIndex &idx : indexes) {
-    if (data_.value(idx.row()).cover_action_ == UpdateCoverAction::None) {
-      data_[idx.row()].cover_result_ = AlbumCoverImageResult();
+    Data &tag_data = data_[idx.row()];
+    if (tag_data.cover_action_ == UpdateCoverAction::None) {
+      tag_data.cover_result_ = AlbumCoverImageResult();
     }
-    const Song song = data_.value(idx.row()).original_;
-    if (data_.value(idx.row()).cover_action_ != first_cover_action || (first_cover_action != UpdateCoverAction::None && data_[idx.row()].cover_result_.image_data != data_[indexes.first().row()].cover_result_.image_data)) {
+    const Song &song = tag_data.original_;
+    if (tag_data.cover_action_ != first_cover_action || (first_cover_action != UpdateCoverAction::None && tag_data.cover_result_.image_data != first_data.cover_result_.image_data)) {
       action_different = true;
     }
-    if (data_.value(idx.row()).cover_action_ != first_cover_action ||
+    if (tag_data.cover_action_ != first_cover_action ||
         song.art_manual() != first_song.art_manual() ||
         song.art_embedded() != first_song.art_embedded() ||
         song.art_automatic() != first_song.art_automatic() ||
@@ -825,6 +905,7 @@ void EditTagDialog::SelectionChanged() {
   ui_->tags_art_button->setEnabled(enable_change_art);
   if ((art_different && first_cover_action != UpdateCoverAction::New) || action_different) {
     tags_cover_art_id_ = 0;  // Cancels any pending art load.
+    tags_cover_pending_ = false;
     ui_->tags_art->clear();
     ui_->tags_art->setText(QLatin1String(kArtDifferentHintText));
     album_cover_choice_controller_->show_cover_action()->setEnabled(false);
@@ -847,15 +928,10 @@ void EditTagDialog::SelectionChanged() {
     album_cover_choice_controller_->unset_cover_action()->setEnabled(enable_change_art && !first_song.art_unset());
     album_cover_choice_controller_->clear_cover_action()->setEnabled(enable_change_art && (!first_song.art_manual().isEmpty() || first_song.art_unset()));
     album_cover_choice_controller_->delete_cover_action()->setEnabled(enable_change_art && (first_song.art_embedded() || !first_song.art_automatic().isEmpty() || !first_song.art_manual().isEmpty()));
-    AlbumCoverLoaderOptions cover_options(AlbumCoverLoaderOptions::Option::RawImageData | AlbumCoverLoaderOptions::Option::OriginalImage | AlbumCoverLoaderOptions::Option::ScaledImage | AlbumCoverLoaderOptions::Option::PadScaledImage);
-    cover_options.types = cover_types_;
-    cover_options.desired_scaled_size = QSize(kSmallImageSize, kSmallImageSize);
-    cover_options.device_pixel_ratio = devicePixelRatioF();
-    if (data_.value(indexes.first().row()).cover_action_ == UpdateCoverAction::None) {
-      tags_cover_art_id_ = albumcover_loader_->LoadImageAsync(cover_options, first_song);
-    }
-    else {
-      tags_cover_art_id_ = albumcover_loader_->LoadImageAsync(cover_options, data_[indexes.first().row()].cover_result_);
+    tags_cover_art_id_ = 0;
+    tags_cover_pending_ = true;
+    if (ui_->tab_widget->currentWidget() == ui_->tab_tags) {
+      LoadTagsCover();
     }
   }
 
@@ -900,9 +976,13 @@ void EditTagDialog::SelectionChanged() {
 
 void EditTagDialog::UpdateUI(const QModelIndexList &indexes) {
 
+  qTraceScope("EditTagDialog::UpdateUI");
+
+  const QList<FieldSummary> summaries = SummarizeFields(fields_, indexes);
+
   ignore_edits_ = true;
-  for (const FieldData &field : std::as_const(fields_)) {
-    InitFieldValue(field, indexes);
+  for (qsizetype i = 0; i < fields_.count(); ++i) {
+    InitFieldValue(fields_[i], indexes, summaries[i]);
   }
   ignore_edits_ = false;
 
@@ -923,13 +1003,60 @@ void EditTagDialog::SetDate(QLabel *label, const qint64 time) {
 
 }
 
-void EditTagDialog::UpdateSummaryTab(const Song &song) {
+void EditTagDialog::LoadTagsCover() {
+
+  tags_cover_pending_ = false;
+
+  const QModelIndexList indexes = ui_->song_list->selectionModel()->selectedIndexes();
+  if (indexes.isEmpty()) return;
+
+  const Data &first_data = data_.at(indexes.first().row());
+
+  AlbumCoverLoaderOptions cover_options(AlbumCoverLoaderOptions::Option::RawImageData | AlbumCoverLoaderOptions::Option::OriginalImage | AlbumCoverLoaderOptions::Option::ScaledImage | AlbumCoverLoaderOptions::Option::PadScaledImage);
+  cover_options.types = cover_types_;
+  cover_options.desired_scaled_size = QSize(kSmallImageSize, kSmallImageSize);
+  cover_options.device_pixel_ratio = devicePixelRatioF();
+  if (first_data.cover_action_ == UpdateCoverAction::None) {
+    tags_cover_art_id_ = albumcover_loader_->LoadImageAsync(cover_options, first_data.original_);
+  }
+  else {
+    tags_cover_art_id_ = albumcover_loader_->LoadImageAsync(cover_options, first_data.cover_result_);
+  }
+
+}
+
+void EditTagDialog::LoadSummaryCover() {
+
+  summary_cover_pending_ = false;
 
   AlbumCoverLoaderOptions cover_options(AlbumCoverLoaderOptions::Option::ScaledImage | AlbumCoverLoaderOptions::Option::PadScaledImage);
   cover_options.types = cover_types_;
   cover_options.desired_scaled_size = QSize(kSmallImageSize, kSmallImageSize);
   cover_options.device_pixel_ratio = devicePixelRatioF();
-  summary_cover_art_id_ = albumcover_loader_->LoadImageAsync(cover_options, song);
+  summary_cover_art_id_ = albumcover_loader_->LoadImageAsync(cover_options, summary_cover_song_);
+
+}
+
+void EditTagDialog::CurrentTabChanged(const int index) {
+
+  QWidget *widget = ui_->tab_widget->widget(index);
+  if (widget == ui_->tab_tags && tags_cover_pending_) {
+    LoadTagsCover();
+  }
+  else if (widget == ui_->tab_summary && summary_cover_pending_) {
+    LoadSummaryCover();
+  }
+
+}
+
+void EditTagDialog::UpdateSummaryTab(const Song &song) {
+
+  summary_cover_art_id_ = 0;
+  summary_cover_song_ = song;
+  summary_cover_pending_ = true;
+  if (ui_->tab_widget->currentWidget() == ui_->tab_summary) {
+    LoadSummaryCover();
+  }
 
   ui_->summary->setText(u"<p><b>"_s + song.PrettyTitleWithArtist().toHtmlEscaped() + u"</b></p>"_s);
 
@@ -1321,6 +1448,8 @@ void EditTagDialog::ButtonClicked(QAbstractButton *button) {
 void EditTagDialog::SaveData() {
 
   QMap<QString, QUrl> cover_urls;
+  QList<TagReaderClient::WriteFileData> write_files;
+  QMap<QString, UpdateCoverAction> write_cover_actions;
 
   for (int i = 0; i < data_.count(); ++i) {
     Data &ref = data_[i];
@@ -1422,7 +1551,6 @@ void EditTagDialog::SaveData() {
       if (ref.current_.year() <= 0) { ref.current_.set_year(-1); }
       if (ref.current_.originalyear() <= 0) { ref.current_.set_originalyear(-1); }
       if (ref.current_.lastplayed() <= 0) { ref.current_.set_lastplayed(-1); }
-      ++save_tag_pending_;
       SaveTagCoverData save_tag_cover_data;
       if (save_embedded_cover && ref.cover_action_ == UpdateCoverAction::New) {
         if (!ref.cover_result_.image.isNull()) {
@@ -1453,12 +1581,8 @@ void EditTagDialog::SaveData() {
       if (save_embedded_cover) {
         save_tags_options |= TagReaderClient::SaveOption::Cover;
       }
-      TagReaderReplyPtr reply = tagreader_client_->WriteFileAsync(ref.current_.url().toLocalFile(), ref.current_, save_tags_options, save_tag_cover_data, tag_id3v2_version);
-      SharedPtr<QMetaObject::Connection> connection = make_shared<QMetaObject::Connection>();
-      *connection = QObject::connect(&*reply, &TagReaderReply::Finished, this, [this, reply, ref, connection]() {
-        SongSaveTagsComplete(reply, ref.current_.url().toLocalFile(), ref.current_, ref.cover_action_);
-        QObject::disconnect(*connection);
-      }, Qt::QueuedConnection);
+      write_files << TagReaderClient::WriteFileData(ref.current_, save_tags_options, save_tag_cover_data, tag_id3v2_version);
+      write_cover_actions.insert(ref.current_.url().toLocalFile(), ref.cover_action_);
     }
     // If the cover was changed, but no tags written, make sure to update the collection.
     else if (ref.cover_action_ != UpdateCoverAction::None && !ref.current_.effective_albumartist().isEmpty() && !ref.current_.album().isEmpty()) {
@@ -1472,6 +1596,16 @@ void EditTagDialog::SaveData() {
 
   }
 
+  if (!write_files.isEmpty()) {
+    ++save_tag_pending_;
+    TagReaderWriteFilesReplyPtr reply = tagreader_client_->WriteFilesAsync(write_files);
+    SharedPtr<QMetaObject::Connection> connection = make_shared<QMetaObject::Connection>();
+    *connection = QObject::connect(&*reply, &TagReaderReply::Finished, this, [this, reply, write_cover_actions, connection]() {
+      SongsSaveTagsComplete(reply, write_cover_actions);
+      QObject::disconnect(*connection);
+    }, Qt::QueuedConnection);
+  }
+
   if (save_tag_pending_ <= 0) SaveDataFinished();
 
 }
@@ -1609,14 +1743,28 @@ void EditTagDialog::UpdateLyrics(const quint64 id, const QString &provider, cons
 
 }
 
-void EditTagDialog::SongSaveTagsComplete(TagReaderReplyPtr reply, const QString &filename, Song song, const UpdateCoverAction cover_action) {
+void EditTagDialog::SongsSaveTagsComplete(TagReaderWriteFilesReplyPtr reply, const QMap<QString, UpdateCoverAction> &cover_actions) {
 
   --save_tag_pending_;
 
-  const bool success = reply->success();
-  const QString error = reply->error();
-
-  if (success) {
+  const QMap<QString, Song> songs = reply->songs();
+  const QMap<QString, TagReaderResult> results = reply->results();
+  for (QMap<QString, TagReaderResult>::const_iterator it = results.constBegin(); it != results.constEnd(); ++it) {
+    const QString &filename = it.key();
+    const TagReaderResult &result = it.value();
+    if (!result.success()) {
+      const QString error = result.error_string();
+      if (error.isEmpty()) {
+        Q_EMIT Error(tr("Could not write metadata to %1").arg(filename));
+      }
+      else {
+        Q_EMIT Error(tr("Could not write metadata to %1: %2").arg(filename, error));
+      }
+      continue;
+    }
+    // The song has the file size and modification time after writing, so the collection doesn't read the file again.
+    Song song = songs.value(filename);
+    const UpdateCoverAction cover_action = cover_actions.value(filename, UpdateCoverAction::None);
     if (song.is_local_collection_song()) {
       if (collection_songs_.contains(song.id())) {
         Song old_song = collection_songs_.take(song.id());
@@ -1645,14 +1793,6 @@ void EditTagDialog::SongSaveTagsComplete(TagReaderReplyPtr reply, const QString
       current_albumcover_loader_->LoadAlbumCover(song);
     }
   }
-  else {
-    if (error.isEmpty()) {
-      Q_EMIT Error(tr("Could not write metadata to %1").arg(filename));
-    }
-    else {
-      Q_EMIT Error(tr("Could not write metadata to %1: %2").arg(filename, error));
-    }
-  }
 
   if (save_tag_pending_ <= 0) SaveDataFinished();
 
@@ -37,6 +37,7 @@
 
 #include "core/song.h"
 #include "tagreader/tagreaderclient.h"
+#include "tagreader/tagreaderwritefilesreply.h"
 #include "playlist/playlistitem.h"
 #include "covermanager/albumcoverloaderoptions.h"
 #include "covermanager/albumcoverloaderresult.h"
@@ -66,6 +67,9 @@ class TagFetcher;
 #endif
 class LyricsFetcher;
 
+template<typename T> class QPromise;
+template<typename T> class QFutureWatcher;
+
 class EditTagDialog : public QDialog {
   Q_OBJECT
 
@@ -118,8 +122,11 @@ class EditTagDialog : public QDialog {
     UpdateCoverAction cover_action_;
     AlbumCoverImageResult cover_result_;
   };
+  using LoadWatcher = QFutureWatcher<QList<Data>>;
 
  private Q_SLOTS:
+  void LoadDataReady(const int begin, const int end);
+  void LoadDataProgress(const int value);
   void SetSongsFinished();
   void SaveDataFinished();
 
@@ -135,6 +142,7 @@ class EditTagDialog : public QDialog {
   void UpdateLyrics(const quint64 id, const QString &provider, const QString &lyrics);
 
   void AlbumCoverLoaded(const quint64 id, const AlbumCoverLoaderResult &cover_result);
+  void CurrentTabChanged(const int index);
 
   void LoadCoverFromFile();
   void SaveCoverToFile();
@@ -148,7 +156,7 @@ class EditTagDialog : public QDialog {
   void PreviousSong();
   void NextSong();
 
-  void SongSaveTagsComplete(TagReaderReplyPtr reply, const QString &filename, Song song, const UpdateCoverAction cover_action);
+  void SongsSaveTagsComplete(TagReaderWriteFilesReplyPtr reply, const QMap<QString, UpdateCoverAction> &cover_actions);
 
  private:
   struct FieldData {
@@ -159,20 +167,29 @@ class EditTagDialog : public QDialog {
     QWidget *editor_;
     QString id_;
   };
+  struct FieldSummary {
+    FieldSummary() : varies_(false), modified_(false) {}
+
+    bool varies_;
+    bool modified_;
+  };
 
   Song *GetFirstSelected();
   void UpdateCover(const UpdateCoverAction cover_action, const AlbumCoverImageResult &cover_result = AlbumCoverImageResult());
 
-  bool DoesValueVary(const QModelIndexList &sel, const QString &id) const;
+  static bool IsValueModified(const QString &id, const QVariant &original, const QVariant &current);
   bool IsValueModified(const QModelIndexList &sel, const QString &id) const;
+  QList<FieldSummary> SummarizeFields(const QList<FieldData> &fields, const QModelIndexList &sel) const;
 
-  void InitFieldValue(const FieldData &field, const QModelIndexList &sel);
+  void InitFieldValue(const FieldData &field, const QModelIndexList &sel, const FieldSummary &summary);
   void UpdateFieldValue(const FieldData &field, const QModelIndexList &sel);
-  void UpdateModifiedField(const FieldData &field, const QModelIndexList &sel);
+  void UpdateModifiedField(const FieldData &field, const bool modified);
   void ResetFieldValue(const FieldData &field, const QModelIndexList &sel);
 
   void UpdateSummaryTab(const Song &song);
   void UpdateStatisticsTab(const Song &song);
+  void LoadTagsCover();
+  void LoadSummaryCover();
 
   QString GetArtSummary(const Song &song, const AlbumCoverLoaderResult::Type cover_type);
   QString GetArtSummary(const UpdateCoverAction cover_action);
@@ -183,7 +200,7 @@ class EditTagDialog : public QDialog {
   void SetSongListVisibility(bool visible);
 
   // Called by QtConcurrentRun
-  QList<Data> LoadData(const SongList &songs) const;
+  static void LoadData(QPromise<QList<Data>> &promise, const SharedPtr<TagReaderClient> tagreader_client, const SongList &songs);
   void SaveData();
 
   static void SetText(QLabel *label, const int value, const QString &suffix, const QString &def = QString());
@@ -213,6 +230,8 @@ class EditTagDialog : public QDialog {
   const QImage image_no_cover_thumbnail_;
 
   bool loading_;
+  // Reloads the tags of the songs in the background, they are added to the list in chunks as they arrive.
+  LoadWatcher *load_watcher_;
 
   PlaylistItemPtrList playlist_items_;
   QList<Data> data_;
@@ -223,6 +242,10 @@ class EditTagDialog : public QDialog {
   quint64 summary_cover_art_id_;
   quint64 tags_cover_art_id_;
   bool cover_art_is_set_;
+  // Covers are only loaded once the tab showing them is current.
+  bool tags_cover_pending_;
+  bool summary_cover_pending_;
+  Song summary_cover_song_;
 
   QPushButton *previous_button_;
   QPushButton *next_button_;
@@ -17,15 +17,20 @@
  *
  */
 
+#include <algorithm>
+#include <cstdlib>
+
 #include <QByteArray>
 #include <QString>
 #include <QDateTime>
+#include <QTimer>
 
 #include "constants/timeconstants.h"
 #include "constants/notificationssettings.h"
 #include "core/settings.h"
 #include "core/song.h"
 #include "core/player.h"
+#include "core/wakeupstatistics.h"
 #include "engine/enginebase.h"
 #include "playlist/playlistmanager.h"
 #include "discordrichpresence.h"
@@ -38,6 +43,14 @@ namespace {
 constexpr char kDiscordApplicationId[] = "1352351827206733974";
 constexpr char kStrawberryIconResourceName[] = "embedded_cover";
 constexpr char kStrawberryIconDescription[] = "Strawberry Music Player";
+
+// Wait for the player to settle, so scrubbing or skipping through tracks results in one update.
+constexpr int kSendDelayMsec = 1000;
+constexpr int kLowPowerSendDelayMsec = 5000;
+constexpr int kRateLimitWindowMsec = 15000;
+constexpr int kRateLimitUpdates = 5;
+// Differences in timestamps up to this are from rounding and not worth an update.
+constexpr qint64 kTimestampToleranceSecs = 2;
 }  // namespace
 
 DiscordRichPresence::DiscordRichPresence(const SharedPtr<Player> player, const SharedPtr<PlaylistManager> playlist_manager, QObject *parent)
@@ -45,14 +58,20 @@ DiscordRichPresence::DiscordRichPresence(const SharedPtr<Player> player, const S
       player_(player),
       playlist_manager_(playlist_manager),
       discord_rpc_(nullptr),
-      status_display_type_(0) {
+      status_display_type_(0),
+      timer_send_(new QTimer(this)),
+      playing_(false),
+      presence_sent_(false),
+      low_power_mode_(false) {
+
+  timer_send_->setSingleShot(true);
+  QObject::connect(timer_send_, &QTimer::timeout, this, &DiscordRichPresence::SendPendingPresence);
+  elapsed_.start();
 
   QObject::connect(&*player_->engine(), &EngineBase::StateChanged, this, &DiscordRichPresence::EngineStateChanged);
   QObject::connect(&*playlist_manager_, &PlaylistManager::CurrentSongChanged, this, &DiscordRichPresence::CurrentSongChanged);
   QObject::connect(&*player_, &Player::Seeked, this, &DiscordRichPresence::Seeked);
 
-  ReloadSettings();
-
 }
 
 DiscordRichPresence::~DiscordRichPresence() {
@@ -75,9 +94,12 @@ void DiscordRichPresence::ReloadSettings() {
 
   if (enabled && !discord_rpc_) {
     discord_rpc_ = new DiscordRPC(QString::fromLatin1(kDiscordApplicationId), this);
+    QObject::connect(discord_rpc_, &DiscordRPC::Ready, this, &DiscordRichPresence::DiscordReady);
     discord_rpc_->Initialize();
   }
   else if (!enabled && discord_rpc_) {
+    timer_send_->stop();
+    presence_sent_ = false;
     discord_rpc_->ClearPresence();
     discord_rpc_->Shutdown();
     delete discord_rpc_;
@@ -90,14 +112,13 @@ void DiscordRichPresence::EngineStateChanged(const EngineBase::State state) {
 
   if (!discord_rpc_) return;
 
-  if (state == EngineBase::State::Playing) {
+  playing_ = state == EngineBase::State::Playing;
+  if (playing_) {
     SetTimestamp(player_->engine()->position_nanosec() / kNsecPerSec);
-    SendPresenceUpdate();
-  }
-  else {
-    discord_rpc_->ClearPresence();
   }
 
+  SchedulePresenceUpdate();
+
 }
 
 void DiscordRichPresence::CurrentSongChanged(const Song &song) {
@@ -110,13 +131,77 @@ void DiscordRichPresence::CurrentSongChanged(const Song &song) {
   activity_.artist = song.artist();
   activity_.album = song.album();
 
-  SendPresenceUpdate();
+  SchedulePresenceUpdate();
 
 }
 
-void DiscordRichPresence::SendPresenceUpdate() {
+void DiscordRichPresence::DiscordReady() {
 
-  if (!discord_rpc_) return;
+  // Anything sent before the connection was ready was dropped.
+  presence_sent_ = false;
+  SchedulePresenceUpdate();
+
+}
+
+void DiscordRichPresence::SchedulePresenceUpdate() {
+
+  const qint64 now = elapsed_.elapsed();
+  send_times_.removeIf([now](const qint64 send_time) { return now - send_time >= kRateLimitWindowMsec; });
+
+  qint64 delay = low_power_mode_ ? kLowPowerSendDelayMsec : kSendDelayMsec;
+  if (send_times_.count() >= kRateLimitUpdates) {
+    delay = std::max(delay, send_times_.first() + kRateLimitWindowMsec - now);
+  }
+
+  // Restart the timer, so a burst of changes is sent as one update.
+  timer_send_->start(static_cast<int>(delay));
+
+}
+
+void DiscordRichPresence::SetLowPowerMode(const bool low_power_mode) {
+
+  low_power_mode_ = low_power_mode;
+  timer_send_->setTimerType(low_power_mode_ ? Qt::VeryCoarseTimer : Qt::CoarseTimer);
+
+}
+
+void DiscordRichPresence::SendPendingPresence() {
+
+  WakeupStatistics::Add();
+
+  if (!discord_rpc_ || !discord_rpc_->IsConnected()) return;
+
+  if (playing_) {
+    // The elapsed and remaining time are shown by Discord from the timestamps, so nothing needs to be sent while playing.
+    const DiscordPresence presence = CreatePresence();
+    if (presence_sent_ && IsPresenceEqual(presence, sent_presence_)) return;
+    discord_rpc_->UpdatePresence(presence);
+    sent_presence_ = presence;
+    presence_sent_ = true;
+  }
+  else {
+    if (!presence_sent_) return;
+    discord_rpc_->ClearPresence();
+    presence_sent_ = false;
+  }
+
+  send_times_ << elapsed_.elapsed();
+
+}
+
+bool DiscordRichPresence::IsPresenceEqual(const DiscordPresence &a, const DiscordPresence &b) {
+
+  return a.type == b.type &&
+         a.status_display_type == b.status_display_type &&
+         a.state == b.state &&
+         a.details == b.details &&
+         a.large_image_text == b.large_image_text &&
+         std::abs(a.start_timestamp - b.start_timestamp) <= kTimestampToleranceSecs &&
+         std::abs(a.end_timestamp - b.end_timestamp) <= kTimestampToleranceSecs;
+
+}
+
+DiscordPresence DiscordRichPresence::CreatePresence() const {
 
   DiscordPresence presence;
 
@@ -147,7 +232,7 @@ void DiscordRichPresence::SendPresenceUpdate() {
   presence.start_timestamp = start_timestamp;
   presence.end_timestamp = start_timestamp + activity_.length_secs;
 
-  discord_rpc_->UpdatePresence(presence);
+  return presence;
 
 }
 
@@ -163,6 +248,6 @@ void DiscordRichPresence::Seeked(const qint64 seek_microseconds) {
   if (!discord_rpc_) return;
 
   SetTimestamp(seek_microseconds / 1000000LL);
-  SendPresenceUpdate();
+  SchedulePresenceUpdate();
 
 }
@@ -24,11 +24,15 @@
 
 #include <QObject>
 #include <QString>
+#include <QList>
+#include <QElapsedTimer>
 
 #include "includes/shared_ptr.h"
 #include "core/player.h"
 #include "engine/enginebase.h"
+#include "discordpresence.h"
 
+class QTimer;
 class Song;
 class Player;
 class PlaylistManager;
@@ -44,16 +48,24 @@ class DiscordRichPresence : public QObject {
                         QObject *parent = nullptr);
   ~DiscordRichPresence() override;
 
+  // Also connects to Discord when enabled, so the first call is deferred until after startup.
   void ReloadSettings();
   void Stop();
+  // Waits longer before sending changes, so skipping through tracks with the window hidden wakes up less often.
+  void SetLowPowerMode(const bool low_power_mode);
 
  private Q_SLOTS:
   void EngineStateChanged(const EngineBase::State state);
   void CurrentSongChanged(const Song &song);
   void Seeked(const qint64 seek_microseconds);
+  void DiscordReady();
+  void SendPendingPresence();
 
  private:
-  void SendPresenceUpdate();
+  // Presence changes are coalesced and sent after a short delay, and rate limited, so seeking doesn't flood Discord.
+  void SchedulePresenceUpdate();
+  DiscordPresence CreatePresence() const;
+  static bool IsPresenceEqual(const DiscordPresence &a, const DiscordPresence &b);
   void SetTimestamp(const qint64 seconds = 0);
 
   const SharedPtr<Player> player_;
@@ -72,6 +84,15 @@ class DiscordRichPresence : public QObject {
   Activity activity_;
   DiscordRPC *discord_rpc_;
   int status_display_type_;
+
+  QTimer *timer_send_;
+  QElapsedTimer elapsed_;
+  // Times of the updates sent within the rate limit window.
+  QList<qint64> send_times_;
+  bool playing_;
+  bool presence_sent_;
+  bool low_power_mode_;
+  DiscordPresence sent_presence_;
 };
 
 #endif  // DISCORDRICHPRESENCE_H
@@ -47,6 +47,10 @@ class DiscordRPC : public QObject {
 
   bool IsConnected() const { return state_ == State::Connected; }
 
+ Q_SIGNALS:
+  // Emitted when the handshake is done, presence updates sent before are dropped.
+  void Ready();
+
  private Q_SLOTS:
   void OnConnected();
   void OnDisconnected();
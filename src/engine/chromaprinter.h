@@ -24,14 +24,14 @@
 
 #include "config.h"
 
-#include <glib.h>
 #include <gst/gst.h>
-#include <gst/app/gstappsink.h>
+#include <chromaprint.h>
 
-#include <QBuffer>
 #include <QString>
 
-class Chromaprinter {
+#include "gstaudiodecoder.h"
+
+class Chromaprinter : public GstAudioDecoder::Sink {
   // Creates a Chromaprint fingerprint from a song.
   // Uses GStreamer to open and decode the file as PCM data and passes this to Chromaprint's code generator.
   // The generated code can be used to identify a song via Acoustid.
@@ -47,17 +47,15 @@ class Chromaprinter {
   QString CreateFingerprint();
 
  private:
-  static GstElement *CreateElement(const QString &factory_name, GstElement *bin = nullptr);
-
-  static void NewPadCallback(GstElement *element, GstPad *pad, gpointer data);
-  static GstFlowReturn NewBufferCallback(GstAppSink *app_sink, gpointer self);
+  GstCaps *DecodeCaps() const override;
+  bool NewSample(GstSample *sample) override;
 
  private:
   QString filename_;
 
-  GstElement *convert_element_;
-
-  QBuffer buffer_;
+  // Fed straight from the decoder as the file decodes, started with the rate and channels of the first sample.
+  ChromaprintContext *chromaprint_;
+  bool chromaprint_started_;
 };
 
 #endif  // CHROMAPRINTER_H
@@ -19,11 +19,20 @@
 
 #include "config.h"
 
+#include <chrono>
+
 #include <QtAlgorithms>
 #include <QObject>
 #include <QList>
+#include <QString>
+#include <QDir>
+#include <QTimer>
+#include <QFuture>
+#include <QFutureWatcher>
+#include <QFileSystemWatcher>
 
 #include "core/logging.h"
+#include "core/taskexecutor.h"
 #include "devicefinders.h"
 #include "devicefinder.h"
 
@@ -50,15 +59,38 @@
 #endif  // Q_OS_WIN32
 
 using namespace Qt::Literals::StringLiterals;
+using namespace std::chrono_literals;
+
+namespace {
+// Linux creates and removes the device nodes here when sound cards are plugged in or out.
+constexpr char kSoundDevicesPath[] = "/dev/snd";
+}  // namespace
 
-DeviceFinders::DeviceFinders(QObject *parent) : QObject(parent) {
+DeviceFinders::DeviceFinders(QObject *parent)
+    : QObject(parent),
+      refresh_watcher_(nullptr),
+      refresh_pending_(false),
+      timer_refresh_(new QTimer(this)),
+      sound_devices_watcher_(nullptr) {
 
   setObjectName(QLatin1String(QObject::metaObject()->className()));
 
+  // Devices are often added or removed a few at a time.
+  timer_refresh_->setSingleShot(true);
+  timer_refresh_->setInterval(1s);
+  QObject::connect(timer_refresh_, &QTimer::timeout, this, &DeviceFinders::Refresh);
+
 }
 
 DeviceFinders::~DeviceFinders() {
+
+  // The finders are still in use by the background task.
+  if (refresh_watcher_) {
+    refresh_watcher_->waitForFinished();
+  }
+
   qDeleteAll(device_finders_);
+
 }
 
 void DeviceFinders::Init() {
@@ -94,4 +126,71 @@ void DeviceFinders::Init() {
     device_finders_.append(finder);
   }
 
+  if (QDir(QLatin1String(kSoundDevicesPath)).exists()) {
+    sound_devices_watcher_ = new QFileSystemWatcher(QStringList() << QLatin1String(kSoundDevicesPath), this);
+    QObject::connect(sound_devices_watcher_, &QFileSystemWatcher::directoryChanged, timer_refresh_, QOverload<>::of(&QTimer::start));
+  }
+
+  Refresh();
+
+}
+
+EngineDeviceList DeviceFinders::Devices(const QString &output) const {
+
+  EngineDeviceList devices;
+  for (DeviceFinder *device_finder : device_finders_) {
+    if (device_finder->outputs().contains(output)) {
+      devices << devices_.value(device_finder);
+    }
+  }
+
+  return devices;
+
+}
+
+void DeviceFinders::Refresh() {
+
+  if (device_finders_.isEmpty()) return;
+
+  // The finders aren't thread safe, only list them again when the running task is done.
+  if (refresh_watcher_) {
+    refresh_pending_ = true;
+    return;
+  }
+
+  refresh_watcher_ = new QFutureWatcher<DevicesList>(this);
+  QObject::connect(refresh_watcher_, &QFutureWatcher<DevicesList>::finished, this, &DeviceFinders::RefreshFinished);
+  refresh_watcher_->setFuture(TaskExecutor::Run(TaskExecutor::Lane::BackgroundIO, &DeviceFinders::ListDevices, device_finders_));
+
+}
+
+DeviceFinders::DevicesList DeviceFinders::ListDevices(const QList<DeviceFinder*> &device_finders) {
+
+  DevicesList devices_list;
+  devices_list.reserve(device_finders.count());
+  for (DeviceFinder *device_finder : device_finders) {
+    devices_list.append(device_finder->ListDevices());
+  }
+
+  return devices_list;
+
+}
+
+void DeviceFinders::RefreshFinished() {
+
+  const DevicesList devices_list = refresh_watcher_->result();
+  refresh_watcher_->deleteLater();
+  refresh_watcher_ = nullptr;
+
+  for (qsizetype i = 0; i < device_finders_.count() && i < devices_list.count(); ++i) {
+    devices_[device_finders_[i]] = devices_list[i];
+  }
+
+  Q_EMIT DevicesChanged();
+
+  if (refresh_pending_) {
+    refresh_pending_ = false;
+    Refresh();
+  }
+
 }
@@ -24,10 +24,19 @@
 
 #include <QObject>
 #include <QList>
+#include <QHash>
 #include <QString>
 
+#include "enginedevice.h"
+
+class QTimer;
+class QFileSystemWatcher;
+template<typename T> class QFutureWatcher;
 class DeviceFinder;
 
+// Keeps the audio output devices of all device finders.
+// The devices are listed in the background and cached, since some sound servers take a while to answer.
+// They are listed again when the sound devices change, where that can be detected, or when Refresh() is called.
 class DeviceFinders : public QObject {
   Q_OBJECT
 
@@ -38,8 +47,28 @@ class DeviceFinders : public QObject {
   void Init();
   QList<DeviceFinder*> ListFinders() { return device_finders_; }
 
+  // Returns the cached devices for the output without blocking, they might not be listed yet.
+  EngineDeviceList Devices(const QString &output) const;
+
+ public Q_SLOTS:
+  void Refresh();
+
+ Q_SIGNALS:
+  void DevicesChanged();
+
+ private Q_SLOTS:
+  void RefreshFinished();
+
  private:
+  using DevicesList = QList<EngineDeviceList>;
+  static DevicesList ListDevices(const QList<DeviceFinder*> &device_finders);
+
   QList<DeviceFinder*> device_finders_;
+  QHash<DeviceFinder*, EngineDeviceList> devices_;
+  QFutureWatcher<DevicesList> *refresh_watcher_;
+  bool refresh_pending_;
+  QTimer *timer_refresh_;
+  QFileSystemWatcher *sound_devices_watcher_;
 };
 
 #endif  // DEVICEFINDERS_H
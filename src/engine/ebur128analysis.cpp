@@ -20,8 +20,6 @@
 #include "config.h"
 
 #include <cmath>
-#include <cstdlib>
-#include <cstring>
 #include <optional>
 #include <tuple>
 #include <vector>
@@ -31,7 +29,6 @@
 #include <glib.h>
 #include <gst/gst.h>
 #include <gst/audio/audio-channels.h>
-#include <gst/app/gstappsink.h>
 #include <gst/pbutils/pbutils.h>
 #include <ebur128.h>
 
@@ -42,7 +39,7 @@
 #include <QtGlobal>
 
 #include "core/logging.h"
-#include "core/signalchecker.h"
+#include "gstaudiodecoder.h"
 
 #include "ebur128analysis.h"
 
@@ -57,10 +54,6 @@ struct ebur128_state_deleter {
   void operator()(ebur128_state *p) const { ebur128_destroy(&p); };
 };
 
-struct GstSampleDeleter {
-  void operator()(GstSample *s) const { gst_sample_unref(s); };
-};
-
 // Remap from the channels defined in SMPTE 2036-2-2008
 // to the channels defined in ITU R-REC-BS 1770-4.
 //
@@ -199,19 +192,17 @@ class EBUR128State {
   unique_ptr<ebur128_state, ebur128_state_deleter> st;
 };
 
-class EBUR128AnalysisImpl {
+class EBUR128AnalysisImpl : public GstAudioDecoder::Sink {
   EBUR128AnalysisImpl() = default;
 
  public:
   static std::optional<EBUR128Measures> Compute(const Song &song);
 
  private:
-  GstElement *convert_element_ = nullptr;
+  GstCaps *DecodeCaps() const override;
+  bool NewSample(GstSample *sample) override;
 
   std::optional<EBUR128State> state;
-
-  static void NewPadCallback(GstElement *elt, GstPad *pad, gpointer data);
-  static GstFlowReturn NewBufferCallback(GstAppSink *app_sink, gpointer self);
 };
 
 FrameFormat::FrameFormat(GstCaps *caps) : channels(0), channel_mask(0), samplerate(0) {
@@ -335,62 +326,36 @@ std::optional<EBUR128Measures> EBUR128State::Finalize(EBUR128State &&state) {
 
 }
 
-void EBUR128AnalysisImpl::NewPadCallback(GstElement *elt, GstPad *pad, gpointer data) {
-
-  Q_UNUSED(elt);
-
-  EBUR128AnalysisImpl *me = reinterpret_cast<EBUR128AnalysisImpl*>(data);
-  GstPad *const audiopad = gst_element_get_static_pad(me->convert_element_, "sink");
+GstCaps *EBUR128AnalysisImpl::DecodeCaps() const {
 
-  if (GST_PAD_IS_LINKED(audiopad)) {
-    qLog(Warning) << "audiopad is already linked, unlinking old pad";
-    gst_pad_unlink(audiopad, GST_PAD_PEER(audiopad));
-  }
+  GstStaticCaps static_caps = GST_STATIC_CAPS("audio/x-raw,"
+                                              "format = (string) { S16LE, S32LE, F32LE, F64LE },"
+                                              "layout = (string) interleaved");
 
-  gst_pad_link(pad, audiopad);
-  gst_object_unref(audiopad);
+  return gst_static_caps_get(&static_caps);
 
 }
 
-GstFlowReturn EBUR128AnalysisImpl::NewBufferCallback(GstAppSink *app_sink, gpointer self) {
-
-  EBUR128AnalysisImpl *me = reinterpret_cast<EBUR128AnalysisImpl*>(self);
+bool EBUR128AnalysisImpl::NewSample(GstSample *sample) {
 
-  unique_ptr<GstSample, GstSampleDeleter> sample(gst_app_sink_pull_sample(app_sink));
-  if (!sample) return GST_FLOW_ERROR;
-
-  const FrameFormat dsc(gst_sample_get_caps(&*sample));
-  if (!me->state) {
-    me->state.emplace(dsc);
+  const FrameFormat dsc(gst_sample_get_caps(sample));
+  if (!state) {
+    state.emplace(dsc);
   }
-  else if (me->state->dsc != dsc) {
-    return GST_FLOW_ERROR;
+  else if (state->dsc != dsc) {
+    return false;
   }
 
-  GstBuffer *buffer = gst_sample_get_buffer(&*sample);
+  GstBuffer *buffer = gst_sample_get_buffer(sample);
   if (buffer) {
     GstMapInfo map;
     if (gst_buffer_map(buffer, &map, GST_MAP_READ)) {
-      me->state->AddFrames(reinterpret_cast<const char*>(map.data), static_cast<size_t>(map.size));
+      state->AddFrames(reinterpret_cast<const char*>(map.data), static_cast<size_t>(map.size));
       gst_buffer_unmap(buffer, &map);
     }
   }
 
-  return GST_FLOW_OK;
-
-}
-
-GstElement *CreateElement(const QString &factory_name, GstElement *bin) {
-
-  GstElement *ret = gst_element_factory_make(factory_name.toLatin1().constData(), factory_name.toLatin1().constData());
-
-  if (ret && bin) gst_bin_add(GST_BIN(bin), ret);
-
-  if (!ret) {
-    qLog(Warning) << "Couldn't create the gstreamer element" << factory_name;
-  }
-
-  return ret;
+  return true;
 
 }
 
@@ -398,99 +363,19 @@ std::optional<EBUR128Measures> EBUR128AnalysisImpl::Compute(const Song &song) {
 
   EBUR128AnalysisImpl impl;
 
-  GstElement *pipeline = gst_pipeline_new("pipeline");
-  if (!pipeline) {
-    return std::nullopt;
-  }
-
-  GstElement *src = CreateElement(u"filesrc"_s, pipeline);
-  GstElement *decode = CreateElement(u"decodebin"_s, pipeline);
-  GstElement *convert = CreateElement(u"audioconvert"_s, pipeline);
-  GstElement *queue = CreateElement(u"queue2"_s, pipeline);
-  GstElement *sink = CreateElement(u"appsink"_s, pipeline);
-
-  if (!src || !decode || !convert || !queue || !sink) {
-    gst_object_unref(pipeline);
-    return std::nullopt;
-  }
-
-  impl.convert_element_ = convert;
-
-  // Connect the elements
-  gst_element_link_many(src, decode, nullptr);
-
-  GstStaticCaps static_caps = GST_STATIC_CAPS("audio/x-raw,"
-                                              "format = (string) { S16LE, S32LE, F32LE, F64LE },"
-                                              "layout = (string) interleaved");
-
-  GstCaps *caps = gst_static_caps_get(&static_caps);
-  // Place a queue before the sink. It really does matter for performance.
-  gst_element_link_filtered(convert, queue, caps);
-  gst_element_link_many(queue, sink, nullptr);
-  gst_caps_unref(caps);
-
-  // Allow the queue to contain up to 60s of audio. It is a magical number,
-  // going higher does not appear to be beneficial for performance,
-  // and while it can be lower, that generally restricts decoding parallelizm.
-  g_object_set(G_OBJECT(queue), "max-size-time", 60 * GST_SECOND, nullptr);
-  // And disable the default buffer and byte limits.
-  g_object_set(G_OBJECT(queue), "max-size-buffers", 0, nullptr);
-  g_object_set(G_OBJECT(queue), "max-size-bytes", 0, nullptr);
-
-  GstAppSinkCallbacks callbacks;
-  memset(&callbacks, 0, sizeof(callbacks));
-  callbacks.new_sample = NewBufferCallback;
-  gst_app_sink_set_callbacks(reinterpret_cast<GstAppSink*>(sink), &callbacks, &impl, nullptr);
-  g_object_set(G_OBJECT(sink), "buffer-list", FALSE, nullptr);
-  g_object_set(G_OBJECT(sink), "sync", FALSE, nullptr);
-  g_object_set(G_OBJECT(sink), "emit-signals", TRUE, nullptr);
-
-  // Disable in-appsink buffering, since we place a proper queue before it.
-  g_object_set(G_OBJECT(sink), "max-buffers", 1, nullptr);
-
-  // Set the filename
-  g_object_set(src, "location", song.url().toLocalFile().toUtf8().constData(), nullptr);
-
-  // Connect signals
-  GstBus *bus = gst_pipeline_get_bus(GST_PIPELINE(pipeline));
-  CHECKED_GCONNECT(decode, "pad-added", &NewPadCallback, &impl);
-
-  // Play only the specified song!
-  gst_element_set_state(pipeline, GST_STATE_PAUSED);
-  // wait for state change before seeking
-  gst_element_get_state(pipeline, nullptr, nullptr, kTimeoutSecs * GST_SECOND);
-  gst_element_seek(pipeline, 1.0, GST_FORMAT_TIME, GST_SEEK_FLAG_FLUSH, GST_SEEK_TYPE_SET, song.beginning_nanosec() * GST_NSECOND, GST_SEEK_TYPE_SET, song.end_nanosec() * GST_NSECOND);
-
   QElapsedTimer time;
   time.start();
 
-  // Start playing
-  gst_element_set_state(pipeline, GST_STATE_PLAYING);
-
-  // Wait until EOS or error
-  bool hadError = false;
-  GstMessage *msg = gst_bus_timed_pop_filtered(bus, kTimeoutSecs * GST_SECOND, static_cast<GstMessageType>(GST_MESSAGE_EOS | GST_MESSAGE_ERROR));
-  if (msg) {
-    if (msg->type == GST_MESSAGE_ERROR) {
-      hadError = true;
-      // Report error
-      GError *error = nullptr;
-      gchar *debugs = nullptr;
-      gst_message_parse_error(msg, &error, &debugs);
-      if (error) {
-        QString message = QString::fromLocal8Bit(error->message);
-        g_error_free(error);
-        qLog(Debug) << "Error processing " << song.url() << ":" << message;
-      }
-      if (debugs) free(debugs);
-    }
-    gst_message_unref(msg);
-  }
+  // Play only the specified song!
+  GstAudioDecoder decoder(song.url().toLocalFile());
+  decoder.AddSink(&impl);
+  decoder.SetSegment(song.beginning_nanosec(), song.end_nanosec());
+  const bool success = decoder.Decode(kTimeoutSecs);
 
   const qint64 decode_time = time.restart();
 
   std::optional<EBUR128Measures> result;
-  if (!hadError && impl.state) {
+  if (success && impl.state) {
     // Generate loudness characteristics from sampled data.
     result = EBUR128State::Finalize(std::move(impl.state.value()));
 
@@ -499,12 +384,6 @@ std::optional<EBUR128Measures> EBUR128AnalysisImpl::Compute(const Song &song) {
     qLog(Debug) << "Decode time:" << decode_time << "Finalization time:" << finalize_time;
   }
 
-  // Cleanup
-  callbacks.new_sample = nullptr;
-  gst_object_unref(bus);
-  gst_element_set_state(pipeline, GST_STATE_NULL);
-  gst_object_unref(pipeline);
-
   return result;
 
 }
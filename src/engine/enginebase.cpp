@@ -44,10 +44,16 @@
 
 using namespace Qt::Literals::StringLiterals;
 
+namespace {
+// ReplayGain 2.0 reference level
+constexpr double kReplayGainReferenceLevelLUFS = -18.0;
+}  // namespace
+
 EngineBase::EngineBase(QObject *parent)
     : QObject(parent),
       playbin3_enabled_(true),
       exclusive_mode_(false),
+      low_latency_(false),
       volume_control_(true),
       volume_(100),
       beginning_offset_nanosec_(0),
@@ -61,6 +67,7 @@ EngineBase::EngineBase(QObject *parent)
       rg_preamp_(0.0),
       rg_fallbackgain_(0.0),
       rg_compression_(true),
+      rg_from_loudness_(false),
       ebur128_loudness_normalization_(false),
       ebur128_target_level_lufs_(-23.0),
       buffer_duration_nanosec_(BackendSettings::kDefaultBufferDuration * kNsecPerMsec),
@@ -81,7 +88,9 @@ EngineBase::EngineBase(QObject *parent)
       bs2b_enabled_(false),
       http2_enabled_(true),
       strict_ssl_enabled_(false),
-      about_to_end_emitted_(false) {}
+      about_to_end_emitted_(false),
+      fast_transport_allowed_(false),
+      stream_discovery_needed_(true) {}
 
 EngineBase::~EngineBase() = default;
 
@@ -95,17 +104,21 @@ bool EngineBase::Load(const QUrl &media_url, const QUrl &stream_url, const Track
   beginning_offset_nanosec_ = beginning_offset_nanosec;
   end_offset_nanosec_ = end_offset_nanosec;
 
+  auto computeGain_dB = [](double source_dB, double target_dB) {
+    // Let's suppose the `source_dB` is -12 dB, while `target_dB` is -23 dB.
+    // In that case, we'd need to apply -11 dB of gain, which is computed as:
+    //   -12 dB + x dB = -23 dB --> x dB = -23 dB - (-12 dB)
+    return target_dB - source_dB;
+  };
+
   ebur128_loudness_normalizing_gain_db_ = 0.0;
   if (ebur128_loudness_normalization_ && ebur128_integrated_loudness_lufs) {
-    auto computeGain_dB = [](double source_dB, double target_dB) {
-      // Let's suppose the `source_dB` is -12 dB, while `target_dB` is -23 dB.
-      // In that case, we'd need to apply -11 dB of gain, which is computed as:
-      //   -12 dB + x dB = -23 dB --> x dB = -23 dB - (-12 dB)
-      return target_dB - source_dB;
-    };
-
     ebur128_loudness_normalizing_gain_db_ = computeGain_dB(*ebur128_integrated_loudness_lufs, ebur128_target_level_lufs_);
   }
+  else if (replaygain_from_loudness()) {
+    // The gain is applied by the same single volume element as the loudness normalization, so rgvolume doesn't have to wait for tags.
+    ebur128_loudness_normalizing_gain_db_ = (ebur128_integrated_loudness_lufs ? computeGain_dB(*ebur128_integrated_loudness_lufs, kReplayGainReferenceLevelLUFS) : rg_fallbackgain_) + rg_preamp_;
+  }
 
   about_to_end_emitted_ = false;
 
@@ -123,6 +136,26 @@ bool EngineBase::Play(const QUrl &media_url, const QUrl &stream_url, const bool
 
 }
 
+void EngineBase::SetStreamDiscovery(const QUrl &media_url, const bool needed, const QString &cache_key) {
+
+  stream_discovery_media_url_ = media_url;
+  stream_discovery_needed_ = needed;
+  stream_discovery_cache_key_ = cache_key;
+
+}
+
+bool EngineBase::StreamDiscoveryNeeded(const QUrl &media_url, QString &cache_key) const {
+
+  if (media_url != stream_discovery_media_url_) {
+    cache_key.clear();
+    return true;
+  }
+
+  cache_key = stream_discovery_cache_key_;
+  return stream_discovery_needed_;
+
+}
+
 void EngineBase::UpdateVolume(const uint volume) {
 
   volume_ = volume;
@@ -161,6 +194,8 @@ void EngineBase::ReloadSettings() {
 
   exclusive_mode_ = s.value(BackendSettings::kExclusiveMode, false).toBool();
 
+  low_latency_ = s.value(BackendSettings::kLowLatency, false).toBool();
+
   volume_control_ = s.value(BackendSettings::kVolumeControl, true).toBool();
 
   channels_enabled_ = s.value(BackendSettings::kChannelsEnabled, false).toBool();
@@ -175,6 +210,7 @@ void EngineBase::ReloadSettings() {
   rg_preamp_ = s.value(BackendSettings::kRgPreamp, 0.0).toDouble();
   rg_fallbackgain_ = s.value(BackendSettings::kRgFallbackGain, 0.0).toDouble();
   rg_compression_ = s.value(BackendSettings::kRgCompression, true).toBool();
+  rg_from_loudness_ = s.value(BackendSettings::kRgFromLoudness, false).toBool();
 
   ebur128_loudness_normalization_ = s.value(BackendSettings::kEBUR128LoudnessNormalization, false).toBool();
   ebur128_target_level_lufs_ = s.value(BackendSettings::kEBUR128TargetLevelLUFS, -23.0).toDouble();
@@ -29,6 +29,8 @@
 #include <sys/types.h>
 #include <cstdint>
 #include <vector>
+#include <optional>
+#include <atomic>
 
 #include <QtGlobal>
 #include <QObject>
@@ -88,6 +90,12 @@ class EngineBase : public QObject {
 
   using Scope = std::vector<int16_t>;
 
+  enum class TransportCommand {
+    Play,
+    Pause,
+    PlayPause
+  };
+
   virtual bool Init() = 0;
   virtual State state() const = 0;
   virtual void StartPreloading(const QUrl&, const QUrl&, const bool, const qint64, const qint64) {}
@@ -99,9 +107,39 @@ class EngineBase : public QObject {
   virtual void Seek(const quint64 offset_nanosec) = 0;
   virtual void SetVolumeSW(const uint percent) = 0;
 
+  // Thread safe, pauses or resumes the current stream without going through the event loop of the main thread, StateChanged() follows from there.
+  // Returns the new state, or nothing when the command has to go through the player instead.
+  virtual std::optional<State> TransportFast(const TransportCommand command) { Q_UNUSED(command) return std::nullopt; }
+  // Set by the player for the current song, songs that can't be paused or need to be reloaded when resumed always go through the player.
+  void set_fast_transport_allowed(const bool allowed) { fast_transport_allowed_.store(allowed, std::memory_order_relaxed); }
+
+  // Set by the player before a song is played or preloaded.
+  // Stream discovery is skipped when the song already has reliable audio properties, otherwise the results are cached by the key, when there is one.
+  void SetStreamDiscovery(const QUrl &media_url, const bool needed, const QString &cache_key);
+
   virtual qint64 position_nanosec() const = 0;
   virtual qint64 length_nanosec() const = 0;
 
+  // Statistics shown in the console, -1 when not known.
+  virtual qint64 output_latency_nanosec() const { return -1; }
+  virtual qint64 buffered_nanosec() const { return -1; }
+  virtual int buffering_percent() const { return -1; }
+
+  struct NetworkBufferStatistics {
+    NetworkBufferStatistics() : input_rate(-1), output_rate(-1), jitter(0.0), buffer_duration_nanosec(0), underruns(0) {}
+    // Rates of the decoded audio going into and out of the buffer, in bytes per second, -1 when not known.
+    qint64 input_rate;
+    qint64 output_rate;
+    // Average deviation of the input rate, relative to the input rate.
+    double jitter;
+    quint64 buffer_duration_nanosec;
+    int underruns;
+    // How many times faster than it is played the stream arrives, 0 when not known.
+    double throughput_ratio() const { return input_rate > 0 && output_rate > 0 ? static_cast<double>(input_rate) / static_cast<double>(output_rate) : 0.0; }
+  };
+  // Only for network streams.
+  virtual std::optional<NetworkBufferStatistics> network_buffer_statistics() const { return std::nullopt; }
+
   virtual const Scope &scope(const int chunk_length) { Q_UNUSED(chunk_length); return scope_; }
 
   // Sets new values for the beginning and end markers of the currently playing song.
@@ -149,6 +187,8 @@ class EngineBase : public QObject {
   virtual void SetStereoBalance(const float) {}
   virtual void SetEqualizerEnabled(const bool) {}
   virtual void SetEqualizerParameters(const int, const QList<int>&) {}
+  // Enabled while nothing shows the analyzer, ie: the window is hidden, to wake the CPU less often during playback.
+  virtual void SetLowPowerMode(const bool) {}
 
  Q_SIGNALS:
   // Emitted when crossfading is enabled and the track is crossfade_duration_ away from finishing
@@ -184,6 +224,7 @@ class EngineBase : public QObject {
  protected:
   bool playbin3_enabled_;
   bool exclusive_mode_;
+  bool low_latency_;
   bool volume_control_;
   uint volume_;
   quint64 beginning_offset_nanosec_;
@@ -205,6 +246,10 @@ class EngineBase : public QObject {
   double rg_preamp_;
   double rg_fallbackgain_;
   bool rg_compression_;
+  bool rg_from_loudness_;
+
+  // ReplayGain in track mode computed from the collection's EBU R 128 loudness, instead of rgvolume reading the tags.
+  bool replaygain_from_loudness() const { return rg_enabled_ && rg_from_loudness_ && rg_mode_ == 0 && !ebur128_loudness_normalization_; }
 
   // EBU R 128 Loudness Normalization
   bool ebur128_loudness_normalization_;
@@ -248,6 +293,15 @@ class EngineBase : public QObject {
 
   bool about_to_end_emitted_;
 
+  std::atomic<bool> fast_transport_allowed_;
+
+  // Returns false when the player said the song doesn't need stream discovery.
+  bool StreamDiscoveryNeeded(const QUrl &media_url, QString &cache_key) const;
+
+  QUrl stream_discovery_media_url_;
+  bool stream_discovery_needed_;
+  QString stream_discovery_cache_key_;
+
   Q_DISABLE_COPY(EngineBase)
 };
 
@@ -0,0 +1,237 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "config.h"
+
+#include <utility>
+#include <cstdlib>
+#include <cstring>
+
+#include <glib.h>
+#include <glib-object.h>
+#include <gst/gst.h>
+#include <gst/app/gstappsink.h>
+
+#include <QtGlobal>
+#include <QList>
+#include <QString>
+
+#include "core/logging.h"
+#include "core/signalchecker.h"
+#include "gststartup.h"
+#include "gstaudiodecoder.h"
+
+using namespace Qt::Literals::StringLiterals;
+
+namespace {
+// Allow every branch to queue up to 60s of audio, so a slow sink doesn't hold up the decoder or the other sinks.
+constexpr guint64 kQueueMaxSizeTime = 60 * GST_SECOND;
+}  // namespace
+
+GstAudioDecoder::GstAudioDecoder(const QString &filename)
+    : filename_(filename),
+      beginning_nanosec_(0),
+      end_nanosec_(-1),
+      tee_(nullptr) {}
+
+void GstAudioDecoder::AddSink(Sink *sink) {
+
+  sinks_ << sink;
+
+}
+
+void GstAudioDecoder::SetSegment(const qint64 beginning_nanosec, const qint64 end_nanosec) {
+
+  beginning_nanosec_ = beginning_nanosec;
+  end_nanosec_ = end_nanosec;
+
+}
+
+GstElement *GstAudioDecoder::CreateElement(const QString &factory_name, GstElement *bin) {
+
+  GstElement *ret = gst_element_factory_make(factory_name.toLatin1().constData(), nullptr);
+
+  if (ret && bin) gst_bin_add(GST_BIN(bin), ret);
+
+  if (!ret) {
+    qLog(Warning) << "Couldn't create the gstreamer element" << factory_name;
+  }
+
+  return ret;
+
+}
+
+bool GstAudioDecoder::CreateBranch(GstElement *pipeline, Sink *sink) {
+
+  GstElement *convert = CreateElement(u"audioconvert"_s, pipeline);
+  GstElement *queue = CreateElement(u"queue2"_s, pipeline);
+  GstElement *appsink = CreateElement(u"appsink"_s, pipeline);
+  if (!convert || !queue || !appsink) {
+    return false;
+  }
+
+  GstCaps *caps = sink->DecodeCaps();
+  // Place a queue before the sink. It really does matter for performance.
+  gst_element_link_filtered(convert, queue, caps);
+  gst_element_link(queue, appsink);
+  gst_caps_unref(caps);
+
+  g_object_set(G_OBJECT(queue), "max-size-time", kQueueMaxSizeTime, nullptr);
+  g_object_set(G_OBJECT(queue), "max-size-buffers", 0, nullptr);
+  g_object_set(G_OBJECT(queue), "max-size-bytes", 0, nullptr);
+
+  GstAppSinkCallbacks callbacks;
+  memset(&callbacks, 0, sizeof(callbacks));
+  callbacks.new_sample = NewSampleCallback;
+  gst_app_sink_set_callbacks(reinterpret_cast<GstAppSink*>(appsink), &callbacks, sink, nullptr);
+  g_object_set(G_OBJECT(appsink), "buffer-list", FALSE, nullptr);
+  g_object_set(G_OBJECT(appsink), "sync", FALSE, nullptr);
+  // Disable in-appsink buffering, since we place a proper queue before it.
+  g_object_set(G_OBJECT(appsink), "max-buffers", 1, nullptr);
+
+  if (tee_) {
+    gst_element_link(tee_, convert);
+  }
+
+  converts_ << convert;
+
+  return true;
+
+}
+
+bool GstAudioDecoder::Decode(const int timeout_secs) {
+
+  GstStartup::WaitForInitialized();
+
+  error_.clear();
+  converts_.clear();
+  tee_ = nullptr;
+
+  if (sinks_.isEmpty()) {
+    error_ = u"No sinks to decode to."_s;
+    return false;
+  }
+
+  GstElement *pipeline = gst_pipeline_new("pipeline");
+  if (!pipeline) {
+    error_ = u"Could not create GStreamer pipeline."_s;
+    return false;
+  }
+
+  GstElement *src = CreateElement(u"filesrc"_s, pipeline);
+  GstElement *decode = CreateElement(u"decodebin"_s, pipeline);
+  // A single sink is linked straight to decodebin, more than one share the decoded stream through a tee.
+  if (sinks_.count() > 1) {
+    tee_ = CreateElement(u"tee"_s, pipeline);
+  }
+
+  bool success = src && decode && (sinks_.count() == 1 || tee_);
+  for (Sink *sink : std::as_const(sinks_)) {
+    if (!success) break;
+    success = CreateBranch(pipeline, sink);
+  }
+  if (!success) {
+    gst_object_unref(pipeline);
+    converts_.clear();
+    tee_ = nullptr;
+    error_ = u"Could not create GStreamer elements."_s;
+    return false;
+  }
+
+  // Connect the elements
+  gst_element_link(src, decode);
+
+  // Set the filename
+  g_object_set(src, "location", filename_.toUtf8().constData(), nullptr);
+
+  // Connect signals
+  GstBus *bus = gst_pipeline_get_bus(GST_PIPELINE(pipeline));
+  CHECKED_GCONNECT(decode, "pad-added", &NewPadCallback, this);
+
+  // Play only the requested segment
+  gst_element_set_state(pipeline, GST_STATE_PAUSED);
+  // wait for state change before seeking
+  gst_element_get_state(pipeline, nullptr, nullptr, timeout_secs * GST_SECOND);
+  gst_element_seek(pipeline, 1.0, GST_FORMAT_TIME, GST_SEEK_FLAG_FLUSH, GST_SEEK_TYPE_SET, beginning_nanosec_ * GST_NSECOND, GST_SEEK_TYPE_SET, end_nanosec_ < 0 ? static_cast<gint64>(GST_CLOCK_TIME_NONE) : end_nanosec_ * GST_NSECOND);
+
+  // Start playing
+  gst_element_set_state(pipeline, GST_STATE_PLAYING);
+
+  // Wait until EOS or error
+  GstMessage *msg = gst_bus_timed_pop_filtered(bus, timeout_secs * GST_SECOND, static_cast<GstMessageType>(GST_MESSAGE_EOS | GST_MESSAGE_ERROR));
+  if (msg) {
+    if (msg->type == GST_MESSAGE_ERROR) {
+      success = false;
+      // Report error
+      GError *error = nullptr;
+      gchar *debugs = nullptr;
+      gst_message_parse_error(msg, &error, &debugs);
+      if (error) {
+        error_ = QString::fromLocal8Bit(error->message);
+        g_error_free(error);
+        qLog(Debug) << "Error processing" << filename_ << ":" << error_;
+      }
+      if (debugs) free(debugs);
+    }
+    gst_message_unref(msg);
+  }
+
+  // Cleanup, this stops the streaming threads so the sinks won't get any more samples.
+  gst_object_unref(bus);
+  gst_element_set_state(pipeline, GST_STATE_NULL);
+  gst_object_unref(pipeline);
+
+  converts_.clear();
+  tee_ = nullptr;
+
+  return success;
+
+}
+
+void GstAudioDecoder::NewPadCallback(GstElement *element, GstPad *pad, gpointer self) {
+
+  Q_UNUSED(element)
+
+  GstAudioDecoder *instance = reinterpret_cast<GstAudioDecoder*>(self);
+  GstElement *next = instance->tee_ ? instance->tee_ : instance->converts_.first();
+  GstPad *const audiopad = gst_element_get_static_pad(next, "sink");
+
+  if (GST_PAD_IS_LINKED(audiopad)) {
+    qLog(Warning) << "audiopad is already linked, unlinking old pad";
+    gst_pad_unlink(audiopad, GST_PAD_PEER(audiopad));
+  }
+
+  gst_pad_link(pad, audiopad);
+  gst_object_unref(audiopad);
+
+}
+
+GstFlowReturn GstAudioDecoder::NewSampleCallback(GstAppSink *app_sink, gpointer self) {
+
+  Sink *sink = reinterpret_cast<Sink*>(self);
+
+  GstSample *sample = gst_app_sink_pull_sample(app_sink);
+  if (!sample) return GST_FLOW_ERROR;
+
+  const bool success = sink->NewSample(sample);
+  gst_sample_unref(sample);
+
+  return success ? GST_FLOW_OK : GST_FLOW_ERROR;
+
+}
@@ -0,0 +1,83 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef GSTAUDIODECODER_H
+#define GSTAUDIODECODER_H
+
+#include "config.h"
+
+#include <glib.h>
+#include <gst/gst.h>
+#include <gst/app/gstappsink.h>
+
+#include <QtGlobal>
+#include <QList>
+#include <QString>
+
+// Decodes a local file to raw audio once, and hands the samples to every registered sink.
+// Each sink gets its own audioconvert branch, so sinks can ask for different formats.
+// Used by the analysers that only need PCM data, like Chromaprinter and EBUR128Analysis.
+class GstAudioDecoder {
+ public:
+  class Sink {
+   public:
+    virtual ~Sink() = default;
+
+    // Returns a new reference to the raw audio caps this sink wants the decoded audio converted to.
+    virtual GstCaps *DecodeCaps() const = 0;
+
+    // Called from a streaming thread for every decoded sample.
+    // Return false to abort decoding.
+    virtual bool NewSample(GstSample *sample) = 0;
+  };
+
+  explicit GstAudioDecoder(const QString &filename);
+
+  // The sinks need to stay alive until Decode() returns.
+  void AddSink(Sink *sink);
+
+  // Limit decoding to part of the file, a negative end decodes to the end of the file.
+  void SetSegment(const qint64 beginning_nanosec, const qint64 end_nanosec);
+
+  // Decodes the file, this method is blocking, so you want to call it in another thread.
+  // Returns false if the pipeline could not be created or posted an error, stopping on the timeout is not an error.
+  bool Decode(const int timeout_secs);
+
+  QString error() const { return error_; }
+
+ private:
+  static GstElement *CreateElement(const QString &factory_name, GstElement *bin);
+  bool CreateBranch(GstElement *pipeline, Sink *sink);
+
+  static void NewPadCallback(GstElement *element, GstPad *pad, gpointer self);
+  static GstFlowReturn NewSampleCallback(GstAppSink *app_sink, gpointer self);
+
+ private:
+  QString filename_;
+  qint64 beginning_nanosec_;
+  qint64 end_nanosec_;
+
+  QList<Sink*> sinks_;
+  QList<GstElement*> converts_;
+  GstElement *tee_;
+
+  QString error_;
+};
+
+#endif  // GSTAUDIODECODER_H
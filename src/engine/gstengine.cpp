@@ -53,14 +53,17 @@
 #include "includes/shared_ptr.h"
 #include "core/logging.h"
 #include "core/taskmanager.h"
+#include "core/backgroundiothrottle.h"
 #include "core/signalchecker.h"
 #include "core/enginemetadata.h"
+#include "core/wakeupstatistics.h"
 #include "constants/timeconstants.h"
 #include "enginebase.h"
 #include "gsturl.h"
 #include "gstengine.h"
 #include "gstenginepipeline.h"
 #include "gstbufferconsumer.h"
+#include "gststartup.h"
 
 using namespace Qt::Literals::StringLiterals;
 
@@ -86,9 +89,16 @@ constexpr char kOSXAudioSink[] = "osxaudiosink";
 constexpr char kWASAPISink[] = "wasapisink";
 constexpr char kWASAPI2Sink[] = "wasapi2sink";
 constexpr int kDiscoveryTimeoutS = 10;
+constexpr int kDiscoveryCacheSize = 1000;
 constexpr qint64 kTimerIntervalNanosec = 1000 * kNsecPerMsec;  // 1s
+constexpr qint64 kLowPowerTimerIntervalNanosec = 5000 * kNsecPerMsec;  // 5s
 constexpr qint64 kPreloadGapNanosec = 8000 * kNsecPerMsec;     // 8s
 constexpr qint64 kSeekDelayNanosec = 100 * kNsecPerMsec;       // 100msec
+// Network streams start with a shorter buffer when the last one arrived this many times faster than it was played, without much jitter
+constexpr double kFastNetworkThroughputRatio = 4.0;
+constexpr double kFastNetworkMaxJitter = 0.25;
+constexpr quint64 kFastNetworkBufferDivisor = 4;
+constexpr quint64 kMinNetworkBufferDurationNanosec = 500 * kNsecPerMsec;
 }  // namespace
 
 #ifdef __clang_
@@ -100,6 +110,8 @@ GstEngine::GstEngine(SharedPtr<TaskManager> task_manager, QObject *parent)
       task_manager_(task_manager),
       discoverer_(nullptr),
       buffering_task_id_(-1),
+      buffering_percent_(-1),
+      pending_scope_buffer_(nullptr),
       latest_buffer_(nullptr),
       stereo_balancer_enabled_(false),
       stereo_balance_(0.0F),
@@ -109,12 +121,14 @@ GstEngine::GstEngine(SharedPtr<TaskManager> task_manager, QObject *parent)
       waiting_to_seek_(false),
       seek_pos_(0),
       timer_id_(-1),
+      low_power_mode_(false),
       has_faded_out_to_pause_(false),
       scope_chunk_(0),
       have_new_buffer_(false),
       scope_chunks_(0),
       discovery_finished_cb_id_(-1),
       discovery_discovered_cb_id_(-1),
+      stream_discovery_cache_(kDiscoveryCacheSize),
       delayed_state_(State::Empty),
       delayed_state_pause_(false),
       delayed_state_offset_nanosec_(0) {
@@ -130,6 +144,14 @@ GstEngine::GstEngine(SharedPtr<TaskManager> task_manager, QObject *parent)
 GstEngine::~GstEngine() {
 
   current_pipeline_.reset();
+  UpdateFastTransport();
+  spare_pipeline_.reset();
+
+  ScopeBuffer *scope_buffer = pending_scope_buffer_.exchange(nullptr);
+  if (scope_buffer) {
+    gst_buffer_unref(scope_buffer->buffer);
+    delete scope_buffer;
+  }
 
   if (latest_buffer_) {
     gst_buffer_unref(latest_buffer_);
@@ -188,12 +210,7 @@ void GstEngine::StartPreloading(const QUrl &media_url, const QUrl &stream_url, c
       current_pipeline_->SetSourceDevice(gst_url.source_device);
     }
     current_pipeline_->PrepareNextUrl(media_url, stream_url, gst_url.url, beginning_offset_nanosec, force_stop_at_end ? end_offset_nanosec : 0);
-    // Add request to discover the stream
-    if (discoverer_ && media_url.scheme() != u"spotify"_s) {
-      if (!gst_discoverer_discover_uri_async(discoverer_, gst_url.url.constData())) {
-        qLog(Error) << "Failed to start stream discovery for" << gst_url.url;
-      }
-    }
+    StartStreamDiscovery(media_url, stream_url, gst_url.url, EngineMetadata::Type::Next);
   }
 
 }
@@ -229,6 +246,7 @@ bool GstEngine::Load(const QUrl &media_url, const QUrl &stream_url, const Engine
 
   GstEnginePipelinePtr old_pipeline = current_pipeline_;
   current_pipeline_ = pipeline;
+  UpdateFastTransport();
 
   if (old_pipeline) {
     if (crossfade && !old_pipeline->exclusive_mode() && !AnyExclusivePipelineActive() && !fadeout_pipelines_.contains(old_pipeline->id())) {
@@ -260,12 +278,7 @@ bool GstEngine::Load(const QUrl &media_url, const QUrl &stream_url, const Engine
     }
   }
 
-  // Add request to discover the stream
-  if (discoverer_ && media_url.scheme() != u"spotify"_s) {
-    if (!gst_discoverer_discover_uri_async(discoverer_, gst_url.url.constData())) {
-      qLog(Error) << "Failed to start stream discovery for" << gst_url.url;
-    }
-  }
+  StartStreamDiscovery(media_url, stream_url, gst_url.url, EngineMetadata::Type::Current);
 
   return true;
 
@@ -337,11 +350,13 @@ void GstEngine::Stop(const bool stop_after) {
     if (fadeout_enabled_ && !stop_after && !AnyExclusivePipelineActive()) {
       GstEnginePipelinePtr old_pipeline = current_pipeline_;
       current_pipeline_ = GstEnginePipelinePtr();
+      UpdateFastTransport();
       StartFadeout(old_pipeline);
     }
     else {
       GstEnginePipelinePtr old_pipeline = current_pipeline_;
       current_pipeline_ = GstEnginePipelinePtr();
+      UpdateFastTransport();
       FinishPipeline(old_pipeline);
     }
   }
@@ -389,6 +404,7 @@ void GstEngine::Unpause() {
       QObject::disconnect(&*current_pipeline_, &GstEnginePipeline::FaderFinished, nullptr, nullptr);
       current_pipeline_->StartFader(fadeout_pause_duration_nanosec_, QTimeLine::Forward, QEasingCurve::Linear, false);
       has_faded_out_to_pause_ = false;
+      UpdateFastTransport();
     }
 
     current_pipeline_->SetState(GST_STATE_PLAYING);
@@ -414,6 +430,50 @@ void GstEngine::Seek(const quint64 offset_nanosec) {
 
 }
 
+std::optional<EngineBase::State> GstEngine::TransportFast(const TransportCommand command) {
+
+  if (!fast_transport_allowed_.load(std::memory_order_relaxed)) return std::nullopt;
+
+  // The lock is kept while changing the state, so the main thread can't drop the pipeline meanwhile, and the last reference is never released from this thread.
+  QMutexLocker l(&mutex_fast_transport_);
+  if (!fast_transport_pipeline_) return std::nullopt;
+
+  const GstState state = fast_transport_pipeline_->TogglePause(command != TransportCommand::Play, command != TransportCommand::Pause);
+  if (state == GST_STATE_VOID_PENDING) return std::nullopt;
+
+  QMetaObject::invokeMethod(this, [this, pipeline_id = fast_transport_pipeline_->id(), state]() { FastTransportFinished(pipeline_id, state); }, Qt::QueuedConnection);
+
+  return state == GST_STATE_PAUSED ? State::Paused : State::Playing;
+
+}
+
+void GstEngine::FastTransportFinished(const int pipeline_id, const GstState state) {
+
+  if (!current_pipeline_ || current_pipeline_->id() != pipeline_id) return;
+
+  // Same as the end of Pause() and Unpause(), the pipeline state was already set by TransportFast().
+  if (state == GST_STATE_PAUSED) {
+    delayed_state_ = State::Empty;
+    delayed_state_pause_ = false;
+    delayed_state_offset_nanosec_ = 0;
+    Q_EMIT StateChanged(State::Paused);
+    StopTimers();
+  }
+  else {
+    Q_EMIT StateChanged(State::Playing);
+    StartTimers();
+  }
+
+}
+
+void GstEngine::UpdateFastTransport() {
+
+  // Pausing and resuming with a fade needs the fader in the main thread.
+  QMutexLocker l(&mutex_fast_transport_);
+  fast_transport_pipeline_ = fadeout_pause_enabled_ || has_faded_out_to_pause_ ? GstEnginePipelinePtr() : current_pipeline_;
+
+}
+
 void GstEngine::SetVolumeSW(const uint volume) {
   if (current_pipeline_) current_pipeline_->SetVolume(volume);
 }
@@ -427,6 +487,30 @@ qint64 GstEngine::position_nanosec() const {
 
 }
 
+qint64 GstEngine::output_latency_nanosec() const {
+
+  if (!current_pipeline_) return -1;
+
+  return current_pipeline_->output_latency_nanosec();
+
+}
+
+qint64 GstEngine::buffered_nanosec() const {
+
+  if (!current_pipeline_) return -1;
+
+  return current_pipeline_->buffered_nanosec();
+
+}
+
+std::optional<EngineBase::NetworkBufferStatistics> GstEngine::network_buffer_statistics() const {
+
+  if (!current_pipeline_) return std::nullopt;
+
+  return current_pipeline_->network_buffer_statistics();
+
+}
+
 qint64 GstEngine::length_nanosec() const {
 
   if (!current_pipeline_) return 0;
@@ -445,6 +529,8 @@ qint64 GstEngine::length_nanosec() const {
 
 const EngineBase::Scope &GstEngine::scope(const int chunk_length) {
 
+  TakePendingScopeBuffer();
+
   // The new buffer could have a different size
   if (have_new_buffer_) {
     if (latest_buffer_) {
@@ -470,6 +556,8 @@ const EngineBase::Scope &GstEngine::scope(const int chunk_length) {
 
 EngineBase::OutputDetailsList GstEngine::GetOutputsList() const {
 
+  GstStartup::WaitForInitialized();
+
   OutputDetailsList outputs;
 
   GstRegistry *registry = gst_registry_get();
@@ -535,6 +623,9 @@ void GstEngine::ReloadSettings() {
 
   if (output_.isEmpty()) output_ = QLatin1String(kAutoSink);
 
+  DiscardSparePipeline();
+  UpdateFastTransport();
+
 #ifdef HAVE_SPOTIFY
   if (current_pipeline_ && old_spotify_access_token != spotify_access_token_) {
     current_pipeline_->set_spotify_access_token(spotify_access_token_);
@@ -545,10 +636,11 @@ void GstEngine::ReloadSettings() {
 
 void GstEngine::ConsumeBuffer(GstBuffer *buffer, const int pipeline_id, const QString &format) {
 
-  // Schedule this to run in the GUI thread.  The buffer gets added to the queue and unreffed by UpdateScope.
-  if (!QMetaObject::invokeMethod(this, "AddBufferToScope", Q_ARG(GstBuffer*, buffer), Q_ARG(int, pipeline_id), Q_ARG(QString, format))) {
-    qLog(Warning) << "Failed to invoke AddBufferToScope on GstEngine";
-    gst_buffer_unref(buffer);
+  // Only the latest buffer is used for the scope, so replace whatever the GUI thread hasn't picked up yet.
+  ScopeBuffer *old_scope_buffer = pending_scope_buffer_.exchange(new ScopeBuffer{ buffer, pipeline_id, format });
+  if (old_scope_buffer) {
+    gst_buffer_unref(old_scope_buffer->buffer);
+    delete old_scope_buffer;
   }
 
 }
@@ -557,6 +649,7 @@ void GstEngine::SetStereoBalancerEnabled(const bool enabled) {
 
   stereo_balancer_enabled_ = enabled;
   if (current_pipeline_) current_pipeline_->set_stereo_balancer_enabled(enabled);
+  DiscardSparePipeline();
 
 }
 
@@ -564,6 +657,7 @@ void GstEngine::SetStereoBalance(const float value) {
 
   stereo_balance_ = value;
   if (current_pipeline_) current_pipeline_->SetStereoBalance(value);
+  if (low_latency_) DiscardSparePipeline();
 
 }
 
@@ -571,6 +665,7 @@ void GstEngine::SetEqualizerEnabled(const bool enabled) {
 
   equalizer_enabled_ = enabled;
   if (current_pipeline_) current_pipeline_->set_equalizer_enabled(enabled);
+  DiscardSparePipeline();
 
 }
 
@@ -580,6 +675,7 @@ void GstEngine::SetEqualizerParameters(const int preamp, const QList<int> &band_
   equalizer_gains_ = band_gains;
 
   if (current_pipeline_) current_pipeline_->SetEqualizerParams(preamp, band_gains);
+  if (low_latency_) DiscardSparePipeline();
 
 }
 
@@ -587,6 +683,7 @@ void GstEngine::AddBufferConsumer(GstBufferConsumer *consumer) {
 
   buffer_consumers_ << consumer;
   if (current_pipeline_) current_pipeline_->AddBufferConsumer(consumer);
+  if (spare_pipeline_) spare_pipeline_->AddBufferConsumer(consumer);
 
 }
 
@@ -594,6 +691,39 @@ void GstEngine::RemoveBufferConsumer(GstBufferConsumer *consumer) {
 
   buffer_consumers_.removeAll(consumer);
   if (current_pipeline_) current_pipeline_->RemoveBufferConsumer(consumer);
+  if (spare_pipeline_) spare_pipeline_->RemoveBufferConsumer(consumer);
+
+}
+
+void GstEngine::SetLowPowerMode(const bool enabled) {
+
+  if (enabled == low_power_mode_) return;
+
+  low_power_mode_ = enabled;
+
+  // Nothing shows the scope, so the pipelines don't need to convert and pass on the buffers.
+  const QList<GstEnginePipelinePtr> pipelines = QList<GstEnginePipelinePtr>() << current_pipeline_ << spare_pipeline_;
+  for (GstEnginePipelinePtr pipeline : pipelines) {
+    if (!pipeline) continue;
+    if (low_power_mode_) {
+      pipeline->RemoveBufferConsumer(this);
+    }
+    else {
+      pipeline->AddBufferConsumer(this);
+    }
+  }
+
+  if (low_power_mode_) {
+    ScopeBuffer *scope_buffer = pending_scope_buffer_.exchange(nullptr);
+    if (scope_buffer) {
+      gst_buffer_unref(scope_buffer->buffer);
+      delete scope_buffer;
+    }
+  }
+
+  if (timer_id_ != -1) {
+    StartTimers();
+  }
 
 }
 
@@ -601,13 +731,15 @@ void GstEngine::timerEvent(QTimerEvent *e) {
 
   if (e->timerId() != timer_id_) return;
 
+  WakeupStatistics::Add();
+
   if (current_pipeline_ && !about_to_end_emitted_) {
     const qint64 current_length = length_nanosec();
     // Only if we know the length of the current stream...
     if (current_length > 0) {
       const qint64 current_position = position_nanosec();
       const qint64 remaining = current_length - current_position;
-      const qint64 fudge = kTimerIntervalNanosec + 100 * kNsecPerMsec;  // Mmm fudge
+      const qint64 fudge = timer_interval_nanosec() + 100 * kNsecPerMsec;  // Mmm fudge
       const qint64 gap = static_cast<qint64>(buffer_duration_nanosec_) + (autocrossfade_enabled_ ? fadeout_duration_nanosec_ : kPreloadGapNanosec);
       // Emit TrackAboutToEnd when we're a few seconds away from finishing
       if (remaining < gap + fudge) {
@@ -629,6 +761,7 @@ void GstEngine::EndOfStreamReached(const int pipeline_id, const bool has_next_tr
     GstEnginePipelinePtr old_pipeline = current_pipeline_;
     FinishPipeline(old_pipeline);
     current_pipeline_ = GstEnginePipelinePtr();
+    UpdateFastTransport();
     BufferingFinished();
   }
 
@@ -654,6 +787,7 @@ void GstEngine::HandlePipelineError(const int pipeline_id, const int domain, con
 
     GstEnginePipelinePtr pipeline = current_pipeline_;
     current_pipeline_ = GstEnginePipelinePtr();
+    UpdateFastTransport();
     FinishPipeline(pipeline);
 
     BufferingFinished();
@@ -688,10 +822,14 @@ void GstEngine::NewMetaData(const int pipeline_id, const EngineMetadata &engine_
 
 }
 
-void GstEngine::AddBufferToScope(GstBuffer *buf, const int pipeline_id, const QString &format) {
+void GstEngine::TakePendingScopeBuffer() {
 
-  if (!current_pipeline_ || current_pipeline_->id() != pipeline_id) {
-    gst_buffer_unref(buf);
+  ScopeBuffer *scope_buffer = pending_scope_buffer_.exchange(nullptr);
+  if (!scope_buffer) return;
+
+  if (!current_pipeline_ || current_pipeline_->id() != scope_buffer->pipeline_id) {
+    gst_buffer_unref(scope_buffer->buffer);
+    delete scope_buffer;
     return;
   }
 
@@ -699,10 +837,12 @@ void GstEngine::AddBufferToScope(GstBuffer *buf, const int pipeline_id, const QS
     gst_buffer_unref(latest_buffer_);
   }
 
-  buffer_format_ = format;
-  latest_buffer_ = buf;
+  buffer_format_ = scope_buffer->format;
+  latest_buffer_ = scope_buffer->buffer;
   have_new_buffer_ = true;
 
+  delete scope_buffer;
+
 }
 
 void GstEngine::FadeoutFinished(const int pipeline_id) {
@@ -726,6 +866,7 @@ void GstEngine::FadeoutPauseFinished() {
   StopTimers();
   has_faded_out_to_pause_ = true;
   fadeout_pause_pipeline_ = GstEnginePipelinePtr();
+  UpdateFastTransport();
 
 }
 
@@ -752,6 +893,7 @@ void GstEngine::PlayDone(const GstStateChangeReturn ret, const bool pause, const
     // Failure, but we got a redirection URL - try loading that instead
     GstEnginePipelinePtr old_pipeline = current_pipeline_;
     current_pipeline_ = GstEnginePipelinePtr();
+    UpdateFastTransport();
     QByteArray redirect_url;
     {
       QMutexLocker l(old_pipeline->mutex_redirect_url());
@@ -776,6 +918,7 @@ void GstEngine::PlayDone(const GstStateChangeReturn ret, const bool pause, const
         stream_url.detach();
       }
       current_pipeline_ = CreatePipeline(media_url, stream_url, redirect_url, static_cast<qint64>(beginning_offset_nanosec_), end_offset_nanosec_, old_pipeline->ebur128_loudness_normalizing_gain_db());
+      UpdateFastTransport();
       FinishPipeline(old_pipeline);
       Play(pause, offset_nanosec);
       return;
@@ -807,11 +950,15 @@ void GstEngine::BufferingStarted() {
 
   buffering_task_id_ = task_manager_->StartTask(tr("Buffering"));
   task_manager_->SetTaskProgress(buffering_task_id_, 0, 100);
+  buffering_percent_ = 0;
+
+  BackgroundIOThrottle::Instance()->SetPlaybackBuffering(true);
 
 }
 
 void GstEngine::BufferingProgress(const int percent) {
   task_manager_->SetTaskProgress(buffering_task_id_, static_cast<quint64>(percent), 100UL);
+  buffering_percent_ = percent;
 }
 
 void GstEngine::BufferingFinished() {
@@ -820,6 +967,15 @@ void GstEngine::BufferingFinished() {
     task_manager_->SetTaskFinished(buffering_task_id_);
     buffering_task_id_ = -1;
   }
+  buffering_percent_ = -1;
+
+  BackgroundIOThrottle::Instance()->SetPlaybackBuffering(false);
+
+  if (current_pipeline_) {
+    if (const std::optional<NetworkBufferStatistics> statistics = current_pipeline_->network_buffer_statistics()) {
+      last_network_buffer_statistics_ = statistics;
+    }
+  }
 
 }
 
@@ -898,13 +1054,21 @@ void GstEngine::StopFadeoutPause() {
   QObject::disconnect(&*fadeout_pause_pipeline_, &GstEnginePipeline::FaderFinished, this, &GstEngine::FadeoutPauseFinished);
   has_faded_out_to_pause_ = true;
   fadeout_pause_pipeline_ = GstEnginePipelinePtr();
+  UpdateFastTransport();
 
 }
 
 void GstEngine::StartTimers() {
 
   StopTimers();
-  timer_id_ = startTimer(kTimerIntervalNanosec / kNsecPerMsec);
+  // In low power mode the timer fires less often, and only on whole seconds so it wakes up together with other timers.
+  timer_id_ = startTimer(static_cast<int>(timer_interval_nanosec() / kNsecPerMsec), low_power_mode_ ? Qt::VeryCoarseTimer : Qt::CoarseTimer);
+
+}
+
+qint64 GstEngine::timer_interval_nanosec() const {
+
+  return low_power_mode_ ? kLowPowerTimerIntervalNanosec : kTimerIntervalNanosec;
 
 }
 
@@ -919,15 +1083,19 @@ void GstEngine::StopTimers() {
 
 GstEnginePipelinePtr GstEngine::CreatePipeline() {
 
+  GstStartup::WaitForInitialized();
+
   GstEnginePipelinePtr pipeline = GstEnginePipelinePtr(new GstEnginePipeline);
   pipeline->set_output_device(output_, device_);
   pipeline->set_playbin3_enabled(playbin3_enabled_);
   pipeline->set_exclusive_mode(exclusive_mode_);
+  pipeline->set_low_latency(low_latency_);
   pipeline->set_volume_enabled(volume_control_);
   pipeline->set_stereo_balancer_enabled(stereo_balancer_enabled_);
   pipeline->set_equalizer_enabled(equalizer_enabled_);
-  pipeline->set_replaygain(rg_enabled_, rg_mode_, rg_preamp_, rg_fallbackgain_, rg_compression_);
-  pipeline->set_ebur128_loudness_normalization(ebur128_loudness_normalization_);
+  // When the ReplayGain is computed from the loudness, the gain is set on the loudness normalization volume element instead of using rgvolume and rglimiter.
+  pipeline->set_replaygain(rg_enabled_ && !replaygain_from_loudness(), rg_mode_, rg_preamp_, rg_fallbackgain_, rg_compression_);
+  pipeline->set_ebur128_loudness_normalization(ebur128_loudness_normalization_ || replaygain_from_loudness());
   pipeline->set_buffer_duration_nanosec(buffer_duration_nanosec_);
   pipeline->set_buffer_low_watermark(buffer_low_watermark_);
   pipeline->set_buffer_high_watermark(buffer_high_watermark_);
@@ -936,12 +1104,17 @@ GstEnginePipelinePtr GstEngine::CreatePipeline() {
   pipeline->set_bs2b_enabled(bs2b_enabled_);
   pipeline->set_strict_ssl_enabled(strict_ssl_enabled_);
   pipeline->set_fading_enabled(fadeout_enabled_ || autocrossfade_enabled_ || fadeout_pause_enabled_);
+  // The low latency mode leaves out neutral elements when the audio bin is created, so it needs the current values up front.
+  pipeline->SetStereoBalance(stereo_balance_);
+  pipeline->SetEqualizerParams(equalizer_preamp_, equalizer_gains_);
 
 #ifdef HAVE_SPOTIFY
   pipeline->set_spotify_access_token(spotify_access_token_);
 #endif
 
-  pipeline->AddBufferConsumer(this);
+  if (!low_power_mode_) {
+    pipeline->AddBufferConsumer(this);
+  }
   for (GstBufferConsumer *consumer : std::as_const(buffer_consumers_)) {
     pipeline->AddBufferConsumer(consumer);
   }
@@ -961,19 +1134,64 @@ GstEnginePipelinePtr GstEngine::CreatePipeline() {
 
 GstEnginePipelinePtr GstEngine::CreatePipeline(const QUrl &media_url, const QUrl &stream_url, const QByteArray &gst_url, const qint64 beginning_offset_nanosec, const qint64 end_offset_nanosec, const double ebur128_loudness_normalizing_gain_db) {
 
-  GstEnginePipelinePtr ret = CreatePipeline();
-  QString error;
-  if (!ret->InitFromUrl(media_url, stream_url, gst_url, beginning_offset_nanosec, end_offset_nanosec, ebur128_loudness_normalizing_gain_db, error)) {
-    ret.reset();
-    Q_EMIT Error(error);
-    Q_EMIT StateChanged(State::Error);
-    Q_EMIT FatalError();
+  // Start with a short buffer when the last network stream arrived fast and steady.
+  quint64 network_initial_buffer_duration_nanosec = 0;
+  if (last_network_buffer_statistics_ && last_network_buffer_statistics_->underruns == 0 && last_network_buffer_statistics_->throughput_ratio() >= kFastNetworkThroughputRatio && last_network_buffer_statistics_->jitter <= kFastNetworkMaxJitter) {
+    network_initial_buffer_duration_nanosec = std::max(kMinNetworkBufferDurationNanosec, buffer_duration_nanosec_ / kFastNetworkBufferDivisor);
   }
 
+  GstEnginePipelinePtr ret;
+  if (spare_pipeline_) {
+    qLog(Debug) << "Using spare pipeline" << spare_pipeline_->id();
+    ret = spare_pipeline_;
+    spare_pipeline_.reset();
+    ret->set_network_initial_buffer_duration_nanosec(network_initial_buffer_duration_nanosec);
+    ret->SetUrl(media_url, stream_url, gst_url, beginning_offset_nanosec, end_offset_nanosec, ebur128_loudness_normalizing_gain_db);
+  }
+  else {
+    ret = CreatePipeline();
+    ret->set_network_initial_buffer_duration_nanosec(network_initial_buffer_duration_nanosec);
+    QString error;
+    if (!ret->InitFromUrl(media_url, stream_url, gst_url, beginning_offset_nanosec, end_offset_nanosec, ebur128_loudness_normalizing_gain_db, error)) {
+      ret.reset();
+      Q_EMIT Error(error);
+      Q_EMIT StateChanged(State::Error);
+      Q_EMIT FatalError();
+      return ret;
+    }
+  }
+
+  // Build the next one once the event loop is idle again, so the track change after this doesn't have to
+  QMetaObject::invokeMethod(this, &GstEngine::PrepareSparePipeline, Qt::QueuedConnection);
+
   return ret;
 
 }
 
+void GstEngine::PrepareSparePipeline() {
+
+  if (spare_pipeline_ || !current_pipeline_) return;
+
+  GstEnginePipelinePtr pipeline = CreatePipeline();
+  QString error;
+  if (!pipeline->Init(error)) {
+    qLog(Debug) << "Could not prepare spare pipeline:" << error;
+    return;
+  }
+
+  spare_pipeline_ = pipeline;
+
+}
+
+void GstEngine::DiscardSparePipeline() {
+
+  if (!spare_pipeline_) return;
+
+  QObject::disconnect(&*spare_pipeline_, nullptr, this, nullptr);
+  spare_pipeline_.reset();
+
+}
+
 void GstEngine::FinishPipeline(GstEnginePipelinePtr pipeline) {
 
   const int pipeline_id = pipeline->id();
@@ -1089,15 +1307,44 @@ void GstEngine::UpdateScope(const int chunk_length) {
 
 }
 
+void GstEngine::StartStreamDiscovery(const QUrl &media_url, const QUrl &stream_url, const QByteArray &gst_url, const EngineMetadata::Type type) {
+
+  if (!discoverer_ || media_url.scheme() == u"spotify"_s) return;
+
+  QString cache_key;
+  if (!StreamDiscoveryNeeded(media_url, cache_key)) return;
+
+  if (!cache_key.isEmpty()) {
+    if (const EngineMetadata *cached_engine_metadata = stream_discovery_cache_.object(cache_key)) {
+      EngineMetadata engine_metadata = *cached_engine_metadata;
+      engine_metadata.type = type;
+      engine_metadata.media_url = media_url;
+      engine_metadata.stream_url = stream_url;
+      // Queued like the results of the discoverer, so the player is done loading the song when it gets them.
+      QMetaObject::invokeMethod(this, [this, engine_metadata]() { Q_EMIT MetaData(engine_metadata); }, Qt::QueuedConnection);
+      return;
+    }
+    stream_discovery_cache_keys_.insert(gst_url, cache_key);
+  }
+
+  if (!gst_discoverer_discover_uri_async(discoverer_, gst_url.constData())) {
+    qLog(Error) << "Failed to start stream discovery for" << gst_url;
+    stream_discovery_cache_keys_.remove(gst_url);
+  }
+
+}
+
 void GstEngine::StreamDiscovered(GstDiscoverer *discoverer, GstDiscovererInfo *info, GError *error, gpointer self) {
 
   Q_UNUSED(discoverer)
   Q_UNUSED(error)
 
   GstEngine *instance = reinterpret_cast<GstEngine*>(self);
-  if (!instance->current_pipeline_) return;
 
   const QByteArray discovered_url = gst_discoverer_info_get_uri(info);
+  const QString cache_key = instance->stream_discovery_cache_keys_.take(discovered_url);
+
+  if (!instance->current_pipeline_) return;
 
   GstDiscovererResult result = gst_discoverer_info_get_result(info);
   if (result != GST_DISCOVERER_OK) {
@@ -1166,6 +1413,15 @@ void GstEngine::StreamDiscovered(GstDiscoverer *discoverer, GstDiscovererInfo *i
 
     qLog(Debug) << "Got stream info for" << discovered_url + ":" << Song::TextForFiletype(engine_metadata.filetype);
 
+    if (!cache_key.isEmpty()) {
+      EngineMetadata *cached_engine_metadata = new EngineMetadata;
+      cached_engine_metadata->filetype = engine_metadata.filetype;
+      cached_engine_metadata->samplerate = engine_metadata.samplerate;
+      cached_engine_metadata->bitdepth = engine_metadata.bitdepth;
+      cached_engine_metadata->bitrate = engine_metadata.bitrate;
+      instance->stream_discovery_cache_.insert(cache_key, cached_engine_metadata);
+    }
+
     Q_EMIT instance->MetaData(engine_metadata);
 
   }
@@ -1227,6 +1483,9 @@ void GstEngine::SetSpotifyAccessToken() {
   if (current_pipeline_) {
     current_pipeline_->set_spotify_access_token(spotify_access_token_);
   }
+  if (spare_pipeline_) {
+    spare_pipeline_->set_spotify_access_token(spotify_access_token_);
+  }
 
 }
 #endif  // HAVE_SPOTIFY
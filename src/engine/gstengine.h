@@ -26,6 +26,7 @@
 #include "config.h"
 
 #include <optional>
+#include <atomic>
 
 #include <gst/gst.h>
 #include <gst/pbutils/pbutils.h>
@@ -33,13 +34,17 @@
 #include <QtGlobal>
 #include <QObject>
 #include <QFuture>
+#include <QMutex>
 #include <QByteArray>
 #include <QList>
 #include <QMap>
+#include <QHash>
+#include <QCache>
 #include <QString>
 #include <QUrl>
 
 #include "includes/shared_ptr.h"
+#include "core/enginemetadata.h"
 #include "enginebase.h"
 #include "gsturl.h"
 #include "gstenginepipeline.h"
@@ -68,6 +73,7 @@ class GstEngine : public EngineBase, public GstBufferConsumer {
   void Pause() override;
   void Unpause() override;
   void Seek(const quint64 offset_nanosec) override;
+  std::optional<State> TransportFast(const TransportCommand command) override;
 
  protected:
   void SetVolumeSW(const uint volume) override;
@@ -75,6 +81,10 @@ class GstEngine : public EngineBase, public GstBufferConsumer {
  public:
   qint64 position_nanosec() const override;
   qint64 length_nanosec() const override;
+  qint64 output_latency_nanosec() const override;
+  qint64 buffered_nanosec() const override;
+  int buffering_percent() const override { return buffering_percent_; }
+  std::optional<NetworkBufferStatistics> network_buffer_statistics() const override;
   const EngineBase::Scope &scope(const int chunk_length) override;
 
   OutputDetailsList GetOutputsList() const override;
@@ -101,6 +111,9 @@ class GstEngine : public EngineBase, public GstBufferConsumer {
   // Set equalizer preamp and gains, range -100..100. Gains are 10 values.
   void SetEqualizerParameters(const int preamp, const QList<int> &band_gains) override;
 
+  // Stops feeding the scope and checks the remaining time less often.
+  void SetLowPowerMode(const bool enabled) override;
+
   void AddBufferConsumer(GstBufferConsumer *consumer);
   void RemoveBufferConsumer(GstBufferConsumer *consumer);
 
@@ -111,7 +124,6 @@ class GstEngine : public EngineBase, public GstBufferConsumer {
   void EndOfStreamReached(const int pipeline_id, const bool has_next_track);
   void HandlePipelineError(const int pipeline_id, const int domain, const int error_code, const QString &message, const QString &debugstr);
   void NewMetaData(const int pipeline_id, const EngineMetadata &engine_metadata);
-  void AddBufferToScope(GstBuffer *buf, const int pipeline_id, const QString &format);
   void FadeoutFinished(const int pipeline_id);
   void FadeoutPauseFinished();
   void SeekNow();
@@ -123,6 +135,10 @@ class GstEngine : public EngineBase, public GstBufferConsumer {
 
   void PipelineFinished(const int pipeline_id);
 
+  void PrepareSparePipeline();
+
+  void FastTransportFinished(const int pipeline_id, const GstState state);
+
  private:
   GstUrl FixupUrl(const QUrl &url);
 
@@ -132,18 +148,24 @@ class GstEngine : public EngineBase, public GstBufferConsumer {
 
   void StartTimers();
   void StopTimers();
+  qint64 timer_interval_nanosec() const;
 
   GstEnginePipelinePtr CreatePipeline();
   GstEnginePipelinePtr CreatePipeline(const QUrl &media_url, const QUrl &stream_url, const QByteArray &gst_url, const qint64 beginning_offset_nanosec, const qint64 end_offset_nanosec, const double ebur128_loudness_normalizing_gain_db);
 
   void FinishPipeline(GstEnginePipelinePtr pipeline);
+  void DiscardSparePipeline();
 
+  void TakePendingScopeBuffer();
   void UpdateScope(int chunk_length);
 
+  void StartStreamDiscovery(const QUrl &media_url, const QUrl &stream_url, const QByteArray &gst_url, const EngineMetadata::Type type);
   static void StreamDiscovered(GstDiscoverer *discoverer, GstDiscovererInfo *info, GError *error, gpointer self);
   static void StreamDiscoveryFinished(GstDiscoverer *discoverer, gpointer self);
   static QString GSTdiscovererErrorMessage(GstDiscovererResult result);
 
+  void UpdateFastTransport();
+
   bool OldExclusivePipelineActive() const;
   bool AnyExclusivePipelineActive() const;
 
@@ -156,14 +178,26 @@ class GstEngine : public EngineBase, public GstBufferConsumer {
   GstDiscoverer *discoverer_;
 
   int buffering_task_id_;
+  int buffering_percent_;
+  // From the last network stream that finished buffering, decides how much the next one buffers before it starts.
+  std::optional<NetworkBufferStatistics> last_network_buffer_statistics_;
 
   GstEnginePipelinePtr current_pipeline_;
   QMap<int, GstEnginePipelinePtr> fadeout_pipelines_;
   GstEnginePipelinePtr fadeout_pause_pipeline_;
   QMap<int, GstEnginePipelinePtr> old_pipelines_;
+  // Built ahead of time for the current output configuration, only the URL is left to set.
+  GstEnginePipelinePtr spare_pipeline_;
 
   QList<GstBufferConsumer*> buffer_consumers_;
 
+  // Handed over from the streaming thread by swapping the pointer, so it never waits for the GUI thread.
+  struct ScopeBuffer {
+    GstBuffer *buffer;
+    int pipeline_id;
+    QString format;
+  };
+  std::atomic<ScopeBuffer*> pending_scope_buffer_;
   GstBuffer *latest_buffer_;
 
   bool stereo_balancer_enabled_;
@@ -179,6 +213,7 @@ class GstEngine : public EngineBase, public GstBufferConsumer {
   quint64 seek_pos_;
 
   int timer_id_;
+  bool low_power_mode_;
 
   bool has_faded_out_to_pause_;
 
@@ -189,10 +224,18 @@ class GstEngine : public EngineBase, public GstBufferConsumer {
 
   int discovery_finished_cb_id_;
   int discovery_discovered_cb_id_;
+  // Cache keys of the streams being discovered, by GStreamer URL.
+  QHash<QByteArray, QString> stream_discovery_cache_keys_;
+  // Only the audio properties of the discovered streams are used.
+  QCache<QString, EngineMetadata> stream_discovery_cache_;
 
   State delayed_state_;
   bool delayed_state_pause_;
   quint64 delayed_state_offset_nanosec_;
+
+  // The current pipeline while it can be paused and resumed without a fade, for TransportFast() from other threads.
+  QMutex mutex_fast_transport_;
+  GstEnginePipelinePtr fast_transport_pipeline_;
 };
 
 #endif  // GSTENGINE_H
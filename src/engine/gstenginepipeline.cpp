@@ -32,6 +32,8 @@
 #include <glib-object.h>
 #include <gst/gst.h>
 #include <gst/audio/audio.h>
+#include <gst/controller/gstinterpolationcontrolsource.h>
+#include <gst/controller/gstdirectcontrolbinding.h>
 
 #ifdef Q_OS_UNIX
 #  include <pthread.h>
@@ -62,6 +64,7 @@
 #include <QVersionNumber>
 
 #include "core/logging.h"
+#include "core/tracing.h"
 #include "core/signalchecker.h"
 #include "constants/timeconstants.h"
 #include "constants/backendsettings.h"
@@ -89,12 +92,78 @@ constexpr int kGstStateTimeoutNanosecs = 10000000;
 constexpr std::chrono::milliseconds kFaderFudgeMsec = 2000ms;
 constexpr std::chrono::milliseconds kFaderTimeoutMsec = 3000ms;
 
+// Distance between the control points of a fade ramp, the volume is interpolated linearly for every sample between them.
+constexpr int kFaderRampStepMsec = 25;
+
+// Time to move the equalizer from the old to the new gains, long enough to not click, short enough to follow a slider.
+constexpr qint64 kEqRampMsec = 40;
+
 constexpr int kEqBandCount = 10;
 constexpr int kEqBandFrequencies[] = { 60, 170, 310, 600, 1000, 3000, 6000, 12000, 14000, 16000 };
 
 // When within this many seconds of track end during gapless playback, ignore buffering messages
 constexpr int kIgnoreBufferingNearEndSeconds = 5;
 
+// The buffer of network streams grows to at most this many times the buffer duration after underruns
+constexpr quint64 kMaxNetworkBufferDurationFactor = 4;
+
+// Audio sink ring buffer size and segment size for the low latency mode, in microseconds.
+// The defaults are 200ms and 10ms, which is what a pause or a seek has to wait out before the change is heard.
+constexpr gint64 kLowLatencyBufferTimeUsec = 10000;
+constexpr gint64 kLowLatencyLatencyTimeUsec = 2500;
+
+// Sample conversions for the analyzer.
+// These are kept as plain counted loops without branches or early exits, so the compiler vectorises them for the target (SSE2, NEON).
+
+void ConvertS32ToS16(const guint8 *source, int16_t *dest, const qsizetype count) {
+  const int32_t *s = reinterpret_cast<const int32_t*>(source);
+  for (qsizetype i = 0; i < count; ++i) {
+    dest[i] = static_cast<int16_t>(s[i] >> 16);
+  }
+}
+
+void ConvertF32ToS16(const guint8 *source, int16_t *dest, const qsizetype count) {
+  const float *s = reinterpret_cast<const float*>(source);
+  for (qsizetype i = 0; i < count; ++i) {
+    dest[i] = static_cast<int16_t>(std::clamp(s[i] * 32768.0F, -32768.0F, 32767.0F));
+  }
+}
+
+void ConvertS24ToS16(const guint8 *source, int16_t *dest, const qsizetype count) {
+  for (qsizetype i = 0; i < count; ++i) {
+    int16_t sample = 0;
+    memcpy(&sample, source + (i * 3) + 1, sizeof(sample));
+    dest[i] = sample;
+  }
+}
+
+void ConvertS24_32ToS16(const guint8 *source, int16_t *dest, const qsizetype count) {
+  const int32_t *s = reinterpret_cast<const int32_t*>(source);
+  for (qsizetype i = 0; i < count; ++i) {
+    dest[i] = static_cast<int16_t>(s[i] >> 8);
+  }
+}
+
+// Returns a new S16 buffer with the samples of buf converted by convert.
+GstBuffer *ConvertBufferToS16(GstBuffer *buf, const int channels, const int rate, const gsize bytes_per_sample, void (*convert)(const guint8*, int16_t*, const qsizetype)) {
+
+  GstMapInfo map_info;
+  gst_buffer_map(buf, &map_info, GST_MAP_READ);
+
+  const int samples = static_cast<int>((map_info.size / bytes_per_sample) / static_cast<gsize>(channels));
+  const qsizetype count = static_cast<qsizetype>(samples) * channels;
+  const gsize buf16_size = static_cast<gsize>(count) * sizeof(int16_t);
+  int16_t *d = static_cast<int16_t*>(g_malloc(buf16_size));
+  convert(map_info.data, d, count);
+  gst_buffer_unmap(buf, &map_info);
+
+  GstBuffer *buf16 = gst_buffer_new_wrapped(d, buf16_size);
+  GST_BUFFER_DURATION(buf16) = GST_FRAMES_TO_CLOCK_TIME(static_cast<guint64>(samples * sizeof(int16_t) / channels), static_cast<guint64>(rate));
+
+  return buf16;
+
+}
+
 }  // namespace
 
 #ifdef __clang_
@@ -127,12 +196,17 @@ GstEnginePipeline::GstEnginePipeline(QObject *parent)
       volume_full_range_support_(false),
       playbin3_enabled_(true),
       exclusive_mode_(false),
+      low_latency_(false),
       volume_enabled_(true),
       fading_enabled_(false),
       strict_ssl_enabled_(false),
       buffer_duration_nanosec_(BackendSettings::kDefaultBufferDuration * kNsecPerMsec),
       buffer_low_watermark_(BackendSettings::kDefaultBufferLowWatermark),
       buffer_high_watermark_(BackendSettings::kDefaultBufferHighWatermark),
+      network_initial_buffer_duration_nanosec_(0),
+      network_stream_(false),
+      network_input_rate_(0.0),
+      network_input_rate_deviation_(0.0),
       proxy_authentication_(false),
       channels_enabled_(false),
       channels_(0),
@@ -141,6 +215,11 @@ GstEnginePipeline::GstEnginePipeline(QObject *parent)
       stereo_balance_(0.0F),
       eq_enabled_(false),
       eq_preamp_(0),
+      eq_target_preamp_(-1.0F),
+      eq_ramp_pending_(false),
+      eq_preamp_control_source_(nullptr),
+      eq_ramp_start_(GST_CLOCK_TIME_NONE),
+      eq_ramp_end_(GST_CLOCK_TIME_NONE),
       rg_enabled_(false),
       rg_mode_(0),
       rg_preamp_(0.0),
@@ -159,10 +238,14 @@ GstEnginePipeline::GstEnginePipeline(QObject *parent)
       pipeline_connected_(false),
       pipeline_active_(false),
       buffering_(false),
+      output_latency_nanosec_(-1),
       pending_state_(GST_STATE_NULL),
       pending_seek_nanosec_(-1),
       pending_seek_ready_previous_state_(GST_STATE_NULL),
       last_known_position_ns_(0),
+      buffer_position_nanosec_(-1),
+      duration_nanosec_(-1),
+      current_state_(GST_STATE_NULL),
       next_uri_set_(false),
       next_uri_need_reset_(false),
       next_uri_reset_(false),
@@ -174,6 +257,8 @@ GstEnginePipeline::GstEnginePipeline(QObject *parent)
       fader_use_fudge_timer_(false),
       timer_fader_fudge_(new QTimer(this)),
       timer_fader_timeout_(new QTimer(this)),
+      fader_control_source_(nullptr),
+      fader_ramp_pending_(false),
       pipeline_(nullptr),
       audiobin_(nullptr),
       audiosink_(nullptr),
@@ -250,6 +335,20 @@ GstEnginePipeline::~GstEnginePipeline() {
     audiobin_ = nullptr;
   }
 
+  if (fader_control_source_) {
+    gst_object_unref(fader_control_source_);
+    fader_control_source_ = nullptr;
+  }
+
+  for (GstControlSource *control_source : std::as_const(eq_band_control_sources_)) {
+    if (control_source) gst_object_unref(control_source);
+  }
+  eq_band_control_sources_.clear();
+  if (eq_preamp_control_source_) {
+    gst_object_unref(eq_preamp_control_source_);
+    eq_preamp_control_source_ = nullptr;
+  }
+
   qLog(Debug) << "Pipeline" << id() << "deleted";
 
 }
@@ -269,6 +368,10 @@ void GstEnginePipeline::set_exclusive_mode(const bool exclusive_mode) {
   exclusive_mode_ = exclusive_mode;
 }
 
+void GstEnginePipeline::set_low_latency(const bool low_latency) {
+  low_latency_ = low_latency;
+}
+
 void GstEnginePipeline::set_volume_enabled(const bool enabled) {
   volume_enabled_ = enabled;
 }
@@ -302,6 +405,17 @@ void GstEnginePipeline::set_ebur128_loudness_normalization(const bool enabled) {
 
 }
 
+qint64 GstEnginePipeline::buffered_nanosec() const {
+
+  if (!audioqueue_) return -1;
+
+  guint64 level_time = 0;
+  g_object_get(G_OBJECT(audioqueue_), "current-level-time", &level_time, nullptr);
+
+  return static_cast<qint64>(level_time);
+
+}
+
 void GstEnginePipeline::set_buffer_duration_nanosec(const quint64 buffer_duration_nanosec) {
   buffer_duration_nanosec_ = buffer_duration_nanosec;
 }
@@ -314,6 +428,10 @@ void GstEnginePipeline::set_buffer_high_watermark(const double value) {
   buffer_high_watermark_ = value;
 }
 
+void GstEnginePipeline::set_network_initial_buffer_duration_nanosec(const quint64 duration_nanosec) {
+  network_initial_buffer_duration_nanosec_ = duration_nanosec;
+}
+
 void GstEnginePipeline::set_proxy_settings(const QString &address, const bool authentication, const QString &user, const QString &pass) {
 
   QMutexLocker l(&mutex_proxy_);
@@ -483,16 +601,15 @@ bool GstEnginePipeline::Finish() {
 
 bool GstEnginePipeline::InitFromUrl(const QUrl &media_url, const QUrl &stream_url, const QByteArray &gst_url, const qint64 beginning_offset_nanosec, const qint64 end_offset_nanosec, const double ebur128_loudness_normalizing_gain_db, QString &error) {
 
-  {
-    QMutexLocker l(&mutex_url_);
-    media_url_ = media_url;
-    stream_url_ = stream_url;
-    gst_url_ = gst_url;
-  }
+  if (!Init(error)) return false;
 
-  beginning_offset_nanosec_ = beginning_offset_nanosec;
-  end_offset_nanosec_ = end_offset_nanosec;
-  ebur128_loudness_normalizing_gain_db_ = ebur128_loudness_normalizing_gain_db;
+  SetUrl(media_url, stream_url, gst_url, beginning_offset_nanosec, end_offset_nanosec, ebur128_loudness_normalizing_gain_db);
+
+  return true;
+
+}
+
+bool GstEnginePipeline::Init(QString &error) {
 
   const QString playbin_name = playbin3_support_ && playbin3_enabled_ ? u"playbin3"_s : u"playbin"_s;
   qLog(Debug) << "Using" << playbin_name << "for pipeline";
@@ -532,14 +649,27 @@ bool GstEnginePipeline::InitFromUrl(const QUrl &media_url, const QUrl &stream_ur
   flags &= ~GST_PLAY_FLAG_SOFT_VOLUME;
   g_object_set(G_OBJECT(pipeline_), "flags", flags, nullptr);
 
+  return true;
+
+}
+
+void GstEnginePipeline::SetUrl(const QUrl &media_url, const QUrl &stream_url, const QByteArray &gst_url, const qint64 beginning_offset_nanosec, const qint64 end_offset_nanosec, const double ebur128_loudness_normalizing_gain_db) {
+
+  beginning_offset_nanosec_ = beginning_offset_nanosec;
+  end_offset_nanosec_ = end_offset_nanosec;
+  SetEBUR128LoudnessNormalizingGain_dB(ebur128_loudness_normalizing_gain_db);
+
   {
     QMutexLocker l(&mutex_url_);
+    media_url_ = media_url;
+    stream_url_ = stream_url;
+    gst_url_ = gst_url;
     g_object_set(G_OBJECT(pipeline_), "uri", gst_url.constData(), nullptr);
   }
 
-  pipeline_connected_ = true;
+  SetupNetworkBuffering(stream_url);
 
-  return true;
+  pipeline_connected_ = true;
 
 }
 
@@ -660,6 +790,11 @@ bool GstEnginePipeline::InitAudioBin(QString &error) {
     g_object_set(G_OBJECT(audiosink_), "exclusive", exclusive_mode_, nullptr);
   }
 
+  if (low_latency_ && g_object_class_find_property(G_OBJECT_GET_CLASS(audiosink_), "buffer-time") && g_object_class_find_property(G_OBJECT_GET_CLASS(audiosink_), "latency-time")) {
+    qLog(Debug) << "Setting low latency buffer time" << kLowLatencyBufferTimeUsec << "and latency time" << kLowLatencyLatencyTimeUsec << "for" << output_;
+    g_object_set(G_OBJECT(audiosink_), "buffer-time", kLowLatencyBufferTimeUsec, "latency-time", kLowLatencyLatencyTimeUsec, nullptr);
+  }
+
 #ifndef Q_OS_WIN32
   if (g_object_class_find_property(G_OBJECT_GET_CLASS(audiosink_), "volume")) {
     qLog(Debug) << output_ << "has volume, enabling volume synchronization.";
@@ -707,13 +842,24 @@ bool GstEnginePipeline::InitAudioBin(QString &error) {
     if (!volume_fading_) {
       return false;
     }
+    // The binding stays disabled while no fade is running, so the volume element can go to passthrough.
+    fader_control_source_ = gst_interpolation_control_source_new();
+    g_object_set(G_OBJECT(fader_control_source_), "mode", GST_INTERPOLATION_MODE_LINEAR, nullptr);
+    if (gst_object_add_control_binding(GST_OBJECT(volume_fading_), gst_direct_control_binding_new_absolute(GST_OBJECT(volume_fading_), "volume", fader_control_source_))) {
+      gst_object_set_control_binding_disabled(GST_OBJECT(volume_fading_), "volume", TRUE);
+    }
+    else {
+      qLog(Warning) << "Failed to add control binding for the fading volume";
+      gst_object_unref(fader_control_source_);
+      fader_control_source_ = nullptr;
+    }
     if (fader_) {
       SetFaderVolume(fader_->currentValue());
     }
   }
 
-  // Create the stereo balancer elements if it's enabled.
-  if (stereo_balancer_enabled_) {
+  // Create the stereo balancer elements if it's enabled, in low latency mode leave it out while it's centered.
+  if (stereo_balancer_enabled_ && !(low_latency_ && stereo_balance_ == 0.0F)) {
     audiopanorama_ = CreateElement(u"audiopanorama"_s, u"audiopanorama"_s, audiobin_, error);
     if (!audiopanorama_) {
       return false;
@@ -722,8 +868,8 @@ bool GstEnginePipeline::InitAudioBin(QString &error) {
     g_object_set(G_OBJECT(audiopanorama_), "panorama", stereo_balance_, nullptr);
   }
 
-  // Create the equalizer elements if it's enabled.
-  if (eq_enabled_) {
+  // Create the equalizer elements if it's enabled, in low latency mode leave them out while they're flat.
+  if (eq_enabled_ && !(low_latency_ && EqualizerNeutral())) {
     equalizer_preamp_ = CreateElement(u"volume"_s, u"equalizer_preamp"_s, audiobin_, error);
     if (!equalizer_preamp_) {
       return false;
@@ -769,6 +915,44 @@ bool GstEnginePipeline::InitAudioBin(QString &error) {
 
     }  // for
 
+    // Bind a control source to every band and the preamp for ramping gain changes, the bindings stay disabled while no ramp is running.
+    bool control_bindings_added = true;
+    for (int i = 0; i < kEqBandCount; ++i) {
+      GstControlSource *control_source = nullptr;
+      GstObject *band = GST_OBJECT(gst_child_proxy_get_child_by_index(GST_CHILD_PROXY(equalizer_), static_cast<guint>(i + 1)));
+      if (band) {
+        control_source = gst_interpolation_control_source_new();
+        g_object_set(G_OBJECT(control_source), "mode", GST_INTERPOLATION_MODE_LINEAR, nullptr);
+        if (gst_object_add_control_binding(band, gst_direct_control_binding_new_absolute(band, "gain", control_source))) {
+          gst_object_set_control_binding_disabled(band, "gain", TRUE);
+        }
+        else {
+          gst_object_unref(control_source);
+          control_source = nullptr;
+        }
+        g_object_unref(G_OBJECT(band));
+      }
+      if (!control_source) control_bindings_added = false;
+      eq_band_control_sources_ << control_source;
+    }
+    eq_preamp_control_source_ = gst_interpolation_control_source_new();
+    g_object_set(G_OBJECT(eq_preamp_control_source_), "mode", GST_INTERPOLATION_MODE_LINEAR, nullptr);
+    if (gst_object_add_control_binding(GST_OBJECT(equalizer_preamp_), gst_direct_control_binding_new_absolute(GST_OBJECT(equalizer_preamp_), "volume", eq_preamp_control_source_))) {
+      gst_object_set_control_binding_disabled(GST_OBJECT(equalizer_preamp_), "volume", TRUE);
+    }
+    else {
+      gst_object_unref(eq_preamp_control_source_);
+      eq_preamp_control_source_ = nullptr;
+      control_bindings_added = false;
+    }
+    if (!control_bindings_added) {
+      qLog(Warning) << "Failed to add control bindings for the equalizer, gain changes are not ramped";
+    }
+
+    // There is no audio yet, so the current gains are set directly.
+    UpdateEqualizerTargets();
+    SetEqualizerValues();
+
   }
 
   eventprobe_ = audioqueueconverter;
@@ -1255,6 +1439,8 @@ GstPadProbeReturn GstEnginePipeline::PadProbeCallback(GstPad *pad, GstPadProbeIn
 
 GstPadProbeReturn GstEnginePipeline::BufferProbeCallback(GstPad *pad, GstPadProbeInfo *info, gpointer self) {
 
+  qTraceScope("GstEnginePipeline::BufferProbeCallback");
+
   GstEnginePipeline *instance = reinterpret_cast<GstEnginePipeline*>(self);
 
   QString format;
@@ -1279,102 +1465,25 @@ GstPadProbeReturn GstEnginePipeline::BufferProbeCallback(GstPad *pad, GstPadProb
   quint64 duration = GST_BUFFER_DURATION(buf);
   qint64 end_time = static_cast<qint64>(start_time + duration);
 
-  if (format.startsWith("S16LE"_L1)) {
-    instance->logged_unsupported_analyzer_format_ = false;
+  if (instance->fader_ramp_pending_.value() && GST_BUFFER_PTS_IS_VALID(buf)) {
+    instance->ApplyFaderRamp(GST_BUFFER_PTS(buf));
   }
-  else if (format.startsWith("S32LE"_L1)) {
-
-    GstMapInfo map_info;
-    gst_buffer_map(buf, &map_info, GST_MAP_READ);
 
-    int32_t *s = reinterpret_cast<int32_t*>(map_info.data);
-    int samples = static_cast<int>((map_info.size / sizeof(int32_t)) / channels);
-    int buf16_size = samples * static_cast<int>(sizeof(int16_t)) * channels;
-    int16_t *d = static_cast<int16_t*>(g_malloc(static_cast<gsize>(buf16_size)));
-    memset(d, 0, static_cast<size_t>(buf16_size));
-    for (int i = 0; i < (samples * channels); ++i) {
-      d[i] = static_cast<int16_t>((s[i] >> 16));
+  if (GST_BUFFER_PTS_IS_VALID(buf)) {
+    const GstClockTime pts = GST_BUFFER_PTS(buf);
+    if (instance->eq_ramp_pending_.value()) {
+      instance->ApplyEqualizerRamp(pts);
     }
-    gst_buffer_unmap(buf, &map_info);
-    buf16 = gst_buffer_new_wrapped(d, static_cast<gsize>(buf16_size));
-    GST_BUFFER_DURATION(buf16) = GST_FRAMES_TO_CLOCK_TIME(static_cast<guint64>(samples * sizeof(int16_t) / channels), static_cast<guint64>(rate));
-    buf = buf16;
-
-    instance->logged_unsupported_analyzer_format_ = false;
-  }
-
-  else if (format.startsWith("F32LE"_L1)) {
-
-    GstMapInfo map_info;
-    gst_buffer_map(buf, &map_info, GST_MAP_READ);
-
-    float *s = reinterpret_cast<float*>(map_info.data);
-    int samples = static_cast<int>((map_info.size / sizeof(float)) / channels);
-    int buf16_size = samples * static_cast<int>(sizeof(int16_t)) * channels;
-    int16_t *d = static_cast<int16_t*>(g_malloc(static_cast<gsize>(buf16_size)));
-    memset(d, 0, static_cast<size_t>(buf16_size));
-    for (int i = 0; i < (samples * channels); ++i) {
-      float sample_float = (s[i] * static_cast<float>(32768.0));
-      d[i] = static_cast<int16_t>(sample_float);
+    // Also finish the ramp when seeking back before its start, the control points would otherwise never be reached.
+    else if (instance->eq_ramp_end_ != GST_CLOCK_TIME_NONE && (pts >= instance->eq_ramp_end_ || pts < instance->eq_ramp_start_)) {
+      instance->SetEqualizerValues();
     }
-    gst_buffer_unmap(buf, &map_info);
-    buf16 = gst_buffer_new_wrapped(d, static_cast<gsize>(buf16_size));
-    GST_BUFFER_DURATION(buf16) = GST_FRAMES_TO_CLOCK_TIME(static_cast<guint64>(samples * sizeof(int16_t) / channels), static_cast<guint64>(rate));
-    buf = buf16;
-
-    instance->logged_unsupported_analyzer_format_ = false;
   }
-  else if (format.startsWith("S24LE"_L1)) {
 
-    GstMapInfo map_info;
-    gst_buffer_map(buf, &map_info, GST_MAP_READ);
-
-    int8_t *s24 = reinterpret_cast<int8_t*>(map_info.data);
-    int8_t *s24e = s24 + map_info.size;
-    int samples = static_cast<int>((map_info.size / sizeof(int8_t)) / channels);
-    int buf16_size = samples * static_cast<int>(sizeof(int16_t)) * channels;
-    int16_t *s16 = static_cast<int16_t*>(g_malloc(static_cast<gsize>(buf16_size)));
-    memset(s16, 0, static_cast<size_t>(buf16_size));
-    for (int i = 0; i < (samples * channels); ++i) {
-      s16[i] = *(reinterpret_cast<int16_t*>(s24 + 1));
-      s24 += 3;
-      if (s24 >= s24e) break;
-    }
-    gst_buffer_unmap(buf, &map_info);
-    buf16 = gst_buffer_new_wrapped(s16, static_cast<gsize>(buf16_size));
-    GST_BUFFER_DURATION(buf16) = GST_FRAMES_TO_CLOCK_TIME(static_cast<guint64>(samples * sizeof(int16_t) / channels), static_cast<guint64>(rate));
-    buf = buf16;
-
-    instance->logged_unsupported_analyzer_format_ = false;
-  }
-  else if (format.startsWith("S24_32LE"_L1)) {
-
-    GstMapInfo map_info;
-    gst_buffer_map(buf, &map_info, GST_MAP_READ);
-
-    int32_t *s32 = reinterpret_cast<int32_t*>(map_info.data);
-    int32_t *s32e = s32 + map_info.size;
-    int32_t *s32p = s32;
-    int samples = static_cast<int>((map_info.size / sizeof(int32_t)) / channels);
-    int buf16_size = samples * static_cast<int>(sizeof(int16_t)) * channels;
-    int16_t *s16 = static_cast<int16_t*>(g_malloc(static_cast<gsize>(buf16_size)));
-    memset(s16, 0, static_cast<size_t>(buf16_size));
-    for (int i = 0; i < (samples * channels); ++i) {
-      int8_t *s24 = reinterpret_cast<int8_t*>(s32p);
-      s16[i] = *(reinterpret_cast<int16_t*>(s24 + 1));
-      ++s32p;
-      if (s32p > s32e) break;
-    }
-    gst_buffer_unmap(buf, &map_info);
-    buf16 = gst_buffer_new_wrapped(s16, static_cast<gsize>(buf16_size));
-    GST_BUFFER_DURATION(buf16) = GST_FRAMES_TO_CLOCK_TIME(static_cast<guint64>(samples * sizeof(int16_t) / channels), static_cast<guint64>(rate));
-    buf = buf16;
-
-    instance->logged_unsupported_analyzer_format_ = false;
-  }
-  else if (!instance->logged_unsupported_analyzer_format_) {
-    instance->logged_unsupported_analyzer_format_ = true;
-    qLog(Error) << "Unsupported audio format for the analyzer" << format;
+  // This buffer is about to go into the audio sink, so it is heard after the output latency.
+  if (GST_BUFFER_TIMESTAMP_IS_VALID(buf) && instance->segment_start_received_.value()) {
+    const qint64 output_latency = std::max(0LL, instance->output_latency_nanosec_.value());
+    instance->buffer_position_nanosec_.store(std::max(0LL, static_cast<qint64>(start_time) - output_latency), std::memory_order_relaxed);
   }
 
   QList<GstBufferConsumer*> consumers;
@@ -1383,13 +1492,44 @@ GstPadProbeReturn GstEnginePipeline::BufferProbeCallback(GstPad *pad, GstPadProb
     consumers = instance->buffer_consumers_;
   }
 
-  for (GstBufferConsumer *consumer : std::as_const(consumers)) {
-    gst_buffer_ref(buf);
-    consumer->ConsumeBuffer(buf, instance->id(), format);
-  }
+  // Without consumers, ie: in low power mode, the buffers aren't converted for the analyzer.
+  if (!consumers.isEmpty()) {
+    if (format.startsWith("S16LE"_L1)) {
+      instance->logged_unsupported_analyzer_format_ = false;
+    }
+    else if (format.startsWith("S32LE"_L1)) {
+      buf16 = ConvertBufferToS16(buf, channels, rate, sizeof(int32_t), ConvertS32ToS16);
+      buf = buf16;
+      instance->logged_unsupported_analyzer_format_ = false;
+    }
+    else if (format.startsWith("F32LE"_L1)) {
+      buf16 = ConvertBufferToS16(buf, channels, rate, sizeof(float), ConvertF32ToS16);
+      buf = buf16;
+      instance->logged_unsupported_analyzer_format_ = false;
+    }
+    else if (format.startsWith("S24LE"_L1)) {
+      buf16 = ConvertBufferToS16(buf, channels, rate, 3, ConvertS24ToS16);
+      buf = buf16;
+      instance->logged_unsupported_analyzer_format_ = false;
+    }
+    else if (format.startsWith("S24_32LE"_L1)) {
+      buf16 = ConvertBufferToS16(buf, channels, rate, sizeof(int32_t), ConvertS24_32ToS16);
+      buf = buf16;
+      instance->logged_unsupported_analyzer_format_ = false;
+    }
+    else if (!instance->logged_unsupported_analyzer_format_) {
+      instance->logged_unsupported_analyzer_format_ = true;
+      qLog(Error) << "Unsupported audio format for the analyzer" << format;
+    }
 
-  if (buf16) {
-    gst_buffer_unref(buf16);
+    for (GstBufferConsumer *consumer : std::as_const(consumers)) {
+      gst_buffer_ref(buf);
+      consumer->ConsumeBuffer(buf, instance->id(), format);
+    }
+
+    if (buf16) {
+      gst_buffer_unref(buf16);
+    }
   }
 
   // Calculate the end time of this buffer so we can stop playback if it's after the end time of this song.
@@ -1420,6 +1560,8 @@ GstPadProbeReturn GstEnginePipeline::BufferProbeCallback(GstPad *pad, GstPadProb
 
 void GstEnginePipeline::AboutToFinishCallback(GstPlayBin *playbin, gpointer self) {
 
+  qTraceScope("GstEnginePipeline::AboutToFinishCallback");
+
   Q_UNUSED(playbin)
 
   GstEnginePipeline *instance = reinterpret_cast<GstEnginePipeline*>(self);
@@ -1454,6 +1596,8 @@ void GstEnginePipeline::AboutToFinishCallback(GstPlayBin *playbin, gpointer self
 
 GstBusSyncReply GstEnginePipeline::BusSyncCallback(GstBus *bus, GstMessage *msg, gpointer self) {
 
+  qTraceScope("GstEnginePipeline::BusSyncCallback");
+
   Q_UNUSED(bus)
 
   GstEnginePipeline *instance = reinterpret_cast<GstEnginePipeline*>(self);
@@ -1491,6 +1635,10 @@ GstBusSyncReply GstEnginePipeline::BusSyncCallback(GstBus *bus, GstMessage *msg,
       instance->StreamStartMessageReceived();
       break;
 
+    case GST_MESSAGE_DURATION_CHANGED:
+      instance->duration_nanosec_.store(-1, std::memory_order_relaxed);
+      break;
+
     default:
       break;
   }
@@ -1501,6 +1649,8 @@ GstBusSyncReply GstEnginePipeline::BusSyncCallback(GstBus *bus, GstMessage *msg,
 
 gboolean GstEnginePipeline::BusWatchCallback(GstBus *bus, GstMessage *msg, gpointer self) {
 
+  qTraceScope("GstEnginePipeline::BusWatchCallback");
+
   Q_UNUSED(bus)
 
   GstEnginePipeline *instance = reinterpret_cast<GstEnginePipeline*>(self);
@@ -1510,10 +1660,6 @@ gboolean GstEnginePipeline::BusWatchCallback(GstBus *bus, GstMessage *msg, gpoin
       instance->ErrorMessageReceived(msg);
       break;
 
-    case GST_MESSAGE_TAG:
-      instance->TagMessageReceived(msg);
-      break;
-
     case GST_MESSAGE_STATE_CHANGED:
       instance->StateChangedMessageReceived(msg);
       break;
@@ -1559,11 +1705,19 @@ void GstEnginePipeline::StreamStartMessageReceived() {
       next_media_url_.clear();
       next_gst_url_.clear();
     }
+    {
+      QMutexLocker l(&mutex_last_tag_metadata_);
+      last_tag_metadata_ = EngineMetadata();
+    }
     beginning_offset_nanosec_ = next_beginning_offset_nanosec_;
     end_offset_nanosec_ = next_end_offset_nanosec_;
     next_beginning_offset_nanosec_ = 0;
     next_end_offset_nanosec_ = 0;
 
+    // Fall back to querying until buffers of the new stream reach the sink.
+    buffer_position_nanosec_.store(-1, std::memory_order_relaxed);
+    duration_nanosec_.store(-1, std::memory_order_relaxed);
+
     Q_EMIT EndOfStreamReached(id(), true);
   }
 
@@ -1708,6 +1862,31 @@ void GstEnginePipeline::TagMessageReceived(GstMessage *msg) {
 
   gst_tag_list_unref(taglist);
 
+  {
+    // Streams repeat the same tags, or only update the bitrate, most of the time.
+    QMutexLocker l(&mutex_last_tag_metadata_);
+    if (engine_metadata.media_url != last_tag_metadata_.media_url || engine_metadata.stream_url != last_tag_metadata_.stream_url) {
+      last_tag_metadata_ = EngineMetadata();
+      last_tag_metadata_.media_url = engine_metadata.media_url;
+      last_tag_metadata_.stream_url = engine_metadata.stream_url;
+    }
+    const auto changed = [](const QString &value, QString &last_value) {
+      if (value.isEmpty() || value == last_value) return false;
+      last_value = value;
+      return true;
+    };
+    bool tags_changed = changed(engine_metadata.title, last_tag_metadata_.title);
+    tags_changed = changed(engine_metadata.artist, last_tag_metadata_.artist) || tags_changed;
+    tags_changed = changed(engine_metadata.album, last_tag_metadata_.album) || tags_changed;
+    tags_changed = changed(engine_metadata.comment, last_tag_metadata_.comment) || tags_changed;
+    tags_changed = changed(engine_metadata.lyrics, last_tag_metadata_.lyrics) || tags_changed;
+    if (engine_metadata.bitrate > 0 && last_tag_metadata_.bitrate <= 0) {
+      last_tag_metadata_.bitrate = engine_metadata.bitrate;
+      tags_changed = true;
+    }
+    if (!tags_changed) return;
+  }
+
   Q_EMIT MetadataFound(id(), engine_metadata);
 
 }
@@ -1747,8 +1926,14 @@ void GstEnginePipeline::StateChangedMessageReceived(GstMessage *msg) {
   GstState old_state = GST_STATE_NULL, new_state = GST_STATE_NULL, pending = GST_STATE_NULL;
   gst_message_parse_state_changed(msg, &old_state, &new_state, &pending);
 
+  current_state_.store(new_state, std::memory_order_relaxed);
+
   qLog(Debug) << "Pipeline state changed from" << GstStateText(old_state) << "to" << GstStateText(new_state);
 
+  if (new_state == GST_STATE_PLAYING) {
+    UpdateOutputLatency();
+  }
+
   const bool pipeline_active = new_state == GST_STATE_PAUSED || new_state == GST_STATE_PLAYING;
   if (pipeline_active != pipeline_active_.value()) {
     pipeline_active_ = pipeline_active;
@@ -1804,6 +1989,8 @@ void GstEnginePipeline::BufferingMessageReceived(GstMessage *msg) {
   int percent = 0;
   gst_message_parse_buffering(msg, &percent);
 
+  UpdateNetworkBufferStatistics(msg);
+
   const GstState current_state = state();
 
   if (percent < 100 && !buffering_.value()) {
@@ -1823,6 +2010,8 @@ void GstEnginePipeline::BufferingMessageReceived(GstMessage *msg) {
     buffering_ = true;
     Q_EMIT BufferingStarted();
     if (current_state == GST_STATE_PLAYING) {
+      // The buffer ran empty while playing, so it was too short for this stream.
+      GrowNetworkBuffer();
       SetStateAsync(GST_STATE_PAUSED);
       if (pending_state_.value() == GST_STATE_NULL) {
         pending_state_ = current_state;
@@ -1847,21 +2036,103 @@ void GstEnginePipeline::BufferingMessageReceived(GstMessage *msg) {
 
 }
 
-GstState GstEnginePipeline::state() const {
+void GstEnginePipeline::SetupNetworkBuffering(const QUrl &stream_url) {
 
-  GstState s = GST_STATE_NULL, sp = GST_STATE_NULL;
-  if (!pipeline_ || gst_element_get_state(pipeline_, &s, &sp, kGstStateTimeoutNanosecs) == GST_STATE_CHANGE_FAILURE) {
-    return GST_STATE_NULL;
+  QMutexLocker l(&mutex_network_buffer_);
+
+  network_stream_ = stream_url.scheme() == "http"_L1 || stream_url.scheme() == "https"_L1;
+  network_buffer_statistics_ = EngineBase::NetworkBufferStatistics();
+  network_input_rate_ = 0.0;
+  network_input_rate_deviation_ = 0.0;
+
+  // Without a buffer duration the queue is limited by its default buffer and byte limits instead.
+  if (!audioqueue_ || buffer_duration_nanosec_ == 0) return;
+
+  quint64 buffer_duration_nanosec = buffer_duration_nanosec_;
+  if (network_stream_ && network_initial_buffer_duration_nanosec_ > 0) {
+    buffer_duration_nanosec = std::min(buffer_duration_nanosec_, network_initial_buffer_duration_nanosec_);
+  }
+  network_buffer_statistics_.buffer_duration_nanosec = buffer_duration_nanosec;
+
+  // The pipeline might be reused after playing a network stream, so this is also set back for other streams.
+  g_object_set(G_OBJECT(audioqueue_), "max-size-time", buffer_duration_nanosec, nullptr);
+
+  if (network_stream_ && buffer_duration_nanosec != buffer_duration_nanosec_) {
+    qLog(Debug) << "Starting network stream with a buffer duration of" << buffer_duration_nanosec;
+  }
+
+}
+
+void GstEnginePipeline::UpdateNetworkBufferStatistics(GstMessage *msg) {
+
+  GstBufferingMode mode = GST_BUFFERING_STREAM;
+  gint avg_in = 0;
+  gint avg_out = 0;
+  gint64 buffering_left = 0;
+  gst_message_parse_buffering_stats(msg, &mode, &avg_in, &avg_out, &buffering_left);
+
+  QMutexLocker l(&mutex_network_buffer_);
+
+  if (!network_stream_) return;
+
+  if (avg_out > 0) {
+    network_buffer_statistics_.output_rate = avg_out;
+  }
+
+  if (avg_in > 0) {
+    // Smoothed average and mean deviation of the input rate, estimated the same way TCP estimates the round trip time.
+    if (network_input_rate_ <= 0.0) {
+      network_input_rate_ = static_cast<double>(avg_in);
+      network_input_rate_deviation_ = static_cast<double>(avg_in) / 2.0;
+    }
+    else {
+      const double difference = static_cast<double>(avg_in) - network_input_rate_;
+      network_input_rate_ += difference / 8.0;
+      network_input_rate_deviation_ += (std::abs(difference) - network_input_rate_deviation_) / 4.0;
+    }
+    network_buffer_statistics_.input_rate = static_cast<qint64>(network_input_rate_);
+    network_buffer_statistics_.jitter = network_input_rate_deviation_ / network_input_rate_;
   }
 
-  return s;
+}
+
+void GstEnginePipeline::GrowNetworkBuffer() {
+
+  QMutexLocker l(&mutex_network_buffer_);
+
+  if (!network_stream_ || !audioqueue_ || buffer_duration_nanosec_ == 0) return;
+
+  ++network_buffer_statistics_.underruns;
+
+  const quint64 max_buffer_duration_nanosec = buffer_duration_nanosec_ * kMaxNetworkBufferDurationFactor;
+  const quint64 buffer_duration_nanosec = std::min(max_buffer_duration_nanosec, std::max(buffer_duration_nanosec_, network_buffer_statistics_.buffer_duration_nanosec * 2));
+  if (buffer_duration_nanosec == network_buffer_statistics_.buffer_duration_nanosec) return;
+
+  qLog(Debug) << "Buffer underrun" << network_buffer_statistics_.underruns << "growing buffer duration to" << buffer_duration_nanosec;
+  network_buffer_statistics_.buffer_duration_nanosec = buffer_duration_nanosec;
+  g_object_set(G_OBJECT(audioqueue_), "max-size-time", buffer_duration_nanosec, nullptr);
+
+}
+
+std::optional<EngineBase::NetworkBufferStatistics> GstEnginePipeline::network_buffer_statistics() const {
+
+  QMutexLocker l(&mutex_network_buffer_);
+
+  if (!network_stream_) return std::nullopt;
+
+  return network_buffer_statistics_;
 
 }
 
 qint64 GstEnginePipeline::length() const {
 
+  const qint64 duration = duration_nanosec_.load(std::memory_order_relaxed);
+  if (duration > 0) return duration;
+
   gint64 value = 0;
-  if (pipeline_) gst_element_query_duration(pipeline_, GST_FORMAT_TIME, &value);
+  if (pipeline_ && gst_element_query_duration(pipeline_, GST_FORMAT_TIME, &value) && value > 0) {
+    duration_nanosec_.store(value, std::memory_order_relaxed);
+  }
 
   return value;
 
@@ -1869,6 +2140,9 @@ qint64 GstEnginePipeline::length() const {
 
 qint64 GstEnginePipeline::position() const {
 
+  const qint64 buffer_position = buffer_position_nanosec_.load(std::memory_order_relaxed);
+  if (buffer_position >= 0) return buffer_position;
+
   if (pipeline_active_.value()) {
     gint64 current_position = 0;
     if (gst_element_query_position(pipeline_, GST_FORMAT_TIME, &current_position)) {
@@ -1933,6 +2207,37 @@ QFuture<GstStateChangeReturn> GstEnginePipeline::SetState(const GstState state)
 
 }
 
+GstState GstEnginePipeline::TogglePause(const bool allow_pause, const bool allow_play) {
+
+  if (!pipeline_ || buffering_.value()) return GST_STATE_VOID_PENDING;
+
+  // The target state is set as soon as a state change is started, unlike the current state which follows from the bus.
+  GST_OBJECT_LOCK(pipeline_);
+  const GstState target_state = GST_STATE_TARGET(pipeline_);
+  GST_OBJECT_UNLOCK(pipeline_);
+
+  GstState state = GST_STATE_VOID_PENDING;
+  if (target_state == GST_STATE_PLAYING && allow_pause) {
+    state = GST_STATE_PAUSED;
+  }
+  else if (target_state == GST_STATE_PAUSED && allow_play) {
+    state = GST_STATE_PLAYING;
+  }
+  else {
+    return GST_STATE_VOID_PENDING;
+  }
+
+  qLog(Debug) << "Setting pipeline" << id() << "state to" << GstStateText(state) << "from the transport fast path";
+
+  if (gst_element_set_state(pipeline_, state) == GST_STATE_CHANGE_FAILURE) {
+    qLog(Error) << "Failed to set pipeline to state" << GstStateText(state);
+    return GST_STATE_VOID_PENDING;
+  }
+
+  return state;
+
+}
+
 void GstEnginePipeline::SetStateFinishedSlot(const GstState state, const GstStateChangeReturn state_change_return) {
 
   last_set_state_in_progress_ = GST_STATE_VOID_PENDING;
@@ -2002,9 +2307,15 @@ bool GstEnginePipeline::Seek(const qint64 nanosec) {
 
   pending_seek_nanosec_ = -1;
   last_known_position_ns_ = nanosec;
+  buffer_position_nanosec_.store(nanosec, std::memory_order_relaxed);
 
   qLog(Debug) << "Seeking to" << nanosec;
 
+  // The stream time the fade ramp was anchored at is no longer valid after the seek.
+  if (fader_active_.value()) {
+    PrepareFaderRamp();
+  }
+
   const bool success = gst_element_seek_simple(pipeline_, GST_FORMAT_TIME, GST_SEEK_FLAG_FLUSH, nanosec);
 
   if (success) {
@@ -2101,11 +2412,54 @@ void GstEnginePipeline::SetEqualizerParams(const int preamp, const QList<int> &b
 
 }
 
+bool GstEnginePipeline::EqualizerNeutral() const {
+
+  return eq_preamp_ == 0 && std::all_of(eq_band_gains_.begin(), eq_band_gains_.end(), [](const int gain) { return gain == 0; });
+
+}
+
+void GstEnginePipeline::UpdateOutputLatency() {
+
+  GstQuery *query = gst_query_new_latency();
+  if (gst_element_query(pipeline_, query)) {
+    gboolean live = FALSE;
+    GstClockTime min_latency = 0;
+    GstClockTime max_latency = 0;
+    gst_query_parse_latency(query, &live, &min_latency, &max_latency);
+    // The sink's own ring buffer is not part of the upstream latency for non-live pipelines, so add its configured size.
+    gint64 buffer_time_usec = 0;
+    if (audiosink_ && g_object_class_find_property(G_OBJECT_GET_CLASS(audiosink_), "buffer-time")) {
+      g_object_get(G_OBJECT(audiosink_), "buffer-time", &buffer_time_usec, nullptr);
+    }
+    const qint64 latency_nanosec = static_cast<qint64>(min_latency) + buffer_time_usec * 1000;
+    if (latency_nanosec != output_latency_nanosec_.value()) {
+      output_latency_nanosec_ = latency_nanosec;
+      qLog(Debug) << "Output latency" << static_cast<double>(latency_nanosec) / static_cast<double>(kNsecPerMsec) << "ms";
+    }
+  }
+  gst_query_unref(query);
+
+}
+
 void GstEnginePipeline::UpdateEqualizer() {
 
   if (!equalizer_ || !equalizer_preamp_) return;
 
-  // Update band gains
+  if (!UpdateEqualizerTargets()) return;
+
+  if (eq_preamp_control_source_ && !eq_band_control_sources_.contains(nullptr)) {
+    eq_ramp_pending_ = true;
+  }
+  else {
+    SetEqualizerValues();
+  }
+
+}
+
+bool GstEnginePipeline::UpdateEqualizerTargets() {
+
+  QList<float> band_gains;
+  band_gains.reserve(kEqBandCount);
   for (int i = 0; i < kEqBandCount; ++i) {
     float gain = eq_enabled_ ? static_cast<float>(eq_band_gains_.value(i)) : static_cast<float>(0.0);
     if (gain < 0) {
@@ -2114,19 +2468,112 @@ void GstEnginePipeline::UpdateEqualizer() {
     else {
       gain *= 0.12F;
     }
+    band_gains << gain;
+  }
+
+  float preamp = 1.0F;
+  if (eq_enabled_) preamp = static_cast<float>(eq_preamp_ + 100) * 0.01F;  // To scale from 0.0 to 2.0
 
-    const int index_in_eq = i + 1;
+  QMutexLocker l(&mutex_eq_ramp_);
+  if (band_gains == eq_target_band_gains_ && preamp == eq_target_preamp_) return false;
+  eq_target_band_gains_ = band_gains;
+  eq_target_preamp_ = preamp;
+
+  return true;
+
+}
+
+void GstEnginePipeline::SetEqualizerValues() {
+
+  // Sets the target values directly, ending any running ramp.
+  // Every band that is set makes the equalizer recalculate its filter coefficients, so only set the bands that changed.
+  // Once all bands are back at exactly 0 and the preamp at 1.0, both elements switch themselves to passthrough.
+
+  QList<float> band_gains;
+  float preamp = 1.0F;
+  {
+    QMutexLocker l(&mutex_eq_ramp_);
+    band_gains = eq_target_band_gains_;
+    preamp = eq_target_preamp_;
+  }
+
+  for (int i = 0; i < band_gains.count(); ++i) {
     // Offset because of the first dummy band we created.
-    GstObject *band = GST_OBJECT(gst_child_proxy_get_child_by_index(GST_CHILD_PROXY(equalizer_), static_cast<guint>(index_in_eq)));
-    g_object_set(G_OBJECT(band), "gain", gain, nullptr);
+    GstObject *band = GST_OBJECT(gst_child_proxy_get_child_by_index(GST_CHILD_PROXY(equalizer_), static_cast<guint>(i + 1)));
+    if (!band) continue;
+    GstControlSource *control_source = eq_band_control_sources_.value(i);
+    if (control_source) {
+      // Keep the control points until the binding is disabled, so an enabled binding never runs without values.
+      gst_object_set_control_binding_disabled(band, "gain", TRUE);
+      gst_timed_value_control_source_unset_all(GST_TIMED_VALUE_CONTROL_SOURCE(control_source));
+    }
+    gdouble gain = 0.0;
+    g_object_get(G_OBJECT(band), "gain", &gain, nullptr);
+    if (gain != static_cast<gdouble>(band_gains[i])) {
+      g_object_set(G_OBJECT(band), "gain", static_cast<gdouble>(band_gains[i]), nullptr);
+    }
     g_object_unref(G_OBJECT(band));
   }
 
-  // Update preamp
+  if (eq_preamp_control_source_) {
+    gst_object_set_control_binding_disabled(GST_OBJECT(equalizer_preamp_), "volume", TRUE);
+    gst_timed_value_control_source_unset_all(GST_TIMED_VALUE_CONTROL_SOURCE(eq_preamp_control_source_));
+  }
+  gdouble volume = 0.0;
+  g_object_get(G_OBJECT(equalizer_preamp_), "volume", &volume, nullptr);
+  if (volume != static_cast<gdouble>(preamp)) {
+    g_object_set(G_OBJECT(equalizer_preamp_), "volume", static_cast<gdouble>(preamp), nullptr);
+  }
+
+  eq_ramp_start_ = GST_CLOCK_TIME_NONE;
+  eq_ramp_end_ = GST_CLOCK_TIME_NONE;
+
+}
+
+void GstEnginePipeline::ApplyEqualizerRamp(const GstClockTime stream_time) {
+
+  // Called from the streaming thread, ramps every band from its current gain to the target, starting at the buffer about to be processed by the equalizer.
+  // A ramp that is still running is restarted from where it is, so the gains never jump.
+  QList<float> band_gains;
   float preamp = 1.0F;
-  if (eq_enabled_) preamp = static_cast<float>(eq_preamp_ + 100) * 0.01F;  // To scale from 0.0 to 2.0
+  {
+    QMutexLocker l(&mutex_eq_ramp_);
+    band_gains = eq_target_band_gains_;
+    preamp = eq_target_preamp_;
+  }
+  eq_ramp_pending_ = false;
+
+  const GstClockTime end_time = stream_time + static_cast<GstClockTime>(kEqRampMsec * kNsecPerMsec);
+
+  for (int i = 0; i < band_gains.count() && i < eq_band_control_sources_.count(); ++i) {
+    GstObject *band = GST_OBJECT(gst_child_proxy_get_child_by_index(GST_CHILD_PROXY(equalizer_), static_cast<guint>(i + 1)));
+    if (!band) continue;
+    gdouble gain = 0.0;
+    g_object_get(G_OBJECT(band), "gain", &gain, nullptr);
+    if (gain != static_cast<gdouble>(band_gains[i])) {
+      RampControlSource(band, "gain", eq_band_control_sources_[i], stream_time, gain, end_time, band_gains[i]);
+    }
+    g_object_unref(G_OBJECT(band));
+  }
+
+  gdouble volume = 0.0;
+  g_object_get(G_OBJECT(equalizer_preamp_), "volume", &volume, nullptr);
+  if (volume != static_cast<gdouble>(preamp)) {
+    RampControlSource(GST_OBJECT(equalizer_preamp_), "volume", eq_preamp_control_source_, stream_time, volume, end_time, preamp);
+  }
 
-  g_object_set(G_OBJECT(equalizer_preamp_), "volume", preamp, nullptr);
+  eq_ramp_start_ = stream_time;
+  eq_ramp_end_ = end_time;
+
+}
+
+void GstEnginePipeline::RampControlSource(GstObject *object, const char *property_name, GstControlSource *control_source, const GstClockTime start_time, const double start_value, const GstClockTime end_time, const double end_value) {
+
+  GstTimedValueControlSource *timed_value_control_source = GST_TIMED_VALUE_CONTROL_SOURCE(control_source);
+  gst_timed_value_control_source_unset_all(timed_value_control_source);
+  gst_timed_value_control_source_set(timed_value_control_source, start_time, start_value);
+  gst_timed_value_control_source_set(timed_value_control_source, end_time, end_value);
+  gst_object_set_control_binding_disabled(object, property_name, FALSE);
 
 }
 
@@ -2172,7 +2619,9 @@ void GstEnginePipeline::StartFader(const qint64 duration_nanosec, const QTimeLin
     }
     timeline->deleteLater();
   });
-  QObject::connect(&*fader_, &QTimeLine::valueChanged, this, &GstEnginePipeline::SetFaderVolume);
+  if (!fader_control_source_) {
+    QObject::connect(&*fader_, &QTimeLine::valueChanged, this, &GstEnginePipeline::SetFaderVolume);
+  }
   QObject::connect(&*fader_, &QTimeLine::stateChanged, this, &GstEnginePipeline::FaderTimelineStateChanged);
   QObject::connect(&*fader_, &QTimeLine::finished, this, &GstEnginePipeline::FaderTimelineFinished);
   fader_->setDirection(direction);
@@ -2187,6 +2636,8 @@ void GstEnginePipeline::StartFader(const qint64 duration_nanosec, const QTimeLin
 
   SetFaderVolume(fader_->currentValue());
 
+  PrepareFaderRamp();
+
   qLog(Debug) << "Pipeline" << id() << "with state" << GstStateText(state()) << "set to fade from" << fader_->currentValue() << "time" << start_time << "direction" << (direction == QTimeLine::Direction::Forward ? "forward" : "backward");
 
   if (pipeline_active_.value()) {
@@ -2195,6 +2646,67 @@ void GstEnginePipeline::StartFader(const qint64 duration_nanosec, const QTimeLin
 
 }
 
+void GstEnginePipeline::PrepareFaderRamp() {
+
+  if (!fader_control_source_ || !fader_) return;
+
+  // Sample the easing curve along the rest of the fade, relative to the current time of the fader.
+  const bool forward = fader_->direction() == QTimeLine::Direction::Forward;
+  const qint64 current_msec = fader_->currentTime();
+  const qint64 remaining_msec = forward ? fader_->duration() - current_msec : current_msec;
+  QList<QPair<qint64, double>> ramp;
+  for (qint64 elapsed_msec = 0;; elapsed_msec = std::min(elapsed_msec + kFaderRampStepMsec, remaining_msec)) {
+    const qint64 timeline_msec = forward ? current_msec + elapsed_msec : current_msec - elapsed_msec;
+    ramp << qMakePair(elapsed_msec * kNsecPerMsec, fader_->valueForTime(static_cast<int>(timeline_msec)));
+    if (elapsed_msec >= remaining_msec) break;
+  }
+
+  {
+    QMutexLocker l(&mutex_fader_ramp_);
+    fader_ramp_ = ramp;
+  }
+  fader_ramp_pending_ = true;
+
+}
+
+void GstEnginePipeline::ApplyFaderRamp(const GstClockTime stream_time) {
+
+  // Called from the streaming thread, anchors the prepared ramp at the stream time of the buffer about to be processed by the fading volume element.
+  QList<QPair<qint64, double>> ramp;
+  {
+    QMutexLocker l(&mutex_fader_ramp_);
+    ramp = fader_ramp_;
+  }
+  fader_ramp_pending_ = false;
+
+  if (ramp.isEmpty()) return;
+
+  GstTimedValueControlSource *timed_value_control_source = GST_TIMED_VALUE_CONTROL_SOURCE(fader_control_source_);
+  gst_timed_value_control_source_unset_all(timed_value_control_source);
+  for (const QPair<qint64, double> &point : std::as_const(ramp)) {
+    gst_timed_value_control_source_set(timed_value_control_source, stream_time + static_cast<GstClockTime>(point.first), point.second);
+  }
+  gst_object_set_control_binding_disabled(GST_OBJECT(volume_fading_), "volume", FALSE);
+
+}
+
+void GstEnginePipeline::StopFaderRamp(const qreal volume) {
+
+  if (!fader_control_source_) return;
+
+  fader_ramp_pending_ = false;
+  {
+    QMutexLocker l(&mutex_fader_ramp_);
+    fader_ramp_.clear();
+  }
+
+  // Keep the control points until the binding is disabled, the volume element fails to process buffers when an enabled binding has no values.
+  gst_object_set_control_binding_disabled(GST_OBJECT(volume_fading_), "volume", TRUE);
+  gst_timed_value_control_source_unset_all(GST_TIMED_VALUE_CONTROL_SOURCE(fader_control_source_));
+  SetFaderVolume(volume);
+
+}
+
 void GstEnginePipeline::SetFaderVolume(const qreal volume) {
 
   if (volume_fading_) {
@@ -2224,6 +2736,8 @@ void GstEnginePipeline::FaderTimelineFinished() {
   fader_active_ = false;
   fader_running_ = false;
 
+  StopFaderRamp(fader_->direction() == QTimeLine::Direction::Forward ? 1.0 : 0.0);
+
   fader_.reset();
 
   timer_fader_timeout_->stop();
@@ -25,6 +25,7 @@
 #include "config.h"
 
 #include <optional>
+#include <atomic>
 
 #include <glib.h>
 #include <glib-object.h>
@@ -39,6 +40,7 @@
 #include <QTimeLine>
 #include <QEasingCurve>
 #include <QList>
+#include <QPair>
 #include <QByteArray>
 #include <QVariant>
 #include <QString>
@@ -48,6 +50,7 @@
 #include "includes/shared_ptr.h"
 #include "includes/mutex_protected.h"
 #include "core/enginemetadata.h"
+#include "enginebase.h"
 
 class QTimer;
 class GstBufferConsumer;
@@ -67,6 +70,7 @@ class GstEnginePipeline : public QObject {
   void set_output_device(const QString &output, const QVariant &device);
   void set_playbin3_enabled(const bool playbin3_enabled);
   void set_exclusive_mode(const bool exclusive_mode);
+  void set_low_latency(const bool low_latency);
   void set_volume_enabled(const bool enabled);
   void set_stereo_balancer_enabled(const bool enabled);
   void set_equalizer_enabled(const bool enabled);
@@ -75,6 +79,8 @@ class GstEnginePipeline : public QObject {
   void set_buffer_duration_nanosec(const quint64 duration_nanosec);
   void set_buffer_low_watermark(const double value);
   void set_buffer_high_watermark(const double value);
+  // Buffer duration used to start network streams with, grown back to the buffer duration and beyond after an underrun. Call before SetUrl.
+  void set_network_initial_buffer_duration_nanosec(const quint64 duration_nanosec);
   void set_proxy_settings(const QString &address, const bool authentication, const QString &user, const QString &pass);
   void set_channels(const bool enabled, const int channels);
   void set_bs2b_enabled(const bool enabled);
@@ -89,6 +95,11 @@ class GstEnginePipeline : public QObject {
   // Creates the pipeline, returns false on error
   bool InitFromUrl(const QUrl &media_url, const QUrl &stream_url, const QByteArray &gst_url, const qint64 beginning_offset_nanosec, const qint64 end_offset_nanosec, const double ebur128_loudness_normalizing_gain_db, QString &error);
 
+  // Creates the playbin and the audio bin without a URL, so the pipeline can be built before it's needed. Returns false on error
+  bool Init(QString &error);
+  // Sets the URL of a pipeline created with Init(), before it's started
+  void SetUrl(const QUrl &media_url, const QUrl &stream_url, const QByteArray &gst_url, const qint64 beginning_offset_nanosec, const qint64 end_offset_nanosec, const double ebur128_loudness_normalizing_gain_db);
+
   // GstBufferConsumers get fed audio data.  Thread-safe.
   void AddBufferConsumer(GstBufferConsumer *consumer);
   void RemoveBufferConsumer(GstBufferConsumer *consumer);
@@ -97,6 +108,9 @@ class GstEnginePipeline : public QObject {
   // Control the music playback
   Q_INVOKABLE QFuture<GstStateChangeReturn> SetState(const GstState state);
   Q_INVOKABLE QFuture<GstStateChangeReturn> Play(const bool pause, const quint64 offset_nanosec);
+  // Thread safe, pauses or resumes the pipeline from the calling thread depending on the state it is heading to.
+  // Returns the new state, or GST_STATE_VOID_PENDING if the pipeline was neither playing nor paused, or the change wasn't allowed.
+  GstState TogglePause(const bool allow_pause, const bool allow_play);
   Q_INVOKABLE bool Seek(const qint64 nanosec);
   void SeekAsync(const qint64 nanosec);
   void SeekDelayed(const qint64 nanosec);
@@ -127,11 +141,12 @@ class GstEnginePipeline : public QObject {
   QMutex *mutex_next_url() const { return &mutex_next_url_; }
   double ebur128_loudness_normalizing_gain_db() const { return ebur128_loudness_normalizing_gain_db_; }
 
-  // Returns this pipeline's state. May return GST_STATE_NULL if the state check timed out. The timeout value is a reasonable default.
-  GstState state() const;
+  // Returns this pipeline's state as last reported on the bus, without blocking on GStreamer.
+  GstState state() const { return current_state_.load(std::memory_order_relaxed); }
   // Please note that this method (unlike GstEngine's.length()) is multiple-section media unaware.
   qint64 length() const;
   // Please note that this method (unlike GstEngine's.position()) is multiple-section media unaware.
+  // Uses the position of the last buffer passed to the sink when there is one, so polling it from the UI doesn't query the pipeline.
   qint64 position() const;
   qint64 segment_start() const { return segment_start_.value(); }
 
@@ -140,6 +155,15 @@ class GstEnginePipeline : public QObject {
 
   bool exclusive_mode() const { return exclusive_mode_; }
 
+  // Output latency reported by the pipeline when it last started playing, -1 if not known
+  qint64 output_latency_nanosec() const { return output_latency_nanosec_.value(); }
+
+  // Amount of audio held in the audio queue, -1 if there is no queue
+  qint64 buffered_nanosec() const;
+
+  // Estimated from the buffering messages of the audio queue, only for network streams.
+  std::optional<EngineBase::NetworkBufferStatistics> network_buffer_statistics() const;
+
   QByteArray redirect_url() const { return redirect_url_; }
   QMutex *mutex_redirect_url() { return &mutex_redirect_url_; }
 
@@ -185,6 +209,9 @@ class GstEnginePipeline : public QObject {
   void ElementMessageReceived(GstMessage *msg);
   void StateChangedMessageReceived(GstMessage *msg);
   void BufferingMessageReceived(GstMessage *msg);
+  void SetupNetworkBuffering(const QUrl &stream_url);
+  void UpdateNetworkBufferStatistics(GstMessage *msg);
+  void GrowNetworkBuffer();
   void StreamStatusMessageReceived(GstMessage *msg);
   void StreamStartMessageReceived();
 
@@ -194,6 +221,12 @@ class GstEnginePipeline : public QObject {
   void UpdateEBUR128LoudnessNormalizingGaindB();
   void UpdateStereoBalance();
   void UpdateEqualizer();
+  bool UpdateEqualizerTargets();
+  void SetEqualizerValues();
+  void ApplyEqualizerRamp(const GstClockTime stream_time);
+  static void RampControlSource(GstObject *object, const char *property_name, GstControlSource *control_source, const GstClockTime start_time, const double start_value, const GstClockTime end_time, const double end_value);
+  bool EqualizerNeutral() const;
+  void UpdateOutputLatency();
 
   void Disconnect();
   void ResumeFaderAsync();
@@ -208,6 +241,9 @@ class GstEnginePipeline : public QObject {
   void FaderTimelineFinished();
   void FaderTimelineTimeout();
   void FaderFudgeFinished();
+  void PrepareFaderRamp();
+  void ApplyFaderRamp(const GstClockTime stream_time);
+  void StopFaderRamp(const qreal volume);
 
  private:
   // Using == to compare two pipelines is a bad idea, because new ones often get created in the same address as old ones.  This ID will be unique for each pipeline.
@@ -227,6 +263,7 @@ class GstEnginePipeline : public QObject {
   QString output_;
   QVariant device_;
   bool exclusive_mode_;
+  bool low_latency_;
   bool volume_enabled_;
   bool fading_enabled_;
   mutex_protected<bool> strict_ssl_enabled_;
@@ -236,6 +273,14 @@ class GstEnginePipeline : public QObject {
   double buffer_low_watermark_;
   double buffer_high_watermark_;
 
+  // Adaptive buffering of network streams
+  quint64 network_initial_buffer_duration_nanosec_;
+  mutable QMutex mutex_network_buffer_;
+  bool network_stream_;
+  EngineBase::NetworkBufferStatistics network_buffer_statistics_;
+  double network_input_rate_;
+  double network_input_rate_deviation_;
+
   // Proxy
   QString proxy_address_;
   bool proxy_authentication_;
@@ -260,6 +305,17 @@ class GstEnginePipeline : public QObject {
   bool eq_enabled_;
   int eq_preamp_;
   QList<int> eq_band_gains_;
+  // Gain changes are ramped in stream time by the streaming thread, so moving a slider doesn't make the output jump.
+  // The GUI thread only stores the target values, any number of slider updates between two buffers end up as a single ramp.
+  QMutex mutex_eq_ramp_;
+  QList<float> eq_target_band_gains_;
+  float eq_target_preamp_;
+  mutex_protected<bool> eq_ramp_pending_;
+  QList<GstControlSource*> eq_band_control_sources_;
+  GstControlSource *eq_preamp_control_source_;
+  // Only accessed from the streaming thread.
+  GstClockTime eq_ramp_start_;
+  GstClockTime eq_ramp_end_;
 
   // ReplayGain
   bool rg_enabled_;
@@ -312,6 +368,10 @@ class GstEnginePipeline : public QObject {
   // Set temporarily when switching out the decode bin, so metadata doesn't get sent while the Player still thinks it's playing the last song
   mutex_protected<bool> ignore_tags_;
 
+  // The last metadata sent for the stream, so tag messages that don't change anything are not sent again.
+  EngineMetadata last_tag_metadata_;
+  QMutex mutex_last_tag_metadata_;
+
   // When the gstreamer source requests a redirect we store the URL here and callers can pick it up after the state change to PLAYING fails.
   mutable QMutex mutex_redirect_url_;
   QByteArray redirect_url_;
@@ -326,6 +386,8 @@ class GstEnginePipeline : public QObject {
   mutex_protected<bool> pipeline_active_;
   mutex_protected<bool> buffering_;
 
+  mutex_protected<qint64> output_latency_nanosec_;
+
   mutex_protected<GstState> pending_state_;
   mutex_protected<qint64> pending_seek_nanosec_;
   mutex_protected<GstState> pending_seek_ready_previous_state_;
@@ -335,6 +397,11 @@ class GstEnginePipeline : public QObject {
   // it here so that we can use it when using gst_element_query_position() is not possible.
   mutable gint64 last_known_position_ns_;
 
+  // Written from the streaming thread and the bus, read by the position, length and state polling from the main thread.
+  std::atomic<qint64> buffer_position_nanosec_;
+  mutable std::atomic<qint64> duration_nanosec_;
+  std::atomic<GstState> current_state_;
+
   // Complete the transition to the next song when it starts playing
   mutex_protected<bool> next_uri_set_;
   mutex_protected<bool> next_uri_need_reset_;
@@ -351,6 +418,14 @@ class GstEnginePipeline : public QObject {
   QTimer *timer_fader_fudge_;
   QTimer *timer_fader_timeout_;
 
+  // The fade is applied as a volume ramp on the fading volume element in stream time, so it is sample accurate and doesn't depend on the event loop.
+  // StartFader() prepares the ramp relative to the start of the fade, and the streaming thread anchors it at the next buffer.
+  // The QTimeLine is only used to track the progress of the fade.
+  GstControlSource *fader_control_source_;
+  QMutex mutex_fader_ramp_;
+  QList<QPair<qint64, double>> fader_ramp_;
+  mutex_protected<bool> fader_ramp_pending_;
+
   GstElement *pipeline_;
   GstElement *audiobin_;
   GstElement *audiosink_;
@@ -23,6 +23,10 @@
 #include <cstring>
 #include <cmath>
 
+#include <algorithm>
+#include <map>
+#include <cstring>
+
 #include <glib.h>
 
 #include <gst/gst.h>
@@ -46,6 +50,10 @@ enum {
   PROP_BANDS
 };
 
+// Plans by FFT size, shared by all instances and kept until exit. Only accessed with the class fftw lock held.
+std::map<guint, fftwf_plan> fftw_plans;
+bool fftw_wisdom_imported = false;
+
 }  // namespace
 
 #ifdef __GNUC__
@@ -129,39 +137,70 @@ static void gst_strawberry_fastspectrum_init(GstStrawberryFastSpectrum *fastspec
 
 }
 
+static fftwf_plan gst_strawberry_fastspectrum_get_plan(GstStrawberryFastSpectrumClass *klass, const guint nfft) {
+
+  g_mutex_lock(&klass->fftw_lock);
+
+  std::map<guint, fftwf_plan>::const_iterator it = fftw_plans.find(nfft);
+  if (it != fftw_plans.end()) {
+    fftwf_plan plan = it->second;
+    g_mutex_unlock(&klass->fftw_lock);
+    return plan;
+  }
+
+  // Measuring finds a faster plan than estimating, the saved wisdom makes it quick after the first time.
+  gchar *wisdom_filename = g_build_filename(g_get_user_cache_dir(), "strawberry", "fftwf-wisdom", nullptr);
+  if (!fftw_wisdom_imported) {
+    fftwf_import_wisdom_from_filename(wisdom_filename);
+    fftw_wisdom_imported = true;
+  }
+
+  // Measuring overwrites the arrays, so the plan is made on arrays of its own.
+  float *input = fftwf_alloc_real(nfft);
+  fftwf_complex *output = fftwf_alloc_complex(nfft / 2 + 1);
+  fftwf_plan plan = fftwf_plan_dft_r2c_1d(static_cast<int>(nfft), input, output, FFTW_MEASURE);
+  fftwf_free(input);
+  fftwf_free(output);
+  fftw_plans[nfft] = plan;
+
+  gchar *wisdom_path = g_path_get_dirname(wisdom_filename);
+  if (g_mkdir_with_parents(wisdom_path, 0700) == 0) {
+    fftwf_export_wisdom_to_filename(wisdom_filename);
+  }
+  g_free(wisdom_path);
+  g_free(wisdom_filename);
+
+  g_mutex_unlock(&klass->fftw_lock);
+
+  return plan;
+
+}
+
 static void gst_strawberry_fastspectrum_alloc_channel_data(GstStrawberryFastSpectrum *fastspectrum) {
 
   const guint bands = fastspectrum->bands;
   const guint nfft = 2 * bands - 2;
 
-  fastspectrum->input_ring_buffer = new double[nfft];
-  fastspectrum->fft_input = reinterpret_cast<double*>(fftw_malloc(sizeof(double) * nfft));
-  fastspectrum->fft_output = reinterpret_cast<fftw_complex*>(fftw_malloc(sizeof(fftw_complex) * (nfft / 2 + 1)));
+  fastspectrum->input_ring_buffer = new float[nfft]{};
+  // Allocated by fftw, so they have the alignment the shared plan was made for.
+  fastspectrum->fft_input = fftwf_alloc_real(nfft);
+  fastspectrum->fft_output = fftwf_alloc_complex(nfft / 2 + 1);
 
   fastspectrum->spect_magnitude = new double[bands]{};
 
   GstStrawberryFastSpectrumClass *klass = reinterpret_cast<GstStrawberryFastSpectrumClass*>(G_OBJECT_GET_CLASS(fastspectrum));
-  {
-    g_mutex_lock(&klass->fftw_lock);
-    fastspectrum->plan = fftw_plan_dft_r2c_1d(static_cast<int>(nfft), fastspectrum->fft_input, fastspectrum->fft_output, FFTW_ESTIMATE);
-    g_mutex_unlock(&klass->fftw_lock);
-  }
+  fastspectrum->plan = gst_strawberry_fastspectrum_get_plan(klass, nfft);
   fastspectrum->channel_data_initialized = true;
 
 }
 
 static void gst_strawberry_fastspectrum_free_channel_data(GstStrawberryFastSpectrum *fastspectrum) {
 
-  GstStrawberryFastSpectrumClass *klass = reinterpret_cast<GstStrawberryFastSpectrumClass*>(G_OBJECT_GET_CLASS(fastspectrum));
-
   if (fastspectrum->channel_data_initialized) {
-    {
-      g_mutex_lock(&klass->fftw_lock);
-      fftw_destroy_plan(fastspectrum->plan);
-      g_mutex_unlock(&klass->fftw_lock);
-    }
-    fftw_free(fastspectrum->fft_input);
-    fftw_free(fastspectrum->fft_output);
+    // The plan is shared, and kept for the next instance with the same size.
+    fastspectrum->plan = nullptr;
+    fftwf_free(fastspectrum->fft_input);
+    fftwf_free(fastspectrum->fft_output);
     delete[] fastspectrum->input_ring_buffer;
     delete[] fastspectrum->spect_magnitude;
 
@@ -269,75 +308,71 @@ static gboolean gst_strawberry_fastspectrum_stop(GstBaseTransform *transform) {
 }
 
 // Mixing data readers
+// The frames are written to the ring buffer in at most two contiguous parts, so the conversion loops can be vectorized.
 
-static void gst_strawberry_fastspectrum_input_data_mixed_float(const guint8 *_in, double *out, const guint64 len, const double max_value, guint op, const guint nfft) {
+template<typename Convert>
+static void gst_strawberry_fastspectrum_write_ring(float *out, const guint64 len, guint op, const guint nfft, Convert convert) {
 
-  (void)max_value;
-
-  const gfloat *in = reinterpret_cast<const gfloat*>(_in);
-  guint ip = 0;
-
-  for (guint64 j = 0; j < len; j++) {
-    out[op] = in[ip++];
-    op = (op + 1) % nfft;
+  guint64 done = 0;
+  while (done < len) {
+    const guint64 part = std::min(len - done, static_cast<guint64>(nfft - op));
+    convert(done, out + op, part);
+    done += part;
+    op = static_cast<guint>((op + part) % nfft);
   }
 
 }
 
-static void gst_strawberry_fastspectrum_input_data_mixed_double(const guint8 *_in, double *out, const guint64 len, const double max_value, guint op, const guint nfft) {
-
-  (void)max_value;
+template<typename T>
+static void gst_strawberry_fastspectrum_input_data_mixed_scaled(const guint8 *_in, float *out, const guint64 len, const double max_value, const guint op, const guint nfft) {
 
-  const gdouble *in = reinterpret_cast<const gdouble*>(_in);
-  guint ip = 0;
+  const T *in = reinterpret_cast<const T*>(_in);
+  const float scale = static_cast<float>(1.0 / max_value);
 
-  for (guint64 j = 0; j < len; j++) {
-    out[op] = in[ip++];
-    op = (op + 1) % nfft;
-  }
+  gst_strawberry_fastspectrum_write_ring(out, len, op, nfft, [in, scale](const guint64 offset, float *part_out, const guint64 part_len) {
+    const T *part_in = in + offset;
+    for (guint64 j = 0; j < part_len; j++) {
+      part_out[j] = static_cast<float>(part_in[j]) * scale;
+    }
+  });
 
 }
 
-static void gst_strawberry_fastspectrum_input_data_mixed_int32_max(const guint8 *_in, double *out, const guint64 len, const double max_value, guint op, const guint nfft) {
+template<typename T>
+static void gst_strawberry_fastspectrum_input_data_mixed_float(const guint8 *_in, float *out, const guint64 len, const double max_value, const guint op, const guint nfft) {
 
-  const gint32 *in = reinterpret_cast<const gint32*>(_in);
-  guint ip = 0;
+  (void)max_value;
 
-  for (guint64 j = 0; j < len; j++) {
-    out[op] = in[ip++] / max_value;
-    op = (op + 1) % nfft;
-  }
+  const T *in = reinterpret_cast<const T*>(_in);
+
+  gst_strawberry_fastspectrum_write_ring(out, len, op, nfft, [in](const guint64 offset, float *part_out, const guint64 part_len) {
+    const T *part_in = in + offset;
+    for (guint64 j = 0; j < part_len; j++) {
+      part_out[j] = static_cast<float>(part_in[j]);
+    }
+  });
 
 }
 
-static void gst_strawberry_fastspectrum_input_data_mixed_int24_max(const guint8 *_in, double *out, const guint64 len, const double max_value, guint op, const guint nfft) {
+static void gst_strawberry_fastspectrum_input_data_mixed_int24_max(const guint8 *_in, float *out, const guint64 len, const double max_value, const guint op, const guint nfft) {
+
+  const float scale = static_cast<float>(1.0 / max_value);
 
-  for (guint64 j = 0; j < len; j++) {
+  gst_strawberry_fastspectrum_write_ring(out, len, op, nfft, [_in, scale](const guint64 offset, float *part_out, const guint64 part_len) {
+    const guint8 *part_in = _in + (offset * 3);
+    for (guint64 j = 0; j < part_len; j++) {
 #if G_BYTE_ORDER == G_BIG_ENDIAN
-    guint32 value = GST_READ_UINT24_BE(_in);
+      guint32 value = GST_READ_UINT24_BE(part_in);
 #else
-    guint32 value = GST_READ_UINT24_LE(_in);
+      guint32 value = GST_READ_UINT24_LE(part_in);
 #endif
-    if (value & 0x00800000) {
-      value |= 0xff000000;
+      if (value & 0x00800000) {
+        value |= 0xff000000;
+      }
+      part_out[j] = static_cast<float>(static_cast<gint32>(value)) * scale;
+      part_in += 3;
     }
-
-    out[op] = value / max_value;
-    op = (op + 1) % nfft;
-    _in += 3;
-  }
-
-}
-
-static void gst_strawberry_fastspectrum_input_data_mixed_int16_max(const guint8 *_in, double *out, const guint64 len, const double max_value, guint op, const guint nfft) {
-
-  const gint16 *in = reinterpret_cast<const gint16*>(_in);
-  guint ip = 0;
-
-  for (guint64 j = 0; j < len; j++) {
-    out[op] = in[ip++] / max_value;
-    op = (op + 1) % nfft;
-  }
+  });
 
 }
 
@@ -349,19 +384,19 @@ static gboolean gst_strawberry_fastspectrum_setup(GstAudioFilter *audio_filter,
   g_mutex_lock(&fastspectrum->lock);
   switch (GST_AUDIO_INFO_FORMAT(audio_info)) {
     case GST_AUDIO_FORMAT_S16:
-      input_data = gst_strawberry_fastspectrum_input_data_mixed_int16_max;
+      input_data = gst_strawberry_fastspectrum_input_data_mixed_scaled<gint16>;
       break;
     case GST_AUDIO_FORMAT_S24:
       input_data = gst_strawberry_fastspectrum_input_data_mixed_int24_max;
       break;
     case GST_AUDIO_FORMAT_S32:
-      input_data = gst_strawberry_fastspectrum_input_data_mixed_int32_max;
+      input_data = gst_strawberry_fastspectrum_input_data_mixed_scaled<gint32>;
       break;
     case GST_AUDIO_FORMAT_F32:
-      input_data = gst_strawberry_fastspectrum_input_data_mixed_float;
+      input_data = gst_strawberry_fastspectrum_input_data_mixed_float<gfloat>;
       break;
     case GST_AUDIO_FORMAT_F64:
-      input_data = gst_strawberry_fastspectrum_input_data_mixed_double;
+      input_data = gst_strawberry_fastspectrum_input_data_mixed_float<gdouble>;
       break;
     default:
       g_assert_not_reached();
@@ -381,18 +416,18 @@ static void gst_strawberry_fastspectrum_run_fft(GstStrawberryFastSpectrum *fasts
   const guint bands = fastspectrum->bands;
   const guint nfft = 2 * bands - 2;
 
-  for (guint i = 0; i < nfft; i++) {
-    fastspectrum->fft_input[i] = fastspectrum->input_ring_buffer[(input_pos + i) % nfft];
-  }
+  // Unroll the ring buffer, oldest frame first.
+  memcpy(fastspectrum->fft_input, fastspectrum->input_ring_buffer + input_pos, (nfft - input_pos) * sizeof(float));
+  memcpy(fastspectrum->fft_input + (nfft - input_pos), fastspectrum->input_ring_buffer, input_pos * sizeof(float));
 
-  // Should be safe to execute the same plan multiple times in parallel.
-  fftw_execute(fastspectrum->plan);
+  // Executing a plan on other arrays is thread safe, the plan is shared with the other instances.
+  fftwf_execute_dft_r2c(fastspectrum->plan, fastspectrum->fft_input, fastspectrum->fft_output);
 
   // Calculate magnitude in db
   for (guint i = 0; i < bands; i++) {
-    gdouble value = fastspectrum->fft_output[i][0] * fastspectrum->fft_output[i][0];
-    value += fastspectrum->fft_output[i][1] * fastspectrum->fft_output[i][1];
-    value /= nfft * nfft;
+    gdouble value = static_cast<gdouble>(fastspectrum->fft_output[i][0]) * fastspectrum->fft_output[i][0];
+    value += static_cast<gdouble>(fastspectrum->fft_output[i][1]) * fastspectrum->fft_output[i][1];
+    value /= static_cast<gdouble>(nfft) * nfft;
     fastspectrum->spect_magnitude[i] += value;
   }
 
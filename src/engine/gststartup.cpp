@@ -20,6 +20,7 @@
 #include "config.h"
 
 #include <cstring>
+#include <mutex>
 #include <glib.h>
 
 #include <gst/gst.h>
@@ -29,9 +30,12 @@
 #include <QString>
 #include <QDir>
 #include <QFile>
+#include <QFuture>
+#include <QElapsedTimer>
 
 #include "core/logging.h"
 #include "core/standardpaths.h"
+#include "core/taskexecutor.h"
 #include "utilities/envutils.h"
 
 #ifdef HAVE_MOODBAR
@@ -42,11 +46,15 @@
 
 using namespace Qt::Literals::StringLiterals;
 
-namespace GstStartup {
+namespace {
 
-void Initialize() {
+QFuture<void> sInitialized;
+std::once_flag sInitializeOnce;
 
-  SetEnvironment();
+void InitializeGStreamer() {
+
+  QElapsedTimer timer;
+  timer.start();
 
   gst_init(nullptr, nullptr);
   gst_pb_utils_init();
@@ -75,6 +83,40 @@ void Initialize() {
   }
 #endif
 
+  qLog(Debug) << "GStreamer initialized in" << timer.elapsed() << "ms";
+
+}
+
+}  // namespace
+
+namespace GstStartup {
+
+void Initialize() {
+
+  SetEnvironment();
+  std::call_once(sInitializeOnce, InitializeGStreamer);
+
+}
+
+void InitializeAsync() {
+
+  // The environment is set up here, before any other thread could be reading it.
+  SetEnvironment();
+  sInitialized = TaskExecutor::Run(TaskExecutor::Lane::BackgroundIO, []() { std::call_once(sInitializeOnce, InitializeGStreamer); });
+
+}
+
+QFuture<void> Initialized() {
+
+  return sInitialized;
+
+}
+
+void WaitForInitialized() {
+
+  // Waits for the background thread if it's still initializing.
+  std::call_once(sInitializeOnce, InitializeGStreamer);
+
 }
 
 void SetEnvironment() {
@@ -20,8 +20,16 @@
 #ifndef GSTSTARTUP_H
 #define GSTSTARTUP_H
 
+#include <QFuture>
+
 namespace GstStartup {
 void Initialize();
+// Initializes GStreamer on a background thread, so a plugin registry rebuild after a GStreamer update doesn't hold up the startup.
+void InitializeAsync();
+// Finishes when GStreamer is initialized.
+QFuture<void> Initialized();
+// Blocks until GStreamer is initialized, has to be called before using GStreamer.
+void WaitForInitialized();
 void SetEnvironment();
 }  // namespace GstStartup
 
@@ -22,7 +22,7 @@
 
 #include "config.h"
 
-#include <QFileInfo>
+#include <QString>
 
 #include "core/simpletreeitem.h"
 
@@ -40,8 +40,7 @@ class FileViewTreeItem : public SimpleTreeItem<FileViewTreeItem> {
 
   Type type;
   QString file_path;        // Absolute file system path
-  QFileInfo file_info;      // Cached file info
-  bool lazy_loaded;         // Whether children have been loaded
+  bool lazy_loaded;         // Whether children have been requested
 
  private:
   Q_DISABLE_COPY(FileViewTreeItem)
@@ -17,6 +17,8 @@
  *
  */
 
+#include <algorithm>
+
 #include <QObject>
 #include <QVariant>
 #include <QString>
@@ -24,25 +26,38 @@
 #include <QList>
 #include <QMap>
 #include <QDir>
+#include <QDirIterator>
 #include <QFileInfo>
 #include <QFileIconProvider>
+#include <QMimeDatabase>
+#include <QMimeType>
 #include <QMimeData>
 #include <QUrl>
 #include <QIcon>
+#include <QFuture>
+#include <QFutureWatcher>
+#include <QPromise>
+#include <QPersistentModelIndex>
 
 #include "core/simpletreemodel.h"
 #include "core/logging.h"
+#include "core/taskexecutor.h"
 #include "fileviewtreemodel.h"
 #include "fileviewtreeitem.h"
 
 using namespace Qt::Literals::StringLiterals;
 
+namespace {
+constexpr int kListingChunkSize = 250;
+}
+
 FileViewTreeModel::FileViewTreeModel(QObject *parent)
     : SimpleTreeModel<FileViewTreeItem>(new FileViewTreeItem(this), parent),
       icon_provider_(new QFileIconProvider()) {
 }
 
 FileViewTreeModel::~FileViewTreeModel() {
+  CancelListings();
   delete root_;
   delete icon_provider_;
 }
@@ -76,7 +91,7 @@ QVariant FileViewTreeModel::data(const QModelIndex &idx, const int role) const {
       if (item->type == FileViewTreeItem::Type::VirtualRoot) {
         return item->display_text.isEmpty() ? item->file_path : item->display_text;
       }
-      return item->file_info.fileName();
+      return item->display_text;
 
     case Qt::DecorationRole:
       return GetIcon(item);
@@ -88,7 +103,7 @@ QVariant FileViewTreeModel::data(const QModelIndex &idx, const int role) const {
       return item->file_path;
 
     case Role_FileName:
-      return item->file_info.fileName();
+      return QFileInfo(item->file_path).fileName();
 
     default:
       return QVariant();
@@ -137,38 +152,100 @@ void FileViewTreeModel::fetchMore(const QModelIndex &parent) {
 void FileViewTreeModel::LazyLoad(FileViewTreeItem *item) {
 
   if (item->lazy_loaded) return;
+  item->lazy_loaded = true;
 
-  QDir dir(item->file_path);
-  if (!dir.exists()) {
-    item->lazy_loaded = true;
-    return;
-  }
+  DirectoryWatcher *watcher = new DirectoryWatcher(this);
+  listings_.insert(item, watcher);
+  QObject::connect(watcher, &DirectoryWatcher::resultsReadyAt, this, [this, item, watcher](const int begin, const int end) {
+    for (int i = begin; i < end; ++i) {
+      AddEntries(item, watcher->resultAt(i));
+    }
+  });
+  QObject::connect(watcher, &DirectoryWatcher::finished, this, [this, item]() { ListingFinished(item); });
+  watcher->setFuture(TaskExecutor::Run(TaskExecutor::Lane::BackgroundIO, &FileViewTreeModel::ListDirectory, item->file_path, name_filters_));
+
+}
 
-  // Apply name filters
-  const QDir::Filters filters = QDir::AllDirs | QDir::Files | QDir::NoDotAndDotDot;
-  if (!name_filters_.isEmpty()) {
-    dir.setNameFilters(name_filters_);
+void FileViewTreeModel::ListDirectory(QPromise<DirectoryEntries> &promise, const QString &path, const QStringList &name_filters) {
+
+  // Only the entry type is needed, which on most file systems comes with the directory entry itself.
+  QDirIterator it(path, name_filters, QDir::AllDirs | QDir::Files | QDir::NoDotAndDotDot);
+  DirectoryEntries entries;
+  entries.reserve(kListingChunkSize);
+  while (it.hasNext()) {
+    if (promise.isCanceled()) return;
+    const QFileInfo fileinfo = it.nextFileInfo();
+    entries << DirectoryEntry { fileinfo.fileName(), fileinfo.isDir() };
+    if (entries.count() >= kListingChunkSize) {
+      promise.addResult(entries);
+      entries.clear();
+      entries.reserve(kListingChunkSize);
+    }
   }
 
-  const QFileInfoList entries = dir.entryInfoList(filters, QDir::Name | QDir::DirsFirst);
   if (!entries.isEmpty()) {
-    BeginInsert(item, 0, static_cast<int>(entries.count()) - 1);
-
-    for (const QFileInfo &entry : entries) {
-      FileViewTreeItem *child = new FileViewTreeItem(
-        entry.isDir() ? FileViewTreeItem::Type::Directory : FileViewTreeItem::Type::File,
-        item
-      );
-      child->file_path = entry.absoluteFilePath();
-      child->file_info = entry;
-      child->lazy_loaded = false;
-      child->display_text = entry.fileName();
-    }
+    promise.addResult(entries);
+  }
+
+}
+
+void FileViewTreeModel::AddEntries(FileViewTreeItem *item, const DirectoryEntries &entries) {
+
+  if (entries.isEmpty()) return;
 
-    EndInsert();
+  const QString path_prefix = item->file_path.endsWith(u'/') ? item->file_path : item->file_path + u'/';
+
+  const int row = static_cast<int>(item->children.count());
+  BeginInsert(item, row, row + static_cast<int>(entries.count()) - 1);
+  for (const DirectoryEntry &entry : entries) {
+    FileViewTreeItem *child = new FileViewTreeItem(entry.is_dir ? FileViewTreeItem::Type::Directory : FileViewTreeItem::Type::File, item);
+    child->file_path = path_prefix + entry.file_name;
+    child->display_text = entry.file_name;
+    child->lazy_loaded = false;
   }
+  EndInsert();
 
-  item->lazy_loaded = true;
+}
+
+void FileViewTreeModel::ListingFinished(FileViewTreeItem *item) {
+
+  DirectoryWatcher *watcher = listings_.take(item);
+  if (!watcher) return;
+  watcher->deleteLater();
+
+  SortChildren(item);
+
+}
+
+void FileViewTreeModel::SortChildren(FileViewTreeItem *item) {
+
+  // Entries are added in the order the file system returns them, sort them once the listing is complete, directories first.
+  const auto less_than = [](const FileViewTreeItem *a, const FileViewTreeItem *b) {
+    const bool a_is_dir = a->type != FileViewTreeItem::Type::File;
+    const bool b_is_dir = b->type != FileViewTreeItem::Type::File;
+    if (a_is_dir != b_is_dir) return a_is_dir;
+    return a->display_text < b->display_text;
+  };
+  if (std::is_sorted(item->children.begin(), item->children.end(), less_than)) return;
+
+  const QList<QPersistentModelIndex> parents = QList<QPersistentModelIndex>() << QPersistentModelIndex(ItemToIndex(item));
+  Q_EMIT layoutAboutToBeChanged(parents, QAbstractItemModel::VerticalSortHint);
+
+  std::stable_sort(item->children.begin(), item->children.end(), less_than);
+  for (int i = 0; i < item->children.count(); ++i) {
+    item->children[i]->row = i;
+  }
+
+  const QModelIndexList old_indexes = persistentIndexList();
+  QModelIndexList new_indexes;
+  new_indexes.reserve(old_indexes.count());
+  for (const QModelIndex &old_index : old_indexes) {
+    FileViewTreeItem *child = IndexToItem(old_index);
+    new_indexes << (child->parent == item ? createIndex(child->row, old_index.column(), child) : old_index);
+  }
+  changePersistentIndexList(old_indexes, new_indexes);
+
+  Q_EMIT layoutChanged(parents, QAbstractItemModel::VerticalSortHint);
 
 }
 
@@ -180,8 +257,16 @@ QIcon FileViewTreeModel::GetIcon(const FileViewTreeItem *item) const {
     case FileViewTreeItem::Type::VirtualRoot:
     case FileViewTreeItem::Type::Directory:
       return icon_provider_->icon(QFileIconProvider::Folder);
-    case FileViewTreeItem::Type::File:
-      return icon_provider_->icon(item->file_info);
+    case FileViewTreeItem::Type::File:{
+      // Look the icon up by the file name only, asking the icon provider for the file itself would access the file.
+      const QString suffix = QFileInfo(item->file_path).suffix().toLower();
+      if (file_icons_.contains(suffix)) return file_icons_.value(suffix);
+      const QMimeType mimetype = QMimeDatabase().mimeTypeForFile(item->file_path, QMimeDatabase::MatchExtension);
+      QIcon icon = QIcon::fromTheme(mimetype.iconName(), QIcon::fromTheme(mimetype.genericIconName()));
+      if (icon.isNull()) icon = icon_provider_->icon(QFileIconProvider::File);
+      file_icons_.insert(suffix, icon);
+      return icon;
+    }
     default:
       return QIcon();
   }
@@ -222,7 +307,6 @@ void FileViewTreeModel::SetRootPaths(const QStringList &paths) {
 
     FileViewTreeItem *virtual_root = new FileViewTreeItem(FileViewTreeItem::Type::VirtualRoot, root_);
     virtual_root->file_path = info.absoluteFilePath();
-    virtual_root->file_info = info;
     virtual_root->display_text = info.absoluteFilePath();
     virtual_root->lazy_loaded = false;
   }
@@ -235,6 +319,8 @@ void FileViewTreeModel::SetNameFilters(const QStringList &filters) {
 
 void FileViewTreeModel::Reset() {
 
+  CancelListings();
+
   beginResetModel();
 
   // Clear children without notifications since we're in a reset
@@ -244,3 +330,14 @@ void FileViewTreeModel::Reset() {
   endResetModel();
 
 }
+
+void FileViewTreeModel::CancelListings() {
+
+  for (DirectoryWatcher *watcher : std::as_const(listings_)) {
+    QObject::disconnect(watcher, nullptr, this, nullptr);
+    watcher->cancel();
+    watcher->deleteLater();
+  }
+  listings_.clear();
+
+}
@@ -24,6 +24,10 @@
 
 #include <QObject>
 #include <QVariant>
+#include <QList>
+#include <QMap>
+#include <QHash>
+#include <QString>
 #include <QStringList>
 #include <QIcon>
 
@@ -32,6 +36,8 @@
 
 class QFileIconProvider;
 class QMimeData;
+template<typename T> class QPromise;
+template<typename T> class QFutureWatcher;
 
 class FileViewTreeModel : public SimpleTreeModel<FileViewTreeItem> {
   Q_OBJECT
@@ -60,13 +66,31 @@ class FileViewTreeModel : public SimpleTreeModel<FileViewTreeItem> {
   void SetNameFilters(const QStringList &filters);
 
  private:
+  struct DirectoryEntry {
+    QString file_name;
+    bool is_dir;
+  };
+  using DirectoryEntries = QList<DirectoryEntry>;
+  using DirectoryWatcher = QFutureWatcher<DirectoryEntries>;
+
   void Reset();
+  void CancelListings();
   void LazyLoad(FileViewTreeItem *item);
+  static void ListDirectory(QPromise<DirectoryEntries> &promise, const QString &path, const QStringList &name_filters);
+  void AddEntries(FileViewTreeItem *item, const DirectoryEntries &entries);
+  void ListingFinished(FileViewTreeItem *item);
+  void SortChildren(FileViewTreeItem *item);
   QIcon GetIcon(const FileViewTreeItem *item) const;
 
  private:
   QFileIconProvider *icon_provider_;
   QStringList name_filters_;
+
+  // Directories being listed on a worker thread, the entries are added in chunks as they arrive.
+  QMap<FileViewTreeItem*, DirectoryWatcher*> listings_;
+
+  // File icons by suffix, looked up when an item is first shown.
+  mutable QHash<QString, QIcon> file_icons_;
 };
 
 #endif  // FILEVIEWTREEMODEL_H
@@ -515,7 +515,7 @@ FilterTree *FilterParser::createSearchTermTreeNode(const QString &column, const
     return new FilterTreeColumnTerm(filter_column, cmp);
   }
 
-  return new FilterTreeTerm(new FilterParserTextContainsComparator(value));
+  return new FilterTreeTerm(new FilterParserTextContainsComparator(value), value);
 
 }
 
@@ -21,12 +21,15 @@
 #define FILTERPARSERSEARCHTERMCOMPARATOR_H
 
 #include <QVariant>
+#include <QString>
 
 class FilterParserSearchTermComparator {
  public:
   explicit FilterParserSearchTermComparator();
   virtual ~FilterParserSearchTermComparator();
   virtual bool Matches(const QVariant &value) const = 0;
+  // Text comparators override this to match strings without wrapping them in a QVariant.
+  virtual bool MatchesText(const QString &value) const { return Matches(QVariant(value)); }
 
  private:
   Q_DISABLE_COPY(FilterParserSearchTermComparator)
@@ -24,3 +24,7 @@ FilterParserTextContainsComparator::FilterParserTextContainsComparator(const QSt
 bool FilterParserTextContainsComparator::Matches(const QVariant &value) const {
   return value.metaType().id() == QMetaType::QString && value.toString().contains(search_term_, Qt::CaseInsensitive);
 }
+
+bool FilterParserTextContainsComparator::MatchesText(const QString &value) const {
+  return value.contains(search_term_, Qt::CaseInsensitive);
+}
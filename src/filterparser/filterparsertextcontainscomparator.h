@@ -21,6 +21,7 @@
 #define FILTERPARSERTEXTCONTAINSCOMPARATOR_H
 
 #include <QVariant>
+#include <QString>
 
 #include "filterparsersearchtermcomparator.h"
 
@@ -28,6 +29,7 @@ class FilterParserTextContainsComparator : public FilterParserSearchTermComparat
  public:
   explicit FilterParserTextContainsComparator(const QString &search_term);
   bool Matches(const QVariant &value) const override;
+  bool MatchesText(const QString &value) const override;
 
  private:
   QString search_term_;
@@ -24,3 +24,7 @@ FilterParserTextEqComparator::FilterParserTextEqComparator(const QString &search
 bool FilterParserTextEqComparator::Matches(const QVariant &value) const {
   return search_term_.compare(value.toString(), Qt::CaseInsensitive) == 0;
 }
+
+bool FilterParserTextEqComparator::MatchesText(const QString &value) const {
+  return search_term_.compare(value, Qt::CaseInsensitive) == 0;
+}
@@ -24,3 +24,7 @@ FilterParserTextNeComparator::FilterParserTextNeComparator(const QString &search
 bool FilterParserTextNeComparator::Matches(const QVariant &value) const {
   return search_term_.compare(value.toString(), Qt::CaseInsensitive) != 0;
 }
+
+bool FilterParserTextNeComparator::MatchesText(const QString &value) const {
+  return search_term_.compare(value, Qt::CaseInsensitive) != 0;
+}
@@ -22,6 +22,7 @@
 
 #include <QVariant>
 #include <QString>
+#include <QString>
 
 #include "filterparsersearchtermcomparator.h"
 
@@ -29,6 +30,7 @@ class FilterParserTextNeComparator : public FilterParserSearchTermComparator {
  public:
   explicit FilterParserTextNeComparator(const QString &search_term);
   bool Matches(const QVariant &value) const override;
+  bool MatchesText(const QString &value) const override;
 
  private:
   QString search_term_;
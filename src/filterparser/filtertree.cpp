@@ -30,6 +30,66 @@ FilterTree::~FilterTree() = default;
 
 QVariant FilterTree::DataFromColumn(const FilterColumn filter_column, const Song &song) {
 
+  if (IsTextColumn(filter_column)) {
+    return TextFromColumn(filter_column, song);
+  }
+
+  switch (filter_column) {
+    case FilterColumn::Track:
+      return song.track();
+    case FilterColumn::Year:
+      return song.year();
+    case FilterColumn::Length:
+      return song.length_nanosec();
+    case FilterColumn::Samplerate:
+      return song.samplerate();
+    case FilterColumn::Bitdepth:
+      return song.bitdepth();
+    case FilterColumn::Bitrate:
+      return song.bitrate();
+    case FilterColumn::Rating:
+      return song.rating();
+    case FilterColumn::Playcount:
+      return song.playcount();
+    case FilterColumn::Skipcount:
+      return song.skipcount();
+    default:
+      break;
+  }
+
+  return QVariant();
+
+}
+
+bool FilterTree::IsTextColumn(const FilterColumn filter_column) {
+
+  switch (filter_column) {
+    case FilterColumn::AlbumArtist:
+    case FilterColumn::AlbumArtistSort:
+    case FilterColumn::Artist:
+    case FilterColumn::ArtistSort:
+    case FilterColumn::Album:
+    case FilterColumn::AlbumSort:
+    case FilterColumn::Title:
+    case FilterColumn::TitleSort:
+    case FilterColumn::Composer:
+    case FilterColumn::ComposerSort:
+    case FilterColumn::Performer:
+    case FilterColumn::PerformerSort:
+    case FilterColumn::Grouping:
+    case FilterColumn::Genre:
+    case FilterColumn::Comment:
+    case FilterColumn::Filename:
+    case FilterColumn::URL:
+      return true;
+    default:
+      return false;
+  }
+
+}
+
+QString FilterTree::TextFromColumn(const FilterColumn filter_column, const Song &song) {
+
   switch (filter_column) {
     case FilterColumn::AlbumArtist:
       return song.effective_albumartist();
@@ -61,32 +121,14 @@ QVariant FilterTree::DataFromColumn(const FilterColumn filter_column, const Song
       return song.genre();
     case FilterColumn::Comment:
       return song.comment();
-    case FilterColumn::Track:
-      return song.track();
-    case FilterColumn::Year:
-      return song.year();
-    case FilterColumn::Length:
-      return song.length_nanosec();
-    case FilterColumn::Samplerate:
-      return song.samplerate();
-    case FilterColumn::Bitdepth:
-      return song.bitdepth();
-    case FilterColumn::Bitrate:
-      return song.bitrate();
-    case FilterColumn::Rating:
-      return song.rating();
-    case FilterColumn::Playcount:
-      return song.playcount();
-    case FilterColumn::Skipcount:
-      return song.skipcount();
     case FilterColumn::Filename:
       return song.basefilename();
     case FilterColumn::URL:
       return song.effective_url().toString();
-    case FilterColumn::Unknown:
+    default:
       break;
   }
 
-  return QVariant();
+  return QString();
 
 }
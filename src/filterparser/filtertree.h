@@ -43,8 +43,13 @@ class FilterTree {
 
   virtual bool accept(const Song &song) const = 0;
 
+  // Returns an equivalent FTS5 MATCH expression for the trigram songs index, or an empty string if the filter can't be expressed as one.
+  virtual QString FtsQuery() const { return QString(); }
+
  protected:
   static QVariant DataFromColumn(const FilterColumn filter_column, const Song &metadata);
+  static bool IsTextColumn(const FilterColumn filter_column);
+  static QString TextFromColumn(const FilterColumn filter_column, const Song &metadata);
 
  private:
   Q_DISABLE_COPY(FilterTree)
@@ -19,8 +19,13 @@
  *
  */
 
+#include <QString>
+#include <QStringList>
+
 #include "filtertreeand.h"
 
+using namespace Qt::Literals::StringLiterals;
+
 FilterTreeAnd::FilterTreeAnd() = default;
 
 FilterTreeAnd::~FilterTreeAnd() {
@@ -30,5 +35,19 @@ FilterTreeAnd::~FilterTreeAnd() {
 void FilterTreeAnd::add(FilterTree *child) { children_.append(child); }
 
 bool FilterTreeAnd::accept(const Song &song) const {
-  return !std::any_of(children_.begin(), children_.end(), [song](FilterTree *child) { return !child->accept(song); });
+  return !std::any_of(children_.begin(), children_.end(), [&song](FilterTree *child) { return !child->accept(song); });
+}
+
+QString FilterTreeAnd::FtsQuery() const {
+
+  QStringList queries;
+  for (FilterTree *child : children_) {
+    if (child->type() == FilterType::Nop) continue;
+    const QString query = child->FtsQuery();
+    if (query.isEmpty()) return QString();
+    queries << u'(' + query + u')';
+  }
+
+  return queries.join(" AND "_L1);
+
 }
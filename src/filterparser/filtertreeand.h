@@ -36,6 +36,7 @@ class FilterTreeAnd : public FilterTree {
   FilterType type() const override { return FilterType::And; }
   virtual void add(FilterTree *child);
   bool accept(const Song &song) const override;
+  QString FtsQuery() const override;
 
  private:
   QList<FilterTree*> children_;
@@ -24,8 +24,14 @@
 #include "filtertreecolumnterm.h"
 #include "filterparsersearchtermcomparator.h"
 
-FilterTreeColumnTerm::FilterTreeColumnTerm(const FilterColumn filter_column, FilterParserSearchTermComparator *comparator) : filter_column_(filter_column), cmp_(comparator) {}
+FilterTreeColumnTerm::FilterTreeColumnTerm(const FilterColumn filter_column, FilterParserSearchTermComparator *comparator) : filter_column_(filter_column), text_column_(IsTextColumn(filter_column)), cmp_(comparator) {}
 
 bool FilterTreeColumnTerm::accept(const Song &song) const {
+
+  if (text_column_) {
+    return cmp_->MatchesText(TextFromColumn(filter_column_, song));
+  }
+
   return cmp_->Matches(DataFromColumn(filter_column_, song));
+
 }
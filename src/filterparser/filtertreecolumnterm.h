@@ -40,6 +40,7 @@ class FilterTreeColumnTerm : public FilterTree {
 
  private:
   const FilterColumn filter_column_;
+  const bool text_column_;
   QScopedPointer<FilterParserSearchTermComparator> cmp_;
 
   Q_DISABLE_COPY(FilterTreeColumnTerm)
@@ -20,9 +20,12 @@
  */
 
 #include <QString>
+#include <QStringList>
 
 #include "filtertreeor.h"
 
+using namespace Qt::Literals::StringLiterals;
+
 FilterTreeOr::FilterTreeOr() = default;
 
 FilterTreeOr::~FilterTreeOr() {
@@ -34,5 +37,18 @@ void FilterTreeOr::add(FilterTree *child) {
 }
 
 bool FilterTreeOr::accept(const Song &song) const {
-  return std::any_of(children_.begin(), children_.end(), [song](FilterTree *child) { return child->accept(song); });
+  return std::any_of(children_.begin(), children_.end(), [&song](FilterTree *child) { return child->accept(song); });
+}
+
+QString FilterTreeOr::FtsQuery() const {
+
+  QStringList queries;
+  for (FilterTree *child : children_) {
+    const QString query = child->FtsQuery();
+    if (query.isEmpty()) return QString();
+    queries << u'(' + query + u')';
+  }
+
+  return queries.join(" OR "_L1);
+
 }
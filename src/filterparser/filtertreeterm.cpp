@@ -19,29 +19,47 @@
  *
  */
 
+#include <QString>
+
 #include "filtertreeterm.h"
 #include "filterparsersearchtermcomparator.h"
 
-FilterTreeTerm::FilterTreeTerm(FilterParserSearchTermComparator *comparator) : cmp_(comparator) {}
+using namespace Qt::Literals::StringLiterals;
+
+namespace {
+// The trigram tokenizer can only match substrings of at least three characters.
+constexpr int kFtsMinimumTermLength = 3;
+}  // namespace
+
+FilterTreeTerm::FilterTreeTerm(FilterParserSearchTermComparator *comparator, const QString &search_term) : cmp_(comparator), search_term_(search_term) {}
 
 bool FilterTreeTerm::accept(const Song &song) const {
 
-  if (cmp_->Matches(song.PrettyTitle())) return true;
-  if (cmp_->Matches(song.titlesort())) return true;
-  if (cmp_->Matches(song.album())) return true;
-  if (cmp_->Matches(song.albumsort())) return true;
-  if (cmp_->Matches(song.artist())) return true;
-  if (cmp_->Matches(song.artistsort())) return true;
-  if (cmp_->Matches(song.albumartist())) return true;
-  if (cmp_->Matches(song.albumartistsort())) return true;
-  if (cmp_->Matches(song.composer())) return true;
-  if (cmp_->Matches(song.composersort())) return true;
-  if (cmp_->Matches(song.performer())) return true;
-  if (cmp_->Matches(song.performersort())) return true;
-  if (cmp_->Matches(song.grouping())) return true;
-  if (cmp_->Matches(song.genre())) return true;
-  if (cmp_->Matches(song.comment())) return true;
+  if (song.title().isEmpty() ? cmp_->MatchesText(song.PrettyTitle()) : cmp_->MatchesText(song.title())) return true;
+  if (cmp_->MatchesText(song.titlesort())) return true;
+  if (cmp_->MatchesText(song.album())) return true;
+  if (cmp_->MatchesText(song.albumsort())) return true;
+  if (cmp_->MatchesText(song.artist())) return true;
+  if (cmp_->MatchesText(song.artistsort())) return true;
+  if (cmp_->MatchesText(song.albumartist())) return true;
+  if (cmp_->MatchesText(song.albumartistsort())) return true;
+  if (cmp_->MatchesText(song.composer())) return true;
+  if (cmp_->MatchesText(song.composersort())) return true;
+  if (cmp_->MatchesText(song.performer())) return true;
+  if (cmp_->MatchesText(song.performersort())) return true;
+  if (cmp_->MatchesText(song.grouping())) return true;
+  if (cmp_->MatchesText(song.genre())) return true;
+  if (cmp_->MatchesText(song.comment())) return true;
 
   return false;
 
 }
+
+QString FilterTreeTerm::FtsQuery() const {
+
+  if (search_term_.length() < kFtsMinimumTermLength) return QString();
+
+  QString search_term = search_term_;
+  return u'"' + search_term.replace(u'"', "\"\""_L1) + u'"';
+
+}
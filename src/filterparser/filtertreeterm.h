@@ -23,6 +23,7 @@
 #define FILTERTREETERM_H
 
 #include <QScopedPointer>
+#include <QString>
 
 #include "filtertree.h"
 
@@ -33,13 +34,15 @@ class FilterParserSearchTermComparator;
 // Filter that applies a SearchTermComparator to all fields
 class FilterTreeTerm : public FilterTree {
  public:
-  explicit FilterTreeTerm(FilterParserSearchTermComparator *comparator);
+  explicit FilterTreeTerm(FilterParserSearchTermComparator *comparator, const QString &search_term = QString());
 
   FilterType type() const override { return FilterType::Term; }
   bool accept(const Song &song) const override;
+  QString FtsQuery() const override;
 
  private:
   QScopedPointer<FilterParserSearchTermComparator> cmp_;
+  QString search_term_;
 
   Q_DISABLE_COPY(FilterTreeTerm)
 };
@@ -32,6 +32,7 @@
 #include <QKeyCombination>
 
 #include "core/logging.h"
+#include "core/transportcontrol.h"
 
 #include "globalshortcutsbackend-kglobalaccel.h"
 
@@ -48,7 +49,8 @@ constexpr char kKGlobalAccelPath[] = "/kglobalaccel";
 GlobalShortcutsBackendKGlobalAccel::GlobalShortcutsBackendKGlobalAccel(GlobalShortcutsManager *manager, QObject *parent)
     : GlobalShortcutsBackend(manager, GlobalShortcutsBackend::Type::KGlobalAccel, parent),
       interface_(nullptr),
-      component_(nullptr) {}
+      component_(nullptr),
+      transport_control_connected_(false) {}
 
 bool GlobalShortcutsBackendKGlobalAccel::IsKGlobalAccelAvailable() {
 
@@ -122,6 +124,11 @@ void GlobalShortcutsBackendKGlobalAccel::RegisterFinished(QDBusPendingCallWatche
   QObject::connect(component_, &org::kde::kglobalaccel::Component::globalShortcutPressed, this, &GlobalShortcutsBackendKGlobalAccel::GlobalShortcutPressed, Qt::UniqueConnection);
   QObject::connect(component_, &org::kde::kglobalaccel::Component::globalShortcutRepeated, this, &GlobalShortcutsBackendKGlobalAccel::GlobalShortcutPressed, Qt::UniqueConnection);
 
+  // Play and pause are received in the thread of the transport control, so they still work while the main thread is busy.
+  if (manager_->transport_control()) {
+    transport_control_connected_ = manager_->transport_control()->ConnectKGlobalAccelComponent(QLatin1String(kKGlobalAccelService), reply.value().path());
+  }
+
   qLog(Debug) << "Registered.";
 
 }
@@ -143,6 +150,11 @@ void GlobalShortcutsBackendKGlobalAccel::DoUnregister() {
 
   if (component_) QObject::disconnect(component_, nullptr, this, nullptr);
 
+  if (transport_control_connected_) {
+    manager_->transport_control()->DisconnectKGlobalAccelComponent();
+    transport_control_connected_ = false;
+  }
+
   qLog(Debug) << "Unregistered";
 
 }
@@ -214,6 +226,8 @@ void GlobalShortcutsBackendKGlobalAccel::GlobalShortcutPressed(const QString &co
 
   Q_UNUSED(timestamp)
 
+  if (transport_control_connected_ && TransportControl::IsTransportShortcut(shortcut_unique)) return;
+
   if (QCoreApplication::applicationName() == component_unique && actions_.contains(shortcut_unique)) {
     const QList<QAction*> actions = actions_.values(shortcut_unique);
     for (QAction *action : actions) {
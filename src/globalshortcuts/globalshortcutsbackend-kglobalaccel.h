@@ -65,6 +65,7 @@ class GlobalShortcutsBackendKGlobalAccel : public GlobalShortcutsBackend {
   OrgKdeKGlobalAccelInterface *interface_;
   OrgKdeKglobalaccelComponentInterface *component_;
   QMultiHash<QString, QAction*> actions_;
+  bool transport_control_connected_;
 };
 
 #endif  // GLOBALSHORTCUTSBACKEND_KDE_H
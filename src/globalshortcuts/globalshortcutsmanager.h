@@ -33,12 +33,14 @@
 #include <QString>
 #include <QKeySequence>
 
+#include "includes/shared_ptr.h"
 #include "globalshortcutsbackend.h"
 
 class QShortcut;
 class QAction;
 
 class Settings;
+class TransportControl;
 
 class GlobalShortcutsManager : public QWidget {
   Q_OBJECT
@@ -55,6 +57,10 @@ class GlobalShortcutsManager : public QWidget {
 
   QMap<QString, Shortcut> shortcuts() const { return shortcuts_; }
 
+  // Backends that can receive shortcuts outside the main thread pass the play and pause shortcuts to this instead.
+  void SetTransportControl(SharedPtr<TransportControl> transport_control) { transport_control_ = transport_control; }
+  SharedPtr<TransportControl> transport_control() const { return transport_control_; }
+
 #if defined(Q_OS_UNIX) && !defined(Q_OS_MACOS) && defined(HAVE_DBUS)
   static bool IsKGlobalAccelAvailable();
 #endif
@@ -105,6 +111,7 @@ class GlobalShortcutsManager : public QWidget {
   QList<GlobalShortcutsBackend*> backends_;
   QList<GlobalShortcutsBackend::Type> backends_enabled_;
   QMap<QString, Shortcut> shortcuts_;
+  SharedPtr<TransportControl> transport_control_;
 };
 
 #endif  // GLOBALSHORTCUTSMANAGER_H
@@ -20,8 +20,13 @@
 
 #include <functional>
 #include <type_traits>
+#include <typeinfo>
+
+#include <QObject>
+#include <QString>
 
 #include "core/logging.h"
+#include "core/startuptracer.h"
 
 #include "shared_ptr.h"
 
@@ -63,8 +68,21 @@ class Lazy {
  private:
   void CheckInitialized() const {
     if (!ptr_) {
+      const qint64 start_msec = StartupTracer::ElapsedMsec();
       ptr_ = SharedPtr<T>(init_(), [](T *obj) { qLog(Debug) << obj << "deleted"; delete obj; });
       qLog(Debug) << &*ptr_ << "created";
+      if (!StartupTracer::IsFinished()) {
+        StartupTracer::AddEvent(QString::fromLatin1(ClassName()), start_msec, StartupTracer::ElapsedMsec() - start_msec);
+      }
+    }
+  }
+
+  static const char *ClassName() {
+    if constexpr (std::is_base_of_v<QObject, T>) {
+      return T::staticMetaObject.className();
+    }
+    else {
+      return typeid(T).name();
     }
   }
 
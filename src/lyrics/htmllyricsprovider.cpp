@@ -58,15 +58,39 @@ void HtmlLyricsProvider::StartSearch(const int id, const LyricsSearchRequest &re
   const QUrl url = Url(request);
   QNetworkReply *reply = CreateGetRequest(url, true);
   QObject::connect(reply, &QNetworkReply::finished, this, [this, reply, id, request]() { HandleLyricsReply(reply, id, request); });
+  search_replies_.insert(id, reply);
 
   qLog(Debug) << name_ << "Sending request for" << url;
 
 }
 
+void HtmlLyricsProvider::CancelSearchAsync(const int id) {
+
+  QMetaObject::invokeMethod(this, "CancelSearch", Qt::QueuedConnection, Q_ARG(int, id));
+
+}
+
+void HtmlLyricsProvider::CancelSearch(const int id) {
+
+  // Another provider already found the lyrics, don't download and parse the page.
+  QNetworkReply *reply = search_replies_.take(id);
+  if (!reply || !replies_.contains(reply)) return;
+
+  replies_.removeAll(reply);
+  QObject::disconnect(reply, nullptr, this, nullptr);
+  reply->abort();
+  reply->deleteLater();
+
+  qLog(Debug) << name_ << "Cancelled lyrics request" << id;
+
+}
+
 void HtmlLyricsProvider::HandleLyricsReply(QNetworkReply *reply, const int id, const LyricsSearchRequest &request) {
 
   Q_ASSERT(QThread::currentThread() != qApp->thread());
 
+  search_replies_.remove(id);
+
   if (!replies_.contains(reply)) return;
   replies_.removeAll(reply);
   QObject::disconnect(reply, nullptr, this, nullptr);
@@ -23,6 +23,7 @@
 #include "config.h"
 
 #include <QVariant>
+#include <QMap>
 #include <QString>
 #include <QUrl>
 
@@ -40,6 +41,7 @@ class HtmlLyricsProvider : public LyricsProvider {
   explicit HtmlLyricsProvider(const QString &name, const bool enabled, const QString &start_tag, const QString &end_tag, const QString &lyrics_start, const bool multiple, const SharedPtr<NetworkAccessManager> network, QObject *parent);
 
   virtual bool StartSearchAsync(const int id, const LyricsSearchRequest &request) override;
+  virtual void CancelSearchAsync(const int id) override;
 
   static QString ParseLyricsFromHTML(const QString &content, const QRegularExpression &start_tag, const QRegularExpression &end_tag, const QRegularExpression &lyrics_start, const bool multiple, const QList<QRegularExpression> &regex_removes = {});
 
@@ -50,11 +52,17 @@ class HtmlLyricsProvider : public LyricsProvider {
   virtual void StartSearch(const int id, const LyricsSearchRequest &request) override;
   virtual void HandleLyricsReply(QNetworkReply *reply, const int id, const LyricsSearchRequest &request);
 
+ private Q_SLOTS:
+  void CancelSearch(const int id);
+
  protected:
   const QString start_tag_;
   const QString end_tag_;
   const QString lyrics_start_;
   const bool multiple_;
+
+ private:
+  QMap<int, QNetworkReply*> search_replies_;
 };
 
 #endif  // HTMLLYRICSPROVIDER_H
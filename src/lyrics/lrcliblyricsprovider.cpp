@@ -150,6 +150,7 @@ void LrcLibLyricsProvider::HandleSearchReply(QNetworkReply *reply, const int id,
   result.album = json_object["albumName"_L1].toString();
   result.title = json_object["trackName"_L1].toString();
   result.lyrics = json_object["plainLyrics"_L1].toString();
+  result.synced = !json_object["syncedLyrics"_L1].toString().isEmpty();
   results << result;
 
 }
@@ -102,6 +102,7 @@ void LyricsFetcherSearch::ProviderSearchFinished(const int id, const LyricsSearc
 
   LyricsSearchResults results_copy(results);
   float higest_score = 0.0;
+  bool synced_match = false;
   for (int i = 0; i < results_copy.count(); ++i) {
     results_copy[i].provider = provider->name();
     results_copy[i].score = 0.0;
@@ -119,16 +120,24 @@ void LyricsFetcherSearch::ProviderSearchFinished(const int id, const LyricsSearc
     }
     if (results_copy[i].lyrics.length() > kGoodLyricsLength) results_copy[i].score += 1.0;
     if (results_copy[i].score > higest_score) higest_score = results_copy[i].score;
+    if (results_copy[i].synced && results_copy[i].artist.compare(request_.artist, Qt::CaseInsensitive) == 0 && results_copy[i].title.compare(request_.title, Qt::CaseInsensitive) == 0) {
+      synced_match = true;
+    }
   }
 
   results_.append(results_copy);
   std::stable_sort(results_.begin(), results_.end(), LyricsSearchResultCompareScore);
 
+  // All providers are searched in parallel, stop at the first good result and cancel the rest.
   if (!pending_requests_.isEmpty()) {
     if (!results_.isEmpty() && higest_score >= kHighScore) {  // Highest score, no need to wait for other providers.
       qLog(Debug) << "Got lyrics with high score from" << results_.last().provider << "for" << request_.artist << request_.title << "score" << results_.last().score << "finishing search.";
       FinishSearch();
     }
+    else if (synced_match) {
+      qLog(Debug) << "Got synced lyrics from" << provider->name() << "for" << request_.artist << request_.title << "finishing search.";
+      FinishSearch();
+    }
     return;
   }
 
@@ -30,6 +30,7 @@
 #include <QRegularExpression>
 
 #include "includes/shared_ptr.h"
+#include "constants/timeconstants.h"
 #include "core/networkaccessmanager.h"
 #include "core/httpbaserequest.h"
 #include "lyricssearchrequest.h"
@@ -53,6 +54,8 @@ class LyricsProvider : public HttpBaseRequest {
   virtual bool authenticated() const override { return false; }
   virtual bool use_authorization_header() const override { return authentication_required_; }
   virtual QByteArray authorization_header() const override { return QByteArray(); }
+  virtual QNetworkRequest::Priority request_priority() const override { return QNetworkRequest::LowPriority; }
+  virtual qint64 cache_time() const override { return 30 * kSecsPerDay; }
 
   virtual bool StartSearchAsync(const int id, const LyricsSearchRequest &request);
   virtual void CancelSearchAsync(const int id) { Q_UNUSED(id); }
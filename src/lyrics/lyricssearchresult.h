@@ -26,13 +26,15 @@
 
 class LyricsSearchResult {
  public:
-  explicit LyricsSearchResult(const QString &_lyrics = QString()) : lyrics(_lyrics), score(0.0) {}
+  explicit LyricsSearchResult(const QString &_lyrics = QString()) : lyrics(_lyrics), score(0.0), synced(false) {}
   QString provider;
   QString artist;
   QString album;
   QString title;
   QString lyrics;
   float score;
+  // The provider also has time synced lyrics for the song.
+  bool synced;
 };
 using LyricsSearchResults = QList<LyricsSearchResult>;
 
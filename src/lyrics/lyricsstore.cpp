@@ -0,0 +1,182 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "config.h"
+
+#include <QtGlobal>
+#include <QObject>
+#include <QThread>
+#include <QMutexLocker>
+#include <QDateTime>
+#include <QString>
+#include <QStringList>
+#include <QRegularExpression>
+#include <QSqlDatabase>
+
+#include "includes/shared_ptr.h"
+#include "core/logging.h"
+#include "core/database.h"
+#include "core/sqlquery.h"
+#include "core/scopedtransaction.h"
+#include "core/song.h"
+#include "lyricsstore.h"
+
+using namespace Qt::Literals::StringLiterals;
+
+LyricsStore::LyricsStore(const SharedPtr<Database> database, QObject *parent)
+    : QObject(parent),
+      database_(database),
+      original_thread_(thread()) {}
+
+void LyricsStore::ExitAsync() {
+  QMetaObject::invokeMethod(this, &LyricsStore::Exit, Qt::QueuedConnection);
+}
+
+void LyricsStore::Exit() {
+
+  Q_ASSERT(QThread::currentThread() == thread());
+
+  moveToThread(original_thread_);
+  Q_EMIT ExitFinished();
+
+}
+
+QStringList LyricsStore::Keys(const Song &song) {
+
+  QStringList keys;
+  if (!song.musicbrainz_recording_id().isEmpty()) {
+    keys << "recording:"_L1 + song.musicbrainz_recording_id();
+  }
+  if (!song.artist().isEmpty() && !song.title().isEmpty()) {
+    keys << "track:"_L1 + song.artist().toLower() + QLatin1Char('\t') + song.title().toLower();
+  }
+
+  return keys;
+
+}
+
+void LyricsStore::LoadLyricsAsync(const quint64 id, const Song &song) {
+  QMetaObject::invokeMethod(this, "LoadLyrics", Qt::QueuedConnection, Q_ARG(quint64, id), Q_ARG(Song, song));
+}
+
+void LyricsStore::LoadLyrics(const quint64 id, const Song &song) {
+
+  const QStringList keys = Keys(song);
+  if (keys.isEmpty()) {
+    Q_EMIT LyricsLoaded(id, QString(), QString());
+    return;
+  }
+
+  QMutexLocker l(database_->Mutex());
+  QSqlDatabase db(database_->Connect());
+
+  // Keys are in order of preference, use the first one found.
+  for (const QString &key : keys) {
+    SqlQuery q(db);
+    q.prepare(u"SELECT provider, lyrics FROM lyrics WHERE key = :key"_s);
+    q.BindValue(u":key"_s, key);
+    if (!q.Exec()) {
+      database_->ReportErrors(q);
+      break;
+    }
+    if (q.next()) {
+      Q_EMIT LyricsLoaded(id, q.value(0).toString(), q.value(1).toString());
+      return;
+    }
+  }
+
+  Q_EMIT LyricsLoaded(id, QString(), QString());
+
+}
+
+void LyricsStore::SaveLyricsAsync(const Song &song, const QString &provider, const QString &lyrics) {
+  QMetaObject::invokeMethod(this, "SaveLyrics", Qt::QueuedConnection, Q_ARG(Song, song), Q_ARG(QString, provider), Q_ARG(QString, lyrics));
+}
+
+void LyricsStore::SaveLyrics(const Song &song, const QString &provider, const QString &lyrics) {
+
+  if (lyrics.isEmpty()) return;
+
+  QMutexLocker l(database_->Mutex());
+  QSqlDatabase db(database_->Connect());
+
+  WriteLyrics(db, song, provider, lyrics);
+
+}
+
+void LyricsStore::SaveLrcFilesAsync(const SongList &songs, const QStringList &lrc_data) {
+  QMetaObject::invokeMethod(this, "SaveLrcFiles", Qt::QueuedConnection, Q_ARG(SongList, songs), Q_ARG(QStringList, lrc_data));
+}
+
+void LyricsStore::SaveLrcFiles(const SongList &songs, const QStringList &lrc_data) {
+
+  if (songs.isEmpty() || songs.count() != lrc_data.count()) return;
+
+  QMutexLocker l(database_->Mutex());
+  QSqlDatabase db(database_->Connect());
+
+  ScopedTransaction transaction(&db);
+  for (qsizetype i = 0; i < songs.count(); ++i) {
+    const QString lyrics = LyricsFromLrc(lrc_data[i]);
+    if (lyrics.isEmpty()) continue;
+    if (!WriteLyrics(db, songs[i], u"LRC file"_s, lyrics)) return;
+  }
+  transaction.Commit();
+
+}
+
+bool LyricsStore::WriteLyrics(QSqlDatabase &db, const Song &song, const QString &provider, const QString &lyrics) {
+
+  const qint64 time = QDateTime::currentSecsSinceEpoch();
+  const QStringList keys = Keys(song);
+  for (const QString &key : keys) {
+    SqlQuery q(db);
+    q.prepare(u"INSERT OR REPLACE INTO lyrics (key, provider, lyrics, time) VALUES (:key, :provider, :lyrics, :time)"_s);
+    q.BindValue(u":key"_s, key);
+    q.BindValue(u":provider"_s, provider);
+    q.BindValue(u":lyrics"_s, lyrics);
+    q.BindValue(u":time"_s, time);
+    if (!q.Exec()) {
+      database_->ReportErrors(q);
+      return false;
+    }
+  }
+
+  return true;
+
+}
+
+QString LyricsStore::LyricsFromLrc(const QString &lrc_data) {
+
+  // Drop the time tags, and the lines with only ID tags such as [ar:...] and [ti:...].
+  static const QRegularExpression regex_time_tag(u"^\\s*(\\[\\d+:\\d+(?:[.:]\\d+)?\\]\\s*)+"_s);
+  static const QRegularExpression regex_id_tag(u"^\\s*\\[[a-zA-Z#]+:[^\\]]*\\]\\s*$"_s);
+
+  QStringList lines;
+  const QStringList lrc_lines = lrc_data.split(u'\n');
+  for (QString line : lrc_lines) {
+    line.remove(u'\r');
+    if (regex_id_tag.match(line).hasMatch()) continue;
+    line.remove(regex_time_tag);
+    lines << line;
+  }
+
+  return lines.join(u'\n').trimmed();
+
+}
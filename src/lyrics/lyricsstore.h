@@ -0,0 +1,73 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef LYRICSSTORE_H
+#define LYRICSSTORE_H
+
+#include "config.h"
+
+#include <QtGlobal>
+#include <QObject>
+#include <QString>
+#include <QStringList>
+
+#include "includes/shared_ptr.h"
+#include "core/song.h"
+
+class QThread;
+class QSqlDatabase;
+class Database;
+
+// Keeps lyrics in the database, so they can be shown without searching the providers again.
+// Lyrics are stored by the MusicBrainz recording ID when the song has one, and by artist and title.
+class LyricsStore : public QObject {
+  Q_OBJECT
+
+ public:
+  explicit LyricsStore(const SharedPtr<Database> database, QObject *parent = nullptr);
+
+  void ExitAsync();
+
+  void LoadLyricsAsync(const quint64 id, const Song &song);
+  void SaveLyricsAsync(const Song &song, const QString &provider, const QString &lyrics);
+  // Stores the contents of sidecar LRC files, lrc_data[i] belongs to songs[i].
+  void SaveLrcFilesAsync(const SongList &songs, const QStringList &lrc_data);
+
+  static QStringList Keys(const Song &song);
+  static QString LyricsFromLrc(const QString &lrc_data);
+
+ Q_SIGNALS:
+  void LyricsLoaded(const quint64 id, const QString &provider, const QString &lyrics);
+  void ExitFinished();
+
+ private Q_SLOTS:
+  void LoadLyrics(const quint64 id, const Song &song);
+  void SaveLyrics(const Song &song, const QString &provider, const QString &lyrics);
+  void SaveLrcFiles(const SongList &songs, const QStringList &lrc_data);
+  void Exit();
+
+ private:
+  bool WriteLyrics(QSqlDatabase &db, const Song &song, const QString &provider, const QString &lyrics);
+
+ private:
+  const SharedPtr<Database> database_;
+  QThread *original_thread_;
+};
+
+#endif  // LYRICSSTORE_H
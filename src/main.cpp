@@ -71,6 +71,9 @@
 #include "core/logging.h"
 #include "core/standardpaths.h"
 #include "core/settings.h"
+#include "core/settingsstore.h"
+#include "core/startuptracer.h"
+#include "core/tracing.h"
 
 #include "utilities/envutils.h"
 
@@ -105,6 +108,10 @@
 #include "core/metatypes.h"
 #include "core/mainwindow.h"
 
+#include "tagreader/tagreaderworker.h"
+
+#include "collection/collectionscanner.h"
+
 #ifdef Q_OS_MACOS
 #  include "systemtrayicon/macsystemtrayicon.h"
 #else
@@ -139,6 +146,9 @@ int main(int argc, char *argv[]) {
   mac::MacMain();
 #endif
 
+  // Start the startup timeline.
+  StartupTracer::ElapsedMsec();
+
   QCoreApplication::setApplicationName(u"Strawberry"_s);
   QCoreApplication::setOrganizationName(u"Strawberry"_s);
   QCoreApplication::setApplicationVersion(QStringLiteral(STRAWBERRY_VERSION_DISPLAY));
@@ -155,6 +165,23 @@ int main(int argc, char *argv[]) {
   logging::Init();
   g_log_set_default_handler(reinterpret_cast<GLogFunc>(&logging::GLog), nullptr);
 
+  // Strawberry runs itself as a tag reader worker process when reading tags out of process is enabled.
+  if (argc == 3 && qstrcmp(argv[1], TagReaderWorker::kCommandLineOption) == 0) {
+    QCoreApplication core_app(argc, argv);
+    return TagReaderWorker::Run(QString::fromLocal8Bit(argv[2]));
+  }
+
+  // Scanning the collection without a GUI, this writes to the same database, so it can't run while Strawberry is running.
+  if ((argc == 2 || argc == 3) && qstrcmp(argv[1], CollectionScanner::kCommandLineOption) == 0) {
+    QCoreApplication core_app(argc, argv);
+    KDSingleApplication single_app(QCoreApplication::applicationName().toLower(), KDSingleApplication::Option::IncludeUsernameInSocketName);
+    if (!single_app.isPrimaryInstance()) {
+      qLog(Error) << "Strawberry is running, the collection can only be scanned with" << CollectionScanner::kCommandLineOption << "while it's not.";
+      return 1;
+    }
+    return CollectionScanner::Run(argc == 3 && qstrcmp(argv[2], CollectionScanner::kFullScanArgument) == 0);
+  }
+
   CommandlineOptions options(argc, argv);
   {
     // Only start a core application now, so we can check if there's another instance without requiring an X server.
@@ -164,6 +191,7 @@ int main(int argc, char *argv[]) {
     // Parse commandline options - need to do this before starting the full QApplication, so it works without an X server
     if (!options.Parse()) return 1;
     logging::SetLevels(options.log_levels());
+    tracing::SetEnabled(!options.trace_file().isEmpty());
     if (!single_app.isPrimaryInstance()) {
       if (options.is_empty()) {
         qLog(Info) << "Strawberry is already running - activating existing window (1)";
@@ -218,7 +246,7 @@ int main(int argc, char *argv[]) {
   qLog(Debug) << "Looking for resources in" << QCoreApplication::libraryPaths();
 #endif
 
-  GstStartup::Initialize();
+  GstStartup::InitializeAsync();
 
   // Gnome on Ubuntu has menu icons disabled by default.  I think that's a bad idea, and makes some menus in Strawberry look confusing.
   QCoreApplication::setAttribute(Qt::AA_DontShowIconsInMenus, false);
@@ -337,6 +365,9 @@ int main(int argc, char *argv[]) {
 
 #endif  // HAVE_TRANSLATIONS
 
+  // Read the settings once in the main thread, after they have been migrated.
+  SettingsStore::Instance();
+
   Application app;
 
   // Network proxy
@@ -358,6 +389,7 @@ int main(int argc, char *argv[]) {
 #endif
 #ifdef HAVE_DISCORD_RPC
   DiscordRichPresence discord_rich_presence(app.player(), app.playlist_manager());
+  app.DeferUntilShown(u"DiscordRichPresence"_s, [&discord_rich_presence]() { discord_rich_presence.ReloadSettings(); });
 #endif
 
   // Window
@@ -386,6 +418,10 @@ int main(int argc, char *argv[]) {
 
   int ret = QCoreApplication::exec();
 
+  if (!options.trace_file().isEmpty()) {
+    tracing::WriteChromeTrace(options.trace_file());
+  }
+
 #ifdef __MINGW32__
   // Workaround crash on exit with win32 threads
   TerminateProcess(GetCurrentProcess(), 0);
@@ -23,6 +23,7 @@
 #include <cmath>
 
 #include <QList>
+#include <QVarLengthArray>
 #include <QByteArray>
 
 #include "moodbarbuilder.h"
@@ -33,6 +34,12 @@ namespace {
 
 constexpr int sBarkBands[] = { 100, 200, 300, 400, 510, 630, 770, 920, 1080, 1270, 1480, 1720, 2000, 2320, 2700, 3150, 3700, 4400, 5300, 6400, 7700, 9500, 12000, 15500 };
 constexpr int sBarkBandCount = arraysize(sBarkBands);
+constexpr int kChannels = 3;
+
+// The bark bands are divided into thirds for red, green and blue.
+constexpr int BarkBandChannel(const int barkband) {
+  return (barkband * kChannels) / sBarkBandCount;
+}
 
 }  // namespace
 
@@ -47,63 +54,82 @@ void MoodbarBuilder::Init(const int bands, const int rate_hz) {
   bands_ = bands;
   rate_hz_ = rate_hz;
 
-  barkband_table_.clear();
-  barkband_table_.reserve(bands + 1);
+  // Magnitudes map to bark bands in ascending order, so every bark band covers one contiguous range of the spectrum.
+  barkband_offsets_.clear();
+  barkband_offsets_.append(0);
 
   int barkband = 0;
   for (int i = 0; i < bands + 1; ++i) {
     if (barkband < sBarkBandCount - 1 && BandFrequency(i) >= sBarkBands[barkband]) {
       barkband++;
+      barkband_offsets_.append(i);
     }
+  }
+  while (barkband_offsets_.count() <= sBarkBandCount) {
+    barkband_offsets_.append(bands + 1);
+  }
+
+}
 
-    barkband_table_.append(static_cast<uint>(barkband));
+double MoodbarBuilder::Sum(const double *values, const int count) {
+
+  // Independent accumulators break the dependency chain so the compiler can keep several additions in flight.
+  double sum[4]{};
+  int i = 0;
+  for (; i + 4 <= count; i += 4) {
+    sum[0] += values[i];
+    sum[1] += values[i + 1];
+    sum[2] += values[i + 2];
+    sum[3] += values[i + 3];
+  }
+  for (; i < count; ++i) {
+    sum[0] += values[i];
   }
 
+  return (sum[0] + sum[1]) + (sum[2] + sum[3]);
+
 }
 
 void MoodbarBuilder::AddFrame(const double *magnitudes, const int size) {
 
-  if (size > barkband_table_.length()) {
+  if (barkband_offsets_.isEmpty() || size > bands_ + 1) {
     return;
   }
 
-  // Calculate total magnitudes for different bark bands.
-  double bands[sBarkBandCount]{};
-  for (int i = 0; i < size; ++i) {
-    bands[barkband_table_[i]] += magnitudes[i];
+  // Sum the magnitudes of every bark band and add their square to the channel it belongs to.
+  double rgb[kChannels]{};
+  for (int barkband = 0; barkband < sBarkBandCount; ++barkband) {
+    const int begin = std::min(barkband_offsets_[barkband], size);
+    const int end = std::min(barkband_offsets_[barkband + 1], size);
+    const double total = Sum(magnitudes + begin, end - begin);
+    rgb[BarkBandChannel(barkband)] += total * total;
   }
 
-  // Now divide the bark bands into thirds and compute their total amplitudes.
-  double rgb[] = { 0, 0, 0 };
-  for (int i = 0; i < sBarkBandCount; ++i) {
-    rgb[(i * 3) / sBarkBandCount] += bands[i] * bands[i];
-  }
-
-  frames_.append(Rgb(sqrt(rgb[0]), sqrt(rgb[1]), sqrt(rgb[2])));
+  frames_.append(sqrt(rgb[0]));
+  frames_.append(sqrt(rgb[1]));
+  frames_.append(sqrt(rgb[2]));
 
 }
 
-void MoodbarBuilder::Normalize(QList<Rgb> *vals, double Rgb::*member) {
+void MoodbarBuilder::Normalize(double *values, const qsizetype count, const int stride) {
 
-  const QList<Rgb> rgb_vals = *vals;
+  double *const end = values + count * stride;
 
-  double mini = vals->at(0).*member;
-  double maxi = vals->at(0).*member;
-  for (int i = 1; i < vals->count(); i++) {
-    const double value = vals->at(i).*member;
-    if (value > maxi) {
-      maxi = value;
+  double mini = values[0];
+  double maxi = values[0];
+  for (const double *value = values + stride; value < end; value += stride) {
+    if (*value > maxi) {
+      maxi = *value;
     }
-    else if (value < mini) {
-      mini = value;
+    else if (*value < mini) {
+      mini = *value;
     }
   }
 
   double avg = 0;
-  for (const Rgb &rgb : rgb_vals) {
-    const double value = rgb.*member;
-    if (value != mini && value != maxi) {
-      avg += value / static_cast<double>(vals->count());
+  for (const double *value = values; value < end; value += stride) {
+    if (*value != mini && *value != maxi) {
+      avg += *value / static_cast<double>(count);
     }
   }
 
@@ -111,15 +137,14 @@ void MoodbarBuilder::Normalize(QList<Rgb> *vals, double Rgb::*member) {
   double tb = 0;
   double avgu = 0;
   double avgb = 0;
-  for (const Rgb &rgb : rgb_vals) {
-    const double value = rgb.*member;
-    if (value != mini && value != maxi) {
-      if (value > avg) {
-        avgu += value;
+  for (const double *value = values; value < end; value += stride) {
+    if (*value != mini && *value != maxi) {
+      if (*value > avg) {
+        avgu += *value;
         tu++;
       }
       else {
-        avgb += value;
+        avgb += *value;
         tb++;
       }
     }
@@ -131,15 +156,14 @@ void MoodbarBuilder::Normalize(QList<Rgb> *vals, double Rgb::*member) {
   tb = 0;
   double avguu = 0;
   double avgbb = 0;
-  for (const Rgb &rgb : rgb_vals) {
-    const double value = rgb.*member;
-    if (value != mini && value != maxi) {
-      if (value > avgu) {
-        avguu += value;
+  for (const double *value = values; value < end; value += stride) {
+    if (*value != mini && *value != maxi) {
+      if (*value > avgu) {
+        avguu += *value;
         tu++;
       }
-      else if (value < avgb) {
-        avgbb += value;
+      else if (*value < avgb) {
+        avgbb += *value;
         tb++;
       }
     }
@@ -154,8 +178,7 @@ void MoodbarBuilder::Normalize(QList<Rgb> *vals, double Rgb::*member) {
     delta = 1;
   }
 
-  for (auto it = vals->begin(); it != vals->end(); ++it) {
-    double *value = &((*it).*member);
+  for (double *value = values; value < end; value += stride) {
     *value = std::isfinite(*value) ? qBound(0.0, (*value - mini) / delta, 1.0) : 0;
   }
 
@@ -166,30 +189,30 @@ QByteArray MoodbarBuilder::Finish(const int width) {
   QByteArray ret;
   ret.resize(width * 3);
   char *data = ret.data();
-  if (frames_.count() == 0) return ret;
+  const qsizetype frame_count = frames_.count() / kChannels;
+  if (frame_count == 0) return ret;
 
-  Normalize(&frames_, &Rgb::r);
-  Normalize(&frames_, &Rgb::g);
-  Normalize(&frames_, &Rgb::b);
+  double *frames = frames_.data();
+  for (int channel = 0; channel < kChannels; ++channel) {
+    Normalize(frames + channel, frame_count, kChannels);
+  }
 
   for (int i = 0; i < width; ++i) {
-    Rgb rgb;
-    const int start = static_cast<int>(i * frames_.count() / width);
-    const int end = std::max(static_cast<int>((i + 1) * frames_.count() / width), start + 1);
-
-    for (int j = start; j < end; j++) {
-      const Rgb frame = frames_.value(j);
-      rgb.r += frame.r * 255;
-      rgb.g += frame.g * 255;
-      rgb.b += frame.b * 255;
-      frames_[j] = rgb;
+    const qsizetype start = i * frame_count / width;
+    const qsizetype end = std::max((i + 1) * frame_count / width, start + 1);
+
+    double rgb[kChannels]{};
+    for (const double *frame = frames + start * kChannels; frame < frames + end * kChannels; frame += kChannels) {
+      rgb[0] += frame[0] * 255;
+      rgb[1] += frame[1] * 255;
+      rgb[2] += frame[2] * 255;
     }
 
-    const int n = end - start;
+    const double n = static_cast<double>(end - start);
 
-    *(data++) = static_cast<char>(rgb.r / n);
-    *(data++) = static_cast<char>(rgb.g / n);
-    *(data++) = static_cast<char>(rgb.b / n);
+    *(data++) = static_cast<char>(rgb[0] / n);
+    *(data++) = static_cast<char>(rgb[1] / n);
+    *(data++) = static_cast<char>(rgb[2] / n);
 
   }
 
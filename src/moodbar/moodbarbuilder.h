@@ -25,6 +25,7 @@
 #include <QtGlobal>
 #include <QList>
 #include <QByteArray>
+#include <QVarLengthArray>
 
 class MoodbarBuilder {
  public:
@@ -35,21 +36,17 @@ class MoodbarBuilder {
   QByteArray Finish(const int width);
 
  private:
-  struct Rgb {
-    Rgb() : r(0), g(0), b(0) {}
-    Rgb(const double r_, const double g_, const double b_) : r(r_), g(g_), b(b_) {}
-
-    double r, g, b;
-  };
-
   int BandFrequency(const int band) const;
-  static void Normalize(QList<Rgb> *vals, double Rgb::*member);
+  static double Sum(const double *values, const int count);
+  static void Normalize(double *values, const qsizetype count, const int stride);
 
-  QList<uint> barkband_table_;
+  // First magnitude index of every bark band, the last entry is the end of the last band.
+  QVarLengthArray<int, 32> barkband_offsets_;
   int bands_;
   int rate_hz_;
 
-  QList<Rgb> frames_;
+  // Interleaved r, g, b values for every frame.
+  QList<double> frames_;
 };
 
 #endif  // MOODBARBUILDER_H
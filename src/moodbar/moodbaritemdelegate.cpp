@@ -23,7 +23,6 @@
 #include <utility>
 
 #include <QApplication>
-#include <QtConcurrentRun>
 #include <QFuture>
 #include <QFutureWatcher>
 #include <QAbstractItemModel>
@@ -39,6 +38,8 @@
 #include "includes/shared_ptr.h"
 #include "core/logging.h"
 #include "core/settings.h"
+#include "core/memorybudget.h"
+#include "core/taskexecutor.h"
 #include "playlist/playlist.h"
 #include "playlist/playlistview.h"
 #include "playlist/playlistfilter.h"
@@ -50,20 +51,28 @@
 
 #include "constants/moodbarsettings.h"
 
+using namespace Qt::Literals::StringLiterals;
 using std::make_shared;
 
-MoodbarItemDelegate::Data::Data() : state_(State::None) {}
+namespace {
+constexpr qsizetype kMaxPixmapCacheBytes = 32LL * 1024LL * 1024LL;
+}
+
+MoodbarItemDelegate::Data::Data() : state_(State::None), style_(MoodbarSettings::Style::Normal) {}
 
 MoodbarItemDelegate::MoodbarItemDelegate(const SharedPtr<MoodbarLoader> moodbar_loader, PlaylistView *playlist_view, QObject *parent)
     : QItemDelegate(parent),
       moodbar_loader_(moodbar_loader),
       playlist_view_(playlist_view),
+      pixmaps_(kMaxPixmapCacheBytes),
       enabled_(false),
       style_(MoodbarSettings::Style::Normal) {
 
   QObject::connect(&*moodbar_loader, &MoodbarLoader::SettingsReloaded, this, &MoodbarItemDelegate::ReloadSettings);
   QObject::connect(&*moodbar_loader, &MoodbarLoader::StyleChanged, this, &MoodbarItemDelegate::ReloadSettings);
 
+  MemoryBudget::Instance()->Register(u"Moodbars"_s, this, [this]() { return MemoryUsage(); }, [this](const qint64 bytes) { TrimMemory(bytes); });
+
   ReloadSettings();
 
 }
@@ -78,6 +87,7 @@ void MoodbarItemDelegate::ReloadSettings() {
 
   if (!enabled_) {
     data_.clear();
+    pixmaps_.clear();
   }
 
   if (new_style != style_) {
@@ -111,6 +121,10 @@ QPixmap MoodbarItemDelegate::PixmapForIndex(const QModelIndex &idx, const QSize
   const QUrl url = idx.sibling(idx.row(), static_cast<int>(Playlist::Column::URL)).data().toUrl();
   const bool has_cue = idx.sibling(idx.row(), static_cast<int>(Playlist::Column::HasCUE)).data().toBool();
 
+  if (const QPixmap *pixmap = pixmaps_.object(PixmapKey { url, size, style_ })) {
+    return *pixmap;
+  }
+
   Data *data = nullptr;
   if (data_.contains(url)) {
     data = data_[url];
@@ -227,8 +241,9 @@ void MoodbarItemDelegate::DataLoaded(const QUrl &url, MoodbarPipelinePtr pipelin
 void MoodbarItemDelegate::StartLoadingColors(const QUrl &url, const QByteArray &bytes, Data *data) {
 
   data->state_ = Data::State::LoadingColors;
+  data->style_ = style_;
 
-  QFuture<ColorVector> future = QtConcurrent::run(MoodbarRenderer::Colors, bytes, style_, qApp->palette());
+  QFuture<ColorVector> future = TaskExecutor::Run(TaskExecutor::Lane::Interactive, MoodbarRenderer::Colors, bytes, style_, qApp->palette());
   QFutureWatcher<ColorVector> *watcher = new QFutureWatcher<ColorVector>();
   QObject::connect(watcher, &QFutureWatcher<ColorVector>::finished, this, [this, watcher, url]() {
     ColorsLoaded(url, watcher->result());
@@ -259,7 +274,7 @@ void MoodbarItemDelegate::StartLoadingImage(const QUrl &url, Data *data) {
 
   data->state_ = Data::State::LoadingImage;
 
-  QFuture<QImage> future = QtConcurrent::run(MoodbarRenderer::RenderToImage, data->colors_, data->desired_size_);
+  QFuture<QImage> future = TaskExecutor::Run(TaskExecutor::Lane::Interactive, MoodbarRenderer::RenderToImage, data->colors_, data->desired_size_);
   QFutureWatcher<QImage> *watcher = new QFutureWatcher<QImage>();
   QObject::connect(watcher, &QFutureWatcher<QImage>::finished, this, [this, watcher, url]() {
     ImageLoaded(url, watcher->result());
@@ -288,6 +303,9 @@ void MoodbarItemDelegate::ImageLoaded(const QUrl &url, const QImage &image) {
 
   data->pixmap_ = QPixmap::fromImage(image);
   data->state_ = Data::State::Loaded;
+  if (!image.isNull()) {
+    pixmaps_.insert(PixmapKey { url, image.size(), data->style_ }, new QPixmap(data->pixmap_), image.sizeInBytes());
+  }
 
   Playlist *playlist = playlist_view_->playlist();
   const PlaylistFilter *filter = playlist->filter();
@@ -310,3 +328,17 @@ void MoodbarItemDelegate::ImageLoaded(const QUrl &url, const QImage &image) {
   }
 
 }
+
+qint64 MoodbarItemDelegate::MemoryUsage() const {
+
+  return static_cast<qint64>(pixmaps_.totalCost());
+
+}
+
+void MoodbarItemDelegate::TrimMemory(const qint64 bytes) {
+
+  const qsizetype max_cost = pixmaps_.maxCost();
+  pixmaps_.setMaxCost(static_cast<qsizetype>(bytes));
+  pixmaps_.setMaxCost(max_cost);
+
+}
@@ -27,6 +27,7 @@
 #include <QObject>
 #include <QItemDelegate>
 #include <QCache>
+#include <QHashFunctions>
 #include <QSet>
 #include <QByteArray>
 #include <QString>
@@ -80,10 +81,21 @@ class MoodbarItemDelegate : public QItemDelegate {
 
     State state_;
     ColorVector colors_;
+    MoodbarSettings::Style style_;
     QSize desired_size_;
     QPixmap pixmap_;
   };
 
+  // Rendered pixmaps are kept for each size and style, so rows scrolled back into view or a column resized back are painted without rendering again.
+  struct PixmapKey {
+    QUrl url;
+    QSize size;
+    MoodbarSettings::Style style;
+
+    bool operator==(const PixmapKey &other) const { return url == other.url && size == other.size && style == other.style; }
+    friend size_t qHash(const PixmapKey &key, const size_t seed = 0) { return qHashMulti(seed, key.url, key.size.width(), key.size.height(), static_cast<int>(key.style)); }
+  };
+
  private:
   QPixmap PixmapForIndex(const QModelIndex &idx, const QSize size);
   void StartLoadingData(const QUrl &url, const bool has_cue, Data *data);
@@ -94,10 +106,16 @@ class MoodbarItemDelegate : public QItemDelegate {
 
   void ReloadAllColors();
 
+  // The pixmaps of the data are shared with the rendered pixmaps, so only those are counted.
+  qint64 MemoryUsage() const;
+  void TrimMemory(const qint64 bytes);
+
  private:
   const SharedPtr<MoodbarLoader> moodbar_loader_;
   PlaylistView *playlist_view_;
   QCache<QUrl, Data> data_;
+  // Cost is the size of the pixmap in bytes.
+  QCache<PixmapKey, QPixmap> pixmaps_;
 
   bool enabled_;
   MoodbarSettings::Style style_;
@@ -44,6 +44,8 @@
 #include "core/logging.h"
 #include "core/standardpaths.h"
 #include "core/settings.h"
+#include "core/song.h"
+#include "collection/collectionbackend.h"
 
 #include "moodbarpipeline.h"
 
@@ -57,12 +59,20 @@ using std::make_shared;
 #  include <windows.h>
 #endif
 
-MoodbarLoader::MoodbarLoader(QObject *parent)
+namespace {
+constexpr int kCollectionSongsId = 1;
+}
+
+MoodbarLoader::MoodbarLoader(const SharedPtr<CollectionBackend> collection_backend, QObject *parent)
     : QObject(parent),
+      collection_backend_(collection_backend),
       cache_(new QNetworkDiskCache(this)),
       thread_(new QThread(this)),
       kMaxActiveRequests(qMax(1, QThread::idealThreadCount() / 2)),
-      save_(false) {
+      enabled_(false),
+      save_(false),
+      generate_collection_(false),
+      low_power_mode_(false) {
 
   setObjectName(QLatin1String(QObject::metaObject()->className()));
   thread_->setObjectName(objectName());
@@ -70,6 +80,10 @@ MoodbarLoader::MoodbarLoader(QObject *parent)
   cache_->setCacheDirectory(StandardPaths::WritableLocation(StandardPaths::StandardLocation::CacheLocation) + u"/moodbar"_s);
   cache_->setMaximumCacheSize(60LL * 1024LL * 1024LL);  // 60MB - enough for 20,000 moodbars
 
+  QObject::connect(&*collection_backend_, &CollectionBackend::GotSongs, this, &MoodbarLoader::CollectionSongsLoaded);
+  QObject::connect(&*collection_backend_, &CollectionBackend::SongsAdded, this, &MoodbarLoader::GenerateMoodbars);
+  QObject::connect(&*collection_backend_, &CollectionBackend::SongsChanged, this, &MoodbarLoader::GenerateMoodbars);
+
   ReloadSettings();
 
 }
@@ -83,9 +97,19 @@ void MoodbarLoader::ReloadSettings() {
 
   Settings s;
   s.beginGroup(MoodbarSettings::kSettingsGroup);
+  enabled_ = s.value(MoodbarSettings::kEnabled, false).toBool();
   save_ = s.value(MoodbarSettings::kSave, false).toBool();
+  const bool generate_collection = enabled_ && s.value(MoodbarSettings::kGenerateCollection, false).toBool();
   s.endGroup();
 
+  if (generate_collection && !generate_collection_) {
+    collection_backend_->GetAllSongsAsync(kCollectionSongsId);
+  }
+  else if (!generate_collection) {
+    background_requests_.clear();
+  }
+  generate_collection_ = generate_collection;
+
   MaybeTakeNextRequest();
 
   Q_EMIT SettingsReloaded();
@@ -108,6 +132,17 @@ QUrl MoodbarLoader::CacheUrlEntry(const QString &filename) {
 
 }
 
+bool MoodbarLoader::HasMoodbarData(const QString &filename) const {
+
+  const QStringList possible_mood_files = MoodFilenames(filename);
+  for (const QString &possible_mood_file : possible_mood_files) {
+    if (QFile::exists(possible_mood_file)) return true;
+  }
+
+  return cache_->metaData(CacheUrlEntry(filename)).isValid();
+
+}
+
 MoodbarLoader::LoadResult MoodbarLoader::Load(const QUrl &url, const bool has_cue) {
 
   if (!url.isLocalFile() || has_cue) {
@@ -154,9 +189,54 @@ MoodbarLoader::LoadResult MoodbarLoader::Load(const QUrl &url, const bool has_cu
     }
   }
 
+  // There was no existing file, analyze the audio file and create one.
+  MoodbarPipelinePtr pipeline = CreateRequest(url);
+  queued_requests_ << url;
+
+  MaybeTakeNextRequest();
+
+  return LoadResult(LoadStatus::WillLoadAsync, pipeline);
+
+}
+
+void MoodbarLoader::SetLowPowerMode(const bool low_power_mode) {
+
+  low_power_mode_ = low_power_mode;
+
+  // The requests already started are finished.
+  MaybeTakeNextRequest();
+
+}
+
+void MoodbarLoader::GenerateMoodbars(const SongList &songs) {
+
+  if (!generate_collection_) return;
+
+  // Whether the moodbar data already exists is checked when the request is taken, to spread the file checks out
+  for (const Song &song : songs) {
+    if (song.url().isLocalFile() && !song.has_cue()) {
+      background_requests_ << song.url();
+    }
+  }
+
+  MaybeTakeNextRequest();
+
+}
+
+void MoodbarLoader::CollectionSongsLoaded(const SongList &songs, const int id) {
+
+  if (id != kCollectionSongsId) return;
+
+  qLog(Info) << "Checking moodbar data for" << songs.count() << "collection songs";
+
+  GenerateMoodbars(songs);
+
+}
+
+MoodbarPipelinePtr MoodbarLoader::CreateRequest(const QUrl &url) {
+
   if (!thread_->isRunning()) thread_->start(QThread::IdlePriority);
 
-  // There was no existing file, analyze the audio file and create one.
   MoodbarPipelinePtr pipeline = MoodbarPipelinePtr(new MoodbarPipeline(url));
   pipeline->moveToThread(thread_);
   SharedPtr<QMetaObject::Connection> connection = make_shared<QMetaObject::Connection>();
@@ -166,11 +246,8 @@ MoodbarLoader::LoadResult MoodbarLoader::Load(const QUrl &url, const bool has_cu
   });
 
   requests_[url] = pipeline;
-  queued_requests_ << url;
 
-  MaybeTakeNextRequest();
-
-  return LoadResult(LoadStatus::WillLoadAsync, pipeline);
+  return pipeline;
 
 }
 
@@ -178,17 +255,29 @@ void MoodbarLoader::MaybeTakeNextRequest() {
 
   Q_ASSERT(QThread::currentThread() == qApp->thread());
 
-  if (active_requests_.count() >= kMaxActiveRequests || queued_requests_.isEmpty()) {
-    return;
-  }
+  while (active_requests_.count() < kMaxActiveRequests) {
 
-  const QUrl url = queued_requests_.takeFirst();
-  active_requests_ << url;
+    QUrl url;
+    if (!queued_requests_.isEmpty()) {
+      url = queued_requests_.takeFirst();
+    }
+    else if (!background_requests_.isEmpty() && !low_power_mode_) {
+      url = background_requests_.takeFirst();
+      if (requests_.contains(url) || HasMoodbarData(url.toLocalFile())) continue;
+      CreateRequest(url);
+    }
+    else {
+      break;
+    }
 
-  qLog(Info) << "Creating moodbar data for" << url.toLocalFile();
+    active_requests_ << url;
 
-  MoodbarPipelinePtr pipeline = requests_.value(url);
-  QMetaObject::invokeMethod(&*pipeline, &MoodbarPipeline::Start, Qt::QueuedConnection);
+    qLog(Info) << "Creating moodbar data for" << url.toLocalFile();
+
+    MoodbarPipelinePtr pipeline = requests_.value(url);
+    QMetaObject::invokeMethod(&*pipeline, &MoodbarPipeline::Start, Qt::QueuedConnection);
+
+  }
 
 }
 
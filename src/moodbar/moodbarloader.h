@@ -30,17 +30,20 @@
 #include <QStringList>
 #include <QUrl>
 
+#include "includes/shared_ptr.h"
+#include "core/song.h"
 #include "moodbarpipeline.h"
 
 class QThread;
 class QByteArray;
 class QNetworkDiskCache;
+class CollectionBackend;
 
 class MoodbarLoader : public QObject {
   Q_OBJECT
 
  public:
-  explicit MoodbarLoader(QObject *parent = nullptr);
+  explicit MoodbarLoader(const SharedPtr<CollectionBackend> collection_backend, QObject *parent = nullptr);
   ~MoodbarLoader() override;
 
   enum class LoadStatus {
@@ -70,11 +73,25 @@ class MoodbarLoader : public QObject {
 
   LoadResult Load(const QUrl &url, const bool has_cue);
 
+  // Queues songs that don't have moodbar data yet for generation in the background,
+  // these are only started when there are no requests from the playlist waiting.
+  void GenerateMoodbars(const SongList &songs);
+
+  // Holds back the background generation while the window is hidden, songs from the playlist are still loaded.
+  void SetLowPowerMode(const bool low_power_mode);
+
+  qsizetype queued_requests() const { return queued_requests_.count(); }
+  qsizetype active_requests() const { return active_requests_.count(); }
+  qsizetype background_requests() const { return background_requests_.count(); }
+
  private:
   static QStringList MoodFilenames(const QString &song_filename);
   static QUrl CacheUrlEntry(const QString &filename);
+  bool HasMoodbarData(const QString &filename) const;
+  MoodbarPipelinePtr CreateRequest(const QUrl &url);
   void RequestFinished(MoodbarPipelinePtr pipeline, const QUrl &url);
   void MaybeTakeNextRequest();
+  void CollectionSongsLoaded(const SongList &songs, const int id);
 
  Q_SIGNALS:
   void MoodbarEnabled(const bool enabled);
@@ -82,6 +99,7 @@ class MoodbarLoader : public QObject {
   void SettingsReloaded();
 
  private:
+  const SharedPtr<CollectionBackend> collection_backend_;
   QNetworkDiskCache *cache_;
   QThread *thread_;
 
@@ -90,8 +108,12 @@ class MoodbarLoader : public QObject {
   QMap<QUrl, MoodbarPipelinePtr> requests_;
   QList<QUrl> queued_requests_;
   QSet<QUrl> active_requests_;
+  QList<QUrl> background_requests_;
 
+  bool enabled_;
   bool save_;
+  bool generate_collection_;
+  bool low_power_mode_;
 };
 
 #endif  // MOODBARLOADER_H
@@ -40,6 +40,7 @@
 #include "utilities/threadutils.h"
 #include "moodbar/moodbarbuilder.h"
 #include "engine/gstfastspectrum.h"
+#include "engine/gststartup.h"
 
 using namespace Qt::Literals::StringLiterals;
 using std::make_unique;
@@ -99,6 +100,8 @@ void MoodbarPipeline::Start() {
     return;
   }
 
+  GstStartup::WaitForInitialized();
+
   pipeline_ = gst_pipeline_new("moodbar-pipeline");
 
   GstElement *decodebin = CreateElement("uridecodebin");
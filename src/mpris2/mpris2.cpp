@@ -36,6 +36,7 @@
 #include <QString>
 #include <QStringList>
 #include <QUrl>
+#include <QTimer>
 #include <QDBusConnection>
 #include <QDBusMessage>
 #include <QDBusArgument>
@@ -107,6 +108,10 @@ namespace mpris {
 constexpr char kMprisObjectPath[] = "/org/mpris/MediaPlayer2";
 constexpr char kServiceName[] = "org.mpris.MediaPlayer2.strawberry";
 constexpr char kFreedesktopPath[] = "org.freedesktop.DBus.Properties";
+constexpr char kTrackIdPrefix[] = "/org/strawberrymusicplayer/strawberry/Track/";
+constexpr int kNotificationDelayMsec = 50;
+// Number of tracks around the current one exported in the track list.
+constexpr int kTrackListWindow = 100;
 
 Mpris2::Mpris2(const SharedPtr<Player> player,
                const SharedPtr<PlaylistManager> playlist_manager,
@@ -115,7 +120,13 @@ Mpris2::Mpris2(const SharedPtr<Player> player,
     : QObject(parent),
       player_(player),
       playlist_manager_(playlist_manager),
-      current_albumcover_loader_(current_albumcover_loader) {
+      current_albumcover_loader_(current_albumcover_loader),
+      timer_notifications_(new QTimer(this)),
+      tracklist_row_(-1) {
+
+  timer_notifications_->setSingleShot(true);
+  timer_notifications_->setInterval(kNotificationDelayMsec);
+  QObject::connect(timer_notifications_, &QTimer::timeout, this, &Mpris2::SendNotifications);
 
   new Mpris2Root(this);
   new Mpris2TrackList(this);
@@ -222,12 +233,32 @@ void Mpris2::EmitNotification(const QString &name, const QVariant &value) {
 
 void Mpris2::EmitNotification(const QString &name, const QVariant &value, const QString &mprisEntity) {
 
-  QDBusMessage msg = QDBusMessage::createSignal(QLatin1String(kMprisObjectPath), QLatin1String(kFreedesktopPath), u"PropertiesChanged"_s);
-  QVariantMap map;
-  map.insert(name, value);
-  const QVariantList args = QVariantList() << mprisEntity << map << QStringList();
-  msg.setArguments(args);
-  QDBusConnection::sessionBus().send(msg);
+  pending_notifications_[mprisEntity].insert(name, value);
+  if (!timer_notifications_->isActive()) {
+    timer_notifications_->start();
+  }
+
+}
+
+void Mpris2::SendNotifications() {
+
+  const QMap<QString, QVariantMap> pending_notifications = std::exchange(pending_notifications_, QMap<QString, QVariantMap>());
+  for (QMap<QString, QVariantMap>::const_iterator it = pending_notifications.constBegin(); it != pending_notifications.constEnd(); ++it) {
+    const QString &mpris_entity = it.key();
+    QVariantMap &sent = sent_notifications_[mpris_entity];
+    QVariantMap changed;
+    for (QVariantMap::const_iterator value_it = it.value().constBegin(); value_it != it.value().constEnd(); ++value_it) {
+      const QVariantMap::const_iterator sent_it = sent.constFind(value_it.key());
+      if (sent_it != sent.constEnd() && sent_it.value() == value_it.value()) continue;
+      changed.insert(value_it.key(), value_it.value());
+      sent.insert(value_it.key(), value_it.value());
+    }
+    if (changed.isEmpty()) continue;
+    QDBusMessage msg = QDBusMessage::createSignal(QLatin1String(kMprisObjectPath), QLatin1String(kFreedesktopPath), u"PropertiesChanged"_s);
+    const QVariantList args = QVariantList() << mpris_entity << changed << QStringList();
+    msg.setArguments(args);
+    QDBusConnection::sessionBus().send(msg);
+  }
 
 }
 
@@ -412,7 +443,36 @@ int Mpris2::current_playlist_row() const {
 }
 
 QDBusObjectPath Mpris2::current_track_id(const int current_row) const {
-  return QDBusObjectPath(QStringLiteral("/org/strawberrymusicplayer/strawberry/Track/%1").arg(current_row));
+  return QDBusObjectPath(QLatin1String(kTrackIdPrefix) + QString::number(current_row));
+}
+
+int Mpris2::TrackIdRow(const QDBusObjectPath &track_id) {
+
+  const QString path = track_id.path();
+  if (!path.startsWith(QLatin1String(kTrackIdPrefix))) return -1;
+
+  bool ok = false;
+  const int row = QStringView(path).mid(static_cast<qsizetype>(sizeof(kTrackIdPrefix) - 1)).toInt(&ok);
+  return ok ? row : -1;
+
+}
+
+// Only a window of tracks around the current one is exported, which the specification allows, so large playlists are never walked.
+// Track IDs are made from the row alone, the songs are only read for the IDs passed to GetTracksMetadata().
+Track_Ids Mpris2::TrackIds(Playlist *playlist, const int current_row) const {
+
+  const int row_count = playlist->rowCount();
+  const int first_row = qBound(0, current_row - kTrackListWindow / 2, qMax(0, row_count - kTrackListWindow));
+  const int last_row = qMin(row_count, first_row + kTrackListWindow);
+
+  Track_Ids track_ids;
+  track_ids.reserve(qMax(0, last_row - first_row));
+  for (int row = first_row; row < last_row; ++row) {
+    track_ids << current_track_id(row);
+  }
+
+  return track_ids;
+
 }
 
 // We send Metadata change notification as soon as the process of changing song starts...
@@ -425,6 +485,13 @@ void Mpris2::CurrentSongChanged(const Song &song) {
   EmitNotification(u"CanGoPrevious"_s, CanGoPrevious());
   EmitNotification(u"CanSeek"_s, CanSeek());
 
+  Playlist *playlist = playlist_manager_->active();
+  const int current_row = current_playlist_row();
+  if (playlist && current_row != -1 && current_row != tracklist_row_) {
+    tracklist_row_ = current_row;
+    Q_EMIT TrackListReplaced(TrackIds(playlist, current_row), current_track_id(current_row));
+  }
+
 }
 
 // ... and we add the cover information later, when it's available.
@@ -433,11 +500,34 @@ void Mpris2::AlbumCoverLoaded(const Song &song, const AlbumCoverLoaderResult &re
   const int current_row = current_playlist_row();
   if (current_row == -1) return;
 
-  last_metadata_ = QVariantMap();
-  song.ToXesam(&last_metadata_);
-
   using mpris::AddMetadata;
+
+  const bool same_song = song.IsSharedWith(metadata_song_) || (song.url() == metadata_song_.url() && song.IsMetadataEqual(metadata_song_));
+  if (!same_song) {
+    metadata_song_ = song;
+    metadata_xesam_ = QVariantMap();
+    song.ToXesam(&metadata_xesam_);
+    AddMetadata(u"year"_s, song.year(), &metadata_xesam_);
+    AddMetadata(u"bitrate"_s, song.bitrate(), &metadata_xesam_);
+    metadata_art_url_.clear();
+  }
+
+  // Keep the cover found earlier for the same song when this is only a metadata update without a loaded cover.
+  if (!same_song || result.success || metadata_art_url_.isEmpty()) {
+    metadata_art_url_ = ArtUrl(song, result);
+  }
+
+  last_metadata_ = metadata_xesam_;
   AddMetadata(u"mpris:trackid"_s, current_track_id(current_row), &last_metadata_);
+  if (!metadata_art_url_.isEmpty()) {
+    AddMetadata(u"mpris:artUrl"_s, metadata_art_url_, &last_metadata_);
+  }
+
+  EmitNotification(u"Metadata"_s, last_metadata_);
+
+}
+
+QString Mpris2::ArtUrl(const Song &song, const AlbumCoverLoaderResult &result) {
 
   QUrl cover_url;
   if (result.album_cover.cover_url.isValid() && result.album_cover.cover_url.isLocalFile() && QFile(result.album_cover.cover_url.toLocalFile()).exists()) {
@@ -453,14 +543,7 @@ void Mpris2::AlbumCoverLoaded(const Song &song, const AlbumCoverLoaderResult &re
     cover_url = song.art_automatic();
   }
 
-  if (cover_url.isValid()) {
-    AddMetadata(u"mpris:artUrl"_s, cover_url.toString(), &last_metadata_);
-  }
-
-  AddMetadata(u"year"_s, song.year(), &last_metadata_);
-  AddMetadata(u"bitrate"_s, song.bitrate(), &last_metadata_);
-
-  EmitNotification(u"Metadata"_s, last_metadata_);
+  return cover_url.isValid() ? cover_url.toString() : QString();
 
 }
 
@@ -598,18 +681,41 @@ void Mpris2::OpenUri(const QString &uri) {
 }
 
 Track_Ids Mpris2::Tracks() const {
-  // TODO
-  return Track_Ids();
+
+  Playlist *playlist = playlist_manager_->active();
+  if (!playlist) return Track_Ids();
+
+  return TrackIds(playlist, playlist->current_row());
+
 }
 
 bool Mpris2::CanEditTracks() const { return false; }
 
 TrackMetadata Mpris2::GetTracksMetadata(const Track_Ids &tracks) const {
 
-  Q_UNUSED(tracks);
+  Playlist *playlist = playlist_manager_->active();
+  if (!playlist) return TrackMetadata();
 
-  // TODO
-  return TrackMetadata();
+  const int current_row = playlist->current_row();
+
+  TrackMetadata ret;
+  ret.reserve(tracks.count());
+  for (const QDBusObjectPath &track_id : tracks) {
+    const int row = TrackIdRow(track_id);
+    // Unknown track IDs are left out, as the specification requires.
+    if (!playlist->has_item_at(row)) continue;
+    if (row == current_row && !last_metadata_.isEmpty()) {
+      ret << last_metadata_;
+      continue;
+    }
+    const Song song = playlist->item_at(row)->EffectiveMetadata();
+    QVariantMap metadata;
+    song.ToXesam(&metadata);
+    mpris::AddMetadata(u"mpris:trackid"_s, track_id, &metadata);
+    ret << metadata;
+  }
+
+  return ret;
 
 }
 
@@ -629,8 +735,13 @@ void Mpris2::RemoveTrack(const QDBusObjectPath &trackId) {
 }
 
 void Mpris2::GoTo(const QDBusObjectPath &trackId) {
-  Q_UNUSED(trackId);
-  // TODO
+
+  Playlist *playlist = playlist_manager_->active();
+  const int row = TrackIdRow(trackId);
+  if (!playlist || !playlist->has_item_at(row)) return;
+
+  player_->PlayAt(row, false, 0, EngineBase::TrackChangeType::Manual, Playlist::AutoScroll::Maybe, true);
+
 }
 
 quint32 Mpris2::PlaylistCount() const {
@@ -718,7 +829,7 @@ void Mpris2::PlaylistChangedSlot(Playlist *playlist) {
 
 void Mpris2::PlaylistCollectionChanged(Playlist *playlist) {
   Q_UNUSED(playlist);
-  EmitNotification(u"PlaylistCount"_s, ""_L1, u"org.mpris.MediaPlayer2.Playlists"_s);
+  EmitNotification(u"PlaylistCount"_s, PlaylistCount(), u"org.mpris.MediaPlayer2.Playlists"_s);
 }
 
 }  // namespace mpris
@@ -38,13 +38,15 @@
 #include <QJsonObject>
 
 #include "includes/shared_ptr.h"
+#include "core/song.h"
 #include "engine/enginebase.h"
 #include "covermanager/albumcoverloaderresult.h"
 
+class QTimer;
+
 class Player;
 class PlaylistManager;
 class CurrentAlbumCoverLoader;
-class Song;
 class Playlist;
 
 using TrackMetadata = QList<QVariantMap>;
@@ -233,7 +235,11 @@ class Mpris2 : public QObject {
   void PlaylistChangedSlot(Playlist *playlist);
   void PlaylistCollectionChanged(Playlist *playlist);
 
+ private Q_SLOTS:
+  void SendNotifications();
+
  private:
+  // Notifications are queued and sent as one PropertiesChanged signal per interface, leaving out values that didn't change.
   void EmitNotification(const QString &name);
   void EmitNotification(const QString &name, const QVariant &value);
   void EmitNotification(const QString &name, const QVariant &value, const QString &mprisEntity);
@@ -242,6 +248,9 @@ class Mpris2 : public QObject {
 
   int current_playlist_row() const;
   QDBusObjectPath current_track_id(const int current_row) const;
+  static int TrackIdRow(const QDBusObjectPath &track_id);
+  static QString ArtUrl(const Song &song, const AlbumCoverLoaderResult &result);
+  Track_Ids TrackIds(Playlist *playlist, const int current_row) const;
 
   bool CanSeek(EngineBase::State state) const;
 
@@ -254,6 +263,17 @@ class Mpris2 : public QObject {
 
   QString desktopfilepath_;
   QVariantMap last_metadata_;
+
+  QTimer *timer_notifications_;
+  QMap<QString, QVariantMap> pending_notifications_;
+  QMap<QString, QVariantMap> sent_notifications_;
+
+  // Xesam metadata and cover of the current song, reused until the song changes.
+  Song metadata_song_;
+  QVariantMap metadata_xesam_;
+  QString metadata_art_url_;
+
+  int tracklist_row_;
 };
 
 }  // namespace mpris
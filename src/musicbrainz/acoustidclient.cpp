@@ -31,6 +31,7 @@
 #include <QStringList>
 #include <QUrl>
 #include <QUrlQuery>
+#include <QTimer>
 #include <QtAlgorithms>
 #include <QNetworkRequest>
 #include <QNetworkReply>
@@ -54,12 +55,21 @@ namespace {
 constexpr char kClientId[] = "0qjUoxbowg";
 constexpr char kUrl[] = "https://api.acoustid.org/v2/lookup";
 constexpr int kDefaultTimeout = 5000;  // msec
+constexpr int kMaxLookupsPerRequest = 10;
+constexpr int kBatchRequestsDelay = 400;  // The API allows 3 requests per second.
 }  // namespace
 
 AcoustidClient::AcoustidClient(SharedPtr<NetworkAccessManager> network, QObject *parent)
     : QObject(parent),
       network_(network),
-      timeouts_(new NetworkTimeouts(kDefaultTimeout, this)) {}
+      timeouts_(new NetworkTimeouts(kDefaultTimeout, this)),
+      timer_flush_batch_(new QTimer(this)) {
+
+  timer_flush_batch_->setInterval(kBatchRequestsDelay);
+  timer_flush_batch_->setSingleShot(false);
+  QObject::connect(timer_flush_batch_, &QTimer::timeout, this, &AcoustidClient::FlushBatch);
+
+}
 
 AcoustidClient::~AcoustidClient() {
 
@@ -69,28 +79,73 @@ AcoustidClient::~AcoustidClient() {
 
 void AcoustidClient::SetTimeout(const int msec) { timeouts_->SetTimeout(msec); }
 
-void AcoustidClient::Start(const int id, const QString &fingerprint, int duration_msec) {
-
-  using Param = QPair<QString, QString>;
-  using ParamList = QList<Param>;
-
-  const ParamList params = ParamList() << Param(u"format"_s, u"json"_s)
-                                       << Param(u"client"_s, QLatin1String(kClientId))
-                                       << Param(u"duration"_s, QString::number(std::max(1LL, duration_msec / kMsecPerSec)))
-                                       << Param(u"meta"_s, u"recordingids+sources"_s)
-                                       << Param(u"fingerprint"_s, fingerprint);
+QNetworkReply *AcoustidClient::SendRequest(const QList<Lookup> &lookups) {
 
   QUrlQuery url_query;
-  url_query.setQueryItems(params);
+  url_query.addQueryItem(u"format"_s, u"json"_s);
+  url_query.addQueryItem(u"client"_s, QLatin1String(kClientId));
+  url_query.addQueryItem(u"meta"_s, u"recordingids+sources"_s);
+  if (lookups.count() == 1) {
+    url_query.addQueryItem(u"duration"_s, QString::number(std::max(1LL, lookups.first().duration_msec / kMsecPerSec)));
+    url_query.addQueryItem(u"fingerprint"_s, lookups.first().fingerprint);
+  }
+  else {
+    for (qsizetype i = 0; i < lookups.count(); ++i) {
+      url_query.addQueryItem(u"duration."_s + QString::number(i), QString::number(std::max(1LL, lookups[i].duration_msec / kMsecPerSec)));
+      url_query.addQueryItem(u"fingerprint."_s + QString::number(i), lookups[i].fingerprint);
+    }
+  }
+
   const QByteArray data = url_query.toString(QUrl::FullyEncoded).toUtf8();
   QNetworkRequest network_request(QUrl(QString::fromLatin1(kUrl)));
   network_request.setAttribute(QNetworkRequest::RedirectPolicyAttribute, QNetworkRequest::NoLessSafeRedirectPolicy);
   network_request.setHeader(QNetworkRequest::ContentTypeHeader, u"application/x-www-form-urlencoded"_s);
   QNetworkReply *reply = network_->post(network_request, data);
+
+  timeouts_->AddReply(reply);
+
+  return reply;
+
+}
+
+void AcoustidClient::Start(const int id, const QString &fingerprint, int duration_msec) {
+
+  QNetworkReply *reply = SendRequest(QList<Lookup>() << Lookup(id, fingerprint, duration_msec));
   QObject::connect(reply, &QNetworkReply::finished, this, [this, reply, id]() { RequestFinished(reply, id); });
   requests_[id] = reply;
 
-  timeouts_->AddReply(reply);
+}
+
+void AcoustidClient::Queue(const int id, const QString &fingerprint, const int duration_msec) {
+
+  pending_lookups_ << Lookup(id, fingerprint, duration_msec);
+
+  if (!timer_flush_batch_->isActive()) {
+    FlushBatch();
+    timer_flush_batch_->start();
+  }
+
+}
+
+void AcoustidClient::FlushBatch() {
+
+  if (pending_lookups_.isEmpty()) {
+    timer_flush_batch_->stop();
+    return;
+  }
+
+  const QList<Lookup> lookups = pending_lookups_.mid(0, kMaxLookupsPerRequest);
+  pending_lookups_.remove(0, lookups.count());
+
+  QList<int> ids;
+  ids.reserve(lookups.count());
+  for (const Lookup &lookup : lookups) {
+    ids << lookup.id;
+  }
+
+  QNetworkReply *reply = SendRequest(lookups);
+  QObject::connect(reply, &QNetworkReply::finished, this, [this, reply, ids]() { BatchRequestFinished(reply, ids); });
+  batch_requests_.insert(reply, ids);
 
 }
 
@@ -98,6 +153,13 @@ void AcoustidClient::Cancel(const int id) {
 
   if (requests_.contains(id)) delete requests_.take(id);
 
+  pending_lookups_.removeIf([id](const Lookup &lookup) { return lookup.id == id; });
+
+  // The other songs in a batch request are still waiting for the reply, so only forget the ID.
+  for (QMap<QNetworkReply*, QList<int>>::iterator it = batch_requests_.begin(); it != batch_requests_.end(); ++it) {
+    it.value().removeAll(id);
+  }
+
 }
 
 void AcoustidClient::CancelAll() {
@@ -106,6 +168,12 @@ void AcoustidClient::CancelAll() {
   qDeleteAll(replies);
   requests_.clear();
 
+  replies = batch_requests_.keys();
+  qDeleteAll(replies);
+  batch_requests_.clear();
+  pending_lookups_.clear();
+  timer_flush_batch_->stop();
+
 }
 
 namespace {
@@ -157,12 +225,75 @@ void AcoustidClient::RequestFinished(QNetworkReply *reply, const int request_id)
     return;
   }
 
+  Q_EMIT Finished(request_id, ParseRecordingIds(json_object["results"_L1].toArray()));
+
+}
+
+void AcoustidClient::BatchRequestFinished(QNetworkReply *reply, const QList<int> &request_ids) {
+
+  QObject::disconnect(reply, nullptr, this, nullptr);
+  reply->deleteLater();
+  // Use the IDs left in the map, some might have been cancelled while the request was running.
+  const QList<int> ids = batch_requests_.take(reply);
+
+  QString error_message;
+  QJsonObject json_object;
+  if (reply->error() != QNetworkReply::NoError) {
+    error_message = QStringLiteral("%1 (%2)").arg(reply->errorString()).arg(reply->error());
+  }
+  else if (reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt() != 200) {
+    error_message = QStringLiteral("Received HTTP code %1").arg(reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt());
+  }
+  else {
+    QJsonParseError error;
+    const QJsonDocument json_document = QJsonDocument::fromJson(reply->readAll(), &error);
+    if (error.error == QJsonParseError::NoError) {
+      json_object = json_document.object();
+      if (json_object["status"_L1].toString() != "ok"_L1) {
+        error_message = json_object["status"_L1].toString();
+      }
+    }
+    else {
+      error_message = error.errorString();
+    }
+  }
+
+  if (!error_message.isEmpty()) {
+    qLog(Error) << "Acoustid:" << error_message;
+    for (const int id : ids) {
+      Q_EMIT Finished(id, QStringList(), error_message);
+    }
+    return;
+  }
+
+  // A request with a single lookup is answered like a normal lookup, batches have a result list for each fingerprint index.
+  QMap<int, QStringList> results;
+  if (json_object.contains("fingerprints"_L1)) {
+    const QJsonArray json_fingerprints = json_object["fingerprints"_L1].toArray();
+    for (const QJsonValue &value_fingerprint : json_fingerprints) {
+      const QJsonObject object_fingerprint = value_fingerprint.toObject();
+      results.insert(object_fingerprint["index"_L1].toVariant().toInt(), ParseRecordingIds(object_fingerprint["results"_L1].toArray()));
+    }
+  }
+  else if (request_ids.count() == 1) {
+    results.insert(0, ParseRecordingIds(json_object["results"_L1].toArray()));
+  }
+
+  for (qsizetype i = 0; i < request_ids.count(); ++i) {
+    if (ids.contains(request_ids[i])) {
+      Q_EMIT Finished(request_ids[i], results.value(static_cast<int>(i)));
+    }
+  }
+
+}
+
+QStringList AcoustidClient::ParseRecordingIds(const QJsonArray &json_results) {
+
   // Get the results:
   // -in a first step, gather ids and their corresponding number of sources
   // -then sort results by number of sources (the results are originally
   //  unsorted but results with more sources are likely to be more accurate)
   // -keep only the ids, as sources where useful only to sort the results
-  const QJsonArray json_results = json_object["results"_L1].toArray();
 
   // List of <id, nb of sources> pairs
   QList<IdSource> id_source_list;
@@ -188,6 +319,6 @@ void AcoustidClient::RequestFinished(QNetworkReply *reply, const int request_id)
     id_list << is.id_;
   }
 
-  Q_EMIT Finished(request_id, id_list);
+  return id_list;
 
 }
@@ -26,12 +26,15 @@
 
 #include <QObject>
 #include <QMap>
+#include <QList>
 #include <QString>
 #include <QStringList>
 
 #include "includes/shared_ptr.h"
 
+class QTimer;
 class QNetworkReply;
+class QJsonArray;
 class NetworkAccessManager;
 class NetworkTimeouts;
 
@@ -54,6 +57,9 @@ class AcoustidClient : public QObject {
   // Starts a request and returns immediately.  Finished() will be emitted later with the same ID.
   void Start(const int id, const QString &fingerprint, int duration_msec);
 
+  // Queues a lookup that is sent together with other queued lookups in one request, used when identifying many songs.
+  void Queue(const int id, const QString &fingerprint, const int duration_msec);
+
   // Cancels the request with the given ID.  Finished() will never be emitted for that ID.  Does nothing if there is no request with the given ID.
   void Cancel(const int id);
 
@@ -65,11 +71,29 @@ class AcoustidClient : public QObject {
 
  private Q_SLOTS:
   void RequestFinished(QNetworkReply *reply, const int id);
+  void FlushBatch();
+  void BatchRequestFinished(QNetworkReply *reply, const QList<int> &ids);
+
+ private:
+  class Lookup {
+   public:
+    Lookup() : id(0), duration_msec(0) {}
+    Lookup(const int _id, const QString &_fingerprint, const int _duration_msec) : id(_id), fingerprint(_fingerprint), duration_msec(_duration_msec) {}
+    int id;
+    QString fingerprint;
+    int duration_msec;
+  };
+
+  QNetworkReply *SendRequest(const QList<Lookup> &lookups);
+  static QStringList ParseRecordingIds(const QJsonArray &json_results);
 
  private:
   SharedPtr<NetworkAccessManager> network_;
   NetworkTimeouts *timeouts_;
+  QTimer *timer_flush_batch_;
   QMap<int, QNetworkReply*> requests_;
+  QList<Lookup> pending_lookups_;
+  QMap<QNetworkReply*, QList<int>> batch_requests_;
 };
 
 #endif  // ACOUSTIDCLIENT_H
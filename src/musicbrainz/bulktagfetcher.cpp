@@ -0,0 +1,320 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "config.h"
+
+#include <utility>
+
+#include <QObject>
+#include <QtConcurrentMap>
+#include <QFuture>
+#include <QFutureWatcher>
+#include <QList>
+#include <QPair>
+#include <QString>
+#include <QStringList>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QTimer>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QJsonValue>
+
+#include "includes/shared_ptr.h"
+#include "core/logging.h"
+#include "core/standardpaths.h"
+#include "core/networkaccessmanager.h"
+#include "core/taskexecutor.h"
+#include "constants/timeconstants.h"
+#include "engine/chromaprinter.h"
+#include "acoustidclient.h"
+#include "musicbrainzclient.h"
+#include "tagfetcher.h"
+#include "bulktagfetcher.h"
+
+using namespace Qt::Literals::StringLiterals;
+
+namespace {
+constexpr char kProgressFilename[] = "bulktagfetcher.json";
+constexpr int kSaveProgressDelay = 10000;
+}  // namespace
+
+BulkTagFetcher::BulkTagFetcher(SharedPtr<NetworkAccessManager> network, QObject *parent)
+    : QObject(parent),
+      progress_filename_(StandardPaths::WritableLocation(StandardPaths::StandardLocation::CacheLocation) + QLatin1Char('/') + QLatin1String(kProgressFilename)),
+      fingerprint_watcher_(nullptr),
+      acoustid_client_(new AcoustidClient(network, this)),
+      musicbrainz_client_(new MusicBrainzClient(network, this)),
+      timer_save_progress_(new QTimer(this)),
+      songs_remaining_(0),
+      songs_done_(0),
+      progress_loaded_(false) {
+
+  timer_save_progress_->setSingleShot(true);
+  timer_save_progress_->setInterval(kSaveProgressDelay);
+  QObject::connect(timer_save_progress_, &QTimer::timeout, this, &BulkTagFetcher::SaveProgress);
+
+  QObject::connect(acoustid_client_, &AcoustidClient::Finished, this, &BulkTagFetcher::RecordingIdsFound);
+  QObject::connect(musicbrainz_client_, &MusicBrainzClient::MbIdFinished, this, &BulkTagFetcher::TagsFetched);
+
+}
+
+BulkTagFetcher::~BulkTagFetcher() {
+
+  Cancel();
+
+}
+
+QString BulkTagFetcher::SongKey(const Song &song) {
+
+  return song.url().toString() + QLatin1Char(':') + QString::number(song.beginning_nanosec());
+
+}
+
+BulkTagFetcher::FingerprintJob BulkTagFetcher::GetFingerprint(const FingerprintJob &job) {
+
+  return FingerprintJob(job.first, Chromaprinter(job.second).CreateFingerprint());
+
+}
+
+void BulkTagFetcher::Start(const SongList &songs) {
+
+  Cancel();
+  LoadProgress();
+
+  songs_.reserve(songs.count());
+  for (const Song &song : songs) {
+    if (!song.url().isLocalFile() || songs_identified_.contains(SongKey(song))) continue;
+    songs_ << song;
+  }
+  songs_remaining_ = static_cast<int>(songs_.count());
+  songs_done_ = 0;
+
+  qLog(Debug) << "Identifying" << songs_.count() << "songs," << songs.count() - songs_.count() << "songs were identified before";
+
+  if (songs_.isEmpty()) {
+    Q_EMIT Finished();
+    return;
+  }
+
+  QList<FingerprintJob> fingerprint_jobs;
+  for (int i = 0; i < songs_.count(); ++i) {
+    const Song &song = songs_[i];
+    QString fingerprint = song.fingerprint();
+    if (fingerprint.isEmpty() || fingerprint == "NONE"_L1) fingerprint = song.acoustid_fingerprint();
+    if (fingerprint.isEmpty()) fingerprint = fingerprints_.value(SongKey(song));
+    if (fingerprint.isEmpty()) {
+      fingerprint_jobs << FingerprintJob(i, song.url().toLocalFile());
+    }
+    else {
+      Identify(i, fingerprint);
+    }
+  }
+
+  if (!fingerprint_jobs.isEmpty()) {
+    qLog(Debug) << "Fingerprinting" << fingerprint_jobs.count() << "songs";
+    QFuture<FingerprintJob> future = QtConcurrent::mapped(TaskExecutor::Pool(TaskExecutor::Lane::CPUAnalysis), fingerprint_jobs, GetFingerprint);
+    fingerprint_watcher_ = new QFutureWatcher<FingerprintJob>(this);
+    QObject::connect(fingerprint_watcher_, &QFutureWatcher<FingerprintJob>::resultReadyAt, this, &BulkTagFetcher::FingerprintFound);
+    fingerprint_watcher_->setFuture(future);
+  }
+
+  Q_EMIT Progress(songs_done_, static_cast<int>(songs_.count()));
+
+}
+
+void BulkTagFetcher::Cancel() {
+
+  if (fingerprint_watcher_) {
+    fingerprint_watcher_->cancel();
+    fingerprint_watcher_->deleteLater();
+    fingerprint_watcher_ = nullptr;
+  }
+
+  acoustid_client_->CancelAll();
+  musicbrainz_client_->CancelAll();
+  songs_.clear();
+  songs_remaining_ = 0;
+  songs_done_ = 0;
+
+  if (timer_save_progress_->isActive()) {
+    timer_save_progress_->stop();
+    SaveProgress();
+  }
+
+}
+
+void BulkTagFetcher::ClearProgress() {
+
+  songs_identified_.clear();
+  fingerprints_.clear();
+  progress_loaded_ = true;
+
+  if (timer_save_progress_->isActive()) {
+    timer_save_progress_->stop();
+  }
+
+  if (QFile::exists(progress_filename_)) {
+    QFile::remove(progress_filename_);
+  }
+
+}
+
+void BulkTagFetcher::FingerprintFound(const int index) {
+
+  QFutureWatcher<FingerprintJob> *watcher = qobject_cast<QFutureWatcher<FingerprintJob>*>(sender());
+  if (!watcher || watcher != fingerprint_watcher_) return;
+
+  const FingerprintJob result = watcher->resultAt(index);
+  if (result.first >= songs_.count()) return;
+
+  if (result.second.isEmpty()) {
+    SongFinished(result.first, SongList(), tr("Could not create fingerprint"));
+    return;
+  }
+
+  fingerprints_.insert(SongKey(songs_[result.first]), result.second);
+  ScheduleSaveProgress();
+
+  Identify(result.first, result.second);
+
+}
+
+void BulkTagFetcher::Identify(const int index, const QString &fingerprint) {
+
+  const Song &song = songs_[index];
+  acoustid_client_->Queue(index, fingerprint, static_cast<int>(song.length_nanosec() / kNsecPerMsec));
+
+}
+
+void BulkTagFetcher::RecordingIdsFound(const int index, const QStringList &recording_ids, const QString &error) {
+
+  if (index >= songs_.count()) return;
+
+  if (recording_ids.isEmpty()) {
+    SongFinished(index, SongList(), error);
+    return;
+  }
+
+  musicbrainz_client_->StartMbIdRequest(index, recording_ids);
+
+}
+
+void BulkTagFetcher::TagsFetched(const int index, const MusicBrainzClient::ResultList &results, const QString &error) {
+
+  if (index >= songs_.count()) return;
+
+  SongFinished(index, TagFetcher::SongsFromResults(results), error);
+
+}
+
+void BulkTagFetcher::SongFinished(const int index, const SongList &songs_guessed, const QString &error) {
+
+  const Song song = songs_[index];
+
+  // Songs that failed because of a network error are tried again next time.
+  if (error.isEmpty()) {
+    songs_identified_.insert(SongKey(song));
+    ScheduleSaveProgress();
+  }
+
+  ++songs_done_;
+  --songs_remaining_;
+
+  Q_EMIT ResultAvailable(song, songs_guessed, error);
+  Q_EMIT Progress(songs_done_, static_cast<int>(songs_.count()));
+
+  if (songs_remaining_ == 0) {
+    if (timer_save_progress_->isActive()) timer_save_progress_->stop();
+    SaveProgress();
+    Q_EMIT Finished();
+  }
+
+}
+
+void BulkTagFetcher::LoadProgress() {
+
+  if (progress_loaded_) return;
+  progress_loaded_ = true;
+
+  QFile file(progress_filename_);
+  if (!file.exists()) return;
+  if (!file.open(QIODevice::ReadOnly)) {
+    qLog(Error) << "Could not open" << progress_filename_ << file.errorString();
+    return;
+  }
+  const QJsonDocument json_document = QJsonDocument::fromJson(file.readAll());
+  file.close();
+
+  const QJsonObject json_object = json_document.object();
+  const QJsonArray json_identified = json_object["identified"_L1].toArray();
+  for (const QJsonValue &value : json_identified) {
+    songs_identified_.insert(value.toString());
+  }
+  const QJsonObject json_fingerprints = json_object["fingerprints"_L1].toObject();
+  for (QJsonObject::const_iterator it = json_fingerprints.constBegin(); it != json_fingerprints.constEnd(); ++it) {
+    fingerprints_.insert(it.key(), it.value().toString());
+  }
+
+}
+
+void BulkTagFetcher::ScheduleSaveProgress() {
+
+  if (!timer_save_progress_->isActive()) {
+    timer_save_progress_->start();
+  }
+
+}
+
+void BulkTagFetcher::SaveProgress() {
+
+  QJsonArray json_identified;
+  for (const QString &key : std::as_const(songs_identified_)) {
+    json_identified << key;
+  }
+
+  // Fingerprints are only needed until the song is identified.
+  QJsonObject json_fingerprints;
+  for (QMap<QString, QString>::const_iterator it = fingerprints_.constBegin(); it != fingerprints_.constEnd(); ++it) {
+    if (!songs_identified_.contains(it.key())) {
+      json_fingerprints.insert(it.key(), it.value());
+    }
+  }
+
+  QJsonObject json_object;
+  json_object.insert("identified"_L1, json_identified);
+  json_object.insert("fingerprints"_L1, json_fingerprints);
+
+  const QDir dir = QFileInfo(progress_filename_).absoluteDir();
+  if (!dir.exists()) dir.mkpath(u"."_s);
+
+  QSaveFile file(progress_filename_);
+  if (!file.open(QIODevice::WriteOnly)) {
+    qLog(Error) << "Could not open" << progress_filename_ << file.errorString();
+    return;
+  }
+  file.write(QJsonDocument(json_object).toJson(QJsonDocument::Compact));
+  if (!file.commit()) {
+    qLog(Error) << "Could not write" << progress_filename_ << file.errorString();
+  }
+
+}
@@ -0,0 +1,99 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef BULKTAGFETCHER_H
+#define BULKTAGFETCHER_H
+
+#include "config.h"
+
+#include <QObject>
+#include <QFutureWatcher>
+#include <QList>
+#include <QMap>
+#include <QPair>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+
+#include "includes/shared_ptr.h"
+#include "core/song.h"
+#include "musicbrainzclient.h"
+
+class QTimer;
+class NetworkAccessManager;
+class AcoustidClient;
+
+// Identifies a large number of songs using AcoustID and MusicBrainz.
+// Fingerprints stored in the collection are reused, files without one are fingerprinted in parallel.
+// Lookups are batched to AcoustID, and MusicBrainz requests are queued by MusicBrainzClient to respect the rate limit.
+// Fingerprints and identified songs are saved to a progress file so an interrupted run can be continued without starting over.
+class BulkTagFetcher : public QObject {
+  Q_OBJECT
+
+ public:
+  explicit BulkTagFetcher(SharedPtr<NetworkAccessManager> network, QObject *parent = nullptr);
+  ~BulkTagFetcher() override;
+
+  // Songs that were identified in an earlier run are skipped.
+  void Start(const SongList &songs);
+
+  // Forgets which songs were identified in earlier runs.
+  void ClearProgress();
+
+ public Q_SLOTS:
+  void Cancel();
+
+ Q_SIGNALS:
+  void Progress(const int done, const int total);
+  void ResultAvailable(const Song &original_song, const SongList &songs_guessed, const QString &error = QString());
+  void Finished();
+
+ private Q_SLOTS:
+  void FingerprintFound(const int index);
+  void RecordingIdsFound(const int index, const QStringList &recording_ids, const QString &error = QString());
+  void TagsFetched(const int index, const MusicBrainzClient::ResultList &results, const QString &error = QString());
+  void SaveProgress();
+
+ private:
+  using FingerprintJob = QPair<int, QString>;
+
+  static QString SongKey(const Song &song);
+  static FingerprintJob GetFingerprint(const FingerprintJob &job);
+  void LoadProgress();
+  void ScheduleSaveProgress();
+  void Identify(const int index, const QString &fingerprint);
+  void SongFinished(const int index, const SongList &songs_guessed, const QString &error);
+
+  const QString progress_filename_;
+  QFutureWatcher<FingerprintJob> *fingerprint_watcher_;
+  AcoustidClient *acoustid_client_;
+  MusicBrainzClient *musicbrainz_client_;
+  QTimer *timer_save_progress_;
+
+  SongList songs_;
+  int songs_remaining_;
+  int songs_done_;
+
+  // Progress kept between runs, by song key.
+  QSet<QString> songs_identified_;
+  QMap<QString, QString> fingerprints_;
+  bool progress_loaded_;
+};
+
+#endif  // BULKTAGFETCHER_H
@@ -96,6 +96,10 @@ void MusicBrainzClient::CancelAll() {
   qDeleteAll(discid_requests_);
   discid_requests_.clear();
 
+  pending_mbid_requests_.clear();
+  pending_discid_requests_.clear();
+  pending_results_.clear();
+
 }
 
 JsonBaseRequest::JsonObjectResult MusicBrainzClient::ParseJsonObject(QNetworkReply *reply) {
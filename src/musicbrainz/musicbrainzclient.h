@@ -34,6 +34,7 @@
 #include <QStringList>
 
 #include "includes/shared_ptr.h"
+#include "constants/timeconstants.h"
 #include "core/jsonbaserequest.h"
 
 class QNetworkReply;
@@ -56,6 +57,7 @@ class MusicBrainzClient : public JsonBaseRequest {
   virtual bool authenticated() const override { return true; }
   virtual bool use_authorization_header() const override { return false; }
   virtual QByteArray authorization_header() const override { return QByteArray(); }
+  virtual qint64 cache_time() const override { return 30 * kSecsPerDay; }
 
   struct Result {
    public:
@@ -32,6 +32,7 @@
 
 #include "includes/shared_ptr.h"
 #include "core/networkaccessmanager.h"
+#include "core/taskexecutor.h"
 #include "constants/timeconstants.h"
 #include "engine/chromaprinter.h"
 #include "acoustidclient.h"
@@ -72,7 +73,7 @@ void TagFetcher::StartFetch(const SongList &songs) {
     }
   }
   else {
-    QFuture<QString> future = QtConcurrent::mapped(songs_, GetFingerprint);
+    QFuture<QString> future = QtConcurrent::mapped(TaskExecutor::Pool(TaskExecutor::Lane::CPUAnalysis), songs_, GetFingerprint);
     fingerprint_watcher_ = new QFutureWatcher<QString>(this);
     QObject::connect(fingerprint_watcher_, &QFutureWatcher<QString>::resultReadyAt, this, &TagFetcher::FingerprintFound);
     fingerprint_watcher_->setFuture(future);
@@ -140,7 +141,12 @@ void TagFetcher::TagsFetched(const int index, const MusicBrainzClient::ResultLis
     return;
   }
 
-  const Song original_song = songs_.value(index);
+  Q_EMIT ResultAvailable(songs_.value(index), SongsFromResults(results), error);
+
+}
+
+SongList TagFetcher::SongsFromResults(const MusicBrainzClient::ResultList &results) {
+
   SongList songs_guessed;
   songs_guessed.reserve(results.count());
   for (const MusicBrainzClient::Result &result : results) {
@@ -159,6 +165,6 @@ void TagFetcher::TagsFetched(const int index, const MusicBrainzClient::ResultLis
     songs_guessed << song;
   }
 
-  Q_EMIT ResultAvailable(original_song, songs_guessed, error);
+  return songs_guessed;
 
 }
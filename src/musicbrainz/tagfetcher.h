@@ -46,6 +46,8 @@ class TagFetcher : public QObject {
 
   void StartFetch(const SongList &songs);
 
+  static SongList SongsFromResults(const MusicBrainzClient::ResultList &results);
+
  public Q_SLOTS:
   void Cancel();
 
@@ -21,14 +21,20 @@
 
 #include <QtGlobal>
 
+#include <algorithm>
 #include <functional>
 #include <utility>
 #include <chrono>
 
 #include <QThread>
+#include <QThreadPool>
+#include <QtConcurrentRun>
+#include <QFuture>
+#include <QFutureWatcher>
 #include <QFile>
 #include <QFileInfo>
 #include <QTimer>
+#include <QElapsedTimer>
 #include <QDateTime>
 #include <QList>
 #include <QString>
@@ -52,6 +58,16 @@ class OrganizeFormat;
 namespace {
 constexpr int kBatchSize = 10;
 constexpr int kTranscodeProgressInterval = 500;
+// Limits how many files wait to be copied, and how many transcoded files wait in the temporary directory.
+constexpr int kMaxQueuedCopiesPerThread = 2;
+constexpr int kMaxQueuedTranscodesPerThread = 2;
+
+struct CopyResult {
+  bool success = false;
+  QString error_text;
+  qint64 elapsed_msec = 0;
+};
+
 }  // namespace
 
 Organize::Organize(const SharedPtr<TaskManager> task_manager,
@@ -80,6 +96,8 @@ Organize::Organize(const SharedPtr<TaskManager> task_manager,
       eject_after_(eject_after),
       task_count_(static_cast<quint64>(songs_info.count())),
       playlist_(playlist),
+      copy_thread_pool_(new QThreadPool(this)),
+      copies_running_(0),
       tasks_complete_(0),
       started_(false),
       task_id_(0),
@@ -88,6 +106,8 @@ Organize::Organize(const SharedPtr<TaskManager> task_manager,
 
   original_thread_ = thread();
 
+  copy_thread_pool_->setMaxThreadCount(destination_->MaxConcurrentCopies());
+
   process_files_timer_->setSingleShot(true);
   process_files_timer_->setInterval(100ms);
   QObject::connect(process_files_timer_, &QTimer::timeout, this, &Organize::ProcessSomeFiles);
@@ -101,6 +121,8 @@ Organize::Organize(const SharedPtr<TaskManager> task_manager,
 
 Organize::~Organize() {
 
+  copy_thread_pool_->waitForDone();
+
   if (thread_) {
     thread_->quit();
     thread_->deleteLater();
@@ -113,6 +135,7 @@ void Organize::Start() {
   if (thread_) return;
 
   task_id_ = task_manager_->StartTask(tr("Organizing files"));
+  elapsed_timer_.start();
   task_manager_->SetTaskBlocksCollectionScans(task_id_);
 
   thread_ = new QThread;
@@ -150,7 +173,15 @@ void Organize::ProcessSomeFiles() {
       return;
     }
 
+    if (copies_running_ > 0) {
+      // CopyFinished will start us off again when the last files are copied
+      qLog(Debug) << "Waiting for copy jobs";
+      return;
+    }
+
+    FlushSongsPathChanged();
     UpdateProgress();
+    LogStatistics();
 
     QString error_text;
     if (!destination_->FinishCopy(files_with_errors_.isEmpty(), error_text) && !error_text.isEmpty()) {
@@ -172,12 +203,17 @@ void Organize::ProcessSomeFiles() {
     return;
   }
 
+  const bool concurrent_copies = copy_thread_pool_->maxThreadCount() > 1;
+
   // We process files in batches so we can be cancelled part-way through.
   for (int i = 0; i < kBatchSize; ++i) {
     SetSongProgress(0);
 
     if (tasks_pending_.isEmpty()) break;
 
+    // Wait for the copy stage to catch up before queueing more files.
+    if (concurrent_copies && copies_running_ >= copy_thread_pool_->maxThreadCount() * kMaxQueuedCopiesPerThread) break;
+
     Task task = tasks_pending_.takeFirst();
     qLog(Info) << "Processing" << task.song_info_.song_.url().toLocalFile();
 
@@ -204,6 +240,12 @@ void Organize::ProcessSomeFiles() {
       // Figure out if we need to transcode it
       Song::FileType dest_type = CheckTranscode(song.filetype());
       if (dest_type != Song::FileType::Unknown) {
+        // Don't fill the temporary directory with transcoded files faster than they can be copied.
+        if (tasks_transcoding_.count() >= transcoder_->max_threads() * kMaxQueuedTranscodesPerThread) {
+          tasks_pending_.prepend(task);
+          break;
+        }
+
         // Get the preset
         TranscoderPreset preset = Transcoder::PresetForFileType(dest_type);
 
@@ -218,8 +260,17 @@ void Organize::ProcessSomeFiles() {
         qLog(Debug) << "Transcoding with" << preset.name_;
 
         task.transcoded_filename_ = transcoder_->GetFile(task.song_info_.song_.url().toLocalFile(), preset);
+        task.transcode_cache_key_ = transcode_cache_.Key(song, preset);
         task.new_extension_ = preset.extension_;
         task.new_filetype_ = dest_type;
+
+        // The song might have been transcoded with the same preset and settings for another device already.
+        if (transcode_cache_.Get(task.transcode_cache_key_, task.transcoded_filename_)) {
+          qLog(Debug) << "Using cached transcoded file for" << task.song_info_.song_.url().toLocalFile();
+          tasks_pending_ << task;
+          continue;
+        }
+
         tasks_transcoding_[task.song_info_.song_.url().toLocalFile()] = task;
         qLog(Debug) << "Transcoding to" << task.transcoded_filename_;
 
@@ -264,42 +315,59 @@ void Organize::ProcessSomeFiles() {
       }
     }
     else if (destination_->source() == Song::Source::Device) {
+      QElapsedTimer cover_timer;
+      cover_timer.start();
       const TagReaderResult result = tagreader_client_->LoadCoverImageBlocking(task.song_info_.song_.url().toLocalFile(), job.cover_image_);
       if (!result.success()) {
         qLog(Error) << "Could not load embedded art from" << task.song_info_.song_.url() << result.error_string();
       }
+      AddStatistics(&statistics_cover_, job.cover_image_.sizeInBytes(), cover_timer.elapsed());
     }
 
     if (!job.cover_source_.isEmpty()) {
       job.cover_dest_ = QFileInfo(job.destination_).path() + QLatin1Char('/') + QFileInfo(job.cover_source_).fileName();
     }
 
-    job.progress_ = std::bind(&Organize::SetSongProgress, this, std::placeholders::_1, !task.transcoded_filename_.isEmpty());
-
-    QString error_text;
-    if (destination_->CopyToStorage(job, error_text)) {
-      if (job.remove_original_ && song.is_local_collection_song() && destination_->source() == Song::Source::Collection) {
-        // Notify other aspects of system that song has been invalidated
-        QString root = destination_->LocalPath();
-        QFileInfo new_file = QFileInfo(root + QLatin1Char('/') + task.song_info_.new_filename_);
-        Q_EMIT SongPathChanged(song, new_file, destination_->collection_directory_id());
-      }
-    }
-    else {
-      files_with_errors_ << task.song_info_.song_.basefilename();
-      if (!error_text.isEmpty()) {
-        log_ << error_text;
-      }
+    const qint64 copy_bytes = QFileInfo(job.source_).size();
+
+    if (concurrent_copies) {
+      // The copy runs on the pool while we go on with the next files.
+      ++copies_running_;
+      const SharedPtr<MusicStorage> destination = destination_;
+      QFuture<CopyResult> future = QtConcurrent::run(copy_thread_pool_, [destination, job]() {
+        QElapsedTimer copy_timer;
+        copy_timer.start();
+        CopyResult result;
+        result.success = destination->CopyToStorage(job, result.error_text);
+        result.elapsed_msec = copy_timer.elapsed();
+        return result;
+      });
+      QFutureWatcher<CopyResult> *watcher = new QFutureWatcher<CopyResult>(this);
+      QObject::connect(watcher, &QFutureWatcher<CopyResult>::finished, this, [this, watcher, task, song, copy_bytes]() {
+        const CopyResult result = watcher->result();
+        watcher->deleteLater();
+        --copies_running_;
+        if (result.success) AddStatistics(&statistics_copy_, copy_bytes, result.elapsed_msec);
+        CopyFinished(task, song, result.success, result.error_text);
+        if (!process_files_timer_->isActive()) {
+          process_files_timer_->start();
+        }
+      });
+      watcher->setFuture(future);
+      continue;
     }
 
-    // Clean up the temporary transcoded file
-    if (!task.transcoded_filename_.isEmpty()) {
-      QFile::remove(task.transcoded_filename_);
-    }
+    job.progress_ = std::bind(&Organize::SetSongProgress, this, std::placeholders::_1, !task.transcoded_filename_.isEmpty());
 
-    tasks_complete_++;
+    QElapsedTimer copy_timer;
+    copy_timer.start();
+    QString error_text;
+    const bool success = destination_->CopyToStorage(job, error_text);
+    if (success) AddStatistics(&statistics_copy_, copy_bytes, copy_timer.elapsed());
+    CopyFinished(task, song, success, error_text);
   }
   SetSongProgress(0);
+  FlushSongsPathChanged();
 
   if (!process_files_timer_->isActive()) {
     process_files_timer_->start();
@@ -308,6 +376,81 @@ void Organize::ProcessSomeFiles() {
 
 }
 
+void Organize::CopyFinished(const Task &task, const Song &song, const bool success, const QString &error_text) {
+
+  if (success) {
+    if (!copy_ && song.is_local_collection_song() && destination_->source() == Song::Source::Collection) {
+      // Notify other aspects of system that song has been invalidated
+      QString root = destination_->LocalPath();
+      songs_path_changed_ << song;
+      songs_path_changed_files_ << QFileInfo(root + QLatin1Char('/') + task.song_info_.new_filename_);
+    }
+  }
+  else {
+    files_with_errors_ << task.song_info_.song_.basefilename();
+    if (!error_text.isEmpty()) {
+      log_ << error_text;
+    }
+  }
+
+  // Clean up the temporary transcoded file
+  if (!task.transcoded_filename_.isEmpty()) {
+    QFile::remove(task.transcoded_filename_);
+  }
+
+  tasks_complete_++;
+
+}
+
+void Organize::AddStatistics(StageStatistics *statistics, const qint64 bytes, const qint64 msec) {
+
+  ++statistics->files;
+  statistics->bytes += bytes;
+  statistics->msec += msec;
+
+}
+
+QString Organize::StatisticsText(const QString &stage, const StageStatistics &statistics) {
+
+  // The time is summed over files that might have been processed at the same time, so the rates are per worker.
+  const double seconds = static_cast<double>(std::max(1LL, statistics.msec)) / 1000.0;
+  const double megabytes = static_cast<double>(statistics.bytes) / (1024.0 * 1024.0);
+
+  return tr("%1: %2 files, %3 MB in %4 s (%5 MB/s, %6 files/s)")
+    .arg(stage)
+    .arg(statistics.files)
+    .arg(megabytes, 0, 'f', 1)
+    .arg(seconds, 0, 'f', 1)
+    .arg(megabytes / seconds, 0, 'f', 1)
+    .arg(static_cast<double>(statistics.files) / seconds, 0, 'f', 1);
+
+}
+
+void Organize::LogStatistics() {
+
+  QStringList lines;
+  lines << tr("Organized %1 files in %2 s").arg(tasks_complete_).arg(static_cast<double>(elapsed_timer_.elapsed()) / 1000.0, 0, 'f', 1);
+  if (statistics_transcode_.files > 0) lines << StatisticsText(tr("Transcoding"), statistics_transcode_);
+  if (statistics_cover_.files > 0) lines << StatisticsText(tr("Loading covers"), statistics_cover_);
+  if (statistics_copy_.files > 0) lines << StatisticsText(tr("Copying"), statistics_copy_);
+
+  for (const QString &line : std::as_const(lines)) {
+    qLog(Info) << line;
+  }
+  log_ << lines;
+
+}
+
+void Organize::FlushSongsPathChanged() {
+
+  if (songs_path_changed_.isEmpty()) return;
+
+  Q_EMIT SongsPathChanged(songs_path_changed_, songs_path_changed_files_, destination_->collection_directory_id());
+  songs_path_changed_.clear();
+  songs_path_changed_files_.clear();
+
+}
+
 bool Organize::ShouldSkipFile(const QString &filename) const {
 
   if (overwrite_) {
@@ -385,9 +528,7 @@ void Organize::UpdateProgress() {
 
 }
 
-void Organize::FileTranscoded(const QString &input, const QString &output, const bool success) {
-
-  Q_UNUSED(output);
+void Organize::FileTranscoded(const QString &input, const QString &output, const bool success, const qint64 elapsed_msec) {
 
   qLog(Info) << "File finished" << input << success;
   transcode_progress_timer_.stop();
@@ -397,6 +538,8 @@ void Organize::FileTranscoded(const QString &input, const QString &output, const
     files_with_errors_ << input;
   }
   else {
+    AddStatistics(&statistics_transcode_, QFileInfo(input).size(), elapsed_msec);
+    transcode_cache_.Insert(task.transcode_cache_key_, output);
     tasks_pending_ << task;
   }
 
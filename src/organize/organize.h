@@ -28,6 +28,7 @@
 
 #include <QObject>
 #include <QBasicTimer>
+#include <QElapsedTimer>
 #include <QFileInfo>
 #include <QSet>
 #include <QList>
@@ -37,9 +38,11 @@
 
 #include "includes/shared_ptr.h"
 #include "core/song.h"
+#include "transcoder/transcodecache.h"
 #include "organizeformat.h"
 
 class QThread;
+class QThreadPool;
 class QTimer;
 class QTimerEvent;
 
@@ -80,14 +83,14 @@ class Organize : public QObject {
  Q_SIGNALS:
   void Finished(const QStringList &files_with_errors, const QStringList &log);
   void FileCopied(const int database_id);
-  void SongPathChanged(const Song &song, const QFileInfo &new_file, const std::optional<int> new_collection_directory_id);
+  void SongsPathChanged(const SongList &songs, const QList<QFileInfo> &new_files, const std::optional<int> new_collection_directory_id);
 
  protected:
   void timerEvent(QTimerEvent *e) override;
 
  private Q_SLOTS:
   void ProcessSomeFiles();
-  void FileTranscoded(const QString &input, const QString &output, const bool success);
+  void FileTranscoded(const QString &input, const QString &output, const bool success, const qint64 elapsed_msec);
   void LogLine(const QString &message);
 
  private:
@@ -105,15 +108,31 @@ class Organize : public QObject {
     NewSongInfo song_info_;
     float transcode_progress_;
     QString transcoded_filename_;
+    QString transcode_cache_key_;
     QString new_extension_;
     Song::FileType new_filetype_;
   };
 
+  // Time spent and bytes processed in one stage, summed over all files.
+  struct StageStatistics {
+    int files = 0;
+    qint64 bytes = 0;
+    qint64 msec = 0;
+  };
+
+  static void AddStatistics(StageStatistics *statistics, const qint64 bytes, const qint64 msec);
+  static QString StatisticsText(const QString &stage, const StageStatistics &statistics);
+  void LogStatistics();
+
+  void CopyFinished(const Task &task, const Song &song, const bool success, const QString &error_text);
+  void FlushSongsPathChanged();
+
   QThread *thread_;
   QThread *original_thread_;
   const SharedPtr<TaskManager> task_manager_;
   const SharedPtr<TagReaderClient> tagreader_client_;
   Transcoder *transcoder_;
+  TranscodeCache transcode_cache_;
   QTimer *process_files_timer_;
   const SharedPtr<MusicStorage> destination_;
   QList<Song::FileType> supported_filetypes_;
@@ -126,6 +145,10 @@ class Organize : public QObject {
   quint64 task_count_;
   const QString playlist_;
 
+  // Files are copied on the pool while the next files are transcoded, when the destination supports concurrent copies.
+  QThreadPool *copy_thread_pool_;
+  int copies_running_;
+
   QBasicTimer transcode_progress_timer_;
   QList<Task> tasks_pending_;
   QMap<QString, Task> tasks_transcoding_;
@@ -137,6 +160,15 @@ class Organize : public QObject {
   int current_copy_progress_;
   bool finished_;
 
+  // Moved collection songs, sent to the collection backend together after each batch.
+  SongList songs_path_changed_;
+  QList<QFileInfo> songs_path_changed_files_;
+
+  QElapsedTimer elapsed_timer_;
+  StageStatistics statistics_transcode_;
+  StageStatistics statistics_cover_;
+  StageStatistics statistics_copy_;
+
   QStringList files_with_errors_;
   QStringList log_;
 };
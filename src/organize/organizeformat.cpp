@@ -21,6 +21,11 @@
 
 #include "config.h"
 
+#include <algorithm>
+#include <utility>
+
+#include <QList>
+#include <QHash>
 #include <QString>
 #include <QChar>
 #include <QStringList>
@@ -38,6 +43,10 @@
 
 using namespace Qt::Literals::StringLiterals;
 
+namespace {
+constexpr qsizetype kMaxTransliterateCacheSize = 10000;
+}  // namespace
+
 const char OrganizeFormat::kBlockPattern[] = "\\{([^{}]+)\\}";
 const char OrganizeFormat::kTagPattern[] = "\\%([a-zA-Z]*)";
 
@@ -71,11 +80,16 @@ OrganizeFormat::OrganizeFormat(const QString &format)
       remove_non_fat_(false),
       remove_non_ascii_(false),
       allow_ascii_ext_(false),
-      replace_spaces_(true) {}
+      replace_spaces_(true) {
+
+  Compile();
+
+}
 
 void OrganizeFormat::set_format(const QString &v) {
   format_ = v;
   format_.replace(u'\\', u'/');
+  Compile();
 }
 
 bool OrganizeFormat::IsValid() const {
@@ -90,11 +104,16 @@ bool OrganizeFormat::IsValid() const {
 
 OrganizeFormat::GetFilenameForSongResult OrganizeFormat::GetFilenameForSong(const Song &song, QString extension) const {
 
+  // Tag values and literals are transliterated separately, so repeated values are only transliterated once.
+  const auto basefilename = [this, &song]() { return transliterate() ? Transliterate(song.basefilename()) : song.basefilename(); };
+
   bool unique_filename = false;
-  QString filepath = ParseBlock(format_, song, &unique_filename);
+  QString filepath;
+  filepath.reserve(format_.length() * 4);
+  Evaluate(0, tokens_.count(), song, filepath, &unique_filename);
 
   if (filepath.isEmpty()) {
-    filepath = song.basefilename();
+    filepath = basefilename();
   }
 
   {
@@ -110,7 +129,7 @@ OrganizeFormat::GetFilenameForSongResult OrganizeFormat::GetFilenameForSong(cons
           filepath.append(u'/');
         }
       }
-      filepath.append(song.basefilename());
+      filepath.append(basefilename());
     }
   }
 
@@ -122,7 +141,6 @@ OrganizeFormat::GetFilenameForSongResult OrganizeFormat::GetFilenameForSong(cons
     static const QRegularExpression regex_problematic_characters(QLatin1String(kProblematicCharactersRegex), QRegularExpression::PatternOption::CaseInsensitiveOption);
     filepath = filepath.remove(regex_problematic_characters);
   }
-  if (remove_non_fat_ || (remove_non_ascii_ && !allow_ascii_ext_)) filepath = Utilities::Transliterate(filepath);
   if (remove_non_fat_) {
     static const QRegularExpression regex_invalid_fat_characters(QLatin1String(kInvalidFatCharactersRegex), QRegularExpression::PatternOption::CaseInsensitiveOption);
     filepath = filepath.remove(regex_invalid_fat_characters);
@@ -196,125 +214,204 @@ OrganizeFormat::GetFilenameForSongResult OrganizeFormat::GetFilenameForSong(cons
 
 }
 
-QString OrganizeFormat::ParseBlock(QString block, const Song &song, bool *have_tagdata, bool *any_empty) const {
-
-  // Find any blocks first
-  qint64 pos = 0;
-  static const QRegularExpression block_regexp(QString::fromLatin1(kBlockPattern));
-  QRegularExpressionMatch re_match;
-  for (re_match = block_regexp.match(block, pos); re_match.hasMatch(); re_match = block_regexp.match(block, pos)) {
-    pos = re_match.capturedStart();
-    // Recursively parse the block
-    bool empty = false;
-    QString value = ParseBlock(re_match.captured(1), song, have_tagdata, &empty);
-    if (empty) value = ""_L1;
-
-    // Replace the block's value
-    block.replace(pos, re_match.capturedLength(), value);
-    pos += value.length();
-  }
+void OrganizeFormat::Compile() {
 
-  // Now look for tags
-  bool empty = false;
-  pos = 0;
-  static const QRegularExpression tag_regexp(QString::fromLatin1(kTagPattern));
-  for (re_match = tag_regexp.match(block, pos); re_match.hasMatch(); re_match = tag_regexp.match(block, pos)) {
-    pos = re_match.capturedStart();
-    const QString tag = re_match.captured(1);
-    const QString value = TagValue(tag, song);
-    if (value.isEmpty()) {
-      empty = true;
+  tokens_.clear();
+
+  QList<qsizetype> open_blocks;
+  bool literal_open = false;
+  for (qsizetype i = 0; i < format_.length(); ++i) {
+    const QChar c = format_[i];
+    if (c == u'{') {
+      open_blocks << tokens_.count();
+      tokens_ << Token { Token::Type::Block, QString(), Tag::Unknown, 0 };
+      literal_open = false;
     }
-    else if (have_tagdata && kUniqueTags.contains(tag)) {
-      *have_tagdata = true;
+    else if (c == u'}' && !open_blocks.isEmpty()) {
+      const qsizetype block = open_blocks.takeLast();
+      if (block == tokens_.count() - 1) {
+        // Empty blocks are kept as text.
+        tokens_[block] = Token { Token::Type::Literal, u"{}"_s, Tag::Unknown, 0 };
+        literal_open = true;
+      }
+      else {
+        tokens_[block].end = tokens_.count();
+        literal_open = false;
+      }
+    }
+    else if (c == u'%') {
+      qsizetype end = i + 1;
+      while (end < format_.length() && ((format_[end] >= u'a' && format_[end] <= u'z') || (format_[end] >= u'A' && format_[end] <= u'Z'))) {
+        ++end;
+      }
+      tokens_ << Token { Token::Type::Tag, QString(), TagFromName(format_.mid(i + 1, end - i - 1)), 0 };
+      literal_open = false;
+      i = end - 1;
     }
+    else if (literal_open) {
+      tokens_.last().literal.append(c);
+    }
+    else {
+      tokens_ << Token { Token::Type::Literal, QString(c), Tag::Unknown, 0 };
+      literal_open = true;
+    }
+  }
 
-    block.replace(pos, re_match.capturedLength(), value);
-    pos += value.length();
+  // Unclosed blocks are kept as text, their contents belong to the enclosing block.
+  for (const qsizetype block : std::as_const(open_blocks)) {
+    tokens_[block] = Token { Token::Type::Literal, u"{"_s, Tag::Unknown, 0 };
   }
 
-  if (any_empty) {
-    *any_empty = empty;
+}
+
+bool OrganizeFormat::Evaluate(const qsizetype begin, const qsizetype end, const Song &song, QString &output, bool *have_tagdata) const {
+
+  const bool transliterate_values = transliterate();
+
+  bool any_empty = false;
+  qsizetype i = begin;
+  while (i < end) {
+    const Token &token = tokens_[i];
+    switch (token.type) {
+      case Token::Type::Literal:
+        output.append(transliterate_values ? Transliterate(token.literal) : token.literal);
+        ++i;
+        break;
+      case Token::Type::Tag:{
+        const QString value = TagValue(token.tag, song);
+        if (value.isEmpty()) {
+          any_empty = true;
+        }
+        else {
+          if (have_tagdata && (token.tag == Tag::Title || token.tag == Tag::Track)) {
+            *have_tagdata = true;
+          }
+          output.append(transliterate_values ? Transliterate(value) : value);
+        }
+        ++i;
+        break;
+      }
+      case Token::Type::Block:{
+        // Evaluated in place, and removed again if it turns out empty.
+        const qsizetype block_start = output.length();
+        if (Evaluate(i + 1, token.end, song, output, have_tagdata)) {
+          output.truncate(block_start);
+        }
+        i = token.end;
+        break;
+      }
+    }
   }
 
-  return block;
+  return any_empty;
+
+}
+
+OrganizeFormat::Tag OrganizeFormat::TagFromName(const QString &name) {
+
+  if (name == "title"_L1) return Tag::Title;
+  if (name == "album"_L1) return Tag::Album;
+  if (name == "artist"_L1) return Tag::Artist;
+  if (name == "artistinitial"_L1) return Tag::ArtistInitial;
+  if (name == "albumartist"_L1) return Tag::AlbumArtist;
+  if (name == "composer"_L1) return Tag::Composer;
+  if (name == "track"_L1) return Tag::Track;
+  if (name == "disc"_L1) return Tag::Disc;
+  if (name == "year"_L1) return Tag::Year;
+  if (name == "originalyear"_L1) return Tag::OriginalYear;
+  if (name == "genre"_L1) return Tag::Genre;
+  if (name == "comment"_L1) return Tag::Comment;
+  if (name == "length"_L1) return Tag::Length;
+  if (name == "bitrate"_L1) return Tag::Bitrate;
+  if (name == "samplerate"_L1) return Tag::Samplerate;
+  if (name == "bitdepth"_L1) return Tag::Bitdepth;
+  if (name == "extension"_L1) return Tag::Extension;
+  if (name == "performer"_L1) return Tag::Performer;
+  if (name == "grouping"_L1) return Tag::Grouping;
+  if (name == "lyrics"_L1) return Tag::Lyrics;
+
+  return Tag::Unknown;
 
 }
 
-QString OrganizeFormat::TagValue(const QString &tag, const Song &song) const {
+QString OrganizeFormat::TagValue(const Tag tag, const Song &song) const {
 
   QString value;
 
-  if (tag == "title"_L1) {
-    value = song.title();
-  }
-  else if (tag == "album"_L1) {
-    value = song.album();
-  }
-  else if (tag == "artist"_L1) {
-    value = song.artist();
-  }
-  else if (tag == "composer"_L1) {
-    value = song.composer();
-  }
-  else if (tag == "performer"_L1) {
-    value = song.performer();
-  }
-  else if (tag == "grouping"_L1) {
-    value = song.grouping();
-  }
-  else if (tag == "lyrics"_L1) {
-    value = song.lyrics();
-  }
-  else if (tag == "genre"_L1) {
-    value = song.genre();
-  }
-  else if (tag == "comment"_L1) {
-    value = song.comment();
-  }
-  else if (tag == "year"_L1) {
-    value = QString::number(song.year());
-  }
-  else if (tag == "originalyear"_L1) {
-    value = QString::number(song.effective_originalyear());
-  }
-  else if (tag == "track"_L1) {
-    value = QString::number(song.track());
-  }
-  else if (tag == "disc"_L1) {
-    value = QString::number(song.disc());
-  }
-  else if (tag == "length"_L1) {
-    value = QString::number(song.length_nanosec() / kNsecPerSec);
-  }
-  else if (tag == "bitrate"_L1) {
-    value = QString::number(song.bitrate());
-  }
-  else if (tag == "samplerate"_L1) {
-    value = QString::number(song.samplerate());
-  }
-  else if (tag == "bitdepth"_L1) {
-    value = QString::number(song.bitdepth());
-  }
-  else if (tag == "extension"_L1) {
-    value = QFileInfo(song.url().toLocalFile()).suffix();
-  }
-  else if (tag == "artistinitial"_L1) {
-    value = song.effective_albumartist().trimmed();
-    if (!value.isEmpty()) {
-      static const QRegularExpression regex_the(u"^the\\s+"_s, QRegularExpression::CaseInsensitiveOption);
-      value = value.remove(regex_the);
-      value = value[0].toUpper();
-    }
-  }
-  else if (tag == "albumartist"_L1) {
-    value = song.is_compilation() ? u"Various Artists"_s : song.effective_albumartist();
+  switch (tag) {
+    case Tag::Unknown:
+      break;
+    case Tag::Title:
+      value = song.title();
+      break;
+    case Tag::Album:
+      value = song.album();
+      break;
+    case Tag::Artist:
+      value = song.artist();
+      break;
+    case Tag::Composer:
+      value = song.composer();
+      break;
+    case Tag::Performer:
+      value = song.performer();
+      break;
+    case Tag::Grouping:
+      value = song.grouping();
+      break;
+    case Tag::Lyrics:
+      value = song.lyrics();
+      break;
+    case Tag::Genre:
+      value = song.genre();
+      break;
+    case Tag::Comment:
+      value = song.comment();
+      break;
+    case Tag::Year:
+      value = QString::number(song.year());
+      break;
+    case Tag::OriginalYear:
+      value = QString::number(song.effective_originalyear());
+      break;
+    case Tag::Track:
+      value = QString::number(song.track());
+      break;
+    case Tag::Disc:
+      value = QString::number(song.disc());
+      break;
+    case Tag::Length:
+      value = QString::number(song.length_nanosec() / kNsecPerSec);
+      break;
+    case Tag::Bitrate:
+      value = QString::number(song.bitrate());
+      break;
+    case Tag::Samplerate:
+      value = QString::number(song.samplerate());
+      break;
+    case Tag::Bitdepth:
+      value = QString::number(song.bitdepth());
+      break;
+    case Tag::Extension:
+      value = QFileInfo(song.url().toLocalFile()).suffix();
+      break;
+    case Tag::ArtistInitial:
+      value = song.effective_albumartist().trimmed();
+      if (!value.isEmpty()) {
+        static const QRegularExpression regex_the(u"^the\\s+"_s, QRegularExpression::CaseInsensitiveOption);
+        value = value.remove(regex_the);
+        value = value[0].toUpper();
+      }
+      break;
+    case Tag::AlbumArtist:
+      value = song.is_compilation() ? u"Various Artists"_s : song.effective_albumartist();
+      break;
   }
 
   if (value == u'0' || value == "-1"_L1) value = ""_L1;
 
   // Prepend a 0 to single-digit track numbers
-  if (tag == "track"_L1 && value.length() == 1) value.prepend(u'0');
+  if (tag == Tag::Track && value.length() == 1) value.prepend(u'0');
 
   // Replace characters that really shouldn't be in paths
   static const QRegularExpression regex_invalid_dir_characters(QString::fromLatin1(kInvalidDirCharactersRegex), QRegularExpression::PatternOption::CaseInsensitiveOption);
@@ -325,3 +422,26 @@ QString OrganizeFormat::TagValue(const QString &tag, const Song &song) const {
   return value;
 
 }
+
+QString OrganizeFormat::Transliterate(const QString &value) const {
+
+  // The transliterator leaves plain ASCII as is.
+  if (std::all_of(value.begin(), value.end(), [](const QChar c) { return c.unicode() < 128; })) {
+    return value;
+  }
+
+  const QHash<QString, QString>::const_iterator it = transliterate_cache_.constFind(value);
+  if (it != transliterate_cache_.constEnd()) {
+    return it.value();
+  }
+
+  if (transliterate_cache_.count() >= kMaxTransliterateCacheSize) {
+    transliterate_cache_.clear();
+  }
+
+  const QString transliterated = Utilities::Transliterate(value);
+  transliterate_cache_.insert(value, transliterated);
+
+  return transliterated;
+
+}
@@ -22,6 +22,8 @@
 #ifndef ORGANISEFORMAT_H
 #define ORGANISEFORMAT_H
 
+#include <QList>
+#include <QHash>
 #include <QString>
 #include <QStringList>
 
@@ -61,15 +63,60 @@ class OrganizeFormat {
   GetFilenameForSongResult GetFilenameForSong(const Song &song, QString extension = QString()) const;
 
  private:
-  QString ParseBlock(QString block, const Song &song, bool *have_tagdata = nullptr, bool *any_empty = nullptr) const;
-  QString TagValue(const QString &tag, const Song &song) const;
+  enum class Tag {
+    Unknown,
+    Title,
+    Album,
+    Artist,
+    ArtistInitial,
+    AlbumArtist,
+    Composer,
+    Track,
+    Disc,
+    Year,
+    OriginalYear,
+    Genre,
+    Comment,
+    Length,
+    Bitrate,
+    Samplerate,
+    Bitdepth,
+    Extension,
+    Performer,
+    Grouping,
+    Lyrics
+  };
+
+  // The format is compiled once into a flat list of tokens.
+  // A block token covers the tokens up to end, it is left out when one of its own tags is empty.
+  struct Token {
+    enum class Type {
+      Literal,
+      Tag,
+      Block
+    };
+    Type type;
+    QString literal;
+    Tag tag;
+    qsizetype end;
+  };
+
+  void Compile();
+  bool Evaluate(const qsizetype begin, const qsizetype end, const Song &song, QString &output, bool *have_tagdata) const;
+  static Tag TagFromName(const QString &name);
+  QString TagValue(const Tag tag, const Song &song) const;
+  bool transliterate() const { return remove_non_fat_ || (remove_non_ascii_ && !allow_ascii_ext_); }
+  QString Transliterate(const QString &value) const;
 
   QString format_;
+  QList<Token> tokens_;
   bool remove_problematic_;
   bool remove_non_fat_;
   bool remove_non_ascii_;
   bool allow_ascii_ext_;
   bool replace_spaces_;
+  // Artist and album names repeat for many songs.
+  mutable QHash<QString, QString> transliterate_cache_;
 };
 
 #endif  // ORGANISEFORMAT_H
@@ -50,12 +50,15 @@
 #include <QSettings>
 #include <QFlags>
 #include <QtEvents>
+#include <QFuture>
+#include <QFutureWatcher>
 
 #ifdef HAVE_QPA_QPLATFORMNATIVEINTERFACE
 #  include <qpa/qplatformnativeinterface.h>
 #endif
 
 #include "core/settings.h"
+#include "core/taskexecutor.h"
 #include "constants/notificationssettings.h"
 
 #include "osdpretty.h"
@@ -92,7 +95,10 @@ OSDPretty::OSDPretty(const Mode mode, QWidget *parent)
       timeout_(new QTimer(this)),
       fading_enabled_(false),
       fader_(new QTimeLine(300, this)),
-      toggle_mode_(false) {
+      toggle_mode_(false),
+      chrome_opacity_(0.0),
+      icon_image_key_(0),
+      message_serial_(0) {
 
   setWindowTitle(u"OSDPretty"_s);
   setWindowFlags(Qt::FramelessWindowHint | Qt::WindowStaysOnTopHint | Qt::X11BypassWindowManagerHint);
@@ -137,10 +143,10 @@ OSDPretty::OSDPretty(const Mode mode, QWidget *parent)
   QImage shadow_corner(u":/pictures/osd_shadow_corner.png"_s);
   for (int i = 0; i < 4; ++i) {
     QTransform rotation = QTransform().rotate(90 * i);
-    shadow_edge_[i] = QPixmap::fromImage(shadow_edge.transformed(rotation));
-    shadow_corner_[i] = QPixmap::fromImage(shadow_corner.transformed(rotation));
+    shadow_edge_[i] = shadow_edge.transformed(rotation);
+    shadow_corner_[i] = shadow_corner.transformed(rotation);
   }
-  background_ = QPixmap(u":/pictures/osd_background.png"_s);
+  background_ = QImage(u":/pictures/osd_background.png"_s);
 
   // Set the margins to allow for the drop shadow
   QBoxLayout *l = qobject_cast<QBoxLayout*>(layout());
@@ -288,35 +294,69 @@ void OSDPretty::ReloadSettings() {
 }
 
 QRect OSDPretty::BoxBorder() const {
-  return rect().adjusted(kDropShadowSize, kDropShadowSize, -kDropShadowSize, -kDropShadowSize);
+  return BoxBorder(size());
 }
 
-void OSDPretty::paintEvent(QPaintEvent *e) {
+QRect OSDPretty::BoxBorder(const QSize size) {
+  return QRect(QPoint(0, 0), size).adjusted(kDropShadowSize, kDropShadowSize, -kDropShadowSize, -kDropShadowSize);
+}
 
-  Q_UNUSED(e)
+OSDPretty::ChromeStyle OSDPretty::chrome_style() const {
 
-  QPainter p(this);
+  ChromeStyle style;
+  style.background_color = background_color_;
+  style.background_opacity = background_opacity_;
+  for (int i = 0; i < 4; ++i) {
+    style.shadow_edge[i] = shadow_edge_[i];
+    style.shadow_corner[i] = shadow_corner_[i];
+  }
+  style.background = background_;
+
+  return style;
+
+}
+
+bool OSDPretty::IsChromeValid(const QSize size) const {
+
+  return !chrome_.isNull() && chrome_.deviceIndependentSize().toSize() == size && chrome_.devicePixelRatio() == devicePixelRatioF() && chrome_color_ == background_color_ && chrome_opacity_ == background_opacity_;
+
+}
+
+QImage OSDPretty::RenderChrome(const QSize size, const qreal device_pixel_ratio, const ChromeStyle &style) {
+
+  QImage image(size * device_pixel_ratio, QImage::Format_ARGB32_Premultiplied);
+  image.setDevicePixelRatio(device_pixel_ratio);
+  image.fill(Qt::transparent);
+
+  QPainter p(&image);
   p.setRenderHint(QPainter::Antialiasing);
 
-  QRect box(BoxBorder());
+  const int width = size.width();
+  const int height = size.height();
+  const QRect box(BoxBorder(size));
 
   // Shadow corners
   const int kShadowCornerSize = kDropShadowSize + kBorderRadius;
-  p.drawPixmap(0, 0, shadow_corner_[0]);
-  p.drawPixmap(width() - kShadowCornerSize, 0, shadow_corner_[1]);
-  p.drawPixmap(width() - kShadowCornerSize, height() - kShadowCornerSize, shadow_corner_[2]);
-  p.drawPixmap(0, height() - kShadowCornerSize, shadow_corner_[3]);
-
-  // Shadow edges
-  p.drawTiledPixmap(kShadowCornerSize, 0, width() - kShadowCornerSize * 2, kDropShadowSize, shadow_edge_[0]);
-  p.drawTiledPixmap(width() - kDropShadowSize, kShadowCornerSize, kDropShadowSize, height() - kShadowCornerSize * 2, shadow_edge_[1]);
-  p.drawTiledPixmap(kShadowCornerSize, height() - kDropShadowSize, width() - kShadowCornerSize * 2, kDropShadowSize, shadow_edge_[2]);
-  p.drawTiledPixmap(0, kShadowCornerSize, kDropShadowSize, height() - kShadowCornerSize * 2, shadow_edge_[3]);
+  p.drawImage(0, 0, style.shadow_corner[0]);
+  p.drawImage(width - kShadowCornerSize, 0, style.shadow_corner[1]);
+  p.drawImage(width - kShadowCornerSize, height - kShadowCornerSize, style.shadow_corner[2]);
+  p.drawImage(0, height - kShadowCornerSize, style.shadow_corner[3]);
+
+  // Shadow edges, tiled from the top left corner of each edge.
+  const auto draw_tiled = [&p](const QRect &rect, const QImage &tile) {
+    QBrush brush(tile);
+    brush.setTransform(QTransform::fromTranslate(rect.x(), rect.y()));
+    p.fillRect(rect, brush);
+  };
+  draw_tiled(QRect(kShadowCornerSize, 0, width - kShadowCornerSize * 2, kDropShadowSize), style.shadow_edge[0]);
+  draw_tiled(QRect(width - kDropShadowSize, kShadowCornerSize, kDropShadowSize, height - kShadowCornerSize * 2), style.shadow_edge[1]);
+  draw_tiled(QRect(kShadowCornerSize, height - kDropShadowSize, width - kShadowCornerSize * 2, kDropShadowSize), style.shadow_edge[2]);
+  draw_tiled(QRect(0, kShadowCornerSize, kDropShadowSize, height - kShadowCornerSize * 2), style.shadow_edge[3]);
 
   // Box background
-  p.setBrush(background_color_);
+  p.setBrush(style.background_color);
   p.setPen(QPen());
-  p.setOpacity(background_opacity_);
+  p.setOpacity(style.background_opacity);
   p.drawRoundedRect(box, kBorderRadius, kBorderRadius);
 
   // Background pattern
@@ -324,11 +364,11 @@ void OSDPretty::paintEvent(QPaintEvent *e) {
   background_path.addRoundedRect(box, kBorderRadius, kBorderRadius);
   p.setClipPath(background_path);
   p.setOpacity(1.0);
-  p.drawPixmap(box.right() - background_.width(), box.bottom() - background_.height(), background_);
+  p.drawImage(box.right() - style.background.width(), box.bottom() - style.background.height(), style.background);
   p.setClipping(false);
 
   // Gradient overlay
-  QLinearGradient gradient(0, 0, 0, height());
+  QLinearGradient gradient(0, 0, 0, height);
   gradient.setColorAt(0, QColor(255, 255, 255, 130));
   gradient.setColorAt(1, QColor(255, 255, 255, 50));
   p.setBrush(gradient);
@@ -336,17 +376,62 @@ void OSDPretty::paintEvent(QPaintEvent *e) {
 
   // Box border
   p.setBrush(QBrush());
-  p.setPen(QPen(background_color_.darker(150), 2));
+  p.setPen(QPen(style.background_color.darker(150), 2));
   p.drawRoundedRect(box, kBorderRadius, kBorderRadius);
 
+  p.end();
+
+  return image;
+
+}
+
+void OSDPretty::paintEvent(QPaintEvent *e) {
+
+  Q_UNUSED(e)
+
+  // Normally rendered ahead on the worker thread, but the size can still change while the OSD is shown.
+  if (!IsChromeValid(size())) {
+    chrome_ = QPixmap::fromImage(RenderChrome(size(), devicePixelRatioF(), chrome_style()));
+    chrome_color_ = background_color_;
+    chrome_opacity_ = background_opacity_;
+  }
+
+  QPainter p(this);
+  p.drawPixmap(0, 0, chrome_);
+
+}
+
+bool OSDPretty::IsIconValid(const QImage &image) const {
+
+  return !icon_.isNull() && icon_image_key_ == image.cacheKey() && icon_.devicePixelRatio() == devicePixelRatioF();
+
+}
+
+QImage OSDPretty::ScaleIcon(const QImage &image, const qreal device_pixel_ratio) {
+
+  QImage scaled_image = image.scaled(static_cast<int>(kMaxIconSize * device_pixel_ratio), static_cast<int>(kMaxIconSize * device_pixel_ratio), Qt::KeepAspectRatio, Qt::SmoothTransformation);
+  scaled_image.setDevicePixelRatio(device_pixel_ratio);
+  return scaled_image;
+
 }
 
 void OSDPretty::SetMessage(const QString &summary, const QString &message, const QImage &image) {
 
-  if (!image.isNull()) {
-    QImage scaled_image = image.scaled(static_cast<int>(kMaxIconSize * devicePixelRatioF()), static_cast<int>(kMaxIconSize * devicePixelRatioF()), Qt::KeepAspectRatio, Qt::SmoothTransformation);
-    scaled_image.setDevicePixelRatio(devicePixelRatioF());
-    ui_->icon->setPixmap(QPixmap::fromImage(scaled_image));
+  ++message_serial_;
+
+  if (!image.isNull() && !IsIconValid(image)) {
+    icon_ = QPixmap::fromImage(ScaleIcon(image, devicePixelRatioF()));
+    icon_image_key_ = image.cacheKey();
+  }
+
+  ApplyMessage(summary, message, !image.isNull());
+
+}
+
+void OSDPretty::ApplyMessage(const QString &summary, const QString &message, const bool show_icon) {
+
+  if (show_icon) {
+    ui_->icon->setPixmap(icon_);
     ui_->icon->show();
   }
   else {
@@ -363,7 +448,59 @@ void OSDPretty::SetMessage(const QString &summary, const QString &message, const
 // Set the desired message and then show the OSD
 void OSDPretty::ShowMessage(const QString &summary, const QString &message, const QImage &image) {
 
-  SetMessage(summary, message, image);
+  const quint64 serial = ++message_serial_;
+
+  if (image.isNull() || IsIconValid(image)) {
+    ApplyMessage(summary, message, !image.isNull());
+    PrepareChrome(serial);
+    return;
+  }
+
+  QFutureWatcher<QImage> *watcher = new QFutureWatcher<QImage>(this);
+  QObject::connect(watcher, &QFutureWatcher<QImage>::finished, this, [this, watcher, serial, summary, message, image_key = image.cacheKey()]() {
+    const QImage scaled_image = watcher->result();
+    watcher->deleteLater();
+    if (serial != message_serial_) return;
+    icon_ = QPixmap::fromImage(scaled_image);
+    icon_image_key_ = image_key;
+    ApplyMessage(summary, message, true);
+    PrepareChrome(serial);
+  });
+  watcher->setFuture(TaskExecutor::Run(TaskExecutor::Lane::Interactive, &OSDPretty::ScaleIcon, image, devicePixelRatioF()));
+
+}
+
+void OSDPretty::PrepareChrome(const quint64 serial) {
+
+  // A visible OSD is repainted with the new size right away.
+  if (isVisible()) {
+    ShowPreparedMessage();
+    return;
+  }
+
+  layout()->activate();
+  const QSize chrome_size = sizeHint();
+  if (IsChromeValid(chrome_size)) {
+    ShowPreparedMessage();
+    return;
+  }
+
+  const ChromeStyle style = chrome_style();
+  QFutureWatcher<QImage> *watcher = new QFutureWatcher<QImage>(this);
+  QObject::connect(watcher, &QFutureWatcher<QImage>::finished, this, [this, watcher, serial, style]() {
+    const QImage chrome = watcher->result();
+    watcher->deleteLater();
+    if (serial != message_serial_) return;
+    chrome_ = QPixmap::fromImage(chrome);
+    chrome_color_ = style.background_color;
+    chrome_opacity_ = style.background_opacity;
+    ShowPreparedMessage();
+  });
+  watcher->setFuture(TaskExecutor::Run(TaskExecutor::Lane::Interactive, &OSDPretty::RenderChrome, chrome_size, devicePixelRatioF(), style));
+
+}
+
+void OSDPretty::ShowPreparedMessage() {
 
   if (isVisible() && mode_ == Mode::Popup) {
     // The OSD is already visible, toggle or restart the timer
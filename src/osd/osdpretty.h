@@ -35,6 +35,7 @@
 #include <QFont>
 #include <QPoint>
 #include <QRect>
+#include <QSize>
 #include <QRgb>
 
 class QScreen;
@@ -115,6 +116,24 @@ class OSDPretty : public QWidget {
   void Load();
 
   QRect BoxBorder() const;
+  static QRect BoxBorder(const QSize size);
+
+  // The cover is scaled and the box with its drop shadow rendered on a worker thread, the message is shown when both are ready.
+  struct ChromeStyle {
+    QColor background_color;
+    qreal background_opacity;
+    QImage shadow_edge[4];
+    QImage shadow_corner[4];
+    QImage background;
+  };
+  ChromeStyle chrome_style() const;
+  bool IsChromeValid(const QSize size) const;
+  static QImage RenderChrome(const QSize size, const qreal device_pixel_ratio, const ChromeStyle &style);
+  bool IsIconValid(const QImage &image) const;
+  static QImage ScaleIcon(const QImage &image, const qreal device_pixel_ratio);
+  void ApplyMessage(const QString &summary, const QString &message, const bool show_icon);
+  void PrepareChrome(const quint64 serial);
+  void ShowPreparedMessage();
 
  private Q_SLOTS:
   void FaderValueChanged(const qreal value);
@@ -138,10 +157,22 @@ class OSDPretty : public QWidget {
   // The OSD is kept always on top until you click (no timer)
   bool disable_duration_;
 
-  // Cached pixmaps
-  QPixmap shadow_edge_[4];
-  QPixmap shadow_corner_[4];
-  QPixmap background_;
+  // Images used to render the box, kept as images so they can be used from the worker thread.
+  QImage shadow_edge_[4];
+  QImage shadow_corner_[4];
+  QImage background_;
+
+  // The rendered box and the colors it was rendered with.
+  QPixmap chrome_;
+  QColor chrome_color_;
+  qreal chrome_opacity_;
+
+  // The scaled cover and the cache key of the image it was scaled from.
+  QPixmap icon_;
+  qint64 icon_image_key_;
+
+  // Incremented for each message, so results for older messages are dropped.
+  quint64 message_serial_;
 
   // For dragging the OSD
   QPoint original_window_pos_;
@@ -29,10 +29,16 @@
 #include <unordered_map>
 #include <random>
 #include <chrono>
+#include <numeric>
+#include <optional>
 
+#include <QtGlobal>
+#include <QtAlgorithms>
 #include <QObject>
 #include <QCoreApplication>
 #include <QtConcurrentRun>
+#include <QtConcurrentTask>
+#include <QtConcurrentMap>
 #include <QFuture>
 #include <QFutureWatcher>
 #include <QIODevice>
@@ -48,6 +54,8 @@
 #include <QString>
 #include <QStringList>
 #include <QUrl>
+#include <QCollator>
+#include <QCollatorSortKey>
 #include <QFont>
 #include <QBrush>
 #include <QUndoStack>
@@ -60,10 +68,13 @@
 
 #include "includes/shared_ptr.h"
 #include "core/logging.h"
+#include "core/tracing.h"
 #include "core/mimedata.h"
 #include "core/song.h"
 #include "core/settings.h"
+#include "core/settingsstore.h"
 #include "core/songmimedata.h"
+#include "core/taskmanager.h"
 #include "constants/timeconstants.h"
 #include "constants/playlistsettings.h"
 #include "tagreader/tagreaderclient.h"
@@ -81,6 +92,7 @@
 #include "playlistitemmimedata.h"
 #include "songloaderinserter.h"
 #include "songplaylistitem.h"
+#include "playlistundocommandbase.h"
 #include "playlistundocommandinsertitems.h"
 #include "playlistundocommandremoveitems.h"
 #include "playlistundocommandmoveitems.h"
@@ -122,6 +134,14 @@ constexpr qint64 kMaxScrobblePointNsecs = 240LL * kNsecPerSec;
 
 constexpr int kMaxPlayedIndexes = 100;
 
+// Default number of items the undo stack may keep alive in total.
+constexpr qint64 kDefaultUndoItemBudget = 1000000;
+
+// Above this many changed columns in a row, dataChanged() is emitted for the whole row.
+constexpr int kMaxSeparateColumnChanges = 5;
+static_assert(Playlist::ColumnCount <= 64, "Changed columns must fit in a 64 bit mask");
+constexpr quint64 kAllColumnsMask = Playlist::ColumnCount == 64 ? ~quint64(0) : (quint64(1) << Playlist::ColumnCount) - 1;
+
 }  // namespace
 
 Playlist::Playlist(const SharedPtr<TaskManager> task_manager,
@@ -138,6 +158,7 @@ Playlist::Playlist(const SharedPtr<TaskManager> task_manager,
       filter_(new PlaylistFilter(this)),
       queue_(new Queue(this, this)),
       timer_save_(new QTimer(this)),
+      timer_data_changed_(new QTimer(this)),
       task_manager_(task_manager),
       url_handlers_(url_handlers),
       playlist_backend_(playlist_backend),
@@ -156,13 +177,26 @@ Playlist::Playlist(const SharedPtr<TaskManager> task_manager,
       scrobble_point_(-1),
       auto_sort_(false),
       sort_column_(Column::Title),
-      sort_order_(Qt::AscendingOrder) {
+      sort_order_(Qt::AscendingOrder),
+      undo_item_budget_(kDefaultUndoItemBudget) {
 
   undo_stack_->setUndoLimit(kUndoStackSize);
 
+  undo_item_budget_ = SettingsStore::Instance()->Value(PlaylistSettings::kSettingsGroup, PlaylistSettings::kUndoItemBudget, kDefaultUndoItemBudget).toLongLong();
+  SettingsStore::Instance()->Watch(PlaylistSettings::kSettingsGroup, PlaylistSettings::kUndoItemBudget, this, [this](const QVariant &value) {
+    undo_item_budget_ = value.isValid() ? value.toLongLong() : kDefaultUndoItemBudget;
+  });
+
   QObject::connect(this, &Playlist::rowsInserted, this, &Playlist::PlaylistChanged);
   QObject::connect(this, &Playlist::rowsRemoved, this, &Playlist::PlaylistChanged);
 
+  // Pending dataChanged() signals refer to row numbers, so flush them before the rows move.
+  QObject::connect(this, &Playlist::rowsAboutToBeInserted, this, &Playlist::EmitPendingDataChanged);
+  QObject::connect(this, &Playlist::rowsAboutToBeRemoved, this, &Playlist::EmitPendingDataChanged);
+  QObject::connect(this, &Playlist::rowsAboutToBeMoved, this, &Playlist::EmitPendingDataChanged);
+  QObject::connect(this, &Playlist::layoutAboutToBeChanged, this, &Playlist::EmitPendingDataChanged);
+  QObject::connect(this, &Playlist::modelAboutToBeReset, this, &Playlist::EmitPendingDataChanged);
+
   Restore();
 
   filter_->setSourceModel(this);
@@ -173,6 +207,7 @@ Playlist::Playlist(const SharedPtr<TaskManager> task_manager,
 
   QObject::connect(queue_, &Queue::rowsInserted, this, &Playlist::TracksEnqueued);
 
+  QObject::connect(queue_, &Queue::rowsMoved, this, &Playlist::QueueRowsMoved);
   QObject::connect(queue_, &Queue::layoutChanged, this, &Playlist::QueueLayoutChanged);
 
   QObject::connect(timer_save_, &QTimer::timeout, this, &Playlist::Save);
@@ -182,6 +217,10 @@ Playlist::Playlist(const SharedPtr<TaskManager> task_manager,
   timer_save_->setSingleShot(true);
   timer_save_->setInterval(900ms);
 
+  timer_data_changed_->setSingleShot(true);
+  timer_data_changed_->setInterval(0ms);
+  QObject::connect(timer_data_changed_, &QTimer::timeout, this, &Playlist::EmitPendingDataChanged);
+
 }
 
 Playlist::~Playlist() {
@@ -194,8 +233,12 @@ void Playlist::InsertSongItems(const SongList &songs, const int pos, const bool
 
   PlaylistItemPtrList items;
   items.reserve(songs.count());
+  QSet<QString> strings;
+  QSet<QUrl> urls;
   for (const Song &song : songs) {
-    items << make_shared<T>(song);
+    PlaylistItemPtr item = make_shared<T>(song);
+    item->ShareStrings(strings, urls);
+    items << item;
   }
 
   InsertItems(items, pos, play_now, enqueue, enqueue_next);
@@ -476,6 +519,7 @@ bool Playlist::setData(const QModelIndex &idx, const QVariant &value, const int
   }
   else if (song.is_stream()) {
     item->SetOriginalMetadata(song);
+    UpdateItemStatistics(item);
     Q_EMIT dataChanged(index(row, 0), index(row, ColumnCount - 1));
     Q_EMIT EditingFinished(id_, idx);
     ScheduleSave();
@@ -557,7 +601,43 @@ void Playlist::ShuffleModeChanged(const PlaylistSequence::ShuffleMode shuffle_mo
 bool Playlist::FilterContainsVirtualIndex(const int i) const {
   if (i < 0 || i >= virtual_items_.count()) return false;
 
-  return filter_->filterAcceptsRow(virtual_items_[i], QModelIndex());
+  if (filter_->filter_string().isEmpty()) return true;
+
+  // The proxy already knows which rows it accepted, looking up the mapping is much cheaper than evaluating the filter again.
+  return filter_->mapFromSource(index(virtual_items_[i], 0)).isValid();
+}
+
+int Playlist::VirtualIndexOfRow(const int row) const {
+
+  if (row < 0 || row >= virtual_items_.count()) return -1;
+
+  // The reverse mapping is validated on lookup and rebuilt when it's out of date, so it doesn't have to be maintained everywhere virtual_items_ is changed.
+  if (virtual_index_of_row_.count() != virtual_items_.count() || virtual_index_of_row_[row] < 0 || virtual_index_of_row_[row] >= virtual_items_.count() || virtual_items_[virtual_index_of_row_[row]] != row) {
+    virtual_index_of_row_.fill(-1, virtual_items_.count());
+    for (int i = 0; i < virtual_items_.count(); ++i) {
+      const int virtual_item = virtual_items_[i];
+      if (virtual_item >= 0 && virtual_item < virtual_index_of_row_.count()) {
+        virtual_index_of_row_[virtual_item] = i;
+      }
+    }
+  }
+
+  return virtual_index_of_row_[row];
+
+}
+
+void Playlist::RemapVirtualItems(const PlaylistItemPtrList &old_items) {
+
+  QHash<const PlaylistItem*, int> new_rows;
+  new_rows.reserve(items_.count());
+  for (int i = 0; i < items_.count(); ++i) {
+    new_rows.insert(&*items_[i], i);
+  }
+
+  for (int &virtual_item : virtual_items_) {
+    virtual_item = new_rows.value(&*old_items[virtual_item], -1);
+  }
+
 }
 
 int Playlist::NextVirtualIndex(int i, const bool ignore_repeat_track) const {
@@ -760,11 +840,11 @@ void Playlist::set_current_row(const int i, const AutoScroll autoscroll, const b
     // For shuffle modes that need to preserve track order within albums, don't move the track
     if (ShuffleMode() == PlaylistSequence::ShuffleMode::Albums || ShuffleMode() == PlaylistSequence::ShuffleMode::InsideAlbum || ShuffleMode() == PlaylistSequence::ShuffleMode::Grouping) {
       // Just find where the track ended up after ReshuffleIndices
-      const int idx = static_cast<int>(virtual_items_.indexOf(i));
+      const int idx = VirtualIndexOfRow(i);
       current_virtual_index_ = idx == -1 ? 0 : idx;
     }
     else {
-      const int idx = static_cast<int>(virtual_items_.indexOf(i));
+      const int idx = VirtualIndexOfRow(i);
       if (idx != -1) {
         virtual_items_.takeAt(idx);
         virtual_items_.prepend(i);
@@ -773,7 +853,7 @@ void Playlist::set_current_row(const int i, const AutoScroll autoscroll, const b
     }
   }
   else if (ShuffleMode() != PlaylistSequence::ShuffleMode::Off) {
-    current_virtual_index_ = static_cast<int>(virtual_items_.indexOf(i));
+    current_virtual_index_ = VirtualIndexOfRow(i);
   }
   else {
     current_virtual_index_ = i;
@@ -879,7 +959,10 @@ bool Playlist::dropMimeData(const QMimeData *data, Qt::DropAction action, const
 
   if (const SongMimeData *song_data = qobject_cast<const SongMimeData*>(data)) {
     // Dragged from a collection
-    if (song_data->backend && Song::IsLinkedCollectionSource(song_data->backend->source())) {
+    if (song_data->lazy()) {
+      InsertLazySongs(song_data, row, play_now, enqueue_now, enqueue_next_now);
+    }
+    else if (song_data->backend && Song::IsLinkedCollectionSource(song_data->backend->source())) {
       InsertSongItems<CollectionPlaylistItem>(song_data->songs, row, play_now, enqueue_now, enqueue_next_now);
     }
     else {
@@ -961,6 +1044,32 @@ bool Playlist::dropMimeData(const QMimeData *data, Qt::DropAction action, const
 
 }
 
+void Playlist::InsertLazySongs(const SongMimeData *song_data, const int pos, const bool play_now, const bool enqueue, const bool enqueue_next) {
+
+  const bool collection_items = song_data->backend && Song::IsLinkedCollectionSource(song_data->backend->source());
+
+  // The mime data is deleted after the drop, only the future is kept.
+  const int task_id = task_manager_ ? task_manager_->StartTask(tr("Loading tracks")) : -1;
+  QFutureWatcher<SongList> *watcher = new QFutureWatcher<SongList>(this);
+  QObject::connect(watcher, &QFutureWatcher<SongList>::finished, this, [this, watcher, task_id, collection_items, pos, play_now, enqueue, enqueue_next]() {
+    const SongList songs = watcher->result();
+    watcher->deleteLater();
+    if (task_id != -1) {
+      task_manager_->SetTaskFinished(task_id);
+    }
+    // Rows might have been removed in the meantime.
+    const int insert_pos = pos > items_.count() ? -1 : pos;
+    if (collection_items) {
+      InsertSongItems<CollectionPlaylistItem>(songs, insert_pos, play_now, enqueue, enqueue_next);
+    }
+    else {
+      InsertSongItems<SongPlaylistItem>(songs, insert_pos, play_now, enqueue, enqueue_next);
+    }
+  });
+  watcher->setFuture(song_data->ResolveSongs());
+
+}
+
 void Playlist::InsertUrls(const QList<QUrl> &urls, const int pos, const bool play_now, const bool enqueue, const bool enqueue_next) {
 
   SongLoaderInserter *inserter = new SongLoaderInserter(task_manager_, tagreader_client_, url_handlers_, collection_backend_);
@@ -1004,81 +1113,38 @@ void Playlist::MoveItemWithoutUndo(const int source, const int dest) {
 
 void Playlist::MoveItemsWithoutUndo(const QList<int> &source_rows, int pos) {
 
-  Q_EMIT layoutAboutToBeChanged();
-
-  PlaylistItemPtrList old_items = items_;
-  PlaylistItemPtrList moved_items;
-  moved_items.reserve(source_rows.count());
-
-  if (pos < 0) {
-    pos = static_cast<int>(items_.count());
+  const int count = static_cast<int>(items_.count());
+  if (pos < 0 || pos > count) {
+    pos = count;
   }
 
-  // Take the items out of the list first, keeping track of whether the insertion point changes
-  int offset = 0;
-  int start = pos;
+  QList<bool> moved(count, false);
   for (const int source_row : source_rows) {
-    moved_items << items_.takeAt(source_row - offset);
-    if (pos > source_row) {
-      --start;
-    }
-    ++offset;
+    moved[source_row] = true;
   }
 
-  // Put the items back in
-  for (int i = start; i < start + moved_items.count(); ++i) {
-    moved_items[i - start]->RemoveForegroundColor(kDynamicHistoryPriority);
-    items_.insert(i, moved_items[i - start]);
+  // The other items keep their order, the moved items go in before pos in the given order.
+  QList<int> order;
+  order.reserve(count);
+  for (int row = 0; row < pos; ++row) {
+    if (!moved[row]) order << row;
   }
-
-  // Update persistent indexes
-  const QModelIndexList pidx_list = persistentIndexList();
-  for (const QModelIndex &pidx : pidx_list) {
-    const int dest_offset = static_cast<int>(source_rows.indexOf(pidx.row()));
-    if (dest_offset != -1) {
-      // This index was moved
-      changePersistentIndex(pidx, index(start + dest_offset, pidx.column(), QModelIndex()));
-    }
-    else {
-      int d = 0;
-      for (int source_row : source_rows) {
-        if (pidx.row() > source_row) d--;
-      }
-      if (pidx.row() + d >= start) d += static_cast<int>(source_rows.count());
-
-      changePersistentIndex(pidx, index(pidx.row() + d, pidx.column(), QModelIndex()));
-    }
-  }
-
-  // Update virtual items
-  if (ShuffleMode() != PlaylistSequence::ShuffleMode::Off) {
-    const QList<int> old_virtual_items = virtual_items_;
-    for (int i = 0; i < virtual_items_.count(); ++i) {
-      virtual_items_[i] = static_cast<int>(items_.indexOf(old_items[old_virtual_items[i]]));
-    }
-  }
-
-  // Update current virtual index
-  if (current_item_index_.isValid()) {
-    current_virtual_index_ = static_cast<int>(virtual_items_.indexOf(current_item_index_.row()));
+  for (const int source_row : source_rows) {
+    items_[source_row]->RemoveForegroundColor(kDynamicHistoryPriority);
+    order << source_row;
   }
-  else {
-    current_virtual_index_ = -1;
+  for (int row = pos; row < count; ++row) {
+    if (!moved[row]) order << row;
   }
 
-  Q_EMIT layoutChanged();
-
-  ScheduleSave();
+  RearrangeItemsWithoutUndo(order);
 
 }
 
 void Playlist::MoveItemsWithoutUndo(int start, const QList<int> &dest_rows) {
 
-  Q_EMIT layoutAboutToBeChanged();
-
-  PlaylistItemPtrList old_items = items_;
-  PlaylistItemPtrList moved_items;
-  moved_items.reserve(dest_rows.count());
+  const int count = static_cast<int>(items_.count());
+  const int moved_count = static_cast<int>(dest_rows.count());
 
   int pos = start;
   for (const int dest_row : dest_rows) {
@@ -1086,54 +1152,98 @@ void Playlist::MoveItemsWithoutUndo(int start, const QList<int> &dest_rows) {
   }
 
   if (start < 0) {
-    start = static_cast<int>(items_.count() - dest_rows.count());
+    start = count - moved_count;
   }
 
-  // Take the items out of the list first
-  for (int i = 0; i < dest_rows.count(); ++i) {
-    moved_items << items_.takeAt(start);
+  // The moved items are at start, put them back in their rows and fill the remaining rows with the other items in order.
+  QList<int> order(count, -1);
+  for (int i = 0; i < moved_count; ++i) {
+    order[dest_rows[i]] = start + i;
   }
-
-  // Put the items back in
-  int offset = 0;
-  for (int dest_row : dest_rows) {
-    items_.insert(dest_row, moved_items[offset]);
-    offset++;
+  int row = 0;
+  for (int &old_row : order) {
+    if (old_row != -1) continue;
+    if (row == start) row += moved_count;
+    old_row = row++;
   }
 
-  // Update persistent indexes
-  const QModelIndexList pidx_list = persistentIndexList();
-  for (const QModelIndex &pidx : pidx_list) {
-    if (pidx.row() >= start && pidx.row() < start + dest_rows.count()) {
-      // This index was moved
-      const int i = pidx.row() - start;
-      changePersistentIndex(pidx, index(dest_rows[i], pidx.column(), QModelIndex()));
-    }
-    else {
-      int d = 0;
-      if (pidx.row() >= start + dest_rows.count()) {
-        d -= static_cast<int>(dest_rows.count());
-      }
+  RearrangeItemsWithoutUndo(order);
 
-      for (int dest_row : dest_rows) {
-        if (pidx.row() + d > dest_row) d++;
-      }
+}
 
-      changePersistentIndex(pidx, index(pidx.row() + d, pidx.column(), QModelIndex()));
+PlaylistItemPtrList Playlist::RearrangeItemsWithoutUndo(const QList<int> &order) {
+
+  Q_EMIT layoutAboutToBeChanged();
+
+  const int old_count = static_cast<int>(items_.count());
+
+  // Old row -> new row, or -1 when the item is removed.
+  QList<int> new_rows(old_count, -1);
+  PlaylistItemPtrList new_items;
+  new_items.reserve(order.count());
+  for (const int old_row : order) {
+    new_rows[old_row] = static_cast<int>(new_items.count());
+    new_items << items_[old_row];
+  }
+
+  PlaylistItemPtrList removed_items;
+  removed_items.reserve(old_count - new_items.count());
+  int first_removed_row = -1;
+  for (int row = 0; row < old_count; ++row) {
+    if (new_rows[row] != -1) continue;
+    if (first_removed_row == -1) first_removed_row = row;
+    const PlaylistItemPtr &item = items_[row];
+    removed_items << item;
+    RemoveItemStatistics(item);
+    const int id = item->EffectiveMetadata().id();
+    const int source_id = item->EffectiveMetadata().source_id();
+    if (id != -1 && collection_items_[source_id].contains(id, item)) {
+      collection_items_[source_id].remove(id, item);
     }
   }
 
+  items_ = new_items;
+
   // Update virtual items
-  if (ShuffleMode() != PlaylistSequence::ShuffleMode::Off) {
-    const QList<int> old_virtual_items = virtual_items_;
-    for (int i = 0; i < virtual_items_.count(); ++i) {
-      virtual_items_[i] = static_cast<int>(items_.indexOf(old_items[old_virtual_items[i]]));
+  QList<int> virtual_items;
+  virtual_items.reserve(items_.count());
+  if (ShuffleMode() == PlaylistSequence::ShuffleMode::Off) {
+    // The virtual items follow the rows, only the removed rows are taken out.
+    QList<int> kept_rows_before(old_count);
+    int kept_rows = 0;
+    for (int row = 0; row < old_count; ++row) {
+      kept_rows_before[row] = kept_rows;
+      if (new_rows[row] != -1) ++kept_rows;
+    }
+    for (const int virtual_item : std::as_const(virtual_items_)) {
+      if (new_rows[virtual_item] != -1) virtual_items << kept_rows_before[virtual_item];
     }
   }
+  else {
+    for (const int virtual_item : std::as_const(virtual_items_)) {
+      if (new_rows[virtual_item] != -1) virtual_items << new_rows[virtual_item];
+    }
+  }
+  virtual_items_ = virtual_items;
+
+  Q_ASSERT(items_.count() == virtual_items_.count());
+
+  // Update persistent indexes
+  const QModelIndexList old_indexes = persistentIndexList();
+  QModelIndexList new_indexes;
+  new_indexes.reserve(old_indexes.count());
+  for (const QModelIndex &idx : old_indexes) {
+    const int new_row = new_rows.value(idx.row(), -1);
+    new_indexes << (new_row == -1 ? QModelIndex() : index(new_row, idx.column(), QModelIndex()));
+  }
+  changePersistentIndexList(old_indexes, new_indexes);
 
   // Update current virtual index
   if (current_item_index_.isValid()) {
-    current_virtual_index_ = static_cast<int>(virtual_items_.indexOf(current_item_index_.row()));
+    current_virtual_index_ = VirtualIndexOfRow(current_item_index_.row());
+  }
+  else if (first_removed_row - 1 > 0 && new_rows[first_removed_row - 1] != -1) {
+    current_virtual_index_ = VirtualIndexOfRow(new_rows[first_removed_row - 1]);
   }
   else {
     current_virtual_index_ = -1;
@@ -1143,6 +1253,8 @@ void Playlist::MoveItemsWithoutUndo(int start, const QList<int> &dest_rows) {
 
   ScheduleSave();
 
+  return removed_items;
+
 }
 
 void Playlist::InsertItems(const PlaylistItemPtrList &itemsIn, const int pos, const bool play_now, const bool enqueue, const bool enqueue_next) {
@@ -1170,6 +1282,8 @@ void Playlist::InsertItems(const PlaylistItemPtrList &itemsIn, const int pos, co
 
 void Playlist::InsertItemsWithoutUndo(const PlaylistItemPtrList &items, const int pos, const bool enqueue, const bool enqueue_next) {
 
+  qTraceScope("Playlist::InsertItemsWithoutUndo");
+
   if (items.isEmpty()) return;
 
   const int start = pos == -1 ? static_cast<int>(items_.count()) : pos;
@@ -1181,6 +1295,7 @@ void Playlist::InsertItemsWithoutUndo(const PlaylistItemPtrList &items, const in
     const PlaylistItemPtr item = items[i - start];
     items_.insert(i, item);
     virtual_items_ << static_cast<int>(virtual_items_.count());
+    AddItemStatistics(item);
 
     if (Song::IsLinkedCollectionSource(item->source())) {
       const int id = item->EffectiveMetadata().id();
@@ -1249,8 +1364,12 @@ void Playlist::InsertSongsOrCollectionItems(const SongList &songs, const QString
 
   PlaylistItemPtrList items;
   items.reserve(songs.count());
+  QSet<QString> strings;
+  QSet<QUrl> urls;
   for (const Song &song : songs) {
-    items << PlaylistItem::NewFromSong(song);
+    PlaylistItemPtr item = PlaylistItem::NewFromSong(song);
+    item->ShareStrings(strings, urls);
+    items << item;
   }
 
   InsertItems(items, pos, play_now, enqueue, enqueue_next);
@@ -1285,51 +1404,60 @@ void Playlist::UpdateItems(SongList songs) {
 
   qLog(Debug) << "Updating playlist with new tracks' info";
 
-  // We first convert our songs list into a linked list (a 'real' list), because removals are faster with QLinkedList.
-  // Next, we walk through the list of playlist's items then the list of songs
-  // we want to update: if an item corresponds to the song (we rely on URL for this), we update the item with the new metadata,
-  // then we remove song from our list because we will not need to check it again.
+  // We first index the songs we want to update by URL, keeping their order for songs sharing the same URL.
+  // Next, we walk through the list of playlist's items: if an item corresponds to a song (we rely on URL for this),
+  // we update the item with the new metadata, then we take the song out of the index because we will not need to check it again.
   // And we also update undo actions.
 
-  for (int i = 0; i < items_.size(); i++) {
+  QHash<QUrl, SongList> songs_by_url;
+  songs_by_url.reserve(songs.count());
+  for (const Song &song : std::as_const(songs)) {
+    songs_by_url[song.url()] << song;
+  }
+
+  for (int i = 0; i < items_.size() && !songs_by_url.isEmpty(); i++) {
     // Update current items list
-    QMutableListIterator<Song> it(songs);
-    while (it.hasNext()) {
-      const Song &song = it.next();
-      const PlaylistItemPtr item = items_.value(i);
-      if (item->EffectiveMetadata().url() == song.url() && (item->EffectiveMetadata().filetype() == Song::FileType::Unknown || item->EffectiveMetadata().filetype() == Song::FileType::Stream || item->EffectiveMetadata().filetype() == Song::FileType::CDDA || !item->EffectiveMetadata().init_from_file())) {
-        PlaylistItemPtr new_item;
-        if (song.is_linked_collection_song()) {
-          new_item = make_shared<CollectionPlaylistItem>(song);
-          if (collection_items_[song.source_id()].contains(song.id(), item)) collection_items_[song.source_id()].remove(song.id(), item);
-          collection_items_[song.source_id()].insert(song.id(), new_item);
+    const PlaylistItemPtr item = items_.value(i);
+    const Song &metadata = item->EffectiveMetadata();
+    if (metadata.filetype() != Song::FileType::Unknown && metadata.filetype() != Song::FileType::Stream && metadata.filetype() != Song::FileType::CDDA && metadata.init_from_file()) {
+      continue;
+    }
+    QHash<QUrl, SongList>::iterator it = songs_by_url.find(metadata.url());
+    if (it == songs_by_url.end()) continue;
+    const Song song = it->takeFirst();
+    if (it->isEmpty()) {
+      songs_by_url.erase(it);
+    }
+    PlaylistItemPtr new_item;
+    if (song.is_linked_collection_song()) {
+      new_item = make_shared<CollectionPlaylistItem>(song);
+      if (collection_items_[song.source_id()].contains(song.id(), item)) collection_items_[song.source_id()].remove(song.id(), item);
+      collection_items_[song.source_id()].insert(song.id(), new_item);
+    }
+    else {
+      if (song.url().isLocalFile()) {
+        new_item = make_shared<SongPlaylistItem>(song);
+      }
+      else {
+        if (song.is_radio()) {
+          new_item = make_shared<RadioStreamPlaylistItem>(song);
         }
         else {
-          if (song.url().isLocalFile()) {
-            new_item = make_shared<SongPlaylistItem>(song);
-          }
-          else {
-            if (song.is_radio()) {
-              new_item = make_shared<RadioStreamPlaylistItem>(song);
-            }
-            else {
-              new_item = make_shared<StreamServicePlaylistItem>(song);
-            }
-          }
-        }
-        items_[i] = new_item;
-        Q_EMIT dataChanged(index(i, 0), index(i, ColumnCount - 1));
-        // Also update undo actions
-        for (int y = 0; y < undo_stack_->count(); y++) {
-          QUndoCommand *undo_action = const_cast<QUndoCommand*>(undo_stack_->command(i));
-          PlaylistUndoCommandInsertItems *undo_action_insert = dynamic_cast<PlaylistUndoCommandInsertItems*>(undo_action);
-          if (undo_action_insert) {
-            bool found_and_updated = undo_action_insert->UpdateItem(new_item);
-            if (found_and_updated) break;
-          }
+          new_item = make_shared<StreamServicePlaylistItem>(song);
         }
-        it.remove();
-        break;
+      }
+    }
+    RemoveItemStatistics(item);
+    items_[i] = new_item;
+    AddItemStatistics(new_item);
+    QueueDataChanged(i, kAllColumnsMask);
+    // Also update undo actions
+    for (int y = 0; y < undo_stack_->count(); y++) {
+      QUndoCommand *undo_action = const_cast<QUndoCommand*>(undo_stack_->command(y));
+      PlaylistUndoCommandInsertItems *undo_action_insert = dynamic_cast<PlaylistUndoCommandInsertItems*>(undo_action);
+      if (undo_action_insert) {
+        bool found_and_updated = undo_action_insert->UpdateItem(new_item);
+        if (found_and_updated) break;
       }
     }
   }
@@ -1531,6 +1659,84 @@ QString Playlist::abbreviated_column_name(const Column column) {
 
 }
 
+namespace {
+
+constexpr int kSortChunkSize = 2000;
+
+// The text CompareItems() compares for the column, or nothing for columns that aren't sorted as text.
+std::optional<QString> ColumnSortText(const Playlist::Column column, const PlaylistItemPtr &item) {
+
+  const Song song = item->EffectiveMetadata();
+
+  switch (column) {
+    case Playlist::Column::Title:           return song.effective_titlesort();
+    case Playlist::Column::TitleSort:       return song.titlesort();
+    case Playlist::Column::Artist:          return song.effective_artistsort();
+    case Playlist::Column::ArtistSort:      return song.artistsort();
+    case Playlist::Column::Album:           return song.effective_albumsort();
+    case Playlist::Column::AlbumSort:       return song.albumsort();
+    case Playlist::Column::Genre:           return song.genre();
+    case Playlist::Column::AlbumArtist:     return song.playlist_effective_albumartistsort();
+    case Playlist::Column::AlbumArtistSort: return song.albumartistsort();
+    case Playlist::Column::Composer:        return song.effective_composersort();
+    case Playlist::Column::ComposerSort:    return song.composersort();
+    case Playlist::Column::Performer:       return song.effective_performersort();
+    case Playlist::Column::PerformerSort:   return song.performersort();
+    case Playlist::Column::Grouping:        return song.grouping();
+    case Playlist::Column::URL:             return item->OriginalUrl().path();
+    case Playlist::Column::Comment:         return song.comment();
+    case Playlist::Column::Mood:            return song.mood();
+    case Playlist::Column::InitialKey:      return song.initial_key();
+    default:
+      break;
+  }
+
+  return std::nullopt;
+
+}
+
+void SortItems(PlaylistItemPtrList::iterator begin, PlaylistItemPtrList::iterator end, const Playlist::Column column, const Qt::SortOrder order) {
+
+  const int count = static_cast<int>(end - begin);
+  if (count < 2) return;
+
+  if (!ColumnSortText(column, *begin).has_value()) {
+    std::stable_sort(begin, end, std::bind(&Playlist::CompareItems, column, order, std::placeholders::_1, std::placeholders::_2));
+    return;
+  }
+
+  // Create the collation keys once per item in parallel, instead of lowercasing and collating both strings in every comparison.
+  QList<std::optional<QCollatorSortKey>> sort_keys(count);
+  QList<int> chunks;
+  for (int i = 0; i < count; i += kSortChunkSize) {
+    chunks << i;
+  }
+  QtConcurrent::blockingMap(chunks, [begin, count, column, &sort_keys](const int start) {
+    // QCollator is not thread-safe, use one per chunk.
+    QCollator collator;
+    const int chunk_end = std::min(start + kSortChunkSize, count);
+    for (int i = start; i < chunk_end; ++i) {
+      sort_keys[i] = collator.sortKey(ColumnSortText(column, *(begin + i)).value_or(QString()).toLower());
+    }
+  });
+
+  QList<int> sorted_indexes(count);
+  std::iota(sorted_indexes.begin(), sorted_indexes.end(), 0);
+  std::stable_sort(sorted_indexes.begin(), sorted_indexes.end(), [&sort_keys, order](const int a, const int b) {
+    return order == Qt::AscendingOrder ? sort_keys[a]->compare(*sort_keys[b]) < 0 : sort_keys[b]->compare(*sort_keys[a]) < 0;
+  });
+
+  PlaylistItemPtrList sorted_items;
+  sorted_items.reserve(count);
+  for (const int i : std::as_const(sorted_indexes)) {
+    sorted_items << *(begin + i);
+  }
+  std::copy(sorted_items.begin(), sorted_items.end(), begin);
+
+}
+
+}  // namespace
+
 void Playlist::sort(const int column_number, const Qt::SortOrder order) {
 
   const Column column = static_cast<Column>(column_number);
@@ -1548,15 +1754,41 @@ void Playlist::sort(const int column_number, const Qt::SortOrder order) {
 
   if (column == Column::Album) {
     // When sorting by album, also take into account discs and tracks.
-    std::stable_sort(begin, new_items.end(), std::bind(&Playlist::CompareItems, Column::Track, order, std::placeholders::_1, std::placeholders::_2));
-    std::stable_sort(begin, new_items.end(), std::bind(&Playlist::CompareItems, Column::Disc, order, std::placeholders::_1, std::placeholders::_2));
-    std::stable_sort(begin, new_items.end(), std::bind(&Playlist::CompareItems, Column::Album, order, std::placeholders::_1, std::placeholders::_2));
+    SortItems(begin, new_items.end(), Column::Track, order);
+    SortItems(begin, new_items.end(), Column::Disc, order);
+    SortItems(begin, new_items.end(), Column::Album, order);
   }
   else {
-    std::stable_sort(begin, new_items.end(), std::bind(&Playlist::CompareItems, column, order, std::placeholders::_1, std::placeholders::_2));
+    SortItems(begin, new_items.end(), column, order);
+  }
+
+  PushUndoCommand(new PlaylistUndoCommandSortItems(this, column, order, new_items));
+
+}
+
+void Playlist::PushUndoCommand(PlaylistUndoCommandBase *command) {
+
+  const qint64 item_count = command->item_count();
+
+  if (item_count > undo_item_budget_) {
+    // Too big to keep in the undo stack. Also clear the stack because it might have been invalidated.
+    command->redo();
+    delete command;
+    undo_stack_->clear();
+    return;
   }
 
-  undo_stack_->push(new PlaylistUndoCommandSortItems(this, column, order, new_items));
+  // QUndoStack can not drop single commands from the bottom, so start over when the budget is exceeded.
+  qint64 total_item_count = item_count;
+  for (int i = 0; i < undo_stack_->count(); ++i) {
+    const PlaylistUndoCommandBase *undo_command = dynamic_cast<const PlaylistUndoCommandBase*>(undo_stack_->command(i));
+    if (undo_command) total_item_count += undo_command->item_count();
+  }
+  if (total_item_count > undo_item_budget_) {
+    undo_stack_->clear();
+  }
+
+  undo_stack_->push(command);
 
 }
 
@@ -1580,15 +1812,12 @@ void Playlist::ReOrderWithoutUndo(const PlaylistItemPtrList &new_items) {
 
   // Update virtual items
   if (ShuffleMode() != PlaylistSequence::ShuffleMode::Off) {
-    const QList<int> old_virtual_items = virtual_items_;
-    for (int i = 0; i < virtual_items_.count(); ++i) {
-      virtual_items_[i] = static_cast<int>(items_.indexOf(old_items[old_virtual_items[i]]));
-    }
+    RemapVirtualItems(old_items);
   }
 
   // Update current virtual index
   if (current_item_index_.isValid()) {
-    current_virtual_index_ = static_cast<int>(virtual_items_.indexOf(current_item_index_.row()));
+    current_virtual_index_ = VirtualIndexOfRow(current_item_index_.row());
   }
   else {
     current_virtual_index_ = -1;
@@ -1662,9 +1891,16 @@ void Playlist::Restore() {
   items_.clear();
   virtual_items_.clear();
   ClearCollectionItems();
+  ClearStatistics();
+
+  // Restore the playlist that was current first, so the visible tab is usable while the background tabs are still loading.
+  Settings s;
+  s.beginGroup(PlaylistSettings::kSettingsGroup);
+  const bool current = s.value(PlaylistSettings::kCurrentPlaylist, 1).toInt() == id_;
+  s.endGroup();
 
   cancel_restore_ = false;
-  QFuture<PlaylistItemPtrList> future = QtConcurrent::run(&PlaylistBackend::GetPlaylistItems, playlist_backend_, id_);
+  QFuture<PlaylistItemPtrList> future = QtConcurrent::task([playlist_backend = playlist_backend_, id = id_]() { return playlist_backend->GetPlaylistItems(id); }).withPriority(current ? 1 : 0).spawn();
   QFutureWatcher<PlaylistItemPtrList> *watcher = new QFutureWatcher<PlaylistItemPtrList>();
   QObject::connect(watcher, &QFutureWatcher<PlaylistItemPtrList>::finished, this, &Playlist::ItemsLoaded);
   watcher->setFuture(future);
@@ -1682,6 +1918,8 @@ void Playlist::ClearCollectionItems() {
 
 void Playlist::ItemsLoaded() {
 
+  qTraceScope("Playlist::ItemsLoaded");
+
   QFutureWatcher<PlaylistItemPtrList> *watcher = static_cast<QFutureWatcher<PlaylistItemPtrList>*>(sender());
   PlaylistItemPtrList items = watcher->result();
   watcher->deleteLater();
@@ -1739,26 +1977,10 @@ void Playlist::ItemsLoaded() {
 
 }
 
-static bool DescendingIntLessThan(const int a, const int b) { return a > b; }
-
 void Playlist::RemoveItemsWithoutUndo(const QList<int> &indicesIn) {
 
-  // Sort the indices descending because removing elements 'backwards' is easier - indices don't 'move' in the process.
-  QList<int> indices = indicesIn;
-  std::sort(indices.begin(), indices.end(), DescendingIntLessThan);
-
-  for (int j = 0; j < indices.count(); j++) {
-    int beginning = indices[j], end = indices[j];
-
-    // Splits the indices into sequences. For example this: [1, 2, 4], will get split into [1, 2] and [4].
-    while (j != indices.count() - 1 && indices[j] == indices[j + 1] + 1) {
-      beginning--;
-      j++;
-    }
-
-    // Remove the current sequence.
-    removeRows(beginning, end - beginning + 1);
-  }
+  QList<int> rows = indicesIn;
+  removeRows(rows);
 
 }
 
@@ -1789,29 +2011,48 @@ bool Playlist::removeRows(QList<int> &rows) {
     return false;
   }
 
-  // Start from the end to be sure that indices won't 'move' during the removal process
-  std::sort(rows.begin(), rows.end(), std::greater<int>());
+  std::sort(rows.begin(), rows.end());
+  rows.erase(std::unique(rows.begin(), rows.end()), rows.end());
 
-  QList<int> part;
-  while (!rows.isEmpty()) {
-    // We're splitting the input list into sequences of consecutive numbers
-    part.append(rows.takeFirst());
-    while (!rows.isEmpty() && rows.first() == part.last() - 1) {
-      part.append(rows.takeFirst());
-    }
+  if (rows.first() < 0 || rows.last() >= items_.count()) {
+    return false;
+  }
 
-    // And now we're removing the current sequence
-    if (!removeRows(part.last(), static_cast<int>(part.size()))) {
-      return false;
-    }
+  // A single range is removed as such, anything else in one pass.
+  if (rows.last() - rows.first() + 1 == rows.count()) {
+    return removeRows(rows.first(), static_cast<int>(rows.count()));
+  }
 
-    part.clear();
+  if (rows.count() > kUndoItemLimit) {
+    // Too big to keep in the undo stack. Also clear the stack because it might have been invalidated.
+    RemoveRowsWithoutUndo(rows);
+    undo_stack_->clear();
+  }
+  else {
+    undo_stack_->push(new PlaylistUndoCommandRemoveItems(this, rows));
   }
 
   return true;
 
 }
 
+PlaylistItemPtrList Playlist::RemoveRowsWithoutUndo(const QList<int> &rows) {
+
+  QList<bool> remove(items_.count(), false);
+  for (const int row : rows) {
+    if (row >= 0 && row < items_.count()) remove[row] = true;
+  }
+
+  QList<int> order;
+  order.reserve(items_.count());
+  for (int row = 0; row < items_.count(); ++row) {
+    if (!remove[row]) order << row;
+  }
+
+  return RearrangeItemsWithoutUndo(order);
+
+}
+
 PlaylistItemPtrList Playlist::RemoveItemsWithoutUndo(const int row, const int count) {
 
   if (row < 0 || row >= items_.size() || row + count > items_.size()) {
@@ -1820,11 +2061,10 @@ PlaylistItemPtrList Playlist::RemoveItemsWithoutUndo(const int row, const int co
 
   // Remove items
   beginRemoveRows(QModelIndex(), row, row + count - 1);
-  PlaylistItemPtrList items;
-  items.reserve(count);
-  for (int i = 0; i < count; ++i) {
-    PlaylistItemPtr item(items_.takeAt(row));
-    items << item;
+  const PlaylistItemPtrList items = items_.mid(row, count);
+  items_.remove(row, count);
+  for (const PlaylistItemPtr &item : items) {
+    RemoveItemStatistics(item);
     const int id = item->EffectiveMetadata().id();
     const int source_id = item->EffectiveMetadata().source_id();
     if (id != -1 && collection_items_[source_id].contains(id, item)) {
@@ -1832,16 +2072,18 @@ PlaylistItemPtrList Playlist::RemoveItemsWithoutUndo(const int row, const int co
     }
   }
 
-  // Update virtual items
-  for (int i = row; i < items_.count() + count; ++i) {
-    Q_ASSERT(virtual_items_.count(i) == 1);
-    if (i >= row + count) {
-      virtual_items_[virtual_items_.indexOf(i)] = i - count;
+  // Update virtual items, in a single pass since looking up each removed row would be quadratic for large playlists.
+  QList<int> virtual_items;
+  virtual_items.reserve(items_.count());
+  for (const int virtual_item : std::as_const(virtual_items_)) {
+    if (virtual_item >= row + count) {
+      virtual_items << virtual_item - count;
     }
-    else {
-      virtual_items_.removeAt(virtual_items_.indexOf(i));
+    else if (virtual_item < row) {
+      virtual_items << virtual_item;
     }
   }
+  virtual_items_ = virtual_items;
 
   endRemoveRows();
 
@@ -1849,11 +2091,11 @@ PlaylistItemPtrList Playlist::RemoveItemsWithoutUndo(const int row, const int co
 
   // Update current virtual index
   if (current_item_index_.isValid()) {
-    current_virtual_index_ = static_cast<int>(virtual_items_.indexOf(current_item_index_.row()));
+    current_virtual_index_ = VirtualIndexOfRow(current_item_index_.row());
   }
   else {
     if (row - 1 > 0 && row - 1 < items_.size()) {
-      current_virtual_index_ = static_cast<int>(virtual_items_.indexOf(row - 1));
+      current_virtual_index_ = VirtualIndexOfRow(row - 1);
     }
     else {
       current_virtual_index_ = -1;
@@ -1893,6 +2135,7 @@ void Playlist::ClearStreamMetadata() {
   const Song old_metadata = current_item()->EffectiveMetadata();
   current_item()->ClearStreamMetadata();
   const Song &new_metadata = current_item()->EffectiveMetadata();
+  UpdateItemStatistics(current_item());
 
   RowDataChanged(current_row(), ChangedColumns(old_metadata, new_metadata));
 
@@ -2037,7 +2280,7 @@ void Playlist::Shuffle() {
     std::swap(new_items[i], new_items[new_pos]);
   }
 
-  undo_stack_->push(new PlaylistUndoCommandShuffleItems(this, new_items));
+  PushUndoCommand(new PlaylistUndoCommandShuffleItems(this, new_items));
 
 }
 
@@ -2163,7 +2406,7 @@ void Playlist::ReshuffleIndices() {
 
   // Update current virtual index
   if (current_item_index_.isValid()) {
-    current_virtual_index_ = static_cast<int>(virtual_items_.indexOf(current_item_index_.row()));
+    current_virtual_index_ = VirtualIndexOfRow(current_item_index_.row());
   }
   else {
     current_virtual_index_ = -1;
@@ -2196,16 +2439,61 @@ SongList Playlist::GetAllSongs() const {
 
 PlaylistItemPtrList Playlist::GetAllItems() const { return items_; }
 
-quint64 Playlist::GetTotalLength() const {
+Playlist::ItemStatistics Playlist::ItemStatisticsFor(const PlaylistItemPtr &item) {
 
-  quint64 total_length = 0;
-  for (int i = 0; i < items_.count(); ++i) {
-    const PlaylistItemPtr item = items_.at(i);
-    const qint64 length = item->EffectiveMetadata().length_nanosec();
-    if (length > 0) total_length += length;
+  const Song song = item->EffectiveMetadata();
+  return ItemStatistics { std::max(0LL, song.length_nanosec()), std::max(0LL, song.filesize()), song.source(), 0 };
+
+}
+
+void Playlist::ApplyItemStatistics(const ItemStatistics &item_statistics, const int rows) {
+
+  statistics_.length_nanosec += item_statistics.length_nanosec * rows;
+  statistics_.filesize += item_statistics.filesize * rows;
+  statistics_.source_counts[static_cast<int>(item_statistics.source)] += rows;
+
+}
+
+void Playlist::AddItemStatistics(const PlaylistItemPtr &item) {
+
+  QHash<const PlaylistItem*, ItemStatistics>::iterator it = item_statistics_.find(&*item);
+  if (it == item_statistics_.end()) {
+    it = item_statistics_.insert(&*item, ItemStatisticsFor(item));
   }
+  ++it->rows;
+  ApplyItemStatistics(*it, 1);
 
-  return total_length;
+}
+
+void Playlist::RemoveItemStatistics(const PlaylistItemPtr &item) {
+
+  QHash<const PlaylistItem*, ItemStatistics>::iterator it = item_statistics_.find(&*item);
+  if (it == item_statistics_.end()) return;
+
+  ApplyItemStatistics(*it, -1);
+  if (--it->rows == 0) {
+    item_statistics_.erase(it);
+  }
+
+}
+
+void Playlist::UpdateItemStatistics(const PlaylistItemPtr &item) {
+
+  QHash<const PlaylistItem*, ItemStatistics>::iterator it = item_statistics_.find(&*item);
+  if (it == item_statistics_.end()) return;
+
+  ItemStatistics item_statistics = ItemStatisticsFor(item);
+  item_statistics.rows = it->rows;
+  ApplyItemStatistics(*it, -it->rows);
+  ApplyItemStatistics(item_statistics, item_statistics.rows);
+  *it = item_statistics;
+
+}
+
+void Playlist::ClearStatistics() {
+
+  statistics_ = Statistics();
+  item_statistics_.clear();
 
 }
 
@@ -2218,36 +2506,64 @@ void Playlist::TracksAboutToBeDequeued(const QModelIndex &idx, const int begin,
   Q_UNUSED(idx)
 
   for (int i = begin; i <= end; ++i) {
-    temp_dequeue_change_indexes_ << queue_->mapToSource(queue_->index(i, static_cast<int>(Column::Title)));
+    temp_dequeue_change_rows_ << queue_->mapToSource(queue_->index(i, static_cast<int>(Column::Title))).row();
   }
 
 }
 
-void Playlist::TracksDequeued() {
+void Playlist::TracksDequeued(const QModelIndex &parent_idx, const int begin) {
+
+  Q_UNUSED(parent_idx)
 
-  for (const QModelIndex &idx : std::as_const(temp_dequeue_change_indexes_)) {
-    Q_EMIT dataChanged(idx, idx);
+  constexpr quint64 column_mask = quint64(1) << static_cast<int>(Column::Title);
+  for (const int row : std::as_const(temp_dequeue_change_rows_)) {
+    QueueDataChanged(row, column_mask);
   }
-  temp_dequeue_change_indexes_.clear();
+  temp_dequeue_change_rows_.clear();
+
+  // Everything after the removed tracks moved up
+  QueuePositionsChanged(begin);
+
   Q_EMIT QueueChanged();
 
 }
 
-void Playlist::TracksEnqueued(const QModelIndex &parent_idx, const int begin, const int end) {
+void Playlist::TracksEnqueued(const QModelIndex &parent_idx, const int begin) {
 
   Q_UNUSED(parent_idx)
 
-  const QModelIndex &b = queue_->mapToSource(queue_->index(begin, static_cast<int>(Column::Title)));
-  const QModelIndex &e = queue_->mapToSource(queue_->index(end, static_cast<int>(Column::Title)));
-  Q_EMIT dataChanged(b, e);
+  // The new tracks and everything after them
+  QueuePositionsChanged(begin);
+
+}
+
+void Playlist::QueueRowsMoved(const QModelIndex &parent_idx, const int start, const int end, const QModelIndex &destination_idx, const int row) {
+
+  Q_UNUSED(parent_idx)
+  Q_UNUSED(destination_idx)
+
+  // Only the positions between the old and the new place of the block changed
+  if (row > end) {
+    QueuePositionsChanged(start, row - 1);
+  }
+  else {
+    QueuePositionsChanged(row, end);
+  }
 
 }
 
 void Playlist::QueueLayoutChanged() {
 
-  for (int i = 0; i < queue_->rowCount(); ++i) {
-    const QModelIndex idx = queue_->mapToSource(queue_->index(i, static_cast<int>(Column::Title)));
-    Q_EMIT dataChanged(idx, idx);
+  QueuePositionsChanged(0);
+
+}
+
+void Playlist::QueuePositionsChanged(const int first, const int last) {
+
+  constexpr quint64 column_mask = quint64(1) << static_cast<int>(Column::Title);
+  const int queue_last = last == -1 ? queue_->rowCount() - 1 : std::min(last, queue_->rowCount() - 1);
+  for (int i = std::max(0, first); i <= queue_last; ++i) {
+    QueueDataChanged(queue_->mapToSource(queue_->index(i, 0)).row(), column_mask);
   }
 
 }
@@ -2403,7 +2719,11 @@ void Playlist::UpdateItemMetadata(PlaylistItemPtr item, const Song &new_metadata
 
 void Playlist::UpdateItemMetadata(const int row, PlaylistItemPtr item, const Song &new_metadata, const bool stream_metadata_update) {
 
-  if (new_metadata.IsEqual(stream_metadata_update ? item->EffectiveMetadata() : item->OriginalMetadata())) return;
+  if (new_metadata.IsEqual(stream_metadata_update ? item->EffectiveMetadata() : item->OriginalMetadata())) {
+    // The metadata might have been set on the item directly.
+    UpdateItemStatistics(item);
+    return;
+  }
 
   const Song old_metadata = item->EffectiveMetadata();
   const Columns changed_columns = ChangedColumns(old_metadata, new_metadata);
@@ -2418,6 +2738,8 @@ void Playlist::UpdateItemMetadata(const int row, PlaylistItemPtr item, const Son
     }
   }
 
+  UpdateItemStatistics(item);
+
   if (!changed_columns.isEmpty()) {
     RowDataChanged(row, changed_columns);
   }
@@ -2431,20 +2753,86 @@ void Playlist::UpdateItemMetadata(const int row, PlaylistItemPtr item, const Son
 
 }
 
-void Playlist::RowDataChanged(const int row, const Columns &columns) {
+void Playlist::UpdateCollectionItemsArt(const SongList &songs) {
+
+  const PlaylistItemPtr current = current_item();
+  bool current_item_changed = false;
 
-  if (columns.count() > 5) {
-    const QModelIndex idx_column_first = index(row, 0);
-    const QModelIndex idx_column_last = index(row, ColumnCount - 1);
-    if (idx_column_first.isValid() && idx_column_last.isValid()) {
-      Q_EMIT dataChanged(index(row, 0), index(row, ColumnCount - 1));
+  for (const Song &song : songs) {
+    const PlaylistItemPtrList items = collection_items(song.source(), song.id());
+    for (const PlaylistItemPtr &item : items) {
+      if (item->EffectiveMetadata().directory_id() != song.directory_id() || item->OriginalMetadata().IsArtEqual(song)) continue;
+      Song metadata = item->OriginalMetadata();
+      metadata.MergeArt(song);
+      item->SetOriginalMetadata(metadata);
+      if (item->HasStreamMetadata()) {
+        Song stream_metadata = item->EffectiveMetadata();
+        stream_metadata.MergeArt(song);
+        item->SetStreamMetadata(stream_metadata);
+      }
+      if (item == current) {
+        current_item_changed = true;
+      }
     }
   }
-  else {
-    for (const Column &column : columns) {
-      const QModelIndex idx = index(row, static_cast<int>(column));
-      if (idx.isValid()) {
-        Q_EMIT dataChanged(idx, idx);
+
+  // The art has no column, so there is nothing to repaint.
+  if (current_item_changed) {
+    InformOfCurrentSongChange(true);
+  }
+
+}
+
+void Playlist::RowDataChanged(const int row, const Columns &columns) {
+
+  quint64 column_mask = 0;
+  for (const Column &column : columns) {
+    column_mask |= quint64(1) << static_cast<int>(column);
+  }
+  QueueDataChanged(row, column_mask);
+
+}
+
+void Playlist::QueueDataChanged(const int row, const quint64 column_mask) {
+
+  if (row < 0 || row >= items_.count() || column_mask == 0) return;
+
+  pending_data_changed_[row] |= column_mask;
+  if (!timer_data_changed_->isActive()) {
+    timer_data_changed_->start();
+  }
+
+}
+
+void Playlist::EmitPendingDataChanged() {
+
+  timer_data_changed_->stop();
+  if (pending_data_changed_.isEmpty()) return;
+
+  const QMap<int, quint64> pending = std::exchange(pending_data_changed_, QMap<int, quint64>());
+
+  // Merge consecutive rows with the same changed columns into one range.
+  QMap<int, quint64>::const_iterator it = pending.constBegin();
+  while (it != pending.constEnd()) {
+    const int first_row = it.key();
+    const quint64 column_mask = it.value();
+    int last_row = first_row;
+    for (++it; it != pending.constEnd() && it.key() == last_row + 1 && it.value() == column_mask; ++it) {
+      last_row = it.key();
+    }
+    if (last_row >= items_.count()) {
+      last_row = static_cast<int>(items_.count()) - 1;
+    }
+    if (first_row > last_row) continue;
+
+    if (qPopulationCount(column_mask) > kMaxSeparateColumnChanges) {
+      Q_EMIT dataChanged(index(first_row, 0), index(last_row, ColumnCount - 1));
+    }
+    else {
+      for (int column = 0; column < ColumnCount; ++column) {
+        if (column_mask & (quint64(1) << column)) {
+          Q_EMIT dataChanged(index(first_row, column), index(last_row, column));
+        }
       }
     }
   }
@@ -32,7 +32,8 @@
 #include <QFuture>
 #include <QList>
 #include <QMap>
-#include <QMultiMap>
+#include <QHash>
+#include <QMultiHash>
 #include <QMetaType>
 #include <QVariant>
 #include <QString>
@@ -55,12 +56,14 @@ class QUndoStack;
 class QTimer;
 
 class TaskManager;
+class SongMimeData;
 class UrlHandlers;
 class CollectionBackend;
 class PlaylistBackend;
 class PlaylistFilter;
 class Queue;
 class RadioService;
+class PlaylistUndoCommandBase;
 
 namespace PlaylistUndoCommands {
 class InsertItems;
@@ -217,7 +220,11 @@ class Playlist : public QAbstractListModel {
 
   SongList GetAllSongs() const;
   PlaylistItemPtrList GetAllItems() const;
-  quint64 GetTotalLength() const;  // in seconds
+
+  // Totals over all the items, kept up to date as items are inserted, removed or changed.
+  quint64 GetTotalLength() const { return static_cast<quint64>(statistics_.length_nanosec); }  // in nanoseconds
+  quint64 GetTotalFilesize() const { return static_cast<quint64>(statistics_.filesize); }
+  int GetSourceCount(const Song::Source source) const { return statistics_.source_counts[static_cast<int>(source)]; }
 
   void set_sequence(PlaylistSequence *v);
   PlaylistSequence *sequence() const { return playlist_sequence_; }
@@ -275,11 +282,16 @@ class Playlist : public QAbstractListModel {
   bool dropMimeData(const QMimeData *data, Qt::DropAction action, const int row, const int column, const QModelIndex &parent_index) override;
   void sort(const int column_number, const Qt::SortOrder order) override;
   bool removeRows(const int row, const int count, const QModelIndex &parent = QModelIndex()) override;
+  // Removes rows with given indices from this playlist.
+  bool removeRows(QList<int> &rows);
 
   static Columns ChangedColumns(const Song &metadata1, const Song &metadata2);
   static bool MinorMetadataChange(const Song &old_metadata, const Song &new_metadata);
   void UpdateItemMetadata(PlaylistItemPtr item, const Song &new_metadata, const bool stream_metadata_update);
   void UpdateItemMetadata(const int row, PlaylistItemPtr item, const Song &new_metadata, const bool stream_metadata_update);
+  // Updates the art of the collection items for the songs of an album, the current song is informed of the change once.
+  void UpdateCollectionItemsArt(const SongList &songs);
+  // Queues dataChanged() for the given columns, the signals are coalesced and emitted from the event loop.
   void RowDataChanged(const int row, const Columns &columns);
 
   // Changes rating of a song to the given value asynchronously
@@ -344,22 +356,32 @@ class Playlist : public QAbstractListModel {
   int NextVirtualIndex(int i, const bool ignore_repeat_track) const;
   int PreviousVirtualIndex(int i, const bool ignore_repeat_track) const;
   bool FilterContainsVirtualIndex(const int i) const;
+  int VirtualIndexOfRow(const int row) const;
+  // Updates virtual_items_ after items_ was reordered, old_items is the list before reordering.
+  void RemapVirtualItems(const PlaylistItemPtrList &old_items);
 
   template<typename T>
   void InsertSongItems(const SongList &songs, const int pos, const bool play_now, const bool enqueue, const bool enqueue_next = false);
+  // Inserts the songs of a large drag when they are resolved.
+  void InsertLazySongs(const SongMimeData *song_data, const int pos, const bool play_now, const bool enqueue, const bool enqueue_next);
 
   // Modify the playlist without changing the undo stack.  These are used by our friends in PlaylistUndoCommands
   void InsertItemsWithoutUndo(const PlaylistItemPtrList &items, const int pos, const bool enqueue = false, const bool enqueue_next = false);
   PlaylistItemPtrList RemoveItemsWithoutUndo(const int row, const int count);
+  // Removes any set of rows in a single pass, returns the removed items in row order.
+  PlaylistItemPtrList RemoveRowsWithoutUndo(const QList<int> &rows);
   void MoveItemsWithoutUndo(const QList<int> &source_rows, int pos);
   void MoveItemWithoutUndo(const int source, const int dest);
   void MoveItemsWithoutUndo(int start, const QList<int> &dest_rows);
   void ReOrderWithoutUndo(const PlaylistItemPtrList &new_items);
+  // Puts the items in the given order of their current rows in a single layout change, rows left out are removed.
+  // Returns the removed items in row order.
+  PlaylistItemPtrList RearrangeItemsWithoutUndo(const QList<int> &order);
 
-  void RemoveItemsNotInQueue();
+  // Pushes the command to the undo stack, keeping the items held by the stack within undo_item_budget_.
+  void PushUndoCommand(PlaylistUndoCommandBase *command);
 
-  // Removes rows with given indices from this playlist.
-  bool removeRows(QList<int> &rows);
+  void RemoveItemsNotInQueue();
 
   void TurnOnDynamicPlaylist(PlaylistGeneratorPtr gen);
   void InsertDynamicItems(const int count);
@@ -369,10 +391,25 @@ class Playlist : public QAbstractListModel {
 
   void ClearCollectionItems();
 
+  struct ItemStatistics {
+    qint64 length_nanosec;
+    qint64 filesize;
+    Song::Source source;
+    int rows;
+  };
+  static ItemStatistics ItemStatisticsFor(const PlaylistItemPtr &item);
+  void ApplyItemStatistics(const ItemStatistics &item_statistics, const int rows);
+  void AddItemStatistics(const PlaylistItemPtr &item);
+  void RemoveItemStatistics(const PlaylistItemPtr &item);
+  // Updates the totals after the metadata of the item changed.
+  void UpdateItemStatistics(const PlaylistItemPtr &item);
+  void ClearStatistics();
+
  private Q_SLOTS:
   void TracksAboutToBeDequeued(const QModelIndex&, const int begin, const int end);
-  void TracksDequeued();
-  void TracksEnqueued(const QModelIndex &parent_idx, const int begin, const int end);
+  void TracksDequeued(const QModelIndex &parent_idx, const int begin);
+  void TracksEnqueued(const QModelIndex &parent_idx, const int begin);
+  void QueueRowsMoved(const QModelIndex &parent_idx, const int start, const int end, const QModelIndex &destination_idx, const int row);
   void QueueLayoutChanged();
   void SongSaveComplete(TagReaderReplyPtr reply, const QPersistentModelIndex &idx);
   void ItemReloadComplete(const QPersistentModelIndex &idx, const Song &new_metadata, const bool metadata_edit);
@@ -380,14 +417,23 @@ class Playlist : public QAbstractListModel {
   void ScheduleSave();
   void ForceScheduleSave();
   void Save();
+  void EmitPendingDataChanged();
+
+ private:
+  void QueueDataChanged(const int row, const quint64 column_mask);
+  // Repaints the playlist rows of the queue positions first to last, -1 meaning the end of the queue.
+  void QueuePositionsChanged(const int first, const int last = -1);
 
  private:
   bool is_loading_;
   PlaylistFilter *filter_;
   Queue *queue_;
   QTimer *timer_save_;
+  QTimer *timer_data_changed_;
+  // Row -> bitmask of changed columns, flushed by EmitPendingDataChanged().
+  QMap<int, quint64> pending_data_changed_;
 
-  QList<QModelIndex> temp_dequeue_change_indexes_;
+  QList<int> temp_dequeue_change_rows_;
 
   const SharedPtr<TaskManager> task_manager_;
   const SharedPtr<UrlHandlers> url_handlers_;
@@ -403,10 +449,24 @@ class Playlist : public QAbstractListModel {
 
   // Contains the indices into items_ in the order that they will be played.
   QList<int> virtual_items_;
+  // Reverse of virtual_items_, row -> virtual index, see VirtualIndexOfRow().
+  mutable QList<int> virtual_index_of_row_;
 
   QList<QPersistentModelIndex> played_indexes_;
 
-  QMultiMap<int, PlaylistItemPtr> collection_items_[Song::kSourceCount];
+  // Song id -> items, per source.
+  QMultiHash<int, PlaylistItemPtr> collection_items_[Song::kSourceCount];
+
+  struct Statistics {
+    Statistics() : length_nanosec(0), filesize(0), source_counts{} {}
+    qint64 length_nanosec;
+    qint64 filesize;
+    int source_counts[Song::kSourceCount];
+  };
+  Statistics statistics_;
+  // What each item added to the totals, so it can be taken out again when the item changes or is removed.
+  // The same item can be in more than one row.
+  QHash<const PlaylistItem*, ItemStatistics> item_statistics_;
 
   QPersistentModelIndex current_item_index_;
   QPersistentModelIndex last_played_item_index_;
@@ -436,6 +496,8 @@ class Playlist : public QAbstractListModel {
   bool auto_sort_;
   Column sort_column_;
   Qt::SortOrder sort_order_;
+
+  qint64 undo_item_budget_;
 };
 
 #endif  // PLAYLIST_H
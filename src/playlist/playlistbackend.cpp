@@ -23,16 +23,25 @@
 
 #include <utility>
 #include <memory>
+#include <algorithm>
+#include <optional>
 
 #include <QObject>
 #include <QApplication>
 #include <QThread>
 #include <QMutex>
 #include <QIODevice>
+#include <QDataStream>
+#include <QCryptographicHash>
 #include <QDir>
 #include <QFile>
+#include <QFileInfo>
+#include <QDateTime>
 #include <QByteArray>
 #include <QList>
+#include <QHash>
+#include <QSet>
+#include <QVariant>
 #include <QString>
 #include <QStringList>
 #include <QUrl>
@@ -46,6 +55,7 @@
 #include "core/song.h"
 #include "core/sqlquery.h"
 #include "core/sqlrow.h"
+#include "utilities/strutils.h"
 #include "collection/collectionbackend.h"
 #include "playlistitem.h"
 #include "songplaylistitem.h"
@@ -58,8 +68,24 @@ using std::make_shared;
 
 namespace {
 constexpr int kSongTableJoins = 2;
+// Gap between the position keys of playlist items, so items can be moved or inserted without renumbering the rest.
+constexpr qint64 kPositionStep = 1024;
+
+QString PlaylistItemInsertQuery() {
+  return u"INSERT INTO playlist_items (playlist, type, uuid, collection_id, position, playlist_song_id) VALUES (:playlist, :type, :uuid, :collection_id, :position, :playlist_song_id)"_s;
+}
+
+// Identical songs in any playlist share a row of playlist_songs, found by the URL and a hash of all saved fields.
+QString PlaylistSongSelectQuery() {
+  return u"SELECT ROWID FROM playlist_songs WHERE url = :url AND hash = :hash"_s;
 }
 
+QString PlaylistSongInsertQuery() {
+  return u"INSERT INTO playlist_songs (hash, "_s + Song::kColumnSpec + u") VALUES (:hash, "_s + Song::kBindSpec + u")"_s;
+}
+
+}  // namespace
+
 PlaylistBackend::PlaylistBackend(const SharedPtr<Database> database,
                                  const SharedPtr<TagReaderClient> tagreader_client,
                                  const SharedPtr<CollectionBackend> collection_backend,
@@ -68,7 +94,8 @@ PlaylistBackend::PlaylistBackend(const SharedPtr<Database> database,
       database_(database),
       tagreader_client_(tagreader_client),
       collection_backend_(collection_backend),
-      original_thread_(nullptr) {
+      original_thread_(nullptr),
+      cue_state_(make_shared<NewSongFromQueryState>()) {
 
   setObjectName(QLatin1String(QObject::metaObject()->className()));
 
@@ -187,20 +214,24 @@ PlaylistBackend::Playlist PlaylistBackend::GetPlaylist(const int id) {
 
 QString PlaylistBackend::PlaylistItemsQuery() {
 
-  return QStringLiteral("SELECT %1, %2, p.type, p.uuid FROM playlist_items AS p "
+  // The metadata comes from the shared playlist song, with the ROWID of the playlist item in place of its ROWID.
+  const QStringList playlist_song_columns = QStringList() << u"p.ROWID"_s << Utilities::Prepend(u"ps."_s, Song::kColumns);
+
+  return QStringLiteral("SELECT %1, %2, p.type, p.uuid, p.position FROM playlist_items AS p "
                         "LEFT JOIN songs ON p.type = songs.source AND p.collection_id = songs.ROWID "
-                        "WHERE p.playlist = :playlist"
-                        ).arg(Song::JoinSpec(u"songs"_s),
-                              Song::JoinSpec(u"p"_s));
+                        "LEFT JOIN playlist_songs AS ps ON p.playlist_song_id = ps.ROWID "
+                        "WHERE p.playlist = :playlist "
+                        "ORDER BY p.position, p.ROWID"
+                        ).arg(Song::LongTextJoinSpec(u"songs"_s),
+                              playlist_song_columns.join(", "_L1));
 
 }
 
-PlaylistItemPtrList PlaylistBackend::GetPlaylistItems(const int playlist) {
+SqlRowList PlaylistBackend::GetPlaylistRows(const int playlist) {
 
-  PlaylistItemPtrList playlist_items;
+  SqlRowList rows;
 
   {
-
     QMutexLocker l(database_->Mutex());
     QSqlDatabase db(database_->Connect());
     SqlQuery q(db);
@@ -210,52 +241,66 @@ PlaylistItemPtrList PlaylistBackend::GetPlaylistItems(const int playlist) {
     q.BindValue(u":playlist"_s, playlist);
     if (!q.Exec()) {
       database_->ReportErrors(q);
-      return PlaylistItemPtrList();
+      return SqlRowList();
     }
 
-    // It's probable that we'll have a few songs associated with the same CUE, so we're caching results of parsing CUEs
-    SharedPtr<NewSongFromQueryState> state_ptr = make_shared<NewSongFromQueryState>();
     while (q.next()) {
-      playlist_items << NewPlaylistItemFromQuery(SqlRow(q), state_ptr);
+      rows << SqlRow(q);
     }
-
   }
 
   if (QThread::currentThread() != thread() && QThread::currentThread() != qApp->thread()) {
     Close();
   }
 
-  return playlist_items;
+  return rows;
 
 }
 
-SongList PlaylistBackend::GetPlaylistSongs(const int playlist) {
-
-  SongList songs;
+PlaylistItemPtrList PlaylistBackend::GetPlaylistItems(const int playlist) {
 
-  {
-    QMutexLocker l(database_->Mutex());
-    QSqlDatabase db(database_->Connect());
-    SqlQuery q(db);
-    // Forward iterations only may be faster
-    q.setForwardOnly(true);
-    q.prepare(PlaylistItemsQuery());
-    q.BindValue(u":playlist"_s, playlist);
-    if (!q.Exec()) {
-      database_->ReportErrors(q);
-      return SongList();
-    }
+  // Only the query holds the database mutex, creating the items and parsing CUEs is done without it so several playlists can be restored in parallel.
+  const SqlRowList rows = GetPlaylistRows(playlist);
 
-    // It's probable that we'll have a few songs associated with the same CUE, so we're caching results of parsing CUEs
-    SharedPtr<NewSongFromQueryState> state_ptr = make_shared<NewSongFromQueryState>();
-    while (q.next()) {
-      songs << NewSongFromQuery(SqlRow(q), state_ptr);
+  PlaylistItemPtrList playlist_items;
+  playlist_items.reserve(rows.count());
+
+  // Large playlists repeat the same artists, albums and genres, so let the items share their strings.
+  QSet<QString> strings;
+  QSet<QUrl> urls;
+  SavedPlaylistItems saved_items;
+  const int rowid_column = static_cast<int>(Song::kRowIdColumns.count());
+  const int position_column = static_cast<int>(Song::kRowIdColumns.count()) * kSongTableJoins + 2;
+  for (const SqlRow &row : rows) {
+    PlaylistItemPtr item = NewPlaylistItemFromQuery(row, cue_state_);
+    item->ShareStrings(strings, urls);
+    playlist_items << item;
+    if (!row.value(position_column).isNull()) {
+      saved_items.insert(&*item, NewSavedPlaylistItem(item, row.value(rowid_column).toLongLong(), row.value(position_column).toLongLong()));
     }
+  }
 
+  // Rows without positions are rewritten on the next save.
+  QMutexLocker locker(&mutex_saved_items_);
+  if (saved_items.count() == playlist_items.count()) {
+    saved_playlist_items_[playlist] = saved_items;
+  }
+  else {
+    saved_playlist_items_.remove(playlist);
   }
 
-  if (QThread::currentThread() != thread() && QThread::currentThread() != qApp->thread()) {
-    Close();
+  return playlist_items;
+
+}
+
+SongList PlaylistBackend::GetPlaylistSongs(const int playlist) {
+
+  const SqlRowList rows = GetPlaylistRows(playlist);
+
+  SongList songs;
+  songs.reserve(rows.count());
+  for (const SqlRow &row : rows) {
+    songs << NewSongFromQuery(row, cue_state_);
   }
 
   return songs;
@@ -295,8 +340,9 @@ PlaylistItemPtr PlaylistBackend::RestoreCueData(PlaylistItemPtr item, SharedPtr<
   if (!song.has_cue()) return item;
 
   QString cue_path = song.cue_path();
+  const QFileInfo cue_fileinfo(cue_path);
   // If .cue was deleted - reload the song
-  if (!QFile::exists(cue_path)) {
+  if (!cue_fileinfo.exists()) {
     const Song reloaded_song = item->Reload();
     if (reloaded_song.is_valid()) {
       item->SetOriginalMetadata(reloaded_song);
@@ -304,21 +350,29 @@ PlaylistItemPtr PlaylistBackend::RestoreCueData(PlaylistItemPtr item, SharedPtr<
     return item;
   }
 
+  const qint64 cue_mtime = cue_fileinfo.lastModified().toMSecsSinceEpoch();
+
   SongList songs;
+  bool cached = false;
   {
     QMutexLocker locker(&state->mutex_);
+    const QHash<QString, CachedCue>::const_iterator it = state->cached_cues_.constFind(cue_path);
+    if (it != state->cached_cues_.constEnd() && it->mtime == cue_mtime) {
+      songs = it->songs;
+      cached = true;
+    }
+  }
 
-    if (!state->cached_cues_.contains(cue_path)) {
-      QFile cue_file(cue_path);
-      if (!cue_file.open(QIODevice::ReadOnly)) return item;
+  // Parse outside the lock so other playlists being restored at the same time aren't held up.
+  if (!cached) {
+    QFile cue_file(cue_path);
+    if (!cue_file.open(QIODevice::ReadOnly)) return item;
 
-      songs = cue_parser.Load(&cue_file, cue_path, QDir(cue_path.section(u'/', 0, -2))).songs;
-      cue_file.close();
-      state->cached_cues_[cue_path] = songs;
-    }
-    else {
-      songs = state->cached_cues_[cue_path];
-    }
+    songs = cue_parser.Load(&cue_file, cue_path, QDir(cue_path.section(u'/', 0, -2))).songs;
+    cue_file.close();
+
+    QMutexLocker locker(&state->mutex_);
+    state->cached_cues_[cue_path] = CachedCue(cue_mtime, songs);
   }
 
   for (const Song &from_list : std::as_const(songs)) {
@@ -353,29 +407,30 @@ void PlaylistBackend::SavePlaylist(int playlist, const PlaylistItemPtrList &item
 
   ScopedTransaction transaction(&db);
 
-  // Clear the existing items in the playlist
+  // Takes the saved state out, so it's dropped if saving fails and the next save rewrites the playlist.
+  std::optional<SavedPlaylistItems> saved_items;
   {
-    SqlQuery q(db);
-    q.prepare(u"DELETE FROM playlist_items WHERE playlist = :playlist"_s);
-    q.BindValue(u":playlist"_s, playlist);
-    if (!q.Exec()) {
-      database_->ReportErrors(q);
-      return;
+    QMutexLocker locker(&mutex_saved_items_);
+    if (saved_playlist_items_.contains(playlist)) {
+      saved_items = saved_playlist_items_.take(playlist);
     }
   }
 
-  // Save the new ones
-  for (int i = 0; i < items.count(); ++i) {
-    const PlaylistItemPtr item = items.at(i);
-    SqlQuery q(db);
-    q.prepare(u"INSERT INTO playlist_items (playlist, type, uuid, collection_id, "_s + Song::kColumnSpec + u") VALUES (:playlist, :type, :uuid, :collection_id, "_s + Song::kBindSpec + u")"_s);
-    q.BindValue(u":playlist"_s, playlist);
-    item->BindToQuery(&q);
-
-    if (!q.Exec()) {
-      database_->ReportErrors(q);
+  bool renumber = !saved_items.has_value();
+  bool items_removed = false;
+  if (saved_items.has_value() && !SavePlaylistItemsChanges(db, playlist, items, saved_items.value(), renumber, items_removed)) {
+    return;
+  }
+  if (renumber) {
+    saved_items = SavedPlaylistItems();
+    if (!SavePlaylistItems(db, playlist, items, saved_items.value())) {
       return;
     }
+    items_removed = true;
+  }
+
+  if (items_removed && !DeleteUnusedPlaylistSongs(db)) {
+    return;
   }
 
   // Update the last played track number
@@ -402,6 +457,290 @@ void PlaylistBackend::SavePlaylist(int playlist, const PlaylistItemPtrList &item
 
   transaction.Commit();
 
+  // Items that are in the playlist more than once can't be told apart, so those playlists are always rewritten.
+  if (saved_items->count() == items.count()) {
+    QMutexLocker locker(&mutex_saved_items_);
+    saved_playlist_items_[playlist] = saved_items.value();
+  }
+
+}
+
+PlaylistBackend::SavedPlaylistItem PlaylistBackend::NewSavedPlaylistItem(PlaylistItemPtr item, const qint64 rowid, const qint64 position) {
+
+  SavedPlaylistItem saved_item;
+  saved_item.item = item;
+  saved_item.rowid = rowid;
+  saved_item.position = position;
+  saved_item.uuid = item->uuid();
+  saved_item.collection_id = item->DatabaseCollectionId();
+  saved_item.song = item->DatabaseMetadata();
+
+  return saved_item;
+
+}
+
+bool PlaylistBackend::IsSavedPlaylistItemChanged(const SavedPlaylistItem &saved_item, PlaylistItemPtr item) {
+
+  if (saved_item.uuid != item->uuid() || saved_item.collection_id != item->DatabaseCollectionId()) return true;
+
+  const Song song = item->DatabaseMetadata();
+  return !saved_item.song.IsSharedWith(song) && !saved_item.song.IsEqual(song);
+
+}
+
+bool PlaylistBackend::SavePlaylistItems(QSqlDatabase &db, const int playlist, const PlaylistItemPtrList &items, SavedPlaylistItems &saved_items) {
+
+  // Clear the existing items in the playlist
+  {
+    SqlQuery q(db);
+    q.prepare(u"DELETE FROM playlist_items WHERE playlist = :playlist"_s);
+    q.BindValue(u":playlist"_s, playlist);
+    if (!q.Exec()) {
+      database_->ReportErrors(q);
+      return false;
+    }
+  }
+
+  // Save the new ones
+  SqlQuery q_song_select(db);
+  q_song_select.prepare(PlaylistSongSelectQuery());
+  SqlQuery q_song_insert(db);
+  q_song_insert.prepare(PlaylistSongInsertQuery());
+  SqlQuery q(db);
+  q.prepare(PlaylistItemInsertQuery());
+  for (int i = 0; i < items.count(); ++i) {
+    const PlaylistItemPtr item = items.at(i);
+    const qint64 position = (i + 1) * kPositionStep;
+    QVariant playlist_song_id;
+    if (!SavePlaylistSong(q_song_select, q_song_insert, item, playlist_song_id)) {
+      return false;
+    }
+    q.BindValue(u":playlist"_s, playlist);
+    q.BindValue(u":position"_s, position);
+    q.BindValue(u":playlist_song_id"_s, playlist_song_id);
+    item->BindToQuery(&q);
+
+    if (!q.Exec()) {
+      database_->ReportErrors(q);
+      return false;
+    }
+
+    saved_items.insert(&*item, NewSavedPlaylistItem(item, q.lastInsertId().toLongLong(), position));
+  }
+
+  return true;
+
+}
+
+bool PlaylistBackend::SavePlaylistItemsChanges(QSqlDatabase &db, const int playlist, const PlaylistItemPtrList &items, SavedPlaylistItems &saved_items, bool &renumber, bool &items_removed) {
+
+  const int count = static_cast<int>(items.count());
+
+  // Match the items with their saved rows, an item pointer that was reused for a new item doesn't match the expired one.
+  QList<const SavedPlaylistItem*> matched_items(count, nullptr);
+  QSet<const PlaylistItem*> matched_keys;
+  for (int i = 0; i < count; ++i) {
+    const PlaylistItem *key = &*items[i];
+    if (matched_keys.contains(key)) {
+      renumber = true;
+      return true;
+    }
+    SavedPlaylistItems::const_iterator it = saved_items.constFind(key);
+    if (it != saved_items.constEnd() && it->item.lock() == items[i]) {
+      matched_items[i] = &*it;
+      matched_keys.insert(key);
+    }
+  }
+
+  // The longest run of items that kept their relative order keep their positions, everything else is moved in between them.
+  QList<bool> fixed(count, false);
+  {
+    QList<int> tails;
+    QList<int> previous(count, -1);
+    for (int i = 0; i < count; ++i) {
+      if (!matched_items[i]) continue;
+      const qint64 position = matched_items[i]->position;
+      const QList<int>::iterator it = std::lower_bound(tails.begin(), tails.end(), position, [&matched_items](const int j, const qint64 value) { return matched_items[j]->position < value; });
+      if (it != tails.begin()) previous[i] = *(it - 1);
+      if (it == tails.end()) {
+        tails << i;
+      }
+      else {
+        *it = i;
+      }
+    }
+    for (int i = tails.isEmpty() ? -1 : tails.constLast(); i != -1; i = previous[i]) {
+      fixed[i] = true;
+    }
+  }
+
+  QList<qint64> positions(count, 0);
+  qint64 left = 0;
+  for (int i = 0; i < count;) {
+    if (fixed[i]) {
+      positions[i] = matched_items[i]->position;
+      left = positions[i];
+      ++i;
+      continue;
+    }
+    int j = i;
+    while (j < count && !fixed[j]) ++j;
+    const qint64 gap_count = j - i;
+    const qint64 right = j < count ? matched_items[j]->position : left + (gap_count + 1) * kPositionStep;
+    if (right - left - 1 < gap_count) {
+      renumber = true;
+      return true;
+    }
+    for (qint64 k = 0; k < gap_count; ++k) {
+      positions[i + k] = left + ((right - left) * (k + 1) / (gap_count + 1));
+    }
+    i = j;
+  }
+
+  {
+    SqlQuery q(db);
+    q.prepare(u"DELETE FROM playlist_items WHERE ROWID = :rowid"_s);
+    for (SavedPlaylistItems::const_iterator it = saved_items.constBegin(); it != saved_items.constEnd(); ++it) {
+      if (matched_keys.contains(it.key())) continue;
+      q.BindValue(u":rowid"_s, it->rowid);
+      if (!q.Exec()) {
+        database_->ReportErrors(q);
+        return false;
+      }
+      items_removed = true;
+    }
+  }
+
+  SqlQuery q_song_select(db);
+  q_song_select.prepare(PlaylistSongSelectQuery());
+  SqlQuery q_song_insert(db);
+  q_song_insert.prepare(PlaylistSongInsertQuery());
+  SqlQuery q_insert(db);
+  q_insert.prepare(PlaylistItemInsertQuery());
+  SqlQuery q_update(db);
+  q_update.prepare(u"UPDATE playlist_items SET type = :type, uuid = :uuid, collection_id = :collection_id, position = :position, playlist_song_id = :playlist_song_id WHERE ROWID = :rowid"_s);
+  SqlQuery q_move(db);
+  q_move.prepare(u"UPDATE playlist_items SET position = :position WHERE ROWID = :rowid"_s);
+
+  SavedPlaylistItems new_saved_items;
+  new_saved_items.reserve(count);
+  for (int i = 0; i < count; ++i) {
+    const PlaylistItemPtr item = items[i];
+    const SavedPlaylistItem *saved_item = matched_items[i];
+    if (!saved_item) {
+      QVariant playlist_song_id;
+      if (!SavePlaylistSong(q_song_select, q_song_insert, item, playlist_song_id)) {
+        return false;
+      }
+      q_insert.BindValue(u":playlist"_s, playlist);
+      q_insert.BindValue(u":position"_s, positions[i]);
+      q_insert.BindValue(u":playlist_song_id"_s, playlist_song_id);
+      item->BindToQuery(&q_insert);
+      if (!q_insert.Exec()) {
+        database_->ReportErrors(q_insert);
+        return false;
+      }
+      new_saved_items.insert(&*item, NewSavedPlaylistItem(item, q_insert.lastInsertId().toLongLong(), positions[i]));
+      continue;
+    }
+    if (IsSavedPlaylistItemChanged(*saved_item, item)) {
+      QVariant playlist_song_id;
+      if (!SavePlaylistSong(q_song_select, q_song_insert, item, playlist_song_id)) {
+        return false;
+      }
+      q_update.BindValue(u":position"_s, positions[i]);
+      q_update.BindValue(u":playlist_song_id"_s, playlist_song_id);
+      q_update.BindValue(u":rowid"_s, saved_item->rowid);
+      item->BindToQuery(&q_update);
+      if (!q_update.Exec()) {
+        database_->ReportErrors(q_update);
+        return false;
+      }
+      items_removed = true;
+      new_saved_items.insert(&*item, NewSavedPlaylistItem(item, saved_item->rowid, positions[i]));
+      continue;
+    }
+    if (positions[i] != saved_item->position) {
+      q_move.BindValue(u":position"_s, positions[i]);
+      q_move.BindValue(u":rowid"_s, saved_item->rowid);
+      if (!q_move.Exec()) {
+        database_->ReportErrors(q_move);
+        return false;
+      }
+    }
+    SavedPlaylistItem new_saved_item = *saved_item;
+    new_saved_item.position = positions[i];
+    new_saved_items.insert(&*item, new_saved_item);
+  }
+
+  saved_items = new_saved_items;
+
+  return true;
+
+}
+
+QByteArray PlaylistBackend::PlaylistSongHash(const Song &song) {
+
+  // The metadata digest is computed when first used, compute it first so the song hashes the same either way.
+  song.metadata_digest();
+
+  QByteArray data;
+  {
+    QDataStream s(&data, QIODevice::WriteOnly);
+    s.setVersion(QDataStream::Qt_6_4);
+    song.ToDataStream(&s);
+  }
+
+  return QCryptographicHash::hash(data, QCryptographicHash::Sha1);
+
+}
+
+bool PlaylistBackend::SavePlaylistSong(SqlQuery &q_select, SqlQuery &q_insert, PlaylistItemPtr item, QVariant &playlist_song_id) {
+
+  const Song song = item->DatabaseMetadata();
+
+  // Collection items only save the collection ID.
+  if (song.url().isEmpty()) {
+    playlist_song_id = QVariant();
+    return true;
+  }
+
+  const QByteArray hash = PlaylistSongHash(song);
+
+  q_select.BindUrlValue(u":url"_s, song.url());
+  q_select.BindValue(u":hash"_s, hash);
+  if (!q_select.Exec()) {
+    database_->ReportErrors(q_select);
+    return false;
+  }
+  if (q_select.next()) {
+    playlist_song_id = q_select.value(0);
+    return true;
+  }
+
+  q_insert.BindValue(u":hash"_s, hash);
+  song.BindToQuery(&q_insert);
+  if (!q_insert.Exec()) {
+    database_->ReportErrors(q_insert);
+    return false;
+  }
+  playlist_song_id = q_insert.lastInsertId();
+
+  return true;
+
+}
+
+bool PlaylistBackend::DeleteUnusedPlaylistSongs(QSqlDatabase &db) {
+
+  SqlQuery q(db);
+  q.prepare(u"DELETE FROM playlist_songs WHERE NOT EXISTS (SELECT 1 FROM playlist_items WHERE playlist_items.playlist_song_id = playlist_songs.ROWID)"_s);
+  if (!q.Exec()) {
+    database_->ReportErrors(q);
+    return false;
+  }
+
+  return true;
+
 }
 
 int PlaylistBackend::CreatePlaylist(const QString &name, const QString &special_type) {
@@ -424,6 +763,11 @@ int PlaylistBackend::CreatePlaylist(const QString &name, const QString &special_
 
 void PlaylistBackend::RemovePlaylist(int id) {
 
+  {
+    QMutexLocker locker(&mutex_saved_items_);
+    saved_playlist_items_.remove(id);
+  }
+
   QMutexLocker l(database_->Mutex());
   QSqlDatabase db(database_->Connect());
 
@@ -449,6 +793,10 @@ void PlaylistBackend::RemovePlaylist(int id) {
     }
   }
 
+  if (!DeleteUnusedPlaylistSongs(db)) {
+    return;
+  }
+
   transaction.Commit();
 
 }
@@ -24,12 +24,16 @@
 
 #include "config.h"
 
+#include <memory>
+
 #include <QObject>
 #include <QMutex>
 #include <QHash>
 #include <QList>
 #include <QSet>
 #include <QString>
+#include <QUuid>
+#include <QVariant>
 
 #include "includes/shared_ptr.h"
 #include "core/song.h"
@@ -38,6 +42,8 @@
 #include "smartplaylists/playlistgenerator.h"
 
 class QThread;
+class QSqlDatabase;
+class SqlQuery;
 class Database;
 class TagReaderClient;
 
@@ -93,12 +99,38 @@ class PlaylistBackend : public QObject {
   void ExitFinished();
 
  private:
+  struct CachedCue {
+    explicit CachedCue(const qint64 _mtime = 0, const SongList &_songs = SongList()) : mtime(_mtime), songs(_songs) {}
+    qint64 mtime;
+    SongList songs;
+  };
+  // It's probable that we'll have a few songs associated with the same CUE, so we're caching results of parsing CUEs
   struct NewSongFromQueryState {
-    QHash<QString, SongList> cached_cues_;
+    QHash<QString, CachedCue> cached_cues_;
     QMutex mutex_;
   };
 
+  // The last saved state of a playlist item, used to only write the rows that changed.
+  struct SavedPlaylistItem {
+    SavedPlaylistItem() : rowid(-1), position(0) {}
+    std::weak_ptr<PlaylistItem> item;
+    qint64 rowid;
+    qint64 position;
+    QUuid uuid;
+    QVariant collection_id;
+    Song song;
+  };
+  using SavedPlaylistItems = QHash<const PlaylistItem*, SavedPlaylistItem>;
+
   static QString PlaylistItemsQuery();
+  SqlRowList GetPlaylistRows(const int playlist);
+  static SavedPlaylistItem NewSavedPlaylistItem(PlaylistItemPtr item, const qint64 rowid, const qint64 position);
+  static bool IsSavedPlaylistItemChanged(const SavedPlaylistItem &saved_item, PlaylistItemPtr item);
+  bool SavePlaylistItems(QSqlDatabase &db, const int playlist, const PlaylistItemPtrList &items, SavedPlaylistItems &saved_items);
+  bool SavePlaylistItemsChanges(QSqlDatabase &db, const int playlist, const PlaylistItemPtrList &items, SavedPlaylistItems &saved_items, bool &renumber, bool &items_removed);
+  static QByteArray PlaylistSongHash(const Song &song);
+  bool SavePlaylistSong(SqlQuery &q_select, SqlQuery &q_insert, PlaylistItemPtr item, QVariant &playlist_song_id);
+  bool DeleteUnusedPlaylistSongs(QSqlDatabase &db);
   Song NewSongFromQuery(const SqlRow &row, SharedPtr<NewSongFromQueryState> state);
   PlaylistItemPtr NewPlaylistItemFromQuery(const SqlRow &row, SharedPtr<NewSongFromQueryState> state);
   PlaylistItemPtr RestoreCueData(PlaylistItemPtr item, SharedPtr<NewSongFromQueryState> state);
@@ -114,6 +146,11 @@ class PlaylistBackend : public QObject {
   const SharedPtr<TagReaderClient> tagreader_client_;
   const SharedPtr<CollectionBackend> collection_backend_;
   QThread *original_thread_;
+  // Shared by all playlists, so CUEs used in several playlists are only parsed once.
+  SharedPtr<NewSongFromQueryState> cue_state_;
+
+  QMutex mutex_saved_items_;
+  QHash<int, SavedPlaylistItems> saved_playlist_items_;
 };
 
 #endif  // PLAYLISTBACKEND_H
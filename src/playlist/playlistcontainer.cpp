@@ -49,6 +49,7 @@
 #include "includes/shared_ptr.h"
 #include "core/iconloader.h"
 #include "core/settings.h"
+#include "constants/playlistsettings.h"
 #include "filterparser/filterparser.h"
 #include "playlist.h"
 #include "playlisttabbar.h"
@@ -194,13 +195,15 @@ void PlaylistContainer::SetViewModel(Playlist *playlist, const int scroll_positi
 
   playlist_ = playlist;
 
-  // Set the view
+  // Set the view, it's painted once when the header, selection and scroll position are all restored.
+  view()->setUpdatesEnabled(false);
   playlist->IgnoreSorting(true);
   view()->setModel(playlist->filter());
   view()->SetPlaylist(playlist);
   view()->selectionModel()->select(manager_->current_selection(), QItemSelectionModel::ClearAndSelect);
   if (scroll_position != 0) view()->verticalScrollBar()->setValue(scroll_position);
   playlist->IgnoreSorting(false);
+  view()->setUpdatesEnabled(true);
 
   QObject::connect(view()->selectionModel(), &QItemSelectionModel::selectionChanged, this, &PlaylistContainer::SelectionChanged);
   Q_EMIT ViewSelectionModelChanged();
@@ -310,7 +313,7 @@ void PlaylistContainer::PlaylistAdded(const int id, const QString &name, const b
   // Are we start up, should we select this tab?
   Settings s;
   s.beginGroup(kSettingsGroup);
-  const int current_playlist = s.value("current_playlist", 1).toInt();
+  const int current_playlist = s.value(PlaylistSettings::kCurrentPlaylist, 1).toInt();
   s.endGroup();
 
   if (starting_up_ && current_playlist == id) {
@@ -400,7 +403,7 @@ void PlaylistContainer::Save() {
 
   Settings s;
   s.beginGroup(kSettingsGroup);
-  s.setValue("current_playlist", ui_->tab_bar->current_id());
+  s.setValue(PlaylistSettings::kCurrentPlaylist, ui_->tab_bar->current_id());
   s.endGroup();
 
 }
@@ -81,6 +81,7 @@ constexpr QRgb kQueueBoxGradientColor1 = qRgb(102, 150, 227);
 constexpr QRgb kQueueBoxGradientColor2 = qRgb(77, 121, 200);
 constexpr int kQueueOpacitySteps = 10;
 constexpr float kQueueOpacityLowerBound = 0.4F;
+constexpr int kDisplayTextCacheSize = 4096;
 }  // namespace
 
 const int PlaylistDelegateBase::kMinHeight = 19;
@@ -166,7 +167,7 @@ int QueuedItemDelegate::queue_indicator_size(const QModelIndex &idx) const {
 
 
 PlaylistDelegateBase::PlaylistDelegateBase(QObject *parent, const QString &suffix)
-    : QueuedItemDelegate(parent), view_(qobject_cast<QTreeView*>(parent)), suffix_(suffix)
+    : QueuedItemDelegate(parent), view_(qobject_cast<QTreeView*>(parent)), suffix_(suffix), text_cache_(kDisplayTextCacheSize)
 {
 }
 
@@ -306,7 +307,7 @@ QString LengthItemDelegate::displayText(const QVariant &value, const QLocale &lo
   bool ok = false;
   qint64 nanoseconds = value.toLongLong(&ok);
 
-  if (ok && nanoseconds > 0) return Utilities::PrettyTimeNanosec(nanoseconds);
+  if (ok && nanoseconds > 0) return CachedDisplayText(nanoseconds, Utilities::PrettyTimeNanosec);
   return QString();
 
 }
@@ -319,7 +320,7 @@ QString SizeItemDelegate::displayText(const QVariant &value, const QLocale &loca
   bool ok = false;
   qint64 bytes = value.toLongLong(&ok);
 
-  if (ok && bytes > 0) return Utilities::PrettySize(static_cast<quint64>(bytes));
+  if (ok && bytes > 0) return CachedDisplayText(bytes, [](const qint64 size) { return Utilities::PrettySize(static_cast<quint64>(size)); });
   return QString();
 
 }
@@ -335,7 +336,7 @@ QString DateItemDelegate::displayText(const QVariant &value, const QLocale &loca
     return QString();
   }
 
-  return QDateTime::fromSecsSinceEpoch(time).toString(QLocale::system().dateTimeFormat(QLocale::ShortFormat));
+  return CachedDisplayText(time, [](const qint64 secs) { return QDateTime::fromSecsSinceEpoch(secs).toString(QLocale::system().dateTimeFormat(QLocale::ShortFormat)); });
 
 }
 
@@ -34,6 +34,7 @@
 #include <QLocale>
 #include <QVariant>
 #include <QUrl>
+#include <QCache>
 #include <QPixmap>
 #include <QPainter>
 #include <QRect>
@@ -86,9 +87,22 @@ class PlaylistDelegateBase : public QueuedItemDelegate {
  public Q_SLOTS:
   bool helpEvent(QHelpEvent *event, QAbstractItemView *view, const QStyleOptionViewItem &option, const QModelIndex &idx) override;
 
+ protected:
+  // Returns the formatted text for value, formatting is done once per distinct value and kept in text_cache_.
+  template<typename F>
+  QString CachedDisplayText(const qint64 value, F format) const {
+    if (const QString *text = text_cache_.object(value)) return *text;
+    const QString text = format(value);
+    text_cache_.insert(value, new QString(text));
+    return text;
+  }
+
  protected:
   QTreeView *view_;
   QString suffix_;
+
+ private:
+  mutable QCache<qint64, QString> text_cache_;
 };
 
 class LengthItemDelegate : public PlaylistDelegateBase {
@@ -21,7 +21,14 @@
 
 #include "config.h"
 
+#include <algorithm>
+
 #include <QObject>
+#include <QtConcurrentRun>
+#include <QtConcurrentMap>
+#include <QFuture>
+#include <QFutureWatcher>
+#include <QList>
 #include <QString>
 
 #include "playlist/playlist.h"
@@ -30,10 +37,19 @@
 #include "filterparser/filtertreenop.h"
 #include "playlistfilter.h"
 
+using std::make_shared;
+
+namespace {
+constexpr int kAsyncFilterMinimumRows = 10000;
+constexpr int kAsyncFilterChunkSize = 2000;
+}  // namespace
+
 PlaylistFilter::PlaylistFilter(QObject *parent)
     : QSortFilterProxyModel(parent),
       filter_tree_(new FilterTreeNop),
-      query_hash_(0) {
+      query_hash_(0),
+      filter_generation_(make_shared<std::atomic<quint64>>(0)),
+      async_filter_pending_(false) {
 
   setDynamicSortFilter(true);
 
@@ -57,6 +73,10 @@ bool PlaylistFilter::filterAcceptsRow(const int source_row, const QModelIndex &s
 
   if (filter_string_.isEmpty()) return true;
 
+  if (!accepted_rows_.isEmpty() && source_row < accepted_rows_.count()) {
+    return accepted_rows_[source_row];
+  }
+
   size_t hash = qHash(filter_string_);
   if (hash != query_hash_) {
     FilterParser p(filter_string_);
@@ -71,6 +91,107 @@ bool PlaylistFilter::filterAcceptsRow(const int source_row, const QModelIndex &s
 void PlaylistFilter::SetFilterString(const QString &filter_string) {
 
   filter_string_ = filter_string;
+
+  // Drop any result still being computed for the previous filter string.
+  ++(*filter_generation_);
+  async_filter_pending_ = false;
+
+  if (!filter_string_.isEmpty() && sourceModel() && sourceModel()->rowCount() >= kAsyncFilterMinimumRows) {
+    StartAsyncFilter();
+    return;
+  }
+
   setFilterFixedString(filter_string);
 
 }
+
+void PlaylistFilter::setSourceModel(QAbstractItemModel *source_model) {
+
+  if (sourceModel()) {
+    QObject::disconnect(sourceModel(), &QAbstractItemModel::rowsAboutToBeInserted, this, &PlaylistFilter::SourceRowsAboutToChange);
+    QObject::disconnect(sourceModel(), &QAbstractItemModel::rowsAboutToBeRemoved, this, &PlaylistFilter::SourceRowsAboutToChange);
+    QObject::disconnect(sourceModel(), &QAbstractItemModel::rowsAboutToBeMoved, this, &PlaylistFilter::SourceRowsAboutToChange);
+    QObject::disconnect(sourceModel(), &QAbstractItemModel::layoutAboutToBeChanged, this, &PlaylistFilter::SourceRowsAboutToChange);
+    QObject::disconnect(sourceModel(), &QAbstractItemModel::modelAboutToBeReset, this, &PlaylistFilter::SourceRowsAboutToChange);
+  }
+
+  QSortFilterProxyModel::setSourceModel(source_model);
+
+  if (source_model) {
+    QObject::connect(source_model, &QAbstractItemModel::rowsAboutToBeInserted, this, &PlaylistFilter::SourceRowsAboutToChange);
+    QObject::connect(source_model, &QAbstractItemModel::rowsAboutToBeRemoved, this, &PlaylistFilter::SourceRowsAboutToChange);
+    QObject::connect(source_model, &QAbstractItemModel::rowsAboutToBeMoved, this, &PlaylistFilter::SourceRowsAboutToChange);
+    QObject::connect(source_model, &QAbstractItemModel::layoutAboutToBeChanged, this, &PlaylistFilter::SourceRowsAboutToChange);
+    QObject::connect(source_model, &QAbstractItemModel::modelAboutToBeReset, this, &PlaylistFilter::SourceRowsAboutToChange);
+  }
+
+}
+
+void PlaylistFilter::StartAsyncFilter() {
+
+  Playlist *playlist = qobject_cast<Playlist*>(sourceModel());
+  if (!playlist) return;
+
+  // Take a snapshot of the metadata, songs are implicitly shared so this is cheap.
+  SongList songs;
+  songs.reserve(playlist->rowCount());
+  for (int row = 0; row < playlist->rowCount(); ++row) {
+    PlaylistItemPtr item = playlist->item_at(row);
+    songs << (item ? item->EffectiveMetadata() : Song());
+  }
+
+  FilterParser p(filter_string_);
+  SharedPtr<FilterTree> filter_tree(p.parse());
+
+  const quint64 generation = *filter_generation_;
+  const QString filter_string = filter_string_;
+  async_filter_pending_ = true;
+
+  QFuture<QList<bool>> future = QtConcurrent::run(&PlaylistFilter::FilterSongs, filter_tree, songs, generation, filter_generation_);
+  QFutureWatcher<QList<bool>> *watcher = new QFutureWatcher<QList<bool>>();
+  QObject::connect(watcher, &QFutureWatcher<QList<bool>>::finished, this, [this, watcher, generation, filter_string]() {
+    const QList<bool> accepted_rows = watcher->result();
+    watcher->deleteLater();
+    if (generation != *filter_generation_ || filter_string != filter_string_ || !sourceModel() || accepted_rows.count() != sourceModel()->rowCount()) return;
+    async_filter_pending_ = false;
+    // Publish the whole result at once, later changes to single rows go through the filter tree again.
+    accepted_rows_ = accepted_rows;
+    setFilterFixedString(filter_string_);
+    invalidateFilter();
+    accepted_rows_.clear();
+  });
+  watcher->setFuture(future);
+
+}
+
+QList<bool> PlaylistFilter::FilterSongs(SharedPtr<FilterTree> filter_tree, const SongList &songs, const quint64 generation, SharedPtr<std::atomic<quint64>> current_generation) {
+
+  QList<bool> accepted_rows(songs.count(), false);
+
+  QList<int> chunks;
+  for (int i = 0; i < songs.count(); i += kAsyncFilterChunkSize) {
+    chunks << i;
+  }
+
+  QtConcurrent::blockingMap(chunks, [&filter_tree, &songs, &accepted_rows, generation, current_generation](const int start) {
+    if (generation != *current_generation) return;
+    const int end = std::min(start + kAsyncFilterChunkSize, static_cast<int>(songs.count()));
+    for (int i = start; i < end; ++i) {
+      accepted_rows[i] = filter_tree->accept(songs[i]);
+    }
+  });
+
+  return accepted_rows;
+
+}
+
+void PlaylistFilter::SourceRowsAboutToChange() {
+
+  // The snapshot no longer matches the playlist rows, start over.
+  if (async_filter_pending_) {
+    ++(*filter_generation_);
+    async_filter_pending_ = false;
+    QMetaObject::invokeMethod(this, [this]() { SetFilterString(filter_string_); }, Qt::QueuedConnection);
+  }
+
+}
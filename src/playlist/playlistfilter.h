@@ -24,10 +24,15 @@
 
 #include "config.h"
 
+#include <atomic>
+
 #include <QSortFilterProxyModel>
 #include <QScopedPointer>
+#include <QList>
 #include <QString>
 
+#include "includes/shared_ptr.h"
+#include "core/song.h"
 #include "filterparser/filtertree.h"
 
 class PlaylistFilter : public QSortFilterProxyModel {
@@ -47,11 +52,25 @@ class PlaylistFilter : public QSortFilterProxyModel {
   void SetFilterString(const QString &filter_string);
   QString filter_string() const { return filter_string_; }
 
+  void setSourceModel(QAbstractItemModel *source_model) override;
+
+ private:
+  static QList<bool> FilterSongs(SharedPtr<FilterTree> filter_tree, const SongList &songs, const quint64 generation, SharedPtr<std::atomic<quint64>> current_generation);
+  void StartAsyncFilter();
+
+ private Q_SLOTS:
+  void SourceRowsAboutToChange();
+
  private:
   // Mutable because they're modified from filterAcceptsRow() const
   mutable QScopedPointer<FilterTree> filter_tree_;
   mutable size_t query_hash_;
   QString filter_string_;
+
+  // Async filtering of large playlists, accepted_rows_ is only set while the result is published.
+  SharedPtr<std::atomic<quint64>> filter_generation_;
+  bool async_filter_pending_;
+  QList<bool> accepted_rows_;
 };
 
 #endif  // PLAYLISTFILTER_H
@@ -122,8 +122,6 @@ void PlaylistItem::BindToQuery(SqlQuery *query) const {
   query->BindValue(u":uuid"_s, uuid_.toString(QUuid::WithoutBraces));
   query->BindValue(u":collection_id"_s, DatabaseValue(DatabaseColumn::CollectionId));
 
-  DatabaseSongMetadata().BindToQuery(query);
-
 }
 
 static Song ReloadPlaylistItem(PlaylistItemPtr item) {
@@ -78,6 +78,9 @@ class PlaylistItem : public enable_shared_from_this<PlaylistItem> {
   virtual QUrl OriginalUrl() const = 0;
   virtual void SetOriginalMetadata(const Song &song) { Q_UNUSED(song); }
 
+  // Makes the metadata use the same string data as other items with equal strings, see Song::ShareStrings.
+  virtual void ShareStrings(QSet<QString> &strings, QSet<QUrl> &urls) { Q_UNUSED(strings); Q_UNUSED(urls); }
+
   Song EffectiveMetadata() const { return HasStreamMetadata() ? stream_song_ : OriginalMetadata(); }
   QUrl EffectiveUrl() const { return stream_song_.effective_url().isValid() ? stream_song_.effective_url() : OriginalUrl(); }
 
@@ -92,7 +95,11 @@ class PlaylistItem : public enable_shared_from_this<PlaylistItem> {
   virtual void SetArtManual(const QUrl &cover_url) = 0;
 
   virtual bool InitFromQuery(const SqlRow &query) = 0;
+  // Binds the columns of the playlist item, the metadata is saved by the playlist backend in a row of playlist_songs shared by identical songs.
   void BindToQuery(SqlQuery *query) const;
+  // The values saved by the playlist backend, so it can tell if the item needs to be saved again.
+  QVariant DatabaseCollectionId() const { return DatabaseValue(DatabaseColumn::CollectionId); }
+  Song DatabaseMetadata() const { return DatabaseSongMetadata(); }
   virtual Song Reload() { return Song(); }
   QFuture<Song> BackgroundReload();
 
@@ -103,6 +103,7 @@ void PlaylistManager::Init(PlaylistSequence *sequence, PlaylistContainer *playli
   parser_ = new PlaylistParser(tagreader_client_, collection_backend_, this);
 
   QObject::connect(&*collection_backend_, &CollectionBackend::SongsChanged, this, &PlaylistManager::UpdateCollectionSongs);
+  QObject::connect(&*collection_backend_, &CollectionBackend::AlbumArtChanged, this, &PlaylistManager::UpdateCollectionAlbumArt);
   QObject::connect(&*collection_backend_, &CollectionBackend::SongsStatisticsChanged, this, &PlaylistManager::UpdateCollectionSongs);
   QObject::connect(&*collection_backend_, &CollectionBackend::SongsRatingChanged, this, &PlaylistManager::UpdateCollectionSongs);
 
@@ -470,6 +471,14 @@ void PlaylistManager::SelectionChanged(const QItemSelection &selection) {
   UpdateSummaryText();
 }
 
+void PlaylistManager::UpdateCollectionAlbumArt(const SongList &songs) {
+
+  for (const Data &data : std::as_const(playlists_)) {
+    data.p->UpdateCollectionItemsArt(songs);
+  }
+
+}
+
 void PlaylistManager::UpdateCollectionSongs(const SongList &songs) {
 
   // Some songs might've changed in the collection, let's update any playlist items we have that match those songs
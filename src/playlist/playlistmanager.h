@@ -148,6 +148,7 @@ class PlaylistManager : public PlaylistManagerInterface {
   void OneOfPlaylistsChanged();
   void UpdateSummaryText();
   void UpdateCollectionSongs(const SongList &songs);
+  void UpdateCollectionAlbumArt(const SongList &songs);
   void ItemsLoadedForSavePlaylist(const QString &playlist_name, const SongList &songs, const QString &filename, const PlaylistSettings::PathType path_type);
   void PlaylistLoaded();
 
@@ -20,6 +20,7 @@
 #ifndef PLAYLISTUNDOCOMMANDBASE_H
 #define PLAYLISTUNDOCOMMANDBASE_H
 
+#include <QtGlobal>
 #include <QUndoCommand>
 
 class Playlist;
@@ -32,6 +33,9 @@ class PlaylistUndoCommandBase : public QUndoCommand {
     RemoveItems = 0,
   };
 
+  // Approximate number of items kept alive by this command, used for the undo memory budget.
+  virtual qint64 item_count() const { return 0; }
+
  protected:
   Playlist *playlist_;
 };
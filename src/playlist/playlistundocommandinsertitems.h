@@ -34,6 +34,8 @@ class PlaylistUndoCommandInsertItems : public PlaylistUndoCommandBase {
   // Return true if the was found (and updated), false otherwise
   bool UpdateItem(const PlaylistItemPtr &updated_item);
 
+  qint64 item_count() const override { return items_.count(); }
+
  private:
   PlaylistItemPtrList items_;
   int pos_;
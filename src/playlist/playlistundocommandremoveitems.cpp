@@ -22,14 +22,44 @@
 #include "playlist.h"
 #include "playlistundocommandremoveitems.h"
 
-PlaylistUndoCommandRemoveItems::PlaylistUndoCommandRemoveItems(Playlist *playlist, const int pos, const int count) : PlaylistUndoCommandBase(playlist) {
+PlaylistUndoCommandRemoveItems::PlaylistUndoCommandRemoveItems(Playlist *playlist, const int pos, const int count) : PlaylistUndoCommandBase(playlist), bulk_(false) {
   setText(QObject::tr("remove %n songs", "", count));
 
   ranges_ << Range(pos, count);
 }
 
+PlaylistUndoCommandRemoveItems::PlaylistUndoCommandRemoveItems(Playlist *playlist, const QList<int> &rows) : PlaylistUndoCommandBase(playlist), bulk_(true) {
+
+  setText(QObject::tr("remove %n songs", "", static_cast<int>(rows.count())));
+
+  // Split the rows into ranges from the bottom up, so the ranges can be inserted back from the top down.
+  qsizetype last = rows.count() - 1;
+  while (last >= 0) {
+    qsizetype first = last;
+    while (first > 0 && rows[first - 1] == rows[first] - 1) --first;
+    ranges_ << Range(rows[first], static_cast<int>(last - first + 1));
+    last = first - 1;
+  }
+
+}
+
 void PlaylistUndoCommandRemoveItems::redo() {
 
+  if (bulk_) {
+    QList<int> rows;
+    for (const Range &range : std::as_const(ranges_)) {
+      for (int row = range.pos_; row < range.pos_ + range.count_; ++row) rows << row;
+    }
+    // The removed items are in row order, the ranges from the bottom up.
+    const PlaylistItemPtrList items = playlist_->RemoveRowsWithoutUndo(rows);
+    qsizetype end = items.count();
+    for (Range &range : ranges_) {
+      range.items_ = items.mid(end - range.count_, range.count_);
+      end -= range.count_;
+    }
+    return;
+  }
+
   for (int i = 0; i < ranges_.count(); ++i) {
     ranges_[i].items_ = playlist_->RemoveItemsWithoutUndo(ranges_[i].pos_, ranges_[i].count_);
   }
@@ -47,6 +77,8 @@ void PlaylistUndoCommandRemoveItems::undo() {
 bool PlaylistUndoCommandRemoveItems::mergeWith(const QUndoCommand *other) {
 
   const PlaylistUndoCommandRemoveItems *remove_command = static_cast<const PlaylistUndoCommandRemoveItems*>(other);
+  if (bulk_ || remove_command->bulk_) return false;
+
   ranges_.append(remove_command->ranges_);
 
   int sum = 0;
@@ -56,3 +88,11 @@ bool PlaylistUndoCommandRemoveItems::mergeWith(const QUndoCommand *other) {
   return true;
 
 }
+
+qint64 PlaylistUndoCommandRemoveItems::item_count() const {
+
+  qint64 count = 0;
+  for (const Range &range : ranges_) count += range.items_.count();
+  return count;
+
+}
@@ -28,12 +28,15 @@
 class PlaylistUndoCommandRemoveItems : public PlaylistUndoCommandBase {
  public:
   explicit PlaylistUndoCommandRemoveItems(Playlist *playlist, const int pos, const int count);
+  // Removes the given sorted rows in one pass.
+  explicit PlaylistUndoCommandRemoveItems(Playlist *playlist, const QList<int> &rows);
 
   int id() const override { return static_cast<int>(PlaylistUndoCommandBase::Type::RemoveItems); }
 
   void undo() override;
   void redo() override;
   bool mergeWith(const QUndoCommand *other) override;
+  qint64 item_count() const override;
 
  private:
   struct Range {
@@ -44,6 +47,8 @@ class PlaylistUndoCommandRemoveItems : public PlaylistUndoCommandBase {
   };
 
   QList<Range> ranges_;
+  // The ranges are all positions before the removal instead of one after another.
+  bool bulk_;
 };
 
 #endif  // PLAYLISTUNDOCOMMANDREMOVEITEMS_H
@@ -17,12 +17,58 @@
  *
  */
 
+#include <utility>
+
+#include <QHash>
+
 #include "playlist.h"
 #include "playlistundocommandreorderitems.h"
 
 PlaylistUndoCommandReOrderItems::PlaylistUndoCommandReOrderItems(Playlist *playlist, const PlaylistItemPtrList &new_items)
-    : PlaylistUndoCommandBase(playlist), old_items_(playlist->items_), new_items_(new_items) {}
+    : PlaylistUndoCommandBase(playlist), old_items_(playlist->items_) {
+
+  if (new_items.count() == old_items_.count()) {
+    QHash<const PlaylistItem*, int> old_rows;
+    old_rows.reserve(old_items_.count());
+    for (int i = 0; i < old_items_.count(); ++i) {
+      old_rows.insert(&*old_items_[i], i);
+    }
+    new_order_.reserve(new_items.count());
+    for (const PlaylistItemPtr &item : new_items) {
+      const QHash<const PlaylistItem*, int>::const_iterator it = old_rows.constFind(&*item);
+      if (it == old_rows.constEnd()) break;
+      new_order_ << it.value();
+    }
+  }
+
+  if (new_order_.count() != new_items.count()) {
+    new_order_.clear();
+    new_items_ = new_items;
+  }
+
+}
 
 void PlaylistUndoCommandReOrderItems::undo() { playlist_->ReOrderWithoutUndo(old_items_); }
 
-void PlaylistUndoCommandReOrderItems::redo() { playlist_->ReOrderWithoutUndo(new_items_); }
+void PlaylistUndoCommandReOrderItems::redo() {
+
+  if (new_order_.isEmpty()) {
+    playlist_->ReOrderWithoutUndo(new_items_);
+    return;
+  }
+
+  PlaylistItemPtrList new_items;
+  new_items.reserve(new_order_.count());
+  for (const int row : std::as_const(new_order_)) {
+    new_items << old_items_[row];
+  }
+  playlist_->ReOrderWithoutUndo(new_items);
+
+}
+
+qint64 PlaylistUndoCommandReOrderItems::item_count() const {
+
+  // An index takes a quarter of the memory of an item pointer.
+  return old_items_.count() + new_items_.count() + new_order_.count() / 4;
+
+}
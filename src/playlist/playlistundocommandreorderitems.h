@@ -20,6 +20,9 @@
 #ifndef PLAYLISTUNDOCOMMANDREORDERITEMS_H
 #define PLAYLISTUNDOCOMMANDREORDERITEMS_H
 
+#include <QtGlobal>
+#include <QList>
+
 #include "playlistundocommandbase.h"
 #include "playlistitem.h"
 
@@ -31,9 +34,13 @@ class PlaylistUndoCommandReOrderItems : public PlaylistUndoCommandBase {
 
   void undo() override;
   void redo() override;
+  qint64 item_count() const override;
 
  private:
   PlaylistItemPtrList old_items_;
+  // The new order as indexes into old_items_, so only one list of items is kept.
+  QList<int> new_order_;
+  // Only used when the new items are not a reordering of the old items.
   PlaylistItemPtrList new_items_;
 };
 
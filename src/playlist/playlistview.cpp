@@ -107,6 +107,7 @@ PlaylistView::PlaylistView(QWidget *parent)
       set_initial_header_layout_(false),
       header_state_loaded_(false),
       header_state_restored_(false),
+      restoring_header_state_(false),
       read_only_settings_(false),
       previous_background_image_opacity_(0.0),
       fade_animation_(new QTimeLine(1000, this)),
@@ -145,6 +146,8 @@ PlaylistView::PlaylistView(QWidget *parent)
   setStyle(style_);
   setMouseTracking(true);
   setAlternatingRowColors(true);
+  // All rows use the same delegates and single line text, so Qt does not need to ask for a size hint per row.
+  setUniformRowHeights(true);
   setAttribute(Qt::WA_MacShowFocusRect, false);
 #ifdef Q_OS_MACOS
   setVerticalScrollMode(QAbstractItemView::ScrollPerPixel);
@@ -343,7 +346,7 @@ void PlaylistView::LoadHeaderState() {
 
 void PlaylistView::SetHeaderState() {
 
-  if (!header_state_loaded_) return;
+  if (!header_state_loaded_ || restoring_header_state_) return;
   header_state_ = header_->SaveState();
 
 }
@@ -360,6 +363,9 @@ void PlaylistView::RestoreHeaderState() {
 
   if (!header_state_loaded_) LoadHeaderState();
 
+  // Every section moved, resized or hidden while restoring would save the whole header state again.
+  restoring_header_state_ = true;
+
   if (header_state_.isEmpty() || !header_->RestoreState(header_state_)) {
     set_initial_header_layout_ = true;
   }
@@ -442,6 +448,9 @@ void PlaylistView::RestoreHeaderState() {
     header_->ShowSection(static_cast<int>(Playlist::Column::Title));
   }
 
+  restoring_header_state_ = false;
+  SetHeaderState();
+
   header_state_restored_ = true;
 
   Q_EMIT ColumnAlignmentChanged(column_alignment_);
@@ -751,13 +760,15 @@ void PlaylistView::RemoveSelected() {
   // Store the last selected row, which is the last in the list
   int last_row = selection.last().top();
 
-  // Sort the selection, so we remove the items at the *bottom* first, ensuring we don't have to mess around with changing row numbers
-  std::sort(selection.begin(), selection.end(), [](const QItemSelectionRange &a, const QItemSelectionRange &b) { return b.bottom() < a.bottom(); });
-
-  for (const QItemSelectionRange &range : selection) {
+  // Remove all the selected rows at once, a large selection can be split in many ranges.
+  QList<int> source_rows;
+  for (const QItemSelectionRange &range : std::as_const(selection)) {
     if (range.top() < last_row) rows_removed += range.height();
-    model()->removeRows(range.top(), range.height(), range.parent());
+    for (int row = range.top(); row <= range.bottom(); ++row) {
+      source_rows << playlist_->filter()->mapToSource(model()->index(row, 0, range.parent())).row();
+    }
   }
+  playlist_->removeRows(source_rows);
 
   int new_row = last_row - rows_removed;
   // Index of the first column for the row to select
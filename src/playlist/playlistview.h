@@ -234,6 +234,8 @@ class PlaylistView : public QTreeView {
   bool set_initial_header_layout_;
   bool header_state_loaded_;
   bool header_state_restored_;
+  // The header is restored for every playlist shown, it's only saved once the restore is done.
+  bool restoring_header_state_;
   bool read_only_settings_;
 
   QImage background_image_;
@@ -22,10 +22,13 @@
 #include "config.h"
 
 #include <utility>
+#include <atomic>
 
 #include <QtConcurrentRun>
+#include <QtConcurrentMap>
 #include <QtAlgorithms>
 #include <QList>
+#include <QHash>
 #include <QUrl>
 
 #include "includes/shared_ptr.h"
@@ -33,6 +36,7 @@
 #include "core/urlhandlers.h"
 #include "core/taskmanager.h"
 #include "core/songloader.h"
+#include "collection/collectionbackend.h"
 #include "playlist.h"
 #include "songloaderinserter.h"
 
@@ -66,7 +70,28 @@ void SongLoaderInserter::Load(Playlist *destination, const int row, const bool p
   QObject::connect(this, &SongLoaderInserter::PreloadFinished, this, &SongLoaderInserter::InsertSongs);
   QObject::connect(this, &SongLoaderInserter::EffectiveLoadFinished, destination, &Playlist::UpdateItems);
 
+  // Look up all dropped local files in the collection at once, only the ones not found need a SongLoader.
+  QHash<QUrl, SongList> collection_songs;
+  if (collection_backend_) {
+    QList<QUrl> local_urls;
+    local_urls.reserve(urls.count());
+    for (const QUrl &url : urls) {
+      if (url.isLocalFile()) local_urls << url;
+    }
+    if (!local_urls.isEmpty()) {
+      const SongList songs = collection_backend_->GetSongsByUrls(local_urls);
+      for (const Song &song : songs) {
+        collection_songs[song.url()] << song;
+      }
+    }
+  }
+
   for (const QUrl &url : urls) {
+    if (collection_songs.contains(url)) {
+      songs_ << collection_songs.value(url);
+      continue;
+    }
+
     SongLoader *loader = new SongLoader(url_handlers_, collection_backend_, tagreader_client_, this);
 
     const SongLoader::Result result = loader->Load(url);
@@ -206,7 +231,7 @@ void SongLoaderInserter::AsyncLoad() {
     if (!first_loaded) {
       // Load everything from the first song.
       // It'll start playing as soon as we emit PreloadFinished, so it needs to have the duration set to show properly in the UI.
-      loader->LoadMetadataBlocking();
+      loader->LoadFirstSongMetadataBlocking();
       first_loaded = true;
     }
 
@@ -218,18 +243,18 @@ void SongLoaderInserter::AsyncLoad() {
   Q_EMIT PreloadFinished();
 
   // Songs are inserted in playlist, now load them completely.
-  async_progress = 0;
+  // The loaders are independent of each other, so the tags are read in parallel.
   async_load_id = task_manager_->StartTask(tr("Loading tracks info"));
-  task_manager_->SetTaskProgress(async_load_id, static_cast<quint64>(async_progress), static_cast<quint64>(songs_.count()));
+  task_manager_->SetTaskProgress(async_load_id, 0, static_cast<quint64>(songs_.count()));
+  std::atomic<quint64> loaded_songs = 0;
+  QtConcurrent::blockingMap(pending_, [this, async_load_id, &loaded_songs](SongLoader *loader) {
+    // Songs that are already loaded, like the first song, are skipped.
+    loader->LoadMetadataBlocking();
+    task_manager_->SetTaskProgress(async_load_id, loaded_songs += static_cast<quint64>(loader->songs().count()));
+  });
   SongList songs;
-  for (int i = 0; i < pending_.count(); ++i) {
-    SongLoader *loader = pending_.value(i);
-    if (i != 0) {
-      // We already did this earlier for the first song.
-      loader->LoadMetadataBlocking();
-    }
+  for (SongLoader *loader : std::as_const(pending_)) {
     songs << loader->songs();
-    task_manager_->SetTaskProgress(async_load_id, static_cast<quint64>(songs.count()));
   }
   task_manager_->SetTaskFinished(async_load_id);
 
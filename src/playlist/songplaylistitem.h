@@ -43,6 +43,7 @@ class SongPlaylistItem : public PlaylistItem {
 
   Song OriginalMetadata() const override { return song_; }
   QUrl OriginalUrl() const override { return song_.url(); }
+  void ShareStrings(QSet<QString> &strings, QSet<QUrl> &urls) override { song_.ShareStrings(strings, urls); }
 
   void SetArtManual(const QUrl &cover_url) override;
 
@@ -37,6 +37,7 @@ class StreamPlaylistItem : public PlaylistItem {
   Song OriginalMetadata() const override { return song_; }
   QUrl OriginalUrl() const override { return song_.url(); }
   void SetOriginalMetadata(const Song &song) override { song_ = song; }
+  void ShareStrings(QSet<QString> &strings, QSet<QUrl> &urls) override { song_.ShareStrings(strings, urls); }
   bool InitFromQuery(const SqlRow &query) override;
   void SetArtManual(const QUrl &cover_url) override;
 
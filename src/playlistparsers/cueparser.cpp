@@ -26,11 +26,16 @@
 #include <QFileInfo>
 #include <QDateTime>
 #include <QList>
+#include <QByteArray>
+#include <QByteArrayView>
 #include <QString>
 #include <QStringList>
 #include <QRegularExpression>
-#include <QTextStream>
 #include <QStringConverter>
+#include <QStringDecoder>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QCache>
 
 #include "includes/shared_ptr.h"
 #include "constants/timeconstants.h"
@@ -45,7 +50,6 @@ using namespace Qt::Literals::StringLiterals;
 class CollectionBackendInterface;
 
 namespace {
-constexpr char kFileLineRegExp[] = "(\\S+)\\s+(?:\"([^\"]+)\"|(\\S+))\\s*(?:\"([^\"]+)\"|(\\S+))?";
 constexpr char kIndexRegExp[] = "(\\d{1,3}):(\\d{2}):(\\d{2})";
 
 constexpr char kPerformer[] = "performer";
@@ -61,36 +65,147 @@ constexpr char kRem[] = "rem";
 constexpr char kGenre[] = "genre";
 constexpr char kDate[] = "date";
 constexpr char kDisc[] = "discnumber";
+constexpr char kBinaryFileType[] = "binary";
+constexpr char kMotorolaFileType[] = "motorola";
+constexpr int kMaxCachedCueSheets = 500;
+QMutex sCueEntriesCacheMutex;
+
+bool EqualsIgnoreCase(const QByteArrayView bytes, const char *keyword) {
+  const qsizetype size = static_cast<qsizetype>(qstrlen(keyword));
+  return bytes.size() == size && qstrnicmp(bytes.data(), keyword, static_cast<size_t>(size)) == 0;
+}
+
+bool IsSpace(const char c) {
+  return c == ' ' || c == '\t' || c == '\v' || c == '\f' || c == '\r' || c == '\n';
+}
 }  // namespace
 
 CueParser::CueParser(const SharedPtr<TagReaderClient> tagreader_client, const SharedPtr<CollectionBackendInterface> collection_backend, QObject *parent)
     : ParserBase(tagreader_client, collection_backend, parent) {}
 
+QCache<QString, CueParser::CachedCueEntries> &CueParser::CueEntriesCache() {
+
+  static QCache<QString, CachedCueEntries> cache(kMaxCachedCueSheets);
+  return cache;
+
+}
+
+bool CueParser::CachedEntries(const QString &cue_path, const QString &dir_path, const qint64 mtime, const qint64 size, QList<CueEntry> *entries) {
+
+  QMutexLocker l(&sCueEntriesCacheMutex);
+  const CachedCueEntries *cached_entries = CueEntriesCache().object(cue_path);
+  if (!cached_entries || cached_entries->dir_path != dir_path || cached_entries->mtime != mtime || cached_entries->size != size) {
+    return false;
+  }
+
+  *entries = cached_entries->entries;
+
+  return true;
+
+}
+
+void CueParser::CacheEntries(const QString &cue_path, const QString &dir_path, const qint64 mtime, const qint64 size, const QList<CueEntry> &entries) {
+
+  QMutexLocker l(&sCueEntriesCacheMutex);
+  CueEntriesCache().insert(cue_path, new CachedCueEntries { dir_path, mtime, size, entries });
+
+}
+
 ParserBase::LoadResult CueParser::Load(QIODevice *device, const QString &playlist_path, const QDir &dir, const bool collection_lookup) const {
 
   SongList ret;
 
-  QTextStream text_stream(device);
+  // The collection scan and restoring playlists load the same .cue files over and over, only parse them again when they changed.
+  const QFileInfo cue_fileinfo(playlist_path);
+  const bool cacheable = !playlist_path.isEmpty() && cue_fileinfo.isFile();
+  const QDateTime cue_mtime = cue_fileinfo.lastModified();
+  const qint64 cue_mtime_msec = cue_mtime.isValid() ? cue_mtime.toMSecsSinceEpoch() : 0;
+  const qint64 cue_size = cacheable ? cue_fileinfo.size() : 0;
 
-  const QByteArray data_chunk = device->peek(1024);
+  QList<CueEntry> entries;
+  if (!cacheable || !CachedEntries(playlist_path, dir.absolutePath(), cue_mtime_msec, cue_size, &entries)) {
+    entries = ParseEntries(device, dir);
+    if (cacheable) {
+      CacheEntries(playlist_path, dir.absolutePath(), cue_mtime_msec, cue_size, entries);
+    }
+  }
+
+  // Finalize parsing songs
+  for (int i = 0; i < entries.length(); i++) {
+    CueEntry entry = entries.at(i);
+
+    Song song = LoadSong(entry.file, IndexToMarker(entry.index), 0, dir, collection_lookup);
+
+    // Cue song has mtime equal to qMax(media_file_mtime, cue_sheet_mtime)
+    if (cue_mtime.isValid()) {
+      song.set_mtime(qMax(cue_mtime.toSecsSinceEpoch(), song.mtime()));
+    }
+    song.set_cue_path(playlist_path);
+
+    // Overwrite the stuff, we may have read from the file or collection, using the current .cue metadata
+
+    song.set_track(i + 1);
+
+    // The last TRACK for every FILE gets it's 'end' marker from the media file's length
+    if (i + 1 < entries.size() && entries.at(i).file == entries.at(i + 1).file) {
+      // Incorrect indices?
+      if (!UpdateSong(entry, entries.at(i + 1).index, &song)) {
+        continue;
+      }
+    }
+    else {
+      // Incorrect index?
+      if (!UpdateLastSong(entry, &song)) {
+        continue;
+      }
+    }
 
-  std::optional<QStringConverter::Encoding> encoding = QStringConverter::encodingForData(data_chunk);
-  if (encoding.has_value()) {
-    text_stream.setEncoding(encoding.value());
+    ret << song;
   }
-  else {
-    const QByteArray encoding_name = Utilities::TextEncodingFromData(data_chunk);
+
+  return ret;
+}
+
+QList<CueParser::CueEntry> CueParser::ParseEntries(QIODevice *device, const QDir &dir) {
+
+  const QByteArray data = MapDevice(device);
+  QByteArrayView text(data);
+
+  const QByteArrayView data_chunk = text.first(qMin(text.size(), static_cast<qsizetype>(1024)));
+
+  QStringConverter::Encoding encoding = QStringConverter::Utf8;
+  std::optional<QStringConverter::Encoding> data_encoding = QStringConverter::encodingForData(data_chunk);
+  if (!data_encoding.has_value()) {
+    const QByteArray encoding_name = Utilities::TextEncodingFromData(data_chunk.toByteArray());
     if (!encoding_name.isEmpty()) {
-      encoding = QStringConverter::encodingForName(encoding_name.constData());
-      if (encoding.has_value()) {
-        text_stream.setEncoding(encoding.value());
-      }
+      data_encoding = QStringConverter::encodingForName(encoding_name.constData());
     }
   }
+  if (data_encoding.has_value()) {
+    encoding = data_encoding.value();
+  }
+
+  // The lines are split on the bytes and only the values used are decoded, that works for all encodings where ASCII is a single byte.
+  // UTF-16 and UTF-32 cue sheets are converted to UTF-8 first.
+  QByteArray converted_data;
+  if (encoding != QStringConverter::Utf8 && encoding != QStringConverter::Latin1 && encoding != QStringConverter::System) {
+    QStringDecoder converter(encoding);
+    converted_data = QString(converter(text)).toUtf8();
+    text = converted_data;
+    encoding = QStringConverter::Utf8;
+  }
+  else if (encoding == QStringConverter::Utf8 && text.startsWith("\xEF\xBB\xBF")) {
+    text = text.sliced(3);
+  }
+
+  QStringDecoder decoder(encoding, QStringConverter::Flag::Stateless);
+  const auto decode = [&decoder](const QByteArrayView bytes) { return QString(decoder(bytes)); };
 
   QString dir_path = dir.absolutePath();
   // Read the first line already
-  QString line = text_stream.readLine();
+  qsizetype pos = 0;
+  QByteArrayView line;
+  ReadLine(text, &pos, &line);
 
   QList<CueEntry> entries;
 
@@ -102,70 +217,72 @@ ParserBase::LoadResult CueParser::Load(QIODevice *device, const QString &playlis
   QString disc;
 
   // -- whole file
-  while (!text_stream.atEnd()) {
+  while (pos < text.size()) {
 
     QString file;
-    QString file_type;
+    QByteArrayView file_type;
+    bool has_line = true;
 
     // -- FILE section
     do {
-      QStringList splitted = SplitCueLine(line);
+      const CueLine cue_line = SplitCueLine(line);
 
       // Uninteresting or incorrect line
-      if (splitted.size() < 2) {
+      if (cue_line.size < 2) {
         continue;
       }
-      const QString &line_name = splitted[0];
-      const QString &line_value = splitted[1];
-
-      if (line_name.compare(QLatin1String(kFile), Qt::CaseInsensitive) == 0) {
-        file = QDir::isAbsolutePath(line_value) ? line_value : dir.absoluteFilePath(line_value);
-        if (splitted.size() > 2) {
-          file_type = splitted[2];
+      const QByteArrayView line_name = cue_line.name;
+      const QByteArrayView line_value = cue_line.value;
+
+      if (EqualsIgnoreCase(line_name, kFile)) {
+        const QString filename = decode(line_value);
+        file = QDir::isAbsolutePath(filename) ? filename : dir.absoluteFilePath(filename);
+        if (cue_line.size > 2) {
+          file_type = cue_line.additional;
         }
       }
-      else if (line_name.compare(QLatin1String(kPerformer), Qt::CaseInsensitive) == 0) {
-        album_artist = line_value;
+      else if (EqualsIgnoreCase(line_name, kPerformer)) {
+        album_artist = decode(line_value);
       }
-      else if (line_name.compare(QLatin1String(kTitle), Qt::CaseInsensitive) == 0) {
-        album = line_value;
+      else if (EqualsIgnoreCase(line_name, kTitle)) {
+        album = decode(line_value);
       }
-      else if (line_name.compare(QLatin1String(kSongWriter), Qt::CaseInsensitive) == 0) {
-        album_composer = line_value;
+      else if (EqualsIgnoreCase(line_name, kSongWriter)) {
+        album_composer = decode(line_value);
       }
-      else if (line_name.compare(QLatin1String(kComposer), Qt::CaseInsensitive) == 0) {
-        album_composer = line_value;
+      else if (EqualsIgnoreCase(line_name, kComposer)) {
+        album_composer = decode(line_value);
       }
-      else if (line_name.compare(QLatin1String(kRem), Qt::CaseInsensitive) == 0) {
-        if (splitted.size() < 3) {
+      else if (EqualsIgnoreCase(line_name, kRem)) {
+        if (cue_line.size < 3) {
           break;
         }
-        if (line_value.compare(QLatin1String(kGenre), Qt::CaseInsensitive) == 0) {
-          album_genre = splitted[2];
+        if (EqualsIgnoreCase(line_value, kGenre)) {
+          album_genre = decode(cue_line.additional);
         }
-        else if (line_value.compare(QLatin1String(kDate), Qt::CaseInsensitive) == 0) {
-          album_date = splitted[2];
+        else if (EqualsIgnoreCase(line_value, kDate)) {
+          album_date = decode(cue_line.additional);
         }
-        else if (line_value.compare(QLatin1String(kDisc), Qt::CaseInsensitive) == 0) {
-          disc = splitted[2];
+        else if (EqualsIgnoreCase(line_value, kDisc)) {
+          disc = decode(cue_line.additional);
         }
       }
       // End of the header -> go into the track mode
-      else if (line_name.compare(QLatin1String(kTrack), Qt::CaseInsensitive) == 0) {
+      else if (EqualsIgnoreCase(line_name, kTrack)) {
         break;
       }
       // Ignore the rest of possible field types for now...
-    } while (!(line = text_stream.readLine()).isNull());
+    } while ((has_line = ReadLine(text, &pos, &line)));
 
-    if (line.isNull()) {
+    if (!has_line) {
       qLog(Warning) << "The .cue file from" << dir_path << "defines no tracks!";
-      return ret;
+      return QList<CueEntry>();
     }
 
     // If this is a data file, all of its tracks will be ignored
-    bool valid_file = file_type.compare("BINARY"_L1, Qt::CaseInsensitive) != 0 && file_type.compare("MOTOROLA"_L1, Qt::CaseInsensitive) != 0;
+    bool valid_file = !EqualsIgnoreCase(file_type, kBinaryFileType) && !EqualsIgnoreCase(file_type, kMotorolaFileType);
 
-    QString track_type;
+    QByteArrayView track_type;
     QString index;
     QString artist;
     QString composer;
@@ -175,135 +292,130 @@ ParserBase::LoadResult CueParser::Load(QIODevice *device, const QString &playlis
 
     // TRACK section
     do {
-      QStringList splitted = SplitCueLine(line);
+      const CueLine cue_line = SplitCueLine(line);
 
       // Uninteresting or incorrect line
-      if (splitted.size() < 2) {
+      if (cue_line.size < 2) {
         continue;
       }
 
-      const QString &line_name = splitted[0];
-      const QString &line_value = splitted[1];
-      QString line_additional = splitted.size() > 2 ? splitted[2].toLower() : ""_L1;
+      const QByteArrayView line_name = cue_line.name;
+      const QByteArrayView line_value = cue_line.value;
+      const QByteArrayView line_additional = cue_line.additional;
 
-      if (line_name.compare(QLatin1String(kTrack), Qt::CaseInsensitive) == 0) {
+      if (EqualsIgnoreCase(line_name, kTrack)) {
 
         // The beginning of another track's definition - we're saving the current one for later (if it's valid of course)
         // please note that the same code is repeated just after this 'do-while' loop
-        if (valid_file && !index.isEmpty() && (track_type.isEmpty() || track_type.compare(QLatin1String(kAudioTrackType), Qt::CaseInsensitive) == 0)) {
+        if (valid_file && !index.isEmpty() && (track_type.isEmpty() || EqualsIgnoreCase(track_type, kAudioTrackType))) {
           entries.append(CueEntry(file, index, title, artist, album_artist, album, composer, album_composer, (genre.isEmpty() ? album_genre : genre), (date.isEmpty() ? album_date : date), disc));
         }
 
         // Clear the state
-        track_type = index = artist = composer = title = date = genre = ""_L1;
-
-        if (!line_additional.isEmpty()) {
-          track_type = line_additional;
-        }
+        index = artist = composer = title = date = genre = ""_L1;
+        track_type = line_additional;
 
       }
-      else if (line_name.compare(QLatin1String(kIndex), Qt::CaseInsensitive) == 0) {
+      else if (EqualsIgnoreCase(line_name, kIndex)) {
 
         // We need the index's position field
         if (!line_additional.isEmpty()) {
 
           // If there's none "01" index, we'll just take the first one also, we'll take the "01" index even if it's the last one
-          if (line_value == "01"_L1 || index.isEmpty()) {
+          if (line_value == "01" || index.isEmpty()) {
 
-            index = line_additional;
+            index = decode(line_additional);
           }
         }
       }
-      else if (line_name.compare(QLatin1String(kTitle), Qt::CaseInsensitive) == 0) {
-        title = line_value;
+      else if (EqualsIgnoreCase(line_name, kTitle)) {
+        title = decode(line_value);
       }
-      else if (line_name.compare(QLatin1String(kDate), Qt::CaseInsensitive) == 0) {
-        date = line_value;
+      else if (EqualsIgnoreCase(line_name, kDate)) {
+        date = decode(line_value);
       }
-      else if (line_name.compare(QLatin1String(kPerformer), Qt::CaseInsensitive) == 0) {
-        artist = line_value;
+      else if (EqualsIgnoreCase(line_name, kPerformer)) {
+        artist = decode(line_value);
       }
-      else if (line_name.compare(QLatin1String(kSongWriter), Qt::CaseInsensitive) == 0) {
-        composer = line_value;
+      else if (EqualsIgnoreCase(line_name, kSongWriter)) {
+        composer = decode(line_value);
       }
-      else if (line_name.compare(QLatin1String(kComposer), Qt::CaseInsensitive) == 0) {
-        composer = line_value;
+      else if (EqualsIgnoreCase(line_name, kComposer)) {
+        composer = decode(line_value);
       }
       // End of tracks for the current file -> parse next one
-      else if (line_name.compare(QLatin1String(kRem), Qt::CaseInsensitive) == 0 && splitted.size() >= 3) {
-        if (line_value.compare(QLatin1String(kGenre), Qt::CaseInsensitive) == 0) {
-          genre = splitted[2];
+      else if (EqualsIgnoreCase(line_name, kRem) && cue_line.size >= 3) {
+        if (EqualsIgnoreCase(line_value, kGenre)) {
+          genre = decode(line_additional);
         }
-        else if (line_value.compare(QLatin1String(kDate), Qt::CaseInsensitive) == 0) {
-          date = splitted[2];
+        else if (EqualsIgnoreCase(line_value, kDate)) {
+          date = decode(line_additional);
         }
       }
-      else if (line_name.compare(QLatin1String(kFile), Qt::CaseInsensitive) == 0) {
+      else if (EqualsIgnoreCase(line_name, kFile)) {
         break;
       }
 
       // Just ignore the rest of possible field types for now...
-    } while (!(line = text_stream.readLine()).isNull());
+    } while (ReadLine(text, &pos, &line));
 
     // We didn't add the last song yet...
-    if (valid_file && !index.isEmpty() && (track_type.isEmpty() || track_type.compare(QLatin1String(kAudioTrackType), Qt::CaseInsensitive) == 0)) {
+    if (valid_file && !index.isEmpty() && (track_type.isEmpty() || EqualsIgnoreCase(track_type, kAudioTrackType))) {
       entries.append(CueEntry(file, index, title, artist, album_artist, album, composer, album_composer, (genre.isEmpty() ? album_genre : genre), (date.isEmpty() ? album_date : date), disc));
     }
   }
 
-  QDateTime cue_mtime = QFileInfo(playlist_path).lastModified();
-
-  // Finalize parsing songs
-  for (int i = 0; i < entries.length(); i++) {
-    CueEntry entry = entries.at(i);
-
-    Song song = LoadSong(entry.file, IndexToMarker(entry.index), 0, dir, collection_lookup);
-
-    // Cue song has mtime equal to qMax(media_file_mtime, cue_sheet_mtime)
-    if (cue_mtime.isValid()) {
-      song.set_mtime(qMax(cue_mtime.toSecsSinceEpoch(), song.mtime()));
-    }
-    song.set_cue_path(playlist_path);
-
-    // Overwrite the stuff, we may have read from the file or collection, using the current .cue metadata
+  return entries;
 
-    song.set_track(i + 1);
+}
 
-    // The last TRACK for every FILE gets it's 'end' marker from the media file's length
-    if (i + 1 < entries.size() && entries.at(i).file == entries.at(i + 1).file) {
-      // Incorrect indices?
-      if (!UpdateSong(entry, entries.at(i + 1).index, &song)) {
-        continue;
+// Splits the raw .cue line into the command and up to two values, getting rid of all the unnecessary whitespaces and quoting.
+// A value is either quoted or runs to the next whitespace, a quoted value can be followed by the next value without whitespace.
+// Lines with only a command are not split.
+CueParser::CueLine CueParser::SplitCueLine(const QByteArrayView line) {
+
+  CueLine cue_line;
+
+  const qsizetype size = line.size();
+  qsizetype pos = 0;
+  while (pos < size && IsSpace(line[pos])) ++pos;
+
+  // Reads the next value from 'pos', a "" value is empty.
+  const auto next_value = [&line, size, &pos](QByteArrayView *value) {
+    if (pos + 2 < size && line[pos] == '"' && line[pos + 1] != '"') {
+      const qsizetype quote = line.indexOf('"', pos + 1);
+      if (quote != -1) {
+        *value = line.sliced(pos + 1, quote - pos - 1);
+        pos = quote + 1;
+        return;
       }
     }
-    else {
-      // Incorrect index?
-      if (!UpdateLastSong(entry, &song)) {
-        continue;
-      }
+    const qsizetype start = pos;
+    while (pos < size && !IsSpace(line[pos])) ++pos;
+    *value = line.sliced(start, pos - start);
+    if (*value == "\"\"") {
+      *value = QByteArrayView();
     }
-
-    ret << song;
+  };
+
+  const qsizetype name_start = pos;
+  while (pos < size && !IsSpace(line[pos])) ++pos;
+  const qsizetype name_end = pos;
+  while (pos < size && IsSpace(line[pos])) ++pos;
+  if (name_end == name_start || pos == name_end || pos == size) {
+    return cue_line;
   }
-
-  return ret;
-}
-
-// This and the kFileLineRegExp do most of the "dirty" work, namely: splitting the raw .cue
-// line into logical parts and getting rid of all the unnecessary whitespaces and quoting.
-QStringList CueParser::SplitCueLine(const QString &line) {
-
-  QRegularExpression line_regexp(QString::fromLatin1(kFileLineRegExp));
-  QRegularExpressionMatch re_match = line_regexp.match(line.trimmed());
-  if (!re_match.hasMatch()) {
-    return QStringList();
+  cue_line.name = line.sliced(name_start, name_end - name_start);
+  next_value(&cue_line.value);
+  cue_line.size = 2;
+
+  while (pos < size && IsSpace(line[pos])) ++pos;
+  if (pos < size) {
+    next_value(&cue_line.additional);
+    cue_line.size = 3;
   }
 
-  // Let's remove the empty entries while we're at it
-  static const QRegularExpression regex_entry(u".+"_s);
-  static const QRegularExpression regex_exclude(u"^\"\"$"_s);
-  QStringList str = re_match.capturedTexts().filter(regex_entry).mid(1, -1);
-  return str.replaceInStrings(regex_exclude, ""_L1);
+  return cue_line;
 
 }
 
@@ -367,7 +479,7 @@ bool CueParser::UpdateLastSong(const CueEntry &entry, Song *song) {
 
 qint64 CueParser::IndexToMarker(const QString &index) {
 
-  QRegularExpression index_regexp(QString::fromLatin1(kIndexRegExp));
+  static const QRegularExpression index_regexp(QString::fromLatin1(kIndexRegExp));
   QRegularExpressionMatch re_match = index_regexp.match(index);
   if (!re_match.hasMatch()) {
     return -1;
@@ -27,6 +27,9 @@
 #include <QtGlobal>
 #include <QObject>
 #include <QByteArray>
+#include <QList>
+#include <QCache>
+#include <QByteArrayView>
 #include <QString>
 #include <QStringList>
 #include <QDir>
@@ -61,6 +64,10 @@ class CueParser : public ParserBase {
 
   static QString FindCueFilename(const QString &filename);
 
+ protected:
+  // The end of the last track is taken from the length of the media file.
+  bool can_defer_tag_reading() const override { return false; }
+
  private:
   // A single TRACK entry in .cue file.
   struct CueEntry {
@@ -87,10 +94,32 @@ class CueParser : public ParserBase {
     file(_file), index(_index), title(_title), artist(_artist), album_artist(_album_artist), album(_album), composer(_composer), album_composer(_album_composer), genre(_genre), date(_date), disc(_disc) {}
   };
 
+  // Parsed entries of a .cue file, shared by all parsers and reused while the file is unchanged.
+  struct CachedCueEntries {
+    QString dir_path;
+    qint64 mtime;
+    qint64 size;
+    QList<CueEntry> entries;
+  };
+  static QCache<QString, CachedCueEntries> &CueEntriesCache();
+  static bool CachedEntries(const QString &cue_path, const QString &dir_path, const qint64 mtime, const qint64 size, QList<CueEntry> *entries);
+  static void CacheEntries(const QString &cue_path, const QString &dir_path, const qint64 mtime, const qint64 size, const QList<CueEntry> &entries);
+
+  static QList<CueEntry> ParseEntries(QIODevice *device, const QDir &dir);
+
   static bool UpdateSong(const CueEntry &entry, const QString &next_index, Song *song);
   static bool UpdateLastSong(const CueEntry &entry, Song *song);
 
-  static QStringList SplitCueLine(const QString &line);
+  // A .cue line split into the command and up to two values, size is 0 when the line has no value.
+  struct CueLine {
+    CueLine() : size(0) {}
+    QByteArrayView name;
+    QByteArrayView value;
+    QByteArrayView additional;
+    int size;
+  };
+
+  static CueLine SplitCueLine(const QByteArrayView line);
   static qint64 IndexToMarker(const QString &index);
 };
 
@@ -21,8 +21,8 @@
 #include <QObject>
 #include <QIODevice>
 #include <QDir>
-#include <QBuffer>
 #include <QByteArray>
+#include <QByteArrayView>
 #include <QString>
 #include <QStringList>
 #include <QSettings>
@@ -49,32 +49,36 @@ ParserBase::LoadResult M3UParser::Load(QIODevice *device, const QString &playlis
   M3UType type = M3UType::STANDARD;
   Metadata current_metadata;
 
-  QString data = QString::fromUtf8(device->readAll());
-  data.replace(u'\r', u'\n');
-  data.replace("\n\n"_L1, "\n"_L1);
-  QByteArray bytes = data.toUtf8();
-  QBuffer buffer(&bytes);
-  if (!buffer.open(QIODevice::ReadOnly)) return SongList();
+  // The lines are split on the bytes, only the filenames and metadata are decoded.
+  const QByteArray data = MapDevice(device);
+  QByteArrayView text(data);
+  if (text.startsWith("\xEF\xBB\xBF")) {
+    text = text.sliced(3);
+  }
 
-  QString line = QString::fromUtf8(buffer.readLine()).trimmed();
-  if (line.startsWith("#EXTM3U"_L1)) {
+  qsizetype pos = 0;
+  QByteArrayView line;
+  if (!ReadLine(text, &pos, &line)) return SongList();
+  line = line.trimmed();
+  if (line.startsWith("#EXTM3U")) {
     // This is in extended M3U format.
     type = M3UType::EXTENDED;
-    line = QString::fromUtf8(buffer.readLine()).trimmed();
+    if (!ReadLine(text, &pos, &line)) return SongList();
+    line = line.trimmed();
   }
 
   SongList ret;
   Q_FOREVER {
-    if (line.startsWith(u'#')) {
+    if (line.startsWith('#')) {
       // Extended info or comment.
-      if (type == M3UType::EXTENDED && line.startsWith("#EXT"_L1)) {
+      if (type == M3UType::EXTENDED && line.startsWith("#EXT")) {
         if (!ParseMetadata(line, &current_metadata)) {
-          qLog(Warning) << "Failed to parse metadata: " << line;
+          qLog(Warning) << "Failed to parse metadata: " << QString::fromUtf8(line);
         }
       }
     }
     else if (!line.isEmpty()) {
-      Song song = LoadSong(line, 0, 0, dir, collection_lookup);
+      Song song = LoadSong(QString::fromUtf8(line), 0, 0, dir, collection_lookup);
       if (!current_metadata.title.isEmpty()) {
         song.set_title(current_metadata.title);
       }
@@ -88,39 +92,43 @@ ParserBase::LoadResult M3UParser::Load(QIODevice *device, const QString &playlis
 
       current_metadata = Metadata();
     }
-    if (buffer.atEnd()) {
+    if (!ReadLine(text, &pos, &line)) {
       break;
     }
-    line = QString::fromUtf8(buffer.readLine()).trimmed();
+    line = line.trimmed();
   }
 
-  buffer.close();
-
   return ret;
 
 }
 
-bool M3UParser::ParseMetadata(const QString &line, M3UParser::Metadata *metadata) {
+bool M3UParser::ParseMetadata(const QByteArrayView line, M3UParser::Metadata *metadata) {
 
   // Extended info, eg.
   // #EXTINF:123,Sample Artist - Sample title
-  QString info = line.section(u':', 1);
-  QString l = info.section(u',', 0, 0);
+  const qsizetype colon = line.indexOf(':');
+  if (colon == -1) {
+    return false;
+  }
+  const QByteArrayView info = line.sliced(colon + 1);
+  const qsizetype comma = info.indexOf(',');
   bool ok = false;
-  int length = l.toInt(&ok);
+  const int length = (comma == -1 ? info : info.first(comma)).toInt(&ok);
   if (!ok) {
     return false;
   }
   metadata->length = length * kNsecPerSec;
 
-  QString track_info = info.section(u',', 1);
-  QStringList list = track_info.split(u" - "_s);
-  if (list.size() <= 1) {
-    metadata->title = track_info;
+  const QByteArrayView track_info = comma == -1 ? QByteArrayView() : info.sliced(comma + 1);
+  const qsizetype artist_end = track_info.indexOf(" - ");
+  if (artist_end == -1) {
+    metadata->title = QString::fromUtf8(track_info);
     return true;
   }
-  metadata->artist = list[0].trimmed();
-  metadata->title = list[1].trimmed();
+  const QByteArrayView title = track_info.sliced(artist_end + 3);
+  const qsizetype title_end = title.indexOf(" - ");
+  metadata->artist = QString::fromUtf8(track_info.first(artist_end)).trimmed();
+  metadata->title = QString::fromUtf8(title_end == -1 ? title : title.first(title_end)).trimmed();
   return true;
 
 }
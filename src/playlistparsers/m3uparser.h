@@ -26,6 +26,7 @@
 #include <QtGlobal>
 #include <QObject>
 #include <QByteArray>
+#include <QByteArrayView>
 #include <QString>
 #include <QStringList>
 #include <QDir>
@@ -70,7 +71,7 @@ class M3UParser : public ParserBase {
     qint64 length;
   };
 
-  static bool ParseMetadata(const QString &line, Metadata *metadata);
+  static bool ParseMetadata(const QByteArrayView line, Metadata *metadata);
 };
 
 #endif  // M3UPARSER_H
@@ -20,9 +20,12 @@
  */
 
 #include <QtGlobal>
+#include <QIODevice>
 #include <QDir>
 #include <QFile>
 #include <QFileInfo>
+#include <QByteArray>
+#include <QByteArrayView>
 #include <QString>
 #include <QRegularExpression>
 #include <QUrl>
@@ -37,7 +40,7 @@
 using namespace Qt::Literals::StringLiterals;
 
 ParserBase::ParserBase(const SharedPtr<TagReaderClient> tagreader_client, const SharedPtr<CollectionBackendInterface> collection_backend, QObject *parent)
-    : QObject(parent), tagreader_client_(tagreader_client), collection_backend_(collection_backend) {}
+    : QObject(parent), tagreader_client_(tagreader_client), collection_backend_(collection_backend), read_tags_(true) {}
 
 void ParserBase::LoadSong(const QString &filename_or_url, const qint64 beginning, const int track, const QDir &dir, Song *song, const bool collection_lookup) const {
 
@@ -119,6 +122,11 @@ void ParserBase::LoadSong(const QString &filename_or_url, const qint64 beginning
     return;
   }
 
+  if (!read_tags_ && can_defer_tag_reading()) {
+    song->InitFromFilePartial(filename, QFileInfo(filename));
+    return;
+  }
+
   if (tagreader_client_) {
     const TagReaderResult result = tagreader_client_->ReadFileBlocking(filename, song);
     if (!result.success()) {
@@ -155,3 +163,43 @@ QString ParserBase::URLOrFilename(const QUrl &url, const QDir &dir, const Playli
   return filename;
 
 }
+
+QByteArray ParserBase::MapDevice(QIODevice *device) {
+
+  QFile *file = qobject_cast<QFile*>(device);
+  if (file && !file->isSequential()) {
+    const qint64 pos = file->pos();
+    const qint64 size = file->size() - pos;
+    if (size <= 0) return QByteArray();
+    uchar *data = file->map(pos, size);
+    if (data) {
+      file->seek(pos + size);
+      return QByteArray::fromRawData(reinterpret_cast<const char*>(data), static_cast<qsizetype>(size));
+    }
+  }
+
+  return device->readAll();
+
+}
+
+bool ParserBase::ReadLine(const QByteArrayView data, qsizetype *pos, QByteArrayView *line) {
+
+  if (*pos >= data.size()) return false;
+
+  qsizetype end = *pos;
+  while (end < data.size() && data[end] != '\n' && data[end] != '\r') {
+    ++end;
+  }
+  *line = data.sliced(*pos, end - *pos);
+
+  if (end < data.size()) {
+    if (data[end] == '\r' && end + 1 < data.size() && data[end + 1] == '\n') {
+      ++end;
+    }
+    ++end;
+  }
+  *pos = end;
+
+  return true;
+
+}
@@ -28,6 +28,7 @@
 #include <QObject>
 #include <QDir>
 #include <QByteArray>
+#include <QByteArrayView>
 #include <QString>
 #include <QStringList>
 #include <QUrl>
@@ -69,6 +70,10 @@ class ParserBase : public QObject {
   virtual LoadResult Load(QIODevice *device, const QString &playlist_path = QLatin1String(""), const QDir &dir = QDir(), const bool collection_lookup = true) const = 0;
   virtual void Save(const QString &playlist_name, const SongList &songs, QIODevice *device, const QDir &dir = QDir(), const PlaylistSettings::PathType path_type = PlaylistSettings::PathType::Automatic) const = 0;
 
+  // When disabled, local files not found in the collection are only initialized from the filename while parsing,
+  // and the caller is responsible for reading the tags later, see SongLoader::LoadMetadataBlocking().
+  void set_read_tags(const bool read_tags) { read_tags_ = read_tags; }
+
  Q_SIGNALS:
   void Error(const QString &error) const;
 
@@ -83,9 +88,19 @@ class ParserBase : public QObject {
   // Otherwise, returns the URL as is. This function should always be used when saving a playlist.
   static QString URLOrFilename(const QUrl &url, const QDir &dir, const PlaylistSettings::PathType path_type);
 
+  // Returns the rest of the device, a file is memory-mapped instead of copied, the data is only valid until the file is closed.
+  static QByteArray MapDevice(QIODevice *device);
+
+  // Reads the line at 'pos' without the line ending (\n, \r\n or \r) and moves 'pos' to the next line, returns false at the end of the data.
+  static bool ReadLine(const QByteArrayView data, qsizetype *pos, QByteArrayView *line);
+
+  // Parsers that need the tags of the media files while parsing return false, they always read the tags.
+  virtual bool can_defer_tag_reading() const { return true; }
+
  private:
   const SharedPtr<TagReaderClient> tagreader_client_;
   const SharedPtr<CollectionBackendInterface> collection_backend_;
+  bool read_tags_;
 };
 
 #endif  // PARSERBASE_H
@@ -19,6 +19,7 @@
  */
 
 #include <algorithm>
+#include <utility>
 
 #include <QObject>
 #include <QIODevice>
@@ -69,6 +70,14 @@ void PlaylistParser::AddParser(ParserBase *parser) {
 
 }
 
+void PlaylistParser::SetReadTags(const bool read_tags) {
+
+  for (ParserBase *parser : std::as_const(parsers_)) {
+    parser->set_read_tags(read_tags);
+  }
+
+}
+
 QStringList PlaylistParser::file_extensions(const Type type) const {
 
   QStringList ret;
@@ -68,6 +68,9 @@ class PlaylistParser : public QObject {
   SongList LoadFromDevice(QIODevice *device, const QString &path_hint = QString(), const QDir &dir_hint = QDir()) const;
   void Save(const QString &playlist_name, const SongList &songs, const QString &filename, const PlaylistSettings::PathType) const;
 
+  // See ParserBase::set_read_tags().
+  void SetReadTags(const bool read_tags);
+
  Q_SIGNALS:
   void Error(const QString &error) const;
 
@@ -104,6 +104,7 @@ QNetworkReply *QobuzBaseRequest::CreateRequest(const QString &ressource_name, co
   QNetworkReply *reply = network_->get(network_request);
   replies_ << reply;
   QObject::connect(reply, &QNetworkReply::sslErrors, this, &QobuzBaseRequest::HandleSSLErrors);
+  service_->request_limiter()->Monitor(reply, this);
 
   qLog(Debug) << "Qobuz: Sending request" << url;
 
@@ -41,6 +41,7 @@
 #include "core/song.h"
 #include "core/networkaccessmanager.h"
 #include "constants/timeconstants.h"
+#include "collection/collectionbackend.h"
 #include "utilities/imageutils.h"
 #include "utilities/coverutils.h"
 #include "qobuzservice.h"
@@ -51,13 +52,9 @@
 using namespace Qt::Literals::StringLiterals;
 
 namespace {
-constexpr int kMaxConcurrentArtistsRequests = 3;
-constexpr int kMaxConcurrentAlbumsRequests = 3;
-constexpr int kMaxConcurrentSongsRequests = 3;
-constexpr int kMaxConcurrentArtistAlbumsRequests = 3;
-constexpr int kMaxConcurrentAlbumSongsRequests = 3;
 constexpr int kMaxConcurrentAlbumCoverRequests = 1;
 constexpr int kFlushRequestsDelay = 200;
+constexpr int kCollectionSongsId = 1;
 }  // namespace
 
 QobuzRequest::QobuzRequest(QobuzService *service, QobuzUrlHandler *url_handler, const SharedPtr<NetworkAccessManager> network, const Type query_type, QObject *parent)
@@ -95,6 +92,7 @@ QobuzRequest::QobuzRequest(QobuzService *service, QobuzUrlHandler *url_handler,
       album_covers_requests_total_(0),
       album_covers_requests_active_(0),
       album_covers_requests_received_(0),
+      collection_albums_reused_(0),
       no_results_(false) {
 
   timer_flush_requests_->setInterval(kFlushRequestsDelay);
@@ -131,6 +129,29 @@ void QobuzRequest::Process() {
 
 }
 
+void QobuzRequest::Process(SharedPtr<CollectionBackend> collection_backend) {
+
+  QObject::connect(&*collection_backend, &CollectionBackend::GotSongs, this, &QobuzRequest::CollectionSongsLoaded);
+  collection_backend->GetAllSongsAsync(kCollectionSongsId);
+
+}
+
+void QobuzRequest::CollectionSongsLoaded(const SongList &songs, const int id) {
+
+  if (id != kCollectionSongsId) return;
+
+  QObject::disconnect(sender(), nullptr, this, nullptr);
+
+  for (const Song &song : songs) {
+    if (!song.album_id().isEmpty() && !song.song_id().isEmpty()) {
+      collection_album_songs_.insert(song.album_id(), song);
+    }
+  }
+
+  Process();
+
+}
+
 void QobuzRequest::StartRequests() {
 
   if (!timer_flush_requests_->isActive()) {
@@ -203,7 +224,7 @@ void QobuzRequest::AddArtistsRequest(const int offset, const int limit) {
 
 void QobuzRequest::FlushArtistsRequests() {
 
-  while (!artists_requests_queue_.isEmpty() && artists_requests_active_ < kMaxConcurrentArtistsRequests) {
+  while (!artists_requests_queue_.isEmpty() && artists_requests_active_ < service_->request_limiter()->concurrent_requests() && service_->request_limiter()->TryAcquire()) {
 
     const Request request = artists_requests_queue_.dequeue();
 
@@ -255,7 +276,7 @@ void QobuzRequest::AddAlbumsRequest(const int offset, const int limit) {
 
 void QobuzRequest::FlushAlbumsRequests() {
 
-  while (!albums_requests_queue_.isEmpty() && albums_requests_active_ < kMaxConcurrentAlbumsRequests) {
+  while (!albums_requests_queue_.isEmpty() && albums_requests_active_ < service_->request_limiter()->concurrent_requests() && service_->request_limiter()->TryAcquire()) {
 
     const Request request = albums_requests_queue_.dequeue();
 
@@ -307,7 +328,7 @@ void QobuzRequest::AddSongsRequest(const int offset, const int limit) {
 
 void QobuzRequest::FlushSongsRequests() {
 
-  while (!songs_requests_queue_.isEmpty() && songs_requests_active_ < kMaxConcurrentSongsRequests) {
+  while (!songs_requests_queue_.isEmpty() && songs_requests_active_ < service_->request_limiter()->concurrent_requests() && service_->request_limiter()->TryAcquire()) {
 
     const Request request = songs_requests_queue_.dequeue();
 
@@ -507,9 +528,9 @@ void QobuzRequest::ArtistsFinishCheck(const int limit, const int offset, const i
 
   if (finished_) return;
 
-  if ((limit == 0 || limit > artists_received) && artists_received_ < artists_total_) {
-    int offset_next = offset + artists_received;
-    if (offset_next > 0 && offset_next < artists_total_) {
+  // The total is known from the first page, so the remaining pages are requested in parallel.
+  if (offset == 0 && artists_received > 0 && (limit == 0 || limit > artists_received) && artists_received_ < artists_total_) {
+    for (int offset_next = artists_received; offset_next < artists_total_; offset_next += artists_received) {
       if (query_type_ == Type::FavouriteArtists) AddArtistsRequest(offset_next);
       else if (query_type_ == Type::SearchArtists) AddArtistsSearchRequest(offset_next);
     }
@@ -559,7 +580,7 @@ void QobuzRequest::AddArtistAlbumsRequest(const Artist &artist, const int offset
 
 void QobuzRequest::FlushArtistAlbumsRequests() {
 
-  while (!artist_albums_requests_queue_.isEmpty() && artist_albums_requests_active_ < kMaxConcurrentArtistAlbumsRequests) {
+  while (!artist_albums_requests_queue_.isEmpty() && artist_albums_requests_active_ < service_->request_limiter()->concurrent_requests() && service_->request_limiter()->TryAcquire()) {
 
     const ArtistAlbumsRequest request = artist_albums_requests_queue_.dequeue();
 
@@ -694,6 +715,7 @@ void QobuzRequest::AlbumsReceived(QNetworkReply *reply, const Artist &artist_req
       album.album_id = QString::number(obj_item["id"_L1].toInt());
     }
     album.album = obj_item["title"_L1].toString();
+    album.songs_total = obj_item["tracks_count"_L1].toInt();
 
     if (obj_item.contains("genre"_L1)) {
       QJsonValue value_genre = obj_item["genre"_L1];
@@ -750,9 +772,8 @@ void QobuzRequest::AlbumsFinishCheck(const Artist &artist, const int limit, cons
 
   if (finished_) return;
 
-  if (limit == 0 || limit > albums_received) {
-    int offset_next = offset + albums_received;
-    if (offset_next > 0 && offset_next < albums_total) {
+  if (offset == 0 && albums_received > 0 && limit == 0 || limit > albums_received) {
+    for (int offset_next = albums_received; offset_next < albums_total; offset_next += albums_received) {
       switch (query_type_) {
         case Type::FavouriteAlbums:
           AddAlbumsRequest(offset_next);
@@ -783,10 +804,15 @@ void QobuzRequest::AlbumsFinishCheck(const Artist &artist, const int limit, cons
 
     for (QHash<QString, AlbumSongsRequest>::const_iterator it = album_songs_requests_pending_.constBegin(); it != album_songs_requests_pending_.constEnd(); ++it) {
       const AlbumSongsRequest &request = it.value();
+      if (AddCollectionAlbumSongs(request.album)) continue;
       AddAlbumSongsRequest(request.artist, request.album);
     }
     album_songs_requests_pending_.clear();
 
+    if (collection_albums_reused_ > 0) {
+      qLog(Debug) << "Qobuz: Using songs from the collection for" << collection_albums_reused_ << "albums";
+    }
+
     if (album_songs_requests_total_ > 0) {
       if (album_songs_requests_total_ == 1) Q_EMIT UpdateStatus(query_id_, tr("Receiving songs for %1 album...").arg(album_songs_requests_total_));
       else Q_EMIT UpdateStatus(query_id_, tr("Receiving songs for %1 albums...").arg(album_songs_requests_total_));
@@ -807,6 +833,20 @@ void QobuzRequest::SongsReplyReceived(QNetworkReply *reply, const int limit_requ
 
 }
 
+bool QobuzRequest::AddCollectionAlbumSongs(const Album &album) {
+
+  if (album.songs_total <= 0 || collection_album_songs_.count(album.album_id) != album.songs_total) return false;
+
+  const SongList songs = collection_album_songs_.values(album.album_id);
+  for (const Song &song : songs) {
+    songs_.insert(song.song_id(), song);
+  }
+  ++collection_albums_reused_;
+
+  return true;
+
+}
+
 void QobuzRequest::AddAlbumSongsRequest(const Artist &artist, const Album &album, const int offset) {
 
   AlbumSongsRequest request;
@@ -823,7 +863,7 @@ void QobuzRequest::AddAlbumSongsRequest(const Artist &artist, const Album &album
 
 void QobuzRequest::FlushAlbumSongsRequests() {
 
-  while (!album_songs_requests_queue_.isEmpty() && album_songs_requests_active_ < kMaxConcurrentAlbumSongsRequests) {
+  while (!album_songs_requests_queue_.isEmpty() && album_songs_requests_active_ < service_->request_limiter()->concurrent_requests() && service_->request_limiter()->TryAcquire()) {
 
     const AlbumSongsRequest request = album_songs_requests_queue_.dequeue();
     ParamList params = ParamList() << Param(u"album_id"_s, request.album.album_id);
@@ -1000,12 +1040,16 @@ void QobuzRequest::SongsReceived(QNetworkReply *reply, const Artist &artist_requ
     songs << song;
   }
 
-  for (Song song : std::as_const(songs)) {
+  for (Song &song : songs) {
     if (compilation) song.set_compilation_detected(true);
     if (!multidisc) song.set_disc(0);
     songs_.insert(song.song_id(), song);
   }
 
+  if (IsSearch() && !songs.isEmpty()) {
+    Q_EMIT PartialResults(query_id_, songs);
+  }
+
   if (query_type_ == Type::FavouriteSongs || query_type_ == Type::SearchSongs) {
     songs_received_ += songs_received;
     Q_EMIT UpdateProgress(query_id_, GetProgress(songs_received_, songs_total_));
@@ -1017,9 +1061,8 @@ void QobuzRequest::SongsFinishCheck(const Artist &artist, const Album &album, co
 
   if (finished_) return;
 
-  if (limit == 0 || limit > songs_received) {
-    int offset_next = offset + songs_received;
-    if (offset_next > 0 && offset_next < songs_total) {
+  if (offset == 0 && songs_received > 0 && limit == 0 || limit > songs_received) {
+    for (int offset_next = songs_received; offset_next < songs_total; offset_next += songs_received) {
       switch (query_type_) {
         case Type::FavouriteSongs:
           AddSongsRequest(offset_next);
@@ -1272,7 +1315,7 @@ void QobuzRequest::GetAlbumCovers() {
 void QobuzRequest::AddAlbumCoverRequest(const Song &song) {
 
   QUrl cover_url = song.art_automatic();
-  if (!cover_url.isValid()) return;
+  if (!cover_url.isValid() || cover_url.isLocalFile()) return;
 
   if (album_covers_requests_sent_.contains(cover_url)) {
     album_covers_requests_sent_.insert(cover_url, song.song_id());
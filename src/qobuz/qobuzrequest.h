@@ -23,6 +23,7 @@
 #include "config.h"
 
 #include <QHash>
+#include <QMultiHash>
 #include <QMap>
 #include <QMultiMap>
 #include <QQueue>
@@ -42,6 +43,7 @@ class QTimer;
 class NetworkAccessManager;
 class QobuzService;
 class QobuzUrlHandler;
+class CollectionBackend;
 
 class QobuzRequest : public QobuzBaseRequest {
   Q_OBJECT
@@ -52,6 +54,8 @@ class QobuzRequest : public QobuzBaseRequest {
   void ReloadSettings();
 
   void Process();
+  // Loads the songs already in the collection first, albums with an unchanged number of songs are then not requested again.
+  void Process(SharedPtr<CollectionBackend> collection_backend);
   void Search(const int query_id, const QString &search_text);
 
  private:
@@ -60,12 +64,13 @@ class QobuzRequest : public QobuzBaseRequest {
     QString artist;
   };
   struct Album {
-    Album() : album_explicit(false) {}
+    Album() : album_explicit(false), songs_total(0) {}
     QString album_id;
     QString album;
     QUrl cover_url;
     bool album_explicit;
     QString genre;
+    int songs_total;
   };
   struct Request {
     Request() : offset(0), limit(0) {}
@@ -94,6 +99,7 @@ class QobuzRequest : public QobuzBaseRequest {
 
  Q_SIGNALS:
   void Results(const int id, const SongMap &songs, const QString &error);
+  void PartialResults(const int id, const SongList &songs);
   void UpdateStatus(const int id, const QString &text);
   void UpdateProgress(const int id, const int max);
   void StreamURLFinished(const QUrl &media_url, const QUrl &url, const Song::FileType filetype, const QString &error = QString());
@@ -110,6 +116,7 @@ class QobuzRequest : public QobuzBaseRequest {
   void ArtistAlbumsReplyReceived(QNetworkReply *reply, const QobuzRequest::Artist &artist, const int offset_requested);
   void AlbumSongsReplyReceived(QNetworkReply *reply, const QobuzRequest::Artist &artist, const QobuzRequest::Album &album, const int offset_requested);
   void AlbumCoverReceived(QNetworkReply *reply, const QUrl &cover_url, const QString &filename);
+  void CollectionSongsLoaded(const SongList &songs, const int id);
 
  private:
   bool IsQuery() const { return (query_type_ == Type::FavouriteArtists || query_type_ == Type::FavouriteAlbums || query_type_ == Type::FavouriteSongs); }
@@ -145,6 +152,7 @@ class QobuzRequest : public QobuzBaseRequest {
 
   void AddAlbumSongsRequest(const Artist &artist, const Album &album, const int offset = 0);
   void FlushAlbumSongsRequests();
+  bool AddCollectionAlbumSongs(const Album &album);
 
   void ParseSong(Song &song, const QJsonObject &json_obj, const Artist &album_artist, const Album &album);
 
@@ -217,6 +225,9 @@ class QobuzRequest : public QobuzBaseRequest {
   int album_covers_requests_active_;
   int album_covers_requests_received_;
 
+  QMultiHash<QString, Song> collection_album_songs_;
+  int collection_albums_reused_;
+
   SongMap songs_;
   bool no_results_;
   QString error_;
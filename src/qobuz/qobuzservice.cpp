@@ -25,6 +25,7 @@
 #include <QPair>
 #include <QList>
 #include <QString>
+#include <QStringList>
 #include <QUrl>
 #include <QUrlQuery>
 #include <QNetworkRequest>
@@ -72,6 +73,10 @@ constexpr char kArtistsSongsTable[] = "qobuz_artists_songs";
 constexpr char kAlbumsSongsTable[] = "qobuz_albums_songs";
 constexpr char kSongsTable[] = "qobuz_songs";
 
+constexpr int kInitialConcurrentRequests = 3;
+constexpr int kMaxConcurrentRequests = 6;
+constexpr double kRequestsPerSecond = 5.0;
+
 }  // namespace
 
 QobuzService::QobuzService(const SharedPtr<TaskManager> task_manager,
@@ -90,6 +95,7 @@ QobuzService::QobuzService(const SharedPtr<TaskManager> task_manager,
       albums_collection_model_(nullptr),
       songs_collection_model_(nullptr),
       timer_search_delay_(new QTimer(this)),
+      request_limiter_(kInitialConcurrentRequests, kMaxConcurrentRequests, kRequestsPerSecond),
       favorite_request_(new QobuzFavoriteRequest(this, network_, this)),
       local_redirect_server_(nullptr),
       format_(0),
@@ -110,6 +116,9 @@ QobuzService::QobuzService(const SharedPtr<TaskManager> task_manager,
 
   // Backends
 
+  // The songs were in the main database before the service had its own database file.
+  database->ImportSongsTables(QStringList() << QLatin1String(kArtistsSongsTable) << QLatin1String(kAlbumsSongsTable) << QLatin1String(kSongsTable));
+
   artists_collection_backend_ = make_shared<CollectionBackend>();
   artists_collection_backend_->moveToThread(database->thread());
   artists_collection_backend_->Init(database, task_manager, Song::Source::Qobuz, QLatin1String(kArtistsSongsTable));
@@ -483,7 +492,7 @@ void QobuzService::GetArtists() {
   QObject::connect(&*artists_request_, &QobuzRequest::UpdateStatus, this, &QobuzService::ArtistsUpdateStatusReceived);
   QObject::connect(&*artists_request_, &QobuzRequest::UpdateProgress, this, &QobuzService::ArtistsUpdateProgressReceived);
 
-  artists_request_->Process();
+  artists_request_->Process(artists_collection_backend_);
 
 }
 
@@ -532,7 +541,7 @@ void QobuzService::GetAlbums() {
   QObject::connect(&*albums_request_, &QobuzRequest::UpdateStatus, this, &QobuzService::AlbumsUpdateStatusReceived);
   QObject::connect(&*albums_request_, &QobuzRequest::UpdateProgress, this, &QobuzService::AlbumsUpdateProgressReceived);
 
-  albums_request_->Process();
+  albums_request_->Process(albums_collection_backend_);
 
 }
 
@@ -636,7 +645,12 @@ void QobuzService::StartSearch() {
 
 }
 
-void QobuzService::CancelSearch() {}
+void QobuzService::CancelSearch() {
+
+  timer_search_delay_->stop();
+  search_request_.reset();
+
+}
 
 void QobuzService::SendSearch() {
 
@@ -656,6 +670,7 @@ void QobuzService::SendSearch() {
 
   search_request_.reset(new QobuzRequest(this, url_handler_, network_, query_type));
   QObject::connect(&*search_request_, &QobuzRequest::Results, this, &QobuzService::SearchResultsReceived);
+  QObject::connect(&*search_request_, &QobuzRequest::PartialResults, this, &QobuzService::SearchPartialResults);
   QObject::connect(&*search_request_, &QobuzRequest::UpdateStatus, this, &QobuzService::SearchUpdateStatus);
   QObject::connect(&*search_request_, &QobuzRequest::UpdateProgress, this, &QobuzService::SearchUpdateProgress);
   search_request_->Search(search_id_, search_text_);
@@ -41,6 +41,7 @@
 #include "includes/shared_ptr.h"
 #include "core/song.h"
 #include "streaming/streamingservice.h"
+#include "streaming/streamingrequestlimiter.h"
 #include "streaming/streamingsearchview.h"
 
 class QTimer;
@@ -93,6 +94,7 @@ class QobuzService : public StreamingService {
   int albumssearchlimit() const { return albumssearchlimit_; }
   int songssearchlimit() const { return songssearchlimit_; }
   bool download_album_covers() const { return download_album_covers_; }
+  StreamingRequestLimiter *request_limiter() { return &request_limiter_; }
   bool remove_remastered() const { return remove_remastered_; }
 
   QString user_auth_token() const { return user_auth_token_; }
@@ -166,6 +168,8 @@ class QobuzService : public StreamingService {
 
   QTimer *timer_search_delay_;
 
+  StreamingRequestLimiter request_limiter_;
+
   QobuzRequestPtr artists_request_;
   QobuzRequestPtr albums_request_;
   QobuzRequestPtr songs_request_;
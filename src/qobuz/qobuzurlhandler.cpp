@@ -39,6 +39,11 @@ QobuzUrlHandler::QobuzUrlHandler(const SharedPtr<TaskManager> task_manager, Qobu
 
 UrlHandler::LoadResult QobuzUrlHandler::StartLoading(const QUrl &url) {
 
+  LoadResult cached_result;
+  if (stream_url_cache_.Find(url, &cached_result)) {
+    return cached_result;
+  }
+
   Request req;
   req.task_id = task_manager_->StartTask(QStringLiteral("Loading %1 stream...").arg(url.scheme()));
   QString error;
@@ -73,7 +78,16 @@ void QobuzUrlHandler::GetStreamURLSuccess(const uint id, const QUrl &media_url,
   Request req = requests_.take(id);
   CancelTask(req.task_id);
 
-  Q_EMIT AsyncLoadComplete(LoadResult(media_url, LoadResult::Type::TrackAvailable, stream_url, filetype, samplerate, bit_depth, duration));
+  const LoadResult result(media_url, LoadResult::Type::TrackAvailable, stream_url, filetype, samplerate, bit_depth, duration);
+  stream_url_cache_.Insert(result);
+
+  Q_EMIT AsyncLoadComplete(result);
+
+}
+
+void QobuzUrlHandler::InvalidateStreamUrl(const QUrl &url) {
+
+  stream_url_cache_.Remove(url);
 
 }
 
@@ -26,6 +26,7 @@
 
 #include "core/urlhandler.h"
 #include "core/song.h"
+#include "streaming/streamurlcache.h"
 #include "qobuz/qobuzservice.h"
 
 class TaskManager;
@@ -36,8 +37,9 @@ class QobuzUrlHandler : public UrlHandler {
  public:
   explicit QobuzUrlHandler(const SharedPtr<TaskManager> task_manager, QobuzService *service);
 
-  QString scheme() const { return service_->url_scheme(); }
-  LoadResult StartLoading(const QUrl &url);
+  QString scheme() const override { return service_->url_scheme(); }
+  LoadResult StartLoading(const QUrl &url) override;
+  void InvalidateStreamUrl(const QUrl &url) override;
 
  private:
   void CancelTask(const int task_id);
@@ -55,6 +57,7 @@ class QobuzUrlHandler : public UrlHandler {
   const SharedPtr<TaskManager> task_manager_;
   QobuzService *service_;
   QMap<uint, Request> requests_;
+  StreamUrlCache stream_url_cache_;
 };
 
 #endif  // QOBUZURLHANDLER_H
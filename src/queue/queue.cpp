@@ -29,6 +29,7 @@
 #include <QDataStream>
 #include <QBuffer>
 #include <QList>
+#include <QHash>
 #include <QVariant>
 #include <QString>
 #include <QStringList>
@@ -46,7 +47,7 @@ namespace {
 constexpr char kRowsMimetype[] = "application/x-strawberry-queue-rows";
 }
 
-Queue::Queue(Playlist *playlist, QObject *parent) : QAbstractProxyModel(parent), playlist_(playlist), total_length_ns_(0) {
+Queue::Queue(Playlist *playlist, QObject *parent) : QAbstractProxyModel(parent), source_row_positions_dirty_(true), playlist_(playlist), total_length_ns_(0) {
 
   signal_item_count_changed_ = QObject::connect(this, &Queue::ItemCountChanged, this, &Queue::UpdateTotalLength);
   QObject::connect(this, &Queue::TotalLengthChanged, this, &Queue::UpdateSummaryText);
@@ -59,22 +60,44 @@ QModelIndex Queue::mapFromSource(const QModelIndex &source_index) const {
 
   if (!source_index.isValid()) return QModelIndex();
 
-  const int source_row = source_index.row();
-  for (int i = 0; i < source_indexes_.count(); ++i) {
-    if (source_indexes_[i].row() == source_row) {
-      return index(i, source_index.column());
-    }
-  }
-  return QModelIndex();
+  const int position = SourceRowPositions().value(source_index.row(), -1);
+  if (position == -1) return QModelIndex();
+
+  return index(position, source_index.column());
 
 }
 
 bool Queue::ContainsSourceRow(const int source_row) const {
 
-  for (int i = 0; i < source_indexes_.count(); ++i) {
-    if (source_indexes_[i].row() == source_row) return true;
+  return SourceRowPositions().contains(source_row);
+
+}
+
+const QHash<int, int> &Queue::SourceRowPositions() const {
+
+  if (source_row_positions_dirty_) {
+    source_row_positions_.clear();
+    source_row_positions_.reserve(source_indexes_.count());
+    for (int i = 0; i < source_indexes_.count(); ++i) {
+      source_row_positions_.insert(source_indexes_[i].row(), i);
+    }
+    source_row_positions_dirty_ = false;
   }
-  return false;
+
+  return source_row_positions_;
+
+}
+
+void Queue::InvalidateSourceRowPositions() {
+
+  source_row_positions_dirty_ = true;
+
+}
+
+void Queue::SourceRowsShifted() {
+
+  // The persistent indexes follow the rows, but the cached source rows are now stale.
+  InvalidateSourceRowPositions();
 
 }
 
@@ -92,6 +115,9 @@ void Queue::setSourceModel(QAbstractItemModel *source_model) {
     QObject::disconnect(sourceModel(), &QAbstractItemModel::dataChanged, this, &Queue::SourceDataChanged);
     QObject::disconnect(sourceModel(), &QAbstractItemModel::rowsRemoved, this, &Queue::SourceLayoutChanged);
     QObject::disconnect(sourceModel(), &QAbstractItemModel::layoutChanged, this, &Queue::SourceLayoutChanged);
+    QObject::disconnect(sourceModel(), &QAbstractItemModel::rowsInserted, this, &Queue::SourceRowsShifted);
+    QObject::disconnect(sourceModel(), &QAbstractItemModel::rowsMoved, this, &Queue::SourceRowsShifted);
+    QObject::disconnect(sourceModel(), &QAbstractItemModel::modelReset, this, &Queue::SourceRowsShifted);
   }
 
   QAbstractProxyModel::setSourceModel(source_model);
@@ -99,16 +125,35 @@ void Queue::setSourceModel(QAbstractItemModel *source_model) {
   QObject::connect(sourceModel(), &QAbstractItemModel::dataChanged, this, &Queue::SourceDataChanged);
   QObject::connect(sourceModel(), &QAbstractItemModel::rowsRemoved, this, &Queue::SourceLayoutChanged);
   QObject::connect(sourceModel(), &QAbstractItemModel::layoutChanged, this, &Queue::SourceLayoutChanged);
+  QObject::connect(sourceModel(), &QAbstractItemModel::rowsInserted, this, &Queue::SourceRowsShifted);
+  QObject::connect(sourceModel(), &QAbstractItemModel::rowsMoved, this, &Queue::SourceRowsShifted);
+  QObject::connect(sourceModel(), &QAbstractItemModel::modelReset, this, &Queue::SourceRowsShifted);
+
+  InvalidateSourceRowPositions();
 
 }
 
 void Queue::SourceDataChanged(const QModelIndex &top_left, const QModelIndex &bottom_right) {
 
-  for (int row = top_left.row(); row <= bottom_right.row(); ++row) {
-    QModelIndex proxy_index = mapFromSource(sourceModel()->index(row, 0));
-    if (!proxy_index.isValid()) continue;
+  if (source_indexes_.isEmpty()) return;
 
-    Q_EMIT dataChanged(proxy_index, proxy_index);
+  const QHash<int, int> &positions = SourceRowPositions();
+  if (bottom_right.row() - top_left.row() + 1 > positions.count()) {
+    // Cheaper to walk the queue than the changed range
+    for (QHash<int, int>::const_iterator it = positions.constBegin(); it != positions.constEnd(); ++it) {
+      if (it.key() >= top_left.row() && it.key() <= bottom_right.row()) {
+        const QModelIndex proxy_index = index(it.value(), 0);
+        Q_EMIT dataChanged(proxy_index, proxy_index);
+      }
+    }
+  }
+  else {
+    for (int row = top_left.row(); row <= bottom_right.row(); ++row) {
+      const int position = positions.value(row, -1);
+      if (position == -1) continue;
+      const QModelIndex proxy_index = index(position, 0);
+      Q_EMIT dataChanged(proxy_index, proxy_index);
+    }
   }
   Q_EMIT ItemCountChanged(ItemCount());
 
@@ -118,14 +163,15 @@ void Queue::SourceLayoutChanged() {
 
   QObject::disconnect(signal_item_count_changed_);
 
+  InvalidateSourceRowPositions();
+
+  QList<int> invalid_rows;
   for (int i = 0; i < source_indexes_.count(); ++i) {
     if (!source_indexes_[i].isValid()) {
-      beginRemoveRows(QModelIndex(), i, i);
-      source_indexes_.removeAt(i);
-      endRemoveRows();
-      --i;
+      invalid_rows << i;
     }
   }
+  RemoveRows(invalid_rows);
 
   signal_item_count_changed_ = QObject::connect(this, &Queue::ItemCountChanged, this, &Queue::UpdateTotalLength);
 
@@ -184,13 +230,17 @@ void Queue::ToggleTracks(const QModelIndexList &source_indexes) {
       const int row = proxy_index.row();
       beginRemoveRows(QModelIndex(), row, row);
       source_indexes_.removeAt(row);
+      InvalidateSourceRowPositions();
       endRemoveRows();
     }
     else {
-      // Enqueue the track
+      // Enqueue the track, appending doesn't shift any other position
       const int row = static_cast<int>(source_indexes_.count());
       beginInsertRows(QModelIndex(), row, row);
       source_indexes_ << QPersistentModelIndex(source_index);
+      if (!source_row_positions_dirty_) {
+        source_row_positions_.insert(source_index.row(), row);
+      }
       endInsertRows();
     }
   }
@@ -206,6 +256,7 @@ void Queue::InsertFirst(const QModelIndexList &source_indexes) {
       const int row = proxy_index.row();
       beginRemoveRows(QModelIndex(), row, row);
       source_indexes_.removeAt(row);
+      InvalidateSourceRowPositions();
       endRemoveRows();
     }
   }
@@ -218,6 +269,7 @@ void Queue::InsertFirst(const QModelIndexList &source_indexes) {
     source_indexes_.insert(offset, QPersistentModelIndex(source_index));
     offset++;
   }
+  InvalidateSourceRowPositions();
   endInsertRows();
 
 }
@@ -273,12 +325,33 @@ void Queue::Clear() {
 
   beginRemoveRows(QModelIndex(), 0, static_cast<int>(source_indexes_.count() - 1));
   source_indexes_.clear();
+  InvalidateSourceRowPositions();
   endRemoveRows();
 
 }
 
 void Queue::Move(const QList<int> &proxy_rows, int pos) {
 
+  if (proxy_rows.isEmpty()) return;
+
+  // A single block of rows, which covers MoveUp(), MoveDown() and most drags, can be signalled as a plain row move
+  const int first = proxy_rows.first();
+  const int last = proxy_rows.last();
+  if (last - first + 1 == proxy_rows.count() && std::is_sorted(proxy_rows.begin(), proxy_rows.end())) {
+    const int count = static_cast<int>(source_indexes_.count());
+    const int destination = pos == -1 ? count : std::min(pos, count);
+    if (!beginMoveRows(QModelIndex(), first, last, QModelIndex(), destination)) return;
+    const QList<QPersistentModelIndex> moved_items = source_indexes_.mid(first, proxy_rows.count());
+    source_indexes_.remove(first, proxy_rows.count());
+    const int start = destination > last ? destination - static_cast<int>(proxy_rows.count()) : destination;
+    for (int i = 0; i < moved_items.count(); ++i) {
+      source_indexes_.insert(start + i, moved_items[i]);
+    }
+    InvalidateSourceRowPositions();
+    endMoveRows();
+    return;
+  }
+
   Q_EMIT layoutAboutToBeChanged();
   QList<QPersistentModelIndex> moved_items;
 
@@ -296,11 +369,18 @@ void Queue::Move(const QList<int> &proxy_rows, int pos) {
   for (int i = start; i < start + moved_items.count(); ++i) {
     source_indexes_.insert(i, moved_items[i - start]);
   }
+  InvalidateSourceRowPositions();
+
+  QHash<int, int> dest_offsets;
+  dest_offsets.reserve(proxy_rows.count());
+  for (int i = 0; i < proxy_rows.count(); ++i) {
+    dest_offsets.insert(proxy_rows[i], i);
+  }
 
   // Update persistent indexes
   const QModelIndexList pindexes = persistentIndexList();
   for (const QModelIndex &pidx : pindexes) {
-    const int dest_offset = static_cast<int>(proxy_rows.indexOf(pidx.row()));
+    const int dest_offset = dest_offsets.value(pidx.row(), -1);
     if (dest_offset != -1) {
       // This index was moved
       changePersistentIndex(pidx, index(start + dest_offset, pidx.column(), QModelIndex()));
@@ -442,6 +522,7 @@ int Queue::TakeNext() {
 
   beginRemoveRows(QModelIndex(), 0, 0);
   int ret = source_indexes_.takeFirst().row();
+  InvalidateSourceRowPositions();
   endRemoveRows();
 
   return ret;
@@ -457,22 +538,32 @@ QVariant Queue::headerData(int section, Qt::Orientation orientation, int role) c
 
 void Queue::Remove(QList<int> &proxy_rows) {
 
-  // Order the rows
-  std::stable_sort(proxy_rows.begin(), proxy_rows.end());
+  RemoveRows(proxy_rows);
 
-  // Reflects immediately changes in the playlist
-  Q_EMIT layoutAboutToBeChanged();
+}
+
+void Queue::RemoveRows(QList<int> proxy_rows) {
+
+  if (proxy_rows.isEmpty()) return;
+
+  // Remove blocks of consecutive rows from the bottom up, so the remaining row numbers stay valid
+  std::sort(proxy_rows.begin(), proxy_rows.end());
+  proxy_rows.erase(std::unique(proxy_rows.begin(), proxy_rows.end()), proxy_rows.end());
 
-  int removed_rows = 0;
-  for (int row : proxy_rows) {
-    // After the first row, the row number needs to be updated
-    const int real_row = row - removed_rows;
-    beginRemoveRows(QModelIndex(), real_row, real_row);
-    source_indexes_.removeAt(real_row);
+  qsizetype i = proxy_rows.count() - 1;
+  while (i >= 0) {
+    const int last = proxy_rows[i];
+    int first = last;
+    while (i > 0 && proxy_rows[i - 1] == first - 1) {
+      --i;
+      first = proxy_rows[i];
+    }
+    --i;
+
+    beginRemoveRows(QModelIndex(), first, last);
+    source_indexes_.remove(first, last - first + 1);
+    InvalidateSourceRowPositions();
     endRemoveRows();
-    removed_rows++;
   }
 
-  Q_EMIT layoutChanged();
-
 }
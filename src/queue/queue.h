@@ -28,6 +28,7 @@
 #include <QAbstractItemModel>
 #include <QAbstractProxyModel>
 #include <QList>
+#include <QHash>
 #include <QVariant>
 #include <QString>
 #include <QStringList>
@@ -88,10 +89,19 @@ class Queue : public QAbstractProxyModel {
  private Q_SLOTS:
   void SourceDataChanged(const QModelIndex &top_left, const QModelIndex &bottom_right);
   void SourceLayoutChanged();
+  void SourceRowsShifted();
   void UpdateTotalLength();
 
+ private:
+  const QHash<int, int> &SourceRowPositions() const;
+  void InvalidateSourceRowPositions();
+  void RemoveRows(QList<int> proxy_rows);
+
  private:
   QList<QPersistentModelIndex> source_indexes_;
+  // Source row -> queue position, rebuilt on demand whenever the queue or the source rows change.
+  mutable QHash<int, int> source_row_positions_;
+  mutable bool source_row_positions_dirty_;
   const Playlist *playlist_;
   quint64 total_length_ns_;
   QMetaObject::Connection signal_item_count_changed_;
@@ -26,6 +26,7 @@
 #include "includes/shared_ptr.h"
 #include "core/database.h"
 #include "core/sqlquery.h"
+#include "core/scopedtransaction.h"
 #include "core/song.h"
 #include "radiobackend.h"
 #include "radiochannel.h"
@@ -123,6 +124,46 @@ void RadioBackend::DeleteChannelsAsync() {
   QMetaObject::invokeMethod(this, &RadioBackend::DeleteChannels, Qt::QueuedConnection);
 }
 
+void RadioBackend::ReplaceChannelsAsync(const Song::Source source, const RadioChannelList &channels) {
+  QMetaObject::invokeMethod(this, "ReplaceChannels", Qt::QueuedConnection, Q_ARG(Song::Source, source), Q_ARG(RadioChannelList, channels));
+}
+
+void RadioBackend::ReplaceChannels(const Song::Source source, const RadioChannelList &channels) {
+
+  QMutexLocker l(db_->Mutex());
+  QSqlDatabase db(db_->Connect());
+
+  ScopedTransaction transaction(&db);
+
+  {
+    SqlQuery q(db);
+    q.prepare(u"DELETE FROM radio_channels WHERE source = :source"_s);
+    q.BindValue(u":source"_s, static_cast<int>(source));
+    if (!q.Exec()) {
+      db_->ReportErrors(q);
+      return;
+    }
+  }
+
+  SqlQuery q(db);
+  q.prepare(u"INSERT INTO radio_channels (source, name, url, thumbnail_url) VALUES (:source, :name, :url, :thumbnail_url)"_s);
+  for (const RadioChannel &channel : channels) {
+    q.BindValue(u":source"_s, static_cast<int>(channel.source));
+    q.BindValue(u":name"_s, channel.name);
+    q.BindValue(u":url"_s, channel.url);
+    q.BindValue(u":thumbnail_url"_s, channel.thumbnail_url);
+    if (!q.Exec()) {
+      db_->ReportErrors(q);
+      return;
+    }
+  }
+
+  transaction.Commit();
+
+  Q_EMIT ChannelsReplaced(source);
+
+}
+
 void RadioBackend::DeleteChannels() {
 
   QMutexLocker l(db_->Mutex());
@@ -23,6 +23,7 @@
 #include <QObject>
 
 #include "includes/shared_ptr.h"
+#include "core/song.h"
 #include "radiochannel.h"
 
 class QThread;
@@ -40,14 +41,17 @@ class RadioBackend : public QObject {
   void AddChannelsAsync(const RadioChannelList &channels);
   void GetChannelsAsync();
   void DeleteChannelsAsync();
+  void ReplaceChannelsAsync(const Song::Source source, const RadioChannelList &channels);
 
  private Q_SLOTS:
   void AddChannels(const RadioChannelList &channels);
   void GetChannels();
   void DeleteChannels();
+  void ReplaceChannels(const Song::Source source, const RadioChannelList &channels);
 
  Q_SIGNALS:
   void NewChannels(const RadioChannelList &channels);
+  void ChannelsReplaced(const Song::Source source);
   void ExitFinished();
 
  private Q_SLOTS:
@@ -38,6 +38,7 @@ using std::make_shared;
 
 RadioServices::RadioServices(const SharedPtr<TaskManager> task_manager,
                              const SharedPtr<NetworkAccessManager> network,
+                             const SharedPtr<UrlHandlers> url_handlers,
                              const SharedPtr<Database> database,
                              const SharedPtr<AlbumCoverLoader> albumcover_loader,
                              QObject *parent)
@@ -52,6 +53,7 @@ RadioServices::RadioServices(const SharedPtr<TaskManager> task_manager,
   backend_->moveToThread(database->thread());
 
   QObject::connect(&*backend_, &RadioBackend::NewChannels, this, &RadioServices::GotChannelsFromBackend);
+  QObject::connect(&*backend_, &RadioBackend::ChannelsReplaced, this, &RadioServices::ChannelsReplaced);
 
   sort_model_->setSourceModel(model_);
   sort_model_->setSortRole(RadioModel::Role_SortText);
@@ -59,7 +61,7 @@ RadioServices::RadioServices(const SharedPtr<TaskManager> task_manager,
   sort_model_->setSortLocaleAware(true);
   sort_model_->sort(0);
 
-  AddService(new SomaFMService(task_manager, network_, this));
+  AddService(new SomaFMService(task_manager, network_, url_handlers, this));
   AddService(new RadioParadiseService(task_manager, network_, this));
 
 }
@@ -115,9 +117,8 @@ void RadioServices::GetChannels() {
 
 void RadioServices::RefreshChannels() {
 
+  // The stored channels are kept until each service has replied, so a failed refresh does not empty the list.
   channels_refresh_ = true;
-  model_->Reset();
-  backend_->DeleteChannelsAsync();
 
   const QList<RadioService*> services = services_.values();
   for (RadioService *service : services) {
@@ -144,6 +145,18 @@ void RadioServices::GotChannelsFromService(const RadioChannelList &channels) {
   RadioService *service = qobject_cast<RadioService*>(sender());
   if (!service) return;
 
-  backend_->AddChannelsAsync(channels);
+  if (channels.isEmpty()) {
+    qLog(Error) << "Could not refresh" << service->name() << "channels";
+    return;
+  }
+
+  backend_->ReplaceChannelsAsync(service->source(), channels);
+
+}
+
+void RadioServices::ChannelsReplaced() {
+
+  model_->Reset();
+  backend_->GetChannelsAsync();
 
 }
@@ -32,6 +32,7 @@ class QSortFilterProxyModel;
 class TaskManager;
 class Database;
 class NetworkAccessManager;
+class UrlHandlers;
 class AlbumCoverLoader;
 class RadioBackend;
 class RadioModel;
@@ -43,6 +44,7 @@ class RadioServices : public QObject {
  public:
   explicit RadioServices(const SharedPtr<TaskManager> task_manager,
                          const SharedPtr<NetworkAccessManager> network,
+                         const SharedPtr<UrlHandlers> url_handlers,
                          const SharedPtr<Database> database,
                          const SharedPtr<AlbumCoverLoader> albumcover_loader,
                          QObject *parent = nullptr);
@@ -65,6 +67,7 @@ class RadioServices : public QObject {
  private Q_SLOTS:
   void ServiceDeleted();
   void GotChannelsFromBackend(const RadioChannelList &channels);
+  void ChannelsReplaced();
   void GotChannelsFromService(const RadioChannelList &channels);
 
  public Q_SLOTS:
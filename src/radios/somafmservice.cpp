@@ -17,8 +17,6 @@
  *
  */
 
-#include <utility>
-
 #include <QObject>
 #include <QString>
 #include <QUrl>
@@ -31,8 +29,9 @@
 #include "core/networkaccessmanager.h"
 #include "core/taskmanager.h"
 #include "core/iconloader.h"
-#include "playlistparsers/playlistparser.h"
+#include "core/urlhandlers.h"
 #include "somafmservice.h"
+#include "somafmurlhandler.h"
 #include "radiochannel.h"
 
 using namespace Qt::Literals::StringLiterals;
@@ -41,8 +40,13 @@ namespace {
 constexpr char kApiChannelsUrl[] = "https://somafm.com/channels.json";
 }  // namespace
 
-SomaFMService::SomaFMService(const SharedPtr<TaskManager> task_manager, const SharedPtr<NetworkAccessManager> network, QObject *parent)
-    : RadioService(Song::Source::SomaFM, u"SomaFM"_s, IconLoader::Load(u"somafm"_s), task_manager, network, parent) {}
+SomaFMService::SomaFMService(const SharedPtr<TaskManager> task_manager, const SharedPtr<NetworkAccessManager> network, const SharedPtr<UrlHandlers> url_handlers, QObject *parent)
+    : RadioService(Song::Source::SomaFM, u"SomaFM"_s, IconLoader::Load(u"somafm"_s), task_manager, network, parent),
+      url_handler_(new SomaFMUrlHandler(task_manager, network, this)) {
+
+  url_handlers->Register(url_handler_);
+
+}
 
 SomaFMService::~SomaFMService() {
   Abort();
@@ -60,8 +64,6 @@ void SomaFMService::Abort() {
     reply->deleteLater();
   }
 
-  channels_.clear();
-
 }
 
 void SomaFMService::GetChannels() {
@@ -118,7 +120,7 @@ void SomaFMService::GetChannelsReply(QNetworkReply *reply, const int task_id) {
       if (quality != "highest"_L1) continue;
       channel.source = source_;
       channel.name = name;
-      channel.url.setUrl(obj_playlist["url"_L1].toString());
+      channel.url = SomaFMUrlHandler::ChannelUrl(QUrl(obj_playlist["url"_L1].toString()));
       channel.thumbnail_url.setUrl(image);
       if (obj_playlist.contains("format"_L1)) {
         channel.name.append(QLatin1Char(' ') + obj_playlist[QLatin1String("format")].toString().toUpper());
@@ -127,44 +129,7 @@ void SomaFMService::GetChannelsReply(QNetworkReply *reply, const int task_id) {
     }
   }
 
-  if (channels.isEmpty()) {
-    task_manager_->SetTaskFinished(task_id);
-    Q_EMIT NewChannels();
-  }
-  else {
-    for (const RadioChannel &channel : std::as_const(channels)) {
-      GetStreamUrl(task_id, channel);
-    }
-  }
-
-}
-
-void SomaFMService::GetStreamUrl(const int task_id, const RadioChannel &channel) {
-
-  QNetworkRequest network_request(channel.url);
-  QNetworkReply *reply = network_->get(network_request);
-  replies_ << reply;
-  QObject::connect(reply, &QNetworkReply::finished, this, [this, reply, task_id, channel]() { GetStreamUrlsReply(reply, task_id, channel); });
-
-}
-
-void SomaFMService::GetStreamUrlsReply(QNetworkReply *reply, const int task_id, RadioChannel channel) {  // clazy:exclude=function-args-by-ref
-
-  if (replies_.contains(reply)) replies_.removeAll(reply);
-  reply->deleteLater();
-
-  PlaylistParser parser(nullptr, nullptr);
-  SongList songs = parser.LoadFromDevice(reply);
-  if (!songs.isEmpty()) {
-    channel.url = songs.first().url();
-  }
-
-  channels_ << channel;
-
-  if (replies_.isEmpty()) {
-    task_manager_->SetTaskFinished(task_id);
-    Q_EMIT NewChannels(channels_);
-    channels_.clear();
-  }
+  task_manager_->SetTaskFinished(task_id);
+  Q_EMIT NewChannels(channels);
 
 }
@@ -31,12 +31,14 @@ class QNetworkReply;
 
 class TaskManager;
 class NetworkAccessManager;
+class UrlHandlers;
+class SomaFMUrlHandler;
 
 class SomaFMService : public RadioService {
   Q_OBJECT
 
  public:
-  explicit SomaFMService(const SharedPtr<TaskManager> task_manager, const SharedPtr<NetworkAccessManager> network, QObject *parent = nullptr);
+  explicit SomaFMService(const SharedPtr<TaskManager> task_manager, const SharedPtr<NetworkAccessManager> network, const SharedPtr<UrlHandlers> url_handlers, QObject *parent = nullptr);
   ~SomaFMService();
 
   QUrl Homepage() override;
@@ -47,16 +49,12 @@ class SomaFMService : public RadioService {
  public Q_SLOTS:
   void GetChannels() override;
 
- private:
-  void GetStreamUrl(const int task_id, const RadioChannel &channel);
-
  private Q_SLOTS:
   void GetChannelsReply(QNetworkReply *reply, const int task_id);
-  void GetStreamUrlsReply(QNetworkReply *reply, const int task_id, RadioChannel channel);
 
  private:
+  SomaFMUrlHandler *url_handler_;
   QList<QNetworkReply*> replies_;
-  RadioChannelList channels_;
 };
 
 #endif  // SOMAFMSERVICE_H
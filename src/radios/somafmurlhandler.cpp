@@ -0,0 +1,121 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "config.h"
+
+#include <QObject>
+#include <QString>
+#include <QUrl>
+#include <QNetworkRequest>
+#include <QNetworkReply>
+
+#include "includes/shared_ptr.h"
+#include "core/song.h"
+#include "core/taskmanager.h"
+#include "core/networkaccessmanager.h"
+#include "playlistparsers/playlistparser.h"
+#include "somafmurlhandler.h"
+
+using namespace Qt::Literals::StringLiterals;
+
+namespace {
+constexpr char kScheme[] = "somafm";
+}  // namespace
+
+SomaFMUrlHandler::SomaFMUrlHandler(const SharedPtr<TaskManager> task_manager, const SharedPtr<NetworkAccessManager> network, QObject *parent)
+    : UrlHandler(parent),
+      task_manager_(task_manager),
+      network_(network) {}
+
+SomaFMUrlHandler::~SomaFMUrlHandler() {
+
+  while (!replies_.isEmpty()) {
+    QNetworkReply *reply = replies_.takeFirst();
+    QObject::disconnect(reply, nullptr, this, nullptr);
+    if (reply->isRunning()) reply->abort();
+    reply->deleteLater();
+  }
+
+}
+
+QString SomaFMUrlHandler::scheme() const {
+
+  return QLatin1String(kScheme);
+
+}
+
+QUrl SomaFMUrlHandler::ChannelUrl(const QUrl &playlist_url) {
+
+  QUrl url(playlist_url);
+  url.setScheme(QLatin1String(kScheme));
+  return url;
+
+}
+
+UrlHandler::LoadResult SomaFMUrlHandler::StartLoading(const QUrl &url) {
+
+  if (stream_urls_.contains(url)) {
+    return LoadResult(url, LoadResult::Type::TrackAvailable, stream_urls_.value(url));
+  }
+
+  QUrl playlist_url(url);
+  playlist_url.setScheme(u"https"_s);
+
+  QNetworkReply *reply = network_->get(QNetworkRequest(playlist_url));
+  replies_ << reply;
+  const int task_id = task_manager_->StartTask(tr("Loading %1 stream...").arg(u"SomaFM"_s));
+  QObject::connect(reply, &QNetworkReply::finished, this, [this, reply, url, task_id]() { PlaylistReplyReceived(reply, url, task_id); });
+
+  return LoadResult(url, LoadResult::Type::WillLoadAsynchronously);
+
+}
+
+void SomaFMUrlHandler::PlaylistReplyReceived(QNetworkReply *reply, const QUrl &url, const int task_id) {
+
+  if (!replies_.contains(reply)) return;
+  replies_.removeAll(reply);
+  QObject::disconnect(reply, nullptr, this, nullptr);
+  reply->deleteLater();
+
+  task_manager_->SetTaskFinished(task_id);
+
+  if (reply->error() != QNetworkReply::NoError) {
+    Q_EMIT AsyncLoadComplete(LoadResult(url, LoadResult::Type::Error, reply->errorString()));
+    return;
+  }
+
+  PlaylistParser parser(nullptr, nullptr);
+  const SongList songs = parser.LoadFromDevice(reply);
+  if (songs.isEmpty() || !songs.first().url().isValid()) {
+    Q_EMIT AsyncLoadComplete(LoadResult(url, LoadResult::Type::Error, tr("No stream found in the SomaFM playlist.")));
+    return;
+  }
+
+  const QUrl stream_url = songs.first().url();
+  stream_urls_.insert(url, stream_url);
+
+  Q_EMIT AsyncLoadComplete(LoadResult(url, LoadResult::Type::TrackAvailable, stream_url));
+
+}
+
+void SomaFMUrlHandler::InvalidateStreamUrl(const QUrl &url) {
+
+  stream_urls_.remove(url);
+
+}
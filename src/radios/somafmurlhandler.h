@@ -0,0 +1,62 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef SOMAFMURLHANDLER_H
+#define SOMAFMURLHANDLER_H
+
+#include "config.h"
+
+#include <QObject>
+#include <QList>
+#include <QHash>
+#include <QString>
+#include <QUrl>
+
+#include "includes/shared_ptr.h"
+#include "core/urlhandler.h"
+
+class QNetworkReply;
+class TaskManager;
+class NetworkAccessManager;
+
+// Channels are stored with the URL of their playlist, and the stream URL is only fetched from the playlist when the channel is played.
+class SomaFMUrlHandler : public UrlHandler {
+  Q_OBJECT
+
+ public:
+  explicit SomaFMUrlHandler(const SharedPtr<TaskManager> task_manager, const SharedPtr<NetworkAccessManager> network, QObject *parent = nullptr);
+  ~SomaFMUrlHandler() override;
+
+  QString scheme() const override;
+  LoadResult StartLoading(const QUrl &url) override;
+  void InvalidateStreamUrl(const QUrl &url) override;
+
+  static QUrl ChannelUrl(const QUrl &playlist_url);
+
+ private Q_SLOTS:
+  void PlaylistReplyReceived(QNetworkReply *reply, const QUrl &url, const int task_id);
+
+ private:
+  const SharedPtr<TaskManager> task_manager_;
+  const SharedPtr<NetworkAccessManager> network_;
+  QList<QNetworkReply*> replies_;
+  QHash<QUrl, QUrl> stream_urls_;
+};
+
+#endif  // SOMAFMURLHANDLER_H
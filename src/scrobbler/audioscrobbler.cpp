@@ -19,15 +19,19 @@
 
 #include "config.h"
 
+#include <algorithm>
 #include <utility>
 #include <memory>
 
 #include <QList>
 #include <QString>
+#include <QTimer>
+#include <QDateTime>
 
 #include "includes/shared_ptr.h"
 #include "core/logging.h"
 #include "core/song.h"
+#include "constants/timeconstants.h"
 
 #include "audioscrobbler.h"
 #include "scrobblersettingsservice.h"
@@ -35,9 +39,21 @@
 
 using std::make_shared;
 
+namespace {
+// Delay between batches while draining a backlog.
+constexpr qint64 kSubmitBatchDelay = 1000;
+// First delay after a failed submission, doubled for every following error.
+constexpr qint64 kSubmitErrorDelay = 30000;
+constexpr qint64 kSubmitMaxErrorDelay = 3600000;
+}  // namespace
+
 AudioScrobbler::AudioScrobbler(QObject *parent)
     : QObject(parent),
-      settings_(make_shared<ScrobblerSettingsService>()) {
+      settings_(make_shared<ScrobblerSettingsService>()),
+      timer_submit_(new QTimer(this)) {
+
+  timer_submit_->setSingleShot(true);
+  QObject::connect(timer_submit_, &QTimer::timeout, this, &AudioScrobbler::SubmitTimeout);
 
   ReloadSettings();
 
@@ -58,6 +74,10 @@ void AudioScrobbler::AddService(ScrobblerServicePtr service) {
 
   QObject::connect(&*service, &ScrobblerService::ErrorMessage, this, &AudioScrobbler::ErrorReceived);
 
+  const QString name = service->name();
+  QObject::connect(&*service, &ScrobblerService::SubmitRequested, this, [this, name](const bool initial) { SubmitRequested(name, initial); });
+  QObject::connect(&*service, &ScrobblerService::SubmitFinished, this, [this, name](const bool success) { SubmitFinished(name, success); });
+
   qLog(Debug) << "Registered scrobbler service" << service->name();
 
 }
@@ -67,6 +87,7 @@ void AudioScrobbler::RemoveService(ScrobblerServicePtr service) {
   if (!service || !services_.contains(service->name())) return;
 
   services_.remove(service->name());
+  submit_states_.remove(service->name());
   QObject::disconnect(&*service, nullptr, this, nullptr);
 
   QObject::disconnect(&*service, &ScrobblerService::ErrorMessage, this, &AudioScrobbler::ErrorReceived);
@@ -173,6 +194,81 @@ void AudioScrobbler::Submit() {
 
 }
 
+void AudioScrobbler::SubmitRequested(const QString &name, const bool initial) {
+
+  SubmitState &state = submit_states_[name];
+
+  const qint64 now = QDateTime::currentMSecsSinceEpoch();
+  const qint64 delay = initial ? static_cast<qint64>(settings_->submit_delay()) * kMsecPerSec : 0;
+  const qint64 submit_time = std::max(now + delay, state.not_before);
+  if (!state.pending || submit_time < state.submit_time) {
+    state.submit_time = submit_time;
+  }
+  state.pending = true;
+
+  StartSubmitTimer();
+
+}
+
+void AudioScrobbler::SubmitFinished(const QString &name, const bool success) {
+
+  SubmitState &state = submit_states_[name];
+
+  const qint64 now = QDateTime::currentMSecsSinceEpoch();
+  if (success) {
+    state.errors = 0;
+    state.not_before = now + kSubmitBatchDelay;
+  }
+  else {
+    state.errors = std::min(state.errors + 1, 16);
+    const qint64 error_delay = std::min(kSubmitErrorDelay << (state.errors - 1), kSubmitMaxErrorDelay);
+    state.not_before = now + error_delay;
+    qLog(Debug) << "Scrobbler" << name << "failed to submit, retrying in" << error_delay / kMsecPerSec << "seconds.";
+  }
+
+}
+
+void AudioScrobbler::StartSubmitTimer() {
+
+  qint64 submit_time = 0;
+  for (const SubmitState &state : std::as_const(submit_states_)) {
+    if (state.pending && (submit_time == 0 || state.submit_time < submit_time)) {
+      submit_time = state.submit_time;
+    }
+  }
+
+  if (submit_time == 0) {
+    timer_submit_->stop();
+    return;
+  }
+
+  timer_submit_->start(static_cast<int>(std::max(0LL, submit_time - QDateTime::currentMSecsSinceEpoch())));
+
+}
+
+void AudioScrobbler::SubmitTimeout() {
+
+  const qint64 now = QDateTime::currentMSecsSinceEpoch();
+
+  // Services are submitted in parallel, each on its own schedule.
+  QList<ScrobblerServicePtr> services;
+  for (QMap<QString, SubmitState>::iterator it = submit_states_.begin(); it != submit_states_.end(); ++it) {
+    SubmitState &state = it.value();
+    if (!state.pending || state.submit_time > now) continue;
+    state.pending = false;
+    ScrobblerServicePtr service = services_.value(it.key());
+    if (!service || !service->enabled() || !service->authenticated() || service->submitted()) continue;
+    services << service;
+  }
+
+  for (ScrobblerServicePtr service : std::as_const(services)) {
+    service->Submit();
+  }
+
+  StartSubmitTimer();
+
+}
+
 void AudioScrobbler::WriteCache() {
 
   const QList<ScrobblerServicePtr> services = GetAll();
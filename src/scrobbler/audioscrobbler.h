@@ -34,6 +34,7 @@
 #include "core/song.h"
 #include "scrobblersettingsservice.h"
 
+class QTimer;
 class ScrobblerService;
 class Song;
 
@@ -85,9 +86,28 @@ class AudioScrobbler : public QObject {
  Q_SIGNALS:
   void ErrorMessage(const QString &error);
 
+ private:
+  // Submissions are scheduled here for all services, each service has at most one batch in flight.
+  struct SubmitState {
+    SubmitState() : pending(false), submit_time(0), not_before(0), errors(0) {}
+    bool pending;
+    qint64 submit_time;
+    qint64 not_before;
+    int errors;
+  };
+
+  void SubmitRequested(const QString &name, const bool initial);
+  void SubmitFinished(const QString &name, const bool success);
+  void StartSubmitTimer();
+
+ private Q_SLOTS:
+  void SubmitTimeout();
+
  private:
   SharedPtr<ScrobblerSettingsService> settings_;
   QMap<QString, SharedPtr<ScrobblerService>> services_;
+  QMap<QString, SubmitState> submit_states_;
+  QTimer *timer_submit_;
 
   Q_DISABLE_COPY(AudioScrobbler)
 };
@@ -43,6 +43,8 @@
 #include "core/networkaccessmanager.h"
 #include "core/settings.h"
 
+#include "collection/collectionplaystatistics.h"
+
 #include "lastfmimport.h"
 
 #include "lastfmscrobbler.h"
@@ -50,7 +52,8 @@
 using namespace Qt::Literals::StringLiterals;
 
 namespace {
-constexpr int kRequestsDelay = 2000;
+constexpr int kRequestsDelay = 500;
+constexpr int kMaxConcurrentRequests = 4;
 }
 
 LastFMImport::LastFMImport(const SharedPtr<NetworkAccessManager> network, QObject *parent)
@@ -196,6 +199,9 @@ void LastFMImport::ImportData(const bool lastplayed, const bool playcount) {
 
 void LastFMImport::FlushRequests() {
 
+  // Pages are fetched in parallel, one new request is sent each interval to stay within the API rate limit.
+  if (replies_.count() >= kMaxConcurrentRequests) return;
+
   if (!recent_tracks_requests_.isEmpty() && (!playcount_ || (playcount_total_ > 0 || top_tracks_requests_.isEmpty()))) {
     SendGetRecentTracksRequest(recent_tracks_requests_.dequeue());
     return;
@@ -314,6 +320,8 @@ void LastFMImport::GetRecentTracksRequestFinished(QNetworkReply *reply, const in
 
     const QJsonArray array_track = json_object["track"_L1].toArray();
 
+    CollectionPlayStatisticsList statistics_list;
+    statistics_list.reserve(array_track.count());
     for (const QJsonValue &value_track : array_track) {
 
       ++lastplayed_received_;
@@ -347,12 +355,20 @@ void LastFMImport::GetRecentTracksRequestFinished(QNetworkReply *reply, const in
       const QString title = obj_track["name"_L1].toString();
       const QDateTime datetime = QDateTime::fromString(date, u"dd MMM yyyy, hh:mm"_s);
       if (datetime.isValid()) {
-        Q_EMIT UpdateLastPlayed(artist, album, title, datetime.toSecsSinceEpoch());
+        CollectionPlayStatistics statistics;
+        statistics.artist = artist;
+        statistics.album = album;
+        statistics.title = title;
+        statistics.lastplayed = datetime.toSecsSinceEpoch();
+        statistics_list << statistics;
       }
 
-      UpdateProgressCheck();
+    }
 
+    if (!statistics_list.isEmpty()) {
+      Q_EMIT UpdatePlayStatistics(statistics_list);
     }
+    UpdateProgressCheck();
 
     if (page == 1) {
       for (int i = 2; i <= pages; ++i) {
@@ -469,6 +485,8 @@ void LastFMImport::GetTopTracksRequestFinished(QNetworkReply *reply, const int p
   else {
 
     const QJsonArray array_track = json_object["track"_L1].toArray();
+    CollectionPlayStatisticsList statistics_list;
+    statistics_list.reserve(array_track.count());
     for (QJsonArray::ConstIterator it = array_track.begin(); it != array_track.constEnd(); ++it) {
 
       const QJsonValue &value_track = *it;
@@ -499,10 +517,18 @@ void LastFMImport::GetTopTracksRequestFinished(QNetworkReply *reply, const int p
 
       if (playcount <= 0) continue;
 
-      Q_EMIT UpdatePlayCount(artist, title, playcount, false);
-      UpdateProgressCheck();
+      CollectionPlayStatistics statistics;
+      statistics.artist = artist;
+      statistics.title = title;
+      statistics.playcount = playcount;
+      statistics_list << statistics;
+
+    }
 
+    if (!statistics_list.isEmpty()) {
+      Q_EMIT UpdatePlayStatistics(statistics_list);
     }
+    UpdateProgressCheck();
 
     if (page == 1) {
       for (int i = 2; i <= pages; ++i) {
@@ -31,7 +31,7 @@
 
 #include "core/jsonbaserequest.h"
 #include "includes/shared_ptr.h"
-#include "core/jsonbaserequest.h"
+#include "collection/collectionplaystatistics.h"
 
 class QTimer;
 class QNetworkReply;
@@ -86,8 +86,7 @@ class LastFMImport : public JsonBaseRequest {
   void FinishCheck();
 
  Q_SIGNALS:
-  void UpdatePlayCount(const QString&, const QString&, const int, const bool = false);
-  void UpdateLastPlayed(const QString&, const QString&, const QString&, const qint64);
+  void UpdatePlayStatistics(const CollectionPlayStatisticsList &statistics_list);
   void UpdateTotal(const int, const int);
   void UpdateProgress(const int, const int);
   void Finished();
@@ -33,7 +33,6 @@
 #include <QUrl>
 #include <QUrlQuery>
 #include <QDateTime>
-#include <QTimer>
 #include <QCryptographicHash>
 #include <QMessageBox>
 #include <QSettings>
@@ -85,12 +84,7 @@ LastFMScrobbler::LastFMScrobbler(const SharedPtr<ScrobblerSettingsService> setti
       subscriber_(false),
       submitted_(false),
       scrobbled_(false),
-      timestamp_(0),
-      submit_error_(false),
-      timer_submit_(new QTimer(this)) {
-
-  timer_submit_->setSingleShot(true);
-  QObject::connect(timer_submit_, &QTimer::timeout, this, &LastFMScrobbler::Submit);
+      timestamp_(0) {
 
   LastFMScrobbler::ReloadSettings();
   LoadSession();
@@ -467,17 +461,7 @@ void LastFMScrobbler::Scrobble(const Song &song) {
 void LastFMScrobbler::StartSubmit(const bool initial) {
 
   if (!submitted_ && cache_->Count() > 0) {
-    if (initial && settings_->submit_delay() <= 0 && !submit_error_) {
-      if (timer_submit_->isActive()) {
-        timer_submit_->stop();
-      }
-      Submit();
-    }
-    else if (!timer_submit_->isActive()) {
-      int submit_delay = static_cast<int>(std::max(settings_->submit_delay(), submit_error_ ? 30 : 5) * kMsecPerSec);
-      timer_submit_->setInterval(submit_delay);
-      timer_submit_->start();
-    }
+    Q_EMIT SubmitRequested(initial);
   }
 
 }
@@ -537,14 +521,14 @@ void LastFMScrobbler::ScrobbleRequestFinished(QNetworkReply *reply, ScrobblerCac
   if (!json_object_result.success()) {
     Error(json_object_result.error_message);
     cache_->ClearSent(cache_items);
-    submit_error_ = true;
+    Q_EMIT SubmitFinished(false);
     StartSubmit();
     return;
   }
   const QJsonObject &json_object = json_object_result.json_object;
 
   cache_->Flush(cache_items);
-  submit_error_ = false;
+  Q_EMIT SubmitFinished(true);
 
   if (!json_object.contains("scrobbles"_L1)) {
     Error(u"Json reply from server is missing scrobbles."_s, json_object);
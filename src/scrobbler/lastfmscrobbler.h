@@ -32,7 +32,6 @@
 #include "scrobblercache.h"
 #include "scrobblercacheitem.h"
 
-class QTimer;
 class QNetworkReply;
 
 class ScrobblerSettingsService;
@@ -63,6 +62,7 @@ class LastFMScrobbler : public ScrobblerService {
 
   bool subscriber() const { return subscriber_; }
   bool submitted() const override { return submitted_; }
+  int cached_scrobbles() const override { return cache_->Count(); }
   QString username() const { return username_; }
 
   void Authenticate();
@@ -144,9 +144,6 @@ class LastFMScrobbler : public ScrobblerService {
   Song song_playing_;
   bool scrobbled_;
   quint64 timestamp_;
-  bool submit_error_;
-
-  QTimer *timer_submit_;
 };
 
 #endif  // LASTFMSCROBBLER_H
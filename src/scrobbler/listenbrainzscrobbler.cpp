@@ -28,7 +28,6 @@
 #include <QString>
 #include <QUrl>
 #include <QDateTime>
-#include <QTimer>
 #include <QNetworkReply>
 #include <QJsonDocument>
 #include <QJsonObject>
@@ -65,7 +64,7 @@ constexpr char kApiUrl[] = "https://api.listenbrainz.org";
 constexpr char kClientIDB64[] = "b2VBVU53cVNRZXIwZXIwOUZpcWkwUQ==";
 constexpr char kClientSecretB64[] = "Uk9GZ2hrZVEzRjNvUHlFaHFpeVdQQQ==";
 constexpr char kCacheFile[] = "listenbrainzscrobbler.cache";
-constexpr int kScrobblesPerRequest = 10;
+constexpr int kScrobblesPerRequest = 100;
 }  // namespace
 
 ListenBrainzScrobbler::ListenBrainzScrobbler(const SharedPtr<ScrobblerSettingsService> settings, const SharedPtr<NetworkAccessManager> network, QObject *parent)
@@ -73,12 +72,10 @@ ListenBrainzScrobbler::ListenBrainzScrobbler(const SharedPtr<ScrobblerSettingsSe
       network_(network),
       oauth_(new OAuthenticator(network, this)),
       cache_(new ScrobblerCache(QLatin1String(kCacheFile), this)),
-      timer_submit_(new QTimer(this)),
       enabled_(false),
       submitted_(false),
       scrobbled_(false),
       timestamp_(0),
-      submit_error_(false),
       prefer_albumartist_(false) {
 
   oauth_->set_settings_group(QLatin1String(kSettingsGroup));
@@ -94,9 +91,6 @@ ListenBrainzScrobbler::ListenBrainzScrobbler(const SharedPtr<ScrobblerSettingsSe
 
   QObject::connect(oauth_, &OAuthenticator::AuthenticationFinished, this, &ListenBrainzScrobbler::OAuthFinished);
 
-  timer_submit_->setSingleShot(true);
-  QObject::connect(timer_submit_, &QTimer::timeout, this, &ListenBrainzScrobbler::Submit);
-
   ListenBrainzScrobbler::ReloadSettings();
   oauth_->LoadSession();
 
@@ -397,17 +391,7 @@ void ListenBrainzScrobbler::Scrobble(const Song &song) {
 void ListenBrainzScrobbler::StartSubmit(const bool initial) {
 
   if (!submitted_ && cache_->Count() > 0) {
-    if (initial && settings_->submit_delay() <= 0 && !submit_error_) {
-      if (timer_submit_->isActive()) {
-        timer_submit_->stop();
-      }
-      Submit();
-    }
-    else if (!timer_submit_->isActive()) {
-      int submit_delay = static_cast<int>(std::max(settings_->submit_delay(), submit_error_ ? 30 : 5) * kMsecPerSec);
-      timer_submit_->setInterval(submit_delay);
-      timer_submit_->start();
-    }
+    Q_EMIT SubmitRequested(initial);
   }
 
 }
@@ -462,7 +446,8 @@ void ListenBrainzScrobbler::ScrobbleRequestFinished(QNetworkReply *reply, Scrobb
   if (reply->error() == QNetworkReply::NetworkError::RemoteHostClosedError) {
     JsonBaseRequest::Error(QStringLiteral("%1 (%2)").arg(reply->errorString()).arg(reply->error()));
     cache_->ClearSent(cache_items);
-    submit_error_ = true;
+    Q_EMIT SubmitFinished(false);
+    StartSubmit();
     return;
   }
 
@@ -477,10 +462,10 @@ void ListenBrainzScrobbler::ScrobbleRequestFinished(QNetworkReply *reply, Scrobb
       qLog(Debug) << "ListenBrainz: Received scrobble reply without status.";
     }
     cache_->Flush(cache_items);
-    submit_error_ = false;
+    Q_EMIT SubmitFinished(true);
   }
   else {
-    submit_error_ = true;
+    Q_EMIT SubmitFinished(false);
     if (json_object_result.error_code == ErrorCode::APIError) {
       if (cache_items.count() == 1) {
         const ScrobbleMetadata &metadata = cache_items.first()->metadata;
@@ -34,7 +34,6 @@
 #include "scrobblercache.h"
 #include "scrobblemetadata.h"
 
-class QTimer;
 class QNetworkReply;
 
 class ScrobblerSettingsService;
@@ -58,6 +57,7 @@ class ListenBrainzScrobbler : public ScrobblerService {
   bool use_authorization_header() const override { return true; }
   QByteArray authorization_header() const override { return "Token " + user_token_.toUtf8(); }
   bool submitted() const override { return submitted_; }
+  int cached_scrobbles() const override { return cache_->Count(); }
   QString user_token() const { return user_token_; }
 
   void Authenticate();
@@ -92,14 +92,12 @@ class ListenBrainzScrobbler : public ScrobblerService {
   const SharedPtr<NetworkAccessManager> network_;
   OAuthenticator *oauth_;
   ScrobblerCache *cache_;
-  QTimer *timer_submit_;
   bool enabled_;
   QString user_token_;
   bool submitted_;
   Song song_playing_;
   bool scrobbled_;
   quint64 timestamp_;
-  bool submit_error_;
 
   bool prefer_albumartist_;
 };
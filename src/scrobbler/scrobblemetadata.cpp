@@ -42,4 +42,5 @@ ScrobbleMetadata::ScrobbleMetadata(const Song &song)
       music_service_name(song.is_stream() ? song.DescriptionForSource() : QString()),
       share_url(song.ShareURL()),
       spotify_id(song.source() == Song::Source::Spotify ? song.song_id() : QString()),
+      subsonic_id(song.source() == Song::Source::Subsonic ? song.song_id() : QString()),
       length_nanosec(song.length_nanosec()) {}
@@ -49,6 +49,7 @@ class ScrobbleMetadata {
   QString music_service_name;
   QString share_url;
   QString spotify_id;
+  QString subsonic_id;
   qint64 length_nanosec;
 
   QString effective_albumartist() const { return albumartist.isEmpty() ? artist : albumartist; }
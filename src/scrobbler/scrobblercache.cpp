@@ -26,6 +26,8 @@
 
 #include <QObject>
 #include <QString>
+#include <QByteArray>
+#include <QHash>
 #include <QFile>
 #include <QIODevice>
 #include <QTextStream>
@@ -34,6 +36,9 @@
 #include <QJsonValue>
 #include <QJsonObject>
 #include <QJsonArray>
+#include <QFuture>
+#include <QFutureWatcher>
+#include <QtConcurrentRun>
 
 #include "core/song.h"
 #include "core/logging.h"
@@ -46,11 +51,181 @@ using namespace std::chrono_literals;
 using namespace Qt::Literals::StringLiterals;
 using std::make_shared;
 
+namespace {
+
+// The journal is compacted when it holds this many more records than there are scrobbles left in the cache.
+constexpr qint64 kCompactThreshold = 100;
+
+QJsonObject TrackToJson(const ScrobblerCacheItem &cache_item) {
+
+  QJsonObject object;
+  object.insert("timestamp"_L1, QJsonValue::fromVariant(cache_item.timestamp));
+  object.insert("artist"_L1, QJsonValue::fromVariant(cache_item.metadata.artist));
+  object.insert("album"_L1, QJsonValue::fromVariant(cache_item.metadata.album));
+  object.insert("title"_L1, QJsonValue::fromVariant(cache_item.metadata.title));
+  object.insert("track"_L1, QJsonValue::fromVariant(cache_item.metadata.track));
+  object.insert("albumartist"_L1, QJsonValue::fromVariant(cache_item.metadata.albumartist));
+  object.insert("grouping"_L1, QJsonValue::fromVariant(cache_item.metadata.grouping));
+  object.insert("musicbrainz_album_artist_id"_L1, QJsonValue::fromVariant(cache_item.metadata.musicbrainz_album_artist_id));
+  object.insert("musicbrainz_artist_id"_L1, QJsonValue::fromVariant(cache_item.metadata.musicbrainz_artist_id));
+  object.insert("musicbrainz_original_artist_id"_L1, QJsonValue::fromVariant(cache_item.metadata.musicbrainz_original_artist_id));
+  object.insert("musicbrainz_album_id"_L1, QJsonValue::fromVariant(cache_item.metadata.musicbrainz_album_id));
+  object.insert("musicbrainz_original_album_id"_L1, QJsonValue::fromVariant(cache_item.metadata.musicbrainz_original_album_id));
+  object.insert("musicbrainz_recording_id"_L1, QJsonValue::fromVariant(cache_item.metadata.musicbrainz_recording_id));
+  object.insert("musicbrainz_track_id"_L1, QJsonValue::fromVariant(cache_item.metadata.musicbrainz_track_id));
+  object.insert("musicbrainz_disc_id"_L1, QJsonValue::fromVariant(cache_item.metadata.musicbrainz_disc_id));
+  object.insert("musicbrainz_release_group_id"_L1, QJsonValue::fromVariant(cache_item.metadata.musicbrainz_release_group_id));
+  object.insert("musicbrainz_work_id"_L1, QJsonValue::fromVariant(cache_item.metadata.musicbrainz_work_id));
+  object.insert("music_service"_L1, QJsonValue::fromVariant(cache_item.metadata.music_service));
+  object.insert("music_service_name"_L1, QJsonValue::fromVariant(cache_item.metadata.music_service_name));
+  object.insert("share_url"_L1, QJsonValue::fromVariant(cache_item.metadata.share_url));
+  object.insert("spotify_id"_L1, QJsonValue::fromVariant(cache_item.metadata.spotify_id));
+  object.insert("subsonic_id"_L1, QJsonValue::fromVariant(cache_item.metadata.subsonic_id));
+  object.insert("length_nanosec"_L1, QJsonValue::fromVariant(cache_item.metadata.length_nanosec));
+  return object;
+
+}
+
+ScrobblerCacheItemPtr TrackFromJson(const QJsonObject &json_obj_track) {
+
+  if (!json_obj_track.contains("timestamp"_L1) ||
+      !json_obj_track.contains("artist"_L1) ||
+      !json_obj_track.contains("album"_L1) ||
+      !json_obj_track.contains("title"_L1) ||
+      !json_obj_track.contains("track"_L1) ||
+      !json_obj_track.contains("albumartist"_L1) ||
+      !json_obj_track.contains("length_nanosec"_L1)) {
+    qLog(Error) << "Scrobbler cache track is missing data.";
+    qLog(Debug) << json_obj_track;
+    return nullptr;
+  }
+
+  ScrobbleMetadata metadata;
+  const quint64 timestamp = json_obj_track["timestamp"_L1].toVariant().toULongLong();
+  metadata.artist = json_obj_track["artist"_L1].toString();
+  metadata.album = json_obj_track["album"_L1].toString();
+  metadata.title = json_obj_track["title"_L1].toString();
+  metadata.track = json_obj_track["track"_L1].toInt();
+  metadata.albumartist = json_obj_track["albumartist"_L1].toString();
+  metadata.length_nanosec = json_obj_track["length_nanosec"_L1].toVariant().toLongLong();
+
+  if (timestamp == 0 || metadata.artist.isEmpty() || metadata.title.isEmpty() || metadata.length_nanosec <= 0) {
+    qLog(Error) << "Invalid cache data" << "for song" << metadata.title;
+    return nullptr;
+  }
+
+  if (json_obj_track.contains("grouping"_L1)) {
+    metadata.grouping = json_obj_track["grouping"_L1].toString();
+  }
+
+  if (json_obj_track.contains("musicbrainz_album_artist_id"_L1)) {
+    metadata.musicbrainz_album_artist_id = json_obj_track["musicbrainz_album_artist_id"_L1].toString();
+  }
+  if (json_obj_track.contains("musicbrainz_artist_id"_L1)) {
+    metadata.musicbrainz_artist_id = json_obj_track["musicbrainz_artist_id"_L1].toString();
+  }
+  if (json_obj_track.contains("musicbrainz_original_artist_id"_L1)) {
+    metadata.musicbrainz_original_artist_id = json_obj_track["musicbrainz_original_artist_id"_L1].toString();
+  }
+  if (json_obj_track.contains("musicbrainz_album_id"_L1)) {
+    metadata.musicbrainz_album_id = json_obj_track["musicbrainz_album_id"_L1].toString();
+  }
+  if (json_obj_track.contains("musicbrainz_original_album_id"_L1)) {
+    metadata.musicbrainz_original_album_id = json_obj_track["musicbrainz_original_album_id"_L1].toString();
+  }
+  if (json_obj_track.contains("musicbrainz_recording_id"_L1)) {
+    metadata.musicbrainz_recording_id = json_obj_track["musicbrainz_recording_id"_L1].toString();
+  }
+  if (json_obj_track.contains("musicbrainz_track_id"_L1)) {
+    metadata.musicbrainz_track_id = json_obj_track["musicbrainz_track_id"_L1].toString();
+  }
+  if (json_obj_track.contains("musicbrainz_disc_id"_L1)) {
+    metadata.musicbrainz_disc_id = json_obj_track["musicbrainz_disc_id"_L1].toString();
+  }
+  if (json_obj_track.contains("musicbrainz_release_group_id"_L1)) {
+    metadata.musicbrainz_release_group_id = json_obj_track["musicbrainz_release_group_id"_L1].toString();
+  }
+  if (json_obj_track.contains("musicbrainz_work_id"_L1)) {
+    metadata.musicbrainz_work_id = json_obj_track["musicbrainz_work_id"_L1].toString();
+  }
+  if (json_obj_track.contains("music_service"_L1)) {
+    metadata.music_service = json_obj_track["music_service"_L1].toString();
+  }
+  if (json_obj_track.contains("music_service_name"_L1)) {
+    metadata.music_service_name = json_obj_track["music_service_name"_L1].toString();
+  }
+  if (json_obj_track.contains("share_url"_L1)) {
+    metadata.share_url = json_obj_track["share_url"_L1].toString();
+  }
+  if (json_obj_track.contains("spotify_id"_L1)) {
+    metadata.spotify_id = json_obj_track["spotify_id"_L1].toString();
+  }
+  if (json_obj_track.contains("subsonic_id"_L1)) {
+    metadata.subsonic_id = json_obj_track["subsonic_id"_L1].toString();
+  }
+
+  return make_shared<ScrobblerCacheItem>(metadata, timestamp);
+
+}
+
+QByteArray JournalAddRecord(const ScrobblerCacheItem &cache_item) {
+
+  QJsonObject object = TrackToJson(cache_item);
+  object.insert("op"_L1, "add"_L1);
+  object.insert("id"_L1, QJsonValue::fromVariant(cache_item.id));
+  return QJsonDocument(object).toJson(QJsonDocument::Compact) + '\n';
+
+}
+
+QByteArray JournalRemoveRecord(const ScrobblerCacheItem &cache_item) {
+
+  QJsonObject object;
+  object.insert("op"_L1, "remove"_L1);
+  object.insert("id"_L1, QJsonValue::fromVariant(cache_item.id));
+  return QJsonDocument(object).toJson(QJsonDocument::Compact) + '\n';
+
+}
+
+bool WriteJournal(const QString &filename, const QList<ScrobblerCacheItem> &cache_items) {
+
+  const QString temp_filename = filename + u".tmp"_s;
+  QFile file(temp_filename);
+  if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+    qLog(Error) << "Unable to open scrobbler cache file" << temp_filename << file.errorString();
+    return false;
+  }
+  for (const ScrobblerCacheItem &cache_item : cache_items) {
+    if (file.write(JournalAddRecord(cache_item)) < 0) {
+      qLog(Error) << "Unable to write scrobbler cache file" << temp_filename << file.errorString();
+      file.close();
+      file.remove();
+      return false;
+    }
+  }
+  file.close();
+
+  if (QFile::exists(filename) && !QFile::remove(filename)) {
+    qLog(Error) << "Unable to remove scrobbler cache file" << filename;
+    QFile::remove(temp_filename);
+    return false;
+  }
+
+  return QFile::rename(temp_filename, filename);
+
+}
+
+}  // namespace
+
 ScrobblerCache::ScrobblerCache(const QString &filename, QObject *parent)
     : QObject(parent),
       timer_flush_(new QTimer(this)),
       filename_(StandardPaths::WritableLocation(StandardPaths::StandardLocation::CacheLocation) + QLatin1Char('/') + filename),
-      loaded_(false) {
+      journal_filename_(filename_ + u".journal"_s),
+      loaded_(false),
+      next_id_(1),
+      journal_records_(0),
+      compact_records_(0),
+      compact_watcher_(nullptr) {
 
   ReadCache();
   loaded_ = true;
@@ -62,11 +237,97 @@ ScrobblerCache::ScrobblerCache(const QString &filename, QObject *parent)
 }
 
 ScrobblerCache::~ScrobblerCache() {
+
+  if (compact_watcher_) {
+    compact_watcher_->waitForFinished();
+    CompactFinished();
+  }
+
   scrobbler_cache_.clear();
+
 }
 
 void ScrobblerCache::ReadCache() {
 
+  if (QFile::exists(journal_filename_)) {
+    ReadJournal();
+  }
+  else if (QFile::exists(filename_)) {
+    ReadLegacyCache();
+    // Convert the old cache file to the journal format once.
+    QList<ScrobblerCacheItem> cache_items;
+    cache_items.reserve(scrobbler_cache_.count());
+    for (const ScrobblerCacheItemPtr &cache_item : std::as_const(scrobbler_cache_)) {
+      cache_items << *cache_item;
+    }
+    if (WriteJournal(journal_filename_, cache_items)) {
+      journal_records_ = cache_items.count();
+      QFile::remove(filename_);
+    }
+  }
+
+}
+
+void ScrobblerCache::ReadJournal() {
+
+  QFile file(journal_filename_);
+  if (!file.open(QIODevice::ReadOnly)) {
+    qLog(Error) << "Unable to open scrobbler cache file" << journal_filename_ << file.errorString();
+    return;
+  }
+
+  QHash<quint64, ScrobblerCacheItemPtr> cache_items;
+  bool terminated = true;
+  while (!file.atEnd()) {
+    const QByteArray data = file.readLine();
+    terminated = data.endsWith('\n');
+    const QByteArray line = data.trimmed();
+    if (line.isEmpty()) continue;
+    ++journal_records_;
+    QJsonParseError error;
+    const QJsonDocument json_doc = QJsonDocument::fromJson(line, &error);
+    if (error.error != QJsonParseError::NoError || !json_doc.isObject()) {
+      // A partly written last record is expected if the application was killed while appending.
+      qLog(Error) << "Scrobbler cache journal has an invalid record" << error.errorString();
+      continue;
+    }
+    const QJsonObject json_obj = json_doc.object();
+    const QString op = json_obj["op"_L1].toString();
+    const quint64 id = json_obj["id"_L1].toVariant().toULongLong();
+    if (id == 0) {
+      qLog(Error) << "Scrobbler cache journal record is missing an id.";
+      continue;
+    }
+    next_id_ = qMax(next_id_, id + 1);
+    if (op == "add"_L1) {
+      ScrobblerCacheItemPtr cache_item = TrackFromJson(json_obj);
+      if (!cache_item) continue;
+      cache_item->id = id;
+      scrobbler_cache_ << cache_item;
+      cache_items.insert(id, cache_item);
+    }
+    else if (op == "remove"_L1) {
+      ScrobblerCacheItemPtr cache_item = cache_items.take(id);
+      if (cache_item) {
+        scrobbler_cache_.removeOne(cache_item);
+      }
+    }
+    else {
+      qLog(Error) << "Scrobbler cache journal record has unknown operation" << op;
+    }
+  }
+  file.close();
+
+  // Make sure new records are not appended to a partly written record.
+  if (!terminated && file.open(QIODevice::WriteOnly | QIODevice::Append)) {
+    file.write("\n");
+    file.close();
+  }
+
+}
+
+void ScrobblerCache::ReadLegacyCache() {
+
   QFile file(filename_);
   bool result = file.open(QIODevice::ReadOnly | QIODevice::Text);
   if (!result) return;
@@ -117,151 +378,98 @@ void ScrobblerCache::ReadCache() {
       qLog(Debug) << value;
       continue;
     }
-    QJsonObject json_obj_track = value.toObject();
-    if (!json_obj_track.contains("timestamp"_L1) ||
-        !json_obj_track.contains("artist"_L1) ||
-        !json_obj_track.contains("album"_L1) ||
-        !json_obj_track.contains("title"_L1) ||
-        !json_obj_track.contains("track"_L1) ||
-        !json_obj_track.contains("albumartist"_L1) ||
-        !json_obj_track.contains("length_nanosec"_L1)) {
-      qLog(Error) << "Scrobbler cache JSON tracks array value is missing data.";
-      qLog(Debug) << value;
-      continue;
-    }
+    ScrobblerCacheItemPtr cache_item = TrackFromJson(value.toObject());
+    if (!cache_item) continue;
+    cache_item->id = next_id_++;
+    scrobbler_cache_ << cache_item;
+  }
 
-    ScrobbleMetadata metadata;
-    quint64 timestamp = json_obj_track["timestamp"_L1].toVariant().toULongLong();
-    metadata.artist = json_obj_track["artist"_L1].toString();
-    metadata.album = json_obj_track["album"_L1].toString();
-    metadata.title = json_obj_track["title"_L1].toString();
-    metadata.track = json_obj_track["track"_L1].toInt();
-    metadata.albumartist = json_obj_track["albumartist"_L1].toString();
-    metadata.length_nanosec = json_obj_track["length_nanosec"_L1].toVariant().toLongLong();
-
-    if (timestamp == 0 || metadata.artist.isEmpty() || metadata.title.isEmpty() || metadata.length_nanosec <= 0) {
-      qLog(Error) << "Invalid cache data" << "for song" << metadata.title;
-      continue;
-    }
+}
 
-    if (json_obj_track.contains("grouping"_L1)) {
-      metadata.grouping = json_obj_track["grouping"_L1].toString();
-    }
+void ScrobblerCache::AppendJournal(const QByteArray &records) {
 
-    if (json_obj_track.contains("musicbrainz_album_artist_id"_L1)) {
-      metadata.musicbrainz_album_artist_id = json_obj_track["musicbrainz_album_artist_id"_L1].toString();
-    }
-    if (json_obj_track.contains("musicbrainz_artist_id"_L1)) {
-      metadata.musicbrainz_artist_id = json_obj_track["musicbrainz_artist_id"_L1].toString();
-    }
-    if (json_obj_track.contains("musicbrainz_original_artist_id"_L1)) {
-      metadata.musicbrainz_original_artist_id = json_obj_track["musicbrainz_original_artist_id"_L1].toString();
-    }
-    if (json_obj_track.contains("musicbrainz_album_id"_L1)) {
-      metadata.musicbrainz_album_id = json_obj_track["musicbrainz_album_id"_L1].toString();
-    }
-    if (json_obj_track.contains("musicbrainz_original_album_id"_L1)) {
-      metadata.musicbrainz_original_album_id = json_obj_track["musicbrainz_original_album_id"_L1].toString();
-    }
-    if (json_obj_track.contains("musicbrainz_recording_id"_L1)) {
-      metadata.musicbrainz_recording_id = json_obj_track["musicbrainz_recording_id"_L1].toString();
-    }
-    if (json_obj_track.contains("musicbrainz_track_id"_L1)) {
-      metadata.musicbrainz_track_id = json_obj_track["musicbrainz_track_id"_L1].toString();
-    }
-    if (json_obj_track.contains("musicbrainz_disc_id"_L1)) {
-      metadata.musicbrainz_disc_id = json_obj_track["musicbrainz_disc_id"_L1].toString();
-    }
-    if (json_obj_track.contains("musicbrainz_release_group_id"_L1)) {
-      metadata.musicbrainz_release_group_id = json_obj_track["musicbrainz_release_group_id"_L1].toString();
-    }
-    if (json_obj_track.contains("musicbrainz_work_id"_L1)) {
-      metadata.musicbrainz_work_id = json_obj_track["musicbrainz_work_id"_L1].toString();
-    }
-    if (json_obj_track.contains("music_service"_L1)) {
-      metadata.music_service = json_obj_track["music_service"_L1].toString();
-    }
-    if (json_obj_track.contains("music_service_name"_L1)) {
-      metadata.music_service_name = json_obj_track["music_service_name"_L1].toString();
-    }
-    if (json_obj_track.contains("share_url"_L1)) {
-      metadata.share_url = json_obj_track["share_url"_L1].toString();
-    }
-    if (json_obj_track.contains("spotify_id"_L1)) {
-      metadata.spotify_id = json_obj_track["spotify_id"_L1].toString();
-    }
+  if (!loaded_ || records.isEmpty()) return;
 
-    ScrobblerCacheItemPtr cache_item = make_shared<ScrobblerCacheItem>(metadata, timestamp);
-    scrobbler_cache_ << cache_item;
+  // The journal file is replaced while compacting, keep new records until it is done.
+  if (compact_watcher_) {
+    pending_records_.append(records);
+    return;
+  }
 
+  QFile file(journal_filename_);
+  if (!file.open(QIODevice::WriteOnly | QIODevice::Append)) {
+    qLog(Error) << "Unable to open scrobbler cache file" << journal_filename_ << file.errorString();
+    return;
+  }
+  if (file.write(records) < 0) {
+    qLog(Error) << "Unable to write scrobbler cache file" << journal_filename_ << file.errorString();
   }
+  file.close();
+
+  journal_records_ += records.count('\n');
 
 }
 
 void ScrobblerCache::WriteCache() {
 
-  if (!loaded_) return;
-
-  qLog(Debug) << "Writing scrobbler cache file" << filename_;
+  if (!loaded_ || compact_watcher_) return;
 
   if (scrobbler_cache_.isEmpty()) {
-    QFile file(filename_);
-    if (file.exists()) file.remove();
+    if (QFile::exists(journal_filename_)) {
+      qLog(Debug) << "Removing scrobbler cache file" << journal_filename_;
+      QFile::remove(journal_filename_);
+    }
+    journal_records_ = 0;
     return;
   }
 
-  QJsonArray array;
-  for (int i = 0; i < scrobbler_cache_.count(); i++) {
-    ScrobblerCacheItemPtr cache_item = scrobbler_cache_.at(i);
-    QJsonObject object;
-    object.insert("timestamp"_L1, QJsonValue::fromVariant(cache_item->timestamp));
-    object.insert("artist"_L1, QJsonValue::fromVariant(cache_item->metadata.artist));
-    object.insert("album"_L1, QJsonValue::fromVariant(cache_item->metadata.album));
-    object.insert("title"_L1, QJsonValue::fromVariant(cache_item->metadata.title));
-    object.insert("track"_L1, QJsonValue::fromVariant(cache_item->metadata.track));
-    object.insert("albumartist"_L1, QJsonValue::fromVariant(cache_item->metadata.albumartist));
-    object.insert("grouping"_L1, QJsonValue::fromVariant(cache_item->metadata.grouping));
-    object.insert("musicbrainz_album_artist_id"_L1, QJsonValue::fromVariant(cache_item->metadata.musicbrainz_album_artist_id));
-    object.insert("musicbrainz_artist_id"_L1, QJsonValue::fromVariant(cache_item->metadata.musicbrainz_artist_id));
-    object.insert("musicbrainz_original_artist_id"_L1, QJsonValue::fromVariant(cache_item->metadata.musicbrainz_original_artist_id));
-    object.insert("musicbrainz_album_id"_L1, QJsonValue::fromVariant(cache_item->metadata.musicbrainz_album_id));
-    object.insert("musicbrainz_original_album_id"_L1, QJsonValue::fromVariant(cache_item->metadata.musicbrainz_original_album_id));
-    object.insert("musicbrainz_recording_id"_L1, QJsonValue::fromVariant(cache_item->metadata.musicbrainz_recording_id));
-    object.insert("musicbrainz_track_id"_L1, QJsonValue::fromVariant(cache_item->metadata.musicbrainz_track_id));
-    object.insert("musicbrainz_disc_id"_L1, QJsonValue::fromVariant(cache_item->metadata.musicbrainz_disc_id));
-    object.insert("musicbrainz_release_group_id"_L1, QJsonValue::fromVariant(cache_item->metadata.musicbrainz_release_group_id));
-    object.insert("musicbrainz_work_id"_L1, QJsonValue::fromVariant(cache_item->metadata.musicbrainz_work_id));
-    object.insert("music_service"_L1, QJsonValue::fromVariant(cache_item->metadata.music_service));
-    object.insert("music_service_name"_L1, QJsonValue::fromVariant(cache_item->metadata.music_service_name));
-    object.insert("share_url"_L1, QJsonValue::fromVariant(cache_item->metadata.share_url));
-    object.insert("spotify_id"_L1, QJsonValue::fromVariant(cache_item->metadata.spotify_id));
-    object.insert("length_nanosec"_L1, QJsonValue::fromVariant(cache_item->metadata.length_nanosec));
-    array.append(QJsonValue::fromVariant(object));
+  if (journal_records_ <= scrobbler_cache_.count() * 2 + kCompactThreshold) return;
+
+  qLog(Debug) << "Compacting scrobbler cache file" << journal_filename_;
+
+  QList<ScrobblerCacheItem> cache_items;
+  cache_items.reserve(scrobbler_cache_.count());
+  for (const ScrobblerCacheItemPtr &cache_item : std::as_const(scrobbler_cache_)) {
+    cache_items << *cache_item;
   }
+  compact_records_ = cache_items.count();
 
-  QJsonObject object;
-  object.insert("tracks"_L1, array);
-  QJsonDocument doc(object);
+  compact_watcher_ = new QFutureWatcher<bool>(this);
+  QObject::connect(compact_watcher_, &QFutureWatcher<bool>::finished, this, &ScrobblerCache::CompactFinished);
+  compact_watcher_->setFuture(QtConcurrent::run(&WriteJournal, journal_filename_, cache_items));
 
-  QFile file(filename_);
-  bool result = file.open(QIODevice::WriteOnly | QIODevice::Text);
-  if (!result) {
-    qLog(Error) << "Unable to open scrobbler cache file" << filename_;
-    return;
+}
+
+void ScrobblerCache::CompactFinished() {
+
+  if (!compact_watcher_) return;
+
+  const bool success = compact_watcher_->result();
+  compact_watcher_->deleteLater();
+  compact_watcher_ = nullptr;
+
+  if (success) {
+    journal_records_ = compact_records_;
+  }
+  else {
+    qLog(Error) << "Unable to compact scrobbler cache file" << journal_filename_;
   }
-  QTextStream stream(&file);
-  stream.setEncoding(QStringConverter::Encoding::Utf8);
-  stream << doc.toJson();
-  file.close();
+
+  const QByteArray records = pending_records_;
+  pending_records_.clear();
+  AppendJournal(records);
 
 }
 
 ScrobblerCacheItemPtr ScrobblerCache::Add(const Song &song, const quint64 timestamp) {
 
   ScrobblerCacheItemPtr cache_item = make_shared<ScrobblerCacheItem>(ScrobbleMetadata(song), timestamp);
+  cache_item->id = next_id_++;
 
   scrobbler_cache_ << cache_item;
 
+  AppendJournal(JournalAddRecord(*cache_item));
+
   if (loaded_ && !timer_flush_->isActive()) {
     timer_flush_->start();
   }
@@ -274,7 +482,9 @@ void ScrobblerCache::Remove(ScrobblerCacheItemPtr cache_item) {
 
   if (scrobbler_cache_.contains(cache_item)) {
     scrobbler_cache_.removeAll(cache_item);
+    AppendJournal(JournalRemoveRecord(*cache_item));
   }
+
 }
 
 void ScrobblerCache::ClearSent(ScrobblerCacheItemPtrList cache_items) {
@@ -297,13 +507,17 @@ void ScrobblerCache::SetError(ScrobblerCacheItemPtrList cache_items) {
 
 void ScrobblerCache::Flush(ScrobblerCacheItemPtrList cache_items) {
 
+  QByteArray records;
   for (int i = 0; i < cache_items.count(); i++) {
     ScrobblerCacheItemPtr cache_item = cache_items.at(i);
     if (scrobbler_cache_.contains(cache_item)) {
       scrobbler_cache_.removeAll(cache_item);
+      records.append(JournalRemoveRecord(*cache_item));
     }
   }
 
+  AppendJournal(records);
+
   if (!timer_flush_->isActive()) {
     timer_flush_->start();
   }
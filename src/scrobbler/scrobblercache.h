@@ -28,6 +28,8 @@
 #include <QObject>
 #include <QList>
 #include <QString>
+#include <QByteArray>
+#include <QFutureWatcher>
 
 #include "scrobblercacheitem.h"
 
@@ -52,12 +54,27 @@ class ScrobblerCache : public QObject {
   void Flush(ScrobblerCacheItemPtrList cache_items);
 
  public Q_SLOTS:
+  // Compacts the journal in the background when it has grown too many removed records.
   void WriteCache();
 
+ private:
+  void ReadJournal();
+  void ReadLegacyCache();
+  void AppendJournal(const QByteArray &records);
+
+ private Q_SLOTS:
+  void CompactFinished();
+
  private:
   QTimer *timer_flush_;
   QString filename_;
+  QString journal_filename_;
   bool loaded_;
+  quint64 next_id_;
+  qint64 journal_records_;
+  qint64 compact_records_;
+  QFutureWatcher<bool> *compact_watcher_;
+  QByteArray pending_records_;
   QList<ScrobblerCacheItemPtr> scrobbler_cache_;
 };
 
@@ -33,6 +33,8 @@ class ScrobblerCacheItem {
  public:
   explicit ScrobblerCacheItem(const ScrobbleMetadata &_metadata, const quint64 _timestamp);
 
+  // Identifies the item in the cache journal.
+  quint64 id;
   ScrobbleMetadata metadata;
   quint64 timestamp;
   bool sent;
@@ -51,9 +51,13 @@ class ScrobblerService : public JsonBaseRequest {
   virtual void Scrobble(const Song &song) = 0;
   virtual void Love() {}
 
+  // Asks AudioScrobbler to schedule a call to Submit() by emitting SubmitRequested().
   virtual void StartSubmit(const bool initial = false) = 0;
   virtual bool submitted() const { return false; }
 
+  // Number of scrobbles waiting to be submitted.
+  virtual int cached_scrobbles() const { return 0; }
+
  protected:
   using EncodedParam = QPair<QByteArray, QByteArray>;
 
@@ -67,6 +71,8 @@ class ScrobblerService : public JsonBaseRequest {
  Q_SIGNALS:
   void ErrorMessage(const QString &error);
   void OpenSettingsDialog();
+  void SubmitRequested(const bool initial);
+  void SubmitFinished(const bool success);
 
  protected:
   const QString name_;
@@ -22,37 +22,45 @@
 
 #include <memory>
 
+#include <QtGlobal>
+#include <QList>
 #include <QVariant>
 #include <QString>
+#include <QStringList>
 #include <QDateTime>
-#include <QTimer>
 
 #include "includes/shared_ptr.h"
 #include "core/song.h"
 #include "core/logging.h"
 #include "core/settings.h"
-#include "constants/timeconstants.h"
 #include "constants/subsonicsettings.h"
 #include "subsonic/subsonicservice.h"
 
 #include "scrobblersettingsservice.h"
 #include "scrobblerservice.h"
+#include "scrobblercache.h"
+#include "scrobblercacheitem.h"
 #include "subsonicscrobbler.h"
 
 namespace {
 constexpr char kName[] = "Subsonic";
-}
+constexpr char kCacheFile[] = "subsonicscrobbler.cache";
+constexpr int kScrobblesPerRequest = 50;
+}  // namespace
 
 SubsonicScrobbler::SubsonicScrobbler(const SharedPtr<ScrobblerSettingsService> settings, const SharedPtr<NetworkAccessManager> network, const SharedPtr<SubsonicService> service, QObject *parent)
     : ScrobblerService(QLatin1String(kName), network, settings, parent),
       service_(service),
+      cache_(new ScrobblerCache(QLatin1String(kCacheFile), this)),
       enabled_(false),
-      submitted_(false) {
+      submitted_(false),
+      timestamp_(0) {
 
   SubsonicScrobbler::ReloadSettings();
 
-  timer_submit_.setSingleShot(true);
-  QObject::connect(&timer_submit_, &QTimer::timeout, this, &SubsonicScrobbler::Submit);
+  if (service_) {
+    QObject::connect(&*service_, &SubsonicService::ScrobbleFinished, this, &SubsonicScrobbler::ScrobbleFinished);
+  }
 
 }
 
@@ -71,23 +79,35 @@ SubsonicServicePtr SubsonicScrobbler::service() const {
 
 }
 
+int SubsonicScrobbler::cached_scrobbles() const {
+
+  return cache_->Count();
+
+}
+
+void SubsonicScrobbler::WriteCache() {
+
+  cache_->WriteCache();
+
+}
+
 void SubsonicScrobbler::UpdateNowPlaying(const Song &song) {
 
   if (song.source() != Song::Source::Subsonic) return;
 
   song_playing_ = song;
-  time_ = QDateTime::currentDateTime();
+  timestamp_ = static_cast<quint64>(QDateTime::currentSecsSinceEpoch());
 
   if (!song.is_metadata_good() || settings_->offline() || !service()) return;
 
-  service()->Scrobble(song.song_id(), false, time_);
+  service()->Scrobble(QStringList() << song.song_id(), QList<qint64>() << static_cast<qint64>(timestamp_) * 1000, false);
 
 }
 
 void SubsonicScrobbler::ClearPlaying() {
 
   song_playing_ = Song();
-  time_ = QDateTime();
+  timestamp_ = 0;
 
 }
 
@@ -95,28 +115,94 @@ void SubsonicScrobbler::Scrobble(const Song &song) {
 
   if (song.source() != Song::Source::Subsonic || song.id() != song_playing_.id() || song.url() != song_playing_.url() || !song.is_metadata_good()) return;
 
+  // Scrobbles are kept in the cache while offline or when the server can't be reached, and submitted later.
+  cache_->Add(song, timestamp_);
+
   if (settings_->offline()) return;
 
-  if (!submitted_) {
-    submitted_ = true;
-    if (settings_->submit_delay() <= 0) {
-      Submit();
-    }
-    else if (!timer_submit_.isActive()) {
-      timer_submit_.setInterval(static_cast<int>(settings_->submit_delay() * kMsecPerSec));
-      timer_submit_.start();
-    }
+  StartSubmit(true);
+
+}
+
+void SubsonicScrobbler::StartSubmit(const bool initial) {
+
+  if (!submitted_ && cache_->Count() > 0) {
+    Q_EMIT SubmitRequested(initial);
   }
 
 }
 
 void SubsonicScrobbler::Submit() {
 
-  qLog(Debug) << "SubsonicScrobbler: Submitting scrobble for" << song_playing_.artist() << song_playing_.title();
+  qLog(Debug) << "SubsonicScrobbler: Submitting scrobbles.";
+
+  if (!enabled() || settings_->offline() || !service()) return;
+
+  QStringList song_ids;
+  QList<qint64> times_ms;
+  ScrobblerCacheItemPtrList cache_items_sent;
+  ScrobblerCacheItemPtrList cache_items_invalid;
+  const ScrobblerCacheItemPtrList all_cache_items = cache_->List();
+  for (ScrobblerCacheItemPtr cache_item : all_cache_items) {
+    if (cache_item->sent) continue;
+    if (cache_item->metadata.subsonic_id.isEmpty()) {
+      cache_items_invalid << cache_item;
+      continue;
+    }
+    if (cache_item->error && cache_items_sent.count() > 0) break;
+    cache_item->sent = true;
+    cache_items_sent << cache_item;
+    song_ids << cache_item->metadata.subsonic_id;
+    times_ms << static_cast<qint64>(cache_item->timestamp) * 1000;
+    if (cache_items_sent.count() >= kScrobblesPerRequest || cache_item->error) break;
+  }
+
+  if (!cache_items_invalid.isEmpty()) {
+    cache_->Flush(cache_items_invalid);
+  }
+
+  if (cache_items_sent.count() <= 0) return;
+
+  if (!service()->Scrobble(song_ids, times_ms, true)) {
+    cache_->ClearSent(cache_items_sent);
+    Q_EMIT SubmitFinished(false);
+    return;
+  }
+
+  submitted_ = true;
+  cache_items_sent_ = cache_items_sent;
+
+}
+
+void SubsonicScrobbler::ScrobbleFinished(const bool success, const bool api_error, const QString &error) {
+
+  if (!submitted_) return;
+
   submitted_ = false;
+  const ScrobblerCacheItemPtrList cache_items = cache_items_sent_;
+  cache_items_sent_.clear();
 
-  if (settings_->offline() || !service()) return;
+  if (success) {
+    cache_->Flush(cache_items);
+    Q_EMIT SubmitFinished(true);
+  }
+  else {
+    Q_EMIT SubmitFinished(false);
+    if (api_error && cache_items.count() == 1) {
+      // The server refused the scrobble, it would fail again.
+      const ScrobbleMetadata &metadata = cache_items.first()->metadata;
+      qLog(Error) << "SubsonicScrobbler: Unable to scrobble" << metadata.effective_albumartist() << metadata.title << error;
+      cache_->Flush(cache_items);
+    }
+    else {
+      // Retried later, a batch the server refused is retried one scrobble at a time.
+      if (api_error) {
+        cache_->SetError(cache_items);
+      }
+      cache_->ClearSent(cache_items);
+    }
+  }
 
-  service()->Scrobble(song_playing_.song_id(), true, time_);
+  StartSubmit();
 
 }
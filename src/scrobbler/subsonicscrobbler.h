@@ -23,16 +23,17 @@
 
 #include "config.h"
 
-#include <QDateTime>
+#include <QtGlobal>
 #include <QVariant>
 #include <QString>
-#include <QTimer>
 
 #include "includes/shared_ptr.h"
 #include "core/song.h"
 #include "scrobblerservice.h"
+#include "scrobblercacheitem.h"
 
 class ScrobblerSettingsService;
+class ScrobblerCache;
 class SubsonicService;
 
 class SubsonicScrobbler : public ScrobblerService {
@@ -53,22 +54,27 @@ class SubsonicScrobbler : public ScrobblerService {
   void ClearPlaying() override;
   void Scrobble(const Song &song) override;
 
-  void StartSubmit(const bool initial = false) override { Q_UNUSED(initial) }
+  void StartSubmit(const bool initial = false) override;
   bool submitted() const override { return submitted_; }
+  int cached_scrobbles() const override;
 
   SharedPtr<SubsonicService> service() const;
 
  public Q_SLOTS:
-  void WriteCache() override {}
+  void WriteCache() override;
   void Submit() override;
 
+ private Q_SLOTS:
+  void ScrobbleFinished(const bool success, const bool api_error, const QString &error);
+
  private:
   const SharedPtr<SubsonicService> service_;
+  ScrobblerCache *cache_;
   bool enabled_;
   bool submitted_;
   Song song_playing_;
-  QDateTime time_;
-  QTimer timer_submit_;
+  quint64 timestamp_;
+  ScrobblerCacheItemPtrList cache_items_sent_;
 };
 
 #endif  // SUBSONICSCROBBLER_H
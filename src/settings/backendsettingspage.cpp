@@ -49,7 +49,6 @@
 #include "engine/enginebase.h"
 #include "engine/enginedevice.h"
 #include "engine/devicefinders.h"
-#include "engine/devicefinder.h"
 #include "widgets/lineedit.h"
 #include "widgets/stickyslider.h"
 #include "settings/settingspage.h"
@@ -107,7 +106,9 @@ BackendSettingsPage::BackendSettingsPage(SettingsDialog *dialog, const SharedPtr
   QObject::connect(ui_->checkbox_fadeout_cross, &QCheckBox::toggled, this, &BackendSettingsPage::FadingOptionsChanged);
   QObject::connect(ui_->checkbox_fadeout_auto, &QCheckBox::toggled, this, &BackendSettingsPage::FadingOptionsChanged);
   QObject::connect(ui_->checkbox_channels, &QCheckBox::toggled, ui_->widget_channels, &QSpinBox::setEnabled);
+  QObject::connect(ui_->checkbox_stream_cache, &QCheckBox::toggled, ui_->spinbox_stream_cache_size, &QSpinBox::setEnabled);
   QObject::connect(ui_->button_buffer_defaults, &QPushButton::clicked, this, &BackendSettingsPage::BufferDefaults);
+  QObject::connect(&*device_finders_, &DeviceFinders::DevicesChanged, this, &BackendSettingsPage::DevicesChanged);
 
 #ifdef Q_OS_WIN32
   ui_->widget_exclusive_mode->show();
@@ -170,6 +171,9 @@ void BackendSettingsPage::Load() {
 
   Load_Output(output_current_, device_current_);
 
+  // The cached devices are shown right away, the list is updated if they changed since.
+  device_finders_->Refresh();
+
   ui_->checkbox_volume_control->setChecked(s.value(kVolumeControl, true).toBool());
 
   ui_->checkbox_channels->setChecked(s.value(kChannelsEnabled, false).toBool());
@@ -178,11 +182,19 @@ void BackendSettingsPage::Load() {
 
   ui_->checkbox_bs2b->setChecked(s.value(kBS2B, false).toBool());
 
+  ui_->checkbox_low_latency->setChecked(s.value(kLowLatency, false).toBool());
+
+  ui_->checkbox_low_power_mode->setChecked(s.value(kLowPowerMode, true).toBool());
+
   ui_->checkbox_playbin3->setChecked(s.value(kPlaybin3, true).toBool());
 
   ui_->checkbox_http2->setChecked(s.value(kHTTP2, false).toBool());
   ui_->checkbox_strict_ssl->setChecked(s.value(kStrictSSL, false).toBool());
 
+  ui_->checkbox_stream_cache->setChecked(s.value(kStreamCache, false).toBool());
+  ui_->spinbox_stream_cache_size->setValue(s.value(kStreamCacheSize, kDefaultStreamCacheSize).toInt());
+  ui_->spinbox_stream_cache_size->setEnabled(ui_->checkbox_stream_cache->isChecked());
+
   ui_->spinbox_bufferduration->setValue(s.value(kBufferDuration, kDefaultBufferDuration).toInt());
   ui_->spinbox_low_watermark->setValue(s.value(kBufferLowWatermark, kDefaultBufferLowWatermark).toDouble());
   ui_->spinbox_high_watermark->setValue(s.value(kBufferHighWatermark, kDefaultBufferHighWatermark).toDouble());
@@ -191,6 +203,7 @@ void BackendSettingsPage::Load() {
   ui_->combobox_replaygainmode->setCurrentIndex(s.value(kRgMode, 0).toInt());
   ui_->stickyslider_replaygainpreamp->setValue(static_cast<int>(s.value(kRgPreamp, 0.0).toDouble() * 10 + 600));
   ui_->checkbox_replaygaincompression->setChecked(s.value(kRgCompression, true).toBool());
+  ui_->checkbox_replaygain_from_loudness->setChecked(s.value(kRgFromLoudness, false).toBool());
   ui_->stickyslider_replaygainfallbackgain->setValue(static_cast<int>(s.value(kRgFallbackGain, 0.0).toDouble() * 10 + 600));
 
   ui_->radiobutton_ebur128_loudness_normalization->setChecked(s.value(kEBUR128LoudnessNormalization, false).toBool());
@@ -297,15 +310,11 @@ void BackendSettingsPage::Load_Device(const QString &output, const QVariant &dev
   ui_->combobox_device->addItem(IconLoader::Load(u"soundcard"_s), QLatin1String(kOutputAutomaticallySelect), QVariant());
 #endif
 
-  const QList<DeviceFinder*> device_finders = device_finders_->ListFinders();
-  for (DeviceFinder *f : device_finders) {
-    if (!f->outputs().contains(output)) continue;
-    const EngineDeviceList engine_devices = f->ListDevices();
-    for (const EngineDevice &d : engine_devices) {
-      devices++;
-      ui_->combobox_device->addItem(IconLoader::Load(d.iconname), d.description, d.value);
-      if (d.value == device) { df_device = d; }
-    }
+  const EngineDeviceList engine_devices = device_finders_->Devices(output);
+  for (const EngineDevice &d : engine_devices) {
+    devices++;
+    ui_->combobox_device->addItem(IconLoader::Load(d.iconname), d.description, d.value);
+    if (d.value == device) { df_device = d; }
   }
 
   if (player_->engine()->CustomDeviceSupport(output)) {
@@ -442,11 +451,18 @@ void BackendSettingsPage::Save() {
 
   s.setValue(kBS2B, ui_->checkbox_bs2b->isChecked());
 
+  s.setValue(kLowLatency, ui_->checkbox_low_latency->isChecked());
+
+  s.setValue(kLowPowerMode, ui_->checkbox_low_power_mode->isChecked());
+
   s.setValue(kPlaybin3, ui_->checkbox_playbin3->isChecked());
 
   s.setValue(kHTTP2, ui_->checkbox_http2->isChecked());
   s.setValue(kStrictSSL, ui_->checkbox_strict_ssl->isChecked());
 
+  s.setValue(kStreamCache, ui_->checkbox_stream_cache->isChecked());
+  s.setValue(kStreamCacheSize, ui_->spinbox_stream_cache_size->value());
+
   s.setValue(kBufferDuration, ui_->spinbox_bufferduration->value());
   s.setValue(kBufferLowWatermark, ui_->spinbox_low_watermark->value());
   s.setValue(kBufferHighWatermark, ui_->spinbox_high_watermark->value());
@@ -456,6 +472,7 @@ void BackendSettingsPage::Save() {
   s.setValue(kRgPreamp, static_cast<double>(ui_->stickyslider_replaygainpreamp->value()) / 10 - 60);
   s.setValue(kRgFallbackGain, static_cast<double>(ui_->stickyslider_replaygainfallbackgain->value()) / 10 - 60);
   s.setValue(kRgCompression, ui_->checkbox_replaygaincompression->isChecked());
+  s.setValue(kRgFromLoudness, ui_->checkbox_replaygain_from_loudness->isChecked());
 
   s.setValue(kEBUR128LoudnessNormalization, ui_->radiobutton_ebur128_loudness_normalization->isChecked());
   s.setValue(kEBUR128TargetLevelLUFS, static_cast<double>(ui_->stickyslider_ebur128_target_level->value()) / 10);
@@ -486,6 +503,19 @@ void BackendSettingsPage::OutputChanged(const int index) {
 
 }
 
+void BackendSettingsPage::DevicesChanged() {
+
+  if (!configloaded_ || ui_->combobox_output->count() == 0) return;
+
+  const EngineBase::OutputDetails output = ui_->combobox_output->itemData(ui_->combobox_output->currentIndex()).value<EngineBase::OutputDetails>();
+  QVariant device_value;
+  if (ui_->combobox_device->currentText() == QLatin1String(kOutputCustom)) device_value = ui_->lineedit_device->text();
+  else device_value = ui_->combobox_device->itemData(ui_->combobox_device->currentIndex()).value<QVariant>();
+
+  Load_Device(output.name, device_value);
+
+}
+
 void BackendSettingsPage::DeviceSelectionChanged(int index) {
 
   if (!configloaded_) return;
@@ -64,6 +64,7 @@ class BackendSettingsPage : public SettingsPage {
   void radiobutton_alsa_pcm_clicked(const bool checked);
   void FadingOptionsChanged();
   void BufferDefaults();
+  void DevicesChanged();
 
  private:
   void Load_Output(QString output, QVariant device);
@@ -49,6 +49,7 @@
 #include "core/standardpaths.h"
 #include "core/settings.h"
 #include "utilities/strutils.h"
+#include "utilities/imageutils.h"
 #include "collection/collectionlibrary.h"
 #include "collection/collectionbackend.h"
 #include "collection/collectionmodel.h"
@@ -93,6 +94,15 @@ CollectionSettingsPage::CollectionSettingsPage(SettingsDialog *dialog,
   ui_->combobox_disk_cache_size->addItem(u"MB"_s, static_cast<int>(CacheSizeUnit::MB));
   ui_->combobox_disk_cache_size->addItem(u"GB"_s, static_cast<int>(CacheSizeUnit::GB));
 
+  const QList<ImageUtils::ThumbnailFormat> thumbnail_formats = ImageUtils::SupportedThumbnailFormats();
+  for (const ImageUtils::ThumbnailFormat thumbnail_format : thumbnail_formats) {
+    ui_->combobox_disk_cache_format->addItem(ImageUtils::ThumbnailFormatDescription(thumbnail_format), static_cast<int>(thumbnail_format));
+  }
+
+  ui_->combobox_server_mode->addItem(tr("Standalone"), static_cast<int>(ServerMode::Standalone));
+  ui_->combobox_server_mode->addItem(tr("Share this collection"), static_cast<int>(ServerMode::Server));
+  ui_->combobox_server_mode->addItem(tr("Use the collection of a server"), static_cast<int>(ServerMode::Replica));
+
   QObject::connect(ui_->add_directory, &QPushButton::clicked, this, &CollectionSettingsPage::AddDirectory);
   QObject::connect(ui_->remove_directory, &QPushButton::clicked, this, &CollectionSettingsPage::RemoveDirectory);
 
@@ -110,9 +120,12 @@ CollectionSettingsPage::CollectionSettingsPage(SettingsDialog *dialog,
 
   QObject::connect(ui_->combobox_cache_size, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &CollectionSettingsPage::CacheSizeUnitChanged);
   QObject::connect(ui_->combobox_disk_cache_size, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &CollectionSettingsPage::DiskCacheSizeUnitChanged);
+  QObject::connect(ui_->combobox_disk_cache_format, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &CollectionSettingsPage::DiskCacheFormatChanged);
 
   QObject::connect(ui_->button_save_stats, &QPushButton::clicked, this, &CollectionSettingsPage::WriteAllSongsStatisticsToFiles);
 
+  QObject::connect(ui_->combobox_server_mode, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &CollectionSettingsPage::ServerModeChanged);
+
 #ifndef HAVE_SONGFINGERPRINTING
   ui_->song_tracking->hide();
 #endif
@@ -154,6 +167,10 @@ void CollectionSettingsPage::Load() {
   ui_->mark_songs_unavailable->setChecked(ui_->song_tracking->isChecked() ? true : s.value(kMarkSongsUnavailable, true).toBool());
   ui_->song_ebur128_loudness_analysis->setChecked(s.value(kSongENUR128LoudnessAnalysis, false).toBool());
   ui_->expire_unavailable_songs_days->setValue(s.value(kExpireUnavailableSongs, 60).toInt());
+  ui_->spinbox_scan_threads->setValue(s.value(kScanThreads, kScanThreadsDefault).toInt());
+  ui_->spinbox_scan_threads_network->setValue(s.value(kScanThreadsNetwork, kScanThreadsNetworkDefault).toInt());
+  ui_->spinbox_background_read_limit->setValue(s.value(kBackgroundReadLimit, 0).toInt());
+  ui_->spinbox_tagreader_workers->setValue(s.value(kTagReaderWorkers, kTagReaderWorkersDefault).toInt());
 
   QStringList filters = s.value(kCoverArtPatterns, QStringList() << u"front"_s << u"cover"_s).toStringList();
   ui_->cover_art_patterns->setText(filters.join(u','));
@@ -165,12 +182,16 @@ void CollectionSettingsPage::Load() {
   ui_->checkbox_skip_articles_for_artists->setChecked(s.value(kSkipArticlesForArtists, true).toBool());
   ui_->checkbox_skip_articles_for_albums->setChecked(s.value(kSkipArticlesForAlbums, false).toBool());
   ui_->checkbox_use_sort_tags->setChecked(s.value(kUseSortTags, true).toBool());
+  ui_->checkbox_lazy_loading->setChecked(s.value(kLazyLoading, false).toBool());
 
   ui_->spinbox_cache_size->setValue(s.value(kSettingsCacheSize, kSettingsCacheSizeDefault).toInt());
   ui_->combobox_cache_size->setCurrentIndex(ui_->combobox_cache_size->findData(s.value(kSettingsCacheSizeUnit, static_cast<int>(CacheSizeUnit::MB)).toInt()));
   ui_->checkbox_disk_cache->setChecked(s.value(kSettingsDiskCacheEnable, false).toBool());
   ui_->spinbox_disk_cache_size->setValue(s.value(kSettingsDiskCacheSize, kSettingsDiskCacheSizeDefault).toInt());
   ui_->combobox_disk_cache_size->setCurrentIndex(ui_->combobox_disk_cache_size->findData(s.value(kSettingsDiskCacheSizeUnit, static_cast<int>(CacheSizeUnit::MB)).toInt()));
+  const int disk_cache_format_index = ui_->combobox_disk_cache_format->findData(s.value(kSettingsDiskCacheFormat, static_cast<int>(ImageUtils::ThumbnailFormat::Raw)).toInt());
+  ui_->combobox_disk_cache_format->setCurrentIndex(disk_cache_format_index == -1 ? 0 : disk_cache_format_index);
+  ui_->spinbox_disk_cache_quality->setValue(s.value(kSettingsDiskCacheQuality, kSettingsDiskCacheQualityDefault).toInt());
 
   ui_->checkbox_save_playcounts->setChecked(s.value(kSavePlayCounts, false).toBool());
   ui_->checkbox_save_ratings->setChecked(s.value(kSaveRatings, false).toBool());
@@ -179,8 +200,16 @@ void CollectionSettingsPage::Load() {
 
   ui_->checkbox_delete_files->setChecked(s.value(kDeleteFiles, false).toBool());
 
+  const int server_mode_index = ui_->combobox_server_mode->findData(s.value(kServerMode, static_cast<int>(ServerMode::Standalone)).toInt());
+  ui_->combobox_server_mode->setCurrentIndex(server_mode_index == -1 ? 0 : server_mode_index);
+  ui_->lineedit_server_host->setText(s.value(kServerHost).toString());
+  ui_->spinbox_server_port->setValue(s.value(kServerPort, kServerPortDefault).toInt());
+  ui_->lineedit_server_password->setText(s.value(kServerPassword).toString());
+
   s.endGroup();
 
+  ServerModeChanged();
+
   DiskCacheEnable(ui_->checkbox_disk_cache->checkState());
 
   UpdateIconDiskCacheSize();
@@ -202,6 +231,10 @@ void CollectionSettingsPage::Save() {
   s.setValue(kMarkSongsUnavailable, ui_->song_tracking->isChecked() ? true : ui_->mark_songs_unavailable->isChecked());
   s.setValue(kSongENUR128LoudnessAnalysis, ui_->song_ebur128_loudness_analysis->isChecked());
   s.setValue(kExpireUnavailableSongs, ui_->expire_unavailable_songs_days->value());
+  s.setValue(kScanThreads, ui_->spinbox_scan_threads->value());
+  s.setValue(kScanThreadsNetwork, ui_->spinbox_scan_threads_network->value());
+  s.setValue(kBackgroundReadLimit, ui_->spinbox_background_read_limit->value());
+  s.setValue(kTagReaderWorkers, ui_->spinbox_tagreader_workers->value());
 
   const QString filter_text = ui_->cover_art_patterns->text();
   s.setValue(kCoverArtPatterns, filter_text.split(u',', Qt::SkipEmptyParts));
@@ -213,12 +246,15 @@ void CollectionSettingsPage::Save() {
   s.setValue(kSkipArticlesForArtists, ui_->checkbox_skip_articles_for_artists->isChecked());
   s.setValue(kSkipArticlesForAlbums, ui_->checkbox_skip_articles_for_albums->isChecked());
   s.setValue(kUseSortTags, ui_->checkbox_use_sort_tags->isChecked());
+  s.setValue(kLazyLoading, ui_->checkbox_lazy_loading->isChecked());
 
   s.setValue(kSettingsCacheSize, ui_->spinbox_cache_size->value());
   s.setValue(kSettingsCacheSizeUnit, ui_->combobox_cache_size->currentData().toInt());
   s.setValue(kSettingsDiskCacheEnable, ui_->checkbox_disk_cache->isChecked());
   s.setValue(kSettingsDiskCacheSize, ui_->spinbox_disk_cache_size->value());
   s.setValue(kSettingsDiskCacheSizeUnit, ui_->combobox_disk_cache_size->currentData().toInt());
+  s.setValue(kSettingsDiskCacheFormat, ui_->combobox_disk_cache_format->currentData().toInt());
+  s.setValue(kSettingsDiskCacheQuality, ui_->spinbox_disk_cache_quality->value());
 
   s.setValue(kSavePlayCounts, ui_->checkbox_save_playcounts->isChecked());
   s.setValue(kSaveRatings, ui_->checkbox_save_ratings->isChecked());
@@ -227,6 +263,11 @@ void CollectionSettingsPage::Save() {
 
   s.setValue(kDeleteFiles, ui_->checkbox_delete_files->isChecked());
 
+  s.setValue(kServerMode, ui_->combobox_server_mode->currentData().toInt());
+  s.setValue(kServerHost, ui_->lineedit_server_host->text());
+  s.setValue(kServerPort, ui_->spinbox_server_port->value());
+  s.setValue(kServerPassword, ui_->lineedit_server_password->text());
+
   s.endGroup();
 
   const QMap<int, CollectionDirectory> dirs = collection_directory_model_->directories();
@@ -300,6 +341,9 @@ void CollectionSettingsPage::DiskCacheEnable(const int state) {
   ui_->label_disk_cache_size->setEnabled(checked);
   ui_->spinbox_disk_cache_size->setEnabled(checked);
   ui_->combobox_disk_cache_size->setEnabled(checked);
+  ui_->label_disk_cache_format->setEnabled(checked);
+  ui_->combobox_disk_cache_format->setEnabled(checked);
+  DiskCacheFormatChanged();
   ui_->label_disk_cache_in_use->setEnabled(checked);
   ui_->disk_cache_in_use->setEnabled(checked);
   ui_->button_clear_disk_cache->setEnabled(checked);
@@ -344,6 +388,17 @@ void CollectionSettingsPage::DiskCacheSizeUnitChanged(int index) {
 
 }
 
+void CollectionSettingsPage::DiskCacheFormatChanged() {
+
+  // Quality only applies to the lossy formats.
+  const ImageUtils::ThumbnailFormat thumbnail_format = static_cast<ImageUtils::ThumbnailFormat>(ui_->combobox_disk_cache_format->currentData().toInt());
+  const bool lossy = thumbnail_format != ImageUtils::ThumbnailFormat::Raw && thumbnail_format != ImageUtils::ThumbnailFormat::PNG;
+  const bool enabled = ui_->checkbox_disk_cache->isChecked() && lossy;
+  ui_->label_disk_cache_quality->setEnabled(enabled);
+  ui_->spinbox_disk_cache_quality->setEnabled(enabled);
+
+}
+
 void CollectionSettingsPage::UpdateIconDiskCacheSize() {
 
   ui_->disk_cache_in_use->setText(collection_model_->icon_disk_cache_size() == 0 ? u"empty"_s : Utilities::PrettySize(collection_model_->icon_disk_cache_size()));
@@ -360,3 +415,12 @@ void CollectionSettingsPage::WriteAllSongsStatisticsToFiles() {
   collection_->SyncPlaycountAndRatingToFilesAsync();
 
 }
+
+void CollectionSettingsPage::ServerModeChanged() {
+
+  const ServerMode server_mode = static_cast<ServerMode>(ui_->combobox_server_mode->currentData().toInt());
+  ui_->lineedit_server_host->setEnabled(server_mode == ServerMode::Replica);
+  ui_->spinbox_server_port->setEnabled(server_mode != ServerMode::Standalone);
+  ui_->lineedit_server_password->setEnabled(server_mode != ServerMode::Standalone);
+
+}
@@ -65,7 +65,9 @@ class CollectionSettingsPage : public SettingsPage {
   void ClearPixmapDiskCache();
   void CacheSizeUnitChanged(int index);
   void DiskCacheSizeUnitChanged(int index);
+  void DiskCacheFormatChanged();
   void WriteAllSongsStatisticsToFiles();
+  void ServerModeChanged();
 
  private:
   void UpdateIconDiskCacheSize();
@@ -76,6 +76,7 @@ void MoodbarSettingsPage::Load() {
   ui_->moodbar_show->setChecked(s.value(kShow, false).toBool());
   ui_->moodbar_style->setCurrentIndex(s.value(kStyle, 0).toInt());
   ui_->moodbar_save->setChecked(s.value(kSave, false).toBool());
+  ui_->moodbar_generate_collection->setChecked(s.value(kGenerateCollection, false).toBool());
   s.endGroup();
 
   InitMoodbarPreviews();
@@ -94,6 +95,7 @@ void MoodbarSettingsPage::Save() {
   s.setValue(kShow, ui_->moodbar_show->isChecked());
   s.setValue(kStyle, ui_->moodbar_style->currentIndex());
   s.setValue(kSave, ui_->moodbar_save->isChecked());
+  s.setValue(kGenerateCollection, ui_->moodbar_generate_collection->isChecked());
   s.endGroup();
 }
 
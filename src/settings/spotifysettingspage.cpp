@@ -43,6 +43,7 @@
 #include "spotify/spotifyservice.h"
 #include "widgets/loginstatewidget.h"
 #include "constants/spotifysettings.h"
+#include "engine/gststartup.h"
 
 using namespace Qt::Literals::StringLiterals;
 using namespace SpotifySettings;
@@ -65,6 +66,7 @@ SpotifySettingsPage::SpotifySettingsPage(SettingsDialog *dialog, const SharedPtr
 
   dialog->installEventFilter(this);
 
+  GstStartup::WaitForInitialized();
   GstRegistry *reg = gst_registry_get();
   if (reg) {
     GstPluginFeature *spotifyaudiosrc = gst_registry_lookup_feature(reg, "spotifyaudiosrc");
@@ -83,6 +83,9 @@ class PlaylistGenerator : public QObject, public enable_shared_from_this<Playlis
     Q_UNUSED(count);
     return PlaylistItemPtrList();
   }
+  // Prepares the next count tracks ahead of time, so the next GenerateMore() call does not have to wait for the query.
+  // Called from non-UI thread.
+  virtual void Prefetch(const int count) { Q_UNUSED(count); }
 
   virtual int GetDynamicHistory() { return kDefaultDynamicHistory; }
   virtual int GetDynamicFuture() { return kDefaultDynamicFuture; }
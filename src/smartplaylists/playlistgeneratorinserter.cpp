@@ -45,7 +45,8 @@ PlaylistGeneratorInserter::PlaylistGeneratorInserter(SharedPtr<TaskManager> task
       play_now_(false),
       enqueue_(false),
       enqueue_next_(false),
-      is_dynamic_(false) {}
+      is_dynamic_(false),
+      dynamic_count_(0) {}
 
 PlaylistItemPtrList PlaylistGeneratorInserter::Generate(PlaylistGeneratorPtr generator, int dynamic_count) {
 
@@ -67,6 +68,8 @@ void PlaylistGeneratorInserter::Load(Playlist *destination, const int row, const
   enqueue_ = enqueue;
   enqueue_next_ = enqueue_next;
   is_dynamic_ = generator->is_dynamic();
+  generator_ = generator;
+  dynamic_count_ = dynamic_count;
 
   QObject::connect(&*generator, &PlaylistGenerator::Error, this, &PlaylistGeneratorInserter::Error);
 
@@ -90,6 +93,10 @@ void PlaylistGeneratorInserter::Finished() {
   }
   else {
     destination_->InsertItems(items, row_, play_now_, enqueue_);
+    if (is_dynamic_ && dynamic_count_ > 0) {
+      // Have the next tracks ready before the next track change asks for them.
+      (void)QtConcurrent::run([generator = generator_, count = dynamic_count_]() { generator->Prefetch(count); });
+    }
   }
 
   task_manager_->SetTaskFinished(task_id_);
@@ -66,6 +66,8 @@ class PlaylistGeneratorInserter : public QObject {
   bool enqueue_;
   bool enqueue_next_;
   bool is_dynamic_;
+  PlaylistGeneratorPtr generator_;
+  int dynamic_count_;
 };
 
 #endif  // PLAYLISTGENERATORINSERTER_H
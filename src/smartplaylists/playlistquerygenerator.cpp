@@ -20,21 +20,63 @@
 
 #include "config.h"
 
+#include <utility>
+#include <random>
+#include <algorithm>
+
+#include <QtConcurrentRun>
+#include <QFuture>
+#include <QFutureWatcher>
 #include <QIODevice>
 #include <QDataStream>
+#include <QMutexLocker>
 #include <QByteArray>
+#include <QHash>
 #include <QString>
+#include <QStringList>
 
 #include "playlistquerygenerator.h"
 #include "collection/collectionbackend.h"
 
-PlaylistQueryGenerator::PlaylistQueryGenerator(QObject *parent) : PlaylistGenerator(parent), dynamic_(false), current_pos_(0) {}
+using namespace Qt::Literals::StringLiterals;
+
+namespace {
+
+QString SongIdList(const QList<int> &ids) {
+
+  QStringList str_ids;
+  str_ids.reserve(ids.count());
+  for (const int id : ids) {
+    str_ids << QString::number(id);
+  }
+  return str_ids.join(u',');
+
+}
+
+QString MatchingIdsSql(const SmartPlaylistSearch &search, const QString &songs_table, const QList<int> &ids = QList<int>()) {
+
+  QString sql = u"SELECT ROWID FROM %1 WHERE unavailable = 0"_s.arg(songs_table);
+  const QString terms_sql = search.TermsToSql();
+  if (!terms_sql.isEmpty()) {
+    sql += " AND "_L1 + terms_sql;
+  }
+  if (!ids.isEmpty()) {
+    sql += " AND ROWID IN ("_L1 + SongIdList(ids) + u')';
+  }
+  return sql;
+
+}
+
+}  // namespace
+
+PlaylistQueryGenerator::PlaylistQueryGenerator(QObject *parent) : PlaylistGenerator(parent), dynamic_(false), current_pos_(0), matching_ids_loaded_(false) {}
 
 PlaylistQueryGenerator::PlaylistQueryGenerator(const QString &name, const SmartPlaylistSearch &search, const bool dynamic, QObject *parent)
     : PlaylistGenerator(parent),
       search_(search),
       dynamic_(dynamic),
-      current_pos_(0) {
+      current_pos_(0),
+      matching_ids_loaded_(false) {
 
   set_name(name);
 
@@ -42,9 +84,14 @@ PlaylistQueryGenerator::PlaylistQueryGenerator(const QString &name, const SmartP
 
 void PlaylistQueryGenerator::Load(const SmartPlaylistSearch &search) {
 
+  QMutexLocker l(&mutex_);
+
   search_ = search;
   dynamic_ = false;
   current_pos_ = 0;
+  prefetched_songs_.clear();
+  matching_ids_loaded_ = false;
+  matching_ids_.clear();
 
 }
 
@@ -69,18 +116,63 @@ QByteArray PlaylistQueryGenerator::Save() const {
 
 PlaylistItemPtrList PlaylistQueryGenerator::Generate() {
 
-  previous_ids_.clear();
-  current_pos_ = 0;
+  {
+    QMutexLocker l(&mutex_);
+    previous_ids_.clear();
+    current_pos_ = 0;
+    prefetched_songs_.clear();
+  }
+
   return GenerateMore(0);
 
 }
 
 PlaylistItemPtrList PlaylistQueryGenerator::GenerateMore(const int count) {
 
+  QMutexLocker l(&mutex_);
+
+  SongList songs;
+  if (count > 0) {
+    songs = prefetched_songs_.mid(0, count);
+    prefetched_songs_.remove(0, songs.count());
+  }
+  if (count <= 0 || songs.count() < count) {
+    songs << Query(count > 0 ? count - static_cast<int>(songs.count()) : 0);
+  }
+
+  PlaylistItemPtrList items;
+  items.reserve(songs.count());
+  for (const Song &song : std::as_const(songs)) {
+    items << PlaylistItem::NewFromSong(song);
+  }
+
+  return items;
+
+}
+
+void PlaylistQueryGenerator::Prefetch(const int count) {
+
+  QMutexLocker l(&mutex_);
+
+  if (prefetched_songs_.count() < count) {
+    prefetched_songs_ << Query(count - static_cast<int>(prefetched_songs_.count()));
+  }
+
+}
+
+SongList PlaylistQueryGenerator::Query(const int limit) {
+
+  if (CanMaterialize()) {
+    if (!matching_ids_loaded_) {
+      MaterializeMatchingIds();
+    }
+    return QueryMaterialized(limit);
+  }
+
   SmartPlaylistSearch search_copy = search_;
   search_copy.id_not_in_ = previous_ids_;
-  if (count > 0) {
-    search_copy.limit_ = count;
+  if (limit > 0) {
+    search_copy.limit_ = limit;
   }
 
   if (search_copy.sort_type_ != SmartPlaylistSearch::SortType::Random) {
@@ -89,10 +181,7 @@ PlaylistItemPtrList PlaylistQueryGenerator::GenerateMore(const int count) {
   }
 
   const SongList songs = collection_backend_->ExecuteQuery(search_copy.ToSql(collection_backend_->songs_table()));
-  PlaylistItemPtrList items;
-  items.reserve(songs.count());
   for (const Song &song : songs) {
-    items << PlaylistItem::NewFromSong(song);
     previous_ids_ << song.id();
 
     if (previous_ids_.count() > GetDynamicFuture() + GetDynamicHistory()) {
@@ -100,6 +189,121 @@ PlaylistItemPtrList PlaylistQueryGenerator::GenerateMore(const int count) {
     }
   }
 
-  return items;
+  return songs;
+
+}
+
+bool PlaylistQueryGenerator::CanMaterialize() const {
+
+  return search_.sort_type_ == SmartPlaylistSearch::SortType::Random && !search_.is_time_dependent();
+
+}
+
+void PlaylistQueryGenerator::MaterializeMatchingIds() {
+
+  if (!matching_ids_loaded_) {
+    // Keep the ids up to date from now on, the slots run on the generator's thread.
+    QObject::connect(&*collection_backend_, &CollectionBackend::SongsAdded, this, &PlaylistQueryGenerator::CollectionSongsChanged, Qt::UniqueConnection);
+    QObject::connect(&*collection_backend_, &CollectionBackend::SongsChanged, this, &PlaylistQueryGenerator::CollectionSongsChanged, Qt::UniqueConnection);
+    QObject::connect(&*collection_backend_, &CollectionBackend::SongsStatisticsChanged, this, &PlaylistQueryGenerator::CollectionSongsChanged, Qt::UniqueConnection);
+    QObject::connect(&*collection_backend_, &CollectionBackend::SongsDeleted, this, &PlaylistQueryGenerator::CollectionSongsDeleted, Qt::UniqueConnection);
+  }
+
+  const QList<int> ids = collection_backend_->ExecuteSongIdQuery(MatchingIdsSql(search_, collection_backend_->songs_table()));
+  matching_ids_ = QSet<int>(ids.begin(), ids.end());
+  matching_ids_loaded_ = true;
+
+}
+
+SongList PlaylistQueryGenerator::QueryMaterialized(const int limit) {
+
+  const QSet<int> excluded_ids(previous_ids_.begin(), previous_ids_.end());
+  QList<int> ids;
+  ids.reserve(matching_ids_.count());
+  for (const int id : std::as_const(matching_ids_)) {
+    if (!excluded_ids.contains(id)) ids << id;
+  }
+
+  // Partially shuffle, only the first limit ids are needed.
+  static std::mt19937 rng{std::random_device{}()};
+  const qint64 count = limit < 0 ? ids.count() : std::min(static_cast<qint64>(limit), static_cast<qint64>(ids.count()));
+  for (qint64 i = 0; i < count; ++i) {
+    std::uniform_int_distribution<qint64> distribution(i, ids.count() - 1);
+    std::swap(ids[i], ids[distribution(rng)]);
+  }
+  ids.resize(count);
+  if (ids.isEmpty()) return SongList();
+
+  // The songs come back in table order, put them back in the shuffled order.
+  QHash<int, Song> songs_by_id;
+  const SongList collection_songs = collection_backend_->GetSongsById(ids);
+  for (const Song &song : collection_songs) {
+    songs_by_id.insert(song.id(), song);
+  }
+
+  SongList songs;
+  songs.reserve(ids.count());
+  for (const int id : std::as_const(ids)) {
+    const QHash<int, Song>::const_iterator it = songs_by_id.constFind(id);
+    if (it == songs_by_id.constEnd()) continue;
+    songs << it.value();
+    previous_ids_ << id;
+
+    if (previous_ids_.count() > GetDynamicFuture() + GetDynamicHistory()) {
+      previous_ids_.removeFirst();
+    }
+  }
+
+  return songs;
+
+}
+
+void PlaylistQueryGenerator::CollectionSongsChanged(const SongList &songs) {
+
+  {
+    QMutexLocker l(&mutex_);
+    if (!matching_ids_loaded_) return;
+  }
+
+  QList<int> changed_ids;
+  changed_ids.reserve(songs.count());
+  for (const Song &song : songs) {
+    if (song.id() != -1) changed_ids << song.id();
+  }
+  if (changed_ids.isEmpty()) return;
+
+  // Only re-evaluate the changed songs against the search.
+  QFuture<QList<int>> future = QtConcurrent::run([collection_backend = collection_backend_, sql = MatchingIdsSql(search_, collection_backend_->songs_table(), changed_ids)]() { return collection_backend->ExecuteSongIdQuery(sql); });
+  QFutureWatcher<QList<int>> *watcher = new QFutureWatcher<QList<int>>(this);
+  QObject::connect(watcher, &QFutureWatcher<QList<int>>::finished, this, [this, watcher, changed_ids]() {
+    MatchingIdsUpdated(changed_ids, watcher->result());
+    watcher->deleteLater();
+  });
+  watcher->setFuture(future);
+
+}
+
+void PlaylistQueryGenerator::CollectionSongsDeleted(const SongList &songs) {
+
+  QMutexLocker l(&mutex_);
+
+  for (const Song &song : songs) {
+    matching_ids_.remove(song.id());
+  }
+
+}
+
+void PlaylistQueryGenerator::MatchingIdsUpdated(const QList<int> &changed_ids, const QList<int> &matching_ids) {
+
+  QMutexLocker l(&mutex_);
+
+  if (!matching_ids_loaded_) return;
+
+  for (const int id : changed_ids) {
+    matching_ids_.remove(id);
+  }
+  for (const int id : matching_ids) {
+    matching_ids_.insert(id);
+  }
 
 }
@@ -24,9 +24,13 @@
 #include "config.h"
 
 #include <QList>
+#include <QSet>
+#include <QMutex>
 #include <QByteArray>
 #include <QString>
 
+#include "core/song.h"
+
 #include "playlistgenerator.h"
 #include "smartplaylistsearch.h"
 
@@ -45,18 +49,40 @@ class PlaylistQueryGenerator : public PlaylistGenerator {
 
   PlaylistItemPtrList Generate() override;
   PlaylistItemPtrList GenerateMore(const int count) override;
+  void Prefetch(const int count) override;
   bool is_dynamic() const override { return dynamic_; }
   void set_dynamic(bool dynamic) override { dynamic_ = dynamic; }
 
   SmartPlaylistSearch search() const { return search_; }
   int GetDynamicFuture() override { return search_.limit_; }
 
+ private:
+  // Runs the search for the next limit songs, excluding the recently returned ones.
+  SongList Query(const int limit);
+
+  // Random searches that don't depend on the current time keep the ids of all matching songs,
+  // and pick from those instead of running the full search every time.
+  bool CanMaterialize() const;
+  void MaterializeMatchingIds();
+  SongList QueryMaterialized(const int limit);
+  void MatchingIdsUpdated(const QList<int> &changed_ids, const QList<int> &matching_ids);
+
+ private Q_SLOTS:
+  void CollectionSongsChanged(const SongList &songs);
+  void CollectionSongsDeleted(const SongList &songs);
+
  private:
   SmartPlaylistSearch search_;
   bool dynamic_;
 
+  // Protects previous_ids_, current_pos_, prefetched_songs_ and the materialized ids, a prefetch can be running while more tracks are requested.
+  QMutex mutex_;
   QList<int> previous_ids_;
   int current_pos_;
+  SongList prefetched_songs_;
+
+  bool matching_ids_loaded_;
+  QSet<int> matching_ids_;
 };
 
 #endif  // PLAYLISTQUERYGENERATOR_H
@@ -20,11 +20,14 @@
 
 #include "config.h"
 
+#include <algorithm>
+
 #include <QString>
 #include <QStringList>
 #include <QDataStream>
 
 #include "core/song.h"
+#include "collection/collectionlibrary.h"
 
 #include "smartplaylistsearch.h"
 
@@ -53,19 +56,14 @@ void SmartPlaylistSearch::Reset() {
 
 QString SmartPlaylistSearch::ToSql(const QString &songs_table) const {
 
-  QString sql = QStringLiteral("SELECT %1 FROM %2").arg(Song::kRowIdColumnSpec, songs_table);
+  const QString column_spec = songs_table == QLatin1String(CollectionLibrary::kSongsTable) ? Song::LongTextJoinSpec(songs_table) : Song::kRowIdColumnSpec;
+  QString sql = QStringLiteral("SELECT %1 FROM %2").arg(column_spec, songs_table);
 
   // Add search terms
   QStringList where_clauses;
-  QStringList term_where_clauses;
-  term_where_clauses.reserve(terms_.count());
-  for (const SmartPlaylistSearchTerm &term : terms_) {
-    term_where_clauses << term.ToSql();
-  }
-
-  if (!terms_.isEmpty() && search_type_ != SearchType::All) {
-    QString boolean_op = search_type_ == SearchType::And ? " AND "_L1 : " OR "_L1;
-    where_clauses << u"("_s + term_where_clauses.join(boolean_op) + u")"_s;
+  const QString terms_sql = TermsToSql();
+  if (!terms_sql.isEmpty()) {
+    where_clauses << terms_sql;
   }
 
   // Restrict the IDs of songs if we're making a dynamic playlist
@@ -106,6 +104,44 @@ QString SmartPlaylistSearch::ToSql(const QString &songs_table) const {
 
 }
 
+QString SmartPlaylistSearch::CountSql(const QString &songs_table) const {
+
+  QString sql = QStringLiteral("SELECT COUNT(*) FROM %1 WHERE unavailable = 0").arg(songs_table);
+
+  const QString terms_sql = TermsToSql();
+  if (!terms_sql.isEmpty()) {
+    sql += " AND "_L1 + terms_sql;
+  }
+
+  return sql;
+
+}
+
+QString SmartPlaylistSearch::TermsToSql() const {
+
+  if (terms_.isEmpty() || search_type_ == SearchType::All) return QString();
+
+  QStringList term_where_clauses;
+  term_where_clauses.reserve(terms_.count());
+  for (const SmartPlaylistSearchTerm &term : terms_) {
+    term_where_clauses << term.ToSql();
+  }
+
+  QString boolean_op = search_type_ == SearchType::And ? " AND "_L1 : " OR "_L1;
+  return u"("_s + term_where_clauses.join(boolean_op) + u")"_s;
+
+}
+
+bool SmartPlaylistSearch::is_time_dependent() const {
+
+  if (search_type_ == SearchType::All) return false;
+
+  return std::any_of(terms_.begin(), terms_.end(), [](const SmartPlaylistSearchTerm &term) {
+    return term.operator_ == SmartPlaylistSearchTerm::Operator::NumericDate || term.operator_ == SmartPlaylistSearchTerm::Operator::NumericDateNot || term.operator_ == SmartPlaylistSearchTerm::Operator::RelativeDate;
+  });
+
+}
+
 bool SmartPlaylistSearch::is_valid() const {
 
   if (search_type_ == SearchType::All) return true;
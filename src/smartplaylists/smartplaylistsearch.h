@@ -68,6 +68,12 @@ class SmartPlaylistSearch {
 
   void Reset();
   QString ToSql(const QString &songs_table) const;
+  // Counts all matching songs, ignoring the sorting and the limit.
+  QString CountSql(const QString &songs_table) const;
+  // The condition for the search terms only, empty if the search matches all songs.
+  QString TermsToSql() const;
+  // Whether the matching songs depend on the current time, like with "in the last X days".
+  bool is_time_dependent() const;
 };
 
 QDataStream &operator<<(QDataStream &s, const SmartPlaylistSearch &search);
@@ -20,30 +20,41 @@
 
 #include "config.h"
 
-#include <memory>
+#include <algorithm>
+#include <chrono>
 
 #include <QWidget>
 #include <QAbstractItemView>
 #include <QString>
-#include <QtConcurrentRun>
-#include <QFuture>
+#include <QTimer>
 #include <QFutureWatcher>
 
 #include "includes/shared_ptr.h"
+#include "core/taskexecutor.h"
+#include "collection/collectionbackend.h"
 
 #include "smartplaylistsearchpreview.h"
 #include "ui_smartplaylistsearchpreview.h"
 
 #include "playlist/playlist.h"
-#include "playlistquerygenerator.h"
+#include "playlist/playlistitem.h"
+#include "playlistgenerator.h"
 
-using std::make_shared;
+using namespace std::chrono_literals;
+
+namespace {
+constexpr auto kSearchDelay = 250ms;
+}  // namespace
 
 SmartPlaylistSearchPreview::SmartPlaylistSearchPreview(QWidget *parent)
     : QWidget(parent),
       ui_(new Ui_SmartPlaylistSearchPreview),
       collection_backend_(nullptr),
-      model_(nullptr) {
+      model_(nullptr),
+      timer_search_(new QTimer(this)),
+      search_pending_(false),
+      sample_watcher_(nullptr),
+      count_watcher_(nullptr) {
 
   ui_->setupUi(this);
 
@@ -56,10 +67,17 @@ SmartPlaylistSearchPreview::SmartPlaylistSearchPreview(QWidget *parent)
   ui_->preview_label->setFont(bold_font);
   ui_->busy_container->hide();
 
+  timer_search_->setSingleShot(true);
+  timer_search_->setInterval(kSearchDelay);
+  QObject::connect(timer_search_, &QTimer::timeout, this, &SmartPlaylistSearchPreview::RunPendingSearch);
+
 }
 
 SmartPlaylistSearchPreview::~SmartPlaylistSearchPreview() {
+
+  CancelSearch();
   delete ui_;
+
 }
 
 void SmartPlaylistSearchPreview::Init(const SharedPtr<Player> player,
@@ -90,80 +108,140 @@ void SmartPlaylistSearchPreview::Update(const SmartPlaylistSearch &search) {
 
   if (search == last_search_) {
     // This search was the same as the last one we did
+    search_pending_ = false;
+    timer_search_->stop();
     return;
   }
 
-  if (generator_ || isHidden()) {
-    // It's busy generating something already, or the widget isn't visible
-    pending_search_ = search;
-    return;
-  }
+  pending_search_ = search;
+  search_pending_ = true;
 
-  RunSearch(search);
+  // Wait for the widget to be visible, and for the terms to stop changing.
+  if (!isHidden()) {
+    timer_search_->start();
+  }
 
 }
 
 void SmartPlaylistSearchPreview::showEvent(QShowEvent *e) {
 
-  if (pending_search_.is_valid() && !generator_) {
+  if (search_pending_) {
     // There was a search waiting while we were hidden, so run it now
-    RunSearch(pending_search_);
-    pending_search_ = SmartPlaylistSearch();
+    RunPendingSearch();
   }
 
   QWidget::showEvent(e);
 
 }
 
-namespace {
-PlaylistItemPtrList DoRunSearch(PlaylistGeneratorPtr gen) { return gen->Generate(); }
-}  // namespace
+void SmartPlaylistSearchPreview::RunPendingSearch() {
+
+  timer_search_->stop();
+
+  if (!search_pending_) return;
+  search_pending_ = false;
+
+  RunSearch(pending_search_);
+  pending_search_ = SmartPlaylistSearch();
+
+}
+
+void SmartPlaylistSearchPreview::CancelSearch() {
+
+  // Queries that haven't started are cancelled, the results of running ones are dropped.
+  if (sample_watcher_) {
+    sample_watcher_->cancel();
+    sample_watcher_->deleteLater();
+    sample_watcher_ = nullptr;
+  }
+
+  if (count_watcher_) {
+    count_watcher_->cancel();
+    count_watcher_->deleteLater();
+    count_watcher_ = nullptr;
+  }
+
+}
 
 void SmartPlaylistSearchPreview::RunSearch(const SmartPlaylistSearch &search) {
 
-  generator_ = make_shared<PlaylistQueryGenerator>();
-  generator_->set_collection_backend(collection_backend_);
-  std::dynamic_pointer_cast<PlaylistQueryGenerator>(generator_)->Load(search);
+  CancelSearch();
+
+  last_search_ = search;
 
   ui_->busy_container->show();
   ui_->count_label->hide();
-  QFuture<PlaylistItemPtrList> future = QtConcurrent::run(DoRunSearch, generator_);
-  QFutureWatcher<PlaylistItemPtrList> *watcher = new QFutureWatcher<PlaylistItemPtrList>();
-  QObject::connect(watcher, &QFutureWatcher<PlaylistItemPtrList>::finished, this, &SmartPlaylistSearchPreview::SearchFinished);
-  watcher->setFuture(future);
+
+  // Only the songs that are shown are loaded.
+  SmartPlaylistSearch sample_search = search;
+  const int sample_limit = search.limit_ == -1 ? PlaylistGenerator::kDefaultLimit : std::min(search.limit_, PlaylistGenerator::kDefaultLimit);
+  sample_search.limit_ = sample_limit;
+
+  QFutureWatcher<SongList> *watcher = new QFutureWatcher<SongList>(this);
+  sample_watcher_ = watcher;
+  QObject::connect(watcher, &QFutureWatcher<SongList>::finished, this, [this, watcher, search, sample_limit]() {
+    if (watcher != sample_watcher_) return;
+    sample_watcher_ = nullptr;
+    const SongList songs = watcher->result();
+    watcher->deleteLater();
+    SampleFinished(search, sample_limit, songs);
+  });
+  watcher->setFuture(TaskExecutor::Run(TaskExecutor::Lane::Interactive, [collection_backend = collection_backend_, sql = sample_search.ToSql(collection_backend_->songs_table())]() { return collection_backend->ExecuteQuery(sql); }));
 
 }
 
-void SmartPlaylistSearchPreview::SearchFinished() {
+void SmartPlaylistSearchPreview::SampleFinished(const SmartPlaylistSearch &search, const int sample_limit, const SongList &songs) {
 
-  QFutureWatcher<PlaylistItemPtrList> *watcher = static_cast<QFutureWatcher<PlaylistItemPtrList>*>(sender());
-  PlaylistItemPtrList all_items = watcher->result();
-  watcher->deleteLater();
+  PlaylistItemPtrList items;
+  items.reserve(songs.count());
+  for (const Song &song : songs) {
+    items << PlaylistItem::NewFromSong(song);
+  }
 
-  last_search_ = std::dynamic_pointer_cast<PlaylistQueryGenerator>(generator_)->search();
-  generator_.reset();
+  model_->Clear();
+  model_->InsertItems(items);
 
-  if (pending_search_.is_valid() && pending_search_ != last_search_) {
-    // There was another search done while we were running
-    // throw away these results and do that one now instead
-    RunSearch(pending_search_);
-    pending_search_ = SmartPlaylistSearch();
+  if (songs.count() < sample_limit) {
+    // All the matching songs are shown already.
+    CountFinished(search, static_cast<int>(songs.count()));
     return;
   }
 
-  PlaylistItemPtrList displayed_items = all_items.mid(0, PlaylistGenerator::kDefaultLimit);
+  ui_->count_label->setText(tr("Showing %1 songs, counting...").arg(songs.count()));
+  ui_->count_label->show();
 
-  model_->Clear();
-  model_->InsertItems(displayed_items);
+  QFutureWatcher<int> *watcher = new QFutureWatcher<int>(this);
+  count_watcher_ = watcher;
+  QObject::connect(watcher, &QFutureWatcher<int>::finished, this, [this, watcher, search]() {
+    if (watcher != count_watcher_) return;
+    count_watcher_ = nullptr;
+    const int count = watcher->result();
+    watcher->deleteLater();
+    CountFinished(search, count);
+  });
+  watcher->setFuture(TaskExecutor::Run(TaskExecutor::Lane::BackgroundIO, [collection_backend = collection_backend_, sql = search.CountSql(collection_backend_->songs_table())]() { return collection_backend->ExecuteCountQuery(sql); }));
 
-  if (displayed_items.count() < all_items.count()) {
-    ui_->count_label->setText(tr("%1 songs found (showing %2)").arg(all_items.count()).arg(displayed_items.count()));
+}
+
+void SmartPlaylistSearchPreview::CountFinished(const SmartPlaylistSearch &search, const int count) {
+
+  ui_->busy_container->hide();
+
+  if (count < 0) {
+    ui_->count_label->hide();
+    return;
+  }
+
+  const int total = search.limit_ == -1 ? count : std::min(count, search.limit_);
+  const int displayed = std::min(total, model_->rowCount());
+
+  if (displayed < total) {
+    ui_->count_label->setText(tr("%1 songs found (showing %2)").arg(total).arg(displayed));
   }
   else {
-    ui_->count_label->setText(tr("%1 songs found").arg(all_items.count()));
+    ui_->count_label->setText(tr("%1 songs found").arg(total));
   }
 
-  ui_->busy_container->hide();
   ui_->count_label->show();
 
 }
@@ -27,11 +27,13 @@
 #include <QList>
 
 #include "includes/shared_ptr.h"
+#include "core/song.h"
 
 #include "smartplaylistsearch.h"
-#include "playlistgenerator_fwd.h"
 
 class QShowEvent;
+class QTimer;
+template<typename T> class QFutureWatcher;
 
 class Player;
 class PlaylistManager;
@@ -66,9 +68,12 @@ class SmartPlaylistSearchPreview : public QWidget {
 
  private:
   void RunSearch(const SmartPlaylistSearch &search);
+  void CancelSearch();
+  void SampleFinished(const SmartPlaylistSearch &search, const int sample_limit, const SongList &songs);
+  void CountFinished(const SmartPlaylistSearch &search, const int count);
 
  private Q_SLOTS:
-  void SearchFinished();
+  void RunPendingSearch();
 
  private:
   Ui_SmartPlaylistSearchPreview *ui_;
@@ -77,9 +82,15 @@ class SmartPlaylistSearchPreview : public QWidget {
   SharedPtr<CollectionBackend> collection_backend_;
   Playlist *model_;
 
+  // Searches are delayed while the terms are being edited, only the last one is run.
+  QTimer *timer_search_;
+  bool search_pending_;
   SmartPlaylistSearch pending_search_;
   SmartPlaylistSearch last_search_;
-  PlaylistGeneratorPtr generator_;
+
+  // Only a sample of the matching songs is loaded, the total is counted afterwards.
+  QFutureWatcher<SongList> *sample_watcher_;
+  QFutureWatcher<int> *count_watcher_;
 };
 
 #endif  // SMARTPLAYLISTSEARCHPREVIEW_H
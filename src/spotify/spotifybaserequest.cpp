@@ -65,7 +65,10 @@ QByteArray SpotifyBaseRequest::authorization_header() const {
 
 QNetworkReply *SpotifyBaseRequest::CreateRequest(const QString &ressource_name, const ParamList &params_provided) {
 
-  return CreateGetRequest(QUrl(QLatin1String(SpotifyService::kApiUrl) + QLatin1Char('/') + ressource_name), params_provided);
+  QNetworkReply *reply = CreateGetRequest(QUrl(QLatin1String(SpotifyService::kApiUrl) + QLatin1Char('/') + ressource_name), params_provided);
+  service_->request_limiter()->Monitor(reply, this);
+
+  return reply;
 
 }
 
@@ -20,6 +20,7 @@
 #include "config.h"
 
 #include <QByteArray>
+#include <QMultiMap>
 #include <QString>
 #include <QStringList>
 #include <QUrl>
@@ -33,6 +34,7 @@
 #include "core/logging.h"
 #include "core/networkaccessmanager.h"
 #include "core/song.h"
+#include "streaming/streamingfavoritebatches.h"
 #include "spotifyservice.h"
 #include "spotifybaserequest.h"
 #include "spotifyfavoriterequest.h"
@@ -57,6 +59,50 @@ QString SpotifyFavoriteRequest::FavoriteText(const FavoriteType type) {
 
 }
 
+QString SpotifyFavoriteRequest::FavoriteId(const FavoriteType type, const Song &song) {
+
+  switch (type) {
+    case FavoriteType_Artists:
+      return song.artist_id();
+    case FavoriteType_Albums:
+      return song.album_id();
+    case FavoriteType_Songs:
+      return song.song_id();
+  }
+
+  return QString();
+
+}
+
+int SpotifyFavoriteRequest::FavoriteMaxIds(const FavoriteType type) {
+
+  // The most ids the endpoints accept in one request.
+  switch (type) {
+    case FavoriteType_Albums:
+      return 20;
+    case FavoriteType_Artists:
+    case FavoriteType_Songs:
+      return 50;
+  }
+
+  return 1;
+
+}
+
+QList<StreamingFavoriteBatches::Chunk> SpotifyFavoriteRequest::FavoriteChunks(const FavoriteType type, const SongList &songs) const {
+
+  QMultiMap<QString, Song> songs_by_id;
+  for (const Song &song : songs) {
+    const QString id = FavoriteId(type, song);
+    if (!id.isEmpty()) {
+      songs_by_id.insert(id, song);
+    }
+  }
+
+  return StreamingFavoriteBatches::Split(songs_by_id, FavoriteMaxIds(type));
+
+}
+
 void SpotifyFavoriteRequest::AddArtists(const SongList &songs) {
   AddFavorites(FavoriteType_Artists, songs);
 }
@@ -75,47 +121,23 @@ void SpotifyFavoriteRequest::AddSongs(const SongMap &songs) {
 
 void SpotifyFavoriteRequest::AddFavorites(const FavoriteType type, const SongList &songs) {
 
-  QStringList list_ids;
-  QJsonArray array_ids;
-  for (const Song &song : songs) {
-    QString id;
-    switch (type) {
-      case FavoriteType_Artists:
-        id = song.artist_id();
-        break;
-      case FavoriteType_Albums:
-        id = song.album_id();
-        break;
-      case FavoriteType_Songs:
-        id = song.song_id();
-        break;
-    }
-    if (!id.isEmpty()) {
-      if (!list_ids.contains(id)) {
-        list_ids << id;
-      }
-      if (!array_ids.contains(id)) {
-        array_ids << id;
-      }
-    }
-  }
-
-  if (list_ids.isEmpty() || array_ids.isEmpty()) return;
-
-  const QByteArray json_data = QJsonDocument(array_ids).toJson();
-  const QString ids_list = list_ids.join(u',');
+  const QList<StreamingFavoriteBatches::Chunk> chunks = FavoriteChunks(type, songs);
+  if (chunks.isEmpty()) return;
 
-  AddFavoritesRequest(type, ids_list, json_data, songs);
+  const int batch_id = batches_.Start(static_cast<int>(chunks.count()));
+  for (const StreamingFavoriteBatches::Chunk &chunk : chunks) {
+    AddFavoritesRequest(type, batch_id, chunk.ids, chunk.songs);
+  }
 
 }
 
-void SpotifyFavoriteRequest::AddFavoritesRequest(const FavoriteType type, const QString &ids_list, const QByteArray &json_data, const SongList &songs) {
+void SpotifyFavoriteRequest::AddFavoritesRequest(const FavoriteType type, const int batch_id, const QStringList &ids, const SongList &songs) {
 
   QUrl url(QLatin1String(SpotifyService::kApiUrl) + (type == FavoriteType_Artists ? u"/me/following"_s : u"/me/"_s + FavoriteText(type)));
   if (type == FavoriteType_Artists) {
     QUrlQuery url_query;
     url_query.addQueryItem(u"type"_s, u"artist"_s);
-    url_query.addQueryItem(u"ids"_s, ids_list);
+    url_query.addQueryItem(u"ids"_s, ids.join(u','));
     url.setQuery(url_query);
   }
   QNetworkRequest network_request(url);
@@ -129,14 +151,14 @@ void SpotifyFavoriteRequest::AddFavoritesRequest(const FavoriteType type, const
     reply = network_->put(network_request, "");
   }
   else {
-    reply = network_->put(network_request, json_data);
+    reply = network_->put(network_request, QJsonDocument(QJsonArray::fromStringList(ids)).toJson());
   }
-  QObject::connect(reply, &QNetworkReply::finished, this, [this, reply, type, songs]() { AddFavoritesReply(reply, type, songs); });
+  QObject::connect(reply, &QNetworkReply::finished, this, [this, reply, type, batch_id, songs]() { AddFavoritesReply(reply, type, batch_id, songs); });
   replies_ << reply;
 
 }
 
-void SpotifyFavoriteRequest::AddFavoritesReply(QNetworkReply *reply, const FavoriteType type, const SongList &songs) {
+void SpotifyFavoriteRequest::AddFavoritesReply(QNetworkReply *reply, const FavoriteType type, const int batch_id, const SongList &songs) {
 
   if (!replies_.contains(reply)) return;
   replies_.removeAll(reply);
@@ -146,25 +168,27 @@ void SpotifyFavoriteRequest::AddFavoritesReply(QNetworkReply *reply, const Favor
   const JsonObjectResult json_object_result = ParseJsonObject(reply);
   if (!json_object_result.success()) {
     Error(json_object_result.error_message);
-    return;
   }
 
+  SongList batch_songs;
+  if (!batches_.Finish(batch_id, json_object_result.success() ? songs : SongList(), batch_songs) || batch_songs.isEmpty()) return;
+
   if (type == FavoriteType_Artists) {
-    qLog(Debug) << "Spotify:" << songs.count() << "songs added to followed" << FavoriteText(type);
+    qLog(Debug) << "Spotify:" << batch_songs.count() << "songs added to followed" << FavoriteText(type);
   }
   else {
-    qLog(Debug) << "Spotify:" << songs.count() << "songs added to saved" << FavoriteText(type);
+    qLog(Debug) << "Spotify:" << batch_songs.count() << "songs added to saved" << FavoriteText(type);
   }
 
   switch (type) {
     case FavoriteType_Artists:
-      Q_EMIT ArtistsAdded(songs);
+      Q_EMIT ArtistsAdded(batch_songs);
       break;
     case FavoriteType_Albums:
-      Q_EMIT AlbumsAdded(songs);
+      Q_EMIT AlbumsAdded(batch_songs);
       break;
     case FavoriteType_Songs:
-      Q_EMIT SongsAdded(songs);
+      Q_EMIT SongsAdded(batch_songs);
       break;
   }
 
@@ -190,71 +214,38 @@ void SpotifyFavoriteRequest::RemoveSongs(const SongMap &songs) {
 
 void SpotifyFavoriteRequest::RemoveFavorites(const FavoriteType type, const SongList &songs) {
 
-  QStringList list_ids;
-  QJsonArray array_ids;
-  for (const Song &song : songs) {
-    QString id;
-    switch (type) {
-      case FavoriteType_Artists:
-        id = song.artist_id();
-        break;
-      case FavoriteType_Albums:
-        id = song.album_id();
-        break;
-      case FavoriteType_Songs:
-        id = song.song_id();
-        break;
-    }
-    if (!id.isEmpty()) {
-      if (!list_ids.contains(id)) {
-        list_ids << id;
-      }
-      if (!array_ids.contains(id)) {
-        array_ids << id;
-      }
-    }
-  }
-
-  if (list_ids.isEmpty() || array_ids.isEmpty()) return;
-
-  const QByteArray json_data = QJsonDocument(array_ids).toJson();
-  const QString ids_list = list_ids.join(u',');
+  const QList<StreamingFavoriteBatches::Chunk> chunks = FavoriteChunks(type, songs);
+  if (chunks.isEmpty()) return;
 
-  RemoveFavoritesRequest(type, ids_list, json_data, songs);
+  const int batch_id = batches_.Start(static_cast<int>(chunks.count()));
+  for (const StreamingFavoriteBatches::Chunk &chunk : chunks) {
+    RemoveFavoritesRequest(type, batch_id, chunk.ids, chunk.songs);
+  }
 
 }
 
-void SpotifyFavoriteRequest::RemoveFavoritesRequest(const FavoriteType type, const QString &ids_list, const QByteArray &json_data, const SongList &songs) {
-
-  Q_UNUSED(json_data)
+void SpotifyFavoriteRequest::RemoveFavoritesRequest(const FavoriteType type, const int batch_id, const QStringList &ids, const SongList &songs) {
 
   QUrl url(QLatin1String(SpotifyService::kApiUrl) + (type == FavoriteType_Artists ? u"/me/following"_s : u"/me/"_s + FavoriteText(type)));
+  QUrlQuery url_query;
   if (type == FavoriteType_Artists) {
-    QUrlQuery url_query;
     url_query.addQueryItem(u"type"_s, u"artist"_s);
-    url_query.addQueryItem(u"ids"_s, ids_list);
-    url.setQuery(url_query);
   }
+  url_query.addQueryItem(u"ids"_s, ids.join(u','));
+  url.setQuery(url_query);
   QNetworkRequest network_request(url);
   network_request.setAttribute(QNetworkRequest::RedirectPolicyAttribute, QNetworkRequest::NoLessSafeRedirectPolicy);
   network_request.setHeader(QNetworkRequest::ContentTypeHeader, u"application/x-www-form-urlencoded"_s);
   if (service_->authenticated()) {
     network_request.setRawHeader("Authorization", service_->authorization_header());
   }
-  QNetworkReply *reply = nullptr;
-  if (type == FavoriteType_Artists) {
-    reply = network_->deleteResource(network_request);
-  }
-  else {
-    // FIXME
-    reply = network_->deleteResource(network_request);
-  }
-  QObject::connect(reply, &QNetworkReply::finished, this, [this, reply, type, songs]() { RemoveFavoritesReply(reply, type, songs); });
+  QNetworkReply *reply = network_->deleteResource(network_request);
+  QObject::connect(reply, &QNetworkReply::finished, this, [this, reply, type, batch_id, songs]() { RemoveFavoritesReply(reply, type, batch_id, songs); });
   replies_ << reply;
 
 }
 
-void SpotifyFavoriteRequest::RemoveFavoritesReply(QNetworkReply *reply, const FavoriteType type, const SongList &songs) {
+void SpotifyFavoriteRequest::RemoveFavoritesReply(QNetworkReply *reply, const FavoriteType type, const int batch_id, const SongList &songs) {
 
   if (!replies_.contains(reply)) return;
   replies_.removeAll(reply);
@@ -264,25 +255,27 @@ void SpotifyFavoriteRequest::RemoveFavoritesReply(QNetworkReply *reply, const Fa
   const JsonObjectResult json_object_result = ParseJsonObject(reply);
   if (!json_object_result.success()) {
     Error(json_object_result.error_message);
-    return;
   }
 
+  SongList batch_songs;
+  if (!batches_.Finish(batch_id, json_object_result.success() ? songs : SongList(), batch_songs) || batch_songs.isEmpty()) return;
+
   if (type == FavoriteType_Artists) {
-    qLog(Debug) << "Spotify:" << songs.count() << "songs removed from followed" << FavoriteText(type);
+    qLog(Debug) << "Spotify:" << batch_songs.count() << "songs removed from followed" << FavoriteText(type);
   }
   else {
-    qLog(Debug) << "Spotify:" << songs.count() << "songs removed from saved" << FavoriteText(type);
+    qLog(Debug) << "Spotify:" << batch_songs.count() << "songs removed from saved" << FavoriteText(type);
   }
 
   switch (type) {
     case FavoriteType_Artists:
-      Q_EMIT ArtistsRemoved(songs);
+      Q_EMIT ArtistsRemoved(batch_songs);
       break;
     case FavoriteType_Albums:
-      Q_EMIT AlbumsRemoved(songs);
+      Q_EMIT AlbumsRemoved(batch_songs);
       break;
     case FavoriteType_Songs:
-      Q_EMIT SongsRemoved(songs);
+      Q_EMIT SongsRemoved(batch_songs);
       break;
   }
 
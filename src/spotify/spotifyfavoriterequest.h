@@ -28,9 +28,11 @@
 #include <QVariant>
 #include <QByteArray>
 #include <QString>
+#include <QStringList>
 
 #include "includes/shared_ptr.h"
 #include "core/song.h"
+#include "streaming/streamingfavoritebatches.h"
 
 #include "spotifybaserequest.h"
 
@@ -59,8 +61,8 @@ class SpotifyFavoriteRequest : public SpotifyBaseRequest {
   void SongsRemoved(SongList);
 
  private Q_SLOTS:
-  void AddFavoritesReply(QNetworkReply *reply, const SpotifyFavoriteRequest::FavoriteType type, const SongList &songs);
-  void RemoveFavoritesReply(QNetworkReply *reply, const SpotifyFavoriteRequest::FavoriteType type, const SongList &songs);
+  void AddFavoritesReply(QNetworkReply *reply, const SpotifyFavoriteRequest::FavoriteType type, const int batch_id, const SongList &songs);
+  void RemoveFavoritesReply(QNetworkReply *reply, const SpotifyFavoriteRequest::FavoriteType type, const int batch_id, const SongList &songs);
 
  public Q_SLOTS:
   void AddArtists(const SongList &songs);
@@ -75,11 +77,15 @@ class SpotifyFavoriteRequest : public SpotifyBaseRequest {
 
  private:
   static QString FavoriteText(const FavoriteType type);
+  static QString FavoriteId(const FavoriteType type, const Song &song);
+  static int FavoriteMaxIds(const FavoriteType type);
+  QList<StreamingFavoriteBatches::Chunk> FavoriteChunks(const FavoriteType type, const SongList &songs) const;
   void AddFavorites(const FavoriteType type, const SongList &songs);
-  void AddFavoritesRequest(const FavoriteType type, const QString &ids_list, const QByteArray &json_data, const SongList &songs);
+  void AddFavoritesRequest(const FavoriteType type, const int batch_id, const QStringList &ids, const SongList &songs);
   void RemoveFavorites(const FavoriteType type, const SongList &songs);
-  void RemoveFavorites(const FavoriteType type, const QString &id, const SongList &songs);
-  void RemoveFavoritesRequest(const FavoriteType type, const QString &ids_list, const QByteArray &json_data, const SongList &songs);
+  void RemoveFavoritesRequest(const FavoriteType type, const int batch_id, const QStringList &ids, const SongList &songs);
+
+  StreamingFavoriteBatches batches_;
 };
 
 #endif  // SPOTIFYFAVORITEREQUEST_H
@@ -35,6 +35,7 @@
 #include <QScopeGuard>
 
 #include "constants/timeconstants.h"
+#include "collection/collectionbackend.h"
 #include "utilities/imageutils.h"
 #include "utilities/coverutils.h"
 #include "core/logging.h"
@@ -47,13 +48,9 @@
 using namespace Qt::Literals::StringLiterals;
 
 namespace {
-constexpr int kMaxConcurrentArtistsRequests = 1;
-constexpr int kMaxConcurrentAlbumsRequests = 1;
-constexpr int kMaxConcurrentSongsRequests = 1;
-constexpr int kMaxConcurrentArtistAlbumsRequests = 1;
-constexpr int kMaxConcurrentAlbumSongsRequests = 1;
 constexpr int kMaxConcurrentAlbumCoverRequests = 10;
 constexpr int kFlushRequestsDelay = 200;
+constexpr int kCollectionSongsId = 1;
 }  // namespace
 
 SpotifyRequest::SpotifyRequest(SpotifyService *service, const SharedPtr<NetworkAccessManager> network, const Type type, QObject *parent)
@@ -92,6 +89,7 @@ SpotifyRequest::SpotifyRequest(SpotifyService *service, const SharedPtr<NetworkA
       album_covers_requests_total_(0),
       album_covers_requests_active_(0),
       album_covers_requests_received_(0),
+      collection_albums_reused_(0),
       no_results_(false) {
 
   timer_flush_requests_->setInterval(kFlushRequestsDelay);
@@ -141,6 +139,29 @@ void SpotifyRequest::Process() {
 
 }
 
+void SpotifyRequest::Process(SharedPtr<CollectionBackend> collection_backend) {
+
+  QObject::connect(&*collection_backend, &CollectionBackend::GotSongs, this, &SpotifyRequest::CollectionSongsLoaded);
+  collection_backend->GetAllSongsAsync(kCollectionSongsId);
+
+}
+
+void SpotifyRequest::CollectionSongsLoaded(const SongList &songs, const int id) {
+
+  if (id != kCollectionSongsId) return;
+
+  QObject::disconnect(sender(), nullptr, this, nullptr);
+
+  for (const Song &song : songs) {
+    if (!song.album_id().isEmpty() && !song.song_id().isEmpty()) {
+      collection_album_songs_.insert(song.album_id(), song);
+    }
+  }
+
+  Process();
+
+}
+
 void SpotifyRequest::StartRequests() {
 
   if (!timer_flush_requests_->isActive()) {
@@ -215,7 +236,7 @@ void SpotifyRequest::AddArtistsRequest(const int offset, const int limit) {
 
 void SpotifyRequest::FlushArtistsRequests() {
 
-  while (!artists_requests_queue_.isEmpty() && artists_requests_active_ < kMaxConcurrentArtistsRequests) {
+  while (!artists_requests_queue_.isEmpty() && artists_requests_active_ < service_->request_limiter()->concurrent_requests() && service_->request_limiter()->TryAcquire()) {
 
     const Request request = artists_requests_queue_.dequeue();
 
@@ -268,7 +289,7 @@ void SpotifyRequest::AddAlbumsRequest(const int offset, const int limit) {
 
 void SpotifyRequest::FlushAlbumsRequests() {
 
-  while (!albums_requests_queue_.isEmpty() && albums_requests_active_ < kMaxConcurrentAlbumsRequests) {
+  while (!albums_requests_queue_.isEmpty() && albums_requests_active_ < service_->request_limiter()->concurrent_requests() && service_->request_limiter()->TryAcquire()) {
 
     const Request request = albums_requests_queue_.dequeue();
 
@@ -321,7 +342,7 @@ void SpotifyRequest::AddSongsRequest(const int offset, const int limit) {
 
 void SpotifyRequest::FlushSongsRequests() {
 
-  while (!songs_requests_queue_.isEmpty() && songs_requests_active_ < kMaxConcurrentSongsRequests) {
+  while (!songs_requests_queue_.isEmpty() && songs_requests_active_ < service_->request_limiter()->concurrent_requests() && service_->request_limiter()->TryAcquire()) {
 
     const Request request = songs_requests_queue_.dequeue();
 
@@ -523,9 +544,9 @@ void SpotifyRequest::ArtistsFinishCheck(const int limit, const int offset, const
 
   if (finished_) return;
 
-  if (artists_received > 0 && (limit == 0 || limit > artists_received) && artists_received_ < artists_total_) {
-    int offset_next = offset + artists_received;
-    if (offset_next > 0 && offset_next < artists_total_) {
+  // The total is known from the first page, so the remaining pages are requested in parallel.
+  if (offset == 0 && artists_received > 0 && (limit == 0 || limit > artists_received) && artists_received_ < artists_total_) {
+    for (int offset_next = artists_received; offset_next < artists_total_; offset_next += artists_received) {
       if (type_ == Type::FavouriteArtists) AddArtistsRequest(offset_next);
       else if (type_ == Type::SearchArtists) AddArtistsSearchRequest(offset_next);
     }
@@ -575,7 +596,7 @@ void SpotifyRequest::AddArtistAlbumsRequest(const Artist &artist, const int offs
 
 void SpotifyRequest::FlushArtistAlbumsRequests() {
 
-  while (!artist_albums_requests_queue_.isEmpty() && artist_albums_requests_active_ < kMaxConcurrentArtistAlbumsRequests) {
+  while (!artist_albums_requests_queue_.isEmpty() && artist_albums_requests_active_ < service_->request_limiter()->concurrent_requests() && service_->request_limiter()->TryAcquire()) {
 
     const ArtistAlbumsRequest request = artist_albums_requests_queue_.dequeue();
 
@@ -711,6 +732,7 @@ void SpotifyRequest::AlbumsReceived(QNetworkReply *reply, const Artist &artist_a
     }
     album.album_id = object_item["id"_L1].toString();
     album.album = object_item["name"_L1].toString();
+    album.songs_total = object_item["total_tracks"_L1].toInt();
 
     if (object_item.contains("artists"_L1) && object_item["artists"_L1].isArray()) {
       const QJsonArray array_artists = object_item["artists"_L1].toArray();
@@ -789,11 +811,14 @@ void SpotifyRequest::AlbumsReceived(QNetworkReply *reply, const Artist &artist_a
           if (song.is_compilation()) compilation = true;
           songs << song;
         }
-        for (Song song : std::as_const(songs)) {
+        for (Song &song : songs) {
           if (compilation) song.set_compilation_detected(true);
           if (!multidisc) song.set_disc(0);
           songs_.insert(song.song_id(), song);
         }
+        if (IsSearch() && !songs.isEmpty()) {
+          Q_EMIT PartialResults(query_id_, songs);
+        }
       }
     }
     else if (!album_songs_requests_pending_.contains(album.album_id)) {
@@ -816,9 +841,8 @@ void SpotifyRequest::AlbumsFinishCheck(const Artist &artist, const int limit, co
 
   if (finished_) return;
 
-  if (albums_received > 0 && (limit == 0 || limit > albums_received)) {
-    int offset_next = offset + albums_received;
-    if (offset_next > 0 && offset_next < albums_total) {
+  if (offset == 0 && albums_received > 0 && (limit == 0 || limit > albums_received)) {
+    for (int offset_next = albums_received; offset_next < albums_total; offset_next += albums_received) {
       switch (type_) {
         case Type::FavouriteAlbums:
           AddAlbumsRequest(offset_next);
@@ -847,10 +871,15 @@ void SpotifyRequest::AlbumsFinishCheck(const Artist &artist, const int limit, co
 
     for (QMap<QString, AlbumSongsRequest>::const_iterator it = album_songs_requests_pending_.constBegin(); it != album_songs_requests_pending_.constEnd(); ++it) {
       AlbumSongsRequest request = it.value();
+      if (AddCollectionAlbumSongs(request.album)) continue;
       AddAlbumSongsRequest(request.artist, request.album);
     }
     album_songs_requests_pending_.clear();
 
+    if (collection_albums_reused_ > 0) {
+      qLog(Debug) << "Spotify: Using songs from the collection for" << collection_albums_reused_ << "albums";
+    }
+
     if (album_songs_requests_total_ > 0) {
       if (album_songs_requests_total_ == 1) Q_EMIT UpdateStatus(query_id_, tr("Receiving songs for %1 album...").arg(album_songs_requests_total_));
       else Q_EMIT UpdateStatus(query_id_, tr("Receiving songs for %1 albums...").arg(album_songs_requests_total_));
@@ -877,6 +906,20 @@ void SpotifyRequest::SongsReplyReceived(QNetworkReply *reply, const int limit_re
 
 }
 
+bool SpotifyRequest::AddCollectionAlbumSongs(const Album &album) {
+
+  if (album.songs_total <= 0 || collection_album_songs_.count(album.album_id) != album.songs_total) return false;
+
+  const SongList songs = collection_album_songs_.values(album.album_id);
+  for (const Song &song : songs) {
+    songs_.insert(song.song_id(), song);
+  }
+  ++collection_albums_reused_;
+
+  return true;
+
+}
+
 void SpotifyRequest::AddAlbumSongsRequest(const Artist &artist, const Album &album, const int offset) {
 
   AlbumSongsRequest request;
@@ -893,7 +936,7 @@ void SpotifyRequest::AddAlbumSongsRequest(const Artist &artist, const Album &alb
 
 void SpotifyRequest::FlushAlbumSongsRequests() {
 
-  while (!album_songs_requests_queue_.isEmpty() && album_songs_requests_active_ < kMaxConcurrentAlbumSongsRequests) {
+  while (!album_songs_requests_queue_.isEmpty() && album_songs_requests_active_ < service_->request_limiter()->concurrent_requests() && service_->request_limiter()->TryAcquire()) {
     const AlbumSongsRequest request = album_songs_requests_queue_.dequeue();
     ++album_songs_requests_active_;
     ParamList parameters;
@@ -1006,12 +1049,16 @@ void SpotifyRequest::SongsReceived(QNetworkReply *reply, const Artist &artist, c
     songs << song;
   }
 
-  for (Song song : std::as_const(songs)) {
+  for (Song &song : songs) {
     if (compilation) song.set_compilation_detected(true);
     if (!multidisc) song.set_disc(0);
     songs_.insert(song.song_id(), song);
   }
 
+  if (IsSearch() && !songs.isEmpty()) {
+    Q_EMIT PartialResults(query_id_, songs);
+  }
+
   if (type_ == Type::FavouriteSongs || type_ == Type::SearchSongs) {
     songs_received_ += songs_received;
     Q_EMIT UpdateProgress(query_id_, GetProgress(songs_received_, songs_total_));
@@ -1023,9 +1070,8 @@ void SpotifyRequest::SongsFinishCheck(const Artist &artist, const Album &album,
 
   if (finished_) return;
 
-  if (songs_received > 0 && (limit == 0 || limit > songs_received)) {
-    int offset_next = offset + songs_received;
-    if (offset_next > 0 && offset_next < songs_total) {
+  if (offset == 0 && songs_received > 0 && (limit == 0 || limit > songs_received)) {
+    for (int offset_next = songs_received; offset_next < songs_total; offset_next += songs_received) {
       switch (type_) {
         case Type::FavouriteSongs:
           AddSongsRequest(offset_next);
@@ -1219,6 +1265,8 @@ void SpotifyRequest::GetAlbumCovers() {
 
 void SpotifyRequest::AddAlbumCoverRequest(const Song &song) {
 
+  if (song.art_automatic().isLocalFile()) return;
+
   if (album_covers_requests_sent_.contains(song.album_id())) {
     album_covers_requests_sent_.insert(song.album_id(), song.song_id());
     return;
@@ -24,6 +24,7 @@
 
 #include <QMap>
 #include <QMultiMap>
+#include <QMultiHash>
 #include <QQueue>
 #include <QVariant>
 #include <QString>
@@ -40,6 +41,7 @@
 class QNetworkReply;
 class NetworkAccessManager;
 class SpotifyService;
+class CollectionBackend;
 
 class SpotifyRequest : public SpotifyBaseRequest {
   Q_OBJECT
@@ -51,6 +53,8 @@ class SpotifyRequest : public SpotifyBaseRequest {
   void ReloadSettings();
 
   void Process();
+  // Loads the songs already in the collection first, albums with an unchanged number of songs are then not requested again.
+  void Process(SharedPtr<CollectionBackend> collection_backend);
   void Search(const int query_id, const QString &search_text);
 
  private:
@@ -60,10 +64,12 @@ class SpotifyRequest : public SpotifyBaseRequest {
     QString genre;
   };
   struct Album {
+    Album() : songs_total(0) {}
     QString album_id;
     QString album;
     QUrl cover_url;
     QString genre;
+    int songs_total;
   };
   struct Request {
     Request() : offset(0), limit(0) {}
@@ -92,6 +98,7 @@ class SpotifyRequest : public SpotifyBaseRequest {
 
  Q_SIGNALS:
   void Results(int id, SongMap songs, QString error);
+  void PartialResults(int id, SongList songs);
   void UpdateStatus(int id, QString text);
   void ProgressSetMaximum(int id, int max);
   void UpdateProgress(int id, int max);
@@ -111,6 +118,7 @@ class SpotifyRequest : public SpotifyBaseRequest {
   void ArtistAlbumsReplyReceived(QNetworkReply *reply, const SpotifyRequest::Artist &artist, const int offset_requested);
   void AlbumSongsReplyReceived(QNetworkReply *reply, const SpotifyRequest::Artist &artist, const SpotifyRequest::Album &album, const int offset_requested);
   void AlbumCoverReceived(QNetworkReply *reply, const QString &album_id, const QUrl &url, const QString &filename);
+  void CollectionSongsLoaded(const SongList &songs, const int id);
 
  private:
   void StartRequests();
@@ -145,6 +153,7 @@ class SpotifyRequest : public SpotifyBaseRequest {
 
   void AddAlbumSongsRequest(const Artist &artist, const Album &album, const int offset = 0);
   void FlushAlbumSongsRequests();
+  bool AddCollectionAlbumSongs(const Album &album);
 
   void ParseSong(Song &song, const QJsonObject &json_obj, const Artist &album_artist, const Album &album);
 
@@ -218,6 +227,9 @@ class SpotifyRequest : public SpotifyBaseRequest {
   int album_covers_requests_active_;
   int album_covers_requests_received_;
 
+  QMultiHash<QString, Song> collection_album_songs_;
+  int collection_albums_reused_;
+
   SongMap songs_;
   bool no_results_;
   QString error_;
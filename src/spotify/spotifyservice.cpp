@@ -23,6 +23,7 @@
 
 #include <QByteArray>
 #include <QString>
+#include <QStringList>
 #include <QUrl>
 #include <QTimer>
 
@@ -59,6 +60,10 @@ constexpr char kArtistsSongsTable[] = "spotify_artists_songs";
 constexpr char kAlbumsSongsTable[] = "spotify_albums_songs";
 constexpr char kSongsTable[] = "spotify_songs";
 
+constexpr int kInitialConcurrentRequests = 1;
+constexpr int kMaxConcurrentRequests = 4;
+constexpr double kRequestsPerSecond = 3.0;
+
 }  // namespace
 
 using std::make_shared;
@@ -79,6 +84,7 @@ SpotifyService::SpotifyService(const SharedPtr<TaskManager> task_manager,
       albums_collection_model_(nullptr),
       songs_collection_model_(nullptr),
       timer_search_delay_(new QTimer(this)),
+      request_limiter_(kInitialConcurrentRequests, kMaxConcurrentRequests, kRequestsPerSecond),
       favorite_request_(new SpotifyFavoriteRequest(this, network_, this)),
       enabled_(false),
       artistssearchlimit_(1),
@@ -106,6 +112,9 @@ SpotifyService::SpotifyService(const SharedPtr<TaskManager> task_manager,
 
   // Backends
 
+  // The songs were in the main database before the service had its own database file.
+  database->ImportSongsTables(QStringList() << QLatin1String(kArtistsSongsTable) << QLatin1String(kAlbumsSongsTable) << QLatin1String(kSongsTable));
+
   artists_collection_backend_ = make_shared<CollectionBackend>();
   artists_collection_backend_->moveToThread(database->thread());
   artists_collection_backend_->Init(database, task_manager, Song::Source::Spotify, QLatin1String(kArtistsSongsTable));
@@ -253,7 +262,7 @@ void SpotifyService::GetArtists() {
   QObject::connect(&*artists_request_, &SpotifyRequest::ProgressSetMaximum, this, &SpotifyService::ArtistsProgressSetMaximumReceived);
   QObject::connect(&*artists_request_, &SpotifyRequest::UpdateProgress, this, &SpotifyService::ArtistsUpdateProgressReceived);
 
-  artists_request_->Process();
+  artists_request_->Process(artists_collection_backend_);
 
 }
 
@@ -300,7 +309,7 @@ void SpotifyService::GetAlbums() {
   QObject::connect(&*albums_request_, &SpotifyRequest::ProgressSetMaximum, this, &SpotifyService::AlbumsProgressSetMaximumReceived);
   QObject::connect(&*albums_request_, &SpotifyRequest::UpdateProgress, this, &SpotifyService::AlbumsUpdateProgressReceived);
 
-  albums_request_->Process();
+  albums_request_->Process(albums_collection_backend_);
 
 }
 
@@ -413,7 +422,12 @@ void SpotifyService::StartSearch() {
 
 }
 
-void SpotifyService::CancelSearch() {}
+void SpotifyService::CancelSearch() {
+
+  timer_search_delay_->stop();
+  search_request_.reset();
+
+}
 
 void SpotifyService::SendSearch() {
 
@@ -436,6 +450,7 @@ void SpotifyService::SendSearch() {
 
   search_request_.reset(new SpotifyRequest(this, network_, type, this));
   QObject::connect(&*search_request_, &SpotifyRequest::Results, this, &SpotifyService::SearchResultsReceived);
+  QObject::connect(&*search_request_, &SpotifyRequest::PartialResults, this, &SpotifyService::SearchPartialResults);
   QObject::connect(&*search_request_, &SpotifyRequest::UpdateStatus, this, &SpotifyService::SearchUpdateStatus);
   QObject::connect(&*search_request_, &SpotifyRequest::ProgressSetMaximum, this, &SpotifyService::SearchProgressSetMaximum);
   QObject::connect(&*search_request_, &SpotifyRequest::UpdateProgress, this, &SpotifyService::SearchUpdateProgress);
@@ -29,6 +29,7 @@
 #include "includes/shared_ptr.h"
 #include "core/song.h"
 #include "streaming/streamingservice.h"
+#include "streaming/streamingrequestlimiter.h"
 #include "collection/collectionmodel.h"
 
 class QTimer;
@@ -73,6 +74,7 @@ class SpotifyService : public StreamingService {
   int songssearchlimit() const { return songssearchlimit_; }
   bool fetchalbums() const { return fetchalbums_; }
   bool download_album_covers() const { return download_album_covers_; }
+  StreamingRequestLimiter *request_limiter() { return &request_limiter_; }
   bool remove_remastered() const { return remove_remastered_; }
 
   bool authenticated() const override;
@@ -139,6 +141,8 @@ class SpotifyService : public StreamingService {
 
   QTimer *timer_search_delay_;
 
+  StreamingRequestLimiter request_limiter_;
+
   SpotifyRequestPtr artists_request_;
   SpotifyRequestPtr albums_request_;
   SpotifyRequestPtr songs_request_;
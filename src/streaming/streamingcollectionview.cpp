@@ -340,6 +340,10 @@ void StreamingCollectionView::contextMenuEvent(QContextMenuEvent *e) {
       context_menu_->addSeparator();
     }
 
+    context_menu_->addAction(tr("Expand all"), this, &StreamingCollectionView::ExpandAll);
+    context_menu_->addAction(tr("Collapse all"), this, &StreamingCollectionView::CollapseAll);
+    context_menu_->addSeparator();
+
     if (filter_) context_menu_->addMenu(filter_->menu());
 
   }
@@ -0,0 +1,71 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <QList>
+#include <QMap>
+#include <QMultiMap>
+#include <QString>
+#include <QStringList>
+
+#include "core/song.h"
+#include "streamingfavoritebatches.h"
+
+StreamingFavoriteBatches::StreamingFavoriteBatches() : next_batch_id_(0) {}
+
+QList<StreamingFavoriteBatches::Chunk> StreamingFavoriteBatches::Split(const QMultiMap<QString, Song> &songs_by_id, const int max_ids) {
+
+  QList<Chunk> chunks;
+
+  const QStringList ids = songs_by_id.uniqueKeys();
+  for (const QString &id : ids) {
+    if (chunks.isEmpty() || chunks.last().ids.count() >= max_ids) {
+      chunks << Chunk();
+    }
+    Chunk &chunk = chunks.last();
+    chunk.ids << id;
+    chunk.songs << songs_by_id.values(id);
+  }
+
+  return chunks;
+
+}
+
+int StreamingFavoriteBatches::Start(const int requests) {
+
+  const int batch_id = ++next_batch_id_;
+  batches_.insert(batch_id, Batch { requests, SongList() });
+
+  return batch_id;
+
+}
+
+bool StreamingFavoriteBatches::Finish(const int batch_id, const SongList &request_songs, SongList &songs) {
+
+  if (!batches_.contains(batch_id)) return false;
+
+  Batch &batch = batches_[batch_id];
+  batch.songs << request_songs;
+  if (--batch.pending_requests > 0) return false;
+
+  songs = batch.songs;
+  batches_.remove(batch_id);
+
+  return true;
+
+}
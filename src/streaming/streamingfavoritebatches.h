@@ -0,0 +1,62 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef STREAMINGFAVORITEBATCHES_H
+#define STREAMINGFAVORITEBATCHES_H
+
+#include <QList>
+#include <QMap>
+#include <QMultiMap>
+#include <QString>
+#include <QStringList>
+
+#include "core/song.h"
+
+// Groups the ids of a favorite operation into as few requests as the API's multi-id endpoints allow.
+// The songs of the finished requests are collected, so the streaming collection is updated once when the whole operation is done.
+class StreamingFavoriteBatches {
+ public:
+  StreamingFavoriteBatches();
+
+  struct Chunk {
+    QStringList ids;
+    SongList songs;
+  };
+
+  // Splits the songs, keyed by id, into chunks of at most max_ids ids.
+  static QList<Chunk> Split(const QMultiMap<QString, Song> &songs_by_id, const int max_ids);
+
+  // Starts a batch of the given number of requests, and returns its id.
+  int Start(const int requests);
+
+  // Records a finished request, with the songs it changed, or no songs when it failed.
+  // Returns true when it was the last request of the batch, songs is then set to the songs of all successful requests.
+  bool Finish(const int batch_id, const SongList &request_songs, SongList &songs);
+
+ private:
+  struct Batch {
+    int pending_requests;
+    SongList songs;
+  };
+
+  int next_batch_id_;
+  QMap<int, Batch> batches_;
+};
+
+#endif  // STREAMINGFAVORITEBATCHES_H
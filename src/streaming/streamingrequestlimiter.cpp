@@ -0,0 +1,107 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <algorithm>
+
+#include <QtGlobal>
+#include <QObject>
+#include <QElapsedTimer>
+#include <QNetworkRequest>
+#include <QNetworkReply>
+
+#include "core/logging.h"
+#include "streamingrequestlimiter.h"
+
+namespace {
+constexpr qint64 kFastReplyMsec = 1000;
+constexpr qint64 kSlowReplyMsec = 5000;
+constexpr qint64 kBackoffMsec = 2000;
+}  // namespace
+
+StreamingRequestLimiter::StreamingRequestLimiter(const int initial_concurrent_requests, const int max_concurrent_requests, const double requests_per_second)
+    : max_concurrent_requests_(std::max(1, max_concurrent_requests)),
+      requests_per_second_(requests_per_second),
+      bucket_size_(std::max(1.0, requests_per_second)),
+      window_(std::clamp(initial_concurrent_requests, 1, max_concurrent_requests_)),
+      tokens_(bucket_size_),
+      last_refill_(0),
+      paused_until_(0) {
+
+  clock_.start();
+
+}
+
+int StreamingRequestLimiter::concurrent_requests() const {
+
+  return static_cast<int>(window_);
+
+}
+
+void StreamingRequestLimiter::Refill() {
+
+  const qint64 now = clock_.elapsed();
+  tokens_ = std::min(bucket_size_, tokens_ + (static_cast<double>(now - last_refill_) * requests_per_second_ / 1000.0));
+  last_refill_ = now;
+
+}
+
+bool StreamingRequestLimiter::TryAcquire() {
+
+  if (clock_.elapsed() < paused_until_) return false;
+
+  if (requests_per_second_ <= 0.0) return true;
+
+  Refill();
+  if (tokens_ < 1.0) return false;
+
+  tokens_ -= 1.0;
+
+  return true;
+
+}
+
+void StreamingRequestLimiter::Monitor(QNetworkReply *reply, const QObject *context) {
+
+  const qint64 started = clock_.elapsed();
+  QObject::connect(reply, &QNetworkReply::finished, context, [this, reply, started]() {
+    RequestFinished(reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt(), clock_.elapsed() - started, reply->rawHeader("Retry-After").toInt());
+  });
+
+}
+
+void StreamingRequestLimiter::RequestFinished(const int http_status_code, const qint64 latency, const int retry_after) {
+
+  if (http_status_code == 429 || http_status_code == 503) {
+    window_ = std::max(1.0, window_ / 2.0);
+    tokens_ = 0.0;
+    paused_until_ = clock_.elapsed() + (retry_after > 0 ? static_cast<qint64>(retry_after) * 1000 : kBackoffMsec);
+    qLog(Debug) << "Received HTTP code" << http_status_code << "reducing concurrent requests to" << concurrent_requests();
+    return;
+  }
+
+  if (http_status_code != 200) return;
+
+  if (latency >= kSlowReplyMsec) {
+    window_ = std::max(1.0, window_ * 0.75);
+  }
+  else if (latency <= kFastReplyMsec) {
+    window_ = std::min(static_cast<double>(max_concurrent_requests_), window_ + (1.0 / window_));
+  }
+
+}
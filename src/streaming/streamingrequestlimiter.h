@@ -0,0 +1,57 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef STREAMINGREQUESTLIMITER_H
+#define STREAMINGREQUESTLIMITER_H
+
+#include <QtGlobal>
+#include <QElapsedTimer>
+
+class QObject;
+class QNetworkReply;
+
+// Limits the API requests sent to a streaming service.
+// The number of concurrent requests grows by one per window of fast replies, and is halved when the service replies with 429 or 503.
+// A token bucket limits the number of requests per second, and requests are paused for the time given by a Retry-After header.
+class StreamingRequestLimiter {
+ public:
+  explicit StreamingRequestLimiter(const int initial_concurrent_requests, const int max_concurrent_requests, const double requests_per_second = 0.0);
+
+  int concurrent_requests() const;
+
+  // Returns false when the request has to wait for the next flush.
+  bool TryAcquire();
+
+  void Monitor(QNetworkReply *reply, const QObject *context);
+  void RequestFinished(const int http_status_code, const qint64 latency, const int retry_after);
+
+ private:
+  void Refill();
+
+  const int max_concurrent_requests_;
+  const double requests_per_second_;
+  const double bucket_size_;
+  QElapsedTimer clock_;
+  double window_;
+  double tokens_;
+  qint64 last_refill_;
+  qint64 paused_until_;
+};
+
+#endif  // STREAMINGREQUESTLIMITER_H
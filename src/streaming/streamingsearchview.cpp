@@ -36,6 +36,8 @@
 #include <QPair>
 #include <QList>
 #include <QMap>
+#include <QSet>
+#include <QCache>
 #include <QString>
 #include <QStringList>
 #include <QRegularExpression>
@@ -90,6 +92,7 @@ namespace {
 constexpr int kSwapModelsTimeoutMsec = 250;
 constexpr int kDelayedSearchTimeoutMs = 200;
 constexpr int kArtHeight = 32;
+constexpr int kResultsCacheSize = 20;
 }  // namespace
 
 StreamingSearchView::StreamingSearchView(QWidget *parent)
@@ -109,7 +112,8 @@ StreamingSearchView::StreamingSearchView(QWidget *parent)
       search_type_(StreamingService::SearchType::Artists),
       search_error_(false),
       last_search_id_(0),
-      searches_next_id_(1) {
+      searches_next_id_(1),
+      results_cache_(kResultsCacheSize) {
 
   ui_->setupUi(this);
 
@@ -199,6 +203,7 @@ void StreamingSearchView::Init(const StreamingServicePtr service, const SharedPt
   QObject::connect(&*service_, &StreamingService::SearchProgressSetMaximum, this, &StreamingSearchView::ProgressSetMaximum);
   QObject::connect(&*service_, &StreamingService::SearchUpdateProgress, this, &StreamingSearchView::UpdateProgress);
   QObject::connect(&*service_, &StreamingService::SearchResults, this, &StreamingSearchView::SearchDone);
+  QObject::connect(&*service_, &StreamingService::SearchPartialResults, this, &StreamingSearchView::SearchPartialResults);
 
   QObject::connect(&*albumcover_loader_, &AlbumCoverLoader::AlbumCoverLoaded, this, &StreamingSearchView::AlbumCoverLoaded);
 
@@ -389,6 +394,7 @@ void StreamingSearchView::TextEdited(const QString &text) {
 
   search_error_ = false;
   cover_loader_tasks_.clear();
+  result_song_ids_.clear();
 
   // Add results to the back model, switch models after some delay.
   back_model_->Clear();
@@ -407,6 +413,16 @@ void StreamingSearchView::TextEdited(const QString &text) {
     ui_->progressbar->hide();
     ui_->progressbar->reset();
   }
+  else if (ResultList *results = results_cache_.object(SearchCacheKey(trimmed, search_type_))) {
+    last_search_id_ = searches_next_id_++;
+    const ResultList cached_results = *results;
+    for (const Result &result : cached_results) {
+      result_song_ids_.insert(result.metadata_.song_id());
+    }
+    AddResults(last_search_id_, cached_results);
+    swap_models_timer_->stop();
+    SwapModels();
+  }
   else {
     ui_->progressbar->reset();
     last_search_id_ = SearchAsync(trimmed, search_type_);
@@ -480,7 +496,7 @@ int StreamingSearchView::SearchAsync(const QString &query, const StreamingServic
 void StreamingSearchView::SearchAsync(const int id, const QString &query, const StreamingService::SearchType type) {
 
   const int service_id = service_->Search(query, type);
-  pending_searches_[service_id] = PendingState(id, TokenizeQuery(query));
+  pending_searches_[service_id] = PendingState(id, TokenizeQuery(query), SearchCacheKey(query, type));
 
 }
 
@@ -493,6 +509,12 @@ void StreamingSearchView::SearchDone(const int service_id, const SongMap &songs,
   const int search_id = state.orig_id_;
 
   if (songs.isEmpty()) {
+    if (search_id == last_search_id_ && !result_song_ids_.isEmpty()) {
+      ui_->label_status->clear();
+      ui_->progressbar->reset();
+      ui_->progressbar->hide();
+      return;
+    }
     SearchError(search_id, error);
     return;
   }
@@ -502,15 +524,64 @@ void StreamingSearchView::SearchDone(const int service_id, const SongMap &songs,
   for (const Song &song : songs) {
     Result result;
     result.metadata_ = song;
+    result.pixmap_cache_key_ = PixmapCacheKey(result);
     results << result;
   }
 
-  // Load cached pixmaps into the results
-  for (StreamingSearchView::ResultList::iterator it = results.begin(); it != results.end(); ++it) {
-    it->pixmap_cache_key_ = PixmapCacheKey(*it);
+  if (error.isEmpty()) {
+    results_cache_.insert(state.cache_key_, new ResultList(results));
+  }
+
+  if (search_id != last_search_id_) return;
+
+  // Most songs were already added as the pages were received, only add the ones that are new.
+  ResultList new_results;
+  for (const Result &result : std::as_const(results)) {
+    if (!result_song_ids_.contains(result.metadata_.song_id())) {
+      result_song_ids_.insert(result.metadata_.song_id());
+      new_results << result;
+    }
+  }
+
+  ui_->label_status->clear();
+  ui_->progressbar->reset();
+  ui_->progressbar->hide();
+
+  AddResults(search_id, new_results);
+
+}
+
+void StreamingSearchView::SearchPartialResults(const int service_id, const SongList &songs) {
+
+  if (!pending_searches_.contains(service_id)) return;
+  if (pending_searches_.value(service_id).orig_id_ != last_search_id_) return;
+
+  const ResultList results = NewResults(songs);
+  if (results.isEmpty()) return;
+
+  current_model_->AddResults(results);
+
+}
+
+StreamingSearchView::ResultList StreamingSearchView::NewResults(const SongList &songs) {
+
+  ResultList results;
+  for (const Song &song : songs) {
+    if (result_song_ids_.contains(song.song_id())) continue;
+    result_song_ids_.insert(song.song_id());
+    Result result;
+    result.metadata_ = song;
+    result.pixmap_cache_key_ = PixmapCacheKey(result);
+    results << result;
   }
 
-  AddResults(search_id, results);
+  return results;
+
+}
+
+QString StreamingSearchView::SearchCacheKey(const QString &query, const StreamingService::SearchType type) {
+
+  return QString::number(static_cast<int>(type)) + u':' + query;
 
 }
 
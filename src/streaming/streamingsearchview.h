@@ -28,6 +28,8 @@
 #include <QPair>
 #include <QList>
 #include <QMap>
+#include <QSet>
+#include <QCache>
 #include <QString>
 #include <QStringList>
 #include <QUrl>
@@ -83,9 +85,10 @@ class StreamingSearchView : public QWidget {
  protected:
   struct PendingState {
     PendingState() : orig_id_(-1) {}
-    PendingState(int orig_id, const QStringList &tokens) : orig_id_(orig_id), tokens_(tokens) {}
+    PendingState(int orig_id, const QStringList &tokens, const QString &cache_key) : orig_id_(orig_id), tokens_(tokens), cache_key_(cache_key) {}
     int orig_id_;
     QStringList tokens_;
+    QString cache_key_;
 
     bool operator<(const PendingState &b) const {
       return orig_id_ < b.orig_id_;
@@ -124,6 +127,9 @@ class StreamingSearchView : public QWidget {
   void SearchError(const int id, const QString &error);
   void CancelSearch(const int id);
 
+  static QString SearchCacheKey(const QString &query, const StreamingService::SearchType type);
+  ResultList NewResults(const SongList &songs);
+
   QString PixmapCacheKey(const Result &result) const;
   bool FindCachedPixmap(const Result &result, QPixmap *pixmap) const;
   int LoadAlbumCoverAsync(const Result &result);
@@ -140,6 +146,7 @@ class StreamingSearchView : public QWidget {
   void TextEdited(const QString &text);
   void StartSearch(const QString &query);
   void SearchDone(const int service_id, const SongMap &songs, const QString &error);
+  void SearchPartialResults(const int service_id, const SongList &songs);
 
   void UpdateStatus(const int service_id, const QString &text);
   void ProgressSetMaximum(const int service_id, const int max);
@@ -202,6 +209,11 @@ class StreamingSearchView : public QWidget {
   QMap<int, DelayedSearch> delayed_searches_;
   QMap<int, PendingState> pending_searches_;
 
+  // Results of the most recent searches, so going back to a previous query does not need to search again.
+  QCache<QString, ResultList> results_cache_;
+  // Songs already added to the current model, results are added page by page as they are received.
+  QSet<QString> result_song_ids_;
+
   QMap<quint64, QPair<QModelIndex, QString>> cover_loader_tasks_;
 };
 Q_DECLARE_METATYPE(StreamingSearchView::Result)
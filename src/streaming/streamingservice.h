@@ -118,6 +118,7 @@ class StreamingService : public QObject {
   void SongsUpdateProgress(const int max);
 
   void SearchResults(const int id, const SongMap &songs, const QString &error);
+  void SearchPartialResults(const int id, const SongList &songs);
   void SearchUpdateStatus(const int id, const QString &text);
   void SearchProgressSetMaximum(const int id, const int max);
   void SearchUpdateProgress(const int id, const int max);
@@ -0,0 +1,125 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <QtGlobal>
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <QUrl>
+#include <QUrlQuery>
+#include <QDateTime>
+
+#include "core/urlhandler.h"
+#include "streamurlcache.h"
+
+using namespace Qt::Literals::StringLiterals;
+
+namespace {
+constexpr qint64 kDefaultLifetimeSecs = 600;
+constexpr qint64 kExpiryMarginSecs = 60;
+constexpr int kMaxEntries = 200;
+}  // namespace
+
+StreamUrlCache::StreamUrlCache() = default;
+
+bool StreamUrlCache::Find(const QUrl &media_url, UrlHandler::LoadResult *result) {
+
+  QHash<QUrl, Entry>::iterator it = entries_.find(media_url);
+  if (it == entries_.end()) return false;
+
+  if (it.value().expires <= QDateTime::currentSecsSinceEpoch()) {
+    entries_.erase(it);
+    return false;
+  }
+
+  *result = it.value().result;
+
+  return true;
+
+}
+
+void StreamUrlCache::Insert(const UrlHandler::LoadResult &result) {
+
+  if (result.type_ != UrlHandler::LoadResult::Type::TrackAvailable || !result.media_url_.isValid() || !result.stream_url_.isValid()) return;
+
+  const qint64 now = QDateTime::currentSecsSinceEpoch();
+  qint64 expires = ExpiryFromUrl(result.stream_url_);
+  if (expires <= 0) expires = now + kDefaultLifetimeSecs;
+  expires -= kExpiryMarginSecs;
+  if (expires <= now) return;
+
+  if (entries_.count() >= kMaxEntries) {
+    RemoveExpired(now);
+    if (entries_.count() >= kMaxEntries) entries_.clear();
+  }
+
+  Entry entry;
+  entry.result = result;
+  entry.expires = expires;
+  entries_.insert(result.media_url_, entry);
+
+}
+
+void StreamUrlCache::Remove(const QUrl &media_url) {
+
+  entries_.remove(media_url);
+
+}
+
+void StreamUrlCache::RemoveExpired(const qint64 now) {
+
+  for (QHash<QUrl, Entry>::iterator it = entries_.begin(); it != entries_.end();) {
+    if (it.value().expires <= now) {
+      it = entries_.erase(it);
+    }
+    else {
+      ++it;
+    }
+  }
+
+}
+
+qint64 StreamUrlCache::ExpiryFromUrl(const QUrl &stream_url) {
+
+  const QUrlQuery url_query(stream_url);
+
+  // Qobuz uses etsp, CloudFront signed URLs use Expires.
+  for (const QString &key : {u"etsp"_s, u"Expires"_s, u"expires"_s}) {
+    if (url_query.hasQueryItem(key)) {
+      bool ok = false;
+      const qint64 expires = url_query.queryItemValue(key).toLongLong(&ok);
+      if (ok && expires > 0) return expires;
+    }
+  }
+
+  // Akamai tokens contain the expiry time as exp=<time> separated by ~.
+  if (url_query.hasQueryItem(u"__token__"_s)) {
+    const QStringList token_parts = url_query.queryItemValue(u"__token__"_s, QUrl::FullyDecoded).split(u'~');
+    for (const QString &token_part : token_parts) {
+      if (token_part.startsWith("exp="_L1)) {
+        bool ok = false;
+        const qint64 expires = token_part.mid(4).toLongLong(&ok);
+        if (ok && expires > 0) return expires;
+      }
+    }
+  }
+
+  return 0;
+
+}
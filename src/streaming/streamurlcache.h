@@ -0,0 +1,53 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef STREAMURLCACHE_H
+#define STREAMURLCACHE_H
+
+#include <QtGlobal>
+#include <QHash>
+#include <QUrl>
+
+#include "core/urlhandler.h"
+
+// Keeps resolved stream URLs until shortly before they expire, so replaying a track or playing a prepared track does not need a new request.
+// The expiry time is taken from the signed stream URL when it has one.
+class StreamUrlCache {
+ public:
+  StreamUrlCache();
+
+  bool Find(const QUrl &media_url, UrlHandler::LoadResult *result);
+  void Insert(const UrlHandler::LoadResult &result);
+  void Remove(const QUrl &media_url);
+
+  static qint64 ExpiryFromUrl(const QUrl &stream_url);
+
+ private:
+  struct Entry {
+    Entry() : expires(0) {}
+    UrlHandler::LoadResult result;
+    qint64 expires;
+  };
+
+  void RemoveExpired(const qint64 now);
+
+  QHash<QUrl, Entry> entries_;
+};
+
+#endif  // STREAMURLCACHE_H
@@ -115,6 +115,7 @@ QNetworkReply *SubsonicBaseRequest::CreateGetRequest(const QString &ressource_na
 
   QNetworkReply *reply = network_->get(network_request);
   QObject::connect(reply, &QNetworkReply::sslErrors, this, &SubsonicBaseRequest::HandleSSLErrors);
+  service_->request_limiter()->Monitor(reply, this);
 
   // qLog(Debug) << "Subsonic: Sending request" << url;
 
@@ -72,6 +72,7 @@ class SubsonicBaseRequest : public QObject {
   bool verify_certificate() const { return service_->verify_certificate(); }
   bool download_album_covers() const { return service_->download_album_covers(); }
   bool use_album_id_for_album_covers() const { return service_->use_album_id_for_album_covers(); }
+  StreamingRequestLimiter *request_limiter() const { return service_->request_limiter(); }
 
  private Q_SLOTS:
   void HandleSSLErrors(const QList<QSslError> &ssl_errors);
@@ -45,6 +45,7 @@
 #include "utilities/strutils.h"
 #include "utilities/imageutils.h"
 #include "constants/timeconstants.h"
+#include "collection/collectionbackend.h"
 #include "subsonicservice.h"
 #include "subsonicurlhandler.h"
 #include "subsonicbaserequest.h"
@@ -53,9 +54,9 @@
 using namespace Qt::Literals::StringLiterals;
 
 namespace {
-constexpr int kMaxConcurrentAlbumsRequests = 3;
-constexpr int kMaxConcurrentAlbumSongsRequests = 3;
 constexpr int kMaxConcurrentAlbumCoverRequests = 1;
+constexpr int kCollectionSongsId = 1;
+constexpr int kSongsSearchPageSize = 500;
 }  // namespace
 
 SubsonicRequest::SubsonicRequest(SubsonicService *service, SubsonicUrlHandler *url_handler, QObject *parent)
@@ -72,6 +73,9 @@ SubsonicRequest::SubsonicRequest(SubsonicService *service, SubsonicUrlHandler *u
       album_covers_requests_active_(0),
       album_covers_requested_(0),
       album_covers_received_(0),
+      collection_albums_reused_(0),
+      last_modified_(0),
+      songs_search_requests_active_(0),
       no_results_(false) {
 
   network_->setRedirectPolicy(QNetworkRequest::NoLessSafeRedirectPolicy);
@@ -113,6 +117,8 @@ void SubsonicRequest::Reset() {
   album_covers_requests_active_ = 0;
   album_covers_requested_ = 0;
   album_covers_received_ = 0;
+  collection_albums_reused_ = 0;
+  songs_search_requests_active_ = 0;
 
   songs_.clear();
   cover_urls_.clear();
@@ -131,19 +137,172 @@ void SubsonicRequest::GetAlbums() {
 
 }
 
+void SubsonicRequest::GetAlbums(SharedPtr<CollectionBackend> collection_backend) {
+
+  Q_EMIT UpdateStatus(tr("Retrieving albums..."));
+  Q_EMIT UpdateProgress(0);
+
+  QObject::connect(&*collection_backend, &CollectionBackend::GotSongs, this, &SubsonicRequest::CollectionSongsLoaded);
+  collection_backend->GetAllSongsAsync(kCollectionSongsId);
+
+}
+
+void SubsonicRequest::CollectionSongsLoaded(const SongList &songs, const int id) {
+
+  if (id != kCollectionSongsId) return;
+
+  QObject::disconnect(sender(), nullptr, this, nullptr);
+
+  for (const Song &song : songs) {
+    if (!song.song_id().isEmpty()) {
+      collection_album_songs_.insert(song.album_id(), song);
+    }
+  }
+
+  GetIndexes();
+
+}
+
+void SubsonicRequest::GetIndexes() {
+
+  QNetworkReply *reply = CreateGetRequest(u"getIndexes"_s, ParamList());
+  replies_ << reply;
+  QObject::connect(reply, &QNetworkReply::finished, this, [this, reply]() { IndexesReplyReceived(reply); });
+  timeouts_->AddReply(reply);
+
+}
+
+void SubsonicRequest::IndexesReplyReceived(QNetworkReply *reply) {
+
+  if (!replies_.contains(reply)) return;
+  replies_.removeAll(reply);
+  QObject::disconnect(reply, nullptr, this, nullptr);
+  reply->deleteLater();
+
+  if (finished_) return;
+
+  const JsonObjectResult json_object_result = ParseJsonObject(reply);
+  if (json_object_result.success() && json_object_result.json_object["indexes"_L1].isObject()) {
+    last_modified_ = json_object_result.json_object["indexes"_L1].toObject()["lastModified"_L1].toVariant().toLongLong();
+  }
+
+  // Nothing changed on the server since the collection was loaded, so the songs in the collection are still current.
+  if (last_modified_ > 0 && last_modified_ == service_->last_modified() && !collection_album_songs_.isEmpty()) {
+    qLog(Debug) << "Subsonic: Server unchanged since last modified" << last_modified_;
+    for (QMultiHash<QString, Song>::const_iterator it = collection_album_songs_.constBegin(); it != collection_album_songs_.constEnd(); ++it) {
+      songs_.insert(it.value().song_id(), it.value());
+    }
+    FinishCheck();
+    return;
+  }
+
+  Q_EMIT UpdateStatus(tr("Retrieving songs..."));
+  AddSongsSearchRequest();
+
+}
+
+void SubsonicRequest::AddSongsSearchRequest(const int offset) {
+
+  ++songs_search_requests_active_;
+
+  const ParamList params = ParamList() << Param(u"query"_s, QString())
+                                       << Param(u"artistCount"_s, u"0"_s)
+                                       << Param(u"albumCount"_s, u"0"_s)
+                                       << Param(u"songCount"_s, QString::number(kSongsSearchPageSize))
+                                       << Param(u"songOffset"_s, QString::number(offset));
+
+  QNetworkReply *reply = CreateGetRequest(u"search3"_s, params);
+  replies_ << reply;
+  QObject::connect(reply, &QNetworkReply::finished, this, [this, reply, offset]() { SongsSearchReplyReceived(reply, offset); });
+  timeouts_->AddReply(reply);
+
+}
+
+void SubsonicRequest::SongsSearchReplyReceived(QNetworkReply *reply, const int offset_requested) {
+
+  if (!replies_.contains(reply)) return;
+  replies_.removeAll(reply);
+  QObject::disconnect(reply, nullptr, this, nullptr);
+  reply->deleteLater();
+
+  --songs_search_requests_active_;
+
+  if (finished_) return;
+
+  const JsonObjectResult json_object_result = ParseJsonObject(reply);
+  const QJsonValue value_search_result = json_object_result.json_object["searchResult3"_L1];
+  const QJsonArray array_songs = value_search_result.toObject()["song"_L1].toArray();
+
+  // Not all servers return all songs for an empty search, use the album list instead.
+  if (offset_requested == 0 && (!json_object_result.success() || !value_search_result.isObject() || array_songs.isEmpty())) {
+    qLog(Debug) << "Subsonic: Server does not support song listing through search3, retrieving albums";
+    Q_EMIT UpdateStatus(tr("Retrieving albums..."));
+    AddAlbumsRequest();
+    return;
+  }
+
+  if (!json_object_result.success()) {
+    Error(json_object_result.error_message);
+    SongsSearchFinished();
+    return;
+  }
+
+  for (const QJsonValue &value_song : array_songs) {
+    if (!value_song.isObject()) {
+      Error(u"Invalid Json reply, track is not a object."_s);
+      continue;
+    }
+    const QJsonObject object_song = value_song.toObject();
+    Song song(Song::Source::Subsonic);
+    ParseSong(song, object_song, QString(), QString(), object_song["displayAlbumArtist"_L1].toString());
+    if (!song.is_valid()) continue;
+    songs_.insert(song.song_id(), song);
+  }
+
+  Q_EMIT UpdateStatus(tr("Retrieved %1 songs...").arg(songs_.count()));
+
+  if (array_songs.count() >= kSongsSearchPageSize) {
+    AddSongsSearchRequest(offset_requested + static_cast<int>(array_songs.count()));
+  }
+  else {
+    SongsSearchFinished();
+  }
+
+}
+
+void SubsonicRequest::SongsSearchFinished() {
+
+  // Detect multi disc albums and compilations the same way as when the songs are retrieved per album.
+  QSet<QString> multidisc_albums;
+  QSet<QString> compilation_albums;
+  for (const Song &song : std::as_const(songs_)) {
+    if (song.disc() >= 2) multidisc_albums.insert(song.album_id());
+    if (song.is_compilation()) compilation_albums.insert(song.album_id());
+  }
+
+  for (SongMap::iterator it = songs_.begin(); it != songs_.end(); ++it) {
+    Song &song = it.value();
+    if (compilation_albums.contains(song.album_id())) song.set_compilation_detected(true);
+    if (!multidisc_albums.contains(song.album_id())) song.set_disc(0);
+  }
+
+  SongsFinishCheck();
+
+}
+
 void SubsonicRequest::AddAlbumsRequest(const int offset, const int size) {
 
   Request request;
   request.size = size;
   request.offset = offset;
   albums_requests_queue_.enqueue(request);
-  if (albums_requests_active_ < kMaxConcurrentAlbumsRequests) FlushAlbumsRequests();
+  if (albums_requests_active_ < request_limiter()->concurrent_requests()) FlushAlbumsRequests();
 
 }
 
 void SubsonicRequest::FlushAlbumsRequests() {
 
-  while (!albums_requests_queue_.isEmpty() && albums_requests_active_ < kMaxConcurrentAlbumsRequests) {
+  while (!albums_requests_queue_.isEmpty() && albums_requests_active_ < request_limiter()->concurrent_requests()) {
 
     const Request request = albums_requests_queue_.dequeue();
     ++albums_requests_active_;
@@ -256,6 +415,7 @@ void SubsonicRequest::AlbumsReplyReceived(QNetworkReply *reply, const int offset
     Request request;
     request.album_id = album_id;
     request.album_artist = artist;
+    request.songs_total = object_album["songCount"_L1].toInt();
     album_songs_requests_pending_.insert(album_id, request);
 
   }
@@ -273,16 +433,21 @@ void SubsonicRequest::AlbumsFinishCheck(const int offset, const int size, const
     }
   }
 
-  if (!albums_requests_queue_.isEmpty() && albums_requests_active_ < kMaxConcurrentAlbumsRequests) FlushAlbumsRequests();
+  if (!albums_requests_queue_.isEmpty() && albums_requests_active_ < request_limiter()->concurrent_requests()) FlushAlbumsRequests();
 
   if (albums_requests_queue_.isEmpty() && albums_requests_active_ <= 0) { // Albums list is finished, get songs for all albums.
 
     for (QHash<QString, Request>::const_iterator it = album_songs_requests_pending_.constBegin(); it != album_songs_requests_pending_.constEnd(); ++it) {
       const Request request = it.value();
+      if (AddCollectionAlbumSongs(request)) continue;
       AddAlbumSongsRequest(request.artist_id, request.album_id, request.album_artist);
     }
     album_songs_requests_pending_.clear();
 
+    if (collection_albums_reused_ > 0) {
+      qLog(Debug) << "Subsonic: Using songs from the collection for" << collection_albums_reused_ << "albums";
+    }
+
     if (album_songs_requested_ > 0) {
       if (album_songs_requested_ == 1) Q_EMIT UpdateStatus(tr("Retrieving songs for %1 album...").arg(album_songs_requested_));
       else Q_EMIT UpdateStatus(tr("Retrieving songs for %1 albums...").arg(album_songs_requested_));
@@ -295,6 +460,20 @@ void SubsonicRequest::AlbumsFinishCheck(const int offset, const int size, const
 
 }
 
+bool SubsonicRequest::AddCollectionAlbumSongs(const Request &request) {
+
+  if (request.songs_total <= 0 || collection_album_songs_.count(request.album_id) != request.songs_total) return false;
+
+  const SongList songs = collection_album_songs_.values(request.album_id);
+  for (const Song &song : songs) {
+    songs_.insert(song.song_id(), song);
+  }
+  ++collection_albums_reused_;
+
+  return true;
+
+}
+
 void SubsonicRequest::AddAlbumSongsRequest(const QString &artist_id, const QString &album_id, const QString &album_artist, const int offset) {
 
   Request request;
@@ -304,13 +483,13 @@ void SubsonicRequest::AddAlbumSongsRequest(const QString &artist_id, const QStri
   request.offset = offset;
   album_songs_requests_queue_.enqueue(request);
   ++album_songs_requested_;
-  if (album_songs_requests_active_ < kMaxConcurrentAlbumSongsRequests) FlushAlbumSongsRequests();
+  if (album_songs_requests_active_ < request_limiter()->concurrent_requests()) FlushAlbumSongsRequests();
 
 }
 
 void SubsonicRequest::FlushAlbumSongsRequests() {
 
-  while (!album_songs_requests_queue_.isEmpty() && album_songs_requests_active_ < kMaxConcurrentAlbumSongsRequests) {
+  while (!album_songs_requests_queue_.isEmpty() && album_songs_requests_active_ < request_limiter()->concurrent_requests()) {
     const Request request = album_songs_requests_queue_.dequeue();
     ++album_songs_requests_active_;
     QNetworkReply *reply = CreateGetRequest(u"getAlbum"_s, ParamList() << Param(u"id"_s, request.album_id));
@@ -419,7 +598,7 @@ void SubsonicRequest::SongsFinishCheck() {
 
   if (finished_) return;
 
-  if (!album_songs_requests_queue_.isEmpty() && album_songs_requests_active_ < kMaxConcurrentAlbumSongsRequests) FlushAlbumSongsRequests();
+  if (!album_songs_requests_queue_.isEmpty() && album_songs_requests_active_ < request_limiter()->concurrent_requests()) FlushAlbumSongsRequests();
 
   if (download_album_covers() &&
       album_songs_requests_queue_.isEmpty() &&
@@ -815,6 +994,7 @@ void SubsonicRequest::FinishCheck() {
       album_cover_requests_queue_.isEmpty() &&
       album_songs_requests_pending_.isEmpty() &&
       album_covers_requests_sent_.isEmpty() &&
+      songs_search_requests_active_ <= 0 &&
       albums_requests_active_ <= 0 &&
       album_songs_requests_active_ <= 0 &&
       album_songs_received_ >= album_songs_requested_ &&
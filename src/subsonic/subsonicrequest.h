@@ -28,6 +28,7 @@
 #include <QSet>
 #include <QList>
 #include <QHash>
+#include <QMultiHash>
 #include <QMap>
 #include <QMultiMap>
 #include <QQueue>
@@ -37,6 +38,7 @@
 #include <QUrl>
 #include <QJsonObject>
 
+#include "includes/shared_ptr.h"
 #include "core/song.h"
 #include "subsonicbaserequest.h"
 
@@ -45,6 +47,7 @@ class QNetworkReply;
 class SubsonicService;
 class SubsonicUrlHandler;
 class NetworkTimeouts;
+class CollectionBackend;
 
 class SubsonicRequest : public SubsonicBaseRequest {
   Q_OBJECT
@@ -56,17 +59,22 @@ class SubsonicRequest : public SubsonicBaseRequest {
   void ReloadSettings();
 
   void GetAlbums();
+  // Loads the songs already in the collection first, albums with an unchanged number of songs are then not requested again.
+  void GetAlbums(SharedPtr<CollectionBackend> collection_backend);
   void Reset();
 
+  qint64 last_modified() const { return last_modified_; }
+
  private:
   struct Request {
-    explicit Request() : offset(0), size(0) {}
+    explicit Request() : offset(0), size(0), songs_total(0) {}
     QString artist_id;
     QString album_id;
     QString song_id;
     int offset;
     int size;
     QString album_artist;
+    int songs_total;
   };
   struct AlbumCoverRequest {
     QString artist_id;
@@ -86,8 +94,15 @@ class SubsonicRequest : public SubsonicBaseRequest {
   void AlbumsReplyReceived(QNetworkReply *reply, const int offset_requested, const int size_requested);
   void AlbumSongsReplyReceived(QNetworkReply *reply, const QString &artist_id, const QString &album_id, const QString &album_artist);
   void AlbumCoverReceived(QNetworkReply *reply, const SubsonicRequest::AlbumCoverRequest &request);
+  void CollectionSongsLoaded(const SongList &songs, const int id);
+  void IndexesReplyReceived(QNetworkReply *reply);
+  void SongsSearchReplyReceived(QNetworkReply *reply, const int offset_requested);
 
  private:
+  void GetIndexes();
+  void AddSongsSearchRequest(const int offset = 0);
+  void SongsSearchFinished();
+
   void AddAlbumsRequest(const int offset = 0, const int size = 500);
   void FlushAlbumsRequests();
 
@@ -96,6 +111,7 @@ class SubsonicRequest : public SubsonicBaseRequest {
 
   void AddAlbumSongsRequest(const QString &artist_id, const QString &album_id, const QString &album_artist, const int offset = 0);
   void FlushAlbumSongsRequests();
+  bool AddCollectionAlbumSongs(const Request &request);
 
   QString ParseSong(Song &song, const QJsonObject &json_object, const QString &artist_id_requested = QString(), const QString &album_id_requested = QString(), const QString &album_artist = QString(), const QString &album_cover_id = QString(), const qint64 album_created = 0);
 
@@ -133,6 +149,12 @@ class SubsonicRequest : public SubsonicBaseRequest {
   int album_covers_requested_;
   int album_covers_received_;
 
+  QMultiHash<QString, Song> collection_album_songs_;
+  int collection_albums_reused_;
+
+  qint64 last_modified_;
+  int songs_search_requests_active_;
+
   SongMap songs_;
   QMap<QString, QUrl> cover_urls_;
   QStringList errors_;
@@ -22,8 +22,9 @@
 
 #include <QObject>
 #include <QByteArray>
+#include <QList>
 #include <QString>
-#include <QDateTime>
+#include <QStringList>
 #include <QNetworkReply>
 #include <QJsonObject>
 #include <QJsonArray>
@@ -57,12 +58,12 @@ SubsonicScrobbleRequest::~SubsonicScrobbleRequest() {
 
 }
 
-void SubsonicScrobbleRequest::CreateScrobbleRequest(const QString &song_id, const bool submission, const QDateTime &start_time) {
+void SubsonicScrobbleRequest::CreateScrobbleRequest(const QStringList &song_ids, const QList<qint64> &times_ms, const bool submission) {
 
   Request request;
-  request.song_id = song_id;
+  request.song_ids = song_ids;
   request.submission = submission;
-  request.time_ms = start_time.toMSecsSinceEpoch();
+  request.times_ms = times_ms;
   scrobble_requests_queue_.enqueue(request);
   if (scrobble_requests_active_ < kMaxConcurrentScrobbleRequests) FlushScrobbleRequests();
 
@@ -75,19 +76,24 @@ void SubsonicScrobbleRequest::FlushScrobbleRequests() {
     Request request = scrobble_requests_queue_.dequeue();
     ++scrobble_requests_active_;
 
-    ParamList params = ParamList() << Param(u"id"_s, request.song_id)
-                                   << Param(u"submission"_s, QVariant(request.submission).toString())
-                                   << Param(u"time"_s, QVariant(request.time_ms).toString());
+    ParamList params = ParamList() << Param(u"submission"_s, QVariant(request.submission).toString());
+    for (qsizetype i = 0; i < request.song_ids.count(); ++i) {
+      params << Param(u"id"_s, request.song_ids.at(i));
+      if (i < request.times_ms.count()) {
+        params << Param(u"time"_s, QString::number(request.times_ms.at(i)));
+      }
+    }
 
+    const bool submission = request.submission;
     QNetworkReply *reply = CreateGetRequest(u"scrobble"_s, params);
     replies_ << reply;
-    QObject::connect(reply, &QNetworkReply::finished, this, [this, reply]() { ScrobbleReplyReceived(reply); });
+    QObject::connect(reply, &QNetworkReply::finished, this, [this, reply, submission]() { ScrobbleReplyReceived(reply, submission); });
 
   }
 
 }
 
-void SubsonicScrobbleRequest::ScrobbleReplyReceived(QNetworkReply *reply) {
+void SubsonicScrobbleRequest::ScrobbleReplyReceived(QNetworkReply *reply, const bool submission) {
 
   if (!replies_.contains(reply)) return;
   replies_.removeAll(reply);
@@ -102,13 +108,14 @@ void SubsonicScrobbleRequest::ScrobbleReplyReceived(QNetworkReply *reply) {
   const JsonObjectResult json_object_result = ParseJsonObject(reply);
   if (!json_object_result.success()) {
     Error(json_object_result.error_message);
-    FinishCheck();
+    if (submission) {
+      Q_EMIT ScrobbleFinished(false, json_object_result.error_code == ErrorCode::APIError, json_object_result.error_message);
+    }
     return;
   }
-  const QJsonObject &json_object = json_object_result.json_object;
-  if (json_object.isEmpty()) {
-    FinishCheck();
-    return;
+
+  if (submission) {
+    Q_EMIT ScrobbleFinished(true, false, QString());
   }
 
   FinishCheck();
@@ -25,7 +25,7 @@
 
 #include <QtGlobal>
 #include <QObject>
-#include <QDateTime>
+#include <QList>
 #include <QQueue>
 #include <QVariant>
 #include <QString>
@@ -44,20 +44,25 @@ class SubsonicScrobbleRequest : public SubsonicBaseRequest {
   explicit SubsonicScrobbleRequest(SubsonicService *service, SubsonicUrlHandler *url_handler, QObject *parent = nullptr);
   ~SubsonicScrobbleRequest() override;
 
-  void CreateScrobbleRequest(const QString &song_id, const bool submission, const QDateTime &start_time);
+  // Several songs are sent in one request, the API takes repeated id and time parameters.
+  void CreateScrobbleRequest(const QStringList &song_ids, const QList<qint64> &times_ms, const bool submission);
+
+ Q_SIGNALS:
+  // Only emitted for submissions, api_error is true when the server refused the scrobbles.
+  void ScrobbleFinished(const bool success, const bool api_error, const QString &error);
 
  private Q_SLOTS:
-  void ScrobbleReplyReceived(QNetworkReply *reply);
+  void ScrobbleReplyReceived(QNetworkReply *reply, const bool submission);
 
  private:
   struct Request {
     explicit Request() : submission(false) {}
-    // subsonic song id
-    QString song_id;
+    // subsonic song ids
+    QStringList song_ids;
     // submission: true=Submission, false=NowPlaying
     bool submission;
-    // song start time
-    qint64 time_ms;
+    // song start times
+    QList<qint64> times_ms;
   };
 
   void FlushScrobbleRequests();
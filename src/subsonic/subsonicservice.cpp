@@ -27,6 +27,7 @@
 #include <QByteArray>
 #include <QList>
 #include <QString>
+#include <QStringList>
 #include <QVariant>
 #include <QUrl>
 #include <QUrlQuery>
@@ -68,6 +69,8 @@ const char *SubsonicService::kApiVersion = "1.11.0";
 namespace {
 constexpr char kSongsTable[] = "subsonic_songs";
 constexpr int kMaxRedirects = 3;
+constexpr int kInitialConcurrentRequests = 3;
+constexpr int kMaxConcurrentRequests = 8;
 }  // namespace
 
 SubsonicService::SubsonicService(const SharedPtr<TaskManager> task_manager,
@@ -79,15 +82,20 @@ SubsonicService::SubsonicService(const SharedPtr<TaskManager> task_manager,
       url_handler_(new SubsonicUrlHandler(this)),
       collection_backend_(nullptr),
       collection_model_(nullptr),
+      request_limiter_(kInitialConcurrentRequests, kMaxConcurrentRequests),
       http2_(false),
       verify_certificate_(false),
       download_album_covers_(true),
       use_album_id_for_album_covers_(false),
       auth_method_(SubsonicSettings::AuthMethod::MD5),
+      last_modified_(0),
       ping_redirects_(0) {
 
   url_handlers->Register(url_handler_);
 
+  // The songs were in the main database before the service had its own database file.
+  database->ImportSongsTables(QStringList() << QLatin1String(kSongsTable));
+
   collection_backend_ = make_shared<CollectionBackend>();
   collection_backend_->moveToThread(database->thread());
   collection_backend_->Init(database, task_manager, Song::Source::Subsonic, QLatin1String(kSongsTable));
@@ -131,6 +139,7 @@ void SubsonicService::ReloadSettings() {
   download_album_covers_ = s.value(SubsonicSettings::kDownloadAlbumCovers, true).toBool();
   use_album_id_for_album_covers_ = s.value(SubsonicSettings::kUseAlbumIdForAlbumCovers, false).toBool();
   auth_method_ = static_cast<SubsonicSettings::AuthMethod>(s.value(SubsonicSettings::kAuthMethod, static_cast<int>(SubsonicSettings::AuthMethod::MD5)).toInt());
+  last_modified_ = s.value(SubsonicSettings::kLastModified, 0).toLongLong();
 
   s.endGroup();
 
@@ -379,18 +388,21 @@ void SubsonicService::CheckConfiguration() {
 
 }
 
-void SubsonicService::Scrobble(const QString &song_id, const bool submission, const QDateTime &time) {
+bool SubsonicService::Scrobble(const QStringList &song_ids, const QList<qint64> &times_ms, const bool submission) {
 
   if (!server_url().isValid() || username().isEmpty() || password().isEmpty()) {
-    return;
+    return false;
   }
 
   if (!scrobble_request_) {
     // We're doing requests every 30-240s the whole time, so keep reusing this instance
     scrobble_request_.reset(new SubsonicScrobbleRequest(this, url_handler_), [](SubsonicScrobbleRequest *request) { request->deleteLater(); });
+    QObject::connect(&*scrobble_request_, &SubsonicScrobbleRequest::ScrobbleFinished, this, &SubsonicService::ScrobbleFinished);
   }
 
-  scrobble_request_->CreateScrobbleRequest(song_id, submission, time);
+  scrobble_request_->CreateScrobbleRequest(song_ids, times_ms, submission);
+
+  return true;
 
 }
 
@@ -423,24 +435,42 @@ void SubsonicService::GetSongs() {
   QObject::connect(&*songs_request_, &SubsonicRequest::ProgressSetMaximum, this, &SubsonicService::SongsProgressSetMaximum);
   QObject::connect(&*songs_request_, &SubsonicRequest::UpdateProgress, this, &SubsonicService::SongsUpdateProgress);
 
-  songs_request_->GetAlbums();
+  songs_request_->GetAlbums(collection_backend_);
 
 }
 
 void SubsonicService::DeleteSongs() {
 
+  SetLastModified(0);
   collection_backend_->DeleteAllAsync();
 
 }
 
 void SubsonicService::SongsResultsReceived(const SongMap &songs, const QString &error) {
 
+  if (songs_request_ && error.isEmpty()) {
+    SetLastModified(songs_request_->last_modified());
+  }
+
   Q_EMIT SongsResults(songs, error);
 
   ResetSongsRequest();
 
 }
 
+void SubsonicService::SetLastModified(const qint64 last_modified) {
+
+  if (last_modified == last_modified_) return;
+
+  last_modified_ = last_modified;
+
+  Settings s;
+  s.beginGroup(SubsonicSettings::kSettingsGroup);
+  s.setValue(SubsonicSettings::kLastModified, last_modified_);
+  s.endGroup();
+
+}
+
 void SubsonicService::PingError(const QString &error, const QVariant &debug) {
 
   if (!error.isEmpty()) errors_ << error;
@@ -41,6 +41,7 @@
 #include "constants/subsonicsettings.h"
 #include "core/song.h"
 #include "streaming/streamingservice.h"
+#include "streaming/streamingrequestlimiter.h"
 #include "collection/collectionmodel.h"
 
 class QNetworkReply;
@@ -81,8 +82,11 @@ class SubsonicService : public StreamingService {
   bool http2() const { return http2_; }
   bool verify_certificate() const { return verify_certificate_; }
   bool download_album_covers() const { return download_album_covers_; }
+  StreamingRequestLimiter *request_limiter() { return &request_limiter_; }
   bool use_album_id_for_album_covers() const { return use_album_id_for_album_covers_; }
   SubsonicSettings::AuthMethod auth_method() const { return auth_method_; }
+  // Last modified time of the server's music folders when the collection was last loaded.
+  qint64 last_modified() const { return last_modified_; }
 
   SharedPtr<CollectionBackend> collection_backend() const { return collection_backend_; }
   CollectionModel *collection_model() const { return collection_model_; }
@@ -93,7 +97,11 @@ class SubsonicService : public StreamingService {
   CollectionFilter *songs_collection_filter_model() override { return collection_model_->filter(); }
 
   void CheckConfiguration();
-  void Scrobble(const QString &song_id, const bool submission, const QDateTime &time);
+  // Returns false when the server isn't configured, ScrobbleFinished() is emitted when a submission finished.
+  bool Scrobble(const QStringList &song_ids, const QList<qint64> &times_ms, const bool submission);
+
+ Q_SIGNALS:
+  void ScrobbleFinished(const bool success, const bool api_error, const QString &error);
 
  public Q_SLOTS:
   void SendPing();
@@ -109,6 +117,7 @@ class SubsonicService : public StreamingService {
 
  private:
   void PingError(const QString &error = QString(), const QVariant &debug = QVariant());
+  void SetLastModified(const qint64 last_modified);
 
   ScopedPtr<QNetworkAccessManager> network_;
   SubsonicUrlHandler *url_handler_;
@@ -116,6 +125,8 @@ class SubsonicService : public StreamingService {
   SharedPtr<CollectionBackend> collection_backend_;
   CollectionModel *collection_model_;
 
+  StreamingRequestLimiter request_limiter_;
+
   SharedPtr<SubsonicRequest> songs_request_;
   SharedPtr<SubsonicScrobbleRequest> scrobble_request_;
 
@@ -127,6 +138,7 @@ class SubsonicService : public StreamingService {
   bool download_album_covers_;
   bool use_album_id_for_album_covers_;
   SubsonicSettings::AuthMethod auth_method_;
+  qint64 last_modified_;
 
   QStringList errors_;
   int ping_redirects_;
@@ -19,11 +19,15 @@
  */
 
 #include <algorithm>
+#include <utility>
 
+#include <QList>
+#include <QPair>
 #include <QByteArray>
 #include <QString>
 #include <QUrl>
 #include <QEventLoop>
+#include <QThreadStorage>
 #include <QNetworkReply>
 #include <QNetworkRequest>
 #include <QSslError>
@@ -36,6 +40,21 @@
 namespace {
 constexpr TagLibLengthType kTagLibPrefixCacheBytes = 64UL * 1024UL;
 constexpr TagLibLengthType kTagLibSuffixCacheBytes = 8UL * 1024UL;
+// TagLib reads small blocks, a cache miss fetches at least this much.
+constexpr uint kReadAheadBytes = 32U * 1024U;
+
+// The network access manager is shared by all streams read in the same thread, so the connections, including TLS sessions, are kept alive between files.
+NetworkAccessManager *ThreadNetworkAccessManager() {
+
+  static QThreadStorage<NetworkAccessManager*> network_storage;
+  if (!network_storage.hasLocalData()) {
+    network_storage.setLocalData(new NetworkAccessManager);
+  }
+
+  return network_storage.localData();
+
+}
+
 }  // namespace
 
 StreamTagReader::StreamTagReader(const QUrl &url,
@@ -49,14 +68,9 @@ StreamTagReader::StreamTagReader(const QUrl &url,
       length_(static_cast<TagLibLengthType>(length)),
       token_type_(token_type),
       access_token_(access_token),
-      network_(new NetworkAccessManager),
       cursor_(0),
       cache_(length),
-      num_requests_(0) {
-
-  network_->setAutoDeleteReplies(true);
-
-}
+      num_requests_(0) {}
 
 TagLib::FileName StreamTagReader::name() const { return encoded_filename_.data(); }
 
@@ -69,47 +83,78 @@ TagLib::ByteVector StreamTagReader::readBlock(const TagLibLengthType length) {
     return TagLib::ByteVector();
   }
 
-  if (CheckCache(start, end)) {
-    const TagLib::ByteVector cached = GetCache(start, end);
-    cursor_ += static_cast<TagLibLengthType>(cached.size());
-    return cached;
+  if (!CheckCache(start, end)) {
+    // Only the part not cached yet is fetched, with read-ahead for the following reads.
+    uint fetch_start = start;
+    while (cache_.test(fetch_start)) ++fetch_start;
+    const uint fetch_end = std::max(end, std::min(fetch_start + kReadAheadBytes - 1U, static_cast<uint>(length_ - 1)));
+    Fetch(QList<QPair<uint, uint>>() << qMakePair(fetch_start, fetch_end));
   }
 
-  QNetworkRequest network_request(url_);
-  if (!token_type_.isEmpty() && !access_token_.isEmpty()) {
-    network_request.setRawHeader("Authorization", token_type_.toUtf8() + " " + access_token_.toUtf8());
+  // Return what is available from the cursor, if the server returned less than requested.
+  uint available_end = start;
+  while (available_end <= end && cache_.test(available_end)) ++available_end;
+  if (available_end == start) {
+    return TagLib::ByteVector();
   }
-  network_request.setRawHeader("Range", QStringLiteral("bytes=%1-%2").arg(start).arg(end).toUtf8());
-  network_request.setAttribute(QNetworkRequest::CacheLoadControlAttribute, QNetworkRequest::AlwaysNetwork);
-  network_request.setAttribute(QNetworkRequest::RedirectPolicyAttribute, QNetworkRequest::NoLessSafeRedirectPolicy);
 
-  QNetworkReply *reply = network_->get(network_request);
-  ++num_requests_;
+  const TagLib::ByteVector cached = GetCache(start, available_end - 1U);
+  cursor_ += static_cast<TagLibLengthType>(cached.size());
 
-  QEventLoop event_loop;
-  QObject::connect(reply, &QNetworkReply::finished, &event_loop, &QEventLoop::quit);
-  event_loop.exec();
+  return cached;
 
-  if (reply->error() != QNetworkReply::NoError) {
-    qLog(Error) << "Unable to get tags from stream for" << url_ << "got error:" << reply->errorString();
-    return TagLib::ByteVector();
-  }
+}
 
-  if (reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).isValid()) {
-    const int http_status_code = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
-    if (http_status_code >= 400) {
-      qLog(Error) << "Unable to get tags from stream for" << url_ << "received HTTP code" << http_status_code;
-      return TagLib::ByteVector();
+bool StreamTagReader::Fetch(const QList<QPair<uint, uint>> &ranges) {
+
+  NetworkAccessManager *network = ThreadNetworkAccessManager();
+
+  // All ranges are requested at once, so they are pipelined or sent over parallel connections instead of waiting for each other.
+  QList<QNetworkReply*> replies;
+  replies.reserve(ranges.count());
+  for (const QPair<uint, uint> &range : ranges) {
+    QNetworkRequest network_request(url_);
+    if (!token_type_.isEmpty() && !access_token_.isEmpty()) {
+      network_request.setRawHeader("Authorization", token_type_.toUtf8() + " " + access_token_.toUtf8());
     }
+    network_request.setRawHeader("Range", QStringLiteral("bytes=%1-%2").arg(range.first).arg(range.second).toUtf8());
+    network_request.setAttribute(QNetworkRequest::CacheLoadControlAttribute, QNetworkRequest::AlwaysNetwork);
+    network_request.setAttribute(QNetworkRequest::RedirectPolicyAttribute, QNetworkRequest::NoLessSafeRedirectPolicy);
+    network_request.setAttribute(QNetworkRequest::HttpPipeliningAllowedAttribute, true);
+    replies << network->get(network_request);
+    ++num_requests_;
   }
 
-  const QByteArray data = reply->readAll();
-  const TagLib::ByteVector bytes(data.data(), static_cast<uint>(data.size()));
-  cursor_ += static_cast<TagLibLengthType>(data.size());
+  QEventLoop event_loop;
+  qsizetype replies_pending = replies.count();
+  for (QNetworkReply *reply : std::as_const(replies)) {
+    QObject::connect(reply, &QNetworkReply::finished, &event_loop, [&event_loop, &replies_pending]() {
+      if (--replies_pending == 0) event_loop.quit();
+    });
+  }
+  event_loop.exec();
 
-  FillCache(start, bytes);
+  bool success = true;
+  for (qsizetype i = 0; i < replies.count(); ++i) {
+    QNetworkReply *reply = replies[i];
+    const int http_status_code = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).isValid() ? reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt() : 0;
+    if (reply->error() != QNetworkReply::NoError) {
+      qLog(Error) << "Unable to get tags from stream for" << url_ << "got error:" << reply->errorString();
+      success = false;
+    }
+    else if (http_status_code >= 400) {
+      qLog(Error) << "Unable to get tags from stream for" << url_ << "received HTTP code" << http_status_code;
+      success = false;
+    }
+    else {
+      const QByteArray data = reply->readAll();
+      // A server not supporting ranges returns the whole file.
+      FillCache(http_status_code == 200 ? 0U : ranges[i].first, TagLib::ByteVector(data.constData(), static_cast<uint>(data.size())));
+    }
+    delete reply;
+  }
 
-  return bytes;
+  return success;
 
 }
 
@@ -175,7 +220,8 @@ bool StreamTagReader::CheckCache(const uint start, const uint end) {
 
 void StreamTagReader::FillCache(const uint start, const TagLib::ByteVector &data) {
 
-  for (uint i = 0; i < data.size(); ++i) {
+  const uint size = std::min(data.size(), static_cast<uint>(length_) - std::min(start, static_cast<uint>(length_)));
+  for (uint i = 0; i < size; ++i) {
     cache_.set(start + i, data[static_cast<int>(i)]);
   }
 
@@ -205,12 +251,16 @@ void StreamTagReader::PreCache() {
   //
   // So, if we precache the first 64KB and the last 8KB we should be sorted :-)
   // Ideally, we would use bytes=0-655364,-8096 but Google Drive does not seem
-  // to support multipart byte ranges yet so we have to make do with two requests.
+  // to support multipart byte ranges yet so we have to make do with two requests, sent together.
 
-  seek(0, TagLib::IOStream::Beginning);
-  readBlock(kTagLibPrefixCacheBytes);
-  seek(kTagLibSuffixCacheBytes, TagLib::IOStream::End);
-  readBlock(kTagLibSuffixCacheBytes);
-  clear();
+  if (length_ == 0) return;
+
+  const uint last = static_cast<uint>(length_ - 1);
+  if (length_ <= kTagLibPrefixCacheBytes + kTagLibSuffixCacheBytes) {
+    Fetch(QList<QPair<uint, uint>>() << qMakePair(0U, last));
+  }
+  else {
+    Fetch(QList<QPair<uint, uint>>() << qMakePair(0U, static_cast<uint>(kTagLibPrefixCacheBytes - 1)) << qMakePair(static_cast<uint>(length_ - kTagLibSuffixCacheBytes), last));
+  }
 
 }
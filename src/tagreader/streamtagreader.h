@@ -24,22 +24,13 @@
 #include <taglib/tiostream.h>
 #include <google/sparsetable>
 
+#include <QList>
+#include <QPair>
 #include <QByteArray>
 #include <QString>
 #include <QUrl>
 
-#include "includes/scoped_ptr.h"
-#include "core/networkaccessmanager.h"
-
-#if TAGLIB_MAJOR_VERSION >= 2
-using TagLibLengthType = size_t;
-using TagLibUOffsetType = TagLib::offset_t;
-using TagLibOffsetType = TagLib::offset_t;
-#else
-using TagLibLengthType = ulong;
-using TagLibUOffsetType = ulong;
-using TagLibOffsetType = long;
-#endif
+#include "taglibtypes.h"
 
 class StreamTagReader : public TagLib::IOStream {
 
@@ -72,6 +63,8 @@ class StreamTagReader : public TagLib::IOStream {
   void PreCache();
 
  private:
+  // Requests the byte ranges, inclusive, concurrently and stores the data in the cache.
+  bool Fetch(const QList<QPair<uint, uint>> &ranges);
   bool CheckCache(const uint start, const uint end);
   void FillCache(const uint start, const TagLib::ByteVector &data);
   TagLib::ByteVector GetCache(const uint start, const uint end);
@@ -84,8 +77,6 @@ class StreamTagReader : public TagLib::IOStream {
   const QString token_type_;
   const QString access_token_;
 
-  ScopedPtr<NetworkAccessManager> network_;
-
   TagLibLengthType cursor_;
   google::sparsetable<char> cache_;
   int num_requests_;
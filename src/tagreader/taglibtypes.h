@@ -0,0 +1,36 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef TAGLIBTYPES_H
+#define TAGLIBTYPES_H
+
+#include <taglib/taglib.h>
+#include <taglib/tiostream.h>
+
+#if TAGLIB_MAJOR_VERSION >= 2
+using TagLibLengthType = size_t;
+using TagLibUOffsetType = TagLib::offset_t;
+using TagLibOffsetType = TagLib::offset_t;
+#else
+using TagLibLengthType = ulong;
+using TagLibUOffsetType = ulong;
+using TagLibOffsetType = long;
+#endif
+
+#endif  // TAGLIBTYPES_H
@@ -33,6 +33,7 @@
 #include "savetagcoverdata.h"
 #include "albumcovertagdata.h"
 #include "tagid3v2version.h"
+#include "tagreaderreadprofile.h"
 
 class TagReaderBase {
  public:
@@ -41,7 +42,7 @@ class TagReaderBase {
 
   virtual TagReaderResult IsMediaFile(const QString &filename) const = 0;
 
-  virtual TagReaderResult ReadFile(const QString &filename, Song *song) const = 0;
+  virtual TagReaderResult ReadFile(const QString &filename, Song *song, const TagReaderReadProfile read_profile) const = 0;
 #ifdef HAVE_STREAMTAGREADER
   virtual TagReaderResult ReadStream(const QUrl &url, const QString &filename, const quint64 size, const quint64 mtime, const QString &token_type, const QString &access_token, Song *song) const = 0;
 #endif
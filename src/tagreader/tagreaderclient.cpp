@@ -19,21 +19,32 @@
 
 #include "config.h"
 
+#include <algorithm>
+#include <utility>
+
 #include <QtGlobal>
 #include <QObject>
 #include <QThread>
+#include <QThreadPool>
 #include <QMutex>
 #include <QByteArray>
 #include <QString>
 #include <QUrl>
+#include <QList>
+#include <QHash>
+#include <QFileInfo>
+#include <QDateTime>
 #include <QImage>
-#include <QScopeGuard>
 
+#include "constants/collectionsettings.h"
 #include "core/logging.h"
+#include "core/tracing.h"
+#include "core/settings.h"
 #include "core/song.h"
 
 #include "tagreaderclient.h"
 #include "tagreadertaglib.h"
+#include "tagreaderworkerpool.h"
 #include "tagreaderresult.h"
 #include "tagreaderrequest.h"
 #include "tagreaderismediafilerequest.h"
@@ -50,21 +61,38 @@
 #include "tagreaderreadstreamreply.h"
 #include "tagreaderloadcoverdatareply.h"
 #include "tagreaderloadcoverimagereply.h"
+#include "tagreaderwritefilesreply.h"
 #include "tagid3v2version.h"
 
 using std::dynamic_pointer_cast;
 using namespace Qt::Literals::StringLiterals;
 
+namespace {
+constexpr int kMaxWorkers = 4;
+}
+
 TagReaderClient *TagReaderClient::sInstance = nullptr;
 
 TagReaderClient::TagReaderClient(QObject *parent)
     : QObject(parent),
       original_thread_(thread()),
-      abort_(false),
-      processing_(false) {
+      thread_pool_(new QThreadPool(this)),
+      workers_(0),
+      worker_pool_(nullptr),
+      abort_(false) {
 
   setObjectName(QLatin1String(QObject::metaObject()->className()));
 
+  thread_pool_->setMaxThreadCount(qBound(1, QThread::idealThreadCount(), kMaxWorkers));
+
+  Settings s;
+  s.beginGroup(CollectionSettings::kSettingsGroup);
+  const int worker_processes = s.value(CollectionSettings::kTagReaderWorkers, CollectionSettings::kTagReaderWorkersDefault).toInt();
+  s.endGroup();
+  if (worker_processes > 0) {
+    worker_pool_ = new TagReaderWorkerPool(worker_processes, this);
+  }
+
   if (!sInstance) {
     sInstance = this;
   }
@@ -80,23 +108,29 @@ void TagReaderClient::ExitAsync() {
 
 }
 
-void TagReaderClient::Exit() {
+qsizetype TagReaderClient::QueuedRequests() const {
 
-  Q_ASSERT(QThread::currentThread() == thread());
-
-  moveToThread(original_thread_);
-  Q_EMIT ExitFinished();
+  QMutexLocker l(&mutex_requests_);
+  return requests_high_priority_.count() + requests_.count();
 
 }
 
-bool TagReaderClient::HaveRequests() const {
+void TagReaderClient::Exit() {
 
   Q_ASSERT(QThread::currentThread() == thread());
 
   {
     QMutexLocker l(&mutex_requests_);
-    return !requests_.isEmpty();
+    requests_high_priority_.clear();
+    requests_.clear();
+  }
+  if (worker_pool_) {
+    worker_pool_->Exit();
   }
+  thread_pool_->waitForDone();
+
+  moveToThread(original_thread_);
+  Q_EMIT ExitFinished();
 
 }
 
@@ -106,71 +140,87 @@ void TagReaderClient::EnqueueRequest(TagReaderRequestPtr request) {
 
   {
     QMutexLocker l(&mutex_requests_);
-    requests_.enqueue(request);
+    if (request->priority == TagReaderRequest::Priority::High) {
+      requests_high_priority_.enqueue(request);
+    }
+    else {
+      requests_.enqueue(request);
+    }
+    if (workers_ >= thread_pool_->maxThreadCount()) return;
+    ++workers_;
   }
 
-  if (!processing_.value()) {
-    ProcessRequestsAsync();
-  }
+  thread_pool_->start([this]() { ProcessRequests(); });
 
 }
 
 TagReaderRequestPtr TagReaderClient::DequeueRequest() {
 
-  Q_ASSERT(QThread::currentThread() == thread());
+  QMutexLocker l(&mutex_requests_);
 
-  {
-    QMutexLocker l(&mutex_requests_);
-    if (requests_.isEmpty()) return TagReaderRequestPtr();
-    return requests_.dequeue();
+  // Take the first request for a file that isn't already being processed by another worker, high priority requests first.
+  for (QQueue<TagReaderRequestPtr> *requests : {&requests_high_priority_, &requests_}) {
+    for (QQueue<TagReaderRequestPtr>::iterator it = requests->begin(); it != requests->end(); ++it) {
+      if (filenames_processing_.contains((*it)->filename)) continue;
+      TagReaderRequestPtr request = *it;
+      requests->erase(it);
+      filenames_processing_.insert(request->filename);
+      return request;
+    }
   }
 
-}
+  // Nothing left this worker can process, the worker for the file in progress picks up the rest.
+  --workers_;
 
-void TagReaderClient::ProcessRequestsAsync() {
+  return TagReaderRequestPtr();
 
-  Q_ASSERT(QThread::currentThread() != thread());
+}
+
+void TagReaderClient::FinishRequest(TagReaderRequestPtr request) {
 
-  QMetaObject::invokeMethod(this, &TagReaderClient::ProcessRequests, Qt::QueuedConnection);
+  QMutexLocker l(&mutex_requests_);
+  filenames_processing_.remove(request->filename);
 
 }
 
 void TagReaderClient::ProcessRequests() {
 
-  Q_ASSERT(QThread::currentThread() == thread());
-
-  processing_ = true;
-
-  const QScopeGuard scopeguard_processing = qScopeGuard([this]() {
-    processing_ = false;
-  });
+  Q_ASSERT(QThread::currentThread() != thread());
 
-  while (HaveRequests()) {
-    if (abort_.value()) return;
-    ProcessRequest(DequeueRequest());
+  while (TagReaderRequestPtr request = DequeueRequest()) {
+    if (abort_.value()) {
+      FinishRequest(request);
+      continue;
+    }
+    ProcessRequest(request);
+    FinishRequest(request);
   }
 
 }
 
 void TagReaderClient::ProcessRequest(TagReaderRequestPtr request) {
 
-  Q_ASSERT(QThread::currentThread() == thread());
+  qTraceScope("TagReaderClient::ProcessRequest");
+
+  Q_ASSERT(QThread::currentThread() != thread());
 
   TagReaderReplyPtr reply = request->reply;
 
   TagReaderResult result;
 
   if (TagReaderIsMediaFileRequestPtr is_media_file_request = dynamic_pointer_cast<TagReaderIsMediaFileRequest>(request)) {
-    result = tagreader_.IsMediaFile(is_media_file_request->filename);
-    if (result.error_code == TagReaderResult::ErrorCode::FileOpenError || result.error_code == TagReaderResult::ErrorCode::Unsupported) {
-      result = gmereader_.IsMediaFile(is_media_file_request->filename);
+    if (!worker_pool_ || !worker_pool_->IsMediaFile(is_media_file_request->filename, &result)) {
+      result = tagreader_.IsMediaFile(is_media_file_request->filename);
+      if (result.error_code == TagReaderResult::ErrorCode::FileOpenError || result.error_code == TagReaderResult::ErrorCode::Unsupported) {
+        result = gmereader_.IsMediaFile(is_media_file_request->filename);
+      }
     }
   }
   else if (TagReaderReadFileRequestPtr read_file_request = dynamic_pointer_cast<TagReaderReadFileRequest>(request)) {
     Song song;
     result = ReadFileBlocking(read_file_request->filename, &song);
     if (result.error_code == TagReaderResult::ErrorCode::FileOpenError || result.error_code == TagReaderResult::ErrorCode::Unsupported) {
-      result = gmereader_.ReadFile(read_file_request->filename, &song);
+      result = gmereader_.ReadFile(read_file_request->filename, &song, TagReaderReadProfile::Full);
     }
     if (result.success()) {
       if (TagReaderReadFileReplyPtr read_file_reply = qSharedPointerDynamicCast<TagReaderReadFileReply>(reply)) {
@@ -191,6 +241,16 @@ void TagReaderClient::ProcessRequest(TagReaderRequestPtr request) {
 #endif  // HAVE_STREAMTAGREADER
   else if (TagReaderWriteFileRequestPtr write_file_request = dynamic_pointer_cast<TagReaderWriteFileRequest>(request)) {
     result = WriteFileBlocking(write_file_request->filename, write_file_request->song, write_file_request->save_tags_options, write_file_request->save_tag_cover_data, write_file_request->tag_id3v2_version);
+    if (TagReaderWriteFilesReplyPtr write_files_reply = qSharedPointerDynamicCast<TagReaderWriteFilesReply>(reply)) {
+      Song song = write_file_request->song;
+      if (result.success()) {
+        const QFileInfo fileinfo(write_file_request->filename);
+        song.set_filesize(fileinfo.size());
+        song.set_mtime(fileinfo.lastModified().isValid() ? std::max(fileinfo.lastModified().toSecsSinceEpoch(), 0LL) : 0LL);
+      }
+      write_files_reply->FileFinished(write_file_request->filename, song, result);
+      return;
+    }
   }
   else if (TagReaderLoadCoverDataRequestPtr load_cover_data_request = dynamic_pointer_cast<TagReaderLoadCoverDataRequest>(request)) {
     QByteArray cover_data;
@@ -230,6 +290,11 @@ bool TagReaderClient::IsMediaFileBlocking(const QString &filename) const {
 
   Q_ASSERT(QThread::currentThread() != thread());
 
+  TagReaderResult result;
+  if (worker_pool_ && worker_pool_->IsMediaFile(filename, &result)) {
+    return result.success();
+  }
+
   return tagreader_.IsMediaFile(filename).success() || gmereader_.IsMediaFile(filename).success();
 
 }
@@ -242,6 +307,7 @@ TagReaderReplyPtr TagReaderClient::IsMediaFileAsync(const QString &filename) {
 
   TagReaderIsMediaFileRequestPtr request = TagReaderIsMediaFileRequest::Create(filename);
   request->reply = reply;
+  request->priority = TagReaderRequest::Priority::High;
   request->filename = filename;
 
   EnqueueRequest(request);
@@ -250,11 +316,16 @@ TagReaderReplyPtr TagReaderClient::IsMediaFileAsync(const QString &filename) {
 
 }
 
-TagReaderResult TagReaderClient::ReadFileBlocking(const QString &filename, Song *song) {
+TagReaderResult TagReaderClient::ReadFileBlocking(const QString &filename, Song *song, const TagReaderReadProfile read_profile) {
 
-  const TagReaderResult result = tagreader_.ReadFile(filename, song);
+  TagReaderResult worker_result;
+  if (worker_pool_ && QThread::currentThread() != thread() && worker_pool_->ReadFile(filename, song, read_profile, &worker_result)) {
+    return worker_result;
+  }
+
+  const TagReaderResult result = tagreader_.ReadFile(filename, song, read_profile);
   if (result.error_code == TagReaderResult::ErrorCode::FileOpenError || result.error_code == TagReaderResult::ErrorCode::Unsupported) {
-    return gmereader_.ReadFile(filename, song);
+    return gmereader_.ReadFile(filename, song, read_profile);
   }
 
   return result;
@@ -269,6 +340,7 @@ TagReaderReadFileReplyPtr TagReaderClient::ReadFileAsync(const QString &filename
 
   TagReaderReadFileRequestPtr request = TagReaderReadFileRequest::Create(filename);
   request->reply = reply;
+  request->priority = TagReaderRequest::Priority::High;
   request->filename = filename;
 
   EnqueueRequest(request);
@@ -292,6 +364,7 @@ TagReaderReadStreamReplyPtr TagReaderClient::ReadStreamAsync(const QUrl &url, co
 
   TagReaderReadStreamRequestPtr request = TagReaderReadStreamRequest::Create(url, filename);
   request->reply = reply;
+  request->priority = TagReaderRequest::Priority::High;
   request->size = size;
   request->mtime = mtime;
   request->token_type = token_type;
@@ -330,8 +403,82 @@ TagReaderReplyPtr TagReaderClient::WriteFileAsync(const QString &filename, const
 
 }
 
+TagReaderWriteFilesReplyPtr TagReaderClient::WriteFilesAsync(const QList<WriteFileData> &files) {
+
+  Q_ASSERT(QThread::currentThread() != thread());
+
+  QList<WriteFileData> files_merged;
+  QHash<QString, qsizetype> file_indexes;
+  for (const WriteFileData &file : files) {
+    const QString filename = file.song.url().toLocalFile();
+    if (file_indexes.contains(filename)) {
+      MergeWriteFileData(&files_merged[file_indexes.value(filename)], file);
+    }
+    else {
+      file_indexes.insert(filename, files_merged.count());
+      files_merged << file;
+    }
+  }
+
+  TagReaderWriteFilesReplyPtr reply = TagReaderReply::Create<TagReaderWriteFilesReply>(QString());
+  reply->set_pending(files_merged.count());
+
+  if (files_merged.isEmpty()) {
+    reply->Finish();
+    return reply;
+  }
+
+  for (const WriteFileData &file : std::as_const(files_merged)) {
+    const QString filename = file.song.url().toLocalFile();
+    TagReaderWriteFileRequestPtr request = TagReaderWriteFileRequest::Create(filename);
+    request->reply = reply;
+    request->filename = filename;
+    request->song = file.song;
+    request->save_tags_options = file.save_tags_options;
+    request->save_tag_cover_data = file.save_tag_cover_data;
+    request->tag_id3v2_version = file.tag_id3v2_version;
+    EnqueueRequest(request);
+  }
+
+  return reply;
+
+}
+
+void TagReaderClient::MergeWriteFileData(WriteFileData *data, const WriteFileData &other) {
+
+  // The tags come from the last change that writes tags, playcount and rating from the last change that writes them.
+  Song song = other.save_tags_options.testFlag(SaveTagsOption::Tags) || !data->save_tags_options.testFlag(SaveTagsOption::Tags) ? other.song : data->song;
+  if (other.save_tags_options.testFlag(SaveTagsOption::Playcount)) {
+    song.set_playcount(other.song.playcount());
+  }
+  else if (data->save_tags_options.testFlag(SaveTagsOption::Playcount)) {
+    song.set_playcount(data->song.playcount());
+  }
+  if (other.save_tags_options.testFlag(SaveTagsOption::Rating)) {
+    song.set_rating(other.song.rating());
+  }
+  else if (data->save_tags_options.testFlag(SaveTagsOption::Rating)) {
+    song.set_rating(data->song.rating());
+  }
+  data->song = song;
+
+  if (other.save_tags_options.testFlag(SaveTagsOption::Cover)) {
+    data->save_tag_cover_data = other.save_tag_cover_data;
+  }
+  if (other.tag_id3v2_version != TagID3v2Version::Default) {
+    data->tag_id3v2_version = other.tag_id3v2_version;
+  }
+  data->save_tags_options |= other.save_tags_options;
+
+}
+
 TagReaderResult TagReaderClient::LoadCoverDataBlocking(const QString &filename, QByteArray &data) {
 
+  TagReaderResult result;
+  if (worker_pool_ && QThread::currentThread() != thread() && worker_pool_->LoadEmbeddedCover(filename, &data, &result)) {
+    return result;
+  }
+
   return tagreader_.LoadEmbeddedCover(filename, data);
 
 }
@@ -357,6 +504,7 @@ TagReaderLoadCoverDataReplyPtr TagReaderClient::LoadCoverDataAsync(const QString
 
   TagReaderLoadCoverDataRequestPtr request = TagReaderLoadCoverDataRequest::Create(filename);
   request->reply = reply;
+  request->priority = TagReaderRequest::Priority::High;
   request->filename = filename;
 
   EnqueueRequest(request);
@@ -373,6 +521,7 @@ TagReaderLoadCoverImageReplyPtr TagReaderClient::LoadCoverImageAsync(const QStri
 
   TagReaderLoadCoverImageRequestPtr request = TagReaderLoadCoverImageRequest::Create(filename);
   request->reply = reply;
+  request->priority = TagReaderRequest::Priority::High;
   request->filename = filename;
 
   EnqueueRequest(request);
@@ -427,18 +576,16 @@ TagReaderResult TagReaderClient::SaveSongPlaycountBlocking(const QString &filena
 
 }
 
-void TagReaderClient::SaveSongsPlaycountAsync(const SongList &songs) {
-
-  Q_ASSERT(QThread::currentThread() != thread());
+TagReaderWriteFilesReplyPtr TagReaderClient::SaveSongsPlaycountAsync(const SongList &songs) {
 
+  QList<WriteFileData> files;
+  files.reserve(songs.count());
   for (const Song &song : songs) {
-    SharedPtr<QMetaObject::Connection> connection = make_shared<QMetaObject::Connection>();
-    TagReaderReplyPtr reply = SaveSongPlaycountAsync(song.url().toLocalFile(), song.playcount());
-    *connection = QObject::connect(&*reply, &TagReaderReply::Finished, this, [reply, connection]() {
-      QObject::disconnect(*connection);
-    }, Qt::QueuedConnection);
+    files << WriteFileData(song, SaveTagsOption::Playcount);
   }
 
+  return WriteFilesAsync(files);
+
 }
 
 TagReaderResult TagReaderClient::SaveSongRatingBlocking(const QString &filename, const float rating) {
@@ -464,16 +611,14 @@ TagReaderReplyPtr TagReaderClient::SaveSongRatingAsync(const QString &filename,
 
 }
 
-void TagReaderClient::SaveSongsRatingAsync(const SongList &songs) {
-
-  Q_ASSERT(QThread::currentThread() != thread());
+TagReaderWriteFilesReplyPtr TagReaderClient::SaveSongsRatingAsync(const SongList &songs) {
 
+  QList<WriteFileData> files;
+  files.reserve(songs.count());
   for (const Song &song : songs) {
-    SharedPtr<QMetaObject::Connection> connection = make_shared<QMetaObject::Connection>();
-    TagReaderReplyPtr reply = SaveSongRatingAsync(song.url().toLocalFile(), song.rating());
-    *connection = QObject::connect(&*reply, &TagReaderReply::Finished, this, [reply, connection]() {
-      QObject::disconnect(*connection);
-    }, Qt::QueuedConnection);
+    files << WriteFileData(song, SaveTagsOption::Rating);
   }
 
+  return WriteFilesAsync(files);
+
 }
@@ -25,6 +25,7 @@
 #include <QObject>
 #include <QList>
 #include <QQueue>
+#include <QSet>
 #include <QString>
 #include <QImage>
 #include <QMutex>
@@ -41,11 +42,15 @@
 #include "tagreaderreadstreamreply.h"
 #include "tagreaderloadcoverdatareply.h"
 #include "tagreaderloadcoverimagereply.h"
+#include "tagreaderwritefilesreply.h"
 #include "savetagsoptions.h"
 #include "savetagcoverdata.h"
 #include "tagid3v2version.h"
+#include "tagreaderreadprofile.h"
 
 class QThread;
+class QThreadPool;
+class TagReaderWorkerPool;
 class Song;
 
 class TagReaderClient : public QObject {
@@ -59,13 +64,25 @@ class TagReaderClient : public QObject {
   void Start();
   void ExitAsync();
 
+  qsizetype QueuedRequests() const;
+
   using SaveOption = SaveTagsOption;
   using SaveOptions = SaveTagsOptions;
 
+  class WriteFileData {
+   public:
+    explicit WriteFileData(const Song &_song = Song(), const SaveTagsOptions _save_tags_options = SaveTagsOption::Tags, const SaveTagCoverData &_save_tag_cover_data = SaveTagCoverData(), const TagID3v2Version _tag_id3v2_version = TagID3v2Version::Default)
+        : song(_song), save_tags_options(_save_tags_options), save_tag_cover_data(_save_tag_cover_data), tag_id3v2_version(_tag_id3v2_version) {}
+    Song song;
+    SaveTagsOptions save_tags_options;
+    SaveTagCoverData save_tag_cover_data;
+    TagID3v2Version tag_id3v2_version;
+  };
+
   bool IsMediaFileBlocking(const QString &filename) const;
   [[nodiscard]] TagReaderReplyPtr IsMediaFileAsync(const QString &filename);
 
-  TagReaderResult ReadFileBlocking(const QString &filename, Song *song);
+  TagReaderResult ReadFileBlocking(const QString &filename, Song *song, const TagReaderReadProfile read_profile = TagReaderReadProfile::Full);
   [[nodiscard]] TagReaderReadFileReplyPtr ReadFileAsync(const QString &filename);
 
 #ifdef HAVE_STREAMTAGREADER
@@ -75,6 +92,8 @@ class TagReaderClient : public QObject {
 
   TagReaderResult WriteFileBlocking(const QString &filename, const Song &song, const SaveTagsOptions save_tags_options = SaveTagsOption::Tags, const SaveTagCoverData &save_tag_cover_data = SaveTagCoverData(), const TagID3v2Version tag_id3v2_version = TagID3v2Version::Default);
   [[nodiscard]] TagReaderReplyPtr WriteFileAsync(const QString &filename, const Song &song, const SaveTagsOptions save_tags_options = SaveTagsOption::Tags, const SaveTagCoverData &save_tag_cover_data = SaveTagCoverData(), const TagID3v2Version tag_id3v2_version = TagID3v2Version::Default);
+  // Writes the files in parallel, changes for the same file are merged so each file is only written once.
+  [[nodiscard]] TagReaderWriteFilesReplyPtr WriteFilesAsync(const QList<WriteFileData> &files);
 
   TagReaderResult LoadCoverDataBlocking(const QString &filename, QByteArray &data);
   TagReaderResult LoadCoverImageBlocking(const QString &filename, QImage &image);
@@ -91,33 +110,39 @@ class TagReaderClient : public QObject {
   TagReaderResult SaveSongRatingBlocking(const QString &filename, const float rating);
 
  private:
-  bool HaveRequests() const;
   void EnqueueRequest(TagReaderRequestPtr request);
   TagReaderRequestPtr DequeueRequest();
-  void ProcessRequestsAsync();
+  void FinishRequest(TagReaderRequestPtr request);
+  void ProcessRequests();
   void ProcessRequest(TagReaderRequestPtr request);
+  static void MergeWriteFileData(WriteFileData *data, const WriteFileData &other);
 
  Q_SIGNALS:
   void ExitFinished();
 
  private Q_SLOTS:
   void Exit();
-  void ProcessRequests();
 
  public Q_SLOTS:
-  void SaveSongsPlaycountAsync(const SongList &songs);
-  void SaveSongsRatingAsync(const SongList &songs);
+  [[nodiscard]] TagReaderWriteFilesReplyPtr SaveSongsPlaycountAsync(const SongList &songs);
+  [[nodiscard]] TagReaderWriteFilesReplyPtr SaveSongsRatingAsync(const SongList &songs);
 
  private:
   static TagReaderClient *sInstance;
 
   QThread *original_thread_;
+  QThreadPool *thread_pool_;
+  QQueue<TagReaderRequestPtr> requests_high_priority_;
   QQueue<TagReaderRequestPtr> requests_;
+  // Files with a request being processed, requests for the same file are never processed concurrently.
+  QSet<QString> filenames_processing_;
+  int workers_;
   mutable QMutex mutex_requests_;
+  // Reads tags in separate processes when enabled, writing always happens in this process.
+  TagReaderWorkerPool *worker_pool_;
   TagReaderTagLib tagreader_;
   TagReaderGME gmereader_;
   mutex_protected<bool> abort_;
-  mutex_protected<bool> processing_;
 };
 
 #endif  // TAGREADERCLIENT_H
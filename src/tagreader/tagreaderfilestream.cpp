@@ -0,0 +1,244 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "config.h"
+
+#include <algorithm>
+#include <atomic>
+
+#include <QtGlobal>
+#include <QByteArray>
+#include <QString>
+#include <QHash>
+#include <QFile>
+#include <QFileInfo>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QStorageInfo>
+
+#include <taglib/tbytevector.h>
+
+#include "constants/filesystemconstants.h"
+#include "tagreaderfilestream.h"
+
+namespace {
+
+constexpr qint64 kHeadBufferBytes = 128LL * 1024LL;
+constexpr qint64 kTailBufferBytes = 64LL * 1024LL;
+constexpr qint64 kReadAheadBytes = 64LL * 1024LL;
+
+// The ID3v2 tag at the start of the file is read in one request, up to this size.
+constexpr qint64 kMaxHeadBufferBytes = 16LL * 1024LL * 1024LL;
+constexpr qint64 kID3v2HeaderBytes = 10;
+
+QMutex network_directories_mutex;
+QHash<QString, bool> network_directories;
+
+std::atomic<quint64> g_files(0);
+std::atomic<quint64> g_bytes_read(0);
+
+}  // namespace
+
+TagReaderFileStream::TagReaderFileStream(const QString &filename, const Mode mode)
+    : filename_(filename),
+      encoded_filename_(QFile::encodeName(filename)),
+      file_(filename),
+      size_(0),
+      data_(nullptr),
+      cursor_(0),
+      num_reads_(0) {
+
+  if (!file_.open(QIODevice::ReadOnly | QIODevice::Unbuffered)) {
+    return;
+  }
+
+  size_ = file_.size();
+  g_files.fetch_add(1, std::memory_order_relaxed);
+
+  if (size_ > 0 && (mode == Mode::Map || (mode == Mode::Auto && !IsNetworkFileSystem(filename_)))) {
+    data_ = file_.map(0, size_);
+  }
+
+}
+
+TagReaderFileStream::~TagReaderFileStream() {
+
+  if (data_) {
+    file_.unmap(data_);
+  }
+
+}
+
+bool TagReaderFileStream::IsNetworkFileSystem(const QString &filename) {
+
+  const QString path = QFileInfo(filename).absolutePath();
+
+  QMutexLocker l(&network_directories_mutex);
+  QHash<QString, bool>::const_iterator it = network_directories.constFind(path);
+  if (it != network_directories.constEnd()) {
+    return *it;
+  }
+
+  const bool network_filesystem = kNetworkFileSystems.contains(QStorageInfo(path).fileSystemType());
+  network_directories.insert(path, network_filesystem);
+
+  return network_filesystem;
+
+}
+
+TagReaderFileStream::Statistics TagReaderFileStream::statistics() {
+
+  return Statistics { g_files.load(std::memory_order_relaxed), g_bytes_read.load(std::memory_order_relaxed) };
+
+}
+
+TagLib::FileName TagReaderFileStream::name() const { return encoded_filename_.constData(); }
+
+TagLib::ByteVector TagReaderFileStream::readBlock(const TagLibLengthType length) {
+
+  if (!file_.isOpen() || length == 0 || cursor_ >= size_) {
+    return TagLib::ByteVector();
+  }
+
+  const qint64 bytes = std::min(static_cast<qint64>(length), size_ - cursor_);
+
+  TagLib::ByteVector data;
+  if (data_) {
+    data = TagLib::ByteVector(reinterpret_cast<const char*>(data_ + cursor_), static_cast<unsigned int>(bytes));
+  }
+  else {
+    data = ReadBuffered(cursor_, bytes);
+  }
+
+  cursor_ += static_cast<qint64>(data.size());
+  g_bytes_read.fetch_add(data.size(), std::memory_order_relaxed);
+
+  return data;
+
+}
+
+void TagReaderFileStream::writeBlock(const TagLib::ByteVector &data) {
+  Q_UNUSED(data)
+}
+
+void TagReaderFileStream::insert(const TagLib::ByteVector &data, const TagLibUOffsetType start, const TagLibLengthType replace) {
+  Q_UNUSED(data)
+  Q_UNUSED(start)
+  Q_UNUSED(replace)
+}
+
+void TagReaderFileStream::removeBlock(const TagLibUOffsetType start, const TagLibLengthType length) {
+  Q_UNUSED(start)
+  Q_UNUSED(length)
+}
+
+bool TagReaderFileStream::readOnly() const { return true; }
+
+bool TagReaderFileStream::isOpen() const { return file_.isOpen(); }
+
+void TagReaderFileStream::seek(const TagLibOffsetType offset, const TagLib::IOStream::Position position) {
+
+  switch (position) {
+    case TagLib::IOStream::Beginning:
+      cursor_ = static_cast<qint64>(offset);
+      break;
+    case TagLib::IOStream::Current:
+      cursor_ += static_cast<qint64>(offset);
+      break;
+    case TagLib::IOStream::End:
+      cursor_ = size_ + static_cast<qint64>(offset);
+      break;
+  }
+
+  cursor_ = std::max(cursor_, 0LL);
+
+}
+
+void TagReaderFileStream::clear() {}
+
+TagLibOffsetType TagReaderFileStream::tell() const { return static_cast<TagLibOffsetType>(cursor_); }
+
+TagLibOffsetType TagReaderFileStream::length() { return static_cast<TagLibOffsetType>(size_); }
+
+void TagReaderFileStream::truncate(const TagLibOffsetType length) {
+  Q_UNUSED(length)
+}
+
+bool TagReaderFileStream::FillBuffer(Buffer *buffer, const qint64 position, const qint64 length) {
+
+  buffer->position = position;
+  buffer->data.clear();
+
+  if (!file_.seek(position)) {
+    return false;
+  }
+
+  buffer->data = file_.read(std::min(length, size_ - position));
+  ++num_reads_;
+
+  return !buffer->data.isEmpty();
+
+}
+
+void TagReaderFileStream::FillHeadBuffer() {
+
+  if (!FillBuffer(&head_, 0, kHeadBufferBytes)) return;
+
+  // If the file starts with an ID3v2 tag larger than the buffer, read the rest of it in one more request instead of many small reads.
+  const QByteArray &header = head_.data;
+  if (header.size() < kID3v2HeaderBytes || !header.startsWith("ID3")) return;
+
+  const qint64 tag_size = (static_cast<qint64>(header[6] & 0x7F) << 21) | (static_cast<qint64>(header[7] & 0x7F) << 14) | (static_cast<qint64>(header[8] & 0x7F) << 7) | static_cast<qint64>(header[9] & 0x7F);
+  const qint64 head_size = std::min(std::min(kID3v2HeaderBytes + tag_size + kReadAheadBytes, kMaxHeadBufferBytes), size_);
+  if (head_size <= head_.data.size() || !file_.seek(head_.data.size())) return;
+
+  head_.data.append(file_.read(head_size - head_.data.size()));
+  ++num_reads_;
+
+}
+
+TagLib::ByteVector TagReaderFileStream::ReadBuffered(const qint64 position, const qint64 length) {
+
+  if (position < kHeadBufferBytes && head_.data.isEmpty()) {
+    FillHeadBuffer();
+  }
+  if (position + length > size_ - kTailBufferBytes && tail_.data.isEmpty()) {
+    const qint64 tail_position = std::max(size_ - kTailBufferBytes, 0LL);
+    FillBuffer(&tail_, tail_position, size_ - tail_position);
+  }
+
+  for (const Buffer *buffer : {&head_, &tail_, &read_ahead_}) {
+    if (buffer->Contains(position, length)) {
+      return TagLib::ByteVector(buffer->data.constData() + (position - buffer->position), static_cast<unsigned int>(length));
+    }
+  }
+
+  // Large reads such as pictures are not buffered.
+  if (length >= kReadAheadBytes) {
+    Buffer buffer;
+    if (!FillBuffer(&buffer, position, length)) return TagLib::ByteVector();
+    return TagLib::ByteVector(buffer.data.constData(), static_cast<unsigned int>(buffer.data.size()));
+  }
+
+  if (!FillBuffer(&read_ahead_, position, kReadAheadBytes)) return TagLib::ByteVector();
+  const qint64 bytes = std::min(length, static_cast<qint64>(read_ahead_.data.size()));
+
+  return TagLib::ByteVector(read_ahead_.data.constData(), static_cast<unsigned int>(bytes));
+
+}
@@ -0,0 +1,98 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef TAGREADERFILESTREAM_H
+#define TAGREADERFILESTREAM_H
+
+#include <taglib/tiostream.h>
+
+#include <QtGlobal>
+#include <QByteArray>
+#include <QString>
+#include <QFile>
+
+#include "taglibtypes.h"
+
+// Read only TagLib stream for reading tags from local files.
+// The file is memory mapped, so the many small reads and seeks TagLib does while parsing are only memory copies.
+// Files on network filesystems are read through buffers instead, the start and the end of the file are read in one request each,
+// since they contain the headers and tags, other reads are read ahead.
+class TagReaderFileStream : public TagLib::IOStream {
+
+ public:
+  enum class Mode {
+    Auto,
+    Map,
+    Buffer
+  };
+
+  explicit TagReaderFileStream(const QString &filename, const Mode mode = Mode::Auto);
+  ~TagReaderFileStream() override;
+
+  TagLib::FileName name() const override;
+  TagLib::ByteVector readBlock(const TagLibLengthType length) override;
+  void writeBlock(const TagLib::ByteVector &data) override;
+  void insert(const TagLib::ByteVector &data, const TagLibUOffsetType start, const TagLibLengthType replace) override;
+  void removeBlock(const TagLibUOffsetType start, const TagLibLengthType length) override;
+  bool readOnly() const override;
+  bool isOpen() const override;
+  void seek(const TagLibOffsetType offset, const TagLib::IOStream::Position position) override;
+  void clear() override;
+  TagLibOffsetType tell() const override;
+  TagLibOffsetType length() override;
+  void truncate(const TagLibOffsetType length) override;
+
+  bool mapped() const { return data_ != nullptr; }
+  int num_reads() const { return num_reads_; }
+
+  // Files opened and bytes returned to TagLib by all streams, in every thread.
+  struct Statistics {
+    quint64 files;
+    quint64 bytes_read;
+  };
+  static Statistics statistics();
+
+ private:
+  class Buffer {
+   public:
+    Buffer() : position(0) {}
+    bool Contains(const qint64 _position, const qint64 _length) const { return _position >= position && _position + _length <= position + data.size(); }
+    qint64 position;
+    QByteArray data;
+  };
+
+  static bool IsNetworkFileSystem(const QString &filename);
+  bool FillBuffer(Buffer *buffer, const qint64 position, const qint64 length);
+  void FillHeadBuffer();
+  TagLib::ByteVector ReadBuffered(const qint64 position, const qint64 length);
+
+ private:
+  const QString filename_;
+  const QByteArray encoded_filename_;
+  QFile file_;
+  qint64 size_;
+  uchar *data_;
+  qint64 cursor_;
+  Buffer head_;
+  Buffer tail_;
+  Buffer read_ahead_;
+  int num_reads_;
+};
+
+#endif  // TAGREADERFILESTREAM_H
@@ -295,7 +295,9 @@ TagReaderResult TagReaderGME::IsMediaFile(const QString &filename) const {
 
 }
 
-TagReaderResult TagReaderGME::ReadFile(const QString &filename, Song *song) const {
+TagReaderResult TagReaderGME::ReadFile(const QString &filename, Song *song, const TagReaderReadProfile read_profile) const {
+
+  Q_UNUSED(read_profile)
 
   QFileInfo fileinfo(filename);
   return GME::ReadFile(fileinfo, song);
@@ -102,7 +102,7 @@ class TagReaderGME : public TagReaderBase {
 
   TagReaderResult IsMediaFile(const QString &filename) const override;
 
-  TagReaderResult ReadFile(const QString &filename, Song *song) const override;
+  TagReaderResult ReadFile(const QString &filename, Song *song, const TagReaderReadProfile read_profile) const override;
 
 #ifdef HAVE_STREAMTAGREADER
   TagReaderResult ReadStream(const QUrl &url, const QString &filename, const quint64 size, const quint64 mtime, const QString &token_type, const QString &access_token, Song *song) const override;
@@ -21,13 +21,13 @@
 
 #include "tagreaderrequest.h"
 
-TagReaderRequest::TagReaderRequest(const QString &_filename) : filename(_filename) {
+TagReaderRequest::TagReaderRequest(const QString &_filename) : filename(_filename), priority(Priority::Normal) {
 
   qLog(Debug) << "New tagreader request for" << filename;
 
 }
 
-TagReaderRequest::TagReaderRequest(const QUrl &_url, const QString &_filename) : filename(_filename), url(_url) {
+TagReaderRequest::TagReaderRequest(const QUrl &_url, const QString &_filename) : filename(_filename), url(_url), priority(Priority::Normal) {
 
   qLog(Debug) << "New tagreader request for" << filename << url;
 
@@ -31,9 +31,17 @@ class TagReaderRequest {
   explicit TagReaderRequest(const QString &_filename);
   explicit TagReaderRequest(const QUrl &_url, const QString &_filename);
   virtual ~TagReaderRequest();
+
+  // High priority requests are processed before any queued normal priority requests.
+  enum class Priority {
+    Normal,
+    High
+  };
+
   QString filename;
   QUrl url;
   TagReaderReplyPtr reply;
+  Priority priority;
 };
 
 using TagReaderRequestPtr = SharedPtr<TagReaderRequest>;
@@ -97,6 +97,8 @@
 #include <QFileInfo>
 #include <QUrl>
 #include <QDateTime>
+#include <QMutexLocker>
+#include <QtEndian>
 #include <QtDebug>
 
 #include "includes/scoped_ptr.h"
@@ -106,6 +108,7 @@
 
 #include "albumcovertagdata.h"
 #include "tagid3v2version.h"
+#include "tagreaderfilestream.h"
 
 using std::make_unique;
 using namespace Qt::Literals::StringLiterals;
@@ -259,6 +262,72 @@ constexpr char kASF_MusicBrainz_DiscId[] = "MusicBrainz/Disc Id";
 constexpr char kASF_MusicBrainz_ReleaseGroupId[] = "MusicBrainz/Release Group Id";
 constexpr char kASF_MusicBrainz_WorkId[] = "MusicBrainz/Work Id";
 
+// Embedded cover locations are forgotten when there are more than this many files.
+constexpr int kMaxEmbeddedCoverLocations = 20000;
+// Maximum size of the APIC frame header (encoding, MIME type, picture type and description) handled without TagLib.
+constexpr qint64 kMaxID3v2PictureHeaderSize = 4096;
+constexpr int kFLAC_MetadataBlockPicture = 6;
+constexpr quint32 kFLAC_PictureTypeOther = 0;
+constexpr quint32 kFLAC_PictureTypeFrontCover = 3;
+
+quint32 ReadBigEndian32(const QByteArray &data, const qsizetype pos) {
+  return qFromBigEndian<quint32>(data.constData() + pos);
+}
+
+qint64 ReadSyncSafe32(const QByteArray &data, const qsizetype pos) {
+
+  const uchar *p = reinterpret_cast<const uchar*>(data.constData() + pos);
+  return (static_cast<qint64>(p[0] & 0x7F) << 21) | (static_cast<qint64>(p[1] & 0x7F) << 14) | (static_cast<qint64>(p[2] & 0x7F) << 7) | static_cast<qint64>(p[3] & 0x7F);
+
+}
+
+QByteArray ReadAt(QFile &file, const qint64 pos, const qint64 length) {
+
+  if (pos < 0 || length <= 0 || !file.seek(pos)) return QByteArray();
+  return file.read(length);
+
+}
+
+bool IsImageData(const QByteArray &data) {
+
+  return data.startsWith("\xFF\xD8\xFF") ||
+         data.startsWith("\x89PNG") ||
+         data.startsWith("GIF8") ||
+         data.startsWith("BM") ||
+         (data.startsWith("RIFF") && data.mid(8, 4) == "WEBP");
+
+}
+
+// Finds the child atom with the given name between pos and end, and returns the range of its data.
+bool FindMP4Atom(QFile &file, qint64 pos, const qint64 end, const char *name, qint64 *data_start, qint64 *data_end) {
+
+  while (pos + 8 <= end) {
+    const QByteArray header = ReadAt(file, pos, 8);
+    if (header.size() != 8) return false;
+    qint64 header_size = 8;
+    qint64 atom_size = ReadBigEndian32(header, 0);
+    if (atom_size == 1) {
+      const QByteArray extended_size = file.read(8);
+      if (extended_size.size() != 8) return false;
+      atom_size = qFromBigEndian<qint64>(extended_size.constData());
+      header_size = 16;
+    }
+    else if (atom_size == 0) {
+      atom_size = end - pos;
+    }
+    if (atom_size < header_size || pos + atom_size > end) return false;
+    if (header.mid(4, 4) == name) {
+      *data_start = pos + header_size;
+      *data_end = pos + atom_size;
+      return true;
+    }
+    pos += atom_size;
+  }
+
+  return false;
+
+}
+
 }  // namespace
 
 class FileRefFactory {
@@ -266,20 +335,45 @@ class FileRefFactory {
   FileRefFactory() = default;
   virtual ~FileRefFactory() = default;
   virtual TagLib::FileRef *GetFileRef(const QString &filename) = 0;
+  virtual TagLib::FileRef *GetFileRef(const QString &filename, const bool read_audio_properties, const TagLib::AudioProperties::ReadStyle read_style) = 0;
   virtual TagLib::FileRef *GetFileRef(TagLib::IOStream *iostream) = 0;
+  // Read only file reference, only for reading tags and covers.
+  virtual TagLib::FileRef *GetFileRefForReading(const QString &filename, const bool read_audio_properties, const TagLib::AudioProperties::ReadStyle read_style) = 0;
 
  private:
   Q_DISABLE_COPY(FileRefFactory)
 };
 
+namespace {
+
+// Base class owning the stream, so the stream is deleted after the file in the TagLib::FileRef destructor.
+class FileStreamOwner {
+ protected:
+  explicit FileStreamOwner(TagReaderFileStream *stream) : stream_(stream) {}
+  ScopedPtr<TagReaderFileStream> stream_;
+};
+
+class FileStreamRef : private FileStreamOwner, public TagLib::FileRef {
+ public:
+  explicit FileStreamRef(TagReaderFileStream *stream, const bool read_audio_properties, const TagLib::AudioProperties::ReadStyle read_style)
+      : FileStreamOwner(stream),
+        TagLib::FileRef(stream, read_audio_properties, read_style) {}
+};
+
+}  // namespace
+
 class TagLibFileRefFactory : public FileRefFactory {
  public:
   TagLibFileRefFactory() = default;
   TagLib::FileRef *GetFileRef(const QString &filename) override {
+    return GetFileRef(filename, true, TagLib::AudioProperties::Average);
+  }
+
+  TagLib::FileRef *GetFileRef(const QString &filename, const bool read_audio_properties, const TagLib::AudioProperties::ReadStyle read_style) override {
 #ifdef Q_OS_WIN32
-    return new TagLib::FileRef(filename.toStdWString().c_str());
+    return new TagLib::FileRef(filename.toStdWString().c_str(), read_audio_properties, read_style);
 #else
-    return new TagLib::FileRef(QFile::encodeName(filename).constData());
+    return new TagLib::FileRef(QFile::encodeName(filename).constData(), read_audio_properties, read_style);
 #endif
   }
 
@@ -287,6 +381,15 @@ class TagLibFileRefFactory : public FileRefFactory {
     return new TagLib::FileRef(iostream);
   }
 
+  TagLib::FileRef *GetFileRefForReading(const QString &filename, const bool read_audio_properties, const TagLib::AudioProperties::ReadStyle read_style) override {
+    TagReaderFileStream *stream = new TagReaderFileStream(filename);
+    if (!stream->isOpen()) {
+      delete stream;
+      return GetFileRef(filename, read_audio_properties, read_style);
+    }
+    return new FileStreamRef(stream, read_audio_properties, read_style);
+  }
+
  private:
   Q_DISABLE_COPY(TagLibFileRefFactory)
 };
@@ -301,7 +404,7 @@ TagReaderResult TagReaderTagLib::IsMediaFile(const QString &filename) const {
 
   qLog(Debug) << "Checking for valid file" << filename;
 
-  ScopedPtr<TagLib::FileRef> fileref(factory_->GetFileRef(filename));
+  ScopedPtr<TagLib::FileRef> fileref(factory_->GetFileRefForReading(filename, true, TagLib::AudioProperties::Average));
   return fileref &&
          !fileref->isNull() &&
          fileref->file() &&
@@ -384,7 +487,9 @@ TagReaderResult TagReaderTagLib::Read(SharedPtr<TagLib::FileRef> fileref, Song *
   }
 
   if (TagLib::FLAC::File *file_flac = dynamic_cast<TagLib::FLAC::File*>(fileref->file())) {
-    song->set_bitdepth(file_flac->audioProperties()->bitsPerSample());
+    if (file_flac->audioProperties()) {
+      song->set_bitdepth(file_flac->audioProperties()->bitsPerSample());
+    }
     if (file_flac->xiphComment()) {
       ParseVorbisComments(file_flac->xiphComment()->fieldListMap(), &disc, &compilation, song);
       if (song->url().isLocalFile()) {
@@ -405,7 +510,9 @@ TagReaderResult TagReaderTagLib::Read(SharedPtr<TagLib::FileRef> fileref, Song *
   }
 
   else if (TagLib::WavPack::File *file_wavpack = dynamic_cast<TagLib::WavPack::File*>(fileref->file())) {
-    song->set_bitdepth(file_wavpack->audioProperties()->bitsPerSample());
+    if (file_wavpack->audioProperties()) {
+      song->set_bitdepth(file_wavpack->audioProperties()->bitsPerSample());
+    }
     if (file_wavpack->APETag()) {
       ParseAPETags(file_wavpack->APETag()->itemListMap(), &disc, &compilation, song);
     }
@@ -415,7 +522,9 @@ TagReaderResult TagReaderTagLib::Read(SharedPtr<TagLib::FileRef> fileref, Song *
   }
 
   else if (TagLib::APE::File *file_ape = dynamic_cast<TagLib::APE::File*>(fileref->file())) {
-    song->set_bitdepth(file_ape->audioProperties()->bitsPerSample());
+    if (file_ape->audioProperties()) {
+      song->set_bitdepth(file_ape->audioProperties()->bitsPerSample());
+    }
     if (file_ape->APETag()) {
       ParseAPETags(file_ape->APETag()->itemListMap(), &disc, &compilation, song);
     }
@@ -431,14 +540,18 @@ TagReaderResult TagReaderTagLib::Read(SharedPtr<TagLib::FileRef> fileref, Song *
   }
 
   else if (TagLib::MP4::File *file_mp4 = dynamic_cast<TagLib::MP4::File*>(fileref->file())) {
-    song->set_bitdepth(file_mp4->audioProperties()->bitsPerSample());
+    if (file_mp4->audioProperties()) {
+      song->set_bitdepth(file_mp4->audioProperties()->bitsPerSample());
+    }
     if (file_mp4->tag()) {
       ParseMP4Tags(file_mp4->tag(), &disc, &compilation, song);
     }
   }
 
   else if (TagLib::ASF::File *file_asf = dynamic_cast<TagLib::ASF::File*>(fileref->file())) {
-    song->set_bitdepth(file_asf->audioProperties()->bitsPerSample());
+    if (file_asf->audioProperties()) {
+      song->set_bitdepth(file_asf->audioProperties()->bitsPerSample());
+    }
     if (file_asf->tag()) {
       song->set_comment(file_asf->tag()->comment());
       ParseASFTags(file_asf->tag(), &disc, &compilation, song);
@@ -514,7 +627,7 @@ TagReaderResult TagReaderTagLib::Read(SharedPtr<TagLib::FileRef> fileref, Song *
 
 }
 
-TagReaderResult TagReaderTagLib::ReadFile(const QString &filename, Song *song) const {
+TagReaderResult TagReaderTagLib::ReadFile(const QString &filename, Song *song, const TagReaderReadProfile read_profile) const {
 
   if (filename.isEmpty()) {
     return TagReaderResult::ErrorCode::FilenameMissing;
@@ -530,11 +643,16 @@ TagReaderResult TagReaderTagLib::ReadFile(const QString &filename, Song *song) c
 
   if (song->source() == Song::Source::Unknown) song->set_source(Song::Source::LocalFile);
 
+  const qint64 mtime = fileinfo.lastModified().isValid() ? std::max(fileinfo.lastModified().toSecsSinceEpoch(), 0LL) : 0LL;
+
+  // Calculating the audio properties can mean reading through much of the file, the scanner already has them for files it reads again unchanged.
+  const bool read_audio_properties = read_profile == TagReaderReadProfile::Full || song->length_nanosec() <= 0 || song->filesize() != fileinfo.size() || song->mtime() != mtime;
+
   const QUrl url = QUrl::fromLocalFile(filename);
   song->set_basefilename(fileinfo.fileName());
   song->set_url(url);
   song->set_filesize(fileinfo.size());
-  song->set_mtime(fileinfo.lastModified().isValid() ? std::max(fileinfo.lastModified().toSecsSinceEpoch(), 0LL) : 0LL);
+  song->set_mtime(mtime);
   song->set_ctime(fileinfo.birthTime().isValid() ? std::max(fileinfo.birthTime().toSecsSinceEpoch(), 0LL) : fileinfo.lastModified().isValid() ? std::max(fileinfo.lastModified().toSecsSinceEpoch(), 0LL) : 0LL);
   if (song->ctime() <= 0) {
     song->set_ctime(song->mtime());
@@ -542,7 +660,7 @@ TagReaderResult TagReaderTagLib::ReadFile(const QString &filename, Song *song) c
   song->set_lastseen(QDateTime::currentSecsSinceEpoch());
   song->set_init_from_file(true);
 
-  SharedPtr<TagLib::FileRef> fileref(factory_->GetFileRef(filename));
+  SharedPtr<TagLib::FileRef> fileref(factory_->GetFileRefForReading(filename, read_audio_properties, read_profile == TagReaderReadProfile::Scan ? TagLib::AudioProperties::Fast : TagLib::AudioProperties::Average));
   if (!fileref || fileref->isNull()) {
     qLog(Error) << "TagLib could not open file" << filename;
     return TagReaderResult::ErrorCode::FileOpenError;
@@ -1067,6 +1185,9 @@ TagReaderResult TagReaderTagLib::WriteFile(const QString &filename, const Song &
     return TagReaderResult::ErrorCode::FileDoesNotExist;
   }
 
+  // Tags are rewritten, so the cover can move.
+  ForgetEmbeddedCoverLocation(filename);
+
   const bool save_tags = save_tags_options.testFlag(SaveTagsOption::Tags);
   const bool save_playcount = save_tags_options.testFlag(SaveTagsOption::Playcount);
   const bool save_rating = save_tags_options.testFlag(SaveTagsOption::Rating);
@@ -1514,7 +1635,11 @@ TagReaderResult TagReaderTagLib::LoadEmbeddedCover(const QString &filename, QByt
 
   qLog(Debug) << "Loading cover from" << filename;
 
-  ScopedPtr<TagLib::FileRef> fileref(factory_->GetFileRef(filename));
+  if (LoadEmbeddedCoverFast(filename, data)) {
+    return TagReaderResult::ErrorCode::Success;
+  }
+
+  ScopedPtr<TagLib::FileRef> fileref(factory_->GetFileRefForReading(filename, true, TagLib::AudioProperties::Average));
   if (!fileref || fileref->isNull()) {
     qLog(Error) << "TagLib could not open file" << filename;
     return TagReaderResult::ErrorCode::FileOpenError;
@@ -1653,6 +1778,13 @@ TagReaderResult TagReaderTagLib::LoadEmbeddedCover(const QString &filename, QByt
     }
   }
 
+  // Remember that the file has no cover, so it is not parsed again until it is modified.
+  const QFileInfo fileinfo(filename);
+  EmbeddedCoverLocation location;
+  location.size = fileinfo.size();
+  location.mtime = fileinfo.lastModified().toMSecsSinceEpoch();
+  CacheEmbeddedCoverLocation(filename, location);
+
   return TagReaderResult::ErrorCode::Success;
 
 }
@@ -1683,6 +1815,245 @@ QByteArray TagReaderTagLib::LoadEmbeddedCover(TagLib::APE::Tag *tag) const {
 
 }
 
+bool TagReaderTagLib::LoadEmbeddedCoverFast(const QString &filename, QByteArray &data) const {
+
+  const QFileInfo fileinfo(filename);
+  const qint64 size = fileinfo.size();
+  const qint64 mtime = fileinfo.lastModified().toMSecsSinceEpoch();
+
+  EmbeddedCoverLocation location;
+  bool cached = false;
+  {
+    QMutexLocker l(&mutex_embedded_cover_locations_);
+    const QHash<QString, EmbeddedCoverLocation>::const_iterator it = embedded_cover_locations_.constFind(filename);
+    if (it != embedded_cover_locations_.constEnd() && it->size == size && it->mtime == mtime) {
+      location = *it;
+      cached = true;
+    }
+  }
+
+  if (cached && location.length == 0) {
+    data.clear();
+    return true;
+  }
+
+  QFile file(filename);
+  if (!file.open(QIODevice::ReadOnly)) {
+    return false;
+  }
+
+  if (!cached) {
+    if (!ProbeEmbeddedCover(file, &location)) {
+      return false;
+    }
+    location.size = size;
+    location.mtime = mtime;
+  }
+
+  data = ReadAt(file, location.offset, location.length);
+  if (data.size() != location.length) {
+    data.clear();
+    ForgetEmbeddedCoverLocation(filename);
+    return false;
+  }
+
+  if (!cached) {
+    CacheEmbeddedCoverLocation(filename, location);
+  }
+
+  return true;
+
+}
+
+bool TagReaderTagLib::ProbeEmbeddedCover(QFile &file, EmbeddedCoverLocation *location) {
+
+  const QByteArray header = ReadAt(file, 0, 10);
+  if (header.size() != 10) return false;
+
+  bool found = false;
+  if (header.startsWith("ID3")) {
+    // FLAC files can have an ID3v2 tag in front, the pictures are still read from the FLAC metadata blocks.
+    const qint64 tag_end = 10 + ReadSyncSafe32(header, 6) + ((header[5] & 0x10) ? 10 : 0);
+    if (ReadAt(file, tag_end, 4) == "fLaC") {
+      found = ProbeFLACCover(file, tag_end, location);
+    }
+    else {
+      found = ProbeID3v2Cover(file, header, location);
+    }
+  }
+  else if (header.startsWith("fLaC")) {
+    found = ProbeFLACCover(file, 0, location);
+  }
+  else if (header.mid(4, 4) == "ftyp") {
+    found = ProbeMP4Cover(file, location);
+  }
+
+  // Leave anything that doesn't look like an image to TagLib.
+  return found && location->length > 0 && location->offset + location->length <= file.size() && IsImageData(ReadAt(file, location->offset, 12));
+
+}
+
+bool TagReaderTagLib::ProbeID3v2Cover(QFile &file, const QByteArray &header, EmbeddedCoverLocation *location) {
+
+  const char version = header[3];
+  const char flags = header[5];
+
+  // ID3v2.2 frames and unsynchronised tags are left to TagLib.
+  if ((version != 3 && version != 4) || (flags & 0x80)) return false;
+
+  const qint64 tag_end = 10 + ReadSyncSafe32(header, 6);
+  qint64 pos = 10;
+  if (flags & 0x40) {
+    const QByteArray extended_header = ReadAt(file, pos, 4);
+    if (extended_header.size() != 4) return false;
+    pos += version == 4 ? ReadSyncSafe32(extended_header, 0) : 4 + ReadBigEndian32(extended_header, 0);
+  }
+
+  while (pos + 10 <= tag_end) {
+    const QByteArray frame_header = ReadAt(file, pos, 10);
+    if (frame_header.size() != 10 || frame_header[0] == '\0') return false;
+
+    const qint64 frame_size = version == 4 ? ReadSyncSafe32(frame_header, 4) : ReadBigEndian32(frame_header, 4);
+    const qint64 frame_start = pos + 10;
+    const qint64 frame_end = frame_start + frame_size;
+    if (frame_end > tag_end) return false;
+
+    if (frame_header.startsWith(kID3v2_CoverArt)) {
+      const char frame_flags = frame_header[9];
+      qint64 body_start = frame_start;
+      if (version == 4) {
+        // Compressed, encrypted or unsynchronised frame
+        if (frame_flags & 0x0E) return false;
+        if (frame_flags & 0x40) body_start += 1;
+        if (frame_flags & 0x01) body_start += 4;
+      }
+      else {
+        if (frame_flags & 0xC0) return false;
+        if (frame_flags & 0x20) body_start += 1;
+      }
+
+      // Text encoding, MIME type, picture type and description come before the picture data.
+      const QByteArray body = ReadAt(file, body_start, qMin(frame_end - body_start, kMaxID3v2PictureHeaderSize));
+      if (body.size() < 4) return false;
+      const char encoding = body[0];
+      qsizetype i = body.indexOf('\0', 1);
+      if (i < 0) return false;
+      i += 2;
+      if (encoding == 1 || encoding == 2) {
+        while (i + 1 < body.size() && (body[i] != '\0' || body[i + 1] != '\0')) i += 2;
+        if (i + 1 >= body.size()) return false;
+        i += 2;
+      }
+      else {
+        i = body.indexOf('\0', i);
+        if (i < 0) return false;
+        i += 1;
+      }
+
+      location->offset = body_start + i;
+      location->length = frame_end - location->offset;
+      return true;
+    }
+
+    pos = frame_end;
+  }
+
+  return false;
+
+}
+
+bool TagReaderTagLib::ProbeFLACCover(QFile &file, const qint64 start, EmbeddedCoverLocation *location) {
+
+  // Same choice as LoadEmbeddedCover(): the first front cover, otherwise the last picture of type other.
+  EmbeddedCoverLocation location_other;
+  qint64 pos = start + 4;
+  bool last_block = false;
+  while (!last_block) {
+    const QByteArray block_header = ReadAt(file, pos, 4);
+    if (block_header.size() != 4) return false;
+    last_block = block_header[0] & 0x80;
+    const int block_type = block_header[0] & 0x7F;
+    const qint64 block_start = pos + 4;
+    const qint64 block_end = block_start + (ReadBigEndian32(block_header, 0) & 0xFFFFFF);
+
+    if (block_type == kFLAC_MetadataBlockPicture) {
+      const QByteArray picture_header = ReadAt(file, block_start, 8);
+      if (picture_header.size() != 8) return false;
+      const quint32 picture_type = ReadBigEndian32(picture_header, 0);
+      const qint64 description_pos = block_start + 8 + ReadBigEndian32(picture_header, 4);
+      const QByteArray description_size = ReadAt(file, description_pos, 4);
+      if (description_size.size() != 4) return false;
+      // Description, width, height, depth and number of colors
+      const QByteArray data_size = ReadAt(file, description_pos + 4 + ReadBigEndian32(description_size, 0) + 16, 4);
+      if (data_size.size() != 4) return false;
+      const qint64 data_start = file.pos();
+      const qint64 data_length = ReadBigEndian32(data_size, 0);
+      if (data_start + data_length > block_end) return false;
+
+      if (data_length > 0) {
+        if (picture_type == kFLAC_PictureTypeFrontCover) {
+          location->offset = data_start;
+          location->length = data_length;
+          return true;
+        }
+        if (picture_type == kFLAC_PictureTypeOther) {
+          location_other.offset = data_start;
+          location_other.length = data_length;
+        }
+      }
+    }
+
+    pos = block_end;
+  }
+
+  if (location_other.length > 0) {
+    location->offset = location_other.offset;
+    location->length = location_other.length;
+    return true;
+  }
+
+  return false;
+
+}
+
+bool TagReaderTagLib::ProbeMP4Cover(QFile &file, EmbeddedCoverLocation *location) {
+
+  qint64 moov_start = 0, moov_end = 0, udta_start = 0, udta_end = 0, meta_start = 0, meta_end = 0, ilst_start = 0, ilst_end = 0, covr_start = 0, covr_end = 0, data_start = 0, data_end = 0;
+  if (!FindMP4Atom(file, 0, file.size(), "moov", &moov_start, &moov_end) ||
+      !FindMP4Atom(file, moov_start, moov_end, "udta", &udta_start, &udta_end) ||
+      !FindMP4Atom(file, udta_start, udta_end, "meta", &meta_start, &meta_end) ||
+      // The meta atom has 4 bytes of version and flags before its children
+      !FindMP4Atom(file, meta_start + 4, meta_end, "ilst", &ilst_start, &ilst_end) ||
+      !FindMP4Atom(file, ilst_start, ilst_end, kMP4_CoverArt, &covr_start, &covr_end) ||
+      !FindMP4Atom(file, covr_start, covr_end, "data", &data_start, &data_end)) {
+    return false;
+  }
+
+  // Like LoadEmbeddedCover(), take the first one, after the 4 bytes of type and 4 bytes of locale.
+  location->offset = data_start + 8;
+  location->length = data_end - location->offset;
+
+  return location->length > 0;
+
+}
+
+void TagReaderTagLib::CacheEmbeddedCoverLocation(const QString &filename, const EmbeddedCoverLocation &location) const {
+
+  QMutexLocker l(&mutex_embedded_cover_locations_);
+  if (embedded_cover_locations_.count() >= kMaxEmbeddedCoverLocations) {
+    embedded_cover_locations_.clear();
+  }
+  embedded_cover_locations_.insert(filename, location);
+
+}
+
+void TagReaderTagLib::ForgetEmbeddedCoverLocation(const QString &filename) const {
+
+  QMutexLocker l(&mutex_embedded_cover_locations_);
+  embedded_cover_locations_.remove(filename);
+
+}
+
 void TagReaderTagLib::SetEmbeddedCover(TagLib::FLAC::File *flac_file, TagLib::Ogg::XiphComment *vorbis_comment, const QByteArray &data, const QString &mimetype) const {
 
   (void)vorbis_comment;
@@ -1772,6 +2143,8 @@ TagReaderResult TagReaderTagLib::SaveEmbeddedCover(const QString &filename, cons
     return TagReaderResult::ErrorCode::FileDoesNotExist;
   }
 
+  ForgetEmbeddedCoverLocation(filename);
+
   ScopedPtr<TagLib::FileRef> fileref(factory_->GetFileRef(filename));
   if (!fileref || fileref->isNull()) {
     qLog(Error) << "TagLib could not open file" << filename;
@@ -1926,6 +2299,8 @@ TagReaderResult TagReaderTagLib::SaveSongPlaycount(const QString &filename, cons
     return TagReaderResult::ErrorCode::FileDoesNotExist;
   }
 
+  ForgetEmbeddedCoverLocation(filename);
+
   ScopedPtr<TagLib::FileRef> fileref(factory_->GetFileRef(filename));
   if (!fileref || fileref->isNull()) {
     qLog(Error) << "TagLib could not open file" << filename;
@@ -2052,6 +2427,8 @@ TagReaderResult TagReaderTagLib::SaveSongRating(const QString &filename, const f
     return TagReaderResult::ErrorCode::FileDoesNotExist;
   }
 
+  ForgetEmbeddedCoverLocation(filename);
+
   if (rating < 0) {
     return TagReaderResult::ErrorCode::Success;
   }
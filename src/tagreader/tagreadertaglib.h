@@ -23,8 +23,11 @@
 
 #include "config.h"
 
+#include <QtGlobal>
 #include <QByteArray>
 #include <QString>
+#include <QHash>
+#include <QMutex>
 
 #include <taglib/tstring.h>
 #include <taglib/fileref.h>
@@ -51,6 +54,7 @@
 #undef TStringToQString
 #undef QStringToTString
 
+class QFile;
 class FileRefFactory;
 
 class TagReaderTagLib : public TagReaderBase {
@@ -68,7 +72,7 @@ class TagReaderTagLib : public TagReaderBase {
 
   TagReaderResult IsMediaFile(const QString &filename) const override;
 
-  TagReaderResult ReadFile(const QString &filename, Song *song) const override;
+  TagReaderResult ReadFile(const QString &filename, Song *song, const TagReaderReadProfile read_profile) const override;
 #ifdef HAVE_STREAMTAGREADER
   TagReaderResult ReadStream(const QUrl &url, const QString &filename, const quint64 size, const quint64 mtime, const QString &token_type, const QString &access_token, Song *song) const override;
 #endif
@@ -106,6 +110,26 @@ class TagReaderTagLib : public TagReaderBase {
   QByteArray LoadEmbeddedCover(TagLib::ID3v2::Tag *tag) const;
   QByteArray LoadEmbeddedCover(TagLib::APE::Tag *tag) const;
 
+  // Position of the raw cover image data in a file, for the file size and modification time it was found at.
+  // A length of 0 means the file has no cover.
+  struct EmbeddedCoverLocation {
+    EmbeddedCoverLocation() : offset(0), length(0), size(0), mtime(0) {}
+    qint64 offset;
+    qint64 length;
+    qint64 size;
+    qint64 mtime;
+  };
+
+  // Reads the cover directly from the APIC frame, FLAC picture block or covr atom without parsing the tags with TagLib.
+  // Returns false when the file should be read with TagLib instead.
+  bool LoadEmbeddedCoverFast(const QString &filename, QByteArray &data) const;
+  static bool ProbeEmbeddedCover(QFile &file, EmbeddedCoverLocation *location);
+  static bool ProbeID3v2Cover(QFile &file, const QByteArray &header, EmbeddedCoverLocation *location);
+  static bool ProbeFLACCover(QFile &file, const qint64 start, EmbeddedCoverLocation *location);
+  static bool ProbeMP4Cover(QFile &file, EmbeddedCoverLocation *location);
+  void CacheEmbeddedCoverLocation(const QString &filename, const EmbeddedCoverLocation &location) const;
+  void ForgetEmbeddedCoverLocation(const QString &filename) const;
+
   static TagLib::ID3v2::PopularimeterFrame *GetPOPMFrameFromTag(TagLib::ID3v2::Tag *tag);
 
   void SetPlaycount(TagLib::Ogg::XiphComment *vorbis_comment, const uint playcount) const;
@@ -130,6 +154,9 @@ class TagReaderTagLib : public TagReaderBase {
  private:
   FileRefFactory *factory_;
 
+  mutable QMutex mutex_embedded_cover_locations_;
+  mutable QHash<QString, EmbeddedCoverLocation> embedded_cover_locations_;
+
   Q_DISABLE_COPY(TagReaderTagLib)
 };
 
@@ -0,0 +1,169 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "config.h"
+
+#include <cstdio>
+
+#include <QtGlobal>
+#include <QByteArray>
+#include <QString>
+#include <QDataStream>
+#include <QDeadlineTimer>
+#include <QLocalServer>
+#include <QLocalSocket>
+
+#include "core/logging.h"
+#include "core/song.h"
+#include "tagreaderworker.h"
+#include "tagreadertaglib.h"
+#include "tagreadergme.h"
+#include "tagreaderresult.h"
+#include "tagreaderreadprofile.h"
+
+namespace {
+// The worker exits when it has been idle for this long, it is started again for the next request.
+// This also makes sure workers left behind by a crashed Strawberry don't keep running.
+constexpr int kIdleTimeoutMsec = 60000;
+constexpr int kSocketTimeoutMsec = 5000;
+constexpr quint32 kMaxMessageSize = 256 * 1024 * 1024;
+}  // namespace
+
+int TagReaderWorker::Run(const QString &server_name) {
+
+  QLocalServer server;
+  server.setSocketOptions(QLocalServer::UserAccessOption);
+  if (!server.listen(server_name)) {
+    qLog(Error) << "Tag reader worker could not listen on" << server_name << server.errorString();
+    return 1;
+  }
+
+  const TagReaderTagLib tagreader;
+  const TagReaderGME gmereader;
+
+  std::fputs(kReadyMessage, stdout);
+  std::fflush(stdout);
+
+  while (server.waitForNewConnection(kIdleTimeoutMsec)) {
+    QLocalSocket *socket = server.nextPendingConnection();
+    if (!socket) continue;
+    QByteArray request;
+    if (ReadMessage(socket, &request, kSocketTimeoutMsec)) {
+      WriteMessage(socket, ProcessRequest(tagreader, gmereader, request), kSocketTimeoutMsec);
+    }
+    socket->disconnectFromServer();
+    if (socket->state() != QLocalSocket::UnconnectedState) {
+      socket->waitForDisconnected(kSocketTimeoutMsec);
+    }
+    delete socket;
+  }
+
+  return 0;
+
+}
+
+QByteArray TagReaderWorker::ProcessRequest(const TagReaderTagLib &tagreader, const TagReaderGME &gmereader, const QByteArray &request) {
+
+  QDataStream in(request);
+  quint8 request_type = 0;
+  QString filename;
+  in >> request_type >> filename;
+
+  QByteArray reply;
+  QDataStream out(&reply, QIODevice::WriteOnly);
+
+  TagReaderResult result;
+  switch (static_cast<RequestType>(request_type)) {
+    case RequestType::IsMediaFile:{
+      result = tagreader.IsMediaFile(filename);
+      if (result.error_code == TagReaderResult::ErrorCode::FileOpenError || result.error_code == TagReaderResult::ErrorCode::Unsupported) {
+        result = gmereader.IsMediaFile(filename);
+      }
+      out << static_cast<qint32>(result.error_code) << result.error_text;
+      break;
+    }
+    case RequestType::ReadFile:{
+      qint32 read_profile = 0;
+      Song song;
+      in >> read_profile;
+      song.InitFromDataStream(&in);
+      result = tagreader.ReadFile(filename, &song, static_cast<TagReaderReadProfile>(read_profile));
+      if (result.error_code == TagReaderResult::ErrorCode::FileOpenError || result.error_code == TagReaderResult::ErrorCode::Unsupported) {
+        result = gmereader.ReadFile(filename, &song, static_cast<TagReaderReadProfile>(read_profile));
+      }
+      out << static_cast<qint32>(result.error_code) << result.error_text;
+      song.ToDataStream(&out);
+      break;
+    }
+    case RequestType::LoadEmbeddedCover:{
+      QByteArray data;
+      result = tagreader.LoadEmbeddedCover(filename, data);
+      out << static_cast<qint32>(result.error_code) << result.error_text << data;
+      break;
+    }
+    default:
+      out << static_cast<qint32>(TagReaderResult::ErrorCode::Unsupported) << QString();
+      break;
+  }
+
+  return reply;
+
+}
+
+bool TagReaderWorker::WriteMessage(QLocalSocket *socket, const QByteArray &message, const int timeout_msec) {
+
+  QByteArray data;
+  QDataStream s(&data, QIODevice::WriteOnly);
+  s << static_cast<quint32>(message.size());
+  data.append(message);
+
+  if (socket->write(data) != data.size()) return false;
+
+  const QDeadlineTimer deadline(timeout_msec);
+  while (socket->bytesToWrite() > 0) {
+    if (deadline.hasExpired() || !socket->waitForBytesWritten(static_cast<int>(deadline.remainingTime()))) return false;
+  }
+
+  return true;
+
+}
+
+bool TagReaderWorker::ReadMessage(QLocalSocket *socket, QByteArray *message, const int timeout_msec) {
+
+  const QDeadlineTimer deadline(timeout_msec);
+
+  const auto wait_for_bytes = [socket, &deadline](const qint64 bytes) {
+    while (socket->bytesAvailable() < bytes) {
+      if (deadline.hasExpired() || !socket->waitForReadyRead(static_cast<int>(deadline.remainingTime()))) return false;
+    }
+    return true;
+  };
+
+  if (!wait_for_bytes(sizeof(quint32))) return false;
+
+  quint32 size = 0;
+  QDataStream s(socket->read(sizeof(quint32)));
+  s >> size;
+  if (size > kMaxMessageSize || !wait_for_bytes(size)) return false;
+
+  *message = socket->read(size);
+
+  return true;
+
+}
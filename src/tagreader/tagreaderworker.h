@@ -0,0 +1,57 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef TAGREADERWORKER_H
+#define TAGREADERWORKER_H
+
+#include "config.h"
+
+#include <QtGlobal>
+#include <QByteArray>
+#include <QString>
+
+class QLocalSocket;
+class TagReaderTagLib;
+class TagReaderGME;
+
+// Tag reader worker process, started by TagReaderWorkerPool by running Strawberry with kCommandLineOption and the name of the local server to listen on.
+// Each connection carries a single request and its reply, so a worker reads one file at a time.
+class TagReaderWorker {
+ public:
+  static constexpr char kCommandLineOption[] = "--tagreader-worker";
+  // Written to standard output once the worker is listening.
+  static constexpr char kReadyMessage[] = "ready\n";
+
+  enum class RequestType : quint8 {
+    IsMediaFile = 1,
+    ReadFile = 2,
+    LoadEmbeddedCover = 3
+  };
+
+  static int Run(const QString &server_name);
+
+  // Messages are prefixed with their size.
+  static bool WriteMessage(QLocalSocket *socket, const QByteArray &message, const int timeout_msec);
+  static bool ReadMessage(QLocalSocket *socket, QByteArray *message, const int timeout_msec);
+
+ private:
+  static QByteArray ProcessRequest(const TagReaderTagLib &tagreader, const TagReaderGME &gmereader, const QByteArray &request);
+};
+
+#endif  // TAGREADERWORKER_H
@@ -0,0 +1,337 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "config.h"
+
+#include <utility>
+
+#include <QtGlobal>
+#include <QObject>
+#include <QCoreApplication>
+#include <QThread>
+#include <QList>
+#include <QByteArray>
+#include <QString>
+#include <QStringList>
+#include <QDataStream>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QProcess>
+#include <QLocalSocket>
+#include <QTimer>
+
+#include "core/logging.h"
+#include "core/song.h"
+#include "tagreaderworkerpool.h"
+#include "tagreaderworker.h"
+#include "tagreaderresult.h"
+#include "tagreaderreadprofile.h"
+
+using namespace Qt::Literals::StringLiterals;
+
+namespace {
+constexpr int kStartTimeoutMsec = 10000;
+constexpr int kConnectTimeoutMsec = 5000;
+// A file taking longer than this to read is assumed to hang the worker.
+constexpr int kRequestTimeoutMsec = 30000;
+// Give up on worker processes after this many failed starts in a row, and read in this process.
+constexpr int kMaxStartFailures = 3;
+}  // namespace
+
+TagReaderWorkerPool::TagReaderWorkerPool(const int workers, QObject *parent)
+    : QObject(parent),
+      start_failures_(0),
+      disabled_(false),
+      exiting_(false) {
+
+  workers_.resize(qMax(1, workers));
+
+}
+
+bool TagReaderWorkerPool::IsMediaFile(const QString &filename, TagReaderResult *result) {
+
+  QByteArray request;
+  QDataStream out(&request, QIODevice::WriteOnly);
+  out << static_cast<quint8>(TagReaderWorker::RequestType::IsMediaFile) << filename;
+
+  QByteArray reply;
+  if (!Request(filename, request, &reply, result)) return false;
+
+  if (!reply.isEmpty()) {
+    QDataStream in(reply);
+    qint32 error_code = 0;
+    in >> error_code >> result->error_text;
+    result->error_code = static_cast<TagReaderResult::ErrorCode>(error_code);
+  }
+
+  return true;
+
+}
+
+bool TagReaderWorkerPool::ReadFile(const QString &filename, Song *song, const TagReaderReadProfile read_profile, TagReaderResult *result) {
+
+  QByteArray request;
+  QDataStream out(&request, QIODevice::WriteOnly);
+  out << static_cast<quint8>(TagReaderWorker::RequestType::ReadFile) << filename << static_cast<qint32>(read_profile);
+  song->ToDataStream(&out);
+
+  QByteArray reply;
+  if (!Request(filename, request, &reply, result)) return false;
+
+  if (!reply.isEmpty()) {
+    QDataStream in(reply);
+    qint32 error_code = 0;
+    in >> error_code >> result->error_text;
+    result->error_code = static_cast<TagReaderResult::ErrorCode>(error_code);
+    song->InitFromDataStream(&in);
+  }
+
+  return true;
+
+}
+
+bool TagReaderWorkerPool::LoadEmbeddedCover(const QString &filename, QByteArray *data, TagReaderResult *result) {
+
+  QByteArray request;
+  QDataStream out(&request, QIODevice::WriteOnly);
+  out << static_cast<quint8>(TagReaderWorker::RequestType::LoadEmbeddedCover) << filename;
+
+  QByteArray reply;
+  if (!Request(filename, request, &reply, result)) return false;
+
+  if (!reply.isEmpty()) {
+    QDataStream in(reply);
+    qint32 error_code = 0;
+    in >> error_code >> result->error_text >> *data;
+    result->error_code = static_cast<TagReaderResult::ErrorCode>(error_code);
+  }
+
+  return true;
+
+}
+
+bool TagReaderWorkerPool::Request(const QString &filename, const QByteArray &request, QByteArray *reply, TagReaderResult *result) {
+
+  Q_ASSERT(QThread::currentThread() != thread());
+
+  // A worker might exit because it was idle just as it is picked, so try another one if connecting fails.
+  for (int attempt = 0; attempt < 2; ++attempt) {
+    QString server_name;
+    const qsizetype index = AcquireWorker(&server_name);
+    if (index == -1) return false;
+
+    QLocalSocket socket;
+    socket.connectToServer(server_name);
+    if (!socket.waitForConnected(kConnectTimeoutMsec)) {
+      ReleaseWorker(index, false);
+      continue;
+    }
+
+    if (!TagReaderWorker::WriteMessage(&socket, request, kConnectTimeoutMsec) || !TagReaderWorker::ReadMessage(&socket, reply, kRequestTimeoutMsec)) {
+      qLog(Error) << "Tag reader worker crashed or timed out reading" << filename;
+      ReleaseWorker(index, false);
+      *result = TagReaderResult(TagReaderResult::ErrorCode::FileParseError, QObject::tr("Tag reader crashed or timed out reading %1").arg(filename));
+      reply->clear();
+      return true;
+    }
+
+    socket.disconnectFromServer();
+    ReleaseWorker(index, true);
+
+    return true;
+  }
+
+  return false;
+
+}
+
+qsizetype TagReaderWorkerPool::AcquireWorker(QString *server_name) {
+
+  QMutexLocker l(&mutex_);
+
+  while (!disabled_ && !exiting_) {
+    for (qsizetype i = 0; i < workers_.count(); ++i) {
+      if (workers_[i].state == State::Idle) {
+        workers_[i].state = State::Busy;
+        *server_name = workers_[i].server_name;
+        return i;
+      }
+    }
+    for (qsizetype i = 0; i < workers_.count(); ++i) {
+      if (workers_[i].state == State::Stopped) {
+        workers_[i].state = State::Starting;
+        QMetaObject::invokeMethod(this, [this, i]() { StartWorker(i); }, Qt::QueuedConnection);
+        break;
+      }
+    }
+    // Workers that are starting or busy always end up idle or stopped because of the timeouts.
+    condition_.wait(&mutex_);
+  }
+
+  return -1;
+
+}
+
+void TagReaderWorkerPool::ReleaseWorker(const qsizetype index, const bool success) {
+
+  QMutexLocker l(&mutex_);
+
+  Worker &worker = workers_[index];
+  if (!worker.running) {
+    worker.state = State::Stopped;
+  }
+  else if (success) {
+    worker.state = State::Idle;
+  }
+  else {
+    worker.state = State::Stopping;
+    QMetaObject::invokeMethod(this, [this, index]() { KillWorker(index); }, Qt::QueuedConnection);
+  }
+
+  condition_.wakeAll();
+
+}
+
+void TagReaderWorkerPool::StartWorker(const qsizetype index) {
+
+  QMutexLocker l(&mutex_);
+
+  Worker &worker = workers_[index];
+  if (exiting_) {
+    worker.state = State::Stopped;
+    condition_.wakeAll();
+    return;
+  }
+
+  const int generation = ++worker.generation;
+  worker.server_name = u"strawberry-tagreader-%1-%2-%3"_s.arg(QCoreApplication::applicationPid()).arg(index).arg(generation);
+  worker.running = true;
+  worker.process = new QProcess(this);
+  worker.process->setProcessChannelMode(QProcess::ForwardedErrorChannel);
+  QObject::connect(worker.process, &QProcess::readyReadStandardOutput, this, [this, index, generation]() { ProcessReadyRead(index, generation); });
+  QObject::connect(worker.process, &QProcess::errorOccurred, this, [this, index, generation](const QProcess::ProcessError error) { ProcessError(index, generation, error); });
+  QObject::connect(worker.process, &QProcess::finished, this, [this, index, generation]() { ProcessFinished(index, generation); });
+
+  QProcess *process = worker.process;
+  const QStringList arguments = QStringList() << QString::fromLatin1(TagReaderWorker::kCommandLineOption) << worker.server_name;
+  l.unlock();
+
+  qLog(Debug) << "Starting tag reader worker" << index;
+
+  process->start(QCoreApplication::applicationFilePath(), arguments);
+
+  QTimer::singleShot(kStartTimeoutMsec, this, [this, index, generation]() { StartTimeout(index, generation); });
+
+}
+
+void TagReaderWorkerPool::KillWorker(const qsizetype index) {
+
+  QMutexLocker l(&mutex_);
+  QProcess *process = workers_[index].process;
+  l.unlock();
+
+  if (process) {
+    qLog(Warning) << "Killing tag reader worker" << index;
+    process->kill();
+  }
+
+}
+
+void TagReaderWorkerPool::StartTimeout(const qsizetype index, const int generation) {
+
+  QMutexLocker l(&mutex_);
+  const bool timeout = workers_[index].generation == generation && workers_[index].state == State::Starting;
+  l.unlock();
+
+  if (timeout) {
+    qLog(Error) << "Tag reader worker" << index << "did not start in time";
+    KillWorker(index);
+  }
+
+}
+
+void TagReaderWorkerPool::ProcessReadyRead(const qsizetype index, const int generation) {
+
+  QMutexLocker l(&mutex_);
+
+  Worker &worker = workers_[index];
+  if (worker.generation != generation || !worker.process) return;
+
+  if (worker.process->readAllStandardOutput().contains(TagReaderWorker::kReadyMessage) && worker.state == State::Starting) {
+    worker.state = State::Idle;
+    start_failures_ = 0;
+    condition_.wakeAll();
+  }
+
+}
+
+void TagReaderWorkerPool::ProcessError(const qsizetype index, const int generation, const QProcess::ProcessError error) {
+
+  // The finished signal is not emitted when the process could not be started.
+  if (error == QProcess::FailedToStart) {
+    ProcessFinished(index, generation);
+  }
+
+}
+
+void TagReaderWorkerPool::ProcessFinished(const qsizetype index, const int generation) {
+
+  QMutexLocker l(&mutex_);
+
+  Worker &worker = workers_[index];
+  if (worker.generation != generation || !worker.process) return;
+
+  worker.process->deleteLater();
+  worker.process = nullptr;
+  worker.running = false;
+
+  if (worker.state == State::Starting && ++start_failures_ >= kMaxStartFailures) {
+    qLog(Error) << "Could not start tag reader workers, reading tags in process";
+    disabled_ = true;
+  }
+
+  // The thread with a request in progress sets the state when it notices.
+  if (worker.state != State::Busy) {
+    worker.state = State::Stopped;
+  }
+
+  condition_.wakeAll();
+
+}
+
+void TagReaderWorkerPool::Exit() {
+
+  Q_ASSERT(QThread::currentThread() == thread());
+
+  QList<QProcess*> processes;
+  {
+    QMutexLocker l(&mutex_);
+    exiting_ = true;
+    for (const Worker &worker : std::as_const(workers_)) {
+      if (worker.process) processes << worker.process;
+    }
+    condition_.wakeAll();
+  }
+
+  for (QProcess *process : std::as_const(processes)) {
+    process->kill();
+    process->waitForFinished(kConnectTimeoutMsec);
+  }
+
+}
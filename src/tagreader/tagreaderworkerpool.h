@@ -0,0 +1,96 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef TAGREADERWORKERPOOL_H
+#define TAGREADERWORKERPOOL_H
+
+#include "config.h"
+
+#include <QtGlobal>
+#include <QObject>
+#include <QList>
+#include <QByteArray>
+#include <QString>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QProcess>
+
+#include "tagreaderresult.h"
+#include "tagreaderreadprofile.h"
+
+class Song;
+
+// Reads tags in worker processes, so a file that crashes or hangs TagLib does not take Strawberry down with it.
+// Workers are started when needed, and killed and started again when they don't reply in time.
+// The pool lives in the tag reader thread, requests are blocking and made from any other thread.
+class TagReaderWorkerPool : public QObject {
+  Q_OBJECT
+
+ public:
+  explicit TagReaderWorkerPool(const int workers, QObject *parent = nullptr);
+
+  // These return false if no worker could be started, the request should then be processed in this process.
+  bool IsMediaFile(const QString &filename, TagReaderResult *result);
+  bool ReadFile(const QString &filename, Song *song, const TagReaderReadProfile read_profile, TagReaderResult *result);
+  bool LoadEmbeddedCover(const QString &filename, QByteArray *data, TagReaderResult *result);
+
+  void Exit();
+
+ private:
+  enum class State {
+    Stopped,
+    Starting,
+    Idle,
+    Busy,
+    Stopping
+  };
+
+  struct Worker {
+    Worker() : process(nullptr), state(State::Stopped), running(false), generation(0) {}
+    QProcess *process;
+    QString server_name;
+    State state;
+    bool running;
+    int generation;
+  };
+
+  bool Request(const QString &filename, const QByteArray &request, QByteArray *reply, TagReaderResult *result);
+  qsizetype AcquireWorker(QString *server_name);
+  void ReleaseWorker(const qsizetype index, const bool success);
+
+  void StartWorker(const qsizetype index);
+  void KillWorker(const qsizetype index);
+  void StartTimeout(const qsizetype index, const int generation);
+
+ private Q_SLOTS:
+  void ProcessReadyRead(const qsizetype index, const int generation);
+  void ProcessError(const qsizetype index, const int generation, const QProcess::ProcessError error);
+  void ProcessFinished(const qsizetype index, const int generation);
+
+ private:
+  // Locks the state of the workers, the processes are only accessed from the tag reader thread.
+  QMutex mutex_;
+  QWaitCondition condition_;
+  QList<Worker> workers_;
+  int start_failures_;
+  bool disabled_;
+  bool exiting_;
+};
+
+#endif  // TAGREADERWORKERPOOL_H
@@ -0,0 +1,76 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <QtGlobal>
+#include <QString>
+#include <QMap>
+#include <QMutex>
+#include <QMutexLocker>
+
+#include "tagreaderwritefilesreply.h"
+
+TagReaderWriteFilesReply::TagReaderWriteFilesReply(const QString &_filename, QObject *parent)
+    : TagReaderReply(_filename, parent),
+      pending_(0) {}
+
+void TagReaderWriteFilesReply::FileFinished(const QString &filename, const Song &song, const TagReaderResult &result) {
+
+  {
+    QMutexLocker l(&mutex_);
+    results_.insert(filename, result);
+    if (result.success()) {
+      songs_.insert(filename, song);
+    }
+    if (--pending_ > 0) return;
+  }
+
+  Finish();
+
+}
+
+void TagReaderWriteFilesReply::Finish() {
+
+  {
+    QMutexLocker l(&mutex_);
+    result_ = TagReaderResult::ErrorCode::Success;
+    for (QMap<QString, TagReaderResult>::const_iterator it = results_.constBegin(); it != results_.constEnd(); ++it) {
+      if (!it.value().success()) {
+        result_ = it.value();
+        break;
+      }
+    }
+  }
+
+  TagReaderReply::Finish();
+
+}
+
+QMap<QString, Song> TagReaderWriteFilesReply::songs() const {
+
+  QMutexLocker l(&mutex_);
+  return songs_;
+
+}
+
+QMap<QString, TagReaderResult> TagReaderWriteFilesReply::results() const {
+
+  QMutexLocker l(&mutex_);
+  return results_;
+
+}
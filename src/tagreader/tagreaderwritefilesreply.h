@@ -0,0 +1,60 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef TAGREADERWRITEFILESREPLY_H
+#define TAGREADERWRITEFILESREPLY_H
+
+#include <QtGlobal>
+#include <QString>
+#include <QMap>
+#include <QMutex>
+#include <QSharedPointer>
+
+#include "core/song.h"
+#include "tagreaderreply.h"
+#include "tagreaderresult.h"
+
+// Reply for a batch of files written in parallel, finished when all files are written.
+class TagReaderWriteFilesReply : public TagReaderReply {
+  Q_OBJECT
+
+ public:
+  explicit TagReaderWriteFilesReply(const QString &_filename, QObject *parent = nullptr);
+
+  void set_pending(const qsizetype pending) { pending_ = pending; }
+
+  // Called from the tagreader threads when a file is done.
+  void FileFinished(const QString &filename, const Song &song, const TagReaderResult &result);
+
+  void Finish() override;
+
+  // The songs of the files that were written, with the file size and modification time after writing.
+  QMap<QString, Song> songs() const;
+  QMap<QString, TagReaderResult> results() const;
+
+ private:
+  mutable QMutex mutex_;
+  qsizetype pending_;
+  QMap<QString, Song> songs_;
+  QMap<QString, TagReaderResult> results_;
+};
+
+using TagReaderWriteFilesReplyPtr = QSharedPointer<TagReaderWriteFilesReply>;
+
+#endif  // TAGREADERWRITEFILESREPLY_H
@@ -72,7 +72,10 @@ QNetworkReply *TidalBaseRequest::CreateRequest(const QString &ressource_name, co
 
   const ParamList params = ParamList() << params_provided
                                        << Param(u"countryCode"_s, service_->country_code());
-  return CreateGetRequest(QUrl(QLatin1String(TidalService::kApiUrl) + QLatin1Char('/') + ressource_name), params);
+  QNetworkReply *reply = CreateGetRequest(QUrl(QLatin1String(TidalService::kApiUrl) + QLatin1Char('/') + ressource_name), params);
+  service_->request_limiter()->Monitor(reply, this);
+
+  return reply;
 
 }
 
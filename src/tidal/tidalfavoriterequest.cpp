@@ -19,6 +19,7 @@
 
 #include "config.h"
 
+#include <QList>
 #include <QMultiMap>
 #include <QByteArray>
 #include <QString>
@@ -32,12 +33,18 @@
 #include "core/logging.h"
 #include "core/networkaccessmanager.h"
 #include "core/song.h"
+#include "streaming/streamingfavoritebatches.h"
 #include "tidalservice.h"
 #include "tidalbaserequest.h"
 #include "tidalfavoriterequest.h"
 
 using namespace Qt::Literals::StringLiterals;
 
+namespace {
+// The most ids sent in one request.
+constexpr int kMaxIdsPerRequest = 50;
+}  // namespace
+
 TidalFavoriteRequest::TidalFavoriteRequest(TidalService *service, const SharedPtr<NetworkAccessManager> network, QObject *parent)
     : TidalBaseRequest(service, network, parent),
       service_(service),
@@ -73,6 +80,35 @@ QString TidalFavoriteRequest::FavoriteMethod(const FavoriteType type) {
 
 }
 
+QString TidalFavoriteRequest::FavoriteId(const FavoriteType type, const Song &song) {
+
+  switch (type) {
+    case FavoriteType::Artists:
+      return song.artist_id();
+    case FavoriteType::Albums:
+      return song.album_id();
+    case FavoriteType::Songs:
+      return song.song_id();
+  }
+
+  return QString();
+
+}
+
+QList<StreamingFavoriteBatches::Chunk> TidalFavoriteRequest::FavoriteChunks(const FavoriteType type, const SongList &songs) {
+
+  QMultiMap<QString, Song> songs_map;
+  for (const Song &song : songs) {
+    const QString id = FavoriteId(type, song);
+    if (!id.isEmpty()) {
+      songs_map.insert(id, song);
+    }
+  }
+
+  return StreamingFavoriteBatches::Split(songs_map, kMaxIdsPerRequest);
+
+}
+
 void TidalFavoriteRequest::AddArtists(const SongList &songs) {
   AddFavorites(FavoriteType::Artists, songs);
 }
@@ -86,40 +122,22 @@ void TidalFavoriteRequest::AddSongs(const SongList &songs) {
 }
 
 void TidalFavoriteRequest::AddSongs(const SongMap &songs) {
-  AddFavoritesRequest(FavoriteType::Songs, songs.keys(), songs.values());
+  AddFavorites(FavoriteType::Songs, songs.values());
 }
 
 void TidalFavoriteRequest::AddFavorites(const FavoriteType type, const SongList &songs) {
 
-  QStringList id_list;
-  for (const Song &song : songs) {
-    QString id;
-    switch (type) {
-      case FavoriteType::Artists:
-        if (song.artist_id().isEmpty()) continue;
-        id = song.artist_id();
-        break;
-      case FavoriteType::Albums:
-        if (song.album_id().isEmpty()) continue;
-        id = song.album_id();
-        break;
-      case FavoriteType::Songs:
-        if (song.song_id().isEmpty()) continue;
-        id = song.song_id();
-        break;
-    }
-    if (!id.isEmpty() && !id_list.contains(id)) {
-      id_list << id;
-    }
-  }
-
-  if (id_list.isEmpty()) return;
+  const QList<StreamingFavoriteBatches::Chunk> chunks = FavoriteChunks(type, songs);
+  if (chunks.isEmpty()) return;
 
-  AddFavoritesRequest(type, id_list, songs);
+  const int batch_id = batches_.Start(static_cast<int>(chunks.count()));
+  for (const StreamingFavoriteBatches::Chunk &chunk : chunks) {
+    AddFavoritesRequest(type, batch_id, chunk.ids, chunk.songs);
+  }
 
 }
 
-void TidalFavoriteRequest::AddFavoritesRequest(const FavoriteType type, const QStringList &id_list, const SongList &songs) {
+void TidalFavoriteRequest::AddFavoritesRequest(const FavoriteType type, const int batch_id, const QStringList &id_list, const SongList &songs) {
 
   const ParamList params = ParamList() << Param(u"countryCode"_s, service_->country_code())
                                        << Param(FavoriteMethod(type), id_list.join(u','));
@@ -138,14 +156,14 @@ void TidalFavoriteRequest::AddFavoritesRequest(const FavoriteType type, const QS
   }
   const QByteArray query = url_query.toString(QUrl::FullyEncoded).toUtf8();
   QNetworkReply *reply = network_->post(network_request, query);
-  QObject::connect(reply, &QNetworkReply::finished, this, [this, reply, type, songs]() { AddFavoritesReply(reply, type, songs); });
+  QObject::connect(reply, &QNetworkReply::finished, this, [this, reply, type, batch_id, songs]() { AddFavoritesReply(reply, type, batch_id, songs); });
   replies_ << reply;
 
   qLog(Debug) << "Tidal: Sending request" << url << query;
 
 }
 
-void TidalFavoriteRequest::AddFavoritesReply(QNetworkReply *reply, const FavoriteType type, const SongList &songs) {
+void TidalFavoriteRequest::AddFavoritesReply(QNetworkReply *reply, const FavoriteType type, const int batch_id, const SongList &songs) {
 
   if (replies_.contains(reply)) {
     replies_.removeAll(reply);
@@ -159,20 +177,23 @@ void TidalFavoriteRequest::AddFavoritesReply(QNetworkReply *reply, const Favorit
   const JsonObjectResult json_object_result = ParseJsonObject(reply);
   if (!json_object_result.success()) {
     Error(json_object_result.error_message);
-    return;
   }
 
-  qLog(Debug) << "Tidal:" << songs.count() << "songs added to" << FavoriteText(type) << "favorites.";
+  // Emit once for all requests of the batch, so the collection is updated in one go.
+  SongList batch_songs;
+  if (!batches_.Finish(batch_id, json_object_result.success() ? songs : SongList(), batch_songs) || batch_songs.isEmpty()) return;
+
+  qLog(Debug) << "Tidal:" << batch_songs.count() << "songs added to" << FavoriteText(type) << "favorites.";
 
   switch (type) {
     case FavoriteType::Artists:
-      Q_EMIT ArtistsAdded(songs);
+      Q_EMIT ArtistsAdded(batch_songs);
       break;
     case FavoriteType::Albums:
-      Q_EMIT AlbumsAdded(songs);
+      Q_EMIT AlbumsAdded(batch_songs);
       break;
     case FavoriteType::Songs:
-      Q_EMIT SongsAdded(songs);
+      Q_EMIT SongsAdded(batch_songs);
       break;
   }
 
@@ -191,46 +212,22 @@ void TidalFavoriteRequest::RemoveSongs(const SongList &songs) {
 }
 
 void TidalFavoriteRequest::RemoveSongs(const SongMap &songs) {
-
-  const SongList songs_list = songs.values();
-  for (const Song &song : songs_list) {
-    RemoveFavoritesRequest(FavoriteType::Songs, song.song_id(), SongList() << song);
-  }
-
+  RemoveFavorites(FavoriteType::Songs, songs.values());
 }
 
 void TidalFavoriteRequest::RemoveFavorites(const FavoriteType type, const SongList &songs) {
 
-  QMultiMap<QString, Song> songs_map;
-  for (const Song &song : songs) {
-    QString id;
-    switch (type) {
-      case FavoriteType::Artists:
-        if (song.artist_id().isEmpty()) continue;
-        id = song.artist_id();
-        break;
-      case FavoriteType::Albums:
-        if (song.album_id().isEmpty()) continue;
-        id = song.album_id();
-        break;
-      case FavoriteType::Songs:
-        if (song.song_id().isEmpty()) continue;
-        id = song.song_id();
-        break;
-    }
-    if (!id.isEmpty()) {
-      songs_map.insert(id, song);
-    }
-  }
+  const QList<StreamingFavoriteBatches::Chunk> chunks = FavoriteChunks(type, songs);
+  if (chunks.isEmpty()) return;
 
-  const QStringList ids = songs_map.uniqueKeys();
-  for (const QString &id : ids) {
-    RemoveFavoritesRequest(type, id, songs_map.values(id));
+  const int batch_id = batches_.Start(static_cast<int>(chunks.count()));
+  for (const StreamingFavoriteBatches::Chunk &chunk : chunks) {
+    RemoveFavoritesRequest(type, batch_id, chunk.ids, chunk.songs);
   }
 
 }
 
-void TidalFavoriteRequest::RemoveFavoritesRequest(const FavoriteType type, const QString &id, const SongList &songs) {
+void TidalFavoriteRequest::RemoveFavoritesRequest(const FavoriteType type, const int batch_id, const QStringList &id_list, const SongList &songs) {
 
   const ParamList params = ParamList() << Param(u"countryCode"_s, service_->country_code());
 
@@ -239,7 +236,8 @@ void TidalFavoriteRequest::RemoveFavoritesRequest(const FavoriteType type, const
     url_query.addQueryItem(QString::fromLatin1(QUrl::toPercentEncoding(param.first)), QString::fromLatin1(QUrl::toPercentEncoding(param.second)));
   }
 
-  QUrl url(QLatin1String(TidalService::kApiUrl) + "/users/"_L1 + QString::number(service_->user_id()) + "/favorites/"_L1 + FavoriteText(type) + "/"_L1 + id);
+  // The delete endpoint takes a comma separated list of ids.
+  QUrl url(QLatin1String(TidalService::kApiUrl) + "/users/"_L1 + QString::number(service_->user_id()) + "/favorites/"_L1 + FavoriteText(type) + "/"_L1 + id_list.join(u','));
   url.setQuery(url_query);
   QNetworkRequest network_request(url);
   network_request.setAttribute(QNetworkRequest::RedirectPolicyAttribute, QNetworkRequest::NoLessSafeRedirectPolicy);
@@ -248,14 +246,14 @@ void TidalFavoriteRequest::RemoveFavoritesRequest(const FavoriteType type, const
     network_request.setRawHeader("Authorization", authorization_header());
   }
   QNetworkReply *reply = network_->deleteResource(network_request);
-  QObject::connect(reply, &QNetworkReply::finished, this, [this, reply, type, songs]() { RemoveFavoritesReply(reply, type, songs); });
+  QObject::connect(reply, &QNetworkReply::finished, this, [this, reply, type, batch_id, songs]() { RemoveFavoritesReply(reply, type, batch_id, songs); });
   replies_ << reply;
 
   qLog(Debug) << "Tidal: Sending request" << url << "with" << songs.count() << "songs";
 
 }
 
-void TidalFavoriteRequest::RemoveFavoritesReply(QNetworkReply *reply, const FavoriteType type, const SongList &songs) {
+void TidalFavoriteRequest::RemoveFavoritesReply(QNetworkReply *reply, const FavoriteType type, const int batch_id, const SongList &songs) {
 
   if (replies_.contains(reply)) {
     replies_.removeAll(reply);
@@ -269,20 +267,22 @@ void TidalFavoriteRequest::RemoveFavoritesReply(QNetworkReply *reply, const Favo
   const JsonObjectResult json_object_result = ParseJsonObject(reply);
   if (!json_object_result.success()) {
     Error(json_object_result.error_message);
-    return;
   }
 
-  qLog(Debug) << "Tidal:" << songs.count() << "songs removed from" << FavoriteText(type) << "favorites.";
+  SongList batch_songs;
+  if (!batches_.Finish(batch_id, json_object_result.success() ? songs : SongList(), batch_songs) || batch_songs.isEmpty()) return;
+
+  qLog(Debug) << "Tidal:" << batch_songs.count() << "songs removed from" << FavoriteText(type) << "favorites.";
 
   switch (type) {
     case FavoriteType::Artists:
-      Q_EMIT ArtistsRemoved(songs);
+      Q_EMIT ArtistsRemoved(batch_songs);
       break;
     case FavoriteType::Albums:
-      Q_EMIT AlbumsRemoved(songs);
+      Q_EMIT AlbumsRemoved(batch_songs);
       break;
     case FavoriteType::Songs:
-      Q_EMIT SongsRemoved(songs);
+      Q_EMIT SongsRemoved(batch_songs);
       break;
   }
 
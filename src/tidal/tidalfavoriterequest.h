@@ -26,9 +26,11 @@
 #include <QList>
 #include <QVariant>
 #include <QString>
+#include <QStringList>
 
 #include "includes/shared_ptr.h"
 #include "core/song.h"
+#include "streaming/streamingfavoritebatches.h"
 
 #include "tidalbaserequest.h"
 
@@ -58,8 +60,8 @@ class TidalFavoriteRequest : public TidalBaseRequest {
   void SongsRemoved(const SongList &songs);
 
  private Q_SLOTS:
-  void AddFavoritesReply(QNetworkReply *reply, const TidalFavoriteRequest::FavoriteType type, const SongList &songs);
-  void RemoveFavoritesReply(QNetworkReply *reply, const TidalFavoriteRequest::FavoriteType type, const SongList &songs);
+  void AddFavoritesReply(QNetworkReply *reply, const TidalFavoriteRequest::FavoriteType type, const int batch_id, const SongList &songs);
+  void RemoveFavoritesReply(QNetworkReply *reply, const TidalFavoriteRequest::FavoriteType type, const int batch_id, const SongList &songs);
 
  public Q_SLOTS:
   void AddArtists(const SongList &songs);
@@ -76,14 +78,16 @@ class TidalFavoriteRequest : public TidalBaseRequest {
   void Error(const QString &error, const QVariant &debug = QVariant()) override;
   static QString FavoriteText(const FavoriteType type);
   static QString FavoriteMethod(const FavoriteType type);
+  static QString FavoriteId(const FavoriteType type, const Song &song);
+  static QList<StreamingFavoriteBatches::Chunk> FavoriteChunks(const FavoriteType type, const SongList &songs);
   void AddFavorites(const FavoriteType type, const SongList &songs);
-  void AddFavoritesRequest(const FavoriteType type, const QStringList &id_list, const SongList &songs);
+  void AddFavoritesRequest(const FavoriteType type, const int batch_id, const QStringList &id_list, const SongList &songs);
   void RemoveFavorites(const FavoriteType type, const SongList &songs);
-  void RemoveFavorites(const FavoriteType type, const QString &id, const SongList &songs);
-  void RemoveFavoritesRequest(const FavoriteType type, const QString &id, const SongList &songs);
+  void RemoveFavoritesRequest(const FavoriteType type, const int batch_id, const QStringList &id_list, const SongList &songs);
 
   TidalService *service_;
   const SharedPtr<NetworkAccessManager> network_;
+  StreamingFavoriteBatches batches_;
 };
 
 #endif  // TIDALFAVORITEREQUEST_H
@@ -41,6 +41,7 @@
 #include "core/networkaccessmanager.h"
 #include "core/song.h"
 #include "constants/timeconstants.h"
+#include "collection/collectionbackend.h"
 #include "utilities/imageutils.h"
 #include "utilities/coverutils.h"
 #include "tidalservice.h"
@@ -52,13 +53,9 @@ using namespace Qt::Literals::StringLiterals;
 
 namespace {
 constexpr char kResourcesUrl[] = "https://resources.tidal.com";
-constexpr int kMaxConcurrentArtistsRequests = 3;
-constexpr int kMaxConcurrentAlbumsRequests = 3;
-constexpr int kMaxConcurrentSongsRequests = 3;
-constexpr int kMaxConcurrentArtistAlbumsRequests = 3;
-constexpr int kMaxConcurrentAlbumSongsRequests = 3;
 constexpr int kMaxConcurrentAlbumCoverRequests = 1;
 constexpr int kFlushRequestsDelay = 200;
+constexpr int kCollectionSongsId = 1;
 }  // namespace
 
 TidalRequest::TidalRequest(TidalService *service, TidalUrlHandler *url_handler, const SharedPtr<NetworkAccessManager> network, const Type query_type, QObject *parent)
@@ -99,7 +96,8 @@ TidalRequest::TidalRequest(TidalService *service, TidalUrlHandler *url_handler,
       album_songs_received_(0),
       album_covers_requests_total_(0),
       album_covers_requests_active_(0),
-      album_covers_requests_received_(0) {
+      album_covers_requests_received_(0),
+      collection_albums_reused_(0) {
 
   timer_flush_requests_->setInterval(kFlushRequestsDelay);
   timer_flush_requests_->setSingleShot(false);
@@ -135,6 +133,29 @@ void TidalRequest::Process() {
 
 }
 
+void TidalRequest::Process(SharedPtr<CollectionBackend> collection_backend) {
+
+  QObject::connect(&*collection_backend, &CollectionBackend::GotSongs, this, &TidalRequest::CollectionSongsLoaded);
+  collection_backend->GetAllSongsAsync(kCollectionSongsId);
+
+}
+
+void TidalRequest::CollectionSongsLoaded(const SongList &songs, const int id) {
+
+  if (id != kCollectionSongsId) return;
+
+  QObject::disconnect(sender(), nullptr, this, nullptr);
+
+  for (const Song &song : songs) {
+    if (!song.album_id().isEmpty() && !song.song_id().isEmpty()) {
+      collection_album_songs_.insert(song.album_id(), song);
+    }
+  }
+
+  Process();
+
+}
+
 void TidalRequest::StartRequests() {
 
   if (!timer_flush_requests_->isActive()) {
@@ -207,7 +228,7 @@ void TidalRequest::AddArtistsRequest(const int offset, const int limit) {
 
 void TidalRequest::FlushArtistsRequests() {
 
-  while (!artists_requests_queue_.isEmpty() && artists_requests_active_ < kMaxConcurrentArtistsRequests) {
+  while (!artists_requests_queue_.isEmpty() && artists_requests_active_ < service_->request_limiter()->concurrent_requests() && service_->request_limiter()->TryAcquire()) {
 
     const Request request = artists_requests_queue_.dequeue();
 
@@ -254,7 +275,7 @@ void TidalRequest::AddAlbumsRequest(const int offset, const int limit) {
 
 void TidalRequest::FlushAlbumsRequests() {
 
-  while (!albums_requests_queue_.isEmpty() && albums_requests_active_ < kMaxConcurrentAlbumsRequests) {
+  while (!albums_requests_queue_.isEmpty() && albums_requests_active_ < service_->request_limiter()->concurrent_requests() && service_->request_limiter()->TryAcquire()) {
 
     const Request request = albums_requests_queue_.dequeue();
 
@@ -301,7 +322,7 @@ void TidalRequest::AddSongsRequest(const int offset, const int limit) {
 
 void TidalRequest::FlushSongsRequests() {
 
-  while (!songs_requests_queue_.isEmpty() && songs_requests_active_ < kMaxConcurrentSongsRequests) {
+  while (!songs_requests_queue_.isEmpty() && songs_requests_active_ < service_->request_limiter()->concurrent_requests() && service_->request_limiter()->TryAcquire()) {
 
     const Request request = songs_requests_queue_.dequeue();
 
@@ -480,9 +501,9 @@ void TidalRequest::ArtistsFinishCheck(const int limit, const int offset, const i
 
   if (finished_) return;
 
-  if ((limit == 0 || limit > artists_received) && artists_received_ < artists_total_) {
-    int offset_next = offset + artists_received;
-    if (offset_next > 0 && offset_next < artists_total_) {
+  // The total is known from the first page, so the remaining pages are requested in parallel.
+  if (offset == 0 && artists_received > 0 && (limit == 0 || limit > artists_received) && artists_received_ < artists_total_) {
+    for (int offset_next = artists_received; offset_next < artists_total_; offset_next += artists_received) {
       if (query_type_ == Type::FavouriteArtists) AddArtistsRequest(offset_next);
       else if (query_type_ == Type::SearchArtists) AddArtistsSearchRequest(offset_next);
     }
@@ -532,7 +553,7 @@ void TidalRequest::AddArtistAlbumsRequest(const Artist &artist, const int offset
 
 void TidalRequest::FlushArtistAlbumsRequests() {
 
-  while (!artist_albums_requests_queue_.isEmpty() && artist_albums_requests_active_ < kMaxConcurrentArtistAlbumsRequests) {
+  while (!artist_albums_requests_queue_.isEmpty() && artist_albums_requests_active_ < service_->request_limiter()->concurrent_requests() && service_->request_limiter()->TryAcquire()) {
 
     const ArtistAlbumsRequest request = artist_albums_requests_queue_.dequeue();
 
@@ -643,6 +664,7 @@ void TidalRequest::AlbumsReceived(QNetworkReply *reply, const Artist &artist_req
         album.album_id = QString::number(object_item["id"_L1].toInt());
       }
       album.album = object_item["title"_L1].toString();
+      album.songs_total = object_item["numberOfTracks"_L1].toInt();
       if (service_->album_explicit() && object_item.contains("explicit"_L1)) {
         album.album_explicit = object_item["explicit"_L1].toVariant().toBool();
         if (album.album_explicit && !album.album.isEmpty()) {
@@ -729,9 +751,8 @@ void TidalRequest::AlbumsFinishCheck(const Artist &artist, const int limit, cons
 
   if (finished_) return;
 
-  if (limit == 0 || limit > albums_received) {
-    int offset_next = offset + albums_received;
-    if (offset_next > 0 && offset_next < albums_total) {
+  if (offset == 0 && albums_received > 0 && limit == 0 || limit > albums_received) {
+    for (int offset_next = albums_received; offset_next < albums_total; offset_next += albums_received) {
       switch (query_type_) {
         case Type::FavouriteAlbums:
           AddAlbumsRequest(offset_next);
@@ -760,10 +781,15 @@ void TidalRequest::AlbumsFinishCheck(const Artist &artist, const int limit, cons
 
     for (QHash<QString, AlbumSongsRequest>::const_iterator it = album_songs_requests_pending_.constBegin(); it != album_songs_requests_pending_.constEnd(); ++it) {
       const AlbumSongsRequest &request = it.value();
+      if (AddCollectionAlbumSongs(request.album)) continue;
       AddAlbumSongsRequest(request.artist, request.album);
     }
     album_songs_requests_pending_.clear();
 
+    if (collection_albums_reused_ > 0) {
+      qLog(Debug) << "Tidal: Using songs from the collection for" << collection_albums_reused_ << "albums";
+    }
+
     if (album_songs_requests_total_ > 0) {
       if (album_songs_requests_total_ == 1) Q_EMIT UpdateStatus(query_id_, tr("Receiving songs for %1 album...").arg(album_songs_requests_total_));
       else Q_EMIT UpdateStatus(query_id_, tr("Receiving songs for %1 albums...").arg(album_songs_requests_total_));
@@ -789,6 +815,20 @@ void TidalRequest::SongsReplyReceived(QNetworkReply *reply, const int limit_requ
 
 }
 
+bool TidalRequest::AddCollectionAlbumSongs(const Album &album) {
+
+  if (album.songs_total <= 0 || collection_album_songs_.count(album.album_id) != album.songs_total) return false;
+
+  const SongList songs = collection_album_songs_.values(album.album_id);
+  for (const Song &song : songs) {
+    songs_.insert(song.song_id(), song);
+  }
+  ++collection_albums_reused_;
+
+  return true;
+
+}
+
 void TidalRequest::AddAlbumSongsRequest(const Artist &artist, const Album &album, const int offset) {
 
   AlbumSongsRequest request;
@@ -805,7 +845,7 @@ void TidalRequest::AddAlbumSongsRequest(const Artist &artist, const Album &album
 
 void TidalRequest::FlushAlbumSongsRequests() {
 
-  while (!album_songs_requests_queue_.isEmpty() && album_songs_requests_active_ < kMaxConcurrentAlbumSongsRequests) {
+  while (!album_songs_requests_queue_.isEmpty() && album_songs_requests_active_ < service_->request_limiter()->concurrent_requests() && service_->request_limiter()->TryAcquire()) {
 
     AlbumSongsRequest request = album_songs_requests_queue_.dequeue();
     ParamList parameters;
@@ -912,12 +952,16 @@ void TidalRequest::SongsReceived(QNetworkReply *reply, const Artist &artist, con
     songs << song;
   }
 
-  for (Song song : std::as_const(songs)) {
+  for (Song &song : songs) {
     if (compilation) song.set_compilation_detected(true);
     if (!multidisc) song.set_disc(0);
     songs_.insert(song.song_id(), song);
   }
 
+  if (IsSearch() && !songs.isEmpty()) {
+    Q_EMIT PartialResults(query_id_, songs);
+  }
+
   if (query_type_ == Type::FavouriteSongs || query_type_ == Type::SearchSongs) {
     songs_received_ += songs_received;
     Q_EMIT UpdateProgress(query_id_, GetProgress(songs_received_, songs_total_));
@@ -929,9 +973,8 @@ void TidalRequest::SongsFinishCheck(const Artist &artist, const Album &album, co
 
   if (finished_) return;
 
-  if (limit == 0 || limit > songs_received) {
-    int offset_next = offset + songs_received;
-    if (offset_next > 0 && offset_next < songs_total) {
+  if (offset == 0 && songs_received > 0 && limit == 0 || limit > songs_received) {
+    for (int offset_next = songs_received; offset_next < songs_total; offset_next += songs_received) {
       switch (query_type_) {
         case Type::FavouriteSongs:
           AddSongsRequest(offset_next);
@@ -1152,6 +1195,8 @@ void TidalRequest::GetAlbumCovers() {
 
 void TidalRequest::AddAlbumCoverRequest(const Song &song) {
 
+  if (song.art_automatic().isLocalFile()) return;
+
   if (album_covers_requests_sent_.contains(song.album_id())) {
     album_covers_requests_sent_.insert(song.album_id(), song.song_id());
     return;
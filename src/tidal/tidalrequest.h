@@ -23,6 +23,7 @@
 #include "config.h"
 
 #include <QHash>
+#include <QMultiHash>
 #include <QMap>
 #include <QMultiMap>
 #include <QQueue>
@@ -42,6 +43,7 @@ class QTimer;
 class NetworkAccessManager;
 class TidalService;
 class TidalUrlHandler;
+class CollectionBackend;
 
 class TidalRequest : public TidalBaseRequest {
   Q_OBJECT
@@ -52,6 +54,8 @@ class TidalRequest : public TidalBaseRequest {
   void ReloadSettings();
 
   void Process();
+  // Loads the songs already in the collection first, albums with an unchanged number of songs are then not requested again.
+  void Process(SharedPtr<CollectionBackend> collection_backend);
   void Search(const int query_id, const QString &search_text);
 
  private:
@@ -60,11 +64,12 @@ class TidalRequest : public TidalBaseRequest {
     QString artist;
   };
   struct Album {
-    Album() : album_explicit(false) {}
+    Album() : album_explicit(false), songs_total(0) {}
     QString album_id;
     QString album;
     QUrl cover_url;
     bool album_explicit;
+    int songs_total;
   };
   struct Request {
     Request() : offset(0), limit(0) {}
@@ -95,6 +100,7 @@ class TidalRequest : public TidalBaseRequest {
   void LoginSuccess();
   void LoginFailure(const QString &failure_reason);
   void Results(const int id, const SongMap &songs = SongMap(), const QString &error = QString());
+  void PartialResults(const int id, const SongList &songs);
   void UpdateStatus(const int id, const QString &text);
   void UpdateProgress(const int id, const int max);
   void StreamURLFinished(const QUrl &media_url, const QUrl &url, const Song::FileType filetype, const QString &error = QString());
@@ -111,6 +117,7 @@ class TidalRequest : public TidalBaseRequest {
   void ArtistAlbumsReplyReceived(QNetworkReply *reply, const TidalRequest::Artist &artist, const int offset_requested);
   void AlbumSongsReplyReceived(QNetworkReply *reply, const TidalRequest::Artist &artist, const TidalRequest::Album &album, const int offset_requested);
   void AlbumCoverReceived(QNetworkReply *reply, const QString &album_id, const QUrl &url, const QString &filename);
+  void CollectionSongsLoaded(const SongList &songs, const int id);
 
  private:
   bool IsQuery() const { return (query_type_ == Type::FavouriteArtists || query_type_ == Type::FavouriteAlbums || query_type_ == Type::FavouriteSongs); }
@@ -146,6 +153,7 @@ class TidalRequest : public TidalBaseRequest {
 
   void AddAlbumSongsRequest(const Artist &artist, const Album &album, const int offset = 0);
   void FlushAlbumSongsRequests();
+  bool AddCollectionAlbumSongs(const Album &album);
 
   void ParseSong(Song &song, const QJsonObject &json_obj, const Artist &album_artist, const Album &album);
 
@@ -222,6 +230,9 @@ class TidalRequest : public TidalBaseRequest {
   int album_covers_requests_active_;
   int album_covers_requests_received_;
 
+  QMultiHash<QString, Song> collection_album_songs_;
+  int collection_albums_reused_;
+
   SongMap songs_;
 };
 
@@ -23,6 +23,7 @@
 
 #include <QByteArray>
 #include <QString>
+#include <QStringList>
 #include <QUrl>
 #include <QTimer>
 
@@ -68,6 +69,10 @@ constexpr char kArtistsSongsTable[] = "tidal_artists_songs";
 constexpr char kAlbumsSongsTable[] = "tidal_albums_songs";
 constexpr char kSongsTable[] = "tidal_songs";
 
+constexpr int kInitialConcurrentRequests = 3;
+constexpr int kMaxConcurrentRequests = 6;
+constexpr double kRequestsPerSecond = 5.0;
+
 }  // namespace
 
 TidalService::TidalService(const SharedPtr<TaskManager> task_manager,
@@ -87,6 +92,7 @@ TidalService::TidalService(const SharedPtr<TaskManager> task_manager,
       albums_collection_model_(nullptr),
       songs_collection_model_(nullptr),
       timer_search_delay_(new QTimer(this)),
+      request_limiter_(kInitialConcurrentRequests, kMaxConcurrentRequests, kRequestsPerSecond),
       favorite_request_(new TidalFavoriteRequest(this, network_, this)),
       enabled_(false),
       artistssearchlimit_(1),
@@ -117,6 +123,9 @@ TidalService::TidalService(const SharedPtr<TaskManager> task_manager,
 
   // Backends
 
+  // The songs were in the main database before the service had its own database file.
+  database->ImportSongsTables(QStringList() << QLatin1String(kArtistsSongsTable) << QLatin1String(kAlbumsSongsTable) << QLatin1String(kSongsTable));
+
   artists_collection_backend_ = make_shared<CollectionBackend>();
   artists_collection_backend_->moveToThread(database->thread());
   artists_collection_backend_->Init(database, task_manager, Song::Source::Tidal, QLatin1String(kArtistsSongsTable));
@@ -290,7 +299,7 @@ void TidalService::GetArtists() {
   QObject::connect(&*artists_request_, &TidalRequest::UpdateStatus, this, &TidalService::ArtistsUpdateStatusReceived);
   QObject::connect(&*artists_request_, &TidalRequest::UpdateProgress, this, &TidalService::ArtistsUpdateProgressReceived);
 
-  artists_request_->Process();
+  artists_request_->Process(artists_collection_backend_);
 
 }
 
@@ -332,7 +341,7 @@ void TidalService::GetAlbums() {
   QObject::connect(&*albums_request_, &TidalRequest::UpdateStatus, this, &TidalService::AlbumsUpdateStatusReceived);
   QObject::connect(&*albums_request_, &TidalRequest::UpdateProgress, this, &TidalService::AlbumsUpdateProgressReceived);
 
-  albums_request_->Process();
+  albums_request_->Process(albums_collection_backend_);
 
 }
 
@@ -434,7 +443,12 @@ void TidalService::StartSearch() {
 
 }
 
-void TidalService::CancelSearch() {}
+void TidalService::CancelSearch() {
+
+  timer_search_delay_->stop();
+  search_request_.reset();
+
+}
 
 void TidalService::SendSearch() {
 
@@ -457,6 +471,7 @@ void TidalService::SendSearch() {
 
   search_request_.reset(new TidalRequest(this, url_handler_, network_, query_type, this));
   QObject::connect(&*search_request_, &TidalRequest::Results, this, &TidalService::SearchResultsReceived);
+  QObject::connect(&*search_request_, &TidalRequest::PartialResults, this, &TidalService::SearchPartialResults);
   QObject::connect(&*search_request_, &TidalRequest::UpdateStatus, this, &TidalService::SearchUpdateStatus);
   QObject::connect(&*search_request_, &TidalRequest::UpdateProgress, this, &TidalService::SearchUpdateProgress);
 
@@ -33,6 +33,7 @@
 #include "includes/shared_ptr.h"
 #include "core/song.h"
 #include "streaming/streamingservice.h"
+#include "streaming/streamingrequestlimiter.h"
 #include "constants/tidalsettings.h"
 #include "collection/collectionmodel.h"
 
@@ -87,6 +88,7 @@ class TidalService : public StreamingService {
   bool fetchalbums() const { return fetchalbums_; }
   QString coversize() const { return coversize_; }
   bool download_album_covers() const { return download_album_covers_; }
+  StreamingRequestLimiter *request_limiter() { return &request_limiter_; }
   TidalSettings::StreamUrlMethod stream_url_method() const { return stream_url_method_; }
   bool album_explicit() const { return album_explicit_; }
   bool remove_remastered() const { return remove_remastered_; }
@@ -155,6 +157,8 @@ class TidalService : public StreamingService {
 
   QTimer *timer_search_delay_;
 
+  StreamingRequestLimiter request_limiter_;
+
   TidalRequestPtr artists_request_;
   TidalRequestPtr albums_request_;
   TidalRequestPtr songs_request_;
@@ -46,6 +46,11 @@ QString TidalUrlHandler::scheme() const {
 
 UrlHandler::LoadResult TidalUrlHandler::StartLoading(const QUrl &url) {
 
+  LoadResult cached_result;
+  if (stream_url_cache_.Find(url, &cached_result)) {
+    return cached_result;
+  }
+
   Request request;
   request.task_id = task_manager_->StartTask(QStringLiteral("Loading %1 stream...").arg(url.scheme()));
   QString error;
@@ -80,7 +85,16 @@ void TidalUrlHandler::GetStreamURLSuccess(const uint id, const QUrl &media_url,
   Request req = requests_.take(id);
   CancelTask(req.task_id);
 
-  Q_EMIT AsyncLoadComplete(LoadResult(media_url, LoadResult::Type::TrackAvailable, stream_url, filetype, samplerate, bit_depth, duration));
+  const LoadResult result(media_url, LoadResult::Type::TrackAvailable, stream_url, filetype, samplerate, bit_depth, duration);
+  stream_url_cache_.Insert(result);
+
+  Q_EMIT AsyncLoadComplete(result);
+
+}
+
+void TidalUrlHandler::InvalidateStreamUrl(const QUrl &url) {
+
+  stream_url_cache_.Remove(url);
 
 }
 
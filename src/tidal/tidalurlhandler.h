@@ -29,6 +29,7 @@
 #include "includes/shared_ptr.h"
 #include "core/urlhandler.h"
 #include "core/song.h"
+#include "streaming/streamurlcache.h"
 
 class TaskManager;
 class TidalService;
@@ -41,6 +42,7 @@ class TidalUrlHandler : public UrlHandler {
 
   QString scheme() const override;
   LoadResult StartLoading(const QUrl &url) override;
+  void InvalidateStreamUrl(const QUrl &url) override;
 
  private:
   void CancelTask(const int task_id);
@@ -58,6 +60,7 @@ class TidalUrlHandler : public UrlHandler {
   const SharedPtr<TaskManager> task_manager_;
   TidalService *service_;
   QMap<uint, Request> requests_;
+  StreamUrlCache stream_url_cache_;
 };
 
 #endif  // TIDALURLHANDLER_H
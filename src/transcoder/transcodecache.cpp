@@ -0,0 +1,173 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "config.h"
+
+#include <algorithm>
+
+#include <QtGlobal>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QFileInfoList>
+#include <QDateTime>
+#include <QString>
+#include <QStringList>
+#include <QCryptographicHash>
+
+#include "core/logging.h"
+#include "core/settings.h"
+#include "core/standardpaths.h"
+#include "core/song.h"
+#include "transcoder.h"
+#include "transcodecache.h"
+
+using namespace Qt::Literals::StringLiterals;
+
+namespace {
+
+constexpr char kCacheDirectory[] = "transcoded";
+constexpr qint64 kMaxCacheSize = 4LL * 1024LL * 1024LL * 1024LL;
+
+QString EncoderSettings() {
+
+  // Element settings are stored in a group for each element below the transcoder group.
+  Settings s;
+  s.beginGroup("Transcoder"_L1);
+  QStringList groups = s.childGroups();
+  std::sort(groups.begin(), groups.end());
+  QStringList settings;
+  for (const QString &group : std::as_const(groups)) {
+    s.beginGroup(group);
+    QStringList keys = s.childKeys();
+    std::sort(keys.begin(), keys.end());
+    for (const QString &key : std::as_const(keys)) {
+      settings << group + QLatin1Char('/') + key + QLatin1Char('=') + s.value(key).toString();
+    }
+    s.endGroup();
+  }
+  s.endGroup();
+
+  return settings.join(QLatin1Char('\n'));
+
+}
+
+}  // namespace
+
+TranscodeCache::TranscodeCache()
+    : cache_directory_(StandardPaths::WritableLocation(StandardPaths::StandardLocation::CacheLocation) + QLatin1Char('/') + QLatin1String(kCacheDirectory)),
+      settings_(EncoderSettings()) {}
+
+QString TranscodeCache::Key(const Song &song, const TranscoderPreset &preset) const {
+
+  QString source;
+  if (!song.fingerprint().isEmpty() && song.fingerprint() != "NONE"_L1) {
+    source = song.fingerprint();
+  }
+  else {
+    const QFileInfo fileinfo(song.url().toLocalFile());
+    if (!fileinfo.exists()) return QString();
+    source = fileinfo.canonicalFilePath() + QLatin1Char('\n') + QString::number(fileinfo.size()) + QLatin1Char('\n') + QString::number(fileinfo.lastModified().toSecsSinceEpoch());
+  }
+
+  QCryptographicHash hash(QCryptographicHash::Sha1);
+  hash.addData(source.toUtf8());
+  hash.addData(QString::number(song.beginning_nanosec()).toUtf8());
+  hash.addData(preset.codec_mimetype_.toUtf8());
+  hash.addData(preset.muxer_mimetype_.toUtf8());
+  hash.addData(settings_.toUtf8());
+
+  return QString::fromLatin1(hash.result().toHex()) + QLatin1Char('.') + preset.extension_;
+
+}
+
+QString TranscodeCache::CacheFilename(const QString &key) const {
+
+  return cache_directory_ + QLatin1Char('/') + key;
+
+}
+
+bool TranscodeCache::Get(const QString &key, const QString &filename) const {
+
+  if (key.isEmpty()) return false;
+
+  const QString cache_filename = CacheFilename(key);
+  if (!QFile::exists(cache_filename)) return false;
+
+  if (QFile::exists(filename)) QFile::remove(filename);
+  if (!QFile::copy(cache_filename, filename)) {
+    qLog(Error) << "Could not copy" << cache_filename << "to" << filename;
+    return false;
+  }
+
+  // Update the modification time so the most recently used files are kept.
+  QFile cache_file(cache_filename);
+  if (cache_file.open(QIODevice::ReadWrite)) {
+    cache_file.setFileTime(QDateTime::currentDateTime(), QFileDevice::FileModificationTime);
+    cache_file.close();
+  }
+
+  return true;
+
+}
+
+void TranscodeCache::Insert(const QString &key, const QString &filename) {
+
+  if (key.isEmpty()) return;
+
+  QDir dir(cache_directory_);
+  if (!dir.exists() && !dir.mkpath(u"."_s)) {
+    qLog(Error) << "Could not create directory" << cache_directory_;
+    return;
+  }
+
+  const QString cache_filename = CacheFilename(key);
+  const QString temp_filename = cache_filename + ".part"_L1;
+  if (QFile::exists(temp_filename)) QFile::remove(temp_filename);
+  if (!QFile::copy(filename, temp_filename)) {
+    qLog(Error) << "Could not copy" << filename << "to" << cache_directory_;
+    return;
+  }
+  if (QFile::exists(cache_filename)) QFile::remove(cache_filename);
+  if (!QFile::rename(temp_filename, cache_filename)) {
+    QFile::remove(temp_filename);
+    return;
+  }
+
+  Expire();
+
+}
+
+void TranscodeCache::Expire() {
+
+  const QFileInfoList files = QDir(cache_directory_).entryInfoList(QDir::Files, QDir::Time);
+
+  qint64 size = 0;
+  for (const QFileInfo &fileinfo : files) {
+    size += fileinfo.size();
+  }
+
+  // The list is sorted with the most recently used files first.
+  for (QFileInfoList::const_reverse_iterator it = files.crbegin(); it != files.crend() && size > kMaxCacheSize; ++it) {
+    if (QFile::remove(it->absoluteFilePath())) {
+      size -= it->size();
+    }
+  }
+
+}
@@ -0,0 +1,56 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef TRANSCODECACHE_H
+#define TRANSCODECACHE_H
+
+#include "config.h"
+
+#include <QtGlobal>
+#include <QString>
+
+#include "core/song.h"
+
+struct TranscoderPreset;
+
+// Keeps transcoded files so copying the same song to another device with the same format doesn't need to encode it again.
+// Files are keyed by the source (fingerprint, or filename, size and modification time), the preset and the encoder settings.
+// The least recently used files are removed when the cache grows past the size limit.
+class TranscodeCache {
+ public:
+  explicit TranscodeCache();
+
+  QString Key(const Song &song, const TranscoderPreset &preset) const;
+
+  // Copies the cached file for the key to the filename, returns false if the file isn't cached.
+  bool Get(const QString &key, const QString &filename) const;
+
+  // Stores a copy of the transcoded file.
+  void Insert(const QString &key, const QString &filename);
+
+ private:
+  QString CacheFilename(const QString &key) const;
+  void Expire();
+
+  const QString cache_directory_;
+  // Encoder settings are read when the cache is created, so they stay the same while organizing.
+  const QString settings_;
+};
+
+#endif  // TRANSCODECACHE_H
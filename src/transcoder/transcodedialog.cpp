@@ -58,6 +58,7 @@
 
 #include "core/iconloader.h"
 #include "core/settings.h"
+#include "constants/timeconstants.h"
 #include "constants/filefilterconstants.h"
 #include "constants/transcodersettings.h"
 #include "utilities/screenutils.h"
@@ -255,6 +256,7 @@ void TranscodeDialog::Start() {
   queued_ = file_model->rowCount();
   finished_success_ = 0;
   finished_failed_ = 0;
+  elapsed_timer_.start();
   UpdateStatusText();
 
   // Start transcoding
@@ -318,6 +320,12 @@ void TranscodeDialog::UpdateStatusText() {
     sections << u"<font color=\"#b60000\">"_s + tr("%n failed", "", finished_failed_) + u"</font>"_s;
   }
 
+  const int finished = finished_success_ + finished_failed_;
+  if (finished > 0 && elapsed_timer_.isValid() && elapsed_timer_.elapsed() >= kMsecPerSec) {
+    const double tracks_per_minute = static_cast<double>(finished) * static_cast<double>(kMsecPerSec * 60) / static_cast<double>(elapsed_timer_.elapsed());
+    sections << tr("%1 tracks per minute").arg(tracks_per_minute, 0, 'f', 1);
+  }
+
   ui_->progress_text->setText(sections.join(", "_L1));
 
 }
@@ -27,6 +27,7 @@
 #include <QObject>
 #include <QDialog>
 #include <QBasicTimer>
+#include <QElapsedTimer>
 #include <QString>
 #include <QStringList>
 
@@ -86,6 +87,7 @@ class TranscodeDialog : public QDialog {
   QDialog *log_dialog_;
 
   QBasicTimer progress_timer_;
+  QElapsedTimer elapsed_timer_;
 
   QPushButton *start_button_;
   QPushButton *cancel_button_;
@@ -46,11 +46,16 @@
 #include "core/standardpaths.h"
 #include "core/signalchecker.h"
 #include "core/settings.h"
+#include "engine/gststartup.h"
 #include "transcoder.h"
 
 using std::make_shared;
 using namespace Qt::Literals::StringLiterals;
 
+namespace {
+constexpr int kCostPerThread = 2;
+}  // namespace
+
 int Transcoder::JobFinishedEvent::sEventType = -1;
 
 TranscoderPreset::TranscoderPreset(const Song::FileType filetype, const QString &name, const QString &extension, const QString &codec_mimetype, const QString &muxer_mimetype)
@@ -68,6 +73,11 @@ GstElement *Transcoder::CreateElement(const QString &factory_name, GstElement *b
   if (ret && bin) gst_bin_add(GST_BIN(bin), ret);
 
   if (ret) {
+    // Jobs run in parallel already, so encoders with their own threads should only use one each.
+    GParamSpec *param_spec_threads = g_object_class_find_property(G_OBJECT_GET_CLASS(ret), "threads");
+    if (param_spec_threads && param_spec_threads->value_type == G_TYPE_INT && (param_spec_threads->flags & G_PARAM_WRITABLE)) {
+      g_object_set(G_OBJECT(ret), "threads", 1, nullptr);
+    }
     SetElementProperties(factory_name, G_OBJECT(ret));
   }
   else {
@@ -91,16 +101,22 @@ struct SuitableElement {
 
 };
 
-GstElement *Transcoder::CreateElementForMimeType(GstElementFactoryListType element_type, const QString &mime_type, GstElement *bin) {
+QString Transcoder::ElementFactoryForMimeType(GstElementFactoryListType element_type, const QString &mime_type) {
 
-  if (mime_type.isEmpty()) return nullptr;
+  if (mime_type.isEmpty()) return QString();
 
   // HACK: Force mp4mux because it doesn't set any useful src caps
   if (mime_type == "audio/mp4"_L1) {
-    Q_EMIT LogLine(QStringLiteral("Using '%1' (rank %2)").arg("mp4mux"_L1).arg(-1));
-    return CreateElement(u"mp4mux"_s, bin);
+    return u"mp4mux"_s;
   }
 
+  const QString key = QString::number(element_type) + QLatin1Char(':') + mime_type;
+  if (element_factories_.contains(key)) {
+    return element_factories_.value(key);
+  }
+
+  GstStartup::WaitForInitialized();
+
   // Keep track of all the suitable elements we find and figure out which is the best at the end.
   QList<SuitableElement> suitable_elements_;
 
@@ -130,15 +146,27 @@ GstElement *Transcoder::CreateElementForMimeType(GstElementFactoryListType eleme
   gst_plugin_feature_list_free(features);
   gst_caps_unref(target_caps);
 
-  if (suitable_elements_.isEmpty()) return nullptr;
+  QString factory_name;
+  if (!suitable_elements_.isEmpty()) {
+    // Sort by rank
+    std::sort(suitable_elements_.begin(), suitable_elements_.end());
+    const SuitableElement &best = suitable_elements_.last();
+    factory_name = best.name_;
+    Q_EMIT LogLine(QStringLiteral("Using '%1' (rank %2)").arg(best.name_).arg(best.rank_));
+  }
 
-  // Sort by rank
-  std::sort(suitable_elements_.begin(), suitable_elements_.end());
-  const SuitableElement &best = suitable_elements_.last();
+  element_factories_.insert(key, factory_name);
 
-  Q_EMIT LogLine(QStringLiteral("Using '%1' (rank %2)").arg(best.name_).arg(best.rank_));
+  return factory_name;
 
-  if (best.name_ == "lamemp3enc"_L1) {
+}
+
+GstElement *Transcoder::CreateElementForMimeType(GstElementFactoryListType element_type, const QString &mime_type, GstElement *bin) {
+
+  const QString factory_name = ElementFactoryForMimeType(element_type, mime_type);
+  if (factory_name.isEmpty()) return nullptr;
+
+  if (factory_name == "lamemp3enc"_L1) {
     // Special case: we need to add xingmux and id3v2mux to the pipeline when using lamemp3enc because it doesn't write the VBR or ID3v2 headers itself.
 
     Q_EMIT LogLine(u"Adding xingmux and id3v2mux to the pipeline"_s);
@@ -171,7 +199,7 @@ GstElement *Transcoder::CreateElementForMimeType(GstElementFactoryListType eleme
     return mp3bin;
   }
   else {
-    return CreateElement(best.name_, bin);
+    return CreateElement(factory_name, bin);
   }
 
 }
@@ -192,6 +220,7 @@ void Transcoder::JobState::PostFinished(const bool success) {
 Transcoder::Transcoder(QObject *parent, const QString &settings_postfix)
     : QObject(parent),
       max_threads_(QThread::idealThreadCount()),
+      current_cost_(0),
       settings_postfix_(settings_postfix) {
 
   if (JobFinishedEvent::sEventType == -1)
@@ -334,7 +363,6 @@ void Transcoder::Start() {
 
 Transcoder::StartJobStatus Transcoder::MaybeStartNextJob() {
 
-  if (current_jobs_.count() >= max_threads()) return StartJobStatus::AllThreadsBusy;
   if (queued_jobs_.isEmpty()) {
     if (current_jobs_.isEmpty()) {
       Q_EMIT AllJobsComplete();
@@ -343,8 +371,11 @@ Transcoder::StartJobStatus Transcoder::MaybeStartNextJob() {
     return StartJobStatus::NoMoreJobs;
   }
 
+  const int cost = JobCost(queued_jobs_.first());
+  if (!current_jobs_.isEmpty() && current_cost_ + cost > max_threads() * kCostPerThread) return StartJobStatus::AllThreadsBusy;
+
   Job job = queued_jobs_.takeFirst();
-  if (StartJob(job)) {
+  if (StartJob(job, cost)) {
     return StartJobStatus::StartedSuccessfully;
   }
 
@@ -408,14 +439,34 @@ void Transcoder::JobState::ReportError(GstMessage *msg) const {
 
 }
 
-bool Transcoder::StartJob(const Job &job) {
+int Transcoder::EncoderCost(const QString &factory_name) {
+
+  // Lossless encoders are fast enough that the jobs mostly wait for the disk, so two of them are run for each thread.
+  if (factory_name.isEmpty() || factory_name == "flacenc"_L1 || factory_name == "wavenc"_L1 || factory_name == "wavpackenc"_L1) {
+    return 1;
+  }
+
+  return kCostPerThread;
+
+}
+
+int Transcoder::JobCost(const Job &job) {
+
+  return EncoderCost(ElementFactoryForMimeType(GST_ELEMENT_FACTORY_TYPE_AUDIO_ENCODER, job.preset.codec_mimetype_));
+
+}
+
+bool Transcoder::StartJob(const Job &job, const int cost) {
 
   SharedPtr<JobState> state = make_shared<JobState>(job, this);
+  state->cost_ = cost;
+  state->elapsed_timer_.start();
 
   Q_EMIT LogLine(tr("Starting %1").arg(QDir::toNativeSeparators(job.input)));
 
   // Create the pipeline.
   // This should be a scoped_ptr, but scoped_ptr doesn't support custom destructors.
+  GstStartup::WaitForInitialized();
   state->pipeline_ = gst_pipeline_new("pipeline");
   if (!state->pipeline_) return false;
 
@@ -462,6 +513,7 @@ bool Transcoder::StartJob(const Job &job) {
   // GStreamer now transcodes in another thread, so we can return now and do something else.
   // Keep the JobState object around.  It'll post an event to our event loop when it finishes.
   current_jobs_ << state;
+  current_cost_ += cost;
 
   return true;
 
@@ -493,18 +545,23 @@ bool Transcoder::event(QEvent *e) {
 
     QString input = (*it)->job_.input;
     QString output = (*it)->job_.output;
+    const qint64 elapsed_msec = (*it)->elapsed_timer_.elapsed();
 
     // Remove event handlers from the gstreamer pipeline, so they don't get called after the pipeline is shutting down
     gst_bus_set_sync_handler(gst_pipeline_get_bus(GST_PIPELINE(finished_event->state_->pipeline_)), nullptr, nullptr, nullptr);
 
     // Remove it from the list - this will also destroy the GStreamer pipeline
+    current_cost_ -= (*it)->cost_;
     current_jobs_.erase(it);
 
     // Emit the finished signal
-    Q_EMIT JobComplete(input, output, finished_event->success_);
+    Q_EMIT JobComplete(input, output, finished_event->success_, elapsed_msec);
 
-    // Start some more jobs
-    MaybeStartNextJob();
+    // Start some more jobs, a finished job can leave room for more than one cheaper job.
+    Q_FOREVER {
+      const StartJobStatus status = MaybeStartNextJob();
+      if (status == StartJobStatus::AllThreadsBusy || status == StartJobStatus::NoMoreJobs) break;
+    }
 
     return true;
   }
@@ -536,6 +593,8 @@ void Transcoder::Cancel() {
     it = current_jobs_.erase(it);
   }
 
+  current_cost_ = 0;
+
 }
 
 QMap<QString, float> Transcoder::GetProgress() const {
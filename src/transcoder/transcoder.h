@@ -35,6 +35,7 @@
 #include <QSet>
 #include <QString>
 #include <QEvent>
+#include <QElapsedTimer>
 
 #include "includes/shared_ptr.h"
 #include "core/song.h"
@@ -75,7 +76,7 @@ class Transcoder : public QObject {
   void Cancel();
 
  Q_SIGNALS:
-  void JobComplete(const QString &input, const QString &output, const bool success);
+  void JobComplete(const QString &input, const QString &output, const bool success, const qint64 elapsed_msec = 0);
   void LogLine(const QString &message);
   void AllJobsComplete();
 
@@ -96,7 +97,8 @@ class Transcoder : public QObject {
         : job_(job),
           parent_(parent),
           pipeline_(nullptr),
-          convert_element_(nullptr) {}
+          convert_element_(nullptr),
+          cost_(0) {}
     ~JobState();
 
     void PostFinished(const bool success);
@@ -106,6 +108,8 @@ class Transcoder : public QObject {
     Transcoder *parent_;
     GstElement *pipeline_;
     GstElement *convert_element_;
+    int cost_;
+    QElapsedTimer elapsed_timer_;
 
    private:
     Q_DISABLE_COPY(JobState)
@@ -132,10 +136,13 @@ class Transcoder : public QObject {
   };
 
   StartJobStatus MaybeStartNextJob();
-  bool StartJob(const Job &job);
+  bool StartJob(const Job &job, const int cost);
+  int JobCost(const Job &job);
+  static int EncoderCost(const QString &factory_name);
 
   GstElement *CreateElement(const QString &factory_name, GstElement *bin = nullptr, const QString &name = QString());
   GstElement *CreateElementForMimeType(GstElementFactoryListType element_type, const QString &mime_type, GstElement *bin = nullptr);
+  QString ElementFactoryForMimeType(GstElementFactoryListType element_type, const QString &mime_type);
   void SetElementProperties(const QString &name, GObject *object);
 
   static void NewPadCallback(GstElement *element, GstPad *pad, gpointer data);
@@ -147,6 +154,10 @@ class Transcoder : public QObject {
   int max_threads_;
   QList<Job> queued_jobs_;
   JobStateList current_jobs_;
+  // Sum of the cost of the running jobs, limited to kCostPerThread for each thread.
+  int current_cost_;
+  // Best element factory for each element type and mime type, so the registry is only searched once.
+  QMap<QString, QString> element_factories_;
   QString settings_postfix_;
 };
 
@@ -19,12 +19,14 @@
 
 #include <utility>
 
+#include <QList>
 #include <QByteArray>
 #include <QString>
 #include <QStringList>
 #include <QBuffer>
 #include <QImage>
 #include <QImageReader>
+#include <QImageWriter>
 #include <QPainter>
 #include <QSize>
 
@@ -147,3 +149,97 @@ QImage ImageUtils::GenerateNoCoverImage(const QSize size, const qreal device_pix
   return image_square;
 
 }
+
+QByteArray ImageUtils::ThumbnailFormatName(const ThumbnailFormat format) {
+
+  switch (format) {
+    case ThumbnailFormat::Raw:
+      break;
+    case ThumbnailFormat::PNG:
+      return "png";
+    case ThumbnailFormat::JPEG:
+      return "jpeg";
+    case ThumbnailFormat::WebP:
+      return "webp";
+    case ThumbnailFormat::AVIF:
+      return "avif";
+    case ThumbnailFormat::JXL:
+      return "jxl";
+  }
+
+  return QByteArray();
+
+}
+
+QString ImageUtils::ThumbnailFormatDescription(const ThumbnailFormat format) {
+
+  switch (format) {
+    case ThumbnailFormat::Raw:
+      break;
+    case ThumbnailFormat::PNG:
+      return u"PNG"_s;
+    case ThumbnailFormat::JPEG:
+      return u"JPEG"_s;
+    case ThumbnailFormat::WebP:
+      return u"WebP"_s;
+    case ThumbnailFormat::AVIF:
+      return u"AVIF"_s;
+    case ThumbnailFormat::JXL:
+      return u"JPEG XL"_s;
+  }
+
+  return u"Uncompressed"_s;
+
+}
+
+bool ImageUtils::ThumbnailFormatIsSupported(const ThumbnailFormat format) {
+
+  if (format == ThumbnailFormat::Raw) return true;
+
+  const QByteArray name = ThumbnailFormatName(format);
+  return QImageWriter::supportedImageFormats().contains(name) && QImageReader::supportedImageFormats().contains(name);
+
+}
+
+QList<ImageUtils::ThumbnailFormat> ImageUtils::SupportedThumbnailFormats() {
+
+  QList<ThumbnailFormat> formats;
+  for (const ThumbnailFormat format : { ThumbnailFormat::Raw, ThumbnailFormat::PNG, ThumbnailFormat::JPEG, ThumbnailFormat::WebP, ThumbnailFormat::AVIF, ThumbnailFormat::JXL }) {
+    if (ThumbnailFormatIsSupported(format)) {
+      formats << format;
+    }
+  }
+
+  return formats;
+
+}
+
+QByteArray ImageUtils::EncodeThumbnail(const QImage &image, const ThumbnailFormat format, const int quality) {
+
+  if (image.isNull() || format == ThumbnailFormat::Raw) return QByteArray();
+
+  QByteArray data;
+  QBuffer buffer(&data);
+  if (!buffer.open(QIODevice::WriteOnly)) return QByteArray();
+
+  QImageWriter writer(&buffer, ThumbnailFormatName(format));
+  writer.setQuality(quality);
+  // JPEG has no alpha channel, the transparent padding of scaled covers becomes black.
+  if (!writer.write(format == ThumbnailFormat::JPEG && image.hasAlphaChannel() ? image.convertToFormat(QImage::Format_RGB32) : image)) {
+    return QByteArray();
+  }
+
+  return data;
+
+}
+
+QImage ImageUtils::DecodeThumbnail(const QByteArray &data, const ThumbnailFormat format) {
+
+  if (data.isEmpty() || format == ThumbnailFormat::Raw) return QImage();
+
+  QImage image;
+  image.loadFromData(data, ThumbnailFormatName(format).constData());
+
+  return image;
+
+}
@@ -20,6 +20,7 @@
 #ifndef IMAGEUTILS_H
 #define IMAGEUTILS_H
 
+#include <QList>
 #include <QByteArray>
 #include <QByteArrayList>
 #include <QString>
@@ -30,6 +31,17 @@
 
 class ImageUtils {
 
+ public:
+  // Formats for storing cached thumbnails, the compressed formats are only available when the Qt image plugins for them are installed.
+  enum class ThumbnailFormat {
+    Raw = 0,
+    PNG = 1,
+    JPEG = 2,
+    WebP = 3,
+    AVIF = 4,
+    JXL = 5
+  };
+
  private:
   static QStringList kSupportedImageMimeTypes;
   static QStringList kSupportedImageFormats;
@@ -41,6 +53,13 @@ class ImageUtils {
   static QByteArray FileToJpegData(const QString &filename);
   static QImage ScaleImage(const QImage &image, const QSize desired_size, const qreal device_pixel_ratio = 1.0F, const bool pad = true);
   static QImage GenerateNoCoverImage(const QSize size, const qreal device_pixel_ratio);
+
+  static QByteArray ThumbnailFormatName(const ThumbnailFormat format);
+  static QString ThumbnailFormatDescription(const ThumbnailFormat format);
+  static bool ThumbnailFormatIsSupported(const ThumbnailFormat format);
+  static QList<ThumbnailFormat> SupportedThumbnailFormats();
+  static QByteArray EncodeThumbnail(const QImage &image, const ThumbnailFormat format, const int quality);
+  static QImage DecodeThumbnail(const QByteArray &data, const ThumbnailFormat format);
 };
 
 #endif  // IMAGEUTILS_H
@@ -27,6 +27,8 @@ namespace Utilities {
 qint32 GetMacOsVersion();
 void IncreaseFDLimit();
 bool ProcessTranslated();
+// True if the system reports a memory pressure level of warning or critical.
+bool MemoryPressure();
 
 }  // namespace Utilities
 
@@ -71,4 +71,17 @@ bool ProcessTranslated() {
 
 }
 
+bool MemoryPressure() {
+
+  // 1 is normal, 2 is warning and 4 is critical.
+  int level = 0;
+  size_t level_size = sizeof(level);
+  if (sysctlbyname("kern.memorystatus_vm_pressure_level", &level, &level_size, nullptr, 0) != 0) {
+    return false;
+  }
+
+  return level >= 2;
+
+}
+
 }  // namespace Utilities
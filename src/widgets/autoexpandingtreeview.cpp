@@ -21,6 +21,7 @@
 
 #include <QWidget>
 #include <QMimeData>
+#include <QTimer>
 #include <QTreeView>
 #include <QAbstractItemModel>
 #include <QAbstractItemView>
@@ -31,6 +32,8 @@
 
 namespace {
 constexpr int kRowsToShow = 50;
+// Nodes expanded before the view is laid out and painted again.
+constexpr int kExpandBatchSize = 500;
 }
 
 AutoExpandingTreeView::AutoExpandingTreeView(QWidget *parent)
@@ -38,11 +41,16 @@ AutoExpandingTreeView::AutoExpandingTreeView(QWidget *parent)
       auto_open_(false),
       expand_on_reset_(false),
       add_on_double_click_(true),
-      ignore_next_click_(false) {
+      ignore_next_click_(false),
+      timer_expand_(new QTimer(this)) {
 
   setExpandsOnDoubleClick(true);
   setAnimated(true);
 
+  timer_expand_->setSingleShot(true);
+  timer_expand_->setInterval(0);
+  QObject::connect(timer_expand_, &QTimer::timeout, this, &AutoExpandingTreeView::ExpandNextBatch);
+
   QObject::connect(this, &AutoExpandingTreeView::expanded, this, &AutoExpandingTreeView::ItemExpanded);
   QObject::connect(this, &AutoExpandingTreeView::clicked, this, &AutoExpandingTreeView::ItemClicked);
   QObject::connect(this, &AutoExpandingTreeView::doubleClicked, this, &AutoExpandingTreeView::ItemDoubleClicked);
@@ -52,6 +60,9 @@ AutoExpandingTreeView::AutoExpandingTreeView(QWidget *parent)
 void AutoExpandingTreeView::reset() {
   QTreeView::reset();
 
+  expand_queue_.clear();
+  timer_expand_->stop();
+
   // Expand nodes in the tree until we have about 50 rows visible in the view
   if (auto_open_ && expand_on_reset_) {
     RecursivelyExpandSlot(rootIndex());
@@ -59,8 +70,89 @@ void AutoExpandingTreeView::reset() {
 }
 
 void AutoExpandingTreeView::RecursivelyExpandSlot(const QModelIndex &idx) {
+
+  // With a layout pending, expand() only marks the nodes as expanded, and the view is laid out once after all of them.
+  scheduleDelayedItemsLayout();
+
   int rows = model()->rowCount(idx);
   RecursivelyExpand(idx, &rows);
+
+}
+
+void AutoExpandingTreeView::ExpandRecursively(const QModelIndexList &indexes) {
+
+  for (const QModelIndex &idx : indexes) {
+    expand_queue_ << QPersistentModelIndex(idx);
+  }
+
+  if (!expand_queue_.isEmpty()) {
+    timer_expand_->start();
+  }
+
+}
+
+void AutoExpandingTreeView::ExpandAll() {
+
+  if (!model()) return;
+
+  const QModelIndex root_index = rootIndex();
+  if (model()->canFetchMore(root_index)) {
+    model()->fetchMore(root_index);
+  }
+
+  QModelIndexList indexes;
+  const int rows = model()->rowCount(root_index);
+  indexes.reserve(rows);
+  for (int row = 0; row < rows; ++row) {
+    indexes << model()->index(row, 0, root_index);
+  }
+
+  ExpandRecursively(indexes);
+
+}
+
+void AutoExpandingTreeView::CollapseAll() {
+
+  expand_queue_.clear();
+  timer_expand_->stop();
+
+  collapseAll();
+
+}
+
+void AutoExpandingTreeView::ExpandNextBatch() {
+
+  if (!model() || expand_queue_.isEmpty()) return;
+
+  setUpdatesEnabled(false);
+  scheduleDelayedItemsLayout();
+
+  for (int i = 0; i < kExpandBatchSize && !expand_queue_.isEmpty(); ++i) {
+    const QModelIndex idx = expand_queue_.takeFirst();
+    if (!idx.isValid() || !model()->hasChildren(idx)) continue;
+
+    if (model()->canFetchMore(idx)) {
+      model()->fetchMore(idx);
+    }
+
+    expand(idx);
+
+    const int children = model()->rowCount(idx);
+    for (int row = 0; row < children; ++row) {
+      const QModelIndex child_index = model()->index(row, 0, idx);
+      if (model()->hasChildren(child_index)) {
+        expand_queue_ << QPersistentModelIndex(child_index);
+      }
+    }
+  }
+
+  executeDelayedItemsLayout();
+  setUpdatesEnabled(true);
+
+  if (!expand_queue_.isEmpty()) {
+    timer_expand_->start();
+  }
+
 }
 
 bool AutoExpandingTreeView::RecursivelyExpand(const QModelIndex &idx, int *count) {
@@ -24,9 +24,12 @@
 
 #include <QtGlobal>
 #include <QObject>
+#include <QList>
 #include <QString>
+#include <QPersistentModelIndex>
 #include <QTreeView>
 
+class QTimer;
 class QMimeData;
 class QWidget;
 class QModelIndex;
@@ -45,6 +48,10 @@ class AutoExpandingTreeView : public QTreeView {
 
  public Q_SLOTS:
   void RecursivelyExpandSlot(const QModelIndex &idx);
+  // Expands the indexes and all their children, a batch of nodes at a time so the view stays responsive in large trees.
+  void ExpandRecursively(const QModelIndexList &indexes);
+  void ExpandAll();
+  void CollapseAll();
   void UpAndFocus();
   void DownAndFocus();
 
@@ -68,6 +75,7 @@ class AutoExpandingTreeView : public QTreeView {
   void ItemExpanded(const QModelIndex &idx);
   void ItemClicked(const QModelIndex &idx);
   void ItemDoubleClicked(const QModelIndex &idx);
+  void ExpandNextBatch();
 
  private:
   bool RecursivelyExpand(const QModelIndex &idx, int *count);
@@ -77,6 +85,9 @@ class AutoExpandingTreeView : public QTreeView {
   bool expand_on_reset_;
   bool add_on_double_click_;
   bool ignore_next_click_;
+  QTimer *timer_expand_;
+  // Nodes waiting to be expanded, their children are only fetched when they are expanded.
+  QList<QPersistentModelIndex> expand_queue_;
 };
 
 #endif  // AUTOEXPANDINGTREEVIEW_H
@@ -18,7 +18,7 @@
  *
  */
 
-#include <utility>
+#include <algorithm>
 
 #include <QWidget>
 #include <QListView>
@@ -56,6 +56,9 @@ constexpr int kBarMarginTop = 3;
 GroupedIconView::GroupedIconView(QWidget *parent)
     : QListView(parent),
       proxy_model_(new MultiSortFilterProxy(this)),
+      layout_width_(-1),
+      layout_height_(0),
+      max_item_height_(0),
       default_header_height_(fontMetrics().height() +
       kBarMarginTop + kBarThickness),
       header_spacing_(10),
@@ -125,13 +128,24 @@ void GroupedIconView::DrawHeader(QPainter *painter, const QRect rect, const QFon
 }
 
 void GroupedIconView::resizeEvent(QResizeEvent *e) {
+
   QListView::resizeEvent(e);
-  LayoutItems();
+
+  // Only the width affects where the items wrap.
+  if (viewport()->width() == layout_width_) {
+    UpdateScrollBarRange();
+  }
+  else {
+    LayoutItems();
+  }
+
 }
 
 void GroupedIconView::rowsInserted(const QModelIndex &parent, int start, int end) {
+
   QListView::rowsInserted(parent, start, end);
-  LayoutItems();
+  if (!parent.isValid()) LayoutItemsFrom(start);
+
 }
 
 void GroupedIconView::dataChanged(const QModelIndex &top_left, const QModelIndex &bottom_right, const QList<int> &roles) {
@@ -139,27 +153,53 @@ void GroupedIconView::dataChanged(const QModelIndex &top_left, const QModelIndex
   Q_UNUSED(roles)
 
   QListView::dataChanged(top_left, bottom_right);
-  LayoutItems();
+  LayoutItemsFrom(top_left.row());
 
 }
 
 void GroupedIconView::LayoutItems() {
 
+  LayoutItemsFrom(0);
+
+}
+
+void GroupedIconView::LayoutItemsFrom(const int row) {
+
   if (!model()) {
     return;
   }
 
   const int count = model()->rowCount();
 
+  // Resume from the last group starting before the row, so a row inserted at the end of a group continues that group's last line.
+  // A full layout is needed if the width changed.
+  qsizetype header_index = 0;
+  if (row > 0 && viewport()->width() == layout_width_ && row <= visual_rects_.count()) {
+    QList<Header>::const_iterator it = std::lower_bound(headers_.cbegin(), headers_.cend(), row, [](const Header &header, const int r) { return header.first_row < r; });
+    header_index = std::max(static_cast<qsizetype>(0), static_cast<qsizetype>(it - headers_.cbegin()) - 1);
+  }
+
+  int first_row = 0;
   QString last_group;
   QPoint next_position(0, 0);
   int max_row_height = 0;
 
-  visual_rects_.clear();
+  if (header_index > 0) {
+    const Header &header = headers_[header_index];
+    first_row = header.first_row;
+    last_group = headers_[header_index - 1].text;
+    next_position.setY(header.content_bottom);
+  }
+  else {
+    max_item_height_ = 0;
+  }
+
+  layout_width_ = viewport()->width();
+  headers_.resize(header_index);
+  visual_rects_.resize(first_row);
   visual_rects_.reserve(count);
-  headers_.clear();
 
-  for (int i = 0; i < count; ++i) {
+  for (int i = first_row; i < count; ++i) {
     const QModelIndex idx(model()->index(i, 0));
     const QString group = idx.data(Role_Group).toString();
     const QSize size(rectForIndex(idx).size());
@@ -168,7 +208,8 @@ void GroupedIconView::LayoutItems() {
     if (group != last_group) {
       // Add the group header.
       Header header;
-      header.y = next_position.y() + max_row_height + header_indent_;
+      header.content_bottom = next_position.y() + max_row_height;
+      header.y = header.content_bottom + header_indent_;
       header.first_row = i;
       header.text = group;
 
@@ -212,13 +253,21 @@ void GroupedIconView::LayoutItems() {
     // Update next index
     next_position.setX(this_position.x() + size.width());
     max_row_height = qMax(max_row_height, size.height());
+    max_item_height_ = qMax(max_item_height_, size.height());
   }
 
-  verticalScrollBar()->setRange(0, next_position.y() + max_row_height - viewport()->height());
+  layout_height_ = next_position.y() + max_row_height;
+  UpdateScrollBarRange();
   update();
 
 }
 
+void GroupedIconView::UpdateScrollBarRange() {
+
+  verticalScrollBar()->setRange(0, layout_height_ - viewport()->height());
+
+}
+
 QRect GroupedIconView::visualRect(const QModelIndex &idx) const {
 
   if (idx.row() < 0 || idx.row() >= visual_rects_.count()) {
@@ -232,10 +281,10 @@ QModelIndex GroupedIconView::indexAt(const QPoint &p) const {
 
   const QPoint viewport_p = p + QPoint(horizontalOffset(), verticalOffset());
 
-  const int count = static_cast<int>(visual_rects_.count());
-  for (int i = 0; i < count; ++i) {
-    if (visual_rects_[i].contains(viewport_p)) {
-      return model()->index(i, 0);
+  const QList<QModelIndex> indexes = IntersectingItems(QRect(viewport_p, QSize(1, 1)));
+  for (const QModelIndex &idx : indexes) {
+    if (visual_rects_[idx.row()].contains(viewport_p)) {
+      return idx;
     }
   }
   return QModelIndex();
@@ -305,9 +354,10 @@ void GroupedIconView::paintEvent(QPaintEvent *e) {
     itemDelegate()->paint(&painter, option, *it);
   }
 
-  // Draw headers
-  for (const Header &header : std::as_const(headers_)) {
-    const QRect header_rect = QRect(header_indent_, header.y, viewport()->width() - header_indent_ * 2, header_height());
+  // Draw headers, they are sorted by position so skip the ones above the area we're drawing.
+  QList<Header>::const_iterator header_it = std::lower_bound(headers_.cbegin(), headers_.cend(), viewport_rect.top() - header_height(), [](const Header &header, const int y) { return header.y < y; });
+  for (; header_it != headers_.cend() && header_it->y <= viewport_rect.bottom(); ++header_it) {
+    const QRect header_rect = QRect(header_indent_, header_it->y, viewport()->width() - header_indent_ * 2, header_height());
 
     // Is this header contained in the area we're drawing?
     if (!header_rect.intersects(viewport_rect)) {
@@ -319,7 +369,7 @@ void GroupedIconView::paintEvent(QPaintEvent *e) {
                header_rect.translated(-horizontalOffset(), -verticalOffset()),
                font(),
                palette(),
-               model()->index(header.first_row, 0).data(Role_Group).toString());
+               header_it->text);
   }
 
 }
@@ -343,10 +393,11 @@ QList<QModelIndex> GroupedIconView::IntersectingItems(const QRect rect) const {
 
   QList<QModelIndex> ret;
 
-  const int count = static_cast<int>(visual_rects_.count());
-  for (int i = 0; i < count; ++i) {
-    if (rect.intersects(visual_rects_[i])) {
-      ret.append(model()->index(i, 0));
+  // Items are laid out in lines from top to bottom, so only items with a top edge between rect.top() - max_item_height_ and rect.bottom() can intersect.
+  QList<QRect>::const_iterator it = std::lower_bound(visual_rects_.cbegin(), visual_rects_.cend(), rect.top() - max_item_height_, [](const QRect &visual_rect, const int y) { return visual_rect.top() < y; });
+  for (; it != visual_rects_.cend() && it->top() <= rect.bottom(); ++it) {
+    if (rect.intersects(*it)) {
+      ret.append(model()->index(static_cast<int>(it - visual_rects_.cbegin()), 0));
     }
   }
 
@@ -100,10 +100,16 @@ class GroupedIconView : public QListView {
   void LayoutItems();
 
  private:
+  // Lays out the items from the start of the group containing the row, the items and headers above it are kept.
+  void LayoutItemsFrom(const int row);
+  void UpdateScrollBarRange();
+
   struct Header {
     int y;
     int first_row;
     QString text;
+    // Bottom of the items above the header, where the layout resumes from.
+    int content_bottom;
   };
 
   // Returns the items that are wholly or partially inside the rect.
@@ -115,6 +121,9 @@ class GroupedIconView : public QListView {
   MultiSortFilterProxy *proxy_model_;
   QList<QRect> visual_rects_;
   QList<Header> headers_;
+  int layout_width_;
+  int layout_height_;
+  int max_item_height_;
 
   const int default_header_height_;
   int header_spacing_;
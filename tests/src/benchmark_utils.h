@@ -0,0 +1,105 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef BENCHMARK_UTILS_H
+#define BENCHMARK_UTILS_H
+
+#include <QList>
+#include <QString>
+#include <QStringList>
+#include <QUrl>
+#include <QElapsedTimer>
+#include <QCoreApplication>
+
+#include "core/logging.h"
+#include "core/song.h"
+
+using namespace Qt::Literals::StringLiterals;
+
+// Library sizes to benchmark, override with a comma separated list in STRAWBERRY_BENCHMARK_SIZES, ie: 10000,100000,1000000
+inline QList<int> BenchmarkSizes() {
+
+  QList<int> sizes;
+  const QStringList values = QString::fromLocal8Bit(qgetenv("STRAWBERRY_BENCHMARK_SIZES")).split(u',', Qt::SkipEmptyParts);
+  for (const QString &value : values) {
+    bool ok = false;
+    const int size = value.trimmed().toInt(&ok);
+    if (ok && size > 0) sizes << size;
+  }
+
+  if (sizes.isEmpty()) {
+    sizes << 10000 << 100000;
+  }
+
+  return sizes;
+
+}
+
+// Generates a synthetic collection with 10 songs per album and 10 albums per artist.
+inline SongList MakeBenchmarkSongs(const int count) {
+
+  static const QStringList genres = QStringList() << u"Rock"_s << u"Pop"_s << u"Jazz"_s << u"Classical"_s << u"Electronic"_s << u"Folk"_s;
+
+  SongList songs;
+  songs.reserve(count);
+  for (int i = 0; i < count; ++i) {
+    const int album_number = i / 10;
+    const int artist_number = album_number / 10;
+    const QString artist = u"Artist %1"_s.arg(artist_number);
+    const QString album = u"Album %1"_s.arg(album_number);
+    Song song(Song::Source::Collection);
+    song.Init(u"Title %1"_s.arg(i), artist, album, 180000000000LL + (i % 120) * 1000000000LL);
+    song.set_albumartist(artist);
+    song.set_track((i % 10) + 1);
+    song.set_year(1960 + (album_number % 60));
+    song.set_genre(genres[artist_number % genres.count()]);
+    song.set_directory_id(1);
+    song.set_url(QUrl::fromLocalFile(u"/music/%1/%2/%3.flac"_s.arg(artist, album).arg(i)));
+    song.set_mtime(1);
+    song.set_ctime(1);
+    song.set_filesize(1);
+    song.set_valid(true);
+    songs << song;
+  }
+
+  return songs;
+
+}
+
+inline void BenchmarkResult(const char *name, const int count, const QElapsedTimer &timer) {
+  qLog(Info) << name << "with" << count << "songs took" << timer.elapsed() << "ms";
+}
+
+// Runs the event loop until the condition is met or the timeout is reached.
+template<typename Condition>
+inline bool BenchmarkWaitFor(Condition condition, const qint64 timeout_msec = 600000) {
+
+  QElapsedTimer timer;
+  timer.start();
+  while (!condition()) {
+    if (timer.elapsed() > timeout_msec) return false;
+    QCoreApplication::processEvents(QEventLoop::AllEvents, 100);
+  }
+
+  return true;
+
+}
+
+#endif  // BENCHMARK_UTILS_H
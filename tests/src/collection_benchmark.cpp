@@ -0,0 +1,137 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <memory>
+
+#include "gtest_include.h"
+
+#include <QElapsedTimer>
+#include <QScopedPointer>
+#include <QModelIndex>
+
+#include "includes/scoped_ptr.h"
+#include "includes/shared_ptr.h"
+#include "core/song.h"
+#include "core/memorydatabase.h"
+#include "collection/collectionlibrary.h"
+#include "collection/collectionbackend.h"
+#include "collection/collectionmodel.h"
+#include "filterparser/filterparser.h"
+#include "filterparser/filtertree.h"
+
+#include "benchmark_utils.h"
+
+using namespace Qt::Literals::StringLiterals;
+using std::make_unique;
+using std::make_shared;
+
+// clazy:excludeall=non-pod-global-static,returning-void-expression
+
+namespace {
+
+class CollectionBenchmark : public ::testing::TestWithParam<int> {
+ protected:
+  void SetUp() override {
+    database_ = make_shared<MemoryDatabase>(nullptr);
+    backend_ = make_shared<CollectionBackend>();
+    backend_->Init(database_, nullptr, Song::Source::Collection, QLatin1String(CollectionLibrary::kSongsTable), QLatin1String(CollectionLibrary::kDirsTable), QLatin1String(CollectionLibrary::kSubdirsTable));
+    backend_->AddDirectory(u"/music"_s);
+    songs_ = MakeBenchmarkSongs(GetParam());
+  }
+
+  void AddSongs() {
+    backend_->AddOrUpdateSongs(songs_);
+  }
+
+  void LoadModel() {
+    model_ = make_unique<CollectionModel>(backend_, nullptr);
+    model_->Reset();
+    ASSERT_TRUE(BenchmarkWaitFor([this]() { return model_->song_nodes().count() == songs_.count(); }));
+  }
+
+  SharedPtr<Database> database_;  // NOLINT(cppcoreguidelines-non-private-member-variables-in-classes)
+  SharedPtr<CollectionBackend> backend_;  // NOLINT(cppcoreguidelines-non-private-member-variables-in-classes)
+  ScopedPtr<CollectionModel> model_;  // NOLINT(cppcoreguidelines-non-private-member-variables-in-classes)
+  SongList songs_;  // NOLINT(cppcoreguidelines-non-private-member-variables-in-classes)
+};
+
+TEST_P(CollectionBenchmark, AddOrUpdateSongs) {
+
+  QElapsedTimer timer;
+  timer.start();
+  AddSongs();
+  BenchmarkResult("CollectionBackend::AddOrUpdateSongs", GetParam(), timer);
+
+  EXPECT_EQ(GetParam(), backend_->GetAllSongs().count());
+
+}
+
+TEST_P(CollectionBenchmark, ModelReset) {
+
+  AddSongs();
+
+  QElapsedTimer timer;
+  timer.start();
+  LoadModel();
+  BenchmarkResult("CollectionModel::Reset", GetParam(), timer);
+
+}
+
+TEST_P(CollectionBenchmark, GetChildSongs) {
+
+  AddSongs();
+  LoadModel();
+
+  QModelIndexList indexes;
+  for (int row = 0; row < model_->rowCount(QModelIndex()); ++row) {
+    indexes << model_->index(row, 0, QModelIndex());
+  }
+
+  QElapsedTimer timer;
+  timer.start();
+  const SongList songs = model_->GetChildSongs(indexes);
+  BenchmarkResult("CollectionModel::GetChildSongs", GetParam(), timer);
+
+  EXPECT_EQ(GetParam(), songs.count());
+
+}
+
+TEST_P(CollectionBenchmark, FilterParseAndAccept) {
+
+  const QStringList filters = QStringList() << u"title 1"_s << u"artist:\"Artist 1\""_s << u"genre:rock year:>1980"_s << u"album:5 OR title:9"_s << u"-artist:3 length:>3:00"_s;
+
+  QElapsedTimer timer;
+  timer.start();
+  int accepted = 0;
+  for (const QString &filter : filters) {
+    FilterParser p(filter);
+    QScopedPointer<FilterTree> filter_tree(p.parse());
+    for (const Song &song : std::as_const(songs_)) {
+      if (filter_tree->accept(song)) ++accepted;
+    }
+  }
+  BenchmarkResult("FilterParser::parse and FilterTree::accept", GetParam(), timer);
+
+  EXPECT_GT(accepted, 0);
+
+}
+
+INSTANTIATE_TEST_SUITE_P(Sizes, CollectionBenchmark, ::testing::ValuesIn(BenchmarkSizes()));
+
+}  // namespace
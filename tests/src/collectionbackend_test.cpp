@@ -19,11 +19,17 @@
  *
  */
 
+#include "config.h"
+
 #include <memory>
+#include <algorithm>
+#include <optional>
+#include <utility>
 
 #include "gtest_include.h"
 
 #include <QFileInfo>
+#include <QPair>
 #include <QSignalSpy>
 #include <QThread>
 #include <QtDebug>
@@ -31,10 +37,18 @@
 #include "includes/scoped_ptr.h"
 #include "includes/shared_ptr.h"
 #include "core/song.h"
+#include "core/songbatch.h"
 #include "core/memorydatabase.h"
 #include "constants/timeconstants.h"
+#include "core/sqlquery.h"
 #include "collection/collectionbackend.h"
 #include "collection/collectionlibrary.h"
+#include "collection/collectionquery.h"
+#include "collection/fingerprintindex.h"
+
+#ifdef HAVE_CHROMAPRINT
+#  include <chromaprint.h>
+#endif
 
 using namespace Qt::Literals::StringLiterals;
 using std::make_unique;
@@ -114,6 +128,34 @@ TEST_F(CollectionBackendTest, RemoveDirectory) {
 
 }
 
+TEST_F(CollectionBackendTest, SubdirAlbumArt) {
+
+  backend_->AddDirectory(u"/tmp"_s);
+
+  CollectionSubdirectory subdir;
+  subdir.directory_id = 1;
+  subdir.path = u"/tmp/album"_s;
+  subdir.mtime = 1;
+  subdir.art_automatic = u"/tmp/album/front.jpg"_s;
+  backend_->AddOrUpdateSubdirs(CollectionSubdirectoryList() << subdir);
+
+  CollectionSubdirectoryList subdirs = backend_->SubdirsInDirectory(1);
+  ASSERT_EQ(1, subdirs.count());
+  EXPECT_EQ(1, subdirs[0].mtime);
+  EXPECT_EQ(u"/tmp/album/front.jpg"_s, subdirs[0].art_automatic);
+
+  // Updating the subdirectory replaces the album art
+  subdir.mtime = 2;
+  subdir.art_automatic.clear();
+  backend_->AddOrUpdateSubdirs(CollectionSubdirectoryList() << subdir);
+
+  subdirs = backend_->SubdirsInDirectory(1);
+  ASSERT_EQ(1, subdirs.count());
+  EXPECT_EQ(2, subdirs[0].mtime);
+  EXPECT_TRUE(subdirs[0].art_automatic.isEmpty());
+
+}
+
 TEST_F(CollectionBackendTest, GetAlbumArtNonExistent) {}
 
 // Test adding a single song to the database, then getting various information back about it.
@@ -144,7 +186,7 @@ class SingleSong : public CollectionBackendTest {
     EXPECT_EQ(0, deleted_spy.count());
     ASSERT_EQ(1, added_spy.count());
 
-    SongList list = *(reinterpret_cast<SongList*>(added_spy[0][0].data()));
+    SongList list = added_spy[0][0].value<SongBatch>().songs();
     ASSERT_EQ(1, list.count());
     EXPECT_EQ(song_.title(), list[0].title());
     EXPECT_EQ(song_.artist(), list[0].artist());
@@ -231,6 +273,81 @@ TEST_F(SingleSong, GetSongs) {
 
 }
 
+TEST_F(SingleSong, CachedTotals) {
+
+  AddDummySong();
+  if (HasFatalFailure()) return;
+
+  EXPECT_EQ(1, backend_->GetAllArtists().size());
+  EXPECT_EQ(1, backend_->GetAllAlbums().size());
+
+  QSignalSpy song_count_spy(&*backend_, &CollectionBackend::TotalSongCountUpdated);
+  QSignalSpy artist_count_spy(&*backend_, &CollectionBackend::TotalArtistCountUpdated);
+  QSignalSpy album_count_spy(&*backend_, &CollectionBackend::TotalAlbumCountUpdated);
+  backend_->UpdateTotalSongCount();
+  backend_->UpdateTotalArtistCount();
+  backend_->UpdateTotalAlbumCount();
+
+  // The second song is added to the cached totals and the cached query results are dropped.
+  Song song2 = MakeDummySong(1);
+  song2.set_title(u"Title 2"_s);
+  song2.set_artist(u"Artist 2"_s);
+  song2.set_album(u"Album 2"_s);
+  song2.set_url(QUrl::fromLocalFile(u"bar.flac"_s));
+  backend_->AddOrUpdateSongs(SongList() << song2);
+
+  EXPECT_EQ(2, backend_->GetAllArtists().size());
+  EXPECT_EQ(2, backend_->GetAllAlbums().size());
+
+  backend_->UpdateTotalSongCount();
+  backend_->UpdateTotalArtistCount();
+  backend_->UpdateTotalAlbumCount();
+
+  ASSERT_EQ(2, song_count_spy.count());
+  ASSERT_EQ(2, artist_count_spy.count());
+  ASSERT_EQ(2, album_count_spy.count());
+  EXPECT_EQ(1, song_count_spy[0][0].toInt());
+  EXPECT_EQ(2, song_count_spy[1][0].toInt());
+  EXPECT_EQ(1, artist_count_spy[0][0].toInt());
+  EXPECT_EQ(2, artist_count_spy[1][0].toInt());
+  EXPECT_EQ(1, album_count_spy[0][0].toInt());
+  EXPECT_EQ(2, album_count_spy[1][0].toInt());
+
+}
+
+TEST_F(SingleSong, GetCompleteSongs) {
+
+  song_.set_lyrics(u"Lyrics"_s);
+  song_.set_musicbrainz_track_id(u"Track ID"_s);
+  AddDummySong();
+  if (HasFatalFailure()) return;
+
+  SongList songs;
+  {
+    QSqlDatabase db(database_->Connect());
+    CollectionQuery q(db, QLatin1String(CollectionLibrary::kSongsTable));
+    q.SetSongColumns(Song::kDetailColumns);
+    ASSERT_TRUE(q.Exec());
+    while (q.Next()) {
+      Song song;
+      song.InitFromQuery(q, true);
+      song.set_incomplete(true);
+      songs << song;
+    }
+  }
+  ASSERT_EQ(1, songs.count());
+  EXPECT_EQ(song_.title(), songs[0].title());
+  EXPECT_TRUE(songs[0].lyrics().isEmpty());
+  EXPECT_TRUE(songs[0].musicbrainz_track_id().isEmpty());
+
+  songs = backend_->GetCompleteSongs(songs);
+  ASSERT_EQ(1, songs.count());
+  EXPECT_FALSE(songs[0].is_incomplete());
+  EXPECT_EQ(u"Lyrics"_s, songs[0].lyrics());
+  EXPECT_EQ(u"Track ID"_s, songs[0].musicbrainz_track_id());
+
+}
+
 TEST_F(SingleSong, GetSongById) {
 
   AddDummySong();
@@ -244,6 +361,79 @@ TEST_F(SingleSong, GetSongById) {
 
 }
 
+TEST_F(SingleSong, LongLyrics) {
+
+  const QString lyrics = u"Line\n"_s.repeated(Song::kLongTextMinSize);
+  song_.set_lyrics(lyrics);
+  AddDummySong();
+  if (HasFatalFailure()) return;
+
+  {
+    QSqlDatabase db(database_->Connect());
+    SqlQuery q(db);
+    q.prepare(u"SELECT songs.lyrics, songs_text.lyrics FROM songs LEFT JOIN songs_text ON songs_text.song_id = songs.ROWID WHERE songs.ROWID = 1"_s);
+    ASSERT_TRUE(q.Exec());
+    ASSERT_TRUE(q.next());
+    EXPECT_TRUE(q.value(0).isNull());
+    EXPECT_FALSE(q.value(1).isNull());
+  }
+
+  EXPECT_EQ(lyrics, backend_->GetSongById(1).lyrics());
+
+  // Shorter lyrics are stored in the songs table again.
+  Song new_song(song_);
+  new_song.set_id(1);
+  new_song.set_lyrics(u"Lyrics"_s);
+  backend_->AddOrUpdateSongs(SongList() << new_song);
+
+  {
+    QSqlDatabase db(database_->Connect());
+    SqlQuery q(db);
+    q.prepare(u"SELECT COUNT(*) FROM songs_text"_s);
+    ASSERT_TRUE(q.Exec());
+    ASSERT_TRUE(q.next());
+    EXPECT_EQ(0, q.value(0).toInt());
+  }
+
+  EXPECT_EQ(u"Lyrics"_s, backend_->GetSongById(1).lyrics());
+
+}
+
+TEST_F(SingleSong, MetadataDigest) {
+
+  AddDummySong();
+  if (HasFatalFailure()) return;
+
+  Song song = backend_->GetSongById(1);
+  EXPECT_EQ(song_.metadata_digest(), song.metadata_digest());
+  EXPECT_TRUE(song.IsMetadataEqual(song_));
+
+  Song changed_song(song);
+  changed_song.set_title(u"A different title"_s);
+  EXPECT_NE(song.metadata_digest(), changed_song.metadata_digest());
+  EXPECT_FALSE(song.IsMetadataEqual(changed_song));
+
+  changed_song.set_title(song_.title());
+  EXPECT_EQ(song.metadata_digest(), changed_song.metadata_digest());
+  EXPECT_TRUE(song.IsMetadataEqual(changed_song));
+
+}
+
+TEST_F(SingleSong, SearchSongIds) {
+
+  AddDummySong();
+  if (HasFatalFailure()) return;
+
+  std::optional<QSet<int>> song_ids = backend_->SearchSongIds(u"\"rtis\""_s);
+  ASSERT_TRUE(song_ids.has_value());
+  EXPECT_TRUE(song_ids->contains(1));
+
+  song_ids = backend_->SearchSongIds(u"\"nothing\""_s);
+  ASSERT_TRUE(song_ids.has_value());
+  EXPECT_TRUE(song_ids->isEmpty());
+
+}
+
 TEST_F(SingleSong, FindSongsInDirectory) {
 
   AddDummySong();
@@ -277,7 +467,7 @@ TEST_F(SingleSong, UpdateSong) {
   ASSERT_EQ(1, changed_spy.size());
   ASSERT_EQ(0, deleted_spy.size());
 
-  SongList songs_changed = *(reinterpret_cast<SongList*>(changed_spy[0][0].data()));
+  SongList songs_changed = changed_spy[0][0].value<SongBatch>().songs();
   ASSERT_EQ(1, songs_changed.size());
   EXPECT_EQ(u"A different title"_s, songs_changed[0].title());
   EXPECT_EQ(1, songs_changed[0].id());
@@ -298,7 +488,7 @@ TEST_F(SingleSong, DeleteSongs) {
 
   ASSERT_EQ(1, deleted_spy.size());
 
-  SongList songs_deleted = *(reinterpret_cast<SongList*>(deleted_spy[0][0].data()));
+  SongList songs_deleted = deleted_spy[0][0].value<SongBatch>().songs();
   ASSERT_EQ(1, songs_deleted.size());
   EXPECT_EQ(u"Title"_s, songs_deleted[0].title());
   EXPECT_EQ(1, songs_deleted[0].id());
@@ -331,7 +521,7 @@ TEST_F(SingleSong, MarkSongsUnavailable) {
 
   ASSERT_EQ(1, deleted_spy.size());
 
-  SongList songs_deleted = *(reinterpret_cast<SongList*>(deleted_spy[0][0].data()));
+  SongList songs_deleted = deleted_spy[0][0].value<SongBatch>().songs();
   ASSERT_EQ(1, songs_deleted.size());
   EXPECT_EQ(u"Title"_s, songs_deleted[0].title());
   EXPECT_EQ(1, songs_deleted[0].id());
@@ -350,6 +540,41 @@ TEST_F(SingleSong, MarkSongsUnavailable) {
 
 }
 
+TEST_F(SingleSong, FlushStatistics) {
+
+  AddDummySong();
+  if (HasFatalFailure()) return;
+
+  QSignalSpy statistics_spy(&*backend_, &CollectionBackend::SongsStatisticsChanged);
+  QSignalSpy rating_spy(&*backend_, &CollectionBackend::SongsRatingChanged);
+
+  backend_->IncrementPlayCount(1);
+  backend_->IncrementPlayCount(1);
+  backend_->IncrementSkipCount(1, 0.5F);
+  backend_->UpdateSongRating(1, 0.8F);
+
+  // Nothing is written until the buffer is flushed.
+  EXPECT_EQ(0, statistics_spy.count());
+  EXPECT_EQ(0, rating_spy.count());
+  EXPECT_EQ(0U, backend_->GetSongById(1).playcount());
+
+  backend_->FlushStatistics();
+
+  ASSERT_EQ(1, statistics_spy.count());
+  SongList songs = statistics_spy[0][0].value<SongList>();
+  ASSERT_EQ(1, songs.count());
+  EXPECT_EQ(2U, songs[0].playcount());
+  EXPECT_EQ(1U, songs[0].skipcount());
+  EXPECT_GT(songs[0].lastplayed(), 0);
+
+  ASSERT_EQ(1, rating_spy.count());
+  songs = rating_spy[0][0].value<SongList>();
+  ASSERT_EQ(1, songs.count());
+  EXPECT_FLOAT_EQ(0.8F, songs[0].rating());
+  EXPECT_FALSE(rating_spy[0][1].toBool());
+
+}
+
 class TestUrls : public CollectionBackendTest {
  protected:
   void SetUp() override {
@@ -395,7 +620,7 @@ TEST_F(TestUrls, TestUrls) {
   if (HasFatalFailure()) return;
 
   ASSERT_EQ(1, spy.count());
-  SongList new_songs = spy[0][0].value<SongList>();
+  SongList new_songs = spy[0][0].value<SongBatch>().songs();
   EXPECT_EQ(new_songs.count(), strings.count());
 
   for (const QUrl &url : urls) {
@@ -479,7 +704,7 @@ TEST_F(UpdateSongsBySongID, UpdateSongsBySongID) {
     backend_->UpdateSongsBySongID(songs);
 
     ASSERT_EQ(1, spy.count());
-    SongList new_songs = spy[0][0].value<SongList>();
+    SongList new_songs = spy[0][0].value<SongBatch>().songs();
     EXPECT_EQ(new_songs.count(), song_ids.count());
     EXPECT_EQ(song_ids[0], new_songs[0].song_id());
     EXPECT_EQ(song_ids[1], new_songs[1].song_id());
@@ -549,7 +774,7 @@ TEST_F(UpdateSongsBySongID, UpdateSongsBySongID) {
 
     ASSERT_EQ(0, spy1.count());
     ASSERT_EQ(1, spy2.count());
-    SongList deleted_songs = spy2[0][0].value<SongList>();
+    SongList deleted_songs = spy2[0][0].value<SongBatch>().songs();
     EXPECT_EQ(deleted_songs.count(), 2);
     EXPECT_EQ(deleted_songs[0].song_id(), u"song2"_s);
     EXPECT_EQ(deleted_songs[1].song_id(), u"song3"_s);
@@ -600,7 +825,7 @@ TEST_F(UpdateSongsBySongID, UpdateSongsBySongID) {
     ASSERT_EQ(0, spy2.count());
     ASSERT_EQ(1, spy3.count());
 
-    SongList changed_songs = spy3[0][0].value<SongList>();
+    SongList changed_songs = spy3[0][0].value<SongBatch>().songs();
     EXPECT_EQ(changed_songs.count(), 2);
     EXPECT_EQ(changed_songs[0].song_id(), u"song1"_s);
     EXPECT_EQ(changed_songs[1].song_id(), u"song6"_s);
@@ -609,4 +834,262 @@ TEST_F(UpdateSongsBySongID, UpdateSongsBySongID) {
 
 }
 
+TEST_F(CollectionBackendTest, CompilationsNeedUpdating) {
+
+  backend_->AddDirectory(u"/tmp"_s);
+
+  SongList songs;
+  for (const QString &artist : {u"Artist 1"_s, u"Artist 2"_s}) {
+    Song song = MakeDummySong(1);
+    song.set_title(artist);
+    song.set_artist(artist);
+    song.set_album(u"Album"_s);
+    song.set_url(QUrl::fromLocalFile(u"/tmp/album/"_s + artist + u".flac"_s));
+    songs << song;
+  }
+  backend_->AddOrUpdateSongs(songs);
+
+  QSignalSpy spy(&*backend_, &CollectionBackend::SongsChanged);
+
+  // Both songs are in the same directory with different artists, so the album is a compilation.
+  backend_->CompilationsNeedUpdating();
+  ASSERT_EQ(1, spy.count());
+  SongList changed_songs = spy[0][0].value<SongBatch>().songs();
+  ASSERT_EQ(2, changed_songs.count());
+  EXPECT_TRUE(changed_songs[0].compilation_detected());
+  EXPECT_TRUE(changed_songs[1].compilation_detected());
+
+  // Nothing changed since, so no albums are checked again.
+  backend_->CompilationsNeedUpdating();
+  EXPECT_EQ(1, spy.count());
+
+}
+
+TEST_F(CollectionBackendTest, ManySongs) {
+
+  backend_->AddDirectory(u"/tmp"_s);
+
+  // More songs than SQLite allows bound variables in a statement.
+  SongList songs;
+  for (int i = 0; i < 1500; ++i) {
+    Song song = MakeDummySong(1);
+    song.set_title(u"Title %1"_s.arg(i));
+    song.set_url(QUrl::fromLocalFile(u"/tmp/%1.flac"_s.arg(i)));
+    songs << song;
+  }
+  QSignalSpy added_spy(&*backend_, &CollectionBackend::SongsAdded);
+  backend_->AddOrUpdateSongs(songs);
+  ASSERT_EQ(1, added_spy.count());
+  songs = added_spy[0][0].value<SongBatch>().songs();
+  ASSERT_EQ(1500, songs.count());
+
+  QList<int> ids;
+  QList<QUrl> urls;
+  for (const Song &song : std::as_const(songs)) {
+    ids << song.id();
+    urls << song.url();
+  }
+  EXPECT_EQ(1500, backend_->GetSongsById(ids).count());
+  EXPECT_EQ(1500, backend_->GetSongsByUrls(urls).count());
+
+  backend_->MarkSongsUnavailable(songs.mid(0, 1000));
+  EXPECT_EQ(500, backend_->GetSongsByUrls(urls).count());
+  EXPECT_EQ(1000, backend_->GetSongsByUrls(urls, true).count());
+
+  backend_->DeleteSongs(songs);
+  EXPECT_TRUE(backend_->GetSongsById(ids).isEmpty());
+
+}
+
+// Returns a fingerprint of random sub-fingerprints, and a copy shifted by 2 with some bits flipped, like another encoding of the same audio.
+QPair<FingerprintIndex::RawFingerprint, FingerprintIndex::RawFingerprint> MakeSimilarFingerprints(quint32 seed) {
+
+  FingerprintIndex::RawFingerprint fingerprint1;
+  for (int i = 0; i < 500; ++i) {
+    seed = seed * 1664525U + 1013904223U;
+    fingerprint1 << seed;
+  }
+  FingerprintIndex::RawFingerprint fingerprint2 = fingerprint1.mid(2);
+  for (qsizetype i = 0; i < fingerprint2.count(); i += 8) {
+    fingerprint2[i] ^= 1U << (i % 32);
+  }
+
+  return qMakePair(fingerprint1, fingerprint2);
+
+}
+
+TEST(FingerprintIndexTest, Similarity) {
+
+  const QPair<FingerprintIndex::RawFingerprint, FingerprintIndex::RawFingerprint> similar = MakeSimilarFingerprints(1);
+  const FingerprintIndex::RawFingerprint unrelated = MakeSimilarFingerprints(2).first;
+
+  EXPECT_GT(FingerprintIndex::Similarity(similar.first, similar.second), FingerprintIndex::kDuplicateSimilarity);
+  EXPECT_LT(FingerprintIndex::Similarity(similar.first, unrelated), 0.6);
+  // Too short to cover the longer fingerprint.
+  EXPECT_EQ(0.0, FingerprintIndex::Similarity(similar.first, similar.first.mid(0, 100)));
+
+  const QList<qint64> bands = FingerprintIndex::Bands(similar.first);
+  const QList<qint64> similar_bands = FingerprintIndex::Bands(similar.second);
+  const QList<qint64> unrelated_bands = FingerprintIndex::Bands(unrelated);
+  EXPECT_FALSE(bands.isEmpty());
+  EXPECT_TRUE(std::any_of(bands.begin(), bands.end(), [&similar_bands](const qint64 band) { return similar_bands.contains(band); }));
+  EXPECT_TRUE(std::none_of(bands.begin(), bands.end(), [&unrelated_bands](const qint64 band) { return unrelated_bands.contains(band); }));
+  EXPECT_TRUE(FingerprintIndex::Bands(FingerprintIndex::RawFingerprint()).isEmpty());
+
+}
+
+#ifdef HAVE_CHROMAPRINT
+
+TEST_F(CollectionBackendTest, FingerprintDuplicates) {
+
+  const auto encode = [](const FingerprintIndex::RawFingerprint &raw) {
+    char *encoded = nullptr;
+    int encoded_size = 0;
+    chromaprint_encode_fingerprint(raw.constData(), static_cast<int>(raw.count()), CHROMAPRINT_ALGORITHM_DEFAULT, &encoded, &encoded_size, 1);
+    const QString ret = QString::fromLatin1(encoded, encoded_size);
+    chromaprint_dealloc(encoded);
+    return ret;
+  };
+
+  backend_->AddDirectory(u"/tmp"_s);
+
+  const QPair<FingerprintIndex::RawFingerprint, FingerprintIndex::RawFingerprint> similar = MakeSimilarFingerprints(1);
+  const QStringList fingerprints = QStringList() << encode(similar.first) << encode(MakeSimilarFingerprints(2).first) << encode(similar.second) << u"NONE"_s;
+  SongList songs;
+  for (int i = 0; i < fingerprints.count(); ++i) {
+    Song song = MakeDummySong(1);
+    song.set_title(u"Title %1"_s.arg(i));
+    song.set_url(QUrl::fromLocalFile(u"/tmp/%1.flac"_s.arg(i)));
+    song.set_fingerprint(fingerprints[i]);
+    songs << song;
+  }
+  backend_->AddOrUpdateSongs(songs);
+
+  QList<SongList> duplicates = backend_->GetFingerprintDuplicates();
+  ASSERT_EQ(1, duplicates.count());
+  ASSERT_EQ(2, duplicates[0].count());
+  EXPECT_EQ(u"Title 0"_s, duplicates[0][0].title());
+  EXPECT_EQ(u"Title 2"_s, duplicates[0][1].title());
+
+  // Changing the fingerprint removes the song from the index.
+  Song changed_song = duplicates[0][1];
+  changed_song.set_fingerprint(fingerprints[1]);
+  backend_->AddOrUpdateSongs(SongList() << changed_song);
+  duplicates = backend_->GetFingerprintDuplicates();
+  ASSERT_EQ(1, duplicates.count());
+  ASSERT_EQ(2, duplicates[0].count());
+  EXPECT_EQ(u"Title 1"_s, duplicates[0][0].title());
+  EXPECT_EQ(u"Title 2"_s, duplicates[0][1].title());
+
+}
+
+#endif  // HAVE_CHROMAPRINT
+
+// Check that the hot collection queries are answered from an index instead of reading the whole songs table.
+class QueryPlan : public CollectionBackendTest {
+ protected:
+  // Returns the steps of the query plan that scan the songs table without an index.
+  static QStringList FullTableScans(SqlQuery &q) {
+    EXPECT_TRUE(q.Exec()) << q.LastQuery().toStdString();
+    QStringList scans;
+    while (q.next()) {
+      const QString detail = q.value(3).toString();
+      if (detail.startsWith("SCAN"_L1) && !detail.contains("INDEX"_L1)) {
+        scans << detail;
+      }
+    }
+    return scans;
+  }
+
+  QStringList FullTableScans(const CollectionQuery &query) {
+    QSqlDatabase db(database_->Connect());
+    SqlQuery q(db);
+    q.prepare(u"EXPLAIN QUERY PLAN "_s + query.GetQuery());
+    const QVariantList bound_values = query.bound_values();
+    for (const QVariant &value : bound_values) {
+      q.addBindValue(value);
+    }
+    return FullTableScans(q);
+  }
+
+  CollectionQuery MakeQuery() {
+    return CollectionQuery(database_->Connect(), QLatin1String(CollectionLibrary::kSongsTable));
+  }
+};
+
+TEST_F(QueryPlan, GetAllArtistsWithAlbums) {
+
+  CollectionQuery query = MakeQuery();
+  query.SetColumnSpec(u"DISTINCT albumartist"_s);
+  query.AddCompilationRequirement(false);
+  query.AddWhere(u"album"_s, ""_L1, u"!="_s);
+  EXPECT_EQ(QStringList(), FullTableScans(query));
+
+  CollectionQuery query2 = MakeQuery();
+  query2.SetColumnSpec(u"DISTINCT artist"_s);
+  query2.AddCompilationRequirement(false);
+  query2.AddWhere(u"album"_s, ""_L1, u"!="_s);
+  query2.AddWhere(u"albumartist"_s, ""_L1, u"="_s);
+  EXPECT_EQ(QStringList(), FullTableScans(query2));
+
+}
+
+TEST_F(QueryPlan, GetAlbums) {
+
+  const QString column_spec = u"url, filetype, cue_path, effective_albumartist, album, compilation_effective, art_embedded, art_automatic, art_manual, art_unset"_s;
+  const QString order_by = u"effective_albumartist, album, url"_s;
+
+  CollectionQuery query_all = MakeQuery();
+  query_all.SetColumnSpec(column_spec);
+  query_all.SetOrderBy(order_by);
+  EXPECT_EQ(QStringList(), FullTableScans(query_all));
+
+  CollectionQuery query_compilations = MakeQuery();
+  query_compilations.SetColumnSpec(column_spec);
+  query_compilations.SetOrderBy(order_by);
+  query_compilations.AddCompilationRequirement(true);
+  EXPECT_EQ(QStringList(), FullTableScans(query_compilations));
+
+  CollectionQuery query_artist = MakeQuery();
+  query_artist.SetColumnSpec(column_spec);
+  query_artist.SetOrderBy(order_by);
+  query_artist.AddCompilationRequirement(false);
+  query_artist.AddWhere(u"effective_albumartist"_s, u"Artist"_s);
+  EXPECT_EQ(QStringList(), FullTableScans(query_artist));
+
+}
+
+TEST_F(QueryPlan, GetCompilationSongs) {
+
+  CollectionQuery query = MakeQuery();
+  query.SetColumnSpec(u"%songs_table.ROWID, "_s + Song::kColumnSpec);
+  query.AddCompilationRequirement(true);
+  query.AddWhere(u"album"_s, u"Album"_s);
+  EXPECT_EQ(QStringList(), FullTableScans(query));
+
+}
+
+TEST_F(QueryPlan, GetSongsByUrl) {
+
+  QSqlDatabase db(database_->Connect());
+  SqlQuery q(db);
+  q.prepare(QStringLiteral("EXPLAIN QUERY PLAN SELECT %1 FROM %2 WHERE (url = :url1 OR url = :url2 OR url = :url3 OR url = :url4) AND unavailable = :unavailable").arg(Song::kRowIdColumnSpec, QLatin1String(CollectionLibrary::kSongsTable)));
+  q.BindValue(u":url1"_s, u"file:///foo.flac"_s);
+  q.BindValue(u":url2"_s, u"file:///foo.flac"_s);
+  q.BindValue(u":url3"_s, u"file:///foo.flac"_s);
+  q.BindValue(u":url4"_s, u"file:///foo.flac"_s);
+  q.BindValue(u":unavailable"_s, 0);
+  EXPECT_EQ(QStringList(), FullTableScans(q));
+
+}
+
+TEST_F(QueryPlan, CompilationsNeedUpdating) {
+
+  QSqlDatabase db(database_->Connect());
+  SqlQuery q(db);
+  q.prepare(QStringLiteral("EXPLAIN QUERY PLAN SELECT effective_albumartist, album, url, compilation_detected FROM %1 WHERE unavailable = 0 ORDER BY album").arg(QLatin1String(CollectionLibrary::kSongsTable)));
+  EXPECT_EQ(QStringList(), FullTableScans(q));
+
+}
+
 } // namespace
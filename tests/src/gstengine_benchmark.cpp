@@ -0,0 +1,358 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <memory>
+#include <algorithm>
+#include <iterator>
+#include <optional>
+
+#include <gst/gst.h>
+
+#include "gtest_include.h"
+
+#include <QObject>
+#include <QList>
+#include <QSet>
+#include <QByteArray>
+#include <QString>
+#include <QUrl>
+#include <QFile>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QElapsedTimer>
+#include <QJsonValue>
+#include <QJsonObject>
+#include <QJsonDocument>
+
+#include "includes/shared_ptr.h"
+#include "core/logging.h"
+#include "core/settings.h"
+#include "core/taskmanager.h"
+#include "constants/backendsettings.h"
+#include "constants/timeconstants.h"
+#include "engine/enginebase.h"
+#include "engine/gststartup.h"
+#include "engine/gstengine.h"
+#include "engine/gstbufferconsumer.h"
+
+#include "test_utils.h"
+#include "benchmark_utils.h"
+
+using namespace Qt::Literals::StringLiterals;
+using std::make_shared;
+using std::make_unique;
+
+// clazy:excludeall=non-pod-global-static,returning-void-expression
+
+namespace {
+
+constexpr qint64 kTimeoutMsec = 10000;
+// Longer than the delay GstEngine keeps between two seeks.
+constexpr qint64 kSeekDelayMsec = 150;
+
+const char *kFormats[] = { "wav", "flac", "wv", "oga", "ogg", "opus", "spx", "aif", "asf", "mp3", "m4a", "mp4" };
+
+// Number of times each latency is measured, override with STRAWBERRY_BENCHMARK_ITERATIONS.
+int BenchmarkIterations() {
+
+  bool ok = false;
+  const int iterations = qEnvironmentVariableIntValue("STRAWBERRY_BENCHMARK_ITERATIONS", &ok);
+  return ok && iterations > 0 ? iterations : 5;
+
+}
+
+// Collects the buffers going into the audio sink of one pipeline.
+class BufferRecorder : public GstBufferConsumer {
+ public:
+  BufferRecorder() : pipeline_id_(-1), first_buffer_nanosec_(-1), duration_nanosec_(0) {}
+
+  void ConsumeBuffer(GstBuffer *buffer, const int pipeline_id, const QString &format) override {
+
+    Q_UNUSED(format)
+
+    {
+      QMutexLocker l(&mutex_);
+      // Buffers from pipelines that were already measured can still arrive while they are shut down.
+      if (pipeline_id_ == -1 && !finished_pipeline_ids_.contains(pipeline_id)) {
+        pipeline_id_ = pipeline_id;
+      }
+      if (pipeline_id == pipeline_id_) {
+        if (first_buffer_nanosec_ == -1) {
+          first_buffer_nanosec_ = timer_.nsecsElapsed();
+        }
+        if (GST_BUFFER_DURATION_IS_VALID(buffer)) {
+          duration_nanosec_ += static_cast<qint64>(GST_BUFFER_DURATION(buffer));
+        }
+      }
+    }
+
+    gst_buffer_unref(buffer);
+
+  }
+
+  // Starts recording the next pipeline.
+  void Reset() {
+
+    QMutexLocker l(&mutex_);
+    if (pipeline_id_ != -1) {
+      finished_pipeline_ids_.insert(pipeline_id_);
+    }
+    pipeline_id_ = -1;
+    first_buffer_nanosec_ = -1;
+    duration_nanosec_ = 0;
+    timer_.start();
+
+  }
+
+  // Waits for the next buffer of the same pipeline.
+  void ResetFirstBuffer() {
+
+    QMutexLocker l(&mutex_);
+    first_buffer_nanosec_ = -1;
+    timer_.start();
+
+  }
+
+  qint64 first_buffer_nanosec() const {
+    QMutexLocker l(&mutex_);
+    return first_buffer_nanosec_;
+  }
+
+  qint64 duration_nanosec() const {
+    QMutexLocker l(&mutex_);
+    return duration_nanosec_;
+  }
+
+ private:
+  mutable QMutex mutex_;
+  QElapsedTimer timer_;
+  int pipeline_id_;
+  QSet<int> finished_pipeline_ids_;
+  qint64 first_buffer_nanosec_;
+  qint64 duration_nanosec_;
+};
+
+QJsonObject LatencySummary(QList<double> values_msec) {
+
+  std::sort(values_msec.begin(), values_msec.end());
+
+  QJsonObject summary;
+  summary["iterations"_L1] = static_cast<int>(values_msec.count());
+  if (!values_msec.isEmpty()) {
+    summary["min_msec"_L1] = values_msec.constFirst();
+    summary["median_msec"_L1] = values_msec.at(values_msec.count() / 2);
+    summary["max_msec"_L1] = values_msec.constLast();
+  }
+
+  return summary;
+
+}
+
+class EngineBenchmark : public ::testing::TestWithParam<const char*> {
+ protected:
+  static void SetUpTestSuite() {
+
+    GstStartup::Initialize();
+
+    // The buffers are counted before the sink, a fake sink without clock synchronization plays the files as fast as they decode.
+    Settings s;
+    s.beginGroup(BackendSettings::kSettingsGroup);
+    s.setValue(BackendSettings::kOutputU, u"fakesink"_s);
+    s.endGroup();
+
+  }
+
+  // The results are written as JSON to STRAWBERRY_BENCHMARK_JSON, or engine_benchmark.json in the working directory.
+  static void TearDownTestSuite() {
+
+    QString filename = qEnvironmentVariable("STRAWBERRY_BENCHMARK_JSON");
+    if (filename.isEmpty()) filename = u"engine_benchmark.json"_s;
+
+    QJsonObject json;
+    json["benchmark"_L1] = u"gstengine"_s;
+    json["gstreamer_version"_L1] = QString::fromUtf8(gst_version_string());
+    json["formats"_L1] = results_;
+
+    QFile file(filename);
+    if (file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+      file.write(QJsonDocument(json).toJson());
+      file.close();
+      qLog(Info) << "Engine benchmark results written to" << filename;
+    }
+    else {
+      qLog(Error) << "Could not write engine benchmark results to" << filename << file.errorString();
+    }
+
+  }
+
+  void SetUp() override {
+
+    resource_ = make_unique<TemporaryResource>(u":/audio/strawberry.%1"_s.arg(QLatin1String(GetParam())));
+    url_ = QUrl::fromLocalFile(resource_->fileName());
+
+    task_manager_ = make_shared<TaskManager>();
+    engine_ = make_unique<GstEngine>(task_manager_);
+    engine_->Init();
+    engine_->ReloadSettings();
+    engine_->AddBufferConsumer(&recorder_);
+
+    QObject::connect(&*engine_, &EngineBase::Error, &*engine_, [this](const QString &message) { error_ = message; });
+    QObject::connect(&*engine_, &EngineBase::TrackEnded, &*engine_, [this]() { ++tracks_ended_; });
+
+  }
+
+  void TearDown() override {
+
+    engine_->Stop();
+    engine_->RemoveBufferConsumer(&recorder_);
+    engine_.reset();
+
+  }
+
+  template<typename Condition>
+  bool WaitFor(Condition condition) {
+    return BenchmarkWaitFor([this, &condition]() { return !error_.isEmpty() || condition(); }, kTimeoutMsec) && error_.isEmpty();
+  }
+
+  bool LoadAndPlay(const QUrl &url, const bool pause) {
+
+    recorder_.Reset();
+    tracks_ended_ = 0;
+
+    return engine_->Load(url, url, EngineBase::TrackChangeType::Manual, false, 0, 0, std::nullopt) && engine_->Play(pause, 0) && WaitFor([this]() { return recorder_.first_buffer_nanosec() != -1; });
+
+  }
+
+  // Decoded length of the file played on its own.
+  std::optional<qint64> PlayToEnd(const QUrl &url) {
+
+    if (!LoadAndPlay(url, false) || !WaitFor([this]() { return tracks_ended_ > 0; })) return std::nullopt;
+
+    return recorder_.duration_nanosec();
+
+  }
+
+  void Pause(const qint64 msec) {
+    QElapsedTimer timer;
+    timer.start();
+    BenchmarkWaitFor([&timer, msec]() { return timer.elapsed() >= msec; });
+  }
+
+  void AddResult(const QString &name, const QJsonValue &value) {
+    QJsonObject result = results_.value(QLatin1String(GetParam())).toObject();
+    result[name] = value;
+    results_[QLatin1String(GetParam())] = result;
+  }
+
+  static QJsonObject results_;  // NOLINT(cppcoreguidelines-non-private-member-variables-in-classes)
+
+  std::unique_ptr<TemporaryResource> resource_;  // NOLINT(cppcoreguidelines-non-private-member-variables-in-classes)
+  QUrl url_;  // NOLINT(cppcoreguidelines-non-private-member-variables-in-classes)
+  SharedPtr<TaskManager> task_manager_;  // NOLINT(cppcoreguidelines-non-private-member-variables-in-classes)
+  std::unique_ptr<GstEngine> engine_;  // NOLINT(cppcoreguidelines-non-private-member-variables-in-classes)
+  BufferRecorder recorder_;  // NOLINT(cppcoreguidelines-non-private-member-variables-in-classes)
+  QString error_;  // NOLINT(cppcoreguidelines-non-private-member-variables-in-classes)
+  int tracks_ended_ = 0;  // NOLINT(cppcoreguidelines-non-private-member-variables-in-classes)
+};
+
+QJsonObject EngineBenchmark::results_;
+
+TEST_P(EngineBenchmark, LoadToFirstBuffer) {
+
+  QList<double> latencies;
+  for (int i = 0; i < BenchmarkIterations(); ++i) {
+    if (!LoadAndPlay(url_, false)) {
+      if (!error_.isEmpty()) GTEST_SKIP() << "Can't play " << GetParam() << ": " << error_.toStdString();
+      FAIL() << "Timed out waiting for the first buffer";
+    }
+    latencies << static_cast<double>(recorder_.first_buffer_nanosec()) / kNsecPerMsec;
+    engine_->Stop();
+  }
+
+  const QJsonObject summary = LatencySummary(latencies);
+  qLog(Info) << "GstEngine load to first buffer for" << GetParam() << "took" << summary["median_msec"_L1].toDouble() << "ms (median)";
+  AddResult(u"load_to_first_buffer"_s, summary);
+
+}
+
+TEST_P(EngineBenchmark, SeekToFirstBuffer) {
+
+  QList<double> latencies;
+  for (int i = 0; i < BenchmarkIterations(); ++i) {
+    // Paused after the preroll nothing else flows, so the next buffer is the first one after the seek.
+    if (!LoadAndPlay(url_, true)) {
+      if (!error_.isEmpty()) GTEST_SKIP() << "Can't play " << GetParam() << ": " << error_.toStdString();
+      FAIL() << "Timed out waiting for the preroll";
+    }
+    const qint64 length_nanosec = engine_->length_nanosec();
+    recorder_.ResetFirstBuffer();
+    engine_->Seek(static_cast<quint64>(std::max(0LL, length_nanosec / 2)));
+    if (!WaitFor([this]() { return recorder_.first_buffer_nanosec() != -1; })) {
+      FAIL() << "Timed out waiting for the first buffer after seeking";
+    }
+    latencies << static_cast<double>(recorder_.first_buffer_nanosec()) / kNsecPerMsec;
+    engine_->Stop();
+    Pause(kSeekDelayMsec);
+  }
+
+  const QJsonObject summary = LatencySummary(latencies);
+  qLog(Info) << "GstEngine seek to first buffer for" << GetParam() << "took" << summary["median_msec"_L1].toDouble() << "ms (median)";
+  AddResult(u"seek_to_first_buffer"_s, summary);
+
+}
+
+// Plays this format followed by the next one gaplessly, and compares the decoded audio with the two files played on their own.
+// A positive difference is audio added at the transition, heard as a gap, a negative difference is audio lost from either track.
+TEST_P(EngineBenchmark, GaplessTransition) {
+
+  const char *format = GetParam();
+  const qsizetype format_index = std::find_if(std::begin(kFormats), std::end(kFormats), [format](const char *f) { return qstrcmp(f, format) == 0; }) - std::begin(kFormats);
+  const char *next_format = kFormats[(format_index + 1) % static_cast<qsizetype>(std::size(kFormats))];
+  TemporaryResource next_resource(u":/audio/strawberry.%1"_s.arg(QLatin1String(next_format)));
+  const QUrl next_url = QUrl::fromLocalFile(next_resource.fileName());
+
+  const std::optional<qint64> length_nanosec = PlayToEnd(url_);
+  const std::optional<qint64> next_length_nanosec = PlayToEnd(next_url);
+  if (!length_nanosec.has_value() || !next_length_nanosec.has_value()) {
+    if (!error_.isEmpty()) GTEST_SKIP() << "Can't play " << GetParam() << " and " << next_format << ": " << error_.toStdString();
+    FAIL() << "Timed out playing the files";
+  }
+
+  if (!LoadAndPlay(url_, false)) {
+    FAIL() << "Timed out waiting for the first buffer";
+  }
+  engine_->StartPreloading(next_url, next_url, false, 0, 0);
+  if (!WaitFor([this]() { return tracks_ended_ >= 2; })) {
+    FAIL() << "Timed out waiting for the gapless transition";
+  }
+
+  const qint64 difference_nanosec = recorder_.duration_nanosec() - length_nanosec.value() - next_length_nanosec.value();
+  const double difference_msec = static_cast<double>(difference_nanosec) / kNsecPerMsec;
+  qLog(Info) << "GstEngine gapless transition from" << GetParam() << "to" << next_format << "differs by" << difference_msec << "ms";
+
+  QJsonObject result;
+  result["next_format"_L1] = QString::fromLatin1(next_format);
+  result["difference_msec"_L1] = difference_msec;
+  AddResult(u"gapless_transition"_s, result);
+
+}
+
+INSTANTIATE_TEST_SUITE_P(Formats, EngineBenchmark, ::testing::ValuesIn(kFormats));
+
+}  // namespace
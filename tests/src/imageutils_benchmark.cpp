@@ -0,0 +1,92 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "gtest_include.h"
+
+#include <QtGlobal>
+#include <QList>
+#include <QByteArray>
+#include <QImage>
+#include <QColor>
+#include <QElapsedTimer>
+
+#include "core/logging.h"
+#include "utilities/imageutils.h"
+
+// clazy:excludeall=non-pod-global-static,returning-void-expression
+
+namespace {
+
+constexpr int kThumbnailSize = 32;
+constexpr int kIterations = 2000;
+
+// Generates a cover like image, a gradient with some noise so it does not compress unrealistically well.
+QImage MakeBenchmarkCover() {
+
+  QImage image(kThumbnailSize, kThumbnailSize, QImage::Format_ARGB32_Premultiplied);
+  quint32 seed = 1;
+  for (int y = 0; y < image.height(); ++y) {
+    for (int x = 0; x < image.width(); ++x) {
+      seed = seed * 1103515245U + 12345U;
+      const int noise = static_cast<int>((seed >> 16) % 32);
+      image.setPixel(x, y, qRgb(qMin(255, x * 8 + noise), qMin(255, y * 8 + noise), qMin(255, (x + y) * 4 + noise)));
+    }
+  }
+
+  return image;
+
+}
+
+class ImageUtilsBenchmark : public ::testing::TestWithParam<int> {};
+
+TEST_P(ImageUtilsBenchmark, EncodeDecodeThumbnail) {
+
+  const QImage image = MakeBenchmarkCover();
+  const int quality = GetParam();
+  const qint64 raw_bytes = image.sizeInBytes();
+
+  const QList<ImageUtils::ThumbnailFormat> formats = ImageUtils::SupportedThumbnailFormats();
+  for (const ImageUtils::ThumbnailFormat format : formats) {
+    if (format == ImageUtils::ThumbnailFormat::Raw) continue;
+
+    QByteArray data;
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < kIterations; ++i) {
+      data = ImageUtils::EncodeThumbnail(image, format, quality);
+    }
+    const qint64 encode_msec = timer.elapsed();
+    ASSERT_FALSE(data.isEmpty());
+
+    QImage decoded;
+    timer.restart();
+    for (int i = 0; i < kIterations; ++i) {
+      decoded = ImageUtils::DecodeThumbnail(data, format);
+    }
+    const qint64 decode_msec = timer.elapsed();
+    ASSERT_EQ(image.size(), decoded.size());
+
+    qLog(Info) << ImageUtils::ThumbnailFormatDescription(format) << "quality" << quality << "size" << data.size() << "of" << raw_bytes << "bytes," << "encoding" << kIterations << "thumbnails took" << encode_msec << "ms, decoding took" << decode_msec << "ms";
+  }
+
+}
+
+INSTANTIATE_TEST_SUITE_P(Qualities, ImageUtilsBenchmark, ::testing::Values(50, 75, 90));
+
+}  // namespace
@@ -0,0 +1,126 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <utility>
+
+#include "gtest_include.h"
+
+#include <QList>
+#include <QString>
+#include <QStandardItem>
+#include <QStandardItemModel>
+#include <QModelIndex>
+#include <QElapsedTimer>
+
+#include "core/logging.h"
+#include "core/mergedproxymodel.h"
+
+#include "benchmark_utils.h"
+
+using namespace Qt::Literals::StringLiterals;
+
+// clazy:excludeall=non-pod-global-static,returning-void-expression
+
+namespace {
+
+constexpr int kChildrenPerItem = 10;
+constexpr int kPasses = 5;
+
+// A source model with a few device like items, each with a submodel of albums and songs merged into it.
+class MergedProxyModelBenchmark : public ::testing::TestWithParam<int> {
+ protected:
+  void SetUp() override {
+    merged_.setSourceModel(&source_);
+    for (int i = 0; i < kSubModels; ++i) {
+      source_.appendRow(new QStandardItem(u"Device %1"_s.arg(i)));
+      QStandardItemModel *submodel = new QStandardItemModel(&source_);
+      for (int album = 0; album < GetParam() / kSubModels / kChildrenPerItem; ++album) {
+        QStandardItem *album_item = new QStandardItem(u"Album %1"_s.arg(album));
+        for (int song = 0; song < kChildrenPerItem; ++song) {
+          album_item->appendRow(new QStandardItem(u"Song %1"_s.arg(song)));
+        }
+        submodel->appendRow(album_item);
+      }
+      merged_.AddSubModel(source_.index(i, 0), submodel);
+    }
+  }
+
+  // Walks the whole tree like a view does, returns the number of items visited.
+  int Walk(const QModelIndex &parent) {
+    int count = 0;
+    const int rows = merged_.rowCount(parent);
+    for (int row = 0; row < rows; ++row) {
+      const QModelIndex idx = merged_.index(row, 0, parent);
+      if (merged_.data(idx).isValid() && merged_.parent(idx) == parent) ++count;
+      if (merged_.hasChildren(idx)) count += Walk(idx);
+    }
+    return count;
+  }
+
+  static constexpr int kSubModels = 4;
+
+  QStandardItemModel source_;  // NOLINT(cppcoreguidelines-non-private-member-variables-in-classes)
+  MergedProxyModel merged_;  // NOLINT(cppcoreguidelines-non-private-member-variables-in-classes)
+};
+
+TEST_P(MergedProxyModelBenchmark, Walk) {
+
+  // The first pass creates the mappings, the following passes only look them up.
+  QElapsedTimer timer;
+  timer.start();
+  const int items = Walk(QModelIndex());
+  qLog(Info) << "First walk of" << items << "items took" << timer.elapsed() << "ms";
+  ASSERT_GT(items, 0);
+
+  timer.restart();
+  for (int i = 0; i < kPasses; ++i) {
+    ASSERT_EQ(items, Walk(QModelIndex()));
+  }
+  BenchmarkResult("Walking the merged model", GetParam(), timer);
+
+}
+
+TEST_P(MergedProxyModelBenchmark, MapToAndFromSource) {
+
+  QList<QModelIndex> proxy_indexes;
+  for (int i = 0; i < kSubModels; ++i) {
+    const QModelIndex device = merged_.index(i, 0, QModelIndex());
+    for (int row = 0; row < merged_.rowCount(device); ++row) {
+      const QModelIndex album = merged_.index(row, 0, device);
+      for (int child = 0; child < merged_.rowCount(album); ++child) {
+        proxy_indexes << merged_.index(child, 0, album);
+      }
+    }
+  }
+  ASSERT_FALSE(proxy_indexes.isEmpty());
+
+  QElapsedTimer timer;
+  timer.start();
+  for (int i = 0; i < kPasses; ++i) {
+    for (const QModelIndex &proxy_index : std::as_const(proxy_indexes)) {
+      ASSERT_EQ(proxy_index, merged_.mapFromSource(merged_.mapToSource(proxy_index)));
+    }
+  }
+  BenchmarkResult("Mapping merged model indexes", GetParam(), timer);
+
+}
+
+INSTANTIATE_TEST_SUITE_P(Sizes, MergedProxyModelBenchmark, ::testing::ValuesIn(BenchmarkSizes()));
+
+}  // namespace
@@ -128,6 +128,25 @@ TEST_F(OrganizeFormatTest, Blocks) {
 
 }
 
+TEST_F(OrganizeFormatTest, NestedBlocks) {
+
+  format_.set_format(u"{%artist/{%album/}}%title"_s);
+  ASSERT_TRUE(format_.IsValid());
+
+  song_.set_title(u"title"_s);
+  song_.set_artist(u"artist"_s);
+  song_.set_album(u"album"_s);
+  EXPECT_EQ(u"artist/album/title"_s, format_.GetFilenameForSong(song_).filename);
+
+  song_.set_album(QString());
+  EXPECT_EQ(u"artist/title"_s, format_.GetFilenameForSong(song_).filename);
+
+  song_.set_artist(QString());
+  song_.set_album(u"album"_s);
+  EXPECT_EQ(u"title"_s, format_.GetFilenameForSong(song_).filename);
+
+}
+
 TEST_F(OrganizeFormatTest, ReplaceSpaces) {
 
   song_.set_title(u"The Song Title"_s);
@@ -0,0 +1,87 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <memory>
+
+#include "gtest_include.h"
+
+#include <QElapsedTimer>
+
+#include "includes/shared_ptr.h"
+#include "core/song.h"
+#include "playlist/playlist.h"
+#include "playlist/playlistitem.h"
+#include "playlist/songplaylistitem.h"
+#include "mock_settingsprovider.h"
+
+#include "benchmark_utils.h"
+
+using namespace Qt::Literals::StringLiterals;
+using std::make_shared;
+
+// clazy:excludeall=non-pod-global-static,returning-void-expression
+
+namespace {
+
+class PlaylistBenchmark : public ::testing::TestWithParam<int> {
+ protected:
+  PlaylistBenchmark()
+      : playlist_(nullptr, nullptr, nullptr, nullptr, nullptr, 1),
+        sequence_(nullptr, new DummySettingsProvider) {}
+
+  void SetUp() override {
+    playlist_.set_sequence(&sequence_);
+    const SongList songs = MakeBenchmarkSongs(GetParam());
+    PlaylistItemPtrList items;
+    items.reserve(songs.count());
+    for (const Song &song : songs) {
+      items << make_shared<SongPlaylistItem>(song);
+    }
+    playlist_.InsertItems(items);
+  }
+
+  Playlist playlist_;  // NOLINT(cppcoreguidelines-non-private-member-variables-in-classes)
+  PlaylistSequence sequence_;  // NOLINT(cppcoreguidelines-non-private-member-variables-in-classes)
+};
+
+TEST_P(PlaylistBenchmark, SortByTitle) {
+
+  QElapsedTimer timer;
+  timer.start();
+  playlist_.sort(static_cast<int>(Playlist::Column::Title), Qt::DescendingOrder);
+  BenchmarkResult("Playlist::sort by title", GetParam(), timer);
+
+  EXPECT_EQ(GetParam(), playlist_.rowCount(QModelIndex()));
+
+}
+
+TEST_P(PlaylistBenchmark, SortByAlbum) {
+
+  QElapsedTimer timer;
+  timer.start();
+  playlist_.sort(static_cast<int>(Playlist::Column::Album), Qt::AscendingOrder);
+  BenchmarkResult("Playlist::sort by album", GetParam(), timer);
+
+  EXPECT_EQ(GetParam(), playlist_.rowCount(QModelIndex()));
+
+}
+
+INSTANTIATE_TEST_SUITE_P(Sizes, PlaylistBenchmark, ::testing::ValuesIn(BenchmarkSizes()));
+
+}  // namespace
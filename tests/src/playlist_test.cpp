@@ -285,6 +285,25 @@ TEST_F(PlaylistTest, Clear) {
 
 }
 
+TEST_F(PlaylistTest, Statistics) {
+
+  playlist_.InsertItems(PlaylistItemPtrList() << MakeMockItemP(u"One"_s, QString(), QString(), 100) << MakeMockItemP(u"Two"_s, QString(), QString(), 200) << MakeMockItemP(u"Three"_s, QString(), QString(), 300));
+  EXPECT_EQ(600U, playlist_.GetTotalLength());
+  EXPECT_EQ(3, playlist_.GetSourceCount(Song::Source::Unknown));
+
+  playlist_.removeRows(1, 1);
+  EXPECT_EQ(400U, playlist_.GetTotalLength());
+  EXPECT_EQ(2, playlist_.GetSourceCount(Song::Source::Unknown));
+
+  playlist_.undo_stack()->undo();
+  EXPECT_EQ(600U, playlist_.GetTotalLength());
+
+  playlist_.Clear();
+  EXPECT_EQ(0U, playlist_.GetTotalLength());
+  EXPECT_EQ(0, playlist_.GetSourceCount(Song::Source::Unknown));
+
+}
+
 TEST_F(PlaylistTest, UndoAdd) {
 
   EXPECT_FALSE(playlist_.undo_stack()->canUndo());
@@ -383,6 +402,32 @@ TEST_F(PlaylistTest, UndoMultiRemove) {
 
 }
 
+TEST_F(PlaylistTest, UndoRemoveRows) {
+
+  playlist_.InsertItems(PlaylistItemPtrList() << MakeMockItemP(u"One"_s) << MakeMockItemP(u"Two"_s) << MakeMockItemP(u"Three"_s) << MakeMockItemP(u"Four"_s) << MakeMockItemP(u"Five"_s));
+  ASSERT_EQ(5, playlist_.rowCount(QModelIndex()));
+
+  playlist_.set_current_row(2);
+
+  QList<int> rows = QList<int>() << 3 << 0 << 1;
+  ASSERT_TRUE(playlist_.removeRows(rows));
+  ASSERT_EQ(2, playlist_.rowCount(QModelIndex()));
+  EXPECT_EQ(u"Three"_s, playlist_.data(playlist_.index(0, static_cast<int>(Playlist::Column::Title))));
+  EXPECT_EQ(u"Five"_s, playlist_.data(playlist_.index(1, static_cast<int>(Playlist::Column::Title))));
+  EXPECT_EQ(0, playlist_.current_row());
+
+  ASSERT_TRUE(playlist_.undo_stack()->canUndo());
+  EXPECT_EQ(u"remove 3 songs"_s, playlist_.undo_stack()->undoText());
+  playlist_.undo_stack()->undo();
+
+  ASSERT_EQ(5, playlist_.rowCount(QModelIndex()));
+  EXPECT_EQ(u"One"_s, playlist_.data(playlist_.index(0, static_cast<int>(Playlist::Column::Title))));
+  EXPECT_EQ(u"Two"_s, playlist_.data(playlist_.index(1, static_cast<int>(Playlist::Column::Title))));
+  EXPECT_EQ(u"Four"_s, playlist_.data(playlist_.index(3, static_cast<int>(Playlist::Column::Title))));
+  EXPECT_EQ(2, playlist_.current_row());
+
+}
+
 TEST_F(PlaylistTest, UndoClear) {
 
   playlist_.InsertItems(PlaylistItemPtrList() << MakeMockItemP(u"One"_s) << MakeMockItemP(u"Two"_s) << MakeMockItemP(u"Three"_s));
@@ -2,8 +2,18 @@
 
 #include <sqlite3.h>
 
+#include <QByteArray>
+#include <QString>
+#include <QUrl>
+#include <QVariantList>
+#include <QTemporaryDir>
+
+#include "core/sqlitereader.h"
+
 // clazy:excludeall=returning-void-expression
 
+using namespace Qt::Literals::StringLiterals;
+
 TEST(SqliteTest, CreateTableTest) {
 
   sqlite3 *db = nullptr;
@@ -17,3 +27,53 @@ TEST(SqliteTest, CreateTableTest) {
   sqlite3_close(db);
 
 }
+
+TEST(SqliteTest, ReaderTest) {
+
+  QTemporaryDir temp_dir;
+  ASSERT_TRUE(temp_dir.isValid());
+  const QString filename = temp_dir.filePath(u"test.db"_s);
+
+  sqlite3 *db = nullptr;
+  ASSERT_EQ(0, sqlite3_open(filename.toUtf8().constData(), &db));
+  char *errmsg = nullptr;
+  int rc = sqlite3_exec(db, "CREATE TABLE foo (id INTEGER, artist TEXT, url TEXT, rating REAL);"
+                            "INSERT INTO foo VALUES (1, 'Strawberry', 'file:///music/a%20b.flac', 0.5);"
+                            "INSERT INTO foo VALUES (2, 'Strawberry', 'file:///music/c.flac', NULL);"
+                            "INSERT INTO foo VALUES (3, NULL, NULL, NULL);", nullptr, nullptr, &errmsg);
+  ASSERT_EQ(0, rc) << errmsg;
+  sqlite3_close(db);
+
+  EXPECT_FALSE(SqliteReader(u":memory:"_s).Prepare(u"SELECT 1"_s));
+
+  SqliteReader reader(filename);
+  ASSERT_TRUE(reader.Prepare(u"SELECT id, artist, url, rating FROM foo WHERE id <= ? ORDER BY id"_s, QVariantList() << 2));
+  EXPECT_EQ(reader.columns(), 4);
+
+  ASSERT_TRUE(reader.Next());
+  EXPECT_EQ(reader.Int(0), 1);
+  const QString artist1 = reader.SharedString(1);
+  EXPECT_EQ(artist1, u"Strawberry"_s);
+  EXPECT_EQ(reader.Url(2), QUrl::fromLocalFile(u"/music/a b.flac"_s));
+  EXPECT_DOUBLE_EQ(reader.Double(3), 0.5);
+
+  ASSERT_TRUE(reader.Next());
+  EXPECT_EQ(reader.LongLong(0), 2);
+  const QString artist2 = reader.SharedString(1);
+  EXPECT_EQ(artist2, artist1);
+  EXPECT_EQ(artist2.constData(), artist1.constData());
+  EXPECT_TRUE(reader.IsNull(3));
+
+  EXPECT_FALSE(reader.Next());
+  EXPECT_TRUE(reader.error().isEmpty());
+
+  ASSERT_TRUE(reader.Prepare(u"SELECT artist, url FROM foo WHERE id = ?"_s, QVariantList() << 3));
+  ASSERT_TRUE(reader.Next());
+  EXPECT_TRUE(reader.IsNull(0));
+  EXPECT_TRUE(reader.String(0).isNull());
+  EXPECT_TRUE(reader.SharedUrl(1).isEmpty());
+
+  EXPECT_FALSE(reader.Prepare(u"SELECT missing FROM foo"_s));
+  EXPECT_FALSE(reader.error().isEmpty());
+
+}
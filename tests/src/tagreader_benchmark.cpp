@@ -0,0 +1,195 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "config.h"
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gtest_include.h"
+
+#include <QByteArray>
+#include <QString>
+#include <QStringList>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QElapsedTimer>
+
+#include "core/logging.h"
+#include "core/song.h"
+#include "tagreader/tagreaderclient.h"
+#include "tagreader/tagreaderfilestream.h"
+#include "tagreader/tagreaderreadprofile.h"
+#include "tagreader/savetagcoverdata.h"
+
+#include "test_utils.h"
+
+using std::make_unique;
+using namespace Qt::Literals::StringLiterals;
+
+// clazy:excludeall=non-pod-global-static,returning-void-expression
+
+namespace {
+
+// Number of times each file is read, override with STRAWBERRY_BENCHMARK_ITERATIONS, the files are written a tenth as often.
+int BenchmarkIterations() {
+
+  bool ok = false;
+  const int iterations = qEnvironmentVariableIntValue("STRAWBERRY_BENCHMARK_ITERATIONS", &ok);
+  return ok && iterations > 0 ? iterations : 500;
+
+}
+
+// The test files, and the files in STRAWBERRY_BENCHMARK_TAGREADER_DIR for formats without test files, ie: APE, DSF and GME.
+std::vector<std::string> BenchmarkFiles() {
+
+  std::vector<std::string> files;
+
+  const QStringList formats = QStringList() << u"mp3"_s << u"flac"_s << u"ogg"_s << u"oga"_s << u"opus"_s << u"spx"_s << u"m4a"_s << u"mp4"_s << u"wv"_s << u"asf"_s << u"wav"_s << u"aif"_s;
+  for (const QString &format : formats) {
+    files.push_back(u":/audio/strawberry.%1"_s.arg(format).toStdString());
+  }
+
+  const QString directory = qEnvironmentVariable("STRAWBERRY_BENCHMARK_TAGREADER_DIR");
+  if (!directory.isEmpty()) {
+    const QFileInfoList fileinfos = QDir(directory).entryInfoList(QDir::Files, QDir::Name);
+    for (const QFileInfo &fileinfo : fileinfos) {
+      files.push_back(fileinfo.absoluteFilePath().toStdString());
+    }
+  }
+
+  return files;
+
+}
+
+class TagReaderBenchmark : public ::testing::TestWithParam<std::string> {
+ protected:
+  void SetUp() override {
+
+    const QString filename = QString::fromStdString(GetParam());
+    format_ = filename.section(u'.', -1, -1);
+
+    // Every file is copied, so writing tags and covers doesn't change the originals.
+    temporary_file_ = make_unique<TemporaryResource>(filename);
+    filename_ = temporary_file_->fileName();
+
+    tagreader_client_ = make_unique<TagReaderClient>();
+
+  }
+
+  void TearDown() override {
+    tagreader_client_.reset();
+  }
+
+  // Runs the function for every iteration, and logs the files per second and the bytes TagLib read per file.
+  template<typename Function>
+  void Measure(const char *name, const int iterations, Function function) {
+
+    const TagReaderFileStream::Statistics statistics_before = TagReaderFileStream::statistics();
+    QElapsedTimer timer;
+    timer.start();
+
+    for (int i = 0; i < iterations; ++i) {
+      const TagReaderResult result = function();
+      if (!result.success()) {
+        GTEST_SKIP() << name << " failed for " << format_.toStdString() << ": " << result.error_string().toStdString();
+      }
+    }
+
+    const qint64 elapsed_nsec = std::max(1LL, timer.nsecsElapsed());
+    const TagReaderFileStream::Statistics statistics_after = TagReaderFileStream::statistics();
+    const double files_per_second = static_cast<double>(iterations) * 1000000000.0 / static_cast<double>(elapsed_nsec);
+    const quint64 bytes_per_file = (statistics_after.bytes_read - statistics_before.bytes_read) / static_cast<quint64>(iterations);
+
+    qLog(Info) << name << "for" << format_ << "(" << QFileInfo(filename_).size() << "bytes):" << qRound(files_per_second) << "files/s," << bytes_per_file << "bytes read per file";
+
+  }
+
+  QString format_;  // NOLINT(cppcoreguidelines-non-private-member-variables-in-classes)
+  std::unique_ptr<TemporaryResource> temporary_file_;  // NOLINT(cppcoreguidelines-non-private-member-variables-in-classes)
+  QString filename_;  // NOLINT(cppcoreguidelines-non-private-member-variables-in-classes)
+  std::unique_ptr<TagReaderClient> tagreader_client_;  // NOLINT(cppcoreguidelines-non-private-member-variables-in-classes)
+};
+
+TEST_P(TagReaderBenchmark, ReadFile) {
+
+  Measure("TagReaderClient::ReadFileBlocking", BenchmarkIterations(), [this]() {
+    Song song;
+    return tagreader_client_->ReadFileBlocking(filename_, &song, TagReaderReadProfile::Full);
+  });
+
+}
+
+TEST_P(TagReaderBenchmark, ReadFileScanProfile) {
+
+  // A rescan of an unchanged file, the audio properties are kept from the song read before.
+  Song song;
+  const TagReaderResult result = tagreader_client_->ReadFileBlocking(filename_, &song, TagReaderReadProfile::Full);
+  if (!result.success()) {
+    GTEST_SKIP() << "Can't read " << format_.toStdString() << ": " << result.error_string().toStdString();
+  }
+
+  Measure("TagReaderClient::ReadFileBlocking with the scan profile", BenchmarkIterations(), [this, &song]() {
+    Song rescanned_song = song;
+    return tagreader_client_->ReadFileBlocking(filename_, &rescanned_song, TagReaderReadProfile::Scan);
+  });
+
+}
+
+TEST_P(TagReaderBenchmark, LoadCoverData) {
+
+  QFile cover_file(u":/pictures/strawberry.png"_s);
+  ASSERT_TRUE(cover_file.open(QIODevice::ReadOnly));
+  const QByteArray cover_data = cover_file.readAll();
+  cover_file.close();
+
+  const TagReaderResult result = tagreader_client_->SaveCoverBlocking(filename_, SaveTagCoverData(cover_data, u"image/png"_s));
+  if (!result.success()) {
+    GTEST_SKIP() << "Can't embed a cover in " << format_.toStdString() << ": " << result.error_string().toStdString();
+  }
+
+  Measure("TagReaderClient::LoadCoverDataBlocking", BenchmarkIterations(), [this]() {
+    QByteArray data;
+    return tagreader_client_->LoadCoverDataBlocking(filename_, data);
+  });
+
+}
+
+TEST_P(TagReaderBenchmark, WriteFile) {
+
+  Song song;
+  const TagReaderResult result = tagreader_client_->ReadFileBlocking(filename_, &song, TagReaderReadProfile::Full);
+  if (!result.success()) {
+    GTEST_SKIP() << "Can't read " << format_.toStdString() << ": " << result.error_string().toStdString();
+  }
+
+  int i = 0;
+  Measure("TagReaderClient::WriteFileBlocking", std::max(1, BenchmarkIterations() / 10), [this, &song, &i]() {
+    song.set_title(u"Title %1"_s.arg(++i));
+    return tagreader_client_->WriteFileBlocking(filename_, song);
+  });
+
+}
+
+INSTANTIATE_TEST_SUITE_P(Files, TagReaderBenchmark, ::testing::ValuesIn(BenchmarkFiles()));
+
+}  // namespace
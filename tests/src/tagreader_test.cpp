@@ -24,14 +24,18 @@
 
 #include <QFile>
 #include <QByteArray>
+#include <QList>
+#include <QPair>
 #include <QString>
 #include <QCryptographicHash>
+#include <QDataStream>
 #include <QThread>
 #include <QEventLoop>
 
 #include "core/logging.h"
 #include "core/song.h"
 #include "tagreader/tagreaderclient.h"
+#include "tagreader/tagreaderfilestream.h"
 
 #include "test_utils.h"
 
@@ -2496,4 +2500,131 @@ TEST_F(TagReaderTest, TestMP4AudioFileCover) {
 
 }
 
+TEST_F(TagReaderTest, TestFLACAudioFileCoverReplaced) {
+
+  TemporaryResource r(u":/audio/strawberry.flac"_s);
+
+  QImage original_image;
+  EXPECT_TRUE(original_image.load(u":/pictures/cdcase.png"_s));
+  EXPECT_TRUE(WriteCoverToFile(r.fileName(), u":/pictures/cdcase.png"_s).success());
+  EXPECT_EQ(ReadCoverFromFile(r.fileName()), original_image);
+
+  QImage new_image;
+  EXPECT_TRUE(new_image.load(u":/pictures/strawberry.png"_s));
+  EXPECT_TRUE(WriteCoverToFile(r.fileName(), u":/pictures/strawberry.png"_s).success());
+  EXPECT_EQ(ReadCoverFromFile(r.fileName()), new_image);
+
+}
+
+TEST_F(TagReaderTest, TestMP3AudioFileCoverReplaced) {
+
+  TemporaryResource r(u":/audio/strawberry.mp3"_s);
+
+  QImage original_image;
+  EXPECT_TRUE(original_image.load(u":/pictures/cdcase.png"_s));
+  EXPECT_TRUE(WriteCoverToFile(r.fileName(), u":/pictures/cdcase.png"_s).success());
+  EXPECT_EQ(ReadCoverFromFile(r.fileName()), original_image);
+
+  QImage new_image;
+  EXPECT_TRUE(new_image.load(u":/pictures/strawberry.png"_s));
+  EXPECT_TRUE(WriteCoverToFile(r.fileName(), u":/pictures/strawberry.png"_s).success());
+  EXPECT_EQ(ReadCoverFromFile(r.fileName()), new_image);
+
+}
+
+TEST_F(TagReaderTest, TestScanProfileKeepsAudioPropertiesOfUnchangedFile) {
+
+  TemporaryResource r(u":/audio/strawberry.flac"_s);
+
+  Song song_full;
+  EXPECT_TRUE(tagreader_client_->ReadFileBlocking(r.fileName(), &song_full).success());
+  EXPECT_GT(song_full.length_nanosec(), 0);
+
+  Song song_unchanged;
+  song_unchanged.set_filesize(song_full.filesize());
+  song_unchanged.set_mtime(song_full.mtime());
+  song_unchanged.set_length_nanosec(song_full.length_nanosec() + 1);
+  EXPECT_TRUE(tagreader_client_->ReadFileBlocking(r.fileName(), &song_unchanged, TagReaderReadProfile::Scan).success());
+  EXPECT_EQ(song_unchanged.length_nanosec(), song_full.length_nanosec() + 1);
+  EXPECT_EQ(song_unchanged.title(), song_full.title());
+
+  Song song_changed;
+  song_changed.set_filesize(song_full.filesize() + 1);
+  song_changed.set_mtime(song_full.mtime());
+  song_changed.set_length_nanosec(song_full.length_nanosec() + 1);
+  EXPECT_TRUE(tagreader_client_->ReadFileBlocking(r.fileName(), &song_changed, TagReaderReadProfile::Scan).success());
+  EXPECT_GT(song_changed.length_nanosec(), 0);
+  EXPECT_NE(song_changed.length_nanosec(), song_full.length_nanosec() + 1);
+
+}
+
+TEST_F(TagReaderTest, TestSongDataStreamRoundTrip) {
+
+  TemporaryResource r(u":/audio/strawberry.flac"_s);
+
+  Song song = ReadSongFromFile(r.fileName());
+  song.set_rating(0.6F);
+  song.set_ebur128_integrated_loudness_lufs(-14.5);
+
+  QByteArray data;
+  {
+    QDataStream out(&data, QIODevice::WriteOnly);
+    song.ToDataStream(&out);
+  }
+
+  Song song_copy;
+  {
+    QDataStream in(data);
+    song_copy.InitFromDataStream(&in);
+  }
+
+  EXPECT_TRUE(song_copy.IsAllMetadataEqual(song));
+  EXPECT_EQ(song_copy.url(), song.url());
+  EXPECT_EQ(song_copy.filetype(), song.filetype());
+  EXPECT_EQ(song_copy.length_nanosec(), song.length_nanosec());
+  EXPECT_EQ(song_copy.bitrate(), song.bitrate());
+  EXPECT_EQ(song_copy.filesize(), song.filesize());
+  EXPECT_EQ(song_copy.mtime(), song.mtime());
+  EXPECT_FLOAT_EQ(song_copy.rating(), song.rating());
+  EXPECT_EQ(song_copy.ebur128_integrated_loudness_lufs(), song.ebur128_integrated_loudness_lufs());
+  EXPECT_FALSE(song_copy.ebur128_loudness_range_lu().has_value());
+
+}
+
+TEST_F(TagReaderTest, TestFileStreamReadsMatchFile) {
+
+  TemporaryResource r(u":/audio/strawberry.mp3"_s);
+
+  QByteArray file_data;
+  {
+    QFile file(r.fileName());
+    ASSERT_TRUE(file.open(QIODevice::ReadOnly));
+    file_data = file.readAll();
+  }
+  ASSERT_GT(file_data.size(), 1024);
+  const qint64 size = file_data.size();
+
+  TagReaderFileStream stream_mapped(r.fileName(), TagReaderFileStream::Mode::Map);
+  TagReaderFileStream stream_buffered(r.fileName(), TagReaderFileStream::Mode::Buffer);
+  EXPECT_TRUE(stream_mapped.mapped());
+  EXPECT_FALSE(stream_buffered.mapped());
+
+  // Offset from the start of the file, or from the end if negative, and the number of bytes to read.
+  const QList<QPair<qint64, qint64>> reads = { { 0, 10 }, { 10, 1024 }, { -128, 128 }, { -32, 64 }, { size / 2, 4096 }, { 100, size }, { size + 10, 10 } };
+
+  for (TagReaderFileStream *stream : { &stream_mapped, &stream_buffered }) {
+    EXPECT_TRUE(stream->isOpen());
+    EXPECT_EQ(stream->length(), size);
+    for (const QPair<qint64, qint64> &read : reads) {
+      stream->seek(read.first, read.first < 0 ? TagLib::IOStream::End : TagLib::IOStream::Beginning);
+      const qint64 position = read.first < 0 ? size + read.first : read.first;
+      const TagLib::ByteVector data = stream->readBlock(static_cast<TagLibLengthType>(read.second));
+      const QByteArray expected_data = position < size ? file_data.mid(position, read.second) : QByteArray();
+      EXPECT_EQ(QByteArray(data.data(), static_cast<qsizetype>(data.size())), expected_data);
+      EXPECT_EQ(stream->tell(), position + expected_data.size());
+    }
+  }
+
+}
+
 }  // namespace